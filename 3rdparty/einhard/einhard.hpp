@@ -44,7 +44,8 @@
  *
  * To reduce the performance overhad you can specify NDEBUG during compile. This will disable trace
  * and debug messages in a way that should allow the compilers dead code elimination to remove
- * everything that is only pushed into such a stream.
+ * everything that is only pushed into such a stream. Defining EINHARD_KEEP_DEBUG_MESSAGES keeps
+ * them in spite of NDEBUG.
  *
  * \section install_sec Installation
  *
@@ -68,6 +69,13 @@
 
 #include "stacktrace.h"
 
+// Trace and debug messages are compiled out with NDEBUG, unless the user asks
+// to keep them and filters at compile time via the template parameter of
+// Logger instead.
+#if defined(NDEBUG) && !defined(EINHARD_KEEP_DEBUG_MESSAGES)
+#define EINHARD_STRIP_DEBUG_MESSAGES_
+#endif
+
 // This C header is sadly required to check whether writing to a terminal or a file
 #include <cstdio>
 
@@ -397,7 +405,7 @@ namespace einhard
 			}
 
 			/** Access to the trace message stream. */
-#ifdef NDEBUG
+#ifdef EINHARD_STRIP_DEBUG_MESSAGES_
 			DummyOutputFormatter trace() const noexcept
 			{
 				return DummyOutputFormatter();
@@ -425,7 +433,7 @@ namespace einhard
 			}
 #endif
 			/** Access to the debug message stream. */
-#ifdef NDEBUG
+#ifdef EINHARD_STRIP_DEBUG_MESSAGES_
 			DummyOutputFormatter debug() const noexcept
 			{
 				return DummyOutputFormatter();
@@ -519,7 +527,7 @@ namespace einhard
 
 			template <LogLevel LEVEL> bool isEnabled() const noexcept
 			{
-#ifdef NDEBUG
+#ifdef EINHARD_STRIP_DEBUG_MESSAGES_
 				if( LEVEL == DEBUG || LEVEL == TRACE ) {
 					return false;
 				}
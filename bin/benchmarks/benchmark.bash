@@ -2,7 +2,7 @@
 
 #===================================================
 #
-#    Copyright (c) 2018-2021,2023
+#    Copyright (c) 2018-2021,2023-2024
 #      SMASH Team
 #
 #    GNU General Public License (GPLv3 or later)
@@ -69,6 +69,11 @@ echo "Running Benchmarks for ${SMASH_VER_NUM} ..."
 echo "(Runs for roughly 2h.)"
 
 
+# The SMASH output of the last run is kept to extract the numbers of events
+# and interactions as well as the peak memory for the JSON results.
+RUN_LOG=$(mktemp)
+trap 'rm -f "${RUN_LOG}"' EXIT
+
 benchmark_run() {
   local YAML_DIR DECAYM_DIR PART_DIR
   YAML_DIR=$1
@@ -82,19 +87,49 @@ benchmark_run() {
                -i ${SCRIPTPATH}/configs/${YAML_DIR}/config.yaml \
                -d ${DECAYM_DIR}/decaymodes.txt \
                -p ${PART_DIR}/particles.txt \
+               -c 'General: { Memory_Tracking: true }' \
                -c "$CONFIG_OPT" \
-               2>&1 >/dev/null)
+               2>&1 >"${RUN_LOG}")
   else
     PERF_OUT=$(perf stat -B -r3 \
                ./smash \
                -i ${SCRIPTPATH}/configs/${YAML_DIR}/config.yaml \
                -d ${DECAYM_DIR}/decaymodes.txt \
                -p ${PART_DIR}/particles.txt \
-               2>&1 >/dev/null)
+               -c 'General: { Memory_Tracking: true }' \
+               2>&1 >"${RUN_LOG}")
   fi
   echo "$PERF_OUT"
 }
 
+# Append the results of the last run as JSON object to JSON_RESULTS.
+# The wall time is the mean over the repetitions of perf, while events,
+# interactions and the peak resident memory are taken from the SMASH output.
+json_results() {
+  local NAME CONFIG PERF WALL_TIME WALL_TIME_ERROR EVENTS INTERACTIONS PEAK_RSS
+  NAME=$1
+  CONFIG=$2
+  PERF=$3
+  WALL_TIME=$(echo "$PERF" | awk '/seconds time elapsed/ {print $1}')
+  WALL_TIME_ERROR=$(echo "$PERF" | awk '/seconds time elapsed/ {print ($2 == "+-") ? $3 : 0}')
+  # The output of all three repetitions is in the log
+  EVENTS=$(grep -c 'Interactions in the event' "${RUN_LOG}" | awk '{print $1 / 3}')
+  INTERACTIONS=$(grep -oE 'performed: [0-9]+' "${RUN_LOG}" \
+                 | awk '{n += $2} END {print n / 3}')
+  PEAK_RSS=$(awk '/^Resident \(process\)/ && $4 > max {max = $4} END {print max + 0}' "${RUN_LOG}")
+  JSON_RESULTS+="${JSON_RESULTS:+,
+}    \"${NAME}\": {
+      \"config\": \"${CONFIG}\",
+      \"wall_time_s\": ${WALL_TIME:-0},
+      \"wall_time_error_s\": ${WALL_TIME_ERROR:-0},
+      \"events\": ${EVENTS},
+      \"events_per_s\": $(awk -v n="${EVENTS}" -v t="${WALL_TIME:-0}" 'BEGIN {print (t > 0) ? n / t : 0}'),
+      \"interactions\": ${INTERACTIONS},
+      \"interactions_per_s\": $(awk -v n="${INTERACTIONS}" -v t="${WALL_TIME:-0}" 'BEGIN {print (t > 0) ? n / t : 0}'),
+      \"peak_rss_mib\": ${PEAK_RSS}
+    }"
+}
+
 # Defaults
 PART_DEF="${SMASH_ROOT}/input"
 DECAYM_DEF="${SMASH_ROOT}/input"
@@ -102,38 +137,52 @@ DECAYM_DEF="${SMASH_ROOT}/input"
 echo "   Started benchmark for collider ..."
 coll_perf=$(benchmark_run collider $DECAYM_DEF $PART_DEF)
 echo "$coll_perf" | grep -E "time elapsed"
+json_results "Collider Run (AuAu@1.23)" collider "$coll_perf"
 
 echo "   Started benchmark for timestepless ..."
 nots_perf=$(benchmark_run collider $DECAYM_DEF $PART_DEF 'General: { Time_Step_Mode: None }')
 echo "$nots_perf" | grep -E "time elapsed"
+json_results "Collider Run without Timesteps" collider "$nots_perf"
 
 echo "   Started benchmark for box ..."
 box_perf=$(benchmark_run box "${SMASH_ROOT}/input/box" "${SMASH_ROOT}/input/box")
 echo "$box_perf" | grep -E "time elapsed"
+json_results "Box Run" box "$box_perf"
+
+echo "   Started benchmark for box with multi-particle reactions ..."
+multi_box_perf=$(benchmark_run box/multi_particle "${SMASH_ROOT}/input/multi_particle_box" "${SMASH_ROOT}/input/multi_particle_box")
+echo "$multi_box_perf" | grep -E "time elapsed"
+json_results "Box Run with Multi-Particle Reactions" box/multi_particle "$multi_box_perf"
 
 echo "   Started benchmark for sphere ..."
 sphere_perf=$(benchmark_run sphere $DECAYM_DEF $PART_DEF)
 echo "$sphere_perf" | grep -E "time elapsed"
+json_results "Sphere Run" sphere "$sphere_perf"
 
 echo "   Started benchmark for dileptons ..."
 dilepton_perf=$(benchmark_run dileptons "${SMASH_ROOT}/input/dileptons" $PART_DEF)
 echo "$dilepton_perf" | grep -E "time elapsed"
+json_results "Dilepton Run" dileptons "$dilepton_perf"
 
 echo "   Started benchmark for photons ..."
 photons_perf=$(benchmark_run photons "${SCRIPTPATH}/configs/photons" "${SCRIPTPATH}/configs/photons")
 echo "$photons_perf" | grep -E "time elapsed"
+json_results "Photons Run" photons "$photons_perf"
 
 echo "   Started benchmark for testparticles ..."
 testp_perf=$(benchmark_run testparticles $DECAYM_DEF $PART_DEF)
 echo "$testp_perf" | grep -E "time elapsed"
+json_results "Collider Run with Testparticles (CuCu@1.23)" testparticles "$testp_perf"
 
 echo "   Started benchmark for potentials ..."
 potentials_perf=$(benchmark_run potentials $DECAYM_DEF $PART_DEF)
 echo "$potentials_perf" | grep -E "time elapsed"
+json_results "Potentials Run" potentials "$potentials_perf"
 
 echo "   Started benchmark for high-energy collisions ..."
 high_energy_perf=$(benchmark_run high_energy $DECAYM_DEF $PART_DEF)
 echo "$high_energy_perf" | grep -E "time elapsed"
+json_results "High-energy collision Run" high_energy "$high_energy_perf"
 
 
 OUTPUT_FILE=${SCRIPTPATH}/bm-results-${SMASH_VER_NUM}.md
@@ -179,6 +228,12 @@ $nots_perf
 $box_perf
 \`\`\`
 
+### Box Run with Multi-Particle Reactions
+Dense box with the stochastic criterion and 3-to-1 and 3-to-2 reactions.
+\`\`\`
+$multi_box_perf
+\`\`\`
+
 ### Sphere Run
 \`\`\`
 $sphere_perf
@@ -214,3 +269,14 @@ $high_energy_perf
 \`\`\`
 EOF
 echo "Results are written to $OUTPUT_FILE"
+
+JSON_FILE=${SCRIPTPATH}/bm-results-${SMASH_VER_NUM}.json
+cat > ${JSON_FILE}<<EOF
+{
+  "smash_version": "${SMASH_VER_NUM}",
+  "benchmarks": {
+${JSON_RESULTS}
+  }
+}
+EOF
+echo "Machine-readable results are written to $JSON_FILE"
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+#===================================================
+#
+#    Copyright (c) 2024
+#      SMASH Team
+#
+#    GNU General Public License (GPLv3 or later)
+#
+#===================================================
+
+"""Compares two JSON benchmark results written by benchmark.bash and fails
+with a non-zero exit code if any benchmark regressed beyond the tolerances.
+
+Example:
+    ./check_benchmark_regressions.py bm-results-SMASH-old.json \\
+        bm-results-SMASH-new.json --max-slowdown 5 --max-memory-increase 10
+"""
+
+import argparse
+import json
+import sys
+
+# Quantity in the JSON results, label, whether larger values are better and
+# the option to set its tolerance
+METRICS = [
+    ("wall_time_s", "Wall time {s}", False, "max_slowdown"),
+    ("events_per_s", "Events/s", True, "max_slowdown"),
+    ("interactions_per_s", "Interactions/s", True, "max_slowdown"),
+    ("peak_rss_mib", "Peak RSS {MiB}", False, "max_memory_increase"),
+]
+
+
+def relative_change(old, new, larger_is_better):
+    """Returns the change from old to new in percent, positive if worse."""
+    if old == 0:
+        return 0.0
+    change = (new - old) / old * 100
+    return -change if larger_is_better else change
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("reference", help="JSON results to compare against")
+    parser.add_argument("candidate", help="JSON results to be checked")
+    parser.add_argument("--max-slowdown", type=float, default=5.0,
+                        help="tolerated increase of the wall time and "
+                        "decrease of the rates in percent (default: 5)")
+    parser.add_argument("--max-memory-increase", type=float, default=10.0,
+                        help="tolerated increase of the peak resident memory "
+                        "in percent (default: 10)")
+    parser.add_argument("--noise-sigmas", type=float, default=2.0,
+                        help="wall time changes within this many combined "
+                        "standard errors of perf are not counted as "
+                        "regressions (default: 2)")
+    args = parser.parse_args()
+
+    with open(args.reference) as f:
+        reference = json.load(f)
+    with open(args.candidate) as f:
+        candidate = json.load(f)
+
+    regressions = []
+    print(f"{'BENCHMARK':45s}{'QUANTITY':>16s}{reference['smash_version']:>22s}"
+          f"{candidate['smash_version']:>22s}{'Worse by':>10s}")
+    for name, old in reference["benchmarks"].items():
+        new = candidate["benchmarks"].get(name)
+        if new is None:
+            print(f"{name:45s} missing in {args.candidate}")
+            continue
+        # Changes within the measurement uncertainty are no regressions
+        noise = (args.noise_sigmas *
+                 (old["wall_time_error_s"]**2 + new["wall_time_error_s"]**2)**.5)
+        within_noise = abs(new["wall_time_s"] - old["wall_time_s"]) <= noise
+        for key, label, larger_is_better, tolerance in METRICS:
+            change = relative_change(old[key], new[key], larger_is_better)
+            regressed = (change > getattr(args, tolerance) and
+                         not (tolerance == "max_slowdown" and within_noise))
+            if regressed:
+                regressions.append(f"{name}: {label}")
+            print(f"{name:45s}{label:>16s}{old[key]:22g}{new[key]:22g}"
+                  f"{change:+9.2f}%{'  REGRESSION' if regressed else ''}")
+
+    if regressions:
+        print("\nRegressions beyond the tolerances:")
+        for regression in regressions:
+            print(f"  - {regression}")
+        return 1
+    print("\nNo regressions beyond the tolerances.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -128,12 +128,20 @@ std::pair<FourVector, FourVector> Action::get_potential_at_interaction_point()
 double Action::perform(Particles *particles, uint32_t id_process) {
   assert(id_process != 0);
   double energy_violation = 0.;
-  for (ParticleData &p : outgoing_particles_) {
+  for (std::size_t i = 0; i < outgoing_particles_.size(); i++) {
+    ParticleData &p = outgoing_particles_[i];
     // store the history info
     if (process_type_ != ProcessType::Wall) {
       p.set_history(p.get_history().collisions_per_particle + 1, id_process,
                     process_type_, time_of_execution_, incoming_particles_);
     }
+    /* The products stay in the subensemble of the incoming particles. If
+     * these are from several subensembles, which is only the case for
+     * thermalization, the products are distributed over them. */
+    if (!incoming_particles_.empty()) {
+      p.set_subensemble(
+          incoming_particles_[i % incoming_particles_.size()].subensemble());
+    }
   }
 
   /* For elastic collisions and box wall crossings it is not necessary to remove
@@ -430,9 +438,7 @@ void Action::sample_manybody_phasespace_impl(
                           << std::endl;
 
     // Boost the first i+1 particles to the next CM frame
-    for (size_t j = 0; j <= i + 1; j++) {
-      sampled_momenta[j] = sampled_momenta[j].lorentz_boost(beta[i]);
-    }
+    LorentzBoost(beta[i]).apply(sampled_momenta.data(), i + 2);
   }
 
   FourVector ptot_all = FourVector(0.0, 0.0, 0.0, 0.0);
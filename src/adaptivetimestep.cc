@@ -0,0 +1,74 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/adaptivetimestep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "smash/particles.h"
+
+namespace smash {
+
+AdaptiveTimeStep::AdaptiveTimeStep(const AdaptiveTimeStepParameters &parameters)
+    : parameters_(parameters) {
+  if (!(parameters.min_dt > 0.) || !(parameters.max_dt >= parameters.min_dt)) {
+    throw std::invalid_argument(
+        "The adaptive time step needs 0 < Minimum_Delta_Time <= "
+        "Maximum_Delta_Time.");
+  }
+  if (!(parameters.actions_per_particle > 0.) ||
+      !(parameters.lattice_cell_fraction > 0.) ||
+      !(parameters.momentum_kick > 0.)) {
+    throw std::invalid_argument(
+        "The targets of the adaptive time step have to be positive.");
+  }
+}
+
+double AdaptiveTimeStep::next_timestep(
+    double dt, const TimeStepObservables &observables) const {
+  double next = std::min(parameters_.max_dt, 2. * dt);
+  if (observables.n_actions > 0 && observables.n_particles > 0) {
+    // Number of actions per particle scales linearly with the time step.
+    next = std::min(next, parameters_.actions_per_particle * dt *
+                              observables.n_particles /
+                              observables.n_actions);
+  }
+  if (observables.min_lattice_spacing > 0. && observables.max_velocity > 0.) {
+    next = std::min(next, parameters_.lattice_cell_fraction *
+                              observables.min_lattice_spacing /
+                              observables.max_velocity);
+  }
+  if (observables.max_force > 0.) {
+    next = std::min(next, parameters_.momentum_kick / observables.max_force);
+  }
+  return std::max(next, parameters_.min_dt);
+}
+
+double max_velocity(const std::vector<Particles> &ensembles) {
+  double v_max_sqr = 0.;
+  for (const Particles &particles : ensembles) {
+    for (const ParticleData &data : particles) {
+      v_max_sqr = std::max(v_max_sqr, data.velocity().sqr());
+    }
+  }
+  return std::sqrt(v_max_sqr);
+}
+
+double max_force(
+    const RectangularLattice<std::pair<ThreeVector, ThreeVector>> &forces) {
+  double f_max = 0.;
+  for (const auto &[E, B] : forces) {
+    f_max = std::max(f_max, E.abs() + B.abs());
+  }
+  return f_max;
+}
+
+}  // namespace smash
@@ -0,0 +1,591 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/analysisoutput.h"
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+
+#include "smash/action.h"
+#include "smash/clock.h"
+#include "smash/config.h"
+#include "smash/logging.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+EventHistogram::EventHistogram(double min, double max, std::size_t n_bins)
+    : min_(min),
+      max_(max),
+      width_((max - min) / n_bins),
+      current_(n_bins, 0.),
+      sum_(n_bins, 0.),
+      sum_sq_(n_bins, 0.) {
+  if (n_bins == 0 || !(max > min)) {
+    throw std::invalid_argument(
+        "A histogram needs at least one bin and an upper edge above the lower "
+        "edge.");
+  }
+}
+
+void EventHistogram::end_event() {
+  for (std::size_t i = 0; i < current_.size(); i++) {
+    sum_[i] += current_[i];
+    sum_sq_[i] += current_[i] * current_[i];
+    current_[i] = 0.;
+  }
+}
+
+double EventHistogram::mean(std::size_t i, std::size_t n_events) const {
+  return n_events > 0 ? sum_.at(i) / n_events : 0.;
+}
+
+double EventHistogram::error(std::size_t i, std::size_t n_events) const {
+  if (n_events < 2) {
+    return 0.;
+  }
+  const double mean_value = mean(i, n_events);
+  const double variance = sum_sq_.at(i) / n_events - mean_value * mean_value;
+  return std::sqrt(std::max(variance, 0.) / (n_events - 1));
+}
+
+namespace {
+/**
+ * Create a histogram from its configured binning.
+ * \param[in] bins Lower edge, upper edge and number of bins.
+ * \return Empty histogram.
+ * \throw std::invalid_argument if the binning is invalid.
+ */
+EventHistogram make_histogram(const std::array<double, 3> &bins) {
+  if (!(bins[2] >= 1.)) {
+    throw std::invalid_argument("A histogram needs at least one bin.");
+  }
+  return EventHistogram(bins[0], bins[1], static_cast<std::size_t>(bins[2]));
+}
+
+/**
+ * Check the settings of the analysis before any file is created.
+ * \param[in] par Settings of the analysis.
+ * \return The unchanged settings.
+ * \throw std::invalid_argument if no species are given.
+ */
+const AnalysisOutputParameters &validated(const AnalysisOutputParameters &par) {
+  if (par.species.empty()) {
+    throw std::invalid_argument("The analysis output needs some Species.");
+  }
+  return par;
+}
+}  // namespace
+
+AnalysisOutput::AnalysisOutput(const std::filesystem::path &path,
+                               const std::string &name,
+                               const OutputParameters &out_par)
+    : OutputInterface(name),
+      parameters_(validated(out_par.analysis_parameters)),
+      file_{path / "analysis.dat", "w"},
+      participants_(0., std::numeric_limits<double>::max(), 1) {
+  const std::size_t n_pt_bins = make_histogram(parameters_.pt_bins).n_bins();
+  const std::size_t n_harmonics = parameters_.flow_harmonics.size();
+  for (const int pdg : parameters_.species) {
+    if (species_index_.count(pdg) > 0) {
+      continue;
+    }
+    species_index_[pdg] = species_.size();
+    species_.push_back(
+        {pdg, EventHistogram(0., 1., 1),
+         make_histogram(parameters_.rapidity_bins),
+         make_histogram(parameters_.pt_bins),
+         std::vector<std::vector<double>>(n_harmonics,
+                                          std::vector<double>(n_pt_bins, 0.)),
+         std::vector<std::vector<double>>(n_harmonics,
+                                          std::vector<double>(n_pt_bins, 0.)),
+         std::vector<double>(n_pt_bins, 0.)});
+  }
+}
+
+AnalysisOutput::~AnalysisOutput() { write_results(); }
+
+void AnalysisOutput::at_eventstart(const Particles &particles,
+                                   const int event_number,
+                                   const EventInfo & /*info*/) {
+  int last_id = -1;
+  for (const ParticleData &p : particles) {
+    last_id = std::max(last_id, p.id());
+  }
+  initial_particles_[event_number] = {last_id, particles.size()};
+}
+
+void AnalysisOutput::at_eventend(const Particles &particles,
+                                 const int event_number,
+                                 const EventInfo & /*info*/) {
+  // Initial particles that never interacted are spectators.
+  const auto initial = initial_particles_.find(event_number);
+  if (initial != initial_particles_.end()) {
+    const auto [last_initial_id, n_initial] = initial->second;
+    std::size_t n_spectators = 0;
+    for (const ParticleData &p : particles) {
+      if (p.id() <= last_initial_id &&
+          p.get_history().collisions_per_particle == 0) {
+        n_spectators++;
+      }
+    }
+    participants_.fill(0., static_cast<double>(n_initial - n_spectators));
+    initial_particles_.erase(initial);
+  }
+
+  const double pt_min = parameters_.pt_bins[0];
+  const double pt_width = species_.front().dn_dpt.bin_width();
+  for (const ParticleData &p : particles) {
+    const auto index = species_index_.find(p.pdgcode().get_decimal());
+    if (index == species_index_.end()) {
+      continue;
+    }
+    SpeciesObservables &obs = species_[index->second];
+    const FourVector mom = p.momentum();
+    const double y = 0.5 * std::log((mom.x0() + mom.x3()) /
+                                    (mom.x0() - mom.x3()));
+    obs.yield.fill(0.);
+    obs.dn_dy.fill(y);
+    if (std::abs(y) >= parameters_.midrapidity_cut) {
+      continue;
+    }
+    const double pt = std::hypot(mom.x1(), mom.x2());
+    obs.dn_dpt.fill(pt);
+    const double bin = std::floor((pt - pt_min) / pt_width);
+    if (bin < 0. || bin >= static_cast<double>(obs.flow_count.size())) {
+      continue;
+    }
+    const std::size_t i_pt = static_cast<std::size_t>(bin);
+    // The reaction plane is spanned by the beam axis and the x axis.
+    const double phi = std::atan2(mom.x2(), mom.x1());
+    obs.flow_count[i_pt] += 1.;
+    for (std::size_t h = 0; h < parameters_.flow_harmonics.size(); h++) {
+      const double c = std::cos(parameters_.flow_harmonics[h] * phi);
+      obs.flow_sum[h][i_pt] += c;
+      obs.flow_sum_sq[h][i_pt] += c * c;
+    }
+  }
+
+  participants_.end_event();
+  for (SpeciesObservables &obs : species_) {
+    obs.yield.end_event();
+    obs.dn_dy.end_event();
+    obs.dn_dpt.end_event();
+  }
+  n_events_++;
+}
+
+double AnalysisOutput::mean_participants() const {
+  return participants_.mean(0, n_events_);
+}
+
+/*!\Userguide
+ * \page doxypage_output_analysis
+ * The analysis output evaluates common observables of the final particles
+ * while SMASH runs, so that no particle lists have to be written and read
+ * again for them. It is requested with the `Analysis` content and the
+ * `"ASCII"` format, see \ref input_output_analysis_ for its options. Each
+ * ensemble counts as an event.
+ *
+ * At the end of the run, the file \c analysis.dat is written. After a header
+ * with the SMASH version, the number of events and the average number of
+ * participants, i.e. of the initial particles that interacted at least
+ * once, it contains the following blocks for each species:
+ * \li the yield, i.e. the average number of particles per event,
+ * \li the rapidity spectrum \f$dN/dy\f$ per event,
+ * \li the transverse momentum spectrum \f$dN/dp_T\f$ per event of the
+ * particles with \f$|y|\f$ below the `Midrapidity_Cut` and
+ * \li the anisotropic flow coefficients \f$v_n = \langle \cos(n\phi)
+ * \rangle\f$ of the same particles per bin of \f$p_T\f$, with \f$\phi\f$ the
+ * azimuthal angle with respect to the x axis, which is the direction of the
+ * impact parameter in collider setups.
+ *
+ * Every line of a block gives the lower and upper edge of a bin followed by
+ * the value and its statistical error; for the flow coefficients a value and
+ * an error follow for each harmonic. Lines starting with \c # are comments.
+ * The spectra and their errors are evaluated from the event-by-event
+ * fluctuations of the bin contents.
+ */
+void AnalysisOutput::write_results() {
+  std::FILE *out = file_.get();
+  std::fprintf(out, "# SMASH analysis output\n# %s\n", SMASH_VERSION);
+  std::fprintf(out, "# events %zu\n", n_events_);
+  std::fprintf(out, "# participants %g %g\n", mean_participants(),
+               participants_.error(0, n_events_));
+  for (const SpeciesObservables &obs : species_) {
+    std::fprintf(out, "\n# species %i\n", obs.pdg);
+    std::fprintf(out, "# yield %g %g\n", obs.yield.mean(0, n_events_),
+                 obs.yield.error(0, n_events_));
+    std::fprintf(out, "# dN/dy\n# y_low y_high dN/dy error\n");
+    const EventHistogram &dn_dy = obs.dn_dy;
+    for (std::size_t i = 0; i < dn_dy.n_bins(); i++) {
+      std::fprintf(out, "%g %g %g %g\n", dn_dy.bin_low(i), dn_dy.bin_low(i + 1),
+                   dn_dy.mean(i, n_events_) / dn_dy.bin_width(),
+                   dn_dy.error(i, n_events_) / dn_dy.bin_width());
+    }
+    std::fprintf(out, "# dN/dpT at |y| < %g\n# pT_low pT_high dN/dpT error\n",
+                 parameters_.midrapidity_cut);
+    const EventHistogram &dn_dpt = obs.dn_dpt;
+    for (std::size_t i = 0; i < dn_dpt.n_bins(); i++) {
+      std::fprintf(out, "%g %g %g %g\n", dn_dpt.bin_low(i),
+                   dn_dpt.bin_low(i + 1),
+                   dn_dpt.mean(i, n_events_) / dn_dpt.bin_width(),
+                   dn_dpt.error(i, n_events_) / dn_dpt.bin_width());
+    }
+    if (parameters_.flow_harmonics.empty()) {
+      continue;
+    }
+    std::fprintf(out, "# flow at |y| < %g\n# pT_low pT_high",
+                 parameters_.midrapidity_cut);
+    for (const int n : parameters_.flow_harmonics) {
+      std::fprintf(out, " v%i error", n);
+    }
+    std::fprintf(out, "\n");
+    for (std::size_t i = 0; i < obs.flow_count.size(); i++) {
+      std::fprintf(out, "%g %g", dn_dpt.bin_low(i), dn_dpt.bin_low(i + 1));
+      const double count = obs.flow_count[i];
+      for (std::size_t h = 0; h < parameters_.flow_harmonics.size(); h++) {
+        const double v = count > 0. ? obs.flow_sum[h][i] / count : 0.;
+        const double variance =
+            count > 0. ? obs.flow_sum_sq[h][i] / count - v * v : 0.;
+        const double error =
+            count > 1. ? std::sqrt(std::max(variance, 0.) / (count - 1.)) : 0.;
+        std::fprintf(out, " %g %g", v, error);
+      }
+      std::fprintf(out, "\n");
+    }
+  }
+}
+
+EmissionHistogramOutput::EmissionHistogramOutput(
+    const std::filesystem::path &path, const std::string &name,
+    const OutputParameters &out_par)
+    : OutputInterface(name),
+      empty_{make_histogram(is_dilepton_output()
+                                ? out_par.dil_histograms.mass_bins
+                                : std::array<double, 3>{0., 1., 1.}),
+             make_histogram(is_dilepton_output()
+                                ? out_par.dil_histograms.pt_bins
+                                : out_par.photons_histograms.pt_bins),
+             make_histogram(is_dilepton_output()
+                                ? out_par.dil_histograms.rapidity_bins
+                                : out_par.photons_histograms.rapidity_bins)},
+      total_(empty_),
+      file_{path / (name + "_histograms.dat"), "w"} {}
+
+EmissionHistogramOutput::~EmissionHistogramOutput() { write_results(); }
+
+void EmissionHistogramOutput::at_interaction(const Action &action,
+                                             const double /*density*/) {
+  // The emitted lepton pair or photon
+  FourVector momentum;
+  std::string channel;
+  for (const ParticleData &p : action.outgoing_particles()) {
+    if (is_dilepton_output() ? p.type().is_lepton()
+                             : p.pdgcode().code() == pdg::photon) {
+      momentum += p.momentum();
+    }
+  }
+  for (const ParticleData &p : action.incoming_particles()) {
+    channel += (channel.empty() ? "" : " + ") + p.type().name();
+  }
+  const double weight = action.get_total_weight();
+  const double pt = std::hypot(momentum.x1(), momentum.x2());
+  const double y = 0.5 * std::log((momentum.x0() + momentum.x3()) /
+                                  (momentum.x0() - momentum.x3()));
+  auto fill = [&](Spectra &spectra) {
+    if (is_dilepton_output()) {
+      spectra.mass.fill(momentum.abs(), weight);
+    }
+    spectra.pt.fill(pt, weight);
+    spectra.rapidity.fill(y, weight);
+  };
+  fill(total_);
+  fill(channels_.try_emplace(channel, empty_).first->second);
+}
+
+void EmissionHistogramOutput::at_eventend(
+    const std::vector<Particles> &ensembles, const int /*event_number*/) {
+  /* The ensembles of an event are one sample, since their emissions are not
+   * told apart. The spectra are normalised to a single ensemble. */
+  n_ensembles_ = std::max<std::size_t>(ensembles.size(), 1);
+  auto end_event = [](Spectra &spectra) {
+    spectra.mass.end_event();
+    spectra.pt.end_event();
+    spectra.rapidity.end_event();
+  };
+  end_event(total_);
+  for (auto &channel : channels_) {
+    end_event(channel.second);
+  }
+  n_samples_++;
+}
+
+/*!\Userguide
+ * \page doxypage_output_emission_histograms
+ * The `"Histograms"` format of the `Dileptons` and `Photons` contents
+ * accumulates the spectra of the weighted dileptons or photons while SMASH
+ * runs, so that the large files of all emissions with their weights need not
+ * be written and histogrammed afterwards. The binning is set with the
+ * `Mass_Bins` (dileptons only), `Transverse_Momentum_Bins` and
+ * `Rapidity_Bins` options of the content, see \ref
+ * input_output_emission_histograms_.
+ *
+ * At the end of the run, the file \c Dileptons_histograms.dat or
+ * \c Photons_histograms.dat is written. After a header with the SMASH version
+ * and the number of events, it contains the spectra of all emissions and then
+ * of every channel. The channel of a dilepton is the decaying hadron, the one
+ * of a photon the incoming hadrons of its reaction. Each spectrum gives the
+ * weighted number of emissions per event and bin width, e.g.
+ * \f$dN/dM\f$, for every bin with its lower and upper edge and its
+ * statistical error from the event-by-event fluctuations. With several
+ * ensembles, the spectra are normalised to a single ensemble. Lines starting
+ * with \c # are comments.
+ */
+void EmissionHistogramOutput::write_results() {
+  std::FILE *out = file_.get();
+  std::fprintf(out, "# SMASH %s histograms\n# %s\n",
+               is_dilepton_output() ? "dilepton" : "photon", SMASH_VERSION);
+  std::fprintf(out, "# events %zu\n", n_events());
+  const double norm = 1. / n_ensembles_;
+  auto write_histogram = [&](const EventHistogram &h, const char *quantity) {
+    std::fprintf(out, "# dN/d%s\n# %s_low %s_high dN/d%s error\n", quantity,
+                 quantity, quantity, quantity);
+    for (std::size_t i = 0; i < h.n_bins(); i++) {
+      std::fprintf(out, "%g %g %g %g\n", h.bin_low(i), h.bin_low(i + 1),
+                   norm * h.mean(i, n_samples_) / h.bin_width(),
+                   norm * h.error(i, n_samples_) / h.bin_width());
+    }
+  };
+  auto write_spectra = [&](const Spectra &spectra, const std::string &name) {
+    std::fprintf(out, "\n# channel %s\n", name.c_str());
+    if (is_dilepton_output()) {
+      write_histogram(spectra.mass, "M");
+    }
+    write_histogram(spectra.pt, "pT");
+    write_histogram(spectra.rapidity, "y");
+  };
+  write_spectra(total_, "total");
+  for (const auto &channel : channels_) {
+    write_spectra(channel.second, channel.first);
+  }
+}
+
+MultiTauCorrelator::MultiTauCorrelator(std::size_t points_per_level,
+                                       std::size_t levels) {
+  if (points_per_level < averaging_ || points_per_level % averaging_ != 0 ||
+      levels == 0) {
+    throw std::invalid_argument(
+        "A multi-tau correlator needs at least one level and an even number "
+        "of at least two points per level.");
+  }
+  levels_.resize(levels);
+  for (std::size_t l = 0; l < levels; l++) {
+    Level &level = levels_[l];
+    level.values.assign(points_per_level, 0.);
+    level.sum.assign(points_per_level, 0.);
+    level.count.assign(points_per_level, 0);
+    // Shorter lags of the coarser levels are covered by the finer ones.
+    const std::size_t first = l == 0 ? 0 : points_per_level / averaging_;
+    std::size_t stride = 1;
+    for (std::size_t k = 0; k < l; k++) {
+      stride *= averaging_;
+    }
+    for (std::size_t j = first; j < points_per_level; j++) {
+      lags_.emplace_back(j * stride, l);
+    }
+  }
+}
+
+void MultiTauCorrelator::start_series() {
+  for (Level &level : levels_) {
+    level.filled = 0;
+    level.accumulated = 0.;
+    level.n_accumulated = 0;
+  }
+}
+
+void MultiTauCorrelator::add(double value, std::size_t l) {
+  if (l >= levels_.size()) {
+    return;
+  }
+  Level &level = levels_[l];
+  const std::size_t p = level.values.size();
+  level.newest = (level.newest + p - 1) % p;
+  level.values[level.newest] = value;
+  level.filled = std::min(level.filled + 1, p);
+  const std::size_t first = l == 0 ? 0 : p / averaging_;
+  for (std::size_t j = first; j < level.filled; j++) {
+    level.sum[j] += value * level.values[(level.newest + j) % p];
+    level.count[j]++;
+  }
+  level.accumulated += value;
+  if (++level.n_accumulated == averaging_) {
+    const double mean = level.accumulated / averaging_;
+    level.accumulated = 0.;
+    level.n_accumulated = 0;
+    add(mean, l + 1);
+  }
+}
+
+double MultiTauCorrelator::correlation(std::size_t i) const {
+  const auto [lag, l] = lags_.at(i);
+  const Level &level = levels_[l];
+  const std::size_t j = lag >> l;
+  return level.count[j] > 0 ? level.sum[j] / level.count[j] : 0.;
+}
+
+namespace {
+/**
+ * Check the settings of the Green-Kubo output before any file is created.
+ * \param[in] par Settings of the correlators.
+ * \return The unchanged settings.
+ * \throw std::invalid_argument if the settings are out of range.
+ */
+const GreenKuboOutputParameters &validated(
+    const GreenKuboOutputParameters &par) {
+  if (par.points_per_level < 2 || par.points_per_level % 2 != 0 ||
+      par.levels < 1) {
+    throw std::invalid_argument(
+        "The Green-Kubo output needs at least one level and an even number of "
+        "at least two points per level.");
+  }
+  return par;
+}
+}  // namespace
+
+GreenKuboOutput::GreenKuboOutput(const std::filesystem::path &path,
+                                 const std::string &name,
+                                 const OutputParameters &out_par)
+    : OutputInterface(name),
+      parameters_(validated(out_par.green_kubo_parameters)),
+      file_{path / "green_kubo.dat", "w"} {}
+
+GreenKuboOutput::~GreenKuboOutput() { write_results(); }
+
+void GreenKuboOutput::at_eventstart(const std::vector<Particles> &ensembles,
+                                    const int /*event_number*/) {
+  const MultiTauCorrelator empty(parameters_.points_per_level,
+                                 parameters_.levels);
+  correlators_.resize(ensembles.size(),
+                      std::vector<MultiTauCorrelator>(NSignals, empty));
+  for (auto &correlators : correlators_) {
+    for (MultiTauCorrelator &correlator : correlators) {
+      correlator.start_series();
+    }
+  }
+  last_time_.reset();
+}
+
+void GreenKuboOutput::at_intermediate_time(
+    const std::vector<Particles> &ensembles,
+    const std::unique_ptr<Clock> &clock,
+    const DensityParameters & /*dens_param*/) {
+  const double time = clock->current_time();
+  if (last_time_) {
+    const double interval = time - *last_time_;
+    if (interval_ == 0.) {
+      interval_ = interval;
+    } else if (std::abs(interval - interval_) > 1e-6 * interval_ &&
+               !interval_warned_) {
+      logg[LOutput].warn("The Green-Kubo output needs equidistant output "
+                         "times, but the interval changed from ",
+                         interval_, " fm to ", interval, " fm.");
+      interval_warned_ = true;
+    }
+  }
+  last_time_ = time;
+
+  for (std::size_t i_ens = 0; i_ens < ensembles.size(); i_ens++) {
+    // T^{ij} = sum p^i p^j / E and j^i = sum q p^i / E over the box
+    std::array<double, NSignals> signal{};
+    for (const ParticleData &p : ensembles[i_ens]) {
+      const FourVector mom = p.momentum();
+      const double inv_e = 1. / mom.x0();
+      signal[ShearXY] += mom.x1() * mom.x2() * inv_e;
+      signal[ShearXZ] += mom.x1() * mom.x3() * inv_e;
+      signal[ShearYZ] += mom.x2() * mom.x3() * inv_e;
+      for (int i = 0; i < 3; i++) {
+        const double velocity = mom[i + 1] * inv_e;
+        signal[ChargeX + i] += p.type().charge() * velocity;
+        signal[BaryonX + i] += p.type().baryon_number() * velocity;
+      }
+    }
+    for (int s = 0; s < NSignals; s++) {
+      correlators_.at(i_ens)[s].add(signal[s]);
+    }
+  }
+}
+
+double GreenKuboOutput::correlation(Signal first, int n, std::size_t i) const {
+  double sum = 0.;
+  for (const auto &correlators : correlators_) {
+    for (int s = first; s < first + n; s++) {
+      sum += correlators[s].correlation(i);
+    }
+  }
+  return correlators_.empty() ? 0. : sum / (n * correlators_.size());
+}
+
+/*!\Userguide
+ * \page doxypage_output_green_kubo
+ * The Green-Kubo output accumulates the equilibrium correlation functions of
+ * the energy-momentum tensor and of the charge currents while SMASH runs, so
+ * that transport coefficients can be evaluated from a box in equilibrium
+ * without writing the particles at every output time. It is requested with
+ * the `Green_Kubo` content and the `"ASCII"` format, see \ref
+ * input_output_green_kubo_ for its options.
+ *
+ * At every output time, the volume-integrated quantities
+ * \f[ T^{ij} = \sum_a \frac{p_a^i p_a^j}{E_a} \quad \text{and} \quad
+ *     J_Q^i = \sum_a Q_a \frac{p_a^i}{E_a}, \quad
+ *     J_B^i = \sum_a B_a \frac{p_a^i}{E_a} \f]
+ * of each ensemble are added to multi-tau correlators, which estimate
+ * \f$\langle A(t) A(t + \tau) \rangle\f$ at lags up to
+ * \f$p\,2^{L-1}\f$ output intervals with memory proportional to the number
+ * of levels \f$L\f$, independent of the length of the run. The lags of level
+ * \f$l > 0\f$ are sampled on intervals of \f$2^l\f$ output intervals. The
+ * output times have to be equidistant, which is the case for the usual
+ * `Output_Interval`. In a box, the correlation starts at the equilibration
+ * time.
+ *
+ * At the end of the run, the file \c green_kubo.dat is written. After a
+ * header with the SMASH version and the output interval, every line gives
+ * the lag \f$\tau\f$ in fm and the correlation functions
+ * \li \f$C_\eta(\tau)\f$, the average of the correlations of
+ * \f$T^{xy}\f$, \f$T^{xz}\f$ and \f$T^{yz}\f$ in GeV²,
+ * \li \f$C_Q(\tau)\f$ and \f$C_B(\tau)\f$, the averages of the correlations
+ * of the three components of the electric and baryon current,
+ *
+ * averaged over the ensembles and events. The quantities are integrated over
+ * the volume \f$V\f$, so that e.g. the shear viscosity follows as
+ * \f$\eta = \frac{1}{VT} \int_0^\infty C_\eta(\tau)\, d\tau\f$ and the
+ * electric conductivity as \f$\sigma = \frac{e^2}{VT} \int_0^\infty
+ * C_Q(\tau)\, d\tau\f$, up to the conversion of units with \f$\hbar c\f$. Lines starting with \c # are comments.
+ */
+void GreenKuboOutput::write_results() {
+  std::FILE *out = file_.get();
+  std::fprintf(out, "# SMASH Green-Kubo correlators\n# %s\n", SMASH_VERSION);
+  std::fprintf(out, "# output interval %g fm\n", interval_);
+  std::fprintf(out, "# tau[fm] C_shear[GeV^2] C_charge C_baryon\n");
+  if (correlators_.empty()) {
+    return;
+  }
+  const MultiTauCorrelator &first = correlators_.front().front();
+  for (std::size_t i = 0; i < first.n_lags(); i++) {
+    std::fprintf(out, "%g %g %g %g\n", first.lag(i) * interval_,
+                 correlation(ShearXY, 3, i), correlation(ChargeX, 3, i),
+                 correlation(BaryonX, 3, i));
+  }
+}
+
+}  // namespace smash
@@ -0,0 +1,204 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/arrowexport.h"
+
+#include <array>
+#include <vector>
+
+#include "smash/particles.h"
+
+namespace smash {
+namespace {
+
+/// Columns of the exported particles, in their order
+enum Column { Pdg, T, X, Y, Z, E, Px, Py, Pz, Id, NColl, NColumns };
+
+/// Names of the columns
+constexpr std::array<const char *, NColumns> column_names = {
+    "pdg", "t", "x", "y", "z", "E", "px", "py", "pz", "id", "ncoll"};
+
+/// \return whether the column holds int32 values, otherwise float64.
+bool is_integer(int column) {
+  return column == Pdg || column == Id || column == NColl;
+}
+
+/// Memory of an exported column, owned by its child array
+struct ColumnData {
+  /// Values of a float64 column
+  std::vector<double> reals;
+  /// Values of an int32 column
+  std::vector<int32_t> integers;
+  /// Validity bitmap (none) and values
+  std::array<const void *, 2> buffers{};
+};
+
+/// Memory of the exported struct array, apart from its columns
+struct ArrayData {
+  /// Arrays of the columns
+  std::array<ArrowArray, NColumns> children;
+  /// Pointers to the arrays of the columns
+  std::array<ArrowArray *, NColumns> child_pointers;
+  /// Validity bitmap (none)
+  std::array<const void *, 1> buffers{};
+};
+
+/// Memory of the exported schema
+struct SchemaData {
+  /// Schemas of the columns
+  std::array<ArrowSchema, NColumns> children;
+  /// Pointers to the schemas of the columns
+  std::array<ArrowSchema *, NColumns> child_pointers;
+};
+
+/// Release callback of the array of a column
+void release_column(ArrowArray *array) {
+  delete static_cast<ColumnData *>(array->private_data);
+  array->release = nullptr;
+}
+
+/// Release callback of the struct array, which releases the columns
+void release_array(ArrowArray *array) {
+  ArrayData *data = static_cast<ArrayData *>(array->private_data);
+  // Columns moved out of the array have been released already.
+  for (ArrowArray &child : data->children) {
+    if (child.release) {
+      child.release(&child);
+    }
+  }
+  delete data;
+  array->release = nullptr;
+}
+
+/// Release callback of the schema of a column
+void release_column_schema(ArrowSchema *schema) { schema->release = nullptr; }
+
+/// Release callback of the schema of the struct array
+void release_schema(ArrowSchema *schema) {
+  SchemaData *data = static_cast<SchemaData *>(schema->private_data);
+  for (ArrowSchema &child : data->children) {
+    if (child.release) {
+      child.release(&child);
+    }
+  }
+  delete data;
+  schema->release = nullptr;
+}
+
+/**
+ * Copy the entries of an array of the structure-of-arrays copy which hold
+ * particles.
+ *
+ * \param[in] source Array including the holes.
+ * \param[in] valid Whether an entry holds a particle.
+ * \param[out] target Entries of the particles.
+ */
+void copy_valid(const std::vector<double> &source,
+                const std::vector<char> &valid, std::vector<double> &target) {
+  target.clear();
+  for (std::size_t i = 0; i < source.size(); i++) {
+    if (valid[i]) {
+      target.push_back(source[i]);
+    }
+  }
+}
+
+}  // namespace
+
+void export_particles_to_arrow(const Particles &particles, ArrowArray *array,
+                               ArrowSchema *schema) {
+  const std::size_t n = particles.size();
+  std::array<ColumnData *, NColumns> columns;
+  for (int c = 0; c < NColumns; c++) {
+    columns[c] = new ColumnData();
+    if (is_integer(c)) {
+      columns[c]->integers.reserve(n);
+    } else {
+      columns[c]->reals.reserve(n);
+    }
+  }
+
+  if (particles.arrays_enabled()) {
+    const ParticleArrays &soa = particles.arrays();
+    const bool without_holes = soa.size() == n;
+    for (int mu = 0; mu < 4; mu++) {
+      if (without_holes) {
+        columns[T + mu]->reals = soa.position[mu];
+        columns[E + mu]->reals = soa.momentum[mu];
+      } else {
+        copy_valid(soa.position[mu], soa.valid, columns[T + mu]->reals);
+        copy_valid(soa.momentum[mu], soa.valid, columns[E + mu]->reals);
+      }
+    }
+    for (std::size_t i = 0; i < soa.size(); i++) {
+      if (soa.valid[i]) {
+        columns[Pdg]->integers.push_back(
+            soa.type[i]->pdgcode().get_decimal());
+      }
+    }
+  } else {
+    for (const ParticleData &p : particles) {
+      columns[Pdg]->integers.push_back(p.pdgcode().get_decimal());
+      for (int mu = 0; mu < 4; mu++) {
+        columns[T + mu]->reals.push_back(p.position()[mu]);
+        columns[E + mu]->reals.push_back(p.momentum()[mu]);
+      }
+    }
+  }
+  for (const ParticleData &p : particles) {
+    columns[Id]->integers.push_back(p.id());
+    columns[NColl]->integers.push_back(
+        p.get_history().collisions_per_particle);
+  }
+
+  ArrayData *array_data = new ArrayData();
+  SchemaData *schema_data = new SchemaData();
+  for (int c = 0; c < NColumns; c++) {
+    ColumnData *column = columns[c];
+    column->buffers = {nullptr, is_integer(c) ? static_cast<const void *>(
+                                                    column->integers.data())
+                                              : column->reals.data()};
+    array_data->children[c] = ArrowArray{static_cast<int64_t>(n),
+                                         0,
+                                         0,
+                                         2,
+                                         0,
+                                         column->buffers.data(),
+                                         nullptr,
+                                         nullptr,
+                                         &release_column,
+                                         column};
+    array_data->child_pointers[c] = &array_data->children[c];
+    schema_data->children[c] =
+        ArrowSchema{is_integer(c) ? "i" : "g", column_names[c], nullptr, 0, 0,
+                    nullptr, nullptr, &release_column_schema, nullptr};
+    schema_data->child_pointers[c] = &schema_data->children[c];
+  }
+  *array = ArrowArray{static_cast<int64_t>(n),
+                      0,
+                      0,
+                      1,
+                      NColumns,
+                      array_data->buffers.data(),
+                      array_data->child_pointers.data(),
+                      nullptr,
+                      &release_array,
+                      array_data};
+  *schema = ArrowSchema{"+s",
+                        "",
+                        nullptr,
+                        0,
+                        NColumns,
+                        schema_data->child_pointers.data(),
+                        nullptr,
+                        &release_schema,
+                        schema_data};
+}
+
+}  // namespace smash
@@ -0,0 +1,327 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/asyncoutput.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "smash/action.h"
+#include "smash/clock.h"
+#include "smash/logging.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+namespace {
+/**
+ * Snapshot of a performed action with the information written by the outputs,
+ * which stays valid after the action has been destroyed.
+ */
+class RecordedAction : public Action {
+ public:
+  /**
+   * Record an action.
+   * \param[in] action Performed action.
+   */
+  explicit RecordedAction(const Action &action)
+      : Action(action.incoming_particles(), action.outgoing_particles(),
+               action.time_of_execution(), action.get_type()),
+        total_weight_(action.get_total_weight()),
+        partial_weight_(action.get_partial_weight()) {}
+  double get_total_weight() const override { return total_weight_; }
+  double get_partial_weight() const override { return partial_weight_; }
+  void generate_final_state() override {
+    throw std::logic_error("A recorded action cannot be performed again.");
+  }
+  /**
+   * Writes information about the recorded action to the output stream.
+   * \param[out] out Output stream.
+   */
+  void format_debug_output(std::ostream &out) const override {
+    out << "Recorded " << process_type_ << " of " << incoming_particles_
+        << " to " << outgoing_particles_;
+  }
+
+ private:
+  /// Total weight of the recorded action
+  const double total_weight_;
+  /// Partial weight of the recorded action
+  const double partial_weight_;
+};
+
+/**
+ * Name that gives an OutputInterface the same kind as the wrapped output.
+ * \param[in] output Wrapped output.
+ * \return Name for the OutputInterface constructor.
+ */
+std::string name_of_kind(const OutputInterface &output) {
+  if (output.is_dilepton_output()) {
+    return "Dileptons";
+  } else if (output.is_photon_output()) {
+    return "Photons";
+  } else if (output.is_IC_output()) {
+    return "SMASH_IC";
+  }
+  return "";
+}
+
+/**
+ * Clock that stays at the time of a snapshot.
+ * \param[in] time Current time of the snapshot [fm].
+ * \return Clock whose current time is \p time.
+ */
+std::unique_ptr<Clock> frozen_clock(double time) {
+  auto frozen = std::make_unique<CustomClock>(std::vector<double>{time});
+  frozen->reset(time, false);
+  return frozen;
+}
+
+/**
+ * \param[in] particles Particles to be written.
+ * \return a copy of the particles, whose memory is accounted to the outputs.
+ */
+std::shared_ptr<Particles> snapshot_of(const Particles &particles) {
+  return particles.clone(MemorySubsystem::Outputs);
+}
+}  // namespace
+
+AsyncOutput::AsyncOutput(std::unique_ptr<OutputInterface> output,
+                         std::size_t capacity, Callbacks callbacks)
+    : OutputInterface(name_of_kind(*output)),
+      output_(std::move(output)),
+      capacity_(capacity),
+      callbacks_(callbacks) {
+  if (capacity_ == 0) {
+    throw std::invalid_argument(
+        "The queue of an asynchronous output needs a positive capacity.");
+  }
+  writer_ = std::thread(&AsyncOutput::write_loop, this);
+}
+
+AsyncOutput::~AsyncOutput() {
+  {
+    std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  task_queued_.notify_one();
+  writer_.join();
+  if (error_) {
+    logg[LOutput].error(
+        "An asynchronous output failed while writing at shutdown.");
+  }
+}
+
+void AsyncOutput::write_loop() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    task_queued_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    std::function<void()> task = std::move(queue_.front());
+    queue_.pop_front();
+    writing_ = true;
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      task();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    writing_ = false;
+    if (error && !error_) {
+      error_ = error;
+    }
+    task_written_.notify_all();
+  }
+}
+
+void AsyncOutput::rethrow_error() {
+  if (error_) {
+    std::exception_ptr error = nullptr;
+    std::swap(error, error_);
+    std::rethrow_exception(error);
+  }
+}
+
+void AsyncOutput::push(std::function<void()> task) {
+  {
+    std::unique_lock lock(mutex_);
+    task_written_.wait(lock, [this] { return queue_.size() < capacity_; });
+    rethrow_error();
+    queue_.push_back(std::move(task));
+  }
+  task_queued_.notify_one();
+}
+
+void AsyncOutput::flush() {
+  std::unique_lock lock(mutex_);
+  task_written_.wait(lock, [this] { return queue_.empty() && !writing_; });
+  rethrow_error();
+}
+
+bool AsyncOutput::forward_synchronously() {
+  if (callbacks_ == Callbacks::ParticleLists) {
+    return false;
+  }
+  flush();
+  return true;
+}
+
+void AsyncOutput::at_eventstart(const Particles &particles,
+                                const int event_number,
+                                const EventInfo &info) {
+  push([this, snapshot = snapshot_of(particles), event_number, info] {
+    output_->at_eventstart(*snapshot, event_number, info);
+  });
+}
+
+void AsyncOutput::at_eventstart(const std::vector<Particles> &ensembles,
+                                int event_number) {
+  if (forward_synchronously()) {
+    output_->at_eventstart(ensembles, event_number);
+  }
+}
+
+void AsyncOutput::at_eventstart(const int event_number,
+                                const ThermodynamicQuantity tq,
+                                const DensityType dens_type,
+                                RectangularLattice<DensityOnLattice> lattice) {
+  if (forward_synchronously()) {
+    output_->at_eventstart(event_number, tq, dens_type, std::move(lattice));
+  }
+}
+
+void AsyncOutput::at_eventstart(
+    const int event_number, const ThermodynamicQuantity tq,
+    const DensityType dens_type,
+    RectangularLattice<EnergyMomentumTensor> lattice) {
+  if (forward_synchronously()) {
+    output_->at_eventstart(event_number, tq, dens_type, std::move(lattice));
+  }
+}
+
+void AsyncOutput::at_eventend(const Particles &particles,
+                              const int event_number, const EventInfo &info) {
+  push([this, snapshot = snapshot_of(particles), event_number, info] {
+    output_->at_eventend(*snapshot, event_number, info);
+  });
+  if (callbacks_ == Callbacks::All) {
+    flush();
+  }
+}
+
+void AsyncOutput::at_eventend(const std::vector<Particles> &ensembles,
+                              const int event_number) {
+  if (forward_synchronously()) {
+    output_->at_eventend(ensembles, event_number);
+  }
+}
+
+void AsyncOutput::at_eventend(const int event_number,
+                              const ThermodynamicQuantity tq,
+                              const DensityType dens_type) {
+  if (forward_synchronously()) {
+    output_->at_eventend(event_number, tq, dens_type);
+  }
+}
+
+void AsyncOutput::at_eventend(const ThermodynamicQuantity tq) {
+  if (forward_synchronously()) {
+    output_->at_eventend(tq);
+  }
+}
+
+void AsyncOutput::at_interaction(const Action &action, const double density) {
+  if (!output_->uses_interactions()) {
+    return;
+  }
+  push([this, snapshot = std::make_shared<RecordedAction>(action), density] {
+    output_->at_interaction(*snapshot, density);
+  });
+}
+
+void AsyncOutput::at_intermediate_time(const Particles &particles,
+                                       const std::unique_ptr<Clock> &clock,
+                                       const DensityParameters &dens_param,
+                                       const EventInfo &info) {
+  push([this, snapshot = snapshot_of(particles),
+        time = clock->current_time(), dens_param, info] {
+    const std::unique_ptr<Clock> frozen = frozen_clock(time);
+    output_->at_intermediate_time(*snapshot, frozen, dens_param, info);
+  });
+}
+
+void AsyncOutput::at_intermediate_time(const std::vector<Particles> &ensembles,
+                                       const std::unique_ptr<Clock> &clock,
+                                       const DensityParameters &dens_param) {
+  if (forward_synchronously()) {
+    output_->at_intermediate_time(ensembles, clock, dens_param);
+  }
+}
+
+void AsyncOutput::thermodynamics_output(
+    const ThermodynamicQuantity tq, const DensityType dt,
+    RectangularLattice<DensityOnLattice> &lattice) {
+  if (forward_synchronously()) {
+    output_->thermodynamics_output(tq, dt, lattice);
+  }
+}
+
+void AsyncOutput::thermodynamics_output(
+    const ThermodynamicQuantity tq, const DensityType dt,
+    RectangularLattice<EnergyMomentumTensor> &lattice) {
+  if (forward_synchronously()) {
+    output_->thermodynamics_output(tq, dt, lattice);
+  }
+}
+
+void AsyncOutput::thermodynamics_lattice_output(
+    RectangularLattice<DensityOnLattice> &lat, const double current_time) {
+  if (forward_synchronously()) {
+    output_->thermodynamics_lattice_output(lat, current_time);
+  }
+}
+
+void AsyncOutput::thermodynamics_lattice_output(
+    RectangularLattice<DensityOnLattice> &lat, const double current_time,
+    const std::vector<Particles> &ensembles,
+    const DensityParameters &dens_param) {
+  if (forward_synchronously()) {
+    output_->thermodynamics_lattice_output(lat, current_time, ensembles,
+                                           dens_param);
+  }
+}
+
+void AsyncOutput::thermodynamics_lattice_output(
+    const ThermodynamicQuantity tq,
+    RectangularLattice<EnergyMomentumTensor> &lattice,
+    const double current_time) {
+  if (forward_synchronously()) {
+    output_->thermodynamics_lattice_output(tq, lattice, current_time);
+  }
+}
+
+void AsyncOutput::thermodynamics_output(const GrandCanThermalizer &gct) {
+  if (forward_synchronously()) {
+    output_->thermodynamics_output(gct);
+  }
+}
+
+void AsyncOutput::fields_output(
+    const std::string name1, const std::string name2,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> &lat) {
+  if (forward_synchronously()) {
+    output_->fields_output(name1, name2, lat);
+  }
+}
+
+}  // namespace smash
@@ -9,6 +9,8 @@
 
 #include "smash/binaryoutput.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <filesystem>
 #include <string>
@@ -43,7 +45,8 @@ static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
  * magic_number, format_version, format_variant, len,      smash_version
  * \endcode
  * \li magic_number - 4 bytes that in ASCII read as "SMSH".
- * \li Format version is an integer number, currently it is 7.
+ * \li Format version is an integer number, currently it is 9, or 10 for files
+ * with an event index.
  * \li Format variant is an integer number: 0 for default, 1 for extended.
  * \li len is the length of smash version string
  * \li smash_version is len chars that give information about the SMASH version.
@@ -97,6 +100,25 @@ static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
  * \li \key baryon_number: Baryon number of the particle. 1 for baryons, -1 for
  * anti-baryons and 0 for mesons.
  *
+ * **Delta block**\n
+ * With <tt>\ref key_output_particles_delta_blocks_ "Delta_Blocks"</tt>, the
+ * particles output writes the intermediate particle lists as delta blocks:
+ * \code
+ * char double uint32_t  uint32_t  n_removed*int32_t
+ * 'd'  time   n_removed n_changed removed_ids
+ * \endcode
+ * \li \c time is the time of the output.
+ * \li \c removed_ids are the ids of the particles that were removed since the
+ * previous particle or delta block of the event.
+ *
+ * The block header is followed by \c n_changed particle lines of the particles
+ * that were created, changed their momentum or left their straight line since
+ * their line was last written. Any other particle moved on a straight line
+ * from its last written position with its last written momentum, up to a
+ * deviation of \f$10^{-9}\f$ fm, and has the same line otherwise. The
+ * particle list at the time of the block thus follows from the previous one,
+ * which BinaryParticleListReader::read_particle_lists reconstructs.
+ *
  * **Event end line**
  * \code
  * char    uint32_t      double      char
@@ -109,11 +131,33 @@ static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
  * \li \key empty: 0 if there was an interaction between the projectile
  * and the target, 1 otherwise. For non-collider setups, this is always 0.
  *
+ * **Event index**\n
+ * With <tt>\ref key_output_binary_event_index_ "Binary_Event_Index"</tt>, the
+ * file ends with an index of its events, written when the output is closed:
+ * \code
+ * char uint32_t n_events*(int32_t      uint64_t uint64_t  uint32_t)
+ * 'x'  n_events           event_number begin    particles n_particles
+ *
+ * uint64_t   uint64_t     4*char
+ * events_end index_offset "SMIX"
+ * \endcode
+ * \li \key begin: Byte offset of the first block of the event.
+ * \li \key particles: Byte offset of the first particle line of the last
+ * particle block of the event, \c 0xffffffffffffffff if there is none.
+ * \li \key n_particles: Number of lines of that particle block.
+ * \li \key events_end: Byte offset behind the event end line of the last
+ * event.
+ * \li \key index_offset: Byte offset of the \c 'x' of the index.
+ *
+ * A reader finds the index from the last 12 bytes of the file. Files of an
+ * aborted run, which have no index, are read as before.
+ *
  * Particles output
  * ----------------
  * The particles output is Written to the \c particles_binary.bin file.
  * It contains the current particle list at specific moments of time. Every
- * moment of time is written as a 'p' block. For options of this output see
+ * moment of time is written as a 'p' block, or as a 'd' block for the
+ * intermediate times with delta blocks. For options of this output see
  * \ref input_output_content_specific_ "content-specific output options".
  *
  * Collisions output
@@ -136,32 +180,60 @@ static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
 BinaryOutputBase::BinaryOutputBase(const std::filesystem::path &path,
                                    const std::string &mode,
                                    const std::string &name,
-                                   bool extended_format)
-    : OutputInterface(name), file_{path, mode}, extended_(extended_format) {
-  std::fwrite("SMSH", 4, 1, file_.get());  // magic number
-  write(format_version_);                  // file format version number
+                                   bool extended_format,
+                                   std::size_t buffer_size, bool event_index)
+    : OutputInterface(name),
+      file_{path, mode},
+      buffer_size_(buffer_size),
+      format_version_(event_index ? 10 : 9),
+      extended_(extended_format),
+      event_index_(event_index) {
+  buffer_.reserve(buffer_size_);
+  append("SMSH", 4);       // magic number
+  write(format_version_);  // file format version number
   std::uint16_t format_variant = static_cast<uint16_t>(extended_);
   write(format_variant);
   write(SMASH_VERSION);
+  write_buffer();
+  event_begin_ = position();
 }
 
-// write functions:
-void BinaryOutputBase::write(const char c) {
-  std::fwrite(&c, sizeof(char), 1, file_.get());
+BinaryOutputBase::~BinaryOutputBase() {
+  if (event_index_) {
+    const std::uint64_t index_offset = position();
+    write('x');
+    const auto n_events = static_cast<std::uint32_t>(index_.size() / 24);
+    write(n_events);
+    buffer_.insert(buffer_.end(), index_.begin(), index_.end());
+    // Blocks of an unfinished event lie between the events and the index.
+    append(&event_begin_, sizeof(event_begin_));
+    append(&index_offset, sizeof(index_offset));
+    append("SMIX", 4);
+  }
+  write_buffer();
+}
+
+void BinaryOutputBase::write_buffer() {
+  if (!buffer_.empty()) {
+    std::fwrite(buffer_.data(), 1, buffer_.size(), file_.get());
+    written_ += buffer_.size();
+    buffer_.clear();
+  }
 }
 
+// write functions:
+void BinaryOutputBase::write(const char c) { append(&c, sizeof(char)); }
+
 void BinaryOutputBase::write(const std::string &s) {
   const auto size = smash::numeric_cast<uint32_t>(s.size());
-  std::fwrite(&size, sizeof(std::uint32_t), 1, file_.get());
-  std::fwrite(s.c_str(), s.size(), 1, file_.get());
+  append(&size, sizeof(std::uint32_t));
+  append(s.c_str(), s.size());
 }
 
-void BinaryOutputBase::write(const double x) {
-  std::fwrite(&x, sizeof(x), 1, file_.get());
-}
+void BinaryOutputBase::write(const double x) { append(&x, sizeof(x)); }
 
 void BinaryOutputBase::write(const FourVector &v) {
-  std::fwrite(v.begin(), sizeof(*v.begin()), 4, file_.get());
+  append(v.begin(), 4 * sizeof(*v.begin()));
 }
 
 void BinaryOutputBase::write(const Particles &particles) {
@@ -178,8 +250,7 @@ void BinaryOutputBase::write(const ParticleList &particles) {
 
 void BinaryOutputBase::write_particledata(const ParticleData &p) {
   write(p.position());
-  double mass = p.effective_mass();
-  std::fwrite(&mass, sizeof(mass), 1, file_.get());
+  write(p.effective_mass());
   write(p.momentum());
   write(p.pdgcode().get_decimal());
   write(p.id());
@@ -199,119 +270,198 @@ void BinaryOutputBase::write_particledata(const ParticleData &p) {
   }
 }
 
+void BinaryOutputBase::write_particle_block_header(std::size_t n_particles) {
+  write('p');
+  write(n_particles);
+  particles_offset_ = position();
+  n_particles_ = smash::numeric_cast<std::uint32_t>(n_particles);
+}
+
+void BinaryOutputBase::write_event_end(std::int32_t event_number,
+                                       const EventInfo &event) {
+  // Event end line
+  const char fchar = 'f';
+  write(fchar);
+  write(event_number);
+  write(event.impact_parameter);
+  const char empty = event.empty_event;
+  write(empty);
+
+  if (event_index_) {
+    auto add = [this](const auto &x) {
+      const char *bytes = reinterpret_cast<const char *>(&x);
+      index_.insert(index_.end(), bytes, bytes + sizeof(x));
+    };
+    add(event_number);
+    add(event_begin_);
+    add(particles_offset_);
+    add(n_particles_);
+  }
+  event_begin_ = position();
+  particles_offset_ = no_particles;
+  n_particles_ = 0;
+
+  // Flush to disk
+  write_buffer();
+  std::fflush(file_.get());
+}
+
 BinaryOutputCollisions::BinaryOutputCollisions(
     const std::filesystem::path &path, std::string name,
     const OutputParameters &out_par)
     : BinaryOutputBase(
           path / ((name == "Collisions" ? "collisions_binary" : name) + ".bin"),
-          "wb", name, out_par.get_coll_extended(name)),
+          "wb", name, out_par.get_coll_extended(name),
+          out_par.binary_buffer_size, out_par.binary_event_index),
       print_start_end_(out_par.coll_printstartend) {}
 
 void BinaryOutputCollisions::at_eventstart(const Particles &particles,
                                            const int, const EventInfo &) {
-  const char pchar = 'p';
   if (print_start_end_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
+    write_particle_block_header(particles.size());
     write(particles);
+    end_block();
   }
 }
 
 void BinaryOutputCollisions::at_eventend(const Particles &particles,
                                          const int32_t event_number,
                                          const EventInfo &event) {
-  const char pchar = 'p';
   if (print_start_end_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
+    write_particle_block_header(particles.size());
     write(particles);
   }
 
-  // Event end line
-  const char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
-  write(event_number);
-  write(event.impact_parameter);
-  const char empty = event.empty_event;
-  write(empty);
-
-  // Flush to disk
-  std::fflush(file_.get());
+  write_event_end(event_number, event);
 }
 
 void BinaryOutputCollisions::at_interaction(const Action &action,
                                             const double density) {
   const char ichar = 'i';
-  std::fwrite(&ichar, sizeof(char), 1, file_.get());
+  write(ichar);
   write(action.incoming_particles().size());
   write(action.outgoing_particles().size());
-  std::fwrite(&density, sizeof(double), 1, file_.get());
+  write(density);
   const double weight = action.get_total_weight();
-  std::fwrite(&weight, sizeof(double), 1, file_.get());
+  write(weight);
   const double partial_weight = action.get_partial_weight();
-  std::fwrite(&partial_weight, sizeof(double), 1, file_.get());
+  write(partial_weight);
   const auto type = static_cast<uint32_t>(action.get_type());
-  std::fwrite(&type, sizeof(uint32_t), 1, file_.get());
+  write(type);
   write(action.incoming_particles());
   write(action.outgoing_particles());
+  end_block();
 }
 
 BinaryOutputParticles::BinaryOutputParticles(const std::filesystem::path &path,
                                              std::string name,
                                              const OutputParameters &out_par)
     : BinaryOutputBase(path / "particles_binary.bin", "wb", name,
-                       out_par.part_extended),
-      only_final_(out_par.part_only_final) {}
+                       out_par.part_extended, out_par.binary_buffer_size,
+                       out_par.binary_event_index),
+      only_final_(out_par.part_only_final),
+      delta_blocks_(out_par.part_delta_blocks) {}
 
 void BinaryOutputParticles::at_eventstart(const Particles &particles, const int,
                                           const EventInfo &) {
-  const char pchar = 'p';
   if (only_final_ == OutputOnlyFinal::No) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
-    write(particles);
+    write_snapshot(particles);
+    end_block();
   }
 }
 
 void BinaryOutputParticles::at_eventend(const Particles &particles,
                                         const int event_number,
                                         const EventInfo &event) {
-  const char pchar = 'p';
   if (!(event.empty_event && only_final_ == OutputOnlyFinal::IfNotEmpty)) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
+    write_particle_block_header(particles.size());
     write(particles);
   }
 
-  // Event end line
-  const char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
-  write(event_number);
-  write(event.impact_parameter);
-  const char empty = event.empty_event;
-  write(empty);
-
-  // Flush to disk
-  std::fflush(file_.get());
+  write_event_end(event_number, event);
 }
 
-void BinaryOutputParticles::at_intermediate_time(const Particles &particles,
-                                                 const std::unique_ptr<Clock> &,
-                                                 const DensityParameters &,
-                                                 const EventInfo &) {
-  const char pchar = 'p';
+void BinaryOutputParticles::at_intermediate_time(
+    const Particles &particles, const std::unique_ptr<Clock> &clock,
+    const DensityParameters &, const EventInfo &) {
   if (only_final_ == OutputOnlyFinal::No) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
-    write(particles);
+    if (delta_blocks_) {
+      write_delta(particles, clock->current_time());
+    } else {
+      write_particle_block_header(particles.size());
+      write(particles);
+    }
+    end_block();
+  }
+}
+
+void BinaryOutputParticles::write_snapshot(const Particles &particles) {
+  write_particle_block_header(particles.size());
+  write(particles);
+  if (delta_blocks_) {
+    last_lines_.clear();
+    for (const ParticleData &p : particles) {
+      last_lines_[p.id()] = {p.position(), p.momentum(), n_deltas_};
+    }
+  }
+}
+
+void BinaryOutputParticles::write_delta(const Particles &particles,
+                                        double time) {
+  /* Deviation from the straight line [fm] up to which a particle is not
+   * written again. It bounds the error of the reconstructed positions. */
+  constexpr double max_deviation = 1e-9;
+  ++n_deltas_;
+  changed_.clear();
+  for (const ParticleData &p : particles) {
+    auto [line, created] = last_lines_.try_emplace(p.id());
+    WrittenLine &last = line->second;
+    if (!created) {
+      const ThreeVector expected =
+          last.position.threevec() +
+          last.momentum.velocity() * (time - last.position.x0());
+      const bool on_line =
+          p.momentum() == last.momentum &&
+          std::abs(p.position().x0() - time) <= max_deviation &&
+          (p.position().threevec() - expected).abs() <= max_deviation;
+      if (on_line) {
+        last.seen = n_deltas_;
+        continue;
+      }
+    }
+    last = {p.position(), p.momentum(), n_deltas_};
+    changed_.push_back(&p);
+  }
+  // The lines that were not seen belong to removed particles.
+  removed_.clear();
+  for (auto line = last_lines_.begin(); line != last_lines_.end();) {
+    if (line->second.seen != n_deltas_) {
+      removed_.push_back(line->first);
+      line = last_lines_.erase(line);
+    } else {
+      ++line;
+    }
+  }
+  std::sort(removed_.begin(), removed_.end());
+
+  write('d');
+  write(time);
+  write(removed_.size());
+  write(changed_.size());
+  for (const std::int32_t id : removed_) {
+    write(id);
+  }
+  for (const ParticleData *p : changed_) {
+    write_particledata(*p);
   }
 }
 
 BinaryOutputInitialConditions::BinaryOutputInitialConditions(
     const std::filesystem::path &path, std::string name,
     const OutputParameters &out_par)
-    : BinaryOutputBase(path / "SMASH_IC.bin", "wb", name, out_par.ic_extended) {
-}
+    : BinaryOutputBase(path / "SMASH_IC.bin", "wb", name, out_par.ic_extended,
+                       out_par.binary_buffer_size,
+                       out_par.binary_event_index) {}
 
 void BinaryOutputInitialConditions::at_eventstart(const Particles &, const int,
                                                   const EventInfo &) {}
@@ -319,16 +469,7 @@ void BinaryOutputInitialConditions::at_eventstart(const Particles &, const int,
 void BinaryOutputInitialConditions::at_eventend(const Particles &particles,
                                                 const int event_number,
                                                 const EventInfo &event) {
-  // Event end line
-  const char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
-  write(event_number);
-  write(event.impact_parameter);
-  const char empty = event.empty_event;
-  write(empty);
-
-  // Flush to disk
-  std::fflush(file_.get());
+  write_event_end(event_number, event);
 
   // If the runtime is too short some particles might not yet have
   // reached the hypersurface. Warning is printed.
@@ -343,10 +484,9 @@ void BinaryOutputInitialConditions::at_eventend(const Particles &particles,
 void BinaryOutputInitialConditions::at_interaction(const Action &action,
                                                    const double) {
   if (action.get_type() == ProcessType::HyperSurfaceCrossing) {
-    const char pchar = 'p';
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(action.incoming_particles().size());
+      write_particle_block_header(action.incoming_particles().size());
     write(action.incoming_particles());
+    end_block();
   }
 }
 }  // namespace smash
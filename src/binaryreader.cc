@@ -0,0 +1,407 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/binaryreader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace smash {
+
+namespace {
+/// Binary file format version without event index that can be read
+constexpr std::uint16_t readable_format_version = 9;
+/// Binary file format version that may end with an event index
+constexpr std::uint16_t indexed_format_version = 10;
+/// Size of an entry of the event index
+constexpr std::size_t index_entry_size =
+    2 * sizeof(std::int32_t) + 2 * sizeof(std::uint64_t);
+/// Size of the end of an indexed file behind the entries
+constexpr std::size_t index_footer_size = 2 * sizeof(std::uint64_t) + 4;
+/// Particle offset in the event index of events without particle block
+constexpr std::uint64_t no_particles = ~std::uint64_t{0};
+
+/**
+ * Append the event index to a merged file.
+ *
+ * \param[in] out Merged file, positioned behind the last event.
+ * \param[in] entries Serialised entries of the event index.
+ * \param[in] n_events Number of entries.
+ * \param[in] events_end Offset behind the last event.
+ */
+void write_event_index(std::ostream &out, const std::string &entries,
+                       std::uint32_t n_events, std::uint64_t events_end) {
+  out.put('x');
+  out.write(reinterpret_cast<const char *>(&n_events), sizeof(n_events));
+  out.write(entries.data(), entries.size());
+  out.write(reinterpret_cast<const char *>(&events_end), sizeof(events_end));
+  // The index starts directly behind the last event.
+  out.write(reinterpret_cast<const char *>(&events_end), sizeof(events_end));
+  out.write("SMIX", 4);
+}
+/// Size of a particle line in the default format
+constexpr std::size_t default_line_size = 9 * sizeof(double) + 3 * 4;
+/// Additional size of a particle line in the extended format
+constexpr std::size_t extended_line_size =
+    3 * sizeof(double) + 7 * sizeof(std::int32_t);
+/// Size of a delta block up to the removed ids
+constexpr std::size_t delta_header_size =
+    1 + sizeof(double) + 2 * sizeof(std::uint32_t);
+}  // namespace
+
+bool BinaryParticleListReader::is_binary_file(
+    const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  char magic[4];
+  return file.read(magic, 4) && std::memcmp(magic, "SMSH", 4) == 0;
+}
+
+BinaryParticleListReader::BinaryParticleListReader(
+    const std::filesystem::path &path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open " + path.string() + ".");
+  }
+  struct stat file_status;
+  if (fstat(fd, &file_status) != 0) {
+    close(fd);
+    throw std::runtime_error("Cannot determine the size of " + path.string() +
+                             ".");
+  }
+  size_ = static_cast<std::size_t>(file_status.st_size);
+  if (size_ > 0) {
+    void *mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("Cannot map " + path.string() + ".");
+    }
+    data_ = static_cast<const char *>(mapping);
+  }
+  // The mapping stays valid after closing the file descriptor.
+  close(fd);
+
+  try {
+    if (size_ < 4 || std::memcmp(data_, "SMSH", 4) != 0) {
+      throw std::runtime_error(path.string() + " is not a SMASH binary file.");
+    }
+    std::uint16_t version, variant;
+    std::uint32_t len;
+    read(4, version);
+    read(6, variant);
+    read(8, len);
+    if (version != readable_format_version &&
+        version != indexed_format_version) {
+      throw std::runtime_error("Binary format version " +
+                               std::to_string(version) + " of " +
+                               path.string() + " cannot be read.");
+    }
+    line_size_ = default_line_size + (variant == 1 ? extended_line_size : 0);
+    header_size_ = 12 + len;
+    if (version != indexed_format_version || !read_event_index()) {
+      scan_events(path);
+    }
+  } catch (...) {
+    if (data_) {
+      munmap(const_cast<char *>(data_), size_);
+    }
+    throw;
+  }
+}
+
+bool BinaryParticleListReader::read_event_index() {
+  if (size_ < header_size_ + index_footer_size ||
+      std::memcmp(data_ + size_ - 4, "SMIX", 4) != 0) {
+    return false;
+  }
+  std::uint64_t index_offset;
+  read(size_ - sizeof(std::uint64_t) - 4, index_offset);
+  if (index_offset < header_size_ || index_offset + 5 > size_ ||
+      data_[index_offset] != 'x') {
+    return false;
+  }
+  std::uint32_t n_events;
+  read(index_offset + 1, n_events);
+  if (index_offset + 5 + n_events * index_entry_size + index_footer_size !=
+      size_) {
+    return false;
+  }
+  std::uint64_t events_end;
+  read(index_offset + 5 + n_events * index_entry_size, events_end);
+
+  events_.reserve(n_events);
+  std::size_t entry = index_offset + 5;
+  for (std::uint32_t i = 0; i < n_events; i++, entry += index_entry_size) {
+    std::int32_t event_number;
+    std::uint64_t begin, particles;
+    std::uint32_t n_particles;
+    read(entry, event_number);
+    read(entry + 4, begin);
+    read(entry + 12, particles);
+    read(entry + 20, n_particles);
+    std::optional<std::size_t> offset;
+    if (particles != no_particles) {
+      offset = particles;
+    }
+    events_.push_back({event_number, offset, n_particles, begin, 0});
+  }
+  // Every event ends where the next one begins.
+  for (std::size_t i = 0; i < events_.size(); i++) {
+    EventEntry &event = events_[i];
+    event.end = i + 1 < events_.size() ? events_[i + 1].begin : events_end;
+    const bool inside = event.begin >= header_size_ &&
+                        event.begin <= event.end && event.end <= index_offset;
+    const bool particles_inside =
+        !event.offset || (*event.offset >= event.begin &&
+                          *event.offset + event.n_particles * line_size_ <=
+                              event.end);
+    if (!inside || !particles_inside) {
+      throw std::runtime_error("Corrupt event index in SMASH binary file.");
+    }
+  }
+  return true;
+}
+
+void BinaryParticleListReader::scan_events(
+    const std::filesystem::path &path) {
+  /* Index the events, jumping over the particle lines. Blocks after the
+   * last event end line belong to an unfinished event and are ignored. */
+  std::optional<std::size_t> last_block;
+  std::uint32_t last_block_size = 0;
+  std::size_t offset = header_size_;
+  std::size_t event_begin = offset;
+  while (offset < size_) {
+    const char block_type = data_[offset];
+    if (block_type == 'p') {
+      if (offset + 5 > size_) {
+        break;
+      }
+      std::uint32_t n;
+      read(offset + 1, n);
+      last_block = offset + 5;
+      last_block_size = n;
+      offset += 5 + n * line_size_;
+    } else if (block_type == 'i') {
+      if (offset + 9 > size_) {
+        break;
+      }
+      std::uint32_t n_in, n_out;
+      read(offset + 1, n_in);
+      read(offset + 5, n_out);
+      offset += 9 + 3 * sizeof(double) + sizeof(std::uint32_t) +
+                (n_in + n_out) * line_size_;
+    } else if (block_type == 'd') {
+      if (offset + delta_header_size > size_) {
+        break;
+      }
+      std::uint32_t n_removed, n_changed;
+      read(offset + 9, n_removed);
+      read(offset + 13, n_changed);
+      offset += delta_header_size + n_removed * sizeof(std::int32_t) +
+                n_changed * line_size_;
+    } else if (block_type == 'f') {
+      if (offset + 14 > size_) {
+        break;
+      }
+      std::int32_t event_number;
+      read(offset + 1, event_number);
+      if (last_block && *last_block + last_block_size * line_size_ > size_) {
+        break;
+      }
+      offset += 1 + sizeof(std::int32_t) + sizeof(double) + 1;
+      events_.push_back(
+          {event_number, last_block, last_block_size, event_begin, offset});
+      last_block.reset();
+      last_block_size = 0;
+      event_begin = offset;
+    } else if (block_type == 'x') {
+      // an event index that could not be used
+      break;
+    } else {
+      throw std::runtime_error("Unknown block type in " + path.string() +
+                               ".");
+    }
+  }
+}
+
+BinaryParticleListReader::~BinaryParticleListReader() {
+  if (data_) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+}
+
+template <typename T>
+void BinaryParticleListReader::read(std::size_t offset, T &x) const {
+  if (offset + sizeof(T) > size_) {
+    throw std::runtime_error("Unexpected end of SMASH binary file.");
+  }
+  std::memcpy(&x, data_ + offset, sizeof(T));
+}
+
+std::vector<BinaryParticleLine> BinaryParticleListReader::read_event(
+    std::size_t i) const {
+  const EventEntry &event = events_.at(i);
+  std::vector<BinaryParticleLine> lines;
+  if (!event.offset) {
+    return lines;
+  }
+  lines.reserve(event.n_particles);
+  for (std::uint32_t k = 0; k < event.n_particles; k++) {
+    lines.push_back(read_line(*event.offset + k * line_size_));
+  }
+  return lines;
+}
+
+std::vector<std::vector<BinaryParticleLine>>
+BinaryParticleListReader::read_particle_lists(std::size_t i) const {
+  const EventEntry &event = events_.at(i);
+  std::vector<std::vector<BinaryParticleLine>> lists;
+  // Last written line of every particle, by id
+  std::map<std::int32_t, BinaryParticleLine> last_lines;
+  std::size_t offset = event.begin;
+  while (offset < event.end && data_[offset] != 'f') {
+    const char block_type = data_[offset];
+    if (block_type == 'p') {
+      std::uint32_t n;
+      read(offset + 1, n);
+      offset += 5;
+      std::vector<BinaryParticleLine> &list = lists.emplace_back();
+      list.reserve(n);
+      last_lines.clear();
+      for (std::uint32_t k = 0; k < n; k++, offset += line_size_) {
+        list.push_back(read_line(offset));
+        last_lines[list.back().id] = list.back();
+      }
+    } else if (block_type == 'd') {
+      double time;
+      std::uint32_t n_removed, n_changed;
+      read(offset + 1, time);
+      read(offset + 9, n_removed);
+      read(offset + 13, n_changed);
+      offset += delta_header_size;
+      for (std::uint32_t k = 0; k < n_removed; k++, offset += 4) {
+        std::int32_t id;
+        read(offset, id);
+        last_lines.erase(id);
+      }
+      for (std::uint32_t k = 0; k < n_changed; k++, offset += line_size_) {
+        const BinaryParticleLine line = read_line(offset);
+        last_lines[line.id] = line;
+      }
+      // The other particles moved on a straight line since their last line.
+      std::vector<BinaryParticleLine> &list = lists.emplace_back();
+      list.reserve(last_lines.size());
+      for (const auto &[id, last] : last_lines) {
+        BinaryParticleLine &p = list.emplace_back(last);
+        const ThreeVector position =
+            last.position.threevec() +
+            last.momentum.velocity() * (time - last.position.x0());
+        p.position = FourVector(time, position);
+      }
+    } else if (block_type == 'i') {
+      std::uint32_t n_in, n_out;
+      read(offset + 1, n_in);
+      read(offset + 5, n_out);
+      offset += 9 + 3 * sizeof(double) + sizeof(std::uint32_t) +
+                (n_in + n_out) * line_size_;
+    } else {
+      throw std::runtime_error("Unknown block type in SMASH binary file.");
+    }
+  }
+  return lists;
+}
+
+BinaryParticleLine BinaryParticleListReader::read_line(
+    std::size_t offset) const {
+  if (offset + line_size_ > size_) {
+    throw std::runtime_error("Unexpected end of SMASH binary file.");
+  }
+  const char *line = data_ + offset;
+  // The line is copied out, since it is not aligned in the file.
+  BinaryParticleLine p;
+  double reals[9];
+  std::memcpy(reals, line, sizeof(reals));
+  p.position = FourVector(reals[0], reals[1], reals[2], reals[3]);
+  p.mass = reals[4];
+  p.momentum = FourVector(reals[5], reals[6], reals[7], reals[8]);
+  const char *integers = line + 9 * sizeof(double);
+  std::memcpy(&p.pdg, integers, sizeof(std::int32_t));
+  std::memcpy(&p.id, integers + 4, sizeof(std::int32_t));
+  std::memcpy(&p.charge, integers + 8, sizeof(std::int32_t));
+  return p;
+}
+
+void merge_binary_shards(const std::vector<std::filesystem::path> &shards,
+                         const std::filesystem::path &merged) {
+  if (shards.empty()) {
+    throw std::invalid_argument("No shards to merge into " + merged.string() +
+                                ".");
+  }
+  std::vector<std::unique_ptr<BinaryParticleListReader>> readers;
+  readers.reserve(shards.size());
+  // Event number, shard and position of every event
+  std::vector<std::tuple<std::int32_t, std::size_t, std::size_t>> events;
+  for (std::size_t s = 0; s < shards.size(); s++) {
+    readers.push_back(std::make_unique<BinaryParticleListReader>(shards[s]));
+    if (readers[s]->header() != readers.front()->header()) {
+      throw std::invalid_argument("The header of " + shards[s].string() +
+                                  " differs from the one of " +
+                                  shards.front().string() + ".");
+    }
+    for (std::size_t i = 0; i < readers[s]->n_events(); i++) {
+      events.emplace_back(readers[s]->event_number(i), s, i);
+    }
+  }
+  std::stable_sort(events.begin(), events.end());
+
+  std::ofstream out(merged, std::ios::binary | std::ios::trunc);
+  const std::string_view header = readers.front()->header();
+  out.write(header.data(), header.size());
+  std::uint16_t version;
+  std::memcpy(&version, header.data() + 4, sizeof(version));
+  // Shards with an event index give a merged file with an event index.
+  std::string index;
+  std::uint64_t offset = header.size();
+  for (const auto &[event_number, s, i] : events) {
+    const std::string_view blocks = readers[s]->event_blocks(i);
+    out.write(blocks.data(), blocks.size());
+    if (version == indexed_format_version) {
+      const auto &event = readers[s]->events_[i];
+      const std::uint64_t particles =
+          event.offset ? offset + *event.offset - event.begin : no_particles;
+      const std::uint32_t n_particles = event.n_particles;
+      index.append(reinterpret_cast<const char *>(&event_number),
+                   sizeof(event_number));
+      index.append(reinterpret_cast<const char *>(&offset), sizeof(offset));
+      index.append(reinterpret_cast<const char *>(&particles),
+                   sizeof(particles));
+      index.append(reinterpret_cast<const char *>(&n_particles),
+                   sizeof(n_particles));
+    }
+    offset += blocks.size();
+  }
+  if (version == indexed_format_version) {
+    write_event_index(out, index, events.size(), offset);
+  }
+  if (!out.flush()) {
+    throw std::runtime_error("Cannot write " + merged.string() + ".");
+  }
+}
+
+}  // namespace smash
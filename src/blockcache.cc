@@ -0,0 +1,106 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/blockcache.h"
+
+#include <array>
+#include <new>
+#include <vector>
+
+namespace smash {
+
+namespace {
+/// Width of the size classes in bytes
+constexpr std::size_t class_width = 16;
+
+/// Number of the size classes
+constexpr std::size_t n_classes = BlockCache::max_size / class_width;
+
+/**
+ * \return the size class of blocks of \p size bytes.
+ *
+ * \param[in] size Size in bytes, at most BlockCache::max_size
+ */
+std::size_t size_class(std::size_t size) {
+  return (size + class_width - 1) / class_width - 1;
+}
+
+/**
+ * Whether the free lists of this thread were destroyed. Blocks freed
+ * afterwards, e.g. when static objects are destroyed at the end of the
+ * program, are given back to the heap directly.
+ */
+thread_local bool cache_destroyed = false;
+
+/// The free lists of the blocks cached by this thread
+struct FreeLists {
+  /// Give all cached blocks back to the heap
+  ~FreeLists() {
+    cache_destroyed = true;
+    for (std::vector<void *> &blocks : lists) {
+      for (void *p : blocks) {
+        ::operator delete(p);
+      }
+    }
+  }
+  /// The free list of each size class
+  std::array<std::vector<void *>, n_classes> lists;
+};
+
+/// \return the free lists of this thread.
+FreeLists &free_lists() {
+  static thread_local FreeLists instance;
+  return instance;
+}
+}  // namespace
+
+void *BlockCache::allocate(std::size_t size) {
+  if (size == 0 || size > max_size || cache_destroyed) {
+    return ::operator new(size);
+  }
+  const std::size_t c = size_class(size);
+  std::vector<void *> &blocks = free_lists().lists[c];
+  if (blocks.empty()) {
+    // All blocks of a class have the same size, such that they can be reused.
+    return ::operator new((c + 1) * class_width);
+  }
+  void *p = blocks.back();
+  blocks.pop_back();
+  return p;
+}
+
+void BlockCache::deallocate(void *p, std::size_t size) noexcept {
+  if (p == nullptr) {
+    return;
+  }
+  if (size == 0 || size > max_size || cache_destroyed) {
+    ::operator delete(p);
+    return;
+  }
+  std::vector<void *> &blocks = free_lists().lists[size_class(size)];
+  if (blocks.size() >= max_blocks) {
+    ::operator delete(p);
+    return;
+  }
+  try {
+    blocks.push_back(p);
+  } catch (const std::bad_alloc &) {
+    ::operator delete(p);
+  }
+}
+
+std::size_t BlockCache::cached_blocks() {
+  std::size_t n = 0;
+  for (const std::vector<void *> &blocks : free_lists().lists) {
+    n += blocks.size();
+  }
+  return n;
+}
+
+}  // namespace smash
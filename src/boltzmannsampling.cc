@@ -0,0 +1,158 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/boltzmannsampling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "gsl/gsl_sf_bessel.h"
+
+#include "smash/distributions.h"
+#include "smash/fpenvironment.h"
+#include "smash/parallel.h"
+#include "smash/particles.h"
+#include "smash/random.h"
+
+namespace smash {
+
+BoltzmannSampling::BoltzmannSampling(const ParticleTypePtrList &types,
+                                     double temperature,
+                                     bool account_for_resonance_widths,
+                                     int n_threads)
+    : temperature_(temperature) {
+  if (!(temperature > 0.)) {
+    throw std::invalid_argument(
+        "Thermal sampling needs a positive temperature.");
+  }
+  std::vector<std::pair<ParticleTypePtr, Species *>> to_tabulate;
+  for (const ParticleTypePtr type : types) {
+    const auto inserted = species_.try_emplace(type->pdgcode());
+    if (!inserted.second || !account_for_resonance_widths ||
+        type->is_stable()) {
+      continue;
+    }
+    // Lazily computed properties are not computed thread-safely.
+    type->min_mass_spectral();
+    type->spectral_function(type->mass());
+    to_tabulate.emplace_back(type, &inserted.first->second);
+  }
+
+  // Same upper mass bound as in HadronGasEos::sample_mass_thermal
+  constexpr double max_mass = 5.0;
+  const double beta = 1.0 / temperature;
+  parallel_for(n_threads, to_tabulate.size(), 1, [&](size_t i) {
+    const ParticleType &type = *to_tabulate[i].first;
+    Species &species = *to_tabulate[i].second;
+    const double m0 = type.mass();
+    // Allow underflows in exponentials
+    DisableFloatTraps guard(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
+    const double w0 = type.width_at_pole();
+    const double x_min = std::atan((type.min_mass_spectral() - m0) / w0);
+    const double x_max = std::atan((max_mass - m0) / w0);
+    species.mass = Tabulation::inverse_cdf(x_min, x_max, [&](double x) {
+      const double tanx = std::tan(x);
+      const double m = m0 + w0 * tanx;
+      const double jacobian = w0 * (1.0 + tanx * tanx);
+      const double thermal_factor =
+          m * m * std::exp(-beta * m) * gsl_sf_bessel_Kn_scaled(2, m * beta);
+      return type.spectral_function_no_norm(m) * thermal_factor * jacobian;
+    });
+  });
+  // Tabulate the momenta before the sampling
+  ThermalMomentumSampling::instance();
+}
+
+std::pair<double, double> BoltzmannSampling::sample(
+    const ParticleType &type) const {
+  const Species &species = species_.at(type.pdgcode());
+  double mass = type.mass();
+  if (!species.mass.is_empty()) {
+    const double x = species.mass.get_value_linear(random::canonical());
+    mass += type.width_at_pole() * std::tan(x);
+  }
+  return {mass, ThermalMomentumSampling::instance().sample(temperature_, mass)};
+}
+
+/// Step of \f$ \sqrt{m/T} \f$ between the rows of ThermalMomentumSampling
+constexpr double thermal_momentum_row_step = 0.05;
+
+/// Number of intervals between the rows of ThermalMomentumSampling
+constexpr size_t n_thermal_momentum_rows = 200;
+
+/// Upper bound of \f$ -\ln(1 - q) \f$ in the rows of ThermalMomentumSampling
+constexpr double thermal_momentum_max_tail = 40.;
+
+const ThermalMomentumSampling &ThermalMomentumSampling::instance() {
+  static const ThermalMomentumSampling sampling;
+  return sampling;
+}
+
+ThermalMomentumSampling::ThermalMomentumSampling()
+    : rows_(n_thermal_momentum_rows + 1) {
+  parallel_for(default_thread_count(), rows_.size(), 1, [&](size_t i) {
+    const double sqrt_m_over_T = i * thermal_momentum_row_step;
+    const double m_over_T = sqrt_m_over_T * sqrt_m_over_T;
+    // The distribution is negligible beyond a kinetic energy of 50 T.
+    const double u_max = std::sqrt(50. * (50. + 2. * m_over_T));
+    const Tabulation cdf = Tabulation::cdf(0., u_max, 8192, [&](double u) {
+      const double kinetic = std::sqrt(u * u + m_over_T * m_over_T) - m_over_T;
+      return u * u * std::exp(-kinetic);
+    });
+    /* The quantiles u(q) are tabulated over y = -ln(1 - q) and divided by
+     * the cube root of q. This ratio is smooth at small q, where u grows like
+     * that cube root, and linear in y in the exponential tail, so that the
+     * interpolation is accurate at both ends. The limit at q = 0 is
+     * approximated by a tiny q. */
+    rows_[i] = Tabulation(0., thermal_momentum_max_tail, 4096, [&](double y) {
+      const double q = -std::expm1(-std::max(y, 1e-6));
+      return cdf.get_inverse_linear(q) / std::cbrt(q);
+    });
+  });
+}
+
+double ThermalMomentumSampling::sample(double temperature, double mass) const {
+  const double row = std::sqrt(mass / temperature) / thermal_momentum_row_step;
+  if (!(row < n_thermal_momentum_rows)) {
+    return sample_momenta_from_thermal(temperature, mass);
+  }
+  const size_t i = static_cast<size_t>(row);
+  const double weight = row - i;
+  const double one_minus_q = random::canonical_nonzero();
+  const double y = -std::log(one_minus_q);
+  return temperature * std::cbrt(1. - one_minus_q) *
+         ((1. - weight) * rows_[i].get_value_linear(y) +
+          weight * rows_[i + 1].get_value_linear(y));
+}
+
+void sample_particles_in_parallel(
+    int n_threads, Particles &particles,
+    const std::function<void(ParticleData &)> &sample) {
+  constexpr size_t chunk_size = 1024;
+  std::vector<ParticleData *> list;
+  list.reserve(particles.size());
+  for (ParticleData &data : particles) {
+    list.push_back(&data);
+  }
+  const uint64_t seed = random::advance();
+  const size_t n_chunks = (list.size() + chunk_size - 1) / chunk_size;
+  parallel_for(n_threads, n_chunks, 1, [&](size_t chunk) {
+    random::Engine stream = random::make_stream(seed, chunk);
+    random::ScopedEngine use_stream(stream);
+    const size_t end = std::min(list.size(), (chunk + 1) * chunk_size);
+    for (size_t i = chunk * chunk_size; i < end; i++) {
+      sample(*list[i]);
+    }
+  });
+}
+
+}  // namespace smash
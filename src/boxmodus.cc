@@ -6,16 +6,19 @@
  */
 #include "smash/boxmodus.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <list>
 #include <map>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "smash/algorithms.h"
 #include "smash/angles.h"
+#include "smash/boltzmannsampling.h"
 #include "smash/constants.h"
 #include "smash/cxx17compat.h"
 #include "smash/experimentparameters.h"
@@ -59,6 +62,10 @@ std::ostream &operator<<(std::ostream &out, const BoxModus &m) {
     out << "Adding a " << ptype->name() << " as a jet in the middle "
         << "of the box with " << m.jet_mom_ << " GeV initial momentum.\n";
   }
+  if (!m.wall_crossing_actions_) {
+    out << "Particles leaving the box are folded back at the end of every "
+           "time step.\n";
+  }
   return out;
 }
 
@@ -92,7 +99,9 @@ BoxModus::BoxModus(Configuration modus_config,
                          modus_config.take({"Box", "Jet", "Jet_PDG"}))
                    : std::nullopt),
 
-      jet_mom_(modus_config.take({"Box", "Jet", "Jet_Momentum"}, 20.)) {
+      jet_mom_(modus_config.take({"Box", "Jet", "Jet_Momentum"}, 20.)),
+      wall_crossing_actions_(
+          modus_config.take({"Box", "Wall_Crossing_Actions"}, true)) {
   if (parameters.res_lifetime_factor < 0.) {
     throw std::invalid_argument(
         "Resonance lifetime modifier cannot be negative!");
@@ -105,10 +114,7 @@ BoxModus::BoxModus(Configuration modus_config,
 
 double BoxModus::initial_conditions(Particles *particles,
                                     const ExperimentParameters &parameters) {
-  double momentum_radial = 0.0, mass = 0.0;
-  Angles phitheta;
   FourVector momentum_total(0, 0, 0, 0);
-  auto uniform_length = random::make_uniform_distribution(0.0, this->length_);
   const double T = this->temperature_;
   const double V = length_ * length_ * length_;
   /* Create NUMBER OF PARTICLES according to configuration, or thermal case */
@@ -148,7 +154,22 @@ double BoxModus::initial_conditions(Particles *particles,
   if (this->initial_condition_ == BoxInitialCondition::ThermalMomentaQuantum) {
     quantum_sampling = std::make_unique<QuantumSampling>(init_multipl_, V, T);
   }
-  for (ParticleData &data : *particles) {
+  const int n_threads = parameters.n_threads;
+  std::unique_ptr<BoltzmannSampling> boltzmann_sampling;
+  if (this->initial_condition_ ==
+      BoxInitialCondition::ThermalMomentaBoltzmann) {
+    ParticleTypePtrList types;
+    for (const ParticleData &data : *particles) {
+      if (std::find(types.begin(), types.end(), &data.type()) ==
+          types.end()) {
+        types.push_back(&data.type());
+      }
+    }
+    boltzmann_sampling = std::make_unique<BoltzmannSampling>(
+        types, T, account_for_resonance_widths_, n_threads);
+  }
+  sample_particles_in_parallel(n_threads, *particles, [&](ParticleData &data) {
+    double momentum_radial = 0.0, mass = 0.0;
     /* Set MOMENTUM SPACE distribution */
     if (this->initial_condition_ == BoxInitialCondition::PeakedMomenta) {
       /* initial thermal momentum is the average 3T */
@@ -158,10 +179,8 @@ double BoxModus::initial_conditions(Particles *particles,
       if (this->initial_condition_ ==
           BoxInitialCondition::ThermalMomentaBoltzmann) {
         /* thermal momentum according Maxwell-Boltzmann distribution */
-        mass = (!account_for_resonance_widths_)
-                   ? data.type().mass()
-                   : HadronGasEos::sample_mass_thermal(data.type(), 1.0 / T);
-        momentum_radial = sample_momenta_from_thermal(T, mass);
+        std::tie(mass, momentum_radial) =
+            boltzmann_sampling->sample(data.type());
       } else if (this->initial_condition_ ==
                  BoxInitialCondition::ThermalMomentaQuantum) {
         /*
@@ -173,18 +192,19 @@ double BoxModus::initial_conditions(Particles *particles,
         momentum_radial = quantum_sampling->sample(data.pdgcode());
       }
     }
+    Angles phitheta;
     phitheta.distribute_isotropically();
-    logg[LBox].debug(data.type().name(), "(id ", data.id(),
-                     ") radial momentum ", momentum_radial, ", direction",
-                     phitheta);
     data.set_4momentum(mass, phitheta.threevec() * momentum_radial);
-    momentum_total += data.momentum();
 
     /* Set COORDINATE SPACE distribution */
-    ThreeVector pos{uniform_length(), uniform_length(), uniform_length()};
+    ThreeVector pos{random::uniform(0.0, length_), random::uniform(0.0, length_),
+                    random::uniform(0.0, length_)};
     data.set_4position(FourVector(start_time_, pos));
     /// Initialize formation time
     data.set_formation_time(start_time_);
+  });
+  for (const ParticleData &data : *particles) {
+    momentum_total += data.momentum();
   }
 
   /* Make total 3-momentum 0 */
@@ -227,6 +247,9 @@ int BoxModus::impose_boundary_conditions(Particles *particles,
       const ParticleData incoming_particle(data);
       data.set_4position(position);
       ++wraps;
+      if (output_list.empty()) {
+        continue;
+      }
       ActionPtr action =
           std::make_unique<WallcrossingAction>(incoming_particle, data);
       for (const auto &output : output_list) {
@@ -87,16 +87,13 @@ void BremsstrahlungAction::generate_final_state() {
 
   outgoing_particles_ = proc->particle_list();
   process_type_ = proc->get_type();
-  FourVector interaction_point = get_interaction_point();
+  const FinalStateKinematics &kinematics = final_state_kinematics();
 
   // Sample k and theta:
   // minimum cutoff for k to be in accordance with cross section calculations
   double delta_k;  // k-range
   double k_min = 0.001;
-  double k_max =
-      (sqrt_s() * sqrt_s() - 2 * outgoing_particles_[0].type().mass() * 2 *
-                                 outgoing_particles_[1].type().mass()) /
-      (2 * sqrt_s());
+  double k_max = kinematics.k_max;
 
   if ((k_max - k_min) < 0.0) {
     // Make sure it is kinematically even possible to create a photon that is
@@ -131,9 +128,8 @@ void BremsstrahlungAction::generate_final_state() {
   for (auto &new_particle : outgoing_particles_) {
     // assuming decaying particles are always fully formed
     new_particle.set_formation_time(time_of_execution_);
-    new_particle.set_4position(interaction_point);
-    new_particle.boost_momentum(
-        -total_momentum_of_outgoing_particles().velocity());
+    new_particle.set_4position(kinematics.interaction_point);
+    new_particle.boost_momentum(-kinematics.velocity_cm);
   }
 
   // Photons are not really part of the normal processes, so we have to set a
@@ -142,12 +138,28 @@ void BremsstrahlungAction::generate_final_state() {
   Action::check_conservation(id_process);
 }
 
+const BremsstrahlungAction::FinalStateKinematics &
+BremsstrahlungAction::final_state_kinematics() {
+  if (!kinematics_) {
+    // These only depend on the incoming particles and the outgoing types.
+    const double sqrts = sqrt_s();
+    const double k_max =
+        (sqrts * sqrts - 2 * outgoing_particles_[0].type().mass() * 2 *
+                             outgoing_particles_[1].type().mass()) /
+        (2 * sqrts);
+    kinematics_ = {get_interaction_point(),
+                   total_momentum_of_outgoing_particles().velocity(), sqrts,
+                   k_max};
+  }
+  return *kinematics_;
+}
+
 void BremsstrahlungAction::sample_3body_phasespace() {
   assert(outgoing_particles_.size() == 3);
   const double m_a = outgoing_particles_[0].type().mass(),
                m_b = outgoing_particles_[1].type().mass(),
                m_c = outgoing_particles_[2].type().mass();
-  const double sqrts = sqrt_s();
+  const double sqrts = final_state_kinematics().sqrts;
   const double E_ab = sqrts - m_c - k_;  // Ekin of the pion pair in cm frame
   const double pcm = pCM(sqrts, E_ab, m_c);  // cm momentum of (π pair - photon)
   const double pcm_pions = pCM(E_ab, m_a, m_b);  // cm momentum within pion pair
@@ -185,12 +197,6 @@ CollisionBranchList BremsstrahlungAction::brems_cross_sections() {
   static const ParticleTypePtr pi_p_particle = &ParticleType::find(pdg::pi_p);
   static const ParticleTypePtr pi_m_particle = &ParticleType::find(pdg::pi_m);
 
-  // Create interpolation objects, if not yet existent; only trigger for one
-  // of them as either all or none is created
-  if (pi0pi0_pipi_dsigma_dtheta_interpolation == nullptr) {
-    create_interpolations();
-  }
-
   // Find cross section corresponding to given sqrt(s)
   double sqrts = sqrt_s();
   double xsection;
@@ -201,8 +207,12 @@ CollisionBranchList BremsstrahlungAction::brems_cross_sections() {
 
     // In the case of two oppositely charged pions as incoming particles,
     // there are two potential final states: pi+ + pi- and pi0 + pi0
-    double xsection_pipi = (*pipi_pipi_opp_interpolation)(sqrts);
-    double xsection_pi0pi0 = (*pipi_pi0pi0_interpolation)(sqrts);
+    double xsection_pipi =
+        bremsstrahlung_cross_sections(BremsstrahlungProcess::PiPi_PiPi_Opposite)
+            .sigma(sqrts);
+    double xsection_pi0pi0 =
+        bremsstrahlung_cross_sections(BremsstrahlungProcess::PiPi_Pi0Pi0)
+            .sigma(sqrts);
 
     // Prevent negative cross sections due to numerics in interpolation
     xsection_pipi = (xsection_pipi <= 0.0) ? really_small : xsection_pipi;
@@ -237,10 +247,14 @@ CollisionBranchList BremsstrahlungAction::brems_cross_sections() {
              reac_ == ReactionType::pi_z_pi_p) {
     // Here the final state hadrons are identical to the initial state hadrons
     if (reac_ == ReactionType::pi_m_pi_m || reac_ == ReactionType::pi_p_pi_p) {
-      xsection = (*pipi_pipi_same_interpolation)(sqrts);
+      xsection =
+          bremsstrahlung_cross_sections(BremsstrahlungProcess::PiPi_PiPi_Same)
+              .sigma(sqrts);
     } else {
       // One pi0 in initial and final state
-      xsection = (*pipi0_pipi0_interpolation)(sqrts);
+      xsection =
+          bremsstrahlung_cross_sections(BremsstrahlungProcess::PiPi0_PiPi0)
+              .sigma(sqrts);
     }
 
     // Prevent negative cross sections due to numerics in interpolation
@@ -253,7 +267,8 @@ CollisionBranchList BremsstrahlungAction::brems_cross_sections() {
   } else if (reac_ == ReactionType::pi_z_pi_z) {
     // Here we have a hard-coded final state that differs from the initial
     // state, namely: pi0 + pi0 -> pi+- + pi-+ + gamma
-    xsection = (*pi0pi0_pipi_interpolation)(sqrts);
+    xsection = bremsstrahlung_cross_sections(BremsstrahlungProcess::Pi0Pi0_PiPi)
+                   .sigma(sqrts);
 
     // Prevent negative cross sections due to numerics in interpolation
     xsection = (xsection <= 0.0) ? really_small : xsection;
@@ -270,42 +285,34 @@ CollisionBranchList BremsstrahlungAction::brems_cross_sections() {
 
 std::pair<double, double> BremsstrahlungAction::brems_diff_cross_sections() {
   static const ParticleTypePtr pi_z_particle = &ParticleType::find(pdg::pi_z);
-  const double collision_energy = sqrt_s();
-  double dsigma_dk;
-  double dsigma_dtheta;
+  const double collision_energy = final_state_kinematics().sqrts;
+  BremsstrahlungProcess process;
 
   if (reac_ == ReactionType::pi_p_pi_m) {
     if (outgoing_particles_[0].type() != *pi_z_particle) {
       // pi+- + pi+-- -> pi+- + pi+- + gamma
-      dsigma_dk =
-          (*pipi_pipi_opp_dsigma_dk_interpolation)(k_, collision_energy);
-      dsigma_dtheta = (*pipi_pipi_opp_dsigma_dtheta_interpolation)(
-          theta_, collision_energy);
+      process = BremsstrahlungProcess::PiPi_PiPi_Opposite;
     } else {
       // pi+- + pi+-- -> pi0 + pi0 + gamma
-      dsigma_dk = (*pipi_pi0pi0_dsigma_dk_interpolation)(k_, collision_energy);
-      dsigma_dtheta =
-          (*pipi_pi0pi0_dsigma_dtheta_interpolation)(theta_, collision_energy);
+      process = BremsstrahlungProcess::PiPi_Pi0Pi0;
     }
   } else if (reac_ == ReactionType::pi_p_pi_p ||
              reac_ == ReactionType::pi_m_pi_m) {
-    dsigma_dk = (*pipi_pipi_same_dsigma_dk_interpolation)(k_, collision_energy);
-    dsigma_dtheta =
-        (*pipi_pipi_same_dsigma_dtheta_interpolation)(theta_, collision_energy);
+    process = BremsstrahlungProcess::PiPi_PiPi_Same;
   } else if (reac_ == ReactionType::pi_z_pi_p ||
              reac_ == ReactionType::pi_z_pi_m) {
-    dsigma_dk = (*pipi0_pipi0_dsigma_dk_interpolation)(k_, collision_energy);
-    dsigma_dtheta =
-        (*pipi0_pipi0_dsigma_dtheta_interpolation)(theta_, collision_energy);
+    process = BremsstrahlungProcess::PiPi0_PiPi0;
   } else if (reac_ == ReactionType::pi_z_pi_z) {
-    dsigma_dk = (*pi0pi0_pipi_dsigma_dk_interpolation)(k_, collision_energy);
-    dsigma_dtheta =
-        (*pi0pi0_pipi_dsigma_dtheta_interpolation)(theta_, collision_energy);
+    process = BremsstrahlungProcess::Pi0Pi0_PiPi;
   } else {
     throw std::runtime_error(
         "Unkown channel when computing differential cross sections for "
         "bremsstrahlung processes.");
   }
+  const BremsstrahlungCrossSections &xs =
+      bremsstrahlung_cross_sections(process);
+  double dsigma_dk = xs.dsigma_dk(k_, collision_energy);
+  double dsigma_dtheta = xs.dsigma_dtheta(theta_, collision_energy);
 
   // Prevent negative cross sections due to numerics in interpolation
   dsigma_dk = (dsigma_dk < 0.0) ? really_small : dsigma_dk;
@@ -316,88 +323,4 @@ std::pair<double, double> BremsstrahlungAction::brems_diff_cross_sections() {
 
   return diff_x_sections;
 }
-
-void BremsstrahlungAction::create_interpolations() {
-  // Read in tabularized values for sqrt(s), k and theta
-  std::vector<double> sqrts = BREMS_SQRTS;
-  std::vector<double> photon_momentum = BREMS_K;
-  std::vector<double> photon_angle = BREMS_THETA;
-
-  // Read in tabularized total cross sections
-  std::vector<double> sigma_pipi_pipi_opp = BREMS_PIPI_PIPI_OPP_SIG;
-  std::vector<double> sigma_pipi_pipi_same = BREMS_PIPI_PIPI_SAME_SIG;
-  std::vector<double> sigma_pipi0_pipi0 = BREMS_PIPI0_PIPI0_SIG;
-  std::vector<double> sigma_pipi_pi0pi0 = BREMS_PIPI_PI0PI0_SIG;
-  std::vector<double> sigma_pi0pi0_pipi = BREMS_PI0PI0_PIPI_SIG;
-
-  // Read in tabularized differential cross sections dSigma/dk
-  std::vector<double> dsigma_dk_pipi_pipi_opp = BREMS_PIPI_PIPI_OPP_DIFF_SIG_K;
-  std::vector<double> dsigma_dk_pipi_pipi_same =
-      BREMS_PIPI_PIPI_SAME_DIFF_SIG_K;
-  std::vector<double> dsigma_dk_pipi0_pipi0 = BREMS_PIPI0_PIPI0_DIFF_SIG_K;
-  std::vector<double> dsigma_dk_pipi_pi0pi0 = BREMS_PIPI_PI0PI0_DIFF_SIG_K;
-  std::vector<double> dsigma_dk_pi0pi0_pipi = BREMS_PI0PI0_PIPI_DIFF_SIG_K;
-
-  // Read in tabularized differential cross sections dSigma/dtheta
-  std::vector<double> dsigma_dtheta_pipi_pipi_opp =
-      BREMS_PIPI_PIPI_OPP_DIFF_SIG_THETA;
-  std::vector<double> dsigma_dtheta_pipi_pipi_same =
-      BREMS_PIPI_PIPI_SAME_DIFF_SIG_THETA;
-  std::vector<double> dsigma_dtheta_pipi0_pipi0 =
-      BREMS_PIPI0_PIPI0_DIFF_SIG_THETA;
-  std::vector<double> dsigma_dtheta_pipi_pi0pi0 =
-      BREMS_PIPI_PI0PI0_DIFF_SIG_THETA;
-  std::vector<double> dsigma_dtheta_pi0pi0_pipi =
-      BREMS_PI0PI0_PIPI_DIFF_SIG_THETA;
-
-  // Create interpolation objects containing linear interpolations for
-  // total cross sections
-  pipi_pipi_opp_interpolation = std::make_unique<InterpolateDataLinear<double>>(
-      sqrts, sigma_pipi_pipi_opp);
-  pipi_pipi_same_interpolation =
-      std::make_unique<InterpolateDataLinear<double>>(sqrts,
-                                                      sigma_pipi_pipi_same);
-  pipi0_pipi0_interpolation =
-      std::make_unique<InterpolateDataLinear<double>>(sqrts, sigma_pipi0_pipi0);
-  pipi_pi0pi0_interpolation =
-      std::make_unique<InterpolateDataLinear<double>>(sqrts, sigma_pipi_pi0pi0);
-  pi0pi0_pipi_interpolation =
-      std::make_unique<InterpolateDataLinear<double>>(sqrts, sigma_pi0pi0_pipi);
-
-  // Create interpolation objects containing bicubic interpolations for
-  // differential dSigma/dk
-  pipi_pipi_opp_dsigma_dk_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_momentum, sqrts,
-                                                dsigma_dk_pipi_pipi_opp);
-  pipi_pipi_same_dsigma_dk_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_momentum, sqrts,
-                                                dsigma_dk_pipi_pipi_same);
-  pipi0_pipi0_dsigma_dk_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_momentum, sqrts,
-                                                dsigma_dk_pipi0_pipi0);
-  pipi_pi0pi0_dsigma_dk_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_momentum, sqrts,
-                                                dsigma_dk_pipi_pi0pi0);
-  pi0pi0_pipi_dsigma_dk_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_momentum, sqrts,
-                                                dsigma_dk_pi0pi0_pipi);
-
-  // Create interpolation objects containing bicubic interpolations for
-  // differential dSigma/dtheta
-  pipi_pipi_opp_dsigma_dtheta_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                                dsigma_dtheta_pipi_pipi_opp);
-  pipi_pipi_same_dsigma_dtheta_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                                dsigma_dtheta_pipi_pipi_same);
-  pipi0_pipi0_dsigma_dtheta_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                                dsigma_dtheta_pipi0_pipi0);
-  pipi_pi0pi0_dsigma_dtheta_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                                dsigma_dtheta_pipi_pi0pi0);
-  pi0pi0_pipi_dsigma_dtheta_interpolation =
-      std::make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                                dsigma_dtheta_pi0pi0_pipi);
-}
 }  // namespace smash
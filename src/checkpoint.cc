@@ -0,0 +1,64 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/checkpoint.h"
+
+#include <array>
+#include <sstream>
+#include <string>
+
+namespace smash {
+namespace checkpoint {
+
+namespace {
+/// Identifier at the beginning of every checkpoint
+constexpr std::array<char, 8> magic = {'S', 'M', 'A', 'S', 'H', 'C', 'K', 'P'};
+}  // unnamed namespace
+
+void write(std::ostream &out, const random::Engine &engine) {
+  // The text representation is the only portable access to the state.
+  std::ostringstream state;
+  state << engine;
+  const std::string text = state.str();
+  write(out, std::vector<char>(text.begin(), text.end()));
+}
+
+void read(std::istream &in, random::Engine &engine) {
+  std::vector<char> text;
+  read(in, text);
+  std::istringstream state(std::string(text.begin(), text.end()));
+  state >> engine;
+  if (!state) {
+    throw std::runtime_error("Invalid state of a random number engine.");
+  }
+}
+
+void write_header(std::ostream &out) {
+  write(out, magic);
+  write(out, version);
+}
+
+void read_header(std::istream &in) {
+  std::array<char, 8> id;
+  std::uint32_t file_version = 0;
+  in.read(id.data(), id.size());
+  if (!in || id != magic) {
+    throw std::runtime_error("The file is no SMASH checkpoint.");
+  }
+  read(in, file_version);
+  if (file_version != version) {
+    throw std::runtime_error("Checkpoint of version " +
+                             std::to_string(file_version) +
+                             " cannot be read, expected version " +
+                             std::to_string(version) + ".");
+  }
+}
+
+}  // namespace checkpoint
+}  // namespace smash
@@ -7,8 +7,9 @@
 
 #include "smash/clebschgordan_lookup.h"
 
-#include <numeric>
-#include <unordered_map>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
 
 #include "gsl/gsl_sf_coupling.h"
 
@@ -38,17 +39,51 @@ double ClebschGordan::calculate_coefficient(const int j_a, const int j_b,
   return result;
 }
 
+ClebschGordan::Table::Table() {
+  constexpr int n = tabulated_spins;
+  offsets.fill(-1);
+  for (int j_a = 0; j_a < n; j_a++) {
+    for (int j_b = 0; j_b < n; j_b++) {
+      for (int j_c = std::abs(j_a - j_b); j_c <= j_a + j_b && j_c < n;
+           j_c += 2) {
+        offsets[(j_a * n + j_b) * n + j_c] = coefficients.size();
+        for (int m_a = -j_a; m_a <= j_a; m_a += 2) {
+          for (int m_b = -j_b; m_b <= j_b; m_b += 2) {
+            coefficients.push_back(
+                calculate_coefficient(j_a, j_b, j_c, m_a, m_b, m_a + m_b));
+          }
+        }
+      }
+    }
+  }
+}
+
+const ClebschGordan::Table &ClebschGordan::table() {
+  // The initialization of a static local variable is thread-safe.
+  static const Table tabulated;
+  return tabulated;
+}
+
 double ClebschGordan::coefficient(const int j_a, const int j_b, const int j_c,
                                   const int m_a, const int m_b, const int m_c) {
-  const ThreeSpins spin_information = {j_a, j_b, j_c, m_a, m_b, m_c};
-  if (auto search = lookup_table.find(spin_information);
-      search != lookup_table.end()) {
-    return search->second;
-  } else {
-    double result = calculate_coefficient(j_a, j_b, j_c, m_a, m_b, m_c);
-    lookup_table.insert({spin_information, result});
-    return result;
+  if (m_a + m_b != m_c) {
+    return 0.;
+  }
+  constexpr int n = tabulated_spins;
+  const bool tabulated = j_a >= 0 && j_a < n && j_b >= 0 && j_b < n &&
+                         j_c >= 0 && j_c < n && std::abs(m_a) <= j_a &&
+                         std::abs(m_b) <= j_b && (j_a + m_a) % 2 == 0 &&
+                         (j_b + m_b) % 2 == 0;
+  if (!tabulated) {
+    return calculate_coefficient(j_a, j_b, j_c, m_a, m_b, m_c);
+  }
+  const Table &cg = table();
+  const int offset = cg.offsets[(j_a * n + j_b) * n + j_c];
+  if (offset < 0) {
+    return 0.;
   }
+  return cg.coefficients[offset + (m_a + j_a) / 2 * (j_b + 1) +
+                         (m_b + j_b) / 2];
 }
 
 }  // namespace smash
@@ -9,11 +9,16 @@
 
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -23,11 +28,140 @@
 #include "smash/experimentparameters.h"
 #include "smash/fourvector.h"
 #include "smash/logging.h"
+#include "smash/particles.h"
 #include "smash/random.h"
 
 namespace smash {
 static constexpr int LCollider = LogArea::Collider::id;
 
+namespace {
+/// Index of the random number stream of the initial state of an event
+constexpr uint64_t initial_state_stream = 0;
+
+/// Initial state of an event generated ahead of time
+struct PrefetchedState {
+  /// Number of the event
+  int event = -1;
+  /// Impact parameter
+  double impact = 0.;
+  /// Starting time of the simulation
+  double start_time = 0.;
+  /// Velocities of projectile and target
+  std::pair<double, double> velocities = {0., 0.};
+  /// Nucleons of every ensemble
+  std::vector<ParticleList> ensembles;
+  /// Exception thrown while generating the initial state
+  std::exception_ptr error;
+};
+}  // namespace
+
+/**
+ * Thread generating the initial states of the coming events, which keeps up
+ * to ColliderModus::prefetch_depth_ of them in a queue.
+ */
+struct ColliderModus::InitialStatePipeline {
+  /**
+   * Start generating initial states.
+   *
+   * \param[in] modus Modus whose nuclei are used by the thread from now on.
+   * \param[in] first_event Number of the first event.
+   * \param[in] event_stride Distance between the numbers of the events.
+   * \param[in] seed_of_event Gives the random seed of an event.
+   * \param[in] n_ensembles Number of ensembles of every event.
+   */
+  InitialStatePipeline(ColliderModus &modus, int first_event, int event_stride,
+                       std::function<int64_t(int)> seed_of_event,
+                       std::size_t n_ensembles)
+      : thread([this, &modus, first_event, event_stride,
+                seed_of_event = std::move(seed_of_event), n_ensembles]() {
+          generate(modus, first_event, event_stride, seed_of_event,
+                   n_ensembles);
+        }) {}
+  /// Stop the thread, dropping the initial states not taken
+  ~InitialStatePipeline() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    taken.notify_all();
+    thread.join();
+  }
+
+  /**
+   * Generate initial states until stopped or until one fails.
+   *
+   * \param[in] modus Modus whose nuclei are used.
+   * \param[in] event Number of the first event.
+   * \param[in] event_stride Distance between the numbers of the events.
+   * \param[in] seed_of_event Gives the random seed of an event.
+   * \param[in] n_ensembles Number of ensembles of every event.
+   */
+  void generate(ColliderModus &modus, int event, int event_stride,
+                const std::function<int64_t(int)> &seed_of_event,
+                std::size_t n_ensembles) {
+    const std::size_t depth = modus.prefetch_depth_;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        taken.wait(lock, [&] { return stop || states.size() < depth; });
+        if (stop) {
+          return;
+        }
+      }
+      PrefetchedState state;
+      state.event = event;
+      try {
+        random::Engine stream =
+            random::make_stream(seed_of_event(event), initial_state_stream);
+        random::ScopedEngine use_stream(stream);
+        state.impact = modus.draw_impact();
+        for (std::size_t i = 0; i < n_ensembles; i++) {
+          Particles particles;
+          state.start_time =
+              modus.collide_nuclei(state.impact, &particles, &state.velocities);
+          state.ensembles.push_back(particles.copy_to_vector());
+        }
+      } catch (...) {
+        state.error = std::current_exception();
+      }
+      const bool failed = static_cast<bool>(state.error);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        states.push_back(std::move(state));
+      }
+      generated.notify_one();
+      if (failed) {
+        return;
+      }
+      event += event_stride;
+    }
+  }
+
+  /// \return The next initial state, waiting until it is generated.
+  PrefetchedState take() {
+    std::unique_lock<std::mutex> lock(mutex);
+    generated.wait(lock, [this] { return !states.empty(); });
+    PrefetchedState state = std::move(states.front());
+    states.pop_front();
+    lock.unlock();
+    taken.notify_one();
+    return state;
+  }
+
+  /// Protects states and stop
+  std::mutex mutex;
+  /// Signalled when an initial state was generated
+  std::condition_variable generated;
+  /// Signalled when an initial state was taken or the thread has to stop
+  std::condition_variable taken;
+  /// Generated initial states in the order of the events
+  std::deque<PrefetchedState> states;
+  /// Whether the thread has to stop
+  bool stop = false;
+  /// The generating thread, started after all other members exist
+  std::thread thread;
+};
+
 ColliderModus::ColliderModus(Configuration modus_config,
                              const ExperimentParameters &params) {
   Configuration modus_cfg =
@@ -39,17 +173,13 @@ ColliderModus::ColliderModus(Configuration modus_config,
 
   Configuration proj_cfg = modus_cfg.extract_sub_configuration({"Projectile"});
   Configuration targ_cfg = modus_cfg.extract_sub_configuration({"Target"});
-  /* Needed to check if projectile and target in customnucleus are read from
-   * the same input file.*/
-  bool same_file = false;
   // Set up the projectile nucleus
   if (proj_cfg.has_value({"Deformed"})) {
     projectile_ =
         create_deformed_nucleus(proj_cfg, params.testparticles, "projectile");
   } else if (proj_cfg.has_value({"Custom"})) {
-    same_file = same_inputfile(proj_cfg, targ_cfg);
-    projectile_ = std::make_unique<CustomNucleus>(
-        proj_cfg, params.testparticles, same_file);
+    projectile_ =
+        std::make_unique<CustomNucleus>(proj_cfg, params.testparticles);
   } else {
     projectile_ = std::make_unique<Nucleus>(proj_cfg, params.testparticles);
   }
@@ -62,8 +192,7 @@ ColliderModus::ColliderModus(Configuration modus_config,
   if (targ_cfg.has_value({"Deformed"})) {
     target_ = create_deformed_nucleus(targ_cfg, params.testparticles, "target");
   } else if (targ_cfg.has_value({"Custom"})) {
-    target_ = std::make_unique<CustomNucleus>(targ_cfg, params.testparticles,
-                                              same_file);
+    target_ = std::make_unique<CustomNucleus>(targ_cfg, params.testparticles);
   } else {
     target_ = std::make_unique<Nucleus>(targ_cfg, params.testparticles);
   }
@@ -89,18 +218,7 @@ ColliderModus::ColliderModus(Configuration modus_config,
   const double mass_b = target_->mass() / target_->number_of_particles();
   // Option 1: Center of mass energy.
   if (modus_cfg.has_value({"Sqrtsnn"})) {
-    sqrt_s_NN_ = modus_cfg.take({"Sqrtsnn"});
-    // Check that input satisfies the lower bound (everything at rest).
-    if (sqrt_s_NN_ <= mass_a + mass_b) {
-      throw ModusDefault::InvalidEnergy(
-          "Input Error: sqrt(s_NN) is not larger than masses:\n" +
-          std::to_string(sqrt_s_NN_) + " GeV <= " + std::to_string(mass_a) +
-          " GeV + " + std::to_string(mass_b) + " GeV.");
-    }
-    // Set the total nucleus-nucleus collision energy.
-    total_s_ = (sqrt_s_NN_ * sqrt_s_NN_ - mass_a * mass_a - mass_b * mass_b) *
-                   mass_projec * mass_target / (mass_a * mass_b) +
-               mass_projec * mass_projec + mass_target * mass_target;
+    set_sqrt_s_NN(modus_cfg.take({"Sqrtsnn"}));
     energy_input++;
   }
   /* Option 2: Total energy per nucleon of the projectile nucleus
@@ -203,27 +321,103 @@ ColliderModus::ColliderModus(Configuration modus_config,
         "Please provide only one of Sqrtsnn/E_Kin/P_Lab.");
   }
 
+  Configuration impact_cfg = modus_cfg.extract_sub_configuration(
+      {"Impact"}, Configuration::GetEmpty::Yes);
+  take_impact_settings(impact_cfg);
+  // Look for user-defined initial separation between nuclei.
+  if (modus_cfg.has_value({"Initial_Distance"})) {
+    initial_z_displacement_ = modus_cfg.take({"Initial_Distance"});
+    // the displacement is half the distance (both nuclei are shifted
+    // initial_z_displacement_ away from origin)
+    initial_z_displacement_ /= 2.0;
+  }
+  prefetch_depth_ = modus_cfg.take({"Prefetch_Initial_States"}, 0);
+  if (prefetch_depth_ < 0) {
+    throw std::invalid_argument(
+        "Prefetch_Initial_States must not be negative.");
+  }
+  freeze_out_rate_ = modus_cfg.take({"Freeze_Out_Rate"}, 0.);
+  if (freeze_out_rate_ < 0.) {
+    throw std::invalid_argument("Freeze_Out_Rate must not be negative.");
+  }
+  exclude_spectators_ = modus_cfg.take({"Exclude_Spectators"}, true);
+
+  if (fermi_motion_ == FermiMotion::On) {
+    logg[LCollider].info() << "Fermi motion is ON.";
+  } else if (fermi_motion_ == FermiMotion::Frozen) {
+    logg[LCollider].info() << "FROZEN Fermi motion is on.";
+  } else if (fermi_motion_ == FermiMotion::Off) {
+    logg[LCollider].info() << "Fermi motion is OFF.";
+  }
+}
+
+ColliderModus::~ColliderModus() = default;
+
+void ColliderModus::reconfigure(Configuration &modus_config) {
+  const bool new_energy = modus_config.has_value({"Collider", "Sqrtsnn"});
+  const bool new_impact = modus_config.has_value({"Collider", "Impact"});
+  if (!new_energy && !new_impact) {
+    return;
+  }
+  // The background thread must not see the settings change.
+  pipeline_.reset();
+  if (new_energy) {
+    set_sqrt_s_NN(modus_config.take({"Collider", "Sqrtsnn"}));
+  }
+  if (new_impact) {
+    Configuration impact_cfg = modus_config.extract_sub_configuration(
+        {"Collider", "Impact"}, Configuration::GetEmpty::Yes);
+    take_impact_settings(impact_cfg);
+  }
+}
+
+void ColliderModus::set_sqrt_s_NN(double sqrt_s_NN) {
+  const double mass_projec = projectile_->mass();
+  const double mass_target = target_->mass();
+  // average mass of a particle in that nucleus
+  const double mass_a = mass_projec / projectile_->number_of_particles();
+  const double mass_b = mass_target / target_->number_of_particles();
+  // Check that input satisfies the lower bound (everything at rest).
+  if (sqrt_s_NN <= mass_a + mass_b) {
+    throw ModusDefault::InvalidEnergy(
+        "Input Error: sqrt(s_NN) is not larger than masses:\n" +
+        std::to_string(sqrt_s_NN) + " GeV <= " + std::to_string(mass_a) +
+        " GeV + " + std::to_string(mass_b) + " GeV.");
+  }
+  sqrt_s_NN_ = sqrt_s_NN;
+  // Set the total nucleus-nucleus collision energy.
+  total_s_ = (sqrt_s_NN_ * sqrt_s_NN_ - mass_a * mass_a - mass_b * mass_b) *
+                 mass_projec * mass_target / (mass_a * mass_b) +
+             mass_projec * mass_projec + mass_target * mass_target;
+}
+
+void ColliderModus::take_impact_settings(Configuration &impact_cfg) {
+  impact_ = 0.;
+  sampling_ = Sampling::Quadratic;
+  imp_min_ = 0.0;
+  imp_max_ = 0.0;
+  yield_max_ = 0.0;
+  impact_interpolation_.reset();
   /* Impact parameter setting: Either "Value", "Range", "Max" or "Sample".
    * Unspecified means 0 impact parameter.*/
-  if (modus_cfg.has_value({"Impact", "Value"})) {
-    impact_ = modus_cfg.take({"Impact", "Value"});
+  if (impact_cfg.has_value({"Value"})) {
+    impact_ = impact_cfg.take({"Value"});
     imp_min_ = impact_;
     imp_max_ = impact_;
   } else {
     // If impact is not supplied by value, inspect sampling parameters:
-    if (modus_cfg.has_value({"Impact", "Sample"})) {
-      sampling_ = modus_cfg.take({"Impact", "Sample"});
+    if (impact_cfg.has_value({"Sample"})) {
+      sampling_ = impact_cfg.take({"Sample"});
       if (sampling_ == Sampling::Custom) {
-        if (!(modus_cfg.has_value({"Impact", "Values"}) ||
-              modus_cfg.has_value({"Impact", "Yields"}))) {
+        if (!(impact_cfg.has_value({"Values"}) ||
+              impact_cfg.has_value({"Yields"}))) {
           throw std::domain_error(
               "Input Error: Need impact parameter spectrum for custom "
               "sampling. "
               "Please provide Values and Yields.");
         }
-        const std::vector<double> impacts =
-            modus_cfg.take({"Impact", "Values"});
-        const std::vector<double> yields = modus_cfg.take({"Impact", "Yields"});
+        const std::vector<double> impacts = impact_cfg.take({"Values"});
+        const std::vector<double> yields = impact_cfg.take({"Yields"});
         if (impacts.size() != yields.size()) {
           throw std::domain_error(
               "Input Error: Need as many impact parameter values as yields. "
@@ -239,35 +433,19 @@ ColliderModus::ColliderModus(Configuration modus_config,
         yield_max_ = *std::max_element(yields.begin(), yields.end());
       }
     }
-    if (modus_cfg.has_value({"Impact", "Range"})) {
-      const std::array<double, 2> range = modus_cfg.take({"Impact", "Range"});
+    if (impact_cfg.has_value({"Range"})) {
+      const std::array<double, 2> range = impact_cfg.take({"Range"});
       imp_min_ = range[0];
       imp_max_ = range[1];
     }
-    if (modus_cfg.has_value({"Impact", "Max"})) {
+    if (impact_cfg.has_value({"Max"})) {
       imp_min_ = 0.0;
-      imp_max_ = modus_cfg.take({"Impact", "Max"});
+      imp_max_ = impact_cfg.take({"Max"});
     }
   }
   /// \todo include a check that only one method of specifying impact is used
   // whether the direction of separation should be ramdomly smapled
-  random_reaction_plane_ =
-      modus_cfg.take({"Impact", "Random_Reaction_Plane"}, false);
-  // Look for user-defined initial separation between nuclei.
-  if (modus_cfg.has_value({"Initial_Distance"})) {
-    initial_z_displacement_ = modus_cfg.take({"Initial_Distance"});
-    // the displacement is half the distance (both nuclei are shifted
-    // initial_z_displacement_ away from origin)
-    initial_z_displacement_ /= 2.0;
-  }
-
-  if (fermi_motion_ == FermiMotion::On) {
-    logg[LCollider].info() << "Fermi motion is ON.";
-  } else if (fermi_motion_ == FermiMotion::Frozen) {
-    logg[LCollider].info() << "FROZEN Fermi motion is on.";
-  } else if (fermi_motion_ == FermiMotion::Off) {
-    logg[LCollider].info() << "Fermi motion is OFF.";
-  }
+  random_reaction_plane_ = impact_cfg.take({"Random_Reaction_Plane"}, false);
 }
 
 std::ostream &operator<<(std::ostream &out, const ColliderModus &m) {
@@ -316,6 +494,18 @@ std::unique_ptr<DeformedNucleus> ColliderModus::create_deformed_nucleus(
 
 double ColliderModus::initial_conditions(Particles *particles,
                                          const ExperimentParameters &) {
+  std::pair<double, double> velocities;
+  const double simulation_time = collide_nuclei(impact_, particles, &velocities);
+  // Calculate the beam velocity of the projectile and the target, which will be
+  // used to calculate the beam momenta in experiment.cc
+  if (fermi_motion_ == FermiMotion::Frozen) {
+    std::tie(velocity_projectile_, velocity_target_) = velocities;
+  }
+  return simulation_time;
+}
+
+double ColliderModus::collide_nuclei(double impact, Particles *particles,
+                                     std::pair<double, double> *velocities) {
   // Populate the nuclei with appropriately distributed nucleons.
   // If deformed, this includes rotating the nucleus.
   projectile_->arrange_nucleons();
@@ -335,12 +525,7 @@ double ColliderModus::initial_conditions(Particles *particles,
         "the center of velocity reference frame.");
   }
 
-  // Calculate the beam velocity of the projectile and the target, which will be
-  // used to calculate the beam momenta in experiment.cc
-  if (fermi_motion_ == FermiMotion::Frozen) {
-    velocity_projectile_ = v_a;
-    velocity_target_ = v_b;
-  }
+  *velocities = {v_a, v_b};
 
   // Generate Fermi momenta if necessary
   if (fermi_motion_ == FermiMotion::On ||
@@ -375,8 +560,8 @@ double ColliderModus::initial_conditions(Particles *particles,
   const double phi =
       random_reaction_plane_ ? random::uniform(0.0, 2.0 * M_PI) : 0.0;
 
-  projectile_->shift(proj_z, +impact_ / 2.0, simulation_time);
-  target_->shift(targ_z, -impact_ / 2.0, simulation_time);
+  projectile_->shift(proj_z, +impact / 2.0, simulation_time);
+  target_->shift(targ_z, -impact / 2.0, simulation_time);
 
   // Put the particles in the nuclei into code particles.
   projectile_->copy_particles(particles);
@@ -385,6 +570,37 @@ double ColliderModus::initial_conditions(Particles *particles,
   return simulation_time;
 }
 
+double ColliderModus::take_prefetched_initial_state(
+    int event, int event_stride,
+    const std::function<int64_t(int)> &seed_of_event,
+    std::vector<Particles> *ensembles) {
+  PrefetchedState state;
+  if (pipeline_) {
+    state = pipeline_->take();
+  }
+  if (!pipeline_ || state.event != event) {
+    // Stop the running thread before the nuclei are used by a new one.
+    pipeline_.reset();
+    pipeline_ = std::make_unique<InitialStatePipeline>(
+        *this, event, event_stride, seed_of_event, ensembles->size());
+    state = pipeline_->take();
+  }
+  if (state.error) {
+    pipeline_.reset();
+    std::rethrow_exception(state.error);
+  }
+  impact_ = state.impact;
+  if (fermi_motion_ == FermiMotion::Frozen) {
+    std::tie(velocity_projectile_, velocity_target_) = state.velocities;
+  }
+  for (std::size_t i = 0; i < ensembles->size(); i++) {
+    for (const ParticleData &p : state.ensembles[i]) {
+      (*ensembles)[i].insert(p);
+    }
+  }
+  return state.start_time;
+}
+
 void ColliderModus::rotate_reaction_plane(double phi, Particles *particles) {
   for (ParticleData &p : *particles) {
     ThreeVector pos = p.position().threevec();
@@ -396,16 +612,18 @@ void ColliderModus::rotate_reaction_plane(double phi, Particles *particles) {
   }
 }
 
-void ColliderModus::sample_impact() {
+void ColliderModus::sample_impact() { impact_ = draw_impact(); }
+
+double ColliderModus::draw_impact() const {
   switch (sampling_) {
     case Sampling::Quadratic: {
       // quadratic sampling: Note that for bmin > bmax, this still yields
       // the correct distribution (however canonical() = 0 is then the
       // upper end, not the lower).
-      impact_ = std::sqrt(imp_min_ * imp_min_ +
-                          random::canonical() *
-                              (imp_max_ * imp_max_ - imp_min_ * imp_min_));
-    } break;
+      return std::sqrt(imp_min_ * imp_min_ +
+                       random::canonical() *
+                           (imp_max_ * imp_max_ - imp_min_ * imp_min_));
+    }
     case Sampling::Custom: {
       // rejection sampling based on given distribution
       assert(impact_interpolation_ != nullptr);
@@ -418,13 +636,14 @@ void ColliderModus::sample_impact() {
         assert(probability < 1.);
         probability_random = random::uniform(0., 1.);
       }
-      impact_ = b;
-    } break;
+      return b;
+    }
     case Sampling::Uniform: {
       // linear sampling. Still, min > max works fine.
-      impact_ = random::uniform(imp_min_, imp_max_);
+      return random::uniform(imp_min_, imp_max_);
     }
   }
+  throw std::domain_error("Invalid impact parameter sampling.");
 }
 
 std::pair<double, double> ColliderModus::get_velocities(double s, double m_a,
@@ -464,30 +683,4 @@ std::string ColliderModus::custom_file_path(const std::string &file_directory,
   }
 }
 
-bool ColliderModus::same_inputfile(Configuration &proj_config,
-                                   Configuration &targ_config) {
-  /* Check if both nuclei are custom
-   * Only check target as function is called after if statement for projectile.
-   */
-  if (!targ_config.has_value({"Custom"})) {
-    return false;
-  }
-  std::string projectile_file_directory =
-      proj_config.read({"Custom", "File_Directory"});
-  std::string target_file_directory =
-      targ_config.read({"Custom", "File_Directory"});
-  std::string projectile_file_name = proj_config.read({"Custom", "File_Name"});
-  std::string target_file_name = targ_config.read({"Custom", "File_Name"});
-  // Check if files are the same for projectile and target
-  std::string proj_path =
-      custom_file_path(projectile_file_directory, projectile_file_name);
-  std::string targ_path =
-      custom_file_path(target_file_directory, target_file_name);
-  if (proj_path == targ_path) {
-    return true;
-  } else {
-    return false;
-  }
-}
-
 }  // namespace smash
@@ -0,0 +1,503 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/columnaroutput.h"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef SMASH_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "smash/clock.h"
+#include "smash/config.h"
+#include "smash/logging.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+/*!\Userguide
+ * \page doxypage_output_columnar
+ * The `Columnar` format stores the same particle lists as the binary
+ * particles output (see \ref doxypage_output_binary), but column by column, so
+ * that analyses reading only some quantities do not need to read and convert
+ * the others. It is only available for the `Particles` content and the file is
+ * called `particles_columnar.bin`. All numbers are stored in little endian.
+ *
+ * **Header**
+ * \code
+ * 4*char        uint16_t        uint16_t  uint32_t  len*char
+ * magic_number, format_version, flags,    len,      smash_version
+ * \endcode
+ * \li magic_number - 4 bytes that in ASCII read as "SMCL".
+ * \li Format version is an integer number, currently it is 1.
+ * \li Bit 0 of the flags is set if real numbers are stored as 4 bytes floats
+ *     instead of 8 bytes doubles, bit 1 if the columns are compressed with
+ *     zlib.
+ *
+ * **Chunk**\n
+ * Every particle list, i.e. at event start, at the output times and at event
+ * end depending on
+ * <tt>\ref key_output_particles_only_final_ "Only_Final"</tt>:
+ * \code
+ * char int32_t       uint32_t
+ * 'c'  event_number  n_particles
+ * \endcode
+ * followed by 12 columns, each of them as
+ * \code
+ * uint64_t  size*char
+ * size      data
+ * \endcode
+ * in the order t, x, y, z, mass, p0, px, py, pz, pdg, id, charge. The last
+ * three columns hold 4 bytes integers. The data are the n_particles values of
+ * the column, possibly compressed.
+ *
+ * **Event end**
+ * \code
+ * char int32_t       double            char
+ * 'f'  event_number  impact_parameter  empty_event
+ * \endcode
+ *
+ * **Index**\n
+ * When SMASH finishes, the positions of the chunks in the file are appended:
+ * \code
+ * char uint32_t  n_chunks*(int32_t, uint64_t)            uint64_t      4*char
+ * 'x'  n_chunks  (event_number, position of the chunk)   index_start   "SMCX"
+ * \endcode
+ * where index_start is the position of the 'x'. The class ColumnarReader of
+ * the SMASH library reads these files.
+ */
+
+namespace {
+/// Magic number at the start of columnar files
+constexpr char columnar_magic[4] = {'S', 'M', 'C', 'L'};
+/// Magic number at the end of the index of columnar files
+constexpr char index_magic[4] = {'S', 'M', 'C', 'X'};
+/// Flag for real numbers in single precision
+constexpr std::uint16_t single_precision_flag = 1;
+/// Flag for compressed columns
+constexpr std::uint16_t compressed_flag = 2;
+
+/**
+ * \param[in] p Particle.
+ * \param[in] field Column of real numbers.
+ * \return Value of the particle in this column.
+ */
+double real_field(const ParticleData &p, ColumnarField field) {
+  switch (field) {
+    case ColumnarField::T:
+      return p.position().x0();
+    case ColumnarField::X:
+      return p.position().x1();
+    case ColumnarField::Y:
+      return p.position().x2();
+    case ColumnarField::Z:
+      return p.position().x3();
+    case ColumnarField::Mass:
+      return p.effective_mass();
+    case ColumnarField::P0:
+      return p.momentum().x0();
+    case ColumnarField::Px:
+      return p.momentum().x1();
+    case ColumnarField::Py:
+      return p.momentum().x2();
+    case ColumnarField::Pz:
+      return p.momentum().x3();
+    default:
+      throw std::logic_error("Not a column of real numbers.");
+  }
+}
+
+/**
+ * \param[in] p Particle.
+ * \param[in] field Column of integers.
+ * \return Value of the particle in this column.
+ */
+std::int32_t integer_field(const ParticleData &p, ColumnarField field) {
+  switch (field) {
+    case ColumnarField::Pdg:
+      return p.pdgcode().get_decimal();
+    case ColumnarField::Id:
+      return p.id();
+    case ColumnarField::Charge:
+      return p.type().charge();
+    default:
+      throw std::logic_error("Not a column of integers.");
+  }
+}
+
+/**
+ * \param[in] field Column.
+ * \param[in] single_precision Whether real numbers are stored as floats.
+ * \return Number of bytes of a value in this column.
+ */
+std::size_t value_size(ColumnarField field, bool single_precision) {
+  return is_integer_column(field) || single_precision ? 4 : 8;
+}
+
+/**
+ * Compression level that can be used with this build of SMASH.
+ * \param[in] requested Compression level from the configuration.
+ * \return The compression level, 0 if zlib is not available.
+ * \throw std::invalid_argument if the level is not between 0 and 9.
+ */
+int usable_compression_level(int requested) {
+  if (requested < 0 || requested > 9) {
+    throw std::invalid_argument(
+        "Compression_Level of the columnar output must be between 0 and 9.");
+  }
+#ifndef SMASH_USE_ZLIB
+  if (requested > 0) {
+    logg[LOutput].warn(
+        "Compression of the columnar output requested, but zlib support not "
+        "compiled in. The columns are stored uncompressed.");
+  }
+  return 0;
+#else
+  return requested;
+#endif
+}
+
+/**
+ * Read a value from a file.
+ * \param[in] file File to read from.
+ * \param[out] x Value read.
+ * \throw std::runtime_error if the file ends before.
+ */
+template <typename T>
+void read_value(std::FILE *file, T &x) {
+  if (std::fread(&x, sizeof(T), 1, file) != 1) {
+    throw std::runtime_error("Unexpected end of columnar file.");
+  }
+}
+
+/**
+ * Move to a position in a file.
+ * \param[in] file File to seek in.
+ * \param[in] position Position from the beginning of the file.
+ * \throw std::runtime_error if the position cannot be reached.
+ */
+void seek(std::FILE *file, std::uint64_t position) {
+  if (std::fseek(file, static_cast<long>(position), SEEK_SET) != 0) {
+    throw std::runtime_error("Invalid position in columnar file.");
+  }
+}
+}  // namespace
+
+ColumnarOutput::ColumnarOutput(const std::filesystem::path &path,
+                               std::string name,
+                               const OutputParameters &out_par)
+    : OutputInterface(name),
+      file_{path / "particles_columnar.bin", "wb"},
+      single_precision_(out_par.part_single_precision),
+      compression_level_(
+          usable_compression_level(out_par.part_compression_level)),
+      only_final_(out_par.part_only_final) {
+  write_bytes(columnar_magic, 4);
+  write_bytes(&format_version, sizeof(format_version));
+  const std::uint16_t flags = (single_precision_ ? single_precision_flag : 0) |
+                              (compression_level_ > 0 ? compressed_flag : 0);
+  write_bytes(&flags, sizeof(flags));
+  const std::string version = SMASH_VERSION;
+  const auto len = static_cast<std::uint32_t>(version.size());
+  write_bytes(&len, sizeof(len));
+  write_bytes(version.data(), version.size());
+}
+
+ColumnarOutput::~ColumnarOutput() {
+  const std::uint64_t index_start = position_;
+  const char xchar = 'x';
+  write_bytes(&xchar, sizeof(char));
+  const auto n_chunks = static_cast<std::uint32_t>(index_.size());
+  write_bytes(&n_chunks, sizeof(n_chunks));
+  for (const auto &[event_number, chunk_position] : index_) {
+    write_bytes(&event_number, sizeof(event_number));
+    write_bytes(&chunk_position, sizeof(chunk_position));
+  }
+  write_bytes(&index_start, sizeof(index_start));
+  write_bytes(index_magic, 4);
+}
+
+void ColumnarOutput::write_bytes(const void *data, std::size_t n) {
+  std::fwrite(data, 1, n, file_.get());
+  position_ += n;
+}
+
+void ColumnarOutput::write_chunk(const Particles &particles,
+                                 int event_number) {
+  index_.emplace_back(event_number, position_);
+  const char cchar = 'c';
+  write_bytes(&cchar, sizeof(char));
+  const std::int32_t event = event_number;
+  write_bytes(&event, sizeof(event));
+  const auto n = static_cast<std::uint32_t>(particles.size());
+  write_bytes(&n, sizeof(n));
+  for (std::size_t f = 0; f < n_columnar_fields; f++) {
+    const auto field = static_cast<ColumnarField>(f);
+    const std::size_t width = value_size(field, single_precision_);
+    column_.resize(n * width);
+    char *out = column_.data();
+    for (const ParticleData &p : particles) {
+      if (is_integer_column(field)) {
+        const std::int32_t x = integer_field(p, field);
+        std::memcpy(out, &x, width);
+      } else if (single_precision_) {
+        const float x = static_cast<float>(real_field(p, field));
+        std::memcpy(out, &x, width);
+      } else {
+        const double x = real_field(p, field);
+        std::memcpy(out, &x, width);
+      }
+      out += width;
+    }
+    const char *data = column_.data();
+    std::uint64_t size = column_.size();
+#ifdef SMASH_USE_ZLIB
+    if (compression_level_ > 0) {
+      uLongf compressed_size = compressBound(column_.size());
+      compressed_.resize(compressed_size);
+      if (compress2(reinterpret_cast<Bytef *>(compressed_.data()),
+                    &compressed_size,
+                    reinterpret_cast<const Bytef *>(column_.data()),
+                    column_.size(), compression_level_) != Z_OK) {
+        throw std::runtime_error("Compression of a column failed.");
+      }
+      data = compressed_.data();
+      size = compressed_size;
+    }
+#endif
+    write_bytes(&size, sizeof(size));
+    write_bytes(data, size);
+  }
+}
+
+void ColumnarOutput::at_eventstart(const Particles &particles,
+                                   const int event_number, const EventInfo &) {
+  event_number_ = event_number;
+  if (only_final_ == OutputOnlyFinal::No) {
+    write_chunk(particles, event_number);
+  }
+}
+
+void ColumnarOutput::at_eventend(const Particles &particles,
+                                 const int event_number,
+                                 const EventInfo &event) {
+  if (!(event.empty_event && only_final_ == OutputOnlyFinal::IfNotEmpty)) {
+    write_chunk(particles, event_number);
+  }
+
+  // Event end line
+  const char fchar = 'f';
+  write_bytes(&fchar, sizeof(char));
+  const std::int32_t number = event_number;
+  write_bytes(&number, sizeof(number));
+  write_bytes(&event.impact_parameter, sizeof(double));
+  const char empty = event.empty_event;
+  write_bytes(&empty, sizeof(char));
+
+  // Flush to disk
+  std::fflush(file_.get());
+}
+
+void ColumnarOutput::at_intermediate_time(const Particles &particles,
+                                          const std::unique_ptr<Clock> &,
+                                          const DensityParameters &,
+                                          const EventInfo &) {
+  if (only_final_ == OutputOnlyFinal::No) {
+    write_chunk(particles, event_number_);
+  }
+}
+
+ColumnarReader::ColumnarReader(const std::filesystem::path &path)
+    : file_{fopen(path, "rb")} {
+  std::FILE *file = file_.get();
+  if (!file) {
+    throw std::runtime_error("Cannot open " + path.string() + ".");
+  }
+  char magic[4];
+  if (std::fread(magic, 1, 4, file) != 4 ||
+      std::memcmp(magic, columnar_magic, 4) != 0) {
+    throw std::runtime_error(path.string() + " is not a columnar file.");
+  }
+  std::uint16_t version, flags;
+  read_value(file, version);
+  if (version != ColumnarOutput::format_version) {
+    throw std::runtime_error("Unsupported version of the columnar format.");
+  }
+  read_value(file, flags);
+  single_precision_ = flags & single_precision_flag;
+  compressed_ = flags & compressed_flag;
+#ifndef SMASH_USE_ZLIB
+  if (compressed_) {
+    throw std::runtime_error(
+        "Compressed columnar file, but zlib support not compiled in.");
+  }
+#endif
+  std::uint32_t len;
+  read_value(file, len);
+  first_chunk_ = 4 + 2 * sizeof(std::uint16_t) + sizeof(len) + len;
+
+  // Look for the index at the end of the file
+  std::uint64_t index_start = 0;
+  if (std::fseek(file, -static_cast<long>(sizeof(index_start) + 4),
+                 SEEK_END) == 0 &&
+      std::fread(&index_start, sizeof(index_start), 1, file) == 1 &&
+      std::fread(magic, 1, 4, file) == 4 &&
+      std::memcmp(magic, index_magic, 4) == 0) {
+    seek(file, index_start);
+    char xchar;
+    std::uint32_t n_chunks;
+    read_value(file, xchar);
+    read_value(file, n_chunks);
+    index_.resize(n_chunks);
+    for (auto &[event_number, chunk_position] : index_) {
+      read_value(file, event_number);
+      read_value(file, chunk_position);
+    }
+  } else {
+    logg[LOutput].warn("No index found in ", path,
+                       ", probably SMASH did not finish. Scanning the file.");
+    scan_chunks();
+  }
+}
+
+void ColumnarReader::scan_chunks() {
+  std::FILE *file = file_.get();
+  std::fseek(file, 0, SEEK_END);
+  const auto file_size = static_cast<std::uint64_t>(std::ftell(file));
+  std::uint64_t position = first_chunk_;
+  seek(file, position);
+  // Incomplete chunks at the end of the file are dropped.
+  try {
+    while (position < file_size) {
+      char block_type;
+      read_value(file, block_type);
+      if (block_type == 'f') {
+        position += 1 + sizeof(std::int32_t) + sizeof(double) + 1;
+      } else if (block_type == 'c') {
+        std::int32_t event_number;
+        std::uint32_t n;
+        read_value(file, event_number);
+        read_value(file, n);
+        std::uint64_t end = position + 1 + sizeof(event_number) + sizeof(n);
+        for (std::size_t f = 0; f < n_columnar_fields; f++) {
+          std::uint64_t size;
+          read_value(file, size);
+          end += sizeof(size) + size;
+          seek(file, end);
+        }
+        if (end > file_size) {
+          break;
+        }
+        index_.emplace_back(event_number, position);
+        position = end;
+      } else {
+        break;
+      }
+      seek(file, position);
+    }
+  } catch (std::runtime_error &) {
+  }
+}
+
+std::vector<std::int32_t> ColumnarReader::event_numbers() const {
+  std::vector<std::int32_t> events;
+  events.reserve(index_.size());
+  for (const auto &entry : index_) {
+    events.push_back(entry.first);
+  }
+  return events;
+}
+
+std::vector<ColumnarChunk> ColumnarReader::read_event(
+    std::int32_t event_number, const std::vector<ColumnarField> &fields) {
+  std::vector<ColumnarChunk> chunks;
+  for (std::size_t i = 0; i < index_.size(); i++) {
+    if (index_[i].first == event_number) {
+      chunks.push_back(read_chunk(i, fields));
+    }
+  }
+  return chunks;
+}
+
+ColumnarChunk ColumnarReader::read_chunk(
+    std::size_t i, const std::vector<ColumnarField> &fields) {
+  std::FILE *file = file_.get();
+  seek(file, index_.at(i).second);
+  char cchar;
+  read_value(file, cchar);
+  if (cchar != 'c') {
+    throw std::runtime_error("Invalid chunk in columnar file.");
+  }
+  ColumnarChunk chunk;
+  read_value(file, chunk.event_number);
+  read_value(file, chunk.n_particles);
+  std::array<bool, n_columnar_fields> requested{};
+  for (ColumnarField field : fields) {
+    requested[static_cast<std::size_t>(field)] = true;
+  }
+  std::vector<char> stored, raw;
+  for (std::size_t f = 0; f < n_columnar_fields; f++) {
+    const auto field = static_cast<ColumnarField>(f);
+    std::uint64_t size;
+    read_value(file, size);
+    if (!requested[f]) {
+      if (std::fseek(file, static_cast<long>(size), SEEK_CUR) != 0) {
+        throw std::runtime_error("Invalid column in columnar file.");
+      }
+      continue;
+    }
+    stored.resize(size);
+    if (std::fread(stored.data(), 1, size, file) != size) {
+      throw std::runtime_error("Unexpected end of columnar file.");
+    }
+    const std::size_t width = value_size(field, single_precision_);
+    raw.resize(chunk.n_particles * width);
+    if (compressed_) {
+#ifdef SMASH_USE_ZLIB
+      uLongf raw_size = raw.size();
+      if (uncompress(reinterpret_cast<Bytef *>(raw.data()), &raw_size,
+                     reinterpret_cast<const Bytef *>(stored.data()),
+                     stored.size()) != Z_OK ||
+          raw_size != raw.size()) {
+        throw std::runtime_error("Decompression of a column failed.");
+      }
+#endif
+    } else if (stored.size() == raw.size()) {
+      std::swap(stored, raw);
+    } else {
+      throw std::runtime_error("Invalid column size in columnar file.");
+    }
+    const char *in = raw.data();
+    if (is_integer_column(field)) {
+      std::vector<std::int32_t> &column = chunk.integers[field];
+      column.resize(chunk.n_particles);
+      std::memcpy(column.data(), in, raw.size());
+    } else if (single_precision_) {
+      std::vector<double> &column = chunk.reals[field];
+      column.resize(chunk.n_particles);
+      for (double &x : column) {
+        float value;
+        std::memcpy(&value, in, width);
+        x = value;
+        in += width;
+      }
+    } else {
+      std::vector<double> &column = chunk.reals[field];
+      column.resize(chunk.n_particles);
+      std::memcpy(column.data(), in, raw.size());
+    }
+  }
+  return chunk;
+}
+
+}  // namespace smash
@@ -11,6 +11,8 @@
 
 #include <cstdio>
 #include <filesystem>
+#include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -68,7 +70,8 @@ void descend_one_existing_level(std::optional<YAML::Node> &node,
  */
 YAML::Node remove_empty_maps(YAML::Node root) {
   if (root.IsMap()) {
-    std::vector<std::string> to_remove(root.size());
+    std::vector<std::string> to_remove;
+    to_remove.reserve(root.size());
     for (auto n : root) {
       remove_empty_maps(n.second);
       // If the node is an empty sequence, we do NOT remove it!
@@ -151,8 +154,10 @@ Configuration::Configuration(const std::filesystem::path &path,
 
 Configuration::Configuration(Configuration &&other)
     : root_node_(std::move(other.root_node_)),
+      empty_maps_removed_(other.empty_maps_removed_),
       uncaught_exceptions_(std::move(other.uncaught_exceptions_)) {
   other.root_node_.reset();
+  other.empty_maps_removed_ = false;
   other.uncaught_exceptions_ = 0;
 }
 
@@ -160,8 +165,10 @@ Configuration &Configuration::operator=(Configuration &&other) {
   // YAML does not offer != operator between nodes
   if (!(root_node_ == other.root_node_)) {
     root_node_ = std::move(other.root_node_);
+    empty_maps_removed_ = other.empty_maps_removed_;
     uncaught_exceptions_ = std::move(other.uncaught_exceptions_);
     other.root_node_.reset();
+    other.empty_maps_removed_ = false;
     other.uncaught_exceptions_ = 0;
   }
   return *this;
@@ -181,6 +188,7 @@ Configuration::~Configuration() noexcept(false) {
 }
 
 void Configuration::merge_yaml(const std::string &yaml) {
+  empty_maps_removed_ = false;
   try {
     root_node_ |= YAML::Load(yaml);
   } catch (YAML::ParserException &e) {
@@ -218,7 +226,7 @@ Configuration::Value Configuration::take(
         "Attempt to take value of a not existing key: " + join_quoted(keys));
   }
   previous_to_last_node.value().remove(*last_key_it);
-  root_node_ = remove_empty_maps(root_node_);
+  remove_empty_maps_along({keys.begin(), last_key_it});
   return {to_be_returned.value(), *last_key_it};
 }
 
@@ -297,7 +305,7 @@ Configuration Configuration::extract_sub_configuration(
   } else if (sub_conf_root_node->IsMap() && sub_conf_root_node->size() != 0) {
     Configuration sub_config{*sub_conf_root_node};
     previous_to_section_node->remove(*last_key_it);
-    root_node_ = remove_empty_maps(root_node_);
+    remove_empty_maps_along({keys.begin(), last_key_it});
     return sub_config;
   } else {  // sequence or scalar or any future new YAML type
     throw std::runtime_error("Tried to extract configuration section at " +
@@ -336,6 +344,32 @@ std::optional<YAML::Node> Configuration::find_existing_node(
   return node;
 }
 
+void Configuration::remove_empty_maps_along(std::vector<const char *> keys) {
+  if (!empty_maps_removed_) {
+    root_node_ = remove_empty_maps(root_node_);
+    empty_maps_removed_ = true;
+    return;
+  }
+  /* Without empty maps elsewhere in the tree, only the maps along the path of
+   * the removed key can have become empty. They are removed from the deepest
+   * one upwards, as long as they are empty. */
+  std::vector<YAML::Node> path{root_node_};
+  std::optional<YAML::Node> node{root_node_};
+  for (const auto &key : keys) {
+    descend_one_existing_level(node, key);
+    if (!node) {
+      break;
+    }
+    path.push_back(node.value());
+  }
+  for (std::size_t i = path.size() - 1; i > 0; i--) {
+    if (!path[i].IsMap() || path[i].size() != 0) {
+      break;
+    }
+    path[i - 1].remove(keys[i - 1]);
+  }
+}
+
 YAML::Node Configuration::find_node_creating_it_if_not_existing(
     std::vector<const char *> keys) const {
   assert(keys.size() > 0);
@@ -513,20 +547,27 @@ void adjust_list_of_labels_dealing_with_keys_taken_as_maps(
  * \return \c Configuration::Is::Invalid if the key is invalid.
  */
 Configuration::Is validate_key(const KeyLabels &labels) {
-  auto key_ref_var_it = std::find_if(
-      smash::InputKeys::list.begin(), smash::InputKeys::list.end(),
-      [&labels](auto key) {
-        return std::visit(
-            [&labels](auto &&arg) { return arg.get().has_same_labels(labels); },
-            key);
-      });
-  if (key_ref_var_it == smash::InputKeys::list.end()) {
+  /* The database is indexed by the labels of the keys once, instead of being
+   * searched linearly for every key of every configuration. For equal labels
+   * the first key of the database is kept. */
+  static const auto keys_by_labels = [] {
+    std::map<KeyLabels, smash::InputKeys::key_references_variant> index;
+    for (const auto &key : smash::InputKeys::list) {
+      index.emplace(std::visit([](auto &&var) { return var.get().labels(); },
+                               key),
+                    key);
+    }
+    return index;
+  }();
+  const auto key_ref_var_it = keys_by_labels.find(labels);
+  if (key_ref_var_it == keys_by_labels.end()) {
     logg[LConfiguration].error("Key ", smash::quote(smash::join(labels, ": ")),
                                " is not a valid SMASH input key.");
     return Configuration::Is::Invalid;
   }
 
-  smash::InputKeys::key_references_variant found_variant = *key_ref_var_it;
+  smash::InputKeys::key_references_variant found_variant =
+      key_ref_var_it->second;
   const auto key_labels =
       std::visit([](auto &&var) { return static_cast<std::string>(var.get()); },
                  found_variant);
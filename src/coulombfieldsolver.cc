@@ -0,0 +1,264 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/coulombfieldsolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "smash/constants.h"
+#include "smash/parallel.h"
+
+namespace smash {
+
+namespace {
+/// \return whether n is a power of two
+bool is_power_of_two(int n) { return n > 0 && (n & (n - 1)) == 0; }
+
+/**
+ * Discrete Fourier transform of rows of a fixed length, by the radix-2 fast
+ * Fourier transform for powers of two and by the definition otherwise.
+ */
+class RowTransform {
+ public:
+  /**
+   * Prepare the transform.
+   * \param[in] n Length of the rows
+   */
+  explicit RowTransform(int n) : n_(n), twiddles_(n) {
+    for (int k = 0; k < n; k++) {
+      twiddles_[k] = std::polar(1.0, -2.0 * M_PI * k / n);
+    }
+  }
+
+  /**
+   * Transform a row in place.
+   * \param[inout] row Values of the row
+   * \param[out] work Buffer of the length of the row
+   * \param[in] inverse Whether to do the inverse transform, without the
+   *            division by the length
+   */
+  void operator()(std::complex<double> *row, std::complex<double> *work,
+                  bool inverse) const {
+    auto twiddle = [&](int k) {
+      return inverse ? std::conj(twiddles_[k]) : twiddles_[k];
+    };
+    if (!is_power_of_two(n_)) {
+      for (int k = 0; k < n_; k++) {
+        std::complex<double> sum = 0.0;
+        for (int j = 0; j < n_; j++) {
+          sum += row[j] * twiddle(static_cast<int>(
+                              static_cast<std::int64_t>(j) * k % n_));
+        }
+        work[k] = sum;
+      }
+      std::copy(work, work + n_, row);
+      return;
+    }
+    for (int i = 1, j = 0; i < n_; i++) {
+      int bit = n_ >> 1;
+      for (; j & bit; bit >>= 1) {
+        j ^= bit;
+      }
+      j ^= bit;
+      if (i < j) {
+        std::swap(row[i], row[j]);
+      }
+    }
+    for (int length = 2; length <= n_; length <<= 1) {
+      const int step = n_ / length;
+      for (int start = 0; start < n_; start += length) {
+        for (int k = 0; k < length / 2; k++) {
+          const std::complex<double> u = row[start + k];
+          const std::complex<double> v =
+              row[start + k + length / 2] * twiddle(k * step);
+          row[start + k] = u + v;
+          row[start + k + length / 2] = u - v;
+        }
+      }
+    }
+  }
+
+ private:
+  /// Length of the rows
+  int n_;
+  /// \f$ \exp(-2 \pi i k / n) \f$ for k = 0, ..., n-1
+  std::vector<std::complex<double>> twiddles_;
+};
+}  // unnamed namespace
+
+CoulombFieldSolver::CoulombFieldSolver(const std::array<int, 3> &n_cells,
+                                       const std::array<double, 3> &cell_sizes,
+                                       bool periodic, double r_cut,
+                                       int n_threads)
+    : n_cells_(n_cells), n_threads_(n_threads) {
+  /* RectangularLattice::integrate_volume sums over the nodes j with
+   * ceil(i - a) <= j < ceil(i + a) around the node i, where a = r_cut / h,
+   * hence over the distances i - j from -(ceil(a) - 1) to floor(a). */
+  std::array<int, 3> lowest, highest;
+  for (int dir = 0; dir < 3; dir++) {
+    if (n_cells[dir] <= 0 || !(cell_sizes[dir] > 0.)) {
+      throw std::invalid_argument("Invalid lattice for the Coulomb fields.");
+    }
+    const double a = r_cut / cell_sizes[dir];
+    lowest[dir] = 1 - static_cast<int>(std::ceil(a));
+    highest[dir] = static_cast<int>(std::floor(a));
+    if (periodic) {
+      n_padded_[dir] = n_cells[dir];
+    } else {
+      // Distances beyond the lattice do not occur.
+      lowest[dir] = std::max(lowest[dir], 1 - n_cells[dir]);
+      highest[dir] = std::min(highest[dir], n_cells[dir] - 1);
+      const int reach = std::max(-lowest[dir], highest[dir]);
+      n_padded_[dir] = 1;
+      while (n_padded_[dir] < n_cells[dir] + reach) {
+        n_padded_[dir] *= 2;
+      }
+    }
+  }
+
+  const std::size_t size =
+      static_cast<std::size_t>(n_padded_[0]) * n_padded_[1] * n_padded_[2];
+  for (Spectrum &component : kernel_) {
+    component.assign(size, 0.0);
+  }
+  const double cell_volume = cell_sizes[0] * cell_sizes[1] * cell_sizes[2];
+  auto wrap = [](int i, int n) { return ((i % n) + n) % n; };
+  for (int dz = lowest[2]; dz <= highest[2]; dz++) {
+    for (int dy = lowest[1]; dy <= highest[1]; dy++) {
+      for (int dx = lowest[0]; dx <= highest[0]; dx++) {
+        if (dx == 0 && dy == 0 && dz == 0) {
+          continue;
+        }
+        const ThreeVector dr(dx * cell_sizes[0], dy * cell_sizes[1],
+                             dz * cell_sizes[2]);
+        const ThreeVector k =
+            elementary_charge * cell_volume * dr / std::pow(dr.abs(), 3);
+        const std::size_t index =
+            wrap(dx, n_padded_[0]) +
+            n_padded_[0] * (wrap(dy, n_padded_[1]) +
+                            static_cast<std::size_t>(n_padded_[1]) *
+                                wrap(dz, n_padded_[2]));
+        // On small periodic lattices, several distances fall on one node.
+        for (int c = 0; c < 3; c++) {
+          kernel_[c][index] += k[c];
+        }
+      }
+    }
+  }
+  for (Spectrum &component : kernel_) {
+    transform(component, false);
+  }
+}
+
+void CoulombFieldSolver::transform(Spectrum &data, bool inverse) const {
+  const std::array<std::size_t, 3> strides = {
+      1, static_cast<std::size_t>(n_padded_[0]),
+      static_cast<std::size_t>(n_padded_[0]) * n_padded_[1]};
+  for (int dir = 0; dir < 3; dir++) {
+    const int n = n_padded_[dir];
+    if (n == 1) {
+      continue;
+    }
+    const RowTransform row_transform(n);
+    const std::size_t n_rows = data.size() / n;
+    parallel_for(n_threads_, n_rows, 16, [&](std::size_t i_row) {
+      // The row crosses all nodes with the same other indices.
+      const std::size_t first = i_row % strides[dir] +
+                                i_row / strides[dir] * strides[dir] * n;
+      thread_local std::vector<std::complex<double>> row, work;
+      row.resize(n);
+      work.resize(n);
+      for (int k = 0; k < n; k++) {
+        row[k] = data[first + k * strides[dir]];
+      }
+      row_transform(row.data(), work.data(), inverse);
+      for (int k = 0; k < n; k++) {
+        data[first + k * strides[dir]] = row[k];
+      }
+    });
+  }
+  if (inverse) {
+    const double norm = 1.0 / data.size();
+    for (std::complex<double> &value : data) {
+      value *= norm;
+    }
+  }
+}
+
+void CoulombFieldSolver::compute_fields(
+    RectangularLattice<DensityOnLattice> &charge_density,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> &fields) const {
+  if (charge_density.n_cells() != n_cells_ || fields.n_cells() != n_cells_) {
+    throw std::invalid_argument(
+        "The lattices do not match the Coulomb field solver.");
+  }
+  const std::size_t size =
+      static_cast<std::size_t>(n_padded_[0]) * n_padded_[1] * n_padded_[2];
+  auto padded_index = [this](int ix, int iy, int iz) {
+    return ix + n_padded_[0] * (iy + static_cast<std::size_t>(n_padded_[1]) *
+                                         iz);
+  };
+  auto for_each_node = [&](auto &&f) {
+    std::size_t node = 0;
+    for (int iz = 0; iz < n_cells_[2]; iz++) {
+      for (int iy = 0; iy < n_cells_[1]; iy++) {
+        for (int ix = 0; ix < n_cells_[0]; ix++) {
+          f(node++, padded_index(ix, iy, iz));
+        }
+      }
+    }
+  };
+
+  // Charge density and the components of the current
+  std::array<Spectrum, 4> sources;
+  for (Spectrum &source : sources) {
+    source.assign(size, 0.0);
+  }
+  for_each_node([&](std::size_t node, std::size_t index) {
+    DensityOnLattice &value = charge_density[node];
+    const ThreeVector j = value.jmu_net().threevec();
+    sources[0][index] = value.rho();
+    for (int c = 0; c < 3; c++) {
+      sources[c + 1][index] = j[c];
+    }
+  });
+  for (Spectrum &source : sources) {
+    transform(source, false);
+  }
+
+  /* E = rho * K and B = j x K, where * is the convolution, are products of
+   * the Fourier transforms. */
+  Spectrum result(size);
+  for (int c = 0; c < 3; c++) {
+    for (std::size_t k = 0; k < size; k++) {
+      result[k] = sources[0][k] * kernel_[c][k];
+    }
+    transform(result, true);
+    for_each_node([&](std::size_t node, std::size_t index) {
+      fields[node].first[c] = result[index].real();
+    });
+  }
+  for (int c = 0; c < 3; c++) {
+    const int c1 = (c + 1) % 3, c2 = (c + 2) % 3;
+    for (std::size_t k = 0; k < size; k++) {
+      result[k] = sources[c1 + 1][k] * kernel_[c2][k] -
+                  sources[c2 + 1][k] * kernel_[c1][k];
+    }
+    transform(result, true);
+    for_each_node([&](std::size_t node, std::size_t index) {
+      fields[node].second[c] = result[index].real();
+    });
+  }
+}
+
+}  // namespace smash
@@ -0,0 +1,137 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/crosssectioncache.h"
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "smash/particledata.h"
+#include "smash/potential_globals.h"
+
+namespace smash {
+
+CrossSectionCache::CrossSectionCache(double bin_width)
+    : bin_width_(bin_width) {
+  if (!(bin_width_ > 0.)) {
+    throw std::invalid_argument(
+        "The bin width of the cross-section cache has to be positive.");
+  }
+}
+
+std::int64_t CrossSectionCache::bin_of(double sqrt_s) const {
+  return static_cast<std::int64_t>(std::floor(sqrt_s / bin_width_));
+}
+
+bool CrossSectionCache::applies_to(const ParticleList &incoming,
+                                   double sqrt_s) const {
+  if (incoming.size() != 2 || UB_lat_pointer || UI3_lat_pointer) {
+    return false;
+  }
+  if (!incoming[0].type().is_stable() || !incoming[1].type().is_stable()) {
+    return false;
+  }
+  // The lower edge of the bin has to be above the threshold.
+  const double lower_edge = bin_of(sqrt_s) * bin_width_;
+  return lower_edge > incoming[0].type().mass() + incoming[1].type().mass();
+}
+
+double CrossSectionCache::total(const ParticleList &incoming, double sqrt_s,
+                                const std::function<double(double)> &evaluate) {
+  ParticleTypePtr a = &incoming[0].type();
+  ParticleTypePtr b = &incoming[1].type();
+  if (b < a) {
+    std::swap(a, b);
+  }
+  const std::int64_t bin = bin_of(sqrt_s);
+  std::array<double, 2> edges;
+  std::array<bool, 2> found = {false, false};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < 2; i++) {
+      const auto it = totals_.find(Key{a, b, bin + i});
+      if (it != totals_.end()) {
+        found[i] = true;
+        edges[i] = it->second;
+      }
+    }
+  }
+  // Missing edges are evaluated without holding the lock.
+  for (int i = 0; i < 2; i++) {
+    if (!found[i]) {
+      edges[i] = evaluate((bin + i) * bin_width_);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (found[0] && found[1]) {
+      hits_++;
+    } else {
+      misses_++;
+      for (int i = 0; i < 2; i++) {
+        if (!found[i]) {
+          totals_.emplace(Key{a, b, bin + i}, edges[i]);
+        }
+      }
+    }
+  }
+  const double fraction = sqrt_s / bin_width_ - bin;
+  return edges[0] + fraction * (edges[1] - edges[0]);
+}
+
+/**
+ * \param[in] branches List of collision branches
+ * \return independent copy of the branches
+ */
+static CollisionBranchList copy_branches(const CollisionBranchList &branches) {
+  CollisionBranchList copy;
+  copy.reserve(branches.size());
+  for (const CollisionBranchPtr &branch : branches) {
+    copy.push_back(std::make_unique<CollisionBranch>(
+        branch->particle_types(), branch->weight(), branch->get_type()));
+  }
+  return copy;
+}
+
+CollisionBranchList CrossSectionCache::branches(
+    const ParticleList &incoming, double sqrt_s,
+    const std::function<CollisionBranchList(double)> &evaluate) {
+  const std::int64_t bin = bin_of(sqrt_s);
+  const Key key{&incoming[0].type(), &incoming[1].type(), bin};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = branches_.find(key);
+    if (it != branches_.end()) {
+      hits_++;
+      return copy_branches(it->second);
+    }
+  }
+  CollisionBranchList evaluated = evaluate(bin * bin_width_);
+  CollisionBranchList result = copy_branches(evaluated);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    misses_++;
+    branches_.emplace(key, std::move(evaluated));
+  }
+  return result;
+}
+
+std::uint64_t CrossSectionCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+std::uint64_t CrossSectionCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+}  // namespace smash
@@ -124,12 +124,12 @@ CollisionBranchList CrossSections::generate_collision_list(
     p_pythia = string_probability(finder_parameters);
   }
 
+  const Dispatch& routines = dispatch(t1, t2);
+
   /* Elastic collisions between two nucleons with sqrt_s below
    * low_snn_cut can not happen. */
   const bool reject_by_nucleon_elastic_cutoff =
-      t1.is_nucleon() && t2.is_nucleon() &&
-      t1.antiparticle_sign() == t2.antiparticle_sign() &&
-      sqrt_s_ < finder_parameters.low_snn_cut;
+      routines.nucleon_pair && sqrt_s_ < finder_parameters.low_snn_cut;
   bool incl_elastic =
       finder_parameters.included_2to2[IncludedReactions::Elastic];
   if (incl_elastic && !reject_by_nucleon_elastic_cutoff) {
@@ -157,7 +157,8 @@ CollisionBranchList CrossSections::generate_collision_list(
       append_list(process_list, two_to_one(),
                   (1. - p_pythia) * finder_parameters.scale_xs);
     }
-    if (finder_parameters.included_2to2.any()) {
+    if (finder_parameters.included_2to2.any() &&
+        routines.two_to_two != TwoToTwoRoutine::None) {
       // 2->2 (inelastic)
       append_list(
           process_list,
@@ -165,16 +166,15 @@ CollisionBranchList CrossSections::generate_collision_list(
                      finder_parameters.transition_high_energy.KN_offset),
           (1. - p_pythia) * finder_parameters.scale_xs);
     }
-    if (finder_parameters
-            .included_multi[IncludedMultiParticleReactions::Deuteron_3to2] ==
-        1) {
+    const auto& included_multi = finder_parameters.included_multi;
+    if (routines.two_to_three &&
+        included_multi[IncludedMultiParticleReactions::Deuteron_3to2] == 1) {
       // 2->3 (deuterons only 2-to-3 reaction at the moment)
       append_list(process_list, two_to_three(),
                   (1. - p_pythia) * finder_parameters.scale_xs);
     }
-    if (finder_parameters
-            .included_multi[IncludedMultiParticleReactions::A3_Nuclei_4to2] ==
-        1) {
+    if (routines.two_to_four &&
+        included_multi[IncludedMultiParticleReactions::A3_Nuclei_4to2] == 1) {
       // 2->4
       append_list(process_list, two_to_four(),
                   (1. - p_pythia) * finder_parameters.scale_xs);
@@ -340,63 +340,63 @@ CollisionBranchList CrossSections::rare_two_to_two() const {
 
 double CrossSections::elastic_parametrization(const bool use_AQM,
                                               const double pipi_offset) const {
-  const PdgCode& pdg_a = incoming_particles_[0].type().pdgcode();
-  const PdgCode& pdg_b = incoming_particles_[1].type().pdgcode();
-  double elastic_xs = 0.0;
-  if ((pdg_a.is_nucleon() && pdg_b.is_pion()) ||
-      (pdg_b.is_nucleon() && pdg_a.is_pion())) {
-    // Elastic Nucleon Pion Scattering
-    elastic_xs = npi_el();
-  } else if ((pdg_a.is_nucleon() && pdg_b.is_kaon()) ||
-             (pdg_b.is_nucleon() && pdg_a.is_kaon())) {
-    // Elastic Nucleon Kaon Scattering
-    elastic_xs = nk_el();
-  } else if (pdg_a.is_nucleon() && pdg_b.is_nucleon() &&
-             pdg_a.antiparticle_sign() == pdg_b.antiparticle_sign()) {
-    // Elastic Nucleon Nucleon Scattering
-    elastic_xs = nn_el();
-  } else if (pdg_a.is_nucleon() && pdg_b.is_nucleon() &&
-             pdg_a.antiparticle_sign() == -pdg_b.antiparticle_sign()) {
-    // Elastic Nucleon anti-Nucleon Scattering
-    elastic_xs = ppbar_elastic(sqrt_s_ * sqrt_s_);
-  } else if (pdg_a.is_nucleus() || pdg_b.is_nucleus()) {
-    const PdgCode& pdg_nucleus = pdg_a.is_nucleus() ? pdg_a : pdg_b;
-    const PdgCode& pdg_other = pdg_a.is_nucleus() ? pdg_b : pdg_a;
-    const bool is_deuteron = pdg_nucleus.is_deuteron();  // d or anti-d
-    if (is_deuteron && pdg_other.is_pion()) {
+  const Dispatch& routines =
+      dispatch(incoming_particles_[0].type(), incoming_particles_[1].type());
+  const double m1 = incoming_particles_[0].effective_mass();
+  const double m2 = incoming_particles_[1].effective_mass();
+  const double s = sqrt_s_ * sqrt_s_;
+  switch (routines.elastic) {
+    case ElasticRoutine::NPi:
+      // Elastic Nucleon Pion Scattering
+      return npi_el();
+    case ElasticRoutine::NK:
+      // Elastic Nucleon Kaon Scattering
+      return nk_el();
+    case ElasticRoutine::NN:
+      // Elastic Nucleon Nucleon Scattering
+      return nn_el();
+    case ElasticRoutine::NNbar:
+      // Elastic Nucleon anti-Nucleon Scattering
+      return ppbar_elastic(s);
+    case ElasticRoutine::DeuteronPion:
       // Elastic (Anti-)deuteron Pion Scattering
-      elastic_xs = deuteron_pion_elastic(sqrt_s_ * sqrt_s_);
-    } else if (is_deuteron && pdg_other.is_nucleon()) {
+      return deuteron_pion_elastic(s);
+    case ElasticRoutine::DeuteronNucleon:
       // Elastic (Anti-)deuteron (Anti-)Nucleon Scattering
-      elastic_xs = deuteron_nucleon_elastic(sqrt_s_ * sqrt_s_);
-    }
-  } else if (use_AQM) {
-    const double m1 = incoming_particles_[0].effective_mass();
-    const double m2 = incoming_particles_[1].effective_mass();
-    const double s = sqrt_s_ * sqrt_s_;
-    if (pdg_a.is_baryon() && pdg_b.is_baryon()) {
+      return deuteron_nucleon_elastic(s);
+    case ElasticRoutine::None:
+      return 0.0;
+    default:
+      break;
+  }
+  if (!use_AQM) {
+    return 0.0;
+  }
+  double elastic_xs = 0.0;
+  switch (routines.elastic) {
+    case ElasticRoutine::AQMBaryonBaryon:
       elastic_xs = nn_el();  // valid also for annihilation
-    } else if ((pdg_a.is_meson() && pdg_b.is_baryon()) ||
-               (pdg_b.is_meson() && pdg_a.is_baryon())) {
+      break;
+    case ElasticRoutine::AQMMesonBaryon:
       elastic_xs = piplusp_elastic_high_energy(s, m1, m2);
-    } else if (pdg_a.is_meson() && pdg_b.is_meson()) {
+      break;
+    case ElasticRoutine::AQMPiPlusPiMinus:
       /* Special case: the pi+pi- elastic cross-section goes through resonances
        * at low sqrt_s, so we turn it off for this region so as not to destroy
        * the agreement with experimental data; this does not
        * apply to other pi pi cross-sections, which do not have any data */
-      if (((pdg_a == pdg::pi_p && pdg_b == pdg::pi_m) ||
-           (pdg_a == pdg::pi_m && pdg_b == pdg::pi_p)) &&
-          (m1 + m2 + pipi_offset) > sqrt_s_) {
-        elastic_xs = 0.0;
-      } else {
-        // meson-meson goes through scaling from π+p parametrization
-        elastic_xs = 2. / 3. * piplusp_elastic_AQM(s, m1, m2);
+      if ((m1 + m2 + pipi_offset) > sqrt_s_) {
+        return 0.0;
       }
-    }
-    elastic_xs *=
-        (1. - 0.4 * pdg_a.frac_strange()) * (1. - 0.4 * pdg_b.frac_strange());
+      [[fallthrough]];
+    case ElasticRoutine::AQMMesonMeson:
+      // meson-meson goes through scaling from π+p parametrization
+      elastic_xs = 2. / 3. * piplusp_elastic_AQM(s, m1, m2);
+      break;
+    default:
+      break;
   }
-  return elastic_xs;
+  return elastic_xs * routines.aqm_factor;
 }
 
 double CrossSections::nn_el() const {
@@ -847,12 +847,11 @@ CollisionBranchList CrossSections::two_to_one() const {
   const double m2 = incoming_particles_[1].effective_mass();
   const double p_cm_sqr = pCM_sqr(sqrt_s_, m1, m2);
 
-  ParticleTypePtrList possible_resonances =
-      list_possible_resonances(&type_particle_a, &type_particle_b);
-
-  // Find all the possible resonances
-  for (const ParticleTypePtr type_resonance : possible_resonances) {
-    double resonance_xsection = formation(*type_resonance, p_cm_sqr);
+  // Loop over all the possible resonances
+  for (const FormationCandidate& candidate : DecayModes::formation_candidates(
+           &type_particle_a, &type_particle_b)) {
+    const ParticleTypePtr type_resonance = candidate.resonance;
+    double resonance_xsection = formation(candidate, p_cm_sqr);
 
     // If cross section is non-negligible, add resonance to the list
     if (resonance_xsection > really_small) {
@@ -868,14 +867,16 @@ CollisionBranchList CrossSections::two_to_one() const {
   return resonance_process_list;
 }
 
-double CrossSections::formation(const ParticleType& type_resonance,
+double CrossSections::formation(const FormationCandidate& candidate,
                                 double cm_momentum_sqr) const {
+  const ParticleType& type_resonance = *candidate.resonance;
   const ParticleType& type_particle_a = incoming_particles_[0].type();
   const ParticleType& type_particle_b = incoming_particles_[1].type();
 
   // Calculate partial in-width.
   const double partial_width = type_resonance.get_partial_in_width(
-      sqrt_s_, incoming_particles_[0], incoming_particles_[1]);
+      sqrt_s_, incoming_particles_[0], incoming_particles_[1],
+      candidate.in_modes);
   if (partial_width <= 0.) {
     return 0.;
   }
@@ -901,53 +902,192 @@ double CrossSections::formation(const ParticleType& type_resonance,
 
 CollisionBranchList CrossSections::two_to_two(
     const ReactionsBitSet& included_2to2, const double KN_offset) const {
-  CollisionBranchList process_list;
-  const ParticleData& data_a = incoming_particles_[0];
-  const ParticleData& data_b = incoming_particles_[1];
-  const ParticleType& type_a = data_a.type();
-  const ParticleType& type_b = data_b.type();
-  const auto& pdg_a = data_a.pdgcode();
-  const auto& pdg_b = data_b.pdgcode();
-
-  if (data_a.is_baryon() && data_b.is_baryon()) {
-    if (pdg_a.is_nucleon() && pdg_b.is_nucleon() &&
-        pdg_a.antiparticle_sign() == pdg_b.antiparticle_sign()) {
+  switch (dispatch(incoming_particles_[0].type(),
+                   incoming_particles_[1].type())
+              .two_to_two) {
+    case TwoToTwoRoutine::NN:
       // Nucleon Nucleon Scattering
-      process_list = nn_xx(included_2to2);
-    } else {
+      return nn_xx(included_2to2);
+    case TwoToTwoRoutine::BBExceptNN:
       // Baryon Baryon Scattering
-      process_list = bb_xx_except_nn(included_2to2);
-    }
+      return bb_xx_except_nn(included_2to2);
+    case TwoToTwoRoutine::NK:
+      // Nucleon Kaon Scattering
+      return nk_xx(included_2to2, KN_offset);
+    case TwoToTwoRoutine::YPi:
+      // Hyperon Pion Scattering
+      return ypi_xx(included_2to2);
+    case TwoToTwoRoutine::DeltaK:
+      // Delta Kaon Scattering
+      return deltak_xx(included_2to2);
+    case TwoToTwoRoutine::DN:
+      // Nucleon Deuteron and Nucleon d' Scattering
+      return dn_xx(included_2to2);
+    case TwoToTwoRoutine::DPi:
+      // Pion Deuteron and Pion d' Scattering
+      return dpi_xx(included_2to2);
+    case TwoToTwoRoutine::None:
+      break;
+  }
+  return {};
+}
+
+CrossSections::Dispatch CrossSections::find_dispatch(
+    const ParticleType& type_a, const ParticleType& type_b) {
+  const PdgCode& pdg_a = type_a.pdgcode();
+  const PdgCode& pdg_b = type_b.pdgcode();
+  Dispatch routines;
+
+  routines.nucleon_pair =
+      type_a.is_nucleon() && type_b.is_nucleon() &&
+      type_a.antiparticle_sign() == type_b.antiparticle_sign();
+
+  if (type_a.is_baryon() && type_b.is_baryon()) {
+    // Nucleon Nucleon Scattering or Baryon Baryon Scattering
+    routines.two_to_two = routines.nucleon_pair ? TwoToTwoRoutine::NN
+                                                : TwoToTwoRoutine::BBExceptNN;
   } else if ((type_a.is_baryon() && type_b.is_meson()) ||
              (type_a.is_meson() && type_b.is_baryon())) {
-    // Baryon Meson Scattering
     if ((pdg_a.is_nucleon() && pdg_b.is_kaon()) ||
         (pdg_b.is_nucleon() && pdg_a.is_kaon())) {
-      // Nucleon Kaon Scattering
-      process_list = nk_xx(included_2to2, KN_offset);
+      routines.two_to_two = TwoToTwoRoutine::NK;
     } else if ((pdg_a.is_hyperon() && pdg_b.is_pion()) ||
                (pdg_b.is_hyperon() && pdg_a.is_pion())) {
-      // Hyperon Pion Scattering
-      process_list = ypi_xx(included_2to2);
+      routines.two_to_two = TwoToTwoRoutine::YPi;
     } else if ((pdg_a.is_Delta() && pdg_b.is_kaon()) ||
                (pdg_b.is_Delta() && pdg_a.is_kaon())) {
-      // Delta Kaon Scattering
-      process_list = deltak_xx(included_2to2);
+      routines.two_to_two = TwoToTwoRoutine::DeltaK;
     }
   } else if (type_a.is_nucleus() || type_b.is_nucleus()) {
     if ((type_a.is_nucleon() && type_b.is_nucleus()) ||
         (type_b.is_nucleon() && type_a.is_nucleus())) {
-      // Nucleon Deuteron and Nucleon d' Scattering
-      process_list = dn_xx(included_2to2);
+      routines.two_to_two = TwoToTwoRoutine::DN;
     } else if (((type_a.is_deuteron() || type_a.is_dprime()) &&
                 pdg_b.is_pion()) ||
                ((type_b.is_deuteron() || type_b.is_dprime()) &&
                 pdg_a.is_pion())) {
-      // Pion Deuteron and Pion d' Scattering
-      process_list = dpi_xx(included_2to2);
+      routines.two_to_two = TwoToTwoRoutine::DPi;
+    }
+  }
+
+  // Same conditions as in two_to_three() and two_to_four()
+  routines.two_to_three = (type_a.is_deuteron() && pdg_b.is_pion()) ||
+                          (type_b.is_deuteron() && pdg_a.is_pion()) ||
+                          (type_a.is_nucleon() && type_b.is_deuteron()) ||
+                          (type_b.is_nucleon() && type_a.is_deuteron());
+  const ParticleType& type_nucleus = type_a.is_nucleus() ? type_a : type_b;
+  const ParticleType& type_catalyzer = type_a.is_nucleus() ? type_b : type_a;
+  routines.two_to_four =
+      type_nucleus.is_nucleus() &&
+      std::abs(type_nucleus.baryon_number()) == 3 &&
+      (type_catalyzer.is_pion() || type_catalyzer.is_nucleon());
+
+  // Same conditions as in elastic_parametrization()
+  routines.nucleon_antinucleon_pair =
+      pdg_a.is_nucleon() && pdg_b.is_nucleon() &&
+      pdg_a.antiparticle_sign() == -pdg_b.antiparticle_sign();
+  const bool baryon_meson = (pdg_a.is_baryon() && pdg_b.is_meson()) ||
+                            (pdg_a.is_meson() && pdg_b.is_baryon());
+  if ((pdg_a.is_nucleon() && pdg_b.is_pion()) ||
+      (pdg_b.is_nucleon() && pdg_a.is_pion())) {
+    routines.elastic = ElasticRoutine::NPi;
+  } else if ((pdg_a.is_nucleon() && pdg_b.is_kaon()) ||
+             (pdg_b.is_nucleon() && pdg_a.is_kaon())) {
+    routines.elastic = ElasticRoutine::NK;
+  } else if (routines.nucleon_pair) {
+    routines.elastic = ElasticRoutine::NN;
+  } else if (routines.nucleon_antinucleon_pair) {
+    routines.elastic = ElasticRoutine::NNbar;
+  } else if (pdg_a.is_nucleus() || pdg_b.is_nucleus()) {
+    const PdgCode& pdg_nucleus = pdg_a.is_nucleus() ? pdg_a : pdg_b;
+    const PdgCode& pdg_other = pdg_a.is_nucleus() ? pdg_b : pdg_a;
+    if (pdg_nucleus.is_deuteron() && pdg_other.is_pion()) {
+      routines.elastic = ElasticRoutine::DeuteronPion;
+    } else if (pdg_nucleus.is_deuteron() && pdg_other.is_nucleon()) {
+      routines.elastic = ElasticRoutine::DeuteronNucleon;
+    }
+  } else if (pdg_a.is_baryon() && pdg_b.is_baryon()) {
+    routines.elastic = ElasticRoutine::AQMBaryonBaryon;
+  } else if (baryon_meson) {
+    routines.elastic = ElasticRoutine::AQMMesonBaryon;
+  } else if (pdg_a.is_meson() && pdg_b.is_meson()) {
+    const bool piplus_piminus = (pdg_a == pdg::pi_p && pdg_b == pdg::pi_m) ||
+                                (pdg_a == pdg::pi_m && pdg_b == pdg::pi_p);
+    routines.elastic = piplus_piminus ? ElasticRoutine::AQMPiPlusPiMinus
+                                      : ElasticRoutine::AQMMesonMeson;
+  }
+
+  // Same conditions as in high_energy()
+  if (pdg_a.is_baryon() && pdg_b.is_baryon()) {
+    const int sign = pdg_a.antiparticle_sign() * pdg_b.antiparticle_sign();
+    if (pdg_a == pdg_b) {
+      routines.high_energy = HighEnergyRoutine::PP;
+    } else if (sign == 1) {
+      routines.high_energy = HighEnergyRoutine::NP;
+    } else if (sign == -1) {
+      routines.high_energy = pdg_a.is_antiparticle_of(pdg_b)
+                                 ? HighEnergyRoutine::PPbar
+                                 : HighEnergyRoutine::NPbar;
+    }
+  }
+  if ((pdg_a == pdg::pi_p && pdg_b == pdg::p) ||
+      (pdg_b == pdg::pi_p && pdg_a == pdg::p) ||
+      (pdg_a == pdg::pi_m && pdg_b == pdg::n) ||
+      (pdg_b == pdg::pi_m && pdg_a == pdg::n)) {
+    routines.high_energy = HighEnergyRoutine::PiPlusP;
+  } else if (baryon_meson) {
+    routines.high_energy = HighEnergyRoutine::PiMinusP;
+  }
+  if (pdg_a.is_meson() && pdg_b.is_meson()) {
+    routines.high_energy = HighEnergyRoutine::MesonMeson;
+  }
+
+  // Same conditions as in string_probability()
+  routines.nucleon_pion_pair = (pdg_a.is_pion() && type_b.is_nucleon()) ||
+                               (type_a.is_nucleon() && pdg_b.is_pion());
+  routines.aqm_pair =
+      (type_a.is_baryon() && type_b.is_baryon() &&
+       type_a.antiparticle_sign() == type_b.antiparticle_sign()) ||
+      baryon_meson || (type_a.is_meson() && type_b.is_meson());
+  const bool is_KplusP =
+      ((pdg_a == pdg::K_p || pdg_a == pdg::K_z) && (pdg_b == pdg::p)) ||
+      ((pdg_b == pdg::K_p || pdg_b == pdg::K_z) && (pdg_a == pdg::p)) ||
+      ((pdg_a == -pdg::K_p || pdg_a == -pdg::K_z) && (pdg_b == -pdg::p)) ||
+      ((pdg_b == -pdg::K_p || pdg_b == -pdg::K_z) && (pdg_a == -pdg::p));
+  if (is_KplusP) {
+    routines.string_offset = StringOffset::KN;
+  } else if (pdg_a.is_pion() && pdg_b.is_pion()) {
+    routines.string_offset = StringOffset::PiPi;
+  }
+
+  routines.aqm_factor =
+      (1. - 0.4 * pdg_a.frac_strange()) * (1. - 0.4 * pdg_b.frac_strange());
+  return routines;
+}
+
+void CrossSections::initialize_dispatch_table() {
+  const ParticleTypeList& types = ParticleType::list_all();
+  dispatch_table_.clear();
+  dispatch_table_.reserve(types.size() * types.size());
+  for (const ParticleType& type_a : types) {
+    for (const ParticleType& type_b : types) {
+      dispatch_table_.push_back(find_dispatch(type_a, type_b));
     }
   }
-  return process_list;
+}
+
+const CrossSections::Dispatch& CrossSections::dispatch(
+    const ParticleType& type_a, const ParticleType& type_b) {
+  const ParticleTypeList& types = ParticleType::list_all();
+  const std::size_t n_types = types.size();
+  if (dispatch_table_.size() != n_types * n_types) {
+    initialize_dispatch_table();
+  }
+  const auto index_a = std::addressof(type_a) - std::addressof(types[0]);
+  const auto index_b = std::addressof(type_b) - std::addressof(types[0]);
+  assert(index_a >= 0 && static_cast<std::size_t>(index_a) < n_types);
+  assert(index_b >= 0 && static_cast<std::size_t>(index_b) < n_types);
+  return dispatch_table_[index_a * n_types + index_b];
 }
 
 CollisionBranchList CrossSections::two_to_three() const {
@@ -2474,12 +2614,13 @@ CollisionBranchList CrossSections::string_excitation(
    * Also calculate the multiplicative factor for AQM
    * based on the quark contents. */
   std::array<int, 2> pdgid;
-  double AQM_factor = 1.;
   for (int i = 0; i < 2; i++) {
     PdgCode pdg = incoming_particles_[i].type().pdgcode();
     pdgid[i] = StringProcess::pdg_map_for_pythia(pdg);
-    AQM_factor *= (1. - 0.4 * pdg.frac_strange());
   }
+  const double AQM_factor =
+      dispatch(incoming_particles_[0].type(), incoming_particles_[1].type())
+          .aqm_factor;
 
   /* Determine if the initial state is a baryon-antibaryon pair,
    * which can annihilate. */
@@ -2593,65 +2734,55 @@ CollisionBranchList CrossSections::string_excitation(
 
 double CrossSections::high_energy(
     const StringTransitionParameters& transition_high_energy) const {
-  const PdgCode& pdg_a = incoming_particles_[0].type().pdgcode();
-  const PdgCode& pdg_b = incoming_particles_[1].type().pdgcode();
-
+  const Dispatch& routines =
+      dispatch(incoming_particles_[0].type(), incoming_particles_[1].type());
   const double s = sqrt_s_ * sqrt_s_;
   double xs = 0.;
 
   // Currently all BB collisions use the nucleon-nucleon parametrizations.
-  if (pdg_a.is_baryon() && pdg_b.is_baryon()) {
-    if (pdg_a == pdg_b) {
+  switch (routines.high_energy) {
+    case HighEnergyRoutine::PP:
       xs = pp_high_energy(s);  // pp, nn
-    } else if (pdg_a.antiparticle_sign() * pdg_b.antiparticle_sign() == 1) {
+      break;
+    case HighEnergyRoutine::NP:
       xs = np_high_energy(s);  // np, nbarpbar
-    } else if (pdg_a.antiparticle_sign() * pdg_b.antiparticle_sign() == -1) {
+      break;
+    case HighEnergyRoutine::PPbar:
+    case HighEnergyRoutine::NPbar: {
       /* In the case of baryon-antibaryon interactions,
        * the low-energy cross section must be involved
        * due to annihilation processes (via strings). */
-      double xs_l = ppbar_total(s);
-      double xs_h = 0.;
-      if (pdg_a.is_antiparticle_of(pdg_b)) {
-        xs_h = ppbar_high_energy(s);  // ppbar, nnbar
-      } else {
-        xs_h = npbar_high_energy(s);  // npbar, nbarp
-      }
+      const double xs_l = ppbar_total(s);
+      const double xs_h = routines.high_energy == HighEnergyRoutine::PPbar
+                              ? ppbar_high_energy(s)   // ppbar, nnbar
+                              : npbar_high_energy(s);  // npbar, nbarp
       /* Transition between low and high energy is set to be consistent with
        * that defined in string_probability(). */
       auto [region_lower, region_upper] = transition_high_energy.sqrts_range_NN;
       double prob_high = probability_transit_high(region_lower, region_upper);
       xs = xs_l * (1. - prob_high) + xs_h * prob_high;
+      break;
     }
-  }
-
-  // Pion nucleon interaction / baryon-meson
-  if ((pdg_a == pdg::pi_p && pdg_b == pdg::p) ||
-      (pdg_b == pdg::pi_p && pdg_a == pdg::p) ||
-      (pdg_a == pdg::pi_m && pdg_b == pdg::n) ||
-      (pdg_b == pdg::pi_m && pdg_a == pdg::n)) {
-    xs = piplusp_high_energy(s);  // pi+ p, pi- n
-  } else if ((pdg_a == pdg::pi_m && pdg_b == pdg::p) ||
-             (pdg_b == pdg::pi_m && pdg_a == pdg::p) ||
-             (pdg_a == pdg::pi_p && pdg_b == pdg::n) ||
-             (pdg_b == pdg::pi_p && pdg_a == pdg::n)) {
-    xs = piminusp_high_energy(s);  // pi- p, pi+ n
-  } else if ((pdg_a.is_meson() && pdg_b.is_baryon()) ||
-             (pdg_b.is_meson() && pdg_a.is_baryon())) {
-    xs = piminusp_high_energy(s);  // default for baryon-meson
-  }
-
-  /* Meson-meson interaction goes through AQM from pi+p,
-   * see user guide "Use_AQM"*/
-  if (pdg_a.is_meson() && pdg_b.is_meson()) {
-    /* 2/3 factor since difference of 1 meson between meson-meson
-     * and baryon-meson */
-    xs = 2. / 3. * piplusp_high_energy(s);
+    // Pion nucleon interaction / baryon-meson
+    case HighEnergyRoutine::PiPlusP:
+      xs = piplusp_high_energy(s);  // pi+ p, pi- n
+      break;
+    case HighEnergyRoutine::PiMinusP:
+      xs = piminusp_high_energy(s);  // pi- p, pi+ n, default for baryon-meson
+      break;
+    case HighEnergyRoutine::MesonMeson:
+      /* Meson-meson interaction goes through AQM from pi+p,
+       * see user guide "Use_AQM".
+       * 2/3 factor since difference of 1 meson between meson-meson
+       * and baryon-meson */
+      xs = 2. / 3. * piplusp_high_energy(s);
+      break;
+    case HighEnergyRoutine::None:
+      break;
   }
 
   // AQM scaling for cross-sections
-  xs *= (1. - 0.4 * pdg_a.frac_strange()) * (1. - 0.4 * pdg_b.frac_strange());
-
-  return xs;
+  return xs * routines.aqm_factor;
 }
 
 double CrossSections::string_hard_cross_section() const {
@@ -2976,29 +3107,19 @@ double CrossSections::string_probability(
     return 0.;
   }
 
-  const ParticleType& t1 = incoming_particles_[0].type();
-  const ParticleType& t2 = incoming_particles_[1].type();
+  const Dispatch& routines =
+      dispatch(incoming_particles_[0].type(), incoming_particles_[1].type());
   const bool treat_BBbar_with_strings =
       (finder_parameters.nnbar_treatment == NNbarTreatment::Strings);
-  const bool is_NN_scattering =
-      t1.is_nucleon() && t2.is_nucleon() &&
-      t1.antiparticle_sign() == t2.antiparticle_sign();
+  const bool is_NN_scattering = routines.nucleon_pair;
   const bool is_BBbar_scattering =
       (treat_BBbar_with_strings && is_BBbar_pair_ &&
        finder_parameters.use_AQM) ||
-      (t1.is_nucleon() && t2.is_nucleon() &&
-       t1.antiparticle_sign() != t2.antiparticle_sign());
-  const bool is_Npi_scattering = (t1.pdgcode().is_pion() && t2.is_nucleon()) ||
-                                 (t1.is_nucleon() && t2.pdgcode().is_pion());
+      routines.nucleon_antinucleon_pair;
+  const bool is_Npi_scattering = routines.nucleon_pion_pair;
   /* True for baryon-baryon, anti-baryon-anti-baryon, baryon-meson,
    * anti-baryon-meson and meson-meson*/
-  const bool is_AQM_scattering =
-      finder_parameters.use_AQM &&
-      ((t1.is_baryon() && t2.is_baryon() &&
-        t1.antiparticle_sign() == t2.antiparticle_sign()) ||
-       ((t1.is_baryon() && t2.is_meson()) ||
-        (t2.is_baryon() && t1.is_meson())) ||
-       (t1.is_meson() && t2.is_meson()));
+  const bool is_AQM_scattering = finder_parameters.use_AQM && routines.aqm_pair;
   const double mass_sum =
       incoming_particles_[0].pole_mass() + incoming_particles_[1].pole_mass();
 
@@ -3011,23 +3132,16 @@ double CrossSections::string_probability(
     // BBbar only goes through strings, so there are no "window" considerations
     return 1.;
   } else {
-    /* true for K+ p and K0 p (+ antiparticles), which have special treatment
-     * to fit data */
-    const PdgCode pdg1 = t1.pdgcode(), pdg2 = t2.pdgcode();
-    const bool is_KplusP =
-        ((pdg1 == pdg::K_p || pdg1 == pdg::K_z) && (pdg2 == pdg::p)) ||
-        ((pdg2 == pdg::K_p || pdg2 == pdg::K_z) && (pdg1 == pdg::p)) ||
-        ((pdg1 == -pdg::K_p || pdg1 == -pdg::K_z) && (pdg2 == -pdg::p)) ||
-        ((pdg2 == -pdg::K_p || pdg2 == -pdg::K_z) && (pdg1 == -pdg::p));
     // where to start the AQM strings above mass sum
     double aqm_offset =
         finder_parameters.transition_high_energy.sqrts_add_lower;
-    if (is_KplusP) {
-      /* for this specific case we have data. This corresponds to the point
-       * where the AQM parametrization is smaller than the current 2to2
-       * parametrization, which starts growing and diverges from exp. data */
+    if (routines.string_offset == StringOffset::KN) {
+      /* for K+ p and K0 p (+ antiparticles) we have data. This corresponds to
+       * the point where the AQM parametrization is smaller than the current
+       * 2to2 parametrization, which starts growing and diverges from exp.
+       * data */
       aqm_offset = finder_parameters.transition_high_energy.KN_offset;
-    } else if (pdg1.is_pion() && pdg2.is_pion()) {
+    } else if (routines.string_offset == StringOffset::PiPi) {
       aqm_offset = finder_parameters.transition_high_energy.pipi_offset;
     }
     /* if we do not use the probability transition algorithm, this is always a
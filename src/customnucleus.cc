@@ -9,20 +9,20 @@
 #include <cmath>
 #include <fstream>
 #include <map>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "smash/constants.h"
 #include "smash/particletype.h"
 #include "smash/pdgcode.h"
+#include "smash/random.h"
 
 namespace smash {
 static constexpr int LCollider = LogArea::Collider::id;
 
-std::unique_ptr<std::ifstream> CustomNucleus::filestream_shared_ = nullptr;
-
-CustomNucleus::CustomNucleus(Configuration& config, int testparticles,
-                             bool same_file) {
+CustomNucleus::CustomNucleus(Configuration& config, int testparticles) {
   // Read in file directory from config
   const std::string particle_list_file_directory =
       config.take({"Custom", "File_Directory"});
@@ -39,9 +39,8 @@ CustomNucleus::CustomNucleus(Configuration& config, int testparticles,
   /*
    * Counts number of nucleons in one nucleus as it is specialized
    * by the user in the config file.
-   * It is needed to read in the proper number of nucleons for one
-   * nucleus and to restart at the listreading for the following
-   * nucleus as one does not want to read configurations twice.
+   * It is needed to split the external list into the configurations of
+   * one nucleus each.
    */
   std::map<PdgCode, int> particle_list = config.take({"Particles"});
   for (const auto& particle : particle_list) {
@@ -56,43 +55,46 @@ CustomNucleus::CustomNucleus(Configuration& config, int testparticles,
     }
     number_of_nucleons_ = number_of_protons_ + number_of_neutrons_;
   }
-  /*
-   * "if" statement makes sure the streams to the file are initialized
-   * properly.
-   */
+
   const std::string path =
       file_path(particle_list_file_directory, particle_list_file_name);
-  if (same_file && !filestream_shared_) {
-    filestream_shared_ = std::make_unique<std::ifstream>(path);
-    used_filestream_ = &filestream_shared_;
-  } else if (!same_file) {
-    filestream_ = std::make_unique<std::ifstream>(path);
-    used_filestream_ = &filestream_;
-  } else {
-    used_filestream_ = &filestream_shared_;
+  configurations_ = read_configurations(path);
+  const std::size_t A = number_of_nucleons_;
+  if (A == 0 || configurations_->empty() || configurations_->size() % A != 0) {
+    throw std::runtime_error(
+        "The number of nucleons in " + path +
+        " is not a positive multiple of the number of nucleons specified in "
+        "the config.\nCheck the config and your input file.");
+  }
+  number_of_configurations_ = configurations_->size() / A;
+  for (std::size_t i = 0; i < number_of_configurations_; i++) {
+    int proton_counter = 0;
+    for (std::size_t j = 0; j < A; j++) {
+      proton_counter += (*configurations_)[i * A + j].isospin;
+    }
+    if (proton_counter != number_of_protons_) {
+      throw std::runtime_error(
+          "Number of protons and/or neutrons in configuration " +
+          std::to_string(i + 1) + " of the nuclei input file " + path +
+          " does not correspond to the number specified in the config.\nCheck "
+          "the config and your input file.");
+    }
   }
 
-  custom_nucleus_ = readfile(**used_filestream_);
-  fill_from_list(custom_nucleus_);
+  fill_from_list(0);
   // Inherited from nucleus class (see nucleus.h)
   set_parameters_automatic();
 }
 
-void CustomNucleus::fill_from_list(const std::vector<Nucleoncustom>& vec) {
+void CustomNucleus::fill_from_list(std::size_t configuration) {
   particles_.clear();
+  configuration_ = configuration;
   index_ = 0;
+  const Nucleoncustom* nucleon =
+      &configurations_->at(configuration * number_of_nucleons_);
   // checking if particle is proton or neutron
-  for (const auto& it : vec) {
-    PdgCode pdgcode;
-    if (it.isospin == 1) {
-      pdgcode = pdg::p;
-    } else if (it.isospin == 0) {
-      pdgcode = pdg::n;
-    } else {
-      throw std::runtime_error(
-          "Your particles charges are not 1 = proton or 0 = neutron.\n"
-          "Check whether your list is correct or there is an error.");
-    }
+  for (int i = 0; i < number_of_nucleons_; i++, nucleon++) {
+    const PdgCode pdgcode = nucleon->isospin ? pdg::p : pdg::n;
     // setting parameters for the particles in the particlelist in smash
     const ParticleType& current_type = ParticleType::find(pdgcode);
     double current_mass = current_type.mass();
@@ -102,18 +104,9 @@ void CustomNucleus::fill_from_list(const std::vector<Nucleoncustom>& vec) {
 }
 
 ThreeVector CustomNucleus::distribute_nucleon() {
-  /*
-   * As only arrange_nucleons is called at the beginning of every
-   * event it is important to have readfile and fill from list
-   * called again when a new event starts. The constructor is only
-   * called twice to initialize the first target and projectile.
-   * Therefore this if statement is implemented.
-   */
-  if (index_ >= custom_nucleus_.size()) {
-    custom_nucleus_ = readfile(**used_filestream_);
-    fill_from_list(custom_nucleus_);
-  }
-  const auto& pos = custom_nucleus_.at(index_);
+  assert(index_ < static_cast<std::size_t>(number_of_nucleons_));
+  const auto& pos =
+      (*configurations_)[configuration_ * number_of_nucleons_ + index_];
   index_++;
   ThreeVector nucleon_position(pos.x, pos.y, pos.z);
   // rotate nucleon about euler angle
@@ -128,12 +121,26 @@ void CustomNucleus::arrange_nucleons() {
    * event.
    */
   Nucleus::random_euler_angles();
+  configuration_ =
+      random::uniform_int<std::size_t>(0, number_of_configurations_ - 1);
+  index_ = 0;
+  /* The protons and neutrons only need to be recreated if they are ordered
+   * differently in the drawn configuration, which keeps their labels. */
+  const Nucleoncustom* nucleon =
+      &(*configurations_)[configuration_ * number_of_nucleons_];
+  for (auto i = begin(); i != end(); i++, nucleon++) {
+    if ((i->pdgcode() == pdg::p) != nucleon->isospin) {
+      const BelongsTo label = particles_.front().belongs_to();
+      fill_from_list(configuration_);
+      set_label(label);
+      break;
+    }
+  }
 
   for (auto i = begin(); i != end(); i++) {
     // Initialize momentum
     i->set_4momentum(i->pole_mass(), 0.0, 0.0, 0.0);
-    /* Sampling the Woods-Saxon, get the radial
-     * position and solid angle for the nucleon. */
+    // Get the position of the nucleon from the configuration.
     ThreeVector pos = distribute_nucleon();
     // Set the position of the nucleon.
     i->set_4position(FourVector(0.0, pos));
@@ -159,46 +166,47 @@ std::string CustomNucleus::file_path(const std::string& file_directory,
   }
 }
 
-std::vector<Nucleoncustom> CustomNucleus::readfile(
-    std::ifstream& infile) const {
-  int proton_counter = 0;
-  int neutron_counter = 0;
+std::shared_ptr<const std::vector<Nucleoncustom>>
+CustomNucleus::read_configurations(const std::string& path) {
+  // Lists stay in memory as long as a nucleus uses them.
+  static std::mutex cache_mutex;
+  static std::map<std::string, std::weak_ptr<const std::vector<Nucleoncustom>>>
+      cache;
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (auto configurations = cache[path].lock()) {
+    return configurations;
+  }
+
+  std::ifstream infile(path);
+  if (!infile) {
+    throw std::runtime_error(
+        "SMASH could not open the initial nuclei input file " + path + ".");
+  }
+  auto configurations = std::make_shared<std::vector<Nucleoncustom>>();
   std::string line;
-  std::vector<Nucleoncustom> custom_nucleus;
-  // read in only A particles for one nucleus
-  for (int i = 0; i < number_of_nucleons_; ++i) {
-    std::getline(infile, line);
-    // make sure the stream goes back to the beginning when it hits end of file
-    if (infile.eof()) {
-      infile.clear();
-      infile.seekg(0, infile.beg);
-      std::getline(infile, line);
+  std::size_t linenumber = 0;
+  while (std::getline(infile, line)) {
+    linenumber++;
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
     }
     Nucleoncustom nucleon;
     std::istringstream iss(line);
     if (!(iss >> nucleon.x >> nucleon.y >> nucleon.z >>
           nucleon.spinprojection >> nucleon.isospin)) {
       throw std::runtime_error(
-          "SMASH could not read in a line from your initial nuclei input file."
-          "\nCheck if your file has the following format: x y z "
+          "SMASH could not read in line " + std::to_string(linenumber) +
+          " of your initial nuclei input file " + path +
+          ".\nCheck if your file has the following format: x y z "
           "spinprojection isospin");
     }
-    if (nucleon.isospin == 1) {
-      proton_counter++;
-    } else if (nucleon.isospin == 0) {
-      neutron_counter++;
-    }
-    custom_nucleus.push_back(nucleon);
-  }
-  if (proton_counter != number_of_protons_ ||
-      neutron_counter != number_of_neutrons_) {
-    throw std::runtime_error(
-        "Number of protons and/or neutrons in the nuclei input file does not "
-        "correspond to the number specified in the config.\nCheck the config "
-        "and your input file.");
-  } else {
-    return custom_nucleus;
+    configurations->push_back(nucleon);
   }
+  configurations->shrink_to_fit();
+  logg[LCollider].info("Read ", configurations->size(), " nucleons from ",
+                       path, ".");
+  cache[path] = configurations;
+  return configurations;
 }
 
 }  // namespace smash
@@ -63,13 +63,15 @@ void DecayAction::generate_final_state() {
           std::to_string(incoming_particles_[0].effective_mass()) + ")");
   }
 
+  // Boost to the computational frame
+  const LorentzBoost to_computational_frame(
+      -total_momentum_of_outgoing_particles().velocity());
   // Set formation time.
   for (auto &p : outgoing_particles_) {
     logg[LDecayModes].debug("particle momenta in lrf ", p);
     // assuming decaying particles are always fully formed
     p.set_formation_time(time_of_execution_);
-    // Boost to the computational frame
-    p.boost_momentum(-total_momentum_of_outgoing_particles().velocity());
+    p.boost_momentum(to_computational_frame);
     logg[LDecayModes].debug("particle momenta in comp ", p);
   }
 }
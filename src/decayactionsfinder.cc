@@ -9,14 +9,50 @@
 
 #include "smash/decayactionsfinder.h"
 
+#include <limits>
+
 #include "smash/constants.h"
 #include "smash/decayaction.h"
 #include "smash/decaymodes.h"
 #include "smash/fourvector.h"
+#include "smash/particles.h"
+#include "smash/potential_globals.h"
 #include "smash/random.h"
 
 namespace smash {
 
+namespace {
+/* Without potentials affecting the decays, the widths only depend on the
+ * invariant mass, and the decay branches are only needed for the particles
+ * that actually decay. */
+bool widths_depend_only_on_mass() {
+  return pot_pointer == nullptr ||
+         (UB_lat_pointer == nullptr && UI3_lat_pointer == nullptr);
+}
+}  // unnamed namespace
+
+double DecayActionsFinder::sample_decay_time(const ParticleData &p,
+                                             double width) const {
+  constexpr double one_over_hbarc = 1. / hbarc;
+
+  /* The decay_time is sampled from an exponential distribution.
+   * Even though it may seem suspicious that it is sampled every
+   * timestep, it can be proven that this still overall obeys
+   * the exponential decay law.
+   */
+  double decay_time =
+      res_lifetime_factor_ * random::exponential<double>(
+                                 /* The clock goes slower in the rest
+                                  * frame of the resonance */
+                                 one_over_hbarc * p.inverse_gamma() * width);
+  /* If the particle is not yet formed, shift the decay time by the time it
+   * takes the particle to form */
+  if (p.xsec_scaling_factor() < 1.0) {
+    decay_time += p.formation_time() - p.position().x0();
+  }
+  return decay_time;
+}
+
 ActionList DecayActionsFinder::find_actions_in_cell(
     const ParticleList &search_list, double dt, const double,
     const std::vector<FourVector> &) const {
@@ -25,6 +61,8 @@ ActionList DecayActionsFinder::find_actions_in_cell(
    * less than 10 decays in most time steps */
   actions.reserve(10);
 
+  const bool mass_dependent_widths = widths_depend_only_on_mass();
+
   for (const auto &p : search_list) {
     if (p.type().is_stable()) {
       continue;  // particle doesn't decay
@@ -35,36 +73,42 @@ ActionList DecayActionsFinder::find_actions_in_cell(
       continue;
     }
 
-    DecayBranchList processes = p.type().get_partial_widths(
-        p.momentum(), p.position().threevec(), WhichDecaymodes::Hadronic);
-    // total decay width (mass-dependent)
-    const double width = total_weight<DecayBranch>(processes);
-
-    // check if there are any (hadronic) decays
-    if (!(width > 0.0)) {
-      continue;
-    }
+    DecayBranchList processes;
+    double decay_time;
+    if (p.has_scheduled_decay()) {
+      // the decay time was sampled once, see schedule_decays
+      decay_time = p.scheduled_decay_time() - p.position().x0();
+      if (!(decay_time < dt)) {
+        continue;
+      }
+    } else {
+      // total decay width (mass-dependent)
+      double width;
+      if (mass_dependent_widths) {
+        width = p.type().hadronic_width(p.momentum().abs());
+      } else {
+        processes = p.type().get_partial_widths(
+            p.momentum(), p.position().threevec(), WhichDecaymodes::Hadronic);
+        width = total_weight<DecayBranch>(processes);
+      }
 
-    constexpr double one_over_hbarc = 1. / hbarc;
-
-    /* The decay_time is sampled from an exponential distribution.
-     * Even though it may seem suspicious that it is sampled every
-     * timestep, it can be proven that this still overall obeys
-     * the exponential decay law.
-     */
-    double decay_time =
-        res_lifetime_factor_ * random::exponential<double>(
-                                   /* The clock goes slower in the rest
-                                    * frame of the resonance */
-                                   one_over_hbarc * p.inverse_gamma() * width);
-    /* If the particle is not yet formed, shift the decay time by the time it
-     * takes the particle to form */
-    if (p.xsec_scaling_factor() < 1.0) {
-      decay_time += p.formation_time() - p.position().x0();
+      // check if there are any (hadronic) decays
+      if (!(width > 0.0)) {
+        continue;
+      }
+      decay_time = sample_decay_time(p, width);
     }
     if (decay_time < dt) {
       /* => decay_time ∈ [0, dt[
        * => the particle decays in this timestep. */
+      if (processes.empty()) {
+        processes = p.type().get_partial_widths(
+            p.momentum(), p.position().threevec(), WhichDecaymodes::Hadronic);
+        if (processes.empty()) {
+          // only possible close to a threshold, due to the interpolation
+          continue;
+        }
+      }
       auto act = std::make_unique<DecayAction>(p, decay_time);
       act->add_decays(std::move(processes));
       actions.emplace_back(std::move(act));
@@ -73,8 +117,38 @@ ActionList DecayActionsFinder::find_actions_in_cell(
   return actions;
 }
 
-ActionList DecayActionsFinder::find_final_actions(const Particles &search_list,
-                                                  bool /*only_res*/) const {
+void DecayActionsFinder::schedule_decays(Particles &particles) const {
+  const bool mass_dependent_widths = widths_depend_only_on_mass();
+  for (ParticleData &p : particles) {
+    if (p.type().is_stable()) {
+      continue;
+    }
+    if (!decay_initial_particles_ &&
+        p.get_history().collisions_per_particle == 0) {
+      continue;
+    }
+    /* A decay time in the past belongs to a decay that did not happen, e.g.
+     * because it was Pauli-blocked, and is sampled anew. */
+    if (p.has_scheduled_decay() &&
+        !(p.scheduled_decay_time() < p.position().x0())) {
+      continue;
+    }
+    const double width =
+        mass_dependent_widths
+            ? p.type().hadronic_width(p.momentum().abs())
+            : total_weight<DecayBranch>(p.type().get_partial_widths(
+                  p.momentum(), p.position().threevec(),
+                  WhichDecaymodes::Hadronic));
+    if (width > 0.0) {
+      p.schedule_decay(p.position().x0() + sample_decay_time(p, width));
+    } else {
+      p.schedule_decay(std::numeric_limits<double>::infinity());
+    }
+  }
+}
+
+ActionList DecayActionsFinder::find_final_actions(
+    const ParticleList &search_list, bool /*only_res*/) const {
   ActionList actions;
 
   for (const auto &p : search_list) {
@@ -9,84 +9,119 @@
 
 #include "smash/decayactionsfinderdilepton.h"
 
+#include <algorithm>
+
 #include "smash/constants.h"
 #include "smash/decayactiondilepton.h"
 #include "smash/decaymodes.h"
 
 namespace smash {
 
-void DecayActionsFinderDilepton::shine(const Particles &search_list,
-                                       OutputInterface *output,
-                                       double dt) const {
-  if (!output->is_dilepton_output()) {
-    return;
+DecayActionsFinderDilepton::DecayActionsFinderDilepton() {
+  const auto &types = ParticleType::list_all();
+  has_dilepton_modes_.resize(types.size(), false);
+  has_other_modes_.resize(types.size(), false);
+  for (std::size_t i = 0; i < types.size(); i++) {
+    for (const auto &mode : types[i].decay_modes().decay_mode_list()) {
+      if (mode->type().is_dilepton_decay()) {
+        has_dilepton_modes_[i] = true;
+      } else {
+        has_other_modes_[i] = true;
+      }
+    }
   }
-  for (const auto &p : search_list) {
-    const auto n_all_modes =
-        p.type()
-            .get_partial_widths(p.momentum(), p.position().threevec(),
-                                WhichDecaymodes::All)
-            .size();
-    if (n_all_modes == 0) {
+}
+
+/**
+ * Select the dilepton outputs.
+ *
+ * \param[in] outputs All outputs.
+ * \return Pointers to the dilepton outputs.
+ */
+static std::vector<OutputInterface *> dilepton_outputs(
+    const OutputsList &outputs) {
+  std::vector<OutputInterface *> dilepton;
+  for (const auto &output : outputs) {
+    if (output->is_dilepton_output()) {
+      dilepton.push_back(output.get());
+    }
+  }
+  return dilepton;
+}
+
+void DecayActionsFinderDilepton::shine_decays(
+    const ParticleData &p, DecayBranchList &modes, double factor,
+    double divisor, const std::vector<OutputInterface *> &outputs) {
+  for (DecayBranchPtr &mode : modes) {
+    if (!mode->type().is_dilepton_decay()) {
       continue;
     }
+    const double shining_weight = factor * mode->weight() / divisor;
 
-    const double inv_gamma = p.inverse_gamma();
-    DecayBranchList dil_modes = p.type().get_partial_widths(
-        p.momentum(), p.position().threevec(), WhichDecaymodes::Dileptons);
+    if (shining_weight > 0.0) {  // decays that can happen
+      DecayActionDilepton act(p, 0., shining_weight);
+      act.add_decay(std::move(mode));
+      act.generate_final_state();
+      for (OutputInterface *output : outputs) {
+        output->at_interaction(act, 0.0);
+      }
+    }
+  }
+}
 
+void DecayActionsFinderDilepton::shine(const Particles &search_list,
+                                       const OutputsList &outputs,
+                                       double dt) const {
+  const std::vector<OutputInterface *> dilepton = dilepton_outputs(outputs);
+  if (dilepton.empty()) {
+    return;
+  }
+  for (const auto &p : search_list) {
     /* If particle can only decay into dileptons or is stable, use shining only
      * in find_final_actions and ignore them here, also unformed
      * resonances cannot decay */
-    if (dil_modes.size() == n_all_modes || p.type().is_stable() ||
-        (p.formation_time() > p.position().x0())) {
+    const std::size_t index = (&p.type()).index();
+    if (!has_dilepton_modes_[index] || !has_other_modes_[index] ||
+        p.type().is_stable() || (p.formation_time() > p.position().x0())) {
       continue;
     }
 
-    for (DecayBranchPtr &mode : dil_modes) {
-      // SHINING as described in \iref{Schmidt:2008hm}, chapter 2D
-      const double shining_weight = dt * inv_gamma * mode->weight() / hbarc;
-
-      if (shining_weight > 0.0) {  // decays that can happen
-        DecayActionDilepton act(p, 0., shining_weight);
-        act.add_decay(std::move(mode));
-        act.generate_final_state();
-        output->at_interaction(act, 0.0);
-      }
+    DecayBranchList modes = p.type().get_partial_widths(
+        p.momentum(), p.position().threevec(), WhichDecaymodes::All);
+    // The same holds if only dilepton decays are open at this mass.
+    const bool other_open =
+        std::any_of(modes.begin(), modes.end(), [](const DecayBranchPtr &m) {
+          return !m->type().is_dilepton_decay();
+        });
+    if (!other_open) {
+      continue;
     }
+
+    // SHINING as described in \iref{Schmidt:2008hm}, chapter 2D
+    shine_decays(p, modes, dt * p.inverse_gamma(), hbarc, dilepton);
   }
 }
 
-void DecayActionsFinderDilepton::shine_final(const Particles &search_list,
-                                             OutputInterface *output,
+void DecayActionsFinderDilepton::shine_final(const ParticleList &search_list,
+                                             const OutputsList &outputs,
                                              bool only_res) const {
-  if (!output->is_dilepton_output()) {
+  const std::vector<OutputInterface *> dilepton = dilepton_outputs(outputs);
+  if (dilepton.empty()) {
     return;
   }
   for (const auto &p : search_list) {
     const ParticleType &t = p.type();
-    if (t.decay_modes().decay_mode_list().empty() ||
-        (only_res && t.is_stable())) {
+    if (!has_dilepton_modes_[(&t).index()] || (only_res && t.is_stable())) {
       continue;
     }
 
-    DecayBranchList dil_modes = t.get_partial_widths(
-        p.momentum(), p.position().threevec(), WhichDecaymodes::Dileptons);
+    DecayBranchList modes = t.get_partial_widths(
+        p.momentum(), p.position().threevec(), WhichDecaymodes::All);
 
     // total decay width, also hadronic decays
-    const double width_tot = total_weight<DecayBranch>(t.get_partial_widths(
-        p.momentum(), p.position().threevec(), WhichDecaymodes::All));
+    const double width_tot = total_weight<DecayBranch>(modes);
 
-    for (DecayBranchPtr &mode : dil_modes) {
-      const double shining_weight = mode->weight() / width_tot;
-
-      if (shining_weight > 0.0) {  // decays that can happen
-        DecayActionDilepton act(p, 0., shining_weight);
-        act.add_decay(std::move(mode));
-        act.generate_final_state();
-        output->at_interaction(act, 0.0);
-      }
-    }
+    shine_decays(p, modes, 1., width_tot, dilepton);
   }
 }
 
@@ -9,6 +9,11 @@
 
 #include "smash/decaymodes.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 #include "smash/clebschgordan.h"
@@ -16,6 +21,8 @@
 #include "smash/inputfunctions.h"
 #include "smash/isoparticletype.h"
 #include "smash/logging.h"
+#include "smash/parallel.h"
+#include "smash/potentials.h"
 #include "smash/stringfunctions.h"
 
 namespace smash {
@@ -25,6 +32,76 @@ static constexpr int LDecayModes = LogArea::DecayModes::id;
 std::vector<DecayModes> *DecayModes::all_decay_modes = nullptr;
 /// Global pointer to the decay types list
 std::vector<DecayTypePtr> *all_decay_types = nullptr;
+/// All decay types, defined before the decay modes referencing them so that
+/// they outlive them.
+static std::vector<DecayTypePtr> decay_types_storage;
+/// All decay modes, with the indexing of all_particle_types
+static std::vector<DecayModes> decay_modes_storage;
+
+namespace {
+/**
+ * Compute the difference of the potential scales between the mother and the
+ * products of a decay, see DecayModes::potential_scales.
+ *
+ * \param[in] mother the particle which decays
+ * \param[in] products the products of the decay
+ * \return the differences of the Skyrme or VDF and of the symmetry scales
+ */
+std::pair<double, double> potential_scale_difference(
+    const ParticleType &mother, const ParticleTypePtrList &products) {
+  const auto mother_scale = Potentials::force_scale(mother);
+  double scale_B = mother_scale.first;
+  double scale_I3 = mother_scale.second * mother.isospin3_rel();
+  for (const auto &product : products) {
+    const auto product_scale = Potentials::force_scale(*product);
+    scale_B -= product_scale.first;
+    scale_I3 -= product_scale.second * product->isospin3_rel();
+  }
+  return {scale_B, scale_I3};
+}
+
+/**
+ * Key of an unordered pair of particle types in formation_candidates_table.
+ *
+ * \param[in] type_a first particle
+ * \param[in] type_b second particle
+ * \return the smaller index of the types in the upper and the larger one in
+ *         the lower 16 bits
+ */
+std::uint32_t pair_key(ParticleTypePtr type_a, ParticleTypePtr type_b) {
+  const std::uint32_t i = type_a.index(), j = type_b.index();
+  return i < j ? (i << 16) | j : (j << 16) | i;
+}
+
+/// Resonances that can be formed from each pair of particles, see pair_key
+std::unordered_map<std::uint32_t, std::vector<FormationCandidate>>
+    formation_candidates_table;
+
+/**
+ * Key of the decay types into the given products with the given angular
+ * momentum, which is independent of the order of the products.
+ *
+ * \param[in] products the two or three products of the decay
+ * \param[in] L the angular momentum of the decay
+ * \return L in the upper 16 bits, followed by the sorted indices of the
+ *         products, padded with 0xffff for two products
+ */
+std::uint64_t decay_type_key(ParticleTypePtrList products, int L) {
+  assert(products.size() <= 3);
+  std::sort(products.begin(), products.end());
+  std::uint64_t key = static_cast<std::uint16_t>(L);
+  for (std::size_t i = 0; i < 3; i++) {
+    key = (key << 16) | (i < products.size() ? products[i].index() : 0xffff);
+  }
+  return key;
+}
+
+/**
+ * Decay types of all_decay_types by decay_type_key. Types with the same key
+ * only differ in the mother, if they depend on it.
+ */
+std::unordered_map<std::uint64_t, std::vector<DecayType *>> decay_types_index;
+}  // unnamed namespace
 
 void DecayModes::add_mode(ParticleTypePtr mother, double ratio, int L,
                           ParticleTypePtrList particle_types) {
@@ -37,53 +114,65 @@ void DecayModes::add_mode(ParticleTypePtr mother, double ratio, int L,
     }
   }
   // Add new mode.
-  decay_modes_.push_back(std::make_unique<DecayBranch>(*type, ratio));
+  add_mode(mother, std::make_unique<DecayBranch>(*type, ratio));
+}
+
+void DecayModes::add_mode(ParticleTypePtr mother, DecayBranchPtr branch) {
+  potential_scales_.push_back(
+      potential_scale_difference(*mother, branch->particle_types()));
+  decay_modes_.push_back(std::move(branch));
 }
 
 DecayType *DecayModes::get_decay_type(ParticleTypePtr mother,
                                       ParticleTypePtrList particle_types,
                                       int L) {
   assert(all_decay_types != nullptr);
+  if (particle_types.size() > 3) {
+    // This is not a valid decay, which is reported by create_decay_type.
+    create_decay_type(mother, particle_types, L);
+  }
 
   // check if the decay type already exisits
-  for (const auto &type : *all_decay_types) {
-    if (type->has_mother(mother) && type->has_particles(particle_types) &&
-        type->angular_momentum() == L) {
-      return type.get();
+  std::vector<DecayType *> &candidates =
+      decay_types_index[decay_type_key(particle_types, L)];
+  for (DecayType *type : candidates) {
+    if (type->has_mother(mother)) {
+      return type;
     }
   }
 
   // if the type does not exist yet, create a new one
+  all_decay_types->emplace_back(create_decay_type(mother, particle_types, L));
+  candidates.push_back(all_decay_types->back().get());
+  return candidates.back();
+}
+
+DecayTypePtr DecayModes::create_decay_type(ParticleTypePtr mother,
+                                           ParticleTypePtrList particle_types,
+                                           int L) {
   switch (particle_types.size()) {
     case 2:
       if (is_dilepton(particle_types[0]->pdgcode(),
                       particle_types[1]->pdgcode())) {
-        all_decay_types->emplace_back(
-            std::make_unique<TwoBodyDecayDilepton>(particle_types, L));
+        return std::make_unique<TwoBodyDecayDilepton>(particle_types, L);
       } else if (particle_types[0]->is_stable() &&
                  particle_types[1]->is_stable()) {
-        all_decay_types->emplace_back(
-            std::make_unique<TwoBodyDecayStable>(particle_types, L));
+        return std::make_unique<TwoBodyDecayStable>(particle_types, L);
       } else if (particle_types[0]->is_stable() ||
                  particle_types[1]->is_stable()) {
-        all_decay_types->emplace_back(
-            std::make_unique<TwoBodyDecaySemistable>(particle_types, L));
+        return std::make_unique<TwoBodyDecaySemistable>(particle_types, L);
       } else {
-        all_decay_types->emplace_back(
-            std::make_unique<TwoBodyDecayUnstable>(particle_types, L));
+        return std::make_unique<TwoBodyDecayUnstable>(particle_types, L);
       }
-      break;
     case 3:
       if (has_lepton_pair(particle_types[0]->pdgcode(),
                           particle_types[1]->pdgcode(),
                           particle_types[2]->pdgcode())) {
-        all_decay_types->emplace_back(std::make_unique<ThreeBodyDecayDilepton>(
-            mother, particle_types, L));
+        return std::make_unique<ThreeBodyDecayDilepton>(mother, particle_types,
+                                                        L);
       } else {
-        all_decay_types->emplace_back(
-            std::make_unique<ThreeBodyDecay>(particle_types, L));
+        return std::make_unique<ThreeBodyDecay>(particle_types, L);
       }
-      break;
     default:
       throw InvalidDecay(
           "DecayModes::get_decay_type was instructed to add a decay mode "
@@ -91,8 +180,174 @@ DecayType *DecayModes::get_decay_type(ParticleTypePtr mother,
           std::to_string(particle_types.size()) +
           " particles. This is an invalid input.");
   }
+}
 
-  return all_decay_types->back().get();
+void DecayModes::set_decaymodes(std::vector<DecayTypePtr> decay_types,
+                                std::vector<DecayModes> decay_modes) {
+  assert(decay_modes.size() == ParticleType::list_all().size());
+  decay_modes_storage = std::move(decay_modes);
+  decay_types_storage = std::move(decay_types);
+  all_decay_modes = &decay_modes_storage;
+  all_decay_types = &decay_types_storage;
+  decay_types_index.clear();
+  for (const DecayTypePtr &type : decay_types_storage) {
+    decay_types_index[decay_type_key(type->particle_types(),
+                                     type->angular_momentum())]
+        .push_back(type.get());
+  }
+  build_formation_candidates();
+}
+
+void DecayModes::build_formation_candidates() {
+  formation_candidates_table.clear();
+  for (const ParticleType &resonance : ParticleType::list_all()) {
+    if (resonance.is_stable()) {
+      continue;
+    }
+    const auto &modes = resonance.decay_modes().decay_mode_list();
+    for (std::size_t i = 0; i < modes.size(); i++) {
+      const ParticleTypePtrList &products = modes[i]->type().particle_types();
+      if (products.size() != 2 ||
+          resonance.pdgcode() == products[0]->pdgcode() ||
+          resonance.pdgcode() == products[1]->pdgcode()) {
+        continue;
+      }
+      auto &candidates =
+          formation_candidates_table[pair_key(products[0], products[1])];
+      // Several modes of a resonance into the same pair differ in L.
+      if (candidates.empty() || candidates.back().resonance != &resonance) {
+        candidates.push_back({&resonance, {}});
+      }
+      candidates.back().in_modes.push_back(i);
+    }
+  }
+}
+
+const std::vector<FormationCandidate> &DecayModes::formation_candidates(
+    ParticleTypePtr type_a, ParticleTypePtr type_b) {
+  static const std::vector<FormationCandidate> none;
+  const auto found = formation_candidates_table.find(pair_key(type_a, type_b));
+  return found == formation_candidates_table.end() ? none : found->second;
+}
+
+std::size_t DecayModes::tabulate_decay_types(TabulationBundle &bundle) {
+  assert(all_decay_types != nullptr);
+  // The kinematic minimum masses are initialized lazily, so do it first.
+  for (const ParticleType &type : ParticleType::list_all()) {
+    type.min_mass_kinematic();
+  }
+
+  /* The step of a decay type is 0 without unstable products and otherwise one
+   * more than the highest step of the decay types of its products. */
+  std::map<const DecayType *, int> steps;
+  std::function<int(const DecayType &)> step_of = [&](const DecayType &type) {
+    const auto found = steps.find(&type);
+    if (found != steps.end()) {
+      if (found->second < 0) {
+        throw std::runtime_error("The decay modes contain a cycle.");
+      }
+      return found->second;
+    }
+    steps[&type] = -1;
+    int step = 0;
+    for (const ParticleTypePtr product : type.particle_types()) {
+      if (product->is_stable()) {
+        continue;
+      }
+      for (const auto &mode : product->decay_modes().decay_mode_list()) {
+        step = std::max(step, step_of(mode->type()) + 1);
+      }
+    }
+    steps[&type] = step;
+    return step;
+  };
+  std::vector<std::vector<DecayType *>> types_per_step;
+  for (const DecayTypePtr &type : *all_decay_types) {
+    const std::size_t step = step_of(*type);
+    if (types_per_step.size() <= step) {
+      types_per_step.resize(step + 1);
+    }
+    types_per_step[step].push_back(type.get());
+  }
+
+  std::size_t n_added = 0;
+  for (const std::vector<DecayType *> &types : types_per_step) {
+    /* The spectral functions of the products initialize their normalization
+     * on first use, which needs the tabulations of the previous steps and
+     * must not happen concurrently. */
+    for (const DecayType *type : types) {
+      for (const ParticleTypePtr product : type->particle_types()) {
+        if (!product->is_stable()) {
+          product->spectral_function(product->mass());
+        }
+      }
+    }
+
+    std::vector<DecayType *> missing;
+    std::vector<Tabulation> tabulations;
+    for (DecayType *type : types) {
+      const std::string name = type->tabulation_name();
+      if (name.empty()) {
+        continue;
+      }
+      if (const Tabulation *cached = bundle.find(name)) {
+        type->set_tabulation(*cached);
+      } else {
+        missing.push_back(type);
+      }
+    }
+    tabulations.resize(missing.size());
+
+    parallel_for(default_thread_count(), missing.size(), 1,
+                 [&](std::size_t i) {
+                   tabulations[i] = missing[i]->calculate_tabulation();
+                 });
+
+    for (std::size_t i = 0; i < missing.size(); i++) {
+      bundle.insert(missing[i]->tabulation_name(), tabulations[i]);
+      missing[i]->set_tabulation(std::move(tabulations[i]));
+    }
+    n_added += missing.size();
+  }
+  return n_added;
+}
+
+/// Number of intervals of the tabulations of the widths.
+constexpr size_t num_width_tab_intervals = 1000;
+
+std::size_t DecayModes::tabulate_widths(TabulationBundle &bundle) {
+  assert(all_decay_modes != nullptr);
+  const auto &types = ParticleType::list_all();
+  std::size_t n_added = 0;
+  for (std::size_t i = 0; i < types.size(); i++) {
+    const ParticleType &type = types[i];
+    DecayModes &modes = (*all_decay_modes)[i];
+    // Without the tabulations, the widths are evaluated exactly.
+    modes.total_width_tabulation_ = Tabulation();
+    modes.hadronic_width_tabulation_ = Tabulation();
+    if (type.is_stable()) {
+      continue;
+    }
+    const double m_min = type.min_mass_kinematic();
+    const double range = std::max(2., 10. * type.width_at_pole());
+    const auto tabulate = [&](const std::string &name,
+                              double (ParticleType::*width)(double) const) {
+      if (const Tabulation *cached = bundle.find(name)) {
+        return *cached;
+      }
+      Tabulation tabulation(m_min, range, num_width_tab_intervals,
+                            [&](double m) { return (type.*width)(m); });
+      bundle.insert(name, tabulation);
+      n_added++;
+      return tabulation;
+    };
+    const std::string pdg = type.pdgcode().string();
+    modes.total_width_tabulation_ =
+        tabulate("width_total_" + pdg, &ParticleType::total_width);
+    modes.hadronic_width_tabulation_ =
+        tabulate("width_hadronic_" + pdg, &ParticleType::hadronic_width);
+  }
+  return n_added;
 }
 
 bool DecayModes::renormalize(const std::string &name) {
@@ -161,15 +416,15 @@ static int min_angular_momentum(int s0, int s1, int s2, int s3) {
 }
 
 void DecayModes::load_decaymodes(const std::string &input) {
-  // create the DecayType vector first, then it outlives the DecayModes vector,
-  // which references the DecayType objects.
-  static std::vector<DecayTypePtr> decaytypes;
+  std::vector<DecayTypePtr> &decaytypes = decay_types_storage;
   decaytypes.clear();  // in case an exception was thrown and should try again
   // ten decay types per decay mode should be a good guess.
   decaytypes.reserve(10 * ParticleType::list_all().size());
   all_decay_types = &decaytypes;
+  decay_types_index.clear();
+  decay_types_index.reserve(decaytypes.capacity());
 
-  static std::vector<DecayModes> decaymodes;
+  std::vector<DecayModes> &decaymodes = decay_modes_storage;
   decaymodes.clear();  // in case an exception was thrown and should try again
   decaymodes.resize(ParticleType::list_all().size());
   all_decay_modes = &decaymodes;
@@ -484,6 +739,7 @@ void DecayModes::load_decaymodes(const std::string &input) {
         "Branching ratios of ", total_large_renormalized,
         " hadrons were renormalized by more than 1% to have sum 1.");
   }
+  build_formation_candidates();
 }
 
 }  // namespace smash
@@ -140,24 +140,34 @@ double TwoBodyDecaySemistable::get_Lambda() {
 
 /// Number of tabulation points.
 constexpr size_t num_tab_pts = 200;
-static /*thread_local (see #3075)*/ Integrator integrate;
+static thread_local Integrator integrate;
+
+std::string TwoBodyDecaySemistable::tabulation_name() const {
+  return "rho_semistable_" + particle_types_[0]->pdgcode().string() + "_" +
+         particle_types_[1]->pdgcode().string() + "_L" + std::to_string(L_);
+}
+
+Tabulation TwoBodyDecaySemistable::calculate_tabulation() const {
+  const ParticleTypePtr res = particle_types_[1];
+  const double tabulation_interval = std::max(2., 10. * res->width_at_pole());
+  const double m_stable = particle_types_[0]->mass();
+  const double mres_min = res->min_mass_kinematic();
+
+  return Tabulation(threshold(), tabulation_interval, num_tab_pts,
+                    [&](double sqrts) {
+                      const double mres_max = sqrts - m_stable;
+                      return integrate(mres_min, mres_max, [&](double m) {
+                        return integrand_rho_Manley_1res(sqrts, m, m_stable,
+                                                         res, L_);
+                      });
+                    });
+}
 
 double TwoBodyDecaySemistable::rho(double mass) const {
   if (tabulation_ == nullptr) {
-    /* TODO(weil): Move this lazy init to a global initialization function,
-     * in order to avoid race conditions in multi-threading. */
-    const ParticleTypePtr res = particle_types_[1];
-    const double tabulation_interval = std::max(2., 10. * res->width_at_pole());
-    const double m_stable = particle_types_[0]->mass();
-    const double mres_min = res->min_mass_kinematic();
-
-    tabulation_ = std::make_unique<Tabulation>(
-        threshold(), tabulation_interval, num_tab_pts, [&](double sqrts) {
-          const double mres_max = sqrts - m_stable;
-          return integrate(mres_min, mres_max, [&](double m) {
-            return integrand_rho_Manley_1res(sqrts, m, m_stable, res, L_);
-          });
-        });
+    /* Without DecayModes::tabulate_decay_types at startup, the tabulation is
+     * built on first use, which is not safe in multi-threading. */
+    tabulation_ = std::make_unique<Tabulation>(calculate_tabulation());
   }
   return tabulation_->get_value_linear(mass);
 }
@@ -194,32 +204,41 @@ double TwoBodyDecayUnstable::get_Lambda() {
   return 0.6;
 }
 
-static /*thread_local*/ Integrator2d integrate2d(1E7);
+static thread_local Integrator2d integrate2d(1E7);
+
+std::string TwoBodyDecayUnstable::tabulation_name() const {
+  return "rho_unstable_" + particle_types_[0]->pdgcode().string() + "_" +
+         particle_types_[1]->pdgcode().string() + "_L" + std::to_string(L_);
+}
+
+Tabulation TwoBodyDecayUnstable::calculate_tabulation() const {
+  const ParticleTypePtr r1 = particle_types_[0];
+  const ParticleTypePtr r2 = particle_types_[1];
+  const double m1_min = r1->min_mass_kinematic();
+  const double m2_min = r2->min_mass_kinematic();
+  const double sum_gamma = r1->width_at_pole() + r2->width_at_pole();
+  const double tab_interval = std::max(2., 10. * sum_gamma);
+
+  return Tabulation(
+      m1_min + m2_min, tab_interval, num_tab_pts, [&](double sqrts) {
+        const double m1_max = sqrts - m2_min;
+        const double m2_max = sqrts - m1_min;
+
+        const double result = integrate2d(m1_min, m1_max, m2_min, m2_max,
+                                          [&](double m1, double m2) {
+                                            return integrand_rho_Manley_2res(
+                                                sqrts, m1, m2, r1, r2, L_);
+                                          })
+                                  .value();
+        return result;
+      });
+}
 
 double TwoBodyDecayUnstable::rho(double mass) const {
   if (tabulation_ == nullptr) {
-    /* TODO(weil): Move this lazy init to a global initialization function,
-     * in order to avoid race conditions in multi-threading. */
-    const ParticleTypePtr r1 = particle_types_[0];
-    const ParticleTypePtr r2 = particle_types_[1];
-    const double m1_min = r1->min_mass_kinematic();
-    const double m2_min = r2->min_mass_kinematic();
-    const double sum_gamma = r1->width_at_pole() + r2->width_at_pole();
-    const double tab_interval = std::max(2., 10. * sum_gamma);
-
-    tabulation_ = std::make_unique<Tabulation>(
-        m1_min + m2_min, tab_interval, num_tab_pts, [&](double sqrts) {
-          const double m1_max = sqrts - m2_min;
-          const double m2_max = sqrts - m1_min;
-
-          const double result = integrate2d(m1_min, m1_max, m2_min, m2_max,
-                                            [&](double m1, double m2) {
-                                              return integrand_rho_Manley_2res(
-                                                  sqrts, m1, m2, r1, r2, L_);
-                                            })
-                                    .value();
-          return result;
-        });
+    /* Without DecayModes::tabulate_decay_types at startup, the tabulation is
+     * built on first use, which is not safe in multi-threading. */
+    tabulation_ = std::make_unique<Tabulation>(calculate_tabulation());
   }
   return tabulation_->get_value_linear(mass);
 }
@@ -445,42 +464,57 @@ double ThreeBodyDecayDilepton::diff_width(double m_par, double m_l,
   }
 }
 
+std::string ThreeBodyDecayDilepton::tabulation_name() const {
+  if (mother_->is_stable()) {
+    // The width is not tabulated, see width().
+    return {};
+  }
+  return "width_dalitz_" + mother_->pdgcode().string() + "_" +
+         particle_types_[0]->pdgcode().string() + "_" +
+         particle_types_[1]->pdgcode().string() + "_" +
+         particle_types_[2]->pdgcode().string() + "_L" + std::to_string(L_);
+}
+
+Tabulation ThreeBodyDecayDilepton::calculate_tabulation() const {
+  int non_lepton_position = -1;
+  for (int i = 0; i < 3; ++i) {
+    if (!particle_types_[i]->is_lepton()) {
+      non_lepton_position = i;
+      break;
+    }
+  }
+  // lepton mass
+  const double m_l = particle_types_[(non_lepton_position + 1) % 3]->mass();
+  // mass of non-leptonic particle in final state
+  const double m_other = particle_types_[non_lepton_position]->mass();
+
+  // integrate differential width to obtain partial width
+  double M0 = mother_->mass();
+  double G0tot = mother_->width_at_pole();
+  return Tabulation(
+      m_other + 2 * m_l, M0 + 10 * G0tot, num_tab_pts, [&](double m_parent) {
+        const double bottom = 2 * m_l;
+        const double top = m_parent - m_other;
+        if (top < bottom) {  // numerical problems at lower bound
+          return 0.;
+        }
+        return integrate(bottom, top,
+                         [&](double m_dil) {
+                           return diff_width(
+                               m_parent, m_l, m_dil, m_other,
+                               particle_types_[non_lepton_position], mother_);
+                         })
+            .value();
+      });
+}
+
 double ThreeBodyDecayDilepton::width(double, double G0, double m) const {
   if (mother_->is_stable()) {
     return G0;
   }
 
   if (!tabulation_) {
-    int non_lepton_position = -1;
-    for (int i = 0; i < 3; ++i) {
-      if (!particle_types_[i]->is_lepton()) {
-        non_lepton_position = i;
-        break;
-      }
-    }
-    // lepton mass
-    const double m_l = particle_types_[(non_lepton_position + 1) % 3]->mass();
-    // mass of non-leptonic particle in final state
-    const double m_other = particle_types_[non_lepton_position]->mass();
-
-    // integrate differential width to obtain partial width
-    double M0 = mother_->mass();
-    double G0tot = mother_->width_at_pole();
-    tabulation_ = std::make_unique<Tabulation>(
-        m_other + 2 * m_l, M0 + 10 * G0tot, num_tab_pts, [&](double m_parent) {
-          const double bottom = 2 * m_l;
-          const double top = m_parent - m_other;
-          if (top < bottom) {  // numerical problems at lower bound
-            return 0.;
-          }
-          return integrate(bottom, top,
-                           [&](double m_dil) {
-                             return diff_width(
-                                 m_parent, m_l, m_dil, m_other,
-                                 particle_types_[non_lepton_position], mother_);
-                           })
-              .value();
-        });
+    tabulation_ = std::make_unique<Tabulation>(calculate_tabulation());
   }
 
   return tabulation_->get_value_linear(m, Extrapolation::Const);
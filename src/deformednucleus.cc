@@ -6,17 +6,28 @@
  */
 #include "smash/deformednucleus.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <map>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
 
 #include "smash/configuration.h"
 #include "smash/constants.h"
 #include "smash/fourvector.h"
+#include "smash/logging.h"
 #include "smash/random.h"
+#include "smash/tabulationbundle.h"
 #include "smash/threevector.h"
 
 namespace smash {
+static constexpr int LNucleus = LogArea::Nucleus::id;
+
+/// Number of intervals of the cosine of the polar angle in the tables
+static constexpr size_t n_costheta_rows = 100;
 
 DeformedNucleus::DeformedNucleus(const std::map<PdgCode, int> &particle_list,
                                  int nTest)
@@ -39,6 +50,59 @@ DeformedNucleus::DeformedNucleus(Configuration &config, int nTest,
 }
 
 ThreeVector DeformedNucleus::distribute_nucleon() {
+  if (tabulated_sampling_) {
+    const std::array<double, 6> parameters = {
+        Nucleus::get_nuclear_radius(), Nucleus::get_diffusiveness(), beta2_,
+        gamma_, beta3_, beta4_};
+    if (costheta_inverse_cdf_.is_empty() ||
+        parameters != inverse_cdf_parameters_) {
+      tabulate_inverse_cdfs();
+      inverse_cdf_parameters_ = parameters;
+    }
+    const double costheta =
+        std::clamp(costheta_inverse_cdf_.get_value_linear(random::canonical()),
+                   -1., 1.);
+    // Interpolate the quantiles between the neighbouring polar angles.
+    const double row = 0.5 * (costheta + 1.) * n_costheta_rows;
+    const size_t i = std::min(static_cast<size_t>(row), n_costheta_rows - 1);
+    const double weight = row - i;
+    double phi = 0.;
+    if (phi_inverse_cdfs_.empty()) {
+      phi = random::uniform(0., twopi);
+    } else {
+      const double u = random::canonical();
+      phi = (1. - weight) * phi_inverse_cdfs_[i].get_value_linear(u) +
+            weight * phi_inverse_cdfs_[i + 1].get_value_linear(u);
+      phi = std::clamp(phi, 0., twopi);
+    }
+    // Bilinear interpolation of the deformed radius
+    const double column = phi / twopi * n_phi_intervals_;
+    const size_t j =
+        std::min(static_cast<size_t>(column), n_phi_intervals_ - 1);
+    const double phi_weight = column - j;
+    const size_t n_columns = n_phi_intervals_ + 1;
+    auto at_row = [&](size_t k) {
+      return (1. - phi_weight) * radius_table_[k * n_columns + j] +
+             phi_weight * radius_table_[k * n_columns + j + 1];
+    };
+    const double radius = (1. - weight) * at_row(i) + weight * at_row(i + 1);
+    // Interpolate the quantiles of r^3 between the neighbouring radii.
+    const size_t n_radii = radial_inverse_cdfs_.size() - 1;
+    const double radius_row =
+        radius_step_ > 0. ? (radius - radius_min_) / radius_step_ : 0.;
+    const size_t k = std::min(
+        static_cast<size_t>(std::max(radius_row, 0.)), n_radii - 1);
+    const double radius_weight = std::clamp(radius_row - k, 0., 1.);
+    const double u = random::canonical();
+    const double s =
+        (1. - radius_weight) * radial_inverse_cdfs_[k].get_value_linear(u) +
+        radius_weight * radial_inverse_cdfs_[k + 1].get_value_linear(u);
+    Angles direction;
+    direction.set_phi(phi);
+    direction.set_costheta(costheta);
+    return direction.threevec() * std::cbrt(s);
+  }
+
   double a_radius;
   Angles a_direction;
   // Set a sensible maximum bound for radial sampling.
@@ -60,6 +124,85 @@ ThreeVector DeformedNucleus::distribute_nucleon() {
   return a_direction.threevec() * a_radius;
 }
 
+void DeformedNucleus::tabulate_inverse_cdfs() {
+  constexpr size_t n_rows = n_costheta_rows;
+  // Only the triaxial deformation depends on the azimuthal angle.
+  const bool triaxial = std::abs(std::sin(gamma_)) >= really_small;
+  n_phi_intervals_ = triaxial ? 64 : 1;
+  const size_t n_columns = n_phi_intervals_ + 1;
+  radius_table_.resize((n_rows + 1) * n_columns);
+  for (size_t i = 0; i <= n_rows; i++) {
+    for (size_t j = 0; j < n_columns; j++) {
+      radius_table_[i * n_columns + j] = deformed_radius(
+          -1. + 2. * i / n_rows, twopi * j / n_phi_intervals_);
+    }
+  }
+  const auto [min, max] =
+      std::minmax_element(radius_table_.begin(), radius_table_.end());
+  const double diffusiveness = Nucleus::get_diffusiveness();
+  // The radial distribution only depends on the direction via the radius.
+  const size_t n_radii = *max > *min ? 100 : 1;
+  radius_min_ = *min;
+  radius_step_ = (*max - *min) / n_radii;
+  // The density is negligible 20 diffusivenesses beyond the deformed radius.
+  const double r_max = *max + 20. * diffusiveness;
+  radial_inverse_cdfs_.clear();
+  radial_inverse_cdfs_.reserve(n_radii + 1);
+  // Integral of the density over r^3 for every radius
+  std::vector<double> radial_integrals(n_radii + 1);
+  for (size_t k = 0; k <= n_radii; k++) {
+    const double radius = radius_min_ + k * radius_step_;
+    radial_inverse_cdfs_.push_back(Tabulation::inverse_cdf(
+        0., r_max * r_max * r_max,
+        [&](double s) {
+          return 1. / (1. + std::exp((std::cbrt(s) - radius) / diffusiveness));
+        },
+        &radial_integrals[k]));
+  }
+  // Weight of the directions of the table
+  std::vector<double> weights(radius_table_.size());
+  for (size_t i = 0; i < weights.size(); i++) {
+    const double row =
+        radius_step_ > 0. ? (radius_table_[i] - radius_min_) / radius_step_
+                          : 0.;
+    const size_t k = std::min(static_cast<size_t>(row), n_radii - 1);
+    const double weight = std::clamp(row - k, 0., 1.);
+    weights[i] = (1. - weight) * radial_integrals[k] +
+                 weight * radial_integrals[k + 1];
+  }
+  // Interpolate the weights of a row of the table in the azimuthal angle.
+  auto phi_weight = [&](size_t i, double phi) {
+    const double column = phi / twopi * n_phi_intervals_;
+    const size_t j =
+        std::min(static_cast<size_t>(column), n_phi_intervals_ - 1);
+    const double weight = std::clamp(column - j, 0., 1.);
+    return (1. - weight) * weights[i * n_columns + j] +
+           weight * weights[i * n_columns + j + 1];
+  };
+  // Integral of the weights over the azimuthal angle for every row
+  std::vector<double> integrals(n_rows + 1, 0.);
+  phi_inverse_cdfs_.clear();
+  for (size_t i = 0; i <= n_rows; i++) {
+    for (size_t j = 0; j < n_phi_intervals_; j++) {
+      integrals[i] += 0.5 *
+                      (weights[i * n_columns + j] +
+                       weights[i * n_columns + j + 1]) *
+                      twopi / n_phi_intervals_;
+    }
+    if (triaxial) {
+      phi_inverse_cdfs_.push_back(Tabulation::inverse_cdf(
+          0., twopi, [&](double phi) { return phi_weight(i, phi); }));
+    }
+  }
+  costheta_inverse_cdf_ =
+      Tabulation::inverse_cdf(-1., 1., [&](double costheta) {
+        const double row = 0.5 * (costheta + 1.) * n_rows;
+        const size_t i = std::min(static_cast<size_t>(row), n_rows - 1);
+        const double weight = row - i;
+        return (1. - weight) * integrals[i] + weight * integrals[i + 1];
+      });
+}
+
 void DeformedNucleus::set_deformation_parameters_automatic() {
   // Set the deformation parameters
   // reference for U, Pb, Au, Cu: \iref{Moller:1993ed}
@@ -257,32 +400,25 @@ double y_l_m(int l, int m, double cosx, double phi) {
   }
 }
 
+double DeformedNucleus::deformed_radius(double cosx, double phi) const {
+  return Nucleus::get_nuclear_radius() *
+         (1 +
+          beta2_ * (std::cos(gamma_) * y_l_m(2, 0, cosx, phi) +
+                    std::sqrt(2) * std::sin(gamma_) * y_l_m(2, 2, cosx, phi)) +
+          beta3_ * y_l_m(3, 0, cosx, phi) + beta4_ * y_l_m(4, 0, cosx, phi));
+}
+
 double DeformedNucleus::nucleon_density(double r, double cosx,
                                         double phi) const {
   return Nucleus::get_saturation_density() /
-         (1 + std::exp((r - Nucleus::get_nuclear_radius() *
-                                (1 +
-                                 beta2_ * (std::cos(gamma_) *
-                                               y_l_m(2, 0, cosx, phi) +
-                                           std::sqrt(2) * std::sin(gamma_) *
-                                               y_l_m(2, 2, cosx, phi)) +
-                                 beta3_ * y_l_m(3, 0, cosx, phi) +
-                                 beta4_ * y_l_m(4, 0, cosx, phi))) /
+         (1 + std::exp((r - deformed_radius(cosx, phi)) /
                        Nucleus::get_diffusiveness()));
 }
 
 double DeformedNucleus::nucleon_density_unnormalized(double r, double cosx,
                                                      double phi) const {
-  return 1.0 /
-         (1 + std::exp((r - Nucleus::get_nuclear_radius() *
-                                (1 +
-                                 beta2_ * (std::cos(gamma_) *
-                                               y_l_m(2, 0, cosx, phi) +
-                                           std::sqrt(2) * std::sin(gamma_) *
-                                               y_l_m(2, 2, cosx, phi)) +
-                                 beta3_ * y_l_m(3, 0, cosx, phi) +
-                                 beta4_ * y_l_m(4, 0, cosx, phi))) /
-                       Nucleus::get_diffusiveness()));
+  return 1.0 / (1 + std::exp((r - deformed_radius(cosx, phi)) /
+                             Nucleus::get_diffusiveness()));
 }
 
 double DeformedNucleus::integrant_nucleon_density_phi(double r,
@@ -299,7 +435,42 @@ double DeformedNucleus::integrant_nucleon_density_phi(double r,
   return result.value();
 }
 
+void DeformedNucleus::set_tabulation_cache(
+    sha256::Hash hash, const std::filesystem::path &tabulations_path) {
+  tabulation_cache_hash_ = hash;
+  tabulation_cache_path_ = tabulations_path;
+}
+
 double DeformedNucleus::calculate_saturation_density() const {
+  // The name holds the exact parameters the density is integrated for.
+  std::ostringstream name;
+  name << std::hexfloat << "deformed_nucleus_saturation_density "
+       << number_of_particles() << ' ' << Nucleus::get_nuclear_radius() << ' '
+       << Nucleus::get_diffusiveness() << ' ' << beta2_ << ' ' << gamma_ << ' '
+       << beta3_ << ' ' << beta4_;
+  std::optional<TabulationBundle> bundle;
+  if (!tabulation_cache_path_.empty()) {
+    bundle = TabulationBundle::read(tabulation_cache_path_,
+                                    tabulation_cache_hash_);
+    if (const Tabulation *cached = bundle->find(name.str())) {
+      return cached->get_value_step(0.);
+    }
+  }
+  const double rho0 = integrate_saturation_density();
+  if (bundle) {
+    bundle->insert(name.str(),
+                   Tabulation(0., 1., 2, [rho0](double) { return rho0; }));
+    try {
+      bundle->publish(tabulation_cache_path_);
+    } catch (std::runtime_error &error) {
+      logg[LNucleus].warn(error.what(),
+                          " The saturation density is not cached.");
+    }
+  }
+  return rho0;
+}
+
+double DeformedNucleus::integrate_saturation_density() const {
   Integrator2d integrate;
   // Transform integral from (0, oo) to (0, 1) via r = (1 - t) / t.
   // To prevent overflow, the integration is only performed to t = 0.01 which
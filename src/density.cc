@@ -9,6 +9,10 @@
 
 #include "smash/density.h"
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
 #include "smash/constants.h"
 #include "smash/logging.h"
 
@@ -61,6 +65,52 @@ std::pair<double, ThreeVector> unnormalized_smearing_factor(
   return std::make_pair(sf, sf_grad);
 }
 
+GaussianSmearingKernel::GaussianSmearingKernel(
+    const FourVector &p, double m_inv, const DensityParameters &dens_par,
+    double cell_size_x)
+    : u3_(p.threevec() * m_inv),
+      u0_(p.x0() * m_inv),
+      h_(cell_size_x),
+      two_sig_sqr_inv_(dens_par.two_sig_sqr_inv()),
+      r_cut_sqr_(dens_par.r_cut_sqr()),
+      step_growth_(std::exp(-2.0 * h_ * h_ * (1.0 + u3_.x1() * u3_.x1()) *
+                            two_sig_sqr_inv_)) {}
+
+std::pair<double, ThreeVector> GaussianSmearingKernel::operator()(
+    const ThreeVector &r, int ix, int iy, int iz, bool compute_gradient) {
+  const double r_sqr = r.sqr();
+  const double u_r_scalar = r * u3_;
+  const double r_rest_sqr = r_sqr + u_r_scalar * u_r_scalar;
+  // same cutoffs as in unnormalized_smearing_factor
+  if (r_sqr > r_cut_sqr_ || r_rest_sqr > r_cut_sqr_) {
+    previous_inside_ = false;
+    return std::make_pair(0.0, ThreeVector(0.0, 0.0, 0.0));
+  }
+  const bool continues_row = previous_inside_ && ix == previous_[0] + 1 &&
+                             iy == previous_[1] && iz == previous_[2];
+  if (continues_row) {
+    exp_ *= step_;
+    step_ *= step_growth_;
+  } else {
+    /* Going to the next node in x direction changes r by -h e_x and
+     * r_rest_sqr by h (h (1 + u_x^2) - 2 (r_x + u_r u_x)). */
+    exp_ = std::exp(-r_rest_sqr * two_sig_sqr_inv_);
+    const double r_rest_sqr_change =
+        h_ * (h_ * (1.0 + u3_.x1() * u3_.x1()) -
+              2.0 * (r.x1() + u_r_scalar * u3_.x1()));
+    step_ = std::exp(-r_rest_sqr_change * two_sig_sqr_inv_);
+  }
+  previous_inside_ = true;
+  previous_ = {ix, iy, iz};
+
+  const double sf = exp_ * u0_;
+  const ThreeVector sf_grad =
+      compute_gradient
+          ? sf * (r + u3_ * u_r_scalar) * two_sig_sqr_inv_ * 2.0
+          : ThreeVector(0.0, 0.0, 0.0);
+  return std::make_pair(sf, sf_grad);
+}
+
 /// \copydoc smash::current_eckart
 template <typename /*ParticlesContainer*/ T>
 std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
@@ -183,14 +233,118 @@ current_eckart(const ThreeVector &r, const Particles &plist,
                              smearing);
 }
 
+ParticleCells::ParticleCells(ParticleList plist, double r_cut)
+    : particles_(std::move(plist)), cell_length_(r_cut) {
+  if (!(cell_length_ > 0.)) {
+    throw std::invalid_argument(
+        "The cells of particles need a positive cutoff radius.");
+  }
+  for (std::size_t i = 0; i < particles_.size(); i++) {
+    cells_[cell_of(particles_[i].position().threevec())].push_back(i);
+  }
+}
+
+std::array<int, 3> ParticleCells::cell_of(const ThreeVector &r) const {
+  return {static_cast<int>(std::floor(r.x1() / cell_length_)),
+          static_cast<int>(std::floor(r.x2() / cell_length_)),
+          static_cast<int>(std::floor(r.x3() / cell_length_))};
+}
+
+std::vector<std::size_t> ParticleCells::indices_within_reach(
+    const ThreeVector &r) const {
+  const std::array<int, 3> center = cell_of(r);
+  std::vector<std::size_t> indices;
+  for (int dx = -1; dx <= 1; dx++) {
+    for (int dy = -1; dy <= 1; dy++) {
+      for (int dz = -1; dz <= 1; dz++) {
+        const auto cell =
+            cells_.find({center[0] + dx, center[1] + dy, center[2] + dz});
+        if (cell != cells_.end()) {
+          indices.insert(indices.end(), cell->second.begin(),
+                         cell->second.end());
+        }
+      }
+    }
+  }
+  /* Keeping the original order makes the sums over the particles identical
+   * to the ones over all particles, where the others contribute zero. */
+  std::sort(indices.begin(), indices.end());
+  return indices;
+}
+
+ParticleList ParticleCells::within_reach(const ThreeVector &r) const {
+  const std::vector<std::size_t> indices = indices_within_reach(r);
+  ParticleList result;
+  result.reserve(indices.size());
+  for (const std::size_t i : indices) {
+    result.push_back(particles_[i]);
+  }
+  return result;
+}
+
+std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
+           FourVector, FourVector>
+current_eckart(const ThreeVector &r, const ParticleCells &cells,
+               const DensityParameters &par, DensityType dens_type,
+               bool compute_gradient, bool smearing) {
+  if (!smearing) {
+    return current_eckart_impl(r, cells.particles(), par, dens_type,
+                               compute_gradient, smearing);
+  }
+  return current_eckart_impl(r, cells.within_reach(r), par, dens_type,
+                             compute_gradient, smearing);
+}
+
+/**
+ * Compute the derivatives of the rest frame density of a node from its
+ * current and the derivatives of the current.
+ *
+ * \param[in,out] node Node of a density lattice
+ */
+static void update_rest_frame_derivatives(DensityOnLattice &node) {
+  // the rest frame density
+  double rho = node.rho();
+  const int sgn = rho > 0 ? 1 : -1;
+  if (std::abs(rho) < very_small_double) {
+    rho = sgn * very_small_double;
+  }
+
+  // the computational frame j^mu
+  const FourVector jmu = node.jmu_net();
+  // computational frame array of derivatives of j^mu
+  const std::array<FourVector, 4> djmu_dxnu = node.djmu_dxnu();
+
+  const double drho_dt =
+      (1 / rho) *
+      (jmu.x0() * djmu_dxnu[0].x0() - jmu.x1() * djmu_dxnu[0].x1() -
+       jmu.x2() * djmu_dxnu[0].x2() - jmu.x3() * djmu_dxnu[0].x3());
+
+  const double drho_dx =
+      (1 / rho) *
+      (jmu.x0() * djmu_dxnu[1].x0() - jmu.x1() * djmu_dxnu[1].x1() -
+       jmu.x2() * djmu_dxnu[1].x2() - jmu.x3() * djmu_dxnu[1].x3());
+
+  const double drho_dy =
+      (1 / rho) *
+      (jmu.x0() * djmu_dxnu[2].x0() - jmu.x1() * djmu_dxnu[2].x1() -
+       jmu.x2() * djmu_dxnu[2].x2() - jmu.x3() * djmu_dxnu[2].x3());
+
+  const double drho_dz =
+      (1 / rho) *
+      (jmu.x0() * djmu_dxnu[3].x0() - jmu.x1() * djmu_dxnu[3].x1() -
+       jmu.x2() * djmu_dxnu[3].x2() - jmu.x3() * djmu_dxnu[3].x3());
+
+  const FourVector drho_dxnu = {drho_dt, drho_dx, drho_dy, drho_dz};
+
+  node.overwrite_drho_dxnu(drho_dxnu);
+}
+
 void update_lattice(
     RectangularLattice<DensityOnLattice> *lat,
-    RectangularLattice<FourVector> *old_jmu,
-    RectangularLattice<FourVector> *new_jmu,
-    RectangularLattice<std::array<FourVector, 4>> *four_grad_lattice,
-    const LatticeUpdate update, const DensityType dens_type,
-    const DensityParameters &par, const std::vector<Particles> &ensembles,
-    const double time_step, const bool compute_gradient) {
+    RectangularLattice<FourVector> *old_jmu, const LatticeUpdate update,
+    const DensityType dens_type, const DensityParameters &par,
+    const std::vector<Particles> &ensembles, const double time_step,
+    const bool compute_gradient) {
   // Do not proceed if lattice does not exists/update not required
   if (lat == nullptr || lat->when_update() != update) {
     return;
@@ -198,6 +352,10 @@ void update_lattice(
   const std::array<int, 3> lattice_n_cells = lat->n_cells();
   const int number_of_nodes =
       lattice_n_cells[0] * lattice_n_cells[1] * lattice_n_cells[2];
+  const bool finite_difference =
+      par.derivatives() == DerivativesMode::FiniteDifference;
+  const bool rest_frame_derivatives =
+      par.rho_derivatives() == RestFrameDensityDerivativesMode::On;
 
   /*
    * Take the provided DensityOnLattice lattice and use the information about
@@ -207,7 +365,7 @@ void update_lattice(
    */
   // copy values of jmu at t_0 onto old_jmu;
   // proceed only if finite difference gradients are calculated
-  if (par.derivatives() == DerivativesMode::FiniteDifference) {
+  if (finite_difference) {
     for (int i = 0; i < number_of_nodes; i++) {
       old_jmu->assign_value(i, ((*lat)[i]).jmu_net());
     }
@@ -215,67 +373,242 @@ void update_lattice(
 
   update_lattice(lat, update, dens_type, par, ensembles, compute_gradient);
 
-  // calculate the gradients for finite difference derivatives
-  if (par.derivatives() == DerivativesMode::FiniteDifference) {
-    // copy values of jmu FourVectors at t_0 + time_step onto new_jmu
-    for (int i = 0; i < number_of_nodes; i++) {
-      new_jmu->assign_value(i, ((*lat)[i]).jmu_net());
-    }
+  if (finite_difference) {
+    /* Compute time derivatives and gradients of all components of jmu and
+     * substitute them in the nodes. Overwriting the derivatives of a node does
+     * not change the currents that the neighboring nodes still need. The
+     * derivatives of the rest frame density follow in the same sweep. */
+    lat->compute_four_gradient(
+        *old_jmu, time_step,
+        [](const DensityOnLattice &node) { return node.jmu_net(); },
+        [&](int index, const std::array<FourVector, 4> &djmu_dxnu) {
+          DensityOnLattice &node = (*lat)[index];
+          node.overwrite_djmu_dxnu(djmu_dxnu[0], djmu_dxnu[1], djmu_dxnu[2],
+                                   djmu_dxnu[3]);
+          if (rest_frame_derivatives) {
+            update_rest_frame_derivatives(node);
+          }
+        });
+    // the derivatives are not only written to the occupied bricks
+    lat->mark_all_occupied();
+  } else if (rest_frame_derivatives) {
+    // nodes of empty bricks have no current and keep vanishing derivatives
+    lat->iterate_occupied(
+        [](DensityOnLattice &node) { update_rest_frame_derivatives(node); });
+  }
+}  // void update_lattice()
 
-    // compute time derivatives and gradients of all components of jmu
-    new_jmu->compute_four_gradient_lattice(*old_jmu, time_step,
-                                           *four_grad_lattice);
+template <typename Real>
+void gather_gaussian_currents(
+    RectangularLattice<BasicDensityOnLattice<Real>> *lat, DensityType dens_type,
+    const DensityParameters &par, const std::vector<Particles> &ensembles,
+    bool compute_gradient) {
+  const std::array<int, 3> n_cells = lat->n_cells();
+  const std::array<double, 3> cell_sizes = lat->cell_sizes();
+  const std::array<double, 3> origin = lat->origin();
+  const bool periodic = lat->periodic();
+  /* Range of the cells around a node that may hold particles within the
+   * cutoff radius, and number of cells particles are sorted into. Without
+   * periodicity, the cells extend by this range beyond the lattice. */
+  std::array<int, 3> range, n_bins;
+  for (int i = 0; i < 3; i++) {
+    range[i] = static_cast<int>(std::ceil(par.r_cut() / cell_sizes[i])) + 1;
+    n_bins[i] = periodic ? n_cells[i] : n_cells[i] + 2 * range[i];
+  }
 
-    // substitute new derivatives
-    int node_number = 0;
-    for (auto &node : *lat) {
-      auto tmp = (*four_grad_lattice)[node_number];
-      node.overwrite_djmu_dxnu(tmp[0], tmp[1], tmp[2], tmp[3]);
-      node_number++;
+  /* Pack the contributing particles in their original order, sorted into
+   * cells with a counting sort. With periodicity, the particles are moved
+   * into the lattice and the cells are wrapped. */
+  struct PackedParticle {
+    std::size_t bin;
+    std::array<double, 11> data;  // position, u^i, u^0, velocity, factor
+  };
+  std::vector<PackedParticle> packed;
+  for (const Particles &particles : ensembles) {
+    for (const ParticleData &part : particles) {
+      if (par.only_participants() &&
+          part.get_history().collisions_per_particle == 0) {
+        continue;
+      }
+      const double factor = density_factor(part.type(), dens_type);
+      if (std::abs(factor) < really_small) {
+        continue;
+      }
+      const FourVector p_mu = part.momentum();
+      const double m = p_mu.abs();
+      if (unlikely(m < really_small)) {
+        logg[LDensity].warn("Gaussian smearing is undefined for momentum ",
+                            p_mu);
+        continue;
+      }
+      ThreeVector pos = part.position().threevec();
+      std::size_t bin = 0;
+      bool reaches_lattice = true;
+      for (int i = 2; i >= 0; i--) {
+        const double cell = std::floor((pos[i] - origin[i]) / cell_sizes[i]);
+        int index;
+        if (periodic) {
+          const double wrapped =
+              cell - n_cells[i] * std::floor(cell / n_cells[i]);
+          pos[i] -= (cell - wrapped) * cell_sizes[i];
+          index = static_cast<int>(wrapped);
+        } else if (cell < -range[i] || cell >= n_cells[i] + range[i]) {
+          reaches_lattice = false;
+          break;
+        } else {
+          index = static_cast<int>(cell) + range[i];
+        }
+        bin = bin * n_bins[i] + index;
+      }
+      if (!reaches_lattice) {
+        continue;
+      }
+      const ThreeVector v = part.velocity();
+      packed.push_back({bin,
+                        {pos[0], pos[1], pos[2], p_mu.x1() / m,
+                         p_mu.x2() / m, p_mu.x3() / m, p_mu.x0() / m, v[0],
+                         v[1], v[2], factor}});
     }
-  }  // if (par.derivatives() == DerivativesMode::FiniteDifference)
-
-  // calculate gradients of rest frame density
-  if (par.rho_derivatives() == RestFrameDensityDerivativesMode::On) {
-    for (auto &node : *lat) {
-      // the rest frame density
-      double rho = node.rho();
-      const int sgn = rho > 0 ? 1 : -1;
-      if (std::abs(rho) < very_small_double) {
-        rho = sgn * very_small_double;
+  }
+  const std::size_t n_particles = packed.size();
+  const std::size_t n_all_bins =
+      static_cast<std::size_t>(n_bins[0]) * n_bins[1] * n_bins[2];
+  std::vector<std::size_t> bin_start(n_all_bins + 1, 0);
+  for (const PackedParticle &particle : packed) {
+    bin_start[particle.bin + 1]++;
+  }
+  for (std::size_t bin = 0; bin < n_all_bins; bin++) {
+    bin_start[bin + 1] += bin_start[bin];
+  }
+  constexpr int n_columns = 11;
+  std::vector<double> columns(n_columns * n_particles);
+  {
+    std::vector<std::size_t> fill(bin_start.begin(), bin_start.end() - 1);
+    for (const PackedParticle &particle : packed) {
+      const std::size_t k = fill[particle.bin]++;
+      for (int c = 0; c < n_columns; c++) {
+        columns[c * n_particles + k] = particle.data[c];
       }
+    }
+  }
 
-      // the computational frame j^mu
-      const FourVector jmu = node.jmu_net();
-      // computational frame array of derivatives of j^mu
-      const std::array<FourVector, 4> djmu_dxnu = node.djmu_dxnu();
-
-      const double drho_dt =
-          (1 / rho) *
-          (jmu.x0() * djmu_dxnu[0].x0() - jmu.x1() * djmu_dxnu[0].x1() -
-           jmu.x2() * djmu_dxnu[0].x2() - jmu.x3() * djmu_dxnu[0].x3());
-
-      const double drho_dx =
-          (1 / rho) *
-          (jmu.x0() * djmu_dxnu[1].x0() - jmu.x1() * djmu_dxnu[1].x1() -
-           jmu.x2() * djmu_dxnu[1].x2() - jmu.x3() * djmu_dxnu[1].x3());
-
-      const double drho_dy =
-          (1 / rho) *
-          (jmu.x0() * djmu_dxnu[2].x0() - jmu.x1() * djmu_dxnu[2].x1() -
-           jmu.x2() * djmu_dxnu[2].x2() - jmu.x3() * djmu_dxnu[2].x3());
+  // plain arrays, as they are mapped to the accelerator
+  const double *const x = columns.data();
+  const double *const y = x + n_particles;
+  const double *const z = y + n_particles;
+  const double *const ux = z + n_particles;
+  const double *const uy = ux + n_particles;
+  const double *const uz = uy + n_particles;
+  const double *const u0 = uz + n_particles;
+  const double *const vx = u0 + n_particles;
+  const double *const vy = vx + n_particles;
+  const double *const vz = vy + n_particles;
+  const double *const factor = vz + n_particles;
+  const std::size_t *const start = bin_start.data();
+  const std::size_t n_nodes = lat->size();
+  // j^mu of positive and negative charges and the derivatives of j^mu
+  constexpr int n_sums = 24;
+  std::vector<double> sums(n_sums * n_nodes);
+  double *const out = sums.data();
 
-      const double drho_dz =
-          (1 / rho) *
-          (jmu.x0() * djmu_dxnu[3].x0() - jmu.x1() * djmu_dxnu[3].x1() -
-           jmu.x2() * djmu_dxnu[3].x2() - jmu.x3() * djmu_dxnu[3].x3());
+  const int nx = n_cells[0], ny = n_cells[1], nz = n_cells[2];
+  const int rx = range[0], ry = range[1], rz = range[2];
+  const int bx = n_bins[0], by = n_bins[1];
+  const double hx = cell_sizes[0], hy = cell_sizes[1], hz = cell_sizes[2];
+  const double ox = origin[0], oy = origin[1], oz = origin[2];
+  const double r_cut_sqr = par.r_cut_sqr();
+  const double two_sig_sqr_inv = par.two_sig_sqr_inv();
+  const double norm = par.norm_factor_sf();
+  const bool derivatives =
+      compute_gradient &&
+      par.derivatives() == DerivativesMode::CovariantGaussian;
 
-      const FourVector drho_dxnu = {drho_dt, drho_dx, drho_dy, drho_dz};
+#ifdef SMASH_LATTICE_OFFLOAD
+  const std::size_t n_columns_total = columns.size();
+#pragma omp target teams distribute parallel for                          \
+    map(to : x[0 : n_columns_total], start[0 : n_all_bins + 1])           \
+    map(from : out[0 : n_sums * n_nodes])
+#endif
+  for (std::size_t node = 0; node < n_nodes; node++) {
+    const int ix = node % nx;
+    const int iy = (node / nx) % ny;
+    const int iz = node / (static_cast<std::size_t>(nx) * ny);
+    const double cx = ox + hx * (ix + 0.5);
+    const double cy = oy + hy * (iy + 0.5);
+    const double cz = oz + hz * (iz + 0.5);
+    double sum[n_sums] = {};
+    for (int jz = iz - rz; jz <= iz + rz; jz++) {
+      const int wz = periodic ? (jz % nz + nz) % nz : jz + rz;
+      const double sz = periodic ? (jz - (jz % nz + nz) % nz) * hz : 0.0;
+      for (int jy = iy - ry; jy <= iy + ry; jy++) {
+        const int wy = periodic ? (jy % ny + ny) % ny : jy + ry;
+        const double sy = periodic ? (jy - (jy % ny + ny) % ny) * hy : 0.0;
+        for (int jx = ix - rx; jx <= ix + rx; jx++) {
+          const int wx = periodic ? (jx % nx + nx) % nx : jx + rx;
+          const double sx = periodic ? (jx - (jx % nx + nx) % nx) * hx : 0.0;
+          const std::size_t bin =
+              (static_cast<std::size_t>(wz) * by + wy) * bx + wx;
+          for (std::size_t k = start[bin]; k < start[bin + 1]; k++) {
+            // vector from the node to the particle
+            const double r1 = x[k] + sx - cx;
+            const double r2 = y[k] + sy - cy;
+            const double r3 = z[k] + sz - cz;
+            const double r_sqr = r1 * r1 + r2 * r2 + r3 * r3;
+            const double u_r = r1 * ux[k] + r2 * uy[k] + r3 * uz[k];
+            const double r_rest_sqr = r_sqr + u_r * u_r;
+            // same cutoffs as in unnormalized_smearing_factor
+            if (r_sqr > r_cut_sqr || r_rest_sqr > r_cut_sqr) {
+              continue;
+            }
+            const double sf = std::exp(-r_rest_sqr * two_sig_sqr_inv) * u0[k];
+            const double u_mu[4] = {1.0, vx[k], vy[k], vz[k]};
+            const double weight = factor[k] * norm * sf;
+            const int offset = weight > 0.0 ? 0 : 4;
+            for (int mu = 0; mu < 4; mu++) {
+              sum[offset + mu] += u_mu[mu] * weight;
+            }
+            if (derivatives) {
+              const double grad_factor =
+                  factor[k] * norm * sf * 2.0 * two_sig_sqr_inv;
+              const double grad[3] = {grad_factor * (r1 + ux[k] * u_r),
+                                      grad_factor * (r2 + uy[k] * u_r),
+                                      grad_factor * (r3 + uz[k] * u_r)};
+              for (int i = 0; i < 3; i++) {
+                for (int mu = 0; mu < 4; mu++) {
+                  sum[8 + 4 * (i + 1) + mu] += u_mu[mu] * grad[i];
+                  sum[8 + mu] -= u_mu[mu] * grad[i] * u_mu[i + 1];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+    for (int c = 0; c < n_sums; c++) {
+      out[n_sums * node + c] = sum[c];
+    }
+  }
 
-      node.overwrite_drho_dxnu(drho_dxnu);
+  for (std::size_t node = 0; node < n_nodes; node++) {
+    const double *sum = &sums[n_sums * node];
+    if (std::all_of(sum, sum + 8, [](double s) { return s == 0.0; })) {
+      continue;
     }
-  }  // if (par.rho_derivatives() == RestFrameDensityDerivatives::On){
-}  // void update_lattice()
+    auto four_vector = [&](int c) {
+      return FourVector(sum[c], sum[c + 1], sum[c + 2], sum[c + 3]);
+    };
+    (*lat)[node].add_currents(
+        four_vector(0), four_vector(4),
+        {four_vector(8), four_vector(12), four_vector(16), four_vector(20)});
+  }
+}
+
+template void gather_gaussian_currents(
+    RectangularLattice<BasicDensityOnLattice<float>> *, DensityType,
+    const DensityParameters &, const std::vector<Particles> &, bool);
+template void gather_gaussian_currents(
+    RectangularLattice<BasicDensityOnLattice<double>> *, DensityType,
+    const DensityParameters &, const std::vector<Particles> &, bool);
 
 std::ostream &operator<<(std::ostream &os, DensityType dens_type) {
   switch (dens_type) {
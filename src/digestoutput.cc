@@ -0,0 +1,211 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/digestoutput.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "smash/action.h"
+#include "smash/config.h"
+#include "smash/logging.h"
+#include "smash/particles.h"
+
+namespace smash {
+namespace {
+/**
+ * Add the bytes of a value to a hash.
+ *
+ * \param[in] context Hash to add to.
+ * \param[in] value Value to add.
+ */
+template <typename T>
+void add(sha256::Context &context, const T &value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  context.update(reinterpret_cast<const uint8_t *>(&value), sizeof(T));
+}
+
+/**
+ * Add the id, PDG code, position and momentum of a particle to a hash.
+ *
+ * \param[in] context Hash to add to.
+ * \param[in] particle Particle to add.
+ */
+void add_particle(sha256::Context &context, const ParticleData &particle) {
+  add(context, particle.id());
+  add(context, particle.pdgcode().get_decimal());
+  for (std::size_t i = 0; i < 4; i++) {
+    add(context, particle.position()[i]);
+    add(context, particle.momentum()[i]);
+  }
+}
+}  // namespace
+
+DigestOutput::DigestOutput(const std::filesystem::path &path,
+                           const std::string &name,
+                           const OutputParameters &out_par)
+    : OutputInterface(name),
+      reference_(read_reference(out_par.digest_parameters.reference)),
+      compare_(!out_par.digest_parameters.reference.empty()),
+      file_{path / "digest.dat", "w"} {
+  std::FILE *out = file_.get();
+  std::fprintf(out, "# SMASH digest output\n# %s\n", SMASH_VERSION);
+  std::fprintf(out,
+               "# event n_particles n_interactions final_state_sha256 "
+               "history_sha256\n");
+}
+
+DigestOutput::~DigestOutput() {
+  if (!compare_) {
+    return;
+  }
+  if (first_divergence_) {
+    logg[LOutput].warn("Event ", *first_divergence_,
+                       " is the first one which differs from the reference "
+                       "run.");
+  } else {
+    logg[LOutput].info("All ", n_compared_,
+                       " compared events agree with the reference run.");
+  }
+}
+
+/*!\Userguide
+ * \page doxypage_output_digest
+ * The digest output condenses every event into one line, such that two runs
+ * can be checked for identical results without comparing their full outputs,
+ * e.g. a run with several threads against a serial reference run. It is
+ * requested with the `Digest` content and the `"ASCII"` format, see \ref
+ * input_output_digest_ for its options. As in the other outputs, each
+ * ensemble counts as an event.
+ *
+ * The file \c digest.dat starts with a header with the SMASH version. Then,
+ * every line gives
+ * \li the event number,
+ * \li the number of final particles and of interactions,
+ * \li the SHA256 hash of the ids, PDG codes, positions and momenta of the
+ * final particles, ordered by their id,
+ * \li the SHA256 hash of the interactions in the order in which they were
+ * performed, i.e. of their types, times and incoming and outgoing particles.
+ *
+ * The hashes change with any bit of the hashed values. Lines starting with
+ * \c # are comments. If a `Reference` digest is given, every event is
+ * compared with the same event of the reference run, and the first event
+ * with a different digest is reported at the end of the run.
+ */
+sha256::Hash DigestOutput::final_state_hash(const Particles &particles) {
+  std::vector<const ParticleData *> sorted;
+  sorted.reserve(particles.size());
+  for (const ParticleData &particle : particles) {
+    sorted.push_back(&particle);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const ParticleData *a, const ParticleData *b) {
+              return a->id() < b->id();
+            });
+  sha256::Context context;
+  for (const ParticleData *particle : sorted) {
+    add_particle(context, *particle);
+  }
+  return context.finalize();
+}
+
+void DigestOutput::at_eventstart(const std::vector<Particles> &ensembles,
+                                 int /*event_number*/) {
+  histories_.assign(ensembles.size(), sha256::Context());
+  n_interactions_.assign(ensembles.size(), 0);
+}
+
+void DigestOutput::at_ensemble_interaction(const Action &action,
+                                           const double /*density*/,
+                                           const int i_ensemble) {
+  sha256::Context &context = histories_.at(i_ensemble);
+  add(context, static_cast<int>(action.get_type()));
+  add(context, action.time_of_execution());
+  for (const ParticleData &particle : action.incoming_particles()) {
+    add_particle(context, particle);
+  }
+  // Separates the incoming from the outgoing particles.
+  add(context, -1);
+  for (const ParticleData &particle : action.outgoing_particles()) {
+    add_particle(context, particle);
+  }
+  n_interactions_[i_ensemble]++;
+}
+
+void DigestOutput::at_eventend(const Particles &particles,
+                               const int event_number, const EventInfo &info) {
+  const std::size_t i_ensemble = event_number % info.n_ensembles;
+  sha256::Context &history = histories_.at(i_ensemble);
+  const Digest digest{sha256::hash_to_string(final_state_hash(particles)),
+                      sha256::hash_to_string(history.finalize())};
+  std::fprintf(file_.get(), "%d %zu %" PRIu64 " %s %s\n", event_number,
+               particles.size(), n_interactions_[i_ensemble],
+               digest.final_state.c_str(), digest.history.c_str());
+  std::fflush(file_.get());
+  if (!compare_) {
+    return;
+  }
+  const auto reference = reference_.find(event_number);
+  if (reference == reference_.end()) {
+    logg[LOutput].warn("Event ", event_number,
+                       " is missing in the reference digest.");
+    return;
+  }
+  n_compared_++;
+  const bool same_final_state =
+      reference->second.final_state == digest.final_state;
+  const bool same_history = reference->second.history == digest.history;
+  if (!first_divergence_ && !(same_final_state && same_history)) {
+    first_divergence_ = event_number;
+    logg[LOutput].warn("Event ", event_number,
+                       " differs from the reference run in its ",
+                       same_final_state ? "interactions"
+                       : same_history   ? "final particles"
+                                        : "final particles and interactions",
+                       ".");
+  }
+}
+
+std::map<int, DigestOutput::Digest> DigestOutput::read_reference(
+    const std::string &path) {
+  std::map<int, Digest> reference;
+  if (path.empty()) {
+    return reference;
+  }
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("The reference digest " + path +
+                             " cannot be read.");
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    int event;
+    std::size_t n_particles;
+    std::uint64_t n_interactions;
+    Digest digest;
+    if (!(fields >> event >> n_particles >> n_interactions >>
+          digest.final_state >> digest.history)) {
+      throw std::runtime_error("Invalid line in the reference digest " +
+                               path + ": " + line);
+    }
+    reference[event] = std::move(digest);
+  }
+  return reference;
+}
+
+}  // namespace smash
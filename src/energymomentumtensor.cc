@@ -9,8 +9,12 @@
 
 #include "smash/energymomentumtensor.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <utility>
 
 #include "Eigen/Dense"
 
@@ -20,7 +24,154 @@
 namespace smash {
 static constexpr int LTmn = LogArea::Tmn::id;
 
+namespace {
+/// 4x4 matrix T_{\mu}^{\nu} in row-major order
+using Matrix4 = std::array<std::array<double, 4>, 4>;
+
+/**
+ * Minkowski product of two 4-vectors stored as plain arrays.
+ *
+ * \param[in] a First 4-vector
+ * \param[in] b Second 4-vector
+ * \return a^0 b^0 - a^i b^i
+ */
+double minkowski_product(const std::array<double, 4> &a,
+                         const std::array<double, 4> &b) {
+  return a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+}
+
+/**
+ * Solve the linear system M y = b by Gaussian elimination with partial
+ * pivoting.
+ *
+ * \param[in] M Matrix of the system, destroyed on return
+ * \param[inout] b Right-hand side on input, solution on output
+ * \return False if M is singular, in which case b is undefined.
+ */
+bool solve_linear_system(Matrix4 &M, std::array<double, 4> &b) {
+  for (int c = 0; c < 4; c++) {
+    int pivot = c;
+    for (int r = c + 1; r < 4; r++) {
+      if (std::abs(M[r][c]) > std::abs(M[pivot][c])) {
+        pivot = r;
+      }
+    }
+    if (M[pivot][c] == 0.0) {
+      return false;
+    }
+    std::swap(M[pivot], M[c]);
+    std::swap(b[pivot], b[c]);
+    for (int r = c + 1; r < 4; r++) {
+      const double f = M[r][c] / M[c][c];
+      for (int k = c; k < 4; k++) {
+        M[r][k] -= f * M[c][k];
+      }
+      b[r] -= f * b[c];
+    }
+  }
+  for (int c = 3; c >= 0; c--) {
+    for (int k = c + 1; k < 4; k++) {
+      b[c] -= M[c][k] * b[k];
+    }
+    b[c] /= M[c][c];
+  }
+  return true;
+}
+
+/**
+ * Find the eigenvector of the largest eigenvalue of T_{\mu}^{\nu} without a
+ * full diagonalization.
+ *
+ * The rest frame 4-velocity (1, 0, 0, 0) is a good first guess, which is
+ * improved by power iteration with a shift that moves the pressure
+ * eigenvalues close to zero. The shift is the mean of the other eigenvalues,
+ * estimated from the trace and the Rayleigh quotient of the current guess.
+ * Once the guess is good to 1e-6, a few steps of inverse iteration with the
+ * Rayleigh quotient as shift converge to machine precision.
+ *
+ * \param[in] A T_{\mu}^{\nu}
+ * \param[out] u Normalized eigenvector with positive zeroth component
+ * \return False if the iteration does not converge or the eigenvector is not
+ *         time-like, in which case the full diagonalization has to be done.
+ */
+bool landau_frame_by_iteration(const Matrix4 &A, std::array<double, 4> &u) {
+  constexpr int max_power_iterations = 100;
+  constexpr int max_inverse_iterations = 3;
+  const auto multiply = [&A](const std::array<double, 4> &x) {
+    std::array<double, 4> y;
+    for (int m = 0; m < 4; m++) {
+      y[m] = A[m][0] * x[0] + A[m][1] * x[1] + A[m][2] * x[2] + A[m][3] * x[3];
+    }
+    return y;
+  };
+  // Normalize y to y^0 = 1, store it in x and return the largest change
+  const auto update = [](std::array<double, 4> &x, std::array<double, 4> &y) {
+    double change = 0.0;
+    const double y0 = y[0];
+    for (int m = 0; m < 4; m++) {
+      y[m] /= y0;
+      change = std::max(change, std::abs(y[m] - x[m]));
+    }
+    x = y;
+    return change;
+  };
+  const double trace = A[0][0] + A[1][1] + A[2][2] + A[3][3];
+  std::array<double, 4> x = {1.0, 0.0, 0.0, 0.0};
+  for (int i = 0;; i++) {
+    if (i == max_power_iterations) {
+      return false;
+    }
+    std::array<double, 4> y = multiply(x);
+    const double rayleigh = minkowski_product(x, y) / minkowski_product(x, x);
+    const double shift = (rayleigh - trace) / 3.0;
+    for (int m = 0; m < 4; m++) {
+      y[m] += shift * x[m];
+    }
+    if (update(x, y) <= 1e-6) {
+      break;
+    }
+  }
+  for (int i = 0; i < max_inverse_iterations; i++) {
+    const double lambda =
+        minkowski_product(x, multiply(x)) / minkowski_product(x, x);
+    Matrix4 M = A;
+    for (int m = 0; m < 4; m++) {
+      M[m][m] -= lambda;
+    }
+    std::array<double, 4> y = x;
+    // A singular M means that lambda is exact and x is the eigenvector.
+    if (!solve_linear_system(M, y) || update(x, y) <= 1e-15) {
+      break;
+    }
+  }
+  // Same criterion as for the unit eigenvectors of the diagonalization
+  const double x_sqr = minkowski_product(x, x);
+  const double x_norm_sqr =
+      x[0] * x[0] + x[1] * x[1] + x[2] * x[2] + x[3] * x[3];
+  if (!(x_sqr > really_small * x_norm_sqr)) {
+    return false;
+  }
+  const double norm = std::sqrt(x_sqr);
+  for (int m = 0; m < 4; m++) {
+    u[m] = x[m] / norm;
+  }
+  return true;
+}
+}  // unnamed namespace
+
 FourVector EnergyMomentumTensor::landau_frame_4velocity() const {
+  // clang-format off
+  const Matrix4 T_mixed = {{{ Tmn_[0],  Tmn_[1],  Tmn_[2],  Tmn_[3]},
+                            {-Tmn_[1], -Tmn_[4], -Tmn_[5], -Tmn_[6]},
+                            {-Tmn_[2], -Tmn_[5], -Tmn_[7], -Tmn_[8]},
+                            {-Tmn_[3], -Tmn_[6], -Tmn_[8], -Tmn_[9]}}};
+  // clang-format on
+  std::array<double, 4> u_fast;
+  if (landau_frame_by_iteration(T_mixed, u_fast)) {
+    return FourVector(u_fast[0], u_fast[1], u_fast[2], u_fast[3]);
+  }
+  logg[LTmn].debug("Landau frame iteration failed, diagonalizing Tmn.");
+
   using Eigen::Matrix4d;
   using Eigen::Vector4d;
   /* We want to solve the generalized eigenvalue problem
@@ -36,6 +187,8 @@ FourVector EnergyMomentumTensor::landau_frame_4velocity() const {
      in one plane). For positively definite A a more efficient solution
      is possible, but I (oliiny) do not consider it, until it becomes
      important for SMASH performance.
+     The iteration above finds the same eigenvector much faster, so the
+     diagonalization is only the fallback for tensors where it fails.
      */
   Matrix4d A;
   // A = T_{\mu}^{\nu} = g_{\mu \mu'} T^{\mu' \nu}
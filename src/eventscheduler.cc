@@ -0,0 +1,115 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/eventscheduler.h"
+
+#include <array>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef SMASH_USE_MPI
+#include <mpi.h>
+#endif
+
+#include "smash/logging.h"
+
+namespace smash {
+static constexpr int LMain = LogArea::Main::id;
+
+void LocalEventScheduler::start(const EventLimits &limits) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!started_) {
+    limits_ = limits;
+    started_ = true;
+  }
+}
+
+int LocalEventScheduler::next_event(int nonempty_ensembles) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  nonempty_ensembles_ += nonempty_ensembles;
+  switch (limits_.counting) {
+    case EventCounting::FixedNumber:
+      return next_ < limits_.nevents ? next_++ : -1;
+    case EventCounting::MinimumNonEmpty:
+      if (nonempty_ensembles_ >= limits_.minimum_nonempty_ensembles) {
+        return -1;
+      }
+      if (next_ >= limits_.max_events) {
+        if (next_ == limits_.max_events) {
+          logg[LMain].warn() << "Maximum number of events (" << next_
+                             << ") exceeded with " << nonempty_ensembles_
+                             << " non-empty ensembles. Stopping calculation.";
+          // Only warn once
+          next_++;
+        }
+        return -1;
+      }
+      return next_++;
+    case EventCounting::Invalid:
+      break;
+  }
+  throw std::runtime_error("Event counting option is invalid");
+}
+
+#ifdef SMASH_USE_MPI
+namespace {
+/// Tag of the requests of the workers
+constexpr int request_tag = 1;
+/// Tag of the answers of the master
+constexpr int event_tag = 2;
+/// A request: non-empty ensembles of the last event and the EventLimits
+using Request = std::array<int, 5>;
+}  // unnamed namespace
+
+void MpiEventScheduler::start(const EventLimits &limits) { limits_ = limits; }
+
+int MpiEventScheduler::next_event(int nonempty_ensembles) {
+  Request request = {nonempty_ensembles, static_cast<int>(limits_.counting),
+                     limits_.nevents, limits_.minimum_nonempty_ensembles,
+                     limits_.max_events};
+  MPI_Send(request.data(), request.size(), MPI_INT, 0, request_tag,
+           MPI_COMM_WORLD);
+  int event = -1;
+  MPI_Recv(&event, 1, MPI_INT, 0, event_tag, MPI_COMM_WORLD,
+           MPI_STATUS_IGNORE);
+  return event;
+}
+
+void serve_events_over_mpi(const std::filesystem::path &index_path) {
+  int n_ranks = 1;
+  MPI_Comm_size(MPI_COMM_WORLD, &n_ranks);
+  LocalEventScheduler scheduler;
+  // Number of events handed out to each rank so far
+  std::vector<int> n_events(n_ranks, 0);
+  std::ofstream index(index_path);
+  index << "# event rank position\n";
+
+  int active_workers = n_ranks - 1;
+  while (active_workers > 0) {
+    Request request;
+    MPI_Status status;
+    MPI_Recv(request.data(), request.size(), MPI_INT, MPI_ANY_SOURCE,
+             request_tag, MPI_COMM_WORLD, &status);
+    scheduler.start({static_cast<EventCounting>(request[1]), request[2],
+                     request[3], request[4]});
+    const int event = scheduler.next_event(request[0]);
+    const int rank = status.MPI_SOURCE;
+    if (event < 0) {
+      active_workers--;
+    } else {
+      index << event << ' ' << rank << ' ' << n_events[rank]++ << '\n';
+    }
+    MPI_Send(&event, 1, MPI_INT, rank, event_tag, MPI_COMM_WORLD);
+  }
+  logg[LMain].info() << "All events are distributed, see " << index_path;
+}
+#endif
+
+}  // namespace smash
@@ -9,11 +9,20 @@
 
 #include "smash/experiment.h"
 
+#include <atomic>
 #include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <vector>
 
 #include "smash/boxmodus.h"
 #include "smash/collidermodus.h"
+#include "smash/crosssections.h"
+#include "smash/decaymodes.h"
+#include "smash/isoparticletype.h"
 #include "smash/listmodus.h"
+#include "smash/parametrizations.h"
 #include "smash/spheremodus.h"
 
 namespace smash {
@@ -27,6 +36,7 @@ ExperimentPtr ExperimentBase::create(Configuration &config,
                                        ") does not exist.");
   }
   logg[LExperiment].trace() << SMASH_SOURCE_LOCATION;
+  ScopedTimer timer(startup_profiler(), StartupStage::Experiment);
 
   const std::string modus_chooser = config.read({"General", "Modus"});
   logg[LExperiment].debug() << "Modus for this calculation: " << modus_chooser;
@@ -136,6 +146,15 @@ ExperimentParameters create_experiment_parameters(Configuration &config) {
   if (ntest <= 0) {
     throw std::invalid_argument("Testparticle number should be positive!");
   }
+  const int n_subensembles =
+      config.take({"General", "Testparticle_Subensembles"},
+                  InputKeys::gen_testparticleSubensembles.default_value());
+  if (n_subensembles <= 0 || ntest % n_subensembles != 0 ||
+      n_subensembles > std::numeric_limits<std::uint16_t>::max()) {
+    throw std::invalid_argument(
+        "The number of testparticle subensembles should be positive and "
+        "divide the number of testparticles.");
+  }
 
   // sets whether to consider only participants in thermodynamic outputs or not
   const bool only_participants =
@@ -281,13 +300,17 @@ ExperimentParameters create_experiment_parameters(Configuration &config) {
         "Only use a fixed minimal cell length with the stochastic collision "
         "criterion.");
   }
+  // The stochastic criterion only uses the maximum to bound probabilities.
+  const bool stochastic_bounds =
+      config.read({"Collision_Term", "Stochastic_Thinning"}, false) ||
+      config.read({"Collision_Term", "Stochastic_Pair_Sampling"}, false);
   if (config.has_value({"Collision_Term", "Maximum_Cross_Section"}) &&
-      criterion == CollisionCriterion::Stochastic) {
+      criterion == CollisionCriterion::Stochastic && !stochastic_bounds) {
     throw std::invalid_argument(
         "Only use maximum cross section with the "
-        "geometric collision criterion. Use Fixed_Min_Cell_Length to change "
-        "the grid "
-        "size for the stochastic criterion.");
+        "geometric collision criterion, or with Stochastic_Thinning or "
+        "Stochastic_Pair_Sampling. Use Fixed_Min_Cell_Length to change "
+        "the grid size for the stochastic criterion.");
   }
 
   /**
@@ -343,19 +366,38 @@ ExperimentParameters create_experiment_parameters(Configuration &config) {
                   false),
       config.take({"Collision_Term", "Decay_Initial_Particles"},
                   InputKeys::collTerm_decayInitial.default_value()),
-      std::nullopt};
+      std::nullopt,
+      n_subensembles};
+}
+
+void initialize_lazy_caches() {
+  for (const ParticleType &type : ParticleType::list_all()) {
+    type.min_mass_kinematic();
+    type.min_mass_spectral();
+    type.isospin();
+    if (type.is_stable()) {
+      continue;
+    }
+    type.spectral_function(type.mass());
+    for (const auto &mode : type.decay_modes().decay_mode_list()) {
+      type.partial_width(std::max(type.mass(), mode->threshold()), mode.get());
+    }
+  }
+  IsoParticleType::list_baryon_resonances();
+  initialize_parametrization_interpolations();
+  CrossSections::initialize_dispatch_table();
 }
 
 std::string format_measurements(const std::vector<Particles> &ensembles,
                                 uint64_t scatterings_this_interval,
                                 const QuantumNumbers &conserved_initial,
+                                const QuantumNumbers &conserved_current,
                                 SystemTimePoint time_start, double time,
                                 double E_mean_field,
                                 double E_mean_field_initial) {
   const SystemTimeSpan elapsed_seconds = SystemClock::now() - time_start;
 
-  const QuantumNumbers current_values(ensembles);
-  const QuantumNumbers difference = current_values - conserved_initial;
+  const QuantumNumbers difference = conserved_current - conserved_initial;
   int total_particles = 0;
   for (const Particles &particles : ensembles) {
     total_particles += particles.size();
@@ -363,7 +405,7 @@ std::string format_measurements(const std::vector<Particles> &ensembles,
 
   // Make sure there are no FPEs in case of IC output, were there will
   // eventually be no more particles in the system
-  const double current_energy = current_values.momentum().x0();
+  const double current_energy = conserved_current.momentum().x0();
   const double energy_per_part =
       (total_particles > 0) ? (current_energy + E_mean_field) / total_particles
                             : 0.0;
@@ -394,6 +436,39 @@ std::string format_measurements(const std::vector<Particles> &ensembles,
   return ss.str();
 }
 
+std::string action_cost_report(const std::map<ProcessType, ActionCost> &costs) {
+  // The time spent in all actions of a type is estimated from the samples
+  std::vector<std::pair<ProcessType, double>> totals;
+  double total = 0.;
+  for (const auto &[type, cost] : costs) {
+    const double mean = cost.samples > 0 ? cost.seconds / cost.samples : 0.;
+    totals.emplace_back(type, mean * cost.performed);
+    total += mean * cost.performed;
+  }
+  std::stable_sort(totals.begin(), totals.end(),
+                   [](const auto &a, const auto &b) {
+                     return a.second > b.second;
+                   });
+
+  std::ostringstream ss;
+  ss << std::left << std::setw(30) << "Process type" << std::right
+     << "    Performed    Samples   Mean[us]   Est. time[s]   Share[%]";
+  for (const auto &[type, estimate] : totals) {
+    const ActionCost &cost = costs.at(type);
+    // Soft string processes share a name, so the number is added
+    std::ostringstream name;
+    name << type << " (" << static_cast<int>(type) << ")";
+    ss << '\n'
+       << std::left << std::setw(30) << name.str() << std::right
+       << field<12, 0> << cost.performed << field<10, 0> << cost.samples
+       << field<10, 2>
+       << (cost.samples > 0 ? 1e6 * cost.seconds / cost.samples : 0.)
+       << field<14, 4> << estimate << field<10, 1>
+       << (total > 0. ? 100. * estimate / total : 0.);
+  }
+  return ss.str();
+}
+
 double calculate_mean_field_energy(
     const Potentials &potentials,
     RectangularLattice<smash::DensityOnLattice> &jmuB_lat,
@@ -407,6 +482,13 @@ double calculate_mean_field_energy(
   double density_mean = 0.0;
   double density_variance = 0.0;
 
+  /*
+   * The missing symmetry energy is noted once per run, and not by looking at
+   * the output clock, since the mean field energy may be calculated on another
+   * thread than the time evolution, see Experiment::write_output_time.
+   */
+  static std::atomic<bool> symmetry_noted{false};
+
   /*
    * We anticipate having other options, like the vector DFT potentials, in the
    * future, hence we include checking which potentials are used.
@@ -416,8 +498,7 @@ double calculate_mean_field_energy(
      * Calculating the symmetry energy contribution to the total mean field
      * energy in the system is not implemented at this time.
      */
-    if (potentials.use_symmetry() &&
-        parameters.outputclock->current_time() == 0.0) {
+    if (potentials.use_symmetry() && !symmetry_noted.exchange(true)) {
       logg[LExperiment].warn()
           << "Note:"
           << "\nSymmetry energy is not included in the mean field calculation."
@@ -506,8 +587,7 @@ double calculate_mean_field_energy(
      * Calculating the symmetry energy contribution to the total mean field
      * energy in the system is not implemented at this time.
      */
-    if (potentials.use_symmetry() &&
-        parameters.outputclock->current_time() == 0.0) {
+    if (potentials.use_symmetry() && !symmetry_noted.exchange(true)) {
       logg[LExperiment].error()
           << "\nSymmetry energy is not included in the VDF mean-field "
              "calculation"
@@ -619,13 +699,24 @@ EventInfo fill_event_info(const std::vector<Particles> &ensembles,
                           const ExperimentParameters &parameters,
                           bool projectile_target_interact,
                           bool kinematic_cut_for_SMASH_IC) {
+  return fill_event_info(ensembles, E_mean_field, modus_impact_parameter,
+                         parameters, parameters.outputclock->current_time(),
+                         projectile_target_interact,
+                         kinematic_cut_for_SMASH_IC);
+}
+
+EventInfo fill_event_info(const std::vector<Particles> &ensembles,
+                          double E_mean_field, double modus_impact_parameter,
+                          const ExperimentParameters &parameters,
+                          double current_time, bool projectile_target_interact,
+                          bool kinematic_cut_for_SMASH_IC) {
   const QuantumNumbers current_values(ensembles);
   const double E_kinetic_total = current_values.momentum().x0();
   const double E_total = E_kinetic_total + E_mean_field;
 
   EventInfo event_info{modus_impact_parameter,
                        parameters.box_length,
-                       parameters.outputclock->current_time(),
+                       current_time,
                        E_kinetic_total,
                        E_mean_field,
                        E_total,
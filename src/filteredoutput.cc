@@ -0,0 +1,60 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/filteredoutput.h"
+
+#include <utility>
+
+namespace smash {
+
+FilteredOutput::FilteredOutput(std::unique_ptr<OutputInterface> output,
+                               const ParticleOutputFilter &filter)
+    : OutputInterface(""), output_(std::move(output)), filter_(filter) {}
+
+const Particles &FilteredOutput::select(const Particles &particles) {
+  if (selected_) {
+    selected_->copy_from(particles);
+  } else {
+    selected_ = particles.clone(MemorySubsystem::Outputs);
+  }
+  /* The copies are removed in the order of their storage, so only the last
+   * removal can shrink the storage before the following ones. */
+  for (const ParticleData &p : particles) {
+    if (!filter_.accepts(p)) {
+      selected_->remove(p);
+    }
+  }
+  return *selected_;
+}
+
+void FilteredOutput::at_eventstart(const Particles &particles,
+                                   const int event_number,
+                                   const EventInfo &info) {
+  output_->at_eventstart(select(particles), event_number, info);
+}
+
+void FilteredOutput::at_eventend(const Particles &particles,
+                                 const int event_number,
+                                 const EventInfo &info) {
+  output_->at_eventend(select(particles), event_number, info);
+}
+
+void FilteredOutput::at_interaction(const Action &action,
+                                    const double density) {
+  output_->at_interaction(action, density);
+}
+
+void FilteredOutput::at_intermediate_time(const Particles &particles,
+                                          const std::unique_ptr<Clock> &clock,
+                                          const DensityParameters &dens_param,
+                                          const EventInfo &info) {
+  output_->at_intermediate_time(select(particles), clock, dens_param, info);
+}
+
+}  // namespace smash
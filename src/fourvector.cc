@@ -15,16 +15,28 @@
 namespace smash {
 
 FourVector FourVector::lorentz_boost(const ThreeVector& v) const {
-  const double velocity_squared = v.sqr();
+  return LorentzBoost(v)(*this);
+}
 
-  const double gamma =
-      velocity_squared < 1. ? 1. / std::sqrt(1. - velocity_squared) : 0;
+void LorentzBoost::apply(FourVector* vectors, std::size_t n) const {
+  for (std::size_t i = 0; i < n; i++) {
+    vectors[i] = (*this)(vectors[i]);
+  }
+}
 
-  // this is used four times in the Vector:
-  const double xprime_0 = gamma * (this->x0() - this->threevec() * v);
-  // this is the part of the space-like components that is always the same:
-  const double constantpart = gamma / (gamma + 1) * (xprime_0 + this->x0());
-  return FourVector(xprime_0, this->threevec() - v * constantpart);
+void LorentzBoost::apply(double* x0, double* x1, double* x2, double* x3,
+                         std::size_t n) const {
+  const double v1 = v_.x1(), v2 = v_.x2(), v3 = v_.x3();
+  for (std::size_t i = 0; i < n; i++) {
+    // the same operations as in operator()
+    const double xprime_0 = gamma_ * (x0[i] - (x1[i] * v1 + x2[i] * v2 +
+                                               x3[i] * v3));
+    const double constantpart = gamma_ratio_ * (xprime_0 + x0[i]);
+    x0[i] = xprime_0;
+    x1[i] -= v1 * constantpart;
+    x2[i] -= v2 * constantpart;
+    x3[i] -= v3 * constantpart;
+  }
 }
 
 bool FourVector::operator==(const FourVector& a) const {
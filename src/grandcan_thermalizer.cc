@@ -9,9 +9,14 @@
 
 #include <time.h>
 
+#include <algorithm>
+#include <numeric>
+#include <optional>
+
 #include "smash/angles.h"
 #include "smash/forwarddeclarations.h"
 #include "smash/logging.h"
+#include "smash/parallel.h"
 #include "smash/particles.h"
 #include "smash/quantumnumbers.h"
 #include "smash/random.h"
@@ -39,9 +44,16 @@ void ThermLatticeNode::add_particle(const ParticleData &part, double factor) {
   nq_ += static_cast<double>(part.type().charge()) * factor;
 }
 
-void ThermLatticeNode::compute_rest_frame_quantities(HadronGasEos &eos) {
+void ThermLatticeNode::compute_rest_frame_quantities(
+    const HadronGasEos &eos, const ThermLatticeNode *neighbour) {
   /// \todo(oliiny): use Newton's method instead of these iterations
   const int max_iter = 50;
+  // Solution to start the solver from, if there is a good one
+  std::optional<std::array<double, 4>> warm_start;
+  if (neighbour != nullptr && neighbour->T() > 0.0) {
+    warm_start = {neighbour->T(), neighbour->mub(), neighbour->mus(),
+                  neighbour->muq()};
+  }
   v_ = ThreeVector(0.0, 0.0, 0.0);
   double e_previous_step = 0.0;
   const double tolerance = 5.e-4;
@@ -56,8 +68,19 @@ void ThermLatticeNode::compute_rest_frame_quantities(HadronGasEos &eos) {
     EosTable::table_element tabulated;
     eos.from_table(tabulated, e_, gamma_inv * nb_, nq_);
     if (!eos.is_tabulated() || tabulated.p < 0.0) {
-      auto T_mub_mus_muq =
-          eos.solve_eos(e_, gamma_inv * nb_, gamma_inv * ns_, nq_);
+      std::array<double, 4> T_mub_mus_muq = {0.0, 0.0, 0.0, 0.0};
+      if (warm_start) {
+        T_mub_mus_muq = eos.solve_eos(e_, gamma_inv * nb_, gamma_inv * ns_,
+                                      nq_, *warm_start);
+      }
+      // A solver started far from the solution can run into T = 0.
+      if (T_mub_mus_muq[0] <= 0.0) {
+        T_mub_mus_muq =
+            eos.solve_eos(e_, gamma_inv * nb_, gamma_inv * ns_, nq_);
+      }
+      if (T_mub_mus_muq[0] > 0.0) {
+        warm_start = T_mub_mus_muq;
+      }
       T_ = T_mub_mus_muq[0];
       mub_ = T_mub_mus_muq[1];
       mus_ = T_mub_mus_muq[2];
@@ -132,19 +155,32 @@ void GrandCanThermalizer::update_thermalizer_lattice(
   const DensityType dens_type = DensityType::Hadron;
   const LatticeUpdate update = LatticeUpdate::EveryFixedInterval;
   update_lattice(lat_.get(), update, dens_type, dens_par, ensembles, false);
-  for (auto &node : *lat_) {
-    /* If energy density is definitely below e_crit -
-       no need to find T, mu, etc. So if e = T00 - T0i*vi <=
-       T00 + sum abs(T0i) < e_crit, no efforts are necessary. */
-    if (!ignore_cells_under_treshold ||
-        node.Tmu0().x0() + std::abs(node.Tmu0().x1()) +
-                std::abs(node.Tmu0().x2()) + std::abs(node.Tmu0().x3()) >=
-            e_crit_) {
-      node.compute_rest_frame_quantities(eos_);
-    } else {
-      node = ThermLatticeNode();
+  n_threads_ = dens_par.threads();
+
+  /* The nodes are independent of each other. Within a chunk, the solver
+   * starts from the solution of the previous node, which is usually close. */
+  const size_t n_nodes = lat_->size();
+  constexpr size_t nodes_per_chunk = 64;
+  const size_t n_chunks = (n_nodes + nodes_per_chunk - 1) / nodes_per_chunk;
+  parallel_for(dens_par.threads(), n_chunks, 1, [&](size_t chunk) {
+    const size_t end = std::min((chunk + 1) * nodes_per_chunk, n_nodes);
+    const ThermLatticeNode *previous = nullptr;
+    for (size_t i = chunk * nodes_per_chunk; i < end; i++) {
+      ThermLatticeNode &node = (*lat_)[i];
+      /* If energy density is definitely below e_crit -
+         no need to find T, mu, etc. So if e = T00 - T0i*vi <=
+         T00 + sum abs(T0i) < e_crit, no efforts are necessary. */
+      if (!ignore_cells_under_treshold ||
+          node.Tmu0().x0() + std::abs(node.Tmu0().x1()) +
+                  std::abs(node.Tmu0().x2()) + std::abs(node.Tmu0().x3()) >=
+              e_crit_) {
+        node.compute_rest_frame_quantities(eos_, previous);
+        previous = &node;
+      } else {
+        node = ThermLatticeNode();
+      }
     }
-  }
+  });
 }
 
 ThreeVector GrandCanThermalizer::uniform_in_cell() const {
@@ -179,8 +215,9 @@ void GrandCanThermalizer::renormalize_momenta(
 
   double E = 0.0;
   double E_expected = required_total_momentum.abs();
+  const LorentzBoost to_generated_frame(beta_CM_generated);
   for (auto &particle : plist) {
-    particle.boost_momentum(beta_CM_generated);
+    particle.boost_momentum(to_generated_frame);
     E += particle.momentum().x0();
   }
   // Renorm. momenta by factor (1+a) to get the right energy, binary search
@@ -216,10 +253,11 @@ void GrandCanThermalizer::renormalize_momenta(
 
   logg[LGrandcanThermalizer].info("Renormalizing momenta by factor 1+a, a = ",
                                   a);
+  const LorentzBoost to_required_frame(-beta_CM_required);
   for (auto &particle : plist) {
     particle.set_4momentum(particle.type().mass(),
                            (1 + a) * particle.momentum().threevec());
-    particle.boost_momentum(-beta_CM_required);
+    particle.boost_momentum(to_required_frame);
   }
 }
 
@@ -248,31 +286,45 @@ void GrandCanThermalizer::sample_multinomial(HadronClass particle_class,
   }
 }
 
+void GrandCanThermalizer::compute_N_in_cells_BF_algo() {
+  const size_t n_cells = cells_to_sample_.size();
+  N_cumulative_in_cells_.resize(N_sorts_ * n_cells);
+  // The partial densities of all species are computed cell by cell.
+  parallel_for(n_threads_, n_cells, 16, [&](size_t k) {
+    const ThermLatticeNode cell = (*lat_)[cells_to_sample_[k]];
+    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
+    for (size_t i = 0; i < N_sorts_; i++) {
+      // N_i = n u^mu dsigma_mu = (isochronous hypersurface) n * V * gamma
+      N_cumulative_in_cells_[i * n_cells + k] =
+          lat_cell_volume_ * gamma *
+          HadronGasEos::partial_density(*eos_typelist_[i], cell.T(), cell.mub(),
+                                        cell.mus(), cell.muq());
+    }
+  });
+
+  for (size_t i = 0; i < N_sorts_; i++) {
+    const auto begin = N_cumulative_in_cells_.begin() + i * n_cells;
+    std::partial_sum(begin, begin + n_cells, begin);
+  }
+}
+
 void GrandCanThermalizer::sample_in_random_cell_BF_algo(ParticleList &plist,
                                                         const double time,
                                                         size_t type_index) {
-  N_in_cells_.clear();
-  N_total_in_cells_ = 0.0;
-  for (auto cell_index : cells_to_sample_) {
-    const ThermLatticeNode cell = (*lat_)[cell_index];
-    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
-    const double N_this_cell =
-        lat_cell_volume_ * gamma *
-        HadronGasEos::partial_density(*eos_typelist_[type_index], cell.T(),
-                                      cell.mub(), cell.mus(), cell.muq());
-    N_in_cells_.push_back(N_this_cell);
-    N_total_in_cells_ += N_this_cell;
+  const size_t n_cells = cells_to_sample_.size();
+  if (mult_int_[type_index] == 0 || n_cells == 0) {
+    return;
   }
+  const auto begin = N_cumulative_in_cells_.cbegin() + type_index * n_cells;
+  const auto end = begin + n_cells;
+  const double N_total_in_cells = *(end - 1);
 
   for (int i = 0; i < mult_int_[type_index]; i++) {
     // Choose random cell, probability = N_in_cell/N_total
-    double r = random::uniform(0.0, N_total_in_cells_);
-    double partial_sum = 0.0;
-    int index_only_thermalized = -1;
-    while (partial_sum < r) {
-      index_only_thermalized++;
-      partial_sum += N_in_cells_[index_only_thermalized];
-    }
+    const double r = random::uniform(0.0, N_total_in_cells);
+    const size_t index_only_thermalized = std::min(
+        static_cast<size_t>(std::lower_bound(begin, end, r) - begin),
+        n_cells - 1);
     const int cell_index = cells_to_sample_[index_only_thermalized];
     const ThermLatticeNode cell = (*lat_)[cell_index];
     const ThreeVector cell_center = lat_->cell_center(cell_index);
@@ -283,7 +335,8 @@ void GrandCanThermalizer::sample_in_random_cell_BF_algo(ParticleList &plist,
     // Position
     particle.set_4position(FourVector(time, cell_center + uniform_in_cell()));
     // Momentum
-    double momentum_radial = sample_momenta_from_thermal(cell.T(), m);
+    double momentum_radial =
+        ThermalMomentumSampling::instance().sample(cell.T(), m);
     Angles phitheta;
     phitheta.distribute_isotropically();
     particle.set_4momentum(m, phitheta.threevec() * momentum_radial);
@@ -296,17 +349,12 @@ void GrandCanThermalizer::sample_in_random_cell_BF_algo(ParticleList &plist,
 
 void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
                                              double time, int ntest) {
-  std::fill(mult_sort_.begin(), mult_sort_.end(), 0.0);
-  for (auto cell_index : cells_to_sample_) {
-    const ThermLatticeNode cell = (*lat_)[cell_index];
-    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
-    for (size_t i = 0; i < N_sorts_; i++) {
-      // N_i = n u^mu dsigma_mu = (isochronous hypersurface) n * V * gamma
-      mult_sort_[i] +=
-          lat_cell_volume_ * gamma * ntest *
-          HadronGasEos::partial_density(*eos_typelist_[i], cell.T(), cell.mub(),
-                                        cell.mus(), cell.muq());
-    }
+  compute_N_in_cells_BF_algo();
+  const size_t n_cells = cells_to_sample_.size();
+  for (size_t i = 0; i < N_sorts_; i++) {
+    mult_sort_[i] = n_cells == 0
+                        ? 0.0
+                        : ntest * N_cumulative_in_cells_[(i + 1) * n_cells - 1];
   }
 
   std::fill(mult_classes_.begin(), mult_classes_.end(), 0.0);
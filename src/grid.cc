@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2015,2017-2023
+ *    Copyright (c) 2014-2015,2017-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,11 +9,19 @@
 
 #include "smash/grid.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <mutex>
 #include <stdexcept>
 
 #include "smash/algorithms.h"
 #include "smash/fourvector.h"
 #include "smash/logging.h"
+#include "smash/parallel.h"
 #include "smash/particledata.h"
 #include "smash/threevector.h"
 
@@ -109,26 +117,100 @@ GridBase::find_min_and_length(const Particles &particles) {
   return r;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// AdaptiveCellSizer
+
+void AdaptiveCellSizer::record(const GridStatistics &stats,
+                               double min_cell_length) {
+  // Volume around a particle in which its pair candidates are found
+  const double searched_volume =
+      stats.binned ? 27. * stats.cell_volume : stats.volume;
+  if (stats.particles == 0 || !(searched_volume > 0.) ||
+      !(min_cell_length > 0.)) {
+    return;
+  }
+  const double pairs_per_volume = stats.pair_candidates / searched_volume;
+  const double single_cell_time =
+      stats.single_cell_pairs + cell_cost * stats.layers;
+  auto predicted_time = [&](double cell_length) {
+    const double cell_volume = cell_length * cell_length * cell_length;
+    const double pairs =
+        std::min(pairs_per_volume * 27. * cell_volume,
+                 static_cast<double>(stats.single_cell_pairs));
+    const double cells =
+        stats.layers * std::max(1., stats.volume / cell_volume);
+    return pairs + cell_cost * cells;
+  };
+
+  const double current_time = single_cell_
+                                  ? single_cell_time
+                                  : predicted_time(scale_ * min_cell_length);
+  // A single cell is not possible with periodic boundaries.
+  bool best_single_cell = std::isinf(stats.max_cell_length);
+  double best_scale = 1.;
+  double best_time = best_single_cell
+                         ? single_cell_time
+                         : std::numeric_limits<double>::infinity();
+  for (double scale = 1.; scale <= max_scale * (1. + 1e-9);
+       scale *= std::cbrt(2.)) {
+    if (scale > 1. && scale * min_cell_length > stats.max_cell_length) {
+      break;
+    }
+    const double time = predicted_time(scale * min_cell_length);
+    if (time < best_time) {
+      best_time = time;
+      best_scale = scale;
+      best_single_cell = false;
+    }
+  }
+  if (best_time < (1. - hysteresis) * current_time) {
+    scale_ = best_scale;
+    single_cell_ = best_single_cell;
+    logg[LGrid].debug("Switching to ",
+                      single_cell_ ? "a single cell"
+                                   : "cells of " + std::to_string(scale_) +
+                                         " times the minimal length",
+                      ", predicted search time ", best_time, " instead of ",
+                      current_time, ".");
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Grid
 
 template <GridOptions O>
-Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
-                  &min_and_length,
-              const Particles &particles, double max_interaction_length,
-              double timestep_duration, CellNumberLimitation limit,
-              const bool include_unformed_particles, CellSizeStrategy strategy)
-    : length_(min_and_length.second) {
-  const auto min_position = min_and_length.first;
+void Grid<O>::update(
+    const std::pair<std::array<double, 3>, std::array<double, 3>>
+        &min_and_length,
+    const Particles &particles, double max_interaction_length,
+    double timestep_duration, CellNumberLimitation limit,
+    const bool include_unformed_particles, CellSizeStrategy strategy) {
+  // Remember the previous geometry to decide whether all particles need to be
+  // placed again.
+  const bool was_binned = binned_;
+  const auto previous_min_position = min_position_;
+  const auto previous_index_factor = index_factor_;
+  const auto previous_number_of_cells = number_of_cells_;
+  const auto previous_z_slab_of_bin = std::move(z_slab_of_bin_);
+  z_slab_of_bin_.clear();
+  binned_ = false;
+
+  length_ = min_and_length.second;
+  min_position_ = min_and_length.first;
+  const auto &min_position = min_position_;
   const SizeType particle_count = particles.size();
+  auto is_left_out = [&](const ParticleData &p) {
+    return is_excluded_ && is_excluded_(p);
+  };
 
   // very simple setup for non-periodic boundaries and largest cellsize strategy
   if (O == GridOptions::Normal && strategy == CellSizeStrategy::Largest) {
     number_of_cells_ = {1, 1, 1};
     cell_volume_ = length_[0] * length_[1] * length_[2];
-    cells_.clear();
-    cells_.reserve(1);
-    cells_.emplace_back(particles.copy_to_vector());
+    fill_single_cells(particles,
+                      [&](const ParticleData &p) { return !is_left_out(p); });
+    prepare_cell_order();
+    collect_members();
     return;
   }
 
@@ -138,18 +220,20 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
   // But don't let the number of cells exceed the actual number of particles.
   // That would be overkill. Let max_cells³ ≤ particle_count (conversion to
   // int truncates). Limit only applied for geometric criteiron, where grid
-  // is an optimisation and cells can be made larger.
+  // is an optimisation and cells can be made larger. With several layers,
+  // the particles of one layer are counted.
+  const SizeType layer_count = particle_count / n_layers_;
   const int max_cells =
       (O == GridOptions::Normal)
-          ? std::cbrt(particle_count)
-          : std::max(2, static_cast<int>(std::cbrt(particle_count)));
+          ? std::cbrt(layer_count)
+          : std::max(2, static_cast<int>(std::cbrt(layer_count)));
 
   // This normally equals 1/max_interaction_length. If the number of cells
   // is reduced (because of low density) then this value is smaller. If only
   // one cell is used than this value might also be larger.
-  std::array<double, 3> index_factor = {1. / max_interaction_length,
-                                        1. / max_interaction_length,
-                                        1. / max_interaction_length};
+  std::array<double, 3> &index_factor = index_factor_;
+  index_factor = {1. / max_interaction_length, 1. / max_interaction_length,
+                  1. / max_interaction_length};
   for (std::size_t i = 0; i < number_of_cells_.size(); ++i) {
     if (strategy == CellSizeStrategy::Largest) {
       number_of_cells_[i] = 2;
@@ -203,6 +287,12 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
       assert(index_factor[i] * length_[i] < number_of_cells_[i]);
     }
   }
+  // The cell number limit is only applied for the geometric criterion, so
+  // only then the cells may differ in size.
+  if (O == GridOptions::Normal &&
+      limit == CellNumberLimitation::ParticleNumber) {
+    sweep_beam_axis(particles, max_interaction_length, max_cells);
+  }
 
   if (O == GridOptions::Normal &&
       all_of(number_of_cells_, [](SizeType n) { return n <= 2; })) {
@@ -217,24 +307,18 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
         " cells. Therefore the Grid falls back to a single cell / "
         "particle list.");
     number_of_cells_ = {1, 1, 1};
+    z_slab_of_bin_.clear();
     cell_volume_ = length_[0] * length_[1] * length_[2];
-    if (include_unformed_particles) {
-      cells_.clear();
-      cells_.reserve(1);
-      cells_.emplace_back(particles.copy_to_vector());
-    } else {
-      // filter out the particles that can not interact
-      cells_.resize(1);
-      cells_.front().reserve(particles.size());
-      std::copy_if(particles.begin(), particles.end(),
-                   std::back_inserter(cells_.front()),
-                   [&](const ParticleData &p) {
-                     return p.xsec_scaling_factor(timestep_duration) > 0.0;
-                   });
-    }
+    // filter out the particles that can not interact
+    fill_single_cells(particles, [&](const ParticleData &p) {
+      return !is_left_out(p) &&
+             (include_unformed_particles ||
+              p.xsec_scaling_factor(timestep_duration) > 0.0);
+    });
   } else {
     // construct a normal grid
 
+    // The average volume, if the beam axis is divided into slabs
     cell_volume_ = (length_[0] / number_of_cells_[0]) *
                    (length_[1] / number_of_cells_[1]) *
                    (length_[2] / number_of_cells_[2]);
@@ -245,45 +329,360 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
                       "\nindex_factor: ", index_factor);
 
     // After the grid parameters are determined, we can start placing the
-    // particles in cells.
-    cells_.resize(number_of_cells_[0] * number_of_cells_[1] *
-                  number_of_cells_[2]);
-
-    // Returns the one-dimensional cell-index from the position vector inside
-    // the grid.
-    // This simply calculates the distance to min_position and multiplies it
-    // with index_factor to determine the 3 x,y,z indexes to pass to make_index.
-    auto &&cell_index_for = [&](const ParticleData &p) {
-      return make_index(
-          std::floor((p.position()[1] - min_position[0]) * index_factor[0]),
-          std::floor((p.position()[2] - min_position[1]) * index_factor[1]),
-          std::floor((p.position()[3] - min_position[2]) * index_factor[2]));
+    // particles in cells. If the geometry is the same as before, only the
+    // particles that changed their cell need to be moved.
+    const bool same_geometry = was_binned &&
+                               number_of_cells_ == previous_number_of_cells &&
+                               min_position == previous_min_position &&
+                               index_factor == previous_index_factor &&
+                               z_slab_of_bin_ == previous_z_slab_of_bin;
+    if (same_geometry) {
+      rebin_changed(particles, timestep_duration, include_unformed_particles);
+    } else {
+      rebin_all(particles, timestep_duration, include_unformed_particles);
+    }
+    binned_ = true;
+  }
+  if (O == GridOptions::Normal) {
+    prepare_cell_order();
+  }
+  collect_members();
+
+  logg[LGrid].debug(cells_);
+}
+
+template <GridOptions O>
+void Grid<O>::collect_members() {
+  if (!is_member_) {
+    members_.clear();
+    return;
+  }
+  members_.resize(cells_.size());
+  for (std::size_t i = 0; i < cells_.size(); i++) {
+    members_[i].clear();
+    std::copy_if(cells_[i].begin(), cells_[i].end(),
+                 std::back_inserter(members_[i]), is_member_);
+  }
+}
+
+template <GridOptions O>
+typename Grid<O>::SizeType Grid<O>::cell_index_for(
+    const ParticleData &p, double timestep_duration,
+    bool include_unformed_particles) const {
+  if (!include_unformed_particles &&
+      (p.xsec_scaling_factor(timestep_duration) <= 0.0)) {
+    return -1;
+  }
+  if (is_excluded_ && is_excluded_(p)) {
+    return -1;
+  }
+  // This simply calculates the distance to min_position_ and multiplies it
+  // with index_factor_ to determine the 3 x,y,z indexes to pass to
+  // make_index. Along z, this is the bin of the slab, if there are slabs.
+  const SizeType z_index =
+      std::floor((p.position()[3] - min_position_[2]) * index_factor_[2]);
+  const auto idx =
+      layer_offset(p) +
+      make_index(
+          std::floor((p.position()[1] - min_position_[0]) * index_factor_[0]),
+          std::floor((p.position()[2] - min_position_[1]) * index_factor_[1]),
+          z_slab_of_bin_.empty() ? z_index : z_slab_of_bin_[z_index]);
+#ifndef NDEBUG
+  if (idx >= SizeType(cells_.size())) {
+    logg[LGrid].fatal(
+        SMASH_SOURCE_LOCATION,
+        "\nan out-of-bounds access would be necessary for the "
+        "particle ",
+        p,
+        "\nfor a grid with the following parameters:\nmin: ", min_position_,
+        "\nlength: ", length_, "\ncells: ", number_of_cells_,
+        "\nindex_factor: ", index_factor_, "\ncells_.size: ", cells_.size(),
+        "\nrequested index: ", idx);
+    throw std::runtime_error("out-of-bounds grid access on construction");
+  }
+#endif
+  return idx;
+}
+
+template <GridOptions O>
+void Grid<O>::prepare_cell_order() {
+  if (number_of_cells_ == ordered_number_of_cells_ && !cell_order_.empty()) {
+    return;
+  }
+  ordered_number_of_cells_ = number_of_cells_;
+
+  /* A cell may have neighbors below (bit 0) and above (bit 1) in every
+   * direction, which selects one of the 64 stencils. */
+  auto sides = [](SizeType i, SizeType n) {
+    return (i > 0 ? 1 : 0) | (i < n - 1 ? 2 : 0);
+  };
+  for (int stencil = 0; stencil < 64; stencil++) {
+    const std::array<int, 3> side = {stencil & 3, (stencil >> 2) & 3,
+                                     (stencil >> 4) & 3};
+    auto allowed = [&](int d, int axis) {
+      return d == 0 || (d < 0 ? side[axis] & 1 : side[axis] & 2);
     };
-    for (const auto &p : particles) {
-      if (!include_unformed_particles &&
-          (p.xsec_scaling_factor(timestep_duration) <= 0.0)) {
-        continue;
+    std::vector<SizeType> &offsets = stencils_[stencil];
+    offsets.clear();
+    for (int dz = 0; dz <= 1; dz++) {
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          // Every pair of adjacent cells is visited once: the half shell.
+          const bool half_shell =
+              dz > 0 || (dz == 0 && (dy > 0 || (dy == 0 && dx > 0)));
+          if (half_shell && allowed(dx, 0) && allowed(dy, 1) &&
+              allowed(dz, 2)) {
+            offsets.push_back(make_index(dx, dy, dz));
+          }
+        }
       }
-      const auto idx = cell_index_for(p);
-#ifndef NDEBUG
-      if (idx >= SizeType(cells_.size())) {
-        logg[LGrid].fatal(
-            SMASH_SOURCE_LOCATION,
-            "\nan out-of-bounds access would be necessary for the "
-            "particle ",
-            p,
-            "\nfor a grid with the following parameters:\nmin: ", min_position,
-            "\nlength: ", length_, "\ncells: ", number_of_cells_,
-            "\nindex_factor: ", index_factor, "\ncells_.size: ", cells_.size(),
-            "\nrequested index: ", idx);
-        throw std::runtime_error("out-of-bounds grid access on construction");
+    }
+  }
+
+  std::vector<std::pair<std::uint64_t, OrderedCell>> cells;
+  cells.reserve(cells_per_layer());
+  for (SizeType z = 0; z < number_of_cells_[2]; ++z) {
+    for (SizeType y = 0; y < number_of_cells_[1]; ++y) {
+      for (SizeType x = 0; x < number_of_cells_[0]; ++x) {
+        const std::uint64_t morton = morton_index(x, y, z);
+        const int stencil = sides(x, number_of_cells_[0]) |
+                            sides(y, number_of_cells_[1]) << 2 |
+                            sides(z, number_of_cells_[2]) << 4;
+        const int colour = x % 3 + 3 * (y % 3) + 9 * (z % 3);
+        cells.emplace_back(morton,
+                           OrderedCell{make_index(x, y, z),
+                                       static_cast<std::uint8_t>(stencil),
+                                       static_cast<std::uint8_t>(colour)});
       }
-#endif
+    }
+  }
+  std::sort(cells.begin(), cells.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  cell_order_.clear();
+  cell_order_.reserve(cells.size());
+  for (const auto &cell : cells) {
+    cell_order_.push_back(cell.second);
+  }
+}
+
+template <GridOptions O>
+void Grid<O>::rebin_all(const Particles &particles, double timestep_duration,
+                        bool include_unformed_particles) {
+  // Clearing the cells keeps their storage for the next time step
+  for (ParticleList &cell : cells_) {
+    cell.clear();
+  }
+  cells_.resize(n_layers_ * cells_per_layer());
+  std::fill(slot_cell_.begin(), slot_cell_.end(), -1);
+  for (const auto &p : particles) {
+    const SizeType idx =
+        cell_index_for(p, timestep_duration, include_unformed_particles);
+    if (idx < 0) {
+      continue;
+    }
+    const unsigned slot = storage_index(p);
+    if (slot >= slot_cell_.size()) {
+      slot_cell_.resize(slot + 1, -1);
+      slot_position_.resize(slot + 1);
+      slot_id_.resize(slot + 1);
+    }
+    slot_cell_[slot] = idx;
+    slot_position_[slot] = cells_[idx].size();
+    slot_id_[slot] = p.id();
+    cells_[idx].push_back(p);
+  }
+}
+
+template <GridOptions O>
+void Grid<O>::remove_from_cell(unsigned slot) {
+  ParticleList &cell = cells_[slot_cell_[slot]];
+  const unsigned position = slot_position_[slot];
+  if (position + 1 != cell.size()) {
+    cell[position] = cell.back();
+    slot_position_[storage_index(cell[position])] = position;
+  }
+  cell.pop_back();
+  slot_cell_[slot] = -1;
+}
+
+template <GridOptions O>
+void Grid<O>::rebin_changed(const Particles &particles,
+                            double timestep_duration,
+                            bool include_unformed_particles) {
+  /* Particles that are no longer there: their storage is either beyond the
+   * last particle or a hole. Both are found by comparing with the slots of
+   * the current particles. */
+  std::vector<char> present(slot_cell_.size(), 0);
+  for (const auto &p : particles) {
+    const unsigned slot = storage_index(p);
+    if (slot < present.size()) {
+      present[slot] = 1;
+    }
+  }
+  for (unsigned slot = 0; slot < slot_cell_.size(); ++slot) {
+    if (!present[slot] && slot_cell_[slot] >= 0) {
+      remove_from_cell(slot);
+    }
+  }
+
+  for (const auto &p : particles) {
+    const SizeType idx =
+        cell_index_for(p, timestep_duration, include_unformed_particles);
+    const unsigned slot = storage_index(p);
+    if (slot >= slot_cell_.size()) {
+      slot_cell_.resize(slot + 1, -1);
+      slot_position_.resize(slot + 1);
+      slot_id_.resize(slot + 1);
+    }
+    const bool same_particle = slot_id_[slot] == p.id();
+    if (slot_cell_[slot] >= 0 && same_particle && slot_cell_[slot] == idx) {
+      // still in the same cell, only update the state
+      cells_[idx][slot_position_[slot]] = p;
+      continue;
+    }
+    if (slot_cell_[slot] >= 0) {
+      remove_from_cell(slot);
+    }
+    if (idx >= 0) {
+      slot_cell_[slot] = idx;
+      slot_position_[slot] = cells_[idx].size();
+      slot_id_[slot] = p.id();
       cells_[idx].push_back(p);
     }
   }
+}
 
-  logg[LGrid].debug(cells_);
+template <GridOptions O>
+typename Grid<O>::SizeType Grid<O>::clamped_cell_coordinate(double coordinate,
+                                                            int axis) const {
+  const double index =
+      std::floor((coordinate - min_position_[axis]) * index_factor_[axis]);
+  const bool slabs = axis == 2 && !z_slab_of_bin_.empty();
+  const SizeType last =
+      (slabs ? SizeType(z_slab_of_bin_.size()) : number_of_cells_[axis]) - 1;
+  SizeType clamped = 0;
+  if (index > 0.) {
+    clamped = index < last ? static_cast<SizeType>(index) : last;
+  }
+  return slabs ? z_slab_of_bin_[clamped] : clamped;
+}
+
+template <GridOptions O>
+void Grid<O>::sweep_beam_axis(const Particles &particles,
+                              double max_interaction_length, int max_cells) {
+  constexpr int bins_per_cell = 4;
+  if (particles.size() == 0) {
+    return;
+  }
+  const double bin_factor = bins_per_cell / max_interaction_length;
+  const double bins = std::floor(length_[2] * bin_factor) + 1.;
+  if (bins > bins_per_cell * (particles.size() + 1.)) {
+    return;
+  }
+  const SizeType n_bins = bins;
+  std::vector<char> occupied(n_bins, 0);
+  for (const ParticleData &p : particles) {
+    const double bin =
+        std::floor((p.position()[3] - min_position_[2]) * bin_factor);
+    occupied[std::clamp(bin, 0., n_bins - 1.)] = 1;
+  }
+  // The next occupied bin at or after every bin, n_bins if there is none
+  std::vector<SizeType> next_occupied(n_bins + 1, n_bins);
+  for (SizeType bin = n_bins - 1; bin >= 0; --bin) {
+    next_occupied[bin] = occupied[bin] ? bin : next_occupied[bin + 1];
+  }
+  /* A new slab starts at an occupied bin or, after occupied bins, at a gap
+   * of at least one cell length, so that the nuclei do not become neighbors
+   * across the gap. */
+  std::vector<SizeType> slab_of_bin(n_bins);
+  SizeType slab = 0;
+  bool slab_occupied = false;
+  for (SizeType bin = 0, start = 0; bin < n_bins; ++bin) {
+    const bool gap_follows = slab_occupied && next_occupied[bin] < n_bins &&
+                             next_occupied[bin] >= bin + bins_per_cell;
+    if (bin >= start + bins_per_cell && (occupied[bin] || gap_follows)) {
+      ++slab;
+      start = bin;
+      slab_occupied = false;
+    }
+    slab_occupied = slab_occupied || occupied[bin];
+    slab_of_bin[bin] = slab;
+  }
+  const SizeType n_slabs = slab + 1;
+  if (n_slabs >= number_of_cells_[2]) {
+    return;
+  }
+  number_of_cells_[2] = n_slabs;
+  index_factor_[2] = bin_factor;
+  z_slab_of_bin_ = std::move(slab_of_bin);
+
+  // The cells saved along the beam axis are spent in the transverse plane.
+  const SizeType layer_count = particles.size() / n_layers_;
+  const SizeType max_transverse =
+      std::max<SizeType>(max_cells, std::sqrt(layer_count / n_slabs));
+  for (int i = 0; i < 2; ++i) {
+    const SizeType wanted = std::floor(length_[i] / max_interaction_length);
+    if (number_of_cells_[i] >= std::min(wanted, max_transverse)) {
+      continue;
+    }
+    number_of_cells_[i] = std::min(wanted, max_transverse);
+    index_factor_[i] = number_of_cells_[i] / length_[i];
+    while (index_factor_[i] * length_[i] >= number_of_cells_[i]) {
+      index_factor_[i] = std::nextafter(index_factor_[i], 0.);
+    }
+  }
+  logg[LGrid].debug("The beam axis is divided into ", n_slabs, " slabs.");
+}
+
+template <GridOptions O>
+void Grid<O>::place(const ParticleData &p) {
+  if (!binned_) {
+    throw std::logic_error("Particles can only be placed onto binned grids.");
+  }
+  const ThreeVector r = p.position().threevec();
+  const SizeType idx = layer_offset(p) +
+                       make_index(clamped_cell_coordinate(r.x1(), 0),
+                                  clamped_cell_coordinate(r.x2(), 1),
+                                  clamped_cell_coordinate(r.x3(), 2));
+  const unsigned slot = storage_index(p);
+  if (slot >= slot_cell_.size()) {
+    slot_cell_.resize(slot + 1, -1);
+    slot_position_.resize(slot + 1);
+    slot_id_.resize(slot + 1);
+  }
+  if (slot_cell_[slot] >= 0) {
+    remove_from_cell(slot);
+  }
+  slot_cell_[slot] = idx;
+  slot_position_[slot] = cells_[idx].size();
+  slot_id_[slot] = p.id();
+  cells_[idx].push_back(p);
+}
+
+template <GridOptions O>
+void Grid<O>::iterate_surroundings(
+    const ThreeVector &position, double radius,
+    const std::function<void(const ParticleData &)> &callback) const {
+  if (!binned_) {
+    throw std::logic_error("Only binned grids can be searched locally.");
+  }
+  std::array<SizeType, 3> lower, upper;
+  for (int i = 0; i < 3; i++) {
+    lower[i] = clamped_cell_coordinate(position[i] - radius, i);
+    upper[i] = clamped_cell_coordinate(position[i] + radius, i);
+  }
+  for (SizeType offset = 0; offset < SizeType(cells_.size());
+       offset += cells_per_layer()) {
+    for (SizeType z = lower[2]; z <= upper[2]; ++z) {
+      for (SizeType y = lower[1]; y <= upper[1]; ++y) {
+        for (SizeType x = lower[0]; x <= upper[0]; ++x) {
+          for (const ParticleData &p : cells_[offset + make_index(x, y, z)]) {
+            callback(p);
+          }
+        }
+      }
+    }
+  }
 }
 
 template <GridOptions Options>
@@ -292,56 +691,189 @@ inline typename Grid<Options>::SizeType Grid<Options>::make_index(
   return (z * number_of_cells_[1] + y) * number_of_cells_[0] + x;
 }
 
-static const std::initializer_list<GridBase::SizeType> ZERO{0};
-static const std::initializer_list<GridBase::SizeType> ZERO_ONE{0, 1};
-static const std::initializer_list<GridBase::SizeType> MINUS_ONE_ZERO{-1, 0};
-static const std::initializer_list<GridBase::SizeType> MINUS_ONE_ZERO_ONE{-1, 0,
-                                                                          1};
-
 template <>
 /// Specialization of iterate_cells
 void Grid<GridOptions::Normal>::iterate_cells(
     const std::function<void(const ParticleList &)> &search_cell_callback,
     const std::function<void(const ParticleList &, const ParticleList &)>
         &neighbor_cell_callback) const {
-  std::array<SizeType, 3> search_index;
-  SizeType &x = search_index[0];
-  SizeType &y = search_index[1];
-  SizeType &z = search_index[2];
-  SizeType search_cell_index = 0;
-  for (z = 0; z < number_of_cells_[2]; ++z) {
-    for (y = 0; y < number_of_cells_[1]; ++y) {
-      for (x = 0; x < number_of_cells_[0]; ++x, ++search_cell_index) {
-        assert(search_cell_index == make_index(search_index));
-        assert(search_cell_index >= 0);
-        assert(search_cell_index < SizeType(cells_.size()));
-        const ParticleList &search = cells_[search_cell_index];
-        search_cell_callback(search);
-
-        const auto &dz_list = z == number_of_cells_[2] - 1 ? ZERO : ZERO_ONE;
-        const auto &dy_list = number_of_cells_[1] == 1 ? ZERO
-                              : y == 0                 ? ZERO_ONE
-                              : y == number_of_cells_[1] - 1
-                                  ? MINUS_ONE_ZERO
-                                  : MINUS_ONE_ZERO_ONE;
-        const auto &dx_list = number_of_cells_[0] == 1 ? ZERO
-                              : x == 0                 ? ZERO_ONE
-                              : x == number_of_cells_[0] - 1
-                                  ? MINUS_ONE_ZERO
-                                  : MINUS_ONE_ZERO_ONE;
-        for (SizeType dz : dz_list) {
-          for (SizeType dy : dy_list) {
-            for (SizeType dx : dx_list) {
-              const auto di = make_index(dx, dy, dz);
-              if (di > 0) {
-                neighbor_cell_callback(search, cells_[search_cell_index + di]);
-              }
-            }
+  for (SizeType offset = 0; offset < SizeType(cells_.size());
+       offset += cells_per_layer()) {
+    for (const OrderedCell &cell : cell_order_) {
+      const SizeType search_cell_index = offset + cell.index;
+      assert(search_cell_index < SizeType(cells_.size()));
+      const ParticleList &search = cells_[search_cell_index];
+      search_cell_callback(search);
+      if (search.empty()) {
+        continue;
+      }
+      for (SizeType di : stencils_[cell.stencil]) {
+        const ParticleList &neighbors = cells_[search_cell_index + di];
+        if (!neighbors.empty()) {
+          neighbor_cell_callback(search, neighbors);
+        }
+      }
+    }
+  }
+}
+
+namespace {
+/// Lets a fixed number of threads wait for each other, repeatedly.
+class Barrier {
+ public:
+  /**
+   * Prepare the barrier.
+   * \param[in] n_threads Number of threads that wait for each other
+   */
+  explicit Barrier(int n_threads) : n_threads_(n_threads) {}
+
+  /// Wait until all threads arrived.
+  void arrive_and_wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::uint64_t generation = generation_;
+    if (++arrived_ == n_threads_) {
+      arrived_ = 0;
+      ++generation_;
+      all_arrived_.notify_all();
+      return;
+    }
+    all_arrived_.wait(lock, [&] { return generation_ != generation; });
+  }
+
+ private:
+  /// Number of threads that wait for each other
+  const int n_threads_;
+  /// Number of threads that arrived in the current generation
+  int arrived_ = 0;
+  /// Number of times all threads arrived
+  std::uint64_t generation_ = 0;
+  /// Protects the counters
+  std::mutex mutex_;
+  /// Signals that all threads arrived
+  std::condition_variable all_arrived_;
+};
+
+/**
+ * Processes items sorted by colour on several threads. The colours are
+ * processed one after the other, the items of one colour concurrently in
+ * chunks, with the calling thread as the first worker.
+ *
+ * \param[in] n_threads Maximal number of threads
+ * \param[in] colour_begin Index of the first item of every colour, followed by
+ *                         the number of items
+ * \param[in] process Called with the index of the thread and of the item
+ * \throws the first exception thrown by \p process, after all threads
+ *         finished
+ */
+template <typename F>
+void process_colours_in_parallel(int n_threads,
+                                 const std::vector<std::size_t> &colour_begin,
+                                 const F &process) {
+  constexpr std::size_t chunk_size = 16;
+  const int n_colours = colour_begin.size() - 1;
+  const int n_workers = std::clamp<int>(
+      n_threads, 1, std::max<std::size_t>(1, colour_begin.back() / chunk_size));
+  std::vector<std::atomic<std::size_t>> next_chunk(n_colours);
+  for (auto &chunk : next_chunk) {
+    chunk = 0;
+  }
+  std::vector<std::exception_ptr> errors(n_workers);
+  std::atomic<bool> failed{false};
+  Barrier barrier(n_workers);
+  // One chunk per worker, so that every worker arrives at the barrier
+  parallel_for(n_workers, n_workers, 1, [&](int i_thread, std::size_t) {
+    for (int colour = 0; colour < n_colours; colour++) {
+      const std::size_t begin = colour_begin[colour];
+      const std::size_t end = colour_begin[colour + 1];
+      try {
+        for (std::size_t chunk = next_chunk[colour]++;
+             !failed && begin + chunk * chunk_size < end;
+             chunk = next_chunk[colour]++) {
+          const std::size_t last =
+              std::min(end, begin + (chunk + 1) * chunk_size);
+          for (std::size_t i = begin + chunk * chunk_size; i < last; i++) {
+            process(i_thread, i);
           }
         }
+      } catch (...) {
+        errors[i_thread] = std::current_exception();
+        failed = true;
       }
+      // The next colour may only start after this one is complete.
+      barrier.arrive_and_wait();
     }
+  });
+  for (const std::exception_ptr &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+}  // unnamed namespace
+
+template <>
+/// Specialization of iterate_cells_in_parallel
+void Grid<GridOptions::Normal>::iterate_cells_in_parallel(
+    int n_threads,
+    const std::function<void(int, const ParticleList &)> &search_cell_callback,
+    const std::function<void(int, const ParticleList &, const ParticleList &)>
+        &neighbor_cell_callback) const {
+  // The cells of all layers, sorted by colour
+  constexpr int n_colours = 27;
+  std::vector<SizeType> cells;
+  std::vector<std::uint8_t> stencils;
+  std::vector<std::size_t> colour_begin(n_colours + 1, 0);
+  for (const OrderedCell &cell : cell_order_) {
+    colour_begin[cell.colour + 1]++;
+  }
+  for (int colour = 0; colour < n_colours; colour++) {
+    colour_begin[colour + 1] += colour_begin[colour];
   }
+  const std::size_t n_layers = cells_.size() / std::max(cells_per_layer(), 1);
+  for (std::size_t &begin : colour_begin) {
+    begin *= n_layers;
+  }
+  cells.resize(colour_begin.back());
+  stencils.resize(colour_begin.back());
+  std::array<std::size_t, n_colours> next = {};
+  std::copy(colour_begin.begin(), colour_begin.end() - 1, next.begin());
+  for (SizeType offset = 0; offset < SizeType(cells_.size());
+       offset += cells_per_layer()) {
+    for (const OrderedCell &cell : cell_order_) {
+      const std::size_t i = next[cell.colour]++;
+      cells[i] = offset + cell.index;
+      stencils[i] = cell.stencil;
+    }
+  }
+
+  process_colours_in_parallel(
+      n_threads, colour_begin, [&](int i_thread, std::size_t i) {
+        const ParticleList &search = cells_[cells[i]];
+        search_cell_callback(i_thread, search);
+        if (search.empty()) {
+          return;
+        }
+        for (SizeType di : stencils_[stencils[i]]) {
+          const ParticleList &neighbors = cells_[cells[i] + di];
+          if (!neighbors.empty()) {
+            neighbor_cell_callback(i_thread, search, neighbors);
+          }
+        }
+      });
+}
+
+template <>
+/// Specialization of iterate_cells_with_shifts, no shifts are needed
+void Grid<GridOptions::Normal>::iterate_cells_with_shifts(
+    const std::function<void(const ParticleList &)> &search_cell_callback,
+    const std::function<void(const ParticleList &, const ThreeVector &,
+                             const ParticleList &)> &neighbor_cell_callback)
+    const {
+  const ThreeVector no_shift;
+  iterate_cells(search_cell_callback, [&](const ParticleList &search,
+                                          const ParticleList &neighbors) {
+    neighbor_cell_callback(search, no_shift, neighbors);
+  });
 }
 
 /**
@@ -362,141 +894,262 @@ struct NeighborLookup {
   NeedsToWrap wrap = NeedsToWrap::No;
 };
 
-template <>
-/// Specialization of iterate_cells
-void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
-    const std::function<void(const ParticleList &)> &search_cell_callback,
-    const std::function<void(const ParticleList &, const ParticleList &)>
-        &neighbor_cell_callback) const {
-  std::array<SizeType, 3> search_index;
-  SizeType &x = search_index[0];
-  SizeType &y = search_index[1];
-  SizeType &z = search_index[2];
-  SizeType search_cell_index = 0;
+template <GridOptions O>
+template <typename S, typename N>
+void Grid<O>::visit_periodic_cell(SizeType offset,
+                                  const std::array<SizeType, 3> &search_index,
+                                  const S &search_cell_callback,
+                                  const N &neighbor_cell_callback) const {
+  const SizeType search_cell_index = offset + make_index(search_index);
+  assert(search_cell_index >= 0);
+  assert(search_cell_index < SizeType(cells_.size()));
+  const ParticleList &search = cells_[search_cell_index];
+  search_cell_callback(search);
 
-  // defaults:
+  /* In z, the neighbors are the cell itself and the next one. In x and y, the
+   * cell itself and the ones below and above, where the one that wraps around
+   * the boundary comes last. */
   std::array<NeighborLookup, 2> dz_list;
-  std::array<NeighborLookup, 3> dy_list;
-  std::array<NeighborLookup, 3> dx_list;
+  dz_list[0].index = search_index[2];
+  dz_list[1].index = search_index[2] + 1;
+  if (dz_list[1].index == number_of_cells_[2]) {
+    dz_list[1].index = 0;
+    dz_list[1].wrap = NeedsToWrap::MinusLength;
+  }
+  auto lookups_around = [&](int axis) {
+    const SizeType i = search_index[axis];
+    std::array<NeighborLookup, 3> list;
+    list[0].index = i;
+    list[1].index = i - 1;
+    list[2].index = i + 1;
+    if (i == 0) {
+      list[1] = list[2];
+      list[2].index = number_of_cells_[axis] - 1;
+      list[2].wrap = NeedsToWrap::PlusLength;
+    } else if (list[2].index == number_of_cells_[axis]) {
+      list[2].index = 0;
+      list[2].wrap = NeedsToWrap::MinusLength;
+    }
+    return list;
+  };
+  const std::array<NeighborLookup, 3> dy_list = lookups_around(1);
+  const std::array<NeighborLookup, 3> dx_list = lookups_around(0);
 
+  /* A wrapped neighbor is compared with the virtual position of the search
+   * cell beyond the boundary, such that every pair is visited once. */
+  auto apply_wrap = [&](const NeighborLookup &d, int axis,
+                        std::array<SizeType, 3> &virtual_search_index,
+                        ThreeVector &wrap_vector) {
+    if (d.wrap == NeedsToWrap::MinusLength) {
+      wrap_vector[axis] = -length_[axis];
+      virtual_search_index[axis] = -1;
+    } else if (d.wrap == NeedsToWrap::PlusLength) {
+      wrap_vector[axis] = length_[axis];
+      virtual_search_index[axis] = number_of_cells_[axis];
+    }
+  };
+  for (const auto &dz : dz_list) {
+    for (const auto &dy : dy_list) {
+      for (const auto &dx : dx_list) {
+        auto virtual_search_index = search_index;
+        ThreeVector wrap_vector = {};  // no change
+        apply_wrap(dx, 0, virtual_search_index, wrap_vector);
+        apply_wrap(dy, 1, virtual_search_index, wrap_vector);
+        apply_wrap(dz, 2, virtual_search_index, wrap_vector);
+        assert(dx.index >= 0);
+        assert(dx.index < number_of_cells_[0]);
+        assert(dy.index >= 0);
+        assert(dy.index < number_of_cells_[1]);
+        assert(dz.index >= 0);
+        assert(dz.index < number_of_cells_[2]);
+        const auto neighbor_cell_index =
+            make_index(dx.index, dy.index, dz.index);
+        if (neighbor_cell_index <= make_index(virtual_search_index)) {
+          continue;
+        }
+        neighbor_cell_callback(search, wrap_vector,
+                               cells_[offset + neighbor_cell_index]);
+      }
+    }
+  }
+}
+
+template <>
+/// Specialization of iterate_cells_with_shifts
+void Grid<GridOptions::PeriodicBoundaries>::iterate_cells_with_shifts(
+    const std::function<void(const ParticleList &)> &search_cell_callback,
+    const std::function<void(const ParticleList &, const ThreeVector &,
+                             const ParticleList &)> &neighbor_cell_callback)
+    const {
   assert(number_of_cells_[2] >= 2);
   assert(number_of_cells_[1] >= 2);
   assert(number_of_cells_[0] >= 2);
 
-  for (z = 0; z < number_of_cells_[2]; ++z) {
-    dz_list[0].index = z;
-    dz_list[1].index = z + 1;
-    if (dz_list[1].index == number_of_cells_[2]) {
-      dz_list[1].index = 0;
-      // last z in the loop, so no need to reset wrap again
-      dz_list[1].wrap = NeedsToWrap::MinusLength;
-    }
-    for (y = 0; y < number_of_cells_[1]; ++y) {
-      dy_list[0].index = y;
-      dy_list[1].index = y - 1;
-      dy_list[2].index = y + 1;
-      dy_list[2].wrap = NeedsToWrap::No;
-      if (y == 0) {
-        dy_list[1] = dy_list[2];
-        dy_list[2].index = number_of_cells_[1] - 1;
-        dy_list[2].wrap = NeedsToWrap::PlusLength;
-      } else if (dy_list[2].index == number_of_cells_[1]) {
-        dy_list[2].index = 0;
-        dy_list[2].wrap = NeedsToWrap::MinusLength;
-      }
-      for (x = 0; x < number_of_cells_[0]; ++x, ++search_cell_index) {
-        dx_list[0].index = x;
-        dx_list[1].index = x - 1;
-        dx_list[2].index = x + 1;
-        dx_list[2].wrap = NeedsToWrap::No;
-        if (x == 0) {
-          dx_list[1] = dx_list[2];
-          dx_list[2].index = number_of_cells_[0] - 1;
-          dx_list[2].wrap = NeedsToWrap::PlusLength;
-        } else if (dx_list[2].index == number_of_cells_[0]) {
-          dx_list[2].index = 0;
-          dx_list[2].wrap = NeedsToWrap::MinusLength;
+  std::array<SizeType, 3> search_index;
+  for (SizeType offset = 0; offset < SizeType(cells_.size());
+       offset += cells_per_layer()) {
+    for (search_index[2] = 0; search_index[2] < number_of_cells_[2];
+         ++search_index[2]) {
+      for (search_index[1] = 0; search_index[1] < number_of_cells_[1];
+           ++search_index[1]) {
+        for (search_index[0] = 0; search_index[0] < number_of_cells_[0];
+             ++search_index[0]) {
+          visit_periodic_cell(offset, search_index, search_cell_callback,
+                              neighbor_cell_callback);
         }
+      }
+    }
+  }
+}
 
-        assert(search_cell_index == make_index(search_index));
-        assert(search_cell_index >= 0);
-        assert(search_cell_index < SizeType(cells_.size()));
-        ParticleList search = cells_[search_cell_index];
-        search_cell_callback(search);
+template <>
+/// Specialization of iterate_cells, translating copies of the search cells
+void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
+    const std::function<void(const ParticleList &)> &search_cell_callback,
+    const std::function<void(const ParticleList &, const ParticleList &)>
+        &neighbor_cell_callback) const {
+  const ThreeVector no_shift;
+  ParticleList translated;
+  iterate_cells_with_shifts(
+      search_cell_callback,
+      [&](const ParticleList &search, const ThreeVector &shift,
+          const ParticleList &neighbors) {
+        if (shift == no_shift) {
+          neighbor_cell_callback(search, neighbors);
+          return;
+        }
+        translated.clear();
+        for (const ParticleData &p : search) {
+          translated.push_back(p.translated(shift));
+        }
+        neighbor_cell_callback(translated, neighbors);
+      });
+}
 
-        auto virtual_search_index = search_index;
-        ThreeVector wrap_vector = {};  // no change
-        auto current_wrap_vector = wrap_vector;
+template <>
+/// Specialization of iterate_cells_in_parallel
+void Grid<GridOptions::PeriodicBoundaries>::iterate_cells_in_parallel(
+    int n_threads,
+    const std::function<void(int, const ParticleList &)> &search_cell_callback,
+    const std::function<void(int, const ParticleList &, const ParticleList &)>
+        &neighbor_cell_callback) const {
+  /* In every direction, the cells get the colours 0, 1, 2 repeatedly and the
+   * up to two cells left over at the upper end the colours 3 and 4. */
+  std::array<SizeType, 3> n_colours_along;
+  for (int axis = 0; axis < 3; axis++) {
+    n_colours_along[axis] = 3 + number_of_cells_[axis] % 3;
+  }
+  auto colour_along = [&](SizeType i, int axis) {
+    const SizeType repeated = number_of_cells_[axis] / 3 * 3;
+    return i < repeated ? i % 3 : 3 + i - repeated;
+  };
+  const std::size_t n_colours =
+      n_colours_along[0] * n_colours_along[1] * n_colours_along[2];
+  std::vector<SizeType> colours(cells_per_layer());
+  std::vector<std::size_t> colour_begin(n_colours + 1, 0);
+  for (SizeType z = 0; z < number_of_cells_[2]; ++z) {
+    for (SizeType y = 0; y < number_of_cells_[1]; ++y) {
+      for (SizeType x = 0; x < number_of_cells_[0]; ++x) {
+        const SizeType colour =
+            (colour_along(z, 2) * n_colours_along[1] + colour_along(y, 1)) *
+                n_colours_along[0] +
+            colour_along(x, 0);
+        colours[make_index(x, y, z)] = colour;
+        colour_begin[colour + 1]++;
+      }
+    }
+  }
+  for (std::size_t colour = 0; colour < n_colours; colour++) {
+    colour_begin[colour + 1] += colour_begin[colour];
+  }
+  const std::size_t n_layers = cells_.size() / std::max(cells_per_layer(), 1);
+  for (std::size_t &begin : colour_begin) {
+    begin *= n_layers;
+  }
+  // The cells of all layers, sorted by colour
+  std::vector<SizeType> cells(colour_begin.back());
+  std::vector<std::size_t> next(colour_begin.begin(), colour_begin.end() - 1);
+  for (SizeType offset = 0; offset < SizeType(cells_.size());
+       offset += cells_per_layer()) {
+    for (SizeType index = 0; index < cells_per_layer(); ++index) {
+      cells[next[colours[index]]++] = offset + index;
+    }
+  }
 
-        for (const auto &dz : dz_list) {
-          if (dz.wrap == NeedsToWrap::MinusLength) {
-            // last dz in the loop, so no need to undo the wrap
-            wrap_vector[2] = -length_[2];
-            virtual_search_index[2] = -1;
-          }
-          for (const auto &dy : dy_list) {
-            // only the last dy in dy_list can wrap
-            if (dy.wrap == NeedsToWrap::MinusLength) {
-              wrap_vector[1] = -length_[1];
-              virtual_search_index[1] = -1;
-            } else if (dy.wrap == NeedsToWrap::PlusLength) {
-              wrap_vector[1] = length_[1];
-              virtual_search_index[1] = number_of_cells_[1];
-            }
-            for (const auto &dx : dx_list) {
-              // only the last dx in dx_list can wrap
-              if (dx.wrap == NeedsToWrap::MinusLength) {
-                wrap_vector[0] = -length_[0];
-                virtual_search_index[0] = -1;
-              } else if (dx.wrap == NeedsToWrap::PlusLength) {
-                wrap_vector[0] = length_[0];
-                virtual_search_index[0] = number_of_cells_[0];
+  const ThreeVector no_shift;
+  std::vector<ParticleList> translated(std::max(n_threads, 1));
+  process_colours_in_parallel(
+      n_threads, colour_begin, [&](int i_thread, std::size_t i) {
+        const SizeType offset =
+            cells[i] / cells_per_layer() * cells_per_layer();
+        const SizeType index = cells[i] - offset;
+        const std::array<SizeType, 3> search_index = {
+            index % number_of_cells_[0],
+            index / number_of_cells_[0] % number_of_cells_[1],
+            index / (number_of_cells_[0] * number_of_cells_[1])};
+        visit_periodic_cell(
+            offset, search_index,
+            [&](const ParticleList &search) {
+              search_cell_callback(i_thread, search);
+            },
+            [&](const ParticleList &search, const ThreeVector &shift,
+                const ParticleList &neighbors) {
+              // as for the normal grid, only pairs of non-empty cells
+              if (search.empty() || neighbors.empty()) {
+                return;
               }
-              assert(dx.index >= 0);
-              assert(dx.index < number_of_cells_[0]);
-              assert(dy.index >= 0);
-              assert(dy.index < number_of_cells_[1]);
-              assert(dz.index >= 0);
-              assert(dz.index < number_of_cells_[2]);
-              const auto neighbor_cell_index =
-                  make_index(dx.index, dy.index, dz.index);
-              assert(neighbor_cell_index >= 0);
-              assert(neighbor_cell_index < SizeType(cells_.size()));
-              if (neighbor_cell_index <= make_index(virtual_search_index)) {
-                continue;
+              if (shift == no_shift) {
+                neighbor_cell_callback(i_thread, search, neighbors);
+                return;
               }
-
-              if (wrap_vector != current_wrap_vector) {
-                logg[LGrid].debug("translating search cell by ",
-                                  wrap_vector - current_wrap_vector);
-                for_each(search, [&](ParticleData &p) {
-                  p = p.translated(wrap_vector - current_wrap_vector);
-                });
-                current_wrap_vector = wrap_vector;
+              ParticleList &translated_search = translated[i_thread];
+              translated_search.clear();
+              for (const ParticleData &p : search) {
+                translated_search.push_back(p.translated(shift));
               }
-              neighbor_cell_callback(search, cells_[neighbor_cell_index]);
-            }
-            virtual_search_index[0] = search_index[0];
-            wrap_vector[0] = 0;
-          }
-          virtual_search_index[1] = search_index[1];
-          wrap_vector[1] = 0;
-        }
-      }
+              neighbor_cell_callback(i_thread, translated_search, neighbors);
+            });
+      });
+}
+
+template <GridOptions O>
+GridStatistics Grid<O>::statistics() const {
+  GridStatistics stats;
+  if (cells_.empty()) {
+    return stats;
+  }
+  stats.cells = cells_.size();
+  stats.layers = n_layers_;
+  stats.volume = length_[0] * length_[1] * length_[2];
+  stats.cell_volume = cell_volume_;
+  stats.binned = binned_;
+  if (O == GridOptions::PeriodicBoundaries) {
+    // At least two cells in every direction
+    stats.max_cell_length =
+        0.5 * std::min({length_[0], length_[1], length_[2]});
+  }
+  const std::size_t layer_size = cells_.size() / n_layers_;
+  for (std::size_t first = 0; first < cells_.size(); first += layer_size) {
+    std::int64_t layer_particles = 0;
+    for (std::size_t i = first; i < first + layer_size; i++) {
+      layer_particles += cells_[i].size();
     }
+    stats.particles += layer_particles;
+    stats.single_cell_pairs += layer_particles * (layer_particles - 1) / 2;
   }
+  iterate_cells_with_shifts(
+      [&](const ParticleList &search) {
+        const std::int64_t n = search.size();
+        stats.pair_candidates += n * (n - 1) / 2;
+      },
+      [&](const ParticleList &search, const ThreeVector &,
+          const ParticleList &neighbors) {
+        stats.pair_candidates += static_cast<std::int64_t>(search.size()) *
+                                 static_cast<std::int64_t>(neighbors.size());
+      });
+  return stats;
 }
 
-template Grid<GridOptions::Normal>::Grid(
-    const std::pair<std::array<double, 3>, std::array<double, 3>>
-        &min_and_length,
-    const Particles &particles, double max_interaction_length,
-    double timestep_duration, CellNumberLimitation limit,
-    const bool include_unformed_particles, CellSizeStrategy strategy);
-template Grid<GridOptions::PeriodicBoundaries>::Grid(
-    const std::pair<std::array<double, 3>, std::array<double, 3>>
-        &min_and_length,
-    const Particles &particles, double max_interaction_length,
-    double timestep_duration, CellNumberLimitation limit,
-    const bool include_unformed_particles, CellSizeStrategy strategy);
+template class Grid<GridOptions::Normal>;
+template class Grid<GridOptions::PeriodicBoundaries>;
 }  // namespace smash
@@ -9,10 +9,17 @@
 
 #include "smash/hadgas_eos.h"
 
-#include <filesystem>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
 
 #include "gsl/gsl_sf_bessel.h"
 
@@ -20,6 +27,7 @@
 #include "smash/integrate.h"
 #include "smash/interpolation.h"
 #include "smash/logging.h"
+#include "smash/parallel.h"
 #include "smash/random.h"
 
 namespace smash {
@@ -31,132 +39,183 @@ EosTable::EosTable(double de, double dnb, double dq, size_t n_e, size_t n_nb,
   table_.resize(n_e_ * n_nb_ * n_q_);
 }
 
-void EosTable::compile_table(HadronGasEos &eos,
-                             const std::string &eos_savefile_name) {
-  bool table_read_success = false, table_consistency = true;
-  if (std::filesystem::exists(eos_savefile_name)) {
-    std::cout << "Reading table from file " << eos_savefile_name << std::endl;
-    std::ifstream file;
-    file.open(eos_savefile_name, std::ios::in);
-    file >> de_ >> dnb_ >> dq_;
-    file >> n_e_ >> n_nb_ >> n_q_;
-    table_.resize(n_e_ * n_nb_ * n_q_);
-    for (size_t ie = 0; ie < n_e_; ie++) {
-      for (size_t inb = 0; inb < n_nb_; inb++) {
-        for (size_t iq = 0; iq < n_q_; iq++) {
-          double p, T, mub, mus, muq;
-          file >> p >> T >> mub >> mus >> muq;
-          table_[index(ie, inb, iq)] = {p, T, mub, mus, muq};
-        }
-      }
+namespace {
+/// Magic number at the beginning of a binary EoS table
+constexpr char eos_table_magic[4] = {'S', 'M', 'E', 'T'};
+/// Version of the binary EoS table format
+constexpr std::uint32_t eos_table_version = 1;
+
+/**
+ * Add the bytes of a value to a hash.
+ *
+ * \param[inout] context Hash being computed.
+ * \param[in] x Value to add.
+ */
+template <typename T>
+void hash_value(sha256::Context &context, const T &x) {
+  context.update(reinterpret_cast<const std::uint8_t *>(&x), sizeof(T));
+}
+}  // namespace
+
+sha256::Hash EosTable::hash(const HadronGasEos &eos) const {
+  sha256::Context context;
+  context.update(std::string(eos_table_magic, 4));
+  hash_value(context, eos_table_version);
+  hash_value(context, de_);
+  hash_value(context, dnb_);
+  hash_value(context, dq_);
+  hash_value(context, static_cast<std::uint64_t>(n_e_));
+  hash_value(context, static_cast<std::uint64_t>(n_nb_));
+  hash_value(context, static_cast<std::uint64_t>(n_q_));
+  const bool w = eos.account_for_resonance_widths();
+  hash_value(context, w);
+  for (const ParticleType &ptype : ParticleType::list_all()) {
+    if (!HadronGasEos::is_eos_particle(ptype)) {
+      continue;
     }
-    table_read_success = true;
-    std::cout << "Table consumed successfully." << std::endl;
-  }
-
-  if (table_read_success) {
-    // Check if the saved table is consistent with the current particle table
-    std::cout << "Checking consistency of the table... " << std::endl;
-    constexpr size_t number_of_steps = 50;
-    const size_t ie_step = 1 + n_e_ / number_of_steps;
-    const size_t inb_step = 1 + n_nb_ / number_of_steps;
-    const size_t iq_step = 1 + n_q_ / number_of_steps;
-    for (size_t ie = 0; ie < n_e_; ie += ie_step) {
-      for (size_t inb = 0; inb < n_nb_; inb += inb_step) {
-        for (size_t iq = 0; iq < n_q_; iq += iq_step) {
-          const table_element x = table_[index(ie, inb, iq)];
-          const bool w = eos.account_for_resonance_widths();
-          const double e_comp = eos.energy_density(x.T, x.mub, x.mus, x.muq);
-          const double nb_comp =
-              eos.net_baryon_density(x.T, x.mub, x.mus, x.muq, w);
-          const double ns_comp =
-              eos.net_strange_density(x.T, x.mub, x.mus, x.muq, w);
-          const double p_comp = eos.pressure(x.T, x.mub, x.mus, x.muq, w);
-          const double nq_comp =
-              eos.net_charge_density(x.T, x.mub, x.mus, x.muq, w);
-          // Precision is just 10^-3, this is precision of saved data in the
-          // file
-          const double eps = 1.e-3;
-          // Only check the physical region, hence T > 0 condition
-          if ((std::abs(de_ * ie - e_comp) > eps ||
-               std::abs(dnb_ * inb - nb_comp) > eps ||
-               std::abs(ns_comp) > eps || std::abs(x.p - p_comp) > eps ||
-               std::abs(dq_ * iq - nq_comp) > eps) &&
-              (x.T > 0.0)) {
-            std::cout << "discrepancy: " << de_ * ie << " = " << e_comp << ", "
-                      << dnb_ * inb << " = " << nb_comp << ", " << x.p << " = "
-                      << p_comp << ", 0 = " << ns_comp << ", " << dq_ * iq
-                      << " = " << nq_comp << std::endl;
-            table_consistency = false;
-            goto finish_consistency_check;
-          }
-        }
-      }
+    context.update(ptype.pdgcode().string());
+    hash_value(context, ptype.mass());
+    if (w) {
+      hash_value(context, ptype.width_at_pole());
     }
   }
-finish_consistency_check:
-
-  if (!table_read_success || !table_consistency) {
-    std::cout << "Compiling an EoS table..." << std::endl;
-    const double ns = 0.0;
-    for (size_t ie = 0; ie < n_e_; ie++) {
-      std::cout << ie << "/" << n_e_ << "\r" << std::flush;
-      const double e = de_ * ie;
-      for (size_t inb = 0; inb < n_nb_; inb++) {
-        const double nb = dnb_ * inb;
-        for (size_t iq = 0; iq < n_q_; iq++) {
-          const double q = dq_ * iq;
-          // It is physically impossible to have energy density > nucleon
-          // mass*nb, therefore eqns have no solutions.
-          if (nb >= e || q >= e) {
-            table_[index(ie, inb, iq)] = {0.0, 0.0, 0.0, 0.0, 0.0};
-            continue;
-          }
-          // Take extrapolated (T, mub, mus, muq) as initial approximation
-          std::array<double, 4> init_approx;
-          if (inb >= 2) {
-            const table_element y = table_[index(ie, inb - 2, iq)];
-            const table_element x = table_[index(ie, inb - 1, iq)];
-            init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
-                           2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
-          } else if (iq >= 2) {
-            const table_element y = table_[index(ie, inb, iq - 2)];
-            const table_element x = table_[index(ie, inb, iq - 1)];
-            init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
-                           2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
-          } else {
-            init_approx = eos.solve_eos_initial_approximation(e, nb, q);
-          }
-          const std::array<double, 4> res =
-              eos.solve_eos(e, nb, ns, q, init_approx);
-          const double T = res[0];
-          const double mub = res[1];
-          const double mus = res[2];
-          const double muq = res[3];
-          const bool w = eos.account_for_resonance_widths();
-          table_[index(ie, inb, iq)] = {eos.pressure(T, mub, mus, muq, w), T,
-                                        mub, mus, muq};
-        }
+  return context.finalize();
+}
+
+bool EosTable::read(const std::string &filename, const sha256::Hash &hash) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  char magic[4];
+  std::uint32_t version;
+  sha256::Hash hash_from_file;
+  std::uint64_t n_elements;
+  file.read(magic, 4);
+  file.read(reinterpret_cast<char *>(&version), sizeof(version));
+  file.read(reinterpret_cast<char *>(hash_from_file.data()),
+            hash_from_file.size());
+  file.read(reinterpret_cast<char *>(&n_elements), sizeof(n_elements));
+  if (!file || std::memcmp(magic, eos_table_magic, 4) != 0 ||
+      version != eos_table_version || hash_from_file != hash ||
+      n_elements != table_.size()) {
+    logg[LResonances].info("The EoS table in ", filename,
+                           " does not match the current setup.");
+    return false;
+  }
+  std::vector<table_element> table(n_elements);
+  file.read(reinterpret_cast<char *>(table.data()),
+            n_elements * sizeof(table_element));
+  if (!file || file.peek() != std::ifstream::traits_type::eof()) {
+    logg[LResonances].warn("The EoS table in ", filename, " is damaged.");
+    return false;
+  }
+  table_ = std::move(table);
+  return true;
+}
+
+void EosTable::write(const std::string &filename,
+                     const sha256::Hash &hash) const {
+  /* The table is written to a temporary file first, so that another run
+   * reading the table never sees a partially written one. */
+  const std::string temporary_filename =
+      filename + "." + std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream file(temporary_filename, std::ios::binary);
+    const std::uint64_t n_elements = table_.size();
+    file.write(eos_table_magic, 4);
+    file.write(reinterpret_cast<const char *>(&eos_table_version),
+               sizeof(eos_table_version));
+    file.write(reinterpret_cast<const char *>(hash.data()), hash.size());
+    file.write(reinterpret_cast<const char *>(&n_elements),
+               sizeof(n_elements));
+    file.write(reinterpret_cast<const char *>(table_.data()),
+               n_elements * sizeof(table_element));
+    file.close();
+    if (!file) {
+      std::remove(temporary_filename.c_str());
+      throw std::runtime_error("Cannot write " + temporary_filename + ".");
+    }
+  }
+  if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+    std::remove(temporary_filename.c_str());
+    throw std::runtime_error("Cannot replace " + filename + ".");
+  }
+}
+
+void EosTable::compile_slice(const HadronGasEos &eos, size_t ie) {
+  const double ns = 0.0;
+  const double e = de_ * ie;
+  for (size_t inb = 0; inb < n_nb_; inb++) {
+    const double nb = dnb_ * inb;
+    for (size_t iq = 0; iq < n_q_; iq++) {
+      const double q = dq_ * iq;
+      // It is physically impossible to have energy density > nucleon
+      // mass*nb, therefore eqns have no solutions.
+      if (nb >= e || q >= e) {
+        table_[index(ie, inb, iq)] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        continue;
+      }
+      // Take extrapolated (T, mub, mus, muq) as initial approximation
+      std::array<double, 4> init_approx;
+      if (inb >= 2) {
+        const table_element y = table_[index(ie, inb - 2, iq)];
+        const table_element x = table_[index(ie, inb - 1, iq)];
+        init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
+                       2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
+      } else if (iq >= 2) {
+        const table_element y = table_[index(ie, inb, iq - 2)];
+        const table_element x = table_[index(ie, inb, iq - 1)];
+        init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
+                       2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
+      } else {
+        init_approx = eos.solve_eos_initial_approximation(e, nb, q);
       }
+      const std::array<double, 4> res =
+          eos.solve_eos(e, nb, ns, q, init_approx);
+      const double T = res[0];
+      const double mub = res[1];
+      const double mus = res[2];
+      const double muq = res[3];
+      const bool w = eos.account_for_resonance_widths();
+      table_[index(ie, inb, iq)] = {eos.pressure(T, mub, mus, muq, w), T, mub,
+                                    mus, muq};
     }
-    // Save table to file
-    std::cout << "Saving table to file " << eos_savefile_name << std::endl;
-    std::ofstream file;
-    file.open(eos_savefile_name, std::ios::out);
-    file << de_ << " " << dnb_ << " " << dq_ << std::endl;
-    file << n_e_ << " " << n_nb_ << " " << n_q_ << std::endl;
-    file << std::setprecision(7);
-    file << std::fixed;
-    for (size_t ie = 0; ie < n_e_; ie++) {
-      for (size_t inb = 0; inb < n_nb_; inb++) {
-        for (size_t iq = 0; iq < n_q_; iq++) {
-          const EosTable::table_element x = table_[index(ie, inb, iq)];
-          file << x.p << " " << x.T << " " << x.mub << " " << x.mus << " "
-               << x.muq << std::endl;
-        }
+  }
+}
+
+void EosTable::compile_table(const HadronGasEos &eos,
+                             const std::string &eos_savefile_name) {
+  const sha256::Hash table_hash = hash(eos);
+  if (read(eos_savefile_name, table_hash)) {
+    std::cout << "EoS table read from file " << eos_savefile_name << std::endl;
+    return;
+  }
+
+  std::cout << "Compiling an EoS table..." << std::endl;
+  const bool w = eos.account_for_resonance_widths();
+  if (w) {
+    // The spectral functions are normalized on first use, not thread-safely.
+    for (const ParticleType &ptype : ParticleType::list_all()) {
+      if (HadronGasEos::is_eos_particle(ptype) && !ptype.is_stable()) {
+        ptype.spectral_function(ptype.mass());
       }
     }
   }
+  std::atomic<size_t> n_done{0};
+  std::mutex progress_mutex;
+  parallel_for(default_thread_count(), n_e_, 1, [&](size_t ie) {
+    compile_slice(eos, ie);
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    std::cout << ++n_done << "/" << n_e_ << "\r" << std::flush;
+  });
+
+  std::cout << "Saving table to file " << eos_savefile_name << std::endl;
+  try {
+    write(eos_savefile_name, table_hash);
+  } catch (std::runtime_error &error) {
+    logg[LResonances].warn(error.what(), " The EoS table is not saved.");
+  }
 }
 
 void EosTable::get(EosTable::table_element &res, double e, double nb,
@@ -194,13 +253,48 @@ void EosTable::get(EosTable::table_element &res, double e, double nb,
   }
 }
 
+ScaledBesselTable::ScaledBesselTable() {
+  nodes_.resize(n_intervals_ + 1);
+  // The limits at z = 0, where the functions are 2 + 2z and z^2 to first order
+  nodes_[0] = {2.0, 2.0, 0.0, 0.0};
+  for (size_t i = 1; i <= n_intervals_; i++) {
+    const double z = i * dz_;
+    const double k2 = z * z * gsl_sf_bessel_Kn_scaled(2, z);
+    const double k1 = z * z * z * gsl_sf_bessel_K1_scaled(z);
+    const double k0 = z * z * z * gsl_sf_bessel_K0_scaled(z);
+    // From K_2' = -K_1 - 2 K_2 / z and K_1' = -K_0 - K_1 / z
+    nodes_[i] = {k2, k2 - k1 / z, k1, k1 * (1.0 + 2.0 / z) - k0};
+  }
+}
+
+const ScaledBesselTable &ScaledBesselTable::get() {
+  static const ScaledBesselTable table;
+  return table;
+}
+
+void ScaledBesselTable::evaluate(double z, double &k2, double &k1) const {
+  const double x = z / dz_;
+  if (!(x < n_intervals_)) {
+    k2 = z * z * gsl_sf_bessel_Kn_scaled(2, z);
+    k1 = z * z * z * gsl_sf_bessel_K1_scaled(z);
+    return;
+  }
+  const size_t i = static_cast<size_t>(x);
+  const double t = x - i;
+  const std::array<double, 4> &a = nodes_[i];
+  const std::array<double, 4> &b = nodes_[i + 1];
+  // Cubic Hermite basis, the derivative terms scaled by the grid spacing
+  const double s = 1.0 - t;
+  const double h00 = (1.0 + 2.0 * t) * s * s;
+  const double h10 = t * s * s * dz_;
+  const double h01 = t * t * (3.0 - 2.0 * t);
+  const double h11 = -t * t * s * dz_;
+  k2 = h00 * a[0] + h10 * a[1] + h01 * b[0] + h11 * b[1];
+  k1 = h00 * a[2] + h10 * a[3] + h01 * b[2] + h11 * b[3];
+}
+
 HadronGasEos::HadronGasEos(bool tabulate, bool account_for_width)
-    : x_(gsl_vector_alloc(n_equations_)),
-      tabulate_(tabulate),
-      account_for_resonance_widths_(account_for_width) {
-  const gsl_multiroot_fsolver_type *solver_type;
-  solver_type = gsl_multiroot_fsolver_hybrid;
-  solver_ = gsl_multiroot_fsolver_alloc(solver_type, n_equations_);
+    : tabulate_(tabulate), account_for_resonance_widths_(account_for_width) {
   if (tabulate_ && account_for_resonance_widths_) {
     logg[LResonances].error(
         "Compilation of hadron gas EoS table requested with"
@@ -210,14 +304,30 @@ HadronGasEos::HadronGasEos(bool tabulate, bool account_for_width)
         "implemented for energy density computation, so the computed"
         " table will be inconsistent anyways.");
   }
+}
+
+void HadronGasEos::from_table(EosTable::table_element &res, double e,
+                              double nb, double nq) const {
   if (tabulate_) {
-    eos_table_.compile_table(*this);
+    std::call_once(eos_table_compiled_,
+                   [this]() { eos_table_.compile_table(*this); });
   }
+  eos_table_.get(res, e, nb, nq);
+}
+
+HadronGasEos::SolverContext::SolverContext()
+    : x(gsl_vector_alloc(n_equations_)),
+      solver(gsl_multiroot_fsolver_alloc(gsl_multiroot_fsolver_hybrid,
+                                         n_equations_)) {}
+
+HadronGasEos::SolverContext::~SolverContext() {
+  gsl_multiroot_fsolver_free(solver);
+  gsl_vector_free(x);
 }
 
-HadronGasEos::~HadronGasEos() {
-  gsl_multiroot_fsolver_free(solver_);
-  gsl_vector_free(x_);
+HadronGasEos::SolverContext &HadronGasEos::solver_context() {
+  thread_local SolverContext context;
+  return context;
 }
 
 double HadronGasEos::scaled_partial_density_auxiliary(double m_over_T,
@@ -231,7 +341,7 @@ double HadronGasEos::scaled_partial_density_auxiliary(double m_over_T,
   // z*z*K_2(z) -> 2
   return (m_over_T < really_small)
              ? 2.0 * x
-             : m_over_T * m_over_T * x * gsl_sf_bessel_Kn_scaled(2, m_over_T);
+             : x * ScaledBesselTable::get().density_factor(m_over_T);
 }
 
 double HadronGasEos::scaled_partial_density(const ParticleType &ptype,
@@ -284,6 +394,7 @@ double HadronGasEos::energy_density(double T, double mub, double mus,
     return 0.0;
   }
   const double beta = 1.0 / T;
+  const ScaledBesselTable &bessel = ScaledBesselTable::get();
   double e = 0.0;
   for (const ParticleType &ptype : ParticleType::list_all()) {
     if (!is_eos_particle(ptype)) {
@@ -298,10 +409,7 @@ double HadronGasEos::energy_density(double T, double mub, double mus,
     x = std::exp(x);
     const size_t g = ptype.spin() + 1;
     // Small mass case, z*z*K_2(z) -> 2, z*z*z*K_1(z) -> 0 at z->0
-    e += (z < really_small) ? 3.0 * g * x
-                            : z * z * g * x *
-                                  (3.0 * gsl_sf_bessel_Kn_scaled(2, z) +
-                                   z * gsl_sf_bessel_K1_scaled(z));
+    e += (z < really_small) ? 3.0 * g * x : g * x * bessel.energy_factor(z);
   }
   e *= prefactor_ * T * T * T * T;
   return e;
@@ -396,6 +504,12 @@ double HadronGasEos::sample_mass_thermal(const ParticleType &ptype,
   //    the ratio f(x)/f(xmin) is used.
 
   const double max_mass = 5.0;  // GeV
+  const ScaledBesselTable &bessel = ScaledBesselTable::get();
+  // m^2 exp(-beta m) K_2(beta m)
+  auto thermal_factor = [&bessel, beta](double m) {
+    return std::exp(-beta * m) * bessel.density_factor(beta * m) /
+           (beta * beta);
+  };
   double m, q;
   {
     // Allow underflows in exponentials
@@ -403,9 +517,8 @@ double HadronGasEos::sample_mass_thermal(const ParticleType &ptype,
     const double w0 = ptype.width_at_pole();
     const double mth = ptype.min_mass_spectral();
     const double m0 = ptype.mass();
-    double max_ratio =
-        m0 * m0 * std::exp(-beta * m0) * gsl_sf_bessel_Kn_scaled(2, m0 * beta) *
-        ptype.spectral_function(m0) / ptype.spectral_function_simple(m0);
+    double max_ratio = thermal_factor(m0) * ptype.spectral_function(m0) /
+                       ptype.spectral_function_simple(m0);
     // Heuristic adaptive maximum search to find max_ratio
     constexpr int npoints = 31;
     double m_lower = mth, m_upper = max_mass, m_where_max = m0;
@@ -414,9 +527,7 @@ double HadronGasEos::sample_mass_thermal(const ParticleType &ptype,
       const double dm = (m_upper - m_lower) / npoints;
       for (size_t i = 1; i < npoints; i++) {
         m = m_lower + dm * i;
-        const double thermal_factor =
-            m * m * std::exp(-beta * m) * gsl_sf_bessel_Kn_scaled(2, m * beta);
-        q = ptype.spectral_function(m) * thermal_factor /
+        q = ptype.spectral_function(m) * thermal_factor(m) /
             ptype.spectral_function_simple(m);
         if (q > max_ratio) {
           max_ratio = q;
@@ -433,9 +544,7 @@ double HadronGasEos::sample_mass_thermal(const ParticleType &ptype,
       // sample mass from A(m)
       do {
         m = random::cauchy(m0, 0.5 * w0, mth, max_mass);
-        const double thermal_factor =
-            m * m * std::exp(-beta * m) * gsl_sf_bessel_Kn_scaled(2, m * beta);
-        q = ptype.spectral_function(m) * thermal_factor /
+        q = ptype.spectral_function(m) * thermal_factor(m) /
             ptype.spectral_function_simple(m);
       } while (q < random::uniform(0., max_ratio));
       if (q > max_ratio) {
@@ -503,9 +612,8 @@ double HadronGasEos::e_equation(double T, void *params) {
   return edens - energy_density(T, 0.0, 0.0, 0.0);
 }
 
-std::array<double, 4> HadronGasEos::solve_eos_initial_approximation(double e,
-                                                                    double nb,
-                                                                    double nq) {
+std::array<double, 4> HadronGasEos::solve_eos_initial_approximation(
+    double e, double nb, double nq) const {
   assert(e >= 0.0);
   // 1. Get temperature from energy density assuming zero chemical potentials
   int degeneracies_sum = 0.0;
@@ -585,7 +693,10 @@ std::array<double, 4> HadronGasEos::solve_eos_initial_approximation(double e,
 
 std::array<double, 4> HadronGasEos::solve_eos(
     double e, double nb, double ns, double nq,
-    std::array<double, 4> initial_approximation) {
+    std::array<double, 4> initial_approximation) const {
+  SolverContext &context = solver_context();
+  gsl_vector *x = context.x;
+  gsl_multiroot_fsolver *solver = context.solver;
   int residual_status = GSL_SUCCESS;
   size_t iter = 0;
 
@@ -593,19 +704,19 @@ std::array<double, 4> HadronGasEos::solve_eos(
   gsl_multiroot_function f = {&HadronGasEos::set_eos_solver_equations,
                               n_equations_, &p};
 
-  gsl_vector_set(x_, 0, initial_approximation[0]);
-  gsl_vector_set(x_, 1, initial_approximation[1]);
-  gsl_vector_set(x_, 2, initial_approximation[2]);
-  gsl_vector_set(x_, 3, initial_approximation[3]);
+  gsl_vector_set(x, 0, initial_approximation[0]);
+  gsl_vector_set(x, 1, initial_approximation[1]);
+  gsl_vector_set(x, 2, initial_approximation[2]);
+  gsl_vector_set(x, 3, initial_approximation[3]);
 
-  gsl_multiroot_fsolver_set(solver_, &f, x_);
+  gsl_multiroot_fsolver_set(solver, &f, x);
   do {
     iter++;
-    const auto iterate_status = gsl_multiroot_fsolver_iterate(solver_);
-    // std::cout << print_solver_state(iter);
+    const auto iterate_status = gsl_multiroot_fsolver_iterate(solver);
+    // std::cout << print_solver_state(solver, iter);
 
     // Avoiding too low temperature
-    if (gsl_vector_get(solver_->x, 0) < 0.015) {
+    if (gsl_vector_get(solver->x, 0) < 0.015) {
       return {0.0, 0.0, 0.0, 0.0};
     }
 
@@ -613,7 +724,7 @@ std::array<double, 4> HadronGasEos::solve_eos(
     if (iterate_status) {
       break;
     }
-    residual_status = gsl_multiroot_test_residual(solver_->f, tolerance_);
+    residual_status = gsl_multiroot_test_residual(solver->f, tolerance_);
   } while (residual_status == GSL_CONTINUE && iter < 1000);
 
   if (residual_status != GSL_SUCCESS) {
@@ -626,25 +737,27 @@ std::array<double, 4> HadronGasEos::solve_eos(
                       << initial_approximation[2] << " "
                       << initial_approximation[3] << std::endl;
     logg[LResonances].warn(gsl_strerror(residual_status) +
-                           solver_parameters.str() + print_solver_state(iter));
+                           solver_parameters.str() +
+                           print_solver_state(solver, iter));
   }
 
-  return {gsl_vector_get(solver_->x, 0), gsl_vector_get(solver_->x, 1),
-          gsl_vector_get(solver_->x, 2), gsl_vector_get(solver_->x, 3)};
+  return {gsl_vector_get(solver->x, 0), gsl_vector_get(solver->x, 1),
+          gsl_vector_get(solver->x, 2), gsl_vector_get(solver->x, 3)};
 }
 
-std::string HadronGasEos::print_solver_state(size_t iter) const {
+std::string HadronGasEos::print_solver_state(
+    const gsl_multiroot_fsolver *solver, size_t iter) {
   std::stringstream s;
   // clang-format off
   s << "iter = " << iter << ","
-    << " x = " << gsl_vector_get(solver_->x, 0) << " "
-               << gsl_vector_get(solver_->x, 1) << " "
-               << gsl_vector_get(solver_->x, 2) << ", "
-               << gsl_vector_get(solver_->x, 3) << ", "
-    << "f(x) = " << gsl_vector_get(solver_->f, 0) << " "
-                 << gsl_vector_get(solver_->f, 1) << " "
-                 << gsl_vector_get(solver_->f, 2) << " "
-                 << gsl_vector_get(solver_->f, 3) << std::endl;
+    << " x = " << gsl_vector_get(solver->x, 0) << " "
+               << gsl_vector_get(solver->x, 1) << " "
+               << gsl_vector_get(solver->x, 2) << ", "
+               << gsl_vector_get(solver->x, 3) << ", "
+    << "f(x) = " << gsl_vector_get(solver->f, 0) << " "
+                 << gsl_vector_get(solver->f, 1) << " "
+                 << gsl_vector_get(solver->f, 2) << " "
+                 << gsl_vector_get(solver->f, 3) << std::endl;
   // clang-format on
   return s.str();
 }
@@ -10,6 +10,8 @@
 
 #include "smash/hepmcinterface.h"
 
+#include <algorithm>
+
 #include "HepMC3/GenRunInfo.h"
 #include "HepMC3/Print.h"
 #include "HepMC3/Setup.h"
@@ -20,13 +22,15 @@
 
 namespace smash {
 
-HepMcInterface::HepMcInterface(const std::string& name, const bool full_event)
+HepMcInterface::HepMcInterface(const std::string& name, const bool full_event,
+                               const double min_elastic_sqrts)
     : OutputInterface(name),
       event_(HepMC3::Units::GEV, HepMC3::Units::MM),
       ion_(),
       xs_(),
       ip_(),
-      full_event_(full_event) {
+      full_event_(full_event),
+      min_elastic_sqrts_(min_elastic_sqrts) {
   logg[LOutput].debug() << "Name of output: " << name << " "
                         << (full_event_ ? "full event" : "final state only")
                         << " output" << std::endl;
@@ -132,6 +136,26 @@ void HepMcInterface::at_interaction(const Action& action,
   auto type = action.get_type();
   int status = get_status(type);
 
+  if (full_event_ && type == ProcessType::Elastic &&
+      action.sqrt_s() < min_elastic_sqrts_) {
+    const ParticleList& incoming = action.incoming_particles();
+    const ParticleList& outgoing = action.outgoing_particles();
+    const bool all_registered = std::all_of(
+        incoming.begin(), incoming.end(),
+        [this](const ParticleData& p) { return map_.count(p.id()) > 0; });
+    if (all_registered && incoming.size() == outgoing.size()) {
+      // The outgoing particles of an elastic scattering are in the same order
+      for (std::size_t i = 0; i < incoming.size(); i++) {
+        HepMC3::GenParticlePtr gen = map_[incoming[i].id()];
+        const FourVector mom = outgoing[i].momentum();
+        gen->set_momentum(
+            HepMC3::FourVector(mom.x1(), mom.x2(), mom.x3(), mom.x0()));
+        map_[outgoing[i].id()] = gen;
+      }
+      return;
+    }
+  }
+
   if (full_event_) {
     FourVector v = action.get_interaction_point();
     vp = std::make_shared<HepMC3::GenVertex>(
@@ -193,8 +217,9 @@ void HepMcInterface::at_eventend(const Particles& particles,
   // Take all passed particles and add as outgoing particles to event
   for (auto& p : particles) {
     if (!full_event_) {
-      auto h = make_register(p, Status::fnal);
-      ip_->add_particle_out(h);
+      // Nothing refers to the final particles, so they are not registered.
+      ip_->add_particle_out(make_gen(p.pdgcode().get_decimal(), Status::fnal,
+                                     p.momentum(), p.type().mass()));
     } else if (map_.find(p.id()) == map_.end()) {
       throw std::runtime_error("Dangling particle " + std::to_string(p.id()));
     }
@@ -202,8 +227,12 @@ void HepMcInterface::at_eventend(const Particles& particles,
 }
 
 void HepMcInterface::clear() {
+  max_particles_ = std::max(max_particles_, event_.particles().size());
+  max_vertices_ = std::max(max_vertices_, event_.vertices().size());
   event_.clear();
+  event_.reserve(max_particles_, max_vertices_);
   map_.clear();
+  map_.reserve(max_particles_);
   ip_ = 0;
   coll_ = 0;
   ncoll_ = 0;
@@ -9,6 +9,9 @@
 
 #include "smash/hepmcoutput.h"
 
+#include <stdexcept>
+#include <utility>
+
 #include "HepMC3/Print.h"
 #include "HepMC3/WriterAscii.h"
 
@@ -63,6 +66,11 @@ namespace smash {
  * - Even though in the HepMC library root and treeroot outputs are distinct, in
  *   SMASH the extension of the HepMC treeroot output is simply .root because
  *   the ROOT browser tool does not recognize the .treeroot extension.
+ * - With the \key HepMC_Batch_Size option, the events are written on a
+ *   writer thread of the output while the next events are simulated.
+ * - With the \key HepMC_Min_Elastic_Sqrts option of the \key Collisions
+ *   content, soft elastic scatterings are not written as vertices. The
+ *   scattered particles then carry their momenta after the scattering.
  *
  * \section output_particles_collisions_ Particles and Collisions
  *
@@ -248,9 +256,12 @@ namespace smash {
 
 // clang-format on
 HepMcOutput::HepMcOutput(const std::filesystem::path &path, std::string name,
-                         const bool full_event, std::string HepMC3_output_type)
-    : HepMcInterface(name, full_event),
-      filename_(path / (name + "." + HepMC3_output_type)) {
+                         const bool full_event, std::string HepMC3_output_type,
+                         const std::size_t batch_size,
+                         const double min_elastic_sqrts)
+    : HepMcInterface(name, full_event, min_elastic_sqrts),
+      filename_(path / (name + "." + HepMC3_output_type)),
+      batch_size_(batch_size) {
   filename_unfinished_ = filename_;
   filename_unfinished_ += +".unfinished";
 #ifdef SMASH_USE_HEPMC_ROOTIO
@@ -266,8 +277,26 @@ HepMcOutput::HepMcOutput(const std::filesystem::path &path, std::string name,
     output_type_ = treeroot;
   }
 #endif
+  if (batch_size_ > 0) {
+    writer_ = std::thread(&HepMcOutput::write_loop, this);
+  }
 }
 HepMcOutput::~HepMcOutput() {
+  if (writer_.joinable()) {
+    {
+      std::lock_guard lock(mutex_);
+      if (batch_.size > 0) {
+        pending_.push_back(std::move(batch_));
+      }
+      stop_ = true;
+    }
+    batch_submitted_.notify_one();
+    writer_.join();
+    if (error_) {
+      logg[LOutput].error("Writing the HepMC output ", filename_unfinished_,
+                          " failed on its writer thread.");
+    }
+  }
   logg[LOutput].debug() << "Renaming file " << filename_unfinished_ << " to "
                         << filename_ << std::endl;
   output_file_->close();
@@ -282,7 +311,75 @@ void HepMcOutput::at_eventend(const Particles &particles,
                         << event_.particles().size() << " particles and "
                         << event_.vertices().size() << " vertices to output "
                         << std::endl;
-  output_file_->write_event(event_);
+  if (batch_size_ == 0) {
+    output_file_->write_event(event_);
+    return;
+  }
+  if (batch_.size == batch_.events.size()) {
+    batch_.events.emplace_back();
+  }
+  event_.write_data(batch_.events[batch_.size++]);
+  if (batch_.size == batch_size_) {
+    submit_batch();
+  }
+}
+
+void HepMcOutput::submit_batch() {
+  std::unique_lock lock(mutex_);
+  batch_written_.wait(lock, [this] {
+    return pending_.size() < max_pending_batches || error_;
+  });
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  pending_.push_back(std::move(batch_));
+  if (recycled_.empty()) {
+    batch_ = Batch{};
+  } else {
+    batch_ = std::move(recycled_.back());
+    recycled_.pop_back();
+  }
+  lock.unlock();
+  batch_submitted_.notify_one();
+}
+
+void HepMcOutput::write_loop() {
+  // Event of the writer thread, restored from the flattened events
+  HepMC3::GenEvent event(HepMC3::Units::GEV, HepMC3::Units::MM);
+  event.set_run_info(event_.run_info());
+  std::unique_lock lock(mutex_);
+  while (true) {
+    batch_submitted_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      return;
+    }
+    Batch batch = std::move(pending_.front());
+    pending_.pop_front();
+    const bool failed = static_cast<bool>(error_);
+    lock.unlock();
+    // After a failure, the remaining batches are only recycled.
+    std::exception_ptr error;
+    if (!failed) {
+      try {
+        for (std::size_t i = 0; i < batch.size; i++) {
+          event.read_data(batch.events[i]);
+          output_file_->write_event(event);
+        }
+        if (output_file_->failed()) {
+          throw std::runtime_error("The HepMC writer failed.");
+        }
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    batch.size = 0;
+    lock.lock();
+    if (error) {
+      error_ = error;
+    }
+    recycled_.push_back(std::move(batch));
+    batch_written_.notify_one();
+  }
 }
 
 }  // namespace smash
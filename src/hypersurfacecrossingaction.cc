@@ -54,9 +54,8 @@ ActionList HyperSurfaceCrossActionsFinder::find_actions_in_cell(
   std::vector<ActionPtr> actions;
 
   for (const ParticleData &p : plist) {
-    ParticleData pdata_before_propagation = p;
-    ParticleData pdata_after_propagation = p;  // Will receive updated position
-    double t0 = p.position().x0();
+    const FourVector position_before = p.position();
+    double t0 = position_before.x0();
     double t_end = t0 + dt;  // Time at the end of timestep
 
     // We don't want to remove particles before the nuclei have interacted
@@ -91,13 +90,14 @@ ActionList HyperSurfaceCrossActionsFinder::find_actions_in_cell(
     // propagate particles to position where they would be at the end of the
     // time step (after dt)
     const FourVector distance = FourVector(0.0, v * dt);
-    FourVector position = p.position() + distance;
-    position.set_x0(t_end);
-    // update coordinates to the position corresponding to t_end
-    pdata_after_propagation.set_4position(position);
+    FourVector position_after = position_before + distance;
+    position_after.set_x0(t_end);
 
-    bool hypersurface_is_crossed = crosses_hypersurface(
-        pdata_before_propagation, pdata_after_propagation, prop_time_);
+    /* Most particles do not cross the hypersurface in a given time step, so
+       this cheap test comes before the kinematic cuts below. */
+    if (!crosses_hypersurface(position_before, position_after, prop_time_)) {
+      continue;
+    }
 
     /*
        If rapidity or transverse momentum cut is to be employed; check if
@@ -108,71 +108,61 @@ ActionList HyperSurfaceCrossActionsFinder::find_actions_in_cell(
        crashes with a corresponding error message. The same applies to negtive
        values.
     */
-    bool is_within_y_cut = true;
     // Check whether particle is in desired rapidity range
     if (rap_cut_ > 0.0) {
       const double rapidity =
           0.5 * std::log((p.momentum().x0() + p.momentum().x3()) /
                          (p.momentum().x0() - p.momentum().x3()));
       if (std::fabs(rapidity) > rap_cut_) {
-        is_within_y_cut = false;
+        continue;
       }
     }
 
-    bool is_within_pT_cut = true;
     // Check whether particle is in desired pT range
     if (pT_cut_ > 0.0) {
       const double transverse_momentum =
           std::sqrt(p.momentum().x1() * p.momentum().x1() +
                     p.momentum().x2() * p.momentum().x2());
       if (transverse_momentum > pT_cut_) {
-        is_within_pT_cut = false;
+        continue;
       }
     }
 
-    if (hypersurface_is_crossed && is_within_y_cut && is_within_pT_cut) {
-      // Get exact coordinates where hypersurface is crossed
-      FourVector crossing_position = coordinates_on_hypersurface(
-          pdata_before_propagation, pdata_after_propagation, prop_time_);
+    // Get exact coordinates where hypersurface is crossed
+    FourVector crossing_position = coordinates_on_hypersurface(
+        position_before, position_after, p.velocity(), prop_time_);
 
-      double time_until_crossing = crossing_position[0] - t0;
+    double time_until_crossing = crossing_position[0] - t0;
 
-      ParticleData outgoing_particle(p);
-      outgoing_particle.set_4position(crossing_position);
-      ActionPtr action = std::make_unique<HypersurfacecrossingAction>(
-          p, outgoing_particle, time_until_crossing);
-      actions.emplace_back(std::move(action));
-    }
+    ParticleData outgoing_particle(p);
+    outgoing_particle.set_4position(crossing_position);
+    ActionPtr action = std::make_unique<HypersurfacecrossingAction>(
+        p, outgoing_particle, time_until_crossing);
+    actions.emplace_back(std::move(action));
   }
   return actions;
 }
 
 bool HyperSurfaceCrossActionsFinder::crosses_hypersurface(
-    ParticleData &pdata_before_propagation,
-    ParticleData &pdata_after_propagation, const double tau) const {
+    const FourVector &position_before, const FourVector &position_after,
+    const double tau) const {
   bool hypersurface_is_crossed = false;
   const bool t_greater_z_before_prop =
-      (std::fabs(pdata_before_propagation.position().x0()) >
-               std::fabs(pdata_before_propagation.position().x3())
-           ? true
-           : false);
+      std::fabs(position_before.x0()) > std::fabs(position_before.x3());
   const bool t_greater_z_after_prop =
-      (std::fabs(pdata_after_propagation.position().x0()) >
-               std::fabs(pdata_after_propagation.position().x3())
-           ? true
-           : false);
+      std::fabs(position_after.x0()) > std::fabs(position_after.x3());
 
   if (t_greater_z_before_prop && t_greater_z_after_prop) {
     // proper time before and after propagation
-    const double tau_before = pdata_before_propagation.position().tau();
-    const double tau_after = pdata_after_propagation.position().tau();
+    const double tau_before = position_before.tau();
+    const double tau_after = position_after.tau();
 
     if (tau_before <= tau && tau <= tau_after) {
       hypersurface_is_crossed = true;
     }
   } else if (!t_greater_z_before_prop && t_greater_z_after_prop) {
     // proper time after propagation
-    const double tau_after = pdata_after_propagation.position().tau();
+    const double tau_after = position_after.tau();
     if (tau_after >= tau) {
       hypersurface_is_crossed = true;
     }
@@ -182,15 +172,15 @@ bool HyperSurfaceCrossActionsFinder::crosses_hypersurface(
 }
 
 FourVector HyperSurfaceCrossActionsFinder::coordinates_on_hypersurface(
-    ParticleData &pdata_before_propagation,
-    ParticleData &pdata_after_propagation, const double tau) const {
+    const FourVector &position_before, const FourVector &position_after,
+    const ThreeVector &velocity, const double tau) const {
   // find t and z at start of propagation
-  const double t1 = pdata_before_propagation.position().x0();
-  const double z1 = pdata_before_propagation.position().x3();
+  const double t1 = position_before.x0();
+  const double z1 = position_before.x3();
 
   // find t and z after propagation
-  const double t2 = pdata_after_propagation.position().x0();
-  const double z2 = pdata_after_propagation.position().x3();
+  const double t2 = position_after.x0();
+  const double z2 = position_after.x3();
 
   // find slope and intercept of linear function that describes propagation on
   // straight line
@@ -209,9 +199,8 @@ FourVector HyperSurfaceCrossActionsFinder::coordinates_on_hypersurface(
   assert(!(sol2 >= t1 && sol2 <= t2));
 
   // Propagate to point where hypersurface is crossed
-  const ThreeVector v = pdata_before_propagation.velocity();
-  const FourVector distance = FourVector(0.0, v * (sol1 - t1));
-  FourVector crossing_position = pdata_before_propagation.position() + distance;
+  const FourVector distance = FourVector(0.0, velocity * (sol1 - t1));
+  FourVector crossing_position = position_before + distance;
   crossing_position.set_x0(sol1);
 
   return crossing_position;
@@ -0,0 +1,65 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/iccallbackoutput.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "smash/action.h"
+
+namespace smash {
+
+ICCallbackOutput::ICCallbackOutput(Callback callback)
+    : OutputInterface("SMASH_IC"), callback_(std::move(callback)) {
+  if (!callback_) {
+    throw std::invalid_argument("No function given to ICCallbackOutput.");
+  }
+}
+
+void ICCallbackOutput::at_eventstart(const Particles &, const int,
+                                     const EventInfo &) {
+  // The ensembles of the next event start once all previous ones ended.
+  if (n_ended_ == particles_.size()) {
+    particles_.clear();
+    n_ended_ = 0;
+  }
+  particles_.emplace_back();
+}
+
+void ICCallbackOutput::at_eventend(const Particles &, const int event_number,
+                                   const EventInfo &info) {
+  if (n_ended_ >= particles_.size()) {
+    throw std::logic_error("Event of ICCallbackOutput ended without start.");
+  }
+  callback_(particles_[n_ended_], event_number, info);
+  ParticleList().swap(particles_[n_ended_]);
+  n_ended_++;
+}
+
+void ICCallbackOutput::at_interaction(const Action &action,
+                                      const double density) {
+  at_ensemble_interaction(action, density, 0);
+}
+
+void ICCallbackOutput::at_ensemble_interaction(const Action &action,
+                                               const double,
+                                               const int i_ensemble) {
+  if (action.get_type() != ProcessType::HyperSurfaceCrossing) {
+    return;
+  }
+  if (static_cast<std::size_t>(i_ensemble) >= particles_.size()) {
+    throw std::logic_error("Interaction of ICCallbackOutput before event.");
+  }
+  const ParticleList &incoming = action.incoming_particles();
+  particles_[i_ensemble].insert(particles_[i_ensemble].end(), incoming.begin(),
+                                incoming.end());
+}
+
+}  // namespace smash
@@ -14,6 +14,7 @@
 #include <utility>
 #include <vector>
 
+#include "blockcache.h"
 #include "lattice.h"
 #include "particles.h"
 #include "pauliblocking.h"
@@ -31,19 +32,23 @@ static constexpr int LAction = LogArea::Action::id;
  * Currently such an action can be either a decay, a two-body collision, a
  * wallcrossing or a thermalization.
  * (see derived classes).
+ *
+ * Actions are allocated via the BlockCache, since most of them are
+ * destroyed within the time step they were found in.
  */
-class Action {
+class Action : public CacheAllocated {
  public:
   /**
    * Construct an action object with incoming particles and relative time.
    *
-   * \param[in] in_part list of incoming particles
+   * \param[in] in_part list of incoming particles, which is moved into the
+   *                    action
    * \param[in] time time at which the action is supposed to take place
    *                 (relative to the current time of the incoming particles)
    */
-  Action(const ParticleList &in_part, double time)
-      : incoming_particles_(in_part),
-        time_of_execution_(time + in_part[0].position().x0()) {}
+  Action(ParticleList in_part, double time)
+      : incoming_particles_(std::move(in_part)),
+        time_of_execution_(time + incoming_particles_[0].position().x0()) {}
 
   /**
    * Construct an action object with the incoming particles, relative time, and
@@ -72,7 +77,7 @@ class Action {
    *                                             supposed to take place
    * \param[in] type type of the interaction
    */
-  Action(const ParticleList &in_part, const ParticleList &out_part,
+  Action(ParticleList in_part, ParticleList out_part,
          double absolute_execution_time, ProcessType type)
       : incoming_particles_(std::move(in_part)),
         outgoing_particles_(std::move(out_part)),
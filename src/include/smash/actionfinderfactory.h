@@ -15,7 +15,9 @@
 #include "clock.h"
 #include "forwarddeclarations.h"
 #include "lattice.h"
+#include "particledata.h"
 #include "potentials.h"
+#include "threevector.h"
 
 namespace smash {
 
@@ -61,6 +63,71 @@ class ActionFinderInterface {
       const ParticleList &search_list, const ParticleList &neighbors_list,
       double dt, const std::vector<FourVector> &beam_momentum) const = 0;
 
+  /**
+   * Find actions between a search list and a neighbors list, where the
+   * particles of the search list have to be translated by a shift to be close
+   * to the neighbors, as across the boundaries of a periodic box.
+   *
+   * The default implementation translates a copy of the search list and calls
+   * find_actions_with_neighbors. Finders can avoid this copy by applying the
+   * shift on the fly.
+   *
+   * \param[in] search_list a list of particles where each particle needs to
+   *                  be tested for possible interactions with the neighbors
+   * \param[in] shift translation of the search list particles towards the
+   *                  neighbors [fm]
+   * \param[in] neighbors_list a list of particles that need to be tested
+   *                  against particles in search_list for possible interaction
+   * \param[in] dt duration of the current time step [fm]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   * 
+eturn The function returns a list (std::vector) of Action objects that
+   *         could possibly be executed in this time step.
+   */
+  virtual ActionList find_actions_with_shifted_neighbors(
+      const ParticleList &search_list, const ThreeVector &shift,
+      const ParticleList &neighbors_list, double dt,
+      const std::vector<FourVector> &beam_momentum) const {
+    if (shift == ThreeVector()) {
+      return find_actions_with_neighbors(search_list, neighbors_list, dt,
+                                         beam_momentum);
+    }
+    ParticleList translated;
+    translated.reserve(search_list.size());
+    for (const ParticleData &p : search_list) {
+      translated.push_back(p.translated(shift));
+    }
+    return find_actions_with_neighbors(translated, neighbors_list, dt,
+                                       beam_momentum);
+  }
+
+  /**
+   * Find actions within a cell, whose members taking part in multi-particle
+   * reactions were already listed when the grid was built, see
+   * Grid::set_member_selection.
+   *
+   * The default implementation ignores the members and calls
+   * find_actions_in_cell.
+   *
+   * \param[in] search_list a list of particles where each pair needs to be
+   *                  tested for possible interaction
+   * \param[in] members the particles of \p search_list which can take part
+   *                  in multi-particle reactions
+   * \param[in] dt duration of the current time step [fm]
+   * \param[in] gcell_vol volume of searched grid cell [fm^3]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   * \return The function returns a list (std::vector) of Action objects that
+   *         could possibly be executed in this time step.
+   */
+  virtual ActionList find_actions_in_cell_with_members(
+      const ParticleList &search_list, const ParticleList & /*members*/,
+      double dt, const double gcell_vol,
+      const std::vector<FourVector> &beam_momentum) const {
+    return find_actions_in_cell(search_list, dt, gcell_vol, beam_momentum);
+  }
+
   /**
    * Abstract function for finding actions between a list of particles and
    * the surrounding particles.
@@ -93,7 +160,7 @@ class ActionFinderInterface {
    *                 particles)
    * \return The function returns a list (std::vector) of Action objects.
    */
-  virtual ActionList find_final_actions(const Particles &search_list,
+  virtual ActionList find_final_actions(const ParticleList &search_list,
                                         bool only_res = false) const = 0;
 };
 
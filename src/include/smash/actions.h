@@ -8,11 +8,15 @@
 #define SRC_INCLUDE_SMASH_ACTIONS_H_
 
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <stdexcept>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "action.h"
+#include "memorytracker.h"
 #include "forwarddeclarations.h"
 
 namespace smash {
@@ -22,6 +26,17 @@ namespace smash {
  *
  * The Actions class abstracts the storage and manipulation of actions.
  *
+ * The actions are stored in slots, and a calendar queue of compact keys with
+ * the time of execution and the slot determines the order of execution. The
+ * calendar is a ring of buckets of equal duration, usually spanning one time
+ * step. Keys are appended to the bucket of their time in constant time, and a
+ * bucket is only sorted once it becomes the earliest one. Keys beyond the
+ * calendar wait in a heap until the calendar reaches them. The pending
+ * actions of every incoming particle are indexed by the particle id, such that
+ * all actions of a particle can be dropped eagerly once it is consumed,
+ * instead of being carried until they are popped and found to be invalid.
+ * Their keys stay in the calendar as tombstones until they are the earliest.
+ *
  * \note
  * The Actions object cannot be copied, because it does not make sense
  * semantically. Move semantics make sense and can be implemented when needed.
@@ -33,15 +48,13 @@ class Actions {
   /**
    * Creates a new Actions object from an ActionList.
    *
-   * The actions are stored in a heap and not sorted. The entries of
+   * The actions are stored in a calendar and not sorted. The entries of
    * the ActionList are rendered invalid by this constructor.
    *
    * \param[in] action_list The ActionList from which to construct the Actions
    *                    object
    */
-  explicit Actions(ActionList&& action_list) : data_(std::move(action_list)) {
-    std::make_heap(data_.begin(), data_.end(), cmp);
-  }
+  explicit Actions(ActionList&& action_list) { insert(std::move(action_list)); }
 
   /// Cannot be copied
   Actions(const Actions&) = delete;
@@ -49,7 +62,7 @@ class Actions {
   Actions& operator=(const Actions&) = delete;
 
   /// \return whether the list of actions is empty.
-  bool is_empty() const { return data_.empty(); }
+  bool is_empty() const { return size_ == 0; }
 
   /**
    * Return the first action in the list and removes it from the list.
@@ -57,26 +70,52 @@ class Actions {
    * \throw RuntimeError if the list is empty.
    */
   ActionPtr pop() {
-    if (data_.empty()) {
+    if (is_empty()) {
       throw std::runtime_error("Empty actions list!");
     }
-    std::pop_heap(data_.begin(), data_.end(), cmp);
-    ActionPtr act = std::move(data_.back());
-    data_.pop_back();
+    const uint32_t slot = pop_key();
+    ActionPtr act = std::move(storage_[slot]);
+    ++generation_[slot];
+    free_slots_.push_back(slot);
+    --size_;
+    drop_tombstones();
     return act;
   }
 
   /// Return time of execution of earliest action
-  double earliest_time() const { return data_.front()->time_of_execution(); }
+  double earliest_time() const { return buckets_[current_].back().time; }
+
+  /**
+   * Size the buckets of the calendar such that it spans \p duration, which
+   * should be the time within which most actions are due, e.g. a time step.
+   *
+   * \param[in] duration Time spanned by the calendar [fm]
+   */
+  void set_time_step(double duration) {
+    if (duration > 0.) {
+      bucket_width_ = duration / n_buckets;
+    }
+  }
 
   /**
    * Insert a list of actions into this object.
    *
-   * They're inserted at the right places to keep the complete list a heap.
+   * If there are no other actions, the calendar starts at the earliest of
+   * them.
    *
    * \param[in] new_acts The actions that will be inserted.
    */
   void insert(ActionList&& new_acts) {
+    if (new_acts.empty()) {
+      return;
+    }
+    if (!has_keys()) {
+      double start = new_acts.front()->time_of_execution();
+      for (const ActionPtr& a : new_acts) {
+        start = std::min(start, a->time_of_execution());
+      }
+      start_calendar(start);
+    }
     for (auto& a : new_acts) {
       insert(std::move(a));
     }
@@ -90,47 +129,279 @@ class Actions {
    * \param[in] action The action to insert.
    */
   void insert(ActionPtr&& action) {
-    data_.push_back(std::move(action));
-    std::push_heap(data_.begin(), data_.end(), cmp);
+    uint32_t slot;
+    if (free_slots_.empty()) {
+      slot = storage_.size();
+      storage_.emplace_back();
+      generation_.push_back(0);
+    } else {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+    for (const ParticleData& p : action->incoming_particles()) {
+      actions_of_particle_[p.id()].push_back({slot, generation_[slot]});
+    }
+    const Key key{action->time_of_execution(), slot};
+    if (!has_keys()) {
+      start_calendar(key.time);
+    }
+    storage_[slot] = std::move(action);
+    ++size_;
+    place(key, true);
+    settle();
+    account_memory();
+  }
+
+  /**
+   * Drop all pending actions with the particle of id \p id among their
+   * incoming particles, e.g. because it was consumed by another action.
+   *
+   * \param[in] id The id of the particle
+   * \return Number of dropped actions
+   */
+  ActionList::size_type drop_actions_of(int32_t id) {
+    const auto it = actions_of_particle_.find(id);
+    if (it == actions_of_particle_.end()) {
+      return 0;
+    }
+    ActionList::size_type dropped = 0;
+    for (const SlotReference& ref : it->second) {
+      if (generation_[ref.slot] == ref.generation) {
+        // The key stays in the calendar until it is the earliest one.
+        storage_[ref.slot].reset();
+        ++generation_[ref.slot];
+        ++dropped;
+      }
+    }
+    // The entry keeps its storage for later actions of the particle.
+    it->second.clear();
+    size_ -= dropped;
+    drop_tombstones();
+    return dropped;
   }
 
   /// \return Number of actions.
-  ActionList::size_type size() const { return data_.size(); }
+  ActionList::size_type size() const { return size_; }
 
   /// Delete all actions.
-  void clear() { data_.clear(); }
+  void clear() {
+    storage_.clear();
+    generation_.clear();
+    for (std::vector<Key>& bucket : buckets_) {
+      bucket.clear();
+    }
+    keys_in_calendar_ = 0;
+    // A refilled calendar uses the same buckets again.
+    current_ = 0;
+    overflow_.clear();
+    free_slots_.clear();
+    /* The entries of the particles are kept with their storage, such that
+     * refilling the container does not allocate, unless there are many more
+     * of them than slots, e.g. because the particle ids kept increasing. */
+    if (actions_of_particle_.size() > 4 * storage_.capacity() + 64) {
+      actions_of_particle_.clear();
+    } else {
+      for (auto& entry : actions_of_particle_) {
+        entry.second.clear();
+      }
+    }
+    size_ = 0;
+    account_memory();
+  }
+
+ private:
+  /// Number of buckets of the calendar
+  static constexpr std::size_t n_buckets = 256;
+
+  /// Size up to which a bucket is sorted by insertion, see settle()
+  static constexpr std::size_t max_insertion_sort = 32;
+
+  /// Key of an action in the calendar
+  struct Key {
+    /// Time of execution of the action
+    double time;
+    /// Slot of the action in storage_
+    uint32_t slot;
+  };
+
+  /// Reference to a slot, which is outdated once its action is removed
+  struct SlotReference {
+    /// Slot of the action in storage_
+    uint32_t slot;
+    /// Generation of the slot when the action was inserted
+    uint32_t generation;
+  };
+
+  /**
+   * Compare two keys such that the maximum is the most recent action.
+   *
+   * \param[in] a First key
+   * \param[in] b Second key
+   * \return Whether the first action will be executed later than the second.
+   */
+  static bool cmp(const Key& a, const Key& b) { return a.time > b.time; }
+
+  /// \return whether there are keys, including tombstones.
+  bool has_keys() const { return keys_in_calendar_ > 0 || !overflow_.empty(); }
 
-  /// \return an iterator to the earliest action.
-  std::vector<ActionPtr>::const_reverse_iterator begin() const {
-    return data_.crbegin();
+  /**
+   * Let the earliest bucket of the calendar begin at \p start. There must
+   * not be any keys.
+   *
+   * \param[in] start Time at which the calendar begins [fm]
+   */
+  void start_calendar(double start) {
+    buckets_.resize(n_buckets);
+    calendar_start_ = start;
+    buckets_passed_ = 0;
   }
 
-  /// \return an iterator to the place following the last action.
-  std::vector<ActionPtr>::const_reverse_iterator end() const {
-    return data_.crend();
+  /// \return the time at which the earliest bucket begins [fm].
+  double current_bucket_start() const {
+    return calendar_start_ + buckets_passed_ * bucket_width_;
   }
 
- private:
   /**
-   * Compare two action pointer such that the maximum is the most recent
-   * action.
+   * Put a key into the bucket of its time, or into the overflow if it is
+   * beyond the calendar. Keys before the earliest bucket belong to it.
    *
-   * \param[in] a First action
-   * \param[in] b Second action
-   * \return Whether the first action will be executed later than the second.
+   * \param[in] key The key
+   * \param[in] sorted Whether the earliest bucket is sorted already, such
+   *                   that the key is inserted at its place
    */
-  static bool cmp(const ActionPtr& a, const ActionPtr& b) {
-    return a->time_of_execution() > b->time_of_execution();
+  void place(const Key& key, bool sorted) {
+    const double offset = (key.time - current_bucket_start()) / bucket_width_;
+    if (offset >= n_buckets) {
+      overflow_.push_back(key);
+      std::push_heap(overflow_.begin(), overflow_.end(), cmp);
+      return;
+    }
+    const std::size_t ahead = offset > 0. ? static_cast<std::size_t>(offset) : 0;
+    std::vector<Key>& bucket = buckets_[(current_ + ahead) % n_buckets];
+    if (ahead == 0 && sorted) {
+      // Among equal times, the earlier inserted key is popped first.
+      bucket.insert(std::lower_bound(bucket.begin(), bucket.end(), key, cmp),
+                    key);
+    } else {
+      bucket.push_back(key);
+    }
+    ++keys_in_calendar_;
   }
 
   /**
-   * Dynamic data.
+   * Advance the calendar to the earliest non-empty bucket, if there are any
+   * keys, and sort that bucket, such that its last key is the earliest one.
+   * If the calendar is empty, it restarts at the earliest key of the
+   * overflow.
+   */
+  void settle() {
+    while (buckets_[current_].empty() && has_keys()) {
+      if (keys_in_calendar_ == 0) {
+        start_calendar(overflow_.front().time);
+      } else {
+        current_ = (current_ + 1) % n_buckets;
+        ++buckets_passed_;
+      }
+      /* The overflow keys the calendar reaches now, at least the earliest one
+       * after a restart */
+      const double calendar_end =
+          current_bucket_start() + n_buckets * bucket_width_;
+      while (!overflow_.empty() && (keys_in_calendar_ == 0 ||
+                                    overflow_.front().time < calendar_end)) {
+        std::pop_heap(overflow_.begin(), overflow_.end(), cmp);
+        const Key key = overflow_.back();
+        overflow_.pop_back();
+        place(key, false);
+      }
+      // Among equal times, the earlier inserted key comes last.
+      std::vector<Key>& bucket = buckets_[current_];
+      const auto earlier = [](const Key& a, const Key& b) { return cmp(b, a); };
+      if (bucket.size() <= max_insertion_sort) {
+        // Stable as well, but without the temporary buffer of stable_sort
+        for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+          std::rotate(std::upper_bound(bucket.begin(), it, *it, earlier), it,
+                      std::next(it));
+        }
+      } else {
+        std::stable_sort(bucket.begin(), bucket.end(), earlier);
+      }
+      std::reverse(bucket.begin(), bucket.end());
+    }
+  }
+
+  /**
+   * Remove the earliest key from the calendar.
    *
-   * Vector is likely the best container type here. Because std::sort requires
-   * random access iterators. Any linked data structure (e.g. list) thus
-   * requires a less efficient sort algorithm.
+   * \return the slot of the key
    */
-  std::vector<ActionPtr> data_;
+  uint32_t pop_key() {
+    std::vector<Key>& bucket = buckets_[current_];
+    const uint32_t slot = bucket.back().slot;
+    bucket.pop_back();
+    --keys_in_calendar_;
+    settle();
+    return slot;
+  }
+
+  /// Update the memory of the calendar and its slots, see MemoryTracker.
+  void account_memory() {
+    memory_.set(storage_.capacity() * sizeof(ActionPtr) +
+                generation_.capacity() * sizeof(uint32_t) +
+                (keys_in_calendar_ + overflow_.capacity()) * sizeof(Key) +
+                free_slots_.capacity() * sizeof(uint32_t));
+  }
+
+  /// Remove the keys of dropped actions from the front of the calendar.
+  void drop_tombstones() {
+    while (has_keys() &&
+           storage_[buckets_[current_].back().slot] == nullptr) {
+      free_slots_.push_back(pop_key());
+    }
+  }
+
+  /// The actions, in slots which are reused once the key left the heap
+  std::vector<ActionPtr> storage_;
+
+  /// Generation of every slot, incremented whenever its action is removed
+  std::vector<uint32_t> generation_;
+
+  /**
+   * Ring of buckets of the keys of the actions, including the tombstones of
+   * dropped actions. The bucket at current_ holds the earliest keys, sorted
+   * such that the earliest key is the last one, the following ones are not
+   * sorted.
+   */
+  std::vector<std::vector<Key>> buckets_ = std::vector<std::vector<Key>>(1);
+
+  /// Index of the bucket holding the earliest keys in buckets_
+  std::size_t current_ = 0;
+
+  /// Time at which the calendar was started [fm]
+  double calendar_start_ = 0.;
+
+  /// Number of buckets the calendar advanced since it was started
+  std::uint64_t buckets_passed_ = 0;
+
+  /// Duration of a bucket [fm]
+  double bucket_width_ = 0.01;
+
+  /// Number of keys in buckets_
+  std::size_t keys_in_calendar_ = 0;
+
+  /// Heap of the keys beyond the end of the calendar
+  std::vector<Key> overflow_;
+
+  /// Slots, whose keys are not in the calendar
+  std::vector<uint32_t> free_slots_;
+
+  /// Slots of the pending actions of every incoming particle id
+  std::unordered_map<int32_t, std::vector<SlotReference>> actions_of_particle_;
+
+  /// Number of pending actions, i.e. without the tombstones
+  ActionList::size_type size_ = 0;
+
+  /// Accounts the memory of the heap and its slots
+  MemoryAccount memory_{MemorySubsystem::Actions};
 };
 
 }  // namespace smash
@@ -0,0 +1,112 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_ADAPTIVETIMESTEP_H_
+#define SRC_INCLUDE_SMASH_ADAPTIVETIMESTEP_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "lattice.h"
+#include "threevector.h"
+
+namespace smash {
+
+/// Parameters of the adaptive time step mode
+struct AdaptiveTimeStepParameters {
+  /// Smallest allowed time step [fm]
+  double min_dt;
+  /// Largest allowed time step [fm]
+  double max_dt;
+  /// Targeted number of actions per particle in one time step
+  double actions_per_particle;
+  /// Largest fraction of a lattice cell the fastest particle may cross
+  double lattice_cell_fraction;
+  /// Largest momentum change by the potentials in one time step [GeV]
+  double momentum_kick;
+};
+
+/**
+ * State of the system at the end of a time step, from which the length of the
+ * next time step is determined.
+ */
+struct TimeStepObservables {
+  /// Number of actions found at the beginning of the time step
+  std::size_t n_actions = 0;
+  /// Number of particles
+  std::size_t n_particles = 0;
+  /// Largest velocity of all particles
+  double max_velocity = 0.;
+  /// Smallest cell size of the lattices, 0 without lattices [fm]
+  double min_lattice_spacing = 0.;
+  /// Upper bound of the potential forces on the lattices, 0 without [GeV/fm]
+  double max_force = 0.;
+};
+
+/**
+ * Chooses the length of the next time step from the state of the system.
+ *
+ * The time step is limited by three criteria:
+ * - the rate of actions found per particle, such that dense stages of the
+ *   evolution are resolved with shorter time steps, while dilute stages do
+ *   not rebuild the grid more often than needed,
+ * - the fastest particle crossing at most a fraction of a lattice cell, such
+ *   that densities and forces on the lattices stay smooth in time,
+ * - the largest momentum change due to the forces on the lattices.
+ *
+ * The time step grows at most by a factor of 2 from one step to the next and
+ * is kept within the given bounds.
+ */
+class AdaptiveTimeStep {
+ public:
+  /**
+   * \param[in] parameters Bounds of the time step and targets of the
+   *            criteria.
+   * \throw std::invalid_argument if the bounds are not positive and ordered
+   *        or a target is not positive.
+   */
+  explicit AdaptiveTimeStep(const AdaptiveTimeStepParameters &parameters);
+
+  /**
+   * Determine the length of the next time step.
+   *
+   * \param[in] dt Length of the last time step [fm].
+   * \param[in] observables State of the system after the last time step.
+   * \return Length of the next time step [fm].
+   */
+  double next_timestep(double dt, const TimeStepObservables &observables) const;
+
+  /// \return the bounds and targets of the adaptive time step.
+  const AdaptiveTimeStepParameters &parameters() const { return parameters_; }
+
+ private:
+  /// Bounds of the time step and targets of the criteria
+  AdaptiveTimeStepParameters parameters_;
+};
+
+/**
+ * \param[in] ensembles Particles of all ensembles.
+ * \return the largest velocity of all particles.
+ */
+double max_velocity(const std::vector<Particles> &ensembles);
+
+/**
+ * \param[in] forces Lattice with the electric and magnetic components of a
+ *            force [GeV/fm].
+ * \return an upper bound \f$ |\vec E| + |\vec B| \f$ of the force on a
+ *         particle on any node of the lattice [GeV/fm].
+ */
+double max_force(
+    const RectangularLattice<std::pair<ThreeVector, ThreeVector>> &forces);
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_ADAPTIVETIMESTEP_H_
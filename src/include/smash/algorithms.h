@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <utility>
 
 /**
@@ -98,6 +99,31 @@ inline UnaryFunction for_each(Container &&c, UnaryFunction &&f) {
                        std::forward<UnaryFunction>(f));
 }
 
+/**
+ * Index along the Morton (Z-order) curve, which interleaves the bits of three
+ * indices. Cells that are close in space are mostly close along the curve.
+ *
+ * \param x Index in the first direction, only the lowest 21 bits are used.
+ * \param y Index in the second direction, only the lowest 21 bits are used.
+ * \param z Index in the third direction, only the lowest 21 bits are used.
+ * \return The bits of \p x at the positions 0, 3, 6, ..., those of \p y at
+ *         1, 4, 7, ... and those of \p z at 2, 5, 8, ...
+ */
+inline std::uint64_t morton_index(std::uint64_t x, std::uint64_t y,
+                                  std::uint64_t z) {
+  // Spreads the lowest 21 bits of a number to every third bit.
+  auto spread_bits = [](std::uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffff;
+    v = (v | v << 16) & 0x1f0000ff0000ff;
+    v = (v | v << 8) & 0x100f00f00f00f00f;
+    v = (v | v << 4) & 0x10c30c30c30c30c3;
+    v = (v | v << 2) & 0x1249249249249249;
+    return v;
+  };
+  return spread_bits(x) | spread_bits(y) << 1 | spread_bits(z) << 2;
+}
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_ALGORITHMS_H_
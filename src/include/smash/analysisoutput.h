@@ -0,0 +1,507 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_ANALYSISOUTPUT_H_
+#define SRC_INCLUDE_SMASH_ANALYSISOUTPUT_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "file.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Histogram of a quantity counted per event, which is averaged over the
+ * events together with its statistical error.
+ *
+ * The entries of an event are collected separately and added to the sums over
+ * all events by end_event(), which also keeps the sums of squares for the
+ * event-by-event fluctuations. Entries outside of the range are ignored.
+ */
+class EventHistogram {
+ public:
+  /**
+   * Create an empty histogram.
+   *
+   * \param[in] min Lower edge of the first bin.
+   * \param[in] max Upper edge of the last bin.
+   * \param[in] n_bins Number of bins of equal width.
+   * \throw std::invalid_argument if there are no bins or max is not larger
+   *        than min.
+   */
+  EventHistogram(double min, double max, std::size_t n_bins);
+
+  /**
+   * Add an entry to the current event.
+   *
+   * \param[in] x Value of the histogrammed quantity.
+   * \param[in] weight Weight of the entry.
+   */
+  void fill(double x, double weight = 1.) {
+    if (x >= min_ && x < max_) {
+      const std::size_t bin = static_cast<std::size_t>((x - min_) / width_);
+      current_[std::min(bin, current_.size() - 1)] += weight;
+    }
+  }
+
+  /// Add the current event to the sums over all events and clear it.
+  void end_event();
+
+  /// \return Number of bins.
+  std::size_t n_bins() const { return sum_.size(); }
+  /// \return Width of the bins.
+  double bin_width() const { return width_; }
+  /**
+   * \param[in] i Bin index.
+   * \return Lower edge of the bin.
+   */
+  double bin_low(std::size_t i) const { return min_ + i * width_; }
+
+  /**
+   * \param[in] i Bin index.
+   * \param[in] n_events Number of events.
+   * \return Average content of the bin per event.
+   */
+  double mean(std::size_t i, std::size_t n_events) const;
+
+  /**
+   * \param[in] i Bin index.
+   * \param[in] n_events Number of events.
+   * \return Statistical error of the average content of the bin.
+   */
+  double error(std::size_t i, std::size_t n_events) const;
+
+ private:
+  /// Lower edge of the first bin
+  double min_;
+  /// Upper edge of the last bin
+  double max_;
+  /// Width of the bins
+  double width_;
+  /// Content of the bins in the current event
+  std::vector<double> current_;
+  /// Sum of the bin contents over the finished events
+  std::vector<double> sum_;
+  /// Sum of the squared bin contents over the finished events
+  std::vector<double> sum_sq_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Output that evaluates observables of the final particles during the run,
+ * instead of writing the particle lists for a later analysis.
+ *
+ * For each configured species, the yield, the rapidity spectrum and, around
+ * midrapidity, the transverse momentum spectrum and the anisotropic flow
+ * coefficients as a function of transverse momentum are accumulated. The
+ * average number of participants is evaluated as well. Each ensemble counts
+ * as an event. Only the final particles of each event are analysed; all
+ * results are written at the end of the run into `analysis.dat`, see
+ * \ref doxypage_output_analysis.
+ */
+class AnalysisOutput : public OutputInterface {
+ public:
+  /**
+   * Create the analysis output.
+   *
+   * \param[in] path Output directory.
+   * \param[in] name Name of the output.
+   * \param[in] out_par Output parameters with the analysis settings.
+   * \throw std::invalid_argument if no species or an invalid binning is
+   *        configured.
+   */
+  AnalysisOutput(const std::filesystem::path &path, const std::string &name,
+                 const OutputParameters &out_par);
+
+  /// Write the results of all events.
+  ~AnalysisOutput() override;
+
+  /**
+   * Remember which particles were present initially, to count the
+   * participants at the end of the event.
+   *
+   * \param[in] particles Particles at the start of the event.
+   * \param[in] event_number Number of the event.
+   * \param[in] info Unused, needed since inherited.
+   */
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &info) override;
+
+  /**
+   * Analyse the final particles of an event.
+   *
+   * \param[in] particles Final particles of the event.
+   * \param[in] event_number Number of the event.
+   * \param[in] info Unused, needed since inherited.
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+
+  /// \return false, only the final particles are analysed.
+  bool uses_interactions() const override { return false; }
+  /// \return false, only the final particles are analysed.
+  bool uses_intermediate_times() const override { return false; }
+
+  /// \return Number of analysed events.
+  std::size_t n_events() const { return n_events_; }
+
+  /**
+   * \param[in] i Position of the species in the configured list.
+   * \return Rapidity spectrum of the species.
+   */
+  const EventHistogram &rapidity_spectrum(std::size_t i) const {
+    return species_.at(i).dn_dy;
+  }
+
+  /**
+   * \param[in] i Position of the species in the configured list.
+   * \return Transverse momentum spectrum of the species around midrapidity.
+   */
+  const EventHistogram &pt_spectrum(std::size_t i) const {
+    return species_.at(i).dn_dpt;
+  }
+
+  /// \return Average number of participants per event.
+  double mean_participants() const;
+
+ private:
+  /// Accumulated observables of one species
+  struct SpeciesObservables {
+    /// PDG code as decimal number
+    int pdg;
+    /// Number of particles per event
+    EventHistogram yield;
+    /// Rapidity spectrum
+    EventHistogram dn_dy;
+    /// Transverse momentum spectrum around midrapidity
+    EventHistogram dn_dpt;
+    /// Sum of cos(n phi) per harmonic and transverse momentum bin
+    std::vector<std::vector<double>> flow_sum;
+    /// Sum of cos²(n phi) per harmonic and transverse momentum bin
+    std::vector<std::vector<double>> flow_sum_sq;
+    /// Number of particles per transverse momentum bin entering the flow
+    std::vector<double> flow_count;
+  };
+
+  /// Write the accumulated results to the file.
+  void write_results();
+
+  /// Settings of the analysis
+  const AnalysisOutputParameters parameters_;
+  /// File of the results
+  RenamingFilePtr file_;
+  /// Observables of the configured species, in the configured order
+  std::vector<SpeciesObservables> species_;
+  /// Position of each configured species in species_, by PDG code
+  std::map<int, std::size_t> species_index_;
+  /// Number of participants per event
+  EventHistogram participants_;
+  /// Largest id and number of the initial particles, by event number
+  std::map<int, std::pair<int, std::size_t>> initial_particles_;
+  /// Number of analysed events
+  std::size_t n_events_ = 0;
+};
+
+/**
+ * \ingroup output
+ *
+ * Output that histograms the weighted dileptons or photons during the run,
+ * instead of writing every emission with its weight for a later analysis.
+ *
+ * Every interaction passed to the output adds its weight to the spectra in
+ * invariant mass (dileptons only), transverse momentum and rapidity of the
+ * emitted lepton pair or photon, in total and for its channel. The channel of
+ * a dilepton is the decaying particle, the one of a photon the incoming
+ * particles. The spectra are averaged over the events and ensembles and
+ * written at the end of the run, see \ref doxypage_output_emission_histograms.
+ */
+class EmissionHistogramOutput : public OutputInterface {
+ public:
+  /**
+   * Create the histogram output.
+   *
+   * \param[in] path Output directory.
+   * \param[in] name Name of the output, "Dileptons" or "Photons".
+   * \param[in] out_par Output parameters with the binning.
+   * \throw std::invalid_argument if a binning is invalid.
+   */
+  EmissionHistogramOutput(const std::filesystem::path &path,
+                          const std::string &name,
+                          const OutputParameters &out_par);
+
+  /// Write the spectra of all events.
+  ~EmissionHistogramOutput() override;
+
+  /**
+   * Add a dilepton decay or photon emission to the spectra.
+   *
+   * \param[in] action Action of the emission, with its weight.
+   * \param[in] density Unused, needed since inherited.
+   */
+  void at_interaction(const Action &action, const double density) override;
+
+  /**
+   * Finish the spectra of an event of all ensembles.
+   *
+   * \param[in] ensembles Final particles of the ensembles.
+   * \param[in] event_number Unused, needed since inherited.
+   */
+  void at_eventend(const std::vector<Particles> &ensembles,
+                   const int event_number) override;
+
+  /// \return false, only the emissions are histogrammed.
+  bool uses_intermediate_times() const override { return false; }
+
+  /// Spectra of one channel
+  struct Spectra {
+    /// Invariant mass spectrum, only filled for dileptons
+    EventHistogram mass;
+    /// Transverse momentum spectrum
+    EventHistogram pt;
+    /// Rapidity spectrum
+    EventHistogram rapidity;
+  };
+
+  /// \return Spectra of all emissions.
+  const Spectra &total() const { return total_; }
+
+  /// \return Spectra of the channels, by the name of the channel.
+  const std::map<std::string, Spectra> &channels() const { return channels_; }
+
+  /// \return Number of events times the number of ensembles.
+  std::size_t n_events() const { return n_samples_ * n_ensembles_; }
+
+ private:
+  /// Write the spectra to the file.
+  void write_results();
+
+  /// Empty spectra with the configured binning
+  Spectra empty_;
+  /// Spectra of all emissions
+  Spectra total_;
+  /// Spectra of each channel
+  std::map<std::string, Spectra> channels_;
+  /// File of the results
+  RenamingFilePtr file_;
+  /// Number of finished events, each summed over the ensembles
+  std::size_t n_samples_ = 0;
+  /// Number of ensembles per event
+  std::size_t n_ensembles_ = 1;
+};
+
+/**
+ * \ingroup output
+ *
+ * Multi-tau estimator of the autocorrelation function
+ * \f$C(\tau) = \langle A(t) A(t + \tau) \rangle\f$ of an equidistant series.
+ *
+ * The lags are arranged in levels of p lags each. Level 0 holds the last p
+ * values and thereby the lags 0 to p-1 in units of the sampling interval.
+ * Every two values of a level are averaged and passed on to the next level,
+ * whose sampling interval is twice as large, so that level l > 0 contributes
+ * the lags j 2^l with p/2 <= j < p. The memory is thus proportional to the
+ * number of levels, i.e. to the logarithm of the longest lag, and not to the
+ * length of the series. The correlation at the longer lags is smoothed over
+ * the coarser sampling interval, which is accurate for correlations decaying
+ * slowly compared to the interval.
+ *
+ * Several series, e.g. of different events, contribute to the same averages;
+ * products are only formed within a series.
+ */
+class MultiTauCorrelator {
+ public:
+  /**
+   * Create a correlator without any values.
+   *
+   * \param[in] points_per_level Number of lags p per level, an even number of
+   *            at least 2.
+   * \param[in] levels Number of levels, at least 1.
+   * \throw std::invalid_argument if the parameters are out of range.
+   */
+  MultiTauCorrelator(std::size_t points_per_level, std::size_t levels);
+
+  /// Start a new series, keeping the averages of the previous ones.
+  void start_series();
+
+  /**
+   * Add the next value of the current series.
+   *
+   * \param[in] value Value of the correlated quantity.
+   */
+  void add(double value) { add(value, 0); }
+
+  /// \return Number of lags of the estimated correlation function.
+  std::size_t n_lags() const { return lags_.size(); }
+
+  /**
+   * \param[in] i Index of the lag.
+   * \return Lag in units of the sampling interval.
+   */
+  std::size_t lag(std::size_t i) const { return lags_.at(i).first; }
+
+  /**
+   * \param[in] i Index of the lag.
+   * \return Average of the products of the values at the lag, or 0 if the
+   *         series were too short for it.
+   */
+  double correlation(std::size_t i) const;
+
+ private:
+  /**
+   * Add a value to a level and pass the averages on to the next level.
+   *
+   * \param[in] value Value, averaged over the sampling interval of the level.
+   * \param[in] level Level of the value.
+   */
+  void add(double value, std::size_t level);
+
+  /// Values of a level, the registers holding the most recent ones
+  struct Level {
+    /// Last p values, as a ring buffer
+    std::vector<double> values;
+    /// Position of the most recent value in the ring buffer
+    std::size_t newest = 0;
+    /// Number of valid values in the ring buffer
+    std::size_t filled = 0;
+    /// Sum of the products of the values per lag
+    std::vector<double> sum;
+    /// Number of products per lag
+    std::vector<std::size_t> count;
+    /// Sum of the values not yet passed on to the next level
+    double accumulated = 0.;
+    /// Number of the values not yet passed on to the next level
+    std::size_t n_accumulated = 0;
+  };
+
+  /// Number of values averaged when passing them on to the next level
+  static constexpr std::size_t averaging_ = 2;
+  /// Levels of the correlator
+  std::vector<Level> levels_;
+  /// Lags in units of the sampling interval and their level
+  std::vector<std::pair<std::size_t, std::size_t>> lags_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Output that accumulates the equilibrium correlation functions needed for
+ * the Green-Kubo formulae of the shear viscosity and of the electric and
+ * baryon conductivities, instead of writing the particle lists for a later
+ * analysis.
+ *
+ * At each output time, the volume-integrated off-diagonal components
+ * \f$T^{xy}, T^{xz}, T^{yz}\f$ of the energy-momentum tensor and the
+ * electric and baryon currents of each ensemble are evaluated and added to
+ * multi-tau correlators. Only the correlation functions, averaged over the
+ * components, ensembles and events, are written at the end of the run, see
+ * \ref doxypage_output_green_kubo.
+ */
+class GreenKuboOutput : public OutputInterface {
+ public:
+  /**
+   * Create the Green-Kubo output.
+   *
+   * \param[in] path Output directory.
+   * \param[in] name Name of the output.
+   * \param[in] out_par Output parameters with the correlator settings.
+   * \throw std::invalid_argument if the correlator settings are invalid.
+   */
+  GreenKuboOutput(const std::filesystem::path &path, const std::string &name,
+                  const OutputParameters &out_par);
+
+  /// Write the correlation functions of all events.
+  ~GreenKuboOutput() override;
+
+  /**
+   * Start new series for all ensembles.
+   *
+   * \param[in] ensembles Particles of the ensembles at the start.
+   * \param[in] event_number Unused, needed since inherited.
+   */
+  void at_eventstart(const std::vector<Particles> &ensembles,
+                     int event_number) override;
+
+  /**
+   * Add the current stress tensor and currents of each ensemble to the
+   * correlators.
+   *
+   * \param[in] ensembles Particles of the ensembles.
+   * \param[in] clock Output clock with the current time.
+   * \param[in] dens_param Unused, needed since inherited.
+   */
+  void at_intermediate_time(const std::vector<Particles> &ensembles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param) override;
+
+  /// \return false, only the particles at the output times are used.
+  bool uses_interactions() const override { return false; }
+
+  /// Quantities correlated per ensemble
+  enum Signal {
+    /// \f$T^{xy}\f$, \f$T^{xz}\f$ and \f$T^{yz}\f$
+    ShearXY,
+    ShearXZ,
+    ShearYZ,
+    /// Components of the electric current
+    ChargeX,
+    ChargeY,
+    ChargeZ,
+    /// Components of the baryon current
+    BaryonX,
+    BaryonY,
+    BaryonZ,
+    /// Number of signals
+    NSignals
+  };
+
+  /**
+   * \param[in] first First signal of a group.
+   * \param[in] n Number of signals in the group.
+   * \param[in] i Index of the lag.
+   * \return Correlation averaged over the signals and ensembles.
+   */
+  double correlation(Signal first, int n, std::size_t i) const;
+
+  /// \return Interval between the output times [fm], 0 if not yet known.
+  double interval() const { return interval_; }
+
+ private:
+  /// Write the correlation functions to the file.
+  void write_results();
+
+  /// Settings of the correlators
+  const GreenKuboOutputParameters parameters_;
+  /// Correlators of each ensemble and signal
+  std::vector<std::vector<MultiTauCorrelator>> correlators_;
+  /// Time of the previous output in the event [fm]
+  std::optional<double> last_time_;
+  /// Interval between the output times [fm]
+  double interval_ = 0.;
+  /// Whether a change of the interval has been reported
+  bool interval_warned_ = false;
+  /// File of the results
+  RenamingFilePtr file_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_ANALYSISOUTPUT_H_
@@ -0,0 +1,94 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_ARROWEXPORT_H_
+#define SRC_INCLUDE_SMASH_ARROWEXPORT_H_
+
+#include <cstdint>
+
+#include "forwarddeclarations.h"
+
+/*
+ * Structures of the Apache Arrow C data interface, see
+ * https://arrow.apache.org/docs/format/CDataInterface.html. They are part of
+ * the stable ABI of Arrow and are declared by every producer and consumer
+ * itself, guarded by the macro below, so that no Arrow library is needed.
+ */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+/// Type description of an Arrow array
+struct ArrowSchema {
+  // Array type description
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+
+/// Data of an Arrow array
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+}
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace smash {
+
+/**
+ * Export the particles as a struct array of the Apache Arrow C data
+ * interface, for programs linking SMASH that analyse the particles in memory,
+ * e.g. with pyarrow or polars in a notebook, without writing them to a file.
+ *
+ * The struct array has one row per particle and the non-nullable columns
+ * `pdg`, `id` and `ncoll` (int32) and `t`, `x`, `y`, `z`, `E`, `px`, `py`,
+ * `pz` (float64, in fm and GeV). The columns are filled column by column
+ * with one pass over the particles each, from the structure-of-arrays copy of
+ * the particles if it is enabled (see Particles::enable_arrays()). Their
+ * memory is owned by the exported structures and is released by their
+ * release callbacks, as required by the interface, so that the exported
+ * particles remain valid after \p particles changed.
+ *
+ * \param[in] particles Particles to export.
+ * \param[out] array Array with the columns of the particles.
+ * \param[out] schema Type description of the array.
+ */
+void export_particles_to_arrow(const Particles &particles, ArrowArray *array,
+                               ArrowSchema *schema);
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_ARROWEXPORT_H_
@@ -0,0 +1,253 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_ASYNCOUTPUT_H_
+#define SRC_INCLUDE_SMASH_ASYNCOUTPUT_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "outputinterface.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Output that hands the particle lists and interactions over to another
+ * output, which formats and writes them on a writer thread of its own.
+ *
+ * The callbacks at_eventstart(), at_interaction(), at_intermediate_time() and
+ * at_eventend() for a single particle list take a snapshot of their arguments
+ * and push it into a bounded queue. If the queue is full, the physics loop
+ * waits until the writer thread has caught up. At the end of every event and
+ * on destruction the queue is flushed, i.e. everything has been written when
+ * at_eventend() returns. Exceptions thrown by the wrapped output on the writer
+ * thread are rethrown by the next call on the physics side.
+ *
+ * All other callbacks are forwarded synchronously after flushing the queue,
+ * so the wrapped output sees the calls in their original order. An output
+ * that only depends on the callbacks of single particle lists and of
+ * interactions, like the Rivet output, can be wrapped with
+ * Callbacks::ParticleLists instead. Then the other callbacks are not
+ * forwarded and the physics loop does not wait at the end of an event, so
+ * that the writer thread finishes an event while the next one is evolved.
+ *
+ * The wrapped output receives a clock frozen at the time of the snapshot.
+ * Hence only outputs of particle lists and interactions, which do not depend
+ * on the clock or on shared state of the physics loop, should be wrapped.
+ */
+class AsyncOutput : public OutputInterface {
+ public:
+  /// Callbacks the wrapped output depends on
+  enum class Callbacks {
+    /// All callbacks, the queue is flushed at the end of every event
+    All,
+    /// Only those of single particle lists and of interactions
+    ParticleLists
+  };
+
+  /**
+   * Start the writer thread of an output.
+   *
+   * \param[in] output Output which formats and writes the snapshots.
+   * \param[in] capacity Maximal number of snapshots waiting to be written.
+   * \param[in] callbacks Callbacks the wrapped output depends on.
+   * \throw std::invalid_argument if the capacity is zero.
+   */
+  explicit AsyncOutput(std::unique_ptr<OutputInterface> output,
+                       std::size_t capacity = default_capacity,
+                       Callbacks callbacks = Callbacks::All);
+
+  /// Write all pending snapshots and stop the writer thread.
+  ~AsyncOutput() override;
+
+  /**
+   * Queue the particle list at event start.
+   * \param[in] particles Current list of all particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &info) override;
+
+  /// Forwarded synchronously.
+  void at_eventstart(const std::vector<Particles> &ensembles,
+                     int event_number) override;
+  /// Forwarded synchronously.
+  void at_eventstart(const int event_number, const ThermodynamicQuantity tq,
+                     const DensityType dens_type,
+                     RectangularLattice<DensityOnLattice> lattice) override;
+  /// Forwarded synchronously.
+  void at_eventstart(const int event_number, const ThermodynamicQuantity tq,
+                     const DensityType dens_type,
+                     RectangularLattice<EnergyMomentumTensor> lattice) override;
+
+  /**
+   * Queue the particle list at event end and, unless only the callbacks of
+   * particle lists are forwarded, wait until everything has been written.
+   * \param[in] particles Current list of particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+
+  /// Forwarded synchronously.
+  void at_eventend(const std::vector<Particles> &ensembles,
+                   const int event_number) override;
+  /// Forwarded synchronously.
+  void at_eventend(const int event_number, const ThermodynamicQuantity tq,
+                   const DensityType dens_type) override;
+  /// Forwarded synchronously.
+  void at_eventend(const ThermodynamicQuantity tq) override;
+
+  /**
+   * Queue the incoming and outgoing particles of an interaction.
+   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] density Density at the interaction point.
+   */
+  void at_interaction(const Action &action, const double density) override;
+
+  /// \return Whether the wrapped output uses the interactions.
+  bool uses_interactions() const override {
+    return output_->uses_interactions();
+  }
+  /// \return Whether the wrapped output uses the interaction density.
+  bool uses_interaction_density() const override {
+    return output_->uses_interaction_density();
+  }
+  /// \return Whether the wrapped output uses the output times.
+  bool uses_intermediate_times() const override {
+    return output_->uses_intermediate_times();
+  }
+
+  /**
+   * Queue the particle list at an intermediate time.
+   * \param[in] particles Current list of particles.
+   * \param[in] clock Clock of the output times, only its current time is
+   *            passed on.
+   * \param[in] dens_param Parameters for the density calculation.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &info) override;
+
+  /// Forwarded synchronously.
+  void at_intermediate_time(const std::vector<Particles> &ensembles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param) override;
+  /// Forwarded synchronously.
+  void thermodynamics_output(
+      const ThermodynamicQuantity tq, const DensityType dt,
+      RectangularLattice<DensityOnLattice> &lattice) override;
+  /// Forwarded synchronously.
+  void thermodynamics_output(
+      const ThermodynamicQuantity tq, const DensityType dt,
+      RectangularLattice<EnergyMomentumTensor> &lattice) override;
+  /// Forwarded synchronously.
+  void thermodynamics_lattice_output(RectangularLattice<DensityOnLattice> &lat,
+                                     const double current_time) override;
+  /// Forwarded synchronously.
+  void thermodynamics_lattice_output(
+      RectangularLattice<DensityOnLattice> &lat, const double current_time,
+      const std::vector<Particles> &ensembles,
+      const DensityParameters &dens_param) override;
+  /// Forwarded synchronously.
+  void thermodynamics_lattice_output(
+      const ThermodynamicQuantity tq,
+      RectangularLattice<EnergyMomentumTensor> &lattice,
+      const double current_time) override;
+  /// Forwarded synchronously.
+  void thermodynamics_output(const GrandCanThermalizer &gct) override;
+  /// Forwarded synchronously.
+  void fields_output(
+      const std::string name1, const std::string name2,
+      RectangularLattice<std::pair<ThreeVector, ThreeVector>> &lat) override;
+
+  /**
+   * Wait until all queued snapshots have been written.
+   *
+   * \throw any exception thrown by the wrapped output while writing.
+   */
+  void flush();
+
+  /// Default maximal number of snapshots waiting to be written
+  static constexpr std::size_t default_capacity = 4096;
+
+ private:
+  /**
+   * Queue a writing task, waiting while the queue is full.
+   *
+   * \param[in] task Call of the wrapped output on a snapshot.
+   * \throw any exception thrown by the wrapped output while writing.
+   */
+  void push(std::function<void()> task);
+
+  /// Rethrow an exception of the writer thread on the calling thread.
+  void rethrow_error();
+
+  /**
+   * Flush the queue before forwarding a callback synchronously.
+   *
+   * \return Whether the callback is forwarded to the wrapped output.
+   * \throw any exception thrown by the wrapped output while writing.
+   */
+  bool forward_synchronously();
+
+  /// Execute the queued tasks until stop_ is set and the queue is empty.
+  void write_loop();
+
+  /// Output which formats and writes the snapshots
+  std::unique_ptr<OutputInterface> output_;
+
+  /// Maximal number of queued tasks
+  const std::size_t capacity_;
+
+  /// Callbacks the wrapped output depends on
+  const Callbacks callbacks_;
+
+  /// Queued tasks, oldest first
+  std::deque<std::function<void()>> queue_;
+
+  /// Protects queue_, writing_, stop_ and error_
+  std::mutex mutex_;
+
+  /// Signals the writer thread that a task was queued or it has to stop
+  std::condition_variable task_queued_;
+
+  /// Signals the physics loop that a task has been written
+  std::condition_variable task_written_;
+
+  /// Whether the writer thread is currently executing a task
+  bool writing_ = false;
+
+  /// Whether the writer thread has to stop once the queue is empty
+  bool stop_ = false;
+
+  /// First exception thrown while writing, not yet rethrown
+  std::exception_ptr error_;
+
+  /// Thread executing the queued tasks
+  std::thread writer_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_ASYNCOUTPUT_H_
@@ -10,12 +10,16 @@
 #ifndef SRC_INCLUDE_SMASH_BINARYOUTPUT_H_
 #define SRC_INCLUDE_SMASH_BINARYOUTPUT_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "file.h"
 #include "forwarddeclarations.h"
+#include "fourvector.h"
 #include "numeric_cast.h"
 #include "outputinterface.h"
 #include "outputparameters.h"
@@ -35,10 +39,18 @@ class BinaryOutputBase : public OutputInterface {
    * \param[in] mode Is used to determine the file access mode.
    * \param[in] name Name of the output.
    * \param[in] extended_format Is the written output extended.
+   * \param[in] buffer_size Number of bytes of complete blocks collected in
+   *            memory before they are written to the file.
+   * \param[in] event_index Whether the event index is written at the end of
+   *            the file.
    */
   explicit BinaryOutputBase(const std::filesystem::path &path,
                             const std::string &mode, const std::string &name,
-                            bool extended_format);
+                            bool extended_format, std::size_t buffer_size,
+                            bool event_index);
+
+  /// Write the blocks that are still buffered and the event index.
+  ~BinaryOutputBase() override;
 
   /**
    * Write byte to binary output.
@@ -68,25 +80,19 @@ class BinaryOutputBase : public OutputInterface {
    * Write integer (32 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::int32_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::int32_t x) { append(&x, sizeof(x)); }
 
   /**
    * Write unsigned integer (32 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::uint32_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::uint32_t x) { append(&x, sizeof(x)); }
 
   /**
    * Write unsigned integer (16 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::uint16_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::uint16_t x) { append(&x, sizeof(x)); }
 
   /**
    * Write a std::size_t to binary output.
@@ -112,14 +118,72 @@ class BinaryOutputBase : public OutputInterface {
    */
   void write_particledata(const ParticleData &p);
 
+  /**
+   * Write the header of a particle block.
+   * \param[in] n_particles Number of particle lines that follow.
+   */
+  void write_particle_block_header(std::size_t n_particles);
+
+  /**
+   * Write the event end line, add the event to the event index and pass
+   * everything buffered on to the file.
+   * \param[in] event_number Number of the event.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void write_event_end(std::int32_t event_number, const EventInfo &event);
+
+  /**
+   * Finish the block serialised into the buffer. Once the buffer holds at
+   * least buffer_size_ bytes, it is written to the file with a single call.
+   */
+  void end_block() {
+    if (buffer_.size() >= buffer_size_) {
+      write_buffer();
+    }
+  }
+
+  /// Write everything that is buffered to the file with a single call.
+  void write_buffer();
+
   /// Binary particles output file path
   RenamingFilePtr file_;
 
  private:
-  /// Binary file format version number
-  const uint16_t format_version_ = 9;
+  /**
+   * Append raw bytes to the buffer.
+   * \param[in] data Start of the bytes to be appended.
+   * \param[in] n Number of bytes.
+   */
+  void append(const void *data, std::size_t n) {
+    const char *bytes = static_cast<const char *>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + n);
+  }
+
+  /// \return Offset in the file at which the next byte is written.
+  std::uint64_t position() const { return written_ + buffer_.size(); }
+
+  /// Serialised blocks that have not been written to the file yet
+  std::vector<char> buffer_;
+  /// Number of bytes from which on the buffer is written to the file
+  const std::size_t buffer_size_;
+  /// Binary file format version number, 10 if the event index is written
+  const uint16_t format_version_;
   /// Option for extended output
   bool extended_;
+  /// Whether the event index is written at the end of the file
+  const bool event_index_;
+  /// Number of bytes written to the file
+  std::uint64_t written_ = 0;
+  /// Offset of the first block of the current event
+  std::uint64_t event_begin_ = 0;
+  /// Offset of the particle lines of the last particle block of the event
+  std::uint64_t particles_offset_ = no_particles;
+  /// Number of lines of the last particle block of the event
+  std::uint32_t n_particles_ = 0;
+  /// Serialised entries of the event index
+  std::vector<char> index_;
+  /// Particle offset in the event index of events without particle block
+  static constexpr std::uint64_t no_particles = ~std::uint64_t{0};
 };
 
 /**
@@ -174,6 +238,9 @@ class BinaryOutputCollisions : public BinaryOutputBase {
    */
   void at_interaction(const Action &action, const double density) override;
 
+  /// \return false, only particle lists at event start and end are written.
+  bool uses_intermediate_times() const override { return false; }
+
  private:
   /// Write initial and final particles additonally to collisions?
   bool print_start_end_;
@@ -226,8 +293,10 @@ class BinaryOutputParticles : public BinaryOutputBase {
 
   /**
    * Writes particles at each time interval; fixed by option OUTPUT_INTERVAL.
+   * With delta blocks, only the particles that changed since the previous
+   * output are written.
    * \param[in] particles Current list of particles.
-   * \param[in] clock Unused, needed since inherited.
+   * \param[in] clock Current time, used for the delta blocks.
    * \param[in] dens_param Unused, needed since inherited.
    * \param[in] event Event info, see \ref event_info.
    */
@@ -236,9 +305,60 @@ class BinaryOutputParticles : public BinaryOutputBase {
                             const DensityParameters &dens_param,
                             const EventInfo &event) override;
 
+  /// \return false, the interactions are not used.
+  bool uses_interactions() const override { return false; }
+
+  /// \return Whether the particle lists at the output times are written.
+  bool uses_intermediate_times() const override {
+    return only_final_ == OutputOnlyFinal::No;
+  }
+
  private:
+  /// Position and momentum of a particle as last written to the file
+  struct WrittenLine {
+    /// Space-time position [fm]
+    FourVector position;
+    /// Four-momentum [GeV]
+    FourVector momentum;
+    /// Number of the last delta block at which the particle was present
+    std::uint64_t seen;
+  };
+
+  /**
+   * Write a complete particle block and remember the lines for the following
+   * delta blocks.
+   *
+   * \param[in] particles Current list of particles.
+   */
+  void write_snapshot(const Particles &particles);
+
+  /**
+   * Write a delta block with the particles that were created, changed their
+   * momentum or left their straight line since the last written lines, and
+   * the ids of the removed particles.
+   *
+   * \param[in] particles Current list of particles.
+   * \param[in] time Time of the output [fm].
+   */
+  void write_delta(const Particles &particles, double time);
+
   /// Whether final- or initial-state particles should be written.
   OutputOnlyFinal only_final_;
+
+  /// Whether the intermediate outputs are written as delta blocks
+  const bool delta_blocks_;
+
+  /// Last written lines of the current particles by their id
+  std::unordered_map<std::int32_t, WrittenLine> last_lines_;
+
+  /// Number of delta blocks written so far
+  std::uint64_t n_deltas_ = 0;
+
+  /// Particles of the next delta block, reused between the outputs
+  std::vector<const ParticleData *> changed_;
+
+  /// Ids of the removed particles of the next delta block
+  std::vector<std::int32_t> removed_;
 };
 
 /**
@@ -289,6 +409,9 @@ class BinaryOutputInitialConditions : public BinaryOutputBase {
    * \param[in] action Action that holds the information of the interaction.
    */
   void at_interaction(const Action &action, const double) override;
+
+  /// \return false, the density is not written.
+  bool uses_interaction_density() const override { return false; }
 };
 
 }  // namespace smash
@@ -0,0 +1,230 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_BINARYREADER_H_
+#define SRC_INCLUDE_SMASH_BINARYREADER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "fourvector.h"
+
+namespace smash {
+
+/**
+ * Particle line of a SMASH binary file with the quantities needed to
+ * recreate the particle.
+ */
+struct BinaryParticleLine {
+  /// Space-time position [fm]
+  FourVector position;
+  /// Effective mass [GeV]
+  double mass;
+  /// Four-momentum [GeV]
+  FourVector momentum;
+  /// PDG code as decimal number
+  std::int32_t pdg;
+  /// Particle id
+  std::int32_t id;
+  /// Electric charge
+  std::int32_t charge;
+};
+
+/**
+ * \ingroup output
+ * \brief Reads particle lists from files in the SMASH binary format.
+ *
+ * The file is mapped into memory and its events are located at construction.
+ * Files written with an event index (format version 10) are not scanned, the
+ * index directly gives the particle block of every event. Other files are
+ * scanned once, jumping over the particle lines. The particles of an event
+ * are the last particle block before its event end line, i.e. the final
+ * particles for the particles output. Reading an event then converts only the
+ * lines of that block, without any text parsing. Since the reader is not
+ * changed by reading, several threads can read events of one reader
+ * concurrently.
+ *
+ * Files of the extended format are supported, the additional quantities are
+ * skipped. Events without any particle block have no particles. The
+ * intermediate particle lists, including those written as delta blocks, are
+ * given by read_particle_lists.
+ */
+class BinaryParticleListReader {
+ public:
+  /**
+   * Map a binary file into memory and index its events.
+   *
+   * \param[in] path Path of the file.
+   * \throw std::runtime_error if the file cannot be mapped, is not a SMASH
+   *        binary file of a readable format version or has a corrupt event
+   *        index.
+   */
+  explicit BinaryParticleListReader(const std::filesystem::path &path);
+
+  /// Unmap the file.
+  ~BinaryParticleListReader();
+
+  /// Cannot be copied
+  BinaryParticleListReader(const BinaryParticleListReader &) = delete;
+  /// Cannot be copied
+  BinaryParticleListReader &operator=(const BinaryParticleListReader &) =
+      delete;
+
+  /**
+   * \param[in] path Path of a file.
+   * \return Whether the file starts with the magic number of SMASH binary
+   *         files.
+   */
+  static bool is_binary_file(const std::filesystem::path &path);
+
+  /// \return Number of complete events in the file.
+  std::size_t n_events() const { return events_.size(); }
+
+  /**
+   * \param[in] i Position of the event in the file, counted from 0.
+   * \return Number of this event as written in its event end line.
+   */
+  std::int32_t event_number(std::size_t i) const {
+    return events_.at(i).event_number;
+  }
+
+  /**
+   * Read the particles of an event.
+   *
+   * \param[in] i Position of the event in the file, counted from 0.
+   * \return The particle lines of the event.
+   */
+  std::vector<BinaryParticleLine> read_event(std::size_t i) const;
+
+  /**
+   * Read all particle lists of an event, i.e. those of its particle blocks
+   * and the ones reconstructed from its delta blocks.
+   *
+   * A delta block gives the particle list at its time from the preceding
+   * blocks of the event: The removed particles are left out, the written
+   * lines are taken as they are and every other particle is moved on a
+   * straight line from its last written line. The reconstructed lists are
+   * ordered by particle id, the ones of particle blocks keep the order of the
+   * file.
+   *
+   * \param[in] i Position of the event in the file, counted from 0.
+   * \return The particle lists of the event in the order of the file.
+   * \throw std::runtime_error if the event contains an unknown block.
+   */
+  std::vector<std::vector<BinaryParticleLine>> read_particle_lists(
+      std::size_t i) const;
+
+  /// \return The header of the file, up to the first block.
+  std::string_view header() const { return {data_, header_size_}; }
+
+  /**
+   * \param[in] i Position of the event in the file, counted from 0.
+   * \return All blocks of the event up to and including its event end line.
+   */
+  std::string_view event_blocks(std::size_t i) const {
+    const EventEntry &event = events_.at(i);
+    return {data_ + event.begin, event.end - event.begin};
+  }
+
+ private:
+  /// Location of the particles of an event in the file
+  struct EventEntry {
+    /// Number of the event
+    std::int32_t event_number;
+    /// Offset of the first particle line, if the event has particles
+    std::optional<std::size_t> offset;
+    /// Number of particle lines
+    std::uint32_t n_particles;
+    /// Offset of the first block of the event
+    std::size_t begin;
+    /// Offset behind the event end line
+    std::size_t end;
+  };
+
+  /**
+   * Take the events from the event index at the end of the file.
+   *
+   * \return Whether the file ends with an event index.
+   * \throw std::runtime_error if the entries of the index point outside of
+   *        the events.
+   */
+  bool read_event_index();
+
+  /**
+   * Find the events by going through the blocks of the file.
+   *
+   * \param[in] path Path of the file, for error messages.
+   * \throw std::runtime_error if the file contains an unknown block.
+   */
+  void scan_events(const std::filesystem::path &path);
+
+  /**
+   * Copy a value from the mapped file.
+   *
+   * \param[in] offset Position of the value in the file.
+   * \param[out] x Value read.
+   * \throw std::runtime_error if the value extends beyond the file.
+   */
+  template <typename T>
+  void read(std::size_t offset, T &x) const;
+
+  /**
+   * Convert a particle line of the mapped file.
+   *
+   * \param[in] offset Position of the line in the file.
+   * \return The particle line.
+   * \throw std::runtime_error if the line extends beyond the file.
+   */
+  BinaryParticleLine read_line(std::size_t offset) const;
+
+  /// Start of the mapped file
+  const char *data_ = nullptr;
+  /// Size of the mapped file in bytes
+  std::size_t size_ = 0;
+  /// Size of the file header in bytes
+  std::size_t header_size_ = 0;
+  /// Size of one particle line in bytes
+  std::size_t line_size_ = 0;
+  /// Events in the order of the file
+  std::vector<EventEntry> events_;
+
+  /// Copies the event index of the shards into the merged file
+  friend void merge_binary_shards(
+      const std::vector<std::filesystem::path> &shards,
+      const std::filesystem::path &merged);
+};
+
+/**
+ * \ingroup output
+ * Merge the files of a binary output written with one shard per ensemble.
+ *
+ * The shards are indexed with BinaryParticleListReader and the events of all
+ * shards are copied into one file in the order of their event numbers. This
+ * gives the file a single output would have written for the ensembles
+ * evolved one after another, i.e. the blocks of each event are contiguous.
+ * Unfinished events at the end of a shard are left out. Shards with an event
+ * index give a merged file with an event index.
+ *
+ * \param[in] shards Paths of the shards.
+ * \param[in] merged Path of the merged file, which is overwritten.
+ * \throw std::invalid_argument if no shards are given or the shards have
+ *        different headers.
+ * \throw std::runtime_error if a shard cannot be read or the merged file
+ *        cannot be written.
+ */
+void merge_binary_shards(const std::vector<std::filesystem::path> &shards,
+                         const std::filesystem::path &merged);
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_BINARYREADER_H_
@@ -0,0 +1,97 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_BLOCKCACHE_H_
+#define SRC_INCLUDE_SMASH_BLOCKCACHE_H_
+
+#include <cstddef>
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Cache of freed memory blocks of small sizes, kept separately by every
+ * thread.
+ *
+ * Actions and process branches are created for every candidate interaction,
+ * and almost all of them are destroyed within the same time step. Instead of
+ * returning their memory to the heap, the blocks are kept in free lists per
+ * size class of 16 bytes and handed out again for the next objects of the
+ * same size class, which avoids most of the allocator traffic.
+ *
+ * A block may be freed on another thread than the one it was allocated on,
+ * e.g. with deferred output of parallel ensembles, and is then cached by the
+ * freeing thread. The cached blocks are returned to the heap when their
+ * thread ends or if the free list of their size class is full.
+ */
+class BlockCache {
+ public:
+  /// Largest size of blocks that are cached
+  static constexpr std::size_t max_size = 2048;
+
+  /// Largest number of cached blocks per size class
+  static constexpr std::size_t max_blocks = 1 << 14;
+
+  /**
+   * \return memory for an object of \p size bytes, from the blocks cached by
+   * this thread if possible.
+   *
+   * \param[in] size Size of the object in bytes
+   * \throws std::bad_alloc if no memory can be allocated
+   */
+  static void *allocate(std::size_t size);
+
+  /**
+   * Gives back the memory \p p of an object of \p size bytes, which was
+   * obtained from allocate with the same size.
+   *
+   * \param[in] p Memory of the object
+   * \param[in] size Size of the object in bytes
+   */
+  static void deallocate(void *p, std::size_t size) noexcept;
+
+  /// \return the number of blocks cached by this thread.
+  static std::size_t cached_blocks();
+};
+
+/**
+ * \ingroup data
+ *
+ * Base class of the objects, which are allocated via the BlockCache.
+ *
+ * The class specific allocation functions are used by \c new and \c delete
+ * of all derived classes, such that std::unique_ptr and std::make_unique can
+ * be used as usual. The size passed to the deallocation is the size of the
+ * dynamic type, since all derived classes have virtual destructors.
+ */
+struct CacheAllocated {
+  /**
+   * \return memory for an object of \p size bytes via the BlockCache.
+   *
+   * \param[in] size Size of the object in bytes
+   */
+  static void *operator new(std::size_t size) {
+    return BlockCache::allocate(size);
+  }
+
+  /**
+   * Gives back the memory of an object via the BlockCache.
+   *
+   * \param[in] p Memory of the object
+   * \param[in] size Size of the object in bytes
+   */
+  static void operator delete(void *p, std::size_t size) noexcept {
+    BlockCache::deallocate(p, size);
+  }
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_BLOCKCACHE_H_
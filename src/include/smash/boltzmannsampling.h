@@ -0,0 +1,136 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_BOLTZMANNSAMPLING_H_
+#define SRC_INCLUDE_SMASH_BOLTZMANNSAMPLING_H_
+
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "particletype.h"
+#include "pdgcode.h"
+#include "tabulation.h"
+
+namespace smash {
+
+/**
+ * Samples masses and radial momenta of a Boltzmann gas at a fixed
+ * temperature from tabulated inverse cumulative distributions, of the masses
+ * one per species and of the momenta by ThermalMomentumSampling.
+ *
+ * The distributions are the ones of \ref sample_momenta_from_thermal and
+ * HadronGasEos::sample_mass_thermal, but a sample costs table lookups
+ * instead of a rejection loop. The tables of the masses are built once for
+ * all species on all hardware threads. Masses are tabulated in the variable
+ * \f$ x = \arctan((m - m_0)/\Gamma_0) \f$, such that narrow resonances are
+ * resolved as well as broad ones.
+ */
+class BoltzmannSampling {
+ public:
+  /**
+   * Tabulate the distributions of the given species.
+   *
+   * \param[in] types Species to be sampled.
+   * \param[in] temperature Temperature T of the gas [GeV].
+   * \param[in] account_for_resonance_widths Whether the masses of unstable
+   *            species follow their spectral function weighted with the
+   *            thermal factor \f$ m^2 K_2(m/T) \f$ instead of being the pole
+   *            mass.
+   * \param[in] n_threads Number of threads tabulating the species.
+   * \throw std::invalid_argument if the temperature is not positive.
+   */
+  BoltzmannSampling(const ParticleTypePtrList &types, double temperature,
+                    bool account_for_resonance_widths, int n_threads);
+
+  /**
+   * Sample the mass and the radial momentum of a particle. The thread-local
+   * random engine is used, such that threads can sample concurrently.
+   *
+   * \param[in] type Species of the particle.
+   * \return Mass [GeV] and length of the momentum [GeV].
+   * \throw std::out_of_range if the species was not tabulated.
+   */
+  std::pair<double, double> sample(const ParticleType &type) const;
+
+ private:
+  /// Tabulated distributions of one species
+  struct Species {
+    /// Inverse distribution of x, empty for the pole mass
+    Tabulation mass;
+  };
+
+  /// Temperature of the gas [GeV]
+  double temperature_;
+  /// Tabulated distributions by species
+  std::map<PdgCode, Species> species_;
+};
+
+/**
+ * Samples radial momenta of a Boltzmann gas of any mass and temperature from
+ * tabulated inverse cumulative distributions of \f$ p/T \f$.
+ *
+ * The distribution of \ref sample_momenta_from_thermal only depends on
+ * \f$ m/T \f$ after rescaling the momentum by the temperature. Its inverse
+ * cumulative distribution is tabulated for \f$ \sqrt{m/T} \f$ in steps of
+ * 0.05 up to 10, and a sample interpolates the quantiles of the two
+ * neighbouring rows linearly. The quantiles then deviate by less than
+ * \f$ 3 \cdot 10^{-4} \f$ relatively from the exact ones. Larger values of
+ * \f$ m/T \f$ are sampled by \ref sample_momenta_from_thermal.
+ */
+class ThermalMomentumSampling {
+ public:
+  /**
+   * \return The tabulations shared by all users. They are built on the first
+   *         call, which is thread-safe.
+   */
+  static const ThermalMomentumSampling &instance();
+
+  /**
+   * Sample the radial momentum of a particle. The thread-local random engine
+   * is used, such that threads can sample concurrently.
+   *
+   * \param[in] temperature Temperature T of the gas [GeV].
+   * \param[in] mass Mass of the particle [GeV].
+   * \return Length of the momentum [GeV].
+   */
+  double sample(double temperature, double mass) const;
+
+ private:
+  /// Tabulate the inverse distributions on all hardware threads.
+  ThermalMomentumSampling();
+
+  /// Inverse distributions of \f$ p/T \f$ over the rows of \f$ \sqrt{m/T} \f$
+  std::vector<Tabulation> rows_;
+};
+
+/**
+ * Apply a sampling function to every particle, on several threads.
+ *
+ * The particles are split into chunks of fixed size, and every chunk draws
+ * from its own random number stream derived from one number of the current
+ * engine. The result therefore only depends on the seed, not on the number
+ * of threads.
+ *
+ * \param[in] n_threads Maximal number of threads.
+ * \param[inout] particles Particles to be sampled.
+ * \param[in] sample Function setting the properties of one particle. It
+ *            must only use the thread-local random engine and must not
+ *            modify shared state.
+ * \throw Rethrows the first exception thrown by the sampling function.
+ */
+void sample_particles_in_parallel(
+    int n_threads, Particles &particles,
+    const std::function<void(ParticleData &)> &sample);
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_BOLTZMANNSAMPLING_H_
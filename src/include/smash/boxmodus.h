@@ -85,7 +85,9 @@ class BoxModus : public ModusDefault {
    * inserted from the opposite side. However these wall crossings are not
    * performed by this function but in the Experiment constructor when the
    * WallCrossActionsFinder are created. Wall crossings are written to
-   * collision output: this is where OutputsList is used.
+   * collision output: this is where OutputsList is used. Without
+   * wall-crossing actions, this function folds the particles back at the end
+   * of every time step, without output.
    */
   int impose_boundary_conditions(Particles *particles,
                                  const OutputsList &output_list = {});
@@ -109,6 +111,21 @@ class BoxModus : public ModusDefault {
             strategy};
   }
 
+  /// \copydoc smash::ModusDefault::update_grid
+  void update_grid(
+      Grid<GridOptions::PeriodicBoundaries> &grid, const Particles &particles,
+      double min_cell_length, double timestep_duration, CollisionCriterion crit,
+      const bool include_unformed_particles,
+      CellSizeStrategy strategy = CellSizeStrategy::Optimal) const {
+    CellNumberLimitation limit = CellNumberLimitation::ParticleNumber;
+    if (crit == CollisionCriterion::Stochastic) {
+      limit = CellNumberLimitation::None;
+    }
+    grid.update({{0, 0, 0}, {length_, length_, length_}}, particles,
+                min_cell_length, timestep_duration, limit,
+                include_unformed_particles, strategy);
+  }
+
   /**
    * Creates GrandCanThermalizer. (Special Box implementation.)
    *
@@ -135,6 +152,11 @@ class BoxModus : public ModusDefault {
   bool is_box() const { return true; }
   /// \return length of the box
   double length() const { return length_; }
+  /**
+   * \return Whether particles crossing a wall are moved by wall-crossing
+   *         actions, instead of being folded back at the end of a time step
+   */
+  bool wall_crossing_actions() const { return wall_crossing_actions_; }
 
  private:
   /// Initial momenta distribution: thermal or peaked momenta
@@ -192,6 +214,8 @@ class BoxModus : public ModusDefault {
    * Initial momentum of the jet particle; only used if insert_jet_ is true
    */
   const double jet_mom_;
+  /// Whether wall crossings are performed as actions
+  const bool wall_crossing_actions_;
 
   /**
    * \ingroup logging
@@ -10,6 +10,7 @@
 #ifndef SRC_INCLUDE_SMASH_BREMSSTRAHLUNGACTION_H_
 #define SRC_INCLUDE_SMASH_BREMSSTRAHLUNGACTION_H_
 
+#include <optional>
 #include <utility>
 
 #include "scatteraction.h"
@@ -168,10 +169,31 @@ class BremsstrahlungAction : public ScatterAction {
   double theta_;
 
   /**
-   * Create interpolation objects for tabularized cross sections:
-   * total cross section, differential dSigma/dk, differential dSigma/dtheta
+   * Kinematics of the final state, which are identical for all fractional
+   * photons of the action.
    */
-  void create_interpolations();
+  struct FinalStateKinematics {
+    /// Interaction point in the computational frame
+    FourVector interaction_point;
+    /// Velocity of the center-of-mass frame in the computational frame
+    ThreeVector velocity_cm;
+    /// Center-of-mass energy [GeV]
+    double sqrts;
+    /// Largest photon momentum [GeV]
+    double k_max;
+  };
+
+  /// Kinematics of the fractional photons, see final_state_kinematics
+  std::optional<FinalStateKinematics> kinematics_;
+
+  /**
+   * Evaluate the kinematics of the final state on the first call, after the
+   * outgoing particle types are known, and reuse them for all further
+   * fractional photons.
+   *
+   * \return The kinematics of the final state.
+   */
+  const FinalStateKinematics &final_state_kinematics();
 
   /**
    * Computes the total cross section of the bremsstrahlung process.
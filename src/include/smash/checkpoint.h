@@ -0,0 +1,170 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_CHECKPOINT_H_
+#define SRC_INCLUDE_SMASH_CHECKPOINT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "random.h"
+
+namespace smash {
+
+/**
+ * Binary serialization of the state of an event, from which Experiment
+ * resumes the event bit by bit as if it had never been interrupted.
+ *
+ * Values are written in the native representation of the machine, so a
+ * checkpoint can only be read by the same SMASH build on the same kind of
+ * machine, with the same configuration.
+ */
+namespace checkpoint {
+
+/// Version of the layout of the checkpoint files
+constexpr std::uint32_t version = 5;
+
+/**
+ * Whether values of type T can be written and read as raw bytes. This is
+ * slightly weaker than std::is_trivially_copyable, which also excludes
+ * std::pair because of its assignment operators.
+ */
+template <typename T>
+constexpr bool is_raw_copyable = std::is_trivially_copy_constructible_v<T> &&
+                                 std::is_trivially_destructible_v<T>;
+
+/**
+ * Write the raw bytes of a value.
+ *
+ * \param[out] out Stream of the checkpoint
+ * \param[in] value Value to be written
+ */
+template <typename T>
+void write(std::ostream &out, const T &value) {
+  static_assert(is_raw_copyable<T>, "Value cannot be written as raw bytes.");
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * Read the raw bytes of a value written by write(std::ostream &, const T &).
+ *
+ * \param[in] in Stream of the checkpoint
+ * \param[out] value Value to be read
+ * \throw runtime_error if the checkpoint ends prematurely
+ */
+template <typename T>
+void read(std::istream &in, T &value) {
+  static_assert(is_raw_copyable<T>, "Value cannot be read as raw bytes.");
+  in.read(reinterpret_cast<char *>(&value), sizeof(T));
+  if (!in) {
+    throw std::runtime_error("Checkpoint ends prematurely.");
+  }
+}
+
+/**
+ * Write the raw bytes of an array.
+ *
+ * \param[out] out Stream of the checkpoint
+ * \param[in] data First element of the array
+ * \param[in] size Number of elements
+ */
+template <typename T>
+void write_array(std::ostream &out, const T *data, std::size_t size) {
+  static_assert(is_raw_copyable<T>, "Values cannot be written as raw bytes.");
+  out.write(reinterpret_cast<const char *>(data), size * sizeof(T));
+}
+
+/**
+ * Read an array written by write_array.
+ *
+ * \param[in] in Stream of the checkpoint
+ * \param[out] data First element of the array, which has to hold at least
+ *             \p size elements
+ * \param[in] size Number of elements
+ * \throw runtime_error if the checkpoint ends prematurely
+ */
+template <typename T>
+void read_array(std::istream &in, T *data, std::size_t size) {
+  static_assert(is_raw_copyable<T>, "Values cannot be read as raw bytes.");
+  in.read(reinterpret_cast<char *>(data), size * sizeof(T));
+  if (!in) {
+    throw std::runtime_error("Checkpoint ends prematurely.");
+  }
+}
+
+/**
+ * Write the size and the raw bytes of the elements of a vector.
+ *
+ * \param[out] out Stream of the checkpoint
+ * \param[in] values Vector to be written
+ */
+template <typename T>
+void write(std::ostream &out, const std::vector<T> &values) {
+  write(out, static_cast<std::uint64_t>(values.size()));
+  write_array(out, values.data(), values.size());
+}
+
+/**
+ * Read a vector written by write(std::ostream &, const std::vector<T> &).
+ *
+ * \param[in] in Stream of the checkpoint
+ * \param[out] values Vector to be read, resized as needed
+ * \throw runtime_error if the checkpoint ends prematurely
+ */
+template <typename T>
+void read(std::istream &in, std::vector<T> &values) {
+  std::uint64_t size = 0;
+  read(in, size);
+  values.resize(size);
+  read_array(in, values.data(), size);
+}
+
+/**
+ * Write the state of a random number engine.
+ *
+ * \param[out] out Stream of the checkpoint
+ * \param[in] engine Engine to be written
+ */
+void write(std::ostream &out, const random::Engine &engine);
+
+/**
+ * Read the state of a random number engine.
+ *
+ * \param[in] in Stream of the checkpoint
+ * \param[out] engine Engine to be restored
+ * \throw runtime_error if the state is invalid
+ */
+void read(std::istream &in, random::Engine &engine);
+
+/**
+ * Write the identifier of the file format and the version of the layout.
+ *
+ * \param[out] out Stream of the checkpoint
+ */
+void write_header(std::ostream &out);
+
+/**
+ * Check the identifier of the file format and the version of the layout.
+ *
+ * \param[in] in Stream of the checkpoint
+ * \throw runtime_error if the stream does not hold a checkpoint of this
+ *        version
+ */
+void read_header(std::istream &in);
+
+}  // namespace checkpoint
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_CHECKPOINT_H_
@@ -14,10 +14,13 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <istream>
 #include <limits>
+#include <ostream>
 #include <stdexcept>
 #include <vector>
 
+#include "checkpoint.h"
 #include "logging.h"
 
 namespace smash {
@@ -164,6 +167,25 @@ class Clock {
    */
   bool operator>(double time) const { return present_internal_time() > time; }
 
+  /**
+   * Write the state of the clock to a checkpoint.
+   *
+   * \param[out] out Stream of the checkpoint
+   */
+  virtual void write_checkpoint(std::ostream& out) const {
+    checkpoint::write(out, counter_);
+  }
+
+  /**
+   * Restore the state of the clock from a checkpoint written by a clock of
+   * the same type.
+   *
+   * \param[in] in Stream of the checkpoint
+   */
+  virtual void read_checkpoint(std::istream& in) {
+    checkpoint::read(in, counter_);
+  }
+
   virtual ~Clock() = default;
 
  protected:
@@ -335,6 +357,20 @@ class UniformClock : public Clock {
 
   void remove_times_in_past(double) override{};
 
+  void write_checkpoint(std::ostream& out) const override {
+    Clock::write_checkpoint(out);
+    checkpoint::write(out, timestep_duration_);
+    checkpoint::write(out, reset_time_);
+    checkpoint::write(out, time_end_);
+  }
+
+  void read_checkpoint(std::istream& in) override {
+    Clock::read_checkpoint(in);
+    checkpoint::read(in, timestep_duration_);
+    checkpoint::read(in, reset_time_);
+    checkpoint::read(in, time_end_);
+  }
+
   /**
    * Advances the clock by an arbitrary timestep (multiple of 0.000001 fm).
    *
@@ -455,6 +491,18 @@ class CustomClock : public Clock {
                    });
   }
 
+  void write_checkpoint(std::ostream& out) const override {
+    Clock::write_checkpoint(out);
+    checkpoint::write(out, custom_times_);
+    checkpoint::write(out, start_time_);
+  }
+
+  void read_checkpoint(std::istream& in) override {
+    Clock::read_checkpoint(in);
+    checkpoint::read(in, custom_times_);
+    checkpoint::read(in, start_time_);
+  }
+
  protected:
   /**
    * For the CustomClock, the internal time is basically by design the same as
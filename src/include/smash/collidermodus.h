@@ -7,10 +7,13 @@
 #ifndef SRC_INCLUDE_SMASH_COLLIDERMODUS_H_
 #define SRC_INCLUDE_SMASH_COLLIDERMODUS_H_
 
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "deformednucleus.h"
 #include "forwarddeclarations.h"
@@ -65,6 +68,8 @@ class ColliderModus : public ModusDefault {
    **/
   explicit ColliderModus(Configuration modus_config,
                          const ExperimentParameters &parameters);
+  /// Stops the generation of initial states ahead of time
+  ~ColliderModus();
   /**
    * Creates full path string consisting of file_directory and file_name
    * Needed to initialize a customnucleus.
@@ -100,6 +105,59 @@ class ColliderModus : public ModusDefault {
    **/
   void sample_impact();
 
+  /**
+   * Change the collision energy or the impact parameter settings between
+   * events, keeping the nuclei.
+   *
+   * A given Impact section replaces the previous impact parameter settings
+   * completely. Initial states generated ahead of time are dropped.
+   *
+   * \param[inout] modus_config Changed keys of the Modi section. The keys
+   *                            Collider: Sqrtsnn and Collider: Impact are
+   *                            taken, all others are left.
+   * \throw InvalidEnergy if the new sqrt(s_NN) is not large enough to support
+   *                      the colliding masses of the nuclei
+   * \throw domain_error if custom impact parameter Values and Yields are
+   *                     improperly supplied
+   */
+  void reconfigure(Configuration &modus_config);
+
+  /// \return Number of events whose initial states are generated ahead of time
+  int prefetch_depth() const { return prefetch_depth_; }
+
+  /// \return Scattering rate per particle [1/fm] of the freeze-out, 0 if off
+  double freeze_out_rate() const { return freeze_out_rate_; }
+
+  /// \return Whether spectators are left out of the search for collisions
+  bool exclude_spectators() const { return exclude_spectators_; }
+
+  /**
+   * Take the initial state of an event from the ones generated ahead of time
+   * on a background thread, instead of calling sample_impact and
+   * initial_conditions.
+   *
+   * The initial state of an event is sampled from a random number stream
+   * determined by the seed of the event, so that it does not depend on the
+   * number of prefetched events. Once the first initial state was taken, the
+   * nuclei are only used by the background thread. If the event is not the
+   * expected one, the prefetched states are dropped and the generation starts
+   * again from the given event.
+   *
+   * \param[in] event Number of the event.
+   * \param[in] event_stride Distance to the number of the event run after
+   *                         the given one.
+   * \param[in] seed_of_event Gives the random seed of an event.
+   * \param[out] ensembles Empty ensembles, which are filled with the nucleons
+   *                       of the event.
+   * \return The starting time of the simulation.
+   * \throw domain_error if the initial state cannot be generated, see
+   *                     initial_conditions.
+   */
+  double take_prefetched_initial_state(
+      int event, int event_stride,
+      const std::function<int64_t(int)> &seed_of_event,
+      std::vector<Particles> *ensembles);
+
   /// Time until nuclei have passed through each other
   double nuclei_passing_time() const {
     const double passing_distance =
@@ -185,14 +243,6 @@ class ColliderModus : public ModusDefault {
   static std::unique_ptr<DeformedNucleus> create_deformed_nucleus(
       Configuration &nucleus_cfg, const int ntest,
       const std::string &nucleus_type);
-  /**
-   * Checks if target and projectile are read from the same external file if
-   * they are both initialized as a customnucleus. Function is only called if,
-   * projectile is customnucleus.
-   * /param[in] proj_config Configuration of projectile nucleus
-   * /param[in] targ_config Configuration of target nucleus
-   **/
-  bool same_inputfile(Configuration &proj_config, Configuration &targ_config);
   /**
    * Impact parameter.
    *
@@ -215,6 +265,41 @@ class ColliderModus : public ModusDefault {
   std::unique_ptr<InterpolateDataLinear<double>> impact_interpolation_ =
       nullptr;
 
+  /**
+   * Set the center-of-mass energy of a nucleon-nucleon collision and the
+   * corresponding energy of the nucleus-nucleus collision.
+   *
+   * \param[in] sqrt_s_NN Center-of-mass energy of a nucleon-nucleon collision.
+   * \throw InvalidEnergy if it is not larger than the nucleon masses.
+   */
+  void set_sqrt_s_NN(double sqrt_s_NN);
+
+  /**
+   * Set the impact parameter and the way it is sampled from the Impact
+   * section, unspecified settings taking their default values.
+   *
+   * \param[inout] impact_cfg Impact section, whose keys are taken.
+   * \throw domain_error if custom impact parameter Values and Yields are
+   *                     improperly supplied
+   */
+  void take_impact_settings(Configuration &impact_cfg);
+
+  /// \return An impact parameter sampled as described in sample_impact.
+  double draw_impact() const;
+
+  /**
+   * Arrange both nuclei for an impact parameter, boost and shift them into
+   * their starting positions and copy their nucleons into particles.
+   *
+   * \param[in] impact Impact parameter.
+   * \param[out] particles An empty list that gets filled with the nucleons.
+   * \param[out] velocities Velocities of projectile and target.
+   * \return The starting time of the simulation.
+   * \throw domain_error as described in initial_conditions.
+   */
+  double collide_nuclei(double impact, Particles *particles,
+                        std::pair<double, double> *velocities);
+
   /**
    * Rotate the reaction plane about the angle phi
    *
@@ -259,6 +344,17 @@ class ColliderModus : public ModusDefault {
   std::pair<double, double> get_velocities(double mandelstam_s, double m_a,
                                            double m_b);
 
+  /// Number of events whose initial states are generated ahead of time
+  int prefetch_depth_ = 0;
+  /// Scattering rate per particle of the freeze-out, 0 if it is not detected
+  double freeze_out_rate_ = 0.;
+  /// Whether spectators are left out of the search for collisions
+  bool exclude_spectators_ = true;
+  /// Background thread generating initial states and the queue it fills
+  struct InitialStatePipeline;
+  /// Pipeline of prefetched initial states, if they are prefetched
+  std::unique_ptr<InitialStatePipeline> pipeline_;
+
   /**\ingroup logging
    * Writes the initial state for the ColliderModus to the output stream.
    *
@@ -0,0 +1,251 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_COLUMNAROUTPUT_H_
+#define SRC_INCLUDE_SMASH_COLUMNAROUTPUT_H_
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "file.h"
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+
+namespace smash {
+
+/**
+ * Columns of a particle block in the columnar format, in the order in which
+ * they are stored in each chunk.
+ */
+enum class ColumnarField : std::uint8_t {
+  /// Time \f$t\f$ [fm]
+  T,
+  /// Position \f$x\f$ [fm]
+  X,
+  /// Position \f$y\f$ [fm]
+  Y,
+  /// Position \f$z\f$ [fm]
+  Z,
+  /// Effective mass [GeV]
+  Mass,
+  /// Energy [GeV]
+  P0,
+  /// Momentum \f$p_x\f$ [GeV]
+  Px,
+  /// Momentum \f$p_y\f$ [GeV]
+  Py,
+  /// Momentum \f$p_z\f$ [GeV]
+  Pz,
+  /// PDG code
+  Pdg,
+  /// Particle id
+  Id,
+  /// Electric charge
+  Charge
+};
+
+/// Number of columns stored for every particle block
+constexpr std::size_t n_columnar_fields = 12;
+
+/**
+ * \param[in] field Column of the columnar format.
+ * \return Whether the column holds integers rather than real numbers.
+ */
+inline bool is_integer_column(ColumnarField field) {
+  return field >= ColumnarField::Pdg;
+}
+
+/**
+ * \ingroup output
+ * \brief Writes particle lists column by column into a compressed binary file.
+ *
+ * Every particle list that the \ref doxypage_output_binary "Binary" particles
+ * output would write is stored as one chunk, in which the values of every
+ * column (see ColumnarField) are contiguous. The columns of real numbers can be
+ * stored in single precision, and every column is compressed on its own if
+ * SMASH was built with zlib. Hence analyses that need only a few columns read
+ * only those. When the output is closed, an index of the chunks is appended,
+ * with which ColumnarReader jumps directly to the chunks of an event.
+ */
+class ColumnarOutput : public OutputInterface {
+ public:
+  /**
+   * Create the columnar particles output.
+   *
+   * \param[in] path Output path.
+   * \param[in] name Name of the output.
+   * \param[in] out_par A structure containing the parameters of the output.
+   */
+  ColumnarOutput(const std::filesystem::path &path, std::string name,
+                 const OutputParameters &out_par);
+
+  /// Append the index of the chunks to the file.
+  ~ColumnarOutput() override;
+
+  /**
+   * Writes the initial particles of an event as a chunk.
+   * \param[in] particles Current list of all particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &event) override;
+
+  /**
+   * Writes the final particles of an event as a chunk, followed by the event
+   * end record.
+   * \param[in] particles Current list of particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &event) override;
+
+  /**
+   * Writes the particles at an intermediate time as a chunk.
+   * \param[in] particles Current list of particles.
+   * \param[in] clock Unused, needed since inherited.
+   * \param[in] dens_param Unused, needed since inherited.
+   * \param[in] event Unused, needed since inherited.
+   */
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &event) override;
+
+  /// Columnar file format version number
+  static constexpr std::uint16_t format_version = 1;
+
+  /// \return false, the interactions are not used.
+  bool uses_interactions() const override { return false; }
+
+ private:
+  /**
+   * Write the particles as one chunk and add it to the index.
+   * \param[in] particles Particles to be written.
+   * \param[in] event_number Number of the event they belong to.
+   */
+  void write_chunk(const Particles &particles, int event_number);
+
+  /**
+   * Write bytes to the file, keeping track of the file position.
+   * \param[in] data Start of the bytes.
+   * \param[in] n Number of bytes.
+   */
+  void write_bytes(const void *data, std::size_t n);
+
+  /// Columnar output file
+  RenamingFilePtr file_;
+  /// Number of bytes written so far
+  std::uint64_t position_ = 0;
+  /// Number of the current event
+  std::int32_t event_number_ = 0;
+  /// Event numbers and file positions of the chunks written so far
+  std::vector<std::pair<std::int32_t, std::uint64_t>> index_;
+  /// Whether real numbers are stored in single precision
+  const bool single_precision_;
+  /// zlib compression level of the columns, 0 for no compression
+  const int compression_level_;
+  /// Whether initial-state and intermediate particles are written
+  const OutputOnlyFinal only_final_;
+  /// Serialised column, reused between chunks
+  std::vector<char> column_;
+  /// Compressed column, reused between chunks
+  std::vector<char> compressed_;
+};
+
+/**
+ * A particle block of a columnar output file. Only the requested columns are
+ * filled.
+ */
+struct ColumnarChunk {
+  /// Number of the event the particles belong to
+  std::int32_t event_number = 0;
+  /// Number of particles in the block
+  std::uint32_t n_particles = 0;
+  /// Requested columns of real numbers, converted to double precision
+  std::map<ColumnarField, std::vector<double>> reals;
+  /// Requested columns of integers
+  std::map<ColumnarField, std::vector<std::int32_t>> integers;
+};
+
+/**
+ * \ingroup output
+ * \brief Reads the particle blocks of files written by ColumnarOutput.
+ *
+ * The chunks are located through the index at the end of the file. If the
+ * index is missing, because the writing SMASH run did not finish, the chunks
+ * are found by scanning the file once.
+ */
+class ColumnarReader {
+ public:
+  /**
+   * Open a columnar file and read its index.
+   *
+   * \param[in] path Path of the file.
+   * \throw std::runtime_error if the file is not a valid columnar file or
+   *        needs zlib, while SMASH was built without it.
+   */
+  explicit ColumnarReader(const std::filesystem::path &path);
+
+  /// \return Event numbers of all chunks in the order of the file.
+  std::vector<std::int32_t> event_numbers() const;
+
+  /// \return Whether the real numbers are stored in single precision.
+  bool single_precision() const { return single_precision_; }
+
+  /**
+   * Read all chunks of an event, decompressing only the requested columns.
+   *
+   * \param[in] event_number Number of the event.
+   * \param[in] fields Columns to be read.
+   * \return Chunks of the event in the order of the file, empty if there are
+   *         none.
+   */
+  std::vector<ColumnarChunk> read_event(
+      std::int32_t event_number, const std::vector<ColumnarField> &fields);
+
+  /**
+   * Read the chunk at a given position of the index.
+   *
+   * \param[in] i Position of the chunk in the file, counted from 0.
+   * \param[in] fields Columns to be read.
+   * \return The chunk with the requested columns.
+   */
+  ColumnarChunk read_chunk(std::size_t i,
+                           const std::vector<ColumnarField> &fields);
+
+  /// \return Number of chunks in the file.
+  std::size_t size() const { return index_.size(); }
+
+ private:
+  /// Find the chunks by scanning the file from the first chunk on.
+  void scan_chunks();
+
+  /// Columnar file
+  FilePtr file_;
+  /// Event numbers and file positions of the chunks
+  std::vector<std::pair<std::int32_t, std::uint64_t>> index_;
+  /// Whether the real numbers are stored in single precision
+  bool single_precision_ = false;
+  /// Whether the columns are compressed
+  bool compressed_ = false;
+  /// File position of the first chunk
+  std::uint64_t first_chunk_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_COLUMNAROUTPUT_H_
@@ -724,9 +724,55 @@ class Configuration {
       if (s == "Fixed") {
         return TimeStepMode::Fixed;
       }
-      throw IncorrectTypeInAssignment("The value for key \"" +
-                                      std::string(key_) +
-                                      "\" should be \"None\" or \"Fixed\".");
+      if (s == "Adaptive") {
+        return TimeStepMode::Adaptive;
+      }
+      throw IncorrectTypeInAssignment(
+          "The value for key \"" + std::string(key_) +
+          "\" should be \"None\", \"Fixed\" or \"Adaptive\".");
+    }
+
+    /**
+     * Set the policy of binding threads to cores from configuration values.
+     *
+     * \return Thread affinity policy.
+     * \throw IncorrectTypeInAssignment in case a policy that is not
+     * available is provided as a configuration value.
+     */
+    operator ThreadAffinity() const {
+      const std::string s = operator std::string();
+      if (s == "None") {
+        return ThreadAffinity::None;
+      }
+      if (s == "Compact") {
+        return ThreadAffinity::Compact;
+      }
+      if (s == "Scatter") {
+        return ThreadAffinity::Scatter;
+      }
+      throw IncorrectTypeInAssignment(
+          "The value for key \"" + std::string(key_) +
+          "\" should be \"None\", \"Compact\" or \"Scatter\".");
+    }
+
+    /**
+     * Set the evaluation of the interaction density from configuration values.
+     *
+     * \return Mode of evaluating the density at the interaction points.
+     * \throw IncorrectTypeInAssignment in case a mode that is not available is
+     * provided as a configuration value.
+     */
+    operator InteractionDensityMode() const {
+      const std::string s = operator std::string();
+      if (s == "Exact") {
+        return InteractionDensityMode::Exact;
+      }
+      if (s == "Lattice") {
+        return InteractionDensityMode::Lattice;
+      }
+      throw IncorrectTypeInAssignment(
+          "The value for key \"" + std::string(key_) +
+          "\" should be \"Exact\" or \"Lattice\".");
     }
 
     /**
@@ -1171,6 +1217,8 @@ class Configuration {
   void set_value(std::initializer_list<const char *> keys, T &&value) {
     auto node = find_node_creating_it_if_not_existing(keys);
     node = std::forward<T>(value);
+    // The value might be or contain an empty map
+    empty_maps_removed_ = false;
   }
 
   /**
@@ -1311,9 +1359,23 @@ class Configuration {
   std::optional<YAML::Node> find_existing_node(
       std::vector<const char *> keys) const;
 
+  /**
+   * Remove the empty maps after a key was removed from the YAML tree.
+   *
+   * The first call removes all empty maps of the tree. Later calls only
+   * descend along the path of the removed key, since no other map can have
+   * become empty, unless the tree was modified otherwise in between.
+   *
+   * \param[in] keys Keys leading to the node the key was removed from.
+   */
+  void remove_empty_maps_along(std::vector<const char *> keys);
+
   /// The general_config.yaml contents - fully parsed
   YAML::Node root_node_{YAML::NodeType::Map};
 
+  /// Whether the YAML tree is known not to contain any empty map
+  bool empty_maps_removed_ = false;
+
   /// Counter to be able to optionally throw in destructor
   int uncaught_exceptions_{std::uncaught_exceptions()};
 };
@@ -0,0 +1,96 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_COULOMBFIELDSOLVER_H_
+#define SRC_INCLUDE_SMASH_COULOMBFIELDSOLVER_H_
+
+#include <array>
+#include <complex>
+#include <utility>
+#include <vector>
+
+#include "density.h"
+#include "lattice.h"
+#include "threevector.h"
+
+namespace smash {
+
+/**
+ * Computes the electric and magnetic fields of the charge density and
+ * current on a lattice by fast Fourier transforms.
+ *
+ * The fields are the same sums over the nodes within the cube of half edge
+ * length \f$ r_{cut} \f$ around a node, which RectangularLattice::
+ * integrate_volume evaluates with Potentials::E_field_integrand and
+ * Potentials::B_field_integrand. These sums are discrete convolutions of the
+ * charge density and the current with a kernel that only depends on the
+ * distance of the nodes. They are evaluated as products of the Fourier
+ * transforms, which takes \f$ O(M \log M) \f$ operations for M nodes
+ * instead of \f$ O(M K) \f$ for K nodes in the cube. The results agree with
+ * the direct sums up to rounding.
+ *
+ * Non-periodic lattices are padded with zeros in every direction to a power
+ * of two, large enough that the convolution does not wrap around. Periodic
+ * lattices are transformed with their own number of nodes, which takes
+ * \f$ O(n^2) \f$ operations per row of n nodes if n is not a power of two.
+ * The Fourier transforms of the kernel are computed once in the constructor.
+ */
+class CoulombFieldSolver {
+ public:
+  /**
+   * Prepare the solver for lattices of the given geometry.
+   *
+   * \param[in] n_cells Number of nodes in each direction
+   * \param[in] cell_sizes Distance of neighboring nodes in each direction [fm]
+   * \param[in] periodic Whether the lattice is periodic
+   * \param[in] r_cut Half edge length of the cube of nodes that contribute to
+   *            the fields at a node [fm]
+   * \param[in] n_threads Number of threads for the Fourier transforms
+   */
+  CoulombFieldSolver(const std::array<int, 3> &n_cells,
+                     const std::array<double, 3> &cell_sizes, bool periodic,
+                     double r_cut, int n_threads);
+
+  /**
+   * Compute the fields on all nodes.
+   *
+   * \param[in] charge_density Lattice of the electric charge density and
+   *            current, with the geometry given to the constructor
+   * \param[out] fields Lattice of the electric and magnetic fields [fm^-2]
+   */
+  void compute_fields(
+      RectangularLattice<DensityOnLattice> &charge_density,
+      RectangularLattice<std::pair<ThreeVector, ThreeVector>> &fields) const;
+
+ private:
+  /// Complex values on the padded lattice
+  using Spectrum = std::vector<std::complex<double>>;
+
+  /**
+   * Fourier transform of values on the padded lattice in place.
+   *
+   * \param[inout] data Values on the padded lattice
+   * \param[in] inverse Whether to do the inverse transform, which includes
+   *            the division by the number of nodes
+   */
+  void transform(Spectrum &data, bool inverse) const;
+
+  /// Number of nodes of the lattice in each direction
+  std::array<int, 3> n_cells_;
+  /// Number of nodes of the padded lattice in each direction
+  std::array<int, 3> n_padded_;
+  /// Fourier transforms of the components of the kernel
+  std::array<Spectrum, 3> kernel_;
+  /// Number of threads for the Fourier transforms
+  int n_threads_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_COULOMBFIELDSOLVER_H_
@@ -0,0 +1,145 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_CROSSSECTIONCACHE_H_
+#define SRC_INCLUDE_SMASH_CROSSSECTIONCACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "forwarddeclarations.h"
+#include "particletype.h"
+#include "processbranch.h"
+
+namespace smash {
+
+/**
+ * Cache of cross sections of two incoming particle types, binned in
+ * \f$\sqrt{s}\f$.
+ *
+ * In boxes and afterburner runs the same few pairs of particle types collide
+ * over and over again at similar energies. Instead of evaluating all
+ * parametrizations for every candidate pair, the results are stored per pair
+ * of types and \f$\sqrt{s}\f$ bin of width \f$w\f$ and are reused.
+ *
+ * Two kinds of results are cached:
+ * - Parametrized total cross sections are stored at the bin edges and
+ *   interpolated linearly. Where the parametrization is smooth, the error is
+ *   bounded by \f$w^2/8 \max|\sigma''|\f$ within the bin. At a kink of the
+ *   parametrization it is at most \f$w/4\f$ times the change of the slope.
+ * - Lists of collision branches are evaluated at the lower bin edge
+ *   \f$\sqrt{s_0} \le \sqrt{s}\f$. Each partial cross section then deviates by
+ *   at most \f$w \max|d\sigma_i/d\sqrt{s}|\f$, and channels whose threshold
+ *   lies within \f$[\sqrt{s_0}, \sqrt{s})\f$ are missing. A cached branch is
+ *   therefore always kinematically allowed. The steepest slopes are the
+ *   flanks of resonance peaks: for the \f$\Delta(1232)\f$ and
+ *   \f$w = 1\f$ MeV the deviation stays below about 1% of the peak cross
+ *   section.
+ *
+ * The results only depend on the types and \f$\sqrt{s}\f$ if both incoming
+ * particles are stable, such that their masses are fixed, and if there are
+ * no potentials that shift the thresholds. Other pairs are not cached, see
+ * applies_to.
+ *
+ * The cache can be shared by several threads.
+ */
+class CrossSectionCache {
+ public:
+  /**
+   * Create an empty cache.
+   *
+   * \param[in] bin_width Width \f$w\f$ of the \f$\sqrt{s}\f$ bins [GeV]
+   * \throw std::invalid_argument if the bin width is not positive
+   */
+  explicit CrossSectionCache(double bin_width);
+
+  /// \return width of the \f$\sqrt{s}\f$ bins [GeV]
+  double bin_width() const { return bin_width_; }
+
+  /**
+   * Whether the cross sections of the given particles can be taken from the
+   * cache. This requires two stable particles, no potentials and a
+   * \f$\sqrt{s}\f$ whose bin lies completely above the sum of the masses.
+   *
+   * \param[in] incoming Incoming particles
+   * \param[in] sqrt_s Center-of-mass energy [GeV]
+   * \return whether the cache can be used
+   */
+  bool applies_to(const ParticleList &incoming, double sqrt_s) const;
+
+  /**
+   * Look up the total cross section, interpolated linearly between the edges
+   * of the \f$\sqrt{s}\f$ bin. The order of the incoming types does not
+   * matter.
+   *
+   * \param[in] incoming Incoming particles, see applies_to
+   * \param[in] sqrt_s Center-of-mass energy [GeV]
+   * \param[in] evaluate Function computing the total cross section at a
+   *            given \f$\sqrt{s}\f$, called for missing bin edges
+   * \return total cross section [mb]
+   */
+  double total(const ParticleList &incoming, double sqrt_s,
+               const std::function<double(double)> &evaluate);
+
+  /**
+   * Look up the collision branches, evaluated at the lower edge of the
+   * \f$\sqrt{s}\f$ bin. The key keeps the order of the incoming types, since
+   * the final states of the branches refer to it.
+   *
+   * \param[in] incoming Incoming particles, see applies_to
+   * \param[in] sqrt_s Center-of-mass energy [GeV]
+   * \param[in] evaluate Function generating the branches at a given
+   *            \f$\sqrt{s}\f$, called if the bin is not cached yet
+   * \return copy of the cached branches
+   */
+  CollisionBranchList branches(
+      const ParticleList &incoming, double sqrt_s,
+      const std::function<CollisionBranchList(double)> &evaluate);
+
+  /// \return number of look-ups answered from the cache
+  std::uint64_t hits() const;
+
+  /// \return number of look-ups that required an evaluation
+  std::uint64_t misses() const;
+
+ private:
+  /// Pair of incoming types and index of the \f$\sqrt{s}\f$ bin
+  using Key = std::tuple<ParticleTypePtr, ParticleTypePtr, std::int64_t>;
+
+  /**
+   * \param[in] sqrt_s Center-of-mass energy [GeV]
+   * \return index of the bin containing sqrt_s
+   */
+  std::int64_t bin_of(double sqrt_s) const;
+
+  /// Width of the \f$\sqrt{s}\f$ bins [GeV]
+  const double bin_width_;
+
+  /// Total cross sections at the lower edges of the bins [mb]
+  std::map<Key, double> totals_;
+
+  /// Collision branches at the lower edges of the bins
+  std::map<Key, CollisionBranchList> branches_;
+
+  /// Number of look-ups answered from the cache
+  std::uint64_t hits_ = 0;
+
+  /// Number of look-ups that required an evaluation
+  std::uint64_t misses_ = 0;
+
+  /// Guards the maps and counters
+  mutable std::mutex mutex_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_CROSSSECTIONCACHE_H_
@@ -10,9 +10,12 @@
 #ifndef SRC_INCLUDE_SMASH_CROSSSECTIONS_H_
 #define SRC_INCLUDE_SMASH_CROSSSECTIONS_H_
 
+#include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "decaymodes.h"
 #include "forwarddeclarations.h"
 #include "isoparticletype.h"
 #include "particles.h"
@@ -117,15 +120,15 @@ class CrossSections {
   /**
    * Return the 2-to-1 resonance production cross section for a given resonance.
    *
-   * \param[in] type_resonance Type information for the resonance to be
-   * produced.
+   * \param[in] candidate The resonance to be produced, with its decay modes
+   * into the incoming particles.
    * \param[in] cm_momentum_sqr Square of the center-of-mass momentum of the
    * two initial particles.
    *
    * \return The cross section for the process
    * [initial particle a] + [initial particle b] -> resonance.
    */
-  double formation(const ParticleType& type_resonance,
+  double formation(const FormationCandidate& candidate,
                    double cm_momentum_sqr) const;
 
   /**
@@ -356,7 +359,153 @@ class CrossSections {
   double probability_transit_high(double region_lower,
                                   double region_upper) const;
 
+  /**
+   * Build the table of the routines that apply to each pair of particle types,
+   * which is otherwise lazily created on its first use.
+   *
+   * The table is shared by all threads and must be created before cross
+   * sections are evaluated concurrently.
+   */
+  static void initialize_dispatch_table();
+
  private:
+  /// Specific function that finds the inelastic 2->2 processes of a pair.
+  enum class TwoToTwoRoutine : std::uint8_t {
+    /// No inelastic 2->2 processes
+    None,
+    /// nn_xx()
+    NN,
+    /// bb_xx_except_nn()
+    BBExceptNN,
+    /// nk_xx()
+    NK,
+    /// ypi_xx()
+    YPi,
+    /// deltak_xx()
+    DeltaK,
+    /// dn_xx()
+    DN,
+    /// dpi_xx()
+    DPi,
+  };
+
+  /// Parametrization chosen by elastic_parametrization().
+  enum class ElasticRoutine : std::uint8_t {
+    /// No parametrized elastic cross section
+    None,
+    /// npi_el()
+    NPi,
+    /// nk_el()
+    NK,
+    /// nn_el() of two nucleons or two antinucleons
+    NN,
+    /// ppbar_elastic()
+    NNbar,
+    /// deuteron_pion_elastic()
+    DeuteronPion,
+    /// deuteron_nucleon_elastic()
+    DeuteronNucleon,
+    /// nn_el() scaled with the AQM
+    AQMBaryonBaryon,
+    /// piplusp_elastic_high_energy() scaled with the AQM
+    AQMMesonBaryon,
+    /// piplusp_elastic_AQM() scaled with the AQM
+    AQMMesonMeson,
+    /// As AQMMesonMeson, but switched off close to the threshold
+    AQMPiPlusPiMinus,
+  };
+
+  /// Parametrization chosen by high_energy().
+  enum class HighEnergyRoutine : std::uint8_t {
+    /// No high energy cross section
+    None,
+    /// pp_high_energy()
+    PP,
+    /// np_high_energy()
+    NP,
+    /// Transition from ppbar_total() to ppbar_high_energy()
+    PPbar,
+    /// Transition from ppbar_total() to npbar_high_energy()
+    NPbar,
+    /// piplusp_high_energy()
+    PiPlusP,
+    /// piminusp_high_energy(), also the default for baryon-meson pairs
+    PiMinusP,
+    /// piplusp_high_energy() scaled down to meson-meson pairs
+    MesonMeson,
+  };
+
+  /// Offset of the string threshold used by string_probability().
+  enum class StringOffset : std::uint8_t {
+    /// StringTransitionParameters::sqrts_add_lower
+    Default,
+    /// StringTransitionParameters::KN_offset of K+ p and K0 p
+    KN,
+    /// StringTransitionParameters::pipi_offset
+    PiPi,
+  };
+
+  /**
+   * Routines that can contribute to the collisions of a pair of particle
+   * types. They only depend on the types, so they are tabulated once for all
+   * pairs instead of being determined for every collision.
+   */
+  struct Dispatch {
+    /// Function for the inelastic 2->2 processes
+    TwoToTwoRoutine two_to_two = TwoToTwoRoutine::None;
+    /// Whether two_to_three() can find a process
+    bool two_to_three = false;
+    /// Whether two_to_four() can find a process
+    bool two_to_four = false;
+    /// Whether the pair consists of two nucleons or two antinucleons
+    bool nucleon_pair = false;
+    /// Whether the pair consists of a nucleon and an antinucleon
+    bool nucleon_antinucleon_pair = false;
+    /// Whether the pair consists of a nucleon and a pion
+    bool nucleon_pion_pair = false;
+    /**
+     * Whether the strings of the pair are described by the AQM if it is
+     * enabled: two baryons, two antibaryons, a baryon and a meson or two
+     * mesons
+     */
+    bool aqm_pair = false;
+    /// Parametrization of the elastic cross section
+    ElasticRoutine elastic = ElasticRoutine::None;
+    /// Parametrization of the high energy cross section
+    HighEnergyRoutine high_energy = HighEnergyRoutine::None;
+    /// Offset of the string threshold
+    StringOffset string_offset = StringOffset::Default;
+    /// AQM scaling factor from the strangeness of both particles
+    double aqm_factor = 1.;
+  };
+
+  /**
+   * Determine the routines for a pair of particle types.
+   *
+   * \param[in] type_a first incoming particle type
+   * \param[in] type_b second incoming particle type
+   * \return Routines that can contribute to the collisions of the pair.
+   */
+  static Dispatch find_dispatch(const ParticleType& type_a,
+                                const ParticleType& type_b);
+
+  /**
+   * Look up the routines for a pair of particle types from the table, which is
+   * rebuilt if the number of particle types has changed.
+   *
+   * \param[in] type_a first incoming particle type
+   * \param[in] type_b second incoming particle type
+   * \return Routines that can contribute to the collisions of the pair.
+   */
+  static const Dispatch& dispatch(const ParticleType& type_a,
+                                  const ParticleType& type_b);
+
+  /**
+   * Routines of all pairs of particle types, indexed by the positions of the
+   * types in ParticleType::list_all().
+   */
+  inline static std::vector<Dispatch> dispatch_table_;
+
   /**
    * Choose the appropriate parametrizations for given incoming particles and
    * return the (parametrized) elastic cross section.
@@ -7,8 +7,7 @@
 #ifndef SRC_INCLUDE_SMASH_CUSTOMNUCLEUS_H_
 #define SRC_INCLUDE_SMASH_CUSTOMNUCLEUS_H_
 
-#include <fstream>
-#include <map>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,6 +36,10 @@ struct Nucleoncustom {
 /**
  * Inheriting from Nucleus-Class using modified Nucleon configurations.
  * Configurations are read in from external lists.
+ *
+ * Each list is parsed once and kept in memory, shared by all nuclei reading
+ * it, and every time the nucleons are arranged one of its configurations is
+ * drawn at random.
  */
 class CustomNucleus : public Nucleus {
  public:
@@ -48,28 +51,32 @@ class CustomNucleus : public Nucleus {
    * numbers of particles with a certain PDG code and also the path where
    * the external particle list is located
    * \param[in] testparticles represents the number of testparticles
-   * \param[in] same_file specifies if target and projectile nucleus are
-   * read in from the same file, which is important for the ifstream
+   * \throw runtime_error if the external list does not consist of
+   *                      configurations with the given numbers of protons
+   *                      and neutrons
    */
-  CustomNucleus(Configuration& config, int testparticles, bool same_file);
+  CustomNucleus(Configuration& config, int testparticles);
   /**
-   * Fills Particlelist from vector containing data for one nucleus.
-   * The data contains everything that is written in struct Nucleoncustom.
+   * Fills Particlelist with the protons and neutrons of one configuration of
+   * the external list.
    *
-   * \param[in] vec vector containing data from external list for one nucleus
+   * \param[in] configuration index of the configuration in the list
    */
-  void fill_from_list(const std::vector<Nucleoncustom>& vec);
+  void fill_from_list(std::size_t configuration);
   /// Returns position of a nucleon as given in the external file
   ThreeVector distribute_nucleon() override;
-  /// Sets the positions of the nucleons inside a nucleus.
+  /// Sets the positions of the nucleons of a randomly drawn configuration.
   void arrange_nucleons() override;
   /**
-   * The returned vector contains Data for one nucleus given in the
-   * particlelist.
+   * Parses the nucleons of all configurations in an external list, or
+   * returns them from memory if the list is already in use.
    *
-   * \param[in] infile is needed to read in from the external file
+   * \param[in] path path of the external file
+   * \return nucleons of all configurations, one after the other
+   * \throw runtime_error if a line of the file cannot be read
    */
-  std::vector<Nucleoncustom> readfile(std::ifstream& infile) const;
+  static std::shared_ptr<const std::vector<Nucleoncustom>> read_configurations(
+      const std::string& path);
   /**
    * Generates the name of the stream file.
    * \param[in] file_directory is the path to the external file
@@ -85,24 +92,13 @@ class CustomNucleus : public Nucleus {
   void generate_fermi_momenta() override;
 
  private:
-  /**
-   * Filestream variable used if projectile and target are read in from the
-   * same file and they use the same static stream.
-   */
-  /*
-   * The unique_ptr is only required to work around a bug in GCC 4.8, because it
-   * seems to be trying to use the non-existing copy-constructor of
-   * `std::ifstream`. Newer compilers don't require this unneccessary
-   * indirection.
-   */
-  static std::unique_ptr<std::ifstream> filestream_shared_;
-  /**
-   * Filestream variable used if projectile and target are read in from
-   * different files and they therefore use different streams.
-   */
-  std::unique_ptr<std::ifstream> filestream_;
-  /// Pointer to the used filestream pointer
-  std::unique_ptr<std::ifstream>* used_filestream_;
+  /// Nucleons of all configurations in the external list, see
+  /// read_configurations
+  std::shared_ptr<const std::vector<Nucleoncustom>> configurations_;
+  /// Number of configurations in the external list
+  std::size_t number_of_configurations_ = 0;
+  /// Index of the configuration the nucleons are arranged in
+  std::size_t configuration_ = 0;
   /**
    * Number of nucleons per nucleus
    * Set initally to zero to be modified in the constructor.
@@ -114,9 +110,7 @@ class CustomNucleus : public Nucleus {
   int number_of_protons_ = 0;
   /// Number of neutrons per nucleus
   int number_of_neutrons_ = 0;
-  /// Vector contianing Data for one nucleus given in the particlelist
-  std::vector<Nucleoncustom> custom_nucleus_;
-  /// Index needed to read out vector in distribute nucleon
+  /// Index of the next nucleon of the configuration in distribute_nucleon
   size_t index_ = 0;
 };
 
@@ -54,6 +54,13 @@ class DecayActionsFinder : public ActionFinderInterface {
     return {};
   }
 
+  /// Ignore the shifted neighbor searches for decays
+  ActionList find_actions_with_shifted_neighbors(
+      const ParticleList &, const ThreeVector &, const ParticleList &, double,
+      const std::vector<FourVector> &) const override {
+    return {};
+  }
+
   /// Ignore the surrounding searches for decays
   ActionList find_actions_with_surrounding_particles(
       const ParticleList &, const Particles &, double,
@@ -64,15 +71,29 @@ class DecayActionsFinder : public ActionFinderInterface {
   /**
    * Force all resonances to decay at the end of the simulation.
    *
-   * \param[in] search_list All particles at the end of simulation.
+   * \param[in] search_list Particles at the end of simulation, all of them
+   *                        or the products of the previous final decays.
    * \param[in] only_res optional parameter that requests that only actions
    *                     regarding resonances are considered (disregarding
    *                     stable particles)
    * \return List with the found (Decay)Action objects.
    */
-  ActionList find_final_actions(const Particles &search_list,
+  ActionList find_final_actions(const ParticleList &search_list,
                                 bool only_res = false) const override;
 
+  /**
+   * Sample the decay times of all resonances once and store them with the
+   * particles.
+   *
+   * Only resonances without a decay time, i.e. the ones that interacted since
+   * the last call, and those whose decay did not happen at the scheduled time
+   * are sampled. find_actions_in_cell then uses the stored decay times
+   * instead of evaluating the widths in every time step.
+   *
+   * \param[in,out] particles The particles to schedule the decays of.
+   */
+  void schedule_decays(Particles &particles) const;
+
   /// Multiplicative factor to be applied to resonance lifetimes
   const double res_lifetime_factor_ = 1.;
 
@@ -88,6 +109,16 @@ class DecayActionsFinder : public ActionFinderInterface {
    */
   const bool decay_initial_particles_ =
       InputKeys::collTerm_decayInitial.default_value();
+
+ private:
+  /**
+   * Sample the time until the decay of a particle in the computational frame.
+   *
+   * \param[in] p The decaying particle.
+   * \param[in] width Total hadronic width of the particle [GeV].
+   * \return Decay time relative to the particle's current time [fm].
+   */
+  double sample_decay_time(const ParticleData &p, double width) const;
 };
 
 }  // namespace smash
@@ -10,6 +10,9 @@
 #ifndef SRC_INCLUDE_SMASH_DECAYACTIONSFINDERDILEPTON_H_
 #define SRC_INCLUDE_SMASH_DECAYACTIONSFINDERDILEPTON_H_
 
+#include <vector>
+
+#include "forwarddeclarations.h"
 #include "outputinterface.h"
 
 namespace smash {
@@ -29,17 +32,24 @@ namespace smash {
  */
 class DecayActionsFinderDilepton {
  public:
-  /// Initialize the finder
-  DecayActionsFinderDilepton() {}
+  /**
+   * Initialize the finder, recording which particle types have dilepton decay
+   * modes. The decay modes have to be loaded before.
+   */
+  DecayActionsFinderDilepton();
 
   /**
    * Check the whole particles list and print out possible dilepton decays.
    *
+   * The partial widths of every particle are evaluated once and the decays
+   * are written to all dilepton outputs.
+   *
    * \param[in] search_list List of all particles.
-   * \param[in] output Pointer to the dilepton output.
+   * \param[in] outputs All outputs, of which only the dilepton outputs are
+   *                    written.
    * \param[in] dt Length of timestep [fm]
    */
-  void shine(const Particles& search_list, OutputInterface* output,
+  void shine(const Particles& search_list, const OutputsList& outputs,
              double dt) const;
 
   /**
@@ -48,14 +58,36 @@ class DecayActionsFinderDilepton {
    * This is special, because the shining time is now until the resonance would
    * decay and not for some fixed dt interval.
    *
-   * \param[in] search_list List of all particles.
-   * \param[in] output Pointer to the dilepton output.
+   * \param[in] search_list Particles to shine, all of them or the products
+   *                        of the previous final decays.
+   * \param[in] outputs All outputs, of which only the dilepton outputs are
+   *                    written.
    * \param[in] only_res optional parameter that requests that only actions
    *                     regarding resonances are considered (disregarding
    *                     stable particles)
    */
-  void shine_final(const Particles& search_list, OutputInterface* output,
+  void shine_final(const ParticleList& search_list, const OutputsList& outputs,
                    bool only_res = false) const;
+
+ private:
+  /**
+   * Write the dilepton decays of a particle to the dilepton outputs.
+   *
+   * \param[in] p The decaying particle.
+   * \param[in] modes The decay modes of the particle with their widths, of
+   *                  which the dilepton decays are written.
+   * \param[in] factor Factor of the width in the shining weight.
+   * \param[in] divisor Divisor of the width in the shining weight.
+   * \param[in] outputs The dilepton outputs.
+   */
+  static void shine_decays(const ParticleData& p, DecayBranchList& modes,
+                           double factor, double divisor,
+                           const std::vector<OutputInterface*>& outputs);
+
+  /// Whether a type has a dilepton decay mode, by ParticleTypePtr::index
+  std::vector<bool> has_dilepton_modes_;
+  /// Whether a type has another decay mode, by ParticleTypePtr::index
+  std::vector<bool> has_other_modes_;
 };
 
 }  // namespace smash
@@ -7,15 +7,29 @@
 #ifndef SRC_INCLUDE_SMASH_DECAYMODES_H_
 #define SRC_INCLUDE_SMASH_DECAYMODES_H_
 
+#include <cstddef>
 #include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "processbranch.h"
+#include "tabulationbundle.h"
 
 namespace smash {
 
+/**
+ * A resonance that can be formed from a given pair of particles, see
+ * DecayModes::formation_candidates.
+ */
+struct FormationCandidate {
+  /// Type of the resonance
+  ParticleTypePtr resonance;
+  /// Indices in the decay_mode_list of the resonance of its decays into the
+  /// pair
+  std::vector<std::size_t> in_modes;
+};
+
 /**
  * \ingroup data
  *
@@ -42,11 +56,10 @@ class DecayModes {
   /**
    * Add a decay mode from an already existing decay branch
    *
+   * \param[in] mother the particle which decays
    * \param[in] branch the decay branch to add
    */
-  void add_mode(DecayBranchPtr branch) {
-    decay_modes_.push_back(std::move(branch));
-  }
+  void add_mode(ParticleTypePtr mother, DecayBranchPtr branch);
 
   /**
    * Renormalize the branching ratios to add up to 1.
@@ -62,6 +75,35 @@ class DecayModes {
   /// \return pass out the decay modes list
   const DecayBranchList &decay_mode_list() const { return decay_modes_; }
 
+  /**
+   * \return for every entry of decay_mode_list, the force scale of the
+   *         Skyrme or VDF potential (first) and of the symmetry potential
+   *         (second) of the mother minus those of the products, see
+   *         Potentials::force_scale. The symmetry scales are weighted with the
+   *         relative isospin projections.
+   */
+  const std::vector<std::pair<double, double>> &potential_scales() const {
+    return potential_scales_;
+  }
+
+  /**
+   * \return the tabulation of the total width of the mother over its mass,
+   *         which is empty unless tabulate_widths was called, cf.
+   *         ParticleType::total_width
+   */
+  const Tabulation &total_width_tabulation() const {
+    return total_width_tabulation_;
+  }
+
+  /**
+   * \return the tabulation of the hadronic width of the mother over its mass,
+   *         which is empty unless tabulate_widths was called, cf.
+   *         ParticleType::hadronic_width
+   */
+  const Tabulation &hadronic_width_tabulation() const {
+    return hadronic_width_tabulation_;
+  }
+
   /**
    * Loads the DecayModes map as described in the \p input string.
    *
@@ -97,6 +139,75 @@ class DecayModes {
   static DecayType *get_decay_type(ParticleTypePtr mother,
                                    ParticleTypePtrList particle_types, int L);
 
+  /**
+   * Create a decay type of the class matching the products, without looking
+   * for an existing one.
+   *
+   * \param[in] mother the decaying particle
+   * \param[in] particle_types the products of the decay
+   * \param[in] L the angular momentum
+   * \return the new DecayType object
+   * \throw InvalidDecay if there are less than 2 or more than 3 products
+   */
+  static DecayTypePtr create_decay_type(ParticleTypePtr mother,
+                                        ParticleTypePtrList particle_types,
+                                        int L);
+
+  /**
+   * Replace all decay types and decay modes by already created ones, instead
+   * of loading them with load_decaymodes.
+   *
+   * \param[in] decay_types all decay types the decay modes refer to
+   * \param[in] decay_modes the decay modes of every particle type, with the
+   *                        indexing of ParticleType::list_all
+   */
+  static void set_decaymodes(std::vector<DecayTypePtr> decay_types,
+                             std::vector<DecayModes> decay_modes);
+
+  /**
+   * Build the tabulations of all decay types that tabulate their widths,
+   * instead of letting them be built on first use.
+   *
+   * Tabulations found in the bundle are used directly. The missing ones are
+   * calculated on all hardware threads and added to the bundle. Since the
+   * widths of decays into unstable particles depend on the widths of the
+   * decays of these particles, the decay types are tabulated in order of
+   * their decay chains, in parallel within each step.
+   *
+   * \param[inout] bundle Cached tabulations.
+   * \return Number of tabulations added to the bundle.
+   * \throw runtime_error if the decay modes form a cycle.
+   */
+  static std::size_t tabulate_decay_types(TabulationBundle &bundle);
+
+  /**
+   * Tabulate the total and the hadronic widths of all unstable particle types
+   * over mass, from the minimal kinematic mass up to 10 pole widths (at least
+   * 2 GeV) above it. The tabulations are dropped with the decay modes when
+   * these are loaded again.
+   *
+   * This is not thread-safe and has to be done once during the setup, after
+   * the decay types are tabulated.
+   *
+   * \param[inout] bundle Cached tabulations. The missing ones are added.
+   * \return Number of tabulations added to the bundle.
+   */
+  static std::size_t tabulate_widths(TabulationBundle &bundle);
+
+  /**
+   * List the resonances that can be formed from two particles, i.e. the
+   * unstable particle types (other than the incoming ones) with a two-body
+   * decay into them. The lists of all pairs are built whenever the decay modes
+   * are loaded or replaced, so that they can be read concurrently.
+   *
+   * \param[in] type_a first incoming particle
+   * \param[in] type_b second incoming particle
+   * \return the candidates in the order of ParticleType::list_all, which is
+   *         empty if no resonance can be formed
+   */
+  static const std::vector<FormationCandidate> &formation_candidates(
+      ParticleTypePtr type_a, ParticleTypePtr type_b);
+
   /// \ingroup exception
   struct InvalidDecay : public std::invalid_argument {
     using std::invalid_argument::invalid_argument;
@@ -122,6 +233,18 @@ class DecayModes {
    */
   DecayBranchList decay_modes_;
 
+  /// Differences of the potential scales of every mode, see potential_scales
+  std::vector<std::pair<double, double>> potential_scales_;
+
+  /// Tabulation of the total width, see total_width_tabulation
+  Tabulation total_width_tabulation_;
+
+  /// Tabulation of the hadronic width, see hadronic_width_tabulation
+  Tabulation hadronic_width_tabulation_;
+
+  /// Build the lists of formation_candidates of all pairs of particles.
+  static void build_formation_candidates();
+
   /// allow ParticleType::decay_modes to access all_decay_modes
   friend const DecayModes &ParticleType::decay_modes() const;
 
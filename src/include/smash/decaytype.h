@@ -9,6 +9,8 @@
 #define SRC_INCLUDE_SMASH_DECAYTYPE_H_
 
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "forwarddeclarations.h"
@@ -81,6 +83,28 @@ class DecayType {
   /// \return whether the decay is a dilepton decay (most decays are hadronic)
   virtual bool is_dilepton_decay() const { return false; }
 
+  /**
+   * \return Name of the tabulation of the width in a TabulationBundle, or an
+   *         empty string if the width of this decay type is not tabulated.
+   */
+  virtual std::string tabulation_name() const { return {}; }
+
+  /**
+   * Calculate the tabulation of the width without storing it. Only decay types
+   * with a tabulation_name() have one.
+   *
+   * \return The tabulation.
+   */
+  virtual Tabulation calculate_tabulation() const { return Tabulation(); }
+
+  /**
+   * Use the given tabulation of the width. Decay types otherwise calculate it
+   * on first use, which must not happen on several threads at once.
+   *
+   * \param[in] tabulation Tabulation as given by calculate_tabulation().
+   */
+  virtual void set_tabulation([[maybe_unused]] Tabulation tabulation) {}
+
  protected:
   /// final-state particles of the decay
   ParticleTypePtrList particle_types_;
@@ -207,6 +231,23 @@ class TwoBodyDecaySemistable : public TwoBodyDecay {
   double in_width(double m0, double G0, double m, double m1,
                   double m2) const override;
 
+  /**
+   * See DecayType::tabulation_name.
+   */
+  std::string tabulation_name() const override;
+
+  /**
+   * See DecayType::calculate_tabulation.
+   */
+  Tabulation calculate_tabulation() const override;
+
+  /**
+   * See DecayType::set_tabulation.
+   */
+  void set_tabulation(Tabulation tabulation) override {
+    tabulation_ = std::make_unique<Tabulation>(std::move(tabulation));
+  }
+
  protected:
   /**
    * See TwoBodyDecay::rho.
@@ -252,6 +293,23 @@ class TwoBodyDecayUnstable : public TwoBodyDecay {
   double in_width(double m0, double G0, double m, double m1,
                   double m2) const override;
 
+  /**
+   * See DecayType::tabulation_name.
+   */
+  std::string tabulation_name() const override;
+
+  /**
+   * See DecayType::calculate_tabulation.
+   */
+  Tabulation calculate_tabulation() const override;
+
+  /**
+   * See DecayType::set_tabulation.
+   */
+  void set_tabulation(Tabulation tabulation) override {
+    tabulation_ = std::make_unique<Tabulation>(std::move(tabulation));
+  }
+
  protected:
   /**
    * See TwoBodyDecay::rho.
@@ -357,6 +415,23 @@ class ThreeBodyDecayDilepton : public ThreeBodyDecay {
 
   bool is_dilepton_decay() const override { return true; }
 
+  /**
+   * See DecayType::tabulation_name.
+   */
+  std::string tabulation_name() const override;
+
+  /**
+   * See DecayType::calculate_tabulation.
+   */
+  Tabulation calculate_tabulation() const override;
+
+  /**
+   * See DecayType::set_tabulation.
+   */
+  void set_tabulation(Tabulation tabulation) override {
+    tabulation_ = std::make_unique<Tabulation>(std::move(tabulation));
+  }
+
  protected:
   /// Tabulation of the resonance integrals.
   mutable std::unique_ptr<Tabulation> tabulation_;
@@ -7,12 +7,16 @@
 #ifndef SRC_INCLUDE_SMASH_DEFORMEDNUCLEUS_H_
 #define SRC_INCLUDE_SMASH_DEFORMEDNUCLEUS_H_
 
+#include <array>
+#include <filesystem>
 #include <map>
+#include <vector>
 
 #include "angles.h"
 #include "configuration.h"
 #include "forwarddeclarations.h"
 #include "nucleus.h"
+#include "sha256.h"
 #include "threevector.h"
 
 namespace smash {
@@ -57,11 +61,40 @@ class DeformedNucleus : public Nucleus {
   /**
    * Deformed Woods-Saxon sampling routine.
    *
+   * The deformed radius is tabulated on a grid of the cosine of the polar
+   * angle and, for triaxial nuclei, of the azimuthal angle. The cosine is
+   * sampled from its tabulated inverse cumulative distribution, the azimuthal
+   * angle from the conditional inverse cumulative distributions of the
+   * neighbouring polar angles, and \f$r^3\f$ from the inverse cumulative
+   * distributions tabulated for the neighbouring deformed radii. The tables
+   * are built on the first call and whenever the parameters changed.
+   *
    * \return Spatial position from uniformly sampling
    * the deformed woods-saxon distribution
    */
   ThreeVector distribute_nucleon() override;
 
+  /**
+   * Choose between the tabulated sampling and the rejection sampling of the
+   * exact density, which is only meant for testing.
+   *
+   * \param[in] tabulated Whether the nucleons are sampled from the tables
+   */
+  void set_tabulated_sampling(bool tabulated) {
+    tabulated_sampling_ = tabulated;
+  }
+
+  /**
+   * Cache the saturation densities in the tabulations directory, next to the
+   * other tabulations of the run.
+   *
+   * \param[in] hash Hash of the particle properties of the tabulations
+   * \param[in] tabulations_path Tabulations directory, nothing is cached if
+   *            it is empty
+   */
+  static void set_tabulation_cache(
+      sha256::Hash hash, const std::filesystem::path &tabulations_path);
+
   /**
    * Sets the deformation parameters of the radius according to the current
    * mass number.
@@ -94,6 +127,11 @@ class DeformedNucleus : public Nucleus {
    * and nucleus_azimuthal_angle_ and updates nucleon positions.
    */
   void rotate() override;
+  /**
+   * Rotates a configuration drawn from the library like a newly arranged
+   * nucleus, since it was sampled in the orientation of the deformation.
+   */
+  void rotate_configuration() override { rotate(); }
 
   /**
    * \return the saturation density of the deformed_nucleus
@@ -110,6 +148,14 @@ class DeformedNucleus : public Nucleus {
    * \return The Woods-Saxon density
    */
   double nucleon_density(double r, double cosx, double phi) const override;
+  /**
+   * Return the radius of the deformed nucleus in the given direction.
+   *
+   * \param[in] cosx The cosine of the polar angle
+   * \param[in] phi The azimuthal angle
+   * \return The deformed radius
+   */
+  double deformed_radius(double cosx, double phi) const;
   /**
    * Return the unnormalized deformed Woods-Saxon distribution for the given
    * position.
@@ -136,6 +182,8 @@ class DeformedNucleus : public Nucleus {
    * Woods-Saxon distribution yields the number of particles in the nucleus
    * \f$\int\rho(r)d^3r = N_{particles}\f$.
    *
+   * The result is read from and written to the tabulations directory, if one
+   * is set by set_tabulation_cache.
    */
   double calculate_saturation_density() const override;
   /**
@@ -208,6 +256,44 @@ class DeformedNucleus : public Nucleus {
    * Whether the nuclei should be rotated randomly.
    */
   bool random_rotation_ = false;
+  /// Whether the nucleons are sampled from the tables
+  bool tabulated_sampling_ = true;
+  /**
+   * Deformed radius at equidistant cosines of the polar angle from -1 to 1
+   * (rows) and equidistant azimuthal angles from 0 to \f$2\pi\f$ (columns)
+   */
+  std::vector<double> radius_table_;
+  /// Number of intervals of the azimuthal angle in radius_table_
+  size_t n_phi_intervals_ = 1;
+  /// Inverse cumulative distribution of the cosine of the polar angle
+  Tabulation costheta_inverse_cdf_;
+  /**
+   * Inverse cumulative distributions of the azimuthal angle at the cosines of
+   * the rows of radius_table_, empty without triaxiality
+   */
+  std::vector<Tabulation> phi_inverse_cdfs_;
+  /// Smallest deformed radius in radius_table_
+  double radius_min_ = 0.;
+  /// Spacing of the deformed radii of radial_inverse_cdfs_
+  double radius_step_ = 0.;
+  /**
+   * Inverse cumulative distributions of \f$r^3\f$ at equidistant deformed
+   * radii from radius_min_ on
+   */
+  std::vector<Tabulation> radial_inverse_cdfs_;
+  /// Radius, diffusiveness and deformation the tables were built for
+  std::array<double, 6> inverse_cdf_parameters_ = {};
+  /// Build the tables of the inverse cumulative distributions.
+  void tabulate_inverse_cdfs();
+  /**
+   * \return the saturation density integrated numerically, without the cache.
+   * \see calculate_saturation_density
+   */
+  double integrate_saturation_density() const;
+  /// Hash of the particle properties of the cached saturation densities
+  inline static sha256::Hash tabulation_cache_hash_ = {};
+  /// Tabulations directory caching the saturation densities, if not empty
+  inline static std::filesystem::path tabulation_cache_path_ = {};
 };
 
 }  // namespace smash
@@ -9,9 +9,13 @@
 #ifndef SRC_INCLUDE_SMASH_DENSITY_H_
 #define SRC_INCLUDE_SMASH_DENSITY_H_
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <tuple>
+#include <type_traits>
 #include <typeinfo>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -20,6 +24,7 @@
 #include "forwarddeclarations.h"
 #include "fourvector.h"
 #include "lattice.h"
+#include "parallel.h"
 #include "particledata.h"
 #include "particles.h"
 #include "pdgcode.h"
@@ -167,6 +172,14 @@ class DensityParameters {
   double norm_factor_sf() const { return norm_factor_sf_; }
   /// \return counting only participants (true) or also spectators (false)
   bool only_participants() const { return only_participants_; }
+  /**
+   * Set the number of threads used to smear the particles onto lattices.
+   *
+   * \param[in] threads Number of threads, at least 1
+   */
+  void set_threads(int threads) { threads_ = std::max(threads, 1); }
+  /// \return Number of threads used to smear the particles onto lattices
+  int threads() const { return threads_; }
 
  private:
   /// Gaussian smearing width [fm]
@@ -195,6 +208,8 @@ class DensityParameters {
   const double triangular_range_;
   /// Flag to take into account only participants
   bool only_participants_;
+  /// Number of threads used to smear the particles onto lattices
+  int threads_ = 1;
 };
 
 /**
@@ -218,6 +233,72 @@ std::pair<double, ThreeVector> unnormalized_smearing_factor(
     const ThreeVector &r, const FourVector &p, const double m_inv,
     const DensityParameters &dens_par, const bool compute_gradient = false);
 
+/**
+ * Evaluates the Gaussian smearing factor of one particle on the nodes of a
+ * lattice. The result is the one of unnormalized_smearing_factor up to
+ * rounding, but most nodes do without an exponential.
+ *
+ * RectangularLattice::iterate_in_cube visits the nodes of a row in x
+ * direction in increasing order, and the nodes of a row within the cutoff
+ * are consecutive. Along the row, the exponent is a quadratic polynomial of
+ * the node index. The exponential at the next node is therefore the current
+ * one times a step factor, which itself changes by a constant factor per
+ * node. Only the first node of a row within the cutoff evaluates the
+ * exponentials.
+ */
+class GaussianSmearingKernel {
+ public:
+  /**
+   * Prepare the kernel for one particle.
+   *
+   * \param[in] p particle 4-momentum to account for Lorentz contraction [GeV]
+   * \param[in] m_inv inverse particle mass, \f$ (E^2 - p^2)^{-1/2} \f$
+   *            [GeV\f$^{-1}\f$]
+   * \param[in] dens_par object containing precomputed parameters for
+   *            density calculation.
+   * \param[in] cell_size_x distance of neighboring nodes in x direction [fm]
+   */
+  GaussianSmearingKernel(const FourVector &p, double m_inv,
+                         const DensityParameters &dens_par,
+                         double cell_size_x);
+
+  /**
+   * Smearing factor at a node.
+   *
+   * \param[in] r vector from the node to the particle [fm]
+   * \param[in] ix, iy, iz unwrapped indices of the node, as passed by
+   *            RectangularLattice::iterate_in_cube
+   * \param[in] compute_gradient option, true - compute gradient, false - no
+   * \return (smearing factor, the gradient of the smearing factor or a zero
+   *         three vector)
+   */
+  std::pair<double, ThreeVector> operator()(const ThreeVector &r, int ix,
+                                            int iy, int iz,
+                                            bool compute_gradient);
+
+ private:
+  /// Spatial part of the 4-velocity of the particle
+  ThreeVector u3_;
+  /// Gamma factor of the particle
+  double u0_;
+  /// Distance of neighboring nodes in x direction [fm]
+  double h_;
+  /// \f$ (2 \sigma^2)^{-1} \f$ [fm\f$^{-2}\f$]
+  double two_sig_sqr_inv_;
+  /// Squared cutoff radius [fm\f$^2\f$]
+  double r_cut_sqr_;
+  /// Factor by which the step factor changes from one node to the next
+  double step_growth_;
+  /// Exponential at the previous node
+  double exp_ = 0.0;
+  /// Ratio of the exponentials at the next and the previous node
+  double step_ = 0.0;
+  /// Whether the previous node was within the cutoff
+  bool previous_inside_ = false;
+  /// Indices of the previous node
+  std::array<int, 3> previous_ = {0, 0, 0};
+};
+
 /**
  * Calculates Eckart rest frame density and 4-current of a given density type
  * and optionally the gradient of the density in an arbitary frame (grad j0),
@@ -284,6 +365,222 @@ current_eckart(const ThreeVector &r, const Particles &plist,
                const DensityParameters &par, DensityType dens_type,
                bool compute_gradient, bool smearing);
 
+/**
+ * Particles sorted into cubic cells with the smearing cutoff radius
+ * \f$ r_{cut} \f$ as edge length. All particles within \f$ r_{cut} \f$ of a
+ * point are in the 27 cells around it, so the smeared density at a point is
+ * computed from these particles instead of from all particles. This is used
+ * where densities and potentials are evaluated without a lattice.
+ */
+class ParticleCells {
+ public:
+  /**
+   * Sort the particles into cells.
+   *
+   * \param[in] plist Particles, the list is stored in the cells
+   * \param[in] r_cut Cutoff radius of the smearing [fm]
+   * \throw std::invalid_argument if r_cut is not positive
+   */
+  ParticleCells(ParticleList plist, double r_cut);
+
+  /// \return all particles, in the order of the original list
+  const ParticleList &particles() const { return particles_; }
+
+  /**
+   * \param[in] r Point of interest [fm]
+   * \return copies of all particles that may be within the cutoff radius of
+   *         r, in the order of the original list
+   */
+  ParticleList within_reach(const ThreeVector &r) const;
+
+  /**
+   * \param[in] r Point of interest [fm]
+   * \return indices into particles() of all particles that may be within the
+   *         cutoff radius of r, in increasing order
+   */
+  std::vector<std::size_t> indices_within_reach(const ThreeVector &r) const;
+
+ private:
+  /**
+   * \param[in] r Position [fm]
+   * \return indices of the cell containing r
+   */
+  std::array<int, 3> cell_of(const ThreeVector &r) const;
+
+  /// Hash of the indices of a cell
+  struct CellHash {
+    /// \return hash of the cell indices
+    std::size_t operator()(const std::array<int, 3> &cell) const {
+      std::size_t h = 0;
+      for (const int c : cell) {
+        h = h * 1000003u ^ static_cast<std::size_t>(c);
+      }
+      return h;
+    }
+  };
+
+  /// All particles
+  ParticleList particles_;
+  /// Edge length of the cells [fm]
+  double cell_length_;
+  /// Indices into particles_ of the particles in each non-empty cell
+  std::unordered_map<std::array<int, 3>, std::vector<std::size_t>, CellHash>
+      cells_;
+};
+
+/**
+ * Convenience overload of current_eckart, which only sums over the particles
+ * near r if smearing is used.
+ *
+ * \param[in] r Arbitrary space point where 4-current is calculated [fm]
+ * \param[in] cells Particles sorted into cells of the smearing range
+ * \param[in] par Set of parameters packed in one structure
+ * \param[in] dens_type type of four-currect to be calculated
+ * \param[in] compute_gradient true - compute gradient, false - no
+ * \param[in] smearing whether to use gaussian smearing or not
+ * \return the same as current_eckart
+ */
+std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
+           FourVector, FourVector>
+current_eckart(const ThreeVector &r, const ParticleCells &cells,
+               const DensityParameters &par, DensityType dens_type,
+               bool compute_gradient, bool smearing);
+
+/**
+ * Smears the particles onto arbitrary points, the same way as
+ * update_lattice smears them onto the nodes of a lattice with covariant
+ * Gaussian smearing. Every point receives a node of type T, e.g.
+ * DensityOnLattice for the currents of a DensityType or EnergyMomentumTensor,
+ * which can be used like the nodes of the corresponding lattice.
+ *
+ * Only the particles in the cells around a point are summed over, and the
+ * points are distributed over DensityParameters::threads() threads. Since
+ * every point is computed by one thread from the particles in their original
+ * order, the result does not depend on the number of threads.
+ *
+ * The normalization of DensityParameters includes the number of ensembles,
+ * hence the cells have to contain the particles of all ensembles.
+ *
+ * \param[in] points Points of interest, in any arrangement [fm]
+ * \param[in] cells Particles sorted into cells of the smearing range
+ * \param[in] par Set of parameters packed in one structure
+ * \param[in] dens_type Density type of the charges of the particles
+ * \param[in] compute_gradient Whether to compute the gradients, if the
+ *            derivatives are covariant Gaussian
+ * \return the smeared quantity at each of the points
+ * \tparam T Type of the quantity, like the node type of a lattice
+ */
+template <typename T>
+std::vector<T> smear_at_points(const std::vector<ThreeVector> &points,
+                               const ParticleCells &cells,
+                               const DensityParameters &par,
+                               DensityType dens_type,
+                               bool compute_gradient = false) {
+  std::vector<T> result(points.size());
+  const ParticleList &particles = cells.particles();
+  const double norm_factor_gaus = par.norm_factor_sf();
+  const bool with_derivatives =
+      compute_gradient &&
+      par.derivatives() == DerivativesMode::CovariantGaussian;
+  auto smear_at = [&](std::size_t i) {
+    for (const std::size_t k : cells.indices_within_reach(points[i])) {
+      const ParticleData &part = particles[k];
+      if (par.only_participants() &&
+          part.get_history().collisions_per_particle == 0) {
+        continue;
+      }
+      const double dens_factor = density_factor(part.type(), dens_type);
+      if (std::abs(dens_factor) < really_small) {
+        continue;
+      }
+      const FourVector p_mu = part.momentum();
+      const double m = p_mu.abs();
+      if (m < really_small) {
+        continue;
+      }
+      const auto sf = unnormalized_smearing_factor(
+          part.position().threevec() - points[i], p_mu, 1.0 / m, par,
+          with_derivatives);
+      result[i].add_particle(part, sf.first * dens_factor * norm_factor_gaus);
+      if (with_derivatives) {
+        result[i].add_particle_for_derivatives(part, dens_factor,
+                                               sf.second * norm_factor_gaus);
+      }
+    }
+  };
+
+  parallel_for(par.threads(), points.size(), 64, smear_at);
+  return result;
+}
+
+#ifdef SMASH_SINGLE_PRECISION_LATTICE
+/// Floating-point type of the values stored in the nodes of density lattices
+using LatticeReal = float;
+#else
+/// Floating-point type of the values stored in the nodes of density lattices
+using LatticeReal = double;
+#endif
+
+/**
+ * Four-vector stored with the floating-point type \p Real. It is converted to
+ * a FourVector for any arithmetic, such that every sum is computed in double
+ * precision and only rounded to \p Real when it is stored.
+ *
+ * \tparam Real Floating-point type of the components
+ */
+template <typename Real>
+class StoredFourVector {
+ public:
+  /// Zero four-vector
+  StoredFourVector() = default;
+  /**
+   * Store a four-vector, rounded to \p Real.
+   * \param[in] v The four-vector
+   */
+  StoredFourVector(const FourVector &v)  // NOLINT(runtime/explicit)
+      : x_{static_cast<Real>(v.x0()), static_cast<Real>(v.x1()),
+           static_cast<Real>(v.x2()), static_cast<Real>(v.x3())} {}
+  /// \return the stored four-vector in double precision.
+  operator FourVector() const { return FourVector(x_[0], x_[1], x_[2], x_[3]); }
+  /**
+   * \param[in] mu Index of the component
+   * \return the component \p mu.
+   */
+  double operator[](std::size_t mu) const { return x_[mu]; }
+  /**
+   * Set one component.
+   * \param[in] mu Index of the component
+   * \param[in] value New value of the component
+   */
+  void set(std::size_t mu, double value) { x_[mu] = static_cast<Real>(value); }
+  /**
+   * Add a four-vector, rounding the sums once.
+   * \param[in] v The four-vector
+   * \return this four-vector
+   */
+  StoredFourVector &operator+=(const FourVector &v) {
+    for (std::size_t mu = 0; mu < 4; mu++) {
+      x_[mu] = static_cast<Real>(x_[mu] + v[mu]);
+    }
+    return *this;
+  }
+  /**
+   * Subtract a four-vector, rounding the differences once.
+   * \param[in] v The four-vector
+   * \return this four-vector
+   */
+  StoredFourVector &operator-=(const FourVector &v) {
+    for (std::size_t mu = 0; mu < 4; mu++) {
+      x_[mu] = static_cast<Real>(x_[mu] - v[mu]);
+    }
+    return *this;
+  }
+
+ private:
+  /// Components of the four-vector
+  std::array<Real, 4> x_ = {};
+};
+
 /**
  * A class for time-efficient (time-memory trade-off) calculation of density
  * on the lattice. It holds six FourVectors - positive and negative
@@ -311,11 +608,20 @@ current_eckart(const ThreeVector &r, const Particles &plist,
  * -# Get \f$\partial_t\,\mathbf{j}\f$ via dvecj_dt()
  * -# Get \f$(\boldsymbol{\nabla} \rho) \times \mathbf{j}\f$ via
  *    grad_rho_cross_vecj()
+ *
+ * The four-vectors are stored with the floating-point type \p Real, while
+ * everything is computed in double precision. Nodes in single precision take
+ * half the memory, and the currents on them are rounded once per contribution,
+ * or once per node if they are summed beforehand, see
+ * gather_gaussian_currents.
+ *
+ * \tparam Real Floating-point type of the stored values
  */
-class DensityOnLattice {
+template <typename Real>
+class BasicDensityOnLattice {
  public:
   /// Default constructor
-  DensityOnLattice()
+  BasicDensityOnLattice()
       : jmu_pos_(FourVector()),
         jmu_neg_(FourVector()),
         djmu_dxnu_({FourVector(), FourVector(), FourVector(), FourVector()}),
@@ -381,8 +687,9 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return Net Eckart density on the local lattice \f$\rho\f$ [fm\f$^{-3}\f$]
    */
-  double rho(const double norm_factor = 1.0) {
-    return (jmu_pos_.abs() - jmu_neg_.abs()) * norm_factor;
+  double rho(const double norm_factor = 1.0) const {
+    return (FourVector(jmu_pos_).abs() - FourVector(jmu_neg_).abs()) *
+           norm_factor;
   }
 
   /**
@@ -391,11 +698,11 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return \f$\boldsymbol{\nabla}\times\mathbf{j}\f$ [fm \f$^{-4}\f$]
    */
-  ThreeVector curl_vecj(const double norm_factor = 1.0) {
+  ThreeVector curl_vecj(const double norm_factor = 1.0) const {
     ThreeVector curl_vec_j = ThreeVector();
-    curl_vec_j.set_x1(djmu_dxnu_[2].x3() - djmu_dxnu_[3].x2());
-    curl_vec_j.set_x2(djmu_dxnu_[3].x1() - djmu_dxnu_[1].x3());
-    curl_vec_j.set_x3(djmu_dxnu_[1].x2() - djmu_dxnu_[2].x1());
+    curl_vec_j.set_x1(djmu_dxnu_[2][3] - djmu_dxnu_[3][2]);
+    curl_vec_j.set_x2(djmu_dxnu_[3][1] - djmu_dxnu_[1][3]);
+    curl_vec_j.set_x3(djmu_dxnu_[1][2] - djmu_dxnu_[2][1]);
     curl_vec_j *= norm_factor;
     return curl_vec_j;
   }
@@ -407,10 +714,10 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return \f$\boldsymbol{\nabla} j^0\f$ [fm \f$^{-4}\f$]
    */
-  ThreeVector grad_j0(const double norm_factor = 1.0) {
+  ThreeVector grad_j0(const double norm_factor = 1.0) const {
     ThreeVector j0_grad = ThreeVector();
     for (int i = 1; i < 4; i++) {
-      j0_grad[i - 1] = djmu_dxnu_[i].x0() * norm_factor;
+      j0_grad[i - 1] = djmu_dxnu_[i][0] * norm_factor;
     }
     return j0_grad;
   }
@@ -421,8 +728,8 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return \f$\partial_t \mathbf{j}\f$ [fm \f$^{-4}\f$]
    */
-  ThreeVector dvecj_dt(const double norm_factor = 1.0) {
-    return djmu_dxnu_[0].threevec() * norm_factor;
+  ThreeVector dvecj_dt(const double norm_factor = 1.0) const {
+    return FourVector(djmu_dxnu_[0]).threevec() * norm_factor;
   }
 
   /**
@@ -431,7 +738,9 @@ class DensityOnLattice {
    * There is a "+" operator in between, because the negative symbol
    * of the charge has already be included in FactorTimesSF.
    */
-  FourVector jmu_net() const { return jmu_pos_ + jmu_neg_; }
+  FourVector jmu_net() const {
+    return FourVector(jmu_pos_) + FourVector(jmu_neg_);
+  }
 
   /**
    * Add to the positive density current.
@@ -462,7 +771,9 @@ class DensityOnLattice {
    * \f$\partial_{\nu} j^\mu\f$
    * \return the array of FourGradients of \f$\partial_{\nu} j^\mu\f$
    */
-  std::array<FourVector, 4> djmu_dxnu() const { return djmu_dxnu_; }
+  std::array<FourVector, 4> djmu_dxnu() const {
+    return {djmu_dxnu_[0], djmu_dxnu_[1], djmu_dxnu_[2], djmu_dxnu_[3]};
+  }
 
   /**
    * Compute the  cross product of \f$\boldsymbol{\nabla}\rho\f$ and \f$j^\mu\f$
@@ -470,7 +781,7 @@ class DensityOnLattice {
    *         \f$\mathbf{j}\f$
    */
   ThreeVector grad_rho_cross_vecj() const {
-    const ThreeVector grad_rho = drho_dxnu_.threevec();
+    const ThreeVector grad_rho = FourVector(drho_dxnu_).threevec();
     const ThreeVector vecj = jmu_net().threevec();
     const ThreeVector Drho_cross_vecj = grad_rho.cross_product(vecj);
 
@@ -487,7 +798,7 @@ class DensityOnLattice {
   /**
    * Overwrite the time derivative of the rest frame density to zero.
    */
-  void overwrite_drho_dt_to_zero() { drho_dxnu_[0] = 0.0; }
+  void overwrite_drho_dt_to_zero() { drho_dxnu_.set(0, 0.0); }
 
   /**
    * Overwrite the rest frame density derivatives to provided values.
@@ -512,20 +823,74 @@ class DensityOnLattice {
     djmu_dxnu_[3] = djmu_dz;
   }
 
+  /**
+   * Adds the summed contributions of several particles, as if add_particle
+   * and add_particle_for_derivatives were called for each of them.
+   *
+   * \param[in] jmu_pos Contribution to the current of the positively charged
+   *            particles
+   * \param[in] jmu_neg Contribution to the current of the negatively charged
+   *            particles
+   * \param[in] djmu_dxnu Contribution to the derivatives of the current
+   */
+  void add_currents(const FourVector &jmu_pos, const FourVector &jmu_neg,
+                    const std::array<FourVector, 4> &djmu_dxnu) {
+    jmu_pos_ += jmu_pos;
+    jmu_neg_ += jmu_neg;
+    for (int nu = 0; nu < 4; nu++) {
+      djmu_dxnu_[nu] += djmu_dxnu[nu];
+    }
+  }
+
  private:
   /// Four-current density of the positively charged particle.
-  FourVector jmu_pos_;
+  StoredFourVector<Real> jmu_pos_;
   /// Four-current density of the negatively charged particle.
-  FourVector jmu_neg_;
+  StoredFourVector<Real> jmu_neg_;
   /// Four-gradient of the four-current density, \f$\partial_\nu j^\mu \f$
-  std::array<FourVector, 4> djmu_dxnu_;
+  std::array<StoredFourVector<Real>, 4> djmu_dxnu_;
   /// Four-gradient of the rest frame density, \f$\partial_\nu \rho \f$
-  FourVector drho_dxnu_;
+  StoredFourVector<Real> drho_dxnu_;
 };
 
+/**
+ * Density on the lattice with the precision chosen at build time, see
+ * LatticeReal.
+ */
+typedef BasicDensityOnLattice<LatticeReal> DensityOnLattice;
+
 /// Conveniency typedef for lattice of density
 typedef RectangularLattice<DensityOnLattice> DensityLattice;
 
+/**
+ * Adds the currents of the particles to a lattice with covariant Gaussian
+ * smearing, like update_lattice, but gathers the contributions at every node
+ * instead of scattering every particle onto its nodes.
+ *
+ * The particles are packed into arrays, sorted into the cells of the lattice,
+ * and every node sums over the particles in the cells within the cutoff
+ * radius. This is a data-parallel kernel without write conflicts, which is
+ * offloaded to an accelerator with OpenMP if SMASH is built with
+ * ENABLE_LATTICE_OFFLOAD, and then used by update_lattice. The contributions
+ * are summed in double precision and added to every node at once, so
+ * update_lattice also uses it for nodes in single precision. The result
+ * agrees with the one of update_lattice up to rounding, since the
+ * contributions are summed in a different order.
+ *
+ * \tparam Real Floating-point type of the values stored in the nodes
+ * \param[in,out] lat Lattice the currents are added to
+ * \param[in] dens_type Density type to be computed on the lattice
+ * \param[in] par Parameters of the smearing
+ * \param[in] ensembles The particles of all ensembles
+ * \param[in] compute_gradient Whether to compute the gradients, if the
+ *            derivatives are covariant Gaussian
+ */
+template <typename Real>
+void gather_gaussian_currents(
+    RectangularLattice<BasicDensityOnLattice<Real>> *lat, DensityType dens_type,
+    const DensityParameters &par, const std::vector<Particles> &ensembles,
+    bool compute_gradient);
+
 /**
  * Updates the contents on the lattice.
  *
@@ -568,91 +933,202 @@ void update_lattice(RectangularLattice<T> *lat, const LatticeUpdate update,
        triangular_radius[0] * triangular_radius[1] * triangular_radius[1] *
        triangular_radius[2] * triangular_radius[2]);
 
-  for (const Particles &particles : ensembles) {
-    for (const ParticleData &part : particles) {
-      if (par.only_participants()) {
-        // if this conditions holds, the hadron is a spectator
-        if (part.get_history().collisions_per_particle == 0) {
-          continue;
+  // Whether a particle contributes to the density
+  auto contributes = [&](const ParticleData &part) {
+    if (par.only_participants()) {
+      // if this conditions holds, the hadron is a spectator
+      if (part.get_history().collisions_per_particle == 0) {
+        return false;
+      }
+    }
+    return std::abs(density_factor(part.type(), dens_type)) >= really_small;
+  };
+
+  // Announce the bricks of nodes the particles are going to be smeared on
+  if (lat->tracks_occupation()) {
+    const std::array<double, 3> reach =
+        par.smearing() == SmearingMode::CovariantGaussian
+            ? std::array<double, 3>{par.r_cut(), par.r_cut(), par.r_cut()}
+        : par.smearing() == SmearingMode::Discrete ? lat->cell_sizes()
+                                                   : triangular_radius;
+    for (const Particles &particles : ensembles) {
+      for (const ParticleData &part : particles) {
+        if (contributes(part)) {
+          lat->mark_occupied(part.position().threevec(), reach);
         }
       }
-      const double dens_factor = density_factor(part.type(), dens_type);
-      if (std::abs(dens_factor) < really_small) {
-        continue;
+    }
+  }
+
+#ifdef SMASH_LATTICE_OFFLOAD
+  constexpr bool offload = std::is_same_v<T, DensityOnLattice>;
+#else
+  constexpr bool offload = false;
+#endif
+  // Nodes in single precision receive the currents summed in double precision.
+  if constexpr (offload || std::is_same_v<T, BasicDensityOnLattice<float>>) {
+    if (par.smearing() == SmearingMode::CovariantGaussian) {
+      gather_gaussian_currents(lat, dens_type, par, ensembles,
+                               compute_gradient);
+      return;
+    }
+  }
+
+  /* Deposits the contribution of one particle to all nodes accepted by
+   * `owns`. Returns early for particles not touching the accepted nodes,
+   * which is checked by `touches` with the reach of the smearing. */
+  auto deposit = [&](const ParticleData &part, auto &&owns, auto &&touches) {
+    if (!contributes(part)) {
+      return;
+    }
+    const double dens_factor = density_factor(part.type(), dens_type);
+    const FourVector p_mu = part.momentum();
+    const ThreeVector pos = part.position().threevec();
+
+    // act accordingly to which smearing is used
+    if (par.smearing() == SmearingMode::CovariantGaussian) {
+      if (!touches(pos[2], par.r_cut())) {
+        return;
       }
-      const FourVector p_mu = part.momentum();
-      const ThreeVector pos = part.position().threevec();
-
-      // act accordingly to which smearing is used
-      if (par.smearing() == SmearingMode::CovariantGaussian) {
-        const double m = p_mu.abs();
-        if (unlikely(m < really_small)) {
-          logg[LDensity].warn("Gaussian smearing is undefined for momentum ",
-                              p_mu);
-          continue;
+      const double m = p_mu.abs();
+      if (unlikely(m < really_small)) {
+        logg[LDensity].warn("Gaussian smearing is undefined for momentum ",
+                            p_mu);
+        return;
+      }
+      const double m_inv = 1.0 / m;
+
+      // unweighted contribution to density
+      const double common_weight = dens_factor * norm_factor_gaus;
+      GaussianSmearingKernel kernel(p_mu, m_inv, par, (lat->cell_sizes())[0]);
+      lat->iterate_in_cube(
+          pos, par.r_cut(), [&](T &node, int ix, int iy, int iz) {
+            if (!owns(node)) {
+              return;
+            }
+            // find the weight for smearing
+            const ThreeVector r = lat->cell_center(ix, iy, iz);
+            const auto sf = kernel(pos - r, ix, iy, iz, compute_gradient);
+            node.add_particle(part, sf.first * common_weight);
+            if (par.derivatives() == DerivativesMode::CovariantGaussian) {
+              node.add_particle_for_derivatives(part, dens_factor,
+                                                sf.second * norm_factor_gaus);
+            }
+          });
+    } else if (par.smearing() == SmearingMode::Discrete) {
+      if (!touches(pos[2], (lat->cell_sizes())[2])) {
+        return;
+      }
+      // unweighted contribution to density
+      const double common_weight =
+          dens_factor / (par.ntest() * par.nensembles() * V_cell);
+      lat->iterate_nearest_neighbors(
+          pos, [&](T &node, int iterated_index, int center_index) {
+            if (!owns(node)) {
+              return;
+            }
+            node.add_particle(
+                part, common_weight *
+                          // the contribution to density is weighted depending
+                          // on what node it is added to
+                          (iterated_index == center_index ? big : small));
+          });
+    } else if (par.smearing() == SmearingMode::Triangular) {
+      if (!touches(pos[2], triangular_radius[2])) {
+        return;
+      }
+      // unweighted contribution to density
+      const double common_weight = dens_factor * prefactor_triangular;
+      lat->iterate_in_rectangle(
+          pos, triangular_radius, [&](T &node, int ix, int iy, int iz) {
+            if (!owns(node)) {
+              return;
+            }
+            // compute the position of the node
+            const ThreeVector cell_center = lat->cell_center(ix, iy, iz);
+            // compute smearing weight
+            const double weight_x =
+                triangular_radius[0] - std::abs(cell_center[0] - pos[0]);
+            const double weight_y =
+                triangular_radius[1] - std::abs(cell_center[1] - pos[1]);
+            const double weight_z =
+                triangular_radius[2] - std::abs(cell_center[2] - pos[2]);
+            // add the contribution to the node
+            node.add_particle(part,
+                              common_weight * weight_x * weight_y * weight_z);
+          });
+    }
+  };
+
+  const int n_planes = lat->n_cells()[2];
+  const int n_threads = std::min(par.threads(), n_planes);
+  if (n_threads <= 1) {
+    auto all_nodes = [](const T &) { return true; };
+    auto everywhere = [](double, double) { return true; };
+    for (const Particles &particles : ensembles) {
+      for (const ParticleData &part : particles) {
+        deposit(part, all_nodes, everywhere);
+      }
+    }
+    return;
+  }
+
+  /* Every thread owns a slab of z-planes of the lattice and deposits all
+   * particles, but only into its own nodes. Thus there are no write
+   * conflicts, and every node receives the contributions in the same order
+   * as in the serial loop, which makes the result independent of the number
+   * of threads. */
+  const std::size_t plane_size =
+      static_cast<std::size_t>(lat->n_cells()[0]) * lat->n_cells()[1];
+  auto deposit_slab = [&](int first_plane, int end_plane) {
+    const T *const first_node = &(*lat)[first_plane * plane_size];
+    const T *const last_node = &(*lat)[end_plane * plane_size - 1];
+    auto owns = [&](const T &node) {
+      return &node >= first_node && &node <= last_node;
+    };
+    // conservative check whether a particle can reach one of the planes
+    auto touches = [&](double z, double reach) {
+      const double z_cell = (z - (lat->origin())[2]) / (lat->cell_sizes())[2];
+      const double reach_cell = reach / (lat->cell_sizes())[2];
+      const int lower = std::floor(z_cell - reach_cell) - 1;
+      const int upper = std::floor(z_cell + reach_cell) + 1;
+      if (!lat->periodic()) {
+        return lower < end_plane && upper >= first_plane;
+      }
+      if (upper - lower + 1 >= n_planes) {
+        return true;
+      }
+      for (int iz = lower; iz <= upper; iz++) {
+        const int plane = ((iz % n_planes) + n_planes) % n_planes;
+        if (plane >= first_plane && plane < end_plane) {
+          return true;
         }
-        const double m_inv = 1.0 / m;
-
-        // unweighted contribution to density
-        const double common_weight = dens_factor * norm_factor_gaus;
-        lat->iterate_in_cube(
-            pos, par.r_cut(), [&](T &node, int ix, int iy, int iz) {
-              // find the weight for smearing
-              const ThreeVector r = lat->cell_center(ix, iy, iz);
-              const auto sf = unnormalized_smearing_factor(
-                  pos - r, p_mu, m_inv, par, compute_gradient);
-              node.add_particle(part, sf.first * common_weight);
-              if (par.derivatives() == DerivativesMode::CovariantGaussian) {
-                node.add_particle_for_derivatives(part, dens_factor,
-                                                  sf.second * norm_factor_gaus);
-              }
-            });
-      } else if (par.smearing() == SmearingMode::Discrete) {
-        // unweighted contribution to density
-        const double common_weight =
-            dens_factor / (par.ntest() * par.nensembles() * V_cell);
-        lat->iterate_nearest_neighbors(
-            pos, [&](T &node, int iterated_index, int center_index) {
-              node.add_particle(
-                  part, common_weight *
-                            // the contribution to density is weighted depending
-                            // on what node it is added to
-                            (iterated_index == center_index ? big : small));
-            });
-      } else if (par.smearing() == SmearingMode::Triangular) {
-        // unweighted contribution to density
-        const double common_weight = dens_factor * prefactor_triangular;
-        lat->iterate_in_rectangle(
-            pos, triangular_radius, [&](T &node, int ix, int iy, int iz) {
-              // compute the position of the node
-              const ThreeVector cell_center = lat->cell_center(ix, iy, iz);
-              // compute smearing weight
-              const double weight_x =
-                  triangular_radius[0] - std::abs(cell_center[0] - pos[0]);
-              const double weight_y =
-                  triangular_radius[1] - std::abs(cell_center[1] - pos[1]);
-              const double weight_z =
-                  triangular_radius[2] - std::abs(cell_center[2] - pos[2]);
-              // add the contribution to the node
-              node.add_particle(part,
-                                common_weight * weight_x * weight_y * weight_z);
-            });
       }
-    }  // end of for (const ParticleData &part : particles)
-  }    // end of for (const Particles &particles : ensembles)
+      return false;
+    };
+    for (const Particles &particles : ensembles) {
+      for (const ParticleData &part : particles) {
+        deposit(part, owns, touches);
+      }
+    }
+  };
+  parallel_for(n_threads, n_threads, 1, [&](std::size_t i_slab) {
+    const int i = static_cast<int>(i_slab);
+    deposit_slab(i * n_planes / n_threads, (i + 1) * n_planes / n_threads);
+  });
 }
 
 /**
  * Updates the contents on the lattice of DensityOnLattice type.
  *
+ * The finite difference derivatives of the current and the derivatives of the
+ * rest frame density are computed in one sweep over the lattice, directly
+ * from and into the nodes.
+ *
  * \param[out] lat The lattice of DensityOnLattice type on which the content
  *             will be updated
  * \param[in] old_jmu Auxiliary lattice, filled with current values at t0,
  *            needed for calculating time derivatives
- * \param[in] new_jmu Auxiliary lattice,filled with current values at t0 + dt,
- *            needed for calculating time derivatives
- * \param[in] four_grad_lattice Auxiliary lattice for calculating the
- *            fourgradient of the current
  * \param[in] update Tells if called for update at printout or at timestep
  * \param[in] dens_type Density type to be computed on the lattice
  * \param[in] par a structure containing testparticles number and gaussian
@@ -663,12 +1139,10 @@ void update_lattice(RectangularLattice<T> *lat, const LatticeUpdate update,
  */
 void update_lattice(
     RectangularLattice<DensityOnLattice> *lat,
-    RectangularLattice<FourVector> *old_jmu,
-    RectangularLattice<FourVector> *new_jmu,
-    RectangularLattice<std::array<FourVector, 4>> *four_grad_lattice,
-    const LatticeUpdate update, const DensityType dens_type,
-    const DensityParameters &par, const std::vector<Particles> &ensembles,
-    const double time_step, const bool compute_gradient);
+    RectangularLattice<FourVector> *old_jmu, const LatticeUpdate update,
+    const DensityType dens_type, const DensityParameters &par,
+    const std::vector<Particles> &ensembles, const double time_step,
+    const bool compute_gradient);
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_DENSITY_H_
@@ -0,0 +1,138 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_DIGESTOUTPUT_H_
+#define SRC_INCLUDE_SMASH_DIGESTOUTPUT_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "file.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+#include "sha256.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Output that condenses each event into a line with SHA256 hashes of its
+ * final particles and of its history of interactions, which change with any
+ * bit of the particle data. Each ensemble counts as an event.
+ *
+ * Comparing the digests of two runs tells whether they gave identical
+ * results, e.g. when checking a parallel or otherwise optimized run against
+ * a reference run, without writing and comparing full particle and
+ * collision outputs. If a reference digest is configured, the events are
+ * compared while the run goes on and the first differing event is reported,
+ * see \ref doxypage_output_digest.
+ */
+class DigestOutput : public OutputInterface {
+ public:
+  /**
+   * Create the digest output.
+   *
+   * \param[in] path Output directory.
+   * \param[in] name Name of the output.
+   * \param[in] out_par Output parameters with the digest settings.
+   * \throw std::runtime_error if the reference digest cannot be read.
+   */
+  DigestOutput(const std::filesystem::path &path, const std::string &name,
+               const OutputParameters &out_par);
+
+  /// Report the outcome of the comparison with the reference run.
+  ~DigestOutput() override;
+
+  /**
+   * Start the histories of all ensembles.
+   *
+   * \param[in] ensembles Particles of the ensembles at the start.
+   * \param[in] event_number Unused, needed since inherited.
+   */
+  void at_eventstart(const std::vector<Particles> &ensembles,
+                     int event_number) override;
+
+  /**
+   * Add an interaction to the history of its ensemble.
+   *
+   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] density Unused, needed since inherited.
+   * \param[in] i_ensemble Ensemble of the interaction.
+   */
+  void at_ensemble_interaction(const Action &action, const double density,
+                               const int i_ensemble) override;
+
+  /**
+   * Write the digest of an ensemble and compare it with the reference.
+   *
+   * \param[in] particles Final particles of the ensemble.
+   * \param[in] event_number Number of the ensemble counted as an event.
+   * \param[in] info Event information with the number of ensembles.
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+
+  /// \return false, the density at the interaction point is not used.
+  bool uses_interaction_density() const override { return false; }
+  /// \return false, only the final particles and interactions are used.
+  bool uses_intermediate_times() const override { return false; }
+
+  /// \return First event which differs from the reference, if any.
+  std::optional<int> first_divergence() const { return first_divergence_; }
+
+  /**
+   * \param[in] particles Particles to digest.
+   * \return Hash of the ids, PDG codes, positions and momenta of the
+   *         particles, independent of their order in \p particles.
+   */
+  static sha256::Hash final_state_hash(const Particles &particles);
+
+ private:
+  /// Digest of an event
+  struct Digest {
+    /// Hexadecimal hash of the final particles
+    std::string final_state;
+    /// Hexadecimal hash of the interactions
+    std::string history;
+  };
+
+  /**
+   * Read the digests of a reference run.
+   *
+   * \param[in] path Digest file of the reference run, none if empty.
+   * \return Digests by event number.
+   * \throw std::runtime_error if the file cannot be read.
+   */
+  static std::map<int, Digest> read_reference(const std::string &path);
+
+  /// Hash of the interactions of each ensemble in the current event
+  std::vector<sha256::Context> histories_;
+  /// Number of interactions of each ensemble in the current event
+  std::vector<std::uint64_t> n_interactions_;
+  /// Digests of the reference run by event number
+  const std::map<int, Digest> reference_;
+  /// Whether a reference run is compared with
+  const bool compare_;
+  /// Number of events compared with the reference
+  int n_compared_ = 0;
+  /// First event which differs from the reference
+  std::optional<int> first_divergence_;
+  /// File of the digests
+  RenamingFilePtr file_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_DIGESTOUTPUT_H_
@@ -0,0 +1,133 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_EVENTSCHEDULER_H_
+#define SRC_INCLUDE_SMASH_EVENTSCHEDULER_H_
+
+#include <filesystem>
+#include <mutex>
+#include <utility>
+
+#include "forwarddeclarations.h"
+
+namespace smash {
+
+/// The limits on the number of events of a run, see Experiment
+struct EventLimits {
+  /// How the number of events is specified
+  EventCounting counting = EventCounting::Invalid;
+  /// Number of events, for EventCounting::FixedNumber
+  int nevents = 0;
+  /// Number of ensembles with interactions to be reached, for
+  /// EventCounting::MinimumNonEmpty
+  int minimum_nonempty_ensembles = 0;
+  /// Largest number of events, for EventCounting::MinimumNonEmpty
+  int max_events = 0;
+};
+
+/**
+ * Hands out the numbers of the events to be simulated to one or several
+ * experiments, which ask for the next event whenever they finished one. This
+ * balances the load if the events take very different times, in contrast to
+ * assigning a fixed subset of the events to each experiment. The random seed
+ * of an event only depends on its number, see seed_of_event, so the events
+ * can be handed out in any order.
+ */
+class EventScheduler {
+ public:
+  /// Virtual destructor for the derived schedulers
+  virtual ~EventScheduler() = default;
+
+  /**
+   * Called by every experiment before it asks for its first event. All
+   * experiments of a run have the same limits.
+   *
+   * \param[in] limits The limits on the number of events.
+   */
+  virtual void start(const EventLimits &limits) = 0;
+
+  /**
+   * \param[in] nonempty_ensembles Number of ensembles with interactions in
+   *            the event the experiment just finished, 0 before the first
+   *            event.
+   * \return the number of the next event to be simulated by the experiment,
+   *         or -1 if the run is finished.
+   */
+  virtual int next_event(int nonempty_ensembles) = 0;
+};
+
+/**
+ * Hands out the events in order and counts the ensembles with interactions of
+ * all experiments within the process. Thread-safe.
+ */
+class LocalEventScheduler : public EventScheduler {
+ public:
+  void start(const EventLimits &limits) override;
+  int next_event(int nonempty_ensembles) override;
+
+ private:
+  /// Guards all members
+  std::mutex mutex_;
+  /// Whether the limits are set
+  bool started_ = false;
+  /// The limits on the number of events
+  EventLimits limits_;
+  /// Number of the next event to be handed out
+  int next_ = 0;
+  /// Ensembles with interactions in the finished events
+  int nonempty_ensembles_ = 0;
+};
+
+/**
+ * Hands out a single given event, e.g. to simulate a rare event of a run
+ * again without the events before it. The limits of the run are ignored.
+ */
+class SingleEventScheduler : public EventScheduler {
+ public:
+  /// \param[in] event Number of the event to be simulated
+  explicit SingleEventScheduler(int event) : event_(event) {}
+  void start(const EventLimits &) override {}
+  int next_event(int) override { return std::exchange(event_, -1); }
+
+ private:
+  /// Number of the event still to be handed out, -1 once it was
+  int event_;
+};
+
+#ifdef SMASH_USE_MPI
+/**
+ * Asks the master rank 0 for the events to be simulated by the experiment of
+ * this rank, see serve_events_over_mpi.
+ */
+class MpiEventScheduler : public EventScheduler {
+ public:
+  void start(const EventLimits &limits) override;
+  int next_event(int nonempty_ensembles) override;
+
+ private:
+  /// The limits sent along with every request
+  EventLimits limits_;
+};
+
+/**
+ * Hands out the events to the MpiEventScheduler of all other ranks until the
+ * run is finished, counting the ensembles with interactions globally. To be
+ * called on rank 0.
+ *
+ * \param[in] index_path File to which the consolidated index of the events is
+ *            written. Every line holds the number of an event, the rank that
+ *            simulated it and its position among the events in the output of
+ *            that rank.
+ */
+void serve_events_over_mpi(const std::filesystem::path &index_path);
+#endif
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_EVENTSCHEDULER_H_
@@ -8,52 +8,84 @@
 #define SRC_INCLUDE_SMASH_EXPERIMENT_H_
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <limits>
+#include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "actionfinderfactory.h"
 #include "actions.h"
+#include "adaptivetimestep.h"
 #include "bremsstrahlungaction.h"
+#include "checkpoint.h"
 #include "chrono.h"
+#include "coulombfieldsolver.h"
 #include "decayactionsfinder.h"
 #include "decayactionsfinderdilepton.h"
 #include "energymomentumtensor.h"
+#include "eventscheduler.h"
 #include "fields.h"
 #include "fourvector.h"
 #include "grandcan_thermalizer.h"
 #include "grid.h"
 #include "hypersurfacecrossingaction.h"
+#include "memorytracker.h"
 #include "outputparameters.h"
+#include "parallel.h"
+#include "parametrizations.h"
 #include "pauliblocking.h"
 #include "potential_globals.h"
 #include "potentials.h"
+#include "profiler.h"
 #include "propagation.h"
 #include "quantumnumbers.h"
 #include "scatteractionphoton.h"
 #include "scatteractionsfinder.h"
+#include "spectatorset.h"
 #include "stringprocess.h"
 #include "thermalizationaction.h"
+#include "threadaffinity.h"
 // Output
+#include "analysisoutput.h"
+#include "asyncoutput.h"
 #include "binaryoutput.h"
+#include "columnaroutput.h"
+#include "digestoutput.h"
+#include "filteredoutput.h"
 #ifdef SMASH_USE_HEPMC
 #include "hepmcoutput.h"
 #endif
 #ifdef SMASH_USE_RIVET
 #include "rivetoutput.h"
 #endif
+#include "iccallbackoutput.h"
 #include "icoutput.h"
 #include "oscaroutput.h"
+#include "shardedoutput.h"
 #include "thermodynamiclatticeoutput.h"
 #include "thermodynamicoutput.h"
 #ifdef SMASH_USE_ROOT
+#include "TROOT.h"
 #include "rootoutput.h"
 #endif
 #include "freeforallaction.h"
 #include "vtkoutput.h"
+#include "vtkxmloutput.h"
 #include "wallcrossingaction.h"
 
 namespace std {
@@ -89,6 +121,88 @@ namespace smash {
 static constexpr int LMain = LogArea::Main::id;
 static constexpr int LInitialConditions = LogArea::InitialConditions::id;
 
+/**
+ * Numbers of the particle pairs considered in the search for collisions and
+ * of the found actions which were performed or not, to find out how much of
+ * the work is wasted.
+ */
+struct InteractionStatistics {
+  /// Counters of the search for collisions
+  CollisionSearchCounters search;
+  /// Performed actions, without wall and hypersurface crossings
+  uint64_t performed = 0;
+  /// Found actions that were invalid when they were due to be performed
+  uint64_t discarded = 0;
+  /// Pauli-blocked interactions
+  uint64_t pauli_blocked = 0;
+
+  /**
+   * Add the statistics of a later interval.
+   *
+   * \param[in] other Statistics to be added
+   * \return this object
+   */
+  InteractionStatistics &operator+=(const InteractionStatistics &other) {
+    search += other.search;
+    performed += other.performed;
+    discarded += other.discarded;
+    pauli_blocked += other.pauli_blocked;
+    return *this;
+  }
+};
+
+/**
+ * Write the interaction statistics in one line.
+ *
+ * \param[in] out The ostream into which to output
+ * \param[in] s The statistics to write
+ */
+inline std::ostream &operator<<(std::ostream &out,
+                                const InteractionStatistics &s) {
+  return out << "searched cells: " << s.search.cells << " (at most "
+             << s.search.max_particles_in_cell
+             << " particles), candidate pairs: " << s.search.candidate_pairs
+             << ", checked pairs: " << s.search.checked_pairs
+             << ", found actions: " << s.search.found_actions << " + "
+             << s.search.found_multi_particle_actions
+             << " multi-particle, performed: " << s.performed
+             << ", discarded: " << s.discarded
+             << ", Pauli-blocked: " << s.pauli_blocked;
+}
+
+/// Cost of the actions of one process type, measured for a sample of them
+struct ActionCost {
+  /// Performed actions
+  uint64_t performed = 0;
+  /// Performed actions whose cost was measured
+  uint64_t samples = 0;
+  /// Time spent to generate the final state and perform the samples [s]
+  double seconds = 0.;
+
+  /**
+   * Add the costs measured in another ensemble or interval.
+   *
+   * \param[in] other Costs to be added
+   * \return this object
+   */
+  ActionCost &operator+=(const ActionCost &other) {
+    performed += other.performed;
+    samples += other.samples;
+    seconds += other.seconds;
+    return *this;
+  }
+};
+
+/**
+ * Write a table with the mean cost of the actions of each process type and
+ * the time spent in all of them estimated from the mean, sorted by decreasing
+ * estimated time.
+ *
+ * \param[in] costs The costs of the process types.
+ * \return the table.
+ */
+std::string action_cost_report(const std::map<ProcessType, ActionCost> &costs);
+
 /**
  * Non-template interface to Experiment<Modus>.
  *
@@ -136,6 +250,85 @@ class ExperimentBase {
    */
   virtual void run() = 0;
 
+  /**
+   * Runs a subset of the events of the experiment.
+   *
+   * Only the events with number first_event + k * event_stride are simulated,
+   * such that several instances of the same experiment, e.g. on different
+   * threads, can share the events of a run. The random seed of each event
+   * (and hence its outcome) is the same as if all events were simulated by a
+   * single instance.
+   *
+   * \param[in] first_event Number of the first event to be simulated
+   * \param[in] event_stride Distance between the numbers of the simulated
+   *                         events
+   */
+  virtual void run(int first_event, int event_stride) = 0;
+
+  /**
+   * Runs the events handed out by a scheduler, e.g. by the master rank of an
+   * MPI run.
+   *
+   * After every event the experiment asks the scheduler for the next one and
+   * reports the number of ensembles with interactions, such that
+   * Minimum_Nonempty_Ensembles is counted over all experiments sharing the
+   * scheduler. As for run(int, int), the random seed of each event is the
+   * same as if all events were simulated by a single instance.
+   *
+   * \param[in] scheduler Hands out the numbers of the events.
+   */
+  virtual void run(EventScheduler &scheduler) = 0;
+
+  /**
+   * Selects the events simulated by run_next_event(), as run(int, int) does
+   * for all of them. Without this call, all events are simulated.
+   *
+   * \param[in] first_event Number of the first event to be simulated
+   * \param[in] event_stride Distance between the numbers of the simulated
+   *                         events
+   */
+  virtual void begin_events(int first_event, int event_stride) = 0;
+
+  /**
+   * Simulates the next event of the experiment, for callers that pull the
+   * events one at a time, like EventStream. The events are passed to the
+   * outputs as in run(), where the final state is found, too.
+   *
+   * \return false if the experiment is finished and no event was simulated,
+   *         in which case the reports of the run were written.
+   */
+  virtual bool run_next_event() = 0;
+
+  /**
+   * Adds an output created by the caller to the configured ones. This is
+   * helpful if SMASH is used as a 3rd-party library, e.g. to receive the
+   * initial conditions in memory with an ICCallbackOutput.
+   *
+   * \param[in] output Output to be called like the configured ones
+   * \param[in] name Name of the output in the profiling report
+   */
+  virtual void add_output(std::unique_ptr<OutputInterface> output,
+                          const std::string &name = "Library") = 0;
+
+  /**
+   * Change settings of the experiment between events, e.g. for a scan of
+   * parameters, without setting up a new experiment.
+   *
+   * Only the collision energy (Modi: Collider: Sqrtsnn) and the impact
+   * parameter settings (Modi: Collider: Impact) can be changed, since all
+   * other parts of the setup, like the action finders, the string process,
+   * the lattices and the outputs, are kept. A given Impact section replaces
+   * the previous one completely. The new settings apply from the next call of
+   * initialize_new_event on.
+   *
+   * \param[inout] changes Configuration containing only the changed keys,
+   *                       which are taken.
+   * \throw std::invalid_argument if a key cannot be changed, in which case
+   *        nothing is changed, or if sqrt(s_NN) would cross 200 GeV, which
+   *        decides on the default string parameters.
+   */
+  virtual void reconfigure(Configuration &changes) = 0;
+
   /**
    * \ingroup exception
    * Exception class that is thrown if an invalid modus is requested from the
@@ -197,6 +390,50 @@ class Experiment : public ExperimentBase {
    */
   void run() override;
 
+  /**
+   * Runs every event_stride-th event, starting from first_event.
+   *
+   * See ExperimentBase::run(int, int) for details.
+   *
+   * \throw std::invalid_argument if the events are shared with other instances
+   *        (event_stride > 1) and the number of events is not fixed or the
+   *        setup relies on state that cannot be shared across threads.
+   */
+  void run(int first_event, int event_stride) override;
+
+  /**
+   * Runs the events handed out by a scheduler.
+   *
+   * See ExperimentBase::run(EventScheduler &) for details.
+   *
+   * \throw std::invalid_argument if the initial states are prefetched.
+   */
+  void run(EventScheduler &scheduler) override;
+
+  /**
+   * Selects the events simulated by run_next_event().
+   *
+   * See ExperimentBase::begin_events for details.
+   *
+   * \throw std::invalid_argument for the same selections as run(int, int).
+   */
+  void begin_events(int first_event, int event_stride) override;
+
+  /**
+   * Simulates the next event.
+   *
+   * See ExperimentBase::run_next_event for details. A run resumed from a
+   * checkpoint starts with the event of the checkpoint.
+   */
+  bool run_next_event() override;
+
+  /**
+   * Changes settings between events.
+   *
+   * See ExperimentBase::reconfigure for details.
+   */
+  void reconfigure(Configuration &changes) override;
+
   /**
    * Create a new Experiment.
    *
@@ -213,6 +450,9 @@ class Experiment : public ExperimentBase {
   explicit Experiment(Configuration &config,
                       const std::filesystem::path &output_path);
 
+  /// Wait for the outputs at the last output time, if they are still written.
+  ~Experiment() override;
+
   /**
    * This is called in the beginning of each event. It initializes particles
    * according to selected modus, resets the clock and saves the initial
@@ -270,7 +510,45 @@ class Experiment : public ExperimentBase {
    */
   void increase_event_number();
 
+  /**
+   * Adds an output created by the caller to the configured ones.
+   *
+   * See ExperimentBase::add_output for details.
+   */
+  void add_output(std::unique_ptr<OutputInterface> output,
+                  const std::string &name = "Library") override {
+    outputs_.emplace_back(std::move(output));
+    output_phases_.push_back(profiler_.add_phase("Output " + name));
+    update_subscriptions();
+  }
+
+  /**
+   * \return the interaction statistics of the current event up to the last
+   *         output time.
+   */
+  const InteractionStatistics &interaction_statistics() const {
+    return interaction_statistics_;
+  }
+
+  /// \return the interaction statistics of the last output interval.
+  const InteractionStatistics &interval_interaction_statistics() const {
+    return interval_interaction_statistics_;
+  }
+
  private:
+  /**
+   * Collect the interaction statistics since the last call into the ones of
+   * the last output interval and add them to the ones of the event.
+   */
+  void update_interaction_statistics();
+
+  /**
+   * Report the memory of the subsystems if it is tracked. If the resident
+   * memory exceeds the budget, warn once per event and flush the queues of
+   * the asynchronous outputs.
+   */
+  void check_memory();
+
   /**
    * Perform the given action.
    *
@@ -279,12 +557,94 @@ class Experiment : public ExperimentBase {
    * \param[in] include_pauli_blocking wheter to take Pauli blocking into
    *                                   account. Skipping Pauli blocking is
    *                                   useful for example for final decays.
+   * \param[out] deferred_output_density If given, the action is not written
+   *                                     to the outputs. Instead, the density
+   *                                     at the interaction point is stored
+   *                                     here, such that the caller can write
+   *                                     the output later on.
+   * \param[in] final_state_generated Whether the final state of the action
+   *                                  was generated beforehand, see
+   *                                  prepare_final_states.
    * \return False if the action is
    *                 rejected either due to invalidity or
    *                 Pauli-blocking, or true if it's accepted and performed.
    */
   bool perform_action(Action &action, int i_ensemble,
-                      bool include_pauli_blocking = true);
+                      bool include_pauli_blocking = true,
+                      double *deferred_output_density = nullptr,
+                      bool final_state_generated = false);
+
+  /**
+   * Write a performed action to all outputs interested in interactions.
+   *
+   * \param[in] action The performed action
+   * \param[in] density The density at the interaction point
+   * \param[in] i_ensemble Ensemble in which the action was performed
+   */
+  void write_interaction_output(const Action &action, double density,
+                                int i_ensemble);
+
+  /**
+   * Call the given function once for each ensemble index.
+   *
+   * If more than one ensemble thread is used, the ensembles are distributed
+   * over the threads and processed concurrently. In this case, every ensemble
+   * draws its random numbers from its own engine and its interactions are
+   * written to the outputs only after all threads are done, in the order of
+   * the ensembles. In both cases, the interaction counters of the ensembles
+   * are merged into the totals of the event in the order of the ensembles.
+   *
+   * \param[in] evolve_ensemble Function taking the index of the ensemble, it
+   *                            must only modify that ensemble.
+   * \throw Any exception thrown by evolve_ensemble, if one ensemble failed.
+   */
+  template <typename F>
+  void for_each_ensemble(F &&evolve_ensemble);
+
+  /**
+   * Add the interaction counters accumulated by one ensemble to the totals of
+   * the event and reset them.
+   *
+   * \param[in] i_ensemble Index of the ensemble
+   */
+  void merge_ensemble_counters(int i_ensemble);
+
+  /**
+   * \return The conserved quantities of all ensembles, taken from
+   * conserved_current_ if only actions change them and counted from all
+   * particles otherwise.
+   */
+  QuantumNumbers current_conserved_quantities() const {
+    if (potentials_ || metric_.mode_ != ExpansionMode::NoExpansion) {
+      return QuantumNumbers(ensembles_);
+    }
+    return conserved_current_;
+  }
+
+  /**
+   * Check that the conserved quantities are still the initial ones, if they
+   * are expected to be conserved. This is the case if potentials and string
+   * fragmentation are off. If potentials are on then momentum is conserved
+   * only in average. If string fragmentation is on, then energy and momentum
+   * are only very roughly conserved in high-energy collisions.
+   *
+   * \param[in] recount Whether the conserved quantities are counted from all
+   *            particles instead of being taken from conserved_current_.
+   * \throw std::runtime_error if a conserved quantity changed.
+   */
+  void check_conservation(bool recount) const;
+
+  /**
+   * Install the potentials and the formation power of this experiment, which
+   * the evaluation of widths and cross sections reads from thread-local
+   * state, on the calling thread. This is done at the entry points of the
+   * experiment and on the ensemble threads, such that experiments with
+   * different settings can run concurrently.
+   *
+   * \return Guard restoring the previous potentials of the thread
+   */
+  ScopedPotentialPointers use_on_this_thread() const;
+
   /**
    * Create a list of output files
    *
@@ -303,8 +663,10 @@ class Experiment : public ExperimentBase {
    *
    * \param[in] to_time Time at the end of propagation [fm]
    * \param[in, out] particles Particles to be propagated
+   * \param[in] n_threads Number of threads sharing the particles
    */
-  void propagate_and_shine(double to_time, Particles &particles);
+  void propagate_and_shine(double to_time, Particles &particles,
+                           int n_threads = 1);
 
   /**
    * Performs all the propagations and actions during a certain time interval
@@ -321,12 +683,228 @@ class Experiment : public ExperimentBase {
   void run_time_evolution_timestepless(Actions &actions, int i_ensemble,
                                        const double end_time_propagation);
 
-  /// Intermediate output during an event
+  /// An action of which the final state was generated in advance
+  struct PreparedAction {
+    /// The action
+    ActionPtr action;
+    /// Whether the action turned out to be below its energy threshold
+    bool below_threshold = false;
+    /// Exception thrown while generating the final state, if any
+    std::exception_ptr error;
+  };
+
+  /**
+   * Generate the final state of an action from its own random number stream,
+   * such that it does not depend on when and on which thread it is generated.
+   * Exceptions are stored in the prepared action instead of being thrown.
+   *
+   * \param[in, out] prepared The action, with its incoming particles up to
+   *                 date
+   * \param[in] actions_seed Seed from which the streams of all actions of
+   *            the current propagation are derived
+   * \param[in] i_worker Index of the string process to use
+   */
+  void generate_final_state(PreparedAction &prepared,
+                            std::uint64_t actions_seed, int i_worker) const;
+
+  /**
+   * Pop a batch of the next actions, which cannot influence each other, from
+   * the given actions and generate their final states on
+   * action_execution_threads_ threads.
+   *
+   * An action is taken into the batch, if it shares no incoming particle
+   * with any earlier popped action and lies outside of their future light
+   * cones, extended by the maximal interaction distance. The outgoing
+   * particles of the earlier actions then cannot reach its incoming particles
+   * before it is performed. Actions that do not qualify are put back. The
+   * prepared actions are still performed one after the other in the order
+   * of their times, and discarded if they became invalid meanwhile.
+   *
+   * \param[in, out] actions Pending actions of the ensemble
+   * \param[in] i_ensemble Index of the ensemble
+   * \param[in] end_time Time until which actions are performed
+   * \param[in] actions_seed \see generate_final_state
+   * \param[out] prepared Queue, to which the prepared actions are appended in
+   *                      the order of their times
+   */
+  void prepare_final_states(Actions &actions, int i_ensemble, double end_time,
+                            std::uint64_t actions_seed,
+                            std::deque<PreparedAction> &prepared);
+
+  /**
+   * Collects the current states of the particles of an ensemble, which can
+   * collide with the outgoing particles of an action until the end of the
+   * time step, from the cells of the grid of this time step close to them.
+   *
+   * The particles have moved at most by the time passed since the grid was
+   * updated, and the collision partners are at most twice the remaining time
+   * plus the maximal transverse distance away. This is at least as inclusive
+   * as the cell length of the grid, such that the same collisions are found
+   * as by searching all particles.
+   *
+   * \param[in]  i_ensemble index of the ensemble
+   * \param[in]  outgoing outgoing particles of the action, which have to be
+   *             placed onto the grid already
+   * \param[in]  time time of the action
+   * \param[in]  time_left time until the end of the time step
+   * \param[out] surroundings the particles close to \p outgoing, but not in
+   *             \p outgoing
+   * \return false if the grid cannot be searched locally, in which case all
+   *         particles have to be searched
+   */
+  bool collect_surrounding_particles(int i_ensemble,
+                                     const ParticleList &outgoing, double time,
+                                     double time_left,
+                                     ParticleList &surroundings) const;
+
+  /**
+   * Intermediate output during an event. If Overlap_Output_Times is set, only
+   * a copy of the state is taken here, and the outputs are written from it on
+   * another thread, see overlaps_output_times().
+   */
   void intermediate_output();
 
+  /**
+   * State of the experiment at an output time, from which the outputs at the
+   * output time are written. It refers either to the state of the time
+   * evolution itself or to a copy of it.
+   */
+  struct OutputTimeState {
+    /// Particles of all ensembles
+    const std::vector<Particles> *ensembles = nullptr;
+    /// Clock of the output times, at the output time
+    const std::unique_ptr<Clock> *outputclock = nullptr;
+    /// Number of interactions in the output interval
+    uint64_t interactions = 0;
+    /// Conserved quantities, which are counted from the ensembles if not set
+    std::optional<QuantumNumbers> conserved;
+    /// Whether projectile and target collided, one value for each ensemble
+    std::vector<char> projectile_target_interact;
+    /// Baryon current
+    DensityLattice *jmu_B_lat = nullptr;
+    /// Baryonic isospin current
+    DensityLattice *jmu_I3_lat = nullptr;
+    /// Current of the density type of the printout
+    DensityLattice *jmu_custom_lat = nullptr;
+    /// Charge, baryon and strangeness currents
+    DensityLattice *j_QBS_lat = nullptr;
+    /// Energy-momentum tensors
+    RectangularLattice<EnergyMomentumTensor> *Tmn = nullptr;
+    /// Electric and magnetic fields
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *EM_lat = nullptr;
+  };
+
+  /**
+   * Copy of the state of the experiment at an output time, which is taken if
+   * the output times are overlapped with the time evolution.
+   */
+  struct OutputTimeSnapshot {
+    /// Copy of the particles of all ensembles, kept to reuse their memory
+    std::vector<Particles> ensembles;
+    /// Clock frozen at the output time
+    std::unique_ptr<Clock> outputclock;
+    /// Copy of jmu_B_lat_
+    std::unique_ptr<DensityLattice> jmu_B_lat;
+    /// Copy of jmu_I3_lat_
+    std::unique_ptr<DensityLattice> jmu_I3_lat;
+    /// Copy of jmu_custom_lat_
+    std::unique_ptr<DensityLattice> jmu_custom_lat;
+    /// Copy of j_QBS_lat_
+    std::unique_ptr<DensityLattice> j_QBS_lat;
+    /// Copy of Tmn_
+    std::unique_ptr<RectangularLattice<EnergyMomentumTensor>> Tmn;
+    /// Copy of EM_lat_
+    std::unique_ptr<RectangularLattice<std::pair<ThreeVector, ThreeVector>>>
+        EM_lat;
+  };
+
+  /**
+   * Compute the mean field energy and the measurements at an output time,
+   * log them and pass the particles and the lattices to the outputs at the
+   * output times.
+   *
+   * \param[in] state State of the experiment at the output time.
+   */
+  void write_output_time(const OutputTimeState &state);
+
+  /**
+   * Whether the outputs at the output times are written concurrently with the
+   * time evolution. This needs that Overlap_Output_Times is set and that the
+   * outputs at the output times depend on nothing but the copied state, i.e.
+   * that none of them receives the interactions and there is no thermalizer.
+   */
+  bool overlaps_output_times() const;
+
+  /**
+   * Wait until the outputs at the last output time are written, if they are
+   * written concurrently.
+   *
+   * \throw any exception thrown while writing them.
+   */
+  void finish_output_time();
+
+  /**
+   * Collect the outputs subscribing to the interactions and to the callbacks
+   * at the output times, such that the others are not called at all, and
+   * check whether the density at the interaction points is needed.
+   */
+  void update_subscriptions();
+
+  /**
+   * \param[in] output One of the outputs.
+   * \return the profiled phase of its callbacks.
+   */
+  std::size_t output_phase(const std::unique_ptr<OutputInterface> &output) {
+    return output_phases_[&output - outputs_.data()];
+  }
+
   /// Recompute potentials on lattices if necessary.
   void update_potentials();
 
+  /**
+   * Recompute the density on the lattice the interaction density is taken
+   * from, if it is used by an output.
+   */
+  void update_interaction_density_lattice();
+
+  /**
+   * Set the length of the next time step in the adaptive time step mode from
+   * the state of the system at the end of the current one.
+   *
+   * \param[in] dt Length of the time step that just ended [fm]
+   * \param[in] n_actions Number of actions found at its beginning in all
+   *            ensembles
+   */
+  void adapt_timestep_duration(double dt, std::size_t n_actions);
+
+  /**
+   * Check whether the scattering rate per particle fell below the freeze-out
+   * rate of the modus, after which the particles only stream freely.
+   *
+   * \param[in] n_scatterings Number of scatterings in the last time step in
+   *            all ensembles
+   * \param[in] dt Length of the last time step [fm]
+   */
+  void detect_freeze_out(uint64_t n_scatterings, double dt);
+
+  /**
+   * Propagate all particles along straight lines until a given time, without
+   * searching for actions, and write the intermediate outputs on the way.
+   * This is used after the freeze-out.
+   *
+   * \param[in] t_end Time until which the particles are propagated [fm]
+   */
+  void stream_freely(double t_end);
+
+  /**
+   * Centre all lattices on the bounding box of the particles and let them
+   * grow if needed, see \ref key_lattice_adaptive_interval_. This is done at
+   * the start of an event and once the adaptive interval has passed.
+   *
+   * \param[in] force Whether to follow the particles regardless of the time
+   */
+  void follow_particles_with_lattices(bool force);
+
   /**
    * Calculate the minimal size for the grid cells such that the
    * ScatterActionsFinder will find all collisions within the maximal
@@ -353,6 +931,115 @@ class Experiment : public ExperimentBase {
    */
   void count_nonempty_ensembles();
 
+  /**
+   * Simulates the event event_ from the initial state to the final output.
+   *
+   * \param[in] resume Whether to resume the event from the checkpoint given
+   *            in the configuration instead of sampling its initial state.
+   */
+  void run_event(bool resume = false);
+
+  /**
+   * Writes the state of the event to the checkpoint file, replacing the
+   * previous checkpoint only once the new one is complete.
+   *
+   * PYTHIA is reseeded from the SMASH random number engine after the
+   * checkpoint is written and after it is read, such that the resumed event
+   * continues bit by bit like the event that was checkpointed.
+   */
+  void write_checkpoint();
+
+  /**
+   * Restores the state of an event from a checkpoint written by
+   * write_checkpoint and prepares the outputs as at the start of an event.
+   *
+   * \throw runtime_error if the checkpoint cannot be read or was written with
+   *        a different setup.
+   */
+  void resume_event();
+
+  /**
+   * Writes the state at the start of the event to all outputs.
+   *
+   * \param[in] E_mean_field Energy of the mean field at the start of the event
+   */
+  void output_at_event_start(double E_mean_field);
+
+  /**
+   * Calls a function for all lattices, in a fixed order. The lattices that
+   * are not used are passed as null pointers.
+   *
+   * \param[in] f Function taking a (const) reference to the unique pointer of
+   *            each lattice.
+   */
+  template <typename F>
+  void for_each_lattice(F &&f) {
+    f(j_QBS_lat_);
+    f(jmu_B_lat_);
+    f(jmu_I3_lat_);
+    f(jmu_el_lat_);
+    f(fields_lat_);
+    f(jmu_custom_lat_);
+    f(jmu_interaction_lat_);
+    f(UB_lat_);
+    f(UI3_lat_);
+    f(FB_lat_);
+    f(FI3_lat_);
+    f(EM_lat_);
+    f(Tmn_);
+    f(old_jmu_auxiliary_);
+    f(old_fields_auxiliary_);
+    f(new_fields_auxiliary_);
+    f(fields_four_gradient_auxiliary_);
+  }
+
+  /**
+   * \return the quantities of the setup which have to agree between a
+   *         checkpoint and the run resuming it.
+   */
+  std::array<int64_t, 6> checkpoint_setup() const {
+    return {modus_.is_box(),
+            parameters_.n_ensembles,
+            parameters_.testparticles,
+            parameters_.n_subensembles,
+            ensemble_threads_ > 1,
+            static_cast<int64_t>(ParticleType::list_all().size())};
+  }
+
+  /**
+   * Calls a function for all counters and accumulated quantities of the event
+   * which are part of a checkpoint, in a fixed order.
+   *
+   * \param[in] f Function taking a (const) reference to each quantity.
+   */
+  template <typename F>
+  void for_each_checkpointed_quantity(F &&f) {
+    f(conserved_initial_);
+    f(initial_mean_field_energy_);
+    f(interactions_total_);
+    f(previous_interactions_total_);
+    f(wall_actions_total_);
+    f(previous_wall_actions_total_);
+    f(scatterings_total_);
+    f(frozen_out_);
+    f(total_pauli_blocked_);
+    f(total_hypersurface_crossing_actions_);
+    f(discarded_interactions_total_);
+    f(total_energy_removed_);
+    f(total_energy_violated_by_Pythia_);
+    f(timesteps_since_potentials_update_);
+    f(next_lattice_adaptation_time_);
+    f(nonempty_ensembles_);
+    f(projectile_target_interact_);
+    f(ensemble_interactions_total_);
+    f(interaction_statistics_);
+    f(interval_interaction_statistics_);
+    f(next_checkpoint_time_);
+  }
+
+  /// Writes the reports of the whole run, e.g. the profile, after all events.
+  void finish_run();
+
   /**
    * Checks wether the desired number events have been calculated
    *
@@ -379,6 +1066,86 @@ class Experiment : public ExperimentBase {
   /// Complete particle list, all ensembles in one vector
   std::vector<Particles> ensembles_;
 
+  /// Type of the grid the modus creates for the collision search
+  using GridType = decltype(std::declval<const Modus &>().create_grid(
+      std::declval<const Particles &>(), 0., 0., CollisionCriterion::Geometric,
+      false));
+
+  /**
+   * Grid of each ensemble, kept between time steps such that it can be
+   * updated instead of rebuilt. Created on the first time step.
+   */
+  std::vector<std::unique_ptr<GridType>> grids_;
+
+  /**
+   * Actions found for each ensemble in the current time step. They are kept
+   * between time steps and events, such that their calendars are refilled
+   * without allocating memory once they have grown.
+   */
+  std::vector<Actions> timestep_actions_;
+
+  /**
+   * Buffer of each ensemble for the particles close to the outgoing particles
+   * of an action, kept such that its storage is reused by all actions.
+   */
+  std::vector<ParticleList> surroundings_;
+
+  /**
+   * Cell sizer of the grid of each ensemble, if the cell length is adapted
+   * to the occupancy of the grid, see \ref key_gen_adaptive_cell_size_.
+   */
+  std::vector<AdaptiveCellSizer> cell_sizers_;
+
+  /**
+   * Fraction of holes and added particles above which the particles of an
+   * ensemble are sorted by their position, see
+   * \ref key_gen_spatial_sorting_threshold_. 0 if they are never sorted.
+   */
+  double spatial_sorting_threshold_ = 0.;
+
+  /**
+   * Find the actions of one ensemble at the beginning of a time step by
+   * searching the cells of its grid on action_finding_threads_ threads.
+   *
+   * Every non-empty search cell draws its random numbers from its own stream,
+   * which is seeded from one number drawn from the ensemble's stream and the
+   * id of the first particle in the cell. The actions found in the cells are
+   * merged ordered by their time of execution and the ids of their incoming
+   * particles. Hence, the found actions and their order do not depend on the
+   * number of threads.
+   *
+   * \param[in] grid Grid of the ensemble
+   * \param[in] dt Duration of the time step \unit{in fm}
+   * \param[out] actions Actions of the ensemble, to which the found ones are
+   *                     added
+   */
+  void find_actions_in_parallel(const GridType &grid, double dt,
+                                Actions &actions) const;
+
+  /**
+   * Find the actions within a search cell of a grid, passing the members of
+   * the cell that take part in multi-particle reactions, if the grid lists
+   * them (see Grid::set_member_selection).
+   *
+   * \param[in] finder Action finder
+   * \param[in] grid Grid of the ensemble
+   * \param[in] search_list Search cell of \p grid
+   * \param[in] dt Duration of the time step \unit{in fm}
+   * \return the actions found in the cell
+   */
+  ActionList find_actions_in_grid_cell(const ActionFinderInterface &finder,
+                                       const GridType &grid,
+                                       const ParticleList &search_list,
+                                       double dt) const {
+    if (grid.selects_members()) {
+      return finder.find_actions_in_cell_with_members(
+          search_list, grid.members_of(search_list), dt, grid.cell_volume(),
+          beam_momentum_);
+    }
+    return finder.find_actions_in_cell(search_list, dt, grid.cell_volume(),
+                                       beam_momentum_);
+  }
+
   /**
    * An instance of potentials class, that stores parameters of potentials,
    * calculates them and their gradients.
@@ -397,6 +1164,72 @@ class Experiment : public ExperimentBase {
    */
   OutputsList outputs_;
 
+  /// Profiled phase of the callbacks of each output in outputs_
+  std::vector<std::size_t> output_phases_;
+
+  /// Positions in outputs_ of the outputs receiving the interactions
+  std::vector<std::size_t> interaction_subscribers_;
+
+  /// Positions in outputs_ of the outputs receiving the output times
+  std::vector<std::size_t> intermediate_subscribers_;
+
+  /// Whether an output uses the density at the interaction points
+  bool interaction_density_needed_ = false;
+
+  /// Profiler of the phases of the evolution, if enabled
+  Profiler profiler_;
+
+  /// File the profile of the run is written to, if profiling is enabled
+  std::filesystem::path profile_path_;
+
+  /// File the timeline of the run is written to, if tracing is enabled
+  std::filesystem::path trace_path_;
+
+  /**
+   * The cost of every this many performed actions is measured, 0 if the
+   * costs are not measured
+   */
+  uint64_t action_cost_sampling_ = 0;
+
+  /// Sampled costs of the performed actions of each process type in the run
+  std::map<ProcessType, ActionCost> action_costs_;
+
+  /// Time interval between the checkpoints of an event [fm], 0 if disabled
+  double checkpoint_interval_ = 0.;
+
+  /// Time of the next checkpoint of the event [fm]
+  double next_checkpoint_time_ = 0.;
+
+  /// File the checkpoints are written to, if they are enabled
+  std::filesystem::path checkpoint_path_;
+
+  /// Checkpoint from which the run is resumed, empty for a new run
+  std::filesystem::path resume_path_;
+
+  /// Whether run_next_event() simulated an event since begin_events()
+  bool pulled_event_ = false;
+
+  /// Whether run_next_event() found the experiment to be finished
+  bool pulled_all_events_ = false;
+
+  /// Memory of the process above which the outputs are flushed early [bytes]
+  double memory_budget_ = 0.;
+
+  /// Whether the memory budget was exceeded in the current event
+  bool memory_budget_exceeded_ = false;
+
+  /// Whether the output times may be overlapped with the time evolution
+  bool overlap_output_times_ = false;
+
+  /// Copy of the state at the last output time, if overlapped
+  OutputTimeSnapshot output_time_snapshot_;
+
+  /// Thread writing the outputs at the last output time, if overlapped
+  std::thread output_time_writer_;
+
+  /// Exception thrown while writing the outputs at the last output time
+  std::exception_ptr output_time_error_;
+
   /// The Dilepton output
   OutputPtr dilepton_output_;
 
@@ -405,9 +1238,10 @@ class Experiment : public ExperimentBase {
 
   /**
    * Whether the projectile and the target collided.
-   * One value for each ensemble.
+   * One value for each ensemble. A std::vector<bool> cannot be used here,
+   * because the ensembles may set their value concurrently.
    */
-  std::vector<bool> projectile_target_interact_;
+  std::vector<char> projectile_target_interact_;
 
   /**
    * The initial nucleons in the ColliderModus propagate with
@@ -419,6 +1253,15 @@ class Experiment : public ExperimentBase {
   /// The Action finder objects
   std::vector<std::unique_ptr<ActionFinderInterface>> action_finders_;
 
+  /// The decay finder among the action_finders_, nullptr if decays are off
+  DecayActionsFinder *decay_finder_ = nullptr;
+
+  /**
+   * The scatter finder among the action_finders_, nullptr if collisions are
+   * off
+   */
+  ScatterActionsFinder *scatter_finder_ = nullptr;
+
   /// The Dilepton Action Finder
   std::unique_ptr<DecayActionsFinderDilepton> dilepton_finder_;
 
@@ -452,6 +1295,13 @@ class Experiment : public ExperimentBase {
    */
   std::unique_ptr<DensityLattice> jmu_custom_lat_;
 
+  /**
+   * Density of the type written to the collision headers, updated at the
+   * beginning of every time step if the interaction density is taken from the
+   * lattice.
+   */
+  std::unique_ptr<DensityLattice> jmu_interaction_lat_;
+
   /// Type of density for lattice printout
   DensityType dens_type_lattice_printout_ = DensityType::None;
 
@@ -482,16 +1332,14 @@ class Experiment : public ExperimentBase {
   std::unique_ptr<RectangularLattice<std::pair<ThreeVector, ThreeVector>>>
       EM_lat_;
 
+  /// Solver for the fields on EM_lat_ by Fourier transforms, if requested
+  std::unique_ptr<CoulombFieldSolver> coulomb_solver_;
+
   /// Lattices of energy-momentum tensors for printout
   std::unique_ptr<RectangularLattice<EnergyMomentumTensor>> Tmn_;
 
   /// Auxiliary lattice for values of jmu at a time step t0
   std::unique_ptr<RectangularLattice<FourVector>> old_jmu_auxiliary_;
-  /// Auxiliary lattice for values of jmu at a time step t0 + dt
-  std::unique_ptr<RectangularLattice<FourVector>> new_jmu_auxiliary_;
-  /// Auxiliary lattice for calculating the four-gradient of jmu
-  std::unique_ptr<RectangularLattice<std::array<FourVector, 4>>>
-      four_gradient_auxiliary_;
 
   /// Auxiliary lattice for values of Amu at a time step t0
   std::unique_ptr<RectangularLattice<FourVector>> old_fields_auxiliary_;
@@ -501,6 +1349,32 @@ class Experiment : public ExperimentBase {
   std::unique_ptr<RectangularLattice<std::array<FourVector, 4>>>
       fields_four_gradient_auxiliary_;
 
+  /// Time interval after which the lattices follow the particles, 0 if fixed
+  double lattice_adaptive_interval_ = 0.0;
+
+  /// Distance by which the lattices exceed the particles when following them
+  double lattice_margin_ = 0.0;
+
+  /// Configured number of cells of the lattices, which they keep at least
+  std::array<int, 3> lattice_min_cells_ = {};
+
+  /// Time at which the lattices follow the particles next [fm]
+  double next_lattice_adaptation_time_ = 0.0;
+
+  /// Number of time steps after which the potentials on the lattices are
+  /// recomputed
+  int potentials_update_interval_ = 1;
+
+  /// Number of time steps since the potentials on the lattices were computed
+  int timesteps_since_potentials_update_ = 0;
+
+  /**
+   * Forces on the particles at the end of the last time step, which give the
+   * first half kick of the next one with the leapfrog scheme. Empty if they
+   * are not known for the current particles.
+   */
+  ParticleForces half_kick_forces_;
+
   /// Whether to print the Eckart rest frame density
   bool printout_rho_eckart_ = false;
 
@@ -594,6 +1468,12 @@ class Experiment : public ExperimentBase {
    */
   const bool force_decays_;
 
+  /**
+   * This indicates whether the decay times of resonances are sampled only
+   * once after each interaction instead of in every time step.
+   */
+  const bool sample_decay_times_once_;
+
   /// This indicates whether to use the grid.
   const bool use_grid_;
 
@@ -615,6 +1495,9 @@ class Experiment : public ExperimentBase {
   /// This indicates whether to use time steps.
   const TimeStepMode time_step_mode_;
 
+  /// Choice of the next time step length in the adaptive time step mode
+  std::unique_ptr<AdaptiveTimeStep> adaptive_time_step_;
+
   /**
    * Maximal distance at which particles can interact in case of the geometric
    * criterion, squared
@@ -630,6 +1513,21 @@ class Experiment : public ExperimentBase {
    */
   QuantumNumbers conserved_initial_;
 
+  /**
+   * The current conserved quantities of the system, kept up to date with the
+   * changes by the performed actions instead of being counted from all
+   * particles. Only valid as long as nothing but actions changes them, i.e.
+   * without potentials and expansion, see current_conserved_quantities.
+   */
+  QuantumNumbers conserved_current_;
+
+  /**
+   * Number of time steps after which the conserved quantities are counted
+   * from all particles for the conservation check, or 0 to count them only at
+   * the end of the time evolution
+   */
+  int conservation_recount_interval_ = 0;
+
   /**
    * The initial total mean field energy in the system.
    * Note: will only be calculated if lattice is on.
@@ -642,6 +1540,10 @@ class Experiment : public ExperimentBase {
   /// Type of density to be written to collision headers
   DensityType dens_type_ = DensityType::None;
 
+  /// How the density at the interaction points is evaluated
+  InteractionDensityMode interaction_density_mode_ =
+      InteractionDensityMode::Exact;
+
   /**
    *  Total number of interactions for current timestep.
    *  For timestepless mode the whole run time is considered as one timestep.
@@ -666,6 +1568,27 @@ class Experiment : public ExperimentBase {
    */
   uint64_t previous_wall_actions_total_ = 0;
 
+  /**
+   * Total number of scatterings, i.e. interactions of more than one incoming
+   * particle, in the current event. It is used to detect the freeze-out.
+   */
+  uint64_t scatterings_total_ = 0;
+
+  /**
+   * Whether the freeze-out of the current event was detected, after which the
+   * particles only stream freely.
+   */
+  bool frozen_out_ = false;
+
+  /**
+   * Whether the nucleons of the colliding nuclei that cannot interact yet are
+   * left out of the grid.
+   */
+  bool exclude_spectators_ = false;
+
+  /// The spectators of each ensemble, if they are left out of the grid
+  std::vector<SpectatorSet> spectators_;
+
   /**
    *  Total number of Pauli-blockings for current timestep.
    *  For timestepless mode the whole run time is considered as one timestep.
@@ -680,7 +1603,9 @@ class Experiment : public ExperimentBase {
 
   /**
    *  Total number of discarded interactions, because they were invalidated
-   *  before they could be performed.
+   *  before they could be performed. The pending actions of particles that
+   *  are consumed by a performed action are dropped right away and are not
+   *  counted.
    */
   uint64_t discarded_interactions_total_ = 0;
 
@@ -697,9 +1622,132 @@ class Experiment : public ExperimentBase {
   /// This indicates whether kinematic cuts are enabled for the IC output
   bool kinematic_cuts_for_IC_output_ = false;
 
-  /// random seed for the next event.
+  /// Random seed of the run, from which the seeds of the events are derived
   int64_t seed_ = -1;
 
+  /// Number of events by which the event number advances in run()
+  int event_stride_ = 1;
+
+  /// Number of consecutive events evolved from the same initial state
+  int oversampling_ = 1;
+
+  /// First event of the group whose initial state is kept, -1 if none is
+  int initial_state_event_ = -1;
+
+  /// Start time of the kept initial state
+  double initial_start_time_ = 0.;
+
+  /// Initial particles of all ensembles, kept for the events of a group
+  std::vector<std::unique_ptr<Particles>> initial_ensembles_;
+
+  /// Number of threads used to evolve the ensembles concurrently
+  int ensemble_threads_ = 1;
+
+  /**
+   * Cores to which each ensemble thread is bound, empty if the threads are
+   * not bound, see \ref key_gen_thread_affinity_ "Thread_Affinity"
+   */
+  std::vector<std::vector<int>> ensemble_thread_cores_;
+
+  /**
+   * Whether the particles of each ensemble were moved to the NUMA node of
+   * their thread in the current event. A char per ensemble, such that the
+   * threads can set their entries concurrently.
+   */
+  std::vector<char> ensemble_relocated_;
+
+  /**
+   * Number of threads searching the cells of one ensemble for actions, or 0
+   * to search them one after the other, see find_actions_in_parallel
+   */
+  int action_finding_threads_ = 0;
+
+  /**
+   * Number of threads generating the final states of independent actions of
+   * one ensemble, or 0 to generate them one after the other, see
+   * prepare_final_states
+   */
+  int action_execution_threads_ = 0;
+
+  /**
+   * Number of threads sharing the particles of one ensemble when they are
+   * propagated to the end of a time step or expanded, or 0 for one thread
+   */
+  int propagation_threads_ = 0;
+
+  /**
+   * Whether only the particles taking part in an action or searched for
+   * partners are propagated to the time of the action, see
+   * run_time_evolution_timestepless
+   */
+  bool lazy_propagation_ = false;
+
+  /**
+   * Whether the collisions of the particles produced in an action are only
+   * searched once the evolution is about to reach their earliest possible
+   * collision time, see run_time_evolution_timestepless
+   */
+  bool defer_collision_search_ = false;
+
+  /// Power with which the cross sections of forming particles grow in time
+  double formation_power_;
+
+  /// Interaction statistics of the event up to the last output time
+  InteractionStatistics interaction_statistics_;
+
+  /// Interaction statistics of the last output interval
+  InteractionStatistics interval_interaction_statistics_;
+
+  /**
+   * Interaction counters of a single ensemble, accumulated since they were
+   * last merged into the totals of the event.
+   */
+  struct EnsembleCounters {
+    /// Change of the conserved quantities, see conserved_current_
+    QuantumNumbers conserved_change;
+    /// Performed interactions, see interactions_total_
+    uint64_t interactions = 0;
+    /// Performed wall crossings, see wall_actions_total_
+    uint64_t wall_actions = 0;
+    /// Performed scatterings, see scatterings_total_
+    uint64_t scatterings = 0;
+    /// Pauli-blocked interactions, see total_pauli_blocked_
+    uint64_t pauli_blocked = 0;
+    /// Hypersurface crossings, see total_hypersurface_crossing_actions_
+    uint64_t hypersurface_crossing_actions = 0;
+    /// Discarded interactions, see discarded_interactions_total_
+    uint64_t discarded_interactions = 0;
+    /// Energy removed by hypersurface crossings, see total_energy_removed_
+    double energy_removed = 0.0;
+    /// Energy violation by Pythia, see total_energy_violated_by_Pythia_
+    double energy_violated_by_Pythia = 0.0;
+    /// Sampled costs of the actions, see action_costs_
+    std::map<ProcessType, ActionCost> action_costs;
+  };
+
+  /// Not yet merged interaction counters, one entry for each ensemble
+  std::vector<EnsembleCounters> ensemble_counters_;
+
+  /**
+   * Interactions performed in each ensemble during the event, from which the
+   * process ids of concurrently evolved ensembles are derived.
+   */
+  std::vector<uint64_t> ensemble_interactions_total_;
+
+  /**
+   * Random number streams of the ensembles, only used if the ensembles are
+   * evolved concurrently. They are swapped into the thread-local
+   * random::engine of the thread processing the corresponding ensemble.
+   */
+  std::vector<random::Engine> ensemble_engines_;
+
+  /**
+   * Interactions performed concurrently, together with the density at their
+   * interaction point, which still have to be written to the outputs. One
+   * list for each ensemble.
+   */
+  std::vector<std::vector<std::pair<ActionPtr, double>>> deferred_interactions_;
+
   /**
    * \ingroup logging
    * Writes the initial state for the Experiment to the output stream.
@@ -752,6 +1800,16 @@ void Experiment<Modus>::create_output(const std::string &format,
       outputs_.emplace_back(std::make_unique<BinaryOutputInitialConditions>(
           output_path, content, out_par));
     }
+  } else if (format == "Columnar" && content == "Particles") {
+    outputs_.emplace_back(
+        std::make_unique<ColumnarOutput>(output_path, content, out_par));
+  } else if (format == "VTK_XML" &&
+             (content == "Particles" || content == "Thermodynamics")) {
+    if (content == "Thermodynamics") {
+      printout_lattice_td_ = true;
+    }
+    outputs_.emplace_back(
+        std::make_unique<VtkXmlOutput>(output_path, content, out_par));
   } else if (format == "Oscar1999" || format == "Oscar2013") {
     outputs_.emplace_back(
         create_oscar_output(format, content, output_path, out_par));
@@ -771,17 +1829,32 @@ void Experiment<Modus>::create_output(const std::string &format,
   } else if (content == "Initial_Conditions" && format == "ASCII") {
     outputs_.emplace_back(
         std::make_unique<ICOutput>(output_path, "SMASH_IC", out_par));
+  } else if (content == "Analysis" && format == "ASCII") {
+    outputs_.emplace_back(
+        std::make_unique<AnalysisOutput>(output_path, content, out_par));
+  } else if (content == "Green_Kubo" && format == "ASCII") {
+    outputs_.emplace_back(
+        std::make_unique<GreenKuboOutput>(output_path, content, out_par));
+  } else if (content == "Digest" && format == "ASCII") {
+    outputs_.emplace_back(
+        std::make_unique<DigestOutput>(output_path, content, out_par));
+  } else if (format == "Histograms" &&
+             (content == "Dileptons" || content == "Photons")) {
+    outputs_.emplace_back(std::make_unique<EmissionHistogramOutput>(
+        output_path, content, out_par));
   } else if ((format == "HepMC") || (format == "HepMC_asciiv3") ||
              (format == "HepMC_treeroot")) {
 #ifdef SMASH_USE_HEPMC
     if (content == "Particles") {
       if ((format == "HepMC") || (format == "HepMC_asciiv3")) {
         outputs_.emplace_back(std::make_unique<HepMcOutput>(
-            output_path, "SMASH_HepMC_particles", false, "asciiv3"));
+            output_path, "SMASH_HepMC_particles", false, "asciiv3",
+            out_par.part_hepmc_batch_size));
       } else if (format == "HepMC_treeroot") {
 #ifdef SMASH_USE_HEPMC_ROOTIO
         outputs_.emplace_back(std::make_unique<HepMcOutput>(
-            output_path, "SMASH_HepMC_particles", false, "root"));
+            output_path, "SMASH_HepMC_particles", false, "root",
+            out_par.part_hepmc_batch_size));
 #else
         logg[LExperiment].error(
             "Requested HepMC_treeroot output not available, "
@@ -791,11 +1864,15 @@ void Experiment<Modus>::create_output(const std::string &format,
     } else if (content == "Collisions") {
       if ((format == "HepMC") || (format == "HepMC_asciiv3")) {
         outputs_.emplace_back(std::make_unique<HepMcOutput>(
-            output_path, "SMASH_HepMC_collisions", true, "asciiv3"));
+            output_path, "SMASH_HepMC_collisions", true, "asciiv3",
+            out_par.coll_hepmc_batch_size,
+            out_par.coll_hepmc_min_elastic_sqrts));
       } else if (format == "HepMC_treeroot") {
 #ifdef SMASH_USE_HEPMC_ROOTIO
         outputs_.emplace_back(std::make_unique<HepMcOutput>(
-            output_path, "SMASH_HepMC_collisions", true, "root"));
+            output_path, "SMASH_HepMC_collisions", true, "root",
+            out_par.coll_hepmc_batch_size,
+            out_par.coll_hepmc_min_elastic_sqrts));
 #else
         logg[LExperiment].error(
             "Requested HepMC_treeroot output not available, "
@@ -858,6 +1935,18 @@ void Experiment<Modus>::create_output(const std::string &format,
  */
 ExperimentParameters create_experiment_parameters(Configuration &config);
 
+/**
+ * Evaluate all quantities which are computed on their first use and then
+ * cached in objects shared by all ensembles: the mass thresholds, isospins and
+ * spectral function normalizations of the particle types, the tabulated decay
+ * widths and the interpolations of the cross-section parametrizations.
+ *
+ * Afterwards these quantities are only read, such that ensembles can be
+ * evolved concurrently. Note that the maxima used for the rejection sampling
+ * of resonance masses are still adapted on the fly.
+ */
+void initialize_lazy_caches();
+
 template <typename Modus>
 Experiment<Modus>::Experiment(Configuration &config,
                               const std::filesystem::path &output_path)
@@ -883,11 +1972,17 @@ Experiment<Modus>::Experiment(Configuration &config,
         return Modus{std::move(modus_config), parameters_};
       })),
       ensembles_(parameters_.n_ensembles),
+      grids_(parameters_.n_ensembles),
+      timestep_actions_(parameters_.n_ensembles),
+      surroundings_(parameters_.n_ensembles),
       nevents_(config.take({"General", "Nevents"}, 0)),
       end_time_(config.take({"General", "End_Time"})),
       delta_time_startup_(parameters_.labclock->timestep_duration()),
       force_decays_(
           config.take({"Collision_Term", "Force_Decays_At_End"}, true)),
+      sample_decay_times_once_(config.take(
+          {"Collision_Term", "Sample_Decay_Times_Once"},
+          InputKeys::collTerm_sampleDecayTimesOnce.default_value())),
       use_grid_(config.take({"General", "Use_Grid"}, true)),
       metric_(
           config.take({"General", "Metric_Type"}, ExpansionMode::NoExpansion),
@@ -903,6 +1998,22 @@ Experiment<Modus>::Experiment(Configuration &config,
           config.take({"General", "Time_Step_Mode"}, TimeStepMode::Fixed)) {
   logg[LExperiment].info() << *this;
 
+  // The memory is only accounted for containers updated from now on.
+  memory_budget_ =
+      1024. * 1024. *
+      config.take({"General", "Memory_Budget"},
+                  InputKeys::gen_memoryBudget.default_value());
+  if (memory_budget_ < 0.) {
+    throw std::invalid_argument(
+        "Memory_Budget has to be positive, or 0 for no budget.");
+  }
+  if (config.take({"General", "Memory_Tracking"},
+                  InputKeys::gen_memoryTracking.default_value()) ||
+      memory_budget_ > 0.) {
+    MemoryTracker::set_enabled(true);
+    logg[LExperiment].info("Tracking the memory of the subsystems.");
+  }
+
   if (config.has_value({"General", "Minimum_Nonempty_Ensembles"})) {
     if (config.has_value({"General", "Nevents"})) {
       throw std::invalid_argument(
@@ -937,10 +2048,29 @@ Experiment<Modus>::Experiment(Configuration &config,
   }
 
   if (parameters_.coll_crit == CollisionCriterion::Stochastic &&
-      (time_step_mode_ != TimeStepMode::Fixed || !use_grid_)) {
+      (time_step_mode_ == TimeStepMode::None || !use_grid_)) {
     throw std::invalid_argument(
-        "The stochastic criterion can only be employed for fixed time step "
-        "mode and with a grid!");
+        "The stochastic criterion can only be employed with time steps and "
+        "with a grid!");
+  }
+
+  spatial_sorting_threshold_ =
+      config.take({"General", "Spatial_Sorting_Threshold"},
+                  InputKeys::gen_spatialSortingThreshold.default_value());
+  if (spatial_sorting_threshold_ < 0.) {
+    throw std::invalid_argument(
+        "Spatial_Sorting_Threshold has to be positive, or 0 to never sort "
+        "the particles.");
+  }
+
+  if (config.take({"General", "Adaptive_Cell_Size"},
+                  InputKeys::gen_adaptiveCellSize.default_value())) {
+    if (parameters_.coll_crit == CollisionCriterion::Stochastic || !use_grid_) {
+      throw std::invalid_argument(
+          "Adaptive_Cell_Size can only be used with a grid and not with the "
+          "stochastic criterion, for which the cell size is a parameter.");
+    }
+    cell_sizers_.resize(parameters_.n_ensembles);
   }
 
   if (modus_.is_box() && (time_step_mode_ != TimeStepMode::Fixed)) {
@@ -948,11 +2078,114 @@ Experiment<Modus>::Experiment(Configuration &config,
         "The box modus can only be used with the fixed time step mode!");
   }
 
+  if (time_step_mode_ == TimeStepMode::Adaptive) {
+    const AdaptiveTimeStepParameters adaptive_parameters{
+        config.take({"General", "Adaptive_Time_Step", "Minimum_Delta_Time"},
+                    0.01),
+        config.take({"General", "Adaptive_Time_Step", "Maximum_Delta_Time"},
+                    1.0),
+        config.take({"General", "Adaptive_Time_Step", "Actions_Per_Particle"},
+                    0.1),
+        config.take({"General", "Adaptive_Time_Step", "Lattice_Cell_Fraction"},
+                    0.5),
+        config.take({"General", "Adaptive_Time_Step", "Momentum_Kick"}, 0.01)};
+    adaptive_time_step_ =
+        std::make_unique<AdaptiveTimeStep>(adaptive_parameters);
+    if (delta_time_startup_ < adaptive_parameters.min_dt ||
+        delta_time_startup_ > adaptive_parameters.max_dt) {
+      throw std::invalid_argument(
+          "Delta_Time has to lie between the Minimum_Delta_Time and the "
+          "Maximum_Delta_Time of the adaptive time step.");
+    }
+    logg[LExperiment].info(
+        "Adapting the time step between ", adaptive_parameters.min_dt,
+        " fm and ", adaptive_parameters.max_dt, " fm.");
+  }
+
   logg[LExperiment].info("Using ", parameters_.testparticles,
                          " testparticles per particle.");
+  if (parameters_.n_subensembles > 1) {
+    logg[LExperiment].info("Colliding the testparticles in ",
+                           parameters_.n_subensembles, " subensembles.");
+  }
   logg[LExperiment].info("Using ", parameters_.n_ensembles,
                          " parallel ensembles.");
 
+  ensemble_threads_ = config.take({"General", "Ensemble_Threads"}, 1);
+  if (ensemble_threads_ < 1) {
+    throw std::invalid_argument(
+        "The number of ensemble threads has to be a positive integer.");
+  }
+  // Smearing onto the lattices is split in space and can use all threads.
+  density_param_.set_threads(ensemble_threads_);
+  parameters_.n_threads = ensemble_threads_;
+  if (ensemble_threads_ > parameters_.n_ensembles) {
+    logg[LExperiment].warn("Only ", parameters_.n_ensembles,
+                           " ensemble threads are used, one per ensemble.");
+    ensemble_threads_ = parameters_.n_ensembles;
+  }
+  if (ensemble_threads_ > 1) {
+    logg[LExperiment].info("Evolving the ensembles on ", ensemble_threads_,
+                           " threads.");
+  }
+  const ThreadAffinity thread_affinity =
+      config.take({"General", "Thread_Affinity"},
+                  InputKeys::gen_threadAffinity.default_value());
+  if (ensemble_threads_ > 1 && thread_affinity != ThreadAffinity::None) {
+    const NumaNodes nodes = usable_numa_nodes();
+    for (std::size_t node :
+         assign_numa_nodes(thread_affinity, nodes, ensemble_threads_)) {
+      ensemble_thread_cores_.push_back(nodes[node]);
+    }
+    if (ensemble_thread_cores_.empty()) {
+      logg[LExperiment].warn(
+          "The cores of the machine could not be determined, the ensemble "
+          "threads are not bound.");
+    } else {
+      logg[LExperiment].info("Binding the ensemble threads to ", nodes.size(),
+                             " NUMA node(s).");
+      ensemble_relocated_.assign(parameters_.n_ensembles, 0);
+    }
+  }
+  action_finding_threads_ =
+      config.take({"General", "Action_Finding_Threads"}, 0);
+  if (action_finding_threads_ < 0) {
+    throw std::invalid_argument("Action_Finding_Threads must not be negative.");
+  }
+  if (action_finding_threads_ > 0) {
+    logg[LExperiment].info("Finding the actions of each ensemble on ",
+                           action_finding_threads_, " threads.");
+  }
+  conservation_recount_interval_ =
+      config.take({"General", "Conservation_Recount_Interval"}, 0);
+  if (conservation_recount_interval_ < 0) {
+    throw std::invalid_argument(
+        "Conservation_Recount_Interval must not be negative.");
+  }
+  action_execution_threads_ =
+      config.take({"General", "Action_Execution_Threads"}, 0);
+  if (action_execution_threads_ < 0) {
+    throw std::invalid_argument(
+        "Action_Execution_Threads must not be negative.");
+  }
+  if (action_execution_threads_ > 0) {
+    logg[LExperiment].info("Generating the final states of independent ",
+                           "actions of each ensemble on ",
+                           action_execution_threads_, " threads.");
+  }
+  propagation_threads_ =
+      config.take({"General", "Propagation_Threads"},
+                  InputKeys::gen_propagationThreads.default_value());
+  if (propagation_threads_ < 0) {
+    throw std::invalid_argument("Propagation_Threads must not be negative.");
+  }
+  lazy_propagation_ =
+      config.take({"General", "Lazy_Propagation"},
+                  InputKeys::gen_lazyPropagation.default_value());
+  ensemble_counters_.resize(parameters_.n_ensembles);
+  ensemble_interactions_total_.resize(parameters_.n_ensembles);
+  deferred_interactions_.resize(parameters_.n_ensembles);
+
   if (modus_.is_box() &&
       config.read({"Collision_Term", "Total_Cross_Section_Strategy"},
                   InputKeys::collTerm_totXsStrategy.default_value()) !=
@@ -964,6 +2197,9 @@ Experiment<Modus>::Experiment(Configuration &config,
         "in your configuration file:\n"
         "   Total_Cross_Section_Strategy: \"BottomUp\"");
   }
+  use_tabulated_parametrizations(config.take(
+      {"Collision_Term", "Tabulate_Parametrizations"},
+      InputKeys::collTerm_tabulateParametrizations.default_value()));
   if (modus_.is_box() &&
       config.read({"Collision_Term", "Pseudoresonance"},
                   InputKeys::collTerm_pseudoresonance.default_value()) !=
@@ -984,7 +2220,7 @@ Experiment<Modus>::Experiment(Configuration &config,
    *       the configuration temporary object will be destroyed not empty, hence
    *       throwing an exception.
    */
-  ParticleData::formation_power_ = config.take(
+  formation_power_ = config.take(
       {"Collision_Term", "String_Parameters", "Power_Particle_Formation"},
       modus_.sqrt_s_NN() >= 200. ? -1. : 1.);
 
@@ -1008,27 +2244,54 @@ Experiment<Modus>::Experiment(Configuration &config,
           "inelastically (e.g. resonance chains), else SMASH is known to "
           "hang.");
     }
-    action_finders_.emplace_back(std::make_unique<DecayActionsFinder>(
-        parameters_.res_lifetime_factor, parameters_.do_weak_decays));
+    auto decay_finder = std::make_unique<DecayActionsFinder>(
+        parameters_.res_lifetime_factor, parameters_.do_weak_decays);
+    decay_finder_ = decay_finder.get();
+    action_finders_.emplace_back(std::move(decay_finder));
   }
   bool no_coll = config.take({"Collision_Term", "No_Collisions"}, false);
+  defer_collision_search_ =
+      config.take({"Collision_Term", "Defer_Collision_Search"},
+                  InputKeys::collTerm_deferCollisionSearch.default_value());
   if ((parameters_.two_to_one || parameters_.included_2to2.any() ||
        parameters_.included_multi.any() || parameters_.strings_switch) &&
       !no_coll) {
+    ScopedTimer timer(startup_profiler(), StartupStage::ActionFinders);
     parameters_.use_monash_tune_default =
         (modus_.is_collider() && modus_.sqrt_s_NN() >= 200.);
-    auto scat_finder =
-        std::make_unique<ScatterActionsFinder>(config, parameters_);
-    max_transverse_distance_sqr_ =
-        scat_finder->max_transverse_distance_sqr(parameters_.testparticles);
+    // Every thread generating final states fragments strings on its own.
+    auto scat_finder = std::make_unique<ScatterActionsFinder>(
+        config, parameters_,
+        ensemble_threads_ * std::max(1, action_execution_threads_));
+    max_transverse_distance_sqr_ = scat_finder->max_transverse_distance_sqr(
+        parameters_.testparticles / parameters_.n_subensembles);
+    /* Spectators can only be left out if their collisions are found in a
+     * limited distance and all nucleons are not needed on the grid. */
+    exclude_spectators_ =
+        modus_.exclude_spectators() &&
+        !scat_finder->collisions_within_nucleus() &&
+        parameters_.coll_crit != CollisionCriterion::Stochastic &&
+        !IC_output_switch_;
     process_string_ptr_ = scat_finder->get_process_string_ptr();
+    if (process_string_ptr_ && action_execution_threads_ > 0) {
+      // Strings are seeded from the stream of their action.
+      process_string_ptr_->set_reseed_per_string(true);
+    }
+    if (defer_collision_search_ &&
+        (parameters_.coll_crit == CollisionCriterion::Stochastic ||
+         parameters_.included_multi.any())) {
+      throw std::invalid_argument(
+          "Defer_Collision_Search can neither be used with the stochastic "
+          "collision criterion nor with multi-particle reactions.");
+    }
+    scatter_finder_ = scat_finder.get();
     action_finders_.emplace_back(std::move(scat_finder));
   } else {
     max_transverse_distance_sqr_ =
         parameters_.maximum_cross_section / M_PI * fm2_mb;
     process_string_ptr_ = NULL;
   }
-  if (modus_.is_box()) {
+  if (modus_.is_box() && modus_.wall_crossing_actions()) {
     action_finders_.emplace_back(
         std::make_unique<WallCrossActionsFinder>(parameters_.box_length));
   }
@@ -1165,7 +2428,7 @@ Experiment<Modus>::Experiment(Configuration &config,
    *   - Available formats: \ref doxypage_output_oscar_particles,
    *                        \ref doxypage_output_binary, \ref
    *                        doxypage_output_root, \ref doxypage_output_vtk, \ref
-   *                        doxypage_output_hepmc
+   *                        doxypage_output_vtk_xml, \ref doxypage_output_hepmc
    * - \b Collisions List of interactions: collisions, decays, box wall
    *                 crossings and forced thermalizations. Information about
    *                 incoming, outgoing particles and the interaction itself
@@ -1176,18 +2439,21 @@ Experiment<Modus>::Experiment(Configuration &config,
    * - \b Dileptons  Special dilepton output, see
    *                 \ref doxypage_output_dileptons.
    *   - Available formats: \ref doxypage_output_oscar_collisions,
-   *                        \ref doxypage_output_binary and \ref
-   *                        doxypage_output_root
+   *                        \ref doxypage_output_binary, \ref
+   *                        doxypage_output_root and \ref
+   *                        doxypage_output_emission_histograms
    * - \b Photons   Special photon output, see
    *                \ref doxypage_output_photons.
    *   - Available formats: \ref doxypage_output_oscar_collisions,
-   *                        \ref doxypage_output_binary and \ref
-   *                        doxypage_output_root.
+   *                        \ref doxypage_output_binary, \ref
+   *                        doxypage_output_root and \ref
+   *                        doxypage_output_emission_histograms
    * - \b Thermodynamics   This output allows to print out thermodynamic
    *                       quantities, see \ref input_output_thermodynamics_.
    *    - Available formats: \ref doxypage_output_thermodyn,
    *                         \ref doxypage_output_thermodyn_lattice,
-   *                         \ref doxypage_output_vtk_lattice
+   *                         \ref doxypage_output_vtk_lattice,
+   *                         \ref doxypage_output_vtk_xml
    * - \b Initial_Conditions  Special initial conditions output, see
    *                          \ref doxypage_output_initial_conditions for
    *                          details.
@@ -1197,6 +2463,18 @@ Experiment<Modus>::Experiment(Configuration &config,
    *            results, see \ref doxypage_output_rivet for
    *            details.
    *    - Available formats: \ref doxypage_output_rivet
+   * - \b Analysis Evaluate spectra and flow of the final particles during the
+   *               run instead of writing particle lists, see
+   *               \ref input_output_analysis_.
+   *    - Available formats: \ref doxypage_output_analysis
+   * - \b Green_Kubo Accumulate the correlation functions of the stress tensor
+   *                 and of the charge currents for transport coefficients,
+   *                 see \ref input_output_green_kubo_.
+   *    - Available formats: \ref doxypage_output_green_kubo
+   * - \b Digest Condense every event into hashes of its final particles and
+   *              interactions to compare runs quickly, see
+   *              \ref input_output_digest_.
+   *    - Available formats: \ref doxypage_output_digest
    *
    *
    * \n
@@ -1216,6 +2494,11 @@ Experiment<Modus>::Experiment(Configuration &config,
    *   - Saves coordinates and momenta with the full double precision
    *   - General file structure is similar to \ref doxypage_output_oscar
    *   - Detailed description: \ref doxypage_output_binary
+   * - \b "Columnar" - binary output storing particle lists column by column
+   *   - Only for "Particles" content
+   *   - Analyses can read only the columns they need, optionally compressed
+   *     and in single precision
+   *   - Format description: \ref doxypage_output_columnar
    * - \b "Root" - binary output in the format used by ROOT software
    *     (http://root.cern.ch)
    *   - Even faster to read and write, requires less disk space
@@ -1225,11 +2508,23 @@ Experiment<Modus>::Experiment(Configuration &config,
    *   - This output can be opened by paraview to see the visulalization.
    *   - For "Particles" content \ref doxypage_output_vtk
    *   - For "Thermodynamics" content \ref doxypage_output_vtk_lattice
+   * - \b "VTK_XML" - compressed binary variant of the "VTK" output
+   *   - Smaller and faster to write, lattices can be cropped and downsampled
+   *   - Used for "Particles" and "Thermodynamics", see
+   *     \ref doxypage_output_vtk_xml
    * - \b "ASCII" - a human-readable text-format table of values
-   *   - Used for "Thermodynamics" and "Initial_Conditions", see
+   *   - Used for "Thermodynamics", "Initial_Conditions", "Analysis",
+   *     "Green_Kubo" and "Digest", see
    * \ref doxypage_output_thermodyn
    * \ref doxypage_output_thermodyn_lattice
    * \ref doxypage_output_initial_conditions
+   * \ref doxypage_output_analysis
+   * \ref doxypage_output_green_kubo
+   * \ref doxypage_output_digest
+   * - \b "Histograms" - spectra of the weighted emissions accumulated during
+   *   the run
+   *   - Only for "Dileptons" and "Photons" content, see
+   *     \ref doxypage_output_emission_histograms
    * - \b "HepMC_asciiv3", \b "HepMC_treeroot" - HepMC3 human-readble asciiv3 or
    *   Tree ROOT format see \ref doxypage_output_hepmc for details
    * - \b "YODA", \b "YODA-full" - compact ASCII text format used by the
@@ -1374,6 +2669,9 @@ Experiment<Modus>::Experiment(Configuration &config,
   dens_type_ = config.take({"Output", "Density_Type"}, DensityType::None);
   logg[LExperiment].debug()
       << "Density type printed to headers: " << dens_type_;
+  interaction_density_mode_ =
+      config.take({"Output", "Interaction_Density"},
+                  InputKeys::output_interactionDensity.default_value());
 
   /* Parse configuration about output contents and formats, doing all logical
    * checks about specified formats, creating all needed output objects. */
@@ -1397,6 +2695,36 @@ Experiment<Modus>::Experiment(Configuration &config,
     logg[LExperiment].warn() << "No \"Output\" section found in the input "
                                 "file. No output file will be produced.";
   }
+  // Not an output content, hence taken before listing the contents
+  const int binary_buffer_size =
+      output_conf.take({"Binary_Buffer_Size"}, 65536);
+  if (binary_buffer_size < 0) {
+    throw std::invalid_argument("Binary_Buffer_Size cannot be negative.");
+  }
+  const bool binary_event_index =
+      output_conf.take({"Binary_Event_Index"}, false);
+  overlap_output_times_ = output_conf.take(
+      {"Overlap_Output_Times"},
+      InputKeys::output_overlapOutputTimes.default_value());
+  RootOutputParameters root_parameters;
+  if (output_conf.has_value({"Root_Options"})) {
+    root_parameters.compression_algorithm =
+        output_conf.take({"Root_Options", "Compression_Algorithm"},
+                         root_parameters.compression_algorithm);
+    root_parameters.compression_level =
+        output_conf.take({"Root_Options", "Compression_Level"},
+                         root_parameters.compression_level);
+    root_parameters.basket_size = output_conf.take(
+        {"Root_Options", "Basket_Size"}, root_parameters.basket_size);
+    root_parameters.auto_flush = output_conf.take(
+        {"Root_Options", "Auto_Flush"}, root_parameters.auto_flush);
+    root_parameters.autosave_frequency =
+        output_conf.take({"Root_Options", "Autosave_Frequency"},
+                         root_parameters.autosave_frequency);
+    if (output_conf.has_value({"Root_Options"})) {
+      throw std::invalid_argument("Unknown key in the Root_Options section.");
+    }
+  }
   const std::vector<std::string> output_contents =
       output_conf.list_upmost_nodes();
   std::vector<std::vector<std::string>> list_of_formats(output_contents.size());
@@ -1409,12 +2737,40 @@ Experiment<Modus>::Experiment(Configuration &config,
         return output_conf.take({content.c_str(), "Format"},
                                 std::vector<std::string>{});
       });
-  const OutputParameters output_parameters(std::move(output_conf));
+  /* Outputs of particle lists and interactions can be written on writer
+   * threads of their own. */
+  const std::set<std::string> contents_allowing_asynchronous_output = {
+      "Particles", "Collisions", "Dileptons", "Photons", "Initial_Conditions",
+      "Rivet"};
+  std::vector<bool> asynchronous_outputs(output_contents.size(), false);
+  for (std::size_t i = 0; i < output_contents.size(); ++i) {
+    if (contents_allowing_asynchronous_output.count(output_contents[i])) {
+      asynchronous_outputs[i] = output_conf.take(
+          {output_contents[i].c_str(), "Asynchronous"}, false);
+    }
+  }
+  /* Outputs of particle lists and interactions of the ensembles can be
+   * written into one shard per ensemble. */
+  const std::set<std::string> contents_allowing_ensemble_shards = {
+      "Particles", "Collisions", "Initial_Conditions"};
+  std::vector<bool> sharded_outputs(output_contents.size(), false);
+  for (std::size_t i = 0; i < output_contents.size(); ++i) {
+    if (contents_allowing_ensemble_shards.count(output_contents[i])) {
+      sharded_outputs[i] = output_conf.take(
+          {output_contents[i].c_str(), "Ensemble_Shards"}, false);
+    }
+  }
+  OutputParameters output_parameters(std::move(output_conf));
+  output_parameters.binary_buffer_size = binary_buffer_size;
+  output_parameters.binary_event_index = binary_event_index;
+  output_parameters.root_parameters = root_parameters;
+  output_parameters.td_threads = density_param_.threads();
   std::size_t total_number_of_requested_formats = 0;
   auto abort_because_of_invalid_input_file = []() {
     throw std::invalid_argument("Invalid configuration input file.");
   };
   for (std::size_t i = 0; i < output_contents.size(); ++i) {
+    ScopedTimer timer(startup_profiler(), StartupStage::Outputs);
     if (list_of_formats[i].empty()) {
       logg[LExperiment].fatal()
           << "Empty or unspecified list of formats for "
@@ -1453,7 +2809,53 @@ Experiment<Modus>::Experiment(Configuration &config,
       list_of_formats[i].assign(tmp_set.begin(), tmp_set.end());
     }
     for (const auto &format : list_of_formats[i]) {
-      create_output(format, output_contents[i], output_path, output_parameters);
+      const int n_shards = sharded_outputs[i] ? parameters_.n_ensembles : 1;
+      std::vector<std::unique_ptr<OutputInterface>> shards;
+      for (int i_shard = 0; i_shard < n_shards; i_shard++) {
+        std::filesystem::path shard_path = output_path;
+        if (sharded_outputs[i]) {
+          shard_path /= "ensemble_" + std::to_string(i_shard);
+          std::filesystem::create_directories(shard_path);
+        }
+        const std::size_t n_outputs = outputs_.size();
+        create_output(format, output_contents[i], shard_path,
+                      output_parameters);
+        if (outputs_.size() == n_outputs) {
+          break;
+        }
+        if (output_contents[i] == "Particles" &&
+            output_parameters.part_filter.is_active()) {
+          outputs_.back() = std::make_unique<FilteredOutput>(
+              std::move(outputs_.back()), output_parameters.part_filter);
+        }
+        if (asynchronous_outputs[i]) {
+#ifdef SMASH_USE_ROOT
+          if (format == "Root") {
+            ROOT::EnableThreadSafety();
+          }
+#endif
+          /* Rivet only uses the particle lists and interactions, so the
+           * analysis of an event can overlap with the next one. */
+          const auto callbacks = output_contents[i] == "Rivet"
+                                     ? AsyncOutput::Callbacks::ParticleLists
+                                     : AsyncOutput::Callbacks::All;
+          outputs_.back() = std::make_unique<AsyncOutput>(
+              std::move(outputs_.back()), AsyncOutput::default_capacity,
+              callbacks);
+        }
+        if (sharded_outputs[i]) {
+          shards.push_back(std::move(outputs_.back()));
+          outputs_.pop_back();
+        }
+      }
+      if (!shards.empty()) {
+        outputs_.emplace_back(
+            std::make_unique<ShardedOutput>(std::move(shards)));
+      }
+      if (outputs_.size() > output_phases_.size()) {
+        output_phases_.push_back(
+            profiler_.add_phase("Output " + output_contents[i] + " " + format));
+      }
       ++total_number_of_requested_formats;
     }
   }
@@ -1462,6 +2864,7 @@ Experiment<Modus>::Experiment(Configuration &config,
         << "At least one invalid output format has been provided.";
     abort_because_of_invalid_input_file();
   }
+  update_subscriptions();
 
   /* We can take away the Fermi motion flag, because the collider modus is
    * already initialized. We only need it when potentials are enabled, but we
@@ -1469,6 +2872,7 @@ Experiment<Modus>::Experiment(Configuration &config,
    * options. We have to provide a default value for modi other than Collider.
    */
   if (config.has_value({"Potentials"})) {
+    ScopedTimer timer(startup_profiler(), StartupStage::Potentials);
     if (time_step_mode_ == TimeStepMode::None) {
       logg[LExperiment].error() << "Potentials only work with time steps!";
       throw std::invalid_argument("Can't use potentials without time steps!");
@@ -1613,6 +3017,7 @@ Experiment<Modus>::Experiment(Configuration &config,
 
   // Create lattices
   if (config.has_value({"Lattice"})) {
+    ScopedTimer timer(startup_profiler(), StartupStage::Lattices);
     bool automatic = config.take({"Lattice", "Automatic"}, false);
     bool all_geometrical_properties_specified =
         config.has_value({"Lattice", "Cell_Number"}) &&
@@ -1704,6 +3109,45 @@ Experiment<Modus>::Experiment(Configuration &config,
       printout_v_landau_ = output_parameters.td_v_landau;
       printout_j_QBS_ = output_parameters.td_jQBS;
     }
+    potentials_update_interval_ =
+        config.take({"Lattice", "Potentials_Update_Interval"}, 1);
+    if (potentials_update_interval_ < 1) {
+      throw std::invalid_argument(
+          "The update interval of the potentials on the lattice has to be at "
+          "least 1 time step.");
+    }
+    lattice_adaptive_interval_ =
+        config.take({"Lattice", "Adaptive_Interval"}, 0.);
+    if (lattice_adaptive_interval_ < 0.) {
+      throw std::invalid_argument(
+          "The lattice adaptive interval has to be positive, or 0 to keep the "
+          "lattice fixed.");
+    }
+    if (lattice_adaptive_interval_ > 0.) {
+      if (periodic) {
+        throw std::invalid_argument(
+            "A periodic lattice cannot follow the particles. Set "
+            "\"Adaptive_Interval: 0\" or \"Periodic: False\".");
+      }
+      if (printout_lattice_td_ || printout_full_lattice_any_td_) {
+        throw std::invalid_argument(
+            "The thermodynamic lattice output needs a fixed lattice. Set "
+            "\"Adaptive_Interval: 0\" in the Lattice section.");
+      }
+      lattice_min_cells_ = n;
+      /* Until the next adaptation, particles move at most by the interval,
+       * and they contribute to nodes within the range of the smearing. */
+      const double cell = std::max({l[0] / n[0], l[1] / n[1], l[2] / n[2]});
+      double reach = cell;
+      if (parameters_.smearing_mode == SmearingMode::CovariantGaussian) {
+        reach = density_param_.r_cut();
+      } else if (parameters_.smearing_mode == SmearingMode::Triangular) {
+        reach = parameters_.triangular_range * cell;
+      }
+      lattice_margin_ = lattice_adaptive_interval_ + reach + cell;
+      logg[LExperiment].info() << "Lattice follows the particles every "
+                               << lattice_adaptive_interval_ << " fm.";
+    }
     if (printout_tmn_ || printout_tmn_landau_ || printout_v_landau_) {
       Tmn_ = std::make_unique<RectangularLattice<EnergyMomentumTensor>>(
           l, n, origin, periodic, LatticeUpdate::AtOutput);
@@ -1719,11 +3163,6 @@ Experiment<Modus>::Experiment(Configuration &config,
       // Create auxiliary lattices for baryon four-current calculation
       old_jmu_auxiliary_ = std::make_unique<RectangularLattice<FourVector>>(
           l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-      new_jmu_auxiliary_ = std::make_unique<RectangularLattice<FourVector>>(
-          l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-      four_gradient_auxiliary_ =
-          std::make_unique<RectangularLattice<std::array<FourVector, 4>>>(
-              l, n, origin, periodic, LatticeUpdate::EveryTimestep);
 
       if (potentials_->use_skyrme()) {
         jmu_B_lat_ = std::make_unique<DensityLattice>(
@@ -1749,6 +3188,11 @@ Experiment<Modus>::Experiment(Configuration &config,
         EM_lat_ = std::make_unique<
             RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+        if (potentials_->coulomb_use_fft()) {
+          coulomb_solver_ = std::make_unique<CoulombFieldSolver>(
+              n, jmu_el_lat_->cell_sizes(), periodic,
+              potentials_->coulomb_r_cut(), density_param_.threads());
+        }
       }
       if (potentials_->use_vdf()) {
         jmu_B_lat_ = std::make_unique<DensityLattice>(
@@ -1759,6 +3203,15 @@ Experiment<Modus>::Experiment(Configuration &config,
             RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
       }
+      /* The densities of the potentials are updated in every time step. Only
+       * the part of the lattice reached by the particles is reset and
+       * processed then. */
+      for (DensityLattice *lat :
+           {jmu_B_lat_.get(), jmu_I3_lat_.get(), jmu_el_lat_.get()}) {
+        if (lat) {
+          lat->track_occupation();
+        }
+      }
       if (parameters_.field_derivatives_mode == FieldDerivativesMode::Direct) {
         // Create auxiliary lattices for field calculation
         old_fields_auxiliary_ =
@@ -1791,10 +3244,21 @@ Experiment<Modus>::Experiment(Configuration &config,
       jmu_custom_lat_ = std::make_unique<DensityLattice>(
           l, n, origin, periodic, LatticeUpdate::AtOutput);
     }
+    if (interaction_density_mode_ == InteractionDensityMode::Lattice &&
+        dens_type_ != DensityType::None) {
+      jmu_interaction_lat_ = std::make_unique<DensityLattice>(
+          l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+      jmu_interaction_lat_->track_occupation();
+    }
   } else if (printout_lattice_td_ || printout_full_lattice_any_td_) {
     logg[LExperiment].error(
         "If you want Therm. VTK or Lattice output, configure a lattice for "
         "it.");
+  } else if (interaction_density_mode_ == InteractionDensityMode::Lattice &&
+             dens_type_ != DensityType::None) {
+    throw std::invalid_argument(
+        "\"Interaction_Density: Lattice\" requires a lattice. Please add one "
+        "to the configuration.");
   } else if (potentials_ && potentials_->use_coulomb()) {
     logg[LExperiment].error(
         "Coulomb potential requires a lattice. Please add one to the "
@@ -1807,13 +3271,6 @@ Experiment<Modus>::Experiment(Configuration &config,
                              << "not going to be calculated.";
   }
 
-  // Store pointers to potential and lattice accessible for Action
-  if (parameters_.potential_affect_threshold) {
-    UB_lat_pointer = UB_lat_.get();
-    UI3_lat_pointer = UI3_lat_.get();
-    pot_pointer = potentials_.get();
-  }
-
   // Throw fatal if DerivativesMode == FiniteDifference and lattice is not on.
   if ((parameters_.derivatives_mode == DerivativesMode::FiniteDifference) &&
       (jmu_B_lat_ == nullptr)) {
@@ -1823,16 +3280,111 @@ Experiment<Modus>::Experiment(Configuration &config,
 
   // Create forced thermalizer
   if (config.has_value({"Forced_Thermalization"})) {
+    ScopedTimer timer(startup_profiler(), StartupStage::Thermalizer);
     Configuration th_conf =
         config.extract_sub_configuration({"Forced_Thermalization"});
     thermalizer_ = modus_.create_grandcan_thermalizer(th_conf);
   }
 
+  if (modus_.freeze_out_rate() > 0.) {
+    if (!force_decays_ || potentials_ || thermalizer_ ||
+        metric_.mode_ != ExpansionMode::NoExpansion || IC_output_switch_) {
+      throw std::invalid_argument(
+          "The freeze-out detection requires Force_Decays_At_End and cannot "
+          "be used with potentials, forced thermalization, an expanding "
+          "metric or the initial conditions output.");
+    }
+    logg[LExperiment].info("Stopping the time steps once the scattering rate "
+                           "per particle falls below ",
+                           modus_.freeze_out_rate(), " / fm.");
+  }
+
+  if (config.take({"General", "Profiling"}, false)) {
+    profiler_.set_enabled(true);
+    profile_path_ = output_path / "Profile.json";
+    logg[LExperiment].info("Profiling the evolution, see ", profile_path_);
+  }
+  const int action_cost_sampling =
+      config.take({"General", "Action_Cost_Sampling"}, 0);
+  if (action_cost_sampling < 0) {
+    throw std::invalid_argument("Action_Cost_Sampling must not be negative.");
+  }
+  action_cost_sampling_ = action_cost_sampling;
+  if (action_cost_sampling_ > 0) {
+    logg[LExperiment].info("Measuring the cost of every ",
+                           action_cost_sampling_, ". action.");
+  }
+  if (config.take({"General", "Trace"}, false)) {
+    profiler_.set_enabled(true);
+    profiler_.set_tracing(true);
+    trace_path_ = output_path / "Trace.json";
+    logg[LExperiment].info("Tracing the evolution, see ", trace_path_);
+  }
+  checkpoint_interval_ = config.take({"General", "Checkpoint_Interval"}, 0.);
+  if (checkpoint_interval_ < 0.) {
+    throw std::invalid_argument("Checkpoint_Interval must not be negative.");
+  }
+  if (config.has_value({"General", "Resume_From_Checkpoint"})) {
+    const std::string resume_path =
+        config.take({"General", "Resume_From_Checkpoint"});
+    resume_path_ = resume_path;
+  }
+  if (checkpoint_interval_ > 0. || !resume_path_.empty()) {
+    /* The initial state of other modi is not (only) determined by the
+     * particles, e.g. the beam momenta of frozen Fermi motion. */
+    if (!modus_.is_box() && !modus_.is_sphere()) {
+      throw std::invalid_argument(
+          "Checkpoints are only possible in the box and sphere modi.");
+    }
+  }
+  oversampling_ = config.take({"General", "Oversampling"},
+                              InputKeys::gen_oversampling.default_value());
+  if (oversampling_ < 1) {
+    throw std::invalid_argument("Oversampling must be at least 1.");
+  }
+  if (oversampling_ > 1) {
+    if (modus_.prefetch_depth() > 0) {
+      throw std::invalid_argument(
+          "Oversampling cannot be combined with prefetched initial states.");
+    }
+    logg[LExperiment].info("Evolving groups of ", oversampling_,
+                           " events from the same initial state.");
+  }
+  if (checkpoint_interval_ > 0.) {
+    checkpoint_path_ = output_path / "Checkpoint.bin";
+    logg[LExperiment].info("Writing a checkpoint every ", checkpoint_interval_,
+                           " fm to ", checkpoint_path_);
+  }
+
+  /* Concurrent ensembles must not share any state while they evolve. This is
+   * not (yet) the case for the outputs written while shining dileptons and
+   * producing photons, and Pauli blocking, which takes into account the
+   * particles of all ensembles. Strings are fragmented by one set of Pythia
+   * objects per thread. */
+  if (ensemble_threads_ > 1) {
+    if (dilepton_finder_ != nullptr || photons_switch_ ||
+        bremsstrahlung_switch_ || pauli_blocker_) {
+      throw std::invalid_argument(
+          "Evolving ensembles on more than one thread is not possible with "
+          "dileptons, photons or Pauli blocking.\nPlease use "
+          "Ensemble_Threads: 1 for this setup.");
+    }
+    initialize_lazy_caches();
+  }
+
   /* Take the seed setting only after the configuration was stored to a file
    * in smash.cc */
   seed_ = config.take({"General", "Randomseed"});
 }
 
+template <typename Modus>
+Experiment<Modus>::~Experiment() {
+  // An error while writing is lost, if the experiment is destroyed early.
+  if (output_time_writer_.joinable()) {
+    output_time_writer_.join();
+  }
+}
+
 /// String representing a horizontal line.
 const std::string hline(113, '-');
 
@@ -1840,13 +3392,13 @@ const std::string hline(113, '-');
  * Generate a string which will be printed to the screen when SMASH is running
  *
  * \param[in] ensembles The simulated particles: one Particles object per
- *            ensemble. The information about particles is used to check the
- *            conservation of the total energy and momentum as well as print
- *            other useful information.
+ *            ensemble, whose number is printed.
  * \param[in] scatterings_this_interval Number of the scatterings occur within
  *            the current timestep.
  * \param[in] conserved_initial Initial quantum numbers needed to check the
  *            conservations.
+ * \param[in] conserved_current Current quantum numbers, whose energy is
+ *            printed and compared to the initial one.
  * \param[in] time_start Moment in the REAL WORLD when SMASH starts to run [s].
  * \param[in] time Current moment in SMASH [fm].
  * \param[in] E_mean_field Value of the mean-field contribution to the total
@@ -1863,6 +3415,7 @@ const std::string hline(113, '-');
 std::string format_measurements(const std::vector<Particles> &ensembles,
                                 uint64_t scatterings_this_interval,
                                 const QuantumNumbers &conserved_initial,
+                                const QuantumNumbers &conserved_current,
                                 SystemTimePoint time_start, double time,
                                 double E_mean_field,
                                 double E_mean_field_initial);
@@ -1907,20 +3460,93 @@ EventInfo fill_event_info(const std::vector<Particles> &ensembles,
                           bool projectile_target_interact,
                           bool kinematic_cut_for_SMASH_IC);
 
+/**
+ * Generate the EventInfo object at a given time instead of the current time
+ * of the output clock, e.g. for a copy of the particles taken at an output
+ * time.
+ *
+ * \see fill_event_info
+ * \param[in] current_time Time of the particles [fm]
+ */
+EventInfo fill_event_info(const std::vector<Particles> &ensembles,
+                          double E_mean_field, double modus_impact_parameter,
+                          const ExperimentParameters &parameters,
+                          double current_time, bool projectile_target_interact,
+                          bool kinematic_cut_for_SMASH_IC);
+
+/**
+ * The random seed of an event, which only depends on the seed of the run and
+ * the number of the event. Any event can thus be simulated without the ones
+ * before it, and the events do not depend on how they are distributed over
+ * threads or processes. The first event uses the seed of the run. The seeds
+ * are not negative, so the seed of an event can be entered as `Randomseed` in
+ * the config to simulate that event as the first one of a run.
+ *
+ * \param[in] run_seed Seed of the run, the `Randomseed` of the config
+ * \param[in] event Number of the event
+ * \return Seed of the event
+ */
+inline int64_t seed_of_event(int64_t run_seed, int event) {
+  if (event == 0) {
+    return run_seed;
+  }
+  return static_cast<int64_t>(random::stream_seed(run_seed, event) >> 1);
+}
+
+template <typename Modus>
+void Experiment<Modus>::reconfigure(Configuration &changes) {
+  // Check everything before changing anything.
+  Configuration unchangeable(changes.to_string().c_str(),
+                             Configuration::InitializeFromYAMLString);
+  if (modus_.is_collider()) {
+    unchangeable.take({"Modi", "Collider", "Sqrtsnn"}, 0.);
+    if (unchangeable.has_value({"Modi", "Collider", "Impact"})) {
+      unchangeable.extract_sub_configuration({"Modi", "Collider", "Impact"})
+          .clear();
+    }
+  }
+  if (!unchangeable.is_empty()) {
+    const std::string keys = unchangeable.to_string();
+    unchangeable.clear();
+    throw std::invalid_argument(
+        "Only the collision energy and the impact parameter of a collider can "
+        "be changed between events, set up a new experiment instead for:\n" +
+        keys);
+  }
+  if (changes.has_value({"Modi", "Collider", "Sqrtsnn"})) {
+    const double sqrt_s_NN = changes.read({"Modi", "Collider", "Sqrtsnn"});
+    if ((sqrt_s_NN >= 200.) != (modus_.sqrt_s_NN() >= 200.)) {
+      throw std::invalid_argument(
+          "The default string parameters differ above and below sqrt(s_NN) = "
+          "200 GeV, set up a new experiment instead to cross it.");
+    }
+  }
+
+  Configuration modus_changes =
+      changes.extract_sub_configuration({"Modi"}, Configuration::GetEmpty::Yes);
+  modus_.reconfigure(modus_changes);
+}
+
 template <typename Modus>
 void Experiment<Modus>::initialize_new_event() {
-  random::set_seed(seed_);
-  logg[LExperiment].info() << "random number seed: " << seed_;
-  /* Set seed for the next event. It has to be positive, so it can be entered
-   * in the config.
-   *
-   * We have to be careful about the minimal integer, whose absolute value
-   * cannot be represented. */
-  int64_t r = random::advance();
-  while (r == INT64_MIN) {
-    r = random::advance();
-  }
-  seed_ = std::abs(r);
+  const auto use_experiment = use_on_this_thread();
+  const int64_t event_seed = seed_of_event(seed_, event_);
+  random::set_seed(event_seed);
+  logg[LExperiment].info() << "random number seed: " << event_seed;
+  /* With concurrent ensembles each ensemble uses its own random numbers, which
+   * are determined by the seed of the event and the index of the ensemble.
+   * This makes the results independent of how the ensembles are scheduled on
+   * the threads. */
+  if (ensemble_threads_ > 1) {
+    const uint64_t ensembles_seed = random::advance();
+    ensemble_engines_.clear();
+    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+      ensemble_engines_.push_back(random::make_stream(ensembles_seed, i_ens));
+    }
+  }
+  /* The initial conditions are sampled on this thread, so the particles are
+   * moved to the nodes of the ensemble threads again. */
+  std::fill(ensemble_relocated_.begin(), ensemble_relocated_.end(), 0);
   /* Set the random seed used in PYTHIA hadronization
    * to be same with the SMASH one.
    * In this way we ensure that the results are reproducible
@@ -1936,27 +3562,80 @@ void Experiment<Modus>::initialize_new_event() {
   // Sample particles according to the initial conditions
   double start_time = -1.0;
 
-  // Sample impact parameter only once per all ensembles
-  // It should be the same for all ensembles
-  if (modus_.is_collider()) {
-    modus_.sample_impact();
-    logg[LExperiment].info("Impact parameter = ", modus_.impact_parameter(),
-                           " fm");
-  }
-  for (Particles &particles : ensembles_) {
-    start_time = modus_.initial_conditions(&particles, parameters_);
-  }
-  /* For box modus make sure that particles are in the box. In principle, after
-   * a correct initialization they should be, so this is just playing it safe.
-   */
-  for (Particles &particles : ensembles_) {
-    modus_.impose_boundary_conditions(&particles, outputs_);
+  /* With oversampling, the initial state of a group of events is sampled with
+   * the random numbers of the first event of the group, so that it does not
+   * depend on which events of the group were run before by this experiment. */
+  const int initial_state_event = event_ - event_ % oversampling_;
+  if (oversampling_ > 1 && initial_state_event == initial_state_event_) {
+    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+      ensembles_[i_ens].copy_from(*initial_ensembles_[i_ens]);
+    }
+    start_time = initial_start_time_;
+    logg[LExperiment].info("Initial state of event ", initial_state_event,
+                           " reused");
+  } else {
+    std::optional<random::Engine> evolution_engine;
+    if (oversampling_ > 1) {
+      evolution_engine = random::engine;
+      random::set_seed(seed_of_event(seed_, initial_state_event));
+    }
+    if (modus_.prefetch_depth() > 0) {
+      /* The initial state was generated ahead of time from a random number
+       * stream of the event, so the seeds of the events run after this one
+       * are needed to continue. */
+      const int64_t run_seed = seed_;
+      auto event_seed_of = [run_seed](int event) {
+        return seed_of_event(run_seed, event);
+      };
+      start_time = modus_.take_prefetched_initial_state(
+          event_, event_stride_, event_seed_of, &ensembles_);
+      if (modus_.is_collider()) {
+        logg[LExperiment].info("Impact parameter = ",
+                               modus_.impact_parameter(), " fm");
+      }
+    } else {
+      // Sample impact parameter only once per all ensembles
+      // It should be the same for all ensembles
+      if (modus_.is_collider()) {
+        modus_.sample_impact();
+        logg[LExperiment].info("Impact parameter = ",
+                               modus_.impact_parameter(), " fm");
+      }
+      for (Particles &particles : ensembles_) {
+        start_time = modus_.initial_conditions(&particles, parameters_);
+      }
+    }
+    /* For box modus make sure that particles are in the box. In principle,
+     * after a correct initialization they should be, so this is just playing
+     * it safe. */
+    for (Particles &particles : ensembles_) {
+      modus_.impose_boundary_conditions(&particles, outputs_);
+    }
+    // The initial testparticles are dealt out to the subensembles.
+    if (parameters_.n_subensembles > 1) {
+      for (Particles &particles : ensembles_) {
+        int i = 0;
+        for (ParticleData &data : particles) {
+          data.set_subensemble(i++ % parameters_.n_subensembles);
+        }
+      }
+    }
+    if (oversampling_ > 1) {
+      initial_ensembles_.clear();
+      for (const Particles &particles : ensembles_) {
+        initial_ensembles_.push_back(particles.clone());
+      }
+      initial_state_event_ = initial_state_event;
+      initial_start_time_ = start_time;
+      random::engine = *evolution_engine;
+    }
   }
   // Reset the simulation clock
   double timestep = delta_time_startup_;
 
   switch (time_step_mode_) {
     case TimeStepMode::Fixed:
+    case TimeStepMode::Adaptive:
       break;
     case TimeStepMode::None:
       timestep = end_time_ - start_time;
@@ -1978,6 +3657,8 @@ void Experiment<Modus>::initialize_new_event() {
       std::make_unique<UniformClock>(start_time, timestep, end_time_);
   parameters_.labclock = std::move(clock_for_this_event);
 
+  next_checkpoint_time_ = start_time + checkpoint_interval_;
+
   // Reset the output clock
   parameters_.outputclock->reset(start_time, true);
   // remove time before starting time in case of custom output times.
@@ -1990,22 +3671,41 @@ void Experiment<Modus>::initialize_new_event() {
   /* Save the initial conserved quantum numbers and total momentum in
    * the system for conservation checks */
   conserved_initial_ = QuantumNumbers(ensembles_);
+  conserved_current_ = conserved_initial_;
   wall_actions_total_ = 0;
   previous_wall_actions_total_ = 0;
   interactions_total_ = 0;
   previous_interactions_total_ = 0;
+  scatterings_total_ = 0;
+  frozen_out_ = false;
+  if (exclude_spectators_) {
+    spectators_.resize(parameters_.n_ensembles);
+    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+      spectators_[i_ens].reset(ensembles_[i_ens]);
+    }
+  }
   discarded_interactions_total_ = 0;
   total_pauli_blocked_ = 0;
+  timesteps_since_potentials_update_ = 0;
+  ensemble_counters_.assign(parameters_.n_ensembles, EnsembleCounters{});
+  ensemble_interactions_total_.assign(parameters_.n_ensembles, 0);
   projectile_target_interact_.assign(parameters_.n_ensembles, false);
   total_hypersurface_crossing_actions_ = 0;
   total_energy_removed_ = 0.0;
   total_energy_violated_by_Pythia_ = 0.0;
+  interaction_statistics_ = InteractionStatistics{};
+  interval_interaction_statistics_ = InteractionStatistics{};
+  memory_budget_exceeded_ = false;
+  if (scatter_finder_) {
+    scatter_finder_->take_search_counters();
+  }
   // Print output headers
   logg[LExperiment].info() << hline;
   logg[LExperiment].info() << "Time[fm]   Ekin[GeV]   E_MF[GeV]  ETotal[GeV]  "
                            << "ETot/N[GeV]  D(ETot/N)[GeV] Scatt&Decays  "
                            << "Particles     Comp.Time";
   logg[LExperiment].info() << hline;
+  follow_particles_with_lattices(true);
   double E_mean_field = 0.0;
   if (potentials_) {
     // update_potentials();
@@ -2013,7 +3713,6 @@ void Experiment<Modus>::initialize_new_event() {
     // using the lattice is necessary
     if ((jmu_B_lat_ != nullptr)) {
       update_lattice(jmu_B_lat_.get(), old_jmu_auxiliary_.get(),
-                     new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
                      LatticeUpdate::EveryTimestep, DensityType::Baryon,
                      density_param_, ensembles_,
                      parameters_.labclock->timestep_duration(), true);
@@ -2030,12 +3729,37 @@ void Experiment<Modus>::initialize_new_event() {
   }
   initial_mean_field_energy_ = E_mean_field;
   logg[LExperiment].info() << format_measurements(
-      ensembles_, 0u, conserved_initial_, time_start_,
-      parameters_.labclock->current_time(), E_mean_field,
+      ensembles_, 0u, conserved_initial_, current_conserved_quantities(),
+      time_start_, parameters_.labclock->current_time(), E_mean_field,
       initial_mean_field_energy_);
 
-  // Output at event start
+  output_at_event_start(E_mean_field);
+
+  /* In the ColliderModus, if Fermi motion is frozen, assign the beam momenta
+   * to the nucleons in both the projectile and the target. Every ensemble
+   * gets the same beam momenta, so no need to create beam_momenta_ vector
+   * for every ensemble.
+   */
+  if (modus_.is_collider() && modus_.fermi_motion() == FermiMotion::Frozen) {
+    for (ParticleData &particle : ensembles_[0]) {
+      const double m = particle.effective_mass();
+      double v_beam = 0.0;
+      if (particle.belongs_to() == BelongsTo::Projectile) {
+        v_beam = modus_.velocity_projectile();
+      } else if (particle.belongs_to() == BelongsTo::Target) {
+        v_beam = modus_.velocity_target();
+      }
+      const double gamma = 1.0 / std::sqrt(1.0 - v_beam * v_beam);
+      beam_momentum_.emplace_back(
+          FourVector(gamma * m, 0.0, 0.0, gamma * v_beam * m));
+    }  // loop over particles
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::output_at_event_start(double E_mean_field) {
   for (const auto &output : outputs_) {
+    ScopedTimer timer(profiler_, output_phase(output));
     for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
       auto event_info = fill_event_info(
           ensembles_, E_mean_field, modus_.impact_parameter(), parameters_,
@@ -2085,48 +3809,171 @@ void Experiment<Modus>::initialize_new_event() {
       }
     }
   }
+}
 
-  /* In the ColliderModus, if Fermi motion is frozen, assign the beam momenta
-   * to the nucleons in both the projectile and the target. Every ensemble
-   * gets the same beam momenta, so no need to create beam_momenta_ vector
-   * for every ensemble.
-   */
-  if (modus_.is_collider() && modus_.fermi_motion() == FermiMotion::Frozen) {
-    for (ParticleData &particle : ensembles_[0]) {
-      const double m = particle.effective_mass();
-      double v_beam = 0.0;
-      if (particle.belongs_to() == BelongsTo::Projectile) {
-        v_beam = modus_.velocity_projectile();
-      } else if (particle.belongs_to() == BelongsTo::Target) {
-        v_beam = modus_.velocity_target();
+template <typename Modus>
+void Experiment<Modus>::write_checkpoint() {
+  const double now = parameters_.labclock->current_time();
+  while (next_checkpoint_time_ <= now) {
+    next_checkpoint_time_ += checkpoint_interval_;
+  }
+  std::filesystem::path tmp_path = checkpoint_path_;
+  tmp_path += ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary);
+    checkpoint::write_header(out);
+    checkpoint::write(out, checkpoint_setup());
+    checkpoint::write(out, event_);
+    checkpoint::write(out, seed_);
+    checkpoint::write(out, random::engine);
+    checkpoint::write(out, static_cast<uint64_t>(ensemble_engines_.size()));
+    for (const random::Engine &engine : ensemble_engines_) {
+      checkpoint::write(out, engine);
+    }
+    parameters_.labclock->write_checkpoint(out);
+    parameters_.outputclock->write_checkpoint(out);
+    for (const Particles &particles : ensembles_) {
+      particles.write_checkpoint(out);
+    }
+    for_each_lattice([&out](const auto &lattice) {
+      checkpoint::write(out, lattice != nullptr);
+      if (lattice) {
+        lattice->write_checkpoint(out);
       }
-      const double gamma = 1.0 / std::sqrt(1.0 - v_beam * v_beam);
-      beam_momentum_.emplace_back(
-          FourVector(gamma * m, 0.0, 0.0, gamma * v_beam * m));
-    }  // loop over particles
+    });
+    for_each_checkpointed_quantity(
+        [&out](const auto &quantity) { checkpoint::write(out, quantity); });
+    if (!out) {
+      throw std::runtime_error("Checkpoint " + tmp_path.string() +
+                               " could not be written.");
+    }
+  }
+  // A job killed while writing leaves the previous checkpoint intact
+  std::filesystem::rename(tmp_path, checkpoint_path_);
+  logg[LExperiment].info("Checkpoint at ", now, " fm written to ",
+                         checkpoint_path_);
+  if (process_string_ptr_ != NULL) {
+    process_string_ptr_->init_pythia_hadron_rndm();
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::resume_event() {
+  std::ifstream in(resume_path_, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Checkpoint " + resume_path_.string() +
+                             " cannot be opened.");
+  }
+  checkpoint::read_header(in);
+  std::array<int64_t, 6> setup;
+  checkpoint::read(in, setup);
+  if (setup != checkpoint_setup()) {
+    throw std::runtime_error(
+        "The checkpoint was written with a different modus, number of "
+        "ensembles, testparticles or testparticle subensembles, "
+        "Ensemble_Threads or particle types.");
+  }
+  checkpoint::read(in, event_);
+  checkpoint::read(in, seed_);
+  checkpoint::read(in, random::engine);
+  uint64_t n_engines = 0;
+  checkpoint::read(in, n_engines);
+  ensemble_engines_.resize(n_engines);
+  for (random::Engine &engine : ensemble_engines_) {
+    checkpoint::read(in, engine);
+  }
+  parameters_.labclock->read_checkpoint(in);
+  parameters_.outputclock->read_checkpoint(in);
+  for (Particles &particles : ensembles_) {
+    particles.read_checkpoint(in);
+  }
+  for_each_lattice([&in](auto &lattice) {
+    bool present = false;
+    checkpoint::read(in, present);
+    if (present != (lattice != nullptr)) {
+      throw std::runtime_error(
+          "The checkpoint was written with different lattices.");
+    }
+    if (lattice) {
+      lattice->read_checkpoint(in);
+    }
+  });
+  for_each_checkpointed_quantity(
+      [&in](auto &quantity) { checkpoint::read(in, quantity); });
+  conserved_current_ = QuantumNumbers(ensembles_);
+  logg[LExperiment].info("Resuming event ", event_, " at ",
+                         parameters_.labclock->current_time(), " fm from ",
+                         resume_path_);
+  if (process_string_ptr_ != NULL) {
+    process_string_ptr_->init_pythia_hadron_rndm();
+  }
+
+  // The bookkeeping of the time step, which starts anew
+  ensemble_counters_.assign(parameters_.n_ensembles, EnsembleCounters{});
+  memory_budget_exceeded_ = false;
+  if (scatter_finder_) {
+    scatter_finder_->take_search_counters();
+  }
+  logg[LExperiment].info() << hline;
+  logg[LExperiment].info() << "Time[fm]   Ekin[GeV]   E_MF[GeV]  ETotal[GeV]  "
+                           << "ETot/N[GeV]  D(ETot/N)[GeV] Scatt&Decays  "
+                           << "Particles     Comp.Time";
+  logg[LExperiment].info() << hline;
+  double E_mean_field = 0.0;
+  if (potentials_ && jmu_B_lat_) {
+    E_mean_field = calculate_mean_field_energy(*potentials_, *jmu_B_lat_,
+                                               EM_lat_.get(), parameters_);
   }
+  logg[LExperiment].info() << format_measurements(
+      ensembles_, 0u, conserved_initial_, current_conserved_quantities(),
+      time_start_, parameters_.labclock->current_time(), E_mean_field,
+      initial_mean_field_energy_);
+  output_at_event_start(E_mean_field);
 }
 
 template <typename Modus>
 bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
-                                       bool include_pauli_blocking) {
+                                       bool include_pauli_blocking,
+                                       double *deferred_output_density,
+                                       bool final_state_generated) {
   Particles &particles = ensembles_[i_ensemble];
+  EnsembleCounters &counters = ensemble_counters_[i_ensemble];
   // Make sure to skip invalid and Pauli-blocked actions.
   if (!action.is_valid(particles)) {
-    discarded_interactions_total_++;
+    counters.discarded_interactions++;
     logg[LExperiment].debug(~einhard::DRed(), "✘ ", action,
                             " (discarded: invalid)");
     return false;
   }
-  try {
-    action.generate_final_state();
-  } catch (Action::StochasticBelowEnergyThreshold &) {
-    return false;
+  ScopedTimer timer(profiler_, ProfiledPhase::ActionExecution);
+  // The cost of generating the final state and performing is sampled
+  const bool sample_cost =
+      action_cost_sampling_ > 0 &&
+      (interactions_total_ + counters.interactions) % action_cost_sampling_ ==
+          0;
+  std::chrono::steady_clock::time_point cost_start;
+  if (sample_cost) {
+    cost_start = std::chrono::steady_clock::now();
+  }
+  if (!final_state_generated) {
+    try {
+      action.generate_final_state();
+    } catch (Action::StochasticBelowEnergyThreshold &) {
+      return false;
+    }
+  }
+  std::chrono::steady_clock::duration cost{0};
+  if (sample_cost) {
+    cost = std::chrono::steady_clock::now() - cost_start;
   }
   logg[LExperiment].debug("Process Type is: ", action.get_type());
+  if (is_string_soft_process(action.get_type()) ||
+      action.get_type() == ProcessType::StringHard) {
+    timer.set_phase(ProfiledPhase::StringFragmentation);
+  }
   if (include_pauli_blocking && pauli_blocker_ &&
       action.is_pauli_blocked(ensembles_, *pauli_blocker_)) {
-    total_pauli_blocked_++;
+    counters.pauli_blocked++;
     return false;
   }
 
@@ -2147,30 +3994,75 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
   }
 
   /* Make sure to pick a non-zero integer, because 0 is reserved for "no
-   * interaction yet". */
-  const auto id_process = static_cast<uint32_t>(interactions_total_ + 1);
+   * interaction yet". Concurrent ensembles number their processes in
+   * disjoint residue classes modulo the number of ensembles, such that the
+   * ids are unique within the event and do not depend on the scheduling. */
+  const uint64_t process_number =
+      ensemble_threads_ > 1
+          ? ensemble_interactions_total_[i_ensemble] * parameters_.n_ensembles +
+                i_ensemble + 1
+          : interactions_total_ + counters.interactions + 1;
+  if (process_number > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Integer overflow in process id!");
+  }
+  const auto id_process = static_cast<uint32_t>(process_number);
   // we perform the action and collect possible energy violations by Pythia
-  total_energy_violated_by_Pythia_ += action.perform(&particles, id_process);
+  if (sample_cost) {
+    cost_start = std::chrono::steady_clock::now();
+  }
+  counters.energy_violated_by_Pythia += action.perform(&particles, id_process);
+  for (const ParticleData &p : action.outgoing_particles()) {
+    counters.conserved_change.add_values(p);
+  }
+  for (const ParticleData &p : action.incoming_particles()) {
+    counters.conserved_change.subtract_values(p);
+  }
+  if (action_cost_sampling_ > 0) {
+    ActionCost &type_cost = counters.action_costs[action.get_type()];
+    type_cost.performed++;
+    if (sample_cost) {
+      cost += std::chrono::steady_clock::now() - cost_start;
+      type_cost.samples++;
+      type_cost.seconds += std::chrono::duration<double>(cost).count();
+    }
+  }
+  if (pauli_blocker_) {
+    pauli_blocker_->update_index(i_ensemble, action.incoming_particles(),
+                                 action.outgoing_particles());
+  }
 
-  interactions_total_++;
+  counters.interactions++;
+  ensemble_interactions_total_[i_ensemble]++;
   if (action.get_type() == ProcessType::Wall) {
-    wall_actions_total_++;
+    counters.wall_actions++;
+  }
+  if (action.incoming_particles().size() > 1 &&
+      action.get_type() != ProcessType::Freeforall &&
+      action.get_type() != ProcessType::Thermalization) {
+    counters.scatterings++;
   }
   if (action.get_type() == ProcessType::HyperSurfaceCrossing) {
-    total_hypersurface_crossing_actions_++;
-    total_energy_removed_ += action.incoming_particles()[0].momentum().x0();
+    counters.hypersurface_crossing_actions++;
+    counters.energy_removed += action.incoming_particles()[0].momentum().x0();
   }
   // Calculate Eckart rest frame density at the interaction point
   double rho = 0.0;
-  if (dens_type_ != DensityType::None) {
+  if (dens_type_ != DensityType::None && interaction_density_needed_) {
     const FourVector r_interaction = action.get_interaction_point();
-    constexpr bool compute_grad = false;
-    const bool smearing = true;
-    // todo(oliiny): it's a rough density estimate from a single ensemble.
-    // It might actually be appropriate for output. Discuss.
-    rho = std::get<0>(current_eckart(r_interaction.threevec(), particles,
-                                     density_param_, dens_type_, compute_grad,
-                                     smearing));
+    if (jmu_interaction_lat_) {
+      // The lattice is only read while the ensembles are evolved.
+      DensityOnLattice jmu;
+      jmu_interaction_lat_->value_at(r_interaction.threevec(), jmu);
+      rho = jmu.rho();
+    } else {
+      constexpr bool compute_grad = false;
+      const bool smearing = true;
+      // todo(oliiny): it's a rough density estimate from a single ensemble.
+      // It might actually be appropriate for output. Discuss.
+      rho = std::get<0>(current_eckart(r_interaction.threevec(), particles,
+                                       density_param_, dens_type_,
+                                       compute_grad, smearing));
+    }
   }
   /*!\Userguide
    * \page doxypage_output_collisions_box_modus
@@ -2187,15 +4079,10 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
    * their x coordinates would be 0.1 and 9.9 fm and interaction point
    * position could be either at 10 fm or at 5 fm.
    */
-  for (const auto &output : outputs_) {
-    if (!output->is_dilepton_output() && !output->is_photon_output()) {
-      if (output->is_IC_output() &&
-          action.get_type() == ProcessType::HyperSurfaceCrossing) {
-        output->at_interaction(action, rho);
-      } else if (!output->is_IC_output()) {
-        output->at_interaction(action, rho);
-      }
-    }
+  if (deferred_output_density) {
+    *deferred_output_density = rho;
+  } else {
+    write_interaction_output(action, rho, i_ensemble);
   }
 
   // At every collision photons can be produced.
@@ -2266,6 +4153,187 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
   return true;
 }
 
+template <typename Modus>
+void Experiment<Modus>::write_interaction_output(const Action &action,
+                                                 double density,
+                                                 int i_ensemble) {
+  for (const std::size_t i_output : interaction_subscribers_) {
+    const auto &output = outputs_[i_output];
+    // The initial conditions only consist of the hypersurface crossings.
+    if (output->is_IC_output() &&
+        action.get_type() != ProcessType::HyperSurfaceCrossing) {
+      continue;
+    }
+    ScopedTimer timer(profiler_, output_phases_[i_output]);
+    output->at_ensemble_interaction(action, density, i_ensemble);
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::merge_ensemble_counters(int i_ensemble) {
+  EnsembleCounters &counters = ensemble_counters_[i_ensemble];
+  interactions_total_ += counters.interactions;
+  wall_actions_total_ += counters.wall_actions;
+  scatterings_total_ += counters.scatterings;
+  total_pauli_blocked_ += counters.pauli_blocked;
+  total_hypersurface_crossing_actions_ +=
+      counters.hypersurface_crossing_actions;
+  discarded_interactions_total_ += counters.discarded_interactions;
+  total_energy_removed_ += counters.energy_removed;
+  total_energy_violated_by_Pythia_ += counters.energy_violated_by_Pythia;
+  for (const auto &[type, cost] : counters.action_costs) {
+    action_costs_[type] += cost;
+  }
+  conserved_current_ += counters.conserved_change;
+  counters = EnsembleCounters{};
+}
+
+template <typename Modus>
+void Experiment<Modus>::check_conservation(bool recount) const {
+  if (potentials_ || parameters_.strings_switch ||
+      metric_.mode_ != ExpansionMode::NoExpansion || IC_output_switch_) {
+    return;
+  }
+  const std::string err_msg =
+      recount ? conserved_initial_.report_deviations(ensembles_)
+              : conserved_initial_.report_deviations(conserved_current_);
+  if (!err_msg.empty()) {
+    logg[LExperiment].error() << err_msg;
+    throw std::runtime_error("Violation of conserved quantities!");
+  }
+}
+
+template <typename Modus>
+ScopedPotentialPointers Experiment<Modus>::use_on_this_thread() const {
+  ParticleData::formation_power_ = formation_power_;
+  // Actions only see the potentials if they affect the thresholds.
+  if (!parameters_.potential_affect_threshold) {
+    return ScopedPotentialPointers(nullptr, nullptr, nullptr);
+  }
+  return ScopedPotentialPointers(UB_lat_.get(), UI3_lat_.get(),
+                                 potentials_.get());
+}
+
+template <typename Modus>
+void Experiment<Modus>::find_actions_in_parallel(const GridType &grid,
+                                                 double dt,
+                                                 Actions &actions) const {
+  const std::uint64_t step_seed = random::advance();
+  const int string_worker = ScatterActionsFinder::string_worker();
+  /* The actions found in every search cell, keyed by the id of the first
+   * particle in the cell, separately for each thread */
+  std::vector<std::vector<std::pair<std::int32_t, ActionList>>> found(
+      action_finding_threads_);
+  // The stream of the ensemble on the calling thread is left untouched.
+  random::Engine cell_stream;
+  random::ScopedEngine use_cell_stream(cell_stream);
+  grid.iterate_cells_in_parallel(
+      action_finding_threads_,
+      [&](int i_thread, const ParticleList &search_list) {
+        if (search_list.empty()) {
+          return;
+        }
+        const auto use_experiment = use_on_this_thread();
+        ScatterActionsFinder::set_string_worker(string_worker);
+        const std::int32_t cell_key = search_list.front().id();
+        random::set_seed(random::stream_seed(step_seed, cell_key));
+        ActionList &cell_actions =
+            found[i_thread].emplace_back(cell_key, ActionList()).second;
+        for (const auto &finder : action_finders_) {
+          for (ActionPtr &action :
+               find_actions_in_grid_cell(*finder, grid, search_list, dt)) {
+            cell_actions.push_back(std::move(action));
+          }
+        }
+      },
+      [&](int i_thread, const ParticleList &search_list,
+          const ParticleList &neighbors_list) {
+        // The neighbors of a cell follow the cell on the same thread.
+        const auto use_experiment = use_on_this_thread();
+        ScatterActionsFinder::set_string_worker(string_worker);
+        ActionList &cell_actions = found[i_thread].back().second;
+        for (const auto &finder : action_finders_) {
+          for (ActionPtr &action : finder->find_actions_with_neighbors(
+                   search_list, neighbors_list, dt, beam_momentum_)) {
+            cell_actions.push_back(std::move(action));
+          }
+        }
+      });
+
+  // Merge the cells in the order of their keys, and then sort the actions.
+  std::vector<std::pair<std::int32_t, ActionList>> cells;
+  for (auto &thread_cells : found) {
+    std::move(thread_cells.begin(), thread_cells.end(),
+              std::back_inserter(cells));
+  }
+  std::sort(cells.begin(), cells.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  ActionList merged;
+  for (auto &cell : cells) {
+    std::move(cell.second.begin(), cell.second.end(),
+              std::back_inserter(merged));
+  }
+  std::stable_sort(merged.begin(), merged.end(),
+                   [](const ActionPtr &a, const ActionPtr &b) {
+                     if (a->time_of_execution() != b->time_of_execution()) {
+                       return a->time_of_execution() < b->time_of_execution();
+                     }
+                     const ParticleList &in_a = a->incoming_particles();
+                     const ParticleList &in_b = b->incoming_particles();
+                     return std::lexicographical_compare(
+                         in_a.begin(), in_a.end(), in_b.begin(), in_b.end(),
+                         [](const ParticleData &p, const ParticleData &q) {
+                           return p.id() < q.id();
+                         });
+                   });
+  actions.insert(std::move(merged));
+}
+
+template <typename Modus>
+template <typename F>
+void Experiment<Modus>::for_each_ensemble(F &&evolve_ensemble) {
+  const int n_ensembles = parameters_.n_ensembles;
+  if (ensemble_threads_ <= 1) {
+    for (int i_ens = 0; i_ens < n_ensembles; i_ens++) {
+      evolve_ensemble(i_ens);
+      merge_ensemble_counters(i_ens);
+    }
+    return;
+  }
+
+  /* The ensembles are distributed round-robin over the threads. The calling
+   * thread takes part as the first worker. */
+  auto worker = [&](int i_thread, std::size_t) {
+    // Each ensemble thread owns the string processes of its action threads.
+    ScatterActionsFinder::set_string_worker(
+        i_thread * std::max(1, action_execution_threads_));
+    const auto use_experiment = use_on_this_thread();
+    std::optional<ScopedThreadAffinity> binding;
+    if (!ensemble_thread_cores_.empty()) {
+      binding.emplace(ensemble_thread_cores_[i_thread]);
+    }
+    for (int i_ens = i_thread; i_ens < n_ensembles;
+         i_ens += ensemble_threads_) {
+      random::ScopedEngine use_ensemble_stream(ensemble_engines_[i_ens]);
+      if (binding && binding->bound() && !ensemble_relocated_[i_ens]) {
+        ensembles_[i_ens].relocate();
+        ensemble_relocated_[i_ens] = 1;
+      }
+      evolve_ensemble(i_ens);
+    }
+  };
+  parallel_for(ensemble_threads_, ensemble_threads_, 1, worker);
+
+  // Merge the results in the order of the ensembles, as in the serial case.
+  for (int i_ens = 0; i_ens < n_ensembles; i_ens++) {
+    for (const auto &[action, density] : deferred_interactions_[i_ens]) {
+      write_interaction_output(*action, density, i_ens);
+    }
+    deferred_interactions_[i_ens].clear();
+    merge_ensemble_counters(i_ens);
+  }
+}
+
 /**
  * Validate a particle list adjusting each particle to be a valid SMASH
  * particle. If the provided particle has an invalid PDG code, it is removed
@@ -2282,6 +4350,7 @@ template <typename Modus>
 void Experiment<Modus>::run_time_evolution(const double t_end,
                                            ParticleList &&add_plist,
                                            ParticleList &&remove_plist) {
+  const auto use_experiment = use_on_this_thread();
   if (!add_plist.empty() || !remove_plist.empty()) {
     if (ensembles_.size() > 1) {
       throw std::runtime_error(
@@ -2300,6 +4369,8 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
       auto action_add_particles = std::make_unique<FreeforallAction>(
           ParticleList{}, add_plist, action_time);
       perform_action(*action_add_particles, 0);
+      // The added particles may scatter again.
+      frozen_out_ = false;
     }
     // Also here 2 if statements are needed as above.
     if (!remove_plist.empty()) {
@@ -2358,7 +4429,10 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
                ensembles_[0].size());
       }
     }
+    merge_ensemble_counters(0);
   }
+  // The particles may have changed since the forces were computed.
+  half_kick_forces_.clear();
 
   if (t_end > end_time_) {
     logg[LExperiment].fatal()
@@ -2367,9 +4441,37 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
     throw std::logic_error(
         "Experiment cannot evolve the system beyond End_Time.");
   }
+  // Time steps run by this call, for the recount of the conserved quantities
+  int timesteps = 0;
   while (*(parameters_.labclock) < t_end) {
+    if (frozen_out_) {
+      stream_freely(t_end);
+      break;
+    }
+    ScopedTimer step_timer(profiler_, ProfiledPhase::TimeStep);
     const double dt = parameters_.labclock->timestep_duration();
     logg[LExperiment].debug("Timestepless propagation for next ", dt, " fm.");
+    const uint64_t scatterings_before_timestep = scatterings_total_;
+
+    /* (0) With the leapfrog scheme, kick the momenta by the forces of half a
+     *     time step before the particles are propagated */
+    const bool leapfrog = potentials_ && potentials_->leapfrog();
+    if (leapfrog) {
+      if (half_kick_forces_.empty()) {
+        // The potentials are needed now, whatever the update interval.
+        timesteps_since_potentials_update_ =
+            std::max(timesteps_since_potentials_update_,
+                     potentials_update_interval_ - 1);
+        update_potentials();
+        ScopedTimer timer(profiler_, ProfiledPhase::MomentumUpdate);
+        half_kick_forces_ =
+            compute_forces(ensembles_, *potentials_, FB_lat_.get(),
+                           FI3_lat_.get(), EM_lat_.get(), jmu_B_lat_.get(),
+                           ensemble_threads_);
+      }
+      ScopedTimer timer(profiler_, ProfiledPhase::MomentumUpdate);
+      kick_momenta(ensembles_, half_kick_forces_, 0.5 * dt);
+    }
 
     // Perform forced thermalization if required
     if (thermalizer_ &&
@@ -2387,99 +4489,190 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
         if (th_act.any_particles_thermalized()) {
           perform_action(th_act, i_ens);
         }
+        merge_ensemble_counters(i_ens);
       }
     }
 
-    std::vector<Actions> actions(parameters_.n_ensembles);
-    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+    update_interaction_density_lattice();
+
+    std::vector<Actions> &actions = timestep_actions_;
+    for_each_ensemble([&](int i_ens) {
       actions[i_ens].clear();
+      actions[i_ens].set_time_step(dt);
       if (ensembles_[i_ens].size() > 0 && action_finders_.size() > 0) {
+        if (sample_decay_times_once_ && decay_finder_) {
+          decay_finder_->schedule_decays(ensembles_[i_ens]);
+        }
         /* (1.a) Create grid. */
         const double min_cell_length = compute_min_cell_length(dt);
         logg[LExperiment].debug("Creating grid with minimal cell length ",
                                 min_cell_length);
+        if (spatial_sorting_threshold_ > 0. &&
+            ensembles_[i_ens].disorder() > spatial_sorting_threshold_) {
+          ScopedTimer timer(profiler_, ProfiledPhase::GridUpdate);
+          ensembles_[i_ens].sort_spatially(min_cell_length);
+        }
         /* For the hyper-surface-crossing actions also unformed particles are
          * searched and therefore needed on the grid. */
         const bool include_unformed_particles = IC_output_switch_;
-        const auto &grid =
-            use_grid_ ? modus_.create_grid(ensembles_[i_ens], min_cell_length,
-                                           dt, parameters_.coll_crit,
-                                           include_unformed_particles)
-                      : modus_.create_grid(ensembles_[i_ens], min_cell_length,
-                                           dt, parameters_.coll_crit,
-                                           include_unformed_particles,
-                                           CellSizeStrategy::Largest);
-
-        const double gcell_vol = grid.cell_volume();
+        CellSizeStrategy strategy =
+            use_grid_ ? CellSizeStrategy::Optimal : CellSizeStrategy::Largest;
+        double cell_length = min_cell_length;
+        if (!cell_sizers_.empty()) {
+          cell_length = cell_sizers_[i_ens].cell_length(min_cell_length);
+          strategy = cell_sizers_[i_ens].strategy();
+        }
+        // The grid is kept between time steps to reuse its storage.
+        std::unique_ptr<GridType> &grid_ptr = grids_[i_ens];
+        {
+          ScopedTimer timer(profiler_, ProfiledPhase::GridUpdate);
+          if (exclude_spectators_ && spectators_[i_ens].size() > 0) {
+            const std::size_t n_spectators = spectators_[i_ens].update(
+                ensembles_[i_ens], std::sqrt(max_transverse_distance_sqr_),
+                dt);
+            logg[LExperiment].debug("Leaving ", n_spectators,
+                                    " spectators out of the grid.");
+          }
+          if (grid_ptr) {
+            modus_.update_grid(*grid_ptr, ensembles_[i_ens], cell_length, dt,
+                               parameters_.coll_crit,
+                               include_unformed_particles, strategy);
+          } else {
+            grid_ptr = std::make_unique<GridType>(modus_.create_grid(
+                ensembles_[i_ens], cell_length, dt, parameters_.coll_crit,
+                include_unformed_particles, strategy));
+            if (exclude_spectators_) {
+              // Spectators are left out from the next update on
+              grid_ptr->set_exclusion([this, i_ens](const ParticleData &data) {
+                return spectators_[i_ens].contains(data);
+              });
+            }
+            if (scatter_finder_ &&
+                scatter_finder_->multi_particle_reactions()) {
+              /* The few particles taking part in multi-particle reactions
+               * are listed for every cell, already in this step. */
+              const ScatterActionsFinder *finder = scatter_finder_;
+              grid_ptr->set_member_selection(
+                  [finder](const ParticleData &data) {
+                    return finder->takes_part_in_multi_particle_reactions(
+                        data);
+                  });
+            }
+            if (parameters_.n_subensembles > 1) {
+              // The subensembles never share cells, already in this step.
+              grid_ptr->set_layers(parameters_.n_subensembles);
+              modus_.update_grid(*grid_ptr, ensembles_[i_ens], cell_length,
+                                 dt, parameters_.coll_crit,
+                                 include_unformed_particles, strategy);
+            }
+          }
+          if (!cell_sizers_.empty()) {
+            cell_sizers_[i_ens].record(grid_ptr->statistics(),
+                                       min_cell_length);
+          }
+        }
+        const auto &grid = *grid_ptr;
+
         /* (1.b) Iterate over cells and find actions. */
-        grid.iterate_cells(
-            [&](const ParticleList &search_list) {
-              for (const auto &finder : action_finders_) {
-                actions[i_ens].insert(finder->find_actions_in_cell(
-                    search_list, dt, gcell_vol, beam_momentum_));
-              }
-            },
-            [&](const ParticleList &search_list,
-                const ParticleList &neighbors_list) {
-              for (const auto &finder : action_finders_) {
-                actions[i_ens].insert(finder->find_actions_with_neighbors(
-                    search_list, neighbors_list, dt, beam_momentum_));
-              }
-            });
+        ScopedTimer timer(profiler_, ProfiledPhase::ActionFinding);
+        if (action_finding_threads_ > 0) {
+          find_actions_in_parallel(grid, dt, actions[i_ens]);
+        } else {
+          grid.iterate_cells_with_shifts(
+              [&](const ParticleList &search_list) {
+                for (const auto &finder : action_finders_) {
+                  actions[i_ens].insert(find_actions_in_grid_cell(
+                      *finder, grid, search_list, dt));
+                }
+              },
+              [&](const ParticleList &search_list, const ThreeVector &shift,
+                  const ParticleList &neighbors_list) {
+                for (const auto &finder : action_finders_) {
+                  actions[i_ens].insert(
+                      finder->find_actions_with_shifted_neighbors(
+                          search_list, shift, neighbors_list, dt,
+                          beam_momentum_));
+                }
+              });
+        }
       }
+    });
+    std::size_t n_actions_found = 0;
+    for (const Actions &ensemble_actions : actions) {
+      n_actions_found += ensemble_actions.size();
     }
 
-    /* \todo (optimizations) Adapt timestep size here */
-
     /* (2) Propagate from action to action until next output or timestep end */
     const double end_timestep_time = parameters_.labclock->next_time();
+    if (pauli_blocker_) {
+      pauli_blocker_->build_index(ensembles_, end_timestep_time);
+    }
     while (next_output_time() < end_timestep_time) {
-      for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+      const double end_time_propagation = next_output_time();
+      for_each_ensemble([&](int i_ens) {
         run_time_evolution_timestepless(actions[i_ens], i_ens,
-                                        next_output_time());
-      }
+                                        end_time_propagation);
+      });
       ++(*parameters_.outputclock);
 
       intermediate_output();
     }
-    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+    for_each_ensemble([&](int i_ens) {
       run_time_evolution_timestepless(actions[i_ens], i_ens, end_timestep_time);
+    });
+    if (pauli_blocker_) {
+      pauli_blocker_->clear_index();
     }
 
     /* (3) Update potentials (if computed on the lattice) and
      *     compute new momenta according to equations of motion */
-    if (potentials_) {
+    if (leapfrog) {
       update_potentials();
+      ScopedTimer timer(profiler_, ProfiledPhase::MomentumUpdate);
+      // The forces are kept for the first half kick of the next time step.
+      half_kick_forces_ =
+          compute_forces(ensembles_, *potentials_, FB_lat_.get(),
+                         FI3_lat_.get(), EM_lat_.get(), jmu_B_lat_.get(),
+                         ensemble_threads_);
+      kick_momenta(ensembles_, half_kick_forces_, 0.5 * dt);
+    } else if (potentials_) {
+      update_potentials();
+      ScopedTimer timer(profiler_, ProfiledPhase::MomentumUpdate);
       update_momenta(ensembles_, parameters_.labclock->timestep_duration(),
                      *potentials_, FB_lat_.get(), FI3_lat_.get(), EM_lat_.get(),
-                     jmu_B_lat_.get());
+                     jmu_B_lat_.get(), ensemble_threads_);
     }
 
     /* (4) Expand universe if non-minkowskian metric; updates
      *     positions and momenta according to the selected expansion */
     if (metric_.mode_ != ExpansionMode::NoExpansion) {
       for (Particles &particles : ensembles_) {
-        expand_space_time(&particles, parameters_, metric_);
+        expand_space_time(&particles, parameters_, metric_,
+                          propagation_threads_);
       }
     }
 
     ++(*parameters_.labclock);
+    if (adaptive_time_step_) {
+      adapt_timestep_duration(dt, n_actions_found);
+    }
+    if (modus_.freeze_out_rate() > 0. && scatterings_total_ > 0) {
+      detect_freeze_out(scatterings_total_ - scatterings_before_timestep, dt);
+    }
 
-    /* (5) Check conservation laws.
-     *
-     * Check conservation of conserved quantities if potentials and string
-     * fragmentation are off.  If potentials are on then momentum is conserved
-     * only in average.  If string fragmentation is on, then energy and
-     * momentum are only very roughly conserved in high-energy collisions. */
-    if (!potentials_ && !parameters_.strings_switch &&
-        metric_.mode_ == ExpansionMode::NoExpansion && !IC_output_switch_) {
-      std::string err_msg = conserved_initial_.report_deviations(ensembles_);
-      if (!err_msg.empty()) {
-        logg[LExperiment].error() << err_msg;
-        throw std::runtime_error("Violation of conserved quantities!");
-      }
+    /* (5) Check conservation laws, from the changes by the actions and, every
+     *     conservation_recount_interval_ time steps, from all particles. */
+    timesteps++;
+    check_conservation(conservation_recount_interval_ > 0 &&
+                       timesteps % conservation_recount_interval_ == 0);
+
+    if (checkpoint_interval_ > 0. &&
+        parameters_.labclock->current_time() >= next_checkpoint_time_) {
+      write_checkpoint();
     }
   }
+  // Whatever the interval, the particles are counted at the end.
+  check_conservation(true);
 
   if (pauli_blocker_) {
     logg[LExperiment].info(
@@ -2490,13 +4683,12 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
 
 template <typename Modus>
 void Experiment<Modus>::propagate_and_shine(double to_time,
-                                            Particles &particles) {
+                                            Particles &particles,
+                                            int n_threads) {
   const double dt =
-      propagate_straight_line(&particles, to_time, beam_momentum_);
+      propagate_straight_line(&particles, to_time, beam_momentum_, n_threads);
   if (dilepton_finder_ != nullptr) {
-    for (const auto &output : outputs_) {
-      dilepton_finder_->shine(particles, output.get(), dt);
-    }
+    dilepton_finder_->shine(particles, outputs_, dt);
   }
 }
 
@@ -2517,20 +4709,134 @@ inline void check_interactions_total(uint64_t interactions_total) {
 template <typename Modus>
 void Experiment<Modus>::run_time_evolution_timestepless(
     Actions &actions, int i_ensemble, const double end_time_propagation) {
+  ScopedTimer propagation_timer(profiler_,
+                                ProfiledPhase::TimesteplessPropagation);
   Particles &particles = ensembles_[i_ensemble];
+  const bool defer_output = ensemble_threads_ > 1;
   logg[LExperiment].debug(
       "Timestepless propagation: ", "Actions size = ", actions.size(),
       ", end time = ", end_time_propagation);
+  // Buffer for the particles close to the outgoing particles of an action
+  ParticleList &surroundings = surroundings_[i_ensemble];
+  /* With several threads, the final states of independent actions are
+   * generated in advance, and every action draws from its own stream. */
+  const bool prepare = action_execution_threads_ > 0;
+  const std::uint64_t actions_seed = prepare ? random::advance() : 0;
+  const int string_worker = ScatterActionsFinder::string_worker();
+  // Prepared actions in the order of their times
+  std::deque<PreparedAction> prepared;
+  /* With a deferred collision search, the outgoing particles of every action
+   * are kept as one group, until the evolution is about to reach the earliest
+   * time at which any of them could collide. */
+  std::vector<ParticleList> fresh;
+  double fresh_horizon = std::numeric_limits<double>::infinity();
+  // Time to which the particles have been propagated by the last action
+  double now = parameters_.labclock->current_time();
+  /* With lazy propagation, every particle keeps the time of its position,
+   * and only the particles of an action and their possible partners are
+   * propagated to its time. Dileptons, Pauli blocking and the exact density
+   * at the interaction point need all particles at the time of the action. */
+  const bool lazy =
+      lazy_propagation_ && !dilepton_finder_ && !pauli_blocker_ &&
+      !(dens_type_ != DensityType::None && interaction_density_needed_ &&
+        !jmu_interaction_lat_);
+  auto propagate_copies = [&](ParticleList &copies, double time) {
+    if (lazy) {
+      for (ParticleData &p : copies) {
+        propagate_straight_line(&p, time, beam_momentum_);
+      }
+    }
+  };
+  auto search_fresh = [&]() {
+    ScopedTimer search_timer(profiler_,
+                             ProfiledPhase::ActionFindingAfterActions);
+    const double time_left = parameters_.labclock->next_time() - now;
+    // Pairs with the groups searched before have been found already.
+    std::set<std::int32_t> searched;
+    ParticleList group;
+    for (const ParticleList &outgoing : fresh) {
+      group.clear();
+      for (const ParticleData &p : outgoing) {
+        if (particles.is_valid(p)) {
+          group.push_back(particles.lookup(p));
+        }
+      }
+      if (group.empty()) {
+        continue;
+      }
+      propagate_copies(group, now);
+      actions.insert(scatter_finder_->find_actions_in_cell(
+          group, time_left, 0.0, beam_momentum_));
+      if (collect_surrounding_particles(i_ensemble, group, now, time_left,
+                                        surroundings)) {
+        surroundings.erase(
+            std::remove_if(surroundings.begin(), surroundings.end(),
+                           [&](const ParticleData &p) {
+                             return searched.count(p.id()) > 0;
+                           }),
+            surroundings.end());
+        propagate_copies(surroundings, now);
+        actions.insert(scatter_finder_->find_actions_with_neighbors(
+            group, surroundings, time_left, beam_momentum_));
+      } else {
+        if (lazy) {
+          propagate_straight_line(&particles, now, beam_momentum_);
+        }
+        actions.insert(scatter_finder_->find_actions_with_surrounding_particles(
+            group, particles, time_left, beam_momentum_));
+      }
+      for (const ParticleData &p : group) {
+        searched.insert(p.id());
+      }
+    }
+    fresh.clear();
+    fresh_horizon = std::numeric_limits<double>::infinity();
+  };
 
   // iterate over all actions
-  while (!actions.is_empty()) {
-    if (actions.earliest_time() > end_time_propagation) {
-      break;
+  while (!actions.is_empty() || !prepared.empty() || !fresh.empty()) {
+    /* Search the fresh particles before any of them could collide, such
+     * that all found actions lie ahead. */
+    if (!fresh.empty()) {
+      double next_time = end_time_propagation;
+      if (!prepared.empty()) {
+        next_time =
+            std::min(next_time, prepared.front().action->time_of_execution());
+      }
+      if (!actions.is_empty()) {
+        next_time = std::min(next_time, actions.earliest_time());
+      }
+      if (next_time >= fresh_horizon) {
+        search_fresh();
+        continue;
+      }
+      if (actions.is_empty() && prepared.empty()) {
+        break;
+      }
     }
-    // get next action
-    ActionPtr act = actions.pop();
+    // get next action, prepared ones are not in actions anymore
+    PreparedAction next;
+    const bool was_prepared =
+        !prepared.empty() &&
+        (actions.is_empty() || prepared.front().action->time_of_execution() <=
+                                   actions.earliest_time());
+    if (was_prepared) {
+      next = std::move(prepared.front());
+      prepared.pop_front();
+    } else {
+      if (actions.earliest_time() > end_time_propagation) {
+        break;
+      }
+      if (prepare && prepared.empty()) {
+        prepare_final_states(actions, i_ensemble, end_time_propagation,
+                             actions_seed, prepared);
+        continue;
+      }
+      next.action = actions.pop();
+    }
+    ActionPtr &act = next.action;
     if (!act->is_valid(particles)) {
-      discarded_interactions_total_++;
+      ensemble_counters_[i_ensemble].discarded_interactions++;
       logg[LExperiment].debug(~einhard::DRed(), "✘ ", act,
                               " (discarded: invalid)");
       continue;
@@ -2539,7 +4845,16 @@ void Experiment<Modus>::run_time_evolution_timestepless(
                             ", action time = ", act->time_of_execution());
 
     /* (1) Propagate to the next action. */
-    propagate_and_shine(act->time_of_execution(), particles);
+    now = act->time_of_execution();
+    if (lazy) {
+      for (const ParticleData &p : act->incoming_particles()) {
+        ParticleData propagated = particles.lookup(p);
+        propagate_straight_line(&propagated, now, beam_momentum_);
+        particles.update_particle(p, propagated);
+      }
+    } else {
+      propagate_and_shine(now, particles);
+    }
 
     /* (2) Perform action.
      *
@@ -2547,7 +4862,18 @@ void Experiment<Modus>::run_time_evolution_timestepless(
      * in the action object will be outdated as the particles have been
      * propagated since the construction of the action. */
     act->update_incoming(particles);
-    const bool performed = perform_action(*act, i_ensemble);
+    if (prepare && !was_prepared) {
+      generate_final_state(next, actions_seed, string_worker);
+    }
+    if (next.error) {
+      std::rethrow_exception(next.error);
+    }
+    double density_at_interaction = 0.0;
+    const bool performed =
+        !next.below_threshold &&
+        perform_action(*act, i_ensemble, true,
+                       defer_output ? &density_at_interaction : nullptr,
+                       prepare);
 
     /* No need to update actions for outgoing particles
      * if the action is not performed. */
@@ -2555,31 +4881,294 @@ void Experiment<Modus>::run_time_evolution_timestepless(
       continue;
     }
 
+    /* Drop the pending actions of the consumed particles right away instead
+     * of discarding them once they are popped. */
+    for (const ParticleData &p : act->incoming_particles()) {
+      if (!particles.is_valid(p)) {
+        actions.drop_actions_of(p.id());
+      }
+    }
+
     /* (3) Update actions for newly-produced particles. */
 
     const double end_time_timestep = parameters_.labclock->next_time();
     // New actions are always search until the end of the current timestep
     const double time_left = end_time_timestep - act->time_of_execution();
     const ParticleList &outgoing_particles = act->outgoing_particles();
+    ScopedTimer timer(profiler_, ProfiledPhase::ActionFindingAfterActions);
+    // Keep the grid up to date, such that it can be searched locally
+    const bool search_grid =
+        grids_[i_ensemble] && grids_[i_ensemble]->binned() &&
+        parameters_.coll_crit != CollisionCriterion::Stochastic;
+    if (search_grid) {
+      for (const ParticleData &p : outgoing_particles) {
+        grids_[i_ensemble]->place(p);
+      }
+    }
+    const bool local_search =
+        search_grid && collect_surrounding_particles(
+                           i_ensemble, outgoing_particles,
+                           act->time_of_execution(), time_left, surroundings);
+    if (local_search) {
+      propagate_copies(surroundings, now);
+    } else if (lazy) {
+      propagate_straight_line(&particles, now, beam_momentum_);
+    }
     // Grid cell volume set to zero, since there is no grid
     const double gcell_vol = 0.0;
+    const bool defer = defer_collision_search_ && local_search;
+    if (defer) {
+      fresh_horizon = std::min(
+          fresh_horizon,
+          scatter_finder_->earliest_collision_time(
+              outgoing_particles, surroundings, time_left, beam_momentum_));
+      fresh.push_back(outgoing_particles);
+    }
     for (const auto &finder : action_finders_) {
+      if (defer && finder.get() == scatter_finder_) {
+        continue;
+      }
       // Outgoing particles can still decay, cross walls...
       actions.insert(finder->find_actions_in_cell(outgoing_particles, time_left,
                                                   gcell_vol, beam_momentum_));
       // ... and collide with other particles.
-      actions.insert(finder->find_actions_with_surrounding_particles(
-          outgoing_particles, particles, time_left, beam_momentum_));
+      if (local_search) {
+        actions.insert(finder->find_actions_with_neighbors(
+            outgoing_particles, surroundings, time_left, beam_momentum_));
+      } else {
+        actions.insert(finder->find_actions_with_surrounding_particles(
+            outgoing_particles, particles, time_left, beam_momentum_));
+      }
+    }
+
+    check_interactions_total(interactions_total_ +
+                             ensemble_counters_[i_ensemble].interactions);
+    if (defer_output) {
+      deferred_interactions_[i_ensemble].emplace_back(std::move(act),
+                                                      density_at_interaction);
+    }
+  }
+
+  // The remaining collisions are due after the end of the propagation.
+  if (!fresh.empty()) {
+    search_fresh();
+  }
+  propagate_and_shine(end_time_propagation, particles, propagation_threads_);
+  if (modus_.is_box() && !modus_.wall_crossing_actions()) {
+    modus_.impose_boundary_conditions(&particles);
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::generate_final_state(PreparedAction &prepared,
+                                             std::uint64_t actions_seed,
+                                             int i_worker) const {
+  Action &action = *prepared.action;
+  const double time = action.time_of_execution();
+  std::uint64_t seed;
+  std::memcpy(&seed, &time, sizeof(seed));
+  seed = random::stream_seed(actions_seed, seed);
+  for (const ParticleData &p : action.incoming_particles()) {
+    seed = random::stream_seed(seed, p.id());
+  }
+  random::Engine stream(seed);
+  random::ScopedEngine use_stream(stream);
+  if (scatter_finder_) {
+    if (auto *scatter = dynamic_cast<ScatterAction *>(&action)) {
+      scatter->set_string_interface(
+          scatter_finder_->worker_string_process(i_worker));
+    }
+  }
+  try {
+    action.generate_final_state();
+  } catch (Action::StochasticBelowEnergyThreshold &) {
+    prepared.below_threshold = true;
+  } catch (...) {
+    prepared.error = std::current_exception();
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::prepare_final_states(
+    Actions &actions, int i_ensemble, double end_time,
+    std::uint64_t actions_seed, std::deque<PreparedAction> &prepared) {
+  // Number of actions looked at for one batch
+  constexpr std::size_t max_popped = 64;
+  const Particles &particles = ensembles_[i_ensemble];
+  const double reach = std::sqrt(max_transverse_distance_sqr_);
+  std::vector<PreparedAction> batch;
+  ActionList put_back;
+  // Interaction points and incoming particles of all valid popped actions
+  std::vector<std::pair<FourVector, const ParticleList *>> popped;
+  while (!actions.is_empty() && actions.earliest_time() <= end_time &&
+         popped.size() < max_popped) {
+    ActionPtr act = actions.pop();
+    if (!act->is_valid(particles)) {
+      ensemble_counters_[i_ensemble].discarded_interactions++;
+      logg[LExperiment].debug(~einhard::DRed(), "✘ ", act,
+                              " (discarded: invalid)");
+      continue;
+    }
+    const FourVector point(act->time_of_execution(),
+                           act->get_interaction_point().threevec());
+    const ParticleList &incoming = act->incoming_particles();
+    const bool independent = std::all_of(
+        popped.begin(), popped.end(), [&](const auto &earlier) {
+          const FourVector distance = point - earlier.first;
+          if (distance.threevec().abs() <= distance.x0() + reach) {
+            return false;
+          }
+          return std::none_of(
+              incoming.begin(), incoming.end(), [&](const ParticleData &p) {
+                return std::any_of(earlier.second->begin(),
+                                   earlier.second->end(),
+                                   [&](const ParticleData &q) {
+                                     return p.id() == q.id();
+                                   });
+              });
+        });
+    popped.emplace_back(point, &incoming);
+    if (independent) {
+      act->update_incoming(particles);
+      batch.emplace_back().action = std::move(act);
+    } else {
+      put_back.push_back(std::move(act));
+    }
+  }
+
+  // The string processes of the threads follow the one of the ensemble.
+  const int string_worker = ScatterActionsFinder::string_worker();
+  parallel_for(action_execution_threads_, batch.size(), 1,
+               [&](int i_thread, std::size_t i) {
+                 const auto use_experiment = use_on_this_thread();
+                 generate_final_state(batch[i], actions_seed,
+                                      string_worker + i_thread);
+               });
+
+  actions.insert(std::move(put_back));
+  std::move(batch.begin(), batch.end(), std::back_inserter(prepared));
+}
+
+template <typename Modus>
+bool Experiment<Modus>::collect_surrounding_particles(
+    int i_ensemble, const ParticleList &outgoing, double time,
+    double time_left, ParticleList &surroundings) const {
+  surroundings.clear();
+  if (outgoing.empty()) {
+    return true;
+  }
+  const Particles &particles = ensembles_[i_ensemble];
+  // Cube containing the outgoing particles
+  ThreeVector lower = outgoing.front().position().threevec();
+  ThreeVector upper = lower;
+  for (const ParticleData &p : outgoing) {
+    const ThreeVector r = p.position().threevec();
+    for (int i = 0; i < 3; i++) {
+      lower[i] = std::min(lower[i], r[i]);
+      upper[i] = std::max(upper[i], r[i]);
     }
+  }
+  double half_size = 0.;
+  for (int i = 0; i < 3; i++) {
+    half_size = std::max(half_size, 0.5 * (upper[i] - lower[i]));
+  }
+  const double moved = time - parameters_.labclock->current_time();
+  const double radius = half_size + moved + 2 * time_left +
+                        std::sqrt(max_transverse_distance_sqr_);
+  if (!std::isfinite(radius)) {
+    return false;
+  }
+  grids_[i_ensemble]->iterate_surroundings(
+      0.5 * (lower + upper), radius, [&](const ParticleData &copy) {
+        if (!particles.is_valid(copy)) {
+          return;
+        }
+        const bool is_outgoing = std::any_of(
+            outgoing.begin(), outgoing.end(),
+            [&](const ParticleData &p) { return p.id() == copy.id(); });
+        // Only particles of the same subensemble interact.
+        const bool same_subensemble = std::any_of(
+            outgoing.begin(), outgoing.end(), [&](const ParticleData &p) {
+              return p.subensemble() == copy.subensemble();
+            });
+        if (!is_outgoing && same_subensemble) {
+          surroundings.push_back(particles.lookup(copy));
+        }
+      });
+  return true;
+}
+
+template <typename Modus>
+void Experiment<Modus>::update_interaction_statistics() {
+  InteractionStatistics interval;
+  if (scatter_finder_) {
+    interval.search = scatter_finder_->take_search_counters();
+  }
+  interval.performed = interactions_total_ - wall_actions_total_ -
+                       total_hypersurface_crossing_actions_ -
+                       interaction_statistics_.performed;
+  interval.discarded =
+      discarded_interactions_total_ - interaction_statistics_.discarded;
+  interval.pauli_blocked =
+      total_pauli_blocked_ - interaction_statistics_.pauli_blocked;
+  interaction_statistics_ += interval;
+  interval_interaction_statistics_ = interval;
+}
 
-    check_interactions_total(interactions_total_);
+template <typename Modus>
+void Experiment<Modus>::check_memory() {
+  if (!MemoryTracker::enabled()) {
+    return;
+  }
+  logg[LExperiment].info() << "Memory at t = "
+                           << parameters_.labclock->current_time() << " fm:\n"
+                           << MemoryTracker::report();
+  if (memory_budget_ <= 0. ||
+      MemoryTracker::resident_bytes() <= memory_budget_) {
+    return;
+  }
+  if (!memory_budget_exceeded_) {
+    memory_budget_exceeded_ = true;
+    logg[LExperiment].warn(
+        "The resident memory exceeds the budget of ",
+        memory_budget_ / (1024. * 1024.), " MiB in event ", event_,
+        ", the queues of the outputs are flushed at every output time.");
+  }
+  for (const auto &output : outputs_) {
+    if (auto *async = dynamic_cast<AsyncOutput *>(output.get())) {
+      async->flush();
+    }
   }
+}
 
-  propagate_and_shine(end_time_propagation, particles);
+template <typename Modus>
+void Experiment<Modus>::update_subscriptions() {
+  interaction_subscribers_.clear();
+  intermediate_subscribers_.clear();
+  interaction_density_needed_ = false;
+  for (std::size_t i = 0; i < outputs_.size(); i++) {
+    const OutputInterface &output = *outputs_[i];
+    // Dileptons and photons are passed to their outputs by their own finders.
+    if (output.is_dilepton_output() || output.is_photon_output()) {
+      continue;
+    }
+    if (output.uses_interactions()) {
+      interaction_subscribers_.push_back(i);
+      interaction_density_needed_ |= output.uses_interaction_density();
+    }
+    if (!output.is_IC_output() && output.uses_intermediate_times()) {
+      intermediate_subscribers_.push_back(i);
+    }
+  }
 }
 
 template <typename Modus>
 void Experiment<Modus>::intermediate_output() {
+  finish_output_time();
+  update_interaction_statistics();
+  check_memory();
+  logg[LExperiment].debug("Interactions in the output interval: ",
+                          interval_interaction_statistics_);
   const uint64_t wall_actions_this_interval =
       wall_actions_total_ - previous_wall_actions_total_;
   previous_wall_actions_total_ = wall_actions_total_;
@@ -2587,15 +5176,84 @@ void Experiment<Modus>::intermediate_output() {
                                               previous_interactions_total_ -
                                               wall_actions_this_interval;
   previous_interactions_total_ = interactions_total_;
+
+  OutputTimeState state;
+  state.interactions = interactions_this_interval;
+  state.projectile_target_interact = projectile_target_interact_;
+  const bool count_conserved =
+      potentials_ || metric_.mode_ != ExpansionMode::NoExpansion;
+  if (!count_conserved) {
+    state.conserved = conserved_current_;
+  }
+  if (!overlaps_output_times()) {
+    state.ensembles = &ensembles_;
+    state.outputclock = &parameters_.outputclock;
+    state.jmu_B_lat = jmu_B_lat_.get();
+    state.jmu_I3_lat = jmu_I3_lat_.get();
+    state.jmu_custom_lat = jmu_custom_lat_.get();
+    state.j_QBS_lat = j_QBS_lat_.get();
+    state.Tmn = Tmn_.get();
+    state.EM_lat = EM_lat_.get();
+    write_output_time(state);
+    return;
+  }
+
+  /* Take a copy of everything the outputs need, since the time evolution
+   * continues until the outputs are written. The lattices are copied as well,
+   * because those updated at the output times are moved with the particles
+   * during the time evolution if the lattices are adaptive. */
+  OutputTimeSnapshot &snapshot = output_time_snapshot_;
+  if (snapshot.ensembles.size() != ensembles_.size()) {
+    // Particles cannot be moved, hence the vector is not resized.
+    snapshot.ensembles = std::vector<Particles>(ensembles_.size());
+  }
+  for (std::size_t i_ens = 0; i_ens < ensembles_.size(); i_ens++) {
+    snapshot.ensembles[i_ens].copy_from(ensembles_[i_ens]);
+  }
+  const double time = parameters_.outputclock->current_time();
+  auto frozen_clock = std::make_unique<CustomClock>(std::vector<double>{time});
+  frozen_clock->reset(time, false);
+  snapshot.outputclock = std::move(frozen_clock);
+  auto copy_lattice = [](const auto &lattice, auto &lattice_copy) {
+    lattice_copy.reset();
+    if (lattice) {
+      lattice_copy =
+          std::make_unique<std::decay_t<decltype(*lattice)>>(*lattice);
+    }
+    return lattice_copy.get();
+  };
+  state.ensembles = &snapshot.ensembles;
+  state.outputclock = &snapshot.outputclock;
+  state.jmu_B_lat = copy_lattice(jmu_B_lat_, snapshot.jmu_B_lat);
+  state.jmu_I3_lat = copy_lattice(jmu_I3_lat_, snapshot.jmu_I3_lat);
+  state.jmu_custom_lat =
+      copy_lattice(jmu_custom_lat_, snapshot.jmu_custom_lat);
+  state.j_QBS_lat = copy_lattice(j_QBS_lat_, snapshot.j_QBS_lat);
+  state.Tmn = copy_lattice(Tmn_, snapshot.Tmn);
+  state.EM_lat = copy_lattice(EM_lat_, snapshot.EM_lat);
+  output_time_writer_ = std::thread([this, state = std::move(state)] {
+    const auto use_experiment = use_on_this_thread();
+    try {
+      write_output_time(state);
+    } catch (...) {
+      output_time_error_ = std::current_exception();
+    }
+  });
+}
+
+template <typename Modus>
+void Experiment<Modus>::write_output_time(const OutputTimeState &state) {
+  const std::vector<Particles> &ensembles = *state.ensembles;
+  const std::unique_ptr<Clock> &outputclock = *state.outputclock;
   double E_mean_field = 0.0;
   /// Auxiliary variable to communicate the time in the computational frame
   /// at the functions printing the thermodynamics lattice output
   double computational_frame_time = 0.0;
   if (potentials_) {
     // using the lattice is necessary
-    if ((jmu_B_lat_ != nullptr)) {
-      E_mean_field = calculate_mean_field_energy(*potentials_, *jmu_B_lat_,
-                                                 EM_lat_.get(), parameters_);
+    if ((state.jmu_B_lat != nullptr)) {
+      E_mean_field = calculate_mean_field_energy(*potentials_, *state.jmu_B_lat,
+                                                 state.EM_lat, parameters_);
       /*
        * Mean field calculated in a box should remain approximately constant if
        * the system is in equilibrium, and so deviations from its original value
@@ -2612,8 +5270,7 @@ void Experiment<Modus>::intermediate_output() {
          */
         if (std::abs(tmp) > 0.01) {
           logg[LExperiment].info()
-              << "\n\n\n\t The mean field at t = "
-              << parameters_.outputclock->current_time()
+              << "\n\n\n\t The mean field at t = " << outputclock->current_time()
               << " [fm] differs from the mean field at t = 0:"
               << "\n\t\t                 initial_mean_field_energy_ = "
               << initial_mean_field_energy_ << " [GeV]"
@@ -2627,96 +5284,106 @@ void Experiment<Modus>::intermediate_output() {
   }
 
   logg[LExperiment].info() << format_measurements(
-      ensembles_, interactions_this_interval, conserved_initial_, time_start_,
-      parameters_.outputclock->current_time(), E_mean_field,
+      ensembles, state.interactions, conserved_initial_,
+      state.conserved ? *state.conserved : QuantumNumbers(ensembles),
+      time_start_, outputclock->current_time(), E_mean_field,
       initial_mean_field_energy_);
   const LatticeUpdate lat_upd = LatticeUpdate::AtOutput;
 
   // save evolution data
-  if (!(modus_.is_box() && parameters_.outputclock->current_time() <
-                               modus_.equilibration_time())) {
-    for (const auto &output : outputs_) {
-      if (output->is_dilepton_output() || output->is_photon_output() ||
-          output->is_IC_output()) {
-        continue;
+  if (!(modus_.is_box() &&
+        outputclock->current_time() < modus_.equilibration_time())) {
+    // The event info does not depend on the output, so it is filled once.
+    std::vector<EventInfo> event_infos;
+    if (!intermediate_subscribers_.empty()) {
+      event_infos.reserve(parameters_.n_ensembles);
+      for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+        event_infos.push_back(fill_event_info(
+            ensembles, E_mean_field, modus_.impact_parameter(), parameters_,
+            outputclock->current_time(), state.projectile_target_interact[i_ens],
+            kinematic_cuts_for_IC_output_));
+        computational_frame_time = event_infos.back().current_time;
       }
+    }
+    for (const std::size_t i_output : intermediate_subscribers_) {
+      const auto &output = outputs_[i_output];
+      ScopedTimer timer(profiler_, output_phases_[i_output]);
       for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
-        auto event_info = fill_event_info(
-            ensembles_, E_mean_field, modus_.impact_parameter(), parameters_,
-            projectile_target_interact_[i_ens], kinematic_cuts_for_IC_output_);
-
-        output->at_intermediate_time(ensembles_[i_ens], parameters_.outputclock,
-                                     density_param_, event_info);
-        computational_frame_time = event_info.current_time;
+        output->at_intermediate_time(ensembles[i_ens], outputclock,
+                                     density_param_, event_infos[i_ens]);
       }
       // For thermodynamic output
-      output->at_intermediate_time(ensembles_, parameters_.outputclock,
-                                   density_param_);
+      output->at_intermediate_time(ensembles, outputclock, density_param_);
 
       // Thermodynamic output on the lattice versus time
       if (printout_rho_eckart_) {
         switch (dens_type_lattice_printout_) {
           case DensityType::Baryon:
-            update_lattice(jmu_B_lat_.get(), lat_upd, DensityType::Baryon,
-                           density_param_, ensembles_, false);
+            update_lattice(state.jmu_B_lat, lat_upd, DensityType::Baryon,
+                           density_param_, ensembles, false);
             output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
-                                          DensityType::Baryon, *jmu_B_lat_);
-            output->thermodynamics_lattice_output(*jmu_B_lat_,
+                                          DensityType::Baryon,
+                                          *state.jmu_B_lat);
+            output->thermodynamics_lattice_output(*state.jmu_B_lat,
                                                   computational_frame_time);
             break;
           case DensityType::BaryonicIsospin:
-            update_lattice(jmu_I3_lat_.get(), lat_upd,
+            update_lattice(state.jmu_I3_lat, lat_upd,
                            DensityType::BaryonicIsospin, density_param_,
-                           ensembles_, false);
+                           ensembles, false);
             output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
                                           DensityType::BaryonicIsospin,
-                                          *jmu_I3_lat_);
-            output->thermodynamics_lattice_output(*jmu_I3_lat_,
+                                          *state.jmu_I3_lat);
+            output->thermodynamics_lattice_output(*state.jmu_I3_lat,
                                                   computational_frame_time);
             break;
           case DensityType::None:
             break;
           default:
-            update_lattice(jmu_custom_lat_.get(), lat_upd,
+            update_lattice(state.jmu_custom_lat, lat_upd,
                            dens_type_lattice_printout_, density_param_,
-                           ensembles_, false);
+                           ensembles, false);
             output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
                                           dens_type_lattice_printout_,
-                                          *jmu_custom_lat_);
-            output->thermodynamics_lattice_output(*jmu_custom_lat_,
+                                          *state.jmu_custom_lat);
+            output->thermodynamics_lattice_output(*state.jmu_custom_lat,
                                                   computational_frame_time);
         }
       }
       if (printout_tmn_ || printout_tmn_landau_ || printout_v_landau_) {
-        update_lattice(Tmn_.get(), lat_upd, dens_type_lattice_printout_,
-                       density_param_, ensembles_, false);
+        update_lattice(state.Tmn, lat_upd, dens_type_lattice_printout_,
+                       density_param_, ensembles, false);
         if (printout_tmn_) {
           output->thermodynamics_output(ThermodynamicQuantity::Tmn,
-                                        dens_type_lattice_printout_, *Tmn_);
+                                        dens_type_lattice_printout_,
+                                        *state.Tmn);
           output->thermodynamics_lattice_output(
-              ThermodynamicQuantity::Tmn, *Tmn_, computational_frame_time);
+              ThermodynamicQuantity::Tmn, *state.Tmn, computational_frame_time);
         }
         if (printout_tmn_landau_) {
           output->thermodynamics_output(ThermodynamicQuantity::TmnLandau,
-                                        dens_type_lattice_printout_, *Tmn_);
+                                        dens_type_lattice_printout_,
+                                        *state.Tmn);
           output->thermodynamics_lattice_output(
-              ThermodynamicQuantity::TmnLandau, *Tmn_,
+              ThermodynamicQuantity::TmnLandau, *state.Tmn,
               computational_frame_time);
         }
         if (printout_v_landau_) {
           output->thermodynamics_output(ThermodynamicQuantity::LandauVelocity,
-                                        dens_type_lattice_printout_, *Tmn_);
+                                        dens_type_lattice_printout_,
+                                        *state.Tmn);
           output->thermodynamics_lattice_output(
-              ThermodynamicQuantity::LandauVelocity, *Tmn_,
+              ThermodynamicQuantity::LandauVelocity, *state.Tmn,
               computational_frame_time);
         }
       }
-      if (EM_lat_) {
-        output->fields_output("Efield", "Bfield", *EM_lat_);
+      if (state.EM_lat) {
+        output->fields_output("Efield", "Bfield", *state.EM_lat);
       }
       if (printout_j_QBS_) {
         output->thermodynamics_lattice_output(
-            *j_QBS_lat_, computational_frame_time, ensembles_, density_param_);
+            *state.j_QBS_lat, computational_frame_time, ensembles,
+            density_param_);
       }
 
       if (thermalizer_) {
@@ -2726,33 +5393,187 @@ void Experiment<Modus>::intermediate_output() {
   }
 }
 
+template <typename Modus>
+bool Experiment<Modus>::overlaps_output_times() const {
+  if (!overlap_output_times_ || thermalizer_) {
+    return false;
+  }
+  return std::none_of(intermediate_subscribers_.begin(),
+                      intermediate_subscribers_.end(), [&](std::size_t i) {
+                        return outputs_[i]->uses_interactions();
+                      });
+}
+
+template <typename Modus>
+void Experiment<Modus>::finish_output_time() {
+  if (!output_time_writer_.joinable()) {
+    return;
+  }
+  output_time_writer_.join();
+  if (output_time_error_) {
+    std::rethrow_exception(std::exchange(output_time_error_, nullptr));
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::follow_particles_with_lattices(bool force) {
+  if (lattice_adaptive_interval_ <= 0.) {
+    return;
+  }
+  const double now = parameters_.labclock->current_time();
+  if (!force && now < next_lattice_adaptation_time_) {
+    return;
+  }
+  next_lattice_adaptation_time_ = now + lattice_adaptive_interval_;
+  bool any_particle = false;
+  ThreeVector lower, upper;
+  for (const Particles &particles : ensembles_) {
+    for (const ParticleData &data : particles) {
+      const ThreeVector r = data.position().threevec();
+      if (!any_particle) {
+        lower = r;
+        upper = r;
+        any_particle = true;
+      }
+      for (int i = 0; i < 3; i++) {
+        lower[i] = std::min(lower[i], r[i]);
+        upper[i] = std::max(upper[i], r[i]);
+      }
+    }
+  }
+  if (!any_particle) {
+    return;
+  }
+  const ThreeVector margin(lattice_margin_, lattice_margin_, lattice_margin_);
+  lower -= margin;
+  upper += margin;
+  bool changed = false;
+  auto follow = [&](auto &lat) {
+    if (lat) {
+      changed = lat->follow(lower, upper, lattice_min_cells_) || changed;
+    }
+  };
+  follow(j_QBS_lat_);
+  follow(jmu_B_lat_);
+  follow(jmu_I3_lat_);
+  follow(jmu_el_lat_);
+  follow(fields_lat_);
+  follow(jmu_custom_lat_);
+  follow(jmu_interaction_lat_);
+  follow(UB_lat_);
+  follow(UI3_lat_);
+  follow(FB_lat_);
+  follow(FI3_lat_);
+  follow(EM_lat_);
+  follow(Tmn_);
+  follow(old_jmu_auxiliary_);
+  follow(old_fields_auxiliary_);
+  follow(new_fields_auxiliary_);
+  follow(fields_four_gradient_auxiliary_);
+  if (changed) {
+    logg[LExperiment].debug("Lattices moved to cover the box from ", lower,
+                            " to ", upper, " fm at t = ", now, " fm.");
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::adapt_timestep_duration(double dt,
+                                                std::size_t n_actions) {
+  TimeStepObservables observables;
+  observables.n_actions = n_actions;
+  for (const Particles &particles : ensembles_) {
+    observables.n_particles += particles.size();
+  }
+  // The lattices updated in every time step share their geometry.
+  for (const DensityLattice *lat :
+       {jmu_B_lat_.get(), jmu_I3_lat_.get(), jmu_el_lat_.get()}) {
+    if (lat) {
+      const std::array<double, 3> &sizes = lat->cell_sizes();
+      observables.min_lattice_spacing =
+          *std::min_element(sizes.begin(), sizes.end());
+      observables.max_velocity = max_velocity(ensembles_);
+      break;
+    }
+  }
+  for (const auto *forces : {FB_lat_.get(), FI3_lat_.get()}) {
+    if (forces) {
+      observables.max_force =
+          std::max(observables.max_force, max_force(*forces));
+    }
+  }
+  const double next_dt = adaptive_time_step_->next_timestep(dt, observables);
+  logg[LExperiment].debug("Next time step: ", next_dt, " fm (", n_actions,
+                          " actions in ", dt, " fm)");
+  // The lab clock of an event is always a UniformClock.
+  static_cast<UniformClock &>(*parameters_.labclock)
+      .set_timestep_duration(next_dt);
+}
+
+template <typename Modus>
+void Experiment<Modus>::detect_freeze_out(uint64_t n_scatterings, double dt) {
+  std::size_t n_particles = 0;
+  for (const Particles &particles : ensembles_) {
+    n_particles += particles.size();
+  }
+  if (n_scatterings < modus_.freeze_out_rate() * n_particles * dt) {
+    frozen_out_ = true;
+    logg[LExperiment].info("Freeze-out at ",
+                           parameters_.labclock->current_time(), " fm with ",
+                           n_scatterings, " scatterings of ", n_particles,
+                           " particles in the last time step.");
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::stream_freely(double t_end) {
+  while (next_output_time() < t_end) {
+    const double output_time = next_output_time();
+    for (Particles &particles : ensembles_) {
+      propagate_and_shine(output_time, particles, propagation_threads_);
+    }
+    ++(*parameters_.outputclock);
+    intermediate_output();
+  }
+  for (Particles &particles : ensembles_) {
+    propagate_and_shine(t_end, particles, propagation_threads_);
+  }
+  parameters_.labclock->reset(t_end, false);
+}
+
 template <typename Modus>
 void Experiment<Modus>::update_potentials() {
   if (potentials_) {
+    // the forces of the last update are reused in between
+    if (++timesteps_since_potentials_update_ < potentials_update_interval_) {
+      return;
+    }
+    ScopedTimer timer(profiler_, ProfiledPhase::LatticeUpdate);
+    // time since the last update, for the finite-difference time derivatives
+    const double dt = timesteps_since_potentials_update_ *
+                      parameters_.labclock->timestep_duration();
+    timesteps_since_potentials_update_ = 0;
+    follow_particles_with_lattices(false);
     if (potentials_->use_symmetry() && jmu_I3_lat_ != nullptr) {
       update_lattice(jmu_I3_lat_.get(), old_jmu_auxiliary_.get(),
-                     new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
                      LatticeUpdate::EveryTimestep, DensityType::BaryonicIsospin,
-                     density_param_, ensembles_,
-                     parameters_.labclock->timestep_duration(), true);
+                     density_param_, ensembles_, dt, true);
     }
     if ((potentials_->use_skyrme() || potentials_->use_symmetry()) &&
         jmu_B_lat_ != nullptr) {
       update_lattice(jmu_B_lat_.get(), old_jmu_auxiliary_.get(),
-                     new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
                      LatticeUpdate::EveryTimestep, DensityType::Baryon,
-                     density_param_, ensembles_,
-                     parameters_.labclock->timestep_duration(), true);
-      const size_t UBlattice_size = UB_lat_->size();
-      for (size_t i = 0; i < UBlattice_size; i++) {
-        auto jB = (*jmu_B_lat_)[i];
+                     density_param_, ensembles_, dt, true);
+      // The nodes are independent and evaluated on the smearing threads.
+      jmu_B_lat_->iterate_in_parallel(density_param_.threads(), [&](size_t i) {
+        const DensityOnLattice &jB = (*jmu_B_lat_)[i];
+        const double baryon_density = jB.rho();
         const FourVector flow_four_velocity_B =
-            std::abs(jB.rho()) > very_small_double ? jB.jmu_net() / jB.rho()
-                                                   : FourVector();
-        double baryon_density = jB.rho();
-        ThreeVector baryon_grad_j0 = jB.grad_j0();
-        ThreeVector baryon_dvecj_dt = jB.dvecj_dt();
-        ThreeVector baryon_curl_vecj = jB.curl_vecj();
+            std::abs(baryon_density) > very_small_double
+                ? jB.jmu_net() / baryon_density
+                : FourVector();
+        const ThreeVector baryon_grad_j0 = jB.grad_j0();
+        const ThreeVector baryon_dvecj_dt = jB.dvecj_dt();
+        const ThreeVector baryon_curl_vecj = jB.curl_vecj();
         if (potentials_->use_skyrme()) {
           (*UB_lat_)[i] =
               flow_four_velocity_B * potentials_->skyrme_pot(baryon_density);
@@ -2761,127 +5582,152 @@ void Experiment<Modus>::update_potentials() {
                                         baryon_dvecj_dt, baryon_curl_vecj);
         }
         if (potentials_->use_symmetry() && jmu_I3_lat_ != nullptr) {
-          auto jI3 = (*jmu_I3_lat_)[i];
+          const DensityOnLattice &jI3 = (*jmu_I3_lat_)[i];
+          const double isospin_density = jI3.rho();
           const FourVector flow_four_velocity_I3 =
-              std::abs(jI3.rho()) > very_small_double
-                  ? jI3.jmu_net() / jI3.rho()
+              std::abs(isospin_density) > very_small_double
+                  ? jI3.jmu_net() / isospin_density
                   : FourVector();
-          (*UI3_lat_)[i] = flow_four_velocity_I3 *
-                           potentials_->symmetry_pot(jI3.rho(), baryon_density);
+          (*UI3_lat_)[i] =
+              flow_four_velocity_I3 *
+              potentials_->symmetry_pot(isospin_density, baryon_density);
           (*FI3_lat_)[i] = potentials_->symmetry_force(
-              jI3.rho(), jI3.grad_j0(), jI3.dvecj_dt(), jI3.curl_vecj(),
+              isospin_density, jI3.grad_j0(), jI3.dvecj_dt(), jI3.curl_vecj(),
               baryon_density, baryon_grad_j0, baryon_dvecj_dt,
               baryon_curl_vecj);
         }
-      }
+      });
     }
     if (potentials_->use_coulomb()) {
       update_lattice(jmu_el_lat_.get(), LatticeUpdate::EveryTimestep,
                      DensityType::Charge, density_param_, ensembles_, true);
-      for (size_t i = 0; i < EM_lat_->size(); i++) {
-        ThreeVector electric_field = {0., 0., 0.};
-        ThreeVector position = jmu_el_lat_->cell_center(i);
-        jmu_el_lat_->integrate_volume(electric_field,
-                                      Potentials::E_field_integrand,
-                                      potentials_->coulomb_r_cut(), position);
-        ThreeVector magnetic_field = {0., 0., 0.};
-        jmu_el_lat_->integrate_volume(magnetic_field,
-                                      Potentials::B_field_integrand,
-                                      potentials_->coulomb_r_cut(), position);
-        (*EM_lat_)[i] = std::make_pair(electric_field, magnetic_field);
+      if (coulomb_solver_) {
+        coulomb_solver_->compute_fields(*jmu_el_lat_, *EM_lat_);
+      } else {
+        for (size_t i = 0; i < EM_lat_->size(); i++) {
+          ThreeVector electric_field = {0., 0., 0.};
+          ThreeVector position = jmu_el_lat_->cell_center(i);
+          jmu_el_lat_->integrate_volume(electric_field,
+                                        Potentials::E_field_integrand,
+                                        potentials_->coulomb_r_cut(), position);
+          ThreeVector magnetic_field = {0., 0., 0.};
+          jmu_el_lat_->integrate_volume(magnetic_field,
+                                        Potentials::B_field_integrand,
+                                        potentials_->coulomb_r_cut(), position);
+          (*EM_lat_)[i] = std::make_pair(electric_field, magnetic_field);
+        }
       }
     }  // if ((potentials_->use_skyrme() || ...
     if (potentials_->use_vdf() && jmu_B_lat_ != nullptr) {
       update_lattice(jmu_B_lat_.get(), old_jmu_auxiliary_.get(),
-                     new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
                      LatticeUpdate::EveryTimestep, DensityType::Baryon,
-                     density_param_, ensembles_,
-                     parameters_.labclock->timestep_duration(), true);
+                     density_param_, ensembles_, dt, true);
       if (parameters_.field_derivatives_mode == FieldDerivativesMode::Direct) {
         update_fields_lattice(
             fields_lat_.get(), old_fields_auxiliary_.get(),
             new_fields_auxiliary_.get(), fields_four_gradient_auxiliary_.get(),
-            jmu_B_lat_.get(), LatticeUpdate::EveryTimestep, *potentials_,
-            parameters_.labclock->timestep_duration());
+            jmu_B_lat_.get(), LatticeUpdate::EveryTimestep, *potentials_, dt);
       }
-      const size_t UBlattice_size = UB_lat_->size();
-      for (size_t i = 0; i < UBlattice_size; i++) {
-        auto jB = (*jmu_B_lat_)[i];
-        (*UB_lat_)[i] = potentials_->vdf_pot(jB.rho(), jB.jmu_net());
+      jmu_B_lat_->iterate_in_parallel(density_param_.threads(), [&](size_t i) {
+        const DensityOnLattice &jB = (*jmu_B_lat_)[i];
+        const double baryon_density = jB.rho();
+        const FourVector jmu_net = jB.jmu_net();
+        (*UB_lat_)[i] = potentials_->vdf_pot(baryon_density, jmu_net);
         switch (parameters_.field_derivatives_mode) {
           case FieldDerivativesMode::ChainRule:
             (*FB_lat_)[i] = potentials_->vdf_force(
-                jB.rho(), jB.drho_dxnu().x0(), jB.drho_dxnu().threevec(),
-                jB.grad_rho_cross_vecj(), jB.jmu_net().x0(), jB.grad_j0(),
-                jB.jmu_net().threevec(), jB.dvecj_dt(), jB.curl_vecj());
+                baryon_density, jB.drho_dxnu().x0(), jB.drho_dxnu().threevec(),
+                jB.grad_rho_cross_vecj(), jmu_net.x0(), jB.grad_j0(),
+                jmu_net.threevec(), jB.dvecj_dt(), jB.curl_vecj());
             break;
           case FieldDerivativesMode::Direct:
-            auto Amu = (*fields_lat_)[i];
+            const FieldsOnLattice &Amu = (*fields_lat_)[i];
             (*FB_lat_)[i] = potentials_->vdf_force(
                 Amu.grad_A0(), Amu.dvecA_dt(), Amu.curl_vecA());
             break;
         }
-      }  // for (size_t i = 0; i < UBlattice_size; i++)
+      });
     }    // if potentials_->use_vdf()
   }
 }
 
+template <typename Modus>
+void Experiment<Modus>::update_interaction_density_lattice() {
+  if (!jmu_interaction_lat_ || !interaction_density_needed_) {
+    return;
+  }
+  ScopedTimer timer(profiler_, ProfiledPhase::LatticeUpdate);
+  follow_particles_with_lattices(false);
+  update_lattice(jmu_interaction_lat_.get(), LatticeUpdate::EveryTimestep,
+                 dens_type_, density_param_, ensembles_, false);
+}
+
 template <typename Modus>
 void Experiment<Modus>::do_final_decays() {
+  const auto use_experiment = use_on_this_thread();
   /* At end of time evolution: Force all resonances to decay. In order to handle
-   * decay chains, we need to loop until no further actions occur. */
-  bool actions_performed, decays_found;
-  uint64_t interactions_old;
-  do {
-    decays_found = false;
-    interactions_old = interactions_total_;
-    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
-      Actions actions;
-
+   * decay chains, the products of the decays are searched again until no
+   * further actions occur. Only the first search covers all particles. */
+  const bool defer_output = ensemble_threads_ > 1;
+  for_each_ensemble([&](int i_ens) {
+    ParticleList search_list = ensembles_[i_ens].copy_to_vector();
+    while (!search_list.empty()) {
       // Dileptons: shining of remaining resonances
       if (dilepton_finder_ != nullptr) {
-        for (const auto &output : outputs_) {
-          dilepton_finder_->shine_final(ensembles_[i_ens], output.get(), true);
-        }
+        dilepton_finder_->shine_final(search_list, outputs_, true);
       }
       // Find actions.
+      Actions actions;
       for (const auto &finder : action_finders_) {
-        auto found_actions = finder->find_final_actions(ensembles_[i_ens]);
-        if (!found_actions.empty()) {
-          actions.insert(std::move(found_actions));
-          decays_found = true;
-        }
+        actions.insert(finder->find_final_actions(search_list));
       }
-      // Perform actions.
+      const bool decays_found = !actions.is_empty();
+      bool actions_performed = false;
+      // Perform actions and collect their products.
+      search_list.clear();
       while (!actions.is_empty()) {
-        perform_action(*actions.pop(), i_ens, false);
+        ActionPtr action = actions.pop();
+        double density = 0.0;
+        if (!perform_action(*action, i_ens, false,
+                            defer_output ? &density : nullptr)) {
+          continue;
+        }
+        actions_performed = true;
+        const ParticleList &outgoing = action->outgoing_particles();
+        search_list.insert(search_list.end(), outgoing.begin(), outgoing.end());
+        if (defer_output) {
+          deferred_interactions_[i_ens].emplace_back(std::move(action),
+                                                     density);
+        }
+      }
+      // Throw an error if actions were found but not performed
+      if (decays_found && !actions_performed) {
+        throw std::runtime_error("Final decays were found but not performed.");
       }
     }
-    actions_performed = interactions_total_ > interactions_old;
-    // Throw an error if actions were found but not performed
-    if (decays_found && !actions_performed) {
-      throw std::runtime_error("Final decays were found but not performed.");
-    }
-    // loop until no more decays occur
-  } while (actions_performed);
+  });
 
   // Dileptons: shining of stable particles at the end
   if (dilepton_finder_ != nullptr) {
-    for (const auto &output : outputs_) {
-      for (Particles &particles : ensembles_) {
-        dilepton_finder_->shine_final(particles, output.get(), false);
-      }
+    for (Particles &particles : ensembles_) {
+      dilepton_finder_->shine_final(particles.copy_to_vector(), outputs_,
+                                    false);
     }
   }
 }
 
 template <typename Modus>
 void Experiment<Modus>::final_output() {
+  const auto use_experiment = use_on_this_thread();
+  finish_output_time();
   /* make sure the experiment actually ran (note: we should compare this
    * to the start time, but we don't know that. Therefore, we check that
    * the time is positive, which should heuristically be the same). */
   double E_mean_field = 0.0;
   if (likely(parameters_.labclock > 0)) {
+    update_interaction_statistics();
+    logg[LExperiment].info("Interactions in the event: ",
+                           interaction_statistics_);
     const uint64_t wall_actions_this_interval =
         wall_actions_total_ - previous_wall_actions_total_;
     const uint64_t interactions_this_interval = interactions_total_ -
@@ -2903,7 +5749,8 @@ void Experiment<Modus>::final_output() {
     } else {
       logg[LExperiment].info() << format_measurements(
           ensembles_, interactions_this_interval, conserved_initial_,
-          time_start_, end_time_, E_mean_field, initial_mean_field_energy_);
+          current_conserved_quantities(), time_start_, end_time_,
+          E_mean_field, initial_mean_field_energy_);
     }
     int total_particles = 0;
     for (const Particles &particles : ensembles_) {
@@ -2989,6 +5836,7 @@ void Experiment<Modus>::final_output() {
   count_nonempty_ensembles();
 
   for (const auto &output : outputs_) {
+    ScopedTimer timer(profiler_, output_phase(output));
     for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
       auto event_info = fill_event_info(
           ensembles_, E_mean_field, modus_.impact_parameter(), parameters_,
@@ -3071,21 +5919,152 @@ void Experiment<Modus>::increase_event_number() {
 
 template <typename Modus>
 void Experiment<Modus>::run() {
-  const auto &mainlog = logg[LMain];
-  for (event_ = 0; !is_finished(); event_++) {
-    mainlog.info() << "Event " << event_;
+  run(0, 1);
+}
+
+template <typename Modus>
+void Experiment<Modus>::run(int first_event, int event_stride) {
+  begin_events(first_event, event_stride);
+  const auto use_experiment = use_on_this_thread();
+
+  if (!resume_path_.empty()) {
+    // The checkpoint determines the event and the seed of the run
+    run_event(true);
+    event_++;
+  }
+  for (; !is_finished(); event_ += event_stride) {
+    run_event();
+  }
+  finish_run();
+}
+
+template <typename Modus>
+void Experiment<Modus>::begin_events(int first_event, int event_stride) {
+  if (first_event < 0 || event_stride < 1) {
+    throw std::invalid_argument("Invalid selection of events to be run.");
+  }
+  if (event_stride > 1) {
+    if (event_counting_ != EventCounting::FixedNumber) {
+      throw std::invalid_argument(
+          "Events can only be shared among threads for a fixed number of "
+          "events (Nevents).");
+    }
+    /* Photon production relies on static state, which cannot be shared by
+     * concurrent events. */
+    if (photons_switch_ || bremsstrahlung_switch_) {
+      throw std::invalid_argument(
+          "Events cannot be run concurrently with photons.");
+    }
+  }
+  if ((checkpoint_interval_ > 0. || !resume_path_.empty()) &&
+      event_stride > 1) {
+    throw std::invalid_argument(
+        "Checkpoints cannot be used with events on several threads.");
+  }
+  event_stride_ = event_stride;
+  event_ = first_event;
+  pulled_event_ = false;
+  pulled_all_events_ = false;
+}
+
+template <typename Modus>
+bool Experiment<Modus>::run_next_event() {
+  if (pulled_all_events_) {
+    return false;
+  }
+  const auto use_experiment = use_on_this_thread();
+  if (!pulled_event_ && !resume_path_.empty()) {
+    // The checkpoint determines the event and the seed of the run
+    run_event(true);
+    pulled_event_ = true;
+    return true;
+  }
+  if (pulled_event_) {
+    event_ += event_stride_;
+  }
+  if (is_finished()) {
+    finish_run();
+    pulled_all_events_ = true;
+    return false;
+  }
+  run_event();
+  pulled_event_ = true;
+  return true;
+}
+
+template <typename Modus>
+void Experiment<Modus>::run(EventScheduler &scheduler) {
+  const auto use_experiment = use_on_this_thread();
+  /* The initial state of the next event is not known in advance and
+   * Minimum_Nonempty_Ensembles is counted by the scheduler. */
+  if (modus_.prefetch_depth() > 0) {
+    throw std::invalid_argument(
+        "Initial states cannot be prefetched with scheduled events.");
+  }
+  if (checkpoint_interval_ > 0. || !resume_path_.empty()) {
+    throw std::invalid_argument(
+        "Checkpoints cannot be used with scheduled events.");
+  }
+  scheduler.start({event_counting_, nevents_, minimum_nonempty_ensembles_,
+                   max_events_});
+  for (int event = scheduler.next_event(0); event >= 0;
+       event = scheduler.next_event(nonempty_ensembles_)) {
+    event_ = event;
+    // Only the ensembles with interactions of this event are reported
+    nonempty_ensembles_ = 0;
+    run_event();
+  }
+  finish_run();
+}
+
+template <typename Modus>
+void Experiment<Modus>::run_event(bool resume) {
+  log_startup_profile();
+  if (resume) {
+    resume_event();
+  } else {
+    logg[LMain].info() << "Event " << event_;
 
     // Sample initial particles, start clock, some printout and book-keeping
     initialize_new_event();
+  }
 
-    run_time_evolution(end_time_);
+  run_time_evolution(end_time_);
 
-    if (force_decays_) {
-      do_final_decays();
-    }
+  if (force_decays_) {
+    do_final_decays();
+  }
+
+  // Output at event end
+  final_output();
 
-    // Output at event end
-    final_output();
+  if (profiler_.enabled()) {
+    logg[LExperiment].info() << "Profile of event " << event_ << ":\n"
+                             << profiler_.end_event();
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::finish_run() {
+  if (profiler_.enabled()) {
+    logg[LExperiment].info() << "Profile of the run:\n"
+                             << profiler_.run_report();
+    if (!profile_path_.empty()) {
+      std::ofstream profile(profile_path_);
+      profiler_.write_json(profile);
+    }
+  }
+  if (action_cost_sampling_ > 0) {
+    logg[LExperiment].info() << "Sampled cost of the actions:\n"
+                             << action_cost_report(action_costs_);
+  }
+  if (profiler_.tracing()) {
+    std::ofstream trace(trace_path_);
+    profiler_.write_trace(trace);
+  }
+  if (MemoryTracker::enabled()) {
+    logg[LExperiment].info() << "Memory at the end of the run:\n"
+                             << MemoryTracker::report();
   }
 }
 
@@ -159,6 +159,19 @@ struct ExperimentParameters {
    * created.
    */
   std::optional<bool> use_monash_tune_default;
+
+  /**
+   * Number of subensembles, into which the test particles of an ensemble are
+   * divided. Particles only interact within their subensemble, while the
+   * densities and mean fields are computed from all of them.
+   */
+  int n_subensembles = 1;
+
+  /**
+   * Number of threads of the ensembles, which also sample the initial
+   * conditions, see the Ensemble_Threads key.
+   */
+  int n_threads = 1;
 };
 
 }  // namespace smash
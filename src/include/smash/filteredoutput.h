@@ -0,0 +1,118 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_FILTEREDOUTPUT_H_
+#define SRC_INCLUDE_SMASH_FILTEREDOUTPUT_H_
+
+#include <memory>
+
+#include "outputinterface.h"
+#include "outputparameters.h"
+#include "particles.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Output that hands only the particles selected by a ParticleOutputFilter
+ * over to another output, e.g. only charged hadrons at midrapidity.
+ *
+ * The particle lists at event start, at event end and at intermediate times
+ * are copied into a list kept by this output, from which the rejected
+ * particles are removed, so the wrapped output formats and counts only the
+ * selected ones. The particles keep their ids. Interactions are forwarded
+ * unchanged.
+ *
+ * Only the callbacks of particle lists and interactions are forwarded, hence
+ * only outputs of the particles content should be filtered.
+ */
+class FilteredOutput : public OutputInterface {
+ public:
+  /**
+   * Select the particles given to an output.
+   *
+   * \param[in] output Output which writes the selected particles.
+   * \param[in] filter Selection of the particles.
+   */
+  FilteredOutput(std::unique_ptr<OutputInterface> output,
+                 const ParticleOutputFilter &filter);
+
+  /**
+   * Forward the selected particles at event start.
+   * \param[in] particles Current list of all particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &info) override;
+
+  /**
+   * Forward the selected particles at event end.
+   * \param[in] particles Current list of particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+
+  /**
+   * Forward an interaction.
+   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] density Density at the interaction point.
+   */
+  void at_interaction(const Action &action, const double density) override;
+
+  /**
+   * Forward the selected particles at an intermediate time.
+   * \param[in] particles Current list of particles.
+   * \param[in] clock Clock of the output times.
+   * \param[in] dens_param Parameters for the density calculation.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &info) override;
+
+  /// \return Whether the wrapped output uses the interactions.
+  bool uses_interactions() const override {
+    return output_->uses_interactions();
+  }
+  /// \return Whether the wrapped output uses the interaction density.
+  bool uses_interaction_density() const override {
+    return output_->uses_interaction_density();
+  }
+  /// \return Whether the wrapped output uses the output times.
+  bool uses_intermediate_times() const override {
+    return output_->uses_intermediate_times();
+  }
+
+ private:
+  /**
+   * Copy the selected particles into selected_.
+   *
+   * \param[in] particles All particles
+   * \return the selected particles
+   */
+  const Particles &select(const Particles &particles);
+
+  /// Output writing the selected particles
+  std::unique_ptr<OutputInterface> output_;
+
+  /// Selection of the particles
+  ParticleOutputFilter filter_;
+
+  /// Selected particles, whose storage is reused for every list
+  std::unique_ptr<Particles> selected_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_FILTEREDOUTPUT_H_
@@ -55,6 +55,7 @@ class ScatterActionMulti;
 class BoxModus;
 class Clock;
 class Configuration;
+class CrossSectionCache;
 class CrossSections;
 class DecayModes;
 class DecayType;
@@ -144,6 +145,8 @@ enum class TimeStepMode : char {
   None,
   /// Use fixed time step.
   Fixed,
+  /// Adapt the time step to the state of the system after every time step.
+  Adaptive,
 };
 
 /**
@@ -338,6 +341,30 @@ enum class PseudoResonance {
   ClosestFromUnstable,
 };
 
+/**
+ * Policy of binding the threads evolving the ensembles to the cores of the
+ * NUMA nodes. \see_key{key_gen_thread_affinity_}
+ */
+enum class ThreadAffinity {
+  /// Threads are not bound
+  None,
+  /// Threads fill the cores of one NUMA node before using the next node
+  Compact,
+  /// Threads are distributed round-robin over the NUMA nodes
+  Scatter,
+};
+
+/**
+ * How the density at the interaction points is evaluated.
+ * \see_key{key_output_interaction_density_}
+ */
+enum class InteractionDensityMode {
+  /// Smeared density of all particles of the ensemble
+  Exact,
+  /// Density of all ensembles at the nearest node of an auxiliary lattice
+  Lattice,
+};
+
 /// @cond
 using ActionPtr = build_unique_ptr_<Action>;
 using ScatterActionPtr = build_unique_ptr_<ScatterAction>;
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "angles.h"
+#include "boltzmannsampling.h"
 #include "clock.h"
 #include "configuration.h"
 #include "density.h"
@@ -70,6 +71,9 @@ class ThermLatticeNode {
    * Temperature, chemical potentials and rest frame velocity are
    * calculated given the hadron gas equation of state object
    * \param[in] eos \see HadronGasEos based on Tmu0, nb, ns and nq
+   * \param[in] neighbour A node with already computed rest frame quantities,
+   *            typically a neighbouring one, whose solution the equation of
+   *            state solver starts from, or nullptr
    * \return Temperature T, net baryon chemical potential mub,
    * net strangeness chemical potential mus, net charge chemical potential muq
    * and the velocity of the Landau rest frame, under assumption that the
@@ -78,7 +82,8 @@ class ThermLatticeNode {
    * frame transformation is that it conserves energy and momentum, even
    * though the dissipative part of the energy-momentum tensor is neglected.
    */
-  void compute_rest_frame_quantities(HadronGasEos& eos);
+  void compute_rest_frame_quantities(
+      const HadronGasEos& eos, const ThermLatticeNode* neighbour = nullptr);
   /**
    * Set all the rest frame quantities to some values, this is useful
    * for testing.
@@ -264,12 +269,20 @@ class GrandCanThermalizer {
    * HadronClass \param[out] N Number of particles to be sampled
    */
   void sample_multinomial(HadronClass particle_class, int N);
+  /**
+   * Computes the average number of particles of every species in the cells
+   * to be sampled for the BF algorithm, from the partial densities of all
+   * species in one sweep over the cells on all hardware threads, and stores
+   * them summed up over the cells in N_cumulative_in_cells_.
+   */
+  void compute_N_in_cells_BF_algo();
   /**
    * The total number of particles of species type_index is defined by mult_int_
    * array that is returned by \see sample_multinomial.
    * This function samples mult_int_[type_index] particles. It chooses
-   * randomly the cell to sample and picks up momentum and coordinate from the
-   * corresponding distributions.
+   * randomly the cell to sample by a binary search in the numbers of particles
+   * summed up over the cells, \see compute_N_in_cells_BF_algo, and picks up
+   * momentum and coordinate from the corresponding distributions.
    * \param[out] plist \see ParticleList of newly produced particles
    * \param[in] time Current time in the simulation to become zero component of
    * sampled particles
@@ -367,7 +380,8 @@ class GrandCanThermalizer {
     // Position
     particle.set_4position(FourVector(time, cell_center + uniform_in_cell()));
     // Momentum
-    double momentum_radial = sample_momenta_from_thermal(cell.T(), m);
+    double momentum_radial =
+        ThermalMomentumSampling::instance().sample(cell.T(), m);
     Angles phitheta;
     phitheta.distribute_isotropically();
     particle.set_4momentum(m, phitheta.threevec() * momentum_radial);
@@ -448,6 +462,12 @@ class GrandCanThermalizer {
   }
   /// Number of particles to be sampled in one cell
   std::vector<double> N_in_cells_;
+  /**
+   * Number of particles of every species to be sampled in the cells up to
+   * and including a cell, for the BF algorithm. The entry of species i and
+   * cell k is at i * cells_to_sample_.size() + k.
+   */
+  std::vector<double> N_cumulative_in_cells_;
   /// Cells above critical energy density
   std::vector<size_t> cells_to_sample_;
   /// Hadron gas equation of state
@@ -495,6 +515,8 @@ class GrandCanThermalizer {
   const ThermalizationAlgorithm algorithm_;
   /// Enforce energy conservation as part of BF sampling algorithm or not
   const bool BF_enforce_microcanonical_;
+  /// Number of threads of the density smearing, also used for the sampling
+  int n_threads_ = 1;
 };
 
 }  // namespace smash
@@ -11,8 +11,13 @@
 #define SRC_INCLUDE_SMASH_GRID_H_
 
 #include <array>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -60,6 +65,85 @@ enum class CellNumberLimitation : char {
   ParticleNumber
 };
 
+/**
+ * Occupancy of a grid after placing the particles, as measured by
+ * Grid::statistics.
+ */
+struct GridStatistics {
+  /// Number of cells of all layers, including empty ones
+  std::int64_t cells = 0;
+  /// Number of layers of cells
+  std::int64_t layers = 1;
+  /// Number of particles on the grid
+  std::int64_t particles = 0;
+  /// Number of pairs of particles in the same or in neighboring cells
+  std::int64_t pair_candidates = 0;
+  /// Number of pairs if every layer was a single cell
+  std::int64_t single_cell_pairs = 0;
+  /// Volume of the grid [fm³]
+  double volume = 0.;
+  /// Volume of a cell [fm³]
+  double cell_volume = 0.;
+  /// Whether the particles are sorted into cells or into one list per layer
+  bool binned = false;
+  /// Largest possible cell length [fm], finite for periodic boundaries
+  double max_cell_length = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * Chooses the cell length of a grid and whether to use cells at all from the
+ * occupancy of the grid in the previous time step.
+ *
+ * The time to search interactions on a grid is modelled as the number of pair
+ * candidates plus the number of visited cells times \ref cell_cost. Small
+ * cells keep the pair candidates low in dense systems, but many nearly empty
+ * cells cost more than the few pairs they save in dilute systems. The cell
+ * length is therefore chosen among multiples \f$2^{j/3}\f$ of the minimal
+ * length required by the physics, up to \ref max_scale times that length, or
+ * a single cell is used. The pair candidates at another cell length are
+ * predicted from the measured ones, proportional to the volume searched for
+ * every particle, which takes the clustering of the particles into account.
+ * To avoid switching back and forth, the choice only changes if its predicted
+ * time is lower than the measured one by more than \ref hysteresis.
+ */
+class AdaptiveCellSizer {
+ public:
+  /// Largest cell length in units of the minimal cell length
+  static constexpr double max_scale = 4.;
+  /// Time to visit a cell in units of the time to check a pair candidate
+  static constexpr double cell_cost = 4.;
+  /// Relative gain of the predicted time required to change the cell length
+  static constexpr double hysteresis = 0.2;
+
+  /**
+   * \param[in] min_cell_length Minimal cell length required by the physics
+   * \return cell length to use [fm]
+   */
+  double cell_length(double min_cell_length) const {
+    return scale_ * min_cell_length;
+  }
+
+  /// \return strategy to create the grid with, Largest for a single cell
+  CellSizeStrategy strategy() const {
+    return single_cell_ ? CellSizeStrategy::Largest
+                        : CellSizeStrategy::Optimal;
+  }
+
+  /**
+   * Choose the cell length for the next time step.
+   *
+   * \param[in] stats Occupancy of the grid created with the current choice
+   * \param[in] min_cell_length Minimal cell length required by the physics
+   */
+  void record(const GridStatistics &stats, double min_cell_length);
+
+ private:
+  /// Cell length in units of the minimal cell length
+  double scale_ = 1.;
+  /// Whether a single cell is used instead of a grid
+  bool single_cell_ = false;
+};
+
 /**
  * Base class for Grid to host common functions that do not depend on the
  * GridOptions parameter.
@@ -78,6 +162,14 @@ class GridBase {
    */
   static std::pair<std::array<double, 3>, std::array<double, 3>>
   find_min_and_length(const Particles &particles);
+
+  /**
+   * \return the index of the storage of the particle in Particles, which
+   * identifies the particle while the grid is kept between time steps.
+   *
+   * \param[in] p A valid copy of a particle in Particles
+   */
+  static unsigned storage_index(const ParticleData &p) { return p.index_; }
 };
 
 /**
@@ -134,7 +226,7 @@ class Grid : public GridBase {
    * \param[in] timestep_duration Duration of the timestep in fm.
    * \param[in] limit Limitation of cell number.
    * \param[in] include_unformed_particles include unformed particles from
-                                           the grid (worsens runtime).
+   *                                       the grid (worsens runtime).
    * \param[in] strategy The strategy for determining the cell size.
    * \throws runtime_error if your box length is smaller than the grid length.
    */
@@ -143,7 +235,41 @@ class Grid : public GridBase {
        const Particles &particles, double min_cell_length,
        double timestep_duration, CellNumberLimitation limit,
        const bool include_unformed_particles = false,
-       CellSizeStrategy strategy = CellSizeStrategy::Optimal);
+       CellSizeStrategy strategy = CellSizeStrategy::Optimal) {
+    update(min_and_length, particles, min_cell_length, timestep_duration,
+           limit, include_unformed_particles, strategy);
+  }
+
+  /**
+   * Places the current state of the given particles onto the grid, with the
+   * same arguments as the constructor Grid(const Particles &, ...).
+   *
+   * The grid is meant to be kept between time steps: the storage of the cells
+   * is reused and, if the geometry of the grid did not change, only the
+   * particles that moved to another cell or were created or removed are
+   * re-binned, the others are updated in place.
+   */
+  void update(const Particles &particles, double min_cell_length,
+              double timestep_duration, CellNumberLimitation limit,
+              const bool include_unformed_particles = false,
+              CellSizeStrategy strategy = CellSizeStrategy::Optimal) {
+    update(find_min_and_length(particles), particles, min_cell_length,
+           timestep_duration, limit, include_unformed_particles, strategy);
+  }
+
+  /**
+   * Places the current state of the given particles onto the grid, with the
+   * same arguments as the constructor Grid(const std::pair<...> &, ...).
+   *
+   * \see update(const Particles &, double, double, CellNumberLimitation,
+   *             const bool, CellSizeStrategy)
+   */
+  void update(const std::pair<std::array<double, 3>, std::array<double, 3>>
+                  &min_and_length,
+              const Particles &particles, double min_cell_length,
+              double timestep_duration, CellNumberLimitation limit,
+              const bool include_unformed_particles = false,
+              CellSizeStrategy strategy = CellSizeStrategy::Optimal);
 
   /**
    * Iterates over all cells in the grid and calls the callback arguments with
@@ -154,6 +280,12 @@ class Grid : public GridBase {
    * - three cells (x-1,x,x+1) at y+1
    * - nine cells (x-1, y-1)...(x+1, y+1) at z+1
    *
+   * Without periodic boundaries, the search cells of a layer are visited in
+   * Morton (Z-)order, such that consecutive search cells are close in space
+   * and share most of their neighbor cells, and the neighbor cells are
+   * looked up in stencils precomputed for the geometry of the grid. The
+   * neighbor cell callback is only called if both cells contain particles.
+   *
    * \param[in] search_cell_callback A callable called for/with every non-empty
    *                                 cell in the grid.
    * \param[in] neighbor_cell_callback A callable called for/with every
@@ -166,12 +298,216 @@ class Grid : public GridBase {
       const std::function<void(const ParticleList &, const ParticleList &)>
           &neighbor_cell_callback) const;
 
+  /**
+   * Iterates over the same cell combinations as iterate_cells, distributed
+   * over several threads.
+   *
+   * The cells are divided into 27 colours by their indices modulo 3 in every
+   * direction. The colours are processed one after the other, and the cells of
+   * one colour concurrently. Cells processed at the same time are at least
+   * three cells apart, such that they never share a neighbor cell. The order
+   * of the calls within a colour is not determined, but the neighbor cell
+   * callbacks of a search cell directly follow its search cell callback on
+   * the same thread. On grids with periodic boundaries, the up to two cells
+   * left over at the upper end of a direction get colours of their own, such
+   * that the cells of one colour are also three cells apart across the
+   * boundary, and the search cells are translated as in iterate_cells.
+   *
+   * \param[in] n_threads Maximal number of threads
+   * \param[in] search_cell_callback A callable called with the index of the
+   *                                 thread (from 0 to n_threads - 1) and every
+   *                                 cell in the grid.
+   * \param[in] neighbor_cell_callback A callable called with the index of the
+   *                                   thread and every combination of two
+   *                                   non-empty adjacent cells.
+   * \throws the first exception thrown by a callback, after all threads
+   *         finished
+   */
+  void iterate_cells_in_parallel(
+      int n_threads,
+      const std::function<void(int, const ParticleList &)>
+          &search_cell_callback,
+      const std::function<void(int, const ParticleList &,
+                               const ParticleList &)> &neighbor_cell_callback)
+      const;
+
+  /**
+   * Iterates over the same cell combinations as iterate_cells, but without
+   * copying particles. The neighbor cell callback receives the particles of
+   * the search cell as they are stored, together with the shift by which they
+   * have to be translated to be close to the neighbor cell (minimum image).
+   * The shift is only nonzero across the boundaries of a periodic grid.
+   *
+   * \param[in] search_cell_callback A callable called for/with every non-empty
+   *                                 cell in the grid.
+   * \param[in] neighbor_cell_callback A callable called for/with every
+   *                              non-empty cell, the shift of its particles
+   *                              and an adjacent cell.
+   */
+  void iterate_cells_with_shifts(
+      const std::function<void(const ParticleList &)> &search_cell_callback,
+      const std::function<void(const ParticleList &, const ThreeVector &,
+                               const ParticleList &)> &neighbor_cell_callback)
+      const;
+
+  /**
+   * Places the current state of a particle, which was created or changed by
+   * an action since the last update, onto the grid, such that it is found by
+   * iterate_surroundings. A particle outside of the grid is placed into the
+   * closest cell. Copies of particles removed since the last update stay on
+   * the grid until the next update.
+   *
+   * \param[in] p The current state of the particle in Particles
+   * \throws std::logic_error if the particles are not sorted into cells, see
+   *         binned()
+   */
+  void place(const ParticleData &p);
+
+  /**
+   * Calls \p callback with the copies of all particles in the cells which
+   * overlap with the cube of half side length \p radius around \p position.
+   *
+   * The copies describe the state of the particles when they were placed onto
+   * the grid, i.e. they can be outdated or even removed from Particles.
+   *
+   * \param[in] position The center of the searched cube
+   * \param[in] radius Half the side length of the searched cube
+   * \param[in] callback A callable called for/with every copy
+   * \throws std::logic_error if the particles are not sorted into cells, see
+   *         binned()
+   */
+  void iterate_surroundings(
+      const ThreeVector &position, double radius,
+      const std::function<void(const ParticleData &)> &callback) const;
+
+  /**
+   * \return whether the particles are sorted into cells, which is not the
+   * case for the single cell fallbacks.
+   */
+  bool binned() const { return binned_; }
+
   /**
    * \return the volume of a single grid cell
    */
   double cell_volume() const { return cell_volume_; }
 
+  /**
+   * Measure the occupancy of the grid, e.g. for an AdaptiveCellSizer.
+   *
+   * \return numbers of cells, particles and pair candidates
+   */
+  GridStatistics statistics() const;
+
+  /**
+   * Leave the particles for which \p is_excluded returns true out of the grid
+   * from the next update on. An empty function places all particles again.
+   *
+   * \param[in] is_excluded Predicate selecting the particles to leave out
+   */
+  void set_exclusion(std::function<bool(const ParticleData &)> is_excluded) {
+    is_excluded_ = std::move(is_excluded);
+  }
+
+  /**
+   * Keep a list of the particles for which \p is_member returns true for
+   * every cell, e.g. of the few particles that can take part in
+   * multi-particle reactions, so that they are found without visiting the
+   * whole cell, see members_of(). The lists are collected right away and at
+   * every update. An empty function stops collecting them.
+   *
+   * \param[in] is_member Predicate selecting the members
+   */
+  void set_member_selection(
+      std::function<bool(const ParticleData &)> is_member) {
+    is_member_ = std::move(is_member);
+    collect_members();
+  }
+
+  /// \return whether lists of members are kept, see set_member_selection()
+  bool selects_members() const { return static_cast<bool>(is_member_); }
+
+  /**
+   * \return the selected members of a cell, in the order of the cell, as
+   * collected at the last update.
+   *
+   * \param[in] cell A search cell passed to the callbacks of iterate_cells,
+   *            iterate_cells_in_parallel or iterate_cells_with_shifts
+   * \note This function may only be called if selects_members().
+   */
+  const ParticleList &members_of(const ParticleList &cell) const {
+    assert(selects_members());
+    const std::ptrdiff_t index = &cell - cells_.data();
+    assert(index >= 0 &&
+           index < static_cast<std::ptrdiff_t>(members_.size()));
+    return members_[index];
+  }
+
+  /**
+   * Sort the particles into \p n_layers separate layers of cells by their
+   * subensemble (ParticleData::subensemble modulo \p n_layers) from the next
+   * update on. All layers have the same geometry, and particles of different
+   * layers are never passed together to the callbacks of iterate_cells.
+   *
+   * \param[in] n_layers Number of layers
+   * \throws std::invalid_argument if \p n_layers is not positive
+   */
+  void set_layers(int n_layers) {
+    if (n_layers <= 0) {
+      throw std::invalid_argument("The grid needs at least one layer.");
+    }
+    if (n_layers != n_layers_) {
+      n_layers_ = n_layers;
+      // The particles have to be sorted into the layers again.
+      binned_ = false;
+    }
+  }
+
  private:
+  /// \return the number of cells of one layer
+  SizeType cells_per_layer() const {
+    return number_of_cells_[0] * number_of_cells_[1] * number_of_cells_[2];
+  }
+
+  /**
+   * \return the index of the first cell of the layer of particle \p p
+   *
+   * \param[in] p The particle
+   */
+  SizeType layer_offset(const ParticleData &p) const {
+    return static_cast<SizeType>(p.subensemble() % n_layers_) *
+           cells_per_layer();
+  }
+
+  /**
+   * Determine the order of the search cells and the stencils of their
+   * neighbor cells for the current number of cells, if it changed.
+   */
+  void prepare_cell_order();
+
+  /// Collect the members of every cell, see set_member_selection().
+  void collect_members();
+
+  /**
+   * Place the particles for which \p is_placed returns true into the single
+   * cell of their layer, for the fallbacks without binning.
+   *
+   * \param[in] particles The particles to place onto the grid.
+   * \param[in] is_placed Predicate selecting the particles to place
+   */
+  template <typename F>
+  void fill_single_cells(const Particles &particles, const F &is_placed) {
+    cells_.resize(n_layers_);
+    for (ParticleList &cell : cells_) {
+      cell.clear();
+      cell.reserve(particles.size() / n_layers_);
+    }
+    for (const ParticleData &p : particles) {
+      if (is_placed(p)) {
+        cells_[p.subensemble() % n_layers_].push_back(p);
+      }
+    }
+  }
+
   /**
    * \return the one-dimensional cell-index from the 3-dim index \p x, \p y, \p
    * z.
@@ -186,17 +522,165 @@ class Grid : public GridBase {
     return make_index(idx[0], idx[1], idx[2]);
   }
 
+  /**
+   * Calls the callbacks of iterate_cells_with_shifts for one search cell of a
+   * grid with periodic boundaries, in the same order.
+   *
+   * \param[in] offset Index of the first cell of the layer
+   * \param[in] search_index 3-dim index of the search cell within the layer
+   * \param[in] search_cell_callback Called with the search cell
+   * \param[in] neighbor_cell_callback Called with the search cell, the shift
+   *                                   of its particles and every neighbor cell
+   */
+  template <typename S, typename N>
+  void visit_periodic_cell(SizeType offset,
+                           const std::array<SizeType, 3> &search_index,
+                           const S &search_cell_callback,
+                           const N &neighbor_cell_callback) const;
+
+  /**
+   * Place all particles again onto the grid with the current geometry.
+   *
+   * \param[in] particles The particles to place onto the grid.
+   * \param[in] timestep_duration Duration of the timestep in fm.
+   * \param[in] include_unformed_particles include unformed particles
+   */
+  void rebin_all(const Particles &particles, double timestep_duration,
+                 bool include_unformed_particles);
+
+  /**
+   * Only move the particles, which changed their cell or were created or
+   * removed since the last call of update, and update all others in place.
+   *
+   * \param[in] particles The particles to place onto the grid.
+   * \param[in] timestep_duration Duration of the timestep in fm.
+   * \param[in] include_unformed_particles include unformed particles
+   */
+  void rebin_changed(const Particles &particles, double timestep_duration,
+                     bool include_unformed_particles);
+
+  /**
+   * \return the index of the cell of particle \p p, or -1 if the particle is
+   * not placed onto the grid.
+   *
+   * \param[in] p The particle
+   * \param[in] timestep_duration Duration of the timestep in fm.
+   * \param[in] include_unformed_particles include unformed particles
+   */
+  SizeType cell_index_for(const ParticleData &p, double timestep_duration,
+                          bool include_unformed_particles) const;
+
+  /**
+   * \return the index of the cell along the axis \p axis for the coordinate
+   * \p coordinate, clamped to the cells of the grid.
+   *
+   * \param[in] coordinate The coordinate along the axis
+   * \param[in] axis 0, 1 or 2 for x, y or z
+   */
+  SizeType clamped_cell_coordinate(double coordinate, int axis) const;
+
+  /**
+   * Replace the uniform cells along the beam axis by slabs that follow the
+   * occupied parts of the grid, if that needs fewer cells, and allow
+   * correspondingly more cells in the transverse plane.
+   *
+   * The particles are sorted into bins of a quarter of the cell length along
+   * z. A new slab starts at the first occupied bin at least one cell length
+   * after the start of the previous slab, or where an empty gap of at least
+   * one cell length begins. All slabs but the last are thus at least one cell
+   * length wide, so the neighboring cells still contain all interaction
+   * partners, while the empty space between two approaching nuclei collapses
+   * into a single slab.
+   *
+   * \param[in] particles The particles to place onto the grid.
+   * \param[in] max_interaction_length The minimal length of a cell.
+   * \param[in] max_cells The limit of the number of cells per direction.
+   */
+  void sweep_beam_axis(const Particles &particles,
+                       double max_interaction_length, int max_cells);
+
+  /**
+   * Remove the copy of the particle stored at \p slot in Particles from its
+   * cell.
+   *
+   * \param[in] slot Storage index of the particle.
+   */
+  void remove_from_cell(unsigned slot);
+
   /// The 3 lengths of the complete grid. Used for periodic boundary wrapping.
-  const std::array<double, 3> length_;
+  std::array<double, 3> length_;
+
+  /// The minimum x,y,z coordinates of the grid.
+  std::array<double, 3> min_position_ = {0., 0., 0.};
+
+  /// The factors converting a position into the 3-dim cell index.
+  std::array<double, 3> index_factor_ = {0., 0., 0.};
 
   /// The volume of a single cell.
   double cell_volume_;
 
   /// The number of cells in x, y, and z direction.
-  std::array<int, 3> number_of_cells_;
+  std::array<int, 3> number_of_cells_ = {0, 0, 0};
 
-  /// The cell storage.
+  /**
+   * The slab along z for every bin of index_factor_[2], if the beam axis is
+   * divided into slabs by sweep_beam_axis, empty for uniform cells.
+   */
+  std::vector<SizeType> z_slab_of_bin_;
+
+  /// The cell storage, the layers one after the other.
   std::vector<ParticleList> cells_;
+
+  /// Number of layers of cells, see set_layers
+  int n_layers_ = 1;
+
+  /// A search cell of a layer, in the order of iterate_cells
+  struct OrderedCell {
+    /// Index of the cell within its layer
+    SizeType index;
+    /// Index of the stencil of the neighbor cells in stencils_
+    std::uint8_t stencil;
+    /// Colour of the cell for iterate_cells_in_parallel, from 0 to 26
+    std::uint8_t colour;
+  };
+
+  /// The cells of a layer in Morton order, see iterate_cells
+  std::vector<OrderedCell> cell_order_;
+
+  /// Number of cells in each direction for which cell_order_ was prepared
+  std::array<int, 3> ordered_number_of_cells_ = {0, 0, 0};
+
+  /**
+   * Offsets of the neighbor cells from the search cell, for the 64
+   * combinations of a search cell lying at the lower, the upper, both or
+   * no boundaries in the three directions
+   */
+  std::array<std::vector<SizeType>, 64> stencils_;
+
+  /**
+   * Whether the particles are binned with min_position_ and index_factor_,
+   * such that the bookkeeping below can be used to only re-bin particles that
+   * changed. False for the single cell fallbacks.
+   */
+  bool binned_ = false;
+
+  /// Cell of the particle at a given storage index in Particles (-1: none)
+  std::vector<SizeType> slot_cell_;
+
+  /// Position of the particle at a given storage index within its cell
+  std::vector<unsigned> slot_position_;
+
+  /// Id of the particle at a given storage index, when it was placed
+  std::vector<int32_t> slot_id_;
+
+  /// Predicate selecting the particles left out of the grid, if any
+  std::function<bool(const ParticleData &)> is_excluded_;
+
+  /// Predicate selecting the members listed for every cell, if any
+  std::function<bool(const ParticleData &)> is_member_;
+
+  /// Selected members of every cell, in the order of cells_
+  std::vector<ParticleList> members_;
 };
 
 }  // namespace smash
@@ -10,6 +10,7 @@
 #define SRC_INCLUDE_SMASH_HADGAS_EOS_H_
 
 #include <array>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -19,6 +20,7 @@
 
 #include "constants.h"
 #include "particletype.h"
+#include "sha256.h"
 
 namespace smash {
 
@@ -71,12 +73,17 @@ class EosTable {
    * Computes the actual content of the table (for EosTable description see
    * documentation of the constructor).
    *
+   * The table is read from the save file if it was compiled for the same
+   * grid and hadrons, which is checked with a hash stored in the file.
+   * Otherwise the energy density slices of the table are solved on all
+   * hardware threads and the table is saved in a binary file.
+   *
    * \param[in] eos equation of state
    * \param[in] eos_savefile_name name of the file to save tabulated equation
    *            of state
    */
-  void compile_table(HadronGasEos& eos,
-                     const std::string& eos_savefile_name = "hadgas_eos.dat");
+  void compile_table(const HadronGasEos& eos,
+                     const std::string& eos_savefile_name = "hadgas_eos.bin");
   /**
    * Obtain interpolated p/T/muB/muS/muQ from the tabulated equation of state
    * given energy density, net baryon density and net charge density
@@ -93,6 +100,40 @@ class EosTable {
   size_t index(size_t ie, size_t inb, size_t inq) const {
     return n_q_ * (ie * n_nb_ + inb) + inq;
   }
+  /**
+   * Hash of everything the content of the table depends on: the grid, the
+   * hadrons and whether their widths are accounted for.
+   *
+   * \param[in] eos equation of state
+   * \return The hash.
+   */
+  sha256::Hash hash(const HadronGasEos& eos) const;
+  /**
+   * Read the table from a binary file.
+   *
+   * \param[in] filename name of the file
+   * \param[in] hash hash the table has to be compiled with
+   * \return Whether a complete table with the given hash was read.
+   */
+  bool read(const std::string& filename, const sha256::Hash& hash);
+  /**
+   * Write the table into a binary file, replacing it atomically.
+   *
+   * \param[in] filename name of the file
+   * \param[in] hash hash the table was compiled with
+   * \throw std::runtime_error if the file cannot be written
+   */
+  void write(const std::string& filename, const sha256::Hash& hash) const;
+  /**
+   * Solve the equation of state for all nodes of one energy density.
+   *
+   * The initial approximations are extrapolated only within the slice, so
+   * that slices can be compiled independently.
+   *
+   * \param[in] eos equation of state used to solve
+   * \param[in] ie index of the energy density
+   */
+  void compile_slice(const HadronGasEos& eos, size_t ie);
   /// Storage for the tabulated equation of state
   std::vector<table_element> table_;
   /// Step in energy density
@@ -109,6 +150,67 @@ class EosTable {
   size_t n_q_;
 };
 
+/**
+ * Table of the Bessel functions in the thermal densities of a Boltzmann gas,
+ * \f$ z^2 e^z K_2(z) \f$ and \f$ z^3 e^z K_1(z) \f$ as functions of
+ * \f$ z = m/T \f$.
+ *
+ * The functions and their derivatives are tabulated on a uniform grid up to
+ * \f$ z = 64 \f$ and interpolated with cubic Hermite polynomials, which
+ * keeps the relative error below \f$ 10^{-9} \f$. Larger arguments are
+ * computed directly. The table is built at its first use and
+ * shared by all threads.
+ */
+class ScaledBesselTable {
+ public:
+  /// \return The table, built at the first call.
+  static const ScaledBesselTable& get();
+
+  /**
+   * \param[in] z mass to temperature ratio \f$ m/T \f$, not negative
+   * \return \f$ z^2 e^z K_2(z) \f$
+   */
+  double density_factor(double z) const {
+    double k2, k1;
+    evaluate(z, k2, k1);
+    return k2;
+  }
+
+  /**
+   * \param[in] z mass to temperature ratio \f$ m/T \f$, not negative
+   * \return \f$ z^2 e^z (3 K_2(z) + z K_1(z)) \f$
+   */
+  double energy_factor(double z) const {
+    double k2, k1;
+    evaluate(z, k2, k1);
+    return 3.0 * k2 + k1;
+  }
+
+ private:
+  /// Tabulate the functions.
+  ScaledBesselTable();
+
+  /**
+   * Interpolate both functions.
+   *
+   * \param[in] z mass to temperature ratio \f$ m/T \f$, not negative
+   * \param[out] k2 \f$ z^2 e^z K_2(z) \f$
+   * \param[out] k1 \f$ z^3 e^z K_1(z) \f$
+   */
+  void evaluate(double z, double& k2, double& k1) const;
+
+  /// Grid spacing in \f$ z \f$
+  static constexpr double dz_ = 1.0 / 64;
+  /// Number of grid intervals
+  static constexpr size_t n_intervals_ = 64 * 64;
+
+  /**
+   * Values and derivatives of \f$ z^2 e^z K_2(z) \f$ and
+   * \f$ z^3 e^z K_1(z) \f$ at the grid points
+   */
+  std::vector<std::array<double, 4>> nodes_;
+};
+
 /**
  * Class to handle the equation of state (EoS) of the hadron gas, consisting
  * of all hadrons included in SMASH. This implementation deals with an ideal
@@ -129,7 +231,9 @@ class HadronGasEos {
    *  \param[in] tabulate Whether the equation of state should be tabulated
    *             Tabulation takes time once (typically around 5 minutes), but
    *             makes the further usage of the class much faster. Tabulated
-   *             values are saved in a file and loaded at the next run.
+   *             values are saved in a file and loaded at the next run. The
+   *             table is only compiled or loaded at the first lookup, see
+   *             from_table.
    *  \param[in] account_for_widths Whether equation of state should account
    *             for resonance spectral functions. Normally one wants to do it,
    *             if HadronGasEos is used for density calculations,
@@ -142,7 +246,6 @@ class HadronGasEos {
    *             calculation.
    */
   HadronGasEos(bool tabulate, bool account_for_widths);
-  ~HadronGasEos();
 
   /**
    * \brief Compute energy density.
@@ -303,9 +406,13 @@ class HadronGasEos {
    *        to use as starting point
    * \return array of 4 values: temperature, baryon chemical potential,
    *          strange chemical potential and charge chemical potential
+   *
+   * The equations are solved with the GSL solver of the calling thread, so
+   * that one equation of state can be solved from several threads at once.
    */
-  std::array<double, 4> solve_eos(double e, double nb, double ns, double nq,
-                                  std::array<double, 4> initial_approximation);
+  std::array<double, 4> solve_eos(
+      double e, double nb, double ns, double nq,
+      std::array<double, 4> initial_approximation) const;
 
   /**
    * Compute temperature and chemical potentials given energy-,
@@ -319,7 +426,8 @@ class HadronGasEos {
    * \return array of 4 values: temperature, baryon chemical potential
    *         and strange chemical potential and charge
    */
-  std::array<double, 4> solve_eos(double e, double nb, double ns, double nq) {
+  std::array<double, 4> solve_eos(double e, double nb, double ns,
+                                  double nq) const {
     return solve_eos(e, nb, ns, nq, solve_eos_initial_approximation(e, nb, nq));
   }
 
@@ -333,7 +441,7 @@ class HadronGasEos {
    *         and strange chemical potential
    */
   std::array<double, 4> solve_eos_initial_approximation(double e, double nb,
-                                                        double nq);
+                                                        double nq) const;
 
   /**
    * Compute strangeness chemical potential, requiring that net strangeness = 0
@@ -345,11 +453,12 @@ class HadronGasEos {
    */
   static double mus_net_strangeness0(double T, double mub, double muq);
 
-  /// Get the element of eos table
+  /**
+   * Get the element of eos table. The table is compiled at the first call,
+   * since e.g. a thermalizer can be set up without ever thermalizing.
+   */
   void from_table(EosTable::table_element& res, double e, double nb,
-                  double nq) const {
-    eos_table_.get(res, e, nb, nq);
-  }
+                  double nq) const;
 
   /// Check if a particle belongs to the EoS
   static bool is_eos_particle(const ParticleType& ptype) {
@@ -422,10 +531,12 @@ class HadronGasEos {
   /**
    * Helpful printout, useful for debugging if gnu equation solving goes crazy
    *
+   * \param[in] solver the solver
    * \param[in] iter current value of iterator
    * \return debug output string with iter, x and f(x) from solver
    */
-  std::string print_solver_state(size_t iter) const;
+  static std::string print_solver_state(const gsl_multiroot_fsolver* solver,
+                                        size_t iter);
 
   /// Constant factor, that appears in front of many thermodyn. expressions
   static constexpr double prefactor_ =
@@ -437,19 +548,34 @@ class HadronGasEos {
   /// Number of equations in the system of equations to be solved
   static constexpr size_t n_equations_ = 4;
 
-  /// EOS Table to be used
-  EosTable eos_table_ = EosTable(1.e-1, 1.e-1, 1.e-1, 90, 90, 90);
+  /// EOS Table to be used, compiled at the first lookup
+  mutable EosTable eos_table_ = EosTable(1.e-1, 1.e-1, 1.e-1, 90, 90, 90);
+
+  /// Guards the compilation of #eos_table_ by concurrent lookups
+  mutable std::once_flag eos_table_compiled_;
 
   /**
-   * Variables used by gnu equation solver. They are stored here to allocate
-   * and deallocate memory for them only once. It is expected that this class
-   * will be used for solving the EoS many times, so multiple allocations and
-   * frees are unwanted.
+   * Variables used by gnu equation solver, which are changed by every solve.
+   * One context exists per thread and is shared by all equations of state
+   * solved on that thread, so that memory for them is allocated only once
+   * per thread and the equations of state themselves are not changed by
+   * solving.
    */
-  gsl_vector* x_;
+  struct SolverContext {
+    SolverContext();
+    ~SolverContext();
+    /// Cannot be copied, since it owns the GSL objects
+    SolverContext(const SolverContext&) = delete;
+    /// Cannot be copied, since it owns the GSL objects
+    SolverContext& operator=(const SolverContext&) = delete;
+    /// Initial approximation given to the solver
+    gsl_vector* x;
+    /// The solver
+    gsl_multiroot_fsolver* solver;
+  };
 
-  /// \see x_
-  gsl_multiroot_fsolver* solver_;
+  /// \return The solver context of the calling thread.
+  static SolverContext& solver_context();
 
   /// Create an EoS table or not?
   const bool tabulate_;
@@ -11,9 +11,10 @@
 #ifndef SRC_INCLUDE_SMASH_HEPMCINTERFACE_H_
 #define SRC_INCLUDE_SMASH_HEPMCINTERFACE_H_
 
-#include <map>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <valarray>
 
@@ -90,8 +91,12 @@ class HepMcInterface : public OutputInterface {
    * \param[in] name    Name of output
    * \param[in] full_event Whether the full event or only final-state particles
    *                       are printed in the output
+   * \param[in] min_elastic_sqrts Elastic scatterings with a lower
+   *                              \f$\sqrt{s}\f$ [GeV] are not recorded as
+   *                              vertices of the full event
    */
-  HepMcInterface(const std::string& name, const bool full_event);
+  HepMcInterface(const std::string& name, const bool full_event,
+                 const double min_elastic_sqrts = 0.);
   /**
    * Add the initial particles information of an event to the
    * central vertex.  Construct projectile and target particles with
@@ -108,11 +113,25 @@ class HepMcInterface : public OutputInterface {
   /**
    * Writes collisions to event.
    *
+   * Elastic scatterings below the configured \f$\sqrt{s}\f$ are not written
+   * as vertices. Instead, the particles entering them take the momenta of the
+   * outgoing particles and continue to the next vertex.
+   *
    * \param[in] action an Action object containing incoming,
    *                   outgoing particles and type of interactions.
    * \param[in] density Unused, needed since inherited.
    */
   void at_interaction(const Action& action, const double density) override;
+  /**
+   * \return Whether the interactions are needed, which is only the case for
+   *         the full event. The final-state event is built from the particles
+   *         at the start and end of the event alone.
+   */
+  bool uses_interactions() const override { return full_event_; }
+  /// \return false, the density is not stored.
+  bool uses_interaction_density() const override { return false; }
+  /// \return false, the event is built at its start and end.
+  bool uses_intermediate_times() const override { return false; }
   /**
    * Add the final particles information of an event to the central vertex.
    * Store impact paramter and write event.
@@ -133,10 +152,14 @@ class HepMcInterface : public OutputInterface {
     off = 100
   };
   /** Type of mapping from SMASH ID to HepMC ID */
-  using IdMap = std::map<int, HepMC3::GenParticlePtr>;
+  using IdMap = std::unordered_map<int, HepMC3::GenParticlePtr>;
   /** Counter of collitions per incoming particle */
   using CollCounter = std::valarray<int>;
-  /** Clear before an event */
+  /**
+   * Clear before an event. The storage of the event and of the mapping is
+   * kept and reserved for as many particles and vertices as in the largest
+   * event so far, such that it is not reallocated while an event is built.
+   */
   void clear();
   /** Convert SMASH process type to HepMC status */
   int get_status(const ProcessType& t) const;
@@ -222,6 +245,12 @@ class HepMcInterface : public OutputInterface {
   int ncoll_hard_;
   /** Whether the full event or only final-state particles are in the output */
   bool full_event_;
+  /** Elastic scatterings with a lower \f$\sqrt{s}\f$ are not vertices */
+  double min_elastic_sqrts_;
+  /** Largest number of particles in an event so far */
+  std::size_t max_particles_ = 0;
+  /** Largest number of vertices in an event so far */
+  std::size_t max_vertices_ = 0;
 };
 }  // namespace smash
 
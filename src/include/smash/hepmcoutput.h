@@ -11,11 +11,18 @@
 #ifndef SRC_INCLUDE_SMASH_HEPMCOUTPUT_H_
 #define SRC_INCLUDE_SMASH_HEPMCOUTPUT_H_
 
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "HepMC3/Data/GenEventData.h"
 #include "HepMC3/Writer.h"
 
 #include "hepmcinterface.h"
@@ -32,6 +39,12 @@ namespace smash {
  * file can be a human-readable ASCII file or a ROOT Tree binary file.
  * HepMC version 3 is used.
  *
+ * With a positive batch size, the events are written by a writer thread of
+ * the output. The built event is flattened into a `HepMC3::GenEventData`,
+ * whose storage is reused, and handed over in batches of the given number
+ * of events. The writer thread restores each event into an event of its own
+ * and writes it, such that the next event can be built meanwhile.
+ *
  * More details of the output format can be found in the User Guide.
  */
 class HepMcOutput : public HepMcInterface {
@@ -44,15 +57,22 @@ class HepMcOutput : public HepMcInterface {
    * \param[in] full_event Whether the full event or only final-state particles
                            are printed in the output
    * \param[in] HepMC3_output_type: "root" or "asciiv3"
+   * \param[in] batch_size Number of events handed over to the writer thread at
+   *                       once; with 0 the events are written synchronously
+   * \param[in] min_elastic_sqrts Elastic scatterings with a lower
+   *                              \f$\sqrt{s}\f$ [GeV] are not written as
+   *                              vertices of the full event
    */
   HepMcOutput(const std::filesystem::path &path, std::string name,
-              const bool full_event, std::string HepMC3_output_type);
+              const bool full_event, std::string HepMC3_output_type,
+              const std::size_t batch_size = 0,
+              const double min_elastic_sqrts = 0.);
 
-  /// Destructor renames file
+  /// Destructor writes the pending events and renames file
   ~HepMcOutput();
   /**
    * Add the final particles information of an event to the central vertex.
-   * Store impact parameter and write event.
+   * Store impact parameter and write event, or add it to the current batch.
    *
    * \param[in] particles Current list of particles.
    * \param[in] event_number Number of event.
@@ -72,6 +92,49 @@ class HepMcOutput : public HepMcInterface {
   typedef enum enum_output { asciiv3, treeroot } type_of_HepMC3_output;
   /// HepMC3 output type
   type_of_HepMC3_output output_type_;
+
+  /// Flattened events handed over to the writer thread together
+  struct Batch {
+    /// Storage of the events, which can be longer than the batch
+    std::vector<HepMC3::GenEventData> events;
+    /// Number of events in the batch
+    std::size_t size = 0;
+  };
+
+  /**
+   * Hand the current batch over to the writer thread, waiting while too many
+   * batches are pending.
+   *
+   * \throw std::runtime_error if writing a previous batch failed.
+   */
+  void submit_batch();
+
+  /// Write the submitted batches until stop_ is set and none is pending.
+  void write_loop();
+
+  /// Maximal number of batches waiting to be written
+  static constexpr std::size_t max_pending_batches = 2;
+
+  /// Number of events per batch; 0 if written synchronously
+  const std::size_t batch_size_;
+  /// Batch which is currently filled
+  Batch batch_;
+  /// Submitted batches, oldest first
+  std::deque<Batch> pending_;
+  /// Written batches, whose storage is reused
+  std::vector<Batch> recycled_;
+  /// Protects pending_, recycled_, stop_ and error_
+  std::mutex mutex_;
+  /// Signals the writer thread that a batch was submitted or it has to stop
+  std::condition_variable batch_submitted_;
+  /// Signals the physics loop that a batch has been written
+  std::condition_variable batch_written_;
+  /// Whether the writer thread has to stop once all batches are written
+  bool stop_ = false;
+  /// Exception thrown on the writer thread
+  std::exception_ptr error_;
+  /// Writer thread, only started with a positive batch size
+  std::thread writer_;
 };
 
 }  // namespace smash
@@ -105,6 +105,13 @@ class HyperSurfaceCrossActionsFinder : public ActionFinderInterface {
     return {};
   }
 
+  /// Ignore the shifted neighbor searches for hypersurface crossing
+  ActionList find_actions_with_shifted_neighbors(
+      const ParticleList &, const ThreeVector &, const ParticleList &, double,
+      const std::vector<FourVector> &) const override {
+    return {};
+  }
+
   /// Ignore the surrounding searches for hypersurface crossing
   ActionList find_actions_with_surrounding_particles(
       const ParticleList &, const Particles &, double,
@@ -113,7 +120,7 @@ class HyperSurfaceCrossActionsFinder : public ActionFinderInterface {
   }
 
   /// No final actions for hypersurface crossing
-  ActionList find_final_actions(const Particles &, bool) const override {
+  ActionList find_final_actions(const ParticleList &, bool) const override {
     return {};
   }
 
@@ -141,28 +148,31 @@ class HyperSurfaceCrossActionsFinder : public ActionFinderInterface {
   /**
    * Determine whether particle crosses hypersurface within next timestep
    * during propagation
-   * \param[in] pdata_before_propagation Particle data at the beginning of time
+   * \param[in] position_before Particle position at the beginning of time
    *            step in question
-   * \param[in] pdata_after_propagation Particle data at the end of time step
-   *            in question
+   * \param[in] position_after Particle position at the end of time step in
+   *            question
    * \param[in] tau Proper time of the hypersurface that is tested
    * \return Does particle cross the hypersurface?
    */
-  bool crosses_hypersurface(ParticleData &pdata_before_propagation,
-                            ParticleData &pdata_after_propagation,
+  bool crosses_hypersurface(const FourVector &position_before,
+                            const FourVector &position_after,
                             const double tau) const;
 
   /**
    * Find the coordinates where particle crosses hypersurface
-   * \param[in] pdata_before_propagation Particle data at the beginning of time
-   *            in question
-   * \param[in] pdata_after_propagation Particle data at the end of time step
-   *            in question
+   * \param[in] position_before Particle position at the beginning of time
+   *            step in question
+   * \param[in] position_after Particle position at the end of time step in
+   *            question
+   * \param[in] velocity Velocity with which the particle is propagated to
+   *            the crossing
    * \param[in] tau Proper time of the hypersurface that is crossed
    * \return Fourvector of the crossing position
    */
-  FourVector coordinates_on_hypersurface(ParticleData &pdata_before_propagation,
-                                         ParticleData &pdata_after_propagation,
+  FourVector coordinates_on_hypersurface(const FourVector &position_before,
+                                         const FourVector &position_after,
+                                         const ThreeVector &velocity,
                                          const double tau) const;
 };
 
@@ -0,0 +1,107 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_ICCALLBACKOUTPUT_H_
+#define SRC_INCLUDE_SMASH_ICCALLBACKOUTPUT_H_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "outputinterface.h"
+#include "particledata.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Output that hands the particles removed on the hypersurface of the initial
+ * conditions to a function of the caller instead of writing them to a file.
+ *
+ * This is meant for SMASH as a library, where a hydrodynamics code runs in
+ * the same process. The particles are collected in memory during the event
+ * and passed to the callback at its end, with the positions at which they
+ * crossed the hypersurface. Like the binary initial conditions output, all
+ * crossing particles are passed, including spectators that never interacted.
+ * The caller can e.g. sum them up in an EnergyMomentumTensor or smear them
+ * onto the grid of the hydrodynamics code.
+ *
+ * The hypersurface crossings are only searched for if the `Initial_Conditions`
+ * output is configured, which can be done with `Format: ["None"]` if no files
+ * are wanted. The output is then added with Experiment::add_output, e.g.
+ * \code{.cpp}
+ * experiment.add_output(std::make_unique<ICCallbackOutput>(
+ *     [&hydro](const ParticleList &particles, int event_number,
+ *              const EventInfo &) { hydro.set_initial_state(particles); }));
+ * \endcode
+ *
+ * Each ensemble is passed as an event of its own, in the order of the
+ * ensembles.
+ */
+class ICCallbackOutput : public OutputInterface {
+ public:
+  /**
+   * Function to be called with the particles that crossed the hypersurface
+   * in an event, the number of the event and the event info.
+   */
+  using Callback = std::function<void(const ParticleList &particles,
+                                      int event_number, const EventInfo &info)>;
+
+  /**
+   * Create the output.
+   *
+   * \param[in] callback Function to be called at the end of every event
+   */
+  explicit ICCallbackOutput(Callback callback);
+
+  /**
+   * Start collecting the particles of an event.
+   * \param[in] event_number Number of the event, not used
+   * \param[in] info Event info, not used
+   */
+  void at_eventstart(const Particles &, const int event_number,
+                     const EventInfo &info) override;
+
+  /**
+   * Pass the particles collected for the event to the callback.
+   * \param[in] event_number Number of the current event.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_eventend(const Particles &, const int event_number,
+                   const EventInfo &info) override;
+
+  /**
+   * Collect the particle of a hypersurface crossing of the first ensemble.
+   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] density Density at the interaction point, not used
+   */
+  void at_interaction(const Action &action, const double density) override;
+
+  /**
+   * Collect the particle of a hypersurface crossing of an ensemble.
+   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] density Density at the interaction point, not used
+   * \param[in] i_ensemble Ensemble of the action
+   */
+  void at_ensemble_interaction(const Action &action, const double density,
+                               const int i_ensemble) override;
+
+ private:
+  /// Function called at the end of every event
+  Callback callback_;
+  /// Particles of the events started but not yet ended, one per ensemble
+  std::vector<ParticleList> particles_;
+  /// Number of events in particles_ already passed to the callback
+  std::size_t n_ended_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_ICCALLBACKOUTPUT_H_
@@ -70,6 +70,9 @@ class ICOutput : public OutputInterface {
    */
   void at_interaction(const Action &action, const double) override;
 
+  /// \return false, the density is not written.
+  bool uses_interaction_density() const override { return false; }
+
  private:
   /// Pointer to output file
   RenamingFilePtr file_;
@@ -12,6 +12,7 @@
 
 #include <any>
 #include <functional>
+#include <limits>
 #include <map>
 #include <optional>
 #include <set>
@@ -622,6 +623,15 @@ class Key {
  * keys are listed with a short description, an example is given and some
  * information about the input particle files is provided.
  *
+ * Files in the SMASH \ref doxypage_output_binary "binary format" are accepted
+ * as well and recognized by their magic number. They are mapped into memory
+ * and indexed once, so that every event is read directly without any text
+ * parsing. The particles of an event are those of the last particle block
+ * before its event end line, e.g. the final particles of a `Particles` output
+ * in `Binary` format. All files of a
+ * <tt>\ref key_ML_file_prefix_ "File_Prefix"</tt> have to be in the same
+ * format.
+ *
  * \attention
  * In `List` modus, the provided list of particles has to match information
  * contained in the particles file (either the SMASH default one or that
@@ -1131,6 +1141,92 @@ struct InputKeys {
   inline static const Key<int> gen_minNonEmptyEnsembles_number{
       {"General", "Minimum_Nonempty_Ensembles", "Number"}, {"1.3"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general_ats
+   * The `Adaptive_Time_Step` section of `General` is only read with
+   * `Time_Step_Mode: "Adaptive"`. The first time step of every event has the
+   * length `Delta_Time`. At the end of every time step, the length of the
+   * next one is chosen as the smallest of
+   * - the time step in which `Actions_Per_Particle` actions per particle are
+   *   expected, given the number of actions found at the beginning of the
+   *   last time step,
+   * - the time the fastest particle needs to cross the fraction
+   *   `Lattice_Cell_Fraction` of the smallest cell of the lattice, if a
+   *   lattice is used,
+   * - the time in which the largest force of the potentials on the lattice
+   *   changes a momentum by `Momentum_Kick`, if potentials are used.
+   *
+   * The time step grows at most by a factor of 2 from one time step to the
+   * next and is kept between `Minimum_Delta_Time` and `Maximum_Delta_Time`.
+   * Output times are not affected by the length of the time steps.
+   *
+   * <hr>
+   * \optional_key_no_line{key_gen_ats_actions_per_particle_,
+   * Actions_Per_Particle,double,0.1}
+   *
+   * Targeted number of actions per particle in one time step.
+   */
+  /**
+   * \see_key{key_gen_ats_actions_per_particle_}
+   */
+  inline static const Key<double> gen_adaptiveTimeStep_actionsPerParticle{
+      {"General", "Adaptive_Time_Step", "Actions_Per_Particle"}, 0.1, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general_ats
+   * \optional_key{key_gen_ats_lattice_cell_fraction_,Lattice_Cell_Fraction,
+   * double,0.5}
+   *
+   * Largest fraction of a lattice cell that the fastest particle may cross in
+   * one time step.
+   */
+  /**
+   * \see_key{key_gen_ats_lattice_cell_fraction_}
+   */
+  inline static const Key<double> gen_adaptiveTimeStep_latticeCellFraction{
+      {"General", "Adaptive_Time_Step", "Lattice_Cell_Fraction"},
+      0.5,
+      {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general_ats
+   * \optional_key{key_gen_ats_maximum_delta_time_,Maximum_Delta_Time,double,
+   * 1.0}
+   *
+   * Longest time step \unit{in fm}.
+   */
+  /**
+   * \see_key{key_gen_ats_maximum_delta_time_}
+   */
+  inline static const Key<double> gen_adaptiveTimeStep_maximumDeltaTime{
+      {"General", "Adaptive_Time_Step", "Maximum_Delta_Time"}, 1.0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general_ats
+   * \optional_key{key_gen_ats_minimum_delta_time_,Minimum_Delta_Time,double,
+   * 0.01}
+   *
+   * Shortest time step \unit{in fm}.
+   */
+  /**
+   * \see_key{key_gen_ats_minimum_delta_time_}
+   */
+  inline static const Key<double> gen_adaptiveTimeStep_minimumDeltaTime{
+      {"General", "Adaptive_Time_Step", "Minimum_Delta_Time"}, 0.01, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general_ats
+   * \optional_key{key_gen_ats_momentum_kick_,Momentum_Kick,double,0.01}
+   *
+   * Largest change of a momentum \unit{in GeV} by the forces of the
+   * potentials in one time step.
+   */
+  /**
+   * \see_key{key_gen_ats_momentum_kick_}
+   */
+  inline static const Key<double> gen_adaptiveTimeStep_momentumKick{
+      {"General", "Adaptive_Time_Step", "Momentum_Kick"}, 0.01, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * <hr>
@@ -1139,7 +1235,148 @@ struct InputKeys {
 
   /*!\Userguide
    * \page doxypage_input_conf_general
-   * \optional_key_no_line{key_gen_delta_time_,Delta_Time,double,1.0}
+   * \optional_key_no_line{key_gen_action_cost_sampling_,Action_Cost_Sampling,
+   * int,0}
+   *
+   * If positive, the wall-clock time to generate the final state of and
+   * perform every this many actions is measured. At the end of the run, the
+   * mean cost of the actions of each process type, e.g. elastic, 2&rarr;1,
+   * 2&rarr;2, soft and hard strings, decays, multi-particle reactions and wall
+   * crossings, is printed together with the time spent in all of them
+   * estimated from the mean. This tells which processes dominate the run time
+   * of a setup, e.g. to decide about the \ref key_CT_strings_ "Strings" or
+   * \ref key_CT_use_aqm_ "Use_AQM" settings. Sampling every 100th action keeps
+   * the overhead negligible.
+   */
+  /**
+   * \see_key{key_gen_action_cost_sampling_}
+   */
+  inline static const Key<int> gen_actionCostSampling{
+      {"General", "Action_Cost_Sampling"}, 0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key_no_line{key_gen_action_execution_threads_,
+   * Action_Execution_Threads,int,0}
+   *
+   * Number of threads generating the final states of the actions of one
+   * ensemble, e.g. fragmenting strings. With 0, every action is generated
+   * when it is performed. With a positive value, batches of upcoming actions
+   * within the time step, which cannot influence each other, are generated
+   * concurrently in advance: They share no incoming particles and are
+   * separated by more than the light travel time between them plus the
+   * maximal interaction distance. The actions are still performed one after
+   * the other in the order of their times, and a prepared action is
+   * discarded like any other if one of its particles was consumed in the
+   * meantime.
+   *
+   * In this mode, every action draws the random numbers of its final state
+   * from its own stream, which is seeded from the stream of the ensemble,
+   * the time of the action and its incoming particles. Hence, the results do
+   * not depend on the number of threads, as long as it is positive, and are
+   * statistically equivalent to, but not identical with, a run with 0. Each
+   * thread fragments strings with its own PYTHIA objects, which are seeded
+   * for every string. Together with
+   * <tt>\ref key_gen_ensemble_threads_ "Ensemble_Threads"</tt>, every
+   * ensemble thread uses this many threads.
+   */
+  /**
+   * \see_key{key_gen_action_execution_threads_}
+   */
+  inline static const Key<int> gen_actionExecutionThreads{
+      {"General", "Action_Execution_Threads"}, 0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key_no_line{key_gen_action_finding_threads_,
+   * Action_Finding_Threads,int,0}
+   *
+   * Number of threads used to find the actions of one ensemble at the
+   * beginning of every time step. With 0, the cells of the grid are searched
+   * one after the other. With a positive value, the cells are distributed
+   * over this many threads, such that cells searched at the same time never
+   * share a neighboring cell. Every cell then draws its random numbers from
+   * its own stream, seeded from the ensemble's stream and the particles of
+   * the cell, and the found actions are merged ordered by their time and
+   * incoming particles. Hence, the actions do not depend on the number of
+   * threads, as long as it is positive, but differ from a run with 0.
+   *
+   * This speeds up the action finding of large ensembles, e.g. of collider
+   * events with many particles or testparticles. Together with
+   * <tt>\ref key_gen_ensemble_threads_ "Ensemble_Threads"</tt>, every
+   * ensemble thread uses this many threads. This includes the grids with
+   * periodic boundaries of boxes, which are split into domains in the same
+   * way, such that large boxes also benefit.
+   */
+  /**
+   * \see_key{key_gen_action_finding_threads_}
+   */
+  inline static const Key<int> gen_actionFindingThreads{
+      {"General", "Action_Finding_Threads"}, 0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key_no_line{key_gen_adaptive_cell_size_,Adaptive_Cell_Size,bool,
+   * false}
+   *
+   * Whether the length of the grid cells is adapted in every time step to the
+   * occupancy of the grid. The minimal cell length required to find all
+   * collisions stays the lower limit. Above it, the cells are made larger, up
+   * to four times the minimal length, or a single cell is used, if the pairs
+   * of particles and the cells to search in the previous time step indicate
+   * that the search becomes faster by more than 20%. This speeds up dilute
+   * systems, like the late stages of collider events. Only the pairs that are
+   * checked change, not the collision criterion. Not allowed for the
+   * stochastic criterion, for which the cell size is a parameter, or without
+   * <tt>\ref key_gen_use_grid_ "Use_Grid"</tt>.
+   */
+  /**
+   * \see_key{key_gen_adaptive_cell_size_}
+   */
+  inline static const Key<bool> gen_adaptiveCellSize{
+      {"General", "Adaptive_Cell_Size"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_checkpoint_interval_,Checkpoint_Interval,double,0.0}
+   *
+   * Time interval \unit{in fm} after which the full state of the event is
+   * written to the file `Checkpoint.bin` in the output directory, at the end
+   * of the time step reaching it. A run which was interrupted, e.g. by the
+   * wall-time limit of a batch system, can then be continued with \ref
+   * key_gen_resume_from_checkpoint_ "Resume_From_Checkpoint". Each checkpoint
+   * replaces the previous one only once it is complete. With 0, no
+   * checkpoints are written. Checkpoints are only possible in the box and
+   * sphere modi and not with events on several threads.
+   */
+  /**
+   * \see_key{key_gen_checkpoint_interval_}
+   */
+  inline static const Key<double> gen_checkpointInterval{
+      {"General", "Checkpoint_Interval"}, 0.0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key_no_line{key_gen_conservation_recount_interval_,
+   * Conservation_Recount_Interval,int,0}
+   *
+   * Whenever the conservation laws are checked, i.e. without potentials,
+   * strings, expansion and initial conditions output, the conserved quantities
+   * are compared to the initial ones after every time step. They are obtained
+   * from the changes by the performed actions, and they are counted from all
+   * particles only at the end of the time evolution. A positive value
+   * additionally counts them from all particles every this many time steps,
+   * which is meant for debugging.
+   */
+  /**
+   * \see_key{key_gen_conservation_recount_interval_}
+   */
+  inline static const Key<int> gen_conservationRecountInterval{
+      {"General", "Conservation_Recount_Interval"}, 0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_delta_time_,Delta_Time,double,1.0}
    *
    * Fixed time step \unit{in fm} at which the collision-finding grid is
    * recreated, and, if potentials are on, momenta are updated according to the
@@ -1202,6 +1439,50 @@ struct InputKeys {
   inline static const Key<double> gen_smearingDiscreteWeight{
       {"General", "Discrete_Weight"}, 1. / 3, {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_ensemble_threads_,Ensemble_Threads,int,1}
+   *
+   * Number of threads used to evolve the parallel ensembles concurrently.
+   *
+   * Between two updates of the densities and mean-field potentials the
+   * ensembles are independent of each other, so that their collision finding
+   * and timestepless propagation can be carried out at the same time on
+   * different threads. Each ensemble then uses its own random number stream,
+   * which is seeded from the event seed and the ensemble index. Hence, results
+   * do not depend on the number of threads, as long as it is larger than one,
+   * but differ from a run with `Ensemble_Threads: 1`, where all ensembles share
+   * the same stream. Interactions are written to the outputs in the same order
+   * as in the serial evolution, i.e. ensemble by ensemble within each output
+   * interval. Their process ids are counted separately in every ensemble, such
+   * that interaction n of ensemble i, both counted from zero, has the id
+   * n &times; Ensembles + i + 1.
+   *
+   * The same number of threads is used to smear the particles onto the
+   * density lattices. There, every thread fills its own slab of the lattice,
+   * such that the lattices are identical to the ones of a serial run. The
+   * temperatures and chemical potentials of the forced thermalization lattice
+   * are then also computed on that many threads.
+   *
+   * Values larger than the number of <tt>\ref key_gen_ensembles_
+   * "Ensembles"</tt> are reduced to that number for the evolution of the
+   * ensembles, but not for the lattices. Concurrent
+   * ensembles can currently not be combined with dilepton or photon
+   * production, and Pauli blocking.
+   *
+   * With strings, every thread fragments them with its own PYTHIA objects,
+   * which are seeded for every string from the random number stream of its
+   * ensemble. The PYTHIA objects of hard strings are initialized at the energy
+   * of the first collision of the beams a thread performs, which may slightly
+   * depend on the scheduling, unless they are given in
+   * <tt>\ref key_CT_SP_pythia_pool_beams_ "Pythia_Pool_Beams"</tt>.
+   */
+  /**
+   * \see_key{key_gen_ensemble_threads_}
+   */
+  inline static const Key<int> gen_ensembleThreads{
+      {"General", "Ensemble_Threads"}, 1, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_ensembles_,Ensembles,int,1}
@@ -1307,6 +1588,66 @@ struct InputKeys {
   inline static const Key<double> gen_smearingGaussianSigma{
       {"General", "Gaussian_Sigma"}, 1.0, {"0.60"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_lazy_propagation_,Lazy_Propagation,bool,false}
+   *
+   * Whether the particles are only propagated when they are needed, instead
+   * of moving all particles of an ensemble to the time of every action. Every
+   * particle then keeps the time of its position, and only the incoming
+   * particles of an action and the particles searched for collisions with
+   * its outgoing particles are propagated to the time of the action. All
+   * particles are propagated together at the end of every time step and at
+   * output times, so outputs see the same state as without this option. This
+   * saves most of the propagation in large ensembles with many actions per
+   * time step. The results agree with the eager propagation up to rounding.
+   *
+   * The option takes no effect with dileptons, with Pauli blocking, or if the
+   * density at the interaction points is computed from all particles, see
+   * <tt>\ref key_output_interaction_density_ "Interaction_Density"</tt>,
+   * since these need all particles at the time of every action. Without a
+   * grid, or with the `"Stochastic"` collision criterion, all particles are
+   * still propagated for the collision search after every action.
+   */
+  /**
+   * \see_key{key_gen_lazy_propagation_}
+   */
+  inline static const Key<bool> gen_lazyPropagation{
+      {"General", "Lazy_Propagation"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_memory_budget_,Memory_Budget,double,0.0}
+   *
+   * Resident memory of the SMASH process \unit{in MiB}, above which a warning
+   * is printed and the queues of the asynchronous outputs are written at every
+   * output time instead of only when they are full or at the end of the
+   * event. Setting a budget enables `Memory_Tracking`. With 0, there is no
+   * budget.
+   */
+  /**
+   * \see_key{key_gen_memory_budget_}
+   */
+  inline static const Key<double> gen_memoryBudget{
+      {"General", "Memory_Budget"}, 0.0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_memory_tracking_,Memory_Tracking,bool,false}
+   *
+   * Whether the current and peak memory of the particles, lattices, heaps of
+   * actions, snapshots queued for asynchronous outputs and the PYTHIA
+   * instances of the string processes is accounted, together with the
+   * resident memory of the process. The memory is reported at every output
+   * time and at the end of the run. The memory allocated within PYTHIA is
+   * estimated by the growth of the resident memory while it is set up.
+   */
+  /**
+   * \see_key{key_gen_memory_tracking_}
+   */
+  inline static const Key<bool> gen_memoryTracking{
+      {"General", "Memory_Tracking"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_metric_type_,Metric_Type,string,"NoExpansion"}
@@ -1324,6 +1665,102 @@ struct InputKeys {
   inline static const Key<ExpansionMode> gen_metricType{
       {"General", "Metric_Type"}, ExpansionMode::NoExpansion, {"1.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_oversampling_,Oversampling,int,1}
+   *
+   * Number of consecutive events evolved from the same initial state. The
+   * initial state is sampled for the first event of every group of
+   * `Oversampling` events, with the random numbers of that event, and copied
+   * for the other events of the group, which are evolved with their own random
+   * numbers. This saves the sampling or reading of expensive initial states,
+   * e.g. of deformed nuclei or from the files of the list modus, for
+   * observables that are limited by the statistics of the evolution rather
+   * than of the initial states. The events of a group are correlated, which has to be taken into
+   * account in the statistical errors. It cannot be combined with prefetched
+   * initial states.
+   */
+  /**
+   * \see_key{key_gen_oversampling_}
+   */
+  inline static const Key<int> gen_oversampling{{"General", "Oversampling"},
+                                                1,
+                                                {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_particle_snapshot_,Particle_Snapshot,bool,false}
+   *
+   * Whether the particle types and decay modes are stored in a binary snapshot
+   * in the tabulations directory after parsing the particles and decay modes
+   * files, and read from there by later runs with the same files and SMASH
+   * version. This saves the parsing and checking of the files at startup,
+   * which is useful for many short runs. Without a tabulations directory, the
+   * files are always parsed.
+   */
+  /**
+   * \see_key{key_gen_particle_snapshot_}
+   */
+  inline static const Key<bool> gen_particleSnapshot{
+      {"General", "Particle_Snapshot"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_precompute_decay_tabulations_,Precompute_Decay_Tabulations,bool,true}
+   *
+   * Whether the tabulated widths of decays into unstable particles and of
+   * Dalitz decays are built on all hardware threads at startup. Like the cross
+   * section integrals, they are then cached in the tabulations directory of the
+   * particle and decay mode files and read from there by later runs. If
+   * disabled, every tabulation is built when it is first needed during the
+   * simulation, which only works with a single thread.
+   */
+  /**
+   * \see_key{key_gen_precompute_decay_tabulations_}
+   */
+  inline static const Key<bool> gen_precomputeDecayTabulations{
+      {"General", "Precompute_Decay_Tabulations"}, true, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_profiling_,Profiling,bool,false}
+   *
+   * Whether the wall-clock time spent in the phases of the evolution, like
+   * the grid update, the action finding, performing actions, string
+   * fragmentation, updating the lattices and momenta, the propagation and the
+   * remainder of each time step as well as the callbacks of each output, is
+   * measured. The breakdown is printed after every event
+   * and for the whole run, and written as JSON into the file `Profile.json`
+   * in the output directory. The time of a phase within another one is only
+   * attributed to the inner one. With several ensemble threads, the times of
+   * all threads add up.
+   */
+  /**
+   * \see_key{key_gen_profiling_}
+   */
+  inline static const Key<bool> gen_profiling{
+      {"General", "Profiling"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_propagation_threads_,Propagation_Threads,int,0}
+   *
+   * Number of threads sharing the particles of one ensemble when they are
+   * propagated along straight lines to the end of a time step or to an
+   * output time, and when they are moved by the expansion of a
+   * non-Minkowskian <tt>\ref key_gen_metric_type_ "Metric_Type"</tt>. With
+   * 0, one thread propagates all particles. Each thread propagates at least
+   * a few thousand particles, so this speeds up large ensembles, e.g.
+   * expanding spheres, and does not change the results. Together with
+   * <tt>\ref key_gen_ensemble_threads_ "Ensemble_Threads"</tt>, every
+   * ensemble thread uses this many threads.
+   */
+  /**
+   * \see_key{key_gen_propagation_threads_}
+   */
+  inline static const Key<int> gen_propagationThreads{
+      {"General", "Propagation_Threads"}, 0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_rfdd_mode_,Rest_Frame_Density_Derivatives_Mode,string,"Off"}
@@ -1341,6 +1778,25 @@ struct InputKeys {
           RestFrameDensityDerivativesMode::Off,
           {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_resume_from_checkpoint_,Resume_From_Checkpoint,
+   * string,</tt>no resumption<tt>}
+   *
+   * Checkpoint written by a run with \ref key_gen_checkpoint_interval_
+   * "Checkpoint_Interval", from which the event being simulated at the time
+   * of the checkpoint is continued. The resumed event evolves bit by bit like
+   * the interrupted one, provided that the same SMASH build and configuration
+   * are used. The outputs of the resumed run begin with the state at the time
+   * of the checkpoint, as if the event started there, in the new output
+   * directory. The following events are simulated as in the interrupted run.
+   */
+  /**
+   * \see_key{key_gen_resume_from_checkpoint_}
+   */
+  inline static const Key<std::string> gen_resumeFromCheckpoint{
+      {"General", "Resume_From_Checkpoint"}, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_smearing_mode_,Smearing_Mode,string,"Covariant
@@ -1398,6 +1854,30 @@ struct InputKeys {
   inline static const Key<SmearingMode> gen_smearingMode{
       {"General", "Smearing_Mode"}, SmearingMode::CovariantGaussian, {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_spatial_sorting_threshold_,Spatial_Sorting_Threshold,
+   * double,0.0}
+   *
+   * Threshold to reorder the particles in memory by their position at the
+   * beginning of a time step. New particles are stored in the holes left by
+   * removed ones or at the end, regardless of their position, such that
+   * neighboring particles end up far apart in memory over an event. The
+   * particles of an ensemble are sorted along the Morton curve of cells with
+   * the minimal cell length of the grid, if the number of holes and of
+   * particles added since the last sorting exceeds this fraction of the
+   * stored particles. This makes the grid and lattice updates
+   * cache-friendly. The order of the particles does not change the
+   * interactions, but changes the order in which random numbers are drawn,
+   * so the results are statistically equivalent. A value of 0 disables the
+   * sorting.
+   */
+  /**
+   * \see_key{key_gen_spatial_sorting_threshold_}
+   */
+  inline static const Key<double> gen_spatialSortingThreshold{
+      {"General", "Spatial_Sorting_Threshold"}, 0.0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_testparticles_,Testparticles,int,1}
@@ -1428,6 +1908,58 @@ struct InputKeys {
   inline static const Key<int> gen_testparticles{
       {"General", "Testparticles"}, 1, {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_testparticle_subensembles_,
+   * Testparticle_Subensembles,int,1}
+   *
+   * Number of subensembles, into which the testparticles of an ensemble are
+   * divided. It has to divide the number of <tt>\ref key_gen_testparticles_
+   * "Testparticles"</tt>.
+   *
+   * Every testparticle belongs to one subensemble, which is passed on to the
+   * products of its collisions and decays. Particles only collide within
+   * their subensemble, and the cross sections are decreased by the number of
+   * testparticles per subensemble instead of the number of all
+   * testparticles. The densities and mean-field potentials are computed from
+   * all testparticles. The collisions are the same as with the parallel
+   * ensembles of <tt>\ref key_gen_ensembles_ "Ensembles"</tt>, each with
+   * fewer testparticles, and are found on a grid with separate cells for
+   * every subensemble, built in one pass over the particles. All particles
+   * stay in one list and are written out as one event.
+   */
+  /**
+   * \see_key{key_gen_testparticle_subensembles_}
+   */
+  inline static const Key<int> gen_testparticleSubensembles{
+      {"General", "Testparticle_Subensembles"}, 1, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_thread_affinity_,Thread_Affinity,string,"None"}
+   *
+   * Policy of binding the threads, which evolve the ensembles with
+   * <tt>\ref key_gen_ensemble_threads_ "Ensemble_Threads"</tt> larger than 1,
+   * to the NUMA nodes of the machine:
+   * - `"None"`: The threads are not bound.
+   * - `"Compact"`: The threads fill the cores of one NUMA node before the next
+   *   node is used, which keeps the threads close together.
+   * - `"Scatter"`: The threads are distributed round-robin over the NUMA
+   *   nodes, which uses the memory bandwidth of all nodes.
+   *
+   * A bound thread may run on all cores of its node, such that the threads it
+   * starts itself are not confined to one core. Every ensemble is always
+   * evolved by the same thread, which moves the particles of the ensemble
+   * into the memory of its node the first time, and creates the grid of the
+   * ensemble there. Binding is only supported on Linux and is skipped with a
+   * warning elsewhere.
+   */
+  /**
+   * \see_key{key_gen_thread_affinity_}
+   */
+  inline static const Key<ThreadAffinity> gen_threadAffinity{
+      {"General", "Thread_Affinity"}, ThreadAffinity::None, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_time_step_mode_,Time_Step_Mode,string,"Fixed"}
@@ -1438,6 +1970,9 @@ struct InputKeys {
    * - `"Fixed"`&rarr; Fixed-sized time steps at which collision-finding grid is
    *   created. More efficient for systems with many particles. The `Delta_Time`
    *   is provided by user.
+   * - `"Adaptive"`&rarr; Time steps as for `"Fixed"`, starting with
+   *   `Delta_Time`, whose length is adapted to the state of the system after
+   *   every time step, see \ref doxypage_input_conf_general_ats.
    *
    * For `Delta_Time` explanation see \ref key_gen_delta_time_ "here".
    *
@@ -1452,6 +1987,26 @@ struct InputKeys {
   inline static const Key<TimeStepMode> gen_timeStepMode{
       {"General", "Time_Step_Mode"}, TimeStepMode::Fixed, {"0.85"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_trace_,Trace,bool,false}
+   *
+   * Whether the timeline of the evolution is recorded and written into the
+   * file `Trace.json` in the output directory, in the Chrome trace event
+   * format which can be opened with <a href="https://ui.perfetto.dev">
+   * Perfetto</a>. Every time step, propagation of an ensemble within a time
+   * step, the phases profiled with \ref key_gen_profiling_ "Profiling" and
+   * every output callback appear with their thread and event, which shows
+   * load imbalances between the ensembles, outputs and lattice updates. This
+   * enables the profiling as well. The timeline is kept in memory until the
+   * end of the run, so this is meant for short runs.
+   */
+  /**
+   * \see_key{key_gen_trace_}
+   */
+  inline static const Key<bool> gen_trace{
+      {"General", "Trace"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_triangular_range_,Triangular_Range,double,2.0}
@@ -1979,6 +2534,30 @@ struct InputKeys {
       CollisionCriterion::Covariant,
       {"1.7"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_cs_cache_bin_width_,Cross_Section_Cache_Bin_Width,double,0.0}
+   *
+   * Width of the \f$\sqrt{s}\f$ bins, in GeV, of a cache for the cross
+   * sections of two-body collisions. A value of 0 disables the cache.
+   *
+   * With the cache, the total cross sections and the collision branches are
+   * computed once per pair of particle types and \f$\sqrt{s}\f$ bin and then
+   * reused, which pays off in boxes and afterburner runs, where the same pairs
+   * collide over and over again. Totals are interpolated linearly between the
+   * bin edges, while branches are taken from the lower edge of the bin. Hence
+   * partial cross sections deviate by at most the bin width times their slope,
+   * e.g. by less than 1% of the \f$\Delta(1232)\f$ peak for a bin width of
+   * 0.001 GeV. Only pairs of stable particles are cached, and only if no
+   * potentials are used. The numbers of cache hits and misses are reported at
+   * the end of the run.
+   */
+  /**
+   * \see_key{key_CT_cs_cache_bin_width_}
+   */
+  inline static const Key<double> collTerm_crossSectionCacheBinWidth{
+      {"Collision_Term", "Cross_Section_Cache_Bin_Width"}, 0.0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_cs_scaling_,Cross_Section_Scaling,double,1.0}
@@ -2002,6 +2581,13 @@ struct InputKeys {
    * elastic cross sections (which are energy-dependent) with a constant value
    * \unit{in mb}. This constant elastic cross section is used for all
    * collisions.
+   *
+   * If in addition only elastic 2↔2 reactions are included, and neither
+   * resonance formation, multi-particle reactions, strings nor NNbar
+   * annihilation are enabled, and all collisions are
+   * \ref key_CT_isotropic_ "Isotropic", collisions are found without
+   * evaluating cross sections for each pair of particles. This is useful
+   * e.g. for transport-coefficient studies in a box with many species.
    */
   /**
    * \see_key{key_CT_elastic_cross_section_}
@@ -2163,6 +2749,27 @@ struct InputKeys {
   inline static const Key<bool> collTerm_decayInitial{
       {"Collision_Term", "Decay_Initial_Particles"}, true, {"3.0"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_defer_collision_search_,Defer_Collision_Search,bool,
+   * false}
+   *
+   * Postpone the search for the collisions of the particles produced in an
+   * action. Instead of being searched right away, the new particles are
+   * collected and searched together just before the evolution reaches the
+   * earliest time at which any of them could collide. Particles that decay
+   * or are consumed before that time are never searched, which saves the
+   * evaluation of their cross sections in dense phases. The order of the
+   * actions is not changed. This only takes effect if the collisions can be
+   * searched on the grid, and it can neither be combined with the
+   * `"Stochastic"` collision criterion nor with multi-particle reactions.
+   */
+  /**
+   * \see_key{key_CT_defer_collision_search_}
+   */
+  inline static const Key<bool> collTerm_deferCollisionSearch{
+      {"Collision_Term", "Defer_Collision_Search"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_included_2to2_,Included_2to2,list of strings,["All"]}
@@ -2228,6 +2835,11 @@ struct InputKeys {
    * then the default is increased to 2000 mb to function correctly (see
    * \iref{Oliinychenko:2018ugs}). The maximal cross section is scaled with
    * <tt>\ref key_CT_cs_scaling_ "Cross_Section_Scaling"</tt> factor.
+   *
+   * With the stochastic criterion it can only be given together with
+   * <tt>\ref key_CT_stochastic_thinning_ "Stochastic_Thinning"</tt> or
+   * <tt>\ref key_CT_stochastic_pair_sampling_ "Stochastic_Pair_Sampling"</tt>,
+   * which use it to bound the collision probabilities.
    */
   /**
    * \see_key{key_CT_max_cs_}
@@ -2361,6 +2973,81 @@ struct InputKeys {
   inline static const Key<double> collTerm_resonanceLifetimeModifier{
       {"Collision_Term", "Resonance_Lifetime_Modifier"}, 1.0, {"1.8"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_sample_decay_times_once_,Sample_Decay_Times_Once,bool,false}
+   *
+   * - `false` &rarr; The decay times of resonances are sampled anew in every
+   *   time step, from the width at their current mass and velocity.
+   * - `true` &rarr; The decay time of a resonance is sampled only once, when
+   *   it is first seen at the start of a time step and again after each of its
+   *   interactions, and it is stored with the particle. Until then, no widths
+   *   of the resonance are evaluated, which makes many small time steps
+   *   cheaper.
+   *
+   * Both are equivalent because of the exponential decay law, as long as the
+   * velocity and the width of a resonance only change in interactions. With
+   * potentials, which change the momenta in every time step, the stored decay
+   * times are based on the velocity at the time of sampling.
+   */
+  /**
+   * \see_key{key_CT_sample_decay_times_once_}
+   */
+  inline static const Key<bool> collTerm_sampleDecayTimesOnce{
+      {"Collision_Term", "Sample_Decay_Times_Once"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_stochastic_thinning_,Stochastic_Thinning,bool,false}
+   *
+   * Whether pairs in the stochastic collision criterion are first tested with
+   * the <tt>\ref key_CT_max_cs_ "Maximum_Cross_Section"</tt>, before their
+   * cross section is evaluated. Only allowed for the stochastic criterion.
+   *
+   * Most pairs in a cell do not collide, but their cross sections are
+   * evaluated anyway to compute the collision probability. With the thinning,
+   * the random number of a pair is first compared to the probability the
+   * maximum cross section gives, and only the pairs below it have their cross
+   * section evaluated. As long as no cross section exceeds the maximum, the
+   * collisions are sampled exactly as without thinning. Evaluated cross
+   * sections above the maximum are counted and reported at the end of the run.
+   * Since the pairs rejected by the first test are not evaluated, the
+   * collisions lost in this way cannot all be counted, so the maximum should
+   * be chosen safely above all cross sections of the run.
+   */
+  /**
+   * \see_key{key_CT_stochastic_thinning_}
+   */
+  inline static const Key<bool> collTerm_stochasticThinning{
+      {"Collision_Term", "Stochastic_Thinning"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_stochastic_pair_sampling_,Stochastic_Pair_Sampling,bool,false}
+   *
+   * Whether the pairs of a cell are sampled in the stochastic collision
+   * criterion instead of checking every pair, as in direct simulation Monte
+   * Carlo without time counter. Only allowed for the stochastic criterion.
+   *
+   * The collision probability of every pair in a cell is bounded by the one of
+   * a pair with the <tt>\ref key_CT_max_cs_ "Maximum_Cross_Section"</tt> and
+   * a relative velocity of twice the largest speed in the cell. A Poisson
+   * distributed number of random pairs with the number of pairs times this
+   * bound as mean is checked, and each collides with its probability divided
+   * by the bound. This samples the same
+   * collisions up to terms of second order in the probabilities, while the
+   * cost grows only linearly with the number of particles in a cell, which
+   * makes many test particles affordable. Cells in which the bound is not
+   * below 1 are searched pair by pair. Probabilities above the bound, i.e.
+   * cross sections above the maximum, are counted and reported at the end of
+   * the run.
+   */
+  /**
+   * \see_key{key_CT_stochastic_pair_sampling_}
+   */
+  inline static const Key<bool> collTerm_stochasticPairSampling{
+      {"Collision_Term", "Stochastic_Pair_Sampling"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_strings_,Strings,bool,
@@ -2405,6 +3092,27 @@ struct InputKeys {
   inline static const Key<bool> collTerm_stringsWithProbability{
       {"Collision_Term", "Strings_with_Probability"}, true, {"1.3"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_tabulate_parametrizations_,Tabulate_Parametrizations,bool,false}
+   *
+   * Evaluate the most frequently used cross-section parametrizations by linear
+   * interpolation in lookup tables instead of exactly. This concerns the
+   * elastic nucleon-nucleon, nucleon-antinucleon, pion-nucleon and
+   * kaon-nucleon parametrizations, the total nucleon-antinucleon one and the
+   * high-energy total cross sections. The tables are built once at the start
+   * in steps of 1 MeV in \f$\sqrt{s}\f$ up to \f$\sqrt{s}=30\f$ GeV, above
+   * which, as well as close to the thresholds, the exact parametrizations are
+   * used. The interpolated cross sections deviate from the exact ones by much
+   * less than a percent, except within 1 MeV around the discontinuities of the
+   * parametrizations.
+   */
+  /**
+   * \see_key{key_CT_tabulate_parametrizations_}
+   */
+  inline static const Key<bool> collTerm_tabulateParametrizations{
+      {"Collision_Term", "Tabulate_Parametrizations"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_two_to_one_,Two_to_One,bool,true}
@@ -2488,6 +3196,24 @@ struct InputKeys {
       1.86,
       {"0.7.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_ct_pauliblocker
+   * \optional_key{key_CT_PB_momentum_cells_,Momentum_Cells,bool,false}
+   *
+   * Whether the baryons indexed for the phase-space densities of a time step
+   * are also sorted into momentum cells, twice as large as the momentum
+   * averaging radius. A phase-space density then only looks at the particles
+   * in the few cells around its momentum, instead of all particles around its
+   * position. The cells are updated with every performed action and the
+   * densities are the same as without them. This pays off for many test
+   * particles or ensembles.
+   */
+  /**
+   * \see_key{key_CT_PB_momentum_cells_}
+   */
+  inline static const Key<bool> collTerm_pauliBlocking_momentumCells{
+      {"Collision_Term", "Pauli_Blocking", "Momentum_Cells"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_ct_string_transition
    * \optional_key{key_CT_ST_KN_offset_,KN_Offset,double,15.15}
@@ -2738,6 +3464,51 @@ struct InputKeys {
       1.0 / 3,
       {"1.5"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_ct_string_parameters
+   * \optional_key{key_CT_SP_pythia_pool_beams_,Pythia_Pool_Beams,list of PDG code pairs,[]}
+   *
+   * Pairs of incoming hadrons, which are given by their PDG codes, e.g.
+   * `[[2212, 2212], [2212, -211]]`. The PYTHIA objects of the hard string
+   * routine for these beams are initialized when setting up the simulation
+   * rather than at the first hard string process, and they are reused in all
+   * events. Like in the hard string routine, the hadrons are mapped onto
+   * protons, neutrons and charged pions first.
+   *
+   * If a tabulations directory is used, the initialization of multiparton
+   * interactions of these objects is stored there, such that further runs with
+   * the same SMASH version, particles and decay modes read it back instead of
+   * recomputing it.
+   */
+  /**
+   * \see_key{key_CT_SP_pythia_pool_beams_}
+   */
+  inline static const Key<std::vector<std::vector<int>>>
+      collTerm_stringParam_pythiaPoolBeams{
+          {"Collision_Term", "String_Parameters", "Pythia_Pool_Beams"},
+          std::vector<std::vector<int>>{},
+          {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_ct_string_parameters
+   * \optional_key{key_CT_SP_pythia_pool_sqrts_,Pythia_Pool_Sqrts,double,10.0}
+   *
+   * Center-of-mass energy \unit{in GeV}, at which the PYTHIA objects of
+   * \ref key_CT_SP_pythia_pool_beams_ "Pythia_Pool_Beams" are initialized.
+   * The energy of the hard string processes may still vary from event to
+   * event up to this value, but a stored initialization is only read back for
+   * the same value. Collisions at higher energies initialize the objects
+   * anew at the next power of two times 10 GeV. The PYTHIA objects of other
+   * beams are initialized at their first collision in the same energy bins.
+   */
+  /**
+   * \see_key{key_CT_SP_pythia_pool_sqrts_}
+   */
+  inline static const Key<double> collTerm_stringParam_pythiaPoolSqrts{
+      {"Collision_Term", "String_Parameters", "Pythia_Pool_Sqrts"},
+      10.0,
+      {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_ct_string_parameters
    * \optional_key{key_CT_SP_separate_fragment_bar_,Separate_Fragment_Baryon,bool,true}
@@ -3056,11 +3827,31 @@ struct InputKeys {
 
   /*!\Userguide
    * \page doxypage_input_conf_modi_collider
-   * \optional_key{key_MC_fermi_motion_,Fermi_Motion,string,"off"}
+   * \optional_key{key_MC_exclude_spectators_,Exclude_Spectators,bool,true}
    *
-   * - `"on"` &rarr; Switch Fermi motion on, it is recommended to also activate
-   * potentials.
-   * - `"off"` &rarr; Switch Fermi motion off.
+   * Whether nucleons of projectile and target that did not collide yet and
+   * are far away from all particles they could interact with are left out of
+   * the search for collisions. Such spectators cannot interact within the
+   * time step, hence this only speeds up the search, mostly in peripheral
+   * collisions. A spectator is searched again for collisions from the time
+   * step on in which it approaches the interaction region and is not left out
+   * anymore afterwards. This has no effect with the stochastic collision
+   * criterion, with first collisions within the same nucleus or with the
+   * initial conditions output, since there all nucleons are searched.
+   */
+  /**
+   * \see_key{key_MC_exclude_spectators_}
+   */
+  inline static const Key<bool> modi_collider_excludeSpectators{
+      {"Modi", "Collider", "Exclude_Spectators"}, true, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_collider
+   * \optional_key{key_MC_fermi_motion_,Fermi_Motion,string,"off"}
+   *
+   * - `"on"` &rarr; Switch Fermi motion on, it is recommended to also activate
+   * potentials.
+   * - `"off"` &rarr; Switch Fermi motion off.
    * - `"frozen"` &rarr; Use "frozen" if you want to use Fermi motion
    * without potentials.
    */
@@ -3070,6 +3861,30 @@ struct InputKeys {
   inline static const Key<FermiMotion> modi_collider_fermiMotion{
       {"Modi", "Collider", "Fermi_Motion"}, FermiMotion::Off, {"0.60"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_collider
+   * \optional_key{key_MC_freeze_out_rate_,Freeze_Out_Rate,double,0.0}
+   *
+   * Scattering rate \unit{in 1/fm} per particle below which the system is
+   * considered to be frozen out. After the first scattering, the number of
+   * scatterings in every time step is divided by the number of particles and
+   * by the length of the time step. Once this rate falls below the given
+   * value, the time steps are stopped: all particles are propagated along
+   * straight lines to the end time, still writing the outputs at their
+   * output times, and the resonances that have not decayed by then decay at
+   * the end time. This saves the collision searches of the free streaming
+   * stage, but changes the positions of the late decays. `0` disables the
+   * detection. It requires
+   * <tt>\ref key_CT_force_decays_at_end_ "Force_Decays_At_End"</tt> and
+   * cannot be used with potentials, forced thermalization, an expanding
+   * metric or the initial conditions output.
+   */
+  /**
+   * \see_key{key_MC_freeze_out_rate_}
+   */
+  inline static const Key<double> modi_collider_freezeOutRate{
+      {"Modi", "Collider", "Freeze_Out_Rate"}, 0.0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_collider
    * \optional_key{key_MC_initial_distance_,Initial_Distance,double,2.0}
@@ -3086,6 +3901,24 @@ struct InputKeys {
   inline static const Key<double> modi_collider_initialDistance{
       {"Modi", "Collider", "Initial_Distance"}, 2.0, {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_collider
+   * \optional_key{key_MC_prefetch_initial_states_,Prefetch_Initial_States,int,0}
+   *
+   * Number of events whose initial states are generated ahead of time on a
+   * background thread, while the previous events evolve. The initial state of
+   * every event is then sampled from its own random number stream, which is
+   * determined by the random seed of the event. The results are therefore
+   * reproducible and independent of this number, but differ from those of a
+   * run without prefetching. `0` generates the initial state of each event
+   * when the event starts.
+   */
+  /**
+   * \see_key{key_MC_prefetch_initial_states_}
+   */
+  inline static const Key<int> modi_collider_prefetchInitialStates{
+      {"Modi", "Collider", "Prefetch_Initial_States"}, 0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_C_proj_targ
    * \optional_key{key_MC_PT_diffusiveness_,Diffusiveness,double,</tt>\f$d(A)\f$<tt>}
@@ -3509,6 +4342,56 @@ struct InputKeys {
           M_PI / 2,
           {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_C_proj_targ
+   * <hr>
+   * ### Library of nucleon configurations
+   *
+   * Instead of sampling the nucleon positions and Fermi momenta in every
+   * event, the projectile and/or target can draw them from a library of
+   * configurations using the `Library` section. The library is sampled in the
+   * first event and every event uses one of its configurations, drawn at
+   * random. Spherical nuclei are rotated randomly, deformed nuclei are
+   * oriented as configured in the `Deformed` section. This is not possible
+   * for custom nuclei.
+   *
+   * \optional_key_no_line{key_MC_PT_library_file_,File,string,""}
+   *
+   * File with the library. If it exists, the configurations are read from it,
+   * otherwise the sampled library is saved to it. The file has the format of
+   * the files of custom nuclei with the three components of the Fermi
+   * momentum \unit{in GeV} as additional columns, so that it can be used as
+   * the file of a custom nucleus as well.
+   */
+  /**
+   * \see_key{key_MC_PT_library_file_}
+   */
+  inline static const Key<std::string> modi_collider_projectile_library_file{
+      {"Modi", "Collider", "Projectile", "Library", "File"}, "", {"3.2"}};
+  /**
+   * \see_key{key_MC_PT_library_file_}
+   */
+  inline static const Key<std::string> modi_collider_target_library_file{
+      {"Modi", "Collider", "Target", "Library", "File"}, "", {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_C_proj_targ
+   * \optional_key_no_line{key_MC_PT_library_size_,Size,int,0}
+   *
+   * Number of configurations sampled for the library. It is required unless
+   * the library is read from an existing `File`.
+   */
+  /**
+   * \see_key{key_MC_PT_library_size_}
+   */
+  inline static const Key<int> modi_collider_projectile_library_size{
+      {"Modi", "Collider", "Projectile", "Library", "Size"}, 0, {"3.2"}};
+  /**
+   * \see_key{key_MC_PT_library_size_}
+   */
+  inline static const Key<int> modi_collider_target_library_size{
+      {"Modi", "Collider", "Target", "Library", "Size"}, 0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_C_impact_parameter
    * \optional_key{key_MC_impact_max_,Max,double,0.0}
@@ -3737,6 +4620,19 @@ struct InputKeys {
   inline static const Key<double> modi_sphere_chargeChemicalPotential{
       {"Modi", "Sphere", "Charge_Chemical_Potential"}, 0.0, {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_sphere
+   * \optional_key{key_MS_freeze_out_rate_,Freeze_Out_Rate,double,0.0}
+   *
+   * See <tt>\ref key_MC_freeze_out_rate_ "Freeze_Out_Rate"</tt> of the
+   * collider modus.
+   */
+  /**
+   * \see_key{key_MS_freeze_out_rate_}
+   */
+  inline static const Key<double> modi_sphere_freezeOutRate{
+      {"Modi", "Sphere", "Freeze_Out_Rate"}, 0.0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_sphere
    * \optional_key{key_MS_initial_cond_,Initial_Condition,string,
@@ -4009,6 +4905,26 @@ struct InputKeys {
   inline static const Key<bool> modi_box_useThermalMultiplicities{
       {"Modi", "Box", "Use_Thermal_Multiplicities"}, false, {"1.0"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_box
+   * \optional_key{key_MB_wall_crossing_actions_,Wall_Crossing_Actions,bool,true}
+   *
+   * Whether particles crossing a wall of the box are put back at the opposite
+   * wall by wall-crossing actions, at the time they cross it. Wall crossings
+   * are then written to the `Collisions` output and counted as interactions.
+   * If `false`, particles which left the box during a time step are folded
+   * back into it at the end of the time step instead, which is cheaper in
+   * long runs, where wall crossings can outnumber collisions. Collisions
+   * across the walls are still found, but particles produced close to a wall
+   * only find collision partners across it in the next time step, and wall
+   * crossings are not written to any output.
+   */
+  /**
+   * \see_key{key_MB_wall_crossing_actions_}
+   */
+  inline static const Key<bool> modi_box_wallCrossingActions{
+      {"Modi", "Box", "Wall_Crossing_Actions"}, true, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_box
    * <hr>
@@ -4106,6 +5022,21 @@ struct InputKeys {
   inline static const Key<int> modi_list_shiftId{
       {"Modi", "List", "Shift_Id"}, 0, {"0.60"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_list
+   * \optional_key{key_ML_prefetch_initial_states_,Prefetch_Initial_States,int,0}
+   *
+   * Number of events whose particle lists are read, checked and propagated
+   * back to the same time ahead of time on a background thread, while the
+   * previous events evolve. The results do not depend on this number. `0`
+   * reads each event when it starts.
+   */
+  /**
+   * \see_key{key_ML_prefetch_initial_states_}
+   */
+  inline static const Key<int> modi_list_prefetchInitialStates{
+      {"Modi", "List", "Prefetch_Initial_States"}, 0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_listbox
    * \required_key{key_MLB_file_dir_,File_Directory,string}
@@ -4171,6 +5102,20 @@ struct InputKeys {
   inline static const Key<int> modi_listBox_shiftId{
       {"Modi", "ListBox", "Shift_Id"}, 0, {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_listbox
+   * \optional_key{key_MLB_prefetch_initial_states_,Prefetch_Initial_States,int,0}
+   *
+   * See &nbsp;
+   * <tt>\ref key_ML_prefetch_initial_states_
+   * "List: Prefetch_Initial_States"</tt>.
+   */
+  /**
+   * \see_key{key_MLB_prefetch_initial_states_}
+   */
+  inline static const Key<int> modi_listBox_prefetchInitialStates{
+      {"Modi", "ListBox", "Prefetch_Initial_States"}, 0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    *
@@ -4192,6 +5137,36 @@ struct InputKeys {
   inline static const Key<std::string> output_densityType{
       {"Output", "Density_Type"}, "none", {"0.60"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_interaction_density_,Interaction_Density,string,
+   * "Exact"}
+   *
+   * Determines how the density of the type chosen by
+   * <tt>\ref key_output_density_type_ "Density_Type"</tt> is evaluated at the
+   * interaction points. Possible values are:
+   * - `"Exact"` &rarr; The smeared density of all particles of the ensemble of
+   *   the interaction is evaluated at the interaction point. Every interaction
+   *   then loops over all particles, which dominates the run time of large
+   *   systems with collision output.
+   * - `"Lattice"` &rarr; The density of all ensembles is computed on a copy of
+   *   the lattice configured in the \ref doxypage_input_conf_lattice section
+   *   at the beginning of every time step, and the value at the node closest
+   *   to the interaction point is written. The accuracy is limited by the cell
+   *   size of the lattice and the duration of the time step, but the cost of
+   *   an interaction no longer grows with the number of particles.
+   *
+   * In both cases, the density is only evaluated if an output writing the
+   * interactions uses it.
+   */
+  /**
+   * \see_key{key_output_interaction_density_}
+   */
+  inline static const Key<InteractionDensityMode> output_interactionDensity{
+      {"Output", "Interaction_Density"},
+      InteractionDensityMode::Exact,
+      {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * \optional_key{key_output_out_interval_,Output_Interval,double,
@@ -4229,6 +5204,116 @@ struct InputKeys {
   inline static const Key<std::vector<double>> output_outputTimes{
       {"Output", "Output_Times"}, {"1.7"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_binary_buffer_size_,Binary_Buffer_Size,int,65536}
+   *
+   * Number of bytes that outputs in the `"Binary"` format collect in memory
+   * before writing them to the file. Every block (particles, interaction or
+   * event end) is serialised completely into the buffer, which is written with
+   * a single call once it holds at least this many bytes and at every event
+   * end. With `0` every block is written on its own. The content of the files
+   * does not depend on this value.
+   */
+  /**
+   * \see_key{key_output_binary_buffer_size_}
+   */
+  inline static const Key<int> output_binaryBufferSize{
+      {"Output", "Binary_Buffer_Size"}, 65536, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_binary_event_index_,Binary_Event_Index,bool,false}
+   *
+   * Whether outputs in the `"Binary"` format end with an index of their
+   * events, which gives the offsets of the blocks and the particle block of
+   * every event. Readers can then jump to any event without scanning the file,
+   * see \ref doxypage_output_binary. Such files have the format version 10.
+   */
+  /**
+   * \see_key{key_output_binary_event_index_}
+   */
+  inline static const Key<bool> output_binaryEventIndex{
+      {"Output", "Binary_Event_Index"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_overlap_output_times_,Overlap_Output_Times,bool,false}
+   *
+   * Whether the outputs at the output times are computed and written on a
+   * thread of their own, while the time evolution continues. At every output
+   * time, only a copy of the particles and of the lattices is taken, and the
+   * mean field energy, the conserved quantities, the lattice outputs and the
+   * particle outputs are computed from the copy until the next output time or
+   * the end of the event. This does not change the content of the outputs.
+   * If an output at the output times also receives the interactions, or if
+   * the thermalizer is used, the output times are not overlapped.
+   */
+  /**
+   * \see_key{key_output_overlap_output_times_}
+   */
+  inline static const Key<bool> output_overlapOutputTimes{
+      {"Output", "Overlap_Output_Times"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * ### &diams; Root_Options
+   * Settings of all files of the `"Root"` format. They only affect the size
+   * of the files and the speed of writing them, but not their content.
+   *
+   * \optional_key_no_line{key_output_root_compression_algorithm_,Compression_Algorithm,string,"Default"}
+   *
+   * Compression algorithm of the files, one of `"ZLIB"`, `"LZMA"`, `"LZ4"`
+   * and `"ZSTD"`. With `"Default"` the default compression of the installed
+   * ROOT version is used and `Compression_Level` is ignored.
+   *
+   * \optional_key_no_line{key_output_root_compression_level_,Compression_Level,int,1}
+   *
+   * Compression level from `0` (no compression) to `9` (smallest files).
+   *
+   * \optional_key_no_line{key_output_root_basket_size_,Basket_Size,int,32000}
+   *
+   * Size in bytes of the buffer of every branch, which is compressed and
+   * written as a whole.
+   *
+   * \optional_key_no_line{key_output_root_auto_flush_,Auto_Flush,int,-30000000}
+   *
+   * If positive, the number of tree entries after which all buffers are
+   * written to the file. If negative, the buffers are written once they
+   * hold this many compressed bytes. See `TTree::SetAutoFlush`.
+   *
+   * \optional_key_no_line{key_output_root_autosave_frequency_,Autosave_Frequency,int,1000}
+   *
+   * Number of events after which the trees are saved to the file, such that
+   * it can be read even if SMASH does not finish. Saving is expensive; with
+   * `0` the trees are only saved at the end of the run.
+   */
+  /**
+   * \see_key{key_output_root_compression_algorithm_}
+   */
+  inline static const Key<std::string> output_root_compressionAlgorithm{
+      {"Output", "Root_Options", "Compression_Algorithm"}, "Default", {"3.2"}};
+  /**
+   * \see_key{key_output_root_compression_level_}
+   */
+  inline static const Key<int> output_root_compressionLevel{
+      {"Output", "Root_Options", "Compression_Level"}, 1, {"3.2"}};
+  /**
+   * \see_key{key_output_root_basket_size_}
+   */
+  inline static const Key<int> output_root_basketSize{
+      {"Output", "Root_Options", "Basket_Size"}, 32000, {"3.2"}};
+  /**
+   * \see_key{key_output_root_auto_flush_}
+   */
+  inline static const Key<int> output_root_autoFlush{
+      {"Output", "Root_Options", "Auto_Flush"}, -30000000, {"3.2"}};
+  /**
+   * \see_key{key_output_root_autosave_frequency_}
+   */
+  inline static const Key<int> output_root_autosaveFrequency{
+      {"Output", "Root_Options", "Autosave_Frequency"}, 1000, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
@@ -4291,6 +5376,21 @@ struct InputKeys {
   /**
    * \see_key{key_output_content_format_}
    */
+  inline static const Key<std::vector<std::string>> output_analysis_format{
+      {"Output", "Analysis", "Format"}, {}, {"3.2"}};
+  /**
+   * \see_key{key_output_content_format_}
+   */
+  inline static const Key<std::vector<std::string>> output_greenKubo_format{
+      {"Output", "Green_Kubo", "Format"}, {}, {"3.2"}};
+  /**
+   * \see_key{key_output_content_format_}
+   */
+  inline static const Key<std::vector<std::string>> output_digest_format{
+      {"Output", "Digest", "Format"}, {}, {"3.2"}};
+  /**
+   * \see_key{key_output_content_format_}
+   */
   inline static const Key<std::vector<std::string>> output_coulomb_format{
       {"Output", "Coulomb", "Format"}, {}, {"2.1"}};
   /**
@@ -4300,6 +5400,85 @@ struct InputKeys {
       output_thermodynamics_format{
           {"Output", "Thermodynamics", "Format"}, {}, {"1.2"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_content_asynchronous_,Asynchronous,bool,false}
+   *
+   * &rArr; Only for the `Particles`, `Collisions`, `Dileptons`, `Photons`,
+   * `Initial_Conditions` and `Rivet` contents.
+   *
+   * Write the outputs of this content on a separate thread per format, so
+   * that formatting and writing do not halt the evolution. The particle lists
+   * and interactions are copied into a bounded queue, from which the writer
+   * thread takes them in order. All pending data is written at the end of each
+   * event, except for the `Rivet` content, whose analysis of an event runs
+   * while the next event is evolved. Whether the outputs run asynchronously
+   * does not change their content.
+   */
+  /**
+   * \see_key{key_output_content_asynchronous_}
+   */
+  inline static const Key<bool> output_particles_asynchronous{
+      {"Output", "Particles", "Asynchronous"}, false, {"3.2"}};
+  /**
+   * \see_key{key_output_content_asynchronous_}
+   */
+  inline static const Key<bool> output_collisions_asynchronous{
+      {"Output", "Collisions", "Asynchronous"}, false, {"3.2"}};
+  /**
+   * \see_key{key_output_content_asynchronous_}
+   */
+  inline static const Key<bool> output_dileptons_asynchronous{
+      {"Output", "Dileptons", "Asynchronous"}, false, {"3.2"}};
+  /**
+   * \see_key{key_output_content_asynchronous_}
+   */
+  inline static const Key<bool> output_photons_asynchronous{
+      {"Output", "Photons", "Asynchronous"}, false, {"3.2"}};
+  /**
+   * \see_key{key_output_content_asynchronous_}
+   */
+  inline static const Key<bool> output_initialConditions_asynchronous{
+      {"Output", "Initial_Conditions", "Asynchronous"}, false, {"3.2"}};
+  /**
+   * \see_key{key_output_content_asynchronous_}
+   */
+  inline static const Key<bool> output_rivet_asynchronous{
+      {"Output", "Rivet", "Asynchronous"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_content_ensemble_shards_,Ensemble_Shards,bool,false}
+   *
+   * &rArr; Only for the `Particles`, `Collisions` and `Initial_Conditions`
+   * contents.
+   *
+   * Write the outputs of every ensemble into files of their own, placed in
+   * the subdirectories `ensemble_0`, `ensemble_1`, ... of the output
+   * directory. Each ensemble keeps the event numbers it would have in a
+   * single file, i.e. `event * Ensembles + ensemble`. The shards can be
+   * written without contention, in particular together with `Asynchronous`,
+   * which then uses a writer thread per shard. Files of the `Binary` format
+   * can be merged into the file of a single output with
+   * `smash::merge_binary_shards`. This option has no effect with a single
+   * ensemble, except for the output files being placed in `ensemble_0`.
+   */
+  /**
+   * \see_key{key_output_content_ensemble_shards_}
+   */
+  inline static const Key<bool> output_particles_ensembleShards{
+      {"Output", "Particles", "Ensemble_Shards"}, false, {"3.2"}};
+  /**
+   * \see_key{key_output_content_ensemble_shards_}
+   */
+  inline static const Key<bool> output_collisions_ensembleShards{
+      {"Output", "Collisions", "Ensemble_Shards"}, false, {"3.2"}};
+  /**
+   * \see_key{key_output_content_ensemble_shards_}
+   */
+  inline static const Key<bool> output_initialConditions_ensembleShards{
+      {"Output", "Initial_Conditions", "Ensemble_Shards"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
@@ -4343,6 +5522,138 @@ struct InputKeys {
   inline static const Key<OutputOnlyFinal> output_particles_onlyFinal{
       {"Output", "Particles", "Only_Final"}, OutputOnlyFinal::Yes, {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_particles_single_precision_,
+   * Single_Precision,bool,false}
+   *
+   * &rArr; Only `Columnar` format.
+   *
+   * Whether times, positions, masses and momenta are stored as single-precision
+   * floating-point numbers, which halves their size.
+   */
+  /**
+   * \see_key{key_output_particles_single_precision_}
+   */
+  inline static const Key<bool> output_particles_singlePrecision{
+      {"Output", "Particles", "Single_Precision"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_particles_compression_level_,
+   * Compression_Level,int,1}
+   *
+   * &rArr; Only `Columnar` and `VTK_XML` formats.
+   *
+   * zlib compression level from 0 (no compression) to 9 (best compression)
+   * applied to every column or data array. The fastest level 1 already removes most of the
+   * redundancy of the integer columns. Without zlib support compiled in, the
+   * columns are stored uncompressed.
+   */
+  /**
+   * \see_key{key_output_particles_compression_level_}
+   */
+  inline static const Key<int> output_particles_compressionLevel{
+      {"Output", "Particles", "Compression_Level"}, 1, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_content_hepmc_batch_size_,
+   * HepMC_Batch_Size,int,0}
+   *
+   * &rArr; Only `HepMC_asciiv3` and `HepMC_treeroot` formats of the
+   * `Particles` and `Collisions` contents.
+   *
+   * If positive, the HepMC events are written on a writer thread of the
+   * output, which receives them in batches of this many events. The next
+   * events are built meanwhile. With `0` every event is written right after it
+   * has been built. The content of the files does not depend on this key.
+   */
+  /**
+   * \see_key{key_output_content_hepmc_batch_size_}
+   */
+  inline static const Key<int> output_particles_hepmcBatchSize{
+      {"Output", "Particles", "HepMC_Batch_Size"}, 0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_particles_filter_,Filter,map,
+   * </tt><b>no default</b><tt>}
+   *
+   * Only the particles passing all criteria of this section are written by
+   * all formats, e.g. only charged hadrons at midrapidity. They are selected
+   * before being formatted and keep their ids, and the numbers of particles
+   * in the particle blocks count only the selected ones. Windows include their
+   * lower edge but not their upper edge.
+   *
+   * - `Species` (list of ints) &rarr; PDG codes of the written species
+   * - `Charge` (string, `"Any"`) &rarr; `"Any"`, `"Charged"` or `"Neutral"`
+   * - `Rapidity_Window` (list of two doubles) &rarr; lower and upper edge of
+   *   the rapidity \f$y\f$
+   * - `Transverse_Momentum_Window` (list of two doubles) &rarr; lower and
+   *   upper edge of the transverse momentum in GeV
+   * - `Only_Participants` (bool, `false`) &rarr; whether only particles that
+   *   took part in a collision are written
+   *
+   * For example, the charged pions and kaons with \f$|y|<1\f$ are selected by
+   *\verbatim
+   Output:
+       Particles:
+           Format: ["Binary"]
+           Filter:
+               Species: [211, -211, 321, -321]
+               Rapidity_Window: [-1.0, 1.0]
+   \endverbatim
+   */
+  /**
+   * \see_key{key_output_particles_filter_}
+   */
+  inline static const Key<std::vector<int>> output_particles_filter_species{
+      {"Output", "Particles", "Filter", "Species"}, {"3.2"}};
+  /**
+   * \see_key{key_output_particles_filter_}
+   */
+  inline static const Key<std::string> output_particles_filter_charge{
+      {"Output", "Particles", "Filter", "Charge"}, "Any", {"3.2"}};
+  /**
+   * \see_key{key_output_particles_filter_}
+   */
+  inline static const Key<std::array<double, 2>>
+      output_particles_filter_rapidityWindow{
+          {"Output", "Particles", "Filter", "Rapidity_Window"}, {"3.2"}};
+  /**
+   * \see_key{key_output_particles_filter_}
+   */
+  inline static const Key<std::array<double, 2>>
+      output_particles_filter_transverseMomentumWindow{
+          {"Output", "Particles", "Filter", "Transverse_Momentum_Window"},
+          {"3.2"}};
+  /**
+   * \see_key{key_output_particles_filter_}
+   */
+  inline static const Key<bool> output_particles_filter_onlyParticipants{
+      {"Output", "Particles", "Filter", "Only_Participants"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_particles_delta_blocks_,Delta_Blocks,bool,
+   * false}
+   *
+   * &rArr; Only `Binary` format, if `Only_Final` is `No`.
+   *
+   * Whether the intermediate outputs only contain the particles that were
+   * created, changed their momentum or left their straight line since the
+   * previous output, together with the ids of the removed particles. The start
+   * and the end of every event are still written as complete particle lists.
+   * The intermediate particle lists can be reconstructed with the binary
+   * reader of SMASH, see \ref doxypage_output_binary.
+   */
+  /**
+   * \see_key{key_output_particles_delta_blocks_}
+   */
+  inline static const Key<bool> output_particles_deltaBlocks{
+      {"Output", "Particles", "Delta_Blocks"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
@@ -4377,11 +5688,44 @@ struct InputKeys {
   inline static const Key<bool> output_collisions_printStartEnd{
       {"Output", "Collisions", "Print_Start_End"}, false, {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_collisions_hepmc_batch_size_,
+   * HepMC_Batch_Size,int,0}
+   *
+   * See the <tt>\ref key_output_content_hepmc_batch_size_
+   * "HepMC_Batch_Size"</tt> key of the `Particles` content.
+   */
+  /**
+   * \see_key{key_output_collisions_hepmc_batch_size_}
+   */
+  inline static const Key<int> output_collisions_hepmcBatchSize{
+      {"Output", "Collisions", "HepMC_Batch_Size"}, 0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_collisions_hepmc_min_elastic_sqrts_,
+   * HepMC_Min_Elastic_Sqrts,double,0.0}
+   *
+   * &rArr; Only `HepMC_asciiv3` and `HepMC_treeroot` formats.
+   *
+   * Elastic scatterings with a center-of-mass energy below this value
+   * \unit{in GeV} are not written as vertices of the event tree. The incoming
+   * particles carry the momenta of the outgoing particles instead and continue
+   * to their next vertex. This shrinks the output considerably, since most
+   * scatterings in the late stage are soft elastic ones.
+   */
+  /**
+   * \see_key{key_output_collisions_hepmc_min_elastic_sqrts_}
+   */
+  inline static const Key<double> output_collisions_hepmcMinElasticSqrts{
+      {"Output", "Collisions", "HepMC_Min_Elastic_Sqrts"}, 0.0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
    * ### &diams; Dileptons
-   * &rArr; Only `Oscar1999`, `Oscar2013` and `Binary` formats.
+   * &rArr; Only `Oscar1999`, `Oscar2013`, `Binary` and `Histograms` formats.
    *
    * \optional_key_no_line{key_output_dileptons_extended_,Extended,bool,false}
    *
@@ -4399,7 +5743,7 @@ struct InputKeys {
    * \page doxypage_input_conf_output
    * <hr>
    * ### &diams; Photons
-   * &rArr; Only `Oscar1999`, `Oscar2013` and `Binary` formats.
+   * &rArr; Only `Oscar1999`, `Oscar2013`, `Binary` and `Histograms` formats.
    *
    * \optional_key_no_line{key_output_photons_extended_,Extended,bool,false}
    *
@@ -4413,6 +5757,64 @@ struct InputKeys {
   inline static const Key<bool> output_photons_extended{
       {"Output", "Photons", "Extended"}, false, {"1.5"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \anchor input_output_emission_histograms_
+   * The following options of the `Dileptons` and `Photons` contents only
+   * affect the `Histograms` format (see \ref
+   * doxypage_output_emission_histograms "here" for more information about the
+   * format).
+   *
+   * \optional_key_no_line{key_output_dileptons_mass_bins_,Mass_Bins,
+   * list of three doubles,[0.0\, 1.2\, 120]}
+   *
+   * Only for `Dileptons`. Lower edge, upper edge (in GeV) and number of bins
+   * of the invariant mass spectra.
+   *
+   * \optional_key_no_line{key_output_dileptons_transverse_momentum_bins_,
+   * Transverse_Momentum_Bins,list of three doubles,[0.0\, 3.0\, 60]}
+   *
+   * Lower edge, upper edge (in GeV) and number of bins of the transverse
+   * momentum spectra. The same key exists for `Photons`.
+   *
+   * \optional_key_no_line{key_output_dileptons_rapidity_bins_,Rapidity_Bins,
+   * list of three doubles,[-4.0\, 4.0\, 40]}
+   *
+   * Lower edge, upper edge and number of bins of the rapidity spectra. The
+   * same key exists for `Photons`.
+   */
+  /**
+   * \see_key{key_output_dileptons_mass_bins_}
+   */
+  inline static const Key<std::array<double, 3>> output_dileptons_massBins{
+      {"Output", "Dileptons", "Mass_Bins"}, {{0., 1.2, 120.}}, {"3.2"}};
+  /**
+   * \see_key{key_output_dileptons_transverse_momentum_bins_}
+   */
+  inline static const Key<std::array<double, 3>>
+      output_dileptons_transverseMomentumBins{
+          {"Output", "Dileptons", "Transverse_Momentum_Bins"},
+          {{0., 3., 60.}},
+          {"3.2"}};
+  /**
+   * \see_key{key_output_dileptons_rapidity_bins_}
+   */
+  inline static const Key<std::array<double, 3>> output_dileptons_rapidityBins{
+      {"Output", "Dileptons", "Rapidity_Bins"}, {{-4., 4., 40.}}, {"3.2"}};
+  /**
+   * \see_key{key_output_dileptons_transverse_momentum_bins_}
+   */
+  inline static const Key<std::array<double, 3>>
+      output_photons_transverseMomentumBins{
+          {"Output", "Photons", "Transverse_Momentum_Bins"},
+          {{0., 3., 60.}},
+          {"3.2"}};
+  /**
+   * \see_key{key_output_dileptons_rapidity_bins_}
+   */
+  inline static const Key<std::array<double, 3>> output_photons_rapidityBins{
+      {"Output", "Photons", "Rapidity_Bins"}, {{-4., 4., 40.}}, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
@@ -4675,6 +6077,129 @@ struct InputKeys {
   inline static const Key<std::vector<std::string>> output_rivet_weights_select{
       {"Output", "Rivet", "Weights", "Select"}, {"2.0.2"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * <hr> \anchor input_output_analysis_
+   * ### &diams; Analysis
+   * &rArr; Only `ASCII` format (see \ref doxypage_output_analysis "here" for
+   * more information about the format).
+   *
+   * \optional_key_no_line{key_output_analysis_species_,Species,list of ints,
+   * [211\, -211\, 321\, -321\, 2212\, -2212]}
+   *
+   * PDG codes of the species whose spectra and flow are evaluated.
+   *
+   * \optional_key_no_line{key_output_analysis_rapidity_bins_,Rapidity_Bins,
+   * list of three doubles,[-4.0\, 4.0\, 40]}
+   *
+   * Lower edge, upper edge and number of bins of the rapidity spectra.
+   *
+   * \optional_key_no_line{key_output_analysis_transverse_momentum_bins_,
+   * Transverse_Momentum_Bins,list of three doubles,[0.0\, 3.0\, 30]}
+   *
+   * Lower edge, upper edge (in GeV) and number of bins of the transverse
+   * momentum spectra and of the flow coefficients.
+   *
+   * \optional_key_no_line{key_output_analysis_midrapidity_cut_,
+   * Midrapidity_Cut,double,0.5}
+   *
+   * Only particles with a rapidity \f$|y|\f$ below this value enter the
+   * transverse momentum spectra and the flow coefficients.
+   *
+   * \optional_key_no_line{key_output_analysis_flow_harmonics_,Flow_Harmonics,
+   * list of ints,[1\, 2\, 3]}
+   *
+   * Harmonics \f$n\f$ of the flow coefficients
+   * \f$v_n=\langle\cos(n\phi)\rangle\f$ with respect to the reaction plane.
+   */
+  /**
+   * \see_key{key_output_analysis_species_}
+   */
+  inline static const Key<std::vector<int>> output_analysis_species{
+      {"Output", "Analysis", "Species"},
+      {{211, -211, 321, -321, 2212, -2212}},
+      {"3.2"}};
+  /**
+   * \see_key{key_output_analysis_rapidity_bins_}
+   */
+  inline static const Key<std::array<double, 3>> output_analysis_rapidityBins{
+      {"Output", "Analysis", "Rapidity_Bins"}, {{-4., 4., 40.}}, {"3.2"}};
+  /**
+   * \see_key{key_output_analysis_transverse_momentum_bins_}
+   */
+  inline static const Key<std::array<double, 3>>
+      output_analysis_transverseMomentumBins{
+          {"Output", "Analysis", "Transverse_Momentum_Bins"},
+          {{0., 3., 30.}},
+          {"3.2"}};
+  /**
+   * \see_key{key_output_analysis_midrapidity_cut_}
+   */
+  inline static const Key<double> output_analysis_midrapidityCut{
+      {"Output", "Analysis", "Midrapidity_Cut"}, 0.5, {"3.2"}};
+  /**
+   * \see_key{key_output_analysis_flow_harmonics_}
+   */
+  inline static const Key<std::vector<int>> output_analysis_flowHarmonics{
+      {"Output", "Analysis", "Flow_Harmonics"}, {{1, 2, 3}}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * <hr> \anchor input_output_green_kubo_
+   * ### &diams; Green_Kubo
+   * &rArr; Only `ASCII` format (see \ref doxypage_output_green_kubo "here" for
+   * more information about the format).
+   *
+   * The correlation functions are sampled at the output times, so that the
+   * `Output_Interval` sets the resolution of the shortest lags. The output is
+   * meant for boxes in equilibrium.
+   *
+   * \optional_key_no_line{key_output_green_kubo_points_per_level_,
+   * Points_Per_Level,int,16}
+   *
+   * Number of lags per level of the multi-tau correlators, an even number.
+   * The first level covers the lags of 0 to `Points_Per_Level`-1 output
+   * intervals, each further level the second half of this range on a twice
+   * as coarse grid.
+   *
+   * \optional_key_no_line{key_output_green_kubo_levels_,Levels,int,16}
+   *
+   * Number of levels of the multi-tau correlators. The longest lag is
+   * `Points_Per_Level` \f$\cdot\;2^{\text{Levels}-1}\f$ output intervals.
+   */
+  /**
+   * \see_key{key_output_green_kubo_points_per_level_}
+   */
+  inline static const Key<int> output_greenKubo_pointsPerLevel{
+      {"Output", "Green_Kubo", "Points_Per_Level"}, 16, {"3.2"}};
+  /**
+   * \see_key{key_output_green_kubo_levels_}
+   */
+  inline static const Key<int> output_greenKubo_levels{
+      {"Output", "Green_Kubo", "Levels"}, 16, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * <hr> \anchor input_output_digest_
+   * ### &diams; Digest
+   * &rArr; Only `ASCII` format (see \ref doxypage_output_digest "here" for
+   * more information about the format).
+   *
+   * \optional_key_no_line{key_output_digest_reference_,Reference,string,
+   * </tt>no comparison<tt>}
+   *
+   * Digest file `digest.dat` of a reference run. The digest of every event is
+   * compared to the one of the same event in this file, and the first event
+   * which differs is reported. This is meant to check quickly that e.g. a
+   * parallel or otherwise optimized run gives the same results as a reference
+   * run, without comparing the full outputs.
+   */
+  /**
+   * \see_key{key_output_digest_reference_}
+   */
+  inline static const Key<std::string> output_digest_reference{
+      {"Output", "Digest", "Reference"}, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
@@ -4721,6 +6246,40 @@ struct InputKeys {
   inline static const Key<bool> output_thermodynamics_onlyParticipants{
       {"Output", "Thermodynamics", "Only_Participants"}, false, {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_thermo_compression_level_,
+   * Compression_Level,int,1}
+   *
+   * &rArr; Only `VTK_XML` format.
+   *
+   * zlib compression level from 0 (no compression) to 9 (best compression) of
+   * the lattice files. Without zlib support compiled in, the files are stored
+   * uncompressed.
+   */
+  /**
+   * \see_key{key_output_thermo_compression_level_}
+   */
+  inline static const Key<int> output_thermodynamics_compressionLevel{
+      {"Output", "Thermodynamics", "Compression_Level"}, 1, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_thermo_downsampling_,Downsampling,int,1}
+   *
+   * &rArr; Only `VTK_XML` format.
+   *
+   * Only every n-th lattice node in each direction is written, starting from
+   * the first node in the region given by `Region_Min` and `Region_Max`. The
+   * written values are those at the nodes, they are not averaged over the
+   * skipped ones.
+   */
+  /**
+   * \see_key{key_output_thermo_downsampling_}
+   */
+  inline static const Key<int> output_thermodynamics_downsampling{
+      {"Output", "Thermodynamics", "Downsampling"}, 1, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * \optional_key_no_line{key_output_thermo_position_,Position,
@@ -4762,6 +6321,50 @@ struct InputKeys {
       output_thermodynamics_quantites{
           {"Output", "Thermodynamics", "Quantities"}, {}, {"1.0"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_thermo_region_max_,Region_Max,
+   * list of 3 doubles,unbounded}
+   *
+   * &rArr; Only `VTK_XML` format.
+   *
+   * Upper corner of the region (\unit{in fm}) of the lattice nodes that are
+   * written, see `Region_Min`.
+   */
+  /**
+   * \see_key{key_output_thermo_region_max_}
+   */
+  inline static const Key<std::array<double, 3>>
+      output_thermodynamics_regionMax{
+          {"Output", "Thermodynamics", "Region_Max"},
+          {{std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::max()}},
+          {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_thermo_region_min_,Region_Min,
+   * list of 3 doubles,unbounded}
+   *
+   * &rArr; Only `VTK_XML` format.
+   *
+   * Lower corner of the region (\unit{in fm}) of the lattice nodes that are
+   * written. Only nodes with their cell center between `Region_Min` and
+   * `Region_Max` in all directions are written, which allows to restrict
+   * large lattices to the region of interest.
+   */
+  /**
+   * \see_key{key_output_thermo_region_min_}
+   */
+  inline static const Key<std::array<double, 3>>
+      output_thermodynamics_regionMin{
+          {"Output", "Thermodynamics", "Region_Min"},
+          {{-std::numeric_limits<double>::max(),
+            -std::numeric_limits<double>::max(),
+            -std::numeric_limits<double>::max()}},
+          {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * \optional_key_no_line{key_output_thermo_smearing_,Smearing,bool,true}
@@ -4817,6 +6420,31 @@ struct InputKeys {
   inline static const Key<DensityType> output_thermodynamics_type{
       {"Output", "Thermodynamics", "Type"}, DensityType::Baryon, {"1.0"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_lattice
+   * \optional_key{key_lattice_adaptive_interval_,Adaptive_Interval,double,0.0}
+   *
+   * Time interval \unit{in fm} after which the lattice follows the particles.
+   * A value of 0 keeps the lattice fixed.
+   *
+   * At the start of every event and after every interval, the lattice is
+   * moved by whole cells to be centred on the bounding box of all particles.
+   * If the box, widened by the interval and the smearing range, does not fit
+   * any more, the lattice grows, while the cell sizes stay the same. The
+   * lattice never gets smaller than configured by `Sizes`, so these only have
+   * to cover the initial state. Values of quantities on the nodes kept by the
+   * lattice are kept as well, such that time derivatives stay valid.
+   *
+   * Only non-periodic lattices can follow the particles, and the
+   * \ref doxypage_output_thermodyn_lattice "Thermodynamic Lattice Output",
+   * which assumes a fixed grid, cannot be used with it.
+   */
+  /**
+   * \see_key{key_lattice_adaptive_interval_}
+   */
+  inline static const Key<double> lattice_adaptiveInterval{
+      {"Lattice", "Adaptive_Interval"}, 0.0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_lattice
    * \required_key{key_lattice_automatic_,Automatic,bool}
@@ -4907,6 +6535,24 @@ struct InputKeys {
   inline static const Key<bool> lattice_potentialsAffectThreshold{
       {"Lattice", "Potentials_Affect_Thresholds"}, false, {"1.3"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_lattice
+   * \optional_key{key_lattice_pot_update_interval_,Potentials_Update_Interval,int,1}
+   *
+   * Number of time steps after which the densities, potentials and forces on
+   * the lattice are recomputed. In the time steps in between, the forces of
+   * the last update are reused, which saves most of the cost of the
+   * potentials if the time step is small compared to the time scale on which
+   * the mean field changes. Finite-difference time derivatives are then taken
+   * over the whole interval. The forces of potentials evaluated outside of
+   * the lattice are not affected.
+   */
+  /**
+   * \see_key{key_lattice_pot_update_interval_}
+   */
+  inline static const Key<int> lattice_potentialsUpdateInterval{
+      {"Lattice", "Potentials_Update_Interval"}, 1, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_lattice
    * \optional_key{key_lattice_sizes_,Sizes,list of 3 doubles,
@@ -4936,6 +6582,27 @@ struct InputKeys {
   inline static const Key<bool> potentials_use_potentials_outside_lattice{
       {"Potentials", "Use_Potentials_Outside_Lattice"}, true, {"3.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_potentials
+   * \optional_key{key_potentials_leapfrog_,Leapfrog,bool,false}
+   *
+   * Whether to propagate the particles in the potentials with the leapfrog
+   * (kick-drift-kick) scheme. By default, the momenta are changed by the
+   * forces of a whole time step at its end. With the leapfrog scheme, they
+   * are changed by half a time step of the forces at the beginning and at
+   * the end of every time step, such that positions and momenta are known at
+   * the same times. The scheme is of second order in the time step and
+   * conserves the energy better, which allows for a larger
+   * \ref key_gen_delta_time_ "Delta_Time" at the same accuracy. The forces
+   * at the end of a time step are reused for the beginning of the next one,
+   * so that the potentials are not evaluated more often.
+   */
+  /**
+   * \see_key{key_potentials_leapfrog_}
+   */
+  inline static const Key<bool> potentials_leapfrog{
+      {"Potentials", "Leapfrog"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_pot_skyrme
    * \required_key{key_potentials_skyrme_a_,Skyrme_A,double}
@@ -5051,6 +6718,24 @@ struct InputKeys {
   inline static const Key<std::vector<double>> potentials_coulomb_rCut{
       {"Potentials", "Coulomb", "R_Cut"}, {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_pot_coulomb
+   * \optional_key{key_potentials_coulomb_use_fft_,Use_FFT,bool,false}
+   *
+   * Whether to compute the electric and magnetic fields by fast Fourier
+   * transforms of the charge density and current on the whole lattice. The
+   * fields are the same as by the direct sum over the integration volume, up
+   * to rounding, but the computation is much faster for large values of
+   * <tt>\ref key_potentials_coulomb_r_cut_ "R_Cut"</tt>. It needs memory for
+   * several complex copies of the lattice, padded to up to twice its size in
+   * every direction if the lattice is not periodic.
+   */
+  /**
+   * \see_key{key_potentials_coulomb_use_fft_}
+   */
+  inline static const Key<bool> potentials_coulomb_useFFT{
+      {"Potentials", "Coulomb", "Use_FFT"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_pot_momentum_dependence
    * \required_key{key_potentials_momentum_dependence_C,C,double}
@@ -5212,8 +6897,10 @@ struct InputKeys {
       std::reference_wrapper<const Key<std::array<double, 2>>>,
       std::reference_wrapper<const Key<std::array<double, 3>>>,
       std::reference_wrapper<const Key<std::pair<double, double>>>,
+      std::reference_wrapper<const Key<std::vector<int>>>,
       std::reference_wrapper<const Key<std::vector<double>>>,
       std::reference_wrapper<const Key<std::vector<std::string>>>,
+      std::reference_wrapper<const Key<std::vector<std::vector<int>>>>,
       std::reference_wrapper<const Key<std::set<ThermodynamicQuantity>>>,
       std::reference_wrapper<const Key<std::map<PdgCode, int>>>,
       std::reference_wrapper<const Key<std::map<std::string, std::string>>>,
@@ -5226,6 +6913,7 @@ struct InputKeys {
       std::reference_wrapper<const Key<ExpansionMode>>,
       std::reference_wrapper<const Key<FermiMotion>>,
       std::reference_wrapper<const Key<FieldDerivativesMode>>,
+      std::reference_wrapper<const Key<InteractionDensityMode>>,
       std::reference_wrapper<const Key<MultiParticleReactionsBitSet>>,
       std::reference_wrapper<const Key<NNbarTreatment>>,
       std::reference_wrapper<const Key<OutputOnlyFinal>>,
@@ -5237,6 +6925,7 @@ struct InputKeys {
       std::reference_wrapper<const Key<SmearingMode>>,
       std::reference_wrapper<const Key<SphereInitialCondition>>,
       std::reference_wrapper<const Key<ThermalizationAlgorithm>>,
+      std::reference_wrapper<const Key<ThreadAffinity>>,
       std::reference_wrapper<const Key<TimeStepMode>>,
       std::reference_wrapper<const Key<TotalCrossSectionStrategy>>>;
 
@@ -5250,19 +6939,44 @@ struct InputKeys {
       std::cref(gen_randomseed),
       std::cref(gen_minNonEmptyEnsembles_maximumEnsembles),
       std::cref(gen_minNonEmptyEnsembles_number),
+      std::cref(gen_actionCostSampling),
+      std::cref(gen_actionExecutionThreads),
+      std::cref(gen_actionFindingThreads),
+      std::cref(gen_adaptiveCellSize),
+      std::cref(gen_adaptiveTimeStep_actionsPerParticle),
+      std::cref(gen_adaptiveTimeStep_latticeCellFraction),
+      std::cref(gen_adaptiveTimeStep_maximumDeltaTime),
+      std::cref(gen_adaptiveTimeStep_minimumDeltaTime),
+      std::cref(gen_adaptiveTimeStep_momentumKick),
+      std::cref(gen_checkpointInterval),
+      std::cref(gen_conservationRecountInterval),
       std::cref(gen_deltaTime),
       std::cref(gen_derivativesMode),
       std::cref(gen_smearingDiscreteWeight),
+      std::cref(gen_ensembleThreads),
       std::cref(gen_ensembles),
       std::cref(gen_expansionRate),
       std::cref(gen_fieldDerivativesMode),
       std::cref(gen_smearingGaussCutoffInSigma),
       std::cref(gen_smearingGaussianSigma),
+      std::cref(gen_lazyPropagation),
+      std::cref(gen_memoryBudget),
+      std::cref(gen_memoryTracking),
       std::cref(gen_metricType),
+      std::cref(gen_oversampling),
+      std::cref(gen_particleSnapshot),
+      std::cref(gen_precomputeDecayTabulations),
+      std::cref(gen_profiling),
+      std::cref(gen_propagationThreads),
       std::cref(gen_restFrameDensityDerivativeMode),
+      std::cref(gen_resumeFromCheckpoint),
       std::cref(gen_smearingMode),
+      std::cref(gen_spatialSortingThreshold),
       std::cref(gen_testparticles),
+      std::cref(gen_testparticleSubensembles),
+      std::cref(gen_threadAffinity),
       std::cref(gen_timeStepMode),
+      std::cref(gen_trace),
       std::cref(gen_smearingTriangularRange),
       std::cref(gen_useGrid),
       std::cref(log_default),
@@ -5302,6 +7016,7 @@ struct InputKeys {
       std::cref(version),
       std::cref(collTerm_additionalElasticCrossSection),
       std::cref(collTerm_collisionCriterion),
+      std::cref(collTerm_crossSectionCacheBinWidth),
       std::cref(collTerm_crossSectionScaling),
       std::cref(collTerm_elasticCrossSection),
       std::cref(collTerm_elasticNNCutoffSqrts),
@@ -5311,6 +7026,7 @@ struct InputKeys {
       std::cref(collTerm_forceDecaysAtEnd),
       std::cref(collTerm_includeDecaysAtTheEnd),
       std::cref(collTerm_decayInitial),
+      std::cref(collTerm_deferCollisionSearch),
       std::cref(collTerm_includedTwoToTwo),
       std::cref(collTerm_isotropic),
       std::cref(collTerm_maximumCrossSection),
@@ -5319,13 +7035,18 @@ struct InputKeys {
       std::cref(collTerm_noCollisions),
       std::cref(collTerm_onlyWarnForHighProbability),
       std::cref(collTerm_resonanceLifetimeModifier),
+      std::cref(collTerm_sampleDecayTimesOnce),
+      std::cref(collTerm_stochasticThinning),
+      std::cref(collTerm_stochasticPairSampling),
       std::cref(collTerm_strings),
       std::cref(collTerm_stringsWithProbability),
+      std::cref(collTerm_tabulateParametrizations),
       std::cref(collTerm_twoToOne),
       std::cref(collTerm_useAQM),
       std::cref(collTerm_pauliBlocking_gaussianCutoff),
       std::cref(collTerm_pauliBlocking_momentumAveragingRadius),
       std::cref(collTerm_pauliBlocking_spatialAveragingRadius),
+      std::cref(collTerm_pauliBlocking_momentumCells),
       std::cref(collTerm_stringTrans_KNOffset),
       std::cref(collTerm_stringTrans_pipiOffset),
       std::cref(collTerm_stringTrans_lower),
@@ -5343,6 +7064,8 @@ struct InputKeys {
       std::cref(collTerm_stringParam_popcornRate),
       std::cref(collTerm_stringParam_powerParticleFormation),
       std::cref(collTerm_stringParam_probabilityPToDUU),
+      std::cref(collTerm_stringParam_pythiaPoolBeams),
+      std::cref(collTerm_stringParam_pythiaPoolSqrts),
       std::cref(collTerm_stringParam_separateFragmentBaryon),
       std::cref(collTerm_stringParam_sigmaPerp),
       std::cref(collTerm_stringParam_strangeSuppression),
@@ -5363,8 +7086,11 @@ struct InputKeys {
       std::cref(modi_collider_sqrtSNN),
       std::cref(modi_collider_calculationFrame),
       std::cref(modi_collider_collisionWithinNucleus),
+      std::cref(modi_collider_excludeSpectators),
       std::cref(modi_collider_fermiMotion),
+      std::cref(modi_collider_freezeOutRate),
       std::cref(modi_collider_initialDistance),
+      std::cref(modi_collider_prefetchInitialStates),
       std::cref(modi_collider_projectile_diffusiveness),
       std::cref(modi_collider_target_diffusiveness),
       std::cref(modi_collider_projectile_particles),
@@ -5401,6 +7127,10 @@ struct InputKeys {
       std::cref(modi_collider_target_deformed_orientation_randomRotation),
       std::cref(modi_collider_projectile_deformed_orientation_theta),
       std::cref(modi_collider_target_deformed_orientation_theta),
+      std::cref(modi_collider_projectile_library_file),
+      std::cref(modi_collider_target_library_file),
+      std::cref(modi_collider_projectile_library_size),
+      std::cref(modi_collider_target_library_size),
       std::cref(modi_collider_impact_max),
       std::cref(modi_collider_impact_randomReactionPlane),
       std::cref(modi_collider_impact_range),
@@ -5416,6 +7146,7 @@ struct InputKeys {
       std::cref(modi_sphere_addRadialVelocity),
       std::cref(modi_sphere_baryonChemicalPotential),
       std::cref(modi_sphere_chargeChemicalPotential),
+      std::cref(modi_sphere_freezeOutRate),
       std::cref(modi_sphere_initialCondition),
       std::cref(modi_sphere_strangeChemicalPotential),
       std::cref(modi_sphere_useThermalMultiplicities),
@@ -5432,34 +7163,74 @@ struct InputKeys {
       std::cref(modi_box_equilibrationTime),
       std::cref(modi_box_strangeChemicalPotential),
       std::cref(modi_box_useThermalMultiplicities),
+      std::cref(modi_box_wallCrossingActions),
       std::cref(modi_box_jet_jetMomentum),
       std::cref(modi_box_jet_jetPdg),
       std::cref(modi_list_fileDirectory),
       std::cref(modi_list_filename),
       std::cref(modi_list_filePrefix),
       std::cref(modi_list_shiftId),
+      std::cref(modi_list_prefetchInitialStates),
       std::cref(modi_listBox_fileDirectory),
       std::cref(modi_listBox_filename),
       std::cref(modi_listBox_filePrefix),
       std::cref(modi_listBox_length),
       std::cref(modi_listBox_shiftId),
+      std::cref(modi_listBox_prefetchInitialStates),
       std::cref(output_densityType),
+      std::cref(output_interactionDensity),
       std::cref(output_outputInterval),
       std::cref(output_outputTimes),
+      std::cref(output_binaryBufferSize),
+      std::cref(output_binaryEventIndex),
+      std::cref(output_overlapOutputTimes),
+      std::cref(output_root_compressionAlgorithm),
+      std::cref(output_root_compressionLevel),
+      std::cref(output_root_basketSize),
+      std::cref(output_root_autoFlush),
+      std::cref(output_root_autosaveFrequency),
       std::cref(output_particles_format),
       std::cref(output_collisions_format),
       std::cref(output_dileptons_format),
       std::cref(output_photons_format),
       std::cref(output_initialConditions_format),
       std::cref(output_rivet_format),
+      std::cref(output_analysis_format),
+      std::cref(output_greenKubo_format),
+      std::cref(output_digest_format),
       std::cref(output_coulomb_format),
       std::cref(output_thermodynamics_format),
+      std::cref(output_particles_asynchronous),
+      std::cref(output_collisions_asynchronous),
+      std::cref(output_dileptons_asynchronous),
+      std::cref(output_photons_asynchronous),
+      std::cref(output_initialConditions_asynchronous),
+      std::cref(output_rivet_asynchronous),
+      std::cref(output_particles_ensembleShards),
+      std::cref(output_collisions_ensembleShards),
+      std::cref(output_initialConditions_ensembleShards),
       std::cref(output_particles_extended),
       std::cref(output_particles_onlyFinal),
+      std::cref(output_particles_singlePrecision),
+      std::cref(output_particles_compressionLevel),
+      std::cref(output_particles_hepmcBatchSize),
+      std::cref(output_particles_filter_species),
+      std::cref(output_particles_filter_charge),
+      std::cref(output_particles_filter_rapidityWindow),
+      std::cref(output_particles_filter_transverseMomentumWindow),
+      std::cref(output_particles_filter_onlyParticipants),
+      std::cref(output_particles_deltaBlocks),
       std::cref(output_collisions_extended),
       std::cref(output_collisions_printStartEnd),
+      std::cref(output_collisions_hepmcBatchSize),
+      std::cref(output_collisions_hepmcMinElasticSqrts),
       std::cref(output_dileptons_extended),
       std::cref(output_photons_extended),
+      std::cref(output_dileptons_massBins),
+      std::cref(output_dileptons_transverseMomentumBins),
+      std::cref(output_dileptons_rapidityBins),
+      std::cref(output_photons_transverseMomentumBins),
+      std::cref(output_photons_rapidityBins),
       std::cref(output_initialConditions_extended),
       std::cref(output_initialConditions_lowerBound),
       std::cref(output_initialConditions_properTime),
@@ -5477,18 +7248,33 @@ struct InputKeys {
       std::cref(output_rivet_weights_noMulti),
       std::cref(output_rivet_weights_nominal),
       std::cref(output_rivet_weights_select),
+      std::cref(output_analysis_species),
+      std::cref(output_analysis_rapidityBins),
+      std::cref(output_analysis_transverseMomentumBins),
+      std::cref(output_analysis_midrapidityCut),
+      std::cref(output_analysis_flowHarmonics),
+      std::cref(output_greenKubo_pointsPerLevel),
+      std::cref(output_greenKubo_levels),
+      std::cref(output_digest_reference),
       std::cref(output_thermodynamics_onlyParticipants),
+      std::cref(output_thermodynamics_compressionLevel),
+      std::cref(output_thermodynamics_downsampling),
       std::cref(output_thermodynamics_position),
       std::cref(output_thermodynamics_quantites),
+      std::cref(output_thermodynamics_regionMax),
+      std::cref(output_thermodynamics_regionMin),
       std::cref(output_thermodynamics_smearing),
       std::cref(output_thermodynamics_type),
+      std::cref(lattice_adaptiveInterval),
       std::cref(lattice_automatic),
       std::cref(lattice_cellNumber),
       std::cref(lattice_origin),
       std::cref(lattice_periodic),
       std::cref(lattice_potentialsAffectThreshold),
+      std::cref(lattice_potentialsUpdateInterval),
       std::cref(lattice_sizes),
       std::cref(potentials_use_potentials_outside_lattice),
+      std::cref(potentials_leapfrog),
       std::cref(potentials_skyrme_skyrmeA),
       std::cref(potentials_skyrme_skyrmeB),
       std::cref(potentials_skyrme_skyrmeTau),
@@ -5498,6 +7284,7 @@ struct InputKeys {
       std::cref(potentials_vdf_powers),
       std::cref(potentials_vdf_satRhoB),
       std::cref(potentials_coulomb_rCut),
+      std::cref(potentials_coulomb_useFFT),
       std::cref(potentials_momentum_dependence_C),
       std::cref(potentials_momentum_dependence_Lambda),
       std::cref(forcedThermalization_cellNumber),
@@ -5871,12 +7658,12 @@ General:
  * particles as you specified in the configuration. For the example considered
  * here, the file needs to contain 79 protons and 118 neutrons in the first
  197
- * lines. And the same number in the following 197 lines. The read in nuclei
- are
- * randomly rotated and recentered. Therefore you can run SMASH even if your
- * file does not contain enough nuclei for the number of events you want to
- * simulate as the missing nuclei are generated by rotation of the given
- * configurations.
+ * lines. And the same number in the following 197 lines. The file is read
+ * once at the start. For every nucleus of an event, one of its configurations
+ * is drawn at random, which is then randomly rotated and recentered.
+ * Therefore you can run SMASH even if your file does not contain enough nuclei
+ * for the number of events you want to simulate as the missing nuclei are
+ * generated by rotation of the given configurations.
  *
  * \note
  * SMASH is shipped with an example configuration file to set up a collision
@@ -268,21 +268,28 @@ class Integrator2d {
 
     Integrand2d<F> f_with_limits = {min1, max1 - min1, min2, max2 - min2, fun};
 
-    const integrand_t cuhre_fun{[](const int * /* ndim */, const cubareal xx[],
-                                   const int * /* ncomp */, cubareal ff[],
-                                   void *userdata) -> int {
+    /* Cuba passes all points of a subregion at once, such that the integrand
+     * is evaluated in a loop that the compiler can inline and vectorize. */
+    const auto cuhre_fun = [](const int * /* ndim */, const cubareal xx[],
+                              const int * /* ncomp */, cubareal ff[],
+                              void *userdata, const int *n_points,
+                              const int * /* core */) -> int {
       auto i = static_cast<Integrand2d<F> *>(userdata);
       /* We have to transform the integrand to the unit cube.
        * This is what Cuba expects. */
-      ff[0] = (i->f)(i->min1 + i->diff1 * xx[0], i->min2 + i->diff2 * xx[1]) *
-              i->diff1 * i->diff2;
+      const double jacobian = i->diff1 * i->diff2;
+      for (int j = 0; j < *n_points; j++) {
+        ff[j] = (i->f)(i->min1 + i->diff1 * xx[2 * j],
+                       i->min2 + i->diff2 * xx[2 * j + 1]) *
+                jacobian;
+      }
       return 0;
-    }};
+    };
 
     const int ndim = 2;
     const int ncomp = 1;
     void *userdata = &f_with_limits;
-    const int nvec = 1;
+    const int nvec = max_points_per_call;
     const int flags = 0;  // Use the defaults.
     const int mineval = 0;
     const int maxeval = maxeval_;
@@ -290,9 +297,12 @@ class Integrator2d {
     const char *statefile = nullptr;
     void *spin = nullptr;
 
-    Cuhre(ndim, ncomp, cuhre_fun, userdata, nvec, epsrel_, epsabs_, flags,
-          mineval, maxeval, key, statefile, spin, &nregions_, &neval_, &fail_,
-          &result.first, &result.second, &prob_);
+    /* The explicit cast to integrand_t is how Cuba expects the nvec argument.
+     * Casting via a generic function pointer avoids the compiler warning. */
+    const auto generic_fun = reinterpret_cast<void (*)()>(+cuhre_fun);
+    Cuhre(ndim, ncomp, reinterpret_cast<integrand_t>(generic_fun), userdata,
+          nvec, epsrel_, epsabs_, flags, mineval, maxeval, key, statefile, spin,
+          &nregions_, &neval_, &fail_, &result.first, &result.second, &prob_);
 
     if (fail_) {
       std::stringstream err;
@@ -306,6 +316,12 @@ class Integrator2d {
   }
 
  private:
+  /**
+   * Maximal number of points passed to the integrand at once. It exceeds the
+   * 65 points of the default degree-13 rule of Cuhre in two dimensions, so
+   * that a subregion is evaluated in one call.
+   */
+  static constexpr int max_points_per_call = 128;
   /// The (approximate) maximum number of integrand evaluations allowed.
   int maxeval_;
   /// Requested relative accuracy.
@@ -16,6 +16,7 @@
 #include "particletype.h"
 #include "sha256.h"
 #include "tabulation.h"
+#include "tabulationbundle.h"
 
 namespace smash {
 
@@ -204,17 +205,30 @@ class IsoParticleType {
   static void create_multiplet(const ParticleType &type);
 
   /**
-   * Tabulate all relevant integrals.
+   * Tabulate all relevant integrals, caching them in the TabulationBundle of
+   * the tabulations directory.
    *
    * \param hash The hash of the particle properties.
    *             This is used to determine whether a cached tabulation can be
    *             reused or not.
    * \param tabulations_path The path to the directory where the tabulations are
-   * cached.
+   * cached, empty if they are not cached.
    */
   static void tabulate_integrals(sha256::Hash hash,
                                  const std::filesystem::path &tabulations_path);
 
+  /**
+   * Tabulate all relevant integrals.
+   *
+   * The integrals are looked up in the bundle. Missing ones are calculated on
+   * all hardware threads, each with its own integrators, stored in a fixed
+   * order afterwards and added to the bundle.
+   *
+   * \param[inout] bundle Cached tabulations.
+   * \return Number of integrals added to the bundle.
+   */
+  static std::size_t tabulate_integrals(TabulationBundle &bundle);
+
   /**
    * Look up the tabulated resonance integral for the XX -> NR cross section.
    *
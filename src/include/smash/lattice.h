@@ -10,16 +10,25 @@
 #ifndef SRC_INCLUDE_SMASH_LATTICE_H_
 #define SRC_INCLUDE_SMASH_LATTICE_H_
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstring>
 #include <functional>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "checkpoint.h"
 #include "forwarddeclarations.h"
 #include "fourvector.h"
 #include "logging.h"
+#include "memorytracker.h"
 #include "numerics.h"
+#include "parallel.h"
+#include "threadaffinity.h"
 
 namespace smash {
 static constexpr int LLattice = LogArea::Lattice::id;
@@ -74,7 +83,14 @@ class RectangularLattice {
         origin_(orig),
         periodic_(per),
         when_update_(upd) {
-    lattice_.resize(n_cells_[0] * n_cells_[1] * n_cells_[2]);
+    const std::size_t n_cells = static_cast<std::size_t>(n_cells_[0]) *
+                                n_cells_[1] * n_cells_[2];
+    // Large lattices are spread over many pages, so the advice is given before
+    // the cells are initialized and the memory is touched.
+    lattice_.reserve(n_cells);
+    advise_huge_pages(lattice_.data(), n_cells * sizeof(T));
+    lattice_.resize(n_cells);
+    memory_.set(lattice_.capacity() * sizeof(T));
     logg[LLattice].debug(
         "Rectangular lattice created: sizes[fm] = (", lattice_sizes_[0], ",",
         lattice_sizes_[1], ",", lattice_sizes_[2], "), dims = (", n_cells_[0],
@@ -98,10 +114,230 @@ class RectangularLattice {
         cell_volume_(rl.cell_volume_),
         origin_(rl.origin_),
         periodic_(rl.periodic_),
-        when_update_(rl.when_update_) {}
+        when_update_(rl.when_update_),
+        occupied_bricks_(rl.occupied_bricks_),
+        memory_(rl.memory_) {}
 
-  /// Sets all values on lattice to zeros.
-  void reset() { std::fill(lattice_.begin(), lattice_.end(), T()); }
+  /**
+   * Sets all values on lattice to zeros. If the occupation is tracked, only
+   * the occupied bricks are reset, which are then marked as empty.
+   */
+  void reset() {
+    if (!tracks_occupation()) {
+      std::fill(lattice_.begin(), lattice_.end(), T());
+      return;
+    }
+    iterate_occupied([](T& node) { node = T(); });
+    std::fill(occupied_bricks_.begin(), occupied_bricks_.end(), 0);
+  }
+
+  /// Number of nodes along each edge of the bricks used to track occupation
+  static constexpr int brick_size = 8;
+
+  /**
+   * Start to track which bricks of brick_size^3 nodes may hold values other
+   * than the default one. Then reset() and iterate_occupied() only visit
+   * these bricks, such that their cost scales with the occupied volume, e.g.
+   * for a fireball in a lattice covering a whole collision. Any code writing
+   * a value other than the default to a node has to announce it with
+   * mark_occupied() or mark_all_occupied(). Initially, all bricks are marked
+   * as occupied.
+   */
+  void track_occupation() {
+    occupied_bricks_.assign(
+        n_bricks(0) * static_cast<std::size_t>(n_bricks(1)) * n_bricks(2), 1);
+  }
+
+  /// \return Whether the occupied bricks are tracked
+  bool tracks_occupation() const { return !occupied_bricks_.empty(); }
+
+  /**
+   * Mark all bricks with nodes within a distance from a point as occupied,
+   * if the occupation is tracked. The marked region is conservative: it
+   * includes all nodes visited by iterate_in_rectangle and
+   * iterate_nearest_neighbors with the same reach.
+   *
+   * \param[in] point Position, usually the position of a particle [fm]
+   * \param[in] reach Maximum distances in the x-, y-, and z-directions from
+   *            the point [fm]
+   */
+  void mark_occupied(const ThreeVector& point,
+                     const std::array<double, 3>& reach) {
+    if (!tracks_occupation()) {
+      return;
+    }
+    std::array<std::vector<int>, 3> bricks;
+    for (int i = 0; i < 3; i++) {
+      // in floating point to stay safe for particles far off the lattice
+      double lower =
+          std::floor((point[i] - origin_[i] - reach[i]) / cell_sizes_[i]) - 1;
+      double upper =
+          std::floor((point[i] - origin_[i] + reach[i]) / cell_sizes_[i]) + 1;
+      if (periodic_ && upper - lower + 1 >= n_cells_[i]) {
+        lower = 0;
+        upper = n_cells_[i] - 1;
+      } else if (periodic_) {
+        const double shift = n_cells_[i] * std::floor(lower / n_cells_[i]);
+        lower -= shift;
+        upper -= shift;
+      } else {
+        lower = std::clamp(lower, 0., static_cast<double>(n_cells_[i]));
+        upper = std::clamp(upper, -1., n_cells_[i] - 1.);
+      }
+      for (int node = lower; node <= upper; node++) {
+        const int brick = (node % n_cells_[i]) / brick_size;
+        if (bricks[i].empty() || bricks[i].back() != brick) {
+          bricks[i].push_back(brick);
+        }
+      }
+    }
+    for (const int bz : bricks[2]) {
+      for (const int by : bricks[1]) {
+        for (const int bx : bricks[0]) {
+          occupied_bricks_[bx + n_bricks(0) * (by + n_bricks(1) * bz)] = 1;
+        }
+      }
+    }
+  }
+
+  /// Mark all bricks as occupied, if the occupation is tracked
+  void mark_all_occupied() {
+    std::fill(occupied_bricks_.begin(), occupied_bricks_.end(), 1);
+  }
+
+  /**
+   * Apply a function to all nodes of the occupied bricks, or to all nodes if
+   * the occupation is not tracked. Other nodes hold the default value.
+   *
+   * \tparam F Type of the function, taking a node as argument.
+   * \param[in] func Function acting on the nodes
+   */
+  template <typename F>
+  void iterate_occupied(F&& func) {
+    if (!tracks_occupation()) {
+      for (T& node : lattice_) {
+        func(node);
+      }
+      return;
+    }
+    for (int bz = 0; bz < n_bricks(2); bz++) {
+      for (int by = 0; by < n_bricks(1); by++) {
+        for (int bx = 0; bx < n_bricks(0); bx++) {
+          if (!occupied_bricks_[bx + n_bricks(0) * (by + n_bricks(1) * bz)]) {
+            continue;
+          }
+          const int ix_end = std::min((bx + 1) * brick_size, n_cells_[0]);
+          const int iy_end = std::min((by + 1) * brick_size, n_cells_[1]);
+          const int iz_end = std::min((bz + 1) * brick_size, n_cells_[2]);
+          for (int iz = bz * brick_size; iz < iz_end; iz++) {
+            for (int iy = by * brick_size; iy < iy_end; iy++) {
+              const int y_offset = n_cells_[0] * (iy + n_cells_[1] * iz);
+              for (int ix = bx * brick_size; ix < ix_end; ix++) {
+                func(lattice_[ix + y_offset]);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Apply a function to the indices of all nodes, distributed over several
+   * threads in chunks of consecutive nodes. The function has to be safe to
+   * call concurrently for different nodes.
+   *
+   * \tparam F Type of the function, taking the index of a node as argument.
+   * \param[in] n_threads Maximal number of threads
+   * \param[in] func Function acting on the nodes
+   */
+  template <typename F>
+  void iterate_in_parallel(int n_threads, F&& func) const {
+    parallel_for(n_threads, size(), 256, std::forward<F>(func));
+  }
+
+  /**
+   * Move the lattice by whole cells and change its number of cells, while
+   * the cell sizes stay the same. The values of the nodes covered by both the
+   * old and the new lattice are kept, the other nodes get the default value.
+   * If the occupation is tracked, all bricks are marked as occupied.
+   *
+   * \param[in] first_cell Index of the first cell of the new lattice on the
+   *            old lattice. Negative indices extend the lattice towards lower
+   *            coordinates.
+   * \param[in] n Number of cells of the new lattice in x, y, z directions.
+   * \throw std::invalid_argument if the lattice is periodic or a number of
+   *        cells is not positive
+   */
+  void shift_and_resize(const std::array<int, 3>& first_cell,
+                        const std::array<int, 3>& n) {
+    if (periodic_) {
+      throw std::invalid_argument("A periodic lattice cannot be moved.");
+    }
+    if (n[0] < 1 || n[1] < 1 || n[2] < 1) {
+      throw std::invalid_argument("Number of lattice cells should be > 0.");
+    }
+    std::vector<T> moved(n[0] * n[1] * n[2]);
+    for (int iz = 0; iz < n[2]; iz++) {
+      const int old_z = iz + first_cell[2];
+      if (old_z < 0 || old_z >= n_cells_[2]) {
+        continue;
+      }
+      for (int iy = 0; iy < n[1]; iy++) {
+        const int old_y = iy + first_cell[1];
+        if (old_y < 0 || old_y >= n_cells_[1]) {
+          continue;
+        }
+        const int lower = std::max(0, -first_cell[0]);
+        const int upper = std::min(n[0], n_cells_[0] - first_cell[0]);
+        for (int ix = lower; ix < upper; ix++) {
+          moved[ix + n[0] * (iy + n[1] * iz)] = std::move(
+              lattice_[ix + first_cell[0] +
+                       n_cells_[0] * (old_y + n_cells_[1] * old_z)]);
+        }
+      }
+    }
+    lattice_ = std::move(moved);
+    memory_.set(lattice_.capacity() * sizeof(T));
+    for (int i = 0; i < 3; i++) {
+      origin_[i] += first_cell[i] * cell_sizes_[i];
+      n_cells_[i] = n[i];
+      lattice_sizes_[i] = n[i] * cell_sizes_[i];
+    }
+    if (tracks_occupation()) {
+      track_occupation();
+    }
+    logg[LLattice].debug("Rectangular lattice moved: dims = (", n_cells_[0],
+                         ",", n_cells_[1], ",", n_cells_[2], "), origin = (",
+                         origin_[0], ",", origin_[1], ",", origin_[2], ")");
+  }
+
+  /**
+   * Centre the lattice on a box by moving it by whole cells and let it grow,
+   * if the box does not fit, see shift_and_resize. The lattice keeps at
+   * least the given number of cells.
+   *
+   * \param[in] lower Lower corner of the box to be covered [fm]
+   * \param[in] upper Upper corner of the box to be covered [fm]
+   * \param[in] min_cells Minimal number of cells in x, y, z directions
+   * \return Whether the lattice changed
+   */
+  bool follow(const ThreeVector& lower, const ThreeVector& upper,
+              const std::array<int, 3>& min_cells) {
+    std::array<int, 3> first_cell, n;
+    for (int i = 0; i < 3; i++) {
+      const int needed = std::ceil((upper[i] - lower[i]) / cell_sizes_[i]);
+      n[i] = std::max(min_cells[i], needed);
+      const double new_origin =
+          0.5 * (lower[i] + upper[i]) - 0.5 * n[i] * cell_sizes_[i];
+      first_cell[i] = std::lround((new_origin - origin_[i]) / cell_sizes_[i]);
+    }
+    if (first_cell == std::array<int, 3>{0, 0, 0} && n == n_cells_) {
+      return false;
+    }
+    shift_and_resize(first_cell, n);
+    return true;
+  }
 
   /**
    * Checks if 3D index is out of lattice bounds.
@@ -331,79 +567,14 @@ class RectangularLattice {
           "Lattice for gradient should have the"
           " same origin/dims/periodicity as the original one.");
     }
-    const double inv_2dx = 0.5 / cell_sizes_[0];
-    const double inv_2dy = 0.5 / cell_sizes_[1];
-    const double inv_2dz = 0.5 / cell_sizes_[2];
-    const int dix = 1;
-    const int diy = n_cells_[0];
-    const int diz = n_cells_[0] * n_cells_[1];
-    const int d = diz * n_cells_[2];
-
-    for (int iz = 0; iz < n_cells_[2]; iz++) {
-      const int z_offset = diz * iz;
-      for (int iy = 0; iy < n_cells_[1]; iy++) {
-        const int y_offset = diy * iy + z_offset;
-        for (int ix = 0; ix < n_cells_[0]; ix++) {
-          const int index = ix + y_offset;
-          if (unlikely(ix == 0)) {
-            (grad_lat)[index].set_x1(
-                periodic_
-                    ? (lattice_[index + dix] - lattice_[index + diy - dix]) *
-                          inv_2dx
-                    : (lattice_[index + dix] - lattice_[index]) * 2.0 *
-                          inv_2dx);
-          } else if (unlikely(ix == n_cells_[0] - 1)) {
-            (grad_lat)[index].set_x1(
-                periodic_
-                    ? (lattice_[index - diy + dix] - lattice_[index - dix]) *
-                          inv_2dx
-                    : (lattice_[index] - lattice_[index - dix]) * 2.0 *
-                          inv_2dx);
-          } else {
-            (grad_lat)[index].set_x1(
-                (lattice_[index + dix] - lattice_[index - dix]) * inv_2dx);
-          }
-
-          if (unlikely(iy == 0)) {
-            (grad_lat)[index].set_x2(
-                periodic_
-                    ? (lattice_[index + diy] - lattice_[index + diz - diy]) *
-                          inv_2dy
-                    : (lattice_[index + diy] - lattice_[index]) * 2.0 *
-                          inv_2dy);
-          } else if (unlikely(iy == n_cells_[1] - 1)) {
-            (grad_lat)[index].set_x2(
-                periodic_
-                    ? (lattice_[index - diz + diy] - lattice_[index - diy]) *
-                          inv_2dy
-                    : (lattice_[index] - lattice_[index - diy]) * 2.0 *
-                          inv_2dy);
-          } else {
-            (grad_lat)[index].set_x2(
-                (lattice_[index + diy] - lattice_[index - diy]) * inv_2dy);
-          }
-
-          if (unlikely(iz == 0)) {
-            (grad_lat)[index].set_x3(
-                periodic_
-                    ? (lattice_[index + diz] - lattice_[index + d - diz]) *
-                          inv_2dz
-                    : (lattice_[index + diz] - lattice_[index]) * 2.0 *
-                          inv_2dz);
-          } else if (unlikely(iz == n_cells_[2] - 1)) {
-            (grad_lat)[index].set_x3(
-                periodic_
-                    ? (lattice_[index - d + diz] - lattice_[index - diz]) *
-                          inv_2dz
-                    : (lattice_[index] - lattice_[index - diz]) * 2.0 *
-                          inv_2dz);
-          } else {
-            (grad_lat)[index].set_x3(
-                (lattice_[index + diz] - lattice_[index - diz]) * inv_2dz);
-          }
-        }
-      }
-    }
+    iterate_stencils([&](int index, const Stencil& sx, const Stencil& sy,
+                         const Stencil& sz) {
+      grad_lat[index] = ThreeVector(
+          (lattice_[index + sx.plus] - lattice_[index + sx.minus]) * sx.factor,
+          (lattice_[index + sy.plus] - lattice_[index + sy.minus]) * sy.factor,
+          (lattice_[index + sz.plus] - lattice_[index + sz.minus]) *
+              sz.factor);
+    });
   }
 
   /**
@@ -418,99 +589,55 @@ class RectangularLattice {
   void compute_four_gradient_lattice(
       RectangularLattice<FourVector>& old_lat, double time_step,
       RectangularLattice<std::array<FourVector, 4>>& grad_lat) const {
-    if (n_cells_[0] < 2 || n_cells_[1] < 2 || n_cells_[2] < 2) {
-      // Gradient calculation is impossible
-      throw std::runtime_error(
-          "Lattice is too small for gradient calculation"
-          " (should be at least 2x2x2)");
-    }
     if (!identical_to_lattice(&grad_lat)) {
       // Lattice for gradient should have identical origin/dims/periodicity
       throw std::invalid_argument(
           "Lattice for gradient should have the"
           " same origin/dims/periodicity as the original one.");
     }
-    const double inv_2dx = 0.5 / cell_sizes_[0];
-    const double inv_2dy = 0.5 / cell_sizes_[1];
-    const double inv_2dz = 0.5 / cell_sizes_[2];
-    const int dix = 1;
-    const int diy = n_cells_[0];
-    const int diz = n_cells_[0] * n_cells_[1];
-    const int d = diz * n_cells_[2];
+    compute_four_gradient(
+        old_lat, time_step, [](const T& jmu) { return jmu; },
+        [&grad_lat](int index, const std::array<FourVector, 4>& grad) {
+          grad_lat[index] = grad;
+        });
+  }
 
-    for (int iz = 0; iz < n_cells_[2]; iz++) {
-      const int z_offset = diz * iz;
-      for (int iy = 0; iy < n_cells_[1]; iy++) {
-        const int y_offset = diy * iy + z_offset;
-        for (int ix = 0; ix < n_cells_[0]; ix++) {
-          const int index = ix + y_offset;
-
-          // auxiliary vectors used for the calculation of gradients
-          FourVector grad_t_jmu(0.0, 0.0, 0.0, 0.0);
-          FourVector grad_x_jmu(0.0, 0.0, 0.0, 0.0);
-          FourVector grad_y_jmu(0.0, 0.0, 0.0, 0.0);
-          FourVector grad_z_jmu(0.0, 0.0, 0.0, 0.0);
-          // t direction
-          grad_t_jmu = (lattice_[index] - (old_lat)[index]) * (1.0 / time_step);
-          // x direction
-          if (unlikely(ix == 0)) {
-            grad_x_jmu =
-                periodic_
-                    ? (lattice_[index + dix] - lattice_[index + diy - dix]) *
-                          inv_2dx
-                    : (lattice_[index + dix] - lattice_[index]) * 2.0 * inv_2dx;
-          } else if (unlikely(ix == n_cells_[0] - 1)) {
-            grad_x_jmu =
-                periodic_
-                    ? (lattice_[index - diy + dix] - lattice_[index - dix]) *
-                          inv_2dx
-                    : (lattice_[index] - lattice_[index - dix]) * 2.0 * inv_2dx;
-          } else {
-            grad_x_jmu =
-                (lattice_[index + dix] - lattice_[index - dix]) * inv_2dx;
-          }
-          // y direction
-          if (unlikely(iy == 0)) {
-            grad_y_jmu =
-                periodic_
-                    ? (lattice_[index + diy] - lattice_[index + diz - diy]) *
-                          inv_2dy
-                    : (lattice_[index + diy] - lattice_[index]) * 2.0 * inv_2dy;
-          } else if (unlikely(iy == n_cells_[1] - 1)) {
-            grad_y_jmu =
-                periodic_
-                    ? (lattice_[index - diz + diy] - lattice_[index - diy]) *
-                          inv_2dy
-                    : (lattice_[index] - lattice_[index - diy]) * 2.0 * inv_2dy;
-          } else {
-            grad_y_jmu =
-                (lattice_[index + diy] - lattice_[index - diy]) * inv_2dy;
-          }
-          // z direction
-          if (unlikely(iz == 0)) {
-            grad_z_jmu =
-                periodic_
-                    ? (lattice_[index + diz] - lattice_[index + d - diz]) *
-                          inv_2dz
-                    : (lattice_[index + diz] - lattice_[index]) * 2.0 * inv_2dz;
-          } else if (unlikely(iz == n_cells_[2] - 1)) {
-            grad_z_jmu =
-                periodic_
-                    ? (lattice_[index - d + diz] - lattice_[index - diz]) *
-                          inv_2dz
-                    : (lattice_[index] - lattice_[index - diz]) * 2.0 * inv_2dz;
-          } else {
-            grad_z_jmu =
-                (lattice_[index + diz] - lattice_[index - diz]) * inv_2dz;
-          }
-          // fill
-          (grad_lat)[index][0] = grad_t_jmu;
-          (grad_lat)[index][1] = grad_x_jmu;
-          (grad_lat)[index][2] = grad_y_jmu;
-          (grad_lat)[index][3] = grad_z_jmu;
-        }
-      }
+  /**
+   * Compute a fourgradient of a FourVector jmu of every node via the finite
+   * difference method and pass it on, without storing it in another lattice.
+   * The nodes are visited in the order of their index.
+   *
+   * \param[in] old_lat the lattice of FourVectors jmu at a previous time step
+   * \param[in] time_step the used time step, needed for the time derivative
+   * \param[in] jmu_of function returning the FourVector jmu of a node; it must
+   *            not depend on the values passed to store
+   * \param[in] store function taking the index of a node and the 4-array
+   *            [djmu_dt, djmu_dx, djmu_dy, djmu_dz] of the node
+   * \tparam F type of jmu_of
+   * \tparam G type of store
+   */
+  template <typename F, typename G>
+  void compute_four_gradient(const RectangularLattice<FourVector>& old_lat,
+                             double time_step, F&& jmu_of, G&& store) const {
+    if (n_cells_[0] < 2 || n_cells_[1] < 2 || n_cells_[2] < 2) {
+      // Gradient calculation is impossible
+      throw std::runtime_error(
+          "Lattice is too small for gradient calculation"
+          " (should be at least 2x2x2)");
     }
+    const double inv_dt = 1.0 / time_step;
+    auto jmu = [&](int index) -> FourVector { return jmu_of(lattice_[index]); };
+    iterate_stencils([&](int index, const Stencil& sx, const Stencil& sy,
+                         const Stencil& sz) {
+      store(index, std::array<FourVector, 4>{
+                       (jmu(index) - old_lat[index]) * inv_dt,
+                       (jmu(index + sx.plus) - jmu(index + sx.minus)) *
+                           sx.factor,
+                       (jmu(index + sy.plus) - jmu(index + sy.minus)) *
+                           sy.factor,
+                       (jmu(index + sz.plus) - jmu(index + sz.minus)) *
+                           sz.factor});
+    });
   }
 
   /**
@@ -783,25 +910,144 @@ class RectangularLattice {
            periodic_ == lat->periodic();
   }
 
+  /**
+   * Write the position, the number of cells and the values of the nodes to a
+   * checkpoint.
+   *
+   * \param[out] out Stream of the checkpoint
+   */
+  void write_checkpoint(std::ostream& out) const {
+    checkpoint::write(out, n_cells_);
+    checkpoint::write(out, origin_);
+    checkpoint::write(out, lattice_);
+  }
+
+  /**
+   * Restore a lattice with the same cell sizes from a checkpoint written by
+   * write_checkpoint.
+   *
+   * \param[in] in Stream of the checkpoint
+   * \throw runtime_error if the number of nodes does not match the number of
+   *        cells
+   */
+  void read_checkpoint(std::istream& in) {
+    checkpoint::read(in, n_cells_);
+    checkpoint::read(in, origin_);
+    checkpoint::read(in, lattice_);
+    if (lattice_.size() !=
+        static_cast<std::size_t>(n_cells_[0]) * n_cells_[1] * n_cells_[2]) {
+      throw std::runtime_error("Inconsistent lattice in the checkpoint.");
+    }
+    for (int i = 0; i < 3; i++) {
+      lattice_sizes_[i] = n_cells_[i] * cell_sizes_[i];
+    }
+    memory_.set(lattice_.capacity() * sizeof(T));
+    if (tracks_occupation()) {
+      track_occupation();
+    }
+  }
+
  protected:
   /// The lattice itself, array containing physical quantities.
   std::vector<T> lattice_;
   /// Lattice sizes in x, y, z directions.
-  const std::array<double, 3> lattice_sizes_;
+  std::array<double, 3> lattice_sizes_;
   /// Number of cells in x,y,z directions.
-  const std::array<int, 3> n_cells_;
+  std::array<int, 3> n_cells_;
   /// Cell sizes in x, y, z directions.
   const std::array<double, 3> cell_sizes_;
   /// Volume of a cell.
   const double cell_volume_;
   /// Coordinates of the left down nearer corner.
-  const std::array<double, 3> origin_;
+  std::array<double, 3> origin_;
   /// Whether the lattice is periodic.
   const bool periodic_;
   /// When the lattice should be recalculated.
   const LatticeUpdate when_update_;
+  /// Flags of the occupied bricks, empty if the occupation is not tracked
+  std::vector<char> occupied_bricks_;
+  /// Accounts the memory of lattice_, see MemoryTracker
+  MemoryAccount memory_{MemorySubsystem::Lattices};
 
  private:
+  /**
+   * \param[in] i direction
+   * \return Number of bricks in the given direction
+   */
+  int n_bricks(int i) const {
+    return (n_cells_[i] + brick_size - 1) / brick_size;
+  }
+
+  /**
+   * Offsets of the neighbouring nodes entering the finite difference along
+   * one direction, and the factor turning their difference into the
+   * derivative.
+   */
+  struct Stencil {
+    /// Offset of the node in the negative direction
+    int minus;
+    /// Offset of the node in the positive direction
+    int plus;
+    /// Inverse distance of the two nodes [fm^-1]
+    double factor;
+  };
+
+  /**
+   * Determine the finite-difference stencil of the nodes with a given index
+   * along a direction. Inside the lattice, the derivative is central. At the
+   * boundaries, the neighbour is taken from the other side of a periodic
+   * lattice, and otherwise the derivative is one-sided.
+   *
+   * \param[in] i index of the nodes along the direction
+   * \param[in] direction 0, 1 or 2 for x, y or z
+   * \return the stencil
+   */
+  Stencil stencil(int i, int direction) const {
+    const int n = n_cells_[direction];
+    const int stride = direction == 0   ? 1
+                       : direction == 1 ? n_cells_[0]
+                                        : n_cells_[0] * n_cells_[1];
+    const double inv_2d = 0.5 / cell_sizes_[direction];
+    if (unlikely(i == 0)) {
+      return periodic_ ? Stencil{(n - 1) * stride, stride, inv_2d}
+                       : Stencil{0, stride, 2.0 * inv_2d};
+    } else if (unlikely(i == n - 1)) {
+      return periodic_ ? Stencil{-stride, -(n - 1) * stride, inv_2d}
+                       : Stencil{-stride, 0, 2.0 * inv_2d};
+    }
+    return Stencil{-stride, stride, inv_2d};
+  }
+
+  /**
+   * Call a function with the finite-difference stencils of every node, in
+   * the order of their index. The stencils along y and z are determined
+   * once per row along x, and the first and last nodes of a row are handled
+   * apart from the others, such that the loop over the inner nodes of a row
+   * runs without branches over contiguous memory.
+   *
+   * \tparam F Type of the function. Arguments are the index of the node and
+   *         its stencils along x, y and z.
+   * \param[in] func Function acting on the nodes
+   */
+  template <typename F>
+  void iterate_stencils(F&& func) const {
+    const Stencil first_x = stencil(0, 0);
+    const Stencil inner_x = stencil(1, 0);
+    const Stencil last_x = stencil(n_cells_[0] - 1, 0);
+    for (int iz = 0; iz < n_cells_[2]; iz++) {
+      const Stencil sz = stencil(iz, 2);
+      for (int iy = 0; iy < n_cells_[1]; iy++) {
+        const Stencil sy = stencil(iy, 1);
+        const int row = n_cells_[0] * (iy + n_cells_[1] * iz);
+        func(row, first_x, sy, sz);
+        for (int ix = 1; ix < n_cells_[0] - 1; ix++) {
+          func(row + ix, inner_x, sy, sz);
+        }
+        func(row + n_cells_[0] - 1, last_x, sy, sz);
+      }
+    }
+  }
+
   /**
    * Returns division modulo, which is always between 0 and n-1
    * i%n is not suitable, because it returns results from -(n-1) to n-1
@@ -7,10 +7,19 @@
  *
  */
 
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "arrowexport.h"
 #include "configuration.h"
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "particledata.h"
+#include "particles.h"
+#include "processbranch.h"
 
 #ifndef SRC_INCLUDE_SMASH_LIBRARY_H_
 #define SRC_INCLUDE_SMASH_LIBRARY_H_
@@ -18,7 +27,11 @@
 namespace smash {
 
 /* Free functions to interface with smash as a library,
- * also used in smash main function. */
+ * also used in smash main function. The particles of the initial conditions
+ * for hydrodynamics can be received in memory by adding an ICCallbackOutput
+ * to the Experiment with Experiment::add_output. The particles of streamed
+ * events can be handed to Arrow-based analyses with
+ * export_particles_to_arrow. */
 
 /**
  * Set up configuration and logging from input files and extra config
@@ -52,6 +65,161 @@ void initialize_particles_decays_and_tabulations(
     Configuration &configuration, const std::string &version,
     const std::string &tabulations_dir = {});
 
+class ExperimentBase;
+
+/// Interaction in the collision history of a StreamedEvent
+struct StreamedInteraction {
+  /// Ensemble in which the interaction happened
+  int ensemble;
+  /// Process type of the interaction
+  ProcessType type;
+  /// Time of the interaction [fm]
+  double time;
+  /// Density at the interaction point, as written to the outputs
+  double density;
+  /// Particles before the interaction
+  ParticleList incoming;
+  /// Particles after the interaction
+  ParticleList outgoing;
+};
+
+/// Event yielded by an EventStream
+struct StreamedEvent {
+  /// Number of the event
+  int number = -1;
+  /**
+   * Final-state particles of all ensembles. They are not copied but owned by
+   * the experiment of the stream, so they are only valid until the next
+   * event is requested.
+   */
+  const std::vector<Particles> *ensembles = nullptr;
+  /// Event info of each ensemble at the end of the event
+  std::vector<EventInfo> info;
+  /**
+   * Interactions of all ensembles in the order in which they were written to
+   * the outputs, only filled if requested from the EventStream
+   */
+  std::vector<StreamedInteraction> history;
+};
+
+/**
+ * Events of an experiment generated on demand, for programs linking SMASH
+ * that consume the events in memory, e.g.
+ * \code{.cpp}
+ * for (const StreamedEvent &event : EventStream(config)) {
+ *   for (const ParticleData &p : (*event.ensembles)[0]) { ... }
+ * }
+ * \endcode
+ *
+ * The events are simulated as by Experiment::run(), and the next event is
+ * only simulated when it is requested. The particles and decay modes have to
+ * be set up before, see initialize_particles_decays_and_tabulations(). The
+ * formats of all outputs in the configuration are set to "None", such that
+ * nothing is written to disk, but the contents are still evaluated, e.g. the
+ * hypersurface of the initial conditions.
+ *
+ * Streams of disjoint events of the same configuration, or of different
+ * configurations, can be used on different threads at the same time, under
+ * the same conditions as the concurrent events of the `--threads` option of
+ * the smash executable.
+ */
+class EventStream {
+ public:
+  /// Input iterator over the events of a stream, which runs them on demand
+  class iterator {
+   public:
+    /// Iterator category
+    using iterator_category = std::input_iterator_tag;
+    /// Type of the events
+    using value_type = StreamedEvent;
+    /// Type of differences between iterators
+    using difference_type = std::ptrdiff_t;
+    /// Pointer to the current event
+    using pointer = const StreamedEvent *;
+    /// Reference to the current event
+    using reference = const StreamedEvent &;
+
+    /// Create the end iterator
+    iterator() = default;
+    /**
+     * Create an iterator at the next event of the stream, which is simulated.
+     *
+     * \param[in] stream The stream to iterate over
+     */
+    explicit iterator(EventStream *stream) : stream_(stream) { advance(); }
+
+    /// \return the current event
+    reference operator*() const { return stream_->event(); }
+    /// \return the current event
+    pointer operator->() const { return &stream_->event(); }
+    /// Simulate the next event \return this iterator
+    iterator &operator++() {
+      advance();
+      return *this;
+    }
+    /// \return whether both iterators are at the end or at the same stream
+    bool operator==(const iterator &other) const {
+      return stream_ == other.stream_;
+    }
+    /// \return whether the iterators differ
+    bool operator!=(const iterator &other) const { return !(*this == other); }
+
+   private:
+    /// Simulate the next event, and become the end iterator if there is none
+    void advance() {
+      if (stream_ && !stream_->next()) {
+        stream_ = nullptr;
+      }
+    }
+    /// Stream of the events, nullptr at the end
+    EventStream *stream_ = nullptr;
+  };
+
+  /**
+   * Set up the experiment of the stream.
+   *
+   * \param[inout] config Configuration of the experiment, which is taken as
+   *                      by ExperimentBase::create.
+   * \param[in] collision_history Whether the interactions of the events are
+   *                              recorded in StreamedEvent::history.
+   * \param[in] first_event Number of the first event to be simulated.
+   * \param[in] event_stride Distance between the numbers of the simulated
+   *                         events, such that several streams can share the
+   *                         events of a run.
+   * \throw std::invalid_argument for selections of events not supported by
+   *        ExperimentBase::begin_events.
+   */
+  explicit EventStream(Configuration &config, bool collision_history = false,
+                       int first_event = 0, int event_stride = 1);
+  /// Cannot be copied or moved, the outputs of the experiment refer to it
+  EventStream(const EventStream &) = delete;
+  /// Cannot be copied or moved, the outputs of the experiment refer to it
+  EventStream &operator=(const EventStream &) = delete;
+  /// Destroy the experiment
+  ~EventStream();
+
+  /**
+   * Simulate the next event.
+   *
+   * \return false if all events were simulated.
+   */
+  bool next();
+
+  /// \return the event simulated last by next()
+  const StreamedEvent &event() const { return event_; }
+
+  /// \return an iterator at the next event, which is simulated
+  iterator begin() { return iterator(this); }
+  /// \return the end iterator
+  iterator end() { return iterator(); }
+
+ private:
+  /// Event simulated last, filled by the output of the experiment
+  StreamedEvent event_;
+  /// Experiment simulating the events
+  std::unique_ptr<ExperimentBase> experiment_;
+};
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_LIBRARY_H_
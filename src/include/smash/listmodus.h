@@ -9,12 +9,18 @@
 
 #include <cmath>
 #include <cstdint>
+#include <functional>
 #include <list>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
+#include "binaryreader.h"
 #include "forwarddeclarations.h"
 #include "modusdefault.h"
+#include "textreader.h"
 
 namespace smash {
 
@@ -71,7 +77,22 @@ class ListModus : public ModusDefault {
    * Construct an empty list. This is needed for children construction but it is
    * offered as public instead of protected as it is also useful for JetScape.
    */
-  ListModus() = default;
+  ListModus();
+
+  /// Stop reading events ahead of time, see take_prefetched_initial_state
+  ~ListModus();
+
+  /**
+   * Move constructor; only allowed before events are read ahead of time.
+   */
+  ListModus(ListModus &&);
+
+  /**
+   * Move assignment; only allowed before events are read ahead of time.
+   *
+   * \return The modus moved to.
+   */
+  ListModus &operator=(ListModus &&);
 
   /**
    * Generates initial state of the particles in the system according to a list.
@@ -87,6 +108,27 @@ class ListModus : public ModusDefault {
    */
   double initial_conditions(Particles *particles,
                             const ExperimentParameters &parameters);
+  /// \return Number of events which are read ahead of time
+  int prefetch_depth() const { return prefetch_depth_; }
+
+  /**
+   * Take the initial state of the next event from the ones read ahead of time
+   * on a background thread, instead of calling initial_conditions.
+   *
+   * The events are read, checked and propagated back to the same time as in
+   * initial_conditions, in the order of the files. Once the first initial
+   * state was taken, the files are only read by the background thread.
+   *
+   * \param[out] ensembles Empty ensembles, whose only one is filled with the
+   *                       particles of the event.
+   * \return The starting time of the simulation.
+   * \throw runtime_error, LoadFailure or invalid_argument if the event cannot
+   *        be read, see initial_conditions.
+   */
+  double take_prefetched_initial_state(int, int,
+                                       const std::function<int64_t(int)> &,
+                                       std::vector<Particles> *ensembles);
+
   /**
    * Judge whether formation times are the same for all the particles;
    * Don't do anti-freestreaming if all particles start already at the same
@@ -153,17 +195,12 @@ class ListModus : public ModusDefault {
 
  private:
   /**
-   * Check if the file given by filepath has events left after streampos
-   * last_position
+   * Read the particles of the next event, see initial_conditions.
    *
-   * \param[in] filepath Path to file to be checked.
-   * \param[in] last_position Stream position in file after which check is
-   * performed
-   * \return True if there is at least one event left, false otherwise
-   * \throws runtime_error If file could not be read for whatever reason.
+   * \param[out] particles An empty list that gets filled up by this function
+   * \return The starting time of the simulation
    */
-  bool file_has_events_(std::filesystem::path filepath,
-                        std::streampos last_position);
+  double read_initial_state_(Particles *particles);
 
   /**
    * Return the absolute path of the data file. If an integer is passed, the
@@ -184,10 +221,28 @@ class ListModus : public ModusDefault {
    * or from the next file (with file_id += 1)
    *
    * \returns
-   *  One event as string.
-   *  \throws runtime_error If file could not be read for whatever reason.
+   *  The lines of one event, valid until the next file is mapped.
+   *  \throws runtime_error If there are no more events.
+   */
+  std::string_view next_event_();
+
+  /**
+   * Map the current file for reading, unless this has already been done, and
+   * check whether it is in the SMASH binary format. The following files are
+   * expected in the same format.
+   *
+   * \return Whether the events are read from a binary file.
    */
-  std::string next_event_();
+  bool current_file_is_binary_();
+
+  /**
+   * Read the next event from the binary file or, if it has no more events,
+   * from the next one (with file_id += 1)
+   *
+   * \return The particle lines of one event.
+   * \throws runtime_error If there are no more events.
+   */
+  std::vector<BinaryParticleLine> next_binary_event_();
 
   /// File directory of the particle list
   std::string particle_list_file_directory_;
@@ -204,8 +259,22 @@ class ListModus : public ModusDefault {
   /// The unique id of the current event
   int event_id_;
 
-  /// Last read position in current file
-  std::streampos last_read_position_ = 0;
+  /// Reader of the current file, if it is in the SMASH binary format
+  std::shared_ptr<BinaryParticleListReader> binary_reader_;
+
+  /// Reader of the current file, if it is a text file
+  std::shared_ptr<TextParticleListReader> text_reader_;
+
+  /// Position of the next event to be read from the current file
+  std::size_t next_event_in_file_ = 0;
+
+  /// Number of events which are read ahead of time
+  int prefetch_depth_ = 0;
+
+  /// Background thread reading events and the queue it fills
+  struct EventPipeline;
+  /// Pipeline of events read ahead of time, if they are prefetched
+  std::unique_ptr<EventPipeline> pipeline_;
 
   /// Auxiliary flag to warn about mass-discrepancies only once per instance
   bool warn_about_mass_discrepancy_ = true;
@@ -298,6 +367,21 @@ class ListBoxModus : public ListModus {
             strategy};
   }
 
+  /// \copydoc smash::ModusDefault::update_grid
+  void update_grid(
+      Grid<GridOptions::PeriodicBoundaries> &grid, const Particles &particles,
+      double min_cell_length, double timestep_duration, CollisionCriterion crit,
+      const bool include_unformed_particles,
+      CellSizeStrategy strategy = CellSizeStrategy::Optimal) const {
+    CellNumberLimitation limit = CellNumberLimitation::ParticleNumber;
+    if (crit == CollisionCriterion::Stochastic) {
+      limit = CellNumberLimitation::None;
+    }
+    grid.update({{0, 0, 0}, {length_, length_, length_}}, particles,
+                min_cell_length, timestep_duration, limit,
+                include_unformed_particles, strategy);
+  }
+
  private:
   /// Length of the cube's edge in fm
   const double length_;
@@ -67,8 +67,22 @@ class Configuration;
  * former variant, that could make it slightly more efficient). You can see,
  * though, that the former variant is more concise and often much easier to type
  * than the stream operators.
+ *
+ * Messages below the level given by the `SMASH_MIN_LOG_LEVEL` CMake option are
+ * removed at compile time, irrespective of the verbosity set at runtime. By
+ * default, `TRACE` and `DEBUG` messages are removed in builds defining
+ * `NDEBUG` only.
  */
 
+#ifndef SMASH_MIN_LOG_LEVEL
+/// Minimum level of the log messages compiled into SMASH
+#define SMASH_MIN_LOG_LEVEL ALL
+#endif
+
+/// The least severe log level whose messages are compiled in
+inline constexpr einhard::LogLevel compiled_min_loglevel =
+    einhard::SMASH_MIN_LOG_LEVEL;
+
 /**
  * Declares the necessary interface to identify a new log area.
  */
@@ -223,7 +237,8 @@ FormattingHelper<T> format(const T &value, const char *unit, int width = -1,
  * An array that stores all pre-configured Logger objects. The objects can be
  * accessed via the logger function.
  */
-extern std::array<einhard::Logger<>, std::tuple_size<LogArea::AreaTuple>::value>
+extern std::array<einhard::Logger<compiled_min_loglevel>,
+                  std::tuple_size<LogArea::AreaTuple>::value>
     logg;
 }  // namespace smash
 
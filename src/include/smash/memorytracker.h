@@ -0,0 +1,194 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_MEMORYTRACKER_H_
+#define SRC_INCLUDE_SMASH_MEMORYTRACKER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace smash {
+
+/// The subsystems whose memory is accounted by the MemoryTracker
+enum class MemorySubsystem : std::size_t {
+  /// Storage of the particles of the ensembles, see Particles
+  Particles,
+  /// Nodes of the lattices of densities and fields, see RectangularLattice
+  Lattices,
+  /// Heaps of the actions to be performed, see Actions
+  Actions,
+  /// Particle snapshots queued for the outputs, see AsyncOutput
+  Outputs,
+  /// PYTHIA instances of the string processes, see StringProcess
+  StringProcess,
+};
+
+/**
+ * Accounts the current and peak number of bytes used by the subsystems of
+ * MemorySubsystem, as well as the resident memory of the process.
+ *
+ * The containers of the subsystems report their memory explicitly through a
+ * MemoryAccount. The tracking is disabled by default, in which case the
+ * accounts only store their size without touching the shared counters. The
+ * counters can be updated concurrently from several threads.
+ */
+class MemoryTracker {
+ public:
+  /**
+   * Enable or disable the tracking. Accounts are only counted once they are
+   * updated after the tracking was enabled.
+   *
+   * \param[in] enabled Whether to track the memory.
+   */
+  static void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  /// \return whether the memory is tracked.
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * Change the memory used by a subsystem.
+   *
+   * \param[in] subsystem The subsystem.
+   * \param[in] bytes Allocated bytes, negative if released.
+   */
+  static void add(MemorySubsystem subsystem, int64_t bytes);
+
+  /**
+   * \param[in] subsystem The subsystem.
+   * \return the bytes currently used by the subsystem.
+   */
+  static int64_t current_bytes(MemorySubsystem subsystem) {
+    return counter(subsystem).current;
+  }
+
+  /**
+   * \param[in] subsystem The subsystem.
+   * \return the largest number of bytes used by the subsystem so far.
+   */
+  static int64_t peak_bytes(MemorySubsystem subsystem) {
+    return counter(subsystem).peak;
+  }
+
+  /**
+   * \return the resident memory of the process [bytes], 0 if it cannot be
+   *         determined on this platform.
+   */
+  static int64_t resident_bytes();
+
+  /**
+   * \return the largest resident memory of the process so far [bytes], 0 if
+   *         it cannot be determined on this platform.
+   */
+  static int64_t peak_resident_bytes();
+
+  /// \return a table of the current and peak memory of all subsystems.
+  static std::string report();
+
+ private:
+  /// Current and peak bytes of one subsystem
+  struct Counter {
+    /// Currently used bytes
+    std::atomic<int64_t> current{0};
+    /// Largest number of used bytes so far
+    std::atomic<int64_t> peak{0};
+  };
+
+  /// Number of subsystems in MemorySubsystem
+  static constexpr std::size_t n_subsystems = 5;
+
+  /**
+   * \param[in] subsystem The subsystem.
+   * \return the counter of the subsystem.
+   */
+  static Counter &counter(MemorySubsystem subsystem) {
+    return counters_[static_cast<std::size_t>(subsystem)];
+  }
+
+  /// Whether the memory is tracked
+  static std::atomic<bool> enabled_;
+
+  /// Counters of all subsystems
+  static std::array<Counter, n_subsystems> counters_;
+};
+
+/**
+ * The memory of one container, accounted to a subsystem of the MemoryTracker
+ * while the tracking is enabled and released on destruction. Copies account
+ * the same size, such that the account can simply be a member of the
+ * container.
+ */
+class MemoryAccount {
+ public:
+  /**
+   * Create an empty account.
+   *
+   * \param[in] subsystem The subsystem to account to.
+   */
+  explicit MemoryAccount(MemorySubsystem subsystem) : subsystem_(subsystem) {}
+
+  /// Account the same size as another account.
+  MemoryAccount(const MemoryAccount &other) : subsystem_(other.subsystem_) {
+    set(other.bytes_);
+  }
+
+  /// Account the same size to the same subsystem as another account.
+  MemoryAccount &operator=(const MemoryAccount &other) {
+    if (this != &other) {
+      set(0);
+      subsystem_ = other.subsystem_;
+      set(other.bytes_);
+    }
+    return *this;
+  }
+
+  /// Release the accounted memory.
+  ~MemoryAccount() { set(0); }
+
+  /**
+   * Update the size of the container.
+   *
+   * \param[in] bytes Memory used by the container [bytes].
+   */
+  void set(std::size_t bytes) {
+    bytes_ = bytes;
+    const int64_t counted =
+        MemoryTracker::enabled() ? static_cast<int64_t>(bytes) : 0;
+    if (counted != counted_) {
+      MemoryTracker::add(subsystem_, counted - counted_);
+      counted_ = counted;
+    }
+  }
+
+  /**
+   * Account the memory to another subsystem from now on.
+   *
+   * \param[in] subsystem The subsystem to account to.
+   */
+  void set_subsystem(MemorySubsystem subsystem) {
+    const std::size_t bytes = bytes_;
+    set(0);
+    subsystem_ = subsystem;
+    set(bytes);
+  }
+
+ private:
+  /// The subsystem to account to
+  MemorySubsystem subsystem_;
+  /// Memory used by the container [bytes]
+  std::size_t bytes_ = 0;
+  /// Memory currently added to the counter of the subsystem [bytes]
+  int64_t counted_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_MEMORYTRACKER_H_
@@ -10,7 +10,10 @@
 #ifndef SRC_INCLUDE_SMASH_MODUSDEFAULT_H_
 #define SRC_INCLUDE_SMASH_MODUSDEFAULT_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "configuration.h"
 #include "forwarddeclarations.h"
@@ -68,12 +71,47 @@ class ModusDefault {
   bool is_list() const { return false; }
   /// \return Checks if modus is sphere modus; overwritten in SphereModus
   bool is_sphere() const { return false; }
+  /**
+   * \return Whether particles crossing the walls of a box are moved by
+   *         wall-crossing actions; overwritten in BoxModus
+   */
+  bool wall_crossing_actions() const { return true; }
+  /**
+   * \return Scattering rate per particle [1/fm] below which the system is
+   *         frozen out, 0 if the freeze-out is not detected; overwritten in
+   *         ColliderModus and SphereModus
+   */
+  double freeze_out_rate() const { return 0.; }
+  /**
+   * \return Whether nucleons that cannot collide yet are left out of the
+   *         search for collisions; overwritten in ColliderModus
+   */
+  bool exclude_spectators() const { return false; }
   /// \return Center of mass energy per nucleon pair in ColliderModus
   double sqrt_s_NN() const { return 0.; }
   /// \return The impact parameter; overwritten in ColliderModus
   double impact_parameter() const { return -1.; }
   /// sample impact parameter for collider modus
   void sample_impact() const {}
+  /**
+   * Change settings between events; overwritten in ColliderModus. No key is
+   * taken, so that the caller reports all of them as unchangeable.
+   */
+  void reconfigure(Configuration &) const {}
+  /** \return Number of events whose initial states are generated ahead of
+   * time; overwritten in ColliderModus */
+  int prefetch_depth() const { return 0; }
+  /**
+   * Take an initial state generated ahead of time; overwritten in
+   * ColliderModus, only called if prefetch_depth is positive.
+   *
+   * \return The starting time of the simulation.
+   */
+  double take_prefetched_initial_state(int, int,
+                                       const std::function<int64_t(int)> &,
+                                       std::vector<Particles> *) const {
+    return 0.;
+  }
   /** \return The beam velocity of the projectile required in the Collider
    * modus. In the other modus, return zero. */
   double velocity_projectile() const { return 0.0; }
@@ -140,6 +178,26 @@ class ModusDefault {
             strategy};
   }
 
+  /**
+   * Place the particles onto a grid created by create_grid before, reusing
+   * its storage. The arguments are the same as for create_grid.
+   *
+   * \param[in,out] grid The grid to be updated
+   * \see create_grid, Grid::update
+   */
+  void update_grid(
+      Grid<GridOptions::Normal>& grid, const Particles& particles,
+      double min_cell_length, double timestep_duration, CollisionCriterion crit,
+      const bool include_unformed_particles,
+      CellSizeStrategy strategy = CellSizeStrategy::Optimal) const {
+    CellNumberLimitation limit = CellNumberLimitation::ParticleNumber;
+    if (crit == CollisionCriterion::Stochastic) {
+      limit = CellNumberLimitation::None;
+    }
+    grid.update(particles, min_cell_length, timestep_duration, limit,
+                include_unformed_particles, strategy);
+  }
+
   /**
    * Creates GrandCanThermalizer
    *
@@ -7,8 +7,11 @@
 #ifndef SRC_INCLUDE_SMASH_NUCLEUS_H_
 #define SRC_INCLUDE_SMASH_NUCLEUS_H_
 
+#include <array>
+#include <cstddef>
 #include <map>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "configuration.h"
@@ -16,6 +19,7 @@
 #include "forwarddeclarations.h"
 #include "fourvector.h"
 #include "particledata.h"
+#include "tabulation.h"
 #include "threevector.h"
 
 namespace smash {
@@ -64,6 +68,10 @@ class Nucleus {
    * 1}\f$ where \f$d\f$ is the diffusiveness_ parameter and \f$r_0\f$ is
    * nuclear_radius_.
    *
+   * The radius is sampled from a table of the inverse cumulative distribution,
+   * which is built on the first call and whenever the radius or the
+   * diffusiveness changed.
+   *
    * \return  Woods-Saxon distributed position.
    */
   virtual ThreeVector distribute_nucleon();
@@ -75,9 +83,33 @@ class Nucleus {
    */
   double woods_saxon(double x);
 
-  /// Sets the positions of the nucleons inside a nucleus.
+  /**
+   * Sets the positions of the nucleons inside a nucleus.
+   *
+   * With a library of configurations, the positions are those of a randomly
+   * drawn configuration, see use_configuration_library.
+   */
   virtual void arrange_nucleons();
 
+  /**
+   * Draw the nucleons from a library of configurations from now on, instead
+   * of sampling them every time they are arranged.
+   *
+   * The library holds the positions of the nucleons before the nucleus is
+   * rotated and their Fermi momenta. It is read from the file if that exists.
+   * Otherwise it is sampled when the nucleons are arranged the first time,
+   * so that it follows the random seed of the run, and then saved to the
+   * file. The file has the format of the files of CustomNucleus, with the
+   * components of the Fermi momentum as three additional columns.
+   *
+   * \param[in] size Number of configurations sampled for the library.
+   * \param[in] file File of the library, empty for none.
+   * \throw invalid_argument if the size is not positive and the file does not
+   *                         exist.
+   * \throw runtime_error if the file is not a library of this nucleus.
+   */
+  void use_configuration_library(int size, const std::string &file);
+
   /**
    * Sets the deformation parameters of the Woods-Saxon distribution
    * according to the current mass number.
@@ -103,6 +135,9 @@ class Nucleus {
    * neutron density for neutrons and proton density for protons.
    * The actual momenta \f$p_x\f$, \f$p_y\f$, \f$p_z\f$ are
    * uniformly distributed in the sphere with radius \f$p_F\f$.
+   *
+   * With a library of configurations, the Fermi momenta of the drawn
+   * configuration are used.
    */
   virtual void generate_fermi_momenta();
 
@@ -146,6 +181,12 @@ class Nucleus {
    */
   virtual void rotate() {}
 
+  /**
+   * Rotates a configuration drawn from the library. Nondeformed nuclei are
+   * rotated randomly.
+   */
+  virtual void rotate_configuration();
+
   /**
    * Copies the particles from this nucleus into the particle list.
    *
@@ -282,6 +323,47 @@ class Nucleus {
   double proton_radius_ = 1.2;
   /// Number of testparticles per physical particle
   size_t testparticles_ = 1;
+  /**
+   * Inverse cumulative distribution of \f$r^3\f$ for the Woods-Saxon
+   * distribution
+   */
+  Tabulation radial_inverse_cdf_;
+  /// Radius and diffusiveness radial_inverse_cdf_ was built for
+  std::array<double, 2> radial_inverse_cdf_parameters_ = {};
+
+  /// Position and Fermi momentum of a nucleon in the library
+  struct LibraryNucleon {
+    /// Position before the rotation of the nucleus
+    ThreeVector position;
+    /// Fermi momentum
+    ThreeVector momentum;
+  };
+  /// Configurations of the library, one after the other
+  std::vector<LibraryNucleon> library_;
+  /// Number of configurations in the library, 0 without library
+  std::size_t library_size_ = 0;
+  /// File the library is saved to after sampling it
+  std::string library_file_;
+  /// Index of the configuration drawn last
+  std::size_t library_index_ = 0;
+
+  /// Sample the positions of the nucleons and center them
+  void sample_positions();
+  /// Sample the Fermi momenta of the nucleons, see generate_fermi_momenta
+  void sample_fermi_momenta();
+  /**
+   * Sample the configurations of the library and save them to its file.
+   *
+   * \throw runtime_error if the file cannot be written.
+   */
+  void sample_library();
+  /**
+   * Read the configurations of the library from a file.
+   *
+   * \param[in] file File of the library.
+   * \throw runtime_error if the file is not a library of this nucleus.
+   */
+  void read_library(const std::string &file);
 
  protected:
   /// Particles associated with this nucleus.
@@ -17,6 +17,7 @@
 #include "forwarddeclarations.h"
 #include "outputinterface.h"
 #include "outputparameters.h"
+#include "textline.h"
 
 namespace smash {
 
@@ -111,6 +112,16 @@ class OscarOutput : public OutputInterface {
                             const DensityParameters &dens_param,
                             const EventInfo &event) override;
 
+  /// \return Whether the interactions are written.
+  bool uses_interactions() const override {
+    return Contents & OscarInteractions;
+  }
+
+  /// \return Whether the particle lists at the output times are written.
+  bool uses_intermediate_times() const override {
+    return Contents & OscarTimesteps;
+  }
+
  private:
   /**
    * Write single particle information line to output.
@@ -130,6 +141,9 @@ class OscarOutput : public OutputInterface {
 
   /// Full filepath of the output file.
   RenamingFilePtr file_;
+
+  /// Buffer reused to format the particle lines
+  TextLine line_;
 };
 
 /**
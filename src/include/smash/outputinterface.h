@@ -78,7 +78,10 @@ struct EventInfo {
  * implement the called method. This happens e.g. in the Experiment class where
  * an array of pointers to the base class is initialized with different children
  * and then different methods are called on all array entries (some will do what
- * has to be done, but most will just do nothing).
+ * has to be done, but most will just do nothing). To spare these calls in
+ * the frequent cases, an output declares through uses_interactions(),
+ * uses_interaction_density() and uses_intermediate_times() which of them it
+ * consumes, and Experiment only calls the subscribed outputs.
  *
  * \note The parameters of most methods in this base class are not documented,
  * as irrelevant for the empty implementation. However, every child class which
@@ -158,6 +161,40 @@ class OutputInterface {
    */
   virtual void at_interaction(const Action &, const double) {}
 
+  /**
+   * Called whenever an action modified one or more particles of an ensemble.
+   * Unless an output distinguishes the ensembles, this is the same as
+   * at_interaction().
+   *
+   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] density Density at the interaction point.
+   */
+  virtual void at_ensemble_interaction(const Action &action,
+                                       const double density,
+                                       const int /*i_ensemble*/) {
+    at_interaction(action, density);
+  }
+
+  /**
+   * \return Whether the output uses the interactions. If not, they are not
+   *         passed to the output at all.
+   */
+  virtual bool uses_interactions() const { return true; }
+
+  /**
+   * \return Whether the output uses the density at the interaction point
+   *         passed with the interactions. If no output does, the density is
+   *         not computed and 0 is passed instead.
+   */
+  virtual bool uses_interaction_density() const { return uses_interactions(); }
+
+  /**
+   * \return Whether the output uses the callbacks at the output times, i.e.
+   *         at_intermediate_time() and the output of lattices and fields. If
+   *         not, they are not called.
+   */
+  virtual bool uses_intermediate_times() const { return true; }
+
   /**
    * Output launched after every N'th time-step. N is controlled by an option.
    */
@@ -7,8 +7,14 @@
 #ifndef SRC_INCLUDE_SMASH_OUTPUTPARAMETERS_H_
 #define SRC_INCLUDE_SMASH_OUTPUTPARAMETERS_H_
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
 #include <map>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -17,6 +23,7 @@
 #include "density.h"
 #include "forwarddeclarations.h"
 #include "logging.h"
+#include "particledata.h"
 
 namespace smash {
 static constexpr int LExperiment = LogArea::Experiment::id;
@@ -54,6 +61,204 @@ struct RivetOutputParameters {
   bool any_weight_parameter_was_given{false};
 };
 
+/**
+ * Helper structure for OutputParameters in order to store and hand over the
+ * settings of the ROOT files. OutputParameters has one member of this type.
+ */
+struct RootOutputParameters {
+  /// Compression algorithm of the files, "Default" to keep the one of ROOT
+  std::string compression_algorithm{"Default"};
+  /// Compression level from 0 (uncompressed) to 9
+  int compression_level{1};
+  /// Size of the baskets of every branch in bytes
+  int basket_size{32000};
+  /**
+   * Number of entries after which the baskets are flushed to the file if
+   * positive, number of compressed bytes if negative
+   */
+  int auto_flush{-30000000};
+  /// Number of events after which the trees are saved, 0 to never save them
+  int autosave_frequency{1000};
+};
+
+/**
+ * Helper structure for OutputParameters in order to store and hand over the
+ * binning of the histograms of the dilepton or photon output.
+ * OutputParameters has one member of this type for each of them.
+ */
+struct EmissionHistogramParameters {
+  /// Lower edge, upper edge [GeV] and number of bins of the mass spectra
+  std::array<double, 3> mass_bins{0., 1.2, 120.};
+  /// Lower edge, upper edge [GeV] and number of bins of the pT spectra
+  std::array<double, 3> pt_bins{0., 3., 60.};
+  /// Lower edge, upper edge and number of bins of the rapidity spectra
+  std::array<double, 3> rapidity_bins{-4., 4., 40.};
+
+  /**
+   * Take the binning from the configuration of an output content.
+   * \param[inout] conf Configuration of the outputs.
+   * \param[in] content Name of the output content.
+   * \param[in] with_mass Whether the content has mass spectra.
+   */
+  void take_from(Configuration &conf, const char *content, bool with_mass) {
+    if (with_mass) {
+      mass_bins = conf.take({content, "Mass_Bins"}, mass_bins);
+    }
+    pt_bins = conf.take({content, "Transverse_Momentum_Bins"}, pt_bins);
+    rapidity_bins = conf.take({content, "Rapidity_Bins"}, rapidity_bins);
+  }
+};
+
+/**
+ * Helper structure for OutputParameters in order to store and hand over the
+ * selection of the particles written by the outputs of the particles content.
+ * OutputParameters has one member of this type, which is applied by a
+ * FilteredOutput in front of every format.
+ */
+struct ParticleOutputFilter {
+  /// Selection of the particles by their electric charge
+  enum class Charge {
+    /// All particles
+    Any,
+    /// Only charged particles
+    Charged,
+    /// Only neutral particles
+    Neutral
+  };
+
+  /// PDG codes of the written species, sorted, all species if empty
+  std::vector<int> species{};
+  /// Selection by the electric charge
+  Charge charge{Charge::Any};
+  /// Lower and upper edge of the rapidity of the written particles
+  std::array<double, 2> rapidity_window{
+      -std::numeric_limits<double>::infinity(),
+      std::numeric_limits<double>::infinity()};
+  /// Lower and upper edge of the transverse momentum [GeV]
+  std::array<double, 2> pt_window{0.,
+                                  std::numeric_limits<double>::infinity()};
+  /// Whether only particles which interacted are written
+  bool only_participants{false};
+
+  /**
+   * Take the selection from the configuration of an output content.
+   * \param[inout] conf Configuration of the outputs.
+   * \param[in] content Name of the output content.
+   * 	hrow std::invalid_argument if the charge selection is unknown.
+   */
+  void take_from(Configuration &conf, const char *content) {
+    if (!conf.has_value({content, "Filter"})) {
+      return;
+    }
+    species = conf.take({content, "Filter", "Species"}, species);
+    std::sort(species.begin(), species.end());
+    const std::string charge_name =
+        conf.take({content, "Filter", "Charge"}, std::string("Any"));
+    if (charge_name == "Charged") {
+      charge = Charge::Charged;
+    } else if (charge_name == "Neutral") {
+      charge = Charge::Neutral;
+    } else if (charge_name != "Any") {
+      throw std::invalid_argument("Unknown charge selection \"" +
+                                  charge_name +
+                                  "\", use \"Any\", \"Charged\" or "
+                                  "\"Neutral\".");
+    }
+    if (conf.has_value({content, "Filter", "Rapidity_Window"})) {
+      rapidity_window = conf.take({content, "Filter", "Rapidity_Window"});
+    }
+    if (conf.has_value({content, "Filter", "Transverse_Momentum_Window"})) {
+      pt_window = conf.take({content, "Filter", "Transverse_Momentum_Window"});
+    }
+    only_participants =
+        conf.take({content, "Filter", "Only_Participants"}, false);
+  }
+
+  /// \return whether any particles are left out.
+  bool is_active() const {
+    return !species.empty() || charge != Charge::Any ||
+           rapidity_window[0] > -std::numeric_limits<double>::infinity() ||
+           rapidity_window[1] < std::numeric_limits<double>::infinity() ||
+           pt_window[0] > 0. ||
+           pt_window[1] < std::numeric_limits<double>::infinity() ||
+           only_participants;
+  }
+
+  /**
+   * \param[in] p A particle
+   * \return whether the particle is written. The windows include their lower
+   *         edge but not their upper edge.
+   */
+  bool accepts(const ParticleData &p) const {
+    if (!species.empty() &&
+        !std::binary_search(species.begin(), species.end(),
+                            p.pdgcode().get_decimal())) {
+      return false;
+    }
+    if ((charge == Charge::Charged && p.type().charge() == 0) ||
+        (charge == Charge::Neutral && p.type().charge() != 0)) {
+      return false;
+    }
+    if (only_participants && p.get_history().collisions_per_particle == 0) {
+      return false;
+    }
+    const FourVector mom = p.momentum();
+    const double pt = std::hypot(mom.x1(), mom.x2());
+    if (pt < pt_window[0] || pt >= pt_window[1]) {
+      return false;
+    }
+    if (rapidity_window[0] > -std::numeric_limits<double>::infinity() ||
+        rapidity_window[1] < std::numeric_limits<double>::infinity()) {
+      const double y =
+          0.5 * std::log((mom.x0() + mom.x3()) / (mom.x0() - mom.x3()));
+      if (!(y >= rapidity_window[0] && y < rapidity_window[1])) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+/**
+ * Helper structure for OutputParameters in order to store and hand over the
+ * settings of the analysis output. OutputParameters has one member of this
+ * type.
+ */
+struct AnalysisOutputParameters {
+  /// PDG codes of the analysed species
+  std::vector<int> species{211, -211, 321, -321, 2212, -2212};
+  /// Lower edge, upper edge and number of bins of the rapidity spectra
+  std::array<double, 3> rapidity_bins{-4., 4., 40.};
+  /// Lower edge, upper edge and number of bins of the pT spectra [GeV]
+  std::array<double, 3> pt_bins{0., 3., 30.};
+  /// Maximal absolute rapidity of particles entering the pT spectra and flow
+  double midrapidity_cut{0.5};
+  /// Harmonics of the anisotropic flow coefficients
+  std::vector<int> flow_harmonics{1, 2, 3};
+};
+
+/**
+ * Helper structure for OutputParameters in order to store and hand over the
+ * settings of the Green-Kubo output. OutputParameters has one member of this
+ * type.
+ */
+struct GreenKuboOutputParameters {
+  /// Number of lags per level of the multi-tau correlators
+  int points_per_level{16};
+  /// Number of levels of the multi-tau correlators
+  int levels{16};
+};
+
+/**
+ * Helper structure for OutputParameters in order to store and hand over the
+ * settings of the digest output. OutputParameters has one member of this
+ * type.
+ */
+struct DigestOutputParameters {
+  /// Digest file of a reference run to compare with, empty if none
+  std::string reference{};
+};
+
 /**
  * Helper structure for Experiment to hold output options and parameters.
  * Experiment has one member of this struct.
@@ -70,13 +275,37 @@ struct OutputParameters {
         td_jQBS(false),
         td_smearing(true),
         td_only_participants(false),
+        td_downsampling(1),
+        td_region_min{{-std::numeric_limits<double>::max(),
+                       -std::numeric_limits<double>::max(),
+                       -std::numeric_limits<double>::max()}},
+        td_region_max{{std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::max()}},
+        td_compression_level(1),
+        td_threads(1),
         part_extended(false),
         part_only_final(OutputOnlyFinal::Yes),
+        part_single_precision(false),
+        part_compression_level(1),
+        part_hepmc_batch_size(0),
+        part_filter{},
+        part_delta_blocks(false),
         coll_extended(false),
         coll_printstartend(false),
+        coll_hepmc_batch_size(0),
+        coll_hepmc_min_elastic_sqrts(0.),
         dil_extended(false),
         photons_extended(false),
+        dil_histograms{},
+        photons_histograms{},
         ic_extended(false),
+        binary_buffer_size(65536),
+        binary_event_index(false),
+        root_parameters{},
+        analysis_parameters{},
+        green_kubo_parameters{},
+        digest_parameters{},
         rivet_parameters{} {}
 
   /// Constructor from configuration
@@ -104,30 +333,88 @@ struct OutputParameters {
       }
       td_smearing = thermo_conf.take({"Smearing"}, true);
       td_only_participants = thermo_conf.take({"Only_Participants"}, false);
+      td_downsampling = thermo_conf.take({"Downsampling"}, 1);
+      if (thermo_conf.has_value({"Region_Min"})) {
+        td_region_min = thermo_conf.take({"Region_Min"});
+      }
+      if (thermo_conf.has_value({"Region_Max"})) {
+        td_region_max = thermo_conf.take({"Region_Max"});
+      }
+      td_compression_level = thermo_conf.take({"Compression_Level"}, 1);
     }
 
     if (conf.has_value({"Particles"})) {
       part_extended = conf.take({"Particles", "Extended"}, false);
       part_only_final =
           conf.take({"Particles", "Only_Final"}, OutputOnlyFinal::Yes);
+      part_single_precision =
+          conf.take({"Particles", "Single_Precision"}, false);
+      part_compression_level = conf.take({"Particles", "Compression_Level"}, 1);
+      part_hepmc_batch_size = conf.take({"Particles", "HepMC_Batch_Size"}, 0);
+      if (part_hepmc_batch_size < 0) {
+        throw std::invalid_argument("HepMC_Batch_Size cannot be negative.");
+      }
+      part_filter.take_from(conf, "Particles");
+      part_delta_blocks = conf.take({"Particles", "Delta_Blocks"}, false);
     }
 
     if (conf.has_value({"Collisions"})) {
       coll_extended = conf.take({"Collisions", "Extended"}, false);
       coll_printstartend = conf.take({"Collisions", "Print_Start_End"}, false);
+      coll_hepmc_batch_size = conf.take({"Collisions", "HepMC_Batch_Size"}, 0);
+      if (coll_hepmc_batch_size < 0) {
+        throw std::invalid_argument("HepMC_Batch_Size cannot be negative.");
+      }
+      coll_hepmc_min_elastic_sqrts =
+          conf.take({"Collisions", "HepMC_Min_Elastic_Sqrts"}, 0.);
     }
 
     if (conf.has_value({"Dileptons"})) {
       dil_extended = conf.take({"Dileptons", "Extended"}, false);
+      dil_histograms.take_from(conf, "Dileptons", true);
     }
 
     if (conf.has_value({"Photons"})) {
       photons_extended = conf.take({"Photons", "Extended"}, false);
+      photons_histograms.take_from(conf, "Photons", false);
     }
 
     if (conf.has_value({"Initial_Conditions"})) {
       ic_extended = conf.take({"Initial_Conditions", "Extended"}, false);
     }
+    if (!ParticleData::has_full_history &&
+        (part_extended || coll_extended || dil_extended || photons_extended ||
+         ic_extended)) {
+      throw std::invalid_argument(
+          "Extended outputs need the parents and the time of the last "
+          "collision of the particles, which are not stored in builds with "
+          "ENABLE_COMPACT_PARTICLE_HISTORY.");
+    }
+
+    if (conf.has_value({"Analysis"})) {
+      AnalysisOutputParameters &par = analysis_parameters;
+      par.species = conf.take({"Analysis", "Species"}, par.species);
+      par.rapidity_bins =
+          conf.take({"Analysis", "Rapidity_Bins"}, par.rapidity_bins);
+      par.pt_bins = conf.take({"Analysis", "Transverse_Momentum_Bins"},
+                              par.pt_bins);
+      par.midrapidity_cut =
+          conf.take({"Analysis", "Midrapidity_Cut"}, par.midrapidity_cut);
+      par.flow_harmonics =
+          conf.take({"Analysis", "Flow_Harmonics"}, par.flow_harmonics);
+    }
+
+    if (conf.has_value({"Green_Kubo"})) {
+      GreenKuboOutputParameters &par = green_kubo_parameters;
+      par.points_per_level = conf.take({"Green_Kubo", "Points_Per_Level"},
+                                       par.points_per_level);
+      par.levels = conf.take({"Green_Kubo", "Levels"}, par.levels);
+    }
+
+    if (conf.has_value({"Digest"})) {
+      digest_parameters.reference =
+          conf.take({"Digest", "Reference"}, digest_parameters.reference);
+    }
 
     if (conf.has_value({"Rivet"})) {
       auto rivet_conf = conf.extract_sub_configuration({"Rivet"});
@@ -258,27 +545,87 @@ struct OutputParameters {
    */
   bool td_only_participants;
 
+  /// Only every td_downsampling-th lattice node is written by VTK_XML
+  int td_downsampling;
+
+  /// Lower corner of the region of lattice nodes written by VTK_XML [fm]
+  std::array<double, 3> td_region_min;
+
+  /// Upper corner of the region of lattice nodes written by VTK_XML [fm]
+  std::array<double, 3> td_region_max;
+
+  /// zlib compression level of the VTK_XML thermodynamics output
+  int td_compression_level;
+
+  /// Number of threads evaluating the thermodynamic lattice output
+  int td_threads;
+
   /// Extended format for particles output
   bool part_extended;
 
   /// Print only final particles in event
   OutputOnlyFinal part_only_final;
 
+  /// Store real numbers in single precision in the columnar particles output
+  bool part_single_precision;
+
+  /// zlib compression level of the columnar particles output
+  int part_compression_level;
+
+  /// Number of events per batch of the HepMC particles writer thread
+  int part_hepmc_batch_size;
+
+  /// Selection of the particles written by the particles output
+  ParticleOutputFilter part_filter;
+
+  /// Write only the changes since the last output in the binary output
+  bool part_delta_blocks;
+
   /// Extended format for collisions output
   bool coll_extended;
 
   /// Print initial and final particles in event into collision output
   bool coll_printstartend;
 
+  /// Number of events per batch of the HepMC collisions writer thread
+  int coll_hepmc_batch_size;
+
+  /// Elastic scatterings below this \f$\sqrt{s}\f$ are not HepMC vertices
+  double coll_hepmc_min_elastic_sqrts;
+
   /// Extended format for dilepton output
   bool dil_extended;
 
   /// Extended format for photon output
   bool photons_extended;
 
+  /// Binning of the histograms of the dilepton output
+  EmissionHistogramParameters dil_histograms;
+
+  /// Binning of the histograms of the photon output
+  EmissionHistogramParameters photons_histograms;
+
   /// Extended initial conditions output
   bool ic_extended;
 
+  /// Number of bytes collected by binary outputs before writing to the file
+  std::size_t binary_buffer_size;
+
+  /// Whether binary outputs end with an index of their events
+  bool binary_event_index;
+
+  /// Settings of the ROOT files
+  RootOutputParameters root_parameters;
+
+  /// Settings of the analysis output
+  AnalysisOutputParameters analysis_parameters;
+
+  /// Settings of the Green-Kubo output
+  GreenKuboOutputParameters green_kubo_parameters;
+
+  /// Settings of the digest output
+  DigestOutputParameters digest_parameters;
+
   /// Rivet specfic parameters
   RivetOutputParameters rivet_parameters;
 };
@@ -0,0 +1,107 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PARALLEL_H_
+#define SRC_INCLUDE_SMASH_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace smash {
+
+/**
+ * \return Number of threads for work without a configured number of threads,
+ *         like the tabulations at startup: the hardware threads divided by
+ *         the number of events simulated concurrently, at least 1.
+ */
+int default_thread_count();
+
+/**
+ * Set the number of events simulated concurrently in this process, among
+ * which default_thread_count() divides the hardware threads.
+ *
+ * \param[in] n_events Number of concurrent events, at least 1
+ */
+void set_concurrent_events(int n_events);
+
+/**
+ * Call a function for the indices 0, ..., n-1 on several threads.
+ *
+ * The indices are handed out in chunks of consecutive indices. Worker i, of
+ * which the calling thread is worker 0, starts with chunk i and then takes the
+ * next pending chunk. Hence, with as many chunks as workers every chunk runs
+ * on its own thread. The number of workers is \p n_threads, but at least 1
+ * and at most the number of chunks.
+ *
+ * After an exception no further chunks are handed out, and the first
+ * exception in the order of the workers is rethrown once all of them
+ * finished.
+ *
+ * \tparam F Type of the function, taking either the index or the index of the
+ *         worker and the index
+ * \param[in] n_threads Maximal number of threads
+ * \param[in] n Number of indices
+ * \param[in] chunk_size Number of consecutive indices handed out at once
+ * \param[in] f Function called once for every index, which has to be safe to
+ *            call concurrently for different indices
+ */
+template <typename F>
+void parallel_for(int n_threads, std::size_t n, std::size_t chunk_size,
+                  F &&f) {
+  chunk_size = std::max<std::size_t>(chunk_size, 1);
+  const std::size_t n_chunks = (n + chunk_size - 1) / chunk_size;
+  if (n_chunks == 0) {
+    return;
+  }
+  const int n_workers = static_cast<int>(
+      std::clamp<std::size_t>(std::max(n_threads, 1), 1, n_chunks));
+  std::atomic<std::size_t> next_chunk{static_cast<std::size_t>(n_workers)};
+  std::vector<std::exception_ptr> errors(n_workers);
+  auto worker = [&](int i_thread) {
+    try {
+      for (std::size_t chunk = i_thread; chunk < n_chunks;
+           chunk = next_chunk++) {
+        const std::size_t end = std::min(n, (chunk + 1) * chunk_size);
+        for (std::size_t i = chunk * chunk_size; i < end; i++) {
+          if constexpr (std::is_invocable_v<F &, int, std::size_t>) {
+            f(i_thread, i);
+          } else {
+            f(i);
+          }
+        }
+      }
+    } catch (...) {
+      errors[i_thread] = std::current_exception();
+      next_chunk = n_chunks;
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(n_workers - 1);
+  for (int i_thread = 1; i_thread < n_workers; i_thread++) {
+    threads.emplace_back(worker, i_thread);
+  }
+  worker(0);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  for (const std::exception_ptr &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PARALLEL_H_
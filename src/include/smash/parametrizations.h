@@ -13,6 +13,7 @@
 #include <utility>
 
 #include "particletype.h"
+#include "tabulationbundle.h"
 
 /* All quantities in this file use they same units as the rest of SMASH.
  * That is: GeV for energies and momenta, fm for distances and time, and mb for
@@ -570,7 +571,7 @@ class KaonNucleonRatios {
                    const ParticleType& c, const ParticleType& d) const;
 };
 
-extern /*thread_local (see #3075)*/ KaonNucleonRatios kaon_nucleon_ratios;
+extern thread_local KaonNucleonRatios kaon_nucleon_ratios;
 
 /**
  * K- p <-> Kbar0 n cross section parametrization.
@@ -787,6 +788,37 @@ double sigmaplussigmaminus_ximinusp(double sqrts_sqrts0);
  */
 double sigmaplussigmaminus_xi0n(double sqrts_sqrts0);
 
+/**
+ * Build all interpolations of the data of the parametrizations above at
+ * startup. The data sets are smoothed concurrently, and the smoothed values
+ * are cached in the bundle.
+ *
+ * The interpolations are shared by all threads. If they were not built at
+ * startup, they are built on the first use of a parametrization, which is
+ * safe but stalls the concurrent callers. Only the first call builds them.
+ *
+ * \param[inout] bundle Cached tabulations, nullptr to smooth all data.
+ * \return Number of smoothed data sets added to the bundle.
+ */
+std::size_t initialize_parametrization_interpolations(
+    TabulationBundle *bundle = nullptr);
+
+/**
+ * Switch between the exact evaluation of the most frequently used
+ * parametrizations and linear interpolation in lookup tables.
+ *
+ * The elastic NN, N-Nbar, Npi and NK parametrizations, the N-Nbar total one
+ * and the high-energy total cross sections are tabulated in sqrt(s) with a
+ * spacing of 1 MeV up to sqrt(s) = 30 GeV on the first call enabling them.
+ * Outside of the tabulated range, the exact parametrizations are used.
+ *
+ * The tables are shared by all threads and must be built before cross sections
+ * are evaluated concurrently.
+ *
+ * \param[in] use whether the tabulated parametrizations are used
+ */
+void use_tabulated_parametrizations(bool use);
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_PARAMETRIZATIONS_H_
@@ -27,7 +27,7 @@ const std::initializer_list<double> KMINUSN_TOT_PLAB = {
     140.,    156.667,  173.333, 190.,    213.333, 240.,    276.667, 280.,
     310.};
 
-/// An interpolation that gets lazily filled using the KMINUSN_TOT data.
+/// An interpolation of the KMINUSN_TOT data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     kminusn_total_interpolation = nullptr;
 
@@ -128,7 +128,7 @@ const std::initializer_list<double> KMINUSP_ELASTIC_SIG = {
     3.6200, 4.2300, 3.9500, 3.2400, 2.9600, 3.0100, 2.4600, 2.5600, 2.3300,
     2.5400, 2.5300, 2.5100, 2.5200, 2.7400, 2.5900};
 
-/// An interpolation that gets lazily filled using the KMINUSP_ELASTIC data.
+/// An interpolation of the KMINUSP_ELASTIC data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     kminusp_elastic_interpolation = nullptr;
 
@@ -187,7 +187,7 @@ const std::initializer_list<double> KMINUSP_TOT_PLAB = {
     55.000,  70.000,  100.000, 100.000, 100.000, 120.000, 147.000, 150.000,
     150.000, 170.000, 175.000, 200.000, 200.000, 240.000, 280.000, 310.000};
 
-/// An interpolation that gets lazily filled using the KMINUSP_TOT data.
+/// An interpolation of the KMINUSP_TOT data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     kminusp_total_interpolation = nullptr;
 
@@ -269,7 +269,7 @@ const std::initializer_list<double> KMINUSP_RES_SIG = {
     1.56038155638,  1.27216056674, 1.03167072054,  0.85006416230,
     0.39627220898,  0.57172926654, 0.51129452389,  0.44626386026};
 
-/// An interpolation that gets lazily filled using the KMINUSP_RES data.
+/// An interpolation of the KMINUSP_RES data, see build_interpolations.
 static std::unique_ptr<InterpolateDataSpline>
     kminusp_elastic_res_interpolation = nullptr;
 
@@ -313,7 +313,7 @@ const std::initializer_list<double> KPLUSN_TOT_SIG = {
     18.30, 18.66, 18.56, 18.02, 18.43, 18.60, 19.04, 18.99, 19.23,
     19.63, 19.55, 19.74, 19.72, 19.82, 20.37, 20.61, 20.80};
 
-/// An interpolation that gets lazily filled using the KPLUSN_TOT data.
+/// An interpolation of the KPLUSN_TOT data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     kplusn_total_interpolation = nullptr;
 
@@ -368,7 +368,7 @@ const std::initializer_list<double> KPLUSP_TOT_SIG = {
     18.06, 18.03, 18.37, 18.28, 18.17, 18.52, 18.40, 18.88, 18.70, 18.85, 19.14,
     19.52, 19.36, 19.33, 19.64, 18.20, 19.91, 19.84, 20.22, 20.45, 20.67};
 
-/// An interpolation that gets lazily filled using the KPLUSP_TOT data.
+/// An interpolation of the KPLUSP_TOT data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     kplusp_total_interpolation = nullptr;
 
@@ -409,7 +409,7 @@ const std::initializer_list<double> PIMINUSP_ELASTIC_SIG = {
     11.1,   9.69,   9.3,    8.91,   8.5,    7.7,    7.2,    7.2,    7.8,
     7.57,   6.1};
 
-/// An interpolation that gets lazily filled using the PIMINUSP_ELASTIC data.
+/// An interpolation of the PIMINUSP_ELASTIC data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     piminusp_elastic_interpolation = nullptr;
 
@@ -440,7 +440,7 @@ const std::initializer_list<double> PIMINUSP_LAMBDAK0_SIG = {
     0.16,  0.106,  0.12,  0.09,  0.09,  0.109,  0.084, 0.094, 0.087, 0.067,
     0.058, 0.0644, 0.049, 0.054, 0.038, 0.0221, 0.0157};
 
-/// An interpolation that gets lazily filled using the PIMINUSP_LAMBDAK0 data.
+/// An interpolation of the PIMINUSP_LAMBDAK0 data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     piminusp_lambdak0_interpolation = nullptr;
 
@@ -658,7 +658,7 @@ const std::initializer_list<double> PIMINUSP_RES_SIG = {
     0.070291,  0.064685,  0.061942,  0.060365,  0.055497,  0.040625,  0.039905,
     0.027723,  0.022456,  0.017122,  0.016299,  0.014606};
 
-/// An interpolation that gets lazily filled using the PIMINUSP_RES data.
+/// An interpolation of the PIMINUSP_RES data, see build_interpolations.
 static std::unique_ptr<InterpolateDataSpline>
     piminusp_elastic_res_interpolation = nullptr;
 
@@ -697,7 +697,7 @@ const std::initializer_list<double> PIPLUSP_ELASTIC_SIG = {
     4.75,  4.2,   4.54,  4.46,  4.21,  4.21,  3.98,  3.19,  3.37,  3.16,  3.29,
     3.1,   3.35,  3.3,   3.39,  3.24,  3.37,  3.17,  3.3};
 
-/// An interpolation that gets lazily filled using the PIPLUSP_ELASTIC_SIG data.
+/// An interpolation of the PIPLUSP_ELASTIC_SIG data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     piplusp_elastic_interpolation = nullptr;
 
@@ -980,7 +980,7 @@ const std::initializer_list<double> PIPLUSP_TOT_SIG = {
     23.766309,  23.759220,  23.741498,  23.778715,  23.747223,  23.751422,
     23.757168,  23.726229,  23.700736,  23.714497,  23.733227};
 
-/// An interpolation that gets lazily filled using the PIPLUSP_TOT data.
+/// An interpolation of the PIPLUSP_TOT data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     piplusp_total_interpolation = nullptr;
 
@@ -1164,7 +1164,7 @@ const std::initializer_list<double> PIMINUSP_TOT_SIG = {
     25.499989, 25.524119, 25.505887, 25.517685, 25.531841, 25.464596, 25.496449,
     25.494090, 25.459770, 25.482292, 25.458698, 25.461057, 25.469253};
 
-/// An interpolation that gets lazily filled using the PIMINUSP_TOT data.
+/// An interpolation of the PIMINUSP_TOT data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     piminusp_total_interpolation = nullptr;
 
@@ -1302,7 +1302,7 @@ const std::initializer_list<double> PIPLUSPIMINUS_TOT_SIG = {
     17.328783,  17.300391,  17.290688,  17.283970,  17.266057,  17.280985,
     17.266057,  17.232470,  17.268048,  17.238292,  17.203361};
 
-/// An interpolation that gets lazily filled using the PIPLUSPIMINUS_TOT data.
+/// An interpolation of the PIPLUSPIMINUS_TOT data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     pipluspiminus_total_interpolation = nullptr;
 
@@ -1431,7 +1431,7 @@ const std::initializer_list<double> PIZEROPIZERO_TOT_SIG = {
     17.319797, 17.273223, 17.306859, 17.290688, 17.242173, 17.290688, 17.244945,
     17.229236, 17.219995};
 
-/// An interpolation that gets lazily filled using the PIZEROPIZERO_TOT data.
+/// An interpolation of the PIZEROPIZERO_TOT data, see build_interpolations.
 static std::unique_ptr<InterpolateDataLinear<double>>
     pizeropizero_total_interpolation = nullptr;
 
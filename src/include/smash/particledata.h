@@ -7,6 +7,7 @@
 #ifndef SRC_INCLUDE_SMASH_PARTICLEDATA_H_
 #define SRC_INCLUDE_SMASH_PARTICLEDATA_H_
 
+#include <cmath>
 #include <limits>
 
 #include "forwarddeclarations.h"
@@ -26,6 +27,11 @@ enum class BelongsTo : uint8_t {
 /**
  * A structure to hold information about the history of the particle,
  * e.g. the last interaction etc.
+ *
+ * In builds with ENABLE_COMPACT_PARTICLE_HISTORY, the particles only store
+ * the number of collisions and the last process, and the time of the last
+ * collision and the parents keep their default values, see
+ * ParticleData::has_full_history.
  */
 struct HistoryData {
   /// Collision counter per particle, zero only for initially present particles
@@ -136,7 +142,30 @@ class ParticleData {
    * Get history information
    * \return particle history struct
    */
-  HistoryData get_history() const { return history_; }
+  HistoryData get_history() const {
+    HistoryData history;
+    history.collisions_per_particle = history_.collisions_per_particle;
+    history.id_process = history_.id_process;
+    history.process_type = static_cast<ProcessType>(process_type_);
+#ifndef SMASH_COMPACT_PARTICLE_HISTORY
+    history.time_last_collision = history_.time_last_collision;
+    history.p1 = history_.p1;
+    history.p2 = history_.p2;
+#endif
+    return history;
+  }
+
+  /**
+   * Whether the particles store the time of their last collision and their
+   * parents, which the extended outputs need. Builds with
+   * ENABLE_COMPACT_PARTICLE_HISTORY leave them out to keep ParticleData
+   * within two cache lines.
+   */
+#ifdef SMASH_COMPACT_PARTICLE_HISTORY
+  static constexpr bool has_full_history = false;
+#else
+  static constexpr bool has_full_history = true;
+#endif
   /**
    * Store history information
    *
@@ -294,6 +323,29 @@ class ParticleData {
     initial_xsec_scaling_factor_ = xsec_scal;
   }
 
+  /**
+   * Get the absolute time, at which the particle is scheduled to decay
+   *
+   * \return scheduled decay time in the computational frame, NaN if no decay
+   *         time has been sampled since the last interaction
+   */
+  double scheduled_decay_time() const { return scheduled_decay_time_; }
+  /// \return whether a decay time has been sampled for the particle
+  bool has_scheduled_decay() const {
+    return !std::isnan(scheduled_decay_time_);
+  }
+  /**
+   * Store the absolute time, at which the particle will decay
+   *
+   * The schedule is cleared by set_history for any process except wall
+   * crossings, because an interaction changes the mass or the velocity the
+   * decay time was sampled from.
+   *
+   * \param[in] decay_time absolute decay time in the computational frame,
+   *            infinity for a particle that does not decay
+   */
+  void schedule_decay(double decay_time) { scheduled_decay_time_ = decay_time; }
+
   /**
    * Get the velocity 3-vector
    * \return 3-velocity of the particle
@@ -333,11 +385,31 @@ class ParticleData {
     set_4momentum(momentum_.lorentz_boost(v));
   }
 
+  /**
+   * Apply a Lorentz-boost, which is shared by many particles, to only the
+   * momentum
+   * \param[in] boost the boost
+   */
+  void boost_momentum(const LorentzBoost &boost) {
+    set_4momentum(boost(momentum_));
+  }
+
   /// Setter for belongs_to label
   void set_belongs_to(BelongsTo label) { belongs_to_ = label; }
   /// Getter for belongs_to label
   BelongsTo belongs_to() const { return belongs_to_; }
 
+  /**
+   * Setter for the subensemble of test particles, within which the particle
+   * interacts, see ExperimentParameters::n_subensembles.
+   * \param[in] subensemble Index of the subensemble
+   */
+  void set_subensemble(std::uint16_t subensemble) {
+    subensemble_ = subensemble;
+  }
+  /// Getter for the subensemble of test particles
+  std::uint16_t subensemble() const { return subensemble_; }
+
   /**
    * Check whether two particles have the same id
    * \param[in] a particle to compare to
@@ -385,11 +457,15 @@ class ParticleData {
    */
   double xsec_scaling_factor(double delta_time = 0.) const;
 
-  /// Power with which the cross section scaling factor grows in time.
-  static double formation_power_;
+  /**
+   * Power with which the cross section scaling factor grows in time. It is
+   * thread-local, every experiment sets it on the threads it runs on.
+   */
+  static thread_local double formation_power_;
 
  private:
   friend class Particles;
+  friend class GridBase;
   /// Default constructor.
   ParticleData() = default;
 
@@ -401,12 +477,15 @@ class ParticleData {
    */
   void copy_to(ParticleData &dst) const {
     dst.history_ = history_;
+    dst.process_type_ = process_type_;
     dst.momentum_ = momentum_;
     dst.position_ = position_;
     dst.formation_time_ = formation_time_;
     dst.initial_xsec_scaling_factor_ = initial_xsec_scaling_factor_;
     dst.begin_formation_time_ = begin_formation_time_;
+    dst.scheduled_decay_time_ = scheduled_decay_time_;
     dst.belongs_to_ = belongs_to_;
+    dst.subensemble_ = subensemble_;
   }
 
   /**
@@ -435,10 +514,13 @@ class ParticleData {
    */
   ParticleTypePtr type_;
 
-  // this leaves us two Bytes padding to use for "free"
+  /*
+   * The members are ordered such that the small ones fill the space before
+   * the first double, and the history, which is only needed for actions that
+   * are performed and for the output, comes last.
+   */
   static_assert(sizeof(ParticleTypePtr) == 2, "");
-  // make sure we don't exceed that space
-  static_assert(sizeof(bool) <= 2, "");
+  static_assert(sizeof(bool) == 1 && sizeof(BelongsTo) == 1, "");
   /**
    * If \c true, the object is an entry in Particles::data_ and does not hold
    * valid particle data. Specifically iterations over Particles must skip
@@ -448,6 +530,12 @@ class ParticleData {
    * \see Particles::data_
    */
   bool hole_ = false;
+  /// is it part of projectile or target nuclei?
+  BelongsTo belongs_to_ = BelongsTo::Nothing;
+  /// ProcessType of the last action, see HistoryData::process_type
+  std::uint8_t process_type_ = static_cast<std::uint8_t>(ProcessType::None);
+  /// Subensemble of test particles, within which the particle interacts
+  std::uint16_t subensemble_ = 0;
 
   /// momenta of the particle: x0, x1, x2, x3 as E, px, py, pz
   FourVector momentum_;
@@ -464,10 +552,31 @@ class ParticleData {
    * 1 by default, since a particle is fully formed in this case.
    */
   double initial_xsec_scaling_factor_ = 1.0;
+  /// absolute decay time, NaN if not sampled (see schedule_decay)
+  double scheduled_decay_time_ = std::numeric_limits<double>::quiet_NaN();
+
+  /**
+   * History information without the process type, in an order without
+   * padding. See HistoryData for the meaning of the members.
+   */
+  struct CompactHistory {
+#ifndef SMASH_COMPACT_PARTICLE_HISTORY
+    /// \copydoc HistoryData::time_last_collision
+    double time_last_collision = 0.0;
+#endif
+    /// \copydoc HistoryData::collisions_per_particle
+    int32_t collisions_per_particle = 0;
+    /// \copydoc HistoryData::id_process
+    int32_t id_process = 0;
+#ifndef SMASH_COMPACT_PARTICLE_HISTORY
+    /// \copydoc HistoryData::p1
+    PdgCode p1 = 0x0;
+    /// \copydoc HistoryData::p2
+    PdgCode p2 = 0x0;
+#endif
+  };
   /// history information
-  HistoryData history_;
-  /// is it part of projectile or target nuclei?
-  BelongsTo belongs_to_ = BelongsTo::Nothing;
+  CompactHistory history_;
 };
 
 /**
@@ -7,17 +7,44 @@
 #ifndef SRC_INCLUDE_SMASH_PARTICLES_H_
 #define SRC_INCLUDE_SMASH_PARTICLES_H_
 
+#include <array>
 #include <memory>
 #include <type_traits>
 #include <vector>
 
 #include "macros.h"
+#include "memorytracker.h"
 #include "particledata.h"
 #include "particletype.h"
 #include "pdgcode.h"
 
 namespace smash {
 
+/**
+ * \ingroup data
+ *
+ * Structure-of-arrays copy of the kinematics and types of the particles
+ * stored in a Particles object.
+ *
+ * Entry i of every array belongs to the particle with ParticleData::index_ i,
+ * i.e. the arrays have the same layout as the storage of Particles including
+ * holes. This allows loops over all particles, which only need positions,
+ * momenta or types, to run over contiguous memory.
+ */
+struct ParticleArrays {
+  /// Components of the 4-positions: position[mu][i] is x^mu of particle i
+  std::array<std::vector<double>, 4> position;
+  /// Components of the 4-momenta: momentum[mu][i] is p^mu of particle i
+  std::array<std::vector<double>, 4> momentum;
+  /// Types of the particles
+  std::vector<ParticleTypePtr> type;
+  /// Whether entry i holds a particle (1) or is a hole (0)
+  std::vector<char> valid;
+
+  /// \return the number of entries (including holes).
+  size_t size() const { return valid.size(); }
+};
+
 /**
  * \ingroup data
  *
@@ -40,12 +67,44 @@ class Particles {
   /// Cannot be copied
   Particles &operator=(const Particles &) = delete;
 
+  /**
+   * Create an exact copy, in which the particles keep their ids and indices.
+   * The structure-of-arrays copy is not duplicated.
+   *
+   * \param[in] subsystem The subsystem whose memory the copy is accounted to,
+   *            see MemoryTracker.
+   * \return the copy of the particles
+   */
+  std::unique_ptr<Particles> clone(
+      MemorySubsystem subsystem = MemorySubsystem::Particles) const;
+
+  /**
+   * Replace the particles by an exact copy of \p other, in which the particles
+   * keep their ids and indices. The storage is reused if it is large enough.
+   *
+   * \param[in] other The particles to copy
+   */
+  void copy_from(const Particles &other);
+
   /// \return a copy of all particles as a std::vector<ParticleData>.
   ParticleList copy_to_vector() const {
+    ParticleList list;
+    append_to(list);
+    return list;
+  }
+
+  /**
+   * Append copies of all particles to \p list, reusing its storage.
+   *
+   * \param[inout] list The list the particles are appended to
+   */
+  void append_to(ParticleList &list) const {
+    list.reserve(list.size() + size());
     if (dirty_.empty()) {
-      return {&data_[0], &data_[data_size_]};
+      list.insert(list.end(), &data_[0], &data_[data_size_]);
+    } else {
+      list.insert(list.end(), begin(), end());
     }
-    return {begin(), end()};
   }
 
   /**
@@ -135,6 +194,9 @@ class Particles {
    * valid copy obtained from Particles, i.e. a call to \ref is_valid must
    * return \c true.
    *
+   * If \p p is the last entry in the storage, the storage shrinks, also
+   * by the holes before it, such that iterations do not have to skip them.
+   *
    * \param[in] p Particle which is going to be removed
    * \note The validity of \p p is only enforced in DEBUG builds.
    */
@@ -178,6 +240,9 @@ class Particles {
     assert(p.type() == new_state.type());
     ParticleData &original = data_[p.index_];
     new_state.copy_to(original);
+    if (arrays_) {
+      store_in_arrays(p.index_);
+    }
     return original;
   }
 
@@ -224,6 +289,103 @@ class Particles {
     return data_[old_state.index_];
   }
 
+  /**
+   * Start to maintain a structure-of-arrays copy of the positions, momenta and
+   * types of the particles (see ParticleArrays).
+   *
+   * Once enabled, the arrays are kept in sync by all member functions that
+   * modify the particles (insert, create, remove, replace, update, reset).
+   * Particles modified through references or iterators are not tracked, call
+   * sync_arrays() afterwards.
+   */
+  void enable_arrays() {
+    if (!arrays_) {
+      arrays_ = std::make_unique<ParticleArrays>();
+    }
+    sync_arrays();
+  }
+
+  /// \return whether the structure-of-arrays copy is maintained.
+  bool arrays_enabled() const { return arrays_ != nullptr; }
+
+  /**
+   * \return the structure-of-arrays copy of the particles.
+   *
+   * \note This function may only be called after enable_arrays().
+   */
+  const ParticleArrays &arrays() const {
+    assert(arrays_ != nullptr);
+    return *arrays_;
+  }
+
+  /**
+   * Copy the state of all particles to the structure-of-arrays copy. This is
+   * needed after particles were modified through references or iterators.
+   *
+   * \note This function may only be called after enable_arrays().
+   */
+  void sync_arrays();
+
+  /**
+   * Boost the momenta of all particles with the velocity \p beta, with the
+   * Lorentz factor computed once for all of them. The structure-of-arrays
+   * copy, if enabled, is boosted alongside with the loop over its component
+   * arrays, see LorentzBoost::apply.
+   *
+   * \param[in] beta Velocity of the boost.
+   */
+  void boost_momenta(const ThreeVector &beta);
+
+  /**
+   * Reorder the storage of the particles along the Morton curve of cubic
+   * cells, which also removes all holes. Particles close in space are then
+   * mostly close in memory, which makes the accesses of the grid and the
+   * lattices cache-friendly. The ids of the particles stay the same, but
+   * all copies obtained before are no longer valid, see is_valid.
+   *
+   * \param[in] cell_length Length of the cells [fm]
+   * \throw std::invalid_argument if \p cell_length is not positive
+   */
+  void sort_spatially(double cell_length);
+
+  /**
+   * Move the storage of the particles to memory allocated by the calling
+   * thread. The operating system usually places memory on the NUMA node of
+   * the thread that touches it first, so this should be called by the thread
+   * that works on the particles. The order of the storage, the holes and
+   * thus the copies obtained before stay valid.
+   */
+  void relocate();
+
+  /**
+   * \return the number of holes and of particles added since the last
+   * sort_spatially, relative to the size of the storage. Added particles
+   * fill holes or are appended, regardless of their position.
+   */
+  double disorder() const {
+    if (data_size_ == 0) {
+      return 0.;
+    }
+    return static_cast<double>(dirty_.size() + added_since_sort_) / data_size_;
+  }
+
+  /**
+   * Write the particles to a checkpoint, including the holes, such that
+   * read_checkpoint restores them at the same indexes with the same ids.
+   *
+   * \param[out] out Stream of the checkpoint
+   */
+  void write_checkpoint(std::ostream &out) const;
+
+  /**
+   * Replace the particles by those of a checkpoint written by
+   * write_checkpoint. The list of particle types has to be the same as when
+   * the checkpoint was written.
+   *
+   * \param[in] in Stream of the checkpoint
+   */
+  void read_checkpoint(std::istream &in);
+
   /**
    * \internal
    * Iterator type that skips over the holes in `data_`. It implements a
@@ -429,6 +591,16 @@ class Particles {
   /// \return a const end iterator.
   const_iterator cend() const { return end(); }
 
+  /**
+   * Split the storage into ranges of about the same length, e.g. to work on
+   * the particles on several threads. The ranges may be empty.
+   *
+   * \param[in] n Number of ranges
+   * \return n + 1 iterators, the i-th range runs from the i-th to the
+   *         (i+1)-th iterator.
+   */
+  std::vector<iterator> partition(int n);
+
   /**
    * \ingroup logging
    * Print effective mass and type name for all particles to the stream.
@@ -462,6 +634,12 @@ class Particles {
    * list.
    */
   inline void ensure_capacity(unsigned to_add);
+  /**
+   * \internal
+   * Shrink data_size_ by the holes at the end of the used range and remove
+   * them from dirty_. The structure-of-arrays copy is not adjusted.
+   */
+  void trim_holes();
   /**
    * \internal
    * Common implementation for copying the relevant data of a ParticleData
@@ -479,6 +657,15 @@ class Particles {
    */
   inline void copy_in(ParticleData &to, const ParticleData &from);
 
+  /**
+   * \internal
+   * Copy the state of the particle at \p index to the arrays, resizing them to
+   * data_size_ if needed.
+   *
+   * \param[in] index Index of the particle in data_
+   */
+  void store_in_arrays(unsigned index);
+
   /**
    * \internal
    * The number of elements in data_ (including holes, but excluding entries
@@ -497,11 +684,23 @@ class Particles {
    */
   std::unique_ptr<ParticleData[]> data_;
 
+  /// Accounts the memory of data_, see MemoryTracker
+  MemoryAccount memory_{MemorySubsystem::Particles};
+
   /**
    * Stores the indexes in data_ that do not hold valid particle data and should
    * be reused when new particles are added.
    */
   std::vector<unsigned> dirty_;
+
+  /// Number of particles added by insert or create since sort_spatially
+  std::size_t added_since_sort_ = 0;
+
+  /**
+   * Structure-of-arrays copy of the particles, which only exists if
+   * enable_arrays() was called.
+   */
+  std::unique_ptr<ParticleArrays> arrays_;
 };
 
 }  // namespace smash
@@ -0,0 +1,70 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PARTICLESNAPSHOT_H_
+#define SRC_INCLUDE_SMASH_PARTICLESNAPSHOT_H_
+
+#include <filesystem>
+
+#include "sha256.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Binary snapshot of the particle types and decay modes as they result from
+ * parsing the particles and decay modes files, so that later runs with the
+ * same files can skip parsing and checking them.
+ *
+ * The snapshot contains the particle types sorted by PDG code (name, mass,
+ * width, parity and PDG code), the decay types (mother, products and angular
+ * momentum) and the decay modes of every particle type (decay type and
+ * weight), which refer to types by their index. Isospin multiplets are
+ * recreated from the particle types. The file name contains the hash of the
+ * SMASH version and of the input files.
+ */
+class ParticleSnapshot {
+ public:
+  /**
+   * \param[in] dir Tabulations directory.
+   * \param[in] hash Hash of the particle properties.
+   * \return Path of the snapshot of the given hash in the directory.
+   */
+  static std::filesystem::path path(const std::filesystem::path &dir,
+                                    sha256::Hash hash);
+
+  /**
+   * Write the current particle types and decay modes into a directory,
+   * replacing the snapshot of the same hash atomically.
+   *
+   * \param[in] dir Tabulations directory.
+   * \param[in] hash Hash of the particle properties.
+   * \throw std::runtime_error if the snapshot cannot be written.
+   */
+  static void write(const std::filesystem::path &dir, sha256::Hash hash);
+
+  /**
+   * Create the particle types and decay modes from the snapshot of the given
+   * hash, instead of ParticleType::create_type_list and
+   * DecayModes::load_decaymodes.
+   *
+   * Nothing is created if the snapshot is missing. A damaged snapshot or one
+   * of a different format version is ignored with a warning.
+   *
+   * \param[in] dir Tabulations directory.
+   * \param[in] hash Hash of the particle properties.
+   * \return Whether the particle types and decay modes were created.
+   */
+  static bool read(const std::filesystem::path &dir, sha256::Hash hash);
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PARTICLESNAPSHOT_H_
@@ -9,6 +9,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -131,9 +132,12 @@ class ParticleType {
   ParticleType &operator=(const ParticleType &) = delete;
 
   /// move ctors are needed for std::sort
-  ParticleType(ParticleType &&) = default;
+  ParticleType(ParticleType &&);
   /// move ctors are needed for std::sort
-  ParticleType &operator=(ParticleType &&) = default;
+  ParticleType &operator=(ParticleType &&);
+
+  /// Destructor, defined where the tabulation of the widths is complete
+  ~ParticleType();
 
   /// \return the DecayModes object for this particle type.
   const DecayModes &decay_modes() const;
@@ -301,11 +305,38 @@ class ParticleType {
   /**
    * Get the mass-dependent total width of a particle with mass m.
    *
+   * Once DecayModes::tabulate_widths was called, the width is interpolated
+   * linearly in the tabulated mass range, and evaluated exactly outside of it.
+   *
    * \param[in] m Invariant mass of the decaying particle.
    * \return the total width for all modes for this mass
    */
   double total_width(const double m) const;
 
+  /**
+   * Get the mass-dependent sum of the hadronic partial widths of a particle
+   * with mass m, i.e. the width that determines the hadronic decays if the
+   * decays are not affected by potentials.
+   *
+   * Once DecayModes::tabulate_widths was called, the width is interpolated
+   * linearly in the tabulated mass range, and evaluated exactly outside of it.
+   *
+   * \param[in] m Invariant mass of the decaying particle.
+   * \return the sum of the hadronic partial widths for this mass
+   */
+  double hadronic_width(const double m) const;
+
+  /**
+   * Tabulate the cumulative distribution of the spectral function of all
+   * unstable particle types, from which sample_resonance_mass and
+   * sample_resonance_masses draw the masses up to 10 GeV above the minimal
+   * mass, instead of sampling them by rejection from a Cauchy distribution.
+   *
+   * This is not thread-safe and has to be done once during the setup, after
+   * the decay modes are loaded.
+   */
+  static void tabulate_spectral_functions();
+
   /**
    * Helper Function that containes the if-statement logic that decides if a
    * decay mode is either a hadronic and dilepton decay mode.
@@ -352,6 +383,23 @@ class ParticleType {
   double get_partial_in_width(const double m, const ParticleData &p_a,
                               const ParticleData &p_b) const;
 
+  /**
+   * Get the mass-dependent partial in-width of a resonance with mass m into
+   * two given daughter particles, summed over known decay modes into them.
+   * This is get_partial_in_width(const double, const ParticleData &,
+   * const ParticleData &) without searching the decay modes.
+   *
+   * \param[in] m Invariant mass of the decaying resonance.
+   * \param[in] p_a First daughter particle.
+   * \param[in] p_b Second daughter particle.
+   * \param[in] in_modes Indices of the decay modes into the daughters, see
+   *                     FormationCandidate.
+   * \return the partial in-width for this mass and these decay channels
+   */
+  double get_partial_in_width(const double m, const ParticleData &p_a,
+                              const ParticleData &p_b,
+                              const std::vector<std::size_t> &in_modes) const;
+
   /**
    * Full spectral function
    * \f$ A(m) = \frac{2}{\pi} N
@@ -471,10 +519,9 @@ class ParticleType {
    * If the particle type is not found, an invalid ParticleTypePtr is returned.
    * You can convert a ParticleTypePtr to a bool to check whether it is valid.
    *
-   * \note The complexity of the search is \f$\mathcal O(\log N)\f$. Therefore,
-   * do not use this function except for user input that selects a particle
-   * type. All other internal references for a particle type should use
-   * ParticleTypePtr instead.
+   * \note The search is a look-up in a hash table built together with the
+   * type list and takes constant time. Internal references to a particle
+   * type should nevertheless use ParticleTypePtr.
    *
    * \param[in] pdgcode the unique pdg code to try to find
    * \return the ParticleTypePtr that corresponds to this pdg code, or an
@@ -533,6 +580,18 @@ class ParticleType {
    */
   static void create_type_list(const std::string &particles);
 
+  /**
+   * Initialize the global ParticleType list (list_all) from already created
+   * types, together with the isospin multiplets and the lists of particular
+   * types. This function must only be called once (will fail on second
+   * invocation).
+   *
+   * \param[in] type_list All particle types, sorted by PDG code and without
+   *                      duplicates.
+   * \throw runtime_error if this function is called more than once
+   */
+  static void set_type_list(ParticleTypeList type_list);
+
   /**
    * \param[in] rhs another ParticleType to compare to
    * \return whether the two ParticleType objects have the same PDG code.
@@ -652,10 +711,30 @@ class ParticleType {
   /// Container for the isospin multiplet information
   IsoParticleType *iso_multiplet_ = nullptr;
 
-  /// Maximum factor for single-res mass sampling, cf. sample_resonance_mass.
-  mutable double max_factor1_ = 1.;
-  /// Maximum factor for double-res mass sampling, cf. sample_resonance_masses.
-  mutable double max_factor2_ = 1.;
+  /**
+   * Maximum of the ratio of the full to the simple spectral function within
+   * the tabulated range, cf. sample_resonance_mass and
+   * tabulate_spectral_functions.
+   */
+  mutable double spectral_ratio_max_ = 1.;
+
+  /**
+   * Tabulation of the cumulative distribution of the spectral function over
+   * the arctangent of the distance to the pole mass in units of the pole
+   * width, cf. tabulate_spectral_functions.
+   */
+  mutable std::unique_ptr<Tabulation> spectral_cdf_;
+  /// Upper end of the mass range of spectral_cdf_.
+  mutable double spectral_max_mass_ = 0.;
+
+  /**
+   * Sample a mass from the tabulated spectral function, restricted to the
+   * masses below \p max_mass.
+   *
+   * \param[in] max_mass Largest possible mass, within the tabulated range.
+   * \return the sampled mass
+   */
+  double sample_tabulated_mass(double max_mass) const;
 
   /**\ingroup logging
    * Writes all information about the particle type to the output stream.
@@ -716,6 +795,13 @@ class ParticleTypePtr {
   /// \return whether the objects stores a valid ParticleType reference.
   operator bool() const { return index_ != 0xffff; }
 
+  /**
+   * \return the offset of the referenced ParticleType object in
+   *         ParticleType::list_all(), which other tables over all particle
+   *         types can use as a compact key.
+   */
+  std::uint16_t index() const { return index_; }
+
  private:
   /**
    * ParticleType::operator& is a friend in order to call the constructor
@@ -766,9 +852,8 @@ inline ParticleTypePtr ParticleType::get_antiparticle() const {
  * \param[in] type_b second incoming particle.
  * \return list of possible resonances.
  *
- * \note Internally, a `static std::map` is used as a caching mechanism and is
- * filled the first time this function is called, such that calling it again
- * just returns the same list.
+ * \see DecayModes::formation_candidates, which also knows the decay modes
+ * of the resonances into the pair.
  */
 ParticleTypePtrList list_possible_resonances(const ParticleTypePtr type_a,
                                              const ParticleTypePtr type_b);
@@ -10,6 +10,8 @@
 #ifndef SRC_INCLUDE_SMASH_PAULIBLOCKING_H_
 #define SRC_INCLUDE_SMASH_PAULIBLOCKING_H_
 
+#include <array>
+#include <unordered_map>
 #include <vector>
 
 #include "configuration.h"
@@ -68,7 +70,110 @@ class PauliBlocker {
                          const PdgCode pdg,
                          const ParticleList &disregard) const;
 
+  /**
+   * Sort the baryons of all ensembles into a spatial index, such that
+   * phasespace_dens only has to look at particles in the cells around the
+   * requested position instead of all particles. With momentum cells, the
+   * index is six-dimensional and only the cells around the requested momentum
+   * are looked at in addition.
+   *
+   * The index refers to the particles in the given ensembles, which have to
+   * be passed to phasespace_dens afterwards. Positions and momenta are read
+   * from the ensembles, so that particles may be propagated after building
+   * the index, as long as they do not go beyond end_time. Particles that are
+   * created, removed, moved discontinuously or change their momentum have to
+   * be reported with update_index.
+   *
+   * \param[in] ensembles Current list of particles in all ensembles.
+   * \param[in] end_time Time up to which the particles may be propagated
+   *            while the index is used [fm].
+   */
+  void build_index(const std::vector<Particles> &ensembles, double end_time);
+
+  /**
+   * Update the index after the particles of an action were replaced.
+   * Does nothing if there is no index.
+   *
+   * \param[in] ensemble Index of the ensemble the action was performed in.
+   * \param[in] removed Incoming particles of the action.
+   * \param[in] added Outgoing particles of the action, already inserted
+   *            into the ensemble.
+   */
+  void update_index(int ensemble, const ParticleList &removed,
+                    const ParticleList &added);
+
+  /**
+   * Drop the index, such that phasespace_dens loops over all particles
+   * again. This is needed once particles are propagated beyond the end time
+   * given to build_index.
+   */
+  void clear_index();
+
  private:
+  /// Species and integer coordinates of a cell of the index
+  struct IndexKey {
+    /// Species of the particles in the cell
+    PdgCode pdg;
+    /// Coordinates of the cell in units of index_cell_length_
+    std::array<int, 3> cell;
+    /// Momentum coordinates of the cell in units of momentum_cell_length_
+    std::array<int, 3> momentum_cell;
+    /// \return whether both keys denote the same cell
+    bool operator==(const IndexKey &other) const {
+      return pdg == other.pdg && cell == other.cell &&
+             momentum_cell == other.momentum_cell;
+    }
+  };
+
+  /// Hash function of the cell keys
+  struct IndexKeyHash {
+    /// \return hash of the cell key
+    std::size_t operator()(const IndexKey &key) const {
+      std::size_t h = static_cast<std::size_t>(key.pdg.get_decimal());
+      for (const int c : key.cell) {
+        h = h * 1000003u ^ static_cast<std::size_t>(c);
+      }
+      for (const int c : key.momentum_cell) {
+        h = h * 1000003u ^ static_cast<std::size_t>(c);
+      }
+      return h;
+    }
+  };
+
+  /// Particle referenced by the index
+  struct IndexEntry {
+    /// Ensemble of the particle
+    int ensemble;
+    /// Copy of the particle, only used to look it up in its ensemble
+    ParticleData particle;
+  };
+
+  /**
+   * \param[in] pdg Species of the particle
+   * \param[in] r Position of the particle
+   * \param[in] p Momentum of the particle
+   * \return key of the cell containing the given position and momentum
+   */
+  IndexKey index_key(PdgCode pdg, const ThreeVector &r,
+                     const ThreeVector &p) const;
+
+  /// Add one particle of the given ensemble to the index
+  void add_to_index(int ensemble, const ParticleData &particle);
+
+  /**
+   * Contribution of one particle to the phase-space density.
+   *
+   * \param[in] part Particle contributing
+   * \param[in] r Position vector at which the density is evaluated.
+   * \param[in] p Momentum vector at which the density is evaluated.
+   * \param[in] disregard_ids Sorted ids of the particles not to count.
+   * \return Weight of the particle, without the normalization to the number
+   *         of test particles and ensembles
+   */
+  double contribution(const ParticleData &part, const ThreeVector &r,
+                      const ThreeVector &p,
+                      const std::vector<int> &disregard_ids) const;
+
   /// Tabulate integrals for weights
   void init_weights();
 
@@ -95,6 +200,24 @@ class PauliBlocker {
 
   /// Weights: tabulated results of numerical integration
   std::array<double, 30> weights_;
+
+  /// Whether the spatial index is used
+  bool index_built_ = false;
+
+  /// Edge length of the cells of the spatial index, fm
+  double index_cell_length_ = 0.;
+
+  /**
+   * Edge length of the momentum cells of the index, twice the momentum
+   * averaging radius, or 0 without momentum cells, GeV
+   */
+  double momentum_cell_length_ = 0.;
+
+  /// Index: baryons of all ensembles sorted by species and cell
+  std::unordered_map<IndexKey, std::vector<IndexEntry>, IndexKeyHash> index_;
+
+  /// Cell in which each indexed particle is stored, per ensemble and id
+  std::vector<std::unordered_map<int, IndexKey>> indexed_cell_;
 };
 }  // namespace smash
 
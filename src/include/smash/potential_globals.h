@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2018-2020
+ *    Copyright (c) 2018-2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -15,14 +15,70 @@
 
 namespace smash {
 
+/* The evaluation of widths, cross sections and actions reads the potentials
+ * of the experiment through the following pointers. They are thread-local,
+ * such that several experiments with different potentials can run
+ * concurrently in one process. Every experiment installs its own potentials
+ * with a ScopedPotentialPointers on the threads it runs on. */
+
 /// Pointer to the skyrme potential on the lattice
-extern RectangularLattice<FourVector> *UB_lat_pointer;
+extern thread_local RectangularLattice<FourVector> *UB_lat_pointer;
 
 /// Pointer to the symmmetry potential on the lattice
-extern RectangularLattice<FourVector> *UI3_lat_pointer;
+extern thread_local RectangularLattice<FourVector> *UI3_lat_pointer;
 
 /// Pointer to a Potential class
-extern Potentials *pot_pointer;
+extern thread_local Potentials *pot_pointer;
+
+/**
+ * Installs the potentials of an experiment in the thread-local pointers of
+ * the calling thread for the lifetime of this object, similar to
+ * random::ScopedEngine for the random numbers.
+ *
+ * \code
+ *   ScopedPotentialPointers use_potentials(UB_lat, UI3_lat, potentials);
+ *   evolve(ensemble);  // widths and cross sections see the potentials
+ * \endcode
+ */
+class ScopedPotentialPointers {
+ public:
+  /**
+   * Set the thread-local pointers.
+   *
+   * \param[in] UB_lat Skyrme potential on the lattice, or nullptr
+   * \param[in] UI3_lat Symmetry potential on the lattice, or nullptr
+   * \param[in] potentials Potentials, or nullptr if they do not affect the
+   *            thresholds
+   */
+  ScopedPotentialPointers(RectangularLattice<FourVector> *UB_lat,
+                          RectangularLattice<FourVector> *UI3_lat,
+                          Potentials *potentials)
+      : UB_lat_(UB_lat_pointer),
+        UI3_lat_(UI3_lat_pointer),
+        potentials_(pot_pointer) {
+    UB_lat_pointer = UB_lat;
+    UI3_lat_pointer = UI3_lat;
+    pot_pointer = potentials;
+  }
+  /// Deleted copy constructor, the pointers must be restored exactly once
+  ScopedPotentialPointers(const ScopedPotentialPointers &) = delete;
+  /// Deleted copy assignment, the pointers must be restored exactly once
+  ScopedPotentialPointers &operator=(const ScopedPotentialPointers &) = delete;
+  /// Restore the previous pointers of the thread
+  ~ScopedPotentialPointers() {
+    UB_lat_pointer = UB_lat_;
+    UI3_lat_pointer = UI3_lat_;
+    pot_pointer = potentials_;
+  }
+
+ private:
+  /// Previous skyrme potential of the thread
+  RectangularLattice<FourVector> *UB_lat_;
+  /// Previous symmetry potential of the thread
+  RectangularLattice<FourVector> *UI3_lat_;
+  /// Previous potentials of the thread
+  Potentials *potentials_;
+};
 
 }  // namespace smash
 
@@ -67,6 +67,32 @@ class Potentials {
                                               const ThreeVector &momentum,
                                               double mass,
                                               ParticleList &plist) const {
+    return single_particle_energy_gradient(
+        jB_lattice, position, momentum, mass,
+        [&plist]() -> const ParticleList & { return plist; });
+  }
+
+  /**
+   * Calculates the gradient of the single-particle energy (including
+   * potentials) in the calculation frame in MeV/fm
+   *
+   * \param jB_lattice Pointer to the baryon density lattice
+   * \param position Position of the particle of interest in fm
+   * \param momentum Momentum of the particle of interest in GeV
+   * \param mass Mass of the particle of interest in GeV
+   * \param all_particles Function returning all particles, as ParticleList
+   *        or ParticleCells, only called if the current is needed outside of
+   *        the lattice
+   * \return ThreeVector gradient of the single particle energy in the
+   * calculation frame in MeV/fm
+   * \tparam F Type of the function returning the particles
+   */
+  template <typename F>
+  ThreeVector single_particle_energy_gradient(DensityLattice *jB_lattice,
+                                              const ThreeVector &position,
+                                              const ThreeVector &momentum,
+                                              double mass,
+                                              F &&all_particles) const {
     const std::array<double, 3> dr = (jB_lattice)
                                          ? jB_lattice->cell_sizes()
                                          : std::array<double, 3>{0.1, 0.1, 0.1};
@@ -82,7 +108,7 @@ class Potentials {
       if (jB_lattice && jB_lattice->value_at(position_left, jmu_left)) {
         net_4current_left = jmu_left.jmu_net();
       } else if (use_potentials_outside_lattice_) {
-        auto current = current_eckart(position_left, plist, param_,
+        auto current = current_eckart(position_left, all_particles(), param_,
                                       DensityType::Baryon, false, true);
         net_4current_left = std::get<1>(current);
       } else {
@@ -92,7 +118,7 @@ class Potentials {
       if (jB_lattice && jB_lattice->value_at(position_right, jmu_right)) {
         net_4current_right = jmu_right.jmu_net();
       } else if (use_potentials_outside_lattice_) {
-        auto current = current_eckart(position_right, plist, param_,
+        auto current = current_eckart(position_right, all_particles(), param_,
                                       DensityType::Baryon, false, true);
         net_4current_right = std::get<1>(current);
       } else {
@@ -117,19 +143,48 @@ class Potentials {
    **/
   double calculation_frame_energy(const ThreeVector &momentum,
                                   const FourVector &jmu_B, double mass) const {
-    std::function<double(double)> root_equation = [momentum, jmu_B, mass,
-                                                   this](double energy) {
+    const auto root_equation = [momentum, jmu_B, mass, this](double energy) {
       return root_eq_potentials(energy, momentum, jmu_B, mass, skyrme_a_,
                                 skyrme_b_, skyrme_tau_, mom_dependence_C_,
                                 mom_dependence_Lambda_);
     };
-    RootSolver1D root_solver{root_equation};
+    const double initial_guess = std::sqrt(mass * mass + momentum * momentum);
+    /* The root equation is smooth and nearly linear around the root, such
+     * that secant steps from the energy without potentials converge within a
+     * few evaluations. The bracketing solver is the fallback. */
+    double energy_prev = initial_guess;
+    double residual_prev = root_equation(energy_prev);
+    if (residual_prev == 0.) {
+      return initial_guess;
+    }
+    double energy = initial_guess + 0.01;
+    for (int i = 0; i < 50; i++) {
+      const double residual = root_equation(energy);
+      if (residual == 0.) {
+        return energy;
+      }
+      if (residual == residual_prev) {
+        break;
+      }
+      const double next = energy - residual * (energy - energy_prev) /
+                                       (residual - residual_prev);
+      energy_prev = energy;
+      residual_prev = residual;
+      energy = next;
+      // Only roots within the widest interval below are accepted.
+      if (!std::isfinite(energy) || std::abs(energy - initial_guess) > 50.) {
+        break;
+      }
+      if (std::abs(energy - energy_prev) <= 1e-12 * std::abs(energy)) {
+        return energy;
+      }
+    }
     const std::array<double, 4> starting_interval_width = {0.1, 1.0, 10.0,
                                                            100.0};
     for (double width : starting_interval_width) {
-      const double initial_guess = std::sqrt(mass * mass + momentum * momentum);
-      auto calc_frame_energy = root_solver.try_find_root(
-          initial_guess - width / 2, initial_guess + width / 2, 100000);
+      auto calc_frame_energy = RootSolver1D::find_root(
+          root_equation, initial_guess - width / 2, initial_guess + width / 2,
+          100000);
       if (calc_frame_energy) {
         return *calc_frame_energy;
       } else {
@@ -218,6 +273,20 @@ class Potentials {
   double potential(const ThreeVector &r, const ParticleList &plist,
                    const ParticleType &acts_on) const;
 
+  /**
+   * Convenience overload of the above, which only uses the particles near r.
+   * The result is the same as for the complete list of particles.
+   *
+   * \param[in] r Arbitrary space point where potential is calculated
+   * \param[in] cells All particles sorted into cells of the smearing range
+   * \param[in] acts_on Type of particle on which potential is going to act
+   * \return Total potential energy acting on the particle [GeV]
+   */
+  double potential(const ThreeVector &r, const ParticleCells &cells,
+                   const ParticleType &acts_on) const {
+    return potential(r, cells.within_reach(r), acts_on);
+  }
+
   /**
    * Evaluates the scaling factor of the forces acting on the particles.
    *
@@ -429,6 +498,19 @@ class Potentials {
   virtual std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
   all_forces(const ThreeVector &r, const ParticleList &plist) const;
 
+  /**
+   * Convenience overload of the above, which only passes the particles near r
+   * on. The result is the same as for the complete list of particles.
+   *
+   * \param[in] r Arbitrary space point where potential gradient is calculated
+   * \param[in] cells All particles sorted into cells of the smearing range
+   * \return (\f$E_B, B_B, E_{I_3}, B_{I_3}\f$) [GeV/fm], see above
+   */
+  std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector> all_forces(
+      const ThreeVector &r, const ParticleCells &cells) const {
+    return all_forces(r, cells.within_reach(r));
+  }
+
   /// \return Is Skyrme potential on?
   virtual bool use_skyrme() const { return use_skyrme_; }
   /// \return Is symmetry potential on?
@@ -463,6 +545,9 @@ class Potentials {
   /// \return cutoff radius in ntegration for coulomb potential in fm
   double coulomb_r_cut() const { return coulomb_r_cut_; }
 
+  /// \return Whether to compute the Coulomb fields by Fourier transforms
+  bool coulomb_use_fft() const { return coulomb_use_fft_; }
+
   /**
    * \return Wether to take potentials into account for particles outside
    * of the lattice
@@ -471,6 +556,15 @@ class Potentials {
     return use_potentials_outside_lattice_;
   }
 
+  /**
+   * \return Whether to propagate the particles with the leapfrog
+   * (kick-drift-kick) scheme
+   */
+  bool leapfrog() const { return leapfrog_; }
+
+  /// \return Parameters of the density calculation
+  const DensityParameters &density_parameters() const { return param_; }
+
  private:
   /**
    * Struct that contains the gaussian smearing width \f$\sigma\f$,
@@ -543,9 +637,15 @@ class Potentials {
   /// Cutoff in integration for coulomb potential
   double coulomb_r_cut_;
 
+  /// Whether to compute the Coulomb fields by Fourier transforms
+  bool coulomb_use_fft_ = false;
+
   /// Wether potentials should be included outside of the lattice
   bool use_potentials_outside_lattice_;
 
+  /// Whether to propagate the particles with the leapfrog scheme
+  bool leapfrog_;
+
   /**
    * Saturation density of nuclear matter used in the VDF potential; it may
    * vary between different parameterizations.
@@ -12,6 +12,7 @@
 #include <utility>
 #include <vector>
 
+#include "blockcache.h"
 #include "decaytype.h"
 #include "forwarddeclarations.h"
 #include "particletype.h"
@@ -125,8 +126,12 @@ std::ostream &operator<<(std::ostream &os, ProcessType process_type);
  * branch.set_weight(1);
  * deltaplus_decay_modes.push_back(branch);
  * \endcode
+ *
+ * Process branches are allocated via the BlockCache, since most of them
+ * belong to actions that are destroyed within the time step they were found
+ * in.
  */
-class ProcessBranch {
+class ProcessBranch : public CacheAllocated {
  public:
   /// Create a ProcessBranch without final states and weight.
   ProcessBranch() : branch_weight_(0.) {}
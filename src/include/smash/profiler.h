@@ -0,0 +1,363 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PROFILER_H_
+#define SRC_INCLUDE_SMASH_PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace smash {
+
+/// The phases of the time evolution, which are always profiled
+enum class ProfiledPhase : std::size_t {
+  /// Placing the particles onto the grid
+  GridUpdate,
+  /// Finding the actions of all particles on the grid
+  ActionFinding,
+  /// Finding the actions of the particles produced within a time step
+  ActionFindingAfterActions,
+  /// Performing actions other than string fragmentations
+  ActionExecution,
+  /// Performing actions with string fragmentation
+  StringFragmentation,
+  /// Updating the densities and fields on the lattices
+  LatticeUpdate,
+  /// Updating the momenta with the potentials
+  MomentumUpdate,
+  /// A whole time step, the part not covered by the other phases
+  TimeStep,
+  /// Propagating an ensemble from action to action within a time step
+  TimesteplessPropagation,
+};
+
+/// The stages of the startup before the first event, see startup_profiler()
+enum class StartupStage : std::size_t {
+  /// Reading and validating the configuration
+  Configuration,
+  /// Creating the particle types and decay modes
+  ParticleTypes,
+  /// Tabulating the decay widths of unstable decay products
+  DecayTabulations,
+  /// Tabulating the integrals of the cross sections
+  IntegralTabulations,
+  /// Tabulating the phase-space integrals of multi-particle reactions
+  PhaseSpaceTabulations,
+  /// Tabulating the total and hadronic widths
+  WidthTabulations,
+  /// Smoothing the data of the cross-section parametrizations
+  ParametrizationInterpolations,
+  /// Tabulating the spectral functions
+  SpectralFunctions,
+  /// Setting up an experiment, the part not covered by the stages below
+  Experiment,
+  /// Creating the action finders, including the string processes
+  ActionFinders,
+  /// Opening the outputs
+  Outputs,
+  /// Setting up the potentials
+  Potentials,
+  /// Setting up the lattices
+  Lattices,
+  /// Setting up the forced thermalization
+  Thermalizer,
+};
+
+/**
+ * Accumulates the wall-clock time spent in phases of the evolution and how
+ * often they are entered, per event and for the whole run.
+ *
+ * Besides the fixed phases of ProfiledPhase, further phases, e.g. one for the
+ * callbacks of each output, can be added. The profiler is always compiled in
+ * and enabled at runtime, when disabled a ScopedTimer only checks a flag.
+ * Times are exclusive, i.e. the time of a phase entered within another phase
+ * on the same thread is only attributed to the inner one. Phases can be timed
+ * concurrently from several threads, in which case their times add up.
+ *
+ * If tracing is enabled as well, the begin and duration of every timed region
+ * is recorded together with the thread it ran on, such that the timeline can
+ * be written as a Chrome trace and inspected e.g. in Perfetto.
+ */
+class Profiler {
+ public:
+  /// Profiler with the phases of ProfiledPhase
+  Profiler();
+
+  /**
+   * Profiler with other phases than the ones of ProfiledPhase, e.g. the ones
+   * of StartupStage.
+   *
+   * \param[in] phase_names Names of the phases in the order of their indices.
+   */
+  explicit Profiler(std::initializer_list<const char *> phase_names);
+
+  /// Enable or disable the profiling.
+  void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  /// \return whether the profiling is enabled.
+  bool enabled() const { return enabled_; }
+
+  /**
+   * Enable or disable the recording of the timeline, which requires the
+   * profiling to be enabled.
+   */
+  void set_tracing(bool tracing) { tracing_ = tracing; }
+
+  /// \return whether the timeline is recorded.
+  bool tracing() const { return tracing_; }
+
+  /**
+   * Add a phase.
+   *
+   * \param[in] name Name of the phase in the reports.
+   * \return the index of the phase to be passed to ScopedTimer.
+   */
+  std::size_t add_phase(std::string name);
+
+  /**
+   * Attribute time to a phase of the current event.
+   *
+   * \param[in] phase Index of the phase.
+   * \param[in] duration Time spent in the phase.
+   */
+  void add(std::size_t phase, std::chrono::nanoseconds duration) {
+    Phase &p = phases_[phase];
+    p.event_ns.fetch_add(duration.count(), std::memory_order_relaxed);
+    p.event_calls.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Record a timed region in the timeline of the current event.
+   *
+   * \param[in] phase Index of the phase.
+   * \param[in] begin Start of the region.
+   * \param[in] duration Duration of the region including nested regions.
+   */
+  void trace(std::size_t phase, std::chrono::steady_clock::time_point begin,
+             std::chrono::nanoseconds duration);
+
+  /**
+   * Add the times of the current event to the ones of the run and start the
+   * next event.
+   *
+   * \return the breakdown of the finished event, see report.
+   */
+  std::string end_event();
+
+  /// \return the breakdown of the run, see report.
+  std::string run_report() const;
+
+  /// \return the wall-clock time since the construction of the profiler.
+  std::chrono::nanoseconds elapsed() const {
+    return std::chrono::steady_clock::now() - start_;
+  }
+
+  /**
+   * \param[in] phase Index of the phase.
+   * \return the time spent in the phase in the finished events.
+   */
+  std::chrono::nanoseconds run_time(std::size_t phase) const {
+    return std::chrono::nanoseconds(phases_[phase].run_ns);
+  }
+
+  /**
+   * \param[in] phase Index of the phase.
+   * \return how often the phase was entered in the finished events.
+   */
+  uint64_t run_calls(std::size_t phase) const {
+    return phases_[phase].run_calls;
+  }
+
+  /**
+   * Write the breakdowns of all events and of the run as JSON.
+   *
+   * \param[out] out Stream to write to.
+   */
+  void write_json(std::ostream &out) const;
+
+  /**
+   * Write the recorded timeline in the Chrome trace event format, which can
+   * be opened with Perfetto or chrome://tracing.
+   *
+   * \param[out] out Stream to write to.
+   */
+  void write_trace(std::ostream &out) const;
+
+ private:
+  /// Time and calls of one phase
+  struct Phase {
+    /// Name in the reports
+    std::string name;
+    /// Time in the current event [ns]
+    std::atomic<uint64_t> event_ns{0};
+    /// Calls in the current event
+    std::atomic<uint64_t> event_calls{0};
+    /// Time in the finished events [ns]
+    uint64_t run_ns = 0;
+    /// Calls in the finished events
+    uint64_t run_calls = 0;
+  };
+
+  /// A timed region in the timeline
+  struct TraceEvent {
+    /// Index of the phase
+    std::size_t phase;
+    /// Index of the thread, see thread_index
+    std::size_t thread;
+    /// Index of the event
+    std::size_t event;
+    /// Start since the construction of the profiler [ns]
+    int64_t begin_ns;
+    /// Duration [ns]
+    int64_t duration_ns;
+  };
+
+  /// \return a small index of the calling thread, in order of first use.
+  static std::size_t thread_index();
+
+  /// Time [ns] and calls of all phases in one event or the run
+  using Breakdown = std::vector<std::pair<uint64_t, uint64_t>>;
+
+  /**
+   * \param[in] breakdown Times and calls of all phases.
+   * \return a table with the time, share and calls of each phase, sorted by
+   *         decreasing time.
+   */
+  std::string report(const Breakdown &breakdown) const;
+
+  /// \return the times and calls of the finished events.
+  Breakdown run_breakdown() const;
+
+  /// Whether the profiling is enabled
+  bool enabled_ = false;
+
+  /// Whether the timeline is recorded
+  bool tracing_ = false;
+
+  /// Reference for the times in the timeline
+  const std::chrono::steady_clock::time_point start_ =
+      std::chrono::steady_clock::now();
+
+  /// Guards trace_
+  std::mutex trace_mutex_;
+
+  /// The recorded timeline
+  std::vector<TraceEvent> trace_;
+
+  /// The phases, which are not moved when phases are added
+  std::deque<Phase> phases_;
+
+  /// Breakdowns of the finished events
+  std::vector<Breakdown> events_;
+};
+
+/**
+ * Attributes the time of its lifetime to a phase of a Profiler, if the
+ * profiling is enabled. Timers nested on the same thread are subtracted.
+ */
+class ScopedTimer {
+ public:
+  /**
+   * Start timing.
+   *
+   * \param[in] profiler The profiler to report to.
+   * \param[in] phase Index of the phase.
+   */
+  ScopedTimer(Profiler &profiler, std::size_t phase)
+      : profiler_(profiler.enabled() ? &profiler : nullptr), phase_(phase) {
+    if (profiler_) {
+      parent_ = current_;
+      current_ = this;
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  /// \see ScopedTimer(Profiler &, std::size_t)
+  ScopedTimer(Profiler &profiler, ProfiledPhase phase)
+      : ScopedTimer(profiler, static_cast<std::size_t>(phase)) {}
+
+  /// \see ScopedTimer(Profiler &, std::size_t)
+  ScopedTimer(Profiler &profiler, StartupStage stage)
+      : ScopedTimer(profiler, static_cast<std::size_t>(stage)) {}
+
+  /// Stop timing and report the time to the profiler.
+  ~ScopedTimer() {
+    if (profiler_) {
+      const auto elapsed = std::chrono::steady_clock::now() - start_;
+      profiler_->add(phase_, elapsed - nested_);
+      if (profiler_->tracing()) {
+        profiler_->trace(phase_, start_, elapsed);
+      }
+      if (parent_) {
+        parent_->nested_ += elapsed;
+      }
+      current_ = parent_;
+    }
+  }
+
+  /// Cannot be copied
+  ScopedTimer(const ScopedTimer &) = delete;
+  /// Cannot be copied
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  /**
+   * Attribute the time to another phase, if it only turns out within the
+   * timed region which phase it is.
+   *
+   * \param[in] phase Index of the phase.
+   */
+  void set_phase(ProfiledPhase phase) {
+    phase_ = static_cast<std::size_t>(phase);
+  }
+
+ private:
+  /// The profiler to report to, nullptr if the profiling is disabled
+  Profiler *profiler_;
+  /// Index of the phase
+  std::size_t phase_;
+  /// Start of the timed region
+  std::chrono::steady_clock::time_point start_;
+  /// Time spent in nested timers
+  std::chrono::nanoseconds nested_{0};
+  /// The enclosing timer on the same thread
+  ScopedTimer *parent_ = nullptr;
+  /// The innermost timer on this thread
+  static thread_local ScopedTimer *current_;
+};
+
+/**
+ * The profiler of the stages of StartupStage, which is always enabled, such
+ * that the time to the first event can be broken down in every run. Its
+ * phases are the ones of StartupStage and it is created at the first call,
+ * i.e. at the start of the run.
+ *
+ * \return the profiler of the startup.
+ */
+Profiler &startup_profiler();
+
+/**
+ * Print the breakdown of the startup_profiler() and the time since its
+ * creation at info level. Only the first call prints, so it can be called at
+ * the start of every event. Stages timed afterwards, e.g. when another
+ * experiment is set up, are not reported.
+ */
+void log_startup_profile();
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PROFILER_H_
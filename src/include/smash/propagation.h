@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2013-2023
+ *    Copyright (c) 2013-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -8,6 +8,7 @@
 #ifndef SRC_INCLUDE_SMASH_PROPAGATION_H_
 #define SRC_INCLUDE_SMASH_PROPAGATION_H_
 
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -65,11 +66,28 @@ double calc_hubble(double time, const ExpansionProperties &metric);
  *            The the Fermi momenta are only used for collisions,
  *            but not for propagation. In this case beam_momentum
  *            is used for propagating the initial nucleons. [GeV]
+ * \param[in] n_threads Number of threads sharing the particles, if there
+ *            are enough of them
  * \return dt time interval of propagation which is equal to the
  *            difference between the final time and the initial
  *            time read from the 4-position of the particle.
  */
 double propagate_straight_line(Particles *particles, double to_time,
+                               const std::vector<FourVector> &beam_momentum,
+                               int n_threads = 1);
+
+/**
+ * Propagates a single particle along a straight line from the time of its
+ * position to the time \p to_time, like propagate_straight_line for all
+ * particles.
+ *
+ * \param[inout] data The particle
+ * \param[in] to_time final time [fm]
+ * \param[in] beam_momentum 4-momenta of the initial nucleons with frozen
+ *            Fermi motion, see propagate_straight_line [GeV]
+ * \return dt time interval of propagation [fm]
+ */
+double propagate_straight_line(ParticleData *data, double to_time,
                                const std::vector<FourVector> &beam_momentum);
 
 /**
@@ -81,10 +99,55 @@ double propagate_straight_line(Particles *particles, double to_time,
  *            we extract the time in the computational frame.
  * \param[in] metric A struct containing the parameters need to calculate
  *            the metric
+ * \param[in] n_threads Number of threads sharing the particles, if there
+ *            are enough of them
  */
 void expand_space_time(Particles *particles,
                        const ExperimentParameters &parameters,
-                       const ExpansionProperties &metric);
+                       const ExpansionProperties &metric, int n_threads = 1);
+
+/**
+ * Forces on the particles of every ensemble [GeV/fm], in the order of the
+ * particles. The forces of particles that are not affected by the potentials
+ * are unset.
+ */
+using ParticleForces = std::vector<std::vector<std::optional<ThreeVector>>>;
+
+/**
+ * Computes the forces of the potentials on all particles at their current
+ * positions, without changing any momentum.
+ *
+ * \param[in] ensembles The particles of all ensembles
+ * \param[in] pot The potentials in the system
+ * \param[in] FB_lat Lattice for the electric and magnetic
+ *            components of the Skyrme force
+ * \param[in] FI3_lat Lattice for the electric and magnetic
+ *            components of the symmetry force
+ * \param[in] EM_lat Lattice for the electric and magnetic field
+ * \param[in] jB_lat Lattice of the net baryon density
+ * \param[in] n_threads Number of threads over which the ensembles are
+ *            distributed to compute the forces
+ * \return The forces on the particles
+ */
+ParticleForces compute_forces(
+    const std::vector<Particles> &ensembles, const Potentials &pot,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_lat,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *EM_lat,
+    DensityLattice *jB_lat, int n_threads = 1);
+
+/**
+ * Changes the momenta of all particles by the given forces during a time
+ * interval, keeping the particles on their effective mass shell. Warns if
+ * the interval is large compared to the time scale of the momentum change.
+ *
+ * \param[inout] ensembles The particles of all ensembles, unchanged since
+ *               the forces were computed
+ * \param[in] forces The forces on the particles
+ * \param[in] dt Time interval [fm]
+ */
+void kick_momenta(std::vector<Particles> &ensembles,
+                  const ParticleForces &forces, double dt);
 
 /**
  * Updates the momenta of all particles at the current
@@ -101,13 +164,15 @@ void expand_space_time(Particles *particles,
  *            components of the symmetry force
  * \param[in] EM_lat Lattice for the electric and magnetic field
  * \param[in] jB_lat Lattice of the net baryon density
+ * \param[in] n_threads Number of threads over which the ensembles are
+ *            distributed to compute the forces
  */
 void update_momenta(
     std::vector<Particles> &particles, double dt, const Potentials &pot,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_lat,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *EM_lat,
-    DensityLattice *jB_lat);
+    DensityLattice *jB_lat, int n_threads = 1);
 
 }  // namespace smash
 #endif  // SRC_INCLUDE_SMASH_PROPAGATION_H_
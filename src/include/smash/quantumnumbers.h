@@ -136,6 +136,36 @@ class QuantumNumbers {
     baryon_number_ += p.pdgcode().baryon_number();
   }
 
+  /**
+   * Remove the quantum numbers of a single particle from the collection.
+   * \param[in] p particle whose quantum number is removed from the collection
+   */
+  void subtract_values(const ParticleData& p) {
+    momentum_ -= p.momentum();
+    charge_ -= p.pdgcode().charge();
+    isospin3_ -= p.pdgcode().isospin3();
+    strangeness_ -= p.pdgcode().strangeness();
+    charmness_ -= p.pdgcode().charmness();
+    bottomness_ -= p.pdgcode().bottomness();
+    baryon_number_ -= p.pdgcode().baryon_number();
+  }
+
+  /**
+   * Add another collection entry-wise, e.g. a change of the quantum numbers.
+   * \param[in] rhs Right-hand side.
+   * \return This collection.
+   */
+  QuantumNumbers& operator+=(const QuantumNumbers& rhs) {
+    momentum_ += rhs.momentum_;
+    charge_ += rhs.charge_;
+    isospin3_ += rhs.isospin3_;
+    strangeness_ += rhs.strangeness_;
+    charmness_ += rhs.charmness_;
+    bottomness_ += rhs.bottomness_;
+    baryon_number_ += rhs.baryon_number_;
+    return *this;
+  }
+
   /**
    * \return The total momentum four-vector.
    * \f$P^\mu = \sum_{i \in \mbox{particles}} (E_i, \mathbf{p}_i)\f$ [GeV]
@@ -17,6 +17,7 @@
 
 #include "smash/pdgcode.h"
 #include "smash/random.h"
+#include "smash/tabulation.h"
 
 namespace smash {
 
@@ -145,17 +146,20 @@ class QuantumSampling {
 
   /**
    * Sampling radial momenta of given particle species from Boltzmann, Bose, or
-   * Fermi distribution. This sampler uses the simplest rejection sampling.
+   * Fermi distribution. The inverse of the cumulative distribution is
+   * tabulated for every species in the constructor, such that a sample costs
+   * one table lookup.
    * \param[in] pdg the pdg code of the sampled particle species
-   * return the sampled momentum [GeV]
+   * \return the sampled momentum [GeV]
+   * \throw std::out_of_range if the species was not given to the constructor
    */
-  double sample(const PdgCode pdg);
+  double sample(const PdgCode pdg) const;
 
  private:
   /// Tabulated effective chemical potentials for every particle species
   std::map<PdgCode, double> effective_chemical_potentials_;
-  /// Tabulated distribution function maxima for every particle species
-  std::map<PdgCode, double> distribution_function_maximums_;
+  /// Tabulated inverse momentum distributions for every particle species
+  std::map<PdgCode, Tabulation> momentum_inverse_cdfs_;
   /// Volume [fm^3] in which particles sre sampled
   const double volume_;
   /// Temperature [GeV]
@@ -10,9 +10,15 @@
 #ifndef SRC_INCLUDE_SMASH_RANDOM_H_
 #define SRC_INCLUDE_SMASH_RANDOM_H_
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
 #include <limits>
 #include <random>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -23,11 +29,151 @@ namespace smash {
 
 namespace random {
 
+/**
+ * Random number engine that produces its numbers in blocks.
+ *
+ * It runs several independent xoshiro256++ generators (lanes), whose states
+ * are stored word by word across the lanes. A refill advances all lanes in
+ * the same loop, which the compiler can vectorize, and fills a buffer, from
+ * which the numbers are handed out one by one. It satisfies the requirements
+ * of a random number engine of the standard library, apart from discard().
+ */
+class BufferedEngine {
+ public:
+  /// Type of the generated numbers
+  using result_type = uint64_t;
+  /// Number of independent generators
+  static constexpr std::size_t lanes = 8;
+  /// Number of numbers generated by a refill
+  static constexpr std::size_t buffer_size = 32 * lanes;
+  /// Seed of a default-constructed engine, as for std::mt19937_64
+  static constexpr result_type default_seed = 5489u;
+
+  /// Create an engine with the default seed.
+  BufferedEngine() : BufferedEngine(default_seed) {}
+  /**
+   * Create an engine with the given seed.
+   *
+   * \param value Seed of the engine.
+   */
+  explicit BufferedEngine(result_type value) { seed(value); }
+
+  /**
+   * Reset the engine to the state given by a seed.
+   *
+   * \param value Seed of the engine.
+   */
+  void seed(result_type value = default_seed);
+
+  /// \return Smallest number that can be generated
+  static constexpr result_type min() { return 0; }
+  /// \return Largest number that can be generated
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /// \return The next number, refilling the buffer if it is used up
+  result_type operator()() {
+    if (position_ == buffer_size) {
+      refill();
+    }
+    return buffer_[position_++];
+  }
+
+  /**
+   * \param a First engine.
+   * \param b Second engine.
+   * \return Whether both engines generate the same numbers from now on.
+   */
+  friend bool operator==(const BufferedEngine &a, const BufferedEngine &b);
+  /**
+   * \param a First engine.
+   * \param b Second engine.
+   * \return Whether the engines generate different numbers from now on.
+   */
+  friend bool operator!=(const BufferedEngine &a, const BufferedEngine &b) {
+    return !(a == b);
+  }
+  /**
+   * Write the state of the engine, including the numbers left in the buffer.
+   *
+   * \param out Stream to write to.
+   * \param e Engine to write.
+   * \return The stream.
+   */
+  friend std::ostream &operator<<(std::ostream &out, const BufferedEngine &e);
+  /**
+   * Read the state of an engine written with operator<<.
+   *
+   * \param in Stream to read from.
+   * \param e Engine to be set. It is unchanged if reading fails.
+   * \return The stream.
+   */
+  friend std::istream &operator>>(std::istream &in, BufferedEngine &e);
+
+ private:
+  /// Advance all lanes to fill the buffer again.
+  void refill() {
+    auto rotl = [](uint64_t x, int k) { return (x << k) | (x >> (64 - k)); };
+    auto &[s0, s1, s2, s3] = state_;
+    for (std::size_t round = 0; round < buffer_size / lanes; round++) {
+      for (std::size_t lane = 0; lane < lanes; lane++) {
+        buffer_[round * lanes + lane] =
+            rotl(s0[lane] + s3[lane], 23) + s0[lane];
+        const uint64_t t = s1[lane] << 17;
+        s2[lane] ^= s0[lane];
+        s3[lane] ^= s1[lane];
+        s1[lane] ^= s2[lane];
+        s0[lane] ^= s3[lane];
+        s2[lane] ^= t;
+        s3[lane] = rotl(s3[lane], 45);
+      }
+    }
+    position_ = 0;
+  }
+
+  /// Words of the states of the lanes, the lanes being the inner index
+  std::array<std::array<uint64_t, lanes>, 4> state_;
+  /// Generated numbers
+  std::array<uint64_t, buffer_size> buffer_;
+  /// Position of the next number to hand out from the buffer
+  std::size_t position_ = buffer_size;
+};
+
+#ifdef SMASH_BUFFERED_RANDOM_ENGINE
+/// The random number engine used produces its numbers in blocks.
+using Engine = BufferedEngine;
+#else
 /// The random number engine used is the Mersenne Twister.
 using Engine = std::mt19937_64;
+#endif
 
-/// The engine that is used commonly by all distributions.
-extern /*thread_local (see #3075)*/ Engine engine;
+/**
+ * Convert the next number of a 64-bit engine to a uniformly distributed
+ * random real number \f$\chi \in [0,1)\f$, using as many of its highest bits
+ * as fit into the mantissa.
+ *
+ * \param stream Engine to draw the random number from.
+ * \return Sampled random number.
+ */
+template <typename T, typename G>
+T canonical_from_bits(G &stream) {
+  static_assert(std::is_same<typename G::result_type, uint64_t>::value,
+                "a 64-bit engine is needed");
+  constexpr int digits = std::min(std::numeric_limits<T>::digits, 63);
+  constexpr T scale = T(1) / static_cast<T>(uint64_t{1} << digits);
+  // The shifted number fits into the signed type, whose conversion is faster.
+  return static_cast<T>(static_cast<int64_t>(stream() >> (64 - digits))) *
+         scale;
+}
+
+/**
+ * The engine that is used commonly by all distributions.
+ *
+ * Every thread owns its own engine, such that threads evolving different
+ * ensembles concurrently do not share (and race on) the random number state.
+ */
+extern thread_local Engine engine;
 
 /** Provides uniform random numbers on a fixed interval.
  *
@@ -54,13 +200,35 @@ class uniform_dist {
    * \param min Lower bound of interval.
    * \param max Upper bound of interval.
    * */
+#ifdef SMASH_BUFFERED_RANDOM_ENGINE
+  uniform_dist(T min, T max) : min_(min), width_(max - min) {}
+#else
   uniform_dist(T min, T max) : distribution(min, max) {}
+#endif
   /** \returns A random number in the interval. */
-  T operator()() { return distribution(engine); }
+  T operator()() { return (*this)(engine); }
+  /**
+   * \param stream Engine to draw the random number from.
+   * \returns A random number in the interval.
+   */
+  T operator()(Engine &stream) {
+#ifdef SMASH_BUFFERED_RANDOM_ENGINE
+    return min_ + width_ * canonical_from_bits<T>(stream);
+#else
+    return distribution(stream);
+#endif
+  }
 
  private:
+#ifdef SMASH_BUFFERED_RANDOM_ENGINE
+  /** Lower bound of the interval. */
+  T min_;
+  /** Length of the interval. */
+  T width_;
+#else
   /** The distribution object that is being used. */
   std::uniform_real_distribution<T> distribution;
+#endif
 };
 
 /** Generates a seed with a truly random 63-bit value, if possible */
@@ -77,6 +245,74 @@ void set_seed(T &&seed) {
 /// Advance the engine's state and return the generated value.
 inline Engine::result_type advance() { return engine(); }
 
+/**
+ * Derive the seed of an independent random number stream from a master seed
+ * and the index of the stream.
+ *
+ * The two numbers are combined with the SplitMix64 mixing function, such that
+ * neighboring indices lead to uncorrelated seeds.
+ *
+ * \param master_seed Seed from which all streams are derived.
+ * \param stream_index Index of the stream, e.g. the index of an ensemble.
+ * \return Seed of the stream.
+ */
+inline uint64_t stream_seed(uint64_t master_seed, uint64_t stream_index) {
+  uint64_t z = master_seed + (stream_index + 1) * 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * Create the engine of an independent random number stream.
+ *
+ * \param master_seed Seed from which all streams are derived.
+ * \param stream_index Index of the stream.
+ * \return Engine seeded with \ref stream_seed.
+ */
+inline Engine make_stream(uint64_t master_seed, uint64_t stream_index) {
+  return Engine(stream_seed(master_seed, stream_index));
+}
+
+/**
+ * Use the given engine as the thread-local \ref engine for the lifetime of
+ * this object.
+ *
+ * All functions of this namespace drawing from the thread-local engine then
+ * advance the given stream. The previous engine of the thread is restored on
+ * destruction, also if an exception is thrown.
+ *
+ * \code
+ *   random::Engine stream = random::make_stream(seed, i_ensemble);
+ *   {
+ *     random::ScopedEngine use_stream(stream);
+ *     evolve(ensemble);  // uses random::uniform etc.
+ *   }
+ * \endcode
+ */
+class ScopedEngine {
+ public:
+  /**
+   * Swap the given stream into the thread-local engine.
+   *
+   * \param[in,out] stream Engine to use. It holds the advanced state
+   *                       again after destruction of this object.
+   */
+  explicit ScopedEngine(Engine &stream) : stream_(stream) {
+    std::swap(engine, stream_);
+  }
+  /// Deleted copy constructor, the swap must happen exactly once
+  ScopedEngine(const ScopedEngine &) = delete;
+  /// Deleted copy assignment, the swap must happen exactly once
+  ScopedEngine &operator=(const ScopedEngine &) = delete;
+  /// Restore the previous engine of the thread
+  ~ScopedEngine() { std::swap(engine, stream_); }
+
+ private:
+  /// The stream being used, holding the previous engine meanwhile
+  Engine &stream_;
+};
+
 /**
  * \returns A uniformly distributed random real number \f$\chi \in [{\rm
  * min}, {\rm max})\f$
@@ -86,7 +322,11 @@ inline Engine::result_type advance() { return engine(); }
  */
 template <typename T>
 T uniform(T min, T max) {
+#ifdef SMASH_BUFFERED_RANDOM_ENGINE
+  return min + (max - min) * canonical_from_bits<T>(engine);
+#else
   return std::uniform_real_distribution<T>(min, max)(engine);
+#endif
 }
 
 /**
@@ -104,15 +344,20 @@ T uniform_int(T min, T max) {
 /**
  * \return a uniformly distributed random number \f$\chi \in [0,1)\f$.
  *
- * Note that the popular implementations in GCC and clang may return 1:
+ * Note that the popular implementations in GCC and clang may return 1, unless
+ * SMASH is built with the BufferedEngine:
  *
  * https://gcc.gnu.org/bugzilla/show_bug.cgi?id=64351
  * https://llvm.org/bugs/show_bug.cgi?id=18767
  */
 template <typename T = double>
 T canonical() {
+#ifdef SMASH_BUFFERED_RANDOM_ENGINE
+  return canonical_from_bits<T>(engine);
+#else
   return std::generate_canonical<T, std::numeric_limits<double>::digits>(
       engine);
+#endif
 }
 
 /**
@@ -121,9 +366,7 @@ T canonical() {
 template <typename T = double>
 T canonical_nonzero() {
   // use 'nextafter' to generate a value that is guaranteed to be larger than 0
-  return std::nextafter(
-      std::generate_canonical<T, std::numeric_limits<double>::digits>(engine),
-      T(1));
+  return std::nextafter(canonical<T>(), T(1));
 }
 
 /**
@@ -284,6 +527,11 @@ class discrete_dist {
    * \return Sampled value
    */
   int operator()() { return distribution(engine); }
+  /** Draw a random number from the discrete distribution.
+   * \param stream Engine to draw the random number from.
+   * \return Sampled value
+   */
+  int operator()(Engine &stream) { return distribution(stream); }
 
  private:
   /** The distribution object that is being used. */
@@ -392,7 +640,15 @@ class BesselSampler {
    *
    * \return Pair of first and second sampled number.
    */
-  std::pair<int, int> sample();
+  std::pair<int, int> sample() { return sample(engine); }
+
+  /**
+   * Sample two numbers from given Poissonians with a fixed difference.
+   *
+   * \param stream Engine to draw the random numbers from.
+   * \return Pair of first and second sampled number.
+   */
+  std::pair<int, int> sample(Engine &stream);
 
  private:
   /**
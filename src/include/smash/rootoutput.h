@@ -10,6 +10,7 @@
 #ifndef SRC_INCLUDE_SMASH_ROOTOUTPUT_H_
 #define SRC_INCLUDE_SMASH_ROOTOUTPUT_H_
 
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -127,6 +128,12 @@ class RootOutput : public OutputInterface {
    */
   void at_interaction(const Action &action, const double density) override;
 
+  /// \return Whether the collisions are written.
+  bool uses_interactions() const override { return write_collisions_; }
+
+  /// \return false, the density is not written.
+  bool uses_interaction_density() const override { return false; }
+
  private:
   /// Filename of output
   const std::filesystem::path filename_;
@@ -140,14 +147,14 @@ class RootOutput : public OutputInterface {
    * TFile takes ownership of all TTrees.
    * That's why TTree is not a unique pointer.
    */
-  TTree *particles_tree_;
+  TTree *particles_tree_ = nullptr;
   /**
    * TTree for collision output.
    *
    * TFile takes ownership of all TTrees.
    * That's why TTree is not a unique pointer.
    */
-  TTree *collisions_tree_;
+  TTree *collisions_tree_ = nullptr;
   /**
    * Writes particles to a tree defined by treename.
    * \param[in] particles Particles or ParticleList to be written to output.
@@ -170,40 +177,56 @@ class RootOutput : public OutputInterface {
   int current_event_ = 0;
 
   /**
-   * Maximal buffer size.
-   * When the number of particles N exceeds the buffer size B, data is flushed
-   * to the ROOT file every B particles. This creates ceil(N/B) entries in the
-   * ROOT Tree at every output.
+   * Number of particles the buffers hold initially. The buffers grow to the
+   * largest block of particles written, such that every block is written as a
+   * single entry of the tree.
+   */
+  static constexpr std::size_t initial_buffer_size_ = 1000;
+
+  /**
+   * Make sure the buffers hold at least n particles. If they have to grow, the
+   * addresses of the array branches are updated.
+   *
+   * \param[in] n Number of particles of the next entry.
    */
-  static const int max_buffer_size_;
+  void reserve_buffers(std::size_t n);
+
+  /**
+   * Point the array branches of a tree to the current buffers.
+   *
+   * \param[in] tree Tree whose branches are updated.
+   */
+  void set_array_addresses(TTree *tree);
 
   /** @name Buffer for filling TTree
    * See class documentation for definitions.
    */
   //@{
   /// Property that is written to ROOT output.
-  std::vector<double> p0_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> px_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> py_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> pz_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> t_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> x_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> y_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> z_ = std::vector<double>(max_buffer_size_, 0.0);
+  std::vector<double> p0_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> px_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> py_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> pz_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> t_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> x_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> y_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> z_ = std::vector<double>(initial_buffer_size_, 0.0);
   std::vector<double> formation_time_ =
-      std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> xsec_factor_ = std::vector<double>(max_buffer_size_, 0.0);
+      std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> xsec_factor_ =
+      std::vector<double>(initial_buffer_size_, 0.0);
   std::vector<double> time_last_coll_ =
-      std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<int> pdgcode_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> charge_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> coll_per_part_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> proc_id_origin_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> proc_type_origin_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> pdg_mother1_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> pdg_mother2_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> baryon_number_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> strangeness_ = std::vector<int>(max_buffer_size_, 0);
+      std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<int> pdgcode_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> charge_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> coll_per_part_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> proc_id_origin_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> proc_type_origin_ =
+      std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> pdg_mother1_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> pdg_mother2_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> baryon_number_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> strangeness_ = std::vector<int>(initial_buffer_size_, 0);
   int npart_, tcounter_, ev_, nin_, nout_, test_p_;
   double wgt_, par_wgt_, impact_b_, modus_l_, current_t_;
   double E_kinetic_tot_, E_fields_tot_, E_tot_;
@@ -227,12 +250,15 @@ class RootOutput : public OutputInterface {
    * It can happen that SMASH simulation crashed and root file was not closed.
    * To save results of simulation in such case, "AutoSave" is
    * applied every N events. The autosave_frequency_ sets
-   * this N (default N = 1000). Note that "AutoSave" operation is very
-   * time-consuming, so the Autosave_Frequency is
+   * this N (default N = 1000, 0 disables it). Note that "AutoSave" operation
+   * is very time-consuming, so the Autosave_Frequency is
    * always a compromise between safety and speed.
    */
   int autosave_frequency_;
 
+  /// Compression, basket and flushing settings of the file and its trees
+  const RootOutputParameters root_parameters_;
+
   /// Whether extended particle output is on
   const bool part_extended_;
   /// Whether extended collisions output is on
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2023
+ *    Copyright (c) 2023-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,14 +10,12 @@
 #ifndef SRC_INCLUDE_SMASH_ROOTSOLVER_H_
 #define SRC_INCLUDE_SMASH_ROOTSOLVER_H_
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
-#include <memory>
+#include <limits>
 #include <optional>
-#include <string>
-
-#include "gsl/gsl_errno.h"
-#include "gsl/gsl_math.h"
-#include "gsl/gsl_roots.h"
+#include <utility>
 
 #include "logging.h"
 
@@ -25,7 +23,11 @@ namespace smash {
 static constexpr int LRootSolver = LogArea::RootSolver::id;
 /**
  * A class used for calculating the root of a one-dimensional equation.
- * It takes care of all technicalities and provides an interface to GSL.
+ *
+ * It implements Brent's method in the same way as the GSL solver
+ * gsl_root_fsolver_brent, but keeps the whole state of the bracketing
+ * interval on the stack. Hence, finding a root neither allocates nor frees
+ * memory and one solver can be reused for any number of intervals.
  */
 class RootSolver1D {
  public:
@@ -34,11 +36,8 @@ class RootSolver1D {
    *
    * \param[in] eq The function of which a root is desired
    */
-  explicit RootSolver1D(std::function<double(double)> eq) {
-    root_eq_ = std::make_unique<std::function<double(double)>>(eq);
-  }
-
-  ~RootSolver1D() { root_eq_ = nullptr; }
+  explicit RootSolver1D(std::function<double(double)> eq)
+      : root_eq_(std::move(eq)) {}
 
   /**
    * Attempt to find a root in a given interval
@@ -50,79 +49,123 @@ class RootSolver1D {
    */
   std::optional<double> try_find_root(double initial_guess_low,
                                       double initial_guess_high,
-                                      size_t itermax) {
+                                      size_t itermax) const {
+    return find_root(root_eq_, initial_guess_low, initial_guess_high, itermax,
+                     solution_precision_);
+  }
+
+  /**
+   * Attempt to find a root of any callable in a given interval with Brent's
+   * method, without wrapping it into a std::function first.
+   *
+   * \param[in] eq The function of which a root is desired
+   * \param[in] initial_guess_low Lower boundary of the interval
+   * \param[in] initial_guess_high Higher boundary of the interval
+   * \param[in] itermax maximum number of steps for root finding
+   * \param[in] precision Relative width of the final bracketing interval
+   * \return the root if it was found
+   */
+  template <typename F>
+  static std::optional<double> find_root(const F &eq,
+                                         double initial_guess_low,
+                                         double initial_guess_high,
+                                         size_t itermax,
+                                         double precision = 1e-7) {
+    double a = initial_guess_low, b = initial_guess_high, c = b;
+    double fa = eq(a), fb = eq(b), fc = fb;
     // check if root is in the given interval
-    if ((*root_eq_)(initial_guess_low) * (*root_eq_)(initial_guess_high) > 0) {
+    if (fa * fb > 0) {
       logg[LRootSolver].debug()
           << "Function has same sign at both ends of the interval ["
           << initial_guess_low << ", " << initial_guess_high
           << "]. Root can't be found in this interval.";
       return std::nullopt;
     }
-    gsl_function function_GSL = {&(gsl_func), nullptr};
-    int status = GSL_CONTINUE;
-    size_t iter = 0;
-    Root_finder_ = gsl_root_fsolver_alloc(Solver_name_);
-    gsl_root_fsolver_set(Root_finder_, &function_GSL, initial_guess_low,
-                         initial_guess_high);
-    do {
-      iter++;
-      status = gsl_root_fsolver_iterate(Root_finder_);
-      if (status != GSL_SUCCESS) {
-        logg[LRootSolver].debug("GSL ERROR in root finding: " +
-                                static_cast<std::string>(gsl_strerror(status)));
-        break;
+    double d = b - a, e = b - a;
+    for (size_t iter = 0; iter < itermax; iter++) {
+      bool ac_equal = false;
+      if ((fb < 0 && fc < 0) || (fb > 0 && fc > 0)) {
+        ac_equal = true;
+        c = a;
+        fc = fa;
+        d = b - a;
+        e = b - a;
       }
-      double xlow = gsl_root_fsolver_x_lower(Root_finder_);
-      double xhigh = gsl_root_fsolver_x_upper(Root_finder_);
-      status = gsl_root_test_interval(xlow, xhigh, 0, solution_precision_);
-      if (status == GSL_SUCCESS) {
-        double root = 0.5 * (xlow + xhigh);
-        gsl_root_fsolver_free(Root_finder_);
-        return root;
+      if (std::abs(fc) < std::abs(fb)) {
+        ac_equal = true;
+        a = b;
+        b = c;
+        c = a;
+        fa = fb;
+        fb = fc;
+        fc = fa;
       }
-    } while (status == GSL_CONTINUE && iter < itermax);
-    gsl_root_fsolver_free(Root_finder_);
+      const double tol =
+          0.5 * std::numeric_limits<double>::epsilon() * std::abs(b);
+      const double m = 0.5 * (c - b);
+      if (fb == 0 || std::abs(m) <= tol) {
+        return b;
+      }
+      if (std::abs(e) < tol || std::abs(fa) <= std::abs(fb)) {
+        // bisection
+        d = m;
+        e = m;
+      } else {
+        // inverse quadratic interpolation or secant step
+        const double s = fb / fa;
+        double p, q;
+        if (ac_equal) {
+          p = 2 * m * s;
+          q = 1 - s;
+        } else {
+          const double qa = fa / fc;
+          const double r = fb / fc;
+          p = s * (2 * m * qa * (qa - r) - (b - a) * (r - 1));
+          q = (qa - 1) * (r - 1) * (s - 1);
+        }
+        if (p > 0) {
+          q = -q;
+        } else {
+          p = -p;
+        }
+        if (2 * p < std::min(3 * m * q - std::abs(tol * q), std::abs(e * q))) {
+          e = d;
+          d = p / q;
+        } else {
+          // interpolation failed, fall back to bisection
+          d = m;
+          e = m;
+        }
+      }
+      a = b;
+      fa = fb;
+      b += std::abs(d) > tol ? d : (m > 0 ? tol : -tol);
+      fb = eq(b);
+      if (!std::isfinite(fb)) {
+        logg[LRootSolver].debug("Error in root finding: function value at ", b,
+                                " is not finite");
+        return std::nullopt;
+      }
+      const double other_end = (fb < 0 && fc < 0) || (fb > 0 && fc > 0) ? a : c;
+      const double xlow = std::min(b, other_end);
+      const double xhigh = std::max(b, other_end);
+      // same criterion as gsl_root_test_interval without absolute tolerance
+      const double min_abs =
+          (xlow > 0 || xhigh < 0) ? std::min(std::abs(xlow), std::abs(xhigh))
+                                  : 0.;
+      if (xhigh - xlow < precision * min_abs) {
+        return 0.5 * (xlow + xhigh);
+      }
+    }
     return std::nullopt;
   }
 
  private:
-  /// GSL solver to use for root finding
-  const gsl_root_fsolver_type *Solver_name_ = gsl_root_fsolver_brent;
-
-  /// GSL root finding object to take care of root finding
-  gsl_root_fsolver *Root_finder_ = nullptr;
-
-  /** Static pointer to the function to solve
-   * \note This member has to be \c static since it is used inside the `static
-   * gsl_func` method. As \c static methods exist and can be used without a
-   * class instance, it is not possible to use non-static members inside them
-   * (non-static members \b are bound to a class instance). \see gsl_func to
-   * understand why that method needs to be \c static as well.
-   */
-  static inline std::unique_ptr<std::function<double(double)>> root_eq_ =
-      nullptr;
+  /// The function to solve
+  std::function<double(double)> root_eq_;
 
   /// Expected precision of the root
   double solution_precision_ = 1e-7;
-
-  /**
-   * The function of which a root should be found in the form that GSL expects
-   *
-   * \param[in] x Argument of the function
-   *
-   * \return The value of the function for the given argument x
-   *
-   * \note
-   * This function needs to be \c static because GSL uses an object of type \c
-   * gsl_function that has to be initialised with a pointer to a function and
-   * this cannot be created from a class non-static method as a class non-static
-   * method cannot exist as entity without an instance of that type. On the
-   * contrary, a pointer to a static member function can be used as a normal
-   * pointer to a free function, because a \c static method exists without
-   * needing any instance of the class.
-   */
-  static double gsl_func(const double x, void *) { return (*root_eq_)(x); }
 };
 
 }  // namespace smash
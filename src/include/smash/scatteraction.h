@@ -144,21 +144,45 @@ class ScatterAction : public Action {
    * only be called once per ScatterAction instance.
    *
    * \param[in] finder_parameters parameters for collision finding.
+   * \param[in] cache Optional cache the branches are taken from, if it
+   *            applies to the incoming particles.
    */
   void add_all_scatterings(
-      const ScatterActionsFinderParameters& finder_parameters);
+      const ScatterActionsFinderParameters& finder_parameters,
+      CrossSectionCache* cache = nullptr);
 
   /**
    * Given the incoming particles, assigns the correct parametrization of the
    * total cross section.
    *
    * \param[in] finder_parameters Parameters for collision finding.
+   * \param[in] cache Optional cache the total is taken from, if it applies
+   *            to the incoming particles.
    */
   void set_parametrized_total_cross_section(
-      const ScatterActionsFinderParameters& finder_parameters);
+      const ScatterActionsFinderParameters& finder_parameters,
+      CrossSectionCache* cache = nullptr);
 
   /**
-   * Get list of possible collision channels.
+   * Postpone add_all_scatterings until the final state is generated.
+   *
+   * With a parametrized total cross section the collision criterion does not
+   * need the individual branches, so that they are only built for actions
+   * that are actually performed. Many found actions are never performed,
+   * because one of their incoming particles takes part in an earlier action.
+   *
+   * \param[in] finder_parameters Parameters for collision finding. They have
+   *            to outlive this action.
+   * \param[in] cache Optional cache, see add_all_scatterings.
+   * \throw std::logic_error if the total cross section is not parametrized
+   */
+  void add_all_scatterings_lazily(
+      const ScatterActionsFinderParameters& finder_parameters,
+      CrossSectionCache* cache = nullptr);
+
+  /**
+   * Get list of possible collision channels. If the branches are added
+   * lazily, the list is empty until the final state is generated.
    *
    * \return list of possible collision channels.
    */
@@ -320,6 +344,12 @@ class ScatterAction : public Action {
 
   /// Lock for calling add_all_scatterings only once
   bool were_processes_added_ = false;
+
+  /// Parameters for adding the branches lazily, if requested
+  const ScatterActionsFinderParameters* lazy_finder_parameters_ = nullptr;
+
+  /// Cache for adding the branches lazily
+  CrossSectionCache* lazy_cache_ = nullptr;
 };
 
 }  // namespace smash
@@ -10,7 +10,11 @@
 #ifndef SRC_INCLUDE_SMASH_SCATTERACTIONMULTI_H_
 #define SRC_INCLUDE_SMASH_SCATTERACTIONMULTI_H_
 
+#include <cstddef>
+#include <cstdint>
+
 #include "action.h"
+#include "tabulationbundle.h"
 
 namespace smash {
 
@@ -64,6 +68,45 @@ class ScatterActionMulti : public Action {
   void add_possible_reactions(double dt, const double gcell_vol,
                               const MultiParticleReactionsBitSet incl_multi);
 
+  /**
+   * Families of multi-particle reactions. They are the bits of the masks
+   * returned by reaction_mask.
+   */
+  enum ReactionFamily : std::uint8_t {
+    /// 3π → ω/φ
+    ThreePionsToMeson = 1 << 0,
+    /// 2πη → η'
+    TwoPionsEtaToMeson = 1 << 1,
+    /// πNN → πd, NNN → Nd and their antiparticle counterparts
+    NucleonsToDeuteron = 1 << 2,
+    /// Formation of triton, He-3 and hypertriton
+    NucleonsToA3Nucleus = 1 << 3,
+    /// Formation of the corresponding antinuclei
+    AntinucleonsToA3Antinucleus = 1 << 4,
+    /// 5π → NN̅
+    FivePionsToNucleons = 1 << 5,
+  };
+
+  /**
+   * Determine the enabled multi-particle reactions a particle species can take
+   * part in, either as component or as catalyst. The incoming particles of a
+   * reaction found by add_possible_reactions share at least one bit of their
+   * masks with reaction_families for their number, so combinations without
+   * can be discarded beforehand.
+   *
+   * \param[in] type Particle species
+   * \param[in] incl_multi Which multi-particle reactions are enabled?
+   * \return Bitmask of ReactionFamily values
+   */
+  static std::uint8_t reaction_mask(
+      const ParticleType& type, const MultiParticleReactionsBitSet incl_multi);
+
+  /**
+   * \param[in] n_incoming Number of incoming particles
+   * \return Bitmask of the ReactionFamily values with \p n_incoming particles
+   */
+  static std::uint8_t reaction_families(std::size_t n_incoming);
+
   /**
    * Get list of possible reaction channels.
    *
@@ -97,6 +140,21 @@ class ScatterActionMulti : public Action {
    */
   double calculate_I3(const double sqrts) const;
 
+  /**
+   * Tabulate the integral of calculate_I3, divided by the squared kinetic
+   * energy \f$(\sqrt{s} - m_1 - m_2 - m_3)^2\f$, for all mass triplets of the
+   * pions, η mesons and nucleons, which take part in the 3-body reactions.
+   * The integral only depends on the masses, so that calculate_I3 uses the
+   * tabulations for all incoming particles of these masses and evaluates it
+   * exactly otherwise.
+   *
+   * This is not thread-safe and has to be done once during the setup.
+   *
+   * \param[inout] bundle Cached tabulations. The missing ones are added.
+   * \return Number of tabulations added to the bundle.
+   */
+  static std::size_t tabulate_phase_space_integrals(TabulationBundle& bundle);
+
   /**
    * Calculate the parametrized 4-body relativistic phase space integral.
    *
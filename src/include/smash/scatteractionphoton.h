@@ -10,6 +10,8 @@
 #ifndef SRC_INCLUDE_SMASH_SCATTERACTIONPHOTON_H_
 #define SRC_INCLUDE_SMASH_SCATTERACTIONPHOTON_H_
 
+#include <array>
+#include <optional>
 #include <utility>
 
 #include "scatteraction.h"
@@ -228,6 +230,52 @@ class ScatterActionPhoton : public ScatterAction {
   /// Total hadronic cross section
   const double hadronic_cross_section_;
 
+  /**
+   * Analytic total cross sections by MediatorType, see
+   * analytic_total_cross_section. They only depend on the incoming particles
+   * and the rho mass, so they are evaluated once for the collision branch and
+   * all photons of the action.
+   */
+  mutable std::array<std::optional<double>, 3> analytic_cross_sections_;
+
+  /**
+   * Kinematics of the final state, which are identical for all fractional
+   * photons of the action.
+   */
+  struct FinalStateKinematics {
+    /// Interaction point in the computational frame
+    FourVector interaction_point;
+    /// Velocity of the center-of-mass frame in the computational frame
+    ThreeVector velocity_cm;
+    /// Mandelstam s [GeV^2]
+    double s;
+    /// Center-of-mass energy [GeV]
+    double sqrts;
+    /// Mass of the incoming pion [GeV]
+    double m1;
+    /// Mass of the other incoming particle [GeV]
+    double m2;
+    /// Lower bound of Mandelstam t [GeV^2]
+    double t1;
+    /// Upper bound of Mandelstam t [GeV^2]
+    double t2;
+    /// Center-of-mass momentum of the incoming particles [GeV]
+    double pcm_in;
+    /// Center-of-mass momentum of the outgoing particles [GeV]
+    double pcm_out;
+  };
+
+  /// Kinematics of the fractional photons, see final_state_kinematics
+  std::optional<FinalStateKinematics> kinematics_;
+
+  /**
+   * Evaluate the kinematics of the final state on the first call and reuse
+   * them for all further fractional photons.
+   *
+   * \return The kinematics of the final state.
+   */
+  const FinalStateKinematics &final_state_kinematics();
+
   /**
    * Find the mass of the participating rho-particle.
    *
@@ -261,6 +309,17 @@ class ScatterActionPhoton : public ScatterAction {
    */
   double total_cross_section(MediatorType mediator = default_mediator_) const;
 
+  /**
+   * Evaluate the analytic total cross section of the photon process, which
+   * may still be negative or vanish for numerical reasons. Formfactors are
+   * not included.
+   *
+   * \param[in] mediator Switch for determing which mediating particle to use
+   *
+   * \return Total cross section. [mb]
+   */
+  double analytic_total_cross_section(MediatorType mediator) const;
+
   /**
    * Compute the total cross corrected for form factors.
    *
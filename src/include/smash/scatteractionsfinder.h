@@ -10,6 +10,10 @@
 #ifndef SRC_INCLUDE_SMASH_SCATTERACTIONSFINDER_H_
 #define SRC_INCLUDE_SMASH_SCATTERACTIONSFINDER_H_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <vector>
@@ -17,11 +21,82 @@
 #include "action.h"
 #include "actionfinderfactory.h"
 #include "configuration.h"
+#include "crosssectioncache.h"
+#include "memorytracker.h"
 #include "scatteraction.h"
 #include "scatteractionsfinderparameters.h"
 
 namespace smash {
 
+/**
+ * \ingroup action
+ * Kinematics of a list of possible collision partners in structure-of-arrays
+ * layout, as needed by ScatterActionsFinder::preselect_collision_partners.
+ */
+struct CollisionPartnerArrays {
+  /// Components of the positions of the partners [fm]
+  std::array<std::vector<double>, 4> position;
+  /// Components of the momenta of the partners [GeV]
+  std::array<std::vector<double>, 4> momentum;
+  /**
+   * Components of the momenta determining the collision times [GeV]. These
+   * differ from the momenta only for frozen Fermi motion.
+   */
+  std::array<std::vector<double>, 4> time_momentum;
+  /// Whether the partner has a valid (non-negative) id
+  std::vector<char> valid_id;
+
+  /**
+   * Copy the kinematics of the given particles.
+   *
+   * \param[in] partners Possible collision partners
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   */
+  void fill(const ParticleList &partners,
+            const std::vector<FourVector> &beam_momentum);
+
+  /// \return the number of partners.
+  size_t size() const { return valid_id.size(); }
+};
+
+/**
+ * \ingroup action
+ * Numbers of particle pairs and actions seen by the search for collisions of a
+ * ScatterActionsFinder, to find out how much of the search is wasted.
+ */
+struct CollisionSearchCounters {
+  /// Grid cells searched, i.e. calls of find_actions_in_cell
+  uint64_t cells = 0;
+  /// Largest number of particles in a searched cell
+  uint64_t max_particles_in_cell = 0;
+  /// Pairs of particles in the same or in neighboring cells
+  uint64_t candidate_pairs = 0;
+  /// Candidate pairs left by the preselection, whose collision is checked
+  uint64_t checked_pairs = 0;
+  /// Pairs fulfilling the collision criterion, i.e. found 2-particle actions
+  uint64_t found_actions = 0;
+  /// Found actions with more than 2 incoming particles
+  uint64_t found_multi_particle_actions = 0;
+
+  /**
+   * Add the counters of another search, e.g. of the next time step.
+   *
+   * \param[in] other Counters to be added
+   * \return this object
+   */
+  CollisionSearchCounters &operator+=(const CollisionSearchCounters &other) {
+    cells += other.cells;
+    max_particles_in_cell =
+        std::max(max_particles_in_cell, other.max_particles_in_cell);
+    candidate_pairs += other.candidate_pairs;
+    checked_pairs += other.checked_pairs;
+    found_actions += other.found_actions;
+    found_multi_particle_actions += other.found_multi_particle_actions;
+    return *this;
+  }
+};
+
 /**
  * \ingroup action
  * A simple scatter finder:
@@ -43,9 +118,15 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * \param[in] parameters Struct of parameters determining whether to
    *            exclude some certain types of scatterings and switching
    *            among the methods to treat with the NNbar collisions.
+   * \param[in] string_workers Number of threads, which perform string
+   *            processes at the same time, see set_string_worker.
    */
   ScatterActionsFinder(Configuration &config,
-                       const ExperimentParameters &parameters);
+                       const ExperimentParameters &parameters,
+                       int string_workers = 1);
+
+  /// Report the statistics of the cross-section cache, if used.
+  ~ScatterActionsFinder();
 
   /**
    * Determine the collision time of the two particles.
@@ -142,6 +223,35 @@ class ScatterActionsFinder : public ActionFinderInterface {
     }
   }
 
+  /**
+   * Pre-select the collision partners of one particle among a block of
+   * particles, e.g. the particles of a grid cell.
+   *
+   * The collision times and, for the geometric and covariant criteria, the
+   * transverse distances of all pairs are evaluated together on contiguous
+   * arrays, such that the compiler can vectorize the loop. A pair is rejected
+   * only if it clearly fails the collision time or distance cut of
+   * check_collision_two_part, which is still called for all other pairs. The
+   * selection is therefore an optimization only and does not change which
+   * collisions are found.
+   *
+   * \param[in] data_a Particle whose partners are searched
+   * \param[in] shift Translation of data_a towards the partners, nonzero
+   *            across the boundaries of a periodic box [fm]
+   * \param[in] partners Kinematics of the possible collision partners
+   * \param[in] dt The maximum time interval at the current time step [fm]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   * \param[out] candidates Whether partners[i] still needs to be checked with
+   *             check_collision_two_part (1) or cannot collide with data_a
+   *             in this time step (0). For the stochastic criterion, all
+   *             partners are candidates.
+   */
+  void preselect_collision_partners(
+      const ParticleData &data_a, const ThreeVector &shift,
+      const CollisionPartnerArrays &partners, double dt, const std::vector<FourVector> &beam_momentum,
+      std::vector<char> &candidates) const;
+
   /**
    * Search for all the possible collisions within one cell. This function is
    * only used for counting the primary collisions at the beginning of each
@@ -149,6 +259,9 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * secondary collisions among the outgoing particles, no new actions will be
    * found since the scattered pairs cannot scatter again.)
    *
+   * With pair sampling of the stochastic criterion, only a random sample of
+   * the pairs is checked, see sample_collision_pairs.
+   *
    * \param[in] search_list A list of particles within one cell
    * \param[in] dt The maximum time interval at the current time step [fm]
    * \param[in] gcell_vol Volume of searched grid cell [fm^3]
@@ -160,6 +273,27 @@ class ScatterActionsFinder : public ActionFinderInterface {
       const ParticleList &search_list, double dt, const double gcell_vol,
       const std::vector<FourVector> &beam_momentum) const override;
 
+  /**
+   * Search for all the possible collisions within one cell as
+   * find_actions_in_cell, but with the candidates of the multi-particle
+   * reactions taken from the members of the cell listed by the grid, see
+   * takes_part_in_multi_particle_reactions. Then cells without any are not
+   * searched for multi-particle reactions at all.
+   *
+   * \param[in] search_list A list of particles within one cell
+   * \param[in] members The particles of \p search_list which can take part
+   *            in multi-particle reactions
+   * \param[in] dt The maximum time interval at the current time step [fm]
+   * \param[in] gcell_vol Volume of searched grid cell [fm^3]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   * \return A list of possible scatter actions
+   */
+  ActionList find_actions_in_cell_with_members(
+      const ParticleList &search_list, const ParticleList &members, double dt,
+      const double gcell_vol,
+      const std::vector<FourVector> &beam_momentum) const override;
+
   /**
    * Search for all the possible collisions among the neighboring cells. This
    * function is only used for counting the primary collisions at the beginning
@@ -176,6 +310,25 @@ class ScatterActionsFinder : public ActionFinderInterface {
       const ParticleList &search_list, const ParticleList &neighbors_list,
       double dt, const std::vector<FourVector> &beam_momentum) const override;
 
+  /**
+   * Search for all the possible collisions between a cell and a neighboring
+   * cell across the boundaries of a periodic box. Only the particles of the
+   * candidate pairs are translated, instead of the whole search list.
+   *
+   * \param[in] search_list A list of particles within the current cell
+   * \param[in] shift Translation of the search list particles towards the
+   *            neighbors [fm]
+   * \param[in] neighbors_list A list of particles within the neighboring cell
+   * \param[in] dt The maximum time interval at the current time step [fm]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   * \return A list of possible scatter actions
+   */
+  ActionList find_actions_with_shifted_neighbors(
+      const ParticleList &search_list, const ThreeVector &shift,
+      const ParticleList &neighbors_list, double dt,
+      const std::vector<FourVector> &beam_momentum) const override;
+
   /**
    * Search for all the possible secondary collisions between the outgoing
    * particles and the rest.
@@ -191,11 +344,34 @@ class ScatterActionsFinder : public ActionFinderInterface {
       const ParticleList &search_list, const Particles &surrounding_list,
       double dt, const std::vector<FourVector> &beam_momentum) const override;
 
+  /**
+   * Find a lower bound of the times of the two-body collisions, which
+   * find_actions_in_cell and find_actions_with_neighbors would find for the
+   * given particles, without evaluating any cross section. Only the
+   * collision times of the pairs passing preselect_collision_partners are
+   * computed.
+   *
+   * \param[in] search_list Particles, whose collisions among each other and
+   *            with the neighbors are bounded
+   * \param[in] neighbors_list Possible collision partners
+   * \param[in] dt The maximum time interval at the current time step [fm]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   * \return Earliest possible time of a collision [fm], slightly lowered to
+   *         be safe from rounding, or infinity if there is no candidate pair
+   *         in the time step
+   * \throw std::logic_error for the stochastic criterion, which does not
+   *        determine collision times geometrically
+   */
+  double earliest_collision_time(
+      const ParticleList &search_list, const ParticleList &neighbors_list,
+      double dt, const std::vector<FourVector> &beam_momentum) const;
+
   /**
    * Find some final collisions at the end of the simulation.
    * \todo Seems to do nothing.
    */
-  ActionList find_final_actions(const Particles & /*search_list*/,
+  ActionList find_final_actions(const ParticleList & /*search_list*/,
                                 bool /*only_res*/ = false) const override {
     return ActionList();
   }
@@ -205,15 +381,28 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * (only elastic scatterings are possible),
    * scatterings are isotropic and cross-section fixed to elastic_parameter_
    * independently on momenta, then maximal cross-section is elastic_parameter_.
+   * The same holds for several particle sorts if only elastic collisions are
+   * enabled, see only_constant_elastic_.
    * This knowledge can be used for improving performance.
    *
    * \return A boolean indicating whether all the scatterings are elastic
    *         and isotropic
    */
   inline bool is_constant_elastic_isotropic() const {
-    return ParticleType::list_all().size() == 1 &&
-           !finder_parameters_.two_to_one && isotropic_ &&
-           finder_parameters_.elastic_parameter > 0.;
+    return only_constant_elastic_ ||
+           (ParticleType::list_all().size() == 1 &&
+            !finder_parameters_.two_to_one && isotropic_ &&
+            finder_parameters_.elastic_parameter > 0.);
+  }
+
+  /**
+   * \return The constant elastic cross section [mb], including the additional
+   *         elastic contribution and the scaling as in CrossSections::elastic.
+   */
+  double constant_elastic_cross_section() const {
+    return (finder_parameters_.elastic_parameter +
+            finder_parameters_.additional_el_xs) *
+           finder_parameters_.scale_xs;
   }
 
   /**
@@ -230,11 +419,35 @@ class ScatterActionsFinder : public ActionFinderInterface {
    */
   double max_transverse_distance_sqr(int testparticles) const {
     return (is_constant_elastic_isotropic()
-                ? finder_parameters_.elastic_parameter
+                ? constant_elastic_cross_section()
                 : finder_parameters_.maximum_cross_section) /
            testparticles * fm2_mb * M_1_PI;
   }
 
+  /**
+   * \return Whether first collisions of nucleons of the same nucleus are
+   *         searched for.
+   */
+  bool collisions_within_nucleus() const {
+    return finder_parameters_.allow_collisions_within_nucleus;
+  }
+
+  /// \return whether any multi-particle reaction is enabled.
+  bool multi_particle_reactions() const {
+    return finder_parameters_.included_multi.any();
+  }
+
+  /**
+   * \return whether a particle can take part in one of the enabled
+   * multi-particle reactions, judging by its type.
+   *
+   * \param[in] data The particle
+   */
+  bool takes_part_in_multi_particle_reactions(const ParticleData &data) const {
+    return !multi_reaction_masks_.empty() &&
+           multi_reaction_masks_[(&data.type()).index()] != 0;
+  }
+
   /**
    * Prints out all the 2-> n (n > 1) reactions with non-zero cross-sections
    * between all possible pairs of particle types.
@@ -264,13 +477,84 @@ class ScatterActionsFinder : public ActionFinderInterface {
    */
   StringProcess *get_process_string_ptr() {
     if (finder_parameters_.strings_switch) {
-      return string_process_interface_.get();
+      return string_processes_[0].get();
     } else {
       return NULL;
     }
   }
 
+  /**
+   * Select the string process used by the calling thread for the actions it
+   * finds from now on.
+   *
+   * \param[in] i_worker Index of the thread, smaller than the number of
+   *            string workers given at construction; 0 by default.
+   */
+  static void set_string_worker(int i_worker) { string_worker_ = i_worker; }
+
+  /// \return Index of the string process used by the calling thread
+  static int string_worker() { return string_worker_; }
+
+  /**
+   * \param[in] i_worker Index of a thread, smaller than the number of string
+   *            workers given at construction
+   * \return String process of the given thread, nullptr if strings are
+   *         turned off.
+   */
+  StringProcess *worker_string_process(int i_worker) const {
+    if (string_processes_.empty()) {
+      return nullptr;
+    }
+    return string_processes_[i_worker].get();
+  }
+
+  /**
+   * Collect the counters of the search for collisions, which can be done
+   * concurrently by several threads.
+   *
+   * \return the counters accumulated since the last call, after which they
+   *         start from zero again.
+   */
+  CollisionSearchCounters take_search_counters();
+
  private:
+  /**
+   * Search for all the possible collisions within one cell, see
+   * find_actions_in_cell and find_actions_in_cell_with_members.
+   *
+   * \param[in] search_list A list of particles within one cell
+   * \param[in] members The particles of \p search_list which can take part
+   *            in multi-particle reactions, or nullptr to select them from
+   *            \p search_list
+   * \param[in] dt The maximum time interval at the current time step [fm]
+   * \param[in] gcell_vol Volume of searched grid cell [fm^3]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   * \return A list of possible scatter actions
+   */
+  ActionList search_cell(const ParticleList &search_list,
+                         const ParticleList *members, double dt,
+                         const double gcell_vol,
+                         const std::vector<FourVector> &beam_momentum) const;
+
+  /**
+   * Add the counters of a single search to the ones of the finder.
+   *
+   * \param[in] counters Counters of one call of a find_actions_* function
+   */
+  void count_search(const CollisionSearchCounters &counters) const;
+
+  /**
+   * \return String process of the calling thread, nullptr if strings are
+   *         turned off.
+   */
+  StringProcess *string_process() const {
+    if (string_processes_.empty()) {
+      return nullptr;
+    }
+    return string_processes_[string_worker_].get();
+  }
+
   /**
    * Check for a single pair of particles (id_a, id_b) if a collision will
    * happen in the next timestep and create a corresponding Action object
@@ -287,6 +571,9 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * only necessary for frozen Fermi motion
    * \param[in] gcell_vol (optional) volume of grid cell in which the collision
    *                                is checked
+   * \param[in] candidate_prob (optional) probability with which the pair was
+   *            drawn as a candidate, by which the collision probability of the
+   *            stochastic criterion is divided
    * \return A null pointer if no collision happens or an action which contains
    *         the information of the outgoing particles.
    *
@@ -296,7 +583,36 @@ class ScatterActionsFinder : public ActionFinderInterface {
   ActionPtr check_collision_two_part(
       const ParticleData &data_a, const ParticleData &data_b, double dt,
       const std::vector<FourVector> &beam_momentum = {},
-      const double gcell_vol = 0.0) const;
+      const double gcell_vol = 0.0, const double candidate_prob = 1.0) const;
+
+  /**
+   * Sample the candidate pairs of a cell for the stochastic criterion without
+   * a time counter, as in direct simulation Monte Carlo.
+   *
+   * The collision probability of every pair is bounded by the one with the
+   * maximum cross section and twice the largest speed in the cell. The number
+   * of candidates is drawn from a Poisson distribution with the number of
+   * pairs times this bound as mean, and each candidate is a random pair,
+   * which collides with its probability divided by the bound. Every pair
+   * thus collides with its probability, up to terms of second order in the
+   * probabilities, while the cost is linear in the number of particles in
+   * the cell.
+   *
+   * \param[in] cell Formed particles of the cell
+   * \param[in] dt The maximum time interval at the current time step [fm]
+   * \param[in] gcell_vol Volume of the cell [fm^3]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   * \param[out] actions The actions found are appended here.
+   * \param[inout] counters Counters of the search
+   * \return Whether the pairs were sampled, which is not the case if the bound
+   *         is not below 1 and all pairs have to be checked.
+   */
+  bool sample_collision_pairs(const ParticleList &cell, double dt,
+                              double gcell_vol,
+                              const std::vector<FourVector> &beam_momentum,
+                              ActionList &actions,
+                              CollisionSearchCounters &counters) const;
 
   /**
    * Check for multiple i.e. more than 2 particles if a collision will happen in
@@ -318,10 +634,26 @@ class ScatterActionsFinder : public ActionFinderInterface {
 
   /// Struct collecting several parameters.
   ScatterActionsFinderParameters finder_parameters_;
-  /// Class that deals with strings, interfacing Pythia.
-  std::unique_ptr<StringProcess> string_process_interface_;
+  /**
+   * Classes that deal with strings, interfacing Pythia, one for each thread
+   * performing string processes.
+   */
+  std::vector<std::unique_ptr<StringProcess>> string_processes_;
+  /// Index of the string process used by the calling thread.
+  inline static thread_local std::size_t string_worker_ = 0;
+  /// Accounts the memory of the string processes, see MemoryTracker
+  MemoryAccount string_process_memory_{MemorySubsystem::StringProcess};
   /// Do all collisions isotropically.
   const bool isotropic_;
+  /**
+   * Whether all two-body collisions are isotropic and elastic with
+   * constant_elastic_cross_section(). This is the case if a non-negative
+   * elastic cross section is given, the total cross sections are the sum of
+   * the partial ones and neither inelastic 2→2, 2→1, multi-particle, string
+   * nor NNbar reactions are enabled. The collisions are then created with
+   * the elastic channel alone, without evaluating CrossSections.
+   */
+  const bool only_constant_elastic_;
   /**
    * Box length: needed to determine coordinates of collision
    * correctly in case of collision through the wall.
@@ -330,6 +662,42 @@ class ScatterActionsFinder : public ActionFinderInterface {
   const double box_length_;
   /// Parameter for formation time
   const double string_formation_time_;
+  /**
+   * Enabled multi-particle reactions of each type, by ParticleTypePtr::index,
+   * see ScatterActionMulti::reaction_mask
+   */
+  std::vector<std::uint8_t> multi_reaction_masks_;
+  /// Cache of two-body cross sections, only created if requested
+  std::unique_ptr<CrossSectionCache> cross_section_cache_;
+  /**
+   * Whether pairs of the stochastic criterion are first tested with the
+   * maximum cross section, before their cross section is evaluated
+   */
+  bool thinning_ = false;
+  /// Number of evaluated cross sections above the maximum in the thinning
+  mutable std::atomic<uint64_t> thinning_violations_{0};
+  /**
+   * Whether the candidate pairs of the stochastic criterion are sampled
+   * instead of checking every pair of a cell
+   */
+  bool pair_sampling_ = false;
+  /// Number of sampled pairs whose collision probability exceeded the bound
+  mutable std::atomic<uint64_t> pair_sampling_violations_{0};
+  /// Counters of the search, see CollisionSearchCounters
+  struct {
+    /// \see CollisionSearchCounters::cells
+    std::atomic<uint64_t> cells{0};
+    /// \see CollisionSearchCounters::max_particles_in_cell
+    std::atomic<uint64_t> max_particles_in_cell{0};
+    /// \see CollisionSearchCounters::candidate_pairs
+    std::atomic<uint64_t> candidate_pairs{0};
+    /// \see CollisionSearchCounters::checked_pairs
+    std::atomic<uint64_t> checked_pairs{0};
+    /// \see CollisionSearchCounters::found_actions
+    std::atomic<uint64_t> found_actions{0};
+    /// \see CollisionSearchCounters::found_multi_particle_actions
+    std::atomic<uint64_t> found_multi_particle_actions{0};
+  } mutable search_counters_;
 };
 
 /**
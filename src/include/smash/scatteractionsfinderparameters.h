@@ -89,7 +89,10 @@ struct ScatterActionsFinderParameters {
   const ReactionsBitSet included_2to2;
   /// List of included multi-particle reactions
   const MultiParticleReactionsBitSet included_multi;
-  /// Number of test particles.
+  /**
+   * Number of test particles, which interact with each other, i.e. per
+   * subensemble.
+   */
   const int testparticles;
   /// Enables resonance production
   const bool two_to_one;
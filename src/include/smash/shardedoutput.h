@@ -0,0 +1,131 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_SHARDEDOUTPUT_H_
+#define SRC_INCLUDE_SMASH_SHARDEDOUTPUT_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "outputinterface.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Output that writes every ensemble into an output of its own, the shard of
+ * the ensemble.
+ *
+ * Each ensemble is passed to the outputs as an event with number
+ * `event * n_ensembles + i_ensemble`, hence the particle lists at event start
+ * and end are routed to the shard `event_number % n_ensembles`. The particle
+ * lists at intermediate times are given to the shards in turn, starting with
+ * the first shard at every event start, as the ensembles are written in their
+ * order. Interactions are routed by their ensemble through
+ * at_ensemble_interaction().
+ *
+ * Since the shards do not share any file, they can be written without
+ * contention, e.g. onto different disks or by wrapping each shard into an
+ * AsyncOutput. Binary shards can be combined with merge_binary_shards().
+ *
+ * Only the callbacks of particle lists and interactions are forwarded, hence
+ * only outputs of these contents should be sharded.
+ */
+class ShardedOutput : public OutputInterface {
+ public:
+  /**
+   * Combine the outputs of the ensembles.
+   *
+   * \param[in] shards One output per ensemble, in the order of the ensembles.
+   * \throw std::invalid_argument if no shards are given.
+   */
+  explicit ShardedOutput(std::vector<std::unique_ptr<OutputInterface>> shards);
+
+  /**
+   * Forward the particle list at event start to the shard of its ensemble.
+   * \param[in] particles Current list of all particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &info) override;
+
+  /**
+   * Forward the particle list at event end to the shard of its ensemble.
+   * \param[in] particles Current list of particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+
+  /**
+   * Forward an interaction of an unknown ensemble to the first shard.
+   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] density Density at the interaction point.
+   */
+  void at_interaction(const Action &action, const double density) override;
+
+  /**
+   * Forward an interaction to the shard of its ensemble.
+   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] density Density at the interaction point.
+   * \param[in] i_ensemble Ensemble in which the interaction happened.
+   */
+  void at_ensemble_interaction(const Action &action, const double density,
+                               const int i_ensemble) override;
+
+  /**
+   * Forward the particle list at an intermediate time to the next shard.
+   * \param[in] particles Current list of particles.
+   * \param[in] clock Clock of the output times.
+   * \param[in] dens_param Parameters for the density calculation.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &info) override;
+
+  /// \return Whether the shards use the interactions.
+  bool uses_interactions() const override {
+    return shards_.front()->uses_interactions();
+  }
+  /// \return Whether the shards use the interaction density.
+  bool uses_interaction_density() const override {
+    return shards_.front()->uses_interaction_density();
+  }
+  /// \return Whether the shards use the output times.
+  bool uses_intermediate_times() const override {
+    return shards_.front()->uses_intermediate_times();
+  }
+
+  /// \return Number of shards.
+  std::size_t size() const { return shards_.size(); }
+
+ private:
+  /**
+   * \param[in] event_number Number of an event as passed to the outputs.
+   * \return Shard of the ensemble of the event.
+   */
+  OutputInterface &shard_of_event(int event_number);
+
+  /// Outputs of the ensembles
+  std::vector<std::unique_ptr<OutputInterface>> shards_;
+
+  /// Shard receiving the next particle list at an intermediate time
+  std::size_t next_intermediate_shard_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_SHARDEDOUTPUT_H_
@@ -0,0 +1,82 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_SPECTATORSET_H_
+#define SRC_INCLUDE_SMASH_SPECTATORSET_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "forwarddeclarations.h"
+
+namespace smash {
+
+/**
+ * Tracks the nucleons of the colliding nuclei which cannot interact within
+ * the current time step, such that they can be left out of the grid and the
+ * search for collisions.
+ *
+ * At the beginning of an event all nucleons of projectile and target are
+ * spectators. Since first collisions within the same nucleus are forbidden, a
+ * spectator can only interact with the spectators of the other nucleus or with
+ * particles that already interacted, either directly or with the products of
+ * their interactions. A spectator rejoins the search for collisions in the
+ * first time step in which such particles come close to it and is not tracked
+ * anymore afterwards, also if it did not collide.
+ */
+class SpectatorSet {
+ public:
+  /**
+   * Start tracking all nucleons of projectile and target that did not
+   * collide yet.
+   *
+   * \param[in] particles The particles of the ensemble.
+   */
+  void reset(const Particles &particles);
+
+  /**
+   * Let all spectators rejoin which could come close enough to interact with
+   * any other particle within the next time step.
+   *
+   * The neighborhood of a spectator is checked on a coarse mesh, whose cells
+   * are large enough to cover the interaction length, the movement of all
+   * particles within the time step and the distance products of interactions
+   * can be placed away from the interacting particles. The rejoining
+   * particles are taken into account for the others until no more spectators
+   * rejoin.
+   *
+   * \param[in] particles The particles of the ensemble.
+   * \param[in] interaction_length Largest distance at which two particles
+   *            interact [fm].
+   * \param[in] dt Duration of the time step [fm].
+   * \return Number of remaining spectators.
+   */
+  std::size_t update(const Particles &particles, double interaction_length,
+                     double dt);
+
+  /**
+   * \param[in] data A particle of the ensemble.
+   * \return whether the particle is a spectator.
+   */
+  bool contains(const ParticleData &data) const;
+
+  /// \return Number of spectators.
+  std::size_t size() const { return size_; }
+
+ private:
+  /// Whether the particle with a given id is a spectator
+  std::vector<char> is_spectator_;
+
+  /// Number of spectators
+  std::size_t size_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_SPECTATORSET_H_
@@ -79,6 +79,8 @@ class SphereModus : public ModusDefault {
   bool is_sphere() const { return true; }
   /// \return radius
   double radius() const { return radius_; }
+  /// \return Scattering rate per particle [1/fm] of the freeze-out, 0 if off
+  double freeze_out_rate() const { return freeze_out_rate_; }
 
  private:
   /// Sphere radius (in fm)
@@ -146,6 +148,8 @@ class SphereModus : public ModusDefault {
    * Initial momentum of the jet particle; only used if jet_pdg_ is not nullopt
    */
   const double jet_mom_;
+  /// Scattering rate per particle of the freeze-out, 0 if it is not detected
+  const double freeze_out_rate_;
   /**\ingroup logging
    * Writes the initial state for the Sphere to the output stream.
    *
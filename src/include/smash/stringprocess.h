@@ -10,6 +10,7 @@
 #ifndef SRC_INCLUDE_SMASH_STRINGPROCESS_H_
 #define SRC_INCLUDE_SMASH_STRINGPROCESS_H_
 
+#include <filesystem>
 #include <map>
 #include <memory>
 #include <string>
@@ -21,6 +22,7 @@
 #include "constants.h"
 #include "logging.h"
 #include "particledata.h"
+#include "sha256.h"
 
 namespace smash {
 static constexpr int LPythia = LogArea::Pythia::id;
@@ -186,9 +188,181 @@ class StringProcess {
   /// Map object to contain the different pythia objects
   pythia_map hard_map_;
 
-  /// PYTHIA object used in fragmentation
+  /**
+   * Center-of-mass energies, at which the objects in hard_map_ were
+   * initialized [GeV]. PYTHIA objects with variable energy can generate
+   * events up to this energy.
+   */
+  std::map<std::pair<int, int>, double> hard_max_sqrts_;
+
+  /**
+   * Lowest center-of-mass energy, at which PYTHIA objects for hard string
+   * routines are initialized on demand [GeV]
+   */
+  static constexpr double hard_init_sqrts_min = 10.;
+
+  /**
+   * Energy bins of the PYTHIA objects for hard string routines, which are
+   * initialized on demand. The bins are bounded by hard_init_sqrts_min times
+   * powers of two, such that a PYTHIA object is reinitialized at most a few
+   * times as higher energies occur.
+   *
+   * \param[in] sqrts Center-of-mass energy of a collision [GeV]
+   * \return Upper edge of the bin of the energy [GeV]
+   */
+  static double hard_init_sqrts(double sqrts);
+
+  /**
+   * \param[in] idAB PDG ids of the beams used by PYTHIA
+   * \param[in] sqrts Center-of-mass energy of the initialization [GeV]
+   * \return File of the initialization of the multiparton interactions of
+   *         the PYTHIA object, empty if it is not stored.
+   *
+   * \see set_pythia_init_cache
+   */
+  static std::string mpi_init_file_name(const std::pair<int, int> &idAB,
+                                        double sqrts);
+
+  /**
+   * Common beginning of the paths of the files, in which the initialization
+   * of multiparton interactions of PYTHIA objects for hard string routines is
+   * stored.
+   * Empty if it is not stored.
+   *
+   * \see set_pythia_init_cache
+   */
+  inline static std::string mpi_init_file_prefix_ = "";
+
+  /**
+   * Create and initialize the PYTHIA object for the hard string routine of
+   * the given beams and store it in hard_map_, replacing an existing one.
+   *
+   * \param[in] idAB PDG ids of the beams used by PYTHIA
+   * \param[in] sqrts Center-of-mass energy of the initialization [GeV]
+   * \param[in] mpi_init_file File to read the initialization of multiparton
+   *            interactions from or to write it to; empty for neither.
+   *
+   * \throw std::runtime_error if PYTHIA fails to initialize.
+   */
+  void create_pythia_hard(const std::pair<int, int> &idAB, double sqrts,
+                          const std::string &mpi_init_file);
+
+  /**
+   * Hadrons with the quantum numbers of a pair of valence quark constituents,
+   * as they are picked from by get_hadrontype_from_quark and
+   * get_resonance_from_quark.
+   */
+  struct FragmentCandidates {
+    /// PDG ids of the hadrons known to PYTHIA
+    std::vector<int> hadron_pdgids;
+    /**
+     * Summed weights (spin degeneracy over pole mass) of the hadrons,
+     * starting with 0, such that the i-th hadron owns the interval
+     * [hadron_weight_summed[i], hadron_weight_summed[i + 1]).
+     */
+    std::vector<double> hadron_weight_summed;
+    /// PDG ids of the resonances, if the constituents are valid string ends
+    std::vector<int> resonance_pdgids;
+    /// Minimum masses of the resonances [GeV]
+    std::vector<double> resonance_min_mass;
+    /// Pole masses of the resonances [GeV]
+    std::vector<double> resonance_pole_mass;
+  };
+
+  /// Number of (anti)quarks and (anti)diquarks in fragment_candidates_
+  static constexpr int n_quark_codes_ = 70;
+
+  /**
+   * Flat table of the FragmentCandidates of all pairs of (anti)quarks and
+   * (anti)diquarks, indexed by
+   * quark_code_index(idq1) * n_quark_codes_ + quark_code_index(idq2).
+   */
+  std::vector<FragmentCandidates> fragment_candidates_;
+
+  /**
+   * \param[in] idq PDG id of an (anti)quark or (anti)diquark
+   * \return index of \p idq in fragment_candidates_, -1 if it is neither a
+   *         quark nor a diquark.
+   */
+  static int quark_code_index(int idq);
+
+  /**
+   * Find the hadrons with the quantum numbers of the given valence quark
+   * constituents by scanning all particle types.
+   *
+   * \param[in] idq1 PDG id of a valence quark constituent.
+   * \param[in] idq2 PDG id of another valence quark constituent.
+   * \return hadrons that can be made of \p idq1 and \p idq2.
+   *
+   * \note #pythia_hadron_ has to be set up, see pythia_hadron().
+   */
+  FragmentCandidates find_fragment_candidates(int idq1, int idq2) const;
+
+  /// Fill fragment_candidates_, once the particle types are known.
+  void build_fragment_tables();
+
+  /**
+   * Look up the hadrons with the quantum numbers of the given valence quark
+   * constituents in fragment_candidates_.
+   *
+   * \param[in] idq1 PDG id of a valence quark constituent.
+   * \param[in] idq2 PDG id of another valence quark constituent.
+   * \param[out] buffer Storage for the result, if a constituent is not in the
+   *             table.
+   * \return reference to the table entry or to \p buffer
+   *
+   * \note #pythia_hadron_ has to be set up, see pythia_hadron().
+   */
+  const FragmentCandidates &fragment_candidates(
+      int idq1, int idq2, FragmentCandidates &buffer) const;
+
+  /**
+   * PYTHIA object used in fragmentation, nullptr until it is needed, see
+   * pythia_hadron()
+   */
   std::unique_ptr<Pythia8::Pythia> pythia_hadron_;
 
+  /**
+   * Seed of #pythia_hadron_ drawn by init_pythia_hadron_rndm before it was
+   * set up, 0 if none
+   */
+  int pending_seed_ = 0;
+
+  /**
+   * Set up #pythia_hadron_ and the objects depending on it, i.e. the
+   * cross-section and flavor selection objects, the intermediate event
+   * record and the tables of the fragmentation candidates.
+   */
+  void initialize_hadronization();
+
+  /**
+   * Most runs do not fragment any string, e.g. at low energies, so the
+   * objects for the fragmentation are only set up when they are used first,
+   * instead of with the StringProcess.
+   *
+   * \return PYTHIA object used in fragmentation, which is set up if needed.
+   */
+  Pythia8::Pythia *pythia_hadron() {
+    if (!pythia_hadron_) {
+      initialize_hadronization();
+    }
+    return pythia_hadron_.get();
+  }
+
+  /// \return the flavor selection object, which is set up if needed.
+  Pythia8::StringFlav &pythia_stringflav() {
+    pythia_hadron();
+    return pythia_stringflav_;
+  }
+
+  /**
+   * Whether the random numbers of #pythia_hadron_ are seeded anew from the
+   * SMASH random number engine for every string process.
+   *
+   * \see set_reseed_per_string
+   */
+  bool reseed_per_string_ = false;
+
   /// An object to compute cross-sections
   Pythia8::SigmaTotal pythia_sigmatot_;
 
@@ -208,7 +382,7 @@ class StringProcess {
   // clang-format off
 
   /**
-   * Constructor, initializes pythia. Should only be called once.
+   * Constructor, which does not initialize PYTHIA yet, see pythia_hadron().
    * \param[in] string_tension value of #kappa_tension_string_ [GeV/fm]
    * \param[in] time_formation value of #time_formation_const_ [fm]
    * \param[in] gluon_beta value of #pow_fgluon_beta_
@@ -300,6 +474,11 @@ class StringProcess {
     const int seed_new =
         random::uniform_int(1, maximum_rndm_seed_in_pythia);
 
+    // The seed is drawn anyway, so that the random numbers do not change.
+    if (!pythia_hadron_) {
+      pending_seed_ = seed_new;
+      return;
+    }
     pythia_hadron_->rndm.init(seed_new);
     logg[LPythia].debug("pythia_hadron_ : rndm is initialized with seed ",
                         seed_new);
@@ -307,6 +486,54 @@ class StringProcess {
 
   // clang-format on
 
+  /**
+   * Create another StringProcess with the current parameters of this one and
+   * its own PYTHIA objects, e.g. for the use on another thread.
+   *
+   * \return The new StringProcess.
+   */
+  std::unique_ptr<StringProcess> clone() const;
+
+  /**
+   * Seed the random numbers used in the fragmentation anew for every string
+   * process, instead of once per event with init_pythia_hadron_rndm.
+   *
+   * The fragmentation of a string then only depends on the state of the SMASH
+   * random number engine when it is created, and not on the strings that were
+   * fragmented by this object before. This is needed if several objects
+   * fragment the strings of different ensembles on several threads.
+   *
+   * \param[in] reseed Whether to seed PYTHIA for every string process.
+   */
+  void set_reseed_per_string(bool reseed) { reseed_per_string_ = reseed; }
+
+  /**
+   * Store the initialization of PYTHIA objects for hard strings on disk, so
+   * that later runs with the same configuration can skip the initialization
+   * of the multiparton interactions.
+   *
+   * \param[in] hash The hash of the SMASH version, particles and decay modes,
+   *            which is part of the file names.
+   * \param[in] tabulations_path Directory of the files. Nothing is stored if
+   *            this is empty.
+   */
+  static void set_pythia_init_cache(
+      sha256::Hash hash, const std::filesystem::path &tabulations_path);
+
+  /**
+   * Initialize the PYTHIA objects for hard string routines of the given beams
+   * in advance, instead of at their first collision.
+   *
+   * \param[in] beams Pairs of incoming hadrons, which are mapped onto the
+   *            hadrons used by PYTHIA like in the hard string routine.
+   * \param[in] sqrts Center-of-mass energy, at which the objects are
+   *            initialized [GeV]. Collisions above it reinitialize them.
+   *
+   * \throw std::runtime_error if PYTHIA fails to initialize.
+   */
+  void preinitialize_hard_pythia(
+      const std::vector<std::pair<PdgCode, PdgCode>> &beams, double sqrts);
+
   /**
    * Interface to pythia_sigmatot_ to compute cross-sections of A+B->
    * different final states \iref{Schuler:1993wr}.
@@ -326,8 +553,8 @@ class StringProcess {
         (std::abs(pdg_a) > 1000) ? pdg_a : 10 * (std::abs(pdg_a) / 10) + 3;
     const int pdg_b_mod =
         (std::abs(pdg_b) > 1000) ? pdg_b : 10 * (std::abs(pdg_b) / 10) + 3;
-    sqrts_threshold += pythia_hadron_->particleData.m0(pdg_a_mod) +
-                       pythia_hadron_->particleData.m0(pdg_b_mod);
+    sqrts_threshold += pythia_hadron()->particleData.m0(pdg_a_mod) +
+                       pythia_hadron()->particleData.m0(pdg_b_mod);
     /* Constant cross-section for sub-processes below threshold equal to
      * cross-section at the threshold. */
     if (sqrt_s < sqrts_threshold) {
@@ -58,6 +58,9 @@ class Tabulation {
    */
   bool is_empty() const { return values_.empty(); }
 
+  /// \return the upper bound of the tabulation domain
+  double x_max() const { return x_max_; }
+
   /**
    * Construct a tabulation object by reading binary data from a stream.
    *
@@ -68,6 +71,38 @@ class Tabulation {
    */
   static Tabulation from_file(std::ifstream& stream, sha256::Hash hash);
 
+  /**
+   * Tabulate the inverse of the cumulative distribution function of an
+   * unnormalized probability density, so that the tabulated value at a
+   * uniformly distributed argument in [0, 1) follows the density.
+   *
+   * \param[in] x_min Lower bound of the density support.
+   * \param[in] x_max Upper bound of the density support.
+   * \param[in] density Unnormalized probability density.
+   * \param[out] integral Integral of the density, if not null.
+   * \return Tabulation of x as a function of the cumulative probability.
+   * \throw std::invalid_argument if the density vanishes everywhere.
+   */
+  static Tabulation inverse_cdf(double x_min, double x_max,
+                                const std::function<double(double)>& density,
+                                double* integral = nullptr);
+
+  /**
+   * Tabulate the cumulative distribution function of an unnormalized
+   * probability density, normalized to 1 at the upper bound. Together with
+   * get_inverse_linear, this samples the density as a histogram with \p num
+   * bins, without the interpolation of inverse_cdf.
+   *
+   * \param[in] x_min Lower bound of the density support.
+   * \param[in] x_max Upper bound of the density support.
+   * \param[in] num Number of intervals.
+   * \param[in] density Unnormalized probability density.
+   * \return Tabulation of the cumulative probability as a function of x.
+   * \throw std::invalid_argument if the density vanishes everywhere.
+   */
+  static Tabulation cdf(double x_min, double x_max, size_t num,
+                        const std::function<double(double)>& density);
+
   /**
    * Look up a value from the tabulation (without any interpolation, simply
    * using the closest tabulated value). If \par x is below the lower tabulation
@@ -96,6 +131,32 @@ class Tabulation {
   double get_value_linear(
       double x, Extrapolation extrapolation = Extrapolation::Linear) const;
 
+  /**
+   * Invert the linear interpolation of a tabulated nondecreasing function,
+   * such as a cumulative distribution function from cdf.
+   *
+   * \param y Value of the tabulated function.
+   * \return The argument at which the linear interpolation reaches \p y,
+   * clamped to the tabulated range.
+   */
+  double get_inverse_linear(double y) const;
+
+  /**
+   * Look up many values from the tabulation using linear interpolation, with
+   * the same results as get_value_linear for each argument. The choice of
+   * the extrapolation is made once for all arguments.
+   *
+   * \param[in] x First of the arguments to the tabulated function.
+   * \param[out] values First of the tabulated values, which has to hold at
+   *                    least \p n elements.
+   * \param[in] n Number of arguments.
+   * \param[in] extrapolation Extrapolation that should be used for values
+   * outside the tabulation.
+   */
+  void get_values_linear(
+      const double* x, double* values, size_t n,
+      Extrapolation extrapolation = Extrapolation::Linear) const;
+
   /**
    * Write a binary representation of the tabulation to a stream.
    *
@@ -106,6 +167,9 @@ class Tabulation {
   void write(std::ofstream& stream, sha256::Hash hash) const;
 
  protected:
+  /// The bundle reads and writes the tabulated values directly
+  friend class TabulationBundle;
+
   /// vector for storing tabulated values
   std::vector<double> values_;
 
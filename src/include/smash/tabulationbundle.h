@@ -0,0 +1,112 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_TABULATIONBUNDLE_H_
+#define SRC_INCLUDE_SMASH_TABULATIONBUNDLE_H_
+
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <string>
+
+#include "sha256.h"
+#include "tabulation.h"
+
+namespace smash {
+
+/**
+ * Named tabulations stored together in one file of the tabulations
+ * directory.
+ *
+ * The file name contains the hash of the particle properties, so that runs
+ * with different particle or decay mode files share a directory without
+ * interfering. A bundle is read by mapping its file into memory without any
+ * lock. It is published by writing a temporary file next to it, which is then
+ * renamed to the final name. Since renaming is atomic, readers see either the
+ * previous or the new complete bundle, and concurrent writers only replace
+ * one complete bundle by another.
+ *
+ * Layout of the file, in the byte order of the machine:
+ * - `SMTB` magic number, format version (uint32), hash (32 bytes), number of
+ *   tabulations (uint64)
+ * - for every tabulation: length of the name (uint32), name, lower and upper
+ *   bound and inverse step size (3 doubles), number of values (uint64),
+ *   values (doubles)
+ */
+class TabulationBundle {
+ public:
+  /**
+   * Create an empty bundle.
+   *
+   * \param[in] hash Hash of the particle properties of the tabulations.
+   */
+  explicit TabulationBundle(sha256::Hash hash) : hash_(hash) {}
+
+  /**
+   * Read the bundle of the given hash from a directory.
+   *
+   * A missing bundle gives an empty one. A damaged bundle or one of a
+   * different format version is ignored with a warning, so that its
+   * tabulations are computed again.
+   *
+   * \param[in] dir Tabulations directory.
+   * \param[in] hash Hash of the particle properties.
+   * \return The tabulations found in the directory.
+   */
+  static TabulationBundle read(const std::filesystem::path &dir,
+                               sha256::Hash hash);
+
+  /**
+   * \param[in] dir Tabulations directory.
+   * \param[in] hash Hash of the particle properties.
+   * \return Path of the bundle of the given hash in the directory.
+   */
+  static std::filesystem::path path(const std::filesystem::path &dir,
+                                    sha256::Hash hash);
+
+  /**
+   * Look up a tabulation.
+   *
+   * \param[in] name Name of the tabulation.
+   * \return The tabulation or nullptr if the bundle does not contain it.
+   */
+  const Tabulation *find(const std::string &name) const;
+
+  /**
+   * Add a tabulation, replacing one of the same name.
+   *
+   * \param[in] name Name of the tabulation.
+   * \param[in] tabulation The tabulation.
+   */
+  void insert(const std::string &name, const Tabulation &tabulation) {
+    tabulations_[name] = tabulation;
+  }
+
+  /// \return Number of tabulations in the bundle.
+  std::size_t size() const { return tabulations_.size(); }
+
+  /**
+   * Write the bundle into a directory, replacing the bundle of the same hash
+   * atomically.
+   *
+   * \param[in] dir Tabulations directory.
+   * \throw std::runtime_error if the bundle cannot be written.
+   */
+  void publish(const std::filesystem::path &dir) const;
+
+ private:
+  /// Hash of the particle properties
+  sha256::Hash hash_;
+  /// Tabulations by name
+  std::map<std::string, Tabulation> tabulations_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_TABULATIONBUNDLE_H_
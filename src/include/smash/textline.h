@@ -0,0 +1,134 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_TEXTLINE_H_
+#define SRC_INCLUDE_SMASH_TEXTLINE_H_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace smash {
+
+/**
+ * \ingroup output
+ * \brief Buffer to format a line of an ASCII output without `printf`.
+ *
+ * Numbers are appended with `std::to_chars`, which avoids parsing a format
+ * string and the locale handling of `printf` for every value. The text is
+ * identical to the corresponding `printf` conversion: integers match `%i` and
+ * real numbers with precision `p` match `%.<p>g`, as guaranteed for
+ * `std::to_chars` with `std::chars_format::general`. If the standard library
+ * does not provide `std::to_chars` for floating point numbers, real numbers
+ * are formatted with `std::snprintf` instead.
+ *
+ * The buffer is meant to be reused for all lines of an output; it is large
+ * enough for the longest particle line of the OSCAR formats.
+ */
+class TextLine {
+ public:
+  /// Remove the content to start a new line.
+  void clear() { size_ = 0; }
+
+  /**
+   * Append an integer as `%i` would.
+   *
+   * \param[in] x Value to append.
+   * \return This line.
+   */
+  TextLine &operator<<(int x) {
+    size_ =
+        std::to_chars(buffer_ + size_, buffer_ + capacity, x).ptr - buffer_;
+    return *this;
+  }
+
+  /**
+   * Append a real number as `%.<precision>g` would.
+   *
+   * \param[in] x Value to append.
+   * \param[in] precision Number of significant digits.
+   * \return This line.
+   */
+  TextLine &append(double x, int precision = 6) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    size_ = std::to_chars(buffer_ + size_, buffer_ + capacity, x,
+                          std::chars_format::general, precision)
+                .ptr -
+            buffer_;
+#else
+    const int n = std::snprintf(buffer_ + size_, capacity - size_, "%.*g",
+                                precision, x);
+    size_ = std::min(size_ + static_cast<std::size_t>(n), capacity - 1);
+#endif
+    return *this;
+  }
+
+  /**
+   * Append a real number as `%g` would.
+   *
+   * \param[in] x Value to append.
+   * \return This line.
+   */
+  TextLine &operator<<(double x) { return append(x); }
+
+  /**
+   * Append a single character.
+   *
+   * \param[in] c Character to append.
+   * \return This line.
+   */
+  TextLine &operator<<(char c) {
+    if (size_ < capacity) {
+      buffer_[size_++] = c;
+    }
+    return *this;
+  }
+
+  /**
+   * Append a string.
+   *
+   * \param[in] s String to append.
+   * \return This line.
+   */
+  TextLine &operator<<(const std::string &s) {
+    const std::size_t n = std::min(s.size(), capacity - size_);
+    std::memcpy(buffer_ + size_, s.data(), n);
+    size_ += n;
+    return *this;
+  }
+
+  /// \return Start of the formatted text, which is not null-terminated.
+  const char *data() const { return buffer_; }
+  /// \return Number of characters in the line.
+  std::size_t size() const { return size_; }
+  /// \return The line as string.
+  std::string str() const { return std::string(buffer_, size_); }
+
+  /**
+   * Write the line with a single call.
+   *
+   * \param[in] file File to write to.
+   */
+  void write_to(std::FILE *file) const { std::fwrite(buffer_, 1, size_, file); }
+
+ private:
+  /// Maximal number of characters in a line
+  static constexpr std::size_t capacity = 1024;
+  /// Characters of the line
+  char buffer_[capacity];
+  /// Number of characters in use
+  std::size_t size_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_TEXTLINE_H_
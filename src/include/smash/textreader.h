@@ -0,0 +1,88 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_TEXTREADER_H_
+#define SRC_INCLUDE_SMASH_TEXTREADER_H_
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace smash {
+
+/**
+ * \ingroup output
+ * \brief Reads the events of particle lists in text form, like the OSCAR
+ * formats.
+ *
+ * The file is mapped into memory and scanned once at construction to find
+ * the text of every event. Events are terminated by a line containing "end",
+ * as the event end lines of the OSCAR formats. A file without such lines is
+ * one event. An event is only indexed if a comment line follows within its
+ * first five lines or if it has more than five lines, which leaves out the
+ * trailing lines after the last event end line.
+ */
+class TextParticleListReader {
+ public:
+  /**
+   * Map a text file into memory and index its events.
+   *
+   * \param[in] path Path of the file.
+   * \throw std::runtime_error if the file cannot be mapped.
+   */
+  explicit TextParticleListReader(const std::filesystem::path &path);
+
+  /// Unmap the file.
+  ~TextParticleListReader();
+
+  /// Cannot be copied
+  TextParticleListReader(const TextParticleListReader &) = delete;
+  /// Cannot be copied
+  TextParticleListReader &operator=(const TextParticleListReader &) = delete;
+
+  /// \return Number of events in the file.
+  std::size_t n_events() const { return events_.size(); }
+
+  /**
+   * \param[in] i Position of the event in the file, counted from 0.
+   * \return The lines of the event without its event end line. The text
+   *         stays valid as long as the reader exists.
+   */
+  std::string_view event(std::size_t i) const {
+    const EventEntry &entry = events_.at(i);
+    return {data_ + entry.begin, entry.end - entry.begin};
+  }
+
+ private:
+  /// Location of the text of an event in the file
+  struct EventEntry {
+    /// Offset of the first line
+    std::size_t begin;
+    /// Offset of the event end line or the end of the file
+    std::size_t end;
+  };
+
+  /**
+   * \param[in] offset Start of a line.
+   * \return Whether an event starts at the line.
+   */
+  bool has_event_at(std::size_t offset) const;
+
+  /// Start of the mapped file
+  const char *data_ = nullptr;
+  /// Size of the mapped file in bytes
+  std::size_t size_ = 0;
+  /// Events in the order of the file
+  std::vector<EventEntry> events_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_TEXTREADER_H_
@@ -129,6 +129,9 @@ class ThermodynamicLatticeOutput : public OutputInterface {
       RectangularLattice<EnergyMomentumTensor> &lattice,
       double current_time) override;
 
+  /// \return false, the interactions are not used.
+  bool uses_interactions() const override { return false; }
+
  private:
   /// Structure that holds all the information about what to printout
   const OutputParameters out_par_;
@@ -98,6 +98,9 @@ class ThermodynamicOutput : public OutputInterface {
                           const ThreeVector &line_start,
                           const ThreeVector &line_end, int n_points);
 
+  /// \return false, the interactions are not used.
+  bool uses_interactions() const override { return false; }
+
  private:
   /// Pointer to output file
   RenamingFilePtr file_;
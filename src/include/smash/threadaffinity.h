@@ -0,0 +1,95 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_THREADAFFINITY_H_
+#define SRC_INCLUDE_SMASH_THREADAFFINITY_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "forwarddeclarations.h"
+
+namespace smash {
+
+/// Cores of every NUMA node, the nodes in ascending order
+using NumaNodes = std::vector<std::vector<int>>;
+
+/**
+ * Determine the cores on which this process may run, grouped by their NUMA
+ * nodes.
+ *
+ * The nodes are read from sysfs. Without that information, all cores form
+ * one node. Nodes without any usable core are left out.
+ *
+ * \return Cores of the nodes, empty if the cores cannot be determined.
+ */
+NumaNodes usable_numa_nodes();
+
+/**
+ * Assign the worker threads to NUMA nodes.
+ *
+ * \param[in] policy How the threads are distributed over the nodes.
+ * \param[in] nodes Cores of the nodes, see usable_numa_nodes().
+ * \param[in] n_threads Number of threads.
+ * \return Index of the node of every thread, empty for ThreadAffinity::None
+ *         or without nodes. With the compact policy, a node gets as many
+ *         threads as it has cores before the next node is used, and once all
+ *         cores are taken the assignment starts over from the first node.
+ */
+std::vector<std::size_t> assign_numa_nodes(ThreadAffinity policy,
+                                           const NumaNodes &nodes,
+                                           int n_threads);
+
+/**
+ * Bind the calling thread to the given cores for the lifetime of this object.
+ *
+ * The cores the thread could run on before are restored on destruction. The
+ * threads started meanwhile inherit the binding.
+ */
+class ScopedThreadAffinity {
+ public:
+  /**
+   * Bind the calling thread.
+   *
+   * \param[in] cores Cores on which the thread may run.
+   */
+  explicit ScopedThreadAffinity(const std::vector<int> &cores);
+  /// Cannot be copied, the binding is restored exactly once
+  ScopedThreadAffinity(const ScopedThreadAffinity &) = delete;
+  /// Cannot be copied, the binding is restored exactly once
+  ScopedThreadAffinity &operator=(const ScopedThreadAffinity &) = delete;
+  /// Restore the previous binding
+  ~ScopedThreadAffinity();
+
+  /// \return Whether the thread was bound successfully
+  bool bound() const { return previous_ != nullptr; }
+
+ private:
+  /// Opaque copy of the previous binding, nullptr if binding failed
+  struct PreviousCores;
+  /// The previous binding
+  std::unique_ptr<PreviousCores> previous_;
+};
+
+/**
+ * Advise the kernel to back the given memory with transparent huge pages,
+ * which it may ignore. Only the huge pages that lie completely within the
+ * range are affected, so the advice only makes sense for large ranges that
+ * are not yet touched.
+ *
+ * \param[in] memory Start of the memory range.
+ * \param[in] bytes Length of the memory range.
+ * \return Whether the advice was given.
+ */
+bool advise_huge_pages(void *memory, std::size_t bytes);
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_THREADAFFINITY_H_
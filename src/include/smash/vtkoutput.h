@@ -112,6 +112,9 @@ class VtkOutput : public OutputInterface {
       const std::string name1, const std::string name2,
       RectangularLattice<std::pair<ThreeVector, ThreeVector>> &lat) override;
 
+  /// \return false, the interactions are not used.
+  bool uses_interactions() const override { return false; }
+
  private:
   /**
    * Write the given particles to the output.
@@ -0,0 +1,301 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_VTKXMLOUTPUT_H_
+#define SRC_INCLUDE_SMASH_VTKXMLOUTPUT_H_
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "density.h"
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ * Content of a file in the binary XML VTK format, which is collected while
+ * SMASH runs and compressed and written later.
+ */
+struct VtkXmlFile {
+  /// One data array of the file
+  struct Array {
+    /// Section of the data set containing the array, e.g. "PointData"
+    std::string section;
+    /// Name of the array
+    std::string name;
+    /// VTK type of the values, e.g. "Float64"
+    std::string type;
+    /// Number of components per point
+    int n_components;
+    /// Values in the byte order of this machine
+    std::vector<char> data;
+  };
+
+  /**
+   * Append an array.
+   *
+   * \param[in] section Section of the data set containing the array.
+   * \param[in] name Name of the array.
+   * \param[in] type VTK type of the values.
+   * \param[in] n_components Number of components per point.
+   * \param[in] values Values of all components of all points.
+   */
+  template <typename T>
+  void add_array(const std::string &section, const std::string &name,
+                 const std::string &type, int n_components,
+                 const std::vector<T> &values) {
+    arrays.push_back(
+        {section, name, type, n_components,
+         std::vector<char>(values.size() * sizeof(T))});
+    if (!values.empty()) {
+      std::memcpy(arrays.back().data.data(), values.data(),
+                  arrays.back().data.size());
+    }
+  }
+
+  /**
+   * Write the file.
+   *
+   * All arrays are stored raw in the appended data section, optionally
+   * compressed in blocks with zlib as expected by the
+   * `vtkZLibDataCompressor` of VTK.
+   *
+   * \param[in] compression_level zlib compression level, 0 for none.
+   * \throw std::runtime_error if the file cannot be written.
+   */
+  void write(int compression_level) const;
+
+  /// Path of the file
+  std::filesystem::path path;
+  /// Type of the data set, "UnstructuredGrid" or "ImageData"
+  std::string dataset;
+  /// Attributes of the data set element
+  std::string dataset_attributes;
+  /// Attributes of the piece element
+  std::string piece_attributes;
+  /// Arrays in the order of their sections
+  std::vector<Array> arrays;
+};
+
+/**
+ * \ingroup output
+ * SMASH output of particles and thermodynamic lattices in the binary XML VTK
+ * formats, see \ref doxypage_output_vtk_xml.
+ *
+ * In contrast to VtkOutput, the values are stored in binary form and
+ * compressed, and lattices can be cropped to a region of interest and
+ * downsampled. The values are collected on the calling thread; compressing
+ * and writing the files is done by a writer thread of the output.
+ */
+class VtkXmlOutput : public OutputInterface {
+ public:
+  /**
+   * Create a new binary XML VTK output.
+   *
+   * \param[in] path Path to the output files.
+   * \param[in] name Name of the output, "Particles" or "Thermodynamics".
+   * \param[in] out_par Additional information on the configured output.
+   * \throw std::invalid_argument if the downsampling or compression level is
+   *        invalid.
+   */
+  VtkXmlOutput(const std::filesystem::path &path, const std::string &name,
+               const OutputParameters &out_par);
+
+  /// Write the pending files and stop the writer thread.
+  ~VtkXmlOutput() override;
+
+  /**
+   * Writes the initial particles of an event.
+   *
+   * \param[in] particles Current list of all particles.
+   * \param[in] event_number Number of the current event.
+   * \param[in] event Unused, needed since inherited.
+   */
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &event) override;
+
+  /**
+   * Writes the current particles.
+   *
+   * \param[in] particles Current list of particles.
+   * \param[in] clock Unused, needed since inherited.
+   * \param[in] dens_param Unused, needed since inherited.
+   * \param[in] event Unused, needed since inherited.
+   */
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &event) override;
+
+  /**
+   * Writes the density lattice.
+   *
+   * \param[in] tq The quantity of the lattice, used in the file name.
+   * \param[in] dt Type of density, see DensityType.
+   * \param[in] lattice Lattice of the density.
+   */
+  void thermodynamics_output(
+      const ThermodynamicQuantity tq, const DensityType dt,
+      RectangularLattice<DensityOnLattice> &lattice) override;
+
+  /**
+   * Writes the energy-momentum tensor, in the computational or the Landau
+   * frame, or the velocity of the Landau frame.
+   *
+   * \param[in] tq The quantity of the lattice, see ThermodynamicQuantity.
+   * \param[in] dt Type of density, see DensityType.
+   * \param[in] lattice Lattice of the energy-momentum tensor.
+   */
+  void thermodynamics_output(
+      const ThermodynamicQuantity tq, const DensityType dt,
+      RectangularLattice<EnergyMomentumTensor> &lattice) override;
+
+  /**
+   * Writes the lattice of the forced thermalization.
+   *
+   * \param[in] gct Grand-canonical thermalizer holding the lattice.
+   */
+  void thermodynamics_output(const GrandCanThermalizer &gct) override;
+
+  /**
+   * Wait until all files have been written.
+   *
+   * \throw std::runtime_error if writing a file failed.
+   */
+  void flush();
+
+  /// \return false, the interactions are not used.
+  bool uses_interactions() const override { return false; }
+
+ private:
+  /**
+   * Write the current particles into a new file.
+   *
+   * \param[in] particles Current list of particles.
+   */
+  void write_particles(const Particles &particles);
+
+  /// Nodes of a lattice that are written
+  struct Selection {
+    /// Index of the first selected node in each direction
+    std::array<int, 3> first;
+    /// Number of selected nodes in each direction
+    std::array<int, 3> count;
+    /// Distance between selected nodes in each direction, in nodes
+    int stride;
+  };
+
+  /**
+   * Select the nodes of a lattice in the region of interest, every
+   * downsampling-th node in each direction.
+   *
+   * \param[in] lattice Lattice to write.
+   * \return The selected nodes.
+   */
+  template <typename T>
+  Selection select(const RectangularLattice<T> &lattice) const;
+
+  /**
+   * Start a file of a lattice.
+   *
+   * \param[in] lattice Lattice to write.
+   * \param[in] selection Nodes of the lattice to write.
+   * \param[in] description Name of the quantity, beginning of the file name.
+   * \param[in] counter Number of the file of this quantity in the event.
+   * \return File without arrays.
+   */
+  template <typename T>
+  std::unique_ptr<VtkXmlFile> lattice_file(const RectangularLattice<T> &lattice,
+                                           const Selection &selection,
+                                           const std::string &description,
+                                           int counter) const;
+
+  /**
+   * Evaluate a quantity on the selected nodes of a lattice.
+   *
+   * \param[in] lattice Lattice to write.
+   * \param[in] selection Nodes of the lattice to write.
+   * \param[in] get_quantity Function of a node giving a number or a
+   *                         ThreeVector.
+   * \return Values at the selected nodes, x running fastest.
+   */
+  template <typename T, typename F>
+  static std::vector<double> evaluate(RectangularLattice<T> &lattice,
+                                      const Selection &selection,
+                                      F &&get_quantity);
+
+  /**
+   * Hand a file over to the writer thread, waiting while too many files are
+   * pending.
+   *
+   * \param[in] file File to write.
+   * \throw std::runtime_error if writing a previous file failed.
+   */
+  void submit(std::unique_ptr<VtkXmlFile> file);
+
+  /// Write the submitted files until stop_ is set and none is pending.
+  void write_loop();
+
+  /// Maximal number of files waiting to be written
+  static constexpr std::size_t max_pending_files = 4;
+
+  /// filesystem path for output
+  const std::filesystem::path base_path_;
+  /// Is the output a thermodynamics output
+  const bool is_thermodynamics_output_;
+  /// zlib compression level, 0 for uncompressed files
+  const int compression_level_;
+  /// Only every downsampling_-th lattice node in each direction is written
+  const int downsampling_;
+  /// Lower corner of the region of lattice nodes that are written [fm]
+  const std::array<double, 3> region_min_;
+  /// Upper corner of the region of lattice nodes that are written [fm]
+  const std::array<double, 3> region_max_;
+
+  /// Event number
+  int current_event_ = 0;
+  /// Number of particle outputs in current event
+  int particles_counter_ = 0;
+  /// Number of outputs per lattice quantity in current event
+  std::array<int, 5> lattice_counters_{};
+
+  /// Submitted files, oldest first
+  std::deque<std::unique_ptr<VtkXmlFile>> pending_;
+  /// Whether the writer thread is currently writing a file
+  bool writing_ = false;
+  /// Protects pending_, writing_, stop_ and error_
+  std::mutex mutex_;
+  /// Signals the writer thread that a file was submitted or it has to stop
+  std::condition_variable file_submitted_;
+  /// Signals the physics loop that a file has been written
+  std::condition_variable file_written_;
+  /// Whether the writer thread has to stop once all files are written
+  bool stop_ = false;
+  /// Exception thrown on the writer thread
+  std::exception_ptr error_;
+  /// Writer thread
+  std::thread writer_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_VTKXMLOUTPUT_H_
@@ -74,6 +74,13 @@ class WallCrossActionsFinder : public ActionFinderInterface {
     return {};
   }
 
+  /// Ignore the shifted neighbor searches for wall crossing
+  ActionList find_actions_with_shifted_neighbors(
+      const ParticleList &, const ThreeVector &, const ParticleList &, double,
+      const std::vector<FourVector> &) const override {
+    return {};
+  }
+
   /// Ignore the surrounding searches for wall crossing
   ActionList find_actions_with_surrounding_particles(
       const ParticleList &, const Particles &, double,
@@ -82,7 +89,7 @@ class WallCrossActionsFinder : public ActionFinderInterface {
   }
 
   /// No final actions for wall crossing
-  ActionList find_final_actions(const Particles &, bool) const override {
+  ActionList find_final_actions(const ParticleList &, bool) const override {
     return {};
   }
 
@@ -7,11 +7,13 @@
 
 #include "smash/isoparticletype.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <mutex>
 
-#include "smash/filelock.h"
 #include "smash/integrate.h"
 #include "smash/logging.h"
+#include "smash/parallel.h"
 
 namespace smash {
 static constexpr int LParticleType = LogArea::ParticleType::id;
@@ -178,9 +180,6 @@ void IsoParticleType::create_multiplet(const ParticleType &type) {
   multiplet.add_state(type);
 }
 
-static Integrator integrate;
-static Integrator2d integrate2d;
-
 /**
  * Tabulation of all N R integrals.
  *
@@ -216,93 +215,153 @@ static std::unordered_map<std::string, Tabulation> DeltaR_tabulations;
  */
 static std::unordered_map<std::string, Tabulation> rhoR_tabulations;
 
-static std::filesystem::path generate_tabulation_path(
-    const std::filesystem::path &dir, const std::string &prefix,
-    const std::string &res_name) {
-  return dir / (prefix + res_name + ".bin");
-}
+/// One spectral integral to be tabulated by IsoParticleType::tabulate_integrals
+struct IntegralTask {
+  /// Tabulations the result is stored in
+  std::unordered_map<std::string, Tabulation> *tabulations;
+  /// Multiplet of the first particle
+  const IsoParticleType *part;
+  /// Multiplet of the resonance
+  const IsoParticleType *res;
+  /// Anti-multiplet of the resonance, stored under the same integral
+  const IsoParticleType *antires;
+  /// Whether the first particle is unstable as well
+  bool unstable;
+  /// The tabulated integral
+  Tabulation integral;
+
+  /// \return Name of the integral in the tabulation bundle.
+  std::string name() const {
+    return part->name_filtered_prime() + res->name_filtered_prime();
+  }
+};
 
-inline void cache_integral(
-    std::unordered_map<std::string, Tabulation> &tabulations,
-    const std::filesystem::path &dir, sha256::Hash hash,
-    const IsoParticleType &part, const IsoParticleType &res,
-    const IsoParticleType *antires, bool unstable) {
+/// Serializes the progress messages of the tabulation threads
+static std::mutex progress_mutex;
+
+/**
+ * Calculate an integral.
+ *
+ * \param[inout] task The integral to tabulate.
+ * \param[inout] integrate Integrator of this thread.
+ * \param[inout] integrate2d Two-dimensional integrator of this thread.
+ */
+static void calculate_integral(IntegralTask &task, Integrator &integrate,
+                               Integrator2d &integrate2d) {
   constexpr double spacing = 2.0;
   constexpr double spacing2d = 3.0;
-  const auto path = generate_tabulation_path(dir, part.name_filtered_prime(),
-                                             res.name_filtered_prime());
-  Tabulation integral;
-  if (!dir.empty() && std::filesystem::exists(path)) {
-    std::ifstream file(path.string());
-    integral = Tabulation::from_file(file, hash);
-    if (!integral.is_empty()) {
-      // Only print message if the found tabulation was valid.
-      std::cout << "Tabulation found at " << path.filename() << '\r'
-                << std::flush;
-    }
-  }
-  if (integral.is_empty()) {
-    if (!dir.empty()) {
-      std::cout << "Caching tabulation to " << path.filename() << '\r'
-                << std::flush;
-    } else {
-      std::cout << "Calculating integral for " << part.name_filtered_prime()
-                << res.name_filtered_prime() << '\r' << std::flush;
-    }
-    if (!unstable) {
-      integral = spectral_integral_semistable(integrate, *res.get_states()[0],
-                                              *part.get_states()[0], spacing);
-    } else {
-      integral = spectral_integral_unstable(integrate2d, *res.get_states()[0],
-                                            *part.get_states()[0], spacing2d);
-    }
-    if (!dir.empty()) {
-      std::ofstream file(path.string());
-      integral.write(file, hash);
-    }
+  const IsoParticleType &part = *task.part;
+  const IsoParticleType &res = *task.res;
+  {
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    std::cout << "Calculating integral for " << task.name() << '\r'
+              << std::flush;
   }
-  tabulations.emplace(std::make_pair(res.name(), integral));
-  if (antires != nullptr) {
-    tabulations.emplace(std::make_pair(antires->name(), integral));
+  if (!task.unstable) {
+    task.integral = spectral_integral_semistable(
+        integrate, *res.get_states()[0], *part.get_states()[0], spacing);
+  } else {
+    task.integral = spectral_integral_unstable(
+        integrate2d, *res.get_states()[0], *part.get_states()[0], spacing2d);
   }
 }
 
 void IsoParticleType::tabulate_integrals(
     sha256::Hash hash, const std::filesystem::path &tabulations_path) {
-  // To avoid race conditions, make sure we are the only ones currently storing
-  // tabulations. Otherwise, we ignore any stored tabulations and don't store
-  // our results.
-  FileLock lock(tabulations_path / "tabulations.lock");
-  const std::filesystem::path &dir = lock.acquire() ? tabulations_path : "";
+  /* All integrals are cached in one bundle, which is read without locking and
+   * replaced atomically, so concurrent runs neither block nor see partially
+   * written tabulations. */
+  TabulationBundle bundle = tabulations_path.empty()
+                                ? TabulationBundle(hash)
+                                : TabulationBundle::read(tabulations_path, hash);
+  if (tabulate_integrals(bundle) > 0 && !tabulations_path.empty()) {
+    try {
+      bundle.publish(tabulations_path);
+    } catch (std::runtime_error &error) {
+      logg[LParticleType].warn(error.what(),
+                               " The integrals are not cached.");
+    }
+  }
+}
 
+std::size_t IsoParticleType::tabulate_integrals(TabulationBundle &bundle) {
   const auto nuc = IsoParticleType::try_find("N");
   const auto pion = IsoParticleType::try_find("π");
   const auto kaon = IsoParticleType::try_find("K");
   const auto delta = IsoParticleType::try_find("Δ");
   const auto rho = IsoParticleType::try_find("ρ");
   const auto h1 = IsoParticleType::try_find("h₁(1170)");
+  std::vector<IntegralTask> tasks;
   for (const auto &res : IsoParticleType::list_baryon_resonances()) {
     const auto antires = res->anti_multiplet();
     if (nuc) {
-      cache_integral(NR_tabulations, dir, hash, *nuc, *res, antires, false);
+      tasks.push_back({&NR_tabulations, nuc, res, antires, false, {}});
     }
     if (pion) {
-      cache_integral(piR_tabulations, dir, hash, *pion, *res, antires, false);
+      tasks.push_back({&piR_tabulations, pion, res, antires, false, {}});
     }
     if (kaon) {
-      cache_integral(RK_tabulations, dir, hash, *kaon, *res, antires, false);
+      tasks.push_back({&RK_tabulations, kaon, res, antires, false, {}});
     }
     if (delta) {
-      cache_integral(DeltaR_tabulations, dir, hash, *delta, *res, antires,
-                     true);
+      tasks.push_back({&DeltaR_tabulations, delta, res, antires, true, {}});
     }
   }
   if (rho) {
-    cache_integral(rhoR_tabulations, dir, hash, *rho, *rho, nullptr, true);
+    tasks.push_back({&rhoR_tabulations, rho, rho, nullptr, true, {}});
   }
   if (rho && h1) {
-    cache_integral(rhoR_tabulations, dir, hash, *rho, *h1, nullptr, true);
+    tasks.push_back({&rhoR_tabulations, rho, h1, nullptr, true, {}});
+  }
+
+  std::vector<IntegralTask *> missing;
+  for (IntegralTask &task : tasks) {
+    if (const Tabulation *cached = bundle.find(task.name())) {
+      task.integral = *cached;
+    } else {
+      missing.push_back(&task);
+    }
+  }
+  logg[LParticleType].info() << tasks.size() - missing.size() << " of "
+                             << tasks.size()
+                             << " integrals found in the tabulation bundle";
+
+  /* The spectral functions and decay widths initialize their normalizations
+   * and tabulations on first use, which must not happen concurrently. All
+   * unstable types are therefore evaluated once before the integrals are
+   * calculated in parallel. */
+  if (!missing.empty()) {
+    for (const ParticleType &type : ParticleType::list_all()) {
+      if (!type.is_stable()) {
+        type.spectral_function(type.mass());
+      }
+    }
+  }
+
+  /* The integrals differ a lot in their cost, so each thread takes the next
+   * pending one. Every thread has its own integrators, and the results are
+   * stored in the order of the tasks afterwards. */
+  const int n_threads = default_thread_count();
+  std::vector<Integrator> integrate(n_threads);
+  std::vector<Integrator2d> integrate2d(n_threads);
+  parallel_for(n_threads, missing.size(), 1,
+               [&](int i_thread, std::size_t i) {
+                 calculate_integral(*missing[i], integrate[i_thread],
+                                    integrate2d[i_thread]);
+               });
+
+  for (IntegralTask &task : tasks) {
+    task.tabulations->emplace(std::make_pair(task.res->name(), task.integral));
+    if (task.antires != nullptr) {
+      task.tabulations->emplace(
+          std::make_pair(task.antires->name(), task.integral));
+    }
+  }
+
+  for (const IntegralTask *task : missing) {
+    bundle.insert(task->name(), task->integral);
   }
+  return missing.size();
 }
 
 double IsoParticleType::get_integral_NR(double sqrts) {
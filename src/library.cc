@@ -9,18 +9,30 @@
 
 #include "smash/library.h"
 
+#include <cstddef>
 #include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
 
+#include "smash/action.h"
 #include "smash/configuration.h"
 #include "smash/decaymodes.h"
+#include "smash/deformednucleus.h"
+#include "smash/experiment.h"
 #include "smash/inputfunctions.h"
 #include "smash/isoparticletype.h"
 #include "smash/logging.h"
+#include "smash/parametrizations.h"
+#include "smash/particlesnapshot.h"
+#include "smash/profiler.h"
+#include "smash/scatteractionmulti.h"
 #include "smash/setup_particles_decaymodes.h"
 #include "smash/stringfunctions.h"
+#include "smash/stringprocess.h"
+#include "smash/tabulationbundle.h"
 
 namespace smash {
-static constexpr int LMain = LogArea::Main::id;
 
 static Configuration create_configuration(const std::string &,
                                           const std::vector<std::string> &);
@@ -29,11 +41,13 @@ static void fully_validate_configuration(const Configuration &);
 static void setup_logging(Configuration &);
 static void read_particles_and_decaymodes_files_setting_keys_in_configuration(
     const std::string &, const std::string &, Configuration &);
+static void disable_file_outputs(Configuration &);
 
 Configuration setup_config_and_logging(
     const std::string &config_file, const std::string &particles_file,
     const std::string &decaymodes_file,
     const std::vector<std::string> &extra_config) {
+  ScopedTimer timer(startup_profiler(), StartupStage::Configuration);
   Configuration configuration = create_configuration(config_file, extra_config);
   fully_validate_configuration(configuration);
   setup_logging(configuration);
@@ -49,9 +63,6 @@ void initialize_particles_decays_and_tabulations(
                     " create ParticleType and DecayModes");
   const std::string particles_string = configuration.take({"particles"});
   const std::string decaymodes_string = configuration.take({"decaymodes"});
-  ParticleType::create_type_list(particles_string);
-  DecayModes::load_decaymodes(decaymodes_string);
-  ParticleType::check_consistency();
 
   // Calculate a hash of the SMASH version, the particles and decaymodes.
   sha256::Context hash_context;
@@ -61,14 +72,78 @@ void initialize_particles_decays_and_tabulations(
   const auto hash = hash_context.finalize();
   logg[LMain].info() << "Config hash: " << sha256::hash_to_string(hash);
 
-  logg[LMain].info("Tabulating cross section integrals...");
   std::filesystem::path tabulations_path(tabulations_dir);
   if (!tabulations_path.empty()) {
     // Store tabulations on disk
     std::filesystem::create_directories(tabulations_path);
     logg[LMain].info() << "Tabulations path: " << tabulations_path;
   }
-  IsoParticleType::tabulate_integrals(hash, tabulations_path);
+
+  const bool use_snapshot =
+      configuration.take({"General", "Particle_Snapshot"}, false) &&
+      !tabulations_path.empty();
+  Profiler &profiler = startup_profiler();
+  {
+    ScopedTimer timer(profiler, StartupStage::ParticleTypes);
+    if (use_snapshot && ParticleSnapshot::read(tabulations_path, hash)) {
+      logg[LMain].info("Particles and decay modes read from the snapshot");
+    } else {
+      ParticleType::create_type_list(particles_string);
+      DecayModes::load_decaymodes(decaymodes_string);
+      ParticleType::check_consistency();
+      if (use_snapshot) {
+        try {
+          ParticleSnapshot::write(tabulations_path, hash);
+        } catch (std::runtime_error &error) {
+          logg[LMain].warn(error.what(), " The particles are not cached.");
+        }
+      }
+    }
+  }
+  /* All tabulations are cached in one bundle, which is read without locking
+   * and replaced atomically, so concurrent runs neither block nor see
+   * partially written tabulations. */
+  TabulationBundle bundle = tabulations_path.empty()
+                                ? TabulationBundle(hash)
+                                : TabulationBundle::read(tabulations_path, hash);
+  std::size_t n_tabulated = 0;
+  if (configuration.take({"General", "Precompute_Decay_Tabulations"}, true)) {
+    logg[LMain].info("Tabulating decay widths of unstable products...");
+    ScopedTimer timer(profiler, StartupStage::DecayTabulations);
+    n_tabulated += DecayModes::tabulate_decay_types(bundle);
+  }
+  {
+    logg[LMain].info("Tabulating cross section integrals...");
+    ScopedTimer timer(profiler, StartupStage::IntegralTabulations);
+    n_tabulated += IsoParticleType::tabulate_integrals(bundle);
+  }
+  {
+    logg[LMain].info("Tabulating three-body phase-space integrals...");
+    ScopedTimer timer(profiler, StartupStage::PhaseSpaceTabulations);
+    n_tabulated += ScatterActionMulti::tabulate_phase_space_integrals(bundle);
+  }
+  {
+    logg[LMain].info("Tabulating total and hadronic widths...");
+    ScopedTimer timer(profiler, StartupStage::WidthTabulations);
+    n_tabulated += DecayModes::tabulate_widths(bundle);
+  }
+  {
+    logg[LMain].info("Smoothing the data of the parametrizations...");
+    ScopedTimer timer(profiler, StartupStage::ParametrizationInterpolations);
+    n_tabulated += initialize_parametrization_interpolations(&bundle);
+  }
+  if (n_tabulated > 0 && !tabulations_path.empty()) {
+    try {
+      bundle.publish(tabulations_path);
+    } catch (std::runtime_error &error) {
+      logg[LMain].warn(error.what(), " The tabulations are not cached.");
+    }
+  }
+  StringProcess::set_pythia_init_cache(hash, tabulations_path);
+  DeformedNucleus::set_tabulation_cache(hash, tabulations_path);
+  logg[LMain].info("Tabulating spectral functions...");
+  ScopedTimer timer(profiler, StartupStage::SpectralFunctions);
+  ParticleType::tabulate_spectral_functions();
 }
 
 static Configuration create_configuration(
@@ -142,4 +217,123 @@ static void read_particles_and_decaymodes_files_setting_keys_in_configuration(
   }
 }
 
+
+/**
+ * \ingroup output
+ *
+ * Output passing the events of an experiment to an EventStream in memory.
+ *
+ * The final-state particles are not copied, the event refers to the ensembles
+ * of the experiment instead. Interactions are only copied if the history of
+ * the events is requested.
+ */
+class EventStreamOutput : public OutputInterface {
+ public:
+  /**
+   * Create the output.
+   *
+   * \param[out] event Event that is filled
+   * \param[in] collision_history Whether the interactions are recorded
+   */
+  EventStreamOutput(StreamedEvent *event, bool collision_history)
+      : OutputInterface("EventStream"),
+        event_(event),
+        collision_history_(collision_history) {}
+
+  /**
+   * Start a new event.
+   * \param[in] event_number Number of the event
+   */
+  void at_eventstart(const std::vector<Particles> &,
+                     const int event_number) override {
+    event_->number = event_number;
+    event_->ensembles = nullptr;
+    event_->info.clear();
+    event_->history.clear();
+  }
+
+  /**
+   * Keep the info of an ensemble at the end of the event.
+   * \param[in] info Event info of the ensemble
+   */
+  void at_eventend(const Particles &, const int,
+                   const EventInfo &info) override {
+    event_->info.push_back(info);
+  }
+
+  /**
+   * Refer to the final-state particles of the ensembles.
+   * \param[in] ensembles Particles of all ensembles
+   */
+  void at_eventend(const std::vector<Particles> &ensembles,
+                   const int) override {
+    event_->ensembles = &ensembles;
+  }
+
+  /**
+   * Record an interaction in the history, if requested.
+   * \param[in] action Action that holds the information of the interaction
+   * \param[in] density Density at the interaction point
+   * \param[in] i_ensemble Ensemble of the action
+   */
+  void at_ensemble_interaction(const Action &action, const double density,
+                               const int i_ensemble) override {
+    if (collision_history_) {
+      event_->history.push_back({i_ensemble, action.get_type(),
+                                 action.time_of_execution(), density,
+                                 action.incoming_particles(),
+                                 action.outgoing_particles()});
+    }
+  }
+
+ private:
+  /// Event filled by this output
+  StreamedEvent *event_;
+  /// Whether the interactions are recorded
+  bool collision_history_;
+};
+
+/* The setup of experiments is not thread-safe, so the streams are created one
+ * after the other, even if they are used on several threads. */
+static std::mutex event_stream_setup_mutex;
+
+EventStream::EventStream(Configuration &config, bool collision_history,
+                         int first_event, int event_stride) {
+  disable_file_outputs(config);
+  {
+    std::lock_guard<std::mutex> lock(event_stream_setup_mutex);
+    // Nothing is written, so any existing directory will do.
+    experiment_ = ExperimentBase::create(
+        config, std::filesystem::temp_directory_path());
+    initialize_lazy_caches();
+  }
+  experiment_->add_output(
+      std::make_unique<EventStreamOutput>(&event_, collision_history),
+      "EventStream");
+  experiment_->begin_events(first_event, event_stride);
+}
+
+EventStream::~EventStream() = default;
+
+bool EventStream::next() { return experiment_->run_next_event(); }
+
+/**
+ * Set the formats of all outputs in the configuration to "None".
+ *
+ * \param[inout] config Configuration of the experiment
+ */
+static void disable_file_outputs(Configuration &config) {
+  if (!config.has_value({"Output"})) {
+    return;
+  }
+  YAML::Node outputs = YAML::Load(
+      config.extract_sub_configuration({"Output"}).to_string());
+  for (auto content : outputs) {
+    if (content.second.IsMap() && content.second["Format"]) {
+      content.second["Format"] = std::vector<std::string>{"None"};
+    }
+  }
+  config.set_value({"Output"}, outputs);
+}
+
 }  // namespace smash
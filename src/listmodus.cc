@@ -9,14 +9,24 @@
 
 #include "smash/listmodus.h"
 
+#include <array>
+#include <cctype>
+#include <cfloat>
 #include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
+#include <deque>
+#include <exception>
 #include <filesystem>
-#include <fstream>
+#include <functional>
 #include <list>
 #include <map>
-#include <sstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -29,12 +39,115 @@
 #include "smash/inputfunctions.h"
 #include "smash/logging.h"
 #include "smash/particledata.h"
+#include "smash/stringfunctions.h"
 #include "smash/threevector.h"
 #include "smash/wallcrossingaction.h"
 
 namespace smash {
 static constexpr int LList = LogArea::List::id;
 
+namespace {
+/// Initial state of an event read ahead of time
+struct PrefetchedEvent {
+  /// Particles of the event
+  ParticleList particles;
+  /// Starting time of the simulation
+  double start_time = 0.;
+  /// Exception thrown while reading the event
+  std::exception_ptr error;
+};
+}  // namespace
+
+/**
+ * Thread reading the coming events from the files, which keeps up to
+ * ListModus::prefetch_depth_ of them in a queue.
+ */
+struct ListModus::EventPipeline {
+  /**
+   * Start reading events.
+   *
+   * \param[in] modus Modus whose files are read by the thread from now on.
+   */
+  explicit EventPipeline(ListModus &modus)
+      : thread([this, &modus]() { read(modus); }) {}
+  /// Stop the thread, dropping the events not taken
+  ~EventPipeline() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    taken.notify_all();
+    thread.join();
+  }
+
+  /**
+   * Read events until stopped or until one fails.
+   *
+   * \param[in] modus Modus whose files are read.
+   */
+  void read(ListModus &modus) {
+    const std::size_t depth = modus.prefetch_depth_;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        taken.wait(lock, [&] { return stop || events.size() < depth; });
+        if (stop) {
+          return;
+        }
+      }
+      PrefetchedEvent event;
+      try {
+        Particles particles;
+        event.start_time = modus.read_initial_state_(&particles);
+        event.particles = particles.copy_to_vector();
+      } catch (...) {
+        event.error = std::current_exception();
+      }
+      const bool failed = static_cast<bool>(event.error);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(std::move(event));
+      }
+      read_one.notify_one();
+      if (failed) {
+        return;
+      }
+    }
+  }
+
+  /// \return The next event, waiting until it is read.
+  PrefetchedEvent take() {
+    std::unique_lock<std::mutex> lock(mutex);
+    read_one.wait(lock, [this] { return !events.empty(); });
+    PrefetchedEvent event = std::move(events.front());
+    events.pop_front();
+    lock.unlock();
+    taken.notify_one();
+    return event;
+  }
+
+  /// Protects events and stop
+  std::mutex mutex;
+  /// Signalled when an event was read
+  std::condition_variable read_one;
+  /// Signalled when an event was taken or the thread has to stop
+  std::condition_variable taken;
+  /// Events read in the order of the files
+  std::deque<PrefetchedEvent> events;
+  /// Whether the thread has to stop
+  bool stop = false;
+  /// The reading thread, started after all other members exist
+  std::thread thread;
+};
+
+ListModus::ListModus() = default;
+
+ListModus::~ListModus() = default;
+
+ListModus::ListModus(ListModus &&) = default;
+
+ListModus &ListModus::operator=(ListModus &&) = default;
+
 ListModus::ListModus(Configuration modus_config,
                      const ExperimentParameters &param)
     : file_id_{std::nullopt}, event_id_{0} {
@@ -60,6 +173,11 @@ ListModus::ListModus(Configuration modus_config,
     key_to_take = "File_Prefix";
     file_id_ = plain_config.take({"Shift_Id"}, 0);
   }
+  prefetch_depth_ = plain_config.take({"Prefetch_Initial_States"}, 0);
+  if (prefetch_depth_ < 0) {
+    throw std::invalid_argument(
+        "The number of prefetched initial states must not be negative.");
+  }
   particle_list_filename_or_prefix_ =
       plain_config.take({key_to_take.c_str()})
           .convert_for(particle_list_filename_or_prefix_);
@@ -131,34 +249,124 @@ void ListModus::try_create_particle(Particles &particles, PdgCode pdgcode,
   }
 }
 
+/**
+ * Read the quantities of a particle line of a text particle list, in the
+ * order t x y z mass p0 px py pz pdg ID charge. The ID is not needed.
+ *
+ * \param[in] text Null-terminated line without comments
+ * \param[out] reals Where to store the nine real quantities
+ * \param[out] pdg_string PDG code as written in the line
+ * \param[out] charge Electric charge
+ * \return Whether all quantities could be read.
+ */
+static bool parse_particle_line(const char *text, std::array<double, 9> &reals,
+                                std::string &pdg_string, int &charge) {
+  char *end = nullptr;
+  for (double &real : reals) {
+    real = std::strtod(text, &end);
+    if (end == text) {
+      return false;
+    }
+    text = end;
+  }
+  while (std::isspace(static_cast<unsigned char>(*text))) {
+    text++;
+  }
+  const char *pdg_begin = text;
+  while (*text != '\0' && !std::isspace(static_cast<unsigned char>(*text))) {
+    text++;
+  }
+  pdg_string.assign(pdg_begin, text);
+  std::strtol(text, &end, 10);
+  if (pdg_string.empty() || end == text) {
+    return false;
+  }
+  text = end;
+  charge = static_cast<int>(std::strtol(text, &end, 10));
+  return end != text;
+}
+
 /* initial_conditions - sets particle data for @particles */
 double ListModus::initial_conditions(Particles *particles,
                                      const ExperimentParameters &) {
-  std::string particle_list = next_event_();
-  for (const Line &line : line_parser(particle_list)) {
-    std::istringstream lineinput(line.text);
-    double t, x, y, z, mass, E, px, py, pz;
-    int id, charge;
-    std::string pdg_string;
-    lineinput >> t >> x >> y >> z >> mass >> E >> px >> py >> pz >>
-        pdg_string >> id >> charge;
-    if (lineinput.fail()) {
-      throw LoadFailure(
-          build_error_string("While loading external particle lists data:\n"
-                             "Failed to convert the input string to the "
-                             "expected data types.",
-                             line));
+  return read_initial_state_(particles);
+}
+
+double ListModus::take_prefetched_initial_state(
+    int, int, const std::function<int64_t(int)> &,
+    std::vector<Particles> *ensembles) {
+  if (!pipeline_) {
+    pipeline_ = std::make_unique<EventPipeline>(*this);
+  }
+  PrefetchedEvent event = pipeline_->take();
+  if (event.error) {
+    pipeline_.reset();
+    std::rethrow_exception(event.error);
+  }
+  for (const ParticleData &p : event.particles) {
+    ensembles->front().insert(p);
+  }
+  return event.start_time;
+}
+
+double ListModus::read_initial_state_(Particles *particles) {
+  if (current_file_is_binary_()) {
+    for (const BinaryParticleLine &line : next_binary_event_()) {
+      const PdgCode pdgcode = PdgCode::from_decimal(line.pdg);
+      if (pdgcode.charge() != line.charge) {
+        logg[LList].error()
+            << "Charge of pdg = " << pdgcode << " != " << line.charge;
+        throw std::invalid_argument("Inconsistent input (charge).");
+      }
+      try_create_particle(*particles, pdgcode, line.position.x0(),
+                          line.position.x1(), line.position.x2(),
+                          line.position.x3(), line.mass, line.momentum.x0(),
+                          line.momentum.x1(), line.momentum.x2(),
+                          line.momentum.x3());
     }
-    PdgCode pdgcode(pdg_string);
-    logg[LList].debug("Particle ", pdgcode, " (x,y,z)= (", x, ", ", y, ", ", z,
-                      ")");
-
-    // Charge consistency check
-    if (pdgcode.charge() != charge) {
-      logg[LList].error() << "Charge of pdg = " << pdgcode << " != " << charge;
-      throw std::invalid_argument("Inconsistent input (charge).");
+  } else {
+    const std::string_view particle_list = next_event_();
+    // Buffer for the current line, reused to avoid reallocations
+    std::string text;
+    int line_number = 0;
+    std::size_t offset = 0;
+    while (offset < particle_list.size()) {
+      std::size_t line_end = particle_list.find('\n', offset);
+      if (line_end == std::string_view::npos) {
+        line_end = particle_list.size();
+      }
+      std::string_view line = particle_list.substr(offset, line_end - offset);
+      offset = line_end + 1;
+      ++line_number;
+      line = line.substr(0, line.find('#'));
+      if (line.find_first_not_of(" \t") == std::string_view::npos) {
+        continue;
+      }
+      text.assign(line);
+      std::array<double, 9> reals;
+      int charge;
+      std::string pdg_string;
+      if (!parse_particle_line(text.c_str(), reals, pdg_string, charge)) {
+        throw LoadFailure(
+            build_error_string("While loading external particle lists data:\n"
+                               "Failed to convert the input string to the "
+                               "expected data types.",
+                               Line(line_number, trim(text))));
+      }
+      const auto [t, x, y, z, mass, E, px, py, pz] = reals;
+      PdgCode pdgcode(pdg_string);
+      logg[LList].debug("Particle ", pdgcode, " (x,y,z)= (", x, ", ", y, ", ",
+                        z, ")");
+
+      // Charge consistency check
+      if (pdgcode.charge() != charge) {
+        logg[LList].error()
+            << "Charge of pdg = " << pdgcode << " != " << charge;
+        throw std::invalid_argument("Inconsistent input (charge).");
+      }
+      try_create_particle(*particles, pdgcode, t, x, y, z, mass, E, px, py,
+                          pz);
     }
-    try_create_particle(*particles, pdgcode, t, x, y, z, mass, E, px, py, pz);
   }
   if (particles->size() > 0) {
     backpropagate_to_same_time(*particles);
@@ -195,17 +403,14 @@ std::filesystem::path ListModus::file_path_(std::optional<int> file_id) {
   return fpath;
 }
 
-std::string ListModus::next_event_() {
-  const std::filesystem::path fpath = file_path_(file_id_);
-  std::ifstream ifs{fpath};
-  ifs.seekg(last_read_position_);
-
-  if (!file_has_events_(fpath, last_read_position_)) {
+std::string_view ListModus::next_event_() {
+  if (next_event_in_file_ >= text_reader_->n_events()) {
     if (file_id_) {
-      // Get next file and call this function recursively
+      // Map the next file and call this function recursively
       (*file_id_)++;
-      last_read_position_ = 0;
-      ifs.close();
+      text_reader_ =
+          std::make_shared<TextParticleListReader>(file_path_(file_id_));
+      next_event_in_file_ = 0;
       return next_event_();
     } else {
       throw std::runtime_error(
@@ -213,62 +418,38 @@ std::string ListModus::next_event_() {
           "data found in single provided file. Please, check your setup.");
     }
   }
+  return text_reader_->event(next_event_in_file_++);
+}
 
-  // read one event. events marked by line # event end i in case of Oscar
-  // output. Assume one event per file for all other output formats
-  std::string event_string;
-  const std::string needle = "end";
-  std::string line;
-  while (getline(ifs, line)) {
-    if (line.find(needle) == std::string::npos) {
-      event_string += line + "\n";
+bool ListModus::current_file_is_binary_() {
+  if (!binary_reader_ && !text_reader_) {
+    const std::filesystem::path fpath = file_path_(file_id_);
+    if (BinaryParticleListReader::is_binary_file(fpath)) {
+      binary_reader_ = std::make_shared<BinaryParticleListReader>(fpath);
     } else {
-      break;
+      text_reader_ = std::make_shared<TextParticleListReader>(fpath);
     }
+    next_event_in_file_ = 0;
   }
-
-  if (!ifs.eof() && (ifs.fail() || ifs.bad())) {
-    logg[LList].fatal() << "Error while reading " << fpath.filename().native();
-    throw std::runtime_error("Error while reading external particle list");
-  }
-  // save position for next event read
-  last_read_position_ = ifs.tellg();
-  ifs.close();
-
-  return event_string;
+  return static_cast<bool>(binary_reader_);
 }
 
-bool ListModus::file_has_events_(std::filesystem::path filepath,
-                                 std::streampos last_position) {
-  std::ifstream ifs{filepath};
-  std::string line;
-
-  // last event read read at end of file. we know this because errors are
-  // handled in next_event
-  if (last_position == -1) {
-    return false;
-  }
-  ifs.seekg(last_position);
-  // skip over comment lines, assume that a max. of four consecutive comment
-  // lines can occur
-  int skipped_lines = 0;
-  const int max_comment_lines = 4;
-  while (std::getline(ifs, line) && line[0] != '#' &&
-         skipped_lines++ < max_comment_lines) {
-  }
-
-  if (ifs.eof()) {
-    return false;
-  }
-
-  if (!ifs.good()) {
-    logg[LList].fatal() << "Error while reading "
-                        << filepath.filename().native();
-    throw std::runtime_error("Error while reading external particle list");
+std::vector<BinaryParticleLine> ListModus::next_binary_event_() {
+  if (next_event_in_file_ >= binary_reader_->n_events()) {
+    if (file_id_) {
+      // Map the next file and call this function recursively
+      (*file_id_)++;
+      binary_reader_ =
+          std::make_shared<BinaryParticleListReader>(file_path_(file_id_));
+      next_event_in_file_ = 0;
+      return next_binary_event_();
+    } else {
+      throw std::runtime_error(
+          "Attempt to read in next event in Listmodus object but no further "
+          "data found in single provided file. Please, check your setup.");
+    }
   }
-
-  ifs.close();
-  return true;
+  return binary_reader_->read_event(next_event_in_file_++);
 }
 
 ListBoxModus::ListBoxModus(Configuration modus_config,
@@ -36,7 +36,9 @@ void set_default_loglevel(einhard::LogLevel level) {
  * \endcode
  * For further documentation see `logging.h`.
  */
-std::array<einhard::Logger<>, std::tuple_size<LogArea::AreaTuple>::value> logg;
+std::array<einhard::Logger<compiled_min_loglevel>,
+           std::tuple_size<LogArea::AreaTuple>::value>
+    logg;
 
 /**
  * \internal
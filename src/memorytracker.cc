@@ -0,0 +1,83 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/memorytracker.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "smash/iomanipulators.h"
+
+namespace smash {
+
+namespace {
+/// Bytes per MiB
+constexpr double mebibyte = 1024. * 1024.;
+}  // unnamed namespace
+
+std::atomic<bool> MemoryTracker::enabled_{false};
+
+std::array<MemoryTracker::Counter, MemoryTracker::n_subsystems>
+    MemoryTracker::counters_;
+
+void MemoryTracker::add(MemorySubsystem subsystem, int64_t bytes) {
+  Counter &c = counter(subsystem);
+  const int64_t current =
+      c.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  int64_t peak = c.peak.load(std::memory_order_relaxed);
+  while (peak < current && !c.peak.compare_exchange_weak(
+                               peak, current, std::memory_order_relaxed)) {
+  }
+}
+
+int64_t MemoryTracker::resident_bytes() {
+  // The second entry of statm is the number of resident pages.
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0, resident = 0;
+  if (!(statm >> size >> resident)) {
+    return 0;
+  }
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+int64_t MemoryTracker::peak_resident_bytes() {
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  // in kilobytes on Linux
+  return int64_t{1024} * usage.ru_maxrss;
+#endif
+}
+
+std::string MemoryTracker::report() {
+  constexpr std::array<const char *, n_subsystems> names = {
+      "Particles", "Lattices", "Actions", "Outputs", "String processes"};
+  std::ostringstream ss;
+  ss << std::left << std::setw(20) << "Memory [MiB]" << std::right
+     << std::setw(12) << "current" << std::setw(12) << "peak" << "\n";
+  auto row = [&ss](const char *name, int64_t current, int64_t peak) {
+    ss << std::left << std::setw(20) << name << std::right << field<12, 1>
+       << current / mebibyte << field<12, 1> << peak / mebibyte << "\n";
+  };
+  for (std::size_t i = 0; i < n_subsystems; i++) {
+    row(names[i], counters_[i].current, counters_[i].peak);
+  }
+  row("Resident (process)", resident_bytes(), peak_resident_bytes());
+  return ss.str();
+}
+
+}  // namespace smash
@@ -6,10 +6,13 @@
  */
 #include "smash/nucleus.h"
 
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <sstream>
 #include <string>
 
 #include "smash/angles.h"
@@ -50,6 +53,12 @@ Nucleus::Nucleus(Configuration &config, int nTest) {
         "parameters automatically configures the "
         "distribution based on the atomic number.");
   }
+  if (config.has_value({"Library"})) {
+    const int library_size = config.take({"Library", "Size"}, 0);
+    const std::string library_file =
+        config.take({"Library", "File"}, std::string{});
+    use_configuration_library(library_size, library_file);
+  }
 }
 
 double Nucleus::mass() const {
@@ -85,132 +94,22 @@ double Nucleus::mass() const {
  * \f[\frac{dN}{4\pi\rho_0dr} =
  * \frac{r^2}{\exp\left(\frac{r-r_0}{d}\right) + 1}.\f]
  *
- * Let us rewrite that in units of \f$d\f$ (that's the diffusiveness)
- * and drop any constraints on normalization (since in the end we only
- * care about relative probabilities: we create as many nucleons as we
- * need). Now, \f$p(B)\f$ is the un-normalized probability to obtain a
- * point at \f$r = Bd\f$ (with \f$R = r_0/d\f$):
- *
- * \f[p(B) = \frac{B^2}{\exp(B-R) + 1}.\f]
- *
- * Splitting it up in two regimes
- * ------------------------------
- *
- * We shift the distribution so that \f$B-R\f$ is 0 at \f$t = 0\f$: \f$t
- * = B-R\f$:
- *
- * \f[p^{(1)}(t)= \frac{(t+R)^2}{\exp(t)+1}\f]
- *
- * and observe
- *
- * \f[\frac{1}{\exp(x)+1} = \frac{e^{-x}}{e^{-x}e^{x}+e^{-x}} =
- * \frac{e^{-x}}{e^{-x}+1}.\f]
- *
- * The distribution function can now be split into two cases. For
- * negative t (first case), \f$-|t| = t\f$, and for positive t (second
- * case), \f$-|t| = -t\f$:
- *
- * \f[p^{(1)}(t) = \frac{1}{e^{-|t|}+1} \cdot (t+R)^2 \cdot
- * \begin{cases}
- * 1 & -R \le t < 0 \\
- * e^{-t} & t \ge 0
- * \end{cases}.\f]
- *
- * Apart from the first term, all that remains here can easily and
- * exactly be generated from unrejected uniform random numbers (see
- * below). The first term itself - \f$(1+e^{-|t|})^{-1}\f$ - is a number
- * between 1/2 and 1.
- *
- * If we now have a variable \f$t\f$ distributed according to the
- * remainder, \f$p^{(2)}(t)\f$, and reject \f$t\f$ with a probability
- * \f$p^{(rej)}(t) = 1 - p^{(survive)}(t) = 1 - (1+e^{-|t|})^{-1}\f$,
- * the resulting distribution is \f$p^{(combined)}(t) = p^{(2)}(t) \cdot
- * p^{(survive)}(t)\f$. Hence, we need to generate \f$p^{(2)}(t)\f$,
- * which we can normalize to
- *
- * \f[\tilde{p}^{(2)}(t) = \frac{1}{1+3/R+6/R^2+6/R^3} \cdot \begin{cases}
- * \frac{3}{R^3} (t+R)^2 & -R \le t < 0 \\
- * e^{-t} \left( \frac{3}{R}+\frac{6}{R^2}t+\frac{6}{R^3}\frac{1}{2}t^2 \right)
- * & t \ge 0 \end{cases}.\f]
- *
- * (the tilde \f$\tilde{p}\f$ means that this is normalized).
- *
- * Four parts inside the rejection
- * -------------------------------
- *
- * Let \f$c_1 = 1+3/R+6/R^2+6/R^3\f$. The above means:
- *
- * \f[\mbox{Choose: } \begin{cases}
- * \tilde p^{({\rm I})} = \frac{3}{R^3}(t+R)^2 \Theta(-t) \Theta(t+R) \\
- * \tilde p^{({\rm II})}= e^{-t}\Theta(t) \\
- * \tilde p^{({\rm III})}=e^{-t}\Theta(t) t \\
- * \tilde p^{({\rm IV})} =e^{-t}\Theta(t) \frac{1}{2} t^2
- * \end{cases} \mbox{ with a probability of }\begin{cases}
- * \frac{1}{c_1} \cdot 1 \\
- * \frac{1}{c_1} \cdot \frac{3}{R} \\
- * \frac{1}{c_1} \cdot \frac{6}{R^2} \\
- * \frac{1}{c_1} \cdot \frac{6}{R^3}
- * \end{cases}.\f]
- *
- * Let us see how those are generated. \f$\chi_i\f$ are uniformly
- * distributed numbers between 0 and 1.
- *
- * \f[p(\chi_i) = \Theta(\chi_i)\Theta(1-\chi_i)\f]
- *
- * For simple distributions (only one \f$\chi\f$ involved), we invert
- * \f$t(\chi)\f$, derive it w.r.t. \f$t\f$ and normalize.
+ * Sampling from tabulated quantiles
+ * ---------------------------------
  *
- * ### Case I: \f$p^{({\rm I})}\f$
+ * With \f$s = r^3\f$, the volume element is \f$r^2 dr = ds/3\f$, so that
+ * \f$s\f$ is distributed according to the density profile itself,
  *
- * Simply from one random number:
- *
- * \f[t = R\left( \sqrt[ 3 ]{\chi} - 1 \right)\f]
- * \f[\tilde p^{({\rm I})} = \frac{3}{R^3}(t+R)^2 \mbox{ for } -R \le t
- * \le 0\f]
- *
- * ### Case II: \f$p^{({\rm II})}\f$
- *
- * Again, from one only:
- *
- * \f[t = -\log(\chi)\f]
- * \f[p(t) = \frac{d\chi}{dt}\f]
- * \f[p^{({\rm II})} = e^{-t} \mbox{ for } t > 0\f]
- *
- * ### Case III: \f$p^{({\rm III})}\f$
- *
- * Here, we need two variables:
- *
- * \f[t = -\log{\chi_1} -\log{\chi_2}\f]
- *
- * \f$p^{({\rm III})}\f$ is now the folding of \f$p^{({\rm II})}\f$ with
- *itself[1]:
- *
- * \f[p^{({\rm III})} = \int_{-\infty}^{\infty} d\tau e^{-\tau} e^{-(t-\tau)}
- * \Theta(\tau) \Theta(t-\tau) = t e^{-t} \mbox{ for } t > 0\f]
- *
- * ### Case IV: \f$p^{({\rm IV})}\f$
- *
- * Three variables needed:
- *
- * \f[t = -\log{\chi_1} -\log{\chi_2} -\log{\chi_3}\f]
- *
- * \f$p^{({\rm IV})}\f$ is now the folding of \f$p^{({\rm II})}\f$ with
- * \f$p^{({\rm III})}\f$:
- *
- * \f[p^{({\rm IV})} = \int_{ - \infty}^{\infty} d\tau e^{- \tau} \left(
- * t - \tau \right) e^{ - (t - \tau)} \Theta(\tau) \Theta(t - \tau) =
- * \frac{1}{2} t^2 e^{ -t} \mbox{ for } t > 0\f]
- *
- * [1]: This is [the probability to find a \f$\tau\f$] times [the
- * probability to find the value \f$\tau_2 = t-\tau\f$ that added to
- * \f$\tau\f$ yields \f$t\f$], integrated over all possible combinations
- * that have that property.
- *
- * From the beginning
- * ------------------
- *
- *  So, the algorithm needs to do all this from the end:
+ * \f[\frac{dN}{ds} \propto \frac{1}{\exp\left(\frac{s^{1/3}-r_0}{d}\right)
+ * + 1},\f]
  *
+ * which is bounded and smooth, also at the center. Its cumulative
+ * distribution \f$F(s)\f$ is integrated numerically up to \f$r_0 + 20 d\f$,
+ * where the density is negligible, and inverted on a grid of the cumulative
+ * probability. A uniform random number \f$u\f$ then gives the radius
+ * \f$r = \left(F^{-1}(u)\right)^{1/3}\f$ with linear interpolation of the
+ * table and without any rejection. The table only depends on \f$r_0\f$ and
+ * \f$d\f$, so it is built once and reused for all nucleons of all events.
  */
 ThreeVector Nucleus::distribute_nucleon() {
   // Get the solid angle of the nucleon.
@@ -223,39 +122,20 @@ ThreeVector Nucleus::distribute_nucleon() {
   if (almost_equal(nuclear_radius_, 0.)) {
     return smash::ThreeVector();
   }
-  double radius_scaled = nuclear_radius_ / diffusiveness_;
-  double prob_range1 = 1.0;
-  double prob_range2 = 3. / radius_scaled;
-  double prob_range3 = 2. * prob_range2 / radius_scaled;
-  double prob_range4 = 1. * prob_range3 / radius_scaled;
-  double ranges234 = prob_range2 + prob_range3 + prob_range4;
-  double t;
-  /// \li Decide which branch \f$\tilde p^{({\rm I - IV})}\f$ to go into
-  do {
-    double which_range = random::uniform(-prob_range1, ranges234);
-    if (which_range < 0.0) {
-      t = radius_scaled * (std::cbrt(random::canonical()) - 1.);
-    } else {
-      t = -std::log(random::canonical());
-      if (which_range >= prob_range2) {
-        t -= std::log(random::canonical());
-        if (which_range >= prob_range2 + prob_range3) {
-          t -= std::log(random::canonical());
-        }
-      }
-    }
-    /**
-     * \li Generate \f$t\f$ from the distribution in the respective
-     * branches
-     * \li \a Reject that number with a probability
-     * \f$1-(1+\exp(-|t|))^{-1}\f$ (the efficiency of this should be
-     * \f$\gg \frac{1}{2}\f$)
-     */
-  } while (random::canonical() > 1. / (1. + std::exp(-std::abs(t))));
-  /// \li Shift and rescale \f$t\f$ to \f$r = d\cdot t + r_0\f$
-  double position_scaled = t + radius_scaled;
-  double position = position_scaled * diffusiveness_;
-  return dir.threevec() * position;
+  // Sample s = r^3 from its tabulated quantiles, see above.
+  const std::array<double, 2> parameters = {nuclear_radius_, diffusiveness_};
+  if (radial_inverse_cdf_.is_empty() ||
+      parameters != radial_inverse_cdf_parameters_) {
+    // The density is negligible 20 diffusivenesses beyond the radius.
+    const double r_max = nuclear_radius_ + 20. * diffusiveness_;
+    radial_inverse_cdf_ =
+        Tabulation::inverse_cdf(0., r_max * r_max * r_max, [this](double s) {
+          return Nucleus::nucleon_density_unnormalized(std::cbrt(s), 0., 0.);
+        });
+    radial_inverse_cdf_parameters_ = parameters;
+  }
+  const double s = radial_inverse_cdf_.get_value_linear(random::canonical());
+  return dir.threevec() * std::cbrt(s);
 }
 
 double Nucleus::woods_saxon(double r) {
@@ -263,6 +143,119 @@ double Nucleus::woods_saxon(double r) {
 }
 
 void Nucleus::arrange_nucleons() {
+  if (library_size_ > 0) {
+    if (library_.empty()) {
+      sample_library();
+    }
+    library_index_ = random::uniform_int<std::size_t>(0, library_size_ - 1);
+    const LibraryNucleon *configuration = &library_[library_index_ * size()];
+    for (auto i = begin(); i != end(); i++, configuration++) {
+      i->set_4momentum(i->pole_mass(), 0.0, 0.0, 0.0);
+      i->set_4position(FourVector(0.0, configuration->position));
+    }
+    rotate_configuration();
+    return;
+  }
+  sample_positions();
+  rotate();
+}
+
+void Nucleus::use_configuration_library(int size, const std::string &file) {
+  library_.clear();
+  library_file_.clear();
+  if (!file.empty() && std::filesystem::exists(file)) {
+    read_library(file);
+    logg[LNucleus].info("Read ", library_size_,
+                        " nucleon configurations from ", file, ".");
+    return;
+  }
+  if (size <= 0) {
+    throw std::invalid_argument(
+        "The library of nucleon configurations needs a positive Size, unless "
+        "it is read from an existing File.");
+  }
+  library_size_ = size;
+  library_file_ = file;
+}
+
+void Nucleus::rotate_configuration() {
+  random_euler_angles();
+  for (ParticleData &particle : particles_) {
+    ThreeVector position = particle.position().threevec();
+    position.rotate(euler_phi_, euler_theta_, euler_psi_);
+    particle.set_3position(position);
+  }
+}
+
+void Nucleus::sample_library() {
+  const std::size_t A = size();
+  library_.reserve(library_size_ * A);
+  for (std::size_t i_config = 0; i_config < library_size_; i_config++) {
+    sample_positions();
+    sample_fermi_momenta();
+    for (const ParticleData &particle : particles_) {
+      library_.push_back(
+          {particle.position().threevec(), particle.momentum().threevec()});
+    }
+  }
+  logg[LNucleus].info("Sampled ", library_size_, " nucleon configurations.");
+  if (library_file_.empty()) {
+    return;
+  }
+  std::ofstream out(library_file_);
+  out.precision(std::numeric_limits<double>::max_digits10);
+  for (std::size_t i = 0; i < library_.size(); i++) {
+    const LibraryNucleon &nucleon = library_[i];
+    const bool is_proton = particles_[i % A].pdgcode() == pdg::p;
+    out << nucleon.position.x1() << ' ' << nucleon.position.x2() << ' '
+        << nucleon.position.x3() << " 0 " << is_proton << ' '
+        << nucleon.momentum.x1() << ' ' << nucleon.momentum.x2() << ' '
+        << nucleon.momentum.x3() << '\n';
+  }
+  out.close();
+  if (!out) {
+    throw std::runtime_error("Cannot write the nucleon configurations to " +
+                             library_file_ + ".");
+  }
+}
+
+void Nucleus::read_library(const std::string &file) {
+  std::ifstream in(file);
+  const std::size_t A = size();
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
+    }
+    std::istringstream iss(line);
+    LibraryNucleon nucleon;
+    double x, y, z, px, py, pz;
+    int spin_projection, isospin;
+    if (!(iss >> x >> y >> z >> spin_projection >> isospin >> px >> py >>
+          pz)) {
+      throw std::runtime_error(
+          "Cannot read line " + std::to_string(library_.size() + 1) + " of " +
+          file + ", expected: x y z spinprojection isospin px py pz");
+    }
+    const bool is_proton = particles_[library_.size() % A].pdgcode() == pdg::p;
+    if (isospin != static_cast<int>(is_proton)) {
+      throw std::runtime_error("The isospin in line " +
+                               std::to_string(library_.size() + 1) + " of " +
+                               file + " does not match the nucleus.");
+    }
+    nucleon.position = ThreeVector(x, y, z);
+    nucleon.momentum = ThreeVector(px, py, pz);
+    library_.push_back(nucleon);
+  }
+  if (library_.empty() || library_.size() % A != 0) {
+    throw std::runtime_error(
+        "The number of nucleons in " + file +
+        " is not a positive multiple of the mass number of the nucleus.");
+  }
+  library_size_ = library_.size() / A;
+}
+
+void Nucleus::sample_positions() {
   for (auto i = begin(); i != end(); i++) {
     // Initialize momentum
     i->set_4momentum(i->pole_mass(), 0.0, 0.0, 0.0);
@@ -274,9 +267,8 @@ void Nucleus::arrange_nucleons() {
     i->set_4position(FourVector(0.0, pos));
   }
 
-  // Recenter and rotate
+  // Recenter
   align_center();
-  rotate();
 }
 
 void Nucleus::set_parameters_automatic() {
@@ -346,6 +338,19 @@ void Nucleus::set_parameters_from_config(Configuration &config) {
 }
 
 void Nucleus::generate_fermi_momenta() {
+  if (!library_.empty()) {
+    /* The directions of the Fermi momenta are isotropic and independent of
+     * the positions, so they need not be rotated with the configuration. */
+    const LibraryNucleon *configuration = &library_[library_index_ * size()];
+    for (auto i = begin(); i != end(); i++, configuration++) {
+      i->set_4momentum(i->pole_mass(), configuration->momentum);
+    }
+    return;
+  }
+  sample_fermi_momenta();
+}
+
+void Nucleus::sample_fermi_momenta() {
   const int N_n = std::count_if(begin(), end(), [](const ParticleData i) {
     return i.pdgcode() == pdg::n;
   });
@@ -747,31 +747,36 @@ void OscarOutput<Format, Contents>::write_particledata(
     const ParticleData &data) {
   const FourVector pos = data.position();
   const FourVector mom = data.momentum();
-  if (Format == OscarFormat2013) {
-    std::fprintf(file_.get(), "%g %g %g %g %g %.9g %.9g %.9g %.9g %s %i %i\n",
-                 pos.x0(), pos.x1(), pos.x2(), pos.x3(), data.effective_mass(),
-                 mom.x0(), mom.x1(), mom.x2(), mom.x3(),
-                 data.pdgcode().string().c_str(), data.id(),
-                 data.type().charge());
-  } else if (Format == OscarFormat2013Extended) {
-    const auto h = data.get_history();
-    std::fprintf(
-        file_.get(),
-        "%g %g %g %g %g %.9g %.9g %.9g"
-        " %.9g %s %i %i %i %g %g %i %i %g %s %s %i %i\n",
-        pos.x0(), pos.x1(), pos.x2(), pos.x3(), data.effective_mass(), mom.x0(),
-        mom.x1(), mom.x2(), mom.x3(), data.pdgcode().string().c_str(),
-        data.id(), data.type().charge(), h.collisions_per_particle,
-        data.formation_time(), data.xsec_scaling_factor(), h.id_process,
-        static_cast<int>(h.process_type), h.time_last_collision,
-        h.p1.string().c_str(), h.p2.string().c_str(),
-        data.type().baryon_number(), data.type().strangeness());
+  const int pdg = data.pdgcode().get_decimal();
+  line_.clear();
+  if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
+    // Same text as "%g %g %g %g %g %.9g %.9g %.9g %.9g %s %i %i"
+    line_ << pos.x0() << ' ' << pos.x1() << ' ' << pos.x2() << ' ' << pos.x3()
+          << ' ' << data.effective_mass() << ' ';
+    line_.append(mom.x0(), 9) << ' ';
+    line_.append(mom.x1(), 9) << ' ';
+    line_.append(mom.x2(), 9) << ' ';
+    line_.append(mom.x3(), 9) << ' ';
+    line_ << pdg << ' ' << data.id() << ' ' << data.type().charge();
+    if (Format == OscarFormat2013Extended) {
+      // Same text as " %i %g %g %i %i %g %s %s %i %i"
+      const auto h = data.get_history();
+      line_ << ' ' << h.collisions_per_particle << ' ' << data.formation_time()
+            << ' ' << data.xsec_scaling_factor() << ' ' << h.id_process << ' '
+            << static_cast<int>(h.process_type) << ' ' << h.time_last_collision
+            << ' ' << h.p1.get_decimal() << ' ' << h.p2.get_decimal() << ' '
+            << data.type().baryon_number() << ' '
+            << data.type().strangeness();
+    }
   } else {
-    std::fprintf(file_.get(), "%i %s %i %g %g %g %g %g %g %g %g %g\n",
-                 data.id(), data.pdgcode().string().c_str(), 0, mom.x1(),
-                 mom.x2(), mom.x3(), mom.x0(), data.effective_mass(), pos.x1(),
-                 pos.x2(), pos.x3(), pos.x0());
+    // Same text as "%i %s %i %g %g %g %g %g %g %g %g %g"
+    line_ << data.id() << ' ' << pdg << ' ' << 0 << ' ' << mom.x1() << ' '
+          << mom.x2() << ' ' << mom.x3() << ' ' << mom.x0() << ' '
+          << data.effective_mass() << ' ' << pos.x1() << ' ' << pos.x2() << ' '
+          << pos.x3() << ' ' << pos.x0();
   }
+  line_ << '\n';
+  line_.write_to(file_.get());
 }
 
 namespace {
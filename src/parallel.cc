@@ -0,0 +1,26 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/parallel.h"
+
+namespace smash {
+
+/// Number of events simulated concurrently, see set_concurrent_events
+static std::atomic<int> concurrent_events{1};
+
+int default_thread_count() {
+  const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+  return std::max(1, hardware / concurrent_events);
+}
+
+void set_concurrent_events(int n_events) {
+  concurrent_events = std::max(n_events, 1);
+}
+
+}  // namespace smash
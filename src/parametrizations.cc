@@ -9,11 +9,15 @@
 
 #include "smash/parametrizations.h"
 
+#include <algorithm>
 #include <cmath>
 #include <initializer_list>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
+#include <tuple>
 #include <vector>
 
 #include "smash/average.h"
@@ -22,11 +26,97 @@
 #include "smash/kinematics.h"
 #include "smash/logging.h"
 #include "smash/lowess.h"
+#include "smash/parallel.h"
 #include "smash/parametrizations_data.h"
 #include "smash/pow.h"
+#include "smash/tabulation.h"
 
 namespace smash {
 
+/// Whether the tabulated parametrizations below are used.
+static bool use_tabulated_xs = false;
+
+/// Upper bound of the tabulated parametrizations in sqrt(s) [GeV].
+constexpr double tabulated_xs_sqrts_max = 30.;
+
+/// Spacing of the tabulated parametrizations in sqrt(s) [GeV].
+constexpr double tabulated_xs_dsqrts = 0.001;
+
+/**
+ * Lookup table of a parametrization in sqrt(s), which replaces the exact
+ * evaluation for sqrt_min <= sqrt(s) < tabulated_xs_sqrts_max, if tabulated
+ * parametrizations are in use.
+ */
+struct TabulatedXs {
+  /// Lower bound of the tabulation in sqrt(s) [GeV]
+  const double sqrts_min;
+  /// Tabulated values, empty until tabulated parametrizations are enabled
+  Tabulation table = {};
+
+  /**
+   * Look up the parametrization.
+   *
+   * \param[in] mandelstam_s the rest frame total energy squared [GeV^2]
+   * \return the interpolated cross section [mb], or nothing if the exact
+   *         parametrization has to be evaluated
+   */
+  std::optional<double> lookup(double mandelstam_s) const {
+    if (!use_tabulated_xs) {
+      return std::nullopt;
+    }
+    const double sqrts = std::sqrt(mandelstam_s);
+    if (sqrts < sqrts_min || sqrts >= tabulated_xs_sqrts_max) {
+      return std::nullopt;
+    }
+    return table.get_value_linear(sqrts, Extrapolation::Const);
+  }
+
+  /**
+   * Fill the lookup table.
+   *
+   * \param[in] f exact parametrization as a function of mandelstam_s
+   */
+  void tabulate(double (*f)(double)) {
+    const double range = tabulated_xs_sqrts_max - sqrts_min;
+    const auto num =
+        static_cast<size_t>(std::ceil(range / tabulated_xs_dsqrts));
+    table = Tabulation(sqrts_min, range, num,
+                       [f](double sqrts) { return f(sqrts * sqrts); });
+  }
+};
+
+/* Lower bounds of the tabulations are above the thresholds, the poles of the
+ * low-energy NN parametrizations and the cuts below which the pi N and K- p
+ * elastic cross sections are not taken from data. */
+/// Tabulated pp_elastic()
+static TabulatedXs pp_elastic_tabulation{1.9};
+/// Tabulated np_elastic()
+static TabulatedXs np_elastic_tabulation{1.9};
+/// Tabulated ppbar_elastic()
+static TabulatedXs ppbar_elastic_tabulation{2 * nucleon_mass};
+/// Tabulated ppbar_total()
+static TabulatedXs ppbar_total_tabulation{2 * nucleon_mass};
+/// Tabulated piplusp_elastic()
+static TabulatedXs piplusp_elastic_tabulation{1.5};
+/// Tabulated piminusp_elastic()
+static TabulatedXs piminusp_elastic_tabulation{1.3};
+/// Tabulated kplusp_elastic_background()
+static TabulatedXs kplusp_elastic_tabulation{kaon_mass + nucleon_mass};
+/// Tabulated kminusp_elastic_background()
+static TabulatedXs kminusp_elastic_tabulation{1.68};
+/// Tabulated pp_high_energy()
+static TabulatedXs pp_high_energy_tabulation{2 * nucleon_mass};
+/// Tabulated ppbar_high_energy()
+static TabulatedXs ppbar_high_energy_tabulation{2 * nucleon_mass};
+/// Tabulated np_high_energy()
+static TabulatedXs np_high_energy_tabulation{2 * nucleon_mass};
+/// Tabulated npbar_high_energy()
+static TabulatedXs npbar_high_energy_tabulation{2 * nucleon_mass};
+/// Tabulated piplusp_high_energy()
+static TabulatedXs piplusp_high_energy_tabulation{pion_mass + nucleon_mass};
+/// Tabulated piminusp_high_energy()
+static TabulatedXs piminusp_high_energy_tabulation{pion_mass + nucleon_mass};
+
 bool parametrization_exists(const PdgCode& pdg_a, const PdgCode& pdg_b) {
   const bool two_nucleons = pdg_a.is_nucleon() && pdg_b.is_nucleon();
   const bool nucleon_and_kaon = (pdg_a.is_nucleon() && pdg_b.is_kaon()) ||
@@ -52,26 +142,44 @@ double xs_high_energy(double mandelstam_s, bool is_opposite_charge, double ma,
 }
 
 double pp_high_energy(double mandelstam_s) {
+  if (const auto xs = pp_high_energy_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   return xs_high_energy(mandelstam_s, false, 0.939, 0.939, 34.41, 13.07, 7.394);
 }
 
 double ppbar_high_energy(double mandelstam_s) {
+  if (const auto xs = ppbar_high_energy_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   return xs_high_energy(mandelstam_s, true, 0.939, 0.939, 34.41, 13.07, 7.394);
 }
 
 double np_high_energy(double mandelstam_s) {
+  if (const auto xs = np_high_energy_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   return xs_high_energy(mandelstam_s, false, 0.939, 0.939, 34.41, 12.52, 6.66);
 }
 
 double npbar_high_energy(double mandelstam_s) {
+  if (const auto xs = npbar_high_energy_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   return xs_high_energy(mandelstam_s, true, 0.939, 0.939, 34.41, 12.52, 6.66);
 }
 
 double piplusp_high_energy(double mandelstam_s) {
+  if (const auto xs = piplusp_high_energy_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   return xs_high_energy(mandelstam_s, false, 0.939, 0.138, 18.75, 9.56, 1.767);
 }
 
 double piminusp_high_energy(double mandelstam_s) {
+  if (const auto xs = piminusp_high_energy_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   return xs_high_energy(mandelstam_s, true, 0.939, 0.138, 18.75, 9.56, 1.767);
 }
 
@@ -110,14 +218,149 @@ double pipi_string_hard(double mandelstam_s) {
   return xs_string_hard(mandelstam_s, 0.013, 2.3, 4.7);
 }
 
-double pipluspiminus_total(double sqrts) {
-  if (pipluspiminus_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIPLUSPIMINUS_TOT_SQRTS, PIPLUSPIMINUS_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 10);
-    pipluspiminus_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
+/// PDG data that is averaged over equal arguments and smoothed with LOWESS
+struct SmoothedData {
+  /// Name of the smoothed values in the tabulation bundle
+  const char *name;
+  /// Arguments of the data
+  const std::initializer_list<double> &x;
+  /// Values of the data
+  const std::initializer_list<double> &y;
+  /// Span of the LOWESS smoothing
+  double span;
+  /// Robustifying iterations of the LOWESS smoothing
+  std::size_t iterations;
+  /// Interpolation of the smoothed data
+  std::unique_ptr<InterpolateDataLinear<double>> &interpolation;
+};
+
+/**
+ * Build the interpolations of the data of the parametrizations.
+ *
+ * The LOWESS smoothing takes most of the time, so the data sets are smoothed
+ * concurrently, and the smoothed values are read from and added to the
+ * bundle, as values over the indices of the averaged data.
+ *
+ * \param[inout] bundle Cached tabulations, nullptr to smooth all data.
+ * \return Number of smoothed data sets added to the bundle.
+ */
+static std::size_t build_interpolations(TabulationBundle *bundle) {
+  const std::vector<SmoothedData> smoothed = {
+      {"lowess_pipluspiminus_total", PIPLUSPIMINUS_TOT_SQRTS,
+       PIPLUSPIMINUS_TOT_SIG, 0.01, 10, pipluspiminus_total_interpolation},
+      {"lowess_pizeropizero_total", PIZEROPIZERO_TOT_SQRTS,
+       PIZEROPIZERO_TOT_SIG, 0.01, 10, pizeropizero_total_interpolation},
+      {"lowess_piplusp_total", PIPLUSP_TOT_SQRTS, PIPLUSP_TOT_SIG, 0.01, 10,
+       piplusp_total_interpolation},
+      {"lowess_piplusp_elastic", PIPLUSP_ELASTIC_P_LAB, PIPLUSP_ELASTIC_SIG,
+       0.1, 5, piplusp_elastic_interpolation},
+      {"lowess_piplusp_sigmapluskplus", PIPLUSP_SIGMAPLUSKPLUS_P_LAB,
+       PIPLUSP_SIGMAPLUSKPLUS_SIG, 0.2, 5,
+       piplusp_sigmapluskplus_interpolation},
+      {"lowess_piminusp_total", PIMINUSP_TOT_SQRTS, PIMINUSP_TOT_SIG, 0.01, 6,
+       piminusp_total_interpolation},
+      {"lowess_piminusp_elastic", PIMINUSP_ELASTIC_P_LAB, PIMINUSP_ELASTIC_SIG,
+       0.2, 6, piminusp_elastic_interpolation},
+      {"lowess_piminusp_lambdak0", PIMINUSP_LAMBDAK0_P_LAB,
+       PIMINUSP_LAMBDAK0_SIG, 0.2, 6, piminusp_lambdak0_interpolation},
+      {"lowess_piminusp_sigmaminuskplus", PIMINUSP_SIGMAMINUSKPLUS_P_LAB,
+       PIMINUSP_SIGMAMINUSKPLUS_SIG, 0.2, 6,
+       piminusp_sigmaminuskplus_interpolation},
+      {"lowess_piminusp_sigma0k0", PIMINUSP_SIGMA0K0_RES_SQRTS,
+       PIMINUSP_SIGMA0K0_RES_SIG, 0.2, 6, piminusp_sigma0k0_interpolation},
+      {"lowess_kplusp_total", KPLUSP_TOT_PLAB, KPLUSP_TOT_SIG, 0.1, 5,
+       kplusp_total_interpolation},
+      {"lowess_kplusn_total", KPLUSN_TOT_PLAB, KPLUSN_TOT_SIG, 0.05, 5,
+       kplusn_total_interpolation},
+      // Parametrization data is pre-smoothed
+      {"lowess_kminusp_total", KMINUSP_TOT_PLAB, KMINUSP_TOT_SIG, 0.01, 5,
+       kminusp_total_interpolation},
+      {"lowess_kminusn_total", KMINUSN_TOT_PLAB, KMINUSN_TOT_SIG, 0.05, 5,
+       kminusn_total_interpolation},
+      {"lowess_kminusp_elastic", KMINUSP_ELASTIC_P_LAB, KMINUSP_ELASTIC_SIG,
+       0.1, 5, kminusp_elastic_interpolation},
+  };
+
+  const std::size_t n_data = smoothed.size();
+  std::vector<std::vector<double>> x(n_data), y(n_data);
+  std::vector<std::size_t> missing;
+  for (std::size_t i = 0; i < n_data; i++) {
+    std::tie(x[i], y[i]) = dedup_avg<double>(smoothed[i].x, smoothed[i].y);
+    const Tabulation *cached =
+        bundle ? bundle->find(smoothed[i].name) : nullptr;
+    if (cached && std::lround(cached->x_max()) + 1 ==
+                      static_cast<long>(y[i].size())) {
+      for (std::size_t j = 0; j < y[i].size(); j++) {
+        y[i][j] = cached->get_value_step(j);
+      }
+    } else {
+      missing.push_back(i);
+    }
+  }
+
+  parallel_for(default_thread_count(), missing.size(), 1, [&](std::size_t k) {
+    const SmoothedData &data = smoothed[missing[k]];
+    y[missing[k]] =
+        smooth(x[missing[k]], y[missing[k]], data.span, data.iterations);
+  });
+
+  if (bundle) {
+    for (std::size_t i : missing) {
+      const std::vector<double> &values = y[i];
+      const double last = values.size() - 1;
+      bundle->insert(smoothed[i].name,
+                     Tabulation(0., last, values.size() - 1,
+                                [&values](double j) {
+                                  return values[std::lround(j)];
+                                }));
+    }
+  }
+  for (std::size_t i = 0; i < n_data; i++) {
+    smoothed[i].interpolation =
+        std::make_unique<InterpolateDataLinear<double>>(x[i], y[i]);
+  }
+
+  // The elastic contributions from decays are interpolated without smoothing.
+  std::vector<double> piplusp_res_s = PIPLUSP_RES_SQRTS;
+  for (double &s : piplusp_res_s) {
+    s = s * s;
   }
+  piplusp_elastic_res_interpolation = std::make_unique<InterpolateDataSpline>(
+      piplusp_res_s, std::vector<double>(PIPLUSP_RES_SIG));
+
+  std::vector<double> piminusp_res_s = PIMINUSP_RES_SQRTS;
+  for (double &s : piminusp_res_s) {
+    s = s * s;
+  }
+  auto [dedup_s, dedup_sig] =
+      dedup_avg(piminusp_res_s, std::vector<double>(PIMINUSP_RES_SIG));
+  piminusp_elastic_res_interpolation =
+      std::make_unique<InterpolateDataSpline>(dedup_s, dedup_sig);
+
+  std::vector<double> kminusp_res_plab = KMINUSP_RES_SQRTS;
+  for (double &p_lab : kminusp_res_plab) {
+    p_lab = plab_from_s(p_lab * p_lab, kaon_mass, nucleon_mass);
+  }
+  kminusp_elastic_res_interpolation = std::make_unique<InterpolateDataSpline>(
+      kminusp_res_plab, std::vector<double>(KMINUSP_RES_SIG));
+
+  return bundle ? missing.size() : 0;
+}
+
+/// Whether the interpolations of the data were built
+static std::once_flag interpolations_built;
+
+/**
+ * Build the interpolations of the data, unless this was done at startup by
+ * initialize_parametrization_interpolations. Afterwards, this is a single
+ * check, which is safe with concurrent callers.
+ */
+static void require_interpolations() {
+  std::call_once(interpolations_built, build_interpolations, nullptr);
+}
+
+double pipluspiminus_total(double sqrts) {
+  require_interpolations();
   const double last = *(PIPLUSPIMINUS_TOT_SQRTS.end() - 1);
   if (sqrts < last)
     return (*pipluspiminus_total_interpolation)(sqrts);
@@ -126,13 +369,7 @@ double pipluspiminus_total(double sqrts) {
 }
 
 double pizeropizero_total(double sqrts) {
-  if (pizeropizero_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIZEROPIZERO_TOT_SQRTS, PIZEROPIZERO_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 10);
-    pizeropizero_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double last = *(PIZEROPIZERO_TOT_SQRTS.end() - 1);
   if (sqrts < last)
     return (*pizeropizero_total_interpolation)(sqrts);
@@ -141,13 +378,7 @@ double pizeropizero_total(double sqrts) {
 }
 
 double piplusp_total(double sqrts) {
-  if (piplusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIPLUSP_TOT_SQRTS, PIPLUSP_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 10);
-    piplusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double last = *(PIPLUSP_TOT_SQRTS.end() - 1);
   if (sqrts < last)
     return (*piplusp_total_interpolation)(sqrts);
@@ -161,13 +392,7 @@ double piplusp_total(double sqrts) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 static double piplusp_elastic_pdg(double mandelstam_s) {
-  if (piplusp_elastic_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIPLUSP_ELASTIC_P_LAB, PIPLUSP_ELASTIC_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.1, 5);
-    piplusp_elastic_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
   return (*piplusp_elastic_interpolation)(p_lab);
 }
@@ -190,6 +415,9 @@ double piplusp_elastic_AQM(double mandelstam_s, double m1, double m2) {
 }
 
 double piplusp_elastic(double mandelstam_s) {
+  if (const auto xs = piplusp_elastic_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   double sigma;
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
   if (mandelstam_s < 2.25) {
@@ -202,15 +430,7 @@ double piplusp_elastic(double mandelstam_s) {
   }
 
   // The elastic contributions from decays still need to be subtracted.
-  if (piplusp_elastic_res_interpolation == nullptr) {
-    std::vector<double> x = PIPLUSP_RES_SQRTS;
-    for (auto& i : x) {
-      i = i * i;
-    }
-    std::vector<double> y = PIPLUSP_RES_SIG;
-    piplusp_elastic_res_interpolation =
-        std::make_unique<InterpolateDataSpline>(x, y);
-  }
+  require_interpolations();
   sigma -= (*piplusp_elastic_res_interpolation)(mandelstam_s);
   if (sigma < 0) {
     sigma = really_small;
@@ -224,13 +444,7 @@ double piplusp_elastic(double mandelstam_s) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 double piplusp_sigmapluskplus_pdg(double mandelstam_s) {
-  if (piplusp_sigmapluskplus_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] = dedup_avg<double>(PIPLUSP_SIGMAPLUSKPLUS_P_LAB,
-                                                PIPLUSP_SIGMAPLUSKPLUS_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 5);
-    piplusp_sigmapluskplus_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
   /* If p_lab is beyond the upper bound of the linear interpolation,
    * InterpolationDataLinear will return the value at the upper bound and this
@@ -239,13 +453,7 @@ double piplusp_sigmapluskplus_pdg(double mandelstam_s) {
 }
 
 double piminusp_total(double sqrts) {
-  if (piminusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIMINUSP_TOT_SQRTS, PIMINUSP_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 6);
-    piminusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double last = *(PIMINUSP_TOT_SQRTS.end() - 1);
   if (sqrts < last)
     return (*piminusp_total_interpolation)(sqrts);
@@ -259,18 +467,15 @@ double piminusp_total(double sqrts) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 static double piminusp_elastic_pdg(double mandelstam_s) {
-  if (piminusp_elastic_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIMINUSP_ELASTIC_P_LAB, PIMINUSP_ELASTIC_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 6);
-    piminusp_elastic_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
   return (*piminusp_elastic_interpolation)(p_lab);
 }
 
 double piminusp_elastic(double mandelstam_s) {
+  if (const auto xs = piminusp_elastic_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   double sigma;
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
   const auto logp = std::log(p_lab);
@@ -292,16 +497,7 @@ double piminusp_elastic(double mandelstam_s) {
               0.88);
   }
   // The elastic contributions from decays still need to be subtracted.
-  if (piminusp_elastic_res_interpolation == nullptr) {
-    std::vector<double> x = PIMINUSP_RES_SQRTS;
-    for (auto& i : x) {
-      i = i * i;
-    }
-    std::vector<double> y = PIMINUSP_RES_SIG;
-    auto [dedup_x, dedup_y] = dedup_avg(x, y);
-    piminusp_elastic_res_interpolation =
-        std::make_unique<InterpolateDataSpline>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   sigma -= (*piminusp_elastic_res_interpolation)(mandelstam_s);
   if (sigma < 0) {
     sigma = really_small;
@@ -315,13 +511,7 @@ double piminusp_elastic(double mandelstam_s) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 double piminusp_lambdak0_pdg(double mandelstam_s) {
-  if (piminusp_lambdak0_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIMINUSP_LAMBDAK0_P_LAB, PIMINUSP_LAMBDAK0_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 6);
-    piminusp_lambdak0_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
   return (*piminusp_lambdak0_interpolation)(p_lab);
 }
@@ -332,13 +522,7 @@ double piminusp_lambdak0_pdg(double mandelstam_s) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 double piminusp_sigmaminuskplus_pdg(double mandelstam_s) {
-  if (piminusp_sigmaminuskplus_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] = dedup_avg<double>(PIMINUSP_SIGMAMINUSKPLUS_P_LAB,
-                                                PIMINUSP_SIGMAMINUSKPLUS_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 6);
-    piminusp_sigmaminuskplus_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
   return (*piminusp_sigmaminuskplus_interpolation)(p_lab);
 }
@@ -349,18 +533,15 @@ double piminusp_sigmaminuskplus_pdg(double mandelstam_s) {
  * cross section was given for one sqrts value, the corresponding cross sections
  * are averaged. */
 double piminusp_sigma0k0_res(double mandelstam_s) {
-  if (piminusp_sigma0k0_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] = dedup_avg<double>(PIMINUSP_SIGMA0K0_RES_SQRTS,
-                                                PIMINUSP_SIGMA0K0_RES_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 6);
-    piminusp_sigma0k0_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double sqrts = std::sqrt(mandelstam_s);
   return (*piminusp_sigma0k0_interpolation)(sqrts);
 }
 
 double pp_elastic(double mandelstam_s) {
+  if (const auto xs = pp_elastic_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   const double p_lab = plab_from_s(mandelstam_s);
   if (p_lab < 0.435) {
     return 5.12 * nucleon_mass /
@@ -404,6 +585,9 @@ double pp_total(double mandelstam_s) {
 }
 
 double np_elastic(double mandelstam_s) {
+  if (const auto xs = np_elastic_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   const double p_lab = plab_from_s(mandelstam_s);
   if (p_lab < 0.525) {
     return 17.05 * nucleon_mass /
@@ -439,6 +623,9 @@ double np_total(double mandelstam_s) {
 }
 
 double ppbar_elastic(double mandelstam_s) {
+  if (const auto xs = ppbar_elastic_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   if (mandelstam_s < 4 * nucleon_mass * nucleon_mass) {
     // Needed, since called directly from p_52
     return 0.0;
@@ -456,6 +643,9 @@ double ppbar_elastic(double mandelstam_s) {
 }
 
 double ppbar_total(double mandelstam_s) {
+  if (const auto xs = ppbar_total_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   if (mandelstam_s < 4 * nucleon_mass * nucleon_mass) {
     // Needed, since called directly from p_52
     return 0.0;
@@ -484,55 +674,33 @@ double deuteron_nucleon_elastic(double mandelstam_s) {
 }
 
 double kplusp_total(double mandelstam_s) {
-  if (kplusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KPLUSP_TOT_PLAB, KPLUSP_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.1, 5);
-    kplusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
   return (*kplusp_total_interpolation)(p_lab);
 }
 
 double kplusn_total(double mandelstam_s) {
-  if (kplusn_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KPLUSN_TOT_PLAB, KPLUSN_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.05, 5);
-    kplusn_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
   return (*kplusn_total_interpolation)(p_lab);
 }
 
 double kminusp_total(double mandelstam_s) {
-  if (kminusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KMINUSP_TOT_PLAB, KMINUSP_TOT_SIG);
-    // Parametrization data is pre-smoothed
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 5);
-    kminusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
   return (*kminusp_total_interpolation)(p_lab);
 }
 
 double kminusn_total(double mandelstam_s) {
-  if (kminusn_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KMINUSN_TOT_PLAB, KMINUSN_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.05, 5);
-    kminusn_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
   return (*kminusn_total_interpolation)(p_lab);
 }
 
 double kplusp_elastic_background(double mandelstam_s) {
+  if (const auto xs = kplusp_elastic_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   constexpr double a0 = 10.508;  // mb
   constexpr double a1 = -3.716;  // mb/GeV
   constexpr double a2 = 1.845;   // mb/GeV^2
@@ -559,18 +727,15 @@ double kplusn_k0p(double mandelstam_s) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 static double kminusp_elastic_pdg(double mandelstam_s) {
-  if (kminusp_elastic_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KMINUSP_ELASTIC_P_LAB, KMINUSP_ELASTIC_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.1, 5);
-    kminusp_elastic_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
   return (*kminusp_elastic_interpolation)(p_lab);
 }
 
 double kminusp_elastic_background(double mandelstam_s) {
+  if (const auto xs = kminusp_elastic_tabulation.lookup(mandelstam_s)) {
+    return *xs;
+  }
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
   double sigma;
   if (std::sqrt(mandelstam_s) < 1.68) {
@@ -592,15 +757,7 @@ double kminusp_elastic_background(double mandelstam_s) {
     sigma = kminusp_elastic_pdg(mandelstam_s);
   }
   // The elastic contributions from decays still need to be subtracted.
-  if (kminusp_elastic_res_interpolation == nullptr) {
-    std::vector<double> x = KMINUSP_RES_SQRTS;
-    for (auto& i : x) {
-      i = plab_from_s(i * i, kaon_mass, nucleon_mass);
-    }
-    std::vector<double> y = KMINUSP_RES_SIG;
-    kminusp_elastic_res_interpolation =
-        std::make_unique<InterpolateDataSpline>(x, y);
-  }
+  require_interpolations();
   const auto old_sigma = sigma;
   sigma -= (*kminusp_elastic_res_interpolation)(p_lab);
   if (sigma < 0) {
@@ -637,26 +794,14 @@ double kbar0n_elastic_background(double mandelstam_s) {
 }
 
 double kplusp_inelastic_background(double mandelstam_s) {
-  if (kplusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KPLUSP_TOT_PLAB, KPLUSP_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.1, 5);
-    kplusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
   return (*kplusp_total_interpolation)(p_lab)-kplusp_elastic_background(
       mandelstam_s);
 }
 
 double kplusn_inelastic_background(double mandelstam_s) {
-  if (kplusn_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KPLUSN_TOT_PLAB, KPLUSN_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.05, 5);
-    kplusn_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
+  require_interpolations();
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
   return (*kplusn_total_interpolation)(p_lab)-kplusn_elastic_background(
              mandelstam_s) -
@@ -766,7 +911,7 @@ double KaonNucleonRatios::get_ratio(const ParticleType& a,
   return ratios_.at(key);
 }
 
-/*thread_local (see #3075)*/ KaonNucleonRatios kaon_nucleon_ratios;
+thread_local KaonNucleonRatios kaon_nucleon_ratios;
 
 double kminusp_kbar0n(double mandelstam_s) {
   constexpr double a0 = 100;   // mb GeV^2
@@ -869,4 +1014,34 @@ double sigmaplussigmaminus_xi0n(double sqrts_sqrts0) {
   return sigmaplussigmaminus_ximinusp(sqrts_sqrts0);
 }
 
+std::size_t initialize_parametrization_interpolations(
+    TabulationBundle *bundle) {
+  std::size_t n_added = 0;
+  std::call_once(interpolations_built,
+                 [&]() { n_added = build_interpolations(bundle); });
+  return n_added;
+}
+
+void use_tabulated_parametrizations(bool use) {
+  if (use && pp_elastic_tabulation.table.is_empty()) {
+    // The exact parametrizations are tabulated, so the lookup is still off.
+    use_tabulated_xs = false;
+    pp_elastic_tabulation.tabulate(pp_elastic);
+    np_elastic_tabulation.tabulate(np_elastic);
+    ppbar_elastic_tabulation.tabulate(ppbar_elastic);
+    ppbar_total_tabulation.tabulate(ppbar_total);
+    piplusp_elastic_tabulation.tabulate(piplusp_elastic);
+    piminusp_elastic_tabulation.tabulate(piminusp_elastic);
+    kplusp_elastic_tabulation.tabulate(kplusp_elastic_background);
+    kminusp_elastic_tabulation.tabulate(kminusp_elastic_background);
+    pp_high_energy_tabulation.tabulate(pp_high_energy);
+    ppbar_high_energy_tabulation.tabulate(ppbar_high_energy);
+    np_high_energy_tabulation.tabulate(np_high_energy);
+    npbar_high_energy_tabulation.tabulate(npbar_high_energy);
+    piplusp_high_energy_tabulation.tabulate(piplusp_high_energy);
+    piminusp_high_energy_tabulation.tabulate(piminusp_high_energy);
+  }
+  use_tabulated_xs = use;
+}
+
 }  // namespace smash
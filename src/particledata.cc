@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,6 +11,7 @@
 
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <optional>
 #include <vector>
 
@@ -21,6 +22,11 @@
 
 namespace smash {
 
+#ifdef SMASH_COMPACT_PARTICLE_HISTORY
+static_assert(sizeof(ParticleData) <= 128,
+              "The compact history should keep particles in two cache lines.");
+#endif
+
 double ParticleData::effective_mass() const {
   const double m_pole = pole_mass();
   if (m_pole < really_small) {
@@ -32,14 +38,19 @@ double ParticleData::effective_mass() const {
 }
 
 void ParticleData::set_history(int ncoll, uint32_t pid, ProcessType pt,
-                               double time_last_coll,
-                               const ParticleList &plist) {
+                               [[maybe_unused]] double time_last_coll,
+                               [[maybe_unused]] const ParticleList &plist) {
   if (pt != ProcessType::Wall) {
     history_.collisions_per_particle = ncoll;
+#ifndef SMASH_COMPACT_PARTICLE_HISTORY
     history_.time_last_collision = time_last_coll;
+#endif
+    scheduled_decay_time_ = std::numeric_limits<double>::quiet_NaN();
   }
   history_.id_process = pid;
-  history_.process_type = pt;
+  process_type_ = static_cast<std::uint8_t>(pt);
+  // The compact history leaves out the parents.
+#ifndef SMASH_COMPACT_PARTICLE_HISTORY
   switch (pt) {
     case ProcessType::Decay:
     case ProcessType::Wall:
@@ -81,6 +92,7 @@ void ParticleData::set_history(int ncoll, uint32_t pid, ProcessType pt,
       history_.p2 = 0x0;
       break;
   }
+#endif
 }
 
 double ParticleData::xsec_scaling_factor(double delta_time) const {
@@ -160,7 +172,7 @@ std::ostream &operator<<(std::ostream &out,
   return out << ']';
 }
 
-double ParticleData::formation_power_ = 0.0;
+thread_local double ParticleData::formation_power_ = 0.0;
 
 ParticleData create_valid_smash_particle_matching_provided_quantities(
     PdgCode pdgcode, double mass, const FourVector &four_position,
@@ -9,8 +9,16 @@
 
 #include "smash/particles.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "smash/algorithms.h"
+#include "smash/checkpoint.h"
 
 namespace smash {
 
@@ -18,6 +26,7 @@ Particles::Particles() : data_(new ParticleData[data_capacity_]) {
   for (unsigned i = 0; i < data_capacity_; ++i) {
     data_[i].index_ = i;
   }
+  memory_.set(data_capacity_ * sizeof(ParticleData));
 }
 
 inline void Particles::ensure_capacity(unsigned to_add) {
@@ -39,6 +48,38 @@ void Particles::increase_capacity(unsigned new_capacity) {
     new_memory[i].index_ = i;
   }
   std::swap(data_, new_memory);
+  memory_.set(data_capacity_ * sizeof(ParticleData));
+}
+
+std::unique_ptr<Particles> Particles::clone(MemorySubsystem subsystem) const {
+  auto copy = std::make_unique<Particles>();
+  copy->memory_.set_subsystem(subsystem);
+  if (data_capacity_ > copy->data_capacity_) {
+    copy->increase_capacity(data_capacity_);
+  }
+  for (unsigned i = 0; i < data_size_; ++i) {
+    copy->data_[i] = data_[i];
+  }
+  copy->data_size_ = data_size_;
+  copy->dirty_ = dirty_;
+  copy->added_since_sort_ = added_since_sort_;
+  copy->id_max_ = id_max_;
+  return copy;
+}
+
+void Particles::copy_from(const Particles &other) {
+  reset();
+  if (other.data_capacity_ > data_capacity_) {
+    increase_capacity(other.data_capacity_);
+  }
+  std::copy(&other.data_[0], &other.data_[0] + other.data_size_, &data_[0]);
+  data_size_ = other.data_size_;
+  dirty_ = other.dirty_;
+  added_since_sort_ = other.added_since_sort_;
+  id_max_ = other.id_max_;
+  if (arrays_) {
+    sync_arrays();
+  }
 }
 
 inline void Particles::copy_in(ParticleData &to, const ParticleData &from) {
@@ -47,24 +88,93 @@ inline void Particles::copy_in(ParticleData &to, const ParticleData &from) {
   from.copy_to(to);
 }
 
+void Particles::store_in_arrays(unsigned index) {
+  ParticleArrays &arrays = *arrays_;
+  if (arrays.size() != data_size_) {
+    for (int mu = 0; mu < 4; mu++) {
+      arrays.position[mu].resize(data_size_);
+      arrays.momentum[mu].resize(data_size_);
+    }
+    arrays.type.resize(data_size_);
+    arrays.valid.resize(data_size_);
+  }
+  if (index >= data_size_) {
+    return;
+  }
+  const ParticleData &p = data_[index];
+  for (int mu = 0; mu < 4; mu++) {
+    arrays.position[mu][index] = p.position()[mu];
+    arrays.momentum[mu][index] = p.momentum()[mu];
+  }
+  arrays.type[index] = p.type_;
+  arrays.valid[index] = !p.hole_;
+}
+
+void Particles::sync_arrays() {
+  assert(arrays_ != nullptr);
+  for (unsigned i = 0; i < data_size_; ++i) {
+    store_in_arrays(i);
+  }
+  // Also shrinks the arrays for an empty list
+  store_in_arrays(data_size_);
+}
+
+void Particles::boost_momenta(const ThreeVector &beta) {
+  const LorentzBoost boost(beta);
+  for (ParticleData &p : *this) {
+    p.boost_momentum(boost);
+  }
+  if (arrays_) {
+    std::array<std::vector<double>, 4> &momentum = arrays_->momentum;
+    boost.apply(momentum[0].data(), momentum[1].data(), momentum[2].data(),
+                momentum[3].data(), arrays_->size());
+  }
+}
+
+void Particles::write_checkpoint(std::ostream &out) const {
+  checkpoint::write(out, id_max_);
+  checkpoint::write(out, data_size_);
+  checkpoint::write_array(out, &data_[0], data_size_);
+  checkpoint::write(out, dirty_);
+}
+
+void Particles::read_checkpoint(std::istream &in) {
+  unsigned size = 0;
+  reset();
+  checkpoint::read(in, id_max_);
+  checkpoint::read(in, size);
+  ensure_capacity(size);
+  checkpoint::read_array(in, &data_[0], size);
+  data_size_ = size;
+  checkpoint::read(in, dirty_);
+  if (arrays_) {
+    sync_arrays();
+  }
+}
+
 const ParticleData &Particles::insert(const ParticleData &p) {
+  unsigned offset;
   if (likely(dirty_.empty())) {
     ensure_capacity(1);
-    ParticleData &in_vector = data_[data_size_];
-    copy_in(in_vector, p);
+    offset = data_size_;
+    copy_in(data_[offset], p);
     ++data_size_;
-    return in_vector;
   } else {
-    const auto offset = dirty_.back();
+    offset = dirty_.back();
     dirty_.pop_back();
     copy_in(data_[offset], p);
     data_[offset].hole_ = false;
-    return data_[offset];
   }
+  ++added_since_sort_;
+  if (arrays_) {
+    store_in_arrays(offset);
+  }
+  return data_[offset];
 }
 
 void Particles::create(size_t number, PdgCode pdg) {
   const ParticleData pd(ParticleType::find(pdg));
+  added_since_sort_ += number;
   while (number && !dirty_.empty()) {
     const auto offset = dirty_.back();
     dirty_.pop_back();
@@ -84,6 +194,9 @@ void Particles::create(size_t number, PdgCode pdg) {
     }
     data_size_ += number;
   }
+  if (arrays_) {
+    sync_arrays();
+  }
 }
 
 ParticleData &Particles::create(const PdgCode pdg) {
@@ -102,6 +215,10 @@ ParticleData &Particles::create(const PdgCode pdg) {
   pd.copy_to(*ptr);
   ptr->id_ = ++id_max_;
   ptr->type_ = pd.type_;
+  ++added_since_sort_;
+  if (arrays_) {
+    store_in_arrays(ptr->index_);
+  }
   return *ptr;
 }
 
@@ -110,11 +227,27 @@ void Particles::remove(const ParticleData &p) {
   const unsigned index = p.index_;
   if (index == data_size_ - 1) {
     --data_size_;
+    trim_holes();
   } else {
     data_[index].set_id(-1);
     data_[index].hole_ = true;
     dirty_.push_back(index);
   }
+  if (arrays_) {
+    store_in_arrays(index);
+  }
+}
+
+void Particles::trim_holes() {
+  while (data_size_ > 0 && data_[data_size_ - 1].hole_) {
+    --data_size_;
+    data_[data_size_].hole_ = false;
+    // The hole is most likely one of the recently freed slots.
+    const auto slot = std::find(dirty_.rbegin(), dirty_.rend(), data_size_);
+    assert(slot != dirty_.rend());
+    *slot = dirty_.back();
+    dirty_.pop_back();
+  }
 }
 
 void Particles::replace(const ParticleList &to_remove, ParticleList &to_add) {
@@ -125,6 +258,9 @@ void Particles::replace(const ParticleList &to_remove, ParticleList &to_add) {
     copy_in(data_[index], to_add[i]);
     to_add[i].id_ = data_[index].id_;
     to_add[i].index_ = index;
+    if (arrays_) {
+      store_in_arrays(index);
+    }
   }
   for (; i < to_remove.size(); ++i) {
     remove(to_remove[i]);
@@ -143,6 +279,83 @@ void Particles::reset() {
     data_[index].hole_ = false;
   }
   dirty_.clear();
+  added_since_sort_ = 0;
+  if (arrays_) {
+    sync_arrays();
+  }
+}
+
+void Particles::sort_spatially(double cell_length) {
+  if (!(cell_length > 0.)) {
+    throw std::invalid_argument(
+        "The cells to sort the particles by need a positive length.");
+  }
+  std::array<double, 3> min_position;
+  min_position.fill(std::numeric_limits<double>::infinity());
+  for (const ParticleData &p : *this) {
+    for (int i = 0; i < 3; i++) {
+      min_position[i] = std::min(min_position[i], p.position()[i + 1]);
+    }
+  }
+  // Cells beyond the 21 bits of a Morton index share the last index.
+  constexpr double max_cell_index = (1 << 21) - 1;
+  auto cell_index = [&](const ParticleData &p, int i) {
+    const double index =
+        std::floor((p.position()[i + 1] - min_position[i]) / cell_length);
+    return static_cast<std::uint64_t>(std::min(index, max_cell_index));
+  };
+  // The storage index breaks the ties, which keeps the order reproducible.
+  std::vector<std::pair<std::uint64_t, unsigned>> order;
+  order.reserve(size());
+  for (const ParticleData &p : *this) {
+    order.emplace_back(
+        morton_index(cell_index(p, 0), cell_index(p, 1), cell_index(p, 2)),
+        p.index_);
+  }
+  std::sort(order.begin(), order.end());
+
+  std::unique_ptr<ParticleData[]> sorted(new ParticleData[data_capacity_]);
+  unsigned i = 0;
+  for (; i < order.size(); ++i) {
+    sorted[i] = data_[order[i].second];
+    sorted[i].index_ = i;
+  }
+  for (; i < data_capacity_; ++i) {
+    sorted[i].index_ = i;
+  }
+  std::swap(data_, sorted);
+  data_size_ = order.size();
+  dirty_.clear();
+  added_since_sort_ = 0;
+  if (arrays_) {
+    sync_arrays();
+  }
+}
+
+void Particles::relocate() {
+  std::unique_ptr<ParticleData[]> local(new ParticleData[data_capacity_]);
+  std::copy(&data_[0], &data_[0] + data_capacity_, &local[0]);
+  std::swap(data_, local);
+  if (arrays_) {
+    arrays_ = std::make_unique<ParticleArrays>();
+    sync_arrays();
+  }
+}
+
+std::vector<Particles::iterator> Particles::partition(int n) {
+  assert(n > 0);
+  std::vector<iterator> bounds;
+  bounds.reserve(n + 1);
+  for (int i = 0; i <= n; i++) {
+    // The entry at data_size_ is never a hole, which stops the search.
+    ParticleData *first =
+        &data_[static_cast<std::uint64_t>(data_size_) * i / n];
+    while (first->hole_) {
+      ++first;
+    }
+    bounds.push_back(iterator(first));
+  }
+  return bounds;
 }
 
 std::ostream &operator<<(std::ostream &out, const Particles &particles) {
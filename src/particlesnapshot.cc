@@ -0,0 +1,354 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/particlesnapshot.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "smash/decaymodes.h"
+#include "smash/decaytype.h"
+#include "smash/logging.h"
+#include "smash/particletype.h"
+
+namespace smash {
+static constexpr int LParticleType = LogArea::ParticleType::id;
+
+namespace {
+/// Magic number at the beginning of a snapshot
+constexpr char snapshot_magic[4] = {'S', 'M', 'P', 'S'};
+/// Version of the snapshot format
+constexpr std::uint32_t snapshot_version = 1;
+
+/// A particle type as stored in the snapshot
+struct TypeRecord {
+  /// Name of the type
+  std::string name;
+  /// Pole mass
+  double mass;
+  /// Width at the pole
+  double width;
+  /// Parity
+  Parity parity;
+  /// PDG code
+  PdgCode pdgcode;
+};
+
+/// A decay type as stored in the snapshot
+struct DecayTypeRecord {
+  /// Index of the mother
+  std::uint32_t mother;
+  /// Indices of the products
+  std::vector<std::uint32_t> products;
+  /// Angular momentum
+  std::int32_t L;
+};
+
+/// A decay mode as stored in the snapshot
+struct DecayModeRecord {
+  /// Index of the decay type
+  std::uint32_t decay_type;
+  /// Branching ratio
+  double weight;
+};
+
+/// Read-only view of a snapshot, checking every access against its size
+class SnapshotView {
+ public:
+  /// \param[in] data Content of the snapshot.
+  explicit SnapshotView(const std::string &data) : data_(data) {}
+
+  /**
+   * Read a value and advance.
+   *
+   * \param[out] x Value read.
+   * \throw std::runtime_error if the file ends before the value.
+   */
+  template <typename T>
+  void read(T &x) {
+    std::memcpy(&x, bytes(sizeof(T)), sizeof(T));
+  }
+
+  /**
+   * Read an index and advance.
+   *
+   * \param[in] size Number of indexed objects.
+   * \return The index.
+   * \throw std::runtime_error if the index is out of range.
+   */
+  std::uint32_t index(std::size_t size) {
+    std::uint32_t i;
+    read(i);
+    if (i >= size) {
+      throw std::runtime_error("index out of range");
+    }
+    return i;
+  }
+
+  /**
+   * Skip bytes and advance.
+   *
+   * \param[in] n Number of bytes.
+   * \return Begin of the skipped bytes.
+   * \throw std::runtime_error if the file ends before.
+   */
+  const char *bytes(std::size_t n) {
+    if (n > data_.size() - offset_) {
+      throw std::runtime_error("unexpected end of file");
+    }
+    const char *begin = data_.data() + offset_;
+    offset_ += n;
+    return begin;
+  }
+
+  /// \return Whether the whole snapshot was read.
+  bool at_end() const { return offset_ == data_.size(); }
+
+ private:
+  /// Content of the snapshot
+  const std::string &data_;
+  /// Position of the next read
+  std::size_t offset_ = 0;
+};
+
+/**
+ * Append the bytes of a value to a buffer.
+ *
+ * \param[inout] buffer Buffer to append to.
+ * \param[in] x Value to append.
+ */
+template <typename T>
+void append(std::vector<char> &buffer, const T &x) {
+  const char *bytes = reinterpret_cast<const char *>(&x);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+}  // namespace
+
+std::filesystem::path ParticleSnapshot::path(const std::filesystem::path &dir,
+                                             sha256::Hash hash) {
+  return dir / ("particles_" + sha256::hash_to_string(hash) + ".snapshot");
+}
+
+void ParticleSnapshot::write(const std::filesystem::path &dir,
+                             sha256::Hash hash) {
+  const ParticleTypeList &types = ParticleType::list_all();
+  // ParticleType overloads operator&, so the address is taken explicitly.
+  const auto index = [&types](const ParticleType &type) {
+    return static_cast<std::uint32_t>(std::addressof(type) - types.data());
+  };
+  std::vector<char> buffer(snapshot_magic, snapshot_magic + 4);
+  append(buffer, snapshot_version);
+  buffer.insert(buffer.end(), hash.begin(), hash.end());
+
+  append(buffer, static_cast<std::uint32_t>(types.size()));
+  for (const ParticleType &type : types) {
+    append(buffer, static_cast<std::uint32_t>(type.name().size()));
+    buffer.insert(buffer.end(), type.name().begin(), type.name().end());
+    append(buffer, type.mass());
+    append(buffer, type.width_at_pole());
+    append(buffer, static_cast<std::int8_t>(type.parity() == Parity::Pos));
+    append(buffer, type.pdgcode().get_decimal());
+  }
+
+  /* Number the decay types in the order they are first referenced. Decay types
+   * are shared by all mothers with the same products, only Dalitz decays
+   * depend on the mother, which is then the only one. */
+  std::map<const DecayType *, std::uint32_t> decay_type_index;
+  std::vector<std::pair<const DecayType *, const ParticleType *>> decay_types;
+  for (const ParticleType &type : types) {
+    for (const auto &mode : type.decay_modes().decay_mode_list()) {
+      if (decay_type_index.emplace(&mode->type(), decay_types.size()).second) {
+        decay_types.emplace_back(&mode->type(), std::addressof(type));
+      }
+    }
+  }
+  append(buffer, static_cast<std::uint32_t>(decay_types.size()));
+  for (const auto &[decay_type, mother] : decay_types) {
+    append(buffer, index(*mother));
+    append(buffer, static_cast<std::int32_t>(decay_type->angular_momentum()));
+    append(buffer,
+           static_cast<std::uint32_t>(decay_type->particle_types().size()));
+    for (const ParticleTypePtr product : decay_type->particle_types()) {
+      append(buffer, index(*product));
+    }
+  }
+  for (const ParticleType &type : types) {
+    const auto &modes = type.decay_modes().decay_mode_list();
+    append(buffer, static_cast<std::uint32_t>(modes.size()));
+    for (const auto &mode : modes) {
+      append(buffer, decay_type_index[&mode->type()]);
+      append(buffer, mode->weight());
+    }
+  }
+
+  /* The temporary file has to be unique among all jobs sharing the directory,
+   * possibly on different hosts. */
+  char host[64] = {};
+  gethostname(host, sizeof(host) - 1);
+  const std::filesystem::path final_path = path(dir, hash);
+  std::filesystem::path temporary_path = final_path;
+  temporary_path += "." + std::string(host) + "." +
+                    std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary);
+    file.write(buffer.data(), buffer.size());
+    file.close();
+    if (!file) {
+      std::error_code ignored;
+      std::filesystem::remove(temporary_path, ignored);
+      throw std::runtime_error("Cannot write " + temporary_path.string() +
+                               ".");
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary_path, final_path, error);
+  if (error) {
+    std::error_code ignored;
+    std::filesystem::remove(temporary_path, ignored);
+    throw std::runtime_error("Cannot publish " + final_path.string() + ": " +
+                             error.message());
+  }
+}
+
+bool ParticleSnapshot::read(const std::filesystem::path &dir,
+                            sha256::Hash hash) {
+  const std::filesystem::path file_path = path(dir, hash);
+  std::ifstream file(file_path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  const std::string data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+
+  /* Everything is read before creating any type, so that a damaged snapshot
+   * leaves the parsing of the input files possible. */
+  std::vector<TypeRecord> type_records;
+  std::vector<DecayTypeRecord> decay_type_records;
+  std::vector<std::vector<DecayModeRecord>> decay_mode_records;
+  try {
+    SnapshotView view(data);
+    if (std::memcmp(view.bytes(4), snapshot_magic, 4) != 0) {
+      throw std::runtime_error("not a particle snapshot");
+    }
+    std::uint32_t version;
+    view.read(version);
+    if (version != snapshot_version) {
+      throw std::runtime_error("format version " + std::to_string(version));
+    }
+    sha256::Hash hash_from_file;
+    std::memcpy(hash_from_file.data(), view.bytes(hash_from_file.size()),
+                hash_from_file.size());
+    if (hash_from_file != hash) {
+      throw std::runtime_error("hash mismatch");
+    }
+
+    std::uint32_t n_types;
+    view.read(n_types);
+    if (n_types > data.size()) {
+      throw std::runtime_error("unexpected end of file");
+    }
+    type_records.resize(n_types);
+    for (TypeRecord &record : type_records) {
+      std::uint32_t name_length;
+      view.read(name_length);
+      record.name.assign(view.bytes(name_length), name_length);
+      view.read(record.mass);
+      view.read(record.width);
+      std::int8_t positive_parity;
+      view.read(positive_parity);
+      record.parity = positive_parity ? Parity::Pos : Parity::Neg;
+      std::int32_t pdg_decimal;
+      view.read(pdg_decimal);
+      record.pdgcode = PdgCode::from_decimal(pdg_decimal);
+    }
+
+    std::uint32_t n_decay_types;
+    view.read(n_decay_types);
+    if (n_decay_types > data.size()) {
+      throw std::runtime_error("unexpected end of file");
+    }
+    decay_type_records.resize(n_decay_types);
+    for (DecayTypeRecord &record : decay_type_records) {
+      record.mother = view.index(n_types);
+      view.read(record.L);
+      std::uint32_t n_products;
+      view.read(n_products);
+      if (n_products != 2 && n_products != 3) {
+        throw std::runtime_error("invalid number of decay products");
+      }
+      for (std::uint32_t i = 0; i < n_products; i++) {
+        record.products.push_back(view.index(n_types));
+      }
+    }
+
+    decay_mode_records.resize(n_types);
+    for (std::vector<DecayModeRecord> &records : decay_mode_records) {
+      std::uint32_t n_modes;
+      view.read(n_modes);
+      if (n_modes > data.size()) {
+        throw std::runtime_error("unexpected end of file");
+      }
+      records.resize(n_modes);
+      for (DecayModeRecord &record : records) {
+        record.decay_type = view.index(n_decay_types);
+        view.read(record.weight);
+      }
+    }
+    if (!view.at_end()) {
+      throw std::runtime_error("trailing data");
+    }
+  } catch (std::exception &error) {
+    logg[LParticleType].warn("Ignoring ", file_path, " (", error.what(),
+                             "), parsing the input files.");
+    return false;
+  }
+
+  ParticleTypeList types;
+  types.reserve(type_records.size());
+  for (TypeRecord &record : type_records) {
+    types.emplace_back(std::move(record.name), record.mass, record.width,
+                       record.parity, record.pdgcode);
+  }
+  ParticleType::set_type_list(std::move(types));
+
+  const ParticleTypeList &all_types = ParticleType::list_all();
+  std::vector<DecayTypePtr> decay_types;
+  decay_types.reserve(decay_type_records.size());
+  for (const DecayTypeRecord &record : decay_type_records) {
+    ParticleTypePtrList products;
+    for (const std::uint32_t product : record.products) {
+      products.push_back(&all_types[product]);
+    }
+    decay_types.push_back(DecayModes::create_decay_type(
+        &all_types[record.mother], std::move(products), record.L));
+  }
+  std::vector<DecayModes> decay_modes(all_types.size());
+  for (std::size_t i = 0; i < all_types.size(); i++) {
+    for (const DecayModeRecord &record : decay_mode_records[i]) {
+      decay_modes[i].add_mode(
+          &all_types[i], std::make_unique<DecayBranch>(
+                             *decay_types[record.decay_type], record.weight));
+    }
+  }
+  DecayModes::set_decaymodes(std::move(decay_types), std::move(decay_modes));
+  return true;
+}
+
+}  // namespace smash
@@ -12,7 +12,8 @@
 #include <assert.h>
 
 #include <algorithm>
-#include <map>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 #include "smash/constants.h"
@@ -26,6 +27,7 @@
 #include "smash/logging.h"
 #include "smash/potential_globals.h"
 #include "smash/stringfunctions.h"
+#include "smash/tabulation.h"
 
 namespace smash {
 static constexpr int LParticleType = LogArea::ParticleType::id;
@@ -46,6 +48,56 @@ ParticleTypePtrList anti_deltas_list;
 ParticleTypePtrList baryon_resonances_list;
 /// Global pointer to the Particle Type list of light nuclei
 ParticleTypePtrList light_nuclei_list;
+
+/// Slot of the hash table from PDG codes to the offsets of the particle types
+struct PdgIndexSlot {
+  /// PDG code of the particle type in this slot
+  PdgCode pdgcode = PdgCode::invalid();
+  /// Offset of the particle type in the type list, 0xffff for an empty slot
+  std::uint16_t index = 0xffff;
+};
+/**
+ * Hash table with open addressing and linear probing from PDG codes to the
+ * offsets in the type list. Its size is a power of two and at least four
+ * times the number of types, so that most look-ups hit the first slot.
+ */
+std::vector<PdgIndexSlot> pdg_index_table;
+/// Number of bits by which the hash of a PDG code is shifted to the right
+int pdg_index_shift = 32;
+
+/**
+ * Multiplicative hash of a PDG code.
+ *
+ * \param[in] pdgcode PDG code to be hashed
+ * 
+eturn Slot of pdg_index_table at which the search for the code starts
+ */
+inline std::size_t pdg_index_hash(PdgCode pdgcode) {
+  return static_cast<std::uint32_t>(pdgcode.dump() * 0x9e3779b9u) >>
+         pdg_index_shift;
+}
+
+/**
+ * Fill pdg_index_table with all particle types.
+ *
+ * \param[in] types The sorted type list
+ */
+void build_pdg_index(const ParticleTypeList &types) {
+  int bits = 4;
+  while ((std::size_t{1} << bits) < 4 * types.size()) {
+    bits++;
+  }
+  pdg_index_shift = 32 - bits;
+  pdg_index_table.assign(std::size_t{1} << bits, PdgIndexSlot{});
+  const std::size_t mask = pdg_index_table.size() - 1;
+  for (std::size_t i = 0; i < types.size(); i++) {
+    std::size_t slot = pdg_index_hash(types[i].pdgcode());
+    while (pdg_index_table[slot].index != 0xffff) {
+      slot = (slot + 1) & mask;
+    }
+    pdg_index_table[slot] = {types[i].pdgcode(), static_cast<uint16_t>(i)};
+  }
+}
 }  // unnamed namespace
 
 const ParticleTypeList &ParticleType::list_all() {
@@ -87,13 +139,16 @@ ParticleTypePtrList &ParticleType::list_light_nuclei() {
 }
 
 const ParticleTypePtr ParticleType::try_find(PdgCode pdgcode) {
-  const auto found = std::lower_bound(
-      all_particle_types->begin(), all_particle_types->end(), pdgcode,
-      [](const ParticleType &l, const PdgCode &r) { return l.pdgcode() < r; });
-  if (found == all_particle_types->end() || found->pdgcode() != pdgcode) {
-    return {};  // The default constructor creates an invalid pointer.
+  const std::size_t mask = pdg_index_table.size() - 1;
+  for (std::size_t slot = pdg_index_hash(pdgcode);; slot = (slot + 1) & mask) {
+    const PdgIndexSlot &entry = pdg_index_table[slot];
+    if (entry.index == 0xffff) {
+      return {};  // The default constructor creates an invalid pointer.
+    }
+    if (entry.pdgcode == pdgcode) {
+      return &(*all_particle_types)[entry.index];
+    }
   }
-  return &*found;
 }
 
 const ParticleType &ParticleType::find(PdgCode pdgcode) {
@@ -132,6 +187,10 @@ ParticleType::ParticleType(std::string n, double m, double w, Parity p,
       isospin_(-1),
       I3_(pdgcode_.isospin3()) {}
 
+ParticleType::ParticleType(ParticleType &&) = default;
+ParticleType &ParticleType::operator=(ParticleType &&) = default;
+ParticleType::~ParticleType() = default;
+
 /**
  * Construct an antiparticle name-string from the given name-string for the
  * particle and its PDG code.
@@ -197,9 +256,7 @@ static std::string chargestr(int charge) {
 }
 
 void ParticleType::create_type_list(const std::string &input) {  // {{{
-  static ParticleTypeList type_list;
-  type_list.clear();  // in case LoadFailure was thrown and caught and we should
-                      // try again
+  ParticleTypeList type_list;
   for (const Line &line : line_parser(input)) {
     std::istringstream lineinput(line.text);
     std::string name;
@@ -311,19 +368,26 @@ void ParticleType::create_type_list(const std::string &input) {  // {{{
     prev_pdg = t.pdgcode();
   }
 
+  set_type_list(std::move(type_list));
+} /*}}}*/
+
+void ParticleType::set_type_list(ParticleTypeList type_list) {
+  static ParticleTypeList all_types;
   if (all_particle_types != nullptr) {
     throw std::runtime_error("Error: Type list was already built!");
   }
-  all_particle_types = &type_list;  // note that type_list is a function-local
+  all_types = std::move(type_list);
+  all_particle_types = &all_types;  // note that all_types is a function-local
                                     // static and thus will live on until after
                                     // main().
+  build_pdg_index(all_types);
 
   // create all isospin multiplets
-  for (const auto &t : type_list) {
+  for (const auto &t : all_types) {
     IsoParticleType::create_multiplet(t);
   }
   // link the multiplets to the types
-  for (auto &t : type_list) {
+  for (auto &t : all_types) {
     t.iso_multiplet_ = IsoParticleType::find(t);
   }
 
@@ -359,7 +423,7 @@ void ParticleType::create_type_list(const std::string &input) {  // {{{
       light_nuclei_list.push_back(&type);
     }
   }
-} /*}}}*/
+}
 
 double ParticleType::min_mass_kinematic() const {
   if (unlikely(min_mass_kinematic_ < 0.)) {
@@ -441,8 +505,13 @@ double ParticleType::total_width(const double m) const {
   if (is_stable()) {
     return w;
   }
+  const DecayModes &decays = decay_modes();
+  const Tabulation &tabulation = decays.total_width_tabulation();
+  if (!tabulation.is_empty() && m <= tabulation.x_max()) {
+    return tabulation.get_value_linear(m);
+  }
   /* Loop over decay modes and sum up all partial widths. */
-  const auto &modes = decay_modes().decay_mode_list();
+  const auto &modes = decays.decay_mode_list();
   for (unsigned int i = 0; i < modes.size(); i++) {
     w = w + partial_width(m, modes[i].get());
   }
@@ -452,6 +521,62 @@ double ParticleType::total_width(const double m) const {
   return w;
 }
 
+double ParticleType::hadronic_width(const double m) const {
+  double w = 0.;
+  if (is_stable()) {
+    return w;
+  }
+  const DecayModes &decays = decay_modes();
+  const Tabulation &tabulation = decays.hadronic_width_tabulation();
+  if (!tabulation.is_empty() && m <= tabulation.x_max()) {
+    return tabulation.get_value_linear(m);
+  }
+  for (const auto &mode : decays.decay_mode_list()) {
+    if (wanted_decaymode(mode->type(), WhichDecaymodes::Hadronic)) {
+      w += partial_width(m, mode.get());
+    }
+  }
+  return w;
+}
+
+/// Range of the tabulated spectral functions above the minimal mass [GeV].
+constexpr double spectral_tab_range = 10.;
+/// Number of intervals of the tabulation of the spectral functions.
+constexpr size_t num_spectral_tab_intervals = 4096;
+
+void ParticleType::tabulate_spectral_functions() {
+  for (const ParticleType &type : list_all()) {
+    type.spectral_cdf_.reset();
+    if (type.is_stable()) {
+      continue;
+    }
+    /* As in spectral_function, the masses are transformed with
+     * m = m_pole + width_pole * tan(x), which makes the Cauchy-like
+     * distribution nearly flat. */
+    const double w0 = type.width_at_pole();
+    const double m0 = type.mass();
+    const double m_max = type.min_mass_spectral() + spectral_tab_range;
+    const double x_min = std::atan((type.min_mass_spectral() - m0) / w0);
+    const double x_max = std::atan((m_max - m0) / w0);
+    /* The largest ratio of the full to the simple spectral function on the
+     * grid bounds the rejection sampling above the tabulated range. */
+    double ratio_max = 0.;
+    type.spectral_cdf_ = std::make_unique<Tabulation>(Tabulation::cdf(
+        x_min, x_max, num_spectral_tab_intervals, [&](double x) {
+          const double tanx = std::tan(x);
+          const double m = m0 + w0 * tanx;
+          const double jacobian = w0 * (1.0 + tanx * tanx);
+          const double sf = type.spectral_function_no_norm(m);
+          ratio_max = std::max(ratio_max, sf / type.spectral_function_simple(m));
+          return sf * jacobian;
+        }));
+    type.spectral_max_mass_ = m_max;
+    // This also fixes the normalization before any threads are started.
+    type.spectral_function(m0);
+    type.spectral_ratio_max_ = std::max(1., ratio_max * type.norm_factor_);
+  }
+}
+
 void ParticleType::check_consistency() {
   for (const ParticleType &ptype : ParticleType::list_all()) {
     if (!ptype.is_stable() && ptype.decay_modes().is_empty()) {
@@ -490,35 +615,28 @@ DecayBranchList ParticleType::get_partial_widths(const FourVector p,
                                                  const ThreeVector x,
                                                  WhichDecaymodes wh) const {
   const auto &decay_mode_list = decay_modes().decay_mode_list();
+  const auto &potential_scales = decay_modes().potential_scales();
   /* Determine whether the decay is affected by the potentials. If it's
    * affected, read the values of the potentials at the position of the
    * particle */
   FourVector UB = FourVector();
   FourVector UI3 = FourVector();
-  if (UB_lat_pointer != nullptr) {
-    UB_lat_pointer->value_at(x, UB);
-  }
-  if (UI3_lat_pointer != nullptr) {
-    UI3_lat_pointer->value_at(x, UI3);
+  if (pot_pointer != nullptr) {
+    if (UB_lat_pointer != nullptr) {
+      UB_lat_pointer->value_at(x, UB);
+    }
+    if (UI3_lat_pointer != nullptr) {
+      UI3_lat_pointer->value_at(x, UI3);
+    }
   }
   /* Loop over decay modes and calculate all partial widths. */
   DecayBranchList partial;
   partial.reserve(decay_mode_list.size());
   for (unsigned int i = 0; i < decay_mode_list.size(); i++) {
-    /* Calculate the sqare root s of the final state particles. */
-    const auto FinalTypes = decay_mode_list[i]->type().particle_types();
-    double scale_B = 0.0;
-    double scale_I3 = 0.0;
-    if (pot_pointer != nullptr) {
-      scale_B += pot_pointer->force_scale(*this).first;
-      scale_I3 += pot_pointer->force_scale(*this).second * isospin3_rel();
-      for (const auto &finaltype : FinalTypes) {
-        scale_B -= pot_pointer->force_scale(*finaltype).first;
-        scale_I3 -= pot_pointer->force_scale(*finaltype).second *
-                    finaltype->isospin3_rel();
-      }
-    }
-    double sqrt_s = (p + UB * scale_B + UI3 * scale_I3).abs();
+    /* Calculate the sqare root s of the final state particles, with the
+     * force scales precomputed for every decay mode. */
+    const auto &scale = potential_scales[i];
+    double sqrt_s = (p + UB * scale.first + UI3 * scale.second).abs();
 
     const double w = partial_width(sqrt_s, decay_mode_list[i].get());
     if (w > 0.) {
@@ -566,11 +684,25 @@ double ParticleType::get_partial_in_width(const double m,
   return w;
 }
 
+double ParticleType::get_partial_in_width(
+    const double m, const ParticleData &p_a, const ParticleData &p_b,
+    const std::vector<std::size_t> &in_modes) const {
+  const auto &decaymodes = decay_modes().decay_mode_list();
+  double w = 0.;
+  for (const std::size_t i : in_modes) {
+    const auto &mode = decaymodes[i];
+    assert(mode->type().has_particles({&p_a.type(), &p_b.type()}));
+    w += mode->type().in_width(mass(), width_at_pole() * mode->weight(), m,
+                               p_a.effective_mass(), p_b.effective_mass());
+  }
+  return w;
+}
+
 double ParticleType::spectral_function(double m) const {
   if (norm_factor_ < 0.) {
     /* Initialize the normalization factor
      * by integrating over the unnormalized spectral function. */
-    static /*thread_local (see #3075)*/ Integrator integrate;
+    static thread_local Integrator integrate;
     const double width = width_at_pole();
     const double m_pole = mass();
     // We transform the integral using m = m_min + width_pole * tan(x), to
@@ -610,6 +742,17 @@ double ParticleType::spectral_function_simple(double m) const {
   return breit_wigner_nonrel(m, mass(), width_at_pole());
 }
 
+double ParticleType::sample_tabulated_mass(double max_mass) const {
+  const double m0 = mass();
+  const double w0 = width_at_pole();
+  const double u_max = spectral_cdf_->get_value_linear(
+      std::atan((max_mass - m0) / w0), Extrapolation::Const);
+  const double x =
+      spectral_cdf_->get_inverse_linear(random::uniform(0., u_max));
+  // Clamp the mass against rounding of the interpolation.
+  return std::clamp(m0 + w0 * std::tan(x), min_mass_spectral(), max_mass);
+}
+
 /* Resonance mass sampling for 2-particle final state */
 double ParticleType::sample_resonance_mass(const double mass_stable,
                                            const double cms_energy,
@@ -624,19 +767,30 @@ double ParticleType::sample_resonance_mass(const double mass_stable,
   // largest possible cm momentum (from smallest mass)
   const double pcm_max = pCM(cms_energy, mass_stable, min_mass);
   const double blw_max = pcm_max * blatt_weisskopf_sqr(pcm_max, L);
+
+  if (spectral_cdf_ && max_mass <= spectral_max_mass_) {
+    /* The spectral function is sampled directly, such that only the
+     * momentum factor, which is largest at the smallest mass, is left for
+     * the rejection. */
+    double mass_res, blw;
+    do {
+      mass_res = sample_tabulated_mass(max_mass);
+      const double pcm = pCM(cms_energy, mass_stable, mass_res);
+      blw = pcm * blatt_weisskopf_sqr(pcm, L);
+    } while (blw < random::uniform(0., blw_max));
+    return mass_res;
+  }
   /* The maximum of the spectral-function ratio 'usually' happens at the
-   * largest mass. However, this is not always the case, therefore we need
-   * and additional fudge factor (determined automatically). Additionally,
-   * a heuristic knowledge is used that usually such mass exist that
-   * spectral_function(m) > spectral_function_simple(m). */
-  const double sf_ratio_max =
-      std::max(1., this->spectral_function(max_mass) /
-                       this->spectral_function_simple(max_mass));
+   * largest mass. However, this is not always the case, therefore the
+   * maximum found on the grid of the tabulation is used as well. It is fixed
+   * at startup, such that the sampling does not depend on other threads. */
+  double q_max = std::max({1., this->spectral_ratio_max_,
+                           this->spectral_function(max_mass) /
+                               this->spectral_function_simple(max_mass)});
 
   double mass_res, val;
   // outer loop: repeat if maximum is too small
   do {
-    const double q_max = sf_ratio_max * this->max_factor1_;
     const double max = blw_max * q_max;  // maximum value for rejection sampling
     // inner loop: rejection sampling
     do {
@@ -655,10 +809,10 @@ double ParticleType::sample_resonance_mass(const double mass_stable,
     // check that we are using the proper maximum value
     if (val > max) {
       logg[LResonances].debug(
-          "maximum is being increased in sample_resonance_mass: ",
-          this->max_factor1_, " ", val / max, " ", this->pdgcode(), " ",
-          mass_stable, " ", cms_energy, " ", mass_res);
-      this->max_factor1_ *= val / max;
+          "maximum is being increased in sample_resonance_mass: ", q_max, " ",
+          val / max, " ", this->pdgcode(), " ", mass_stable, " ", cms_energy,
+          " ", mass_res);
+      q_max *= val / max;
     } else {
       break;  // maximum ok, exit loop
     }
@@ -682,11 +836,33 @@ std::pair<double, double> ParticleType::sample_resonance_masses(
       pCM(cms_energy, t1.min_mass_spectral(), t2.min_mass_spectral());
   const double blw_max = pcm_max * blatt_weisskopf_sqr(pcm_max, L);
 
+  if (t1.spectral_cdf_ && t2.spectral_cdf_ &&
+      max_mass_1 <= t1.spectral_max_mass_ &&
+      max_mass_2 <= t2.spectral_max_mass_) {
+    // Like in sample_resonance_mass, with both spectral functions tabulated.
+    double mass_1, mass_2, blw;
+    do {
+      mass_1 = t1.sample_tabulated_mass(max_mass_1);
+      mass_2 = t2.sample_tabulated_mass(max_mass_2);
+      const double pcm = pCM(cms_energy, mass_1, mass_2);
+      blw = pcm * blatt_weisskopf_sqr(pcm, L);
+    } while (blw < random::uniform(0., blw_max));
+    return {mass_1, mass_2};
+  }
+
+  // maximum of the spectral-function ratios, cf. sample_resonance_mass
+  double q_max = std::max({1., t1.spectral_ratio_max_,
+                           t1.spectral_function(max_mass_1) /
+                               t1.spectral_function_simple(max_mass_1)}) *
+                 std::max({1., t2.spectral_ratio_max_,
+                           t2.spectral_function(max_mass_2) /
+                               t2.spectral_function_simple(max_mass_2)});
+
   double mass_1, mass_2, val;
   // outer loop: repeat if maximum is too small
   do {
-    // maximum value for rejection sampling (determined automatically)
-    const double max = blw_max * t1.max_factor2_;
+    // maximum value for rejection sampling
+    const double max = blw_max * q_max;
     // inner loop: rejection sampling
     do {
       // sample mass from a simple Breit-Wigner (aka Cauchy) distribution
@@ -707,10 +883,10 @@ std::pair<double, double> ParticleType::sample_resonance_masses(
 
     if (val > max) {
       logg[LResonances].debug(
-          "maximum is being increased in sample_resonance_masses: ",
-          t1.max_factor2_, " ", val / max, " ", t1.pdgcode(), " ", t2.pdgcode(),
-          " ", cms_energy, " ", mass_1, " ", mass_2);
-      t1.max_factor2_ *= val / max;
+          "maximum is being increased in sample_resonance_masses: ", q_max,
+          " ", val / max, " ", t1.pdgcode(), " ", t2.pdgcode(), " ",
+          cms_energy, " ", mass_1, " ", mass_2);
+      q_max *= val / max;
     } else {
       break;  // maximum ok, exit loop
     }
@@ -767,63 +943,14 @@ std::ostream &operator<<(std::ostream &out, const ParticleType &type) {
              << ", spin:" << field<2> << pdg.spin() << "/2 ]";
 }
 
-/*
- * This is valid for two particles of the same species because the comparison
- * operator for smart pointers compares the pointed object. In this case, the
- * `std::set<ParticleTypePtr> incoming` will contain one element instead of two.
- */
 ParticleTypePtrList list_possible_resonances(const ParticleTypePtr type_a,
                                              const ParticleTypePtr type_b) {
-  static std::map<std::set<ParticleTypePtr>, ParticleTypePtrList>
-      map_possible_resonances_of;
-  std::set<ParticleTypePtr> incoming{type_a, type_b};
-  const ParticleTypePtrList incoming_types = {type_a, type_b};
-  // Fill map if set is not yet present
-  if (map_possible_resonances_of.count(incoming) == 0) {
-    logg[LResonances].debug()
-        << "Filling map of compatible resonances for ptypes " << type_a->name()
-        << " " << type_b->name();
-    ParticleTypePtrList resonance_list{};
-    // The tests below are redundant as the decay modes already obey them, but
-    // they are quicker to check and so improve performance.
-    for (const ParticleType &resonance : ParticleType::list_all()) {
-      /* Not a resonance, go to next type of particle */
-      if (resonance.is_stable()) {
-        continue;
-      }
-      // Same resonance as in the beginning, ignore
-      if ((resonance.pdgcode() == type_a->pdgcode()) ||
-          (resonance.pdgcode() == type_b->pdgcode())) {
-        continue;
-      }
-      // Check for charge conservation.
-      if (resonance.charge() != type_a->charge() + type_b->charge()) {
-        continue;
-      }
-      // Check for baryon-number conservation.
-      if (resonance.baryon_number() !=
-          type_a->baryon_number() + type_b->baryon_number()) {
-        continue;
-      }
-      // Check for strangeness conservation.
-      if (resonance.strangeness() !=
-          type_a->strangeness() + type_b->strangeness()) {
-        continue;
-      }
-      const auto &decaymodes = resonance.decay_modes().decay_mode_list();
-      for (const auto &mode : decaymodes) {
-        if (mode->type().has_particles(incoming_types)) {
-          resonance_list.push_back(&resonance);
-          break;
-        }
-      }
-    }
-    // Here `resonance_list` can be empty, corresponding to the case where there
-    // are no possible resonances.
-    map_possible_resonances_of[incoming] = resonance_list;
+  ParticleTypePtrList resonance_list{};
+  for (const auto &candidate :
+       DecayModes::formation_candidates(type_a, type_b)) {
+    resonance_list.push_back(candidate.resonance);
   }
-
-  return map_possible_resonances_of[incoming];
+  return resonance_list;
 }
 
 }  // namespace smash
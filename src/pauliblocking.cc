@@ -9,6 +9,11 @@
 
 #include "smash/pauliblocking.h"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
 #include "smash/constants.h"
 #include "smash/logging.h"
 
@@ -37,59 +42,214 @@ PauliBlocker::PauliBlocker(Configuration conf,
         "be larger than Spatial_Averaging_Radius");
   }
 
+  if (conf.take({"Momentum_Cells"}, false) && rp_ > 0.) {
+    // The momentum sphere of a density overlaps at most two cells per axis.
+    momentum_cell_length_ = 2. * rp_;
+  }
+
   init_weights_analytical();
 }
 
 PauliBlocker::~PauliBlocker() {}
 
+double PauliBlocker::contribution(const ParticleData &part,
+                                  const ThreeVector &r, const ThreeVector &p,
+                                  const std::vector<int> &disregard_ids) const {
+  // Only consider momenta in sphere of radius rp_ with center at p
+  const double pdist_sqr = (part.momentum().threevec() - p).sqr();
+  if (pdist_sqr > rp_ * rp_) {
+    return 0.;
+  }
+  const double rdist_sqr = (part.position().threevec() - r).sqr();
+  // Only consider coordinates in sphere of radius rr_+rc_ with center at r
+  if (rdist_sqr >= (rr_ + rc_) * (rr_ + rc_)) {
+    return 0.;
+  }
+  // Do not count particles that should be disregarded.
+  if (std::binary_search(disregard_ids.begin(), disregard_ids.end(),
+                         part.id())) {
+    return 0.;
+  }
+  // 1st order interpolation using tabulated values
+  const double i_real = std::sqrt(rdist_sqr) / (rr_ + rc_) * weights_.size();
+  const size_t i = std::floor(i_real);
+  const double rest = i_real - i;
+  if (likely(i + 1 < weights_.size())) {
+    return weights_[i] * rest + weights_[i + 1] * (1. - rest);
+  }
+  return 0.;
+}
+
 double PauliBlocker::phasespace_dens(const ThreeVector &r, const ThreeVector &p,
                                      const std::vector<Particles> &ensembles,
                                      const PdgCode pdg,
                                      const ParticleList &disregard) const {
+  std::vector<int> disregard_ids;
+  disregard_ids.reserve(disregard.size());
+  for (const auto &disregard_part : disregard) {
+    disregard_ids.push_back(disregard_part.id());
+  }
+  std::sort(disregard_ids.begin(), disregard_ids.end());
+
   double f = 0.0;
+  // The index only contains baryons.
+  if (!index_built_ || !pdg.is_baryon()) {
+    for (const Particles &particles : ensembles) {
+      for (const ParticleData &part : particles) {
+        // Only consider identical particles
+        if (part.pdgcode() == pdg) {
+          f += contribution(part, r, p, disregard_ids);
+        }
+      }  // loop over particles in one ensemble
+    }    // loop over ensembles
+    return f / ntest_ / n_ensembles_;
+  }
 
-  /* TODO(oliiny): looping over all particles is inefficient,
-   * I need only particles within rp_ radius in momentum and
-   * within rr_+rc_ in coordinate space. Some search algorithm might help. */
-  for (const Particles &particles : ensembles) {
-    for (const ParticleData &part : particles) {
-      // Only consider identical particles
-      if (part.pdgcode() != pdg) {
-        continue;
-      }
-      // Only consider momenta in sphere of radius rp_ with center at p
-      const double pdist_sqr = (part.momentum().threevec() - p).sqr();
-      if (pdist_sqr > rp_ * rp_) {
-        continue;
-      }
-      const double rdist_sqr = (part.position().threevec() - r).sqr();
-      // Only consider coordinates in sphere of radius rr_+rc_ with center at r
-      if (rdist_sqr >= (rr_ + rc_) * (rr_ + rc_)) {
-        continue;
+  /* Only the cells around r, and around p with momentum cells, can contain
+   * particles within rr_ + rc_ and rp_. They are summed in the same order as
+   * in the loop over all particles. */
+  static thread_local std::vector<std::pair<int, const ParticleData *>>
+      candidates;
+  candidates.clear();
+  const IndexKey center = index_key(pdg, r, p);
+  std::array<int, 3> p_first = center.momentum_cell;
+  std::array<int, 3> p_last = center.momentum_cell;
+  if (momentum_cell_length_ > 0.) {
+    for (int i = 0; i < 3; i++) {
+      p_first[i] =
+          static_cast<int>(std::floor((p[i] - rp_) / momentum_cell_length_));
+      p_last[i] =
+          static_cast<int>(std::floor((p[i] + rp_) / momentum_cell_length_));
+    }
+  }
+  IndexKey key = center;
+  auto collect = [&]() {
+    const auto cell = index_.find(key);
+    if (cell == index_.end()) {
+      return;
+    }
+    for (const IndexEntry &entry : cell->second) {
+      const Particles &particles = ensembles[entry.ensemble];
+      if (particles.is_valid(entry.particle)) {
+        candidates.emplace_back(entry.ensemble,
+                                &particles.lookup(entry.particle));
       }
-      // Do not count particles that should be disregarded.
-      bool to_disregard = false;
-      for (const auto &disregard_part : disregard) {
-        if (part.id() == disregard_part.id()) {
-          to_disregard = true;
+    }
+  };
+  for (int dx = -1; dx <= 1; dx++) {
+    for (int dy = -1; dy <= 1; dy++) {
+      for (int dz = -1; dz <= 1; dz++) {
+        key.cell = {center.cell[0] + dx, center.cell[1] + dy,
+                    center.cell[2] + dz};
+        for (int px = p_first[0]; px <= p_last[0]; px++) {
+          for (int py = p_first[1]; py <= p_last[1]; py++) {
+            for (int pz = p_first[2]; pz <= p_last[2]; pz++) {
+              key.momentum_cell = {px, py, pz};
+              collect();
+            }
+          }
         }
       }
-      if (to_disregard) {
-        continue;
-      }
-      // 1st order interpolation using tabulated values
-      const double i_real =
-          std::sqrt(rdist_sqr) / (rr_ + rc_) * weights_.size();
-      const size_t i = std::floor(i_real);
-      const double rest = i_real - i;
-      if (likely(i + 1 < weights_.size())) {
-        f += weights_[i] * rest + weights_[i + 1] * (1. - rest);
-      }
-    }  // loop over particles in one ensemble
-  }    // loop over ensembles
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<int, const ParticleData *> &a,
+               const std::pair<int, const ParticleData *> &b) {
+              return a.first != b.first
+                         ? a.first < b.first
+                         : std::less<const ParticleData *>()(a.second,
+                                                              b.second);
+            });
+  for (const auto &candidate : candidates) {
+    f += contribution(*candidate.second, r, p, disregard_ids);
+  }
   return f / ntest_ / n_ensembles_;
 }
 
+PauliBlocker::IndexKey PauliBlocker::index_key(PdgCode pdg,
+                                               const ThreeVector &r,
+                                               const ThreeVector &p) const {
+  IndexKey key{pdg, {}, {}};
+  for (int i = 0; i < 3; i++) {
+    key.cell[i] = static_cast<int>(std::floor(r[i] / index_cell_length_));
+    if (momentum_cell_length_ > 0.) {
+      key.momentum_cell[i] =
+          static_cast<int>(std::floor(p[i] / momentum_cell_length_));
+    }
+  }
+  return key;
+}
+
+void PauliBlocker::add_to_index(int ensemble, const ParticleData &particle) {
+  // Only baryons are checked for Pauli blocking
+  if (!particle.is_baryon()) {
+    return;
+  }
+  const IndexKey key =
+      index_key(particle.pdgcode(), particle.position().threevec(),
+                particle.momentum().threevec());
+  index_[key].push_back({ensemble, particle});
+  indexed_cell_[ensemble][particle.id()] = key;
+}
+
+void PauliBlocker::build_index(const std::vector<Particles> &ensembles,
+                               double end_time) {
+  clear_index();
+  /* Particles move slower than light, so until end_time they are displaced
+   * by at most end_time minus their current time. Enlarging the cells by this
+   * displacement guarantees that the neighboring cells contain all particles
+   * within rr_ + rc_. */
+  double max_displacement = 0.;
+  for (const Particles &particles : ensembles) {
+    for (const ParticleData &part : particles) {
+      max_displacement =
+          std::max(max_displacement, end_time - part.position().x0());
+    }
+  }
+  index_cell_length_ = rr_ + rc_ + max_displacement;
+  indexed_cell_.resize(ensembles.size());
+  for (size_t i_ens = 0; i_ens < ensembles.size(); i_ens++) {
+    for (const ParticleData &part : ensembles[i_ens]) {
+      add_to_index(i_ens, part);
+    }
+  }
+  index_built_ = true;
+}
+
+void PauliBlocker::update_index(int ensemble, const ParticleList &removed,
+                                const ParticleList &added) {
+  if (!index_built_) {
+    return;
+  }
+  auto &cells = indexed_cell_[ensemble];
+  for (const ParticleData &part : removed) {
+    const auto found = cells.find(part.id());
+    if (found == cells.end()) {
+      continue;
+    }
+    std::vector<IndexEntry> &entries = index_[found->second];
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (it->ensemble == ensemble && it->particle.id() == part.id()) {
+        if (std::next(it) != entries.end()) {
+          *it = std::move(entries.back());
+        }
+        entries.pop_back();
+        break;
+      }
+    }
+    cells.erase(found);
+  }
+  for (const ParticleData &part : added) {
+    add_to_index(ensemble, part);
+  }
+}
+
+void PauliBlocker::clear_index() {
+  index_built_ = false;
+  index_.clear();
+  indexed_cell_.clear();
+}
+
 void PauliBlocker::init_weights_analytical() {
   const double pi = M_PI;
   const double sqrt2 = std::sqrt(2.);
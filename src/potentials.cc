@@ -25,7 +25,9 @@ Potentials::Potentials(Configuration conf, const DensityParameters &param)
       use_potentials_outside_lattice_(
           conf.take({"Use_Potentials_Outside_Lattice"},
                     InputKeys::potentials_use_potentials_outside_lattice
-                        .default_value())) {
+                        .default_value())),
+      leapfrog_(conf.take({"Leapfrog"},
+                          InputKeys::potentials_leapfrog.default_value())) {
   if (use_skyrme_) {
     skyrme_a_ = conf.take({"Skyrme", "Skyrme_A"});
     skyrme_b_ = conf.take({"Skyrme", "Skyrme_B"});
@@ -45,6 +47,9 @@ Potentials::Potentials(Configuration conf, const DensityParameters &param)
   }
   if (use_coulomb_) {
     coulomb_r_cut_ = conf.take({"Coulomb", "R_Cut"});
+    coulomb_use_fft_ = conf.take(
+        {"Coulomb", "Use_FFT"},
+        InputKeys::potentials_coulomb_useFFT.default_value());
   }
   if (use_vdf_) {
     saturation_density_ = conf.take({"VDF", "Sat_rhoB"});
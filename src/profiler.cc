@@ -0,0 +1,199 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+
+#include "smash/iomanipulators.h"
+#include "smash/logging.h"
+
+namespace smash {
+static constexpr int LMain = LogArea::Main::id;
+
+thread_local ScopedTimer *ScopedTimer::current_ = nullptr;
+
+Profiler::Profiler()
+    : Profiler({"Grid update", "Action finding", "Action finding after actions",
+                "Action execution", "String fragmentation", "Lattice update",
+                "Momentum update", "Time step", "Timestepless propagation"}) {}
+
+Profiler::Profiler(std::initializer_list<const char *> phase_names) {
+  for (const char *name : phase_names) {
+    add_phase(name);
+  }
+}
+
+std::size_t Profiler::add_phase(std::string name) {
+  phases_.emplace_back();
+  phases_.back().name = std::move(name);
+  return phases_.size() - 1;
+}
+
+std::size_t Profiler::thread_index() {
+  static std::atomic<std::size_t> n_threads{0};
+  thread_local const std::size_t index = n_threads++;
+  return index;
+}
+
+void Profiler::trace(std::size_t phase,
+                     std::chrono::steady_clock::time_point begin,
+                     std::chrono::nanoseconds duration) {
+  const int64_t begin_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(begin - start_)
+          .count();
+  const std::size_t thread = thread_index();
+  std::lock_guard<std::mutex> lock(trace_mutex_);
+  trace_.push_back({phase, thread, events_.size(), begin_ns, duration.count()});
+}
+
+std::string Profiler::end_event() {
+  Breakdown event(phases_.size());
+  for (std::size_t i = 0; i < phases_.size(); i++) {
+    Phase &p = phases_[i];
+    event[i] = {p.event_ns.exchange(0), p.event_calls.exchange(0)};
+    p.run_ns += event[i].first;
+    p.run_calls += event[i].second;
+  }
+  events_.push_back(event);
+  return report(event);
+}
+
+std::string Profiler::run_report() const { return report(run_breakdown()); }
+
+Profiler::Breakdown Profiler::run_breakdown() const {
+  Breakdown run(phases_.size());
+  for (std::size_t i = 0; i < phases_.size(); i++) {
+    run[i] = {phases_[i].run_ns, phases_[i].run_calls};
+  }
+  return run;
+}
+
+std::string Profiler::report(const Breakdown &breakdown) const {
+  const uint64_t total_ns = std::accumulate(
+      breakdown.begin(), breakdown.end(), uint64_t{0},
+      [](uint64_t sum, const auto &phase) { return sum + phase.first; });
+  std::vector<std::size_t> order(breakdown.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t a, std::size_t b) {
+                     return breakdown[a].first > breakdown[b].first;
+                   });
+  std::size_t name_width = 5;
+  for (const Phase &p : phases_) {
+    name_width = std::max(name_width, p.name.size());
+  }
+
+  std::ostringstream ss;
+  ss << std::left << std::setw(name_width) << "Phase" << std::right
+     << "     Time[s]  Share[%]        Calls";
+  for (std::size_t i : order) {
+    if (breakdown[i].second == 0) {
+      continue;
+    }
+    const double seconds = breakdown[i].first * 1e-9;
+    const double share =
+        total_ns > 0 ? 100. * breakdown[i].first / total_ns : 0.;
+    ss << '\n'
+       << std::left << std::setw(name_width) << phases_[i].name << std::right
+       << field<12, 4> << seconds << field<9, 1> << share << field<12, 0>
+       << breakdown[i].second;
+  }
+  return ss.str();
+}
+
+void Profiler::write_json(std::ostream &out) const {
+  auto write_breakdown = [&](const Breakdown &breakdown,
+                             const std::string &indent) {
+    out << "{";
+    bool first = true;
+    for (std::size_t i = 0; i < breakdown.size(); i++) {
+      if (breakdown[i].second == 0) {
+        continue;
+      }
+      out << (first ? "\n" : ",\n") << indent << "  "
+          << std::quoted(phases_[i].name)
+          << ": {\"seconds\": " << breakdown[i].first * 1e-9
+          << ", \"calls\": " << breakdown[i].second << "}";
+      first = false;
+    }
+    out << (first ? "}" : "\n" + indent + "}");
+  };
+  out << std::setprecision(6) << "{\n  \"run\": ";
+  write_breakdown(run_breakdown(), "  ");
+  out << ",\n  \"events\": [";
+  for (std::size_t i = 0; i < events_.size(); i++) {
+    out << (i == 0 ? "\n    " : ",\n    ");
+    write_breakdown(events_[i], "    ");
+  }
+  out << (events_.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+void Profiler::write_trace(std::ostream &out) const {
+  std::size_t n_threads = 0;
+  for (const TraceEvent &e : trace_) {
+    n_threads = std::max(n_threads, e.thread + 1);
+  }
+  // Times are given in microseconds
+  out << std::fixed << std::setprecision(3) << "{\"traceEvents\": [\n"
+      << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+         "\"args\": {\"name\": \"SMASH\"}}";
+  for (std::size_t thread = 0; thread < n_threads; thread++) {
+    out << ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+           "\"tid\": "
+        << thread << ", \"args\": {\"name\": \"Thread " << thread << "\"}}";
+  }
+  for (const TraceEvent &e : trace_) {
+    out << ",\n  {\"name\": " << std::quoted(phases_[e.phase].name)
+        << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.thread
+        << ", \"ts\": " << e.begin_ns * 1e-3
+        << ", \"dur\": " << e.duration_ns * 1e-3
+        << ", \"args\": {\"event\": " << e.event << "}}";
+  }
+  out << "\n],\n\"displayTimeUnit\": \"ms\"}\n";
+}
+
+namespace {
+/// Profiler of the stages of StartupStage, enabled from its creation
+struct StartupProfiler : Profiler {
+  StartupProfiler()
+      : Profiler({"Configuration", "Particles and decay modes",
+                  "Decay tabulations", "Cross-section integrals",
+                  "Phase-space integrals", "Width tabulations",
+                  "Parametrization interpolations", "Spectral functions",
+                  "Experiment setup", "Action finders", "Outputs",
+                  "Potentials", "Lattices", "Thermalizer"}) {
+    set_enabled(true);
+  }
+};
+}  // namespace
+
+Profiler &startup_profiler() {
+  static StartupProfiler profiler;
+  return profiler;
+}
+
+void log_startup_profile() {
+  static std::once_flag logged;
+  std::call_once(logged, [] {
+    Profiler &profiler = startup_profiler();
+    const double seconds = profiler.elapsed().count() * 1e-9;
+    logg[LMain].info() << "Startup took " << seconds
+                       << " s until the first event:\n"
+                       << profiler.end_event();
+  });
+}
+
+}  // namespace smash
@@ -9,10 +9,15 @@
 
 #include "smash/propagation.h"
 
+#include <algorithm>
+#include <atomic>
+#include <optional>
+
 #include "smash/boxmodus.h"
 #include "smash/collidermodus.h"
 #include "smash/listmodus.h"
 #include "smash/logging.h"
+#include "smash/parallel.h"
 #include "smash/spheremodus.h"
 
 namespace smash {
@@ -41,55 +46,98 @@ double calc_hubble(double time, const ExpansionProperties &metric) {
   return h;
 }
 
-double propagate_straight_line(Particles *particles, double to_time,
-                               const std::vector<FourVector> &beam_momentum) {
-  bool negative_dt_error = false;
-  double dt = 0.0;
-  for (ParticleData &data : *particles) {
-    const double t0 = data.position().x0();
-    dt = to_time - t0;
-    if (dt < 0.0 && !negative_dt_error) {
-      // Print error message once, not for every particle
-      negative_dt_error = true;
-      logg[LPropagation].error("propagate_straight_line - negative dt = ", dt);
+/**
+ * Call \p f for every particle. With several threads, the storage is split
+ * into one range per thread, if there are enough particles to make up for
+ * starting the threads.
+ *
+ * \param[inout] particles The particles
+ * \param[in] n_threads Number of threads
+ * \param[in] f Function called for every particle, from several threads
+ */
+template <typename F>
+static void for_each_particle(Particles *particles, int n_threads,
+                              const F &f) {
+  constexpr int min_particles_per_thread = 4096;
+  const int n_workers =
+      std::clamp(static_cast<int>(particles->size()) / min_particles_per_thread,
+                 1, std::max(1, n_threads));
+  if (n_workers == 1) {
+    for (ParticleData &data : *particles) {
+      f(data);
     }
-    assert(dt >= 0.0);
-    /* "Frozen Fermi motion": Fermi momenta are only used for collisions,
-     * but not for propagation. This is done to avoid nucleus flying apart
-     * even if potentials are off. Initial nucleons before the first collision
-     * are propagated only according to beam momentum.
-     * Initial nucleons are distinguished by data.id() < the size of
-     * beam_momentum, which is by default zero except for the collider modus
-     * with the fermi motion == frozen.
-     * todo(m. mayer): improve this condition (see comment #11 issue #4213)*/
-    assert(data.id() >= 0);
-    const bool avoid_fermi_motion =
-        (static_cast<uint64_t>(data.id()) <
-         static_cast<uint64_t>(beam_momentum.size())) &&
-        (data.get_history().collisions_per_particle == 0);
-    ThreeVector v;
-    if (avoid_fermi_motion) {
-      const FourVector vbeam = beam_momentum[data.id()];
-      v = vbeam.velocity();
-    } else {
-      v = data.velocity();
+    return;
+  }
+  const std::vector<Particles::iterator> bounds =
+      particles->partition(n_workers);
+  parallel_for(n_workers, n_workers, 1, [&](std::size_t i_range) {
+    for (auto it = bounds[i_range]; it != bounds[i_range + 1]; ++it) {
+      f(*it);
     }
-    const FourVector distance = FourVector(0.0, v * dt);
-    logg[LPropagation].debug("Particle ", data, " motion: ", distance);
-    FourVector position = data.position() + distance;
-    position.set_x0(to_time);
-    data.set_4position(position);
+  });
+}
+
+double propagate_straight_line(ParticleData *data, double to_time,
+                               const std::vector<FourVector> &beam_momentum) {
+  const double dt = to_time - data->position().x0();
+  assert(dt >= 0.0);
+  /* "Frozen Fermi motion": Fermi momenta are only used for collisions,
+   * but not for propagation. This is done to avoid nucleus flying apart
+   * even if potentials are off. Initial nucleons before the first collision
+   * are propagated only according to beam momentum.
+   * Initial nucleons are distinguished by data.id() < the size of
+   * beam_momentum, which is by default zero except for the collider modus
+   * with the fermi motion == frozen.
+   * todo(m. mayer): improve this condition (see comment #11 issue #4213)*/
+  assert(data->id() >= 0);
+  const bool avoid_fermi_motion =
+      (static_cast<uint64_t>(data->id()) <
+       static_cast<uint64_t>(beam_momentum.size())) &&
+      (data->get_history().collisions_per_particle == 0);
+  ThreeVector v;
+  if (avoid_fermi_motion) {
+    const FourVector vbeam = beam_momentum[data->id()];
+    v = vbeam.velocity();
+  } else {
+    v = data->velocity();
   }
+  const FourVector distance = FourVector(0.0, v * dt);
+  logg[LPropagation].debug("Particle ", *data, " motion: ", distance);
+  FourVector position = data->position() + distance;
+  position.set_x0(to_time);
+  data->set_4position(position);
+  return dt;
+}
+
+double propagate_straight_line(Particles *particles, double to_time,
+                               const std::vector<FourVector> &beam_momentum,
+                               int n_threads) {
+  if (particles->is_empty()) {
+    return 0.0;
+  }
+  // The interval of the last particle is returned, as they usually agree.
+  const double dt = to_time - particles->back().position().x0();
+  std::atomic<bool> negative_dt_error = false;
+  for_each_particle(particles, n_threads, [&](ParticleData &data) {
+    const double particle_dt = to_time - data.position().x0();
+    if (particle_dt < 0.0 && !negative_dt_error.exchange(true)) {
+      // Print error message once, not for every particle
+      logg[LPropagation].error("propagate_straight_line - negative dt = ",
+                               particle_dt);
+    }
+    propagate_straight_line(&data, to_time, beam_momentum);
+  });
   return dt;
 }
 
 void expand_space_time(Particles *particles,
                        const ExperimentParameters &parameters,
-                       const ExpansionProperties &metric) {
+                       const ExpansionProperties &metric, int n_threads) {
   const double dt = parameters.labclock->timestep_duration();
-  for (ParticleData &data : *particles) {
+  // The Hubble parameter is the same for all particles.
+  const double h = calc_hubble(parameters.labclock->current_time(), metric);
+  for_each_particle(particles, n_threads, [&](ParticleData &data) {
     // Momentum and position modification to ensure appropriate expansion
-    const double h = calc_hubble(parameters.labclock->current_time(), metric);
     FourVector delta_mom = FourVector(0.0, h * data.momentum().threevec() * dt);
     FourVector expan_dist =
         FourVector(0.0, h * data.position().threevec() * dt);
@@ -100,37 +148,50 @@ void expand_space_time(Particles *particles,
     FourVector position = data.position() + expan_dist;
     FourVector momentum = data.momentum() - delta_mom;
 
-    // set the new momentum and position variables
+    // set the new position and force the on shell condition to ensure the
+    // correct energy of the new momentum
     data.set_4position(position);
-    data.set_4momentum(momentum);
-    // force the on shell condition to ensure correct energy
-    data.set_4momentum(data.pole_mass(), data.momentum().threevec());
-  }
+    data.set_4momentum(data.pole_mass(), momentum.threevec());
+  });
 }
 
-void update_momenta(
-    std::vector<Particles> &ensembles, double dt, const Potentials &pot,
+ParticleForces compute_forces(
+    const std::vector<Particles> &ensembles, const Potentials &pot,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_lat,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *EM_lat,
-    DensityLattice *jB_lat) {
-  // Copy particles from ALL ensembles to a single list before propagation
-  // and calculate potentials from this list
-  ParticleList plist;
-  for (Particles &particles : ensembles) {
-    const ParticleList tmp = particles.copy_to_vector();
-    plist.insert(plist.end(), tmp.begin(), tmp.end());
-  }
+    DensityLattice *jB_lat, int n_threads) {
+  /* Potentials away from the lattices are calculated from the particles of ALL
+   * ensembles near the point of interest. They are only copied and sorted into
+   * cells the first time they are needed, which is never the case if all
+   * forces come from the lattices. */
+  std::optional<ParticleCells> cells;
+  std::once_flag cells_filled;
+  auto all_particles = [&]() -> const ParticleCells & {
+    std::call_once(cells_filled, [&]() {
+      ParticleList plist;
+      for (const Particles &particles : ensembles) {
+        particles.append_to(plist);
+      }
+      cells.emplace(std::move(plist), pot.density_parameters().r_cut());
+    });
+    return *cells;
+  };
 
   bool possibly_use_lattice =
       (pot.use_skyrme() ? (FB_lat != nullptr) : true) &&
       (pot.use_vdf() ? (FB_lat != nullptr) : true) &&
       (pot.use_symmetry() ? (FI3_lat != nullptr) : true);
-  std::pair<ThreeVector, ThreeVector> FB, FI3, EM_fields;
-  double min_time_scale = std::numeric_limits<double>::infinity();
 
-  for (Particles &particles : ensembles) {
-    for (ParticleData &data : particles) {
+  /* The forces on the particles of one ensemble are computed, without
+   * changing any momentum, such that all forces see the same particles. Unset
+   * forces belong to particles that are not affected by the potentials. */
+  ParticleForces forces(ensembles.size());
+  auto compute_ensemble_forces = [&](std::size_t i_ens) {
+    std::pair<ThreeVector, ThreeVector> FB, FI3, EM_fields;
+    forces[i_ens].reserve(ensembles[i_ens].size());
+    for (const ParticleData &data : ensembles[i_ens]) {
+      std::optional<ThreeVector> &force = forces[i_ens].emplace_back();
       // Only baryons and nuclei will be affected by the potentials
       if (!(data.is_baryon() || data.is_nucleus())) {
         continue;
@@ -155,43 +216,61 @@ void update_momenta(
         FI3 = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
       }
       if (!use_lattice) {
-        const auto tmp = pot.all_forces(r, plist);
+        const auto tmp = pot.all_forces(r, all_particles());
         FB = std::make_pair(std::get<0>(tmp), std::get<1>(tmp));
         FI3 = std::make_pair(std::get<2>(tmp), std::get<3>(tmp));
       }
       /* Floating point traps should be raised if the force is not overwritten
        * with a meaningful value */
       const auto sNaN = std::numeric_limits<double>::signaling_NaN();
-      ThreeVector force(sNaN, sNaN, sNaN);
+      force = ThreeVector(sNaN, sNaN, sNaN);
       if (pot.use_momentum_dependence()) {
         ThreeVector energy_grad = pot.single_particle_energy_gradient(
             jB_lat, data.position().threevec(), data.momentum().threevec(),
-            data.effective_mass(), plist);
-        force = -energy_grad * scale.first;
-        force +=
+            data.effective_mass(), all_particles);
+        *force = -energy_grad * scale.first;
+        *force +=
             scale.second * data.type().isospin3_rel() *
             (FI3.first + data.momentum().velocity().cross_product(FI3.second));
       } else {
-        force = scale.first *
-                    (FB.first +
-                     data.momentum().velocity().cross_product(FB.second)) +
-                scale.second * data.type().isospin3_rel() *
-                    (FI3.first +
-                     data.momentum().velocity().cross_product(FI3.second));
+        *force = scale.first *
+                     (FB.first +
+                      data.momentum().velocity().cross_product(FB.second)) +
+                 scale.second * data.type().isospin3_rel() *
+                     (FI3.first +
+                      data.momentum().velocity().cross_product(FI3.second));
       }
       // Potentially add Lorentz force
       if (pot.use_coulomb() && EM_lat->value_at(r, EM_fields)) {
         // factor hbar*c to convert fields from 1/fm^2 to GeV/fm
-        force += hbarc * data.type().charge() * elementary_charge *
-                 (EM_fields.first +
-                  data.momentum().velocity().cross_product(EM_fields.second));
+        *force += hbarc * data.type().charge() * elementary_charge *
+                  (EM_fields.first +
+                   data.momentum().velocity().cross_product(EM_fields.second));
       }
-      logg[LPropagation].debug("Update momenta: F [GeV/fm] = ", force);
+    }
+  };
+
+  parallel_for(n_threads, ensembles.size(), 1, compute_ensemble_forces);
+  return forces;
+}
+
+void kick_momenta(std::vector<Particles> &ensembles,
+                  const ParticleForces &forces, double dt) {
+  double min_time_scale = std::numeric_limits<double>::infinity();
+  for (std::size_t i_ens = 0; i_ens < ensembles.size(); i_ens++) {
+    auto force = forces[i_ens].cbegin();
+    for (ParticleData &data : ensembles[i_ens]) {
+      const std::optional<ThreeVector> &particle_force = *force++;
+      if (!particle_force) {
+        continue;
+      }
+      logg[LPropagation].debug("Update momenta: F [GeV/fm] = ",
+                               *particle_force);
       data.set_4momentum(data.effective_mass(),
-                         data.momentum().threevec() + force * dt);
+                         data.momentum().threevec() + *particle_force * dt);
 
       // calculate the time scale of the change in momentum
-      const double Force_abs = force.abs();
+      const double Force_abs = particle_force->abs();
       if (Force_abs < really_small) {
         continue;
       }
@@ -213,4 +292,16 @@ void update_momenta(
   }
 }
 
+void update_momenta(
+    std::vector<Particles> &ensembles, double dt, const Potentials &pot,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_lat,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat,
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *EM_lat,
+    DensityLattice *jB_lat, int n_threads) {
+  kick_momenta(ensembles,
+               compute_forces(ensembles, pot, FB_lat, FI3_lat, EM_lat, jB_lat,
+                              n_threads),
+               dt);
+}
+
 }  // namespace smash
@@ -9,6 +9,8 @@
 
 #include "smash/quantumsampling.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <random>
@@ -206,7 +208,8 @@ double QuantumSampling::maximum_of_the_distribution(
 
 /*
  * Initializing the QuantumSampling object triggers calculation of the
- * chemical potential and distribution maximum for all species present.
+ * chemical potential and tabulation of the inverse momentum distribution for
+ * all species present.
  */
 QuantumSampling::QuantumSampling(
     const std::map<PdgCode, int> &initial_multiplicities, double volume,
@@ -236,47 +239,39 @@ QuantumSampling::QuantumSampling(
         spin_degeneracy, particle_mass, number_density, temperature_,
         quantum_statistics, solution_precision);
     effective_chemical_potentials_[pdg] = chemical_potential;
-    const double distribution_function_maximum = maximum_of_the_distribution(
-        particle_mass, temperature_, chemical_potential, quantum_statistics,
-        solution_precision);
-    distribution_function_maximums_[pdg] = distribution_function_maximum;
+    /*
+     * The distribution is negligible 40 T above the larger of the mass and
+     * the chemical potential; as for the former rejection sampling, no
+     * particle is assumed to have a momentum larger than 10 GeV.
+     */
+    constexpr double maximum_momentum = 10.0;  // in [GeV]
+    const double energy_max =
+        std::max(particle_mass, chemical_potential) + 40.0 * temperature_;
+    const double momentum_max =
+        std::min(maximum_momentum, std::sqrt(energy_max * energy_max -
+                                             particle_mass * particle_mass));
+    momentum_inverse_cdfs_[pdg] =
+        Tabulation::inverse_cdf(0., momentum_max, [&](double p) {
+          // Avoid 0 / 0 for Bose statistics with a chemical potential at the
+          // mass, the single point does not matter for the integral.
+          if (p <= 0.) {
+            return 0.;
+          }
+          return p * p *
+                 juttner_distribution_func(p, particle_mass, temperature_,
+                                           chemical_potential,
+                                           quantum_statistics);
+        });
   }
 }
 
 /*
  * Sampling radial momenta of given particle species from Bose, Boltzmann, or
- * Fermi distribution. The choice between the distributions is made based on
- * the <statistics> variable:
- * -1 for Bose
- *  0 fot Boltzmann
- * +1 for Fermi
- *
- * This sampler is the simplest implementation of sampling based on sampling
- * from a uniform distribution.
+ * Fermi distribution, by evaluating the tabulated inverse of the cumulative
+ * distribution at a uniformly distributed number.
  */
-double QuantumSampling::sample(const PdgCode pdg) {
-  const ParticleType &ptype = ParticleType::find(pdg);
-  const double mass = ptype.mass();
-  const double mu = effective_chemical_potentials_.find(pdg)->second;
-  const double distr_max = distribution_function_maximums_.find(pdg)->second;
-  /*
-   * The variable maximum_momentum denotes the "far right" boundary of the
-   * sampled region; we assume that no particle has momentum larger than 10 GeV
-   */
-  constexpr double maximum_momentum = 10.0;  // in [GeV]
-  const double statistics = (pdg.spin() % 2 == 0) ? -1.0 : 1.0;
-  double sampled_momentum = 0.0, sampled_ratio = 0.0;
-
-  do {
-    sampled_momentum = random::uniform(0.0, maximum_momentum);
-    double distribution_at_sampled_p =
-        sampled_momentum * sampled_momentum *
-        juttner_distribution_func(sampled_momentum, mass, temperature_, mu,
-                                  statistics);
-    sampled_ratio = distribution_at_sampled_p / distr_max;
-  } while (random::canonical() > sampled_ratio);
-
-  return sampled_momentum;
+double QuantumSampling::sample(const PdgCode pdg) const {
+  return momentum_inverse_cdfs_.at(pdg).get_value_linear(random::canonical());
 }
 
 }  // namespace smash
@@ -9,13 +9,69 @@
 
 #include "smash/random.h"
 
+#include <istream>
+#include <ostream>
 #include <random>
 
 #include "smash/logging.h"
 
 namespace smash {
 static constexpr int LGrandcanThermalizer = LogArea::GrandcanThermalizer::id;
-/*thread_local (see #3075)*/ random::Engine random::engine;
+thread_local random::Engine random::engine;
+
+void random::BufferedEngine::seed(result_type value) {
+  // The lanes are initialized with SplitMix64, as recommended for xoshiro.
+  for (std::size_t lane = 0; lane < lanes; lane++) {
+    for (std::size_t word = 0; word < 4; word++) {
+      state_[word][lane] = stream_seed(value, 4 * lane + word);
+    }
+  }
+  position_ = buffer_size;
+}
+
+namespace random {
+
+bool operator==(const BufferedEngine &a, const BufferedEngine &b) {
+  return a.state_ == b.state_ && a.position_ == b.position_ &&
+         std::equal(a.buffer_.begin() + a.position_, a.buffer_.end(),
+                    b.buffer_.begin() + b.position_);
+}
+
+std::ostream &operator<<(std::ostream &out, const BufferedEngine &e) {
+  for (const auto &word : e.state_) {
+    for (uint64_t lane : word) {
+      out << lane << ' ';
+    }
+  }
+  out << e.position_;
+  for (std::size_t i = e.position_; i < BufferedEngine::buffer_size; i++) {
+    out << ' ' << e.buffer_[i];
+  }
+  return out;
+}
+
+std::istream &operator>>(std::istream &in, BufferedEngine &e) {
+  BufferedEngine read;
+  for (auto &word : read.state_) {
+    for (uint64_t &lane : word) {
+      in >> lane;
+    }
+  }
+  in >> read.position_;
+  if (read.position_ > BufferedEngine::buffer_size) {
+    in.setstate(std::ios::failbit);
+  }
+  for (std::size_t i = read.position_; in && i < BufferedEngine::buffer_size;
+       i++) {
+    in >> read.buffer_[i];
+  }
+  if (in) {
+    e = read;
+  }
+  return in;
+}
+
+}  // namespace random
 
 int64_t random::generate_63bit_seed() {
   std::random_device rd;
@@ -70,10 +126,11 @@ random::BesselSampler::BesselSampler(const double poisson_mean1,
   }
 }
 
-std::pair<int, int> random::BesselSampler::sample() {
-  const int N_smaller = (m_ >= m_switch_method_)
-                            ? std::round(random::normal(mu_, sigma_))
-                            : dist_();
+std::pair<int, int> random::BesselSampler::sample(Engine &stream) {
+  const int N_smaller =
+      (m_ >= m_switch_method_)
+          ? std::round(std::normal_distribution<double>(mu_, sigma_)(stream))
+          : dist_(stream);
   return N_is_positive_ ? std::make_pair(N_smaller + N_, N_smaller)
                         : std::make_pair(N_smaller, N_smaller + N_);
 }
@@ -56,7 +56,17 @@ namespace smash {
  * Depending on what it does, the analysis might work fine with both formats,
  * nevertheless, if it is not necessary to know the structure of the whole
  * event, it is recommended to choose the lighter YODA format, thus saving
- * computational time and resources (especially the RAM).
+ * computational time and resources (especially the RAM). With \key YODA,
+ * the interactions are not even passed to the output, and the final
+ * particles are added to the event without keeping track of their
+ * identifiers. The event structure is reused from one event to the next.
+ *
+ * With \key Asynchronous (see \ref key_output_content_asynchronous_), the
+ * events are built and analysed on a thread of their own, fed by a queue of
+ * copies of the particle lists, so that the analysis of an event overlaps with
+ * the evolution of the next one. The Rivet analyses then have to be safe to
+ * run on another thread than the one setting them up, which is the case for
+ * usual analyses.
  *
  * \section rivet_output_user_guide_config_ Configuration
  *
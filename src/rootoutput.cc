@@ -9,6 +9,13 @@
 
 #include "smash/rootoutput.h"
 
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "TBranch.h"
 #include "TFile.h"
 #include "TTree.h"
 #include "smash/action.h"
@@ -19,7 +26,31 @@
 namespace smash {
 static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
 
-const int RootOutput::max_buffer_size_ = 500000;
+namespace {
+/**
+ * Look up the configured compression algorithm of the ROOT files.
+ *
+ * \param[in] par Settings of the ROOT files.
+ * \return Number of the algorithm as used by TFile::SetCompressionAlgorithm.
+ * \throw std::invalid_argument if the algorithm is unknown or the level is
+ *        out of range.
+ */
+int compression_algorithm(const RootOutputParameters &par) {
+  // Values of ROOT::RCompressionSetting::EAlgorithm
+  static const std::map<std::string, int> algorithms = {
+      {"ZLIB", 1}, {"LZMA", 2}, {"LZ4", 4}, {"ZSTD", 5}};
+  const auto algorithm = algorithms.find(par.compression_algorithm);
+  if (algorithm == algorithms.end()) {
+    throw std::invalid_argument("Unknown ROOT compression algorithm \"" +
+                                par.compression_algorithm + "\".");
+  }
+  if (par.compression_level < 0 || par.compression_level > 9) {
+    throw std::invalid_argument(
+        "The ROOT compression level has to be between 0 and 9.");
+  }
+  return algorithm->second;
+}
+}  // namespace
 
 /*!\Userguide
  * \page doxypage_output_root
@@ -238,15 +269,90 @@ RootOutput::RootOutput(const std::filesystem::path &path,
       write_particles_(name == "Particles"),
       write_initial_conditions_(name == "SMASH_IC"),
       particles_only_final_(out_par.part_only_final),
-      autosave_frequency_(1000),
+      autosave_frequency_(out_par.root_parameters.autosave_frequency),
+      root_parameters_(out_par.root_parameters),
       part_extended_(out_par.part_extended),
       coll_extended_(out_par.coll_extended),
       ic_extended_(out_par.ic_extended) {
   filename_unfinished_ = filename_;
   filename_unfinished_ += ".unfinished";
+  if (root_parameters_.basket_size <= 0) {
+    throw std::invalid_argument("The ROOT basket size has to be positive.");
+  }
+  if (autosave_frequency_ < 0) {
+    throw std::invalid_argument(
+        "The ROOT autosave frequency cannot be negative.");
+  }
+  const bool default_compression =
+      root_parameters_.compression_algorithm == "Default";
+  const int algorithm =
+      default_compression ? 0 : compression_algorithm(root_parameters_);
   root_out_file_ =
       std::make_unique<TFile>(filename_unfinished_.native().c_str(), "NEW");
+  if (!default_compression) {
+    root_out_file_->SetCompressionAlgorithm(algorithm);
+    root_out_file_->SetCompressionLevel(root_parameters_.compression_level);
+  }
   init_trees();
+  for (TTree *tree : {particles_tree_, collisions_tree_}) {
+    if (tree) {
+      tree->SetBasketSize("*", root_parameters_.basket_size);
+      tree->SetAutoFlush(root_parameters_.auto_flush);
+    }
+  }
+}
+
+void RootOutput::reserve_buffers(std::size_t n) {
+  if (n <= p0_.size()) {
+    return;
+  }
+  // Grow geometrically to reallocate only a few times.
+  const std::size_t size = std::max(n, 2 * p0_.size());
+  for (std::vector<double> *buffer :
+       {&p0_, &px_, &py_, &pz_, &t_, &x_, &y_, &z_, &formation_time_,
+        &xsec_factor_, &time_last_coll_}) {
+    buffer->resize(size);
+  }
+  for (std::vector<int> *buffer :
+       {&pdgcode_, &charge_, &coll_per_part_, &proc_id_origin_,
+        &proc_type_origin_, &pdg_mother1_, &pdg_mother2_, &baryon_number_,
+        &strangeness_}) {
+    buffer->resize(size);
+  }
+  for (TTree *tree : {particles_tree_, collisions_tree_}) {
+    if (tree) {
+      set_array_addresses(tree);
+    }
+  }
+}
+
+void RootOutput::set_array_addresses(TTree *tree) {
+  const std::pair<const char *, void *> arrays[] = {
+      {"pdgcode", pdgcode_.data()},
+      {"charge", charge_.data()},
+      {"p0", p0_.data()},
+      {"px", px_.data()},
+      {"py", py_.data()},
+      {"pz", pz_.data()},
+      {"t", t_.data()},
+      {"x", x_.data()},
+      {"y", y_.data()},
+      {"z", z_.data()},
+      {"ncoll", coll_per_part_.data()},
+      {"form_time", formation_time_.data()},
+      {"xsecfac", xsec_factor_.data()},
+      {"proc_id_origin", proc_id_origin_.data()},
+      {"proc_type_origin", proc_type_origin_.data()},
+      {"time_last_coll", time_last_coll_.data()},
+      {"pdg_mother1", pdg_mother1_.data()},
+      {"pdg_mother2", pdg_mother2_.data()},
+      {"baryon_number", baryon_number_.data()},
+      {"strangeness", strangeness_.data()}};
+  for (const auto &[name, address] : arrays) {
+    if (TBranch *branch = tree->GetBranch(name)) {
+      branch->SetAddress(address);
+    }
+  }
 }
 
 void RootOutput::init_trees() {
@@ -417,7 +523,8 @@ void RootOutput::at_eventend(const Particles &particles,
   }
   /* Forced regular dump from operational memory to disk. Very demanding!
    * If program crashes written data will NOT be lost. */
-  if (current_event_ > 0 && current_event_ % autosave_frequency_ == 0) {
+  if (autosave_frequency_ > 0 && current_event_ > 0 &&
+      current_event_ % autosave_frequency_ == 0) {
     if (write_particles_ || write_initial_conditions_) {
       particles_tree_->AutoSave("SaveSelf");
     }
@@ -453,62 +560,42 @@ void RootOutput::at_interaction(const Action &action,
 
 template <typename T>
 void RootOutput::particles_to_tree(T &particles) {
+  reserve_buffers(particles.size());
   int i = 0;
 
   ev_ = current_event_;
   tcounter_ = output_counter_;
-  bool exceeded_buffer_message = true;
 
   for (const auto &p : particles) {
-    // Buffer full - flush to tree, else fill with particles
-    if (i >= max_buffer_size_) {
-      if (exceeded_buffer_message) {
-        logg[LOutput].warn()
-            << "\nThe number of particles N = " << particles.size()
-            << " exceeds the maximum buffer size B = " << max_buffer_size_
-            << ".\nceil(N/B) = "
-            << std::ceil(particles.size() /
-                         static_cast<double>(max_buffer_size_))
-            << " separate ROOT Tree entries will be created at this output."
-            << "\nMaximum buffer size (max_buffer_size_) can be changed in "
-            << "rootoutput.h\n\n";
-        exceeded_buffer_message = false;
-      }
-      npart_ = max_buffer_size_;
-      i = 0;
-      particles_tree_->Fill();
-    } else {
-      pdgcode_[i] = p.pdgcode().get_decimal();
-      charge_[i] = p.type().charge();
+    pdgcode_[i] = p.pdgcode().get_decimal();
+    charge_[i] = p.type().charge();
 
-      p0_[i] = p.momentum().x0();
-      px_[i] = p.momentum().x1();
-      py_[i] = p.momentum().x2();
-      pz_[i] = p.momentum().x3();
+    p0_[i] = p.momentum().x0();
+    px_[i] = p.momentum().x1();
+    py_[i] = p.momentum().x2();
+    pz_[i] = p.momentum().x3();
 
-      t_[i] = p.position().x0();
-      x_[i] = p.position().x1();
-      y_[i] = p.position().x2();
-      z_[i] = p.position().x3();
+    t_[i] = p.position().x0();
+    x_[i] = p.position().x1();
+    y_[i] = p.position().x2();
+    z_[i] = p.position().x3();
 
-      if (part_extended_ || ic_extended_) {
-        const auto h = p.get_history();
-        formation_time_[i] = p.formation_time();
-        xsec_factor_[i] = p.xsec_scaling_factor();
-        time_last_coll_[i] = h.time_last_collision;
-        coll_per_part_[i] = h.collisions_per_particle;
-        proc_id_origin_[i] = h.id_process;
-        proc_type_origin_[i] = static_cast<int>(h.process_type);
-        pdg_mother1_[i] = h.p1.get_decimal();
-        pdg_mother2_[i] = h.p2.get_decimal();
-        baryon_number_[i] = p.type().baryon_number();
-        strangeness_[i] = p.type().strangeness();
-      }
-
-      i++;
+    if (part_extended_ || ic_extended_) {
+      const auto h = p.get_history();
+      formation_time_[i] = p.formation_time();
+      xsec_factor_[i] = p.xsec_scaling_factor();
+      time_last_coll_[i] = h.time_last_collision;
+      coll_per_part_[i] = h.collisions_per_particle;
+      proc_id_origin_[i] = h.id_process;
+      proc_type_origin_[i] = static_cast<int>(h.process_type);
+      pdg_mother1_[i] = h.p1.get_decimal();
+      pdg_mother2_[i] = h.p2.get_decimal();
+      baryon_number_[i] = p.type().baryon_number();
+      strangeness_[i] = p.type().strangeness();
     }
+
+    i++;
   }
-  // Flush rest to tree
   if (i > 0) {
     npart_ = i;
     particles_tree_->Fill();
@@ -526,13 +613,9 @@ void RootOutput::collisions_to_tree(const ParticleList &incoming,
   wgt_ = weight;
   par_wgt_ = partial_weight;
 
+  reserve_buffers(npart_);
   int i = 0;
 
-  /* It is assumed that nin + nout < max_buffer_size_
-   * This is true for any possible reaction for current buffer size: 10000
-   * But if one wants initial/final particles written to collisions
-   * then implementation should be updated. */
-
   for (const ParticleList &plist : {incoming, outgoing}) {
     for (const auto &p : plist) {
       pdgcode_[i] = p.pdgcode().get_decimal();
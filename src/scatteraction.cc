@@ -15,6 +15,7 @@
 
 #include "smash/angles.h"
 #include "smash/constants.h"
+#include "smash/crosssectioncache.h"
 #include "smash/crosssections.h"
 #include "smash/fpenvironment.h"
 #include "smash/logging.h"
@@ -53,6 +54,11 @@ void ScatterAction::add_collisions(CollisionBranchList pv) {
 void ScatterAction::generate_final_state() {
   logg[LScatterAction].debug("Incoming particles: ", incoming_particles_);
 
+  if (lazy_finder_parameters_) {
+    add_all_scatterings(*lazy_finder_parameters_, lazy_cache_);
+    lazy_finder_parameters_ = nullptr;
+  }
+
   const CollisionBranch *proc = choose_channel<CollisionBranch>(
       collision_channels_, is_total_parametrized_
                                ? *parametrized_total_cross_section_
@@ -103,10 +109,11 @@ void ScatterAction::generate_final_state() {
           ", PDGcode2=" + incoming_particles_[1].pdgcode().string() + ")");
   }
 
+  // Boost to the computational frame
+  const LorentzBoost to_computational_frame(
+      -total_momentum_of_outgoing_particles().velocity());
   for (ParticleData &new_particle : outgoing_particles_) {
-    // Boost to the computational frame
-    new_particle.boost_momentum(
-        -total_momentum_of_outgoing_particles().velocity());
+    new_particle.boost_momentum(to_computational_frame);
     /* Set positions of the outgoing particles */
     if (proc->get_type() != ProcessType::Elastic) {
       new_particle.set_4position(middle_point);
@@ -115,7 +122,8 @@ void ScatterAction::generate_final_state() {
 }
 
 void ScatterAction::add_all_scatterings(
-    const ScatterActionsFinderParameters &finder_parameters) {
+    const ScatterActionsFinderParameters &finder_parameters,
+    CrossSectionCache *cache) {
   if (were_processes_added_) {
     logg[LScatterAction].fatal() << "Trying to add processes again.";
     throw std::logic_error(
@@ -124,10 +132,18 @@ void ScatterAction::add_all_scatterings(
   } else {
     were_processes_added_ = true;
   }
-  CrossSections xs(incoming_particles_, sqrt_s(),
-                   get_potential_at_interaction_point());
+  const auto potentials = get_potential_at_interaction_point();
+  CrossSections xs(incoming_particles_, sqrt_s(), potentials);
   CollisionBranchList processes =
-      xs.generate_collision_list(finder_parameters, string_process_);
+      (cache && cache->applies_to(incoming_particles_, sqrt_s()))
+          ? cache->branches(incoming_particles_, sqrt_s(),
+                            [&](double cached_sqrt_s) {
+                              return CrossSections(incoming_particles_,
+                                                   cached_sqrt_s, potentials)
+                                  .generate_collision_list(finder_parameters,
+                                                           string_process_);
+                            })
+          : xs.generate_collision_list(finder_parameters, string_process_);
 
   /* Add various subprocesses.*/
   add_collisions(std::move(processes));
@@ -275,13 +291,23 @@ ParticleTypePtr ScatterAction::try_find_pseudoresonance(
 }
 
 void ScatterAction::set_parametrized_total_cross_section(
-    const ScatterActionsFinderParameters &finder_parameters) {
-  CrossSections xs(incoming_particles_, sqrt_s(),
-                   get_potential_at_interaction_point());
+    const ScatterActionsFinderParameters &finder_parameters,
+    CrossSectionCache *cache) {
+  const auto potentials = get_potential_at_interaction_point();
+  CrossSections xs(incoming_particles_, sqrt_s(), potentials);
 
   if (is_total_parametrized_) {
-    parametrized_total_cross_section_ =
-        xs.parametrized_total(finder_parameters);
+    if (cache && cache->applies_to(incoming_particles_, sqrt_s())) {
+      parametrized_total_cross_section_ = cache->total(
+          incoming_particles_, sqrt_s(), [&](double cached_sqrt_s) {
+            return CrossSections(incoming_particles_, cached_sqrt_s,
+                                 potentials)
+                .parametrized_total(finder_parameters);
+          });
+    } else {
+      parametrized_total_cross_section_ =
+          xs.parametrized_total(finder_parameters);
+    }
   } else {
     logg[LScatterAction].fatal()
         << "Trying to parametrize total cross section when it shouldn't be.";
@@ -291,6 +317,18 @@ void ScatterAction::set_parametrized_total_cross_section(
   }
 }
 
+void ScatterAction::add_all_scatterings_lazily(
+    const ScatterActionsFinderParameters &finder_parameters,
+    CrossSectionCache *cache) {
+  if (!is_total_parametrized_ || were_processes_added_) {
+    throw std::logic_error(
+        "Branches can only be added lazily once and for a parametrized total "
+        "cross section.");
+  }
+  lazy_finder_parameters_ = &finder_parameters;
+  lazy_cache_ = cache;
+}
+
 double ScatterAction::get_total_weight() const {
   return sum_of_partial_cross_sections_ *
          incoming_particles_[0].xsec_scaling_factor() *
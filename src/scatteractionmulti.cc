@@ -9,7 +9,11 @@
 
 #include "smash/scatteractionmulti.h"
 
+#include <algorithm>
+#include <array>
 #include <map>
+#include <string>
+#include <vector>
 
 #include "gsl/gsl_sf_ellint.h"
 
@@ -51,6 +55,51 @@ double ScatterActionMulti::get_partial_weight() const {
   return partial_probability_ * xsec_scaling;
 }
 
+std::uint8_t ScatterActionMulti::reaction_mask(
+    const ParticleType& type, const MultiParticleReactionsBitSet incl_multi) {
+  const PdgCode pdg = type.pdgcode();
+  const bool pion = pdg.is_pion();
+  // Nucleons and antinucleons catalyze the formation of nuclei and antinuclei
+  const bool nucleon = pdg.is_nucleon();
+  std::uint8_t mask = 0;
+  if (incl_multi[IncludedMultiParticleReactions::Meson_3to1] == 1) {
+    if (pion) {
+      mask |= ThreePionsToMeson | TwoPionsEtaToMeson;
+    } else if (pdg == pdg::eta) {
+      mask |= TwoPionsEtaToMeson;
+    }
+  }
+  if (incl_multi[IncludedMultiParticleReactions::Deuteron_3to2] == 1 &&
+      (pion || nucleon)) {
+    mask |= NucleonsToDeuteron;
+  }
+  if (incl_multi[IncludedMultiParticleReactions::A3_Nuclei_4to2] == 1) {
+    if (pion || nucleon || pdg == pdg::Lambda) {
+      mask |= NucleonsToA3Nucleus;
+    }
+    if (pion || nucleon || pdg == -pdg::Lambda) {
+      mask |= AntinucleonsToA3Antinucleus;
+    }
+  }
+  if (incl_multi[IncludedMultiParticleReactions::NNbar_5to2] == 1 && pion) {
+    mask |= FivePionsToNucleons;
+  }
+  return mask;
+}
+
+std::uint8_t ScatterActionMulti::reaction_families(std::size_t n_incoming) {
+  switch (n_incoming) {
+    case 3:
+      return ThreePionsToMeson | TwoPionsEtaToMeson | NucleonsToDeuteron;
+    case 4:
+      return NucleonsToA3Nucleus | AntinucleonsToA3Antinucleus;
+    case 5:
+      return FivePionsToNucleons;
+    default:
+      return 0;
+  }
+}
+
 void ScatterActionMulti::add_possible_reactions(
     double dt, const double gcell_vol,
     const MultiParticleReactionsBitSet incl_multi) {
@@ -409,11 +458,18 @@ void ScatterActionMulti::generate_final_state() {
   }
 }
 
-double ScatterActionMulti::calculate_I3(const double sqrts) const {
-  const double m1 = incoming_particles_[0].type().mass();
-  const double m2 = incoming_particles_[1].type().mass();
-  const double m3 = incoming_particles_[2].type().mass();
-
+/**
+ * Evaluate the three-body phase-space integral of
+ * ScatterActionMulti::calculate_I3 with complete elliptic integrals.
+ *
+ * \param[in] m1 Mass of the first particle [GeV]
+ * \param[in] m2 Mass of the second particle [GeV]
+ * \param[in] m3 Mass of the third particle [GeV]
+ * \param[in] sqrts Center of mass energy [GeV]
+ * \return Value of the integral [GeV⁴]
+ */
+static double three_body_integral(double m1, double m2, double m3,
+                                  double sqrts) {
   if (sqrts < m1 + m2 + m3) {
     return 0.0;
   }
@@ -440,6 +496,83 @@ double ScatterActionMulti::calculate_I3(const double sqrts) const {
   return res;
 }
 
+/**
+ * Tabulations of the three-body phase-space integral over the squared kinetic
+ * energy, by the sorted masses of the particles
+ */
+static std::map<std::array<double, 3>, Tabulation> I3_tabulations;
+
+/// Step of the kinetic energy in the tabulations of I3_tabulations [GeV]
+constexpr double I3_tabulation_step = 0.001;
+
+/// Number of intervals of the tabulations of I3_tabulations
+constexpr size_t num_I3_tab_intervals = 3000;
+
+double ScatterActionMulti::calculate_I3(const double sqrts) const {
+  const double m1 = incoming_particles_[0].type().mass();
+  const double m2 = incoming_particles_[1].type().mass();
+  const double m3 = incoming_particles_[2].type().mass();
+
+  const double kinetic_energy = sqrts - m1 - m2 - m3;
+  if (!I3_tabulations.empty() && kinetic_energy >= I3_tabulation_step) {
+    std::array<double, 3> masses{m1, m2, m3};
+    std::sort(masses.begin(), masses.end());
+    const auto found = I3_tabulations.find(masses);
+    if (found != I3_tabulations.end() &&
+        kinetic_energy <= found->second.x_max()) {
+      return kinetic_energy * kinetic_energy *
+             found->second.get_value_linear(kinetic_energy);
+    }
+  }
+  return three_body_integral(m1, m2, m3, sqrts);
+}
+
+std::size_t ScatterActionMulti::tabulate_phase_space_integrals(
+    TabulationBundle& bundle) {
+  // One type for each mass, whose name identifies the tabulations
+  std::map<double, ParticleTypePtr> types_by_mass;
+  for (const ParticleType& type : ParticleType::list_all()) {
+    const PdgCode pdg = type.pdgcode();
+    if (pdg.is_pion() || pdg == pdg::eta || pdg.is_nucleon()) {
+      types_by_mass.emplace(type.mass(), &type);
+    }
+  }
+  ParticleTypePtrList types;
+  for (const auto& entry : types_by_mass) {
+    types.push_back(entry.second);
+  }
+  std::size_t n_added = 0;
+  I3_tabulations.clear();
+  for (std::size_t i = 0; i < types.size(); i++) {
+    for (std::size_t j = i; j < types.size(); j++) {
+      for (std::size_t k = j; k < types.size(); k++) {
+        const std::array<double, 3> masses{
+            types[i]->mass(), types[j]->mass(), types[k]->mass()};
+        const std::string name = "phase_space_I3_" +
+                                 types[i]->pdgcode().string() + "_" +
+                                 types[j]->pdgcode().string() + "_" +
+                                 types[k]->pdgcode().string();
+        if (const Tabulation* cached = bundle.find(name)) {
+          I3_tabulations[masses] = *cached;
+          continue;
+        }
+        const double m_sum = masses[0] + masses[1] + masses[2];
+        Tabulation tabulation(
+            I3_tabulation_step, I3_tabulation_step * num_I3_tab_intervals,
+            num_I3_tab_intervals, [&](double kinetic_energy) {
+              return three_body_integral(masses[0], masses[1], masses[2],
+                                         m_sum + kinetic_energy) /
+                     (kinetic_energy * kinetic_energy);
+            });
+        bundle.insert(name, tabulation);
+        I3_tabulations[masses] = tabulation;
+        n_added++;
+      }
+    }
+  }
+  return n_added;
+}
+
 double ScatterActionMulti::probability_three_to_one(
     const ParticleType& type_out, double dt, const double gcell_vol,
     const int degen_sym_factor) const {
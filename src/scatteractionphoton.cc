@@ -199,31 +199,18 @@ void ScatterActionPhoton::generate_final_state() {
   outgoing_particles_ = proc->particle_list();
   process_type_ = proc->get_type();
 
-  FourVector middle_point = get_interaction_point();
-
-  // t is defined to be the momentum exchanged between the rho meson and the
-  // photon in pi + rho -> pi + photon channel. Therefore,
-  // get_t_range needs to be called with m2 being the rho mass instead of the
-  // pion mass. So, particles 1 and 2 are swapped if necessary.
-
-  if (!incoming_particles_[0].pdgcode().is_pion()) {
-    std::swap(incoming_particles_[0], incoming_particles_[1]);
-  }
-
-  // 2->2 inelastic scattering
-  // Sample the particle momenta in CM system
-  const double m1 = incoming_particles_[0].effective_mass();
-  const double m2 = incoming_particles_[1].effective_mass();
+  const FinalStateKinematics &kinematics = final_state_kinematics();
+  const double m1 = kinematics.m1;
+  const double m2 = kinematics.m2;
 
   const double &m_out = hadron_out_mass_;
 
-  const double s = mandelstam_s();
-  const double sqrts = sqrt_s();
-  std::array<double, 2> mandelstam_t = get_t_range(sqrts, m1, m2, m_out, 0.0);
-  const double t1 = mandelstam_t[1];
-  const double t2 = mandelstam_t[0];
-  const double pcm_in = cm_momentum();
-  const double pcm_out = pCM(sqrts, m_out, 0.0);
+  const double s = kinematics.s;
+  const double sqrts = kinematics.sqrts;
+  const double t1 = kinematics.t1;
+  const double t2 = kinematics.t2;
+  const double pcm_in = kinematics.pcm_in;
+  const double pcm_out = kinematics.pcm_out;
 
   const double t = random::uniform(t1, t2);
 
@@ -251,9 +238,8 @@ void ScatterActionPhoton::generate_final_state() {
 
   // Set positions & boost to computational frame.
   for (ParticleData &new_particle : outgoing_particles_) {
-    new_particle.set_4position(middle_point);
-    new_particle.boost_momentum(
-        -total_momentum_of_outgoing_particles().velocity());
+    new_particle.set_4position(kinematics.interaction_point);
+    new_particle.boost_momentum(-kinematics.velocity_cm);
   }
 
   const double E_Photon = outgoing_particles_[1].momentum()[0];
@@ -285,6 +271,39 @@ void ScatterActionPhoton::generate_final_state() {
   Action::check_conservation(id_process);
 }
 
+const ScatterActionPhoton::FinalStateKinematics &
+ScatterActionPhoton::final_state_kinematics() {
+  if (kinematics_) {
+    return *kinematics_;
+  }
+  // t is defined to be the momentum exchanged between the rho meson and the
+  // photon in pi + rho -> pi + photon channel. Therefore,
+  // get_t_range needs to be called with m2 being the rho mass instead of the
+  // pion mass. So, particles 1 and 2 are swapped if necessary.
+  if (!incoming_particles_[0].pdgcode().is_pion()) {
+    std::swap(incoming_particles_[0], incoming_particles_[1]);
+  }
+
+  // 2->2 inelastic scattering
+  // Sample the particle momenta in CM system
+  const double m1 = incoming_particles_[0].effective_mass();
+  const double m2 = incoming_particles_[1].effective_mass();
+  const double sqrts = sqrt_s();
+  std::array<double, 2> mandelstam_t =
+      get_t_range(sqrts, m1, m2, hadron_out_mass_, 0.0);
+  kinematics_ = {get_interaction_point(),
+                 total_momentum_of_outgoing_particles().velocity(),
+                 mandelstam_s(),
+                 sqrts,
+                 m1,
+                 m2,
+                 mandelstam_t[1],
+                 mandelstam_t[0],
+                 cm_momentum(),
+                 pCM(sqrts, hadron_out_mass_, 0.0)};
+  return *kinematics_;
+}
+
 void ScatterActionPhoton::add_dummy_hadronic_process(
     double reaction_cross_section) {
   CollisionBranchPtr dummy_process = std::make_unique<CollisionBranch>(
@@ -347,8 +366,13 @@ CollisionBranchList ScatterActionPhoton::create_collision_branch() {
   return process_list;
 }
 
-double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
-  CollisionBranchList process_list;
+double ScatterActionPhoton::analytic_total_cross_section(
+    MediatorType mediator) const {
+  std::optional<double> &cached =
+      analytic_cross_sections_[static_cast<std::size_t>(mediator)];
+  if (cached) {
+    return *cached;
+  }
   CrosssectionsPhoton<ComputationMethod::Analytic> xs_object;
 
   const double s = mandelstam_s();
@@ -376,7 +400,10 @@ double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
     case ReactionType::pi_m_rho_p_pi_z:
     case ReactionType::pi_p_rho_m_pi_z:
       if (mediator == MediatorType::SUM) {
-        xsection = xs_object.xs_pi_rho_pi0(s, m_rho);
+        // Identical to xs_pi_rho_pi0, but reuses the single channels needed
+        // for the form factors.
+        xsection = cut_off(analytic_total_cross_section(MediatorType::PION) +
+                           analytic_total_cross_section(MediatorType::OMEGA));
         break;
       } else if (mediator == MediatorType::PION) {
         xsection = xs_object.xs_pi_rho_pi0_rho_mediated(s, m_rho);
@@ -390,7 +417,9 @@ double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
     case ReactionType::pi_z_rho_m_pi_m:
     case ReactionType::pi_z_rho_p_pi_p:
       if (mediator == MediatorType::SUM) {
-        xsection = xs_object.xs_pi0_rho_pi(s, m_rho);
+        // Identical to xs_pi0_rho_pi, see above.
+        xsection = cut_off(analytic_total_cross_section(MediatorType::PION) +
+                           analytic_total_cross_section(MediatorType::OMEGA));
         break;
       } else if (mediator == MediatorType::PION) {
         xsection = xs_object.xs_pi0_rho_pi_rho_mediated(s, m_rho);
@@ -410,6 +439,12 @@ double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
       // never reached
       break;
   }
+  cached = xsection;
+  return xsection;
+}
+
+double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
+  double xsection = analytic_total_cross_section(mediator);
 
   if (xsection == 0.0) {
     // Vanishing cross sections are problematic for the creation of a
@@ -431,7 +466,7 @@ double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
     xsection = 0.1;
     logg[LScatterAction].warn(
         "Calculated negative cross section.\nParticles ", incoming_particles_,
-        " mass rho particle: ", m_rho, ", sqrt_s: ", std::sqrt(s));
+        " mass rho particle: ", rho_mass(), ", sqrt_s: ", sqrt_s());
   }
   return xsection;
 }
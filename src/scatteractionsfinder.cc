@@ -10,7 +10,12 @@
 #include "smash/scatteractionsfinder.h"
 
 #include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "smash/constants.h"
@@ -31,17 +36,39 @@ static constexpr int LFindScatter = LogArea::FindScatter::id;
  *
  */
 
+/**
+ * \param[in] finder_parameters Parameters of the collisions.
+ * \return Whether all two-body collisions are elastic with the constant cross
+ *         section given in the configuration.
+ */
+static bool only_constant_elastic(
+    const ScatterActionsFinderParameters& finder_parameters) {
+  const ReactionsBitSet only_elastic =
+      ReactionsBitSet().set(IncludedReactions::Elastic);
+  return finder_parameters.elastic_parameter >= 0. &&
+         finder_parameters.total_xs_strategy ==
+             TotalCrossSectionStrategy::BottomUp &&
+         finder_parameters.included_2to2 == only_elastic &&
+         finder_parameters.included_multi.none() &&
+         !finder_parameters.two_to_one && !finder_parameters.strings_switch &&
+         (finder_parameters.nnbar_treatment == NNbarTreatment::NoAnnihilation ||
+          finder_parameters.nnbar_treatment == NNbarTreatment::Strings);
+}
+
 ScatterActionsFinder::ScatterActionsFinder(
-    Configuration& config, const ExperimentParameters& parameters)
+    Configuration& config, const ExperimentParameters& parameters,
+    int string_workers)
     : finder_parameters_(create_finder_parameters(config, parameters)),
       isotropic_(config.take({"Collision_Term", "Isotropic"}, false)),
+      only_constant_elastic_(
+          isotropic_ && only_constant_elastic(finder_parameters_)),
       box_length_(parameters.box_length),
       string_formation_time_(config.take(
           {"Collision_Term", "String_Parameters", "Formation_Time"}, 1.)) {
   if (is_constant_elastic_isotropic()) {
     logg[LFindScatter].info(
         "Constant elastic isotropic cross-section mode:", " using ",
-        finder_parameters_.elastic_parameter, " mb as maximal cross-section.");
+        constant_elastic_cross_section(), " mb as maximal cross-section.");
   }
   if (finder_parameters_.included_multi.any() &&
       finder_parameters_.coll_crit != CollisionCriterion::Stochastic) {
@@ -101,10 +128,23 @@ ScatterActionsFinder::ScatterActionsFinder(
         "to enable annihilation to go through resonances");
   }
 
+  if (finder_parameters_.included_multi.any()) {
+    for (const ParticleType& type : ParticleType::list_all()) {
+      multi_reaction_masks_.push_back(ScatterActionMulti::reaction_mask(
+          type, finder_parameters_.included_multi));
+    }
+  }
+
   if (finder_parameters_.strings_switch) {
+    /* PYTHIA allocates its memory internally, hence it is estimated by the
+     * growth of the resident memory while setting up the string processes.
+     * The PYTHIA objects of the fragmentation are only set up for the first
+     * string, so this only covers the ones preinitialized for hard strings. */
+    const int64_t resident_before =
+        MemoryTracker::enabled() ? MemoryTracker::resident_bytes() : 0;
     auto subconfig = config.extract_sub_configuration(
         {"Collision_Term", "String_Parameters"}, Configuration::GetEmpty::Yes);
-    string_process_interface_ = std::make_unique<StringProcess>(
+    string_processes_.push_back(std::make_unique<StringProcess>(
         subconfig.take({"String_Tension"}, 1.0), string_formation_time_,
         subconfig.take({"Gluon_Beta"}, 0.5),
         subconfig.take({"Gluon_Pmin"}, 0.001),
@@ -123,7 +163,100 @@ ScatterActionsFinder::ScatterActionsFinder(
         subconfig.take({"Separate_Fragment_Baryon"}, true),
         subconfig.take({"Popcorn_Rate"}, 0.15),
         subconfig.take({"Use_Monash_Tune"},
-                       parameters.use_monash_tune_default.value()));
+                       parameters.use_monash_tune_default.value())));
+    /* Every thread fragments strings with its own PYTHIA objects, which are
+     * seeded for each string, such that the fragmentation does not depend on
+     * the distribution of the ensembles over the threads. */
+    if (string_workers > 1) {
+      string_processes_[0]->set_reseed_per_string(true);
+      for (int i_worker = 1; i_worker < string_workers; i_worker++) {
+        string_processes_.push_back(string_processes_[0]->clone());
+      }
+    }
+    const std::vector<std::vector<int>> pool_beams =
+        subconfig.take({"Pythia_Pool_Beams"},
+                       InputKeys::collTerm_stringParam_pythiaPoolBeams
+                           .default_value());
+    const double pool_sqrts = subconfig.take(
+        {"Pythia_Pool_Sqrts"},
+        InputKeys::collTerm_stringParam_pythiaPoolSqrts.default_value());
+    if (!pool_beams.empty()) {
+      std::vector<std::pair<PdgCode, PdgCode>> beams;
+      for (const auto &beam : pool_beams) {
+        if (beam.size() != 2) {
+          throw std::invalid_argument(
+              "Each entry of Pythia_Pool_Beams has to be a pair of PDG codes.");
+        }
+        beams.emplace_back(PdgCode::from_decimal(beam[0]),
+                           PdgCode::from_decimal(beam[1]));
+      }
+      logg[LFindScatter].info("Initializing PYTHIA for ", beams.size(),
+                              " beam combinations at sqrt(s) = ", pool_sqrts,
+                              " GeV.");
+      for (auto& string_process : string_processes_) {
+        string_process->preinitialize_hard_pythia(beams, pool_sqrts);
+      }
+    }
+    if (MemoryTracker::enabled()) {
+      string_process_memory_.set(std::max<int64_t>(
+          0, MemoryTracker::resident_bytes() - resident_before));
+    }
+  }
+
+  const double cache_bin_width =
+      config.take({"Collision_Term", "Cross_Section_Cache_Bin_Width"}, 0.);
+  if (cache_bin_width > 0.) {
+    cross_section_cache_ = std::make_unique<CrossSectionCache>(cache_bin_width);
+    logg[LFindScatter].info("Caching cross sections in bins of ",
+                            cache_bin_width, " GeV.");
+  } else if (cache_bin_width < 0.) {
+    throw std::invalid_argument(
+        "Cross_Section_Cache_Bin_Width has to be positive, or 0 to disable "
+        "the cache.");
+  }
+
+  thinning_ = config.take({"Collision_Term", "Stochastic_Thinning"}, false);
+  if (thinning_) {
+    if (finder_parameters_.coll_crit != CollisionCriterion::Stochastic) {
+      throw std::invalid_argument(
+          "Stochastic_Thinning requires the stochastic collision criterion.");
+    }
+    logg[LFindScatter].info(
+        "Thinning stochastic collisions with the maximum cross section of ",
+        finder_parameters_.maximum_cross_section, " mb.");
+  }
+
+  pair_sampling_ =
+      config.take({"Collision_Term", "Stochastic_Pair_Sampling"}, false);
+  if (pair_sampling_) {
+    if (finder_parameters_.coll_crit != CollisionCriterion::Stochastic) {
+      throw std::invalid_argument(
+          "Stochastic_Pair_Sampling requires the stochastic collision "
+          "criterion.");
+    }
+    logg[LFindScatter].info(
+        "Sampling the candidate pairs of the stochastic criterion.");
+  }
+}
+
+ScatterActionsFinder::~ScatterActionsFinder() {
+  if (cross_section_cache_) {
+    logg[LFindScatter].info("Cross-section cache: ",
+                            cross_section_cache_->hits(), " hits, ",
+                            cross_section_cache_->misses(), " misses.");
+  }
+  if (thinning_violations_ > 0) {
+    logg[LFindScatter].warn(
+        "Stochastic thinning: ", thinning_violations_.load(),
+        " evaluated cross sections exceeded the maximum cross section, so "
+        "that collisions were missed. Consider a larger "
+        "Maximum_Cross_Section.");
+  }
+  if (pair_sampling_violations_ > 0) {
+    logg[LFindScatter].warn(
+        "Stochastic pair sampling: ", pair_sampling_violations_.load(),
+        " collision probabilities exceeded their bound. Consider a larger "
+        "Maximum_Cross_Section.");
   }
 }
 
@@ -183,7 +316,8 @@ ScatterActionsFinderParameters create_finder_parameters(
       parameters.nnbar_treatment,
       parameters.included_2to2,
       parameters.included_multi,
-      parameters.testparticles,
+      // particles only collide within their subensemble
+      parameters.testparticles / parameters.n_subensembles,
       parameters.two_to_one,
       config.take({"Modi", "Collider", "Collisions_Within_Nucleus"}, false),
       parameters.strings_switch,
@@ -210,8 +344,8 @@ ScatterActionsFinderParameters create_finder_parameters(
 
 ActionPtr ScatterActionsFinder::check_collision_two_part(
     const ParticleData& data_a, const ParticleData& data_b, double dt,
-    const std::vector<FourVector>& beam_momentum,
-    const double gcell_vol) const {
+    const std::vector<FourVector>& beam_momentum, const double gcell_vol,
+    const double candidate_prob) const {
   /* If the two particles
    * 1) belong to one of the two colliding nuclei, and
    * 2) both of them have never experienced any collisions,
@@ -246,6 +380,35 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
     return nullptr;
   }
 
+  /* Thinning of the stochastic criterion: The random number is compared to
+   * the collision probability with the maximum cross section first, such
+   * that most pairs are rejected before their cross section is evaluated.
+   * As long as the cross section does not exceed the maximum, this samples
+   * the same collisions as comparing to the collision probability directly. */
+  std::optional<double> random_no;
+  double xs_bound = 0.;
+  if (thinning_) {
+    const FourVector total_momentum = data_a.momentum() + data_b.momentum();
+    const double s = total_momentum.sqr();
+    const double m1 = data_a.effective_mass();
+    const double m2 = data_b.effective_mass();
+    const double v_rel = std::sqrt(Action::lambda_tilde(s, m1 * m1, m2 * m2)) /
+                         (2. * data_a.momentum().x0() * data_b.momentum().x0());
+    xs_bound = is_constant_elastic_isotropic()
+                   ? constant_elastic_cross_section()
+                   : finder_parameters_.maximum_cross_section;
+    const double prob_bound =
+        xs_bound * fm2_mb /
+        static_cast<double>(finder_parameters_.testparticles) *
+        data_a.xsec_scaling_factor(time_until_collision) *
+        data_b.xsec_scaling_factor(time_until_collision) * v_rel * dt /
+        gcell_vol;
+    random_no = random::uniform(0., 1.);
+    if (*random_no > prob_bound / candidate_prob) {
+      return nullptr;
+    }
+  }
+
   // Determine which total cross section to use
   bool incoming_parametrized = (finder_parameters_.total_xs_strategy ==
                                 TotalCrossSectionStrategy::TopDown);
@@ -266,7 +429,7 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
   }
 
   if (finder_parameters_.strings_switch) {
-    act->set_string_interface(string_process_interface_.get());
+    act->set_string_interface(string_process());
   }
 
   // Distance squared calculation not needed for stochastic criterion
@@ -285,11 +448,24 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
     return nullptr;
   }
 
-  if (incoming_parametrized) {
-    act->set_parametrized_total_cross_section(finder_parameters_);
+  if (only_constant_elastic_) {
+    // Elastic collisions of nucleons below low_snn_cut can not happen.
+    const ParticleType& type_a = data_a.type();
+    const ParticleType& type_b = data_b.type();
+    if (type_a.is_nucleon() && type_b.is_nucleon() &&
+        type_a.antiparticle_sign() == type_b.antiparticle_sign() &&
+        act->sqrt_s() < finder_parameters_.low_snn_cut) {
+      return nullptr;
+    }
+    act->add_collision(std::make_unique<CollisionBranch>(
+        type_a, type_b, constant_elastic_cross_section(),
+        ProcessType::Elastic));
+  } else if (incoming_parametrized) {
+    act->set_parametrized_total_cross_section(finder_parameters_,
+                                              cross_section_cache_.get());
   } else {
     // Add various subprocesses.
-    act->add_all_scatterings(finder_parameters_);
+    act->add_all_scatterings(finder_parameters_, cross_section_cache_.get());
   }
 
   double xs = act->cross_section() * fm2_mb /
@@ -304,6 +480,9 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
     /* Collision probability for 2-particle scattering, see
      * \iref{Staudenmaier:2021lrg}. */
     const double prob = xs * v_rel * dt / gcell_vol;
+    if (thinning_ && act->cross_section() > xs_bound) {
+      thinning_violations_++;
+    }
 
     logg[LFindScatter].debug(
         "Stochastic collison criterion parameters (2-particles):\nprob = ",
@@ -328,8 +507,13 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
     }
 
     // probability criterion
-    double random_no = random::uniform(0., 1.);
-    if (random_no > prob) {
+    if (candidate_prob < 1. && prob > candidate_prob) {
+      pair_sampling_violations_++;
+    }
+    if (!random_no) {
+      random_no = random::uniform(0., 1.);
+    }
+    if (*random_no > prob / candidate_prob) {
       return nullptr;
     }
 
@@ -357,9 +541,11 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
                              "\n    ", data_a, "\n<-> ", data_b);
   }
 
-  // Include possible outgoing branches
+  /* The outgoing branches are only needed if the action is performed. They
+   * are added when its final state is generated. */
   if (incoming_parametrized) {
-    act->add_all_scatterings(finder_parameters_);
+    act->add_all_scatterings_lazily(finder_parameters_,
+                                    cross_section_cache_.get());
   }
 
   return act;
@@ -442,89 +628,484 @@ ActionPtr ScatterActionsFinder::check_collision_multi_part(
   return act;
 }
 
+/**
+ * Momentum of a particle, which determines its collision time. For frozen
+ * Fermi motion, the initial nucleons are propagated with the beam momentum
+ * until they interact, see ScatterActionsFinder::collision_time.
+ *
+ * \param[in] data The particle
+ * \param[in] beam_momentum [GeV] List of beam momenta for each particle
+ * \return Momentum to be used for the collision time [GeV]
+ */
+static const FourVector& collision_time_momentum(
+    const ParticleData& data, const std::vector<FourVector>& beam_momentum) {
+  const bool has_no_prior_interactions =
+      data.id() >= 0 &&
+      static_cast<uint64_t>(data.id()) <
+          static_cast<uint64_t>(beam_momentum.size()) &&
+      data.get_history().collisions_per_particle == 0;
+  return has_no_prior_interactions ? beam_momentum[data.id()]
+                                   : data.momentum();
+}
+
+void CollisionPartnerArrays::fill(
+    const ParticleList& partners,
+    const std::vector<FourVector>& beam_momentum) {
+  const size_t n = partners.size();
+  for (int mu = 0; mu < 4; mu++) {
+    position[mu].resize(n);
+    momentum[mu].resize(n);
+    time_momentum[mu].resize(n);
+  }
+  valid_id.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    const ParticleData& data = partners[i];
+    const FourVector& q = collision_time_momentum(data, beam_momentum);
+    for (int mu = 0; mu < 4; mu++) {
+      position[mu][i] = data.position()[mu];
+      momentum[mu][i] = data.momentum()[mu];
+      time_momentum[mu][i] = q[mu];
+    }
+    valid_id[i] = data.id() >= 0;
+  }
+}
+
+void ScatterActionsFinder::preselect_collision_partners(
+    const ParticleData& data_a, const ThreeVector& shift,
+    const CollisionPartnerArrays& partners, double dt,
+    const std::vector<FourVector>& beam_momentum,
+    std::vector<char>& candidates) const {
+  const size_t n = partners.size();
+  candidates.assign(n, 1);
+  const CollisionCriterion criterion = finder_parameters_.coll_crit;
+  if (criterion == CollisionCriterion::Stochastic || n == 0 ||
+      data_a.id() < 0) {
+    return;
+  }
+  /* Relative margin of the cuts. It covers the different rounding of the
+   * batched and the scalar evaluation, so that no collision is lost. */
+  constexpr double margin = 1e-9;
+  const double max_distance_sqr =
+      max_transverse_distance_sqr(finder_parameters_.testparticles) *
+      (1. + margin);
+
+  /* Positions x, momenta p and the momenta q determining the collision time
+   * of the partners */
+  std::array<const double*, 4> x, p, q;
+  for (int mu = 0; mu < 4; mu++) {
+    x[mu] = partners.position[mu].data();
+    p[mu] = partners.momentum[mu].data();
+    q[mu] = partners.time_momentum[mu].data();
+  }
+  const FourVector xa = data_a.position() + FourVector(0., shift);
+  const FourVector pa = data_a.momentum();
+  const FourVector qa = collision_time_momentum(data_a, beam_momentum);
+  const double qa_sqr = qa.sqr();
+  const double pa_sqr = pa.sqr();
+  const double small_sqr = really_small * really_small;
+
+  // The checks of a value against a threshold are ambiguous close to it.
+  auto clearly_below = [&](double value, double threshold) {
+    return value < threshold * (1. - margin);
+  };
+  auto clearly_above = [&](double value, double threshold) {
+    return value >= threshold * (1. + margin);
+  };
+  // Whether a collision time clearly lies outside of [0, dt).
+  auto time_excluded = [&](double t) {
+    const double tolerance = margin * (dt + std::abs(t));
+    return t < -tolerance || t >= dt + tolerance;
+  };
+
+  char* result = candidates.data();
+  if (criterion == CollisionCriterion::Covariant) {
+    for (size_t i = 0; i < n; i++) {
+      const double dx0 = xa[0] - x[0][i], dx1 = xa[1] - x[1][i],
+                   dx2 = xa[2] - x[2][i], dx3 = xa[3] - x[3][i];
+      const double x_sqr = dx0 * dx0 - dx1 * dx1 - dx2 * dx2 - dx3 * dx3;
+      // collision time, see collision_time
+      const double qb_sqr = q[0][i] * q[0][i] - q[1][i] * q[1][i] -
+                            q[2][i] * q[2][i] - q[3][i] * q[3][i];
+      const double qa_dot_x =
+          qa[0] * dx0 - qa[1] * dx1 - qa[2] * dx2 - qa[3] * dx3;
+      const double qb_dot_x =
+          q[0][i] * dx0 - q[1][i] * dx1 - q[2][i] * dx2 - q[3][i] * dx3;
+      const double qa_dot_qb = qa[0] * q[0][i] - qa[1] * q[1][i] -
+                               qa[2] * q[2][i] - qa[3] * q[3][i];
+      const double q_denominator = qa_dot_qb * qa_dot_qb - qa_sqr * qb_sqr;
+      const double time =
+          ((qb_sqr * qa_dot_x - qa_dot_qb * qb_dot_x) * qa[0] -
+           (qa_sqr * qb_dot_x - qa_dot_qb * qa_dot_x) * q[0][i]) /
+          (2 * q_denominator);
+      const bool no_time = clearly_below(std::abs(q_denominator), small_sqr);
+      const bool wrong_time =
+          clearly_above(std::abs(q_denominator), small_sqr) &&
+          time_excluded(time);
+      // transverse distance, see ScatterAction::cov_transverse_distance_sqr
+      const double dp1 = pa[1] - p[1][i], dp2 = pa[2] - p[2][i],
+                   dp3 = pa[3] - p[3][i];
+      const double mom_diff_sqr = dp1 * dp1 + dp2 * dp2 + dp3 * dp3;
+      const double pb_sqr = p[0][i] * p[0][i] - p[1][i] * p[1][i] -
+                            p[2][i] * p[2][i] - p[3][i] * p[3][i];
+      const double pa_dot_x =
+          pa[0] * dx0 - pa[1] * dx1 - pa[2] * dx2 - pa[3] * dx3;
+      const double pb_dot_x =
+          p[0][i] * dx0 - p[1][i] * dx1 - p[2][i] * dx2 - p[3][i] * dx3;
+      const double pa_dot_pb = pa[0] * p[0][i] - pa[1] * p[1][i] -
+                               pa[2] * p[2][i] - pa[3] * p[3][i];
+      const double b_sqr =
+          -x_sqr - (pa_sqr * pb_dot_x * pb_dot_x + pb_sqr * pa_dot_x * pa_dot_x -
+                    2 * pa_dot_pb * pa_dot_x * pb_dot_x) /
+                       (pa_dot_pb * pa_dot_pb - pa_sqr * pb_sqr);
+      const bool far_apart =
+          (clearly_below(mom_diff_sqr, really_small) &&
+           -x_sqr >= max_distance_sqr) ||
+          (clearly_above(mom_diff_sqr, really_small) &&
+           b_sqr >= max_distance_sqr);
+      result[i] = !(no_time || wrong_time || far_apart);
+    }
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      // collision time in the computational frame, see collision_time
+      const double dr1 = xa[1] - x[1][i], dr2 = xa[2] - x[2][i],
+                   dr3 = xa[3] - x[3][i];
+      const double dv1 = qa[1] * q[0][i] - q[1][i] * qa[0],
+                   dv2 = qa[2] * q[0][i] - q[2][i] * qa[0],
+                   dv3 = qa[3] * q[0][i] - q[3][i] * qa[0];
+      const double dv_sqr = dv1 * dv1 + dv2 * dv2 + dv3 * dv3;
+      const double time = -(dr1 * dv1 + dr2 * dv2 + dr3 * dv3) *
+                          (qa[0] * q[0][i] / dv_sqr);
+      const bool no_time = clearly_below(dv_sqr, really_small);
+      const bool wrong_time =
+          clearly_above(dv_sqr, really_small) && time_excluded(time);
+      /* transverse distance in the center-of-momentum frame, see
+       * ScatterAction::transverse_distance_sqr; the boost is linear, so it
+       * can be applied to the differences directly. */
+      const double e_tot = pa[0] + p[0][i];
+      const double v1 = (pa[1] + p[1][i]) / e_tot,
+                   v2 = (pa[2] + p[2][i]) / e_tot,
+                   v3 = (pa[3] + p[3][i]) / e_tot;
+      const double v_sqr = v1 * v1 + v2 * v2 + v3 * v3;
+      const double gamma = v_sqr < 1. ? 1. / std::sqrt(1. - v_sqr) : 0.;
+      const double gamma_factor = gamma / (gamma + 1);
+      const double dx0 = xa[0] - x[0][i];
+      const double dx0_cm = gamma * (dx0 - (dr1 * v1 + dr2 * v2 + dr3 * v3));
+      const double cx = gamma_factor * (dx0_cm + dx0);
+      const double dr1_cm = dr1 - v1 * cx, dr2_cm = dr2 - v2 * cx,
+                   dr3_cm = dr3 - v3 * cx;
+      const double dp0 = pa[0] - p[0][i], dp1 = pa[1] - p[1][i],
+                   dp2 = pa[2] - p[2][i], dp3 = pa[3] - p[3][i];
+      const double dp0_cm = gamma * (dp0 - (dp1 * v1 + dp2 * v2 + dp3 * v3));
+      const double cp = gamma_factor * (dp0_cm + dp0);
+      const double dp1_cm = dp1 - v1 * cp, dp2_cm = dp2 - v2 * cp,
+                   dp3_cm = dp3 - v3 * cp;
+      const double dr_sqr =
+          dr1_cm * dr1_cm + dr2_cm * dr2_cm + dr3_cm * dr3_cm;
+      const double dp_sqr =
+          dp1_cm * dp1_cm + dp2_cm * dp2_cm + dp3_cm * dp3_cm;
+      const double dpdr = dr1_cm * dp1_cm + dr2_cm * dp2_cm + dr3_cm * dp3_cm;
+      const bool far_apart =
+          (clearly_below(dp_sqr, really_small) &&
+           dr_sqr >= max_distance_sqr) ||
+          (clearly_above(dp_sqr, really_small) &&
+           dr_sqr - dpdr * dpdr / dp_sqr >= max_distance_sqr);
+      result[i] = !(no_time || wrong_time || far_apart);
+    }
+  }
+  // Invalid particles are left to check_collision_two_part, which throws.
+  for (size_t i = 0; i < n; i++) {
+    result[i] |= !partners.valid_id[i];
+  }
+}
+
+/**
+ * Select the particles of a cell that can take part in a multi-particle
+ * reaction. The selected particles are ordered by their id, such that
+ * combinations with increasing indices coincide with increasing ids.
+ *
+ * \param[in] search_list Particles of the cell
+ * \param[in] is_candidate Predicate selecting the candidates
+ * \return List of candidates
+ */
+template <typename F>
+static ParticleList multi_particle_candidates(const ParticleList& search_list,
+                                              F&& is_candidate) {
+  ParticleList candidates;
+  std::copy_if(search_list.begin(), search_list.end(),
+               std::back_inserter(candidates), is_candidate);
+  std::sort(candidates.begin(), candidates.end(),
+            [](const ParticleData& a, const ParticleData& b) {
+              return a.id() < b.id();
+            });
+  return candidates;
+}
+
+/**
+ * Select the particles that can scatter within the given time. Unformed
+ * particles, whose cross section scaling factor is still zero at the end of
+ * that time, are left out: the scaling factor does not decrease with time,
+ * such that every collision with them would be rejected anyway.
+ *
+ * \param[in] particle_list Particles to select from
+ * \param[in] dt Time until the end of the search
+ * \param[out] formed Storage of the selection, only filled if a particle is
+ *             left out
+ * \return \p particle_list if all particles can scatter, \p formed otherwise
+ */
+static const ParticleList& formed_particles(const ParticleList& particle_list,
+                                            double dt, ParticleList& formed) {
+  const auto unformed = [dt](const ParticleData& p) {
+    return p.xsec_scaling_factor(dt) <= 0.;
+  };
+  if (std::none_of(particle_list.begin(), particle_list.end(), unformed)) {
+    return particle_list;
+  }
+  formed.clear();
+  std::remove_copy_if(particle_list.begin(), particle_list.end(),
+                      std::back_inserter(formed), unformed);
+  return formed;
+}
+
 ActionList ScatterActionsFinder::find_actions_in_cell(
     const ParticleList& search_list, double dt, const double gcell_vol,
     const std::vector<FourVector>& beam_momentum) const {
+  return search_cell(search_list, nullptr, dt, gcell_vol, beam_momentum);
+}
+
+ActionList ScatterActionsFinder::find_actions_in_cell_with_members(
+    const ParticleList& search_list, const ParticleList& members, double dt,
+    const double gcell_vol,
+    const std::vector<FourVector>& beam_momentum) const {
+  return search_cell(search_list, &members, dt, gcell_vol, beam_momentum);
+}
+
+ActionList ScatterActionsFinder::search_cell(
+    const ParticleList& search_list, const ParticleList* members, double dt,
+    const double gcell_vol,
+    const std::vector<FourVector>& beam_momentum) const {
   std::vector<ActionPtr> actions;
-  for (const ParticleData& p1 : search_list) {
-    for (const ParticleData& p2 : search_list) {
-      // Check for 2 particle scattering
-      if (p1.id() < p2.id()) {
-        ActionPtr act =
-            check_collision_two_part(p1, p2, dt, beam_momentum, gcell_vol);
-        if (act) {
-          actions.push_back(std::move(act));
+  // Unformed particles skip the search until they form
+  ParticleList formed;
+  const ParticleList& cell = formed_particles(search_list, dt, formed);
+  CollisionSearchCounters counters;
+  counters.cells = 1;
+  counters.max_particles_in_cell = cell.size();
+  counters.candidate_pairs = cell.size() * (cell.size() - 1) / 2;
+  // Buffers for the preselection, kept to avoid reallocations
+  static thread_local CollisionPartnerArrays partners;
+  static thread_local std::vector<char> candidates;
+  if (!pair_sampling_ || !sample_collision_pairs(cell, dt, gcell_vol,
+                                                 beam_momentum, actions,
+                                                 counters)) {
+    partners.fill(cell, beam_momentum);
+    for (const ParticleData& p1 : cell) {
+      preselect_collision_partners(p1, ThreeVector(), partners, dt,
+                                   beam_momentum, candidates);
+      for (size_t i = 0; i < cell.size(); i++) {
+        const ParticleData& p2 = cell[i];
+        // Check for 2 particle scattering
+        if (p1.id() < p2.id() && candidates[i]) {
+          counters.checked_pairs++;
+          ActionPtr act =
+              check_collision_two_part(p1, p2, dt, beam_momentum, gcell_vol);
+          if (act) {
+            actions.push_back(std::move(act));
+          }
         }
       }
-      if (finder_parameters_.included_multi.any()) {
-        // Also, check for 3 particle scatterings with stochastic criterion
-        for (const ParticleData& p3 : search_list) {
-          if (finder_parameters_.included_multi
-                      [IncludedMultiParticleReactions::Deuteron_3to2] == 1 ||
-              finder_parameters_.included_multi
-                      [IncludedMultiParticleReactions::Meson_3to1] == 1) {
-            if (p1.id() < p2.id() && p2.id() < p3.id()) {
-              ActionPtr act =
-                  check_collision_multi_part({p1, p2, p3}, dt, gcell_vol);
-              if (act) {
-                actions.push_back(std::move(act));
-              }
-            }
+    }
+  }
+  counters.found_actions = actions.size();
+  /* The candidates of the multi-particle reactions are searched among the
+   * members of the cell listed by the grid, if it did so. */
+  ParticleList formed_members;
+  const ParticleList& multi_cell =
+      members ? formed_particles(*members, dt, formed_members) : cell;
+  if (!finder_parameters_.included_multi.any() || multi_cell.empty()) {
+    count_search(counters);
+    return actions;
+  }
+  auto add_multi_part = [&](ParticleList&& plist) {
+    ActionPtr act = check_collision_multi_part(plist, dt, gcell_vol);
+    if (act) {
+      actions.push_back(std::move(act));
+      counters.found_multi_particle_actions++;
+    }
+  };
+  auto mask_of = [&](const ParticleData& data) {
+    return multi_reaction_masks_[(&data.type()).index()];
+  };
+  /* Only combinations of particles, which can actually react, are checked.
+   * Every combination is generated once, with increasing ids. The masks of the
+   * particles chosen so far tell which reactions remain possible, so that
+   * combinations without any are skipped before creating an action. */
+  auto candidates_for = [&](std::uint8_t families) {
+    return multi_particle_candidates(
+        multi_cell,
+        [&](const ParticleData& data) { return mask_of(data) & families; });
+  };
+  const auto& incl_multi = finder_parameters_.included_multi;
+  if (incl_multi[IncludedMultiParticleReactions::Meson_3to1] == 1 ||
+      incl_multi[IncludedMultiParticleReactions::Deuteron_3to2] == 1) {
+    // 3π → ω/φ, 2πη → η', πNN → πd, NNN → Nd (and antiparticles)
+    const std::uint8_t families = ScatterActionMulti::reaction_families(3);
+    const ParticleList c = candidates_for(families);
+    const size_t n = c.size();
+    for (size_t i = 0; i < n; i++) {
+      const std::uint8_t mi = families & mask_of(c[i]);
+      for (size_t j = i + 1; j < n; j++) {
+        const std::uint8_t mj = mi & mask_of(c[j]);
+        if (!mj) {
+          continue;
+        }
+        for (size_t k = j + 1; k < n; k++) {
+          if (mj & mask_of(c[k])) {
+            add_multi_part({c[i], c[j], c[k]});
           }
-          for (const ParticleData& p4 : search_list) {
-            if (finder_parameters_.included_multi
-                    [IncludedMultiParticleReactions::A3_Nuclei_4to2]) {
-              if (p1.id() < p2.id() && p2.id() < p3.id() && p3.id() < p4.id()) {
-                ActionPtr act =
-                    check_collision_multi_part({p1, p2, p3, p4}, dt, gcell_vol);
-                if (act) {
-                  actions.push_back(std::move(act));
-                }
-              }
+        }
+      }
+    }
+  }
+  if (incl_multi[IncludedMultiParticleReactions::A3_Nuclei_4to2] == 1) {
+    // Components of the A = 3 nuclei and catalysts (N, Λ, π)
+    const std::uint8_t families = ScatterActionMulti::reaction_families(4);
+    const ParticleList c = candidates_for(families);
+    const size_t n = c.size();
+    for (size_t i = 0; i < n; i++) {
+      const std::uint8_t mi = families & mask_of(c[i]);
+      for (size_t j = i + 1; j < n; j++) {
+        const std::uint8_t mj = mi & mask_of(c[j]);
+        if (!mj) {
+          continue;
+        }
+        for (size_t k = j + 1; k < n; k++) {
+          const std::uint8_t mk = mj & mask_of(c[k]);
+          if (!mk) {
+            continue;
+          }
+          for (size_t l = k + 1; l < n; l++) {
+            if (mk & mask_of(c[l])) {
+              add_multi_part({c[i], c[j], c[k], c[l]});
             }
-            if (finder_parameters_.included_multi
-                        [IncludedMultiParticleReactions::NNbar_5to2] == 1 &&
-                search_list.size() >= 5) {
-              for (const ParticleData& p5 : search_list) {
-                if ((p1.id() < p2.id() && p2.id() < p3.id() &&
-                     p3.id() < p4.id() && p4.id() < p5.id()) &&
-                    (p1.is_pion() && p2.is_pion() && p3.is_pion() &&
-                     p4.is_pion() && p5.is_pion())) {
-                  // at the moment only pure pion 5-body reactions
-                  ActionPtr act = check_collision_multi_part(
-                      {p1, p2, p3, p4, p5}, dt, gcell_vol);
-                  if (act) {
-                    actions.push_back(std::move(act));
-                  }
-                }
-              }
+          }
+        }
+      }
+    }
+  }
+  if (incl_multi[IncludedMultiParticleReactions::NNbar_5to2] == 1) {
+    // At the moment only pure pion 5-body reactions, all candidates can react
+    const ParticleList c =
+        candidates_for(ScatterActionMulti::reaction_families(5));
+    const size_t n = c.size();
+    for (size_t i = 0; i < n; i++) {
+      for (size_t j = i + 1; j < n; j++) {
+        for (size_t k = j + 1; k < n; k++) {
+          for (size_t l = k + 1; l < n; l++) {
+            for (size_t m = l + 1; m < n; m++) {
+              add_multi_part({c[i], c[j], c[k], c[l], c[m]});
             }
           }
         }
       }
     }
   }
+  count_search(counters);
   return actions;
 }
 
+bool ScatterActionsFinder::sample_collision_pairs(
+    const ParticleList& cell, double dt, double gcell_vol,
+    const std::vector<FourVector>& beam_momentum, ActionList& actions,
+    CollisionSearchCounters& counters) const {
+  const size_t n = cell.size();
+  if (n < 2 || gcell_vol < really_small) {
+    return false;
+  }
+  double max_speed = 0.;
+  for (const ParticleData& p : cell) {
+    max_speed = std::max(max_speed, p.velocity().abs());
+  }
+  /* The relative velocity of a pair is at most the sum of their speeds, the
+   * cross section scaling factors are at most 1. */
+  const double xs_max = is_constant_elastic_isotropic()
+                            ? constant_elastic_cross_section()
+                            : finder_parameters_.maximum_cross_section;
+  const double prob_max = xs_max * fm2_mb /
+                          static_cast<double>(finder_parameters_.testparticles) *
+                          2. * max_speed * dt / gcell_vol;
+  if (!(prob_max < 1.)) {
+    return false;
+  }
+  const double n_pairs = 0.5 * n * (n - 1);
+  const int n_candidates = random::poisson(n_pairs * prob_max);
+  for (int k = 0; k < n_candidates; k++) {
+    const size_t i = random::uniform_int<size_t>(0, n - 1);
+    // A different particle, chosen uniformly among the others
+    size_t j = random::uniform_int<size_t>(0, n - 2);
+    j += (j >= i);
+    const ParticleData& p1 = cell[std::min(i, j)];
+    const ParticleData& p2 = cell[std::max(i, j)];
+    counters.checked_pairs++;
+    ActionPtr act = check_collision_two_part(p1, p2, dt, beam_momentum,
+                                             gcell_vol, prob_max);
+    if (act) {
+      actions.push_back(std::move(act));
+    }
+  }
+  return true;
+}
+
 ActionList ScatterActionsFinder::find_actions_with_neighbors(
     const ParticleList& search_list, const ParticleList& neighbors_list,
     double dt, const std::vector<FourVector>& beam_momentum) const {
+  return find_actions_with_shifted_neighbors(search_list, ThreeVector(),
+                                             neighbors_list, dt, beam_momentum);
+}
+
+ActionList ScatterActionsFinder::find_actions_with_shifted_neighbors(
+    const ParticleList& search_list, const ThreeVector& shift,
+    const ParticleList& neighbors_list, double dt,
+    const std::vector<FourVector>& beam_momentum) const {
   std::vector<ActionPtr> actions;
   if (finder_parameters_.coll_crit == CollisionCriterion::Stochastic) {
     // Only search in cells
     return actions;
   }
-  for (const ParticleData& p1 : search_list) {
-    for (const ParticleData& p2 : neighbors_list) {
+  // Unformed particles skip the search until they form
+  ParticleList formed_searched, formed_neighbors;
+  const ParticleList& searched =
+      formed_particles(search_list, dt, formed_searched);
+  const ParticleList& neighbors =
+      formed_particles(neighbors_list, dt, formed_neighbors);
+  CollisionSearchCounters counters;
+  counters.candidate_pairs = searched.size() * neighbors.size();
+  // Buffers for the preselection, kept to avoid reallocations
+  static thread_local CollisionPartnerArrays partners;
+  static thread_local std::vector<char> candidates;
+  partners.fill(neighbors, beam_momentum);
+  for (const ParticleData& p1 : searched) {
+    preselect_collision_partners(p1, shift, partners, dt, beam_momentum,
+                                 candidates);
+    for (size_t i = 0; i < neighbors.size(); i++) {
+      const ParticleData& p2 = neighbors[i];
       assert(p1.id() != p2.id());
-      // Check if a collision is possible.
-      ActionPtr act = check_collision_two_part(p1, p2, dt, beam_momentum);
+      if (!candidates[i]) {
+        continue;
+      }
+      counters.checked_pairs++;
+      // Check if a collision is possible, translating only actual candidates.
+      ActionPtr act =
+          shift == ThreeVector()
+              ? check_collision_two_part(p1, p2, dt, beam_momentum)
+              : check_collision_two_part(p1.translated(shift), p2, dt,
+                                         beam_momentum);
       if (act) {
         actions.push_back(std::move(act));
       }
     }
   }
+  counters.found_actions = actions.size();
+  count_search(counters);
   return actions;
 }
 
@@ -536,16 +1117,25 @@ ActionList ScatterActionsFinder::find_actions_with_surrounding_particles(
     // Only search in cells
     return actions;
   }
+  // Unformed particles skip the search until they form
+  ParticleList formed;
+  const ParticleList& searched = formed_particles(search_list, dt, formed);
+  CollisionSearchCounters counters;
   for (const ParticleData& p2 : surrounding_list) {
+    if (p2.xsec_scaling_factor(dt) <= 0.) {
+      continue;
+    }
     /* don't look for collisions if the particle from the surrounding list is
      * also in the search list */
     auto result = std::find_if(
-        search_list.begin(), search_list.end(),
+        searched.begin(), searched.end(),
         [&p2](const ParticleData& p) { return p.id() == p2.id(); });
-    if (result != search_list.end()) {
+    if (result != searched.end()) {
       continue;
     }
-    for (const ParticleData& p1 : search_list) {
+    // all pairs are checked, without preselection
+    counters.candidate_pairs += searched.size();
+    for (const ParticleData& p1 : searched) {
       // Check if a collision is possible.
       ActionPtr act = check_collision_two_part(p1, p2, dt, beam_momentum);
       if (act) {
@@ -553,9 +1143,83 @@ ActionList ScatterActionsFinder::find_actions_with_surrounding_particles(
       }
     }
   }
+  counters.checked_pairs = counters.candidate_pairs;
+  counters.found_actions = actions.size();
+  count_search(counters);
   return actions;
 }
 
+double ScatterActionsFinder::earliest_collision_time(
+    const ParticleList& search_list, const ParticleList& neighbors_list,
+    double dt, const std::vector<FourVector>& beam_momentum) const {
+  if (finder_parameters_.coll_crit == CollisionCriterion::Stochastic) {
+    throw std::logic_error(
+        "Collision times are random with the stochastic criterion.");
+  }
+  double earliest = std::numeric_limits<double>::infinity();
+  auto bound = [&](const ParticleData& p1, const ParticleData& p2) {
+    const double time = collision_time(p1, p2, dt, beam_momentum);
+    if (time >= 0. && time < dt) {
+      earliest = std::min(earliest, p1.position().x0() + time);
+    }
+  };
+  static thread_local CollisionPartnerArrays partners;
+  static thread_local std::vector<char> candidates;
+  for (const ParticleList* list : {&search_list, &neighbors_list}) {
+    partners.fill(*list, beam_momentum);
+    for (const ParticleData& p1 : search_list) {
+      preselect_collision_partners(p1, ThreeVector(), partners, dt,
+                                   beam_momentum, candidates);
+      for (size_t i = 0; i < list->size(); i++) {
+        const ParticleData& p2 = (*list)[i];
+        // Pairs within the search list are bounded once.
+        const bool skip = list == &search_list && p1.id() >= p2.id();
+        if (!skip && candidates[i]) {
+          bound(p1, p2);
+        }
+      }
+    }
+  }
+  // The collision times are evaluated again later, possibly rounded apart.
+  return earliest - 1e-9 * (1. + std::abs(earliest));
+}
+
+CollisionSearchCounters ScatterActionsFinder::take_search_counters() {
+  CollisionSearchCounters counters;
+  counters.cells = search_counters_.cells.exchange(0);
+  counters.max_particles_in_cell =
+      search_counters_.max_particles_in_cell.exchange(0);
+  counters.candidate_pairs = search_counters_.candidate_pairs.exchange(0);
+  counters.checked_pairs = search_counters_.checked_pairs.exchange(0);
+  counters.found_actions = search_counters_.found_actions.exchange(0);
+  counters.found_multi_particle_actions =
+      search_counters_.found_multi_particle_actions.exchange(0);
+  return counters;
+}
+
+void ScatterActionsFinder::count_search(
+    const CollisionSearchCounters& counters) const {
+  /* Once per call of a find_actions_* function, such that concurrent searches
+   * rarely touch the counters at the same time. */
+  constexpr auto relaxed = std::memory_order_relaxed;
+  if (counters.cells > 0) {
+    search_counters_.cells.fetch_add(counters.cells, relaxed);
+    uint64_t max = search_counters_.max_particles_in_cell.load(relaxed);
+    while (max < counters.max_particles_in_cell &&
+           !search_counters_.max_particles_in_cell.compare_exchange_weak(
+               max, counters.max_particles_in_cell, relaxed)) {
+    }
+  }
+  search_counters_.candidate_pairs.fetch_add(counters.candidate_pairs,
+                                             relaxed);
+  search_counters_.checked_pairs.fetch_add(counters.checked_pairs, relaxed);
+  search_counters_.found_actions.fetch_add(counters.found_actions, relaxed);
+  if (counters.found_multi_particle_actions > 0) {
+    search_counters_.found_multi_particle_actions.fetch_add(
+        counters.found_multi_particle_actions, relaxed);
+  }
+}
+
 void ScatterActionsFinder::dump_reactions() const {
   constexpr double time = 0.0;
 
@@ -585,7 +1249,7 @@ void ScatterActionsFinder::dump_reactions() const {
             ScatterActionPtr act = std::make_unique<ScatterAction>(
                 A, B, time, isotropic_, string_formation_time_, -1, false);
             if (finder_parameters_.strings_switch) {
-              act->set_string_interface(string_process_interface_.get());
+              act->set_string_interface(string_process());
             }
             act->add_all_scatterings(finder_parameters_);
             const double total_cs = act->cross_section();
@@ -969,7 +1633,7 @@ void ScatterActionsFinder::dump_cross_sections(
     ScatterActionPtr act = std::make_unique<ScatterAction>(
         a_data, b_data, 0., isotropic_, string_formation_time_, -1, false);
     if (finder_parameters_.strings_switch) {
-      act->set_string_interface(string_process_interface_.get());
+      act->set_string_interface(string_process());
     }
     act->add_all_scatterings(finder_parameters_);
     decaytree::Node tree(a.name() + b.name(), act->cross_section(), {&a, &b},
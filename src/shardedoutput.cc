@@ -0,0 +1,82 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/shardedoutput.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace smash {
+
+namespace {
+/**
+ * Name that gives an OutputInterface the same kind as the shards.
+ * \param[in] shards Outputs of the ensembles.
+ * \return Name for the OutputInterface constructor.
+ * \throw std::invalid_argument if no shards are given.
+ */
+std::string name_of_kind(
+    const std::vector<std::unique_ptr<OutputInterface>> &shards) {
+  if (shards.empty()) {
+    throw std::invalid_argument("A sharded output needs at least one shard.");
+  }
+  const OutputInterface &shard = *shards.front();
+  if (shard.is_dilepton_output()) {
+    return "Dileptons";
+  } else if (shard.is_photon_output()) {
+    return "Photons";
+  } else if (shard.is_IC_output()) {
+    return "SMASH_IC";
+  }
+  return "";
+}
+}  // namespace
+
+ShardedOutput::ShardedOutput(
+    std::vector<std::unique_ptr<OutputInterface>> shards)
+    : OutputInterface(name_of_kind(shards)), shards_(std::move(shards)) {}
+
+OutputInterface &ShardedOutput::shard_of_event(int event_number) {
+  return *shards_[static_cast<std::size_t>(event_number) % shards_.size()];
+}
+
+void ShardedOutput::at_eventstart(const Particles &particles,
+                                  const int event_number,
+                                  const EventInfo &info) {
+  next_intermediate_shard_ = 0;
+  shard_of_event(event_number).at_eventstart(particles, event_number, info);
+}
+
+void ShardedOutput::at_eventend(const Particles &particles,
+                                const int event_number,
+                                const EventInfo &info) {
+  shard_of_event(event_number).at_eventend(particles, event_number, info);
+}
+
+void ShardedOutput::at_interaction(const Action &action,
+                                   const double density) {
+  shards_.front()->at_interaction(action, density);
+}
+
+void ShardedOutput::at_ensemble_interaction(const Action &action,
+                                            const double density,
+                                            const int i_ensemble) {
+  shards_.at(i_ensemble)->at_interaction(action, density);
+}
+
+void ShardedOutput::at_intermediate_time(const Particles &particles,
+                                         const std::unique_ptr<Clock> &clock,
+                                         const DensityParameters &dens_param,
+                                         const EventInfo &info) {
+  shards_[next_intermediate_shard_]->at_intermediate_time(particles, clock,
+                                                          dens_param, info);
+  next_intermediate_shard_ = (next_intermediate_shard_ + 1) % shards_.size();
+}
+
+}  // namespace smash
@@ -7,6 +7,9 @@
  *
  */
 #include <getopt.h>
+#ifdef SMASH_USE_MPI
+#include <mpi.h>
+#endif
 
 #include <filesystem>
 #include <set>
@@ -14,8 +17,10 @@
 #include <vector>
 
 #include "smash/decaymodes.h"
+#include "smash/eventscheduler.h"
 #include "smash/experiment.h"
 #include "smash/filelock.h"
+#include "smash/parallel.h"
 #include "smash/random.h"
 #include "smash/scatteractionsfinder.h"
 #include "smash/setup_particles_decaymodes.h"
@@ -67,6 +72,13 @@ namespace smash {
  * <tr><td>`-e <time>` <td>`--endtime <time>`
  * <td>This is a shortcut for <tt>-c 'General: { End_Time: \<time\> }'</tt>.
  * Note that `-e` always overrides `-c`.
+ * <tr><td>`-E <N>` <td>`--event <N>`
+ * <td>Simulates only the event with number N (counting from 0) of the run,
+ *     with the same random seed as in the full run. The random seed of every
+ *     event is derived from `Randomseed` and the number of the event, so the
+ *     events before it need not be simulated, e.g. to investigate a rare
+ *     event of a large production. This cannot be combined with `--threads`,
+ *     MPI or `Prefetch_Initial_States`.
  * <tr><td>`-o <dir>` <td>`--output <dir>`
  * <td>Sets the output directory. The default output directory is
  *     `./data/<runid>`, where `<rundid>` is an automatically incrementing
@@ -121,7 +133,28 @@ namespace smash {
  * <tr><td>`-q` <td>`--quiet`
  * <td>Quiets the disclaimer for scenarios where no printout is wanted. To
  *     get no printout, you also need to disable logging from the config.
+ * <tr><td>`-t <N>` <td>`--threads <N>`
+ * <td>Simulates N events concurrently on N threads of the same process. The
+ *     particle and decay data as well as the tabulations are shared, while
+ *     each thread has its own particles and random number stream. The events
+ *     are distributed round-robin, the random seed of every event is the same
+ *     as in a run with a single thread. Each thread writes its output to the
+ *     subdirectory `worker_<i>` of the output directory. This requires a
+ *     fixed number of events (`Nevents`) and does not support photons or
+ *     potentials affecting the thresholds.
  * </table>
+ *
+ * If SMASH is built with MPI support (`-DTRY_USE_MPI=ON`) and started on
+ * several MPI ranks, e.g. with `mpirun -n 65 smash`, rank 0 hands out the
+ * events dynamically to all other ranks, which ask for the next event whenever
+ * they finished one. This balances events of very different durations. Each
+ * rank keeps its experiment for all its events and writes its output to the
+ * subdirectory `rank_<i>` of the output directory, while rank 0 writes the
+ * file `event_index.txt` listing for every event the rank and the position
+ * among the events in the output of that rank. `Minimum_Nonempty_Ensembles` is
+ * counted over all ranks. The random seed of every event is the same as in a
+ * run on a single rank. Initial states cannot be prefetched and MPI cannot be
+ * combined with `--threads`.
  */
 
 namespace {
@@ -153,6 +186,7 @@ void usage(const int rc, const std::string &progname) {
       "  -e, --endtime <time>    shortcut for -c 'General: { End_Time: <time> "
       "}'"
       "\n"
+      "  -E, --event <N>         simulate only event N of the run\n"
       "\n"
       "  -o, --output <dir>      output directory (default: ./data/<runid>)\n"
       "  -l, --list-2-to-n       list all possible 2->n reactions (with n>1)\n"
@@ -178,6 +212,7 @@ void usage(const int rc, const std::string &progname) {
       "                          relativistic hydro codes\n"
       "  -q, --quiet             Supress disclaimer print-out\n"
       "  -n, --no-cache          Don't cache integrals on disk\n"
+      "  -t, --threads <N>       simulate N events concurrently\n"
       "  -v, --version\n\n");
   std::exit(rc);
 }
@@ -350,6 +385,82 @@ void ignore_simulation_config_values(Configuration &configuration) {
   }
 }
 
+/**
+ * Simulates the events of a run concurrently on several threads.
+ *
+ * Every thread owns an experiment created from an identical copy of the
+ * configuration and simulates every n_threads-th event. The particle types,
+ * decay modes and tabulations have to be initialized beforehand, they are
+ * shared by all threads. The experiments are created one after the other,
+ * since their setup is not thread-safe, and write to their own subdirectory
+ * of the output directory.
+ *
+ * \param[in] configuration The configuration of the run. It is emptied.
+ * \param[in] output_path The output directory of the run
+ * \param[in] n_threads Number of concurrent events
+ * \throw Rethrows the first exception thrown on any of the threads.
+ */
+void run_events_concurrently(Configuration &configuration,
+                             const std::filesystem::path &output_path,
+                             int n_threads) {
+  // Version key is deprecated. If present, ignore it.
+  if (configuration.has_value({"Version"})) {
+    configuration.take({"Version"});
+  }
+  const std::string config_yaml = configuration.to_string();
+  configuration.clear();
+
+  std::vector<std::unique_ptr<ExperimentBase>> experiments;
+  for (int i = 0; i < n_threads; i++) {
+    Configuration worker_config{config_yaml.c_str(),
+                                Configuration::InitializeFromYAMLString};
+    const std::filesystem::path worker_path =
+        output_path / ("worker_" + std::to_string(i));
+    std::filesystem::create_directories(worker_path);
+    logg[LMain].trace(SMASH_SOURCE_LOCATION, " create Experiment ", i);
+    experiments.emplace_back(
+        ExperimentBase::create(worker_config, worker_path));
+    check_for_unused_config_values(worker_config);
+  }
+  initialize_lazy_caches();
+
+  logg[LMain].info() << "Running events on " << n_threads << " threads";
+  // From now on the events share the hardware threads.
+  set_concurrent_events(n_threads);
+  parallel_for(n_threads, n_threads, 1, [&](std::size_t i) {
+    experiments[i]->run(static_cast<int>(i), n_threads);
+  });
+}
+
+#ifdef SMASH_USE_MPI
+/**
+ * Simulates the events of a run on several MPI ranks.
+ *
+ * Rank 0 only hands out the events to the other ranks, each of which runs one
+ * experiment for all the events it is given.
+ *
+ * \param[in] configuration The configuration of the run. It is emptied.
+ * \param[in] output_path The output directory of this rank
+ * \param[in] rank The MPI rank of this process
+ */
+void run_events_over_mpi(Configuration &configuration,
+                         const std::filesystem::path &output_path, int rank) {
+  if (rank == 0) {
+    configuration.clear();
+    serve_events_over_mpi(output_path / "event_index.txt");
+    return;
+  }
+  auto experiment = ExperimentBase::create(configuration, output_path);
+  // Version key is deprecated. If present, ignore it.
+  if (configuration.has_value({"Version"})) {
+    configuration.take({"Version"});
+  }
+  check_for_unused_config_values(configuration);
+  MpiEventScheduler scheduler;
+  experiment->run(scheduler);
+}
+#endif
+
 }  // unnamed namespace
 
 }  // namespace smash
@@ -367,10 +478,26 @@ void ignore_simulation_config_values(Configuration &configuration) {
 int main(int argc, char *argv[]) {
   using namespace smash;  // NOLINT(build/namespaces)
 
+  // Rank of this process and number of processes of an MPI run
+  int mpi_rank = 0, mpi_ranks = 1;
+#ifdef SMASH_USE_MPI
+  MPI_Init(&argc, &argv);
+  std::atexit([]() {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+      MPI_Finalize();
+    }
+  });
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_ranks);
+#endif
+
   constexpr option longopts[] = {
       {"config", required_argument, 0, 'c'},
       {"decaymodes", required_argument, 0, 'd'},
       {"endtime", required_argument, 0, 'e'},
+      {"event", required_argument, 0, 'E'},
       {"force", no_argument, 0, 'f'},
       {"help", no_argument, 0, 'h'},
       {"inputfile", required_argument, 0, 'i'},
@@ -385,6 +512,7 @@ int main(int argc, char *argv[]) {
       {"version", no_argument, 0, 'v'},
       {"no-cache", no_argument, 0, 'n'},
       {"quiet", no_argument, 0, 'q'},
+      {"threads", required_argument, 0, 't'},
       {nullptr, 0, 0, 0}};
 
   // strip any path to progname
@@ -405,10 +533,12 @@ int main(int argc, char *argv[]) {
     bool particles_dump_iSS_format = false;
     bool cache_integrals = true;
     bool suppress_disclaimer = false;
+    int n_threads = 1;
+    int single_event = -1;
 
     // parse command-line arguments
     int opt;
-    while ((opt = getopt_long(argc, argv, "c:d:e:fhi:m:p:o:lr:s:S:xvnq",
+    while ((opt = getopt_long(argc, argv, "c:d:e:E:fhi:m:p:o:lr:s:S:xvnqt:",
                               longopts, nullptr)) != -1) {
       switch (opt) {
         case 'c':
@@ -435,6 +565,14 @@ int main(int argc, char *argv[]) {
         case 'e':
           end_time = optarg;
           break;
+        case 'E':
+          single_event = std::atoi(optarg);
+          if (single_event < 0) {
+            std::cout << argv[0] << ": invalid event number -- '" << optarg
+                      << "'\n";
+            usage(EXIT_FAILURE, progname);
+          }
+          break;
         case 'o':
           output_path = optarg;
           break;
@@ -480,6 +618,14 @@ int main(int argc, char *argv[]) {
         case 'q':
           suppress_disclaimer = true;
           break;
+        case 't':
+          n_threads = std::atoi(optarg);
+          if (n_threads < 1) {
+            std::cout << argv[0] << ": invalid number of threads -- '"
+                      << optarg << "'\n";
+            usage(EXIT_FAILURE, progname);
+          }
+          break;
         default:
           usage(EXIT_FAILURE, progname);
       }
@@ -636,12 +782,35 @@ int main(int argc, char *argv[]) {
                               std::abs(std::atof(end_time)));
     }
 
+    if (single_event >= 0 && (n_threads > 1 || mpi_ranks > 1)) {
+      throw std::invalid_argument(
+          "A single event cannot be run on several threads or with MPI.");
+    }
+
     int64_t seed = configuration.read({"General", "Randomseed"});
     if (seed < 0) {
       configuration.set_value({"General", "Randomseed"},
                               random::generate_63bit_seed());
     }
 
+#ifdef SMASH_USE_MPI
+    if (mpi_ranks > 1) {
+      if (n_threads > 1) {
+        throw std::invalid_argument(
+            "Events cannot be run on several threads with MPI.");
+      }
+      // All ranks have to draw the seeds of the same sequence of events
+      int64_t run_seed = configuration.read({"General", "Randomseed"});
+      MPI_Bcast(&run_seed, 1, MPI_INT64_T, 0, MPI_COMM_WORLD);
+      configuration.set_value({"General", "Randomseed"}, run_seed);
+      // Every rank except the master writes to its own directory
+      if (mpi_rank > 0) {
+        output_path /= "rank_" + std::to_string(mpi_rank);
+        std::filesystem::create_directories(output_path);
+      }
+    }
+#endif
+
     // Avoid overwriting SMASH output
     const std::filesystem::path lock_path = output_path / "smash.lock";
     FileLock lock(lock_path);
@@ -673,25 +842,47 @@ int main(int argc, char *argv[]) {
         << "# Date     : " << BUILD_DATE << '\n'
         << configuration.to_string() << '\n';
 
-    initialize_particles_decays_and_tabulations(configuration, version,
-                                                tabulations_path);
+    // The master rank of an MPI run does not simulate any events
+    if (mpi_ranks == 1 || mpi_rank > 0) {
+      initialize_particles_decays_and_tabulations(configuration, version,
+                                                  tabulations_path);
+    }
 
-    // Create an experiment
-    logg[LMain].trace(SMASH_SOURCE_LOCATION, " create Experiment");
-    auto experiment = ExperimentBase::create(configuration, output_path);
+    if (mpi_ranks > 1) {
+#ifdef SMASH_USE_MPI
+      run_events_over_mpi(configuration, output_path, mpi_rank);
+#endif
+    } else if (n_threads == 1) {
+      // Create an experiment
+      logg[LMain].trace(SMASH_SOURCE_LOCATION, " create Experiment");
+      auto experiment = ExperimentBase::create(configuration, output_path);
+
+      // Version key is deprecated. If present, ignore it.
+      if (configuration.has_value({"Version"})) {
+        configuration.take({"Version"});
+      }
+      check_for_unused_config_values(configuration);
 
-    // Version key is deprecated. If present, ignore it.
-    if (configuration.has_value({"Version"})) {
-      configuration.take({"Version"});
+      // Run the experiment
+      logg[LMain].trace(SMASH_SOURCE_LOCATION, " run the Experiment");
+      if (single_event >= 0) {
+        SingleEventScheduler scheduler(single_event);
+        experiment->run(scheduler);
+      } else {
+        experiment->run();
+      }
+    } else {
+      run_events_concurrently(configuration, output_path, n_threads);
     }
-    check_for_unused_config_values(configuration);
-
-    // Run the experiment
-    logg[LMain].trace(SMASH_SOURCE_LOCATION, " run the Experiment");
-    experiment->run();
   } catch (std::exception &e) {
     logg[LMain].fatal() << "SMASH failed with the following error:\n"
                         << e.what();
+#ifdef SMASH_USE_MPI
+    // The other ranks would wait for this one forever
+    if (mpi_ranks > 1) {
+      MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+#endif
     return EXIT_FAILURE;
   }
 
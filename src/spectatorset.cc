@@ -0,0 +1,148 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/spectatorset.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <unordered_set>
+
+#include "smash/particles.h"
+
+namespace smash {
+
+namespace {
+/// Coordinates of a cell of the coarse mesh
+using MeshCell = std::array<int64_t, 3>;
+
+/**
+ * \param[in] data The particle.
+ * \param[in] inverse_length Inverse of the cell length of the mesh [1/fm].
+ * \return the cell of the mesh the particle is in.
+ */
+MeshCell mesh_cell(const ParticleData &data, double inverse_length) {
+  const ThreeVector &r = data.position().threevec();
+  return {static_cast<int64_t>(std::floor(r.x1() * inverse_length)),
+          static_cast<int64_t>(std::floor(r.x2() * inverse_length)),
+          static_cast<int64_t>(std::floor(r.x3() * inverse_length))};
+}
+
+/**
+ * Pack the cell coordinates into one key with 21 bits per coordinate. Cells
+ * further away than \f$2^{20}\f$ cells from the origin share their keys with
+ * other cells, which only lets spectators rejoin earlier.
+ *
+ * \param[in] cell The cell of the mesh.
+ * \return the key of the cell.
+ */
+uint64_t mesh_key(const MeshCell &cell) {
+  constexpr int64_t offset = int64_t{1} << 20;
+  constexpr uint64_t mask = (uint64_t{1} << 21) - 1;
+  return (static_cast<uint64_t>(cell[0] + offset) & mask) |
+         (static_cast<uint64_t>(cell[1] + offset) & mask) << 21 |
+         (static_cast<uint64_t>(cell[2] + offset) & mask) << 42;
+}
+
+/**
+ * \param[in] occupied Keys of the occupied cells.
+ * \param[in] cell The cell of the mesh.
+ * \return whether the cell or any of its 26 neighbors is occupied.
+ */
+bool neighborhood_occupied(const std::unordered_set<uint64_t> &occupied,
+                           const MeshCell &cell) {
+  if (occupied.empty()) {
+    return false;
+  }
+  for (int64_t dx = -1; dx <= 1; dx++) {
+    for (int64_t dy = -1; dy <= 1; dy++) {
+      for (int64_t dz = -1; dz <= 1; dz++) {
+        if (occupied.count(
+                mesh_key({cell[0] + dx, cell[1] + dy, cell[2] + dz}))) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+}  // unnamed namespace
+
+void SpectatorSet::reset(const Particles &particles) {
+  is_spectator_.clear();
+  size_ = 0;
+  for (const ParticleData &data : particles) {
+    if (data.belongs_to() == BelongsTo::Nothing ||
+        data.get_history().collisions_per_particle > 0 ||
+        !data.type().is_stable()) {
+      continue;
+    }
+    const auto id = static_cast<std::size_t>(data.id());
+    if (id >= is_spectator_.size()) {
+      is_spectator_.resize(id + 1, 0);
+    }
+    is_spectator_[id] = 1;
+    size_++;
+  }
+}
+
+std::size_t SpectatorSet::update(const Particles &particles,
+                                 double interaction_length, double dt) {
+  if (size_ == 0) {
+    return 0;
+  }
+  /* Within the time step, the spectator and the particles around it move by
+   * at most dt each. Products of interactions are placed within the
+   * interaction length of the interacting particles and move by at most dt
+   * as well. Particles further apart than this cannot interact. */
+  const double inverse_length = 1. / (2. * interaction_length + 3. * dt);
+  std::unordered_set<uint64_t> others, projectile, target;
+  size_ = 0;
+  for (const ParticleData &data : particles) {
+    const uint64_t key = mesh_key(mesh_cell(data, inverse_length));
+    if (!contains(data)) {
+      others.insert(key);
+    } else if (data.belongs_to() == BelongsTo::Projectile) {
+      projectile.insert(key);
+      size_++;
+    } else {
+      target.insert(key);
+      size_++;
+    }
+  }
+
+  bool any_rejoined = true;
+  while (any_rejoined && size_ > 0) {
+    any_rejoined = false;
+    for (const ParticleData &data : particles) {
+      if (!contains(data)) {
+        continue;
+      }
+      const MeshCell cell = mesh_cell(data, inverse_length);
+      const auto &other_nucleus =
+          data.belongs_to() == BelongsTo::Projectile ? target : projectile;
+      if (neighborhood_occupied(others, cell) ||
+          neighborhood_occupied(other_nucleus, cell)) {
+        is_spectator_[data.id()] = 0;
+        size_--;
+        others.insert(mesh_key(cell));
+        any_rejoined = true;
+      }
+    }
+  }
+  return size_;
+}
+
+bool SpectatorSet::contains(const ParticleData &data) const {
+  const auto id = static_cast<std::size_t>(data.id());
+  return data.id() >= 0 && id < is_spectator_.size() && is_spectator_[id] &&
+         data.get_history().collisions_per_particle == 0;
+}
+
+}  // namespace smash
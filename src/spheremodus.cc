@@ -9,15 +9,20 @@
 
 #include "smash/spheremodus.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <list>
 #include <map>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "smash/angles.h"
+#include "smash/boltzmannsampling.h"
 #include "smash/chemicalpotential.h"
 #include "smash/configuration.h"
 #include "smash/constants.h"
@@ -66,7 +71,12 @@ SphereModus::SphereModus(Configuration modus_config,
                          modus_config.take({"Sphere", "Jet", "Jet_PDG"}))
                    : std::nullopt),
 
-      jet_mom_(modus_config.take({"Sphere", "Jet", "Jet_Momentum"}, 20.)) {}
+      jet_mom_(modus_config.take({"Sphere", "Jet", "Jet_Momentum"}, 20.)),
+      freeze_out_rate_(modus_config.take({"Sphere", "Freeze_Out_Rate"}, 0.)) {
+  if (freeze_out_rate_ < 0.) {
+    throw std::invalid_argument("Freeze_Out_Rate must not be negative.");
+  }
+}
 
 /* console output on startup of sphere specific parameters */
 std::ostream &operator<<(std::ostream &out, const SphereModus &m) {
@@ -152,8 +162,21 @@ double SphereModus::initial_conditions(Particles *particles,
   if (this->init_distr_ == SphereInitialCondition::ThermalMomentaQuantum) {
     quantum_sampling = std::make_unique<QuantumSampling>(init_multipl_, V, T);
   }
-  /* loop over particle data to fill in momentum and position information */
-  for (ParticleData &data : *particles) {
+  const int n_threads = parameters.n_threads;
+  std::unique_ptr<BoltzmannSampling> boltzmann_sampling;
+  if (this->init_distr_ == SphereInitialCondition::ThermalMomentaBoltzmann) {
+    ParticleTypePtrList types;
+    for (const ParticleData &data : *particles) {
+      if (std::find(types.begin(), types.end(), &data.type()) ==
+          types.end()) {
+        types.push_back(&data.type());
+      }
+    }
+    boltzmann_sampling = std::make_unique<BoltzmannSampling>(
+        types, T, account_for_resonance_widths_, n_threads);
+  }
+  /* fill in momentum and position information, in parallel */
+  sample_particles_in_parallel(n_threads, *particles, [&](ParticleData &data) {
     Angles phitheta;
     /* thermal momentum according Maxwell-Boltzmann distribution */
     double momentum_radial = 0.0, mass = data.pole_mass();
@@ -173,10 +196,8 @@ double SphereModus::initial_conditions(Particles *particles,
         break;
       case (SphereInitialCondition::ThermalMomentaBoltzmann):
       default:
-        mass = (!account_for_resonance_widths_)
-                   ? data.type().mass()
-                   : HadronGasEos::sample_mass_thermal(data.type(), 1.0 / T);
-        momentum_radial = sample_momenta_from_thermal(T, mass);
+        std::tie(mass, momentum_radial) =
+            boltzmann_sampling->sample(data.type());
         break;
       case (SphereInitialCondition::ThermalMomentaQuantum):
         /*
@@ -191,11 +212,7 @@ double SphereModus::initial_conditions(Particles *particles,
         break;
     }
     phitheta.distribute_isotropically();
-    logg[LSphere].debug(data.type().name(), "(id ", data.id(),
-                        ") radial momentum ", momentum_radial, ", direction",
-                        phitheta);
     data.set_4momentum(mass, phitheta.threevec() * momentum_radial);
-    momentum_total += data.momentum();
     /* uniform sampling in a sphere with radius r */
     double position_radial;
     position_radial = std::cbrt(random::canonical()) * radius_;
@@ -204,6 +221,9 @@ double SphereModus::initial_conditions(Particles *particles,
     data.set_4position(
         FourVector(start_time_, pos_phitheta.threevec() * position_radial));
     data.set_formation_time(start_time_);
+  });
+  for (const ParticleData &data : *particles) {
+    momentum_total += data.momentum();
   }
 
   /* boost in radial direction with an underlying velocity field of the form u_r
@@ -10,6 +10,9 @@
 #include "smash/stringprocess.h"
 
 #include <array>
+#include <cmath>
+#include <optional>
+#include <string>
 
 #include "smash/angles.h"
 #include "smash/kinematics.h"
@@ -49,16 +52,27 @@ StringProcess::StringProcess(
       prob_proton_to_d_uu_(prob_proton_to_d_uu),
       separate_fragment_baryon_(separate_fragment_baryon),
       use_monash_tune_(use_monash_tune) {
+  for (int imu = 0; imu < 3; imu++) {
+    evecBasisAB_[imu] = ThreeVector(0., 0., 0.);
+  }
+
+  final_state_.clear();
+}
+
+void StringProcess::initialize_hadronization() {
   // setup and initialize pythia for fragmentation
   pythia_hadron_ = std::make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
   /* turn off all parton-level processes to implement only hadronization */
   pythia_hadron_->readString("ProcessLevel:all = off");
-  common_setup_pythia(pythia_hadron_.get(), strange_supp, diquark_supp,
-                      popcorn_rate, stringz_a, stringz_b, string_sigma_T);
+  common_setup_pythia(pythia_hadron_.get(), strange_supp_, diquark_supp_,
+                      popcorn_rate_, stringz_a_produce_, stringz_b_produce_,
+                      string_sigma_T_);
 
   /* initialize PYTHIA */
   pythia_hadron_->init();
 
+  build_fragment_tables();
+
   /*
    * The const_cast<type>() function is used to obtain the reference of the
    * PrivateInfo object in the pythia_hadron_.
@@ -79,11 +93,100 @@ StringProcess::StringProcess(
   event_intermediate_.init("intermediate partons",
                            &pythia_hadron_->particleData);
 
-  for (int imu = 0; imu < 3; imu++) {
-    evecBasisAB_[imu] = ThreeVector(0., 0., 0.);
+  if (pending_seed_ > 0) {
+    pythia_hadron_->rndm.init(pending_seed_);
+    logg[LPythia].debug("pythia_hadron_ : rndm is initialized with seed ",
+                        pending_seed_);
   }
+  logg[LPythia].debug("PYTHIA for the fragmentation initialized on first use");
+}
 
-  final_state_.clear();
+std::unique_ptr<StringProcess> StringProcess::clone() const {
+  auto copy = std::make_unique<StringProcess>(
+      kappa_tension_string_, time_formation_const_, pow_fgluon_beta_,
+      pmin_gluon_lightcone_, pow_fquark_alpha_, pow_fquark_beta_,
+      strange_supp_, diquark_supp_, sigma_qperp_, stringz_a_leading_,
+      stringz_b_leading_, stringz_a_produce_, stringz_b_produce_,
+      string_sigma_T_, soft_t_form_, mass_dependent_formation_times_,
+      prob_proton_to_d_uu_, separate_fragment_baryon_, popcorn_rate_,
+      use_monash_tune_);
+  copy->reseed_per_string_ = reseed_per_string_;
+  return copy;
+}
+
+void StringProcess::set_pythia_init_cache(
+    sha256::Hash hash, const std::filesystem::path &tabulations_path) {
+  if (tabulations_path.empty()) {
+    mpi_init_file_prefix_.clear();
+    return;
+  }
+  mpi_init_file_prefix_ =
+      (tabulations_path / ("pythia_mpi_" + sha256::hash_to_string(hash)))
+          .string();
+}
+
+void StringProcess::preinitialize_hard_pythia(
+    const std::vector<std::pair<PdgCode, PdgCode>> &beams, double sqrts) {
+  for (auto [pdg_a, pdg_b] : beams) {
+    const std::pair<int, int> idAB{pdg_map_for_pythia(pdg_a),
+                                   pdg_map_for_pythia(pdg_b)};
+    if (hard_map_.count(idAB) > 0) {
+      continue;  // several beams may be mapped onto the same PYTHIA beams
+    }
+    create_pythia_hard(idAB, sqrts, mpi_init_file_name(idAB, sqrts));
+  }
+}
+
+std::string StringProcess::mpi_init_file_name(
+    const std::pair<int, int> &idAB, double sqrts) {
+  if (mpi_init_file_prefix_.empty()) {
+    return "";
+  }
+  return mpi_init_file_prefix_ + "_" + std::to_string(idAB.first) + "_" +
+         std::to_string(idAB.second) + "_" + std::to_string(sqrts) + ".mpi";
+}
+
+double StringProcess::hard_init_sqrts(double sqrts) {
+  if (sqrts <= hard_init_sqrts_min) {
+    return hard_init_sqrts_min;
+  }
+  return hard_init_sqrts_min *
+         std::exp2(std::ceil(std::log2(sqrts / hard_init_sqrts_min)));
+}
+
+void StringProcess::create_pythia_hard(const std::pair<int, int> &idAB,
+                                       double sqrts,
+                                       const std::string &mpi_init_file) {
+  auto pythia = std::make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
+  pythia->readString("SoftQCD:nonDiffractive = on");
+  pythia->readString("MultipartonInteractions:pTmin = 1.5");
+  pythia->readString("HadronLevel:all = off");
+
+  common_setup_pythia(pythia.get(), strange_supp_, diquark_supp_,
+                      popcorn_rate_, stringz_a_produce_, stringz_b_produce_,
+                      string_sigma_T_);
+
+  pythia->settings.flag("Beams:allowVariableEnergy", true);
+
+  pythia->settings.mode("Beams:idA", idAB.first);
+  pythia->settings.mode("Beams:idB", idAB.second);
+  pythia->settings.parm("Beams:eCM", sqrts);
+
+  if (!mpi_init_file.empty()) {
+    /* Read the initialization of the multiparton interactions from the file
+     * if it exists, otherwise store it there for the next run. */
+    pythia->readString("MultipartonInteractions:reuseInit = 3");
+    pythia->readString("MultipartonInteractions:initFile = " + mpi_init_file);
+  }
+
+  logg[LPythia].debug("Pythia object initialized with ", idAB.first, " + ",
+                      idAB.second, " at CM energy [GeV] ", sqrts);
+
+  if (!pythia->init()) {
+    throw std::runtime_error("Pythia failed to initialize.");
+  }
+  hard_map_[idAB] = std::move(pythia);
+  hard_max_sqrts_[idAB] = sqrts;
 }
 
 void StringProcess::common_setup_pythia(Pythia8::Pythia *pythia_in,
@@ -211,6 +314,9 @@ int StringProcess::append_final_state(ParticleList &intermediate_particles,
 }
 
 void StringProcess::init(const ParticleList &incoming, double tcoll) {
+  if (reseed_per_string_) {
+    init_pythia_hadron_rndm();
+  }
   PDGcodes_[0] = incoming[0].pdgcode();
   PDGcodes_[1] = incoming[1].pdgcode();
   massA_ = incoming[0].effective_mass();
@@ -257,8 +363,8 @@ bool StringProcess::next_SDiff(bool is_AB_to_AX) {
   make_string_ends(is_AB_to_AX ? PDGcodes_[1] : PDGcodes_[0], idqX1, idqX2,
                    prob_proton_to_d_uu_);
   // string mass must be larger than threshold set by PYTHIA.
-  mstrMin = pythia_hadron_->particleData.m0(idqX1) +
-            pythia_hadron_->particleData.m0(idqX2);
+  mstrMin = pythia_hadron()->particleData.m0(idqX1) +
+            pythia_hadron()->particleData.m0(idqX2);
   // this threshold cannot be larger than maximum of allowed string mass.
   if (mstrMin > mstrMax) {
     return false;
@@ -331,8 +437,8 @@ bool StringProcess::set_mass_and_direction_2strings(
 
     m_str[i] = pstr_com[i].sqr();
     m_str[i] = (m_str[i] > 0.) ? std::sqrt(m_str[i]) : 0.;
-    const double threshold = pythia_hadron_->particleData.m0(quarks[i][0]) +
-                             pythia_hadron_->particleData.m0(quarks[i][1]);
+    const double threshold = pythia_hadron()->particleData.m0(quarks[i][0]) +
+                             pythia_hadron()->particleData.m0(quarks[i][1]);
     // string mass must be larger than threshold set by PYTHIA.
     if (m_str[i] > threshold) {
       found_mass[i] = true;
@@ -561,46 +667,29 @@ bool StringProcess::next_NDiffHard() {
 
   std::pair<int, int> idAB{pdg_for_pythia[0], pdg_for_pythia[1]};
 
-  // If an entry for the calculated particle IDs does not exist, create one and
-  // initialize it accordingly
-  if (hard_map_.count(idAB) == 0) {
-    hard_map_[idAB] = std::make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
-    hard_map_[idAB]->readString("SoftQCD:nonDiffractive = on");
-    hard_map_[idAB]->readString("MultipartonInteractions:pTmin = 1.5");
-    hard_map_[idAB]->readString("HadronLevel:all = off");
-
-    common_setup_pythia(hard_map_[idAB].get(), strange_supp_, diquark_supp_,
-                        popcorn_rate_, stringz_a_produce_, stringz_b_produce_,
-                        string_sigma_T_);
-
-    hard_map_[idAB]->settings.flag("Beams:allowVariableEnergy", true);
-
-    hard_map_[idAB]->settings.mode("Beams:idA", idAB.first);
-    hard_map_[idAB]->settings.mode("Beams:idB", idAB.second);
-    hard_map_[idAB]->settings.parm("Beams:eCM", sqrtsAB_);
-
-    logg[LPythia].debug("Pythia object initialized with ", pdg_for_pythia[0],
-                        " + ", pdg_for_pythia[1], " at CM energy [GeV] ",
-                        sqrtsAB_);
-
-    if (!hard_map_[idAB]->init()) {
-      throw std::runtime_error("Pythia failed to initialize.");
-    }
+  /* If an entry for the calculated particle IDs does not exist or was
+   * initialized below the collision energy, (re)initialize one at the upper
+   * edge of the energy bin, such that all lower energies reuse it. */
+  if (hard_map_.count(idAB) == 0 || sqrtsAB_ > hard_max_sqrts_[idAB]) {
+    const double sqrts_init = hard_init_sqrts(sqrtsAB_);
+    create_pythia_hard(idAB, sqrts_init,
+                       mpi_init_file_name(idAB, sqrts_init));
   }
+  Pythia8::Pythia &pythia_hard = *hard_map_[idAB];
 
   const int seed_new = random::uniform_int(1, maximum_rndm_seed_in_pythia);
-  hard_map_[idAB]->rndm.init(seed_new);
+  pythia_hard.rndm.init(seed_new);
   logg[LPythia].debug("hard_map_[", idAB.first, "][", idAB.second,
                       "] : rndm is initialized with seed ", seed_new);
 
   // Change the energy using the Pythia 8.302+ feature
 
   // Short notation for Pythia event
-  Pythia8::Event &event_hadron = pythia_hadron_->event;
+  Pythia8::Event &event_hadron = pythia_hadron()->event;
   logg[LPythia].debug("Pythia hard event created");
   // we update the collision energy in the CM frame
-  hard_map_[idAB]->setKinematics(sqrtsAB_);
-  bool final_state_success = hard_map_[idAB]->next();
+  pythia_hard.setKinematics(sqrtsAB_);
+  bool final_state_success = pythia_hard.next();
   logg[LPythia].debug("Pythia final state computed, success = ",
                       final_state_success);
   if (!final_state_success) {
@@ -615,15 +704,15 @@ bool StringProcess::next_NDiffHard() {
   /* Update the partonic intermediate state from PYTHIA output.
    * Note that hadronization will be performed separately,
    * after identification of strings and replacement of constituents. */
-  for (int i = 0; i < hard_map_[idAB]->event.size(); i++) {
-    if (hard_map_[idAB]->event[i].isFinal()) {
-      const int pdgid = hard_map_[idAB]->event[i].id();
-      Pythia8::Vec4 pquark = hard_map_[idAB]->event[i].p();
-      const double mass = hard_map_[idAB]->particleData.m0(pdgid);
+  for (int i = 0; i < pythia_hard.event.size(); i++) {
+    if (pythia_hard.event[i].isFinal()) {
+      const int pdgid = pythia_hard.event[i].id();
+      Pythia8::Vec4 pquark = pythia_hard.event[i].p();
+      const double mass = pythia_hard.particleData.m0(pdgid);
 
-      const int status = hard_map_[idAB]->event[i].status();
-      const int color = hard_map_[idAB]->event[i].col();
-      const int anticolor = hard_map_[idAB]->event[i].acol();
+      const int status = pythia_hard.event[i].status();
+      const int color = pythia_hard.event[i].col();
+      const int anticolor = pythia_hard.event[i].acol();
 
       pSum += pquark;
       event_intermediate_.append(pdgid, status, color, anticolor, pquark, mass);
@@ -631,11 +720,11 @@ bool StringProcess::next_NDiffHard() {
   }
   // add junctions to the intermediate state if there is any.
   event_intermediate_.clearJunctions();
-  for (int i = 0; i < hard_map_[idAB]->event.sizeJunction(); i++) {
-    const int kind = hard_map_[idAB]->event.kindJunction(i);
+  for (int i = 0; i < pythia_hard.event.sizeJunction(); i++) {
+    const int kind = pythia_hard.event.kindJunction(i);
     std::array<int, 3> col;
     for (int j = 0; j < 3; j++) {
-      col[j] = hard_map_[idAB]->event.colJunction(i, j);
+      col[j] = pythia_hard.event.colJunction(i, j);
     }
     event_intermediate_.appendJunction(kind, col[0], col[1], col[2]);
   }
@@ -660,7 +749,7 @@ bool StringProcess::next_NDiffHard() {
     const int pdgid = event_intermediate_[ipart].id();
     if (event_intermediate_[ipart].isFinal() &&
         !event_intermediate_[ipart].isParton() &&
-        !hard_map_[idAB]->particleData.isOctetHadron(pdgid)) {
+        !pythia_hard.particleData.isOctetHadron(pdgid)) {
       logg[LPythia].debug("PDG ID from Pythia: ", pdgid);
       FourVector momentum = reorient(event_intermediate_[ipart], evecBasisAB_);
       logg[LPythia].debug("4-momentum from Pythia: ", momentum);
@@ -685,8 +774,8 @@ bool StringProcess::next_NDiffHard() {
   // identify and fragment strings until there is no parton left.
   while (event_intermediate_.size() > 1) {
     // dummy event to initialize the internal variables of PYTHIA.
-    pythia_hadron_->event.reset();
-    if (!pythia_hadron_->next()) {
+    pythia_hadron()->event.reset();
+    if (!pythia_hadron()->next()) {
       logg[LPythia].debug("  Dummy event in hard string routine failed.");
       hadronize_success = false;
       break;
@@ -695,16 +784,16 @@ bool StringProcess::next_NDiffHard() {
     if (event_intermediate_.sizeJunction() > 0) {
       // identify string from a junction if there is any.
       compose_string_junction(find_forward_string, event_intermediate_,
-                              pythia_hadron_->event);
+                              pythia_hadron()->event);
     } else {
       /* identify string from a most forward or backward parton.
        * if there is no junction. */
       compose_string_parton(find_forward_string, event_intermediate_,
-                            pythia_hadron_->event);
+                            pythia_hadron()->event);
     }
 
     // fragment the (identified) string into hadrons.
-    hadronize_success = pythia_hadron_->forceHadronLevel(false);
+    hadronize_success = pythia_hadron()->forceHadronLevel(false);
     logg[LPythia].debug("Pythia hadronized, success = ", hadronize_success);
 
     new_intermediate_particles.clear();
@@ -884,7 +973,7 @@ void StringProcess::replace_constituent(
 
   // update the constituent mass and energy.
   Pythia8::Vec4 pquark = particle.p();
-  double mass_new = pythia_hadron_->particleData.m0(pdgid_new);
+  double mass_new = pythia_hadron()->particleData.m0(pdgid_new);
   double e_new = std::sqrt(mass_new * mass_new + pquark.pAbs() * pquark.pAbs());
   // update the particle object.
   particle.id(pdgid_new);
@@ -909,12 +998,12 @@ void StringProcess::find_total_number_constituent(
       // quarks
       for (int iflav = 0; iflav < 5; iflav++) {
         nquark_total[iflav] +=
-            pythia_hadron_->particleData.nQuarksInCode(pdgid, iflav + 1);
+            pythia_hadron()->particleData.nQuarksInCode(pdgid, iflav + 1);
       }
     } else {
       // antiquarks
       for (int iflav = 0; iflav < 5; iflav++) {
-        nantiq_total[iflav] += pythia_hadron_->particleData.nQuarksInCode(
+        nantiq_total[iflav] += pythia_hadron()->particleData.nQuarksInCode(
             std::abs(pdgid), iflav + 1);
       }
     }
@@ -989,7 +1078,7 @@ bool StringProcess::splitting_gluon_qqbar(
         Pythia8::Vec4 pgluon = event_intermediate[iforward].p();
 
         const int pdgid = iflav + 1;
-        const double mass = pythia_hadron_->particleData.m0(pdgid);
+        const double mass = pythia_hadron()->particleData.m0(pdgid);
         const int status = event_intermediate[iforward].status();
         /* color and anticolor indices.
          * the color index of gluon goes to the quark, while
@@ -1006,7 +1095,7 @@ bool StringProcess::splitting_gluon_qqbar(
         // four momenta of quark and antiquark
         std::array<Pythia8::Vec4, 2> pquark;
         // transverse momentum scale of string fragmentation
-        const double sigma_qt_frag = pythia_hadron_->parm("StringPT:sigma");
+        const double sigma_qt_frag = pythia_hadron()->parm("StringPT:sigma");
         // sample relative transverse momentum between quark and antiquark
         const double qx = random::normal(0., sigma_qt_frag * M_SQRT1_2);
         const double qy = random::normal(0., sigma_qt_frag * M_SQRT1_2);
@@ -1200,7 +1289,7 @@ bool StringProcess::restore_constituent(
 
         const int pdgid = event_intermediate[iforward].id();
         Pythia8::Vec4 pquark = event_intermediate[iforward].p();
-        const double mass = pythia_hadron_->particleData.m0(pdgid);
+        const double mass = pythia_hadron()->particleData.m0(pdgid);
 
         const int status = event_intermediate[iforward].status();
         const int color = event_intermediate[iforward].col();
@@ -1605,8 +1694,8 @@ bool StringProcess::next_BBbarAnn() {
   bool kin_threshold_satisfied = true;
   for (int i = 0; i < 2; i++) {
     const double mstr_min =
-        pythia_hadron_->particleData.m0(remaining_quarks[i]) +
-        pythia_hadron_->particleData.m0(remaining_antiquarks[i]);
+        pythia_hadron()->particleData.m0(remaining_quarks[i]) +
+        pythia_hadron()->particleData.m0(remaining_antiquarks[i]);
     if (mstr_min > mstr[i]) {
       kin_threshold_satisfied = false;
     }
@@ -1770,7 +1859,7 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
                                    ThreeVector &evecLong, bool flip_string_ends,
                                    bool separate_fragment_baryon,
                                    ParticleList &intermediate_particles) {
-  pythia_hadron_->event.reset();
+  pythia_hadron()->event.reset();
   intermediate_particles.clear();
 
   logg[LPythia].debug("initial quark content for fragment_string : ", idq1,
@@ -1788,9 +1877,9 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
 
   for (int i = 0; i < 2; i++) {
     // evaluate total baryon number of the string times 3
-    bstring += pythia_hadron_->particleData.baryonNumberType(idqIn[i]);
+    bstring += pythia_hadron()->particleData.baryonNumberType(idqIn[i]);
 
-    m_const[i] = pythia_hadron_->particleData.m0(idqIn[i]);
+    m_const[i] = pythia_hadron()->particleData.m0(idqIn[i]);
   }
   logg[LPythia].debug("baryon number of string times 3 : ", bstring);
 
@@ -1934,7 +2023,7 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
           idqIn[0] = bstring > 0 ? flav_string_neg.id : flav_string_pos.id;
           idqIn[1] = bstring > 0 ? flav_string_pos.id : flav_string_neg.id;
           for (int i = 0; i < 2; i++) {
-            m_const[i] = pythia_hadron_->particleData.m0(idqIn[i]);
+            m_const[i] = pythia_hadron()->particleData.m0(idqIn[i]);
           }
           QTrn_string_pos = std::sqrt(QTrx_string_pos * QTrx_string_pos +
                                       QTry_string_pos * QTry_string_pos);
@@ -1967,7 +2056,7 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
           found_forward_baryon =
               found_forward_baryon ||
               (from_forward &&
-               pythia_hadron_->particleData.isBaryon(pdgid_frag[0]));
+               pythia_hadron()->particleData.isBaryon(pdgid_frag[0]));
         }
         if (n_frag == 2) {
           energy_used_up = true;
@@ -2111,7 +2200,7 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
           std::sqrt(m_const[0] * m_const[0] + three_mom.sqr());
       pquark = set_Vec4(E_quark, three_mom);
       pSum += pquark;
-      pythia_hadron_->event.append(idqIn[0], status, color, anticolor, pquark,
+      pythia_hadron()->event.append(idqIn[0], status, color, anticolor, pquark,
                                    m_const[0]);
 
       // antiquark end of the remaining (mesonic) string
@@ -2143,7 +2232,7 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
           std::sqrt(m_const[1] * m_const[1] + three_mom.sqr());
       pquark = set_Vec4(E_antiq, three_mom);
       pSum += pquark;
-      pythia_hadron_->event.append(idqIn[1], status, color, anticolor, pquark,
+      pythia_hadron()->event.append(idqIn[1], status, color, anticolor, pquark,
                                    m_const[1]);
     }
   } else {
@@ -2179,22 +2268,22 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
     const int status1 = 1, color1 = 1, anticolor1 = 0;
     Pythia8::Vec4 pquark = set_Vec4(E1, -direction * pCMquark);
     pSum += pquark;
-    pythia_hadron_->event.append(idqIn[0], status1, color1, anticolor1, pquark,
+    pythia_hadron()->event.append(idqIn[0], status1, color1, anticolor1, pquark,
                                  m_const[0]);
 
     const int status2 = 1, color2 = 0, anticolor2 = 1;
     pquark = set_Vec4(E2, direction * pCMquark);
     pSum += pquark;
-    pythia_hadron_->event.append(idqIn[1], status2, color2, anticolor2, pquark,
+    pythia_hadron()->event.append(idqIn[1], status2, color2, anticolor2, pquark,
                                  m_const[1]);
   }
 
   if (do_string_fragmentation) {
     logg[LPythia].debug("fragmenting a string with ", idqIn[0], ", ", idqIn[1]);
     // implement PYTHIA fragmentation
-    pythia_hadron_->event[0].p(pSum);
-    pythia_hadron_->event[0].m(pSum.mCalc());
-    bool successful_hadronization = pythia_hadron_->next();
+    pythia_hadron()->event[0].p(pSum);
+    pythia_hadron()->event[0].m(pSum.mCalc());
+    bool successful_hadronization = pythia_hadron()->next();
     // update_info();
     if (!successful_hadronization) {
       return 0;
@@ -2203,24 +2292,25 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
     /* Add transverse momenta of string ends to the most forward and
      * backward hadrons from PYTHIA fragmentation. */
     bool successful_kinematics = remake_kinematics_fragments(
-        pythia_hadron_->event, evec_basis, ppos_string_new, pneg_string_new,
+        pythia_hadron()->event, evec_basis, ppos_string_new, pneg_string_new,
         QTrx_string_new, QTry_string_new, QTrx_add_pos, QTry_add_pos,
         QTrx_add_neg, QTry_add_neg);
     if (!successful_kinematics) {
       return 0;
     }
 
-    for (int ipyth = 0; ipyth < pythia_hadron_->event.size(); ipyth++) {
-      if (!pythia_hadron_->event[ipyth].isFinal()) {
+    for (int ipyth = 0; ipyth < pythia_hadron()->event.size(); ipyth++) {
+      if (!pythia_hadron()->event[ipyth].isFinal()) {
         continue;
       }
-      int pythia_id = pythia_hadron_->event[ipyth].id();
+      int pythia_id = pythia_hadron()->event[ipyth].id();
       /* K_short and K_long need are converted to K0
        * since SMASH only knows K0 */
       convert_KaonLS(pythia_id);
-      FourVector momentum(
-          pythia_hadron_->event[ipyth].e(), pythia_hadron_->event[ipyth].px(),
-          pythia_hadron_->event[ipyth].py(), pythia_hadron_->event[ipyth].pz());
+      FourVector momentum(pythia_hadron()->event[ipyth].e(),
+                          pythia_hadron()->event[ipyth].px(),
+                          pythia_hadron()->event[ipyth].py(),
+                          pythia_hadron()->event[ipyth].pz());
       logg[LPythia].debug("appending the fragmented hadron ", pythia_id,
                           " to the intermediate particle list.");
       bool found_ptype =
@@ -2274,18 +2364,18 @@ int StringProcess::fragment_off_hadron(
                       " ) with mass ", mass_string, " GeV.");
 
   // Take relevant parameters from PYTHIA.
-  const double sigma_qt_frag = pythia_hadron_->parm("StringPT:sigma");
+  const double sigma_qt_frag = pythia_hadron()->parm("StringPT:sigma");
   const double stop_string_mass =
-      pythia_hadron_->parm("StringFragmentation:stopMass");
+      pythia_hadron()->parm("StringFragmentation:stopMass");
   const double stop_string_smear =
-      pythia_hadron_->parm("StringFragmentation:stopSmear");
+      pythia_hadron()->parm("StringFragmentation:stopSmear");
 
   // Enhance the width of transverse momentum with certain probability
   const double prob_enhance_qt =
-      pythia_hadron_->parm("StringPT:enhancedFraction");
+      pythia_hadron()->parm("StringPT:enhancedFraction");
   double fac_enhance_qt;
   if (random::uniform(0., 1.) < prob_enhance_qt) {
-    fac_enhance_qt = pythia_hadron_->parm("StringPT:enhancedWidth");
+    fac_enhance_qt = pythia_hadron()->parm("StringPT:enhancedWidth");
   } else {
     fac_enhance_qt = 1.;
   }
@@ -2336,12 +2426,12 @@ int StringProcess::fragment_off_hadron(
    * species. */
   for (int i_try = 0; i_try < n_try; i_try++) {
     // Sample the new flavor.
-    flav_new = pythia_stringflav_.pick(flav_old);
+    flav_new = pythia_stringflav().pick(flav_old);
     // Combine to get the PDG id of hadron.
-    pdgid_had_1st = pythia_stringflav_.combine(flav_old, flav_new);
+    pdgid_had_1st = pythia_stringflav().combine(flav_old, flav_new);
     if (pdgid_had_1st != 0) {
       // If the PDG id is found, determine mass.
-      mass_had_1st = pythia_hadron_->particleData.mSel(pdgid_had_1st);
+      mass_had_1st = pythia_hadron()->particleData.mSel(pdgid_had_1st);
       logg[LPythia].debug("    number of tries of flavor selection : ",
                           i_try + 1, " in StringProcess::fragment_off_hadron.");
       break;
@@ -2354,7 +2444,7 @@ int StringProcess::fragment_off_hadron(
                       " selected for the string end with ", flav_old.id);
   logg[LPythia].debug("  PDG id ", pdgid_had_1st,
                       " selected for the (first) fragmented hadron.");
-  bool had_1st_baryon = pythia_hadron_->particleData.isBaryon(pdgid_had_1st);
+  bool had_1st_baryon = pythia_hadron()->particleData.isBaryon(pdgid_had_1st);
   // Transverse mass of the (first) fragmented hadron
   double mTrn_had_1st =
       std::sqrt(mass_had_1st * mass_had_1st + QTrn_had_1st * QTrn_had_1st);
@@ -2366,9 +2456,9 @@ int StringProcess::fragment_off_hadron(
    * This formula is taken from StringFragmentation::energyUsedUp
    * in StringFragmentation.cc of PYTHIA 8. */
   const double mass_min_to_continue =
-      (stop_string_mass + pythia_hadron_->particleData.m0(flav_new.id) +
-       pythia_hadron_->particleData.m0(flav_string_pos.id) +
-       pythia_hadron_->particleData.m0(flav_string_neg.id)) *
+      (stop_string_mass + pythia_hadron()->particleData.m0(flav_new.id) +
+       pythia_hadron()->particleData.m0(flav_string_pos.id) +
+       pythia_hadron()->particleData.m0(flav_string_neg.id)) *
       (1. + (2. * random::uniform(0., 1.) - 1.) * stop_string_smear);
   /* If the string mass is lower than that threshold,
    * the string breaks into the last two hadrons. */
@@ -2386,11 +2476,12 @@ int StringProcess::fragment_off_hadron(
   /* Whether the string end, at which the (first) hadron is fragmented,
    * had a diquark or antidiquark */
   bool from_diquark_end =
-      from_forward ? pythia_hadron_->particleData.isDiquark(flav_string_pos.id)
-                   : pythia_hadron_->particleData.isDiquark(flav_string_neg.id);
+      from_forward
+          ? pythia_hadron()->particleData.isDiquark(flav_string_pos.id)
+          : pythia_hadron()->particleData.isDiquark(flav_string_neg.id);
   // Whether the forward end of the string has a diquark
   bool has_diquark_pos =
-      pythia_hadron_->particleData.isDiquark(flav_string_pos.id);
+      pythia_hadron()->particleData.isDiquark(flav_string_pos.id);
 
   int n_frag = 0;
   if (string_into_final_two) {
@@ -2406,22 +2497,24 @@ int StringProcess::fragment_off_hadron(
     flav_new2.anti(flav_new);
     /* Getting a hadron from diquark and antidiquark does not always work.
      * So, if this is the case, start over. */
-    if (pythia_hadron_->particleData.isDiquark(flav_string_neg.id) &&
-        pythia_hadron_->particleData.isDiquark(flav_new2.id) && from_forward) {
+    if (pythia_hadron()->particleData.isDiquark(flav_string_neg.id) &&
+        pythia_hadron()->particleData.isDiquark(flav_new2.id) && from_forward) {
       return 0;
     }
-    if (pythia_hadron_->particleData.isDiquark(flav_string_pos.id) &&
-        pythia_hadron_->particleData.isDiquark(flav_new2.id) && !from_forward) {
+    if (pythia_hadron()->particleData.isDiquark(flav_string_pos.id) &&
+        pythia_hadron()->particleData.isDiquark(flav_new2.id) &&
+        !from_forward) {
       return 0;
     }
     for (int i_try = 0; i_try < n_try; i_try++) {
       // Combine to get the PDG id of the second hadron.
       pdgid_had_2nd =
-          from_forward ? pythia_stringflav_.combine(flav_string_neg, flav_new2)
-                       : pythia_stringflav_.combine(flav_string_pos, flav_new2);
+          from_forward
+              ? pythia_stringflav().combine(flav_string_neg, flav_new2)
+              : pythia_stringflav().combine(flav_string_pos, flav_new2);
       if (pdgid_had_2nd != 0) {
         // If the PDG id is found, determine mass.
-        mass_had_2nd = pythia_hadron_->particleData.mSel(pdgid_had_2nd);
+        mass_had_2nd = pythia_hadron()->particleData.mSel(pdgid_had_2nd);
         break;
       }
     }
@@ -2430,7 +2523,7 @@ int StringProcess::fragment_off_hadron(
     }
     logg[LPythia].debug("  PDG id ", pdgid_had_2nd,
                         " selected for the (second) fragmented hadron.");
-    bool had_2nd_baryon = pythia_hadron_->particleData.isBaryon(pdgid_had_2nd);
+    bool had_2nd_baryon = pythia_hadron()->particleData.isBaryon(pdgid_had_2nd);
 
     /* Determine transverse momentum carried by the second hadron.
      * If the first hadron fragmented from the forward (backward) end
@@ -2569,11 +2662,127 @@ int StringProcess::fragment_off_hadron(
   return n_frag;
 }
 
-int StringProcess::get_hadrontype_from_quark(int idq1, int idq2) {
-  const int baryon_number =
-      pythia_hadron_->particleData.baryonNumberType(idq1) +
-      pythia_hadron_->particleData.baryonNumberType(idq2);
+int StringProcess::quark_code_index(int idq) {
+  const int id = std::abs(idq);
+  int index = -1;
+  if (id >= 1 && id <= 5) {
+    index = id - 1;
+  } else {
+    // diquarks 1000 * a + 100 * b + 2 * s + 1 with b <= a
+    const int a = id / 1000;
+    const int b = (id / 100) % 10;
+    const int spin = id % 100;
+    if (id >= 1000 && id < 6000 && b >= 1 && b <= a && (id / 10) % 10 == 0 &&
+        (spin == 1 || spin == 3)) {
+      index = 5 + 2 * ((a - 1) * a / 2 + b - 1) + (spin == 3 ? 1 : 0);
+    }
+  }
+  if (index < 0) {
+    return -1;
+  }
+  return idq > 0 ? index : index + n_quark_codes_ / 2;
+}
+
+StringProcess::FragmentCandidates StringProcess::find_fragment_candidates(
+    int idq1, int idq2) const {
+  FragmentCandidates candidates;
+  // PYTHIA is set up before the tables are built, see fragment_candidates.
+  const Pythia8::ParticleData &pdata = pythia_hadron_->particleData;
 
+  // net quark number of d, u, s, c and b flavors
+  std::array<int, 5> net_qnumber;
+  for (int iflav = 0; iflav < 5; iflav++) {
+    int qnumber1 = pdata.nQuarksInCode(std::abs(idq1), iflav + 1);
+    int qnumber2 = pdata.nQuarksInCode(std::abs(idq2), iflav + 1);
+    // anti-quarks and anti-diquarks get an extra minus sign.
+    qnumber1 = idq1 > 0 ? qnumber1 : -qnumber1;
+    qnumber2 = idq2 > 0 ? qnumber2 : -qnumber2;
+    net_qnumber[iflav] = qnumber1 + qnumber2;
+  }
+  const int iso3 = net_qnumber[1] - net_qnumber[0];
+  const int strange = -net_qnumber[2];
+  const int charm = net_qnumber[3];
+  const int bottom = -net_qnumber[4];
+
+  const int baryon_number_type =
+      pdata.baryonNumberType(idq1) + pdata.baryonNumberType(idq2);
+  /* The baryon number of a resonance made of a quark (anti-diquark) and an
+   * anti-quark (diquark), see get_resonance_from_quark. */
+  const bool end1_is_quark = idq1 > 0 && pdata.isQuark(idq1);
+  const bool end1_is_antidiq = idq1 < 0 && pdata.isDiquark(idq1);
+  const bool end2_is_antiq = idq2 < 0 && pdata.isQuark(idq2);
+  const bool end2_is_diquark = idq2 > 0 && pdata.isDiquark(idq2);
+  std::optional<int> resonance_baryon;
+  if (end1_is_quark && end2_is_antiq) {
+    resonance_baryon = 0;
+  } else if (end1_is_quark && end2_is_diquark) {
+    resonance_baryon = 1;
+  } else if (end1_is_antidiq && end2_is_antiq) {
+    resonance_baryon = -1;
+  }
+
+  candidates.hadron_weight_summed.push_back(0.);
+  for (auto &ptype : ParticleType::list_all()) {
+    if (!ptype.is_hadron()) {
+      continue;
+    }
+    const PdgCode pdg = ptype.pdgcode();
+    if (pdg.isospin3() != iso3 || pdg.strangeness() != strange ||
+        pdg.charmness() != charm || pdg.bottomness() != bottom) {
+      continue;
+    }
+    const int pdgid = pdg.get_decimal();
+    /* Any hadron with the same valence quark contents is allowed and
+     * the probability goes like spin degeneracy over mass. */
+    if (pdata.isParticle(pdgid) &&
+        baryon_number_type == 3 * pdg.baryon_number()) {
+      const double weight =
+          static_cast<double>(pdg.spin_degeneracy()) / ptype.mass();
+      candidates.hadron_pdgids.push_back(pdgid);
+      candidates.hadron_weight_summed.push_back(
+          candidates.hadron_weight_summed.back() + weight);
+    }
+    // Only resonances with the same baryon number are considered.
+    if (resonance_baryon && !ptype.is_stable() &&
+        pdg.baryon_number() == *resonance_baryon) {
+      candidates.resonance_pdgids.push_back(pdgid);
+      candidates.resonance_min_mass.push_back(ptype.min_mass_spectral());
+      candidates.resonance_pole_mass.push_back(ptype.mass());
+    }
+  }
+  return candidates;
+}
+
+void StringProcess::build_fragment_tables() {
+  fragment_candidates_.clear();
+  fragment_candidates_.reserve(n_quark_codes_ * n_quark_codes_);
+  std::array<int, n_quark_codes_> codes;
+  for (int id = 1; id < 6000; id++) {
+    const int index = quark_code_index(id);
+    if (index >= 0) {
+      codes[index] = id;
+      codes[index + n_quark_codes_ / 2] = -id;
+    }
+  }
+  for (int idq1 : codes) {
+    for (int idq2 : codes) {
+      fragment_candidates_.push_back(find_fragment_candidates(idq1, idq2));
+    }
+  }
+}
+
+const StringProcess::FragmentCandidates &StringProcess::fragment_candidates(
+    int idq1, int idq2, FragmentCandidates &buffer) const {
+  const int index1 = quark_code_index(idq1);
+  const int index2 = quark_code_index(idq2);
+  if (index1 < 0 || index2 < 0 || fragment_candidates_.empty()) {
+    buffer = find_fragment_candidates(idq1, idq2);
+    return buffer;
+  }
+  return fragment_candidates_[index1 * n_quark_codes_ + index2];
+}
+
+int StringProcess::get_hadrontype_from_quark(int idq1, int idq2) {
   int pdgid_hadron = 0;
   /* PDG id of the leading baryon from valence quark constituent.
    * First, try with the PYTHIA machinary. */
@@ -2581,76 +2790,27 @@ int StringProcess::get_hadrontype_from_quark(int idq1, int idq2) {
   Pythia8::FlavContainer flav2 = Pythia8::FlavContainer(idq2);
   const int n_try = 10;
   for (int i_try = 0; i_try < n_try; i_try++) {
-    pdgid_hadron = pythia_stringflav_.combine(flav1, flav2);
+    pdgid_hadron = pythia_stringflav().combine(flav1, flav2);
     if (pdgid_hadron != 0) {
       return pdgid_hadron;
     }
   }
 
   /* If PYTHIA machinary does not work, determine type of the leading baryon
-   * based on the quantum numbers and mass. */
-
-  // net quark number of d, u, s, c and b flavors
-  std::array<int, 5> frag_net_q;
-  /* Evaluate total net quark number of baryon (antibaryon)
-   * from the valence quark constituents. */
-  for (int iq = 0; iq < 5; iq++) {
-    int nq1 =
-        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq1), iq + 1);
-    int nq2 =
-        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq2), iq + 1);
-    nq1 = idq1 > 0 ? nq1 : -nq1;
-    nq2 = idq2 > 0 ? nq2 : -nq2;
-    frag_net_q[iq] = nq1 + nq2;
-  }
-  const int frag_iso3 = frag_net_q[1] - frag_net_q[0];
-  const int frag_strange = -frag_net_q[2];
-  const int frag_charm = frag_net_q[3];
-  const int frag_bottom = -frag_net_q[4];
-  logg[LPythia].debug("  conserved charges : iso3 = ", frag_iso3,
-                      ", strangeness = ", frag_strange,
-                      ", charmness = ", frag_charm,
-                      ", bottomness = ", frag_bottom);
-
-  std::vector<int> pdgid_possible;
-  std::vector<double> weight_possible;
-  std::vector<double> weight_summed;
-  /* loop over hadronic species
-   * Any hadron with the same valence quark contents is allowed and
-   * the probability goes like spin degeneracy over mass. */
-  for (auto &ptype : ParticleType::list_all()) {
-    if (!ptype.is_hadron()) {
-      continue;
-    }
-    const int pdgid = ptype.pdgcode().get_decimal();
-    if ((pythia_hadron_->particleData.isParticle(pdgid)) &&
-        (baryon_number == 3 * ptype.pdgcode().baryon_number()) &&
-        (frag_iso3 == ptype.pdgcode().isospin3()) &&
-        (frag_strange == ptype.pdgcode().strangeness()) &&
-        (frag_charm == ptype.pdgcode().charmness()) &&
-        (frag_bottom == ptype.pdgcode().bottomness())) {
-      const int spin_degeneracy = ptype.pdgcode().spin_degeneracy();
-      const double mass_pole = ptype.mass();
-      const double weight = static_cast<double>(spin_degeneracy) / mass_pole;
-      pdgid_possible.push_back(pdgid);
-      weight_possible.push_back(weight);
-
-      logg[LPythia].debug("  PDG id ", pdgid, " is possible with weight ",
-                          weight);
-    }
-  }
-  const int n_possible = pdgid_possible.size();
-  weight_summed.push_back(0.);
-  for (int i = 0; i < n_possible; i++) {
-    weight_summed.push_back(weight_summed[i] + weight_possible[i]);
-  }
+   * based on the quantum numbers and mass. The hadrons with the same quantum
+   * numbers and their weights are looked up in the tables. */
+  FragmentCandidates buffer;
+  const FragmentCandidates &candidates =
+      fragment_candidates(idq1, idq2, buffer);
+  const std::vector<double> &weight_summed = candidates.hadron_weight_summed;
+  const int n_possible = candidates.hadron_pdgids.size();
 
   /* Sample baryon (antibaryon) specie,
    * which is fragmented from the leading diquark (anti-diquark). */
   const double uspc = random::uniform(0., weight_summed[n_possible]);
   for (int i = 0; i < n_possible; i++) {
     if ((uspc >= weight_summed[i]) && (uspc < weight_summed[i + 1])) {
-      return pdgid_possible[i];
+      return candidates.hadron_pdgids[i];
     }
   }
 
@@ -2663,124 +2823,39 @@ int StringProcess::get_resonance_from_quark(int idq1, int idq2, double mass) {
     return 0;
   }
 
-  /* It checks whether one has a valid input
-   * the string ends. */
-
-  // idq1 is supposed to be a quark or anti-diquark.
-  bool end1_is_quark = idq1 > 0 && pythia_hadron_->particleData.isQuark(idq1);
-  bool end1_is_antidiq =
-      idq1 < 0 && pythia_hadron_->particleData.isDiquark(idq1);
-  // idq2 is supposed to be a anti-quark or diquark.
-  bool end2_is_antiq = idq2 < 0 && pythia_hadron_->particleData.isQuark(idq2);
-  bool end2_is_diquark =
-      idq2 > 0 && pythia_hadron_->particleData.isDiquark(idq2);
-
-  int baryon;
-  if (end1_is_quark) {
-    if (end2_is_antiq) {
-      // we have a mesonic resonance from a quark-antiquark pair.
-      baryon = 0;
-    } else if (end2_is_diquark) {
-      // we have a baryonic resonance from a quark-diquark pair.
-      baryon = 1;
-    } else {
-      return 0;
-    }
-  } else if (end1_is_antidiq) {
-    if (end2_is_antiq) {
-      // we have a antibaryonic resonance from a antiquark-antidiquark pair.
-      baryon = -1;
-    } else {
-      return 0;
-    }
-  } else {
-    return 0;
-  }
-
-  /* array for the net quark numbers of the constituents.
-   * net_qnumber[0, 1, 2, 3 and 4] correspond respectively to
-   * d, u, s, c, b quark flavors. */
-  std::array<int, 5> net_qnumber;
-  for (int iflav = 0; iflav < 5; iflav++) {
-    net_qnumber[iflav] = 0;
-
-    int qnumber1 =
-        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq1), iflav + 1);
-    if (idq1 < 0) {
-      // anti-diquark gets an extra minus sign.
-      qnumber1 = -qnumber1;
-    }
-    net_qnumber[iflav] += qnumber1;
-
-    int qnumber2 =
-        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq2), iflav + 1);
-    if (idq2 < 0) {
-      // anti-quark gets an extra minus sign.
-      qnumber2 = -qnumber2;
-    }
-    net_qnumber[iflav] += qnumber2;
-  }
-
-  // List of PDG ids of resonances with the same quantum number.
-  std::vector<int> pdgid_possible;
-  // Corresponding mass differences.
-  std::vector<double> mass_diff;
-  for (auto &ptype : ParticleType::list_all()) {
-    if (!ptype.is_hadron() || ptype.is_stable() ||
-        ptype.pdgcode().baryon_number() != baryon) {
-      // Only resonances with the same baryon number are considered.
-      continue;
-    }
-    const int pdgid = ptype.pdgcode().get_decimal();
-    const double mass_min = ptype.min_mass_spectral();
-    if (mass < mass_min) {
-      // A resoance with mass lower than its minimum threshold is not allowed.
-      continue;
-    }
-
-    if (ptype.pdgcode().isospin3() != net_qnumber[1] - net_qnumber[0]) {
-      // check isospin3.
-      continue;
-    }
-    if (ptype.pdgcode().strangeness() != -net_qnumber[2]) {
-      // check strangeness.
-      continue;
-    }
-    if (ptype.pdgcode().charmness() != net_qnumber[3]) {
-      // check charmness.
+  /* Resonances with the same quantum numbers as the string ends. There are
+   * none for invalid string ends, see find_fragment_candidates. They are
+   * looked up in the tables, which are built when PYTHIA is set up. */
+  pythia_hadron();
+  FragmentCandidates buffer;
+  const FragmentCandidates &candidates =
+      fragment_candidates(idq1, idq2, buffer);
+
+  int pdgid_closest = 0;
+  double mass_diff_min = 0.;
+  /* Find a resonance whose pole mass is closest to the input mass, among the
+   * ones with a minimum threshold below. */
+  const int n_res = candidates.resonance_pdgids.size();
+  for (int ires = 0; ires < n_res; ires++) {
+    if (mass < candidates.resonance_min_mass[ires]) {
       continue;
     }
-    if (ptype.pdgcode().bottomness() != -net_qnumber[4]) {
-      // check bottomness.
-      continue;
+    const double mass_diff = mass - candidates.resonance_pole_mass[ires];
+    if (pdgid_closest == 0) {
+      pdgid_closest = candidates.resonance_pdgids[ires];
+      mass_diff_min = std::fabs(mass_diff);
+    } else if (std::fabs(mass_diff) < mass_diff_min) {
+      pdgid_closest = candidates.resonance_pdgids[ires];
+      mass_diff_min = mass_diff;
     }
-
-    const double mass_pole = ptype.mass();
-    // Add the PDG id and mass difference to the vector array.
-    pdgid_possible.push_back(pdgid);
-    mass_diff.push_back(mass - mass_pole);
   }
-
-  const int n_res = pdgid_possible.size();
-  if (n_res == 0) {
+  if (pdgid_closest == 0) {
     // If there is no possible resonance found, return 0 (failure).
     return 0;
   }
-
-  int ires_closest = 0;
-  double mass_diff_min = std::fabs(mass_diff[0]);
-  /* Find a resonance whose pole mass is closest to
-   * the input mass. */
-  for (int ires = 1; ires < n_res; ires++) {
-    if (std::fabs(mass_diff[ires]) < mass_diff_min) {
-      ires_closest = ires;
-      mass_diff_min = mass_diff[ires];
-    }
-  }
   logg[LPythia].debug("Quark constituents ", idq1, " and ", idq2, " with mass ",
-                      mass, " (GeV) turned into a resonance ",
-                      pdgid_possible[ires_closest]);
-  return pdgid_possible[ires_closest];
+                      mass, " (GeV) turned into a resonance ", pdgid_closest);
+  return pdgid_closest;
 }
 
 bool StringProcess::make_lightcone_final_two(
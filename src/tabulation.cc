@@ -7,6 +7,11 @@
 
 #include "smash/tabulation.h"
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
 namespace smash {
 
 Tabulation::Tabulation(double x_min, double range, size_t num,
@@ -22,6 +27,75 @@ Tabulation::Tabulation(double x_min, double range, size_t num,
   }
 }
 
+/**
+ * Integrate a density by the trapezoidal rule.
+ *
+ * \param[in] x_min Lower bound of the integration.
+ * \param[in] dx Step of the integration.
+ * \param[in] n Number of steps.
+ * \param[in] density Integrand.
+ * \return The integrals from x_min up to x_min + i dx for i = 0 to n.
+ */
+static std::vector<double> cumulative_integrals(
+    double x_min, double dx, size_t n,
+    const std::function<double(double)>& density) {
+  std::vector<double> cdf(n + 1, 0.);
+  double previous = density(x_min);
+  for (size_t i = 1; i <= n; i++) {
+    const double current = density(x_min + i * dx);
+    cdf[i] = cdf[i - 1] + 0.5 * (previous + current) * dx;
+    previous = current;
+  }
+  return cdf;
+}
+
+Tabulation Tabulation::inverse_cdf(double x_min, double x_max,
+                                   const std::function<double(double)>& density,
+                                   double* integral) {
+  constexpr size_t n_density = 8192;
+  constexpr size_t n_inverse = 4096;
+  const double dx = (x_max - x_min) / n_density;
+  // Cumulative distribution by the trapezoidal rule
+  const std::vector<double> cdf =
+      cumulative_integrals(x_min, dx, n_density, density);
+  const double total = cdf.back();
+  if (integral) {
+    *integral = total;
+  }
+  if (!(total > 0.)) {
+    throw std::invalid_argument(
+        "Cannot tabulate the inverse distribution of a vanishing density.");
+  }
+  return Tabulation(0., 1., n_inverse, [&](double u) {
+    const double target = u * total;
+    const size_t i = std::clamp<size_t>(
+        std::upper_bound(cdf.begin(), cdf.end(), target) - cdf.begin(), 1,
+        n_density);
+    const double width = cdf[i] - cdf[i - 1];
+    const double fraction = width > 0. ? (target - cdf[i - 1]) / width : 0.;
+    return x_min + (i - 1 + std::clamp(fraction, 0., 1.)) * dx;
+  });
+}
+
+Tabulation Tabulation::cdf(double x_min, double x_max, size_t num,
+                           const std::function<double(double)>& density) {
+  Tabulation tab;
+  tab.values_ =
+      cumulative_integrals(x_min, (x_max - x_min) / num, num, density);
+  const double total = tab.values_.back();
+  if (!(total > 0.)) {
+    throw std::invalid_argument(
+        "Cannot tabulate the distribution of a vanishing density.");
+  }
+  for (double& value : tab.values_) {
+    value /= total;
+  }
+  tab.x_min_ = x_min;
+  tab.x_max_ = x_max;
+  tab.inv_dx_ = num / (x_max - x_min);
+  return tab;
+}
+
 double Tabulation::get_value_step(double x) const {
   if (x < x_min_) {
     return 0.;
@@ -53,6 +127,36 @@ double Tabulation::get_value_linear(double x, Extrapolation extrapol) const {
   return values_[n] + (values_[n + 1] - values_[n]) * r;
 }
 
+double Tabulation::get_inverse_linear(double y) const {
+  // the first point above y, such that the interval ends there
+  const size_t n = std::clamp<size_t>(
+      std::upper_bound(values_.begin(), values_.end(), y) - values_.begin(), 1,
+      values_.size() - 1);
+  const double width = values_[n] - values_[n - 1];
+  const double fraction = width > 0. ? (y - values_[n - 1]) / width : 0.;
+  return x_min_ + (n - 1 + std::clamp(fraction, 0., 1.)) / inv_dx_;
+}
+
+void Tabulation::get_values_linear(const double* x, double* values, size_t n,
+                                   Extrapolation extrapol) const {
+  const double* table = values_.data();
+  const double last_index = values_.size() - 2;
+  // Above this bound, the value is replaced by the extrapolated constant.
+  const double x_upper = extrapol == Extrapolation::Linear
+                             ? std::numeric_limits<double>::infinity()
+                             : x_max_;
+  const double above = extrapol == Extrapolation::Const ? values_.back() : 0.;
+  for (size_t i = 0; i < n; i++) {
+    const double index_double = (x[i] - x_min_) * inv_dx_;
+    // the lower index, clamped like in get_value_linear
+    const size_t k = std::min(std::max(index_double, 0.), last_index);
+    const double r = index_double - k;
+    const double interpolated = table[k] + (table[k + 1] - table[k]) * r;
+    const double value = x[i] <= x_upper ? interpolated : above;
+    values[i] = x[i] < x_min_ ? 0. : value;
+  }
+}
+
 /**
  * Write binary representation to stream.
  *
@@ -0,0 +1,218 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/tabulationbundle.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "smash/logging.h"
+
+namespace smash {
+static constexpr int LParticleType = LogArea::ParticleType::id;
+
+namespace {
+/// Magic number at the beginning of a bundle
+constexpr char bundle_magic[4] = {'S', 'M', 'T', 'B'};
+/// Version of the bundle format
+constexpr std::uint32_t bundle_version = 1;
+
+/// Read-only view of a mapped bundle, checking every access against its size
+class BundleView {
+ public:
+  /**
+   * \param[in] data Begin of the mapped file.
+   * \param[in] size Size of the mapped file.
+   */
+  BundleView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  /**
+   * Read a value and advance.
+   *
+   * \param[out] x Value read.
+   * \throw std::runtime_error if the file ends before the value.
+   */
+  template <typename T>
+  void read(T &x) {
+    std::memcpy(&x, bytes(sizeof(T)), sizeof(T));
+  }
+
+  /**
+   * Skip bytes and advance.
+   *
+   * \param[in] n Number of bytes.
+   * \return Begin of the skipped bytes.
+   * \throw std::runtime_error if the file ends before.
+   */
+  const char *bytes(std::size_t n) {
+    if (n > size_ - offset_) {
+      throw std::runtime_error("unexpected end of file");
+    }
+    const char *begin = data_ + offset_;
+    offset_ += n;
+    return begin;
+  }
+
+ private:
+  /// Begin of the mapped file
+  const char *data_;
+  /// Size of the mapped file
+  std::size_t size_;
+  /// Position of the next read
+  std::size_t offset_ = 0;
+};
+
+/**
+ * Append the bytes of a value to a buffer.
+ *
+ * \param[inout] buffer Buffer to append to.
+ * \param[in] x Value to append.
+ */
+template <typename T>
+void append(std::vector<char> &buffer, const T &x) {
+  const char *bytes = reinterpret_cast<const char *>(&x);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+}  // namespace
+
+std::filesystem::path TabulationBundle::path(const std::filesystem::path &dir,
+                                             sha256::Hash hash) {
+  return dir / ("tabulations_" + sha256::hash_to_string(hash) + ".bundle");
+}
+
+TabulationBundle TabulationBundle::read(const std::filesystem::path &dir,
+                                        sha256::Hash hash) {
+  TabulationBundle bundle(hash);
+  const std::filesystem::path file = path(dir, hash);
+  const int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return bundle;
+  }
+  struct stat file_status;
+  if (fstat(fd, &file_status) != 0 || file_status.st_size == 0) {
+    close(fd);
+    return bundle;
+  }
+  const std::size_t size = static_cast<std::size_t>(file_status.st_size);
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after closing the file descriptor.
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    logg[LParticleType].warn("Cannot map ", file, ", tabulating again.");
+    return bundle;
+  }
+
+  try {
+    BundleView view(static_cast<const char *>(mapping), size);
+    if (std::memcmp(view.bytes(4), bundle_magic, 4) != 0) {
+      throw std::runtime_error("not a tabulation bundle");
+    }
+    std::uint32_t version;
+    view.read(version);
+    if (version != bundle_version) {
+      throw std::runtime_error("format version " + std::to_string(version));
+    }
+    sha256::Hash hash_from_file;
+    std::memcpy(hash_from_file.data(), view.bytes(hash_from_file.size()),
+                hash_from_file.size());
+    if (hash_from_file != hash) {
+      throw std::runtime_error("hash mismatch");
+    }
+    std::uint64_t n_tabulations;
+    view.read(n_tabulations);
+    for (std::uint64_t i = 0; i < n_tabulations; i++) {
+      std::uint32_t name_length;
+      view.read(name_length);
+      const std::string name(view.bytes(name_length), name_length);
+      Tabulation tabulation;
+      view.read(tabulation.x_min_);
+      view.read(tabulation.x_max_);
+      view.read(tabulation.inv_dx_);
+      std::uint64_t n_values;
+      view.read(n_values);
+      if (n_values > size / sizeof(double)) {
+        throw std::runtime_error("unexpected end of file");
+      }
+      tabulation.values_.resize(n_values);
+      std::memcpy(tabulation.values_.data(),
+                  view.bytes(n_values * sizeof(double)),
+                  n_values * sizeof(double));
+      bundle.tabulations_.emplace(name, std::move(tabulation));
+    }
+  } catch (std::runtime_error &error) {
+    logg[LParticleType].warn("Ignoring ", file, " (", error.what(),
+                             "), tabulating again.");
+    bundle.tabulations_.clear();
+  }
+  munmap(mapping, size);
+  return bundle;
+}
+
+const Tabulation *TabulationBundle::find(const std::string &name) const {
+  const auto found = tabulations_.find(name);
+  return found == tabulations_.end() ? nullptr : &found->second;
+}
+
+void TabulationBundle::publish(const std::filesystem::path &dir) const {
+  std::vector<char> buffer(bundle_magic, bundle_magic + 4);
+  append(buffer, bundle_version);
+  buffer.insert(buffer.end(), hash_.begin(), hash_.end());
+  append(buffer, static_cast<std::uint64_t>(tabulations_.size()));
+  for (const auto &[name, tabulation] : tabulations_) {
+    append(buffer, static_cast<std::uint32_t>(name.size()));
+    buffer.insert(buffer.end(), name.begin(), name.end());
+    append(buffer, tabulation.x_min_);
+    append(buffer, tabulation.x_max_);
+    append(buffer, tabulation.inv_dx_);
+    append(buffer, static_cast<std::uint64_t>(tabulation.values_.size()));
+    const char *values =
+        reinterpret_cast<const char *>(tabulation.values_.data());
+    buffer.insert(buffer.end(), values,
+                  values + tabulation.values_.size() * sizeof(double));
+  }
+
+  /* The temporary file has to be unique among all jobs sharing the directory,
+   * possibly on different hosts. */
+  char host[64] = {};
+  gethostname(host, sizeof(host) - 1);
+  const std::filesystem::path final_path = path(dir, hash_);
+  std::filesystem::path temporary_path = final_path;
+  temporary_path += "." + std::string(host) + "." +
+                    std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary);
+    file.write(buffer.data(), buffer.size());
+    file.close();
+    if (!file) {
+      std::error_code ignored;
+      std::filesystem::remove(temporary_path, ignored);
+      throw std::runtime_error("Cannot write " + temporary_path.string() +
+                               ".");
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary_path, final_path, error);
+  if (error) {
+    std::error_code ignored;
+    std::filesystem::remove(temporary_path, ignored);
+    throw std::runtime_error("Cannot publish " + final_path.string() + ": " +
+                             error.message());
+  }
+}
+
+}  // namespace smash
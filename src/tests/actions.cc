@@ -12,12 +12,31 @@
 #include "smash/actions.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
 
 #include "setup.h"
 #include "smash/decayaction.h"
 
 using namespace smash;
 
+/// Number of allocations with the global operator new in this test
+static std::atomic<std::size_t> n_allocations{0};
+
+void *operator new(std::size_t size) {
+  n_allocations++;
+  if (void *ptr = std::malloc(size > 0 ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
 TEST(construct_and_insert) {
   Test::create_smashon_particletypes();
 
@@ -65,3 +84,93 @@ TEST(construct_and_insert) {
 
   VERIFY(actions.is_empty());
 }
+
+TEST(drop_actions_of_particle) {
+  const ParticleData a = Test::smashon(Test::Position{0., 1., 0., 0.}, 1);
+  const ParticleData b = Test::smashon(Test::Position{0., 2., 0., 0.}, 2);
+
+  Actions actions;
+  actions.insert(std::make_unique<DecayAction>(a, 1.));
+  actions.insert(std::make_unique<DecayAction>(b, 2.));
+  actions.insert(std::make_unique<DecayAction>(a, 3.));
+  COMPARE(actions.size(), 3u);
+
+  // all actions of a are dropped, also the earliest one
+  COMPARE(actions.drop_actions_of(a.id()), 2u);
+  COMPARE(actions.drop_actions_of(a.id()), 0u);
+  COMPARE(actions.size(), 1u);
+  COMPARE(actions.earliest_time(), 2.);
+
+  // the slots of dropped actions are reused
+  actions.insert(std::make_unique<DecayAction>(a, 4.));
+  actions.insert(std::make_unique<DecayAction>(a, 0.5));
+  COMPARE(actions.size(), 3u);
+  COMPARE(actions.pop()->time_of_execution(), 0.5);
+  COMPARE(actions.pop()->time_of_execution(), 2.);
+
+  // popped actions are not dropped again
+  COMPARE(actions.drop_actions_of(b.id()), 0u);
+  COMPARE(actions.drop_actions_of(a.id()), 1u);
+  VERIFY(actions.is_empty());
+}
+
+TEST(calendar_order) {
+  const ParticleData a = Test::smashon(Test::Position{0., 1., 0., 0.}, 1);
+
+  // The calendar spans the first of three time units, the rest overflows.
+  Actions actions;
+  actions.set_time_step(1.);
+  ActionList action_vec;
+  for (int i = 0; i < 1000; i++) {
+    action_vec.push_back(
+        std::make_unique<DecayAction>(a, std::fmod(i * 0.618034, 3.)));
+  }
+  actions.insert(std::move(action_vec));
+  COMPARE(actions.size(), 1000u);
+
+  // actions inserted while popping are executed in order, too
+  double last_time = 0.;
+  int n_popped = 0;
+  while (!actions.is_empty()) {
+    const double time = actions.pop()->time_of_execution();
+    VERIFY(time >= last_time) << time << " < " << last_time;
+    last_time = time;
+    if (++n_popped % 3 == 0 && time < 2.) {
+      actions.insert(std::make_unique<DecayAction>(a, time + 0.1 * n_popped));
+      if (!actions.is_empty()) {
+        VERIFY(actions.earliest_time() >= time);
+      }
+    }
+  }
+  VERIFY(n_popped > 1000);
+}
+
+TEST(refilled_actions_do_not_allocate) {
+  std::vector<ParticleData> particles;
+  for (int i = 0; i < 50; i++) {
+    particles.push_back(Test::smashon(Test::Position{0., 1. * i, 0., 0.}, i));
+  }
+  Actions actions;
+  actions.set_time_step(10.);
+  for (int round = 0; round < 3; round++) {
+    ActionList action_list;
+    for (int i = 0; i < 50; i++) {
+      action_list.push_back(
+          std::make_unique<DecayAction>(particles[i], 0.1 * ((7 * i) % 50)));
+    }
+    const std::size_t allocations_before = n_allocations;
+    // The container of the previous round is refilled, as in every time step.
+    actions.clear();
+    actions.insert(std::move(action_list));
+    COMPARE(actions.drop_actions_of(3), 1u);
+    double last_time = 0.;
+    while (!actions.is_empty()) {
+      const double time = actions.pop()->time_of_execution();
+      VERIFY(time >= last_time);
+      last_time = time;
+    }
+    if (round > 0) {
+      COMPARE(n_allocations - allocations_before, 0u) << "round " << round;
+    }
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/adaptivetimestep.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include "setup.h"
+#include "smash/particles.h"
+
+using namespace smash;
+
+static const AdaptiveTimeStepParameters parameters{0.01, 1.0, 0.1, 0.5, 0.01};
+
+TEST(grows_without_limiting_criteria) {
+  const AdaptiveTimeStep adaptive(parameters);
+  COMPARE(adaptive.next_timestep(0.1, {}), 0.2);
+  COMPARE(adaptive.next_timestep(0.8, {}), 1.0);
+}
+
+TEST(action_rate) {
+  const AdaptiveTimeStep adaptive(parameters);
+  TimeStepObservables observables;
+  observables.n_particles = 1000;
+  observables.n_actions = 500;
+  // 0.5 actions per particle in 0.1 fm, so 0.1 actions need 0.02 fm
+  FUZZY_COMPARE(adaptive.next_timestep(0.1, observables), 0.02);
+  observables.n_actions = 1000000;
+  COMPARE(adaptive.next_timestep(0.1, observables), parameters.min_dt);
+}
+
+TEST(lattice_crossing) {
+  const AdaptiveTimeStep adaptive(parameters);
+  TimeStepObservables observables;
+  observables.max_velocity = 0.5;
+  observables.min_lattice_spacing = 0.4;
+  FUZZY_COMPARE(adaptive.next_timestep(0.3, observables), 0.4);
+}
+
+TEST(momentum_kick) {
+  const AdaptiveTimeStep adaptive(parameters);
+  TimeStepObservables observables;
+  observables.max_force = 0.1;
+  FUZZY_COMPARE(adaptive.next_timestep(0.3, observables), 0.1);
+}
+
+TEST_CATCH(invalid_bounds, std::invalid_argument) {
+  AdaptiveTimeStep adaptive({0.5, 0.1, 0.1, 0.5, 0.01});
+}
+
+TEST(observables) {
+  Test::create_smashon_particletypes();
+  std::vector<Particles> ensembles(2);
+  ensembles[1].insert(Test::smashon(Test::Momentum{0.5, 0.3, 0., 0.}));
+  ensembles[0].insert(Test::smashon(Test::Momentum{0.5, 0., 0.1, 0.}));
+  FUZZY_COMPARE(max_velocity(ensembles), 0.6);
+
+  RectangularLattice<std::pair<ThreeVector, ThreeVector>> forces(
+      {2., 2., 2.}, {2, 2, 2}, {0., 0., 0.}, false,
+      LatticeUpdate::EveryTimestep);
+  forces[3] = {ThreeVector(0., 0.3, 0.4), ThreeVector(0.1, 0., 0.)};
+  FUZZY_COMPARE(max_force(forces), 0.6);
+}
@@ -0,0 +1,189 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/analysisoutput.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "setup.h"
+#include "smash/clock.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+TEST(event_histogram) {
+  EventHistogram histogram(0., 2., 4);
+  COMPARE(histogram.n_bins(), 4u);
+  COMPARE(histogram.bin_width(), 0.5);
+  COMPARE(histogram.bin_low(3), 1.5);
+  histogram.fill(0.1);
+  histogram.fill(0.2, 3.);
+  histogram.fill(2.);  // outside of the range
+  histogram.end_event();
+  histogram.fill(0.4);
+  histogram.end_event();
+  COMPARE(histogram.mean(0, 2), 2.5);
+  COMPARE(histogram.mean(1, 2), 0.);
+  // Bin contents 4 and 1 give a standard deviation of 1.5.
+  FUZZY_COMPARE(histogram.error(0, 2), 1.5);
+  COMPARE(histogram.error(0, 1), 0.);
+}
+
+TEST_CATCH(event_histogram_without_bins, std::invalid_argument) {
+  EventHistogram histogram(0., 1., 0);
+}
+
+TEST(spectra_and_participants) {
+  OutputParameters out_par = OutputParameters();
+  AnalysisOutputParameters &par = out_par.analysis_parameters;
+  par.species = {661};
+  par.rapidity_bins = {-1., 1., 2.};
+  par.pt_bins = {0., 2., 2.};
+  const EventInfo info = Test::default_event_info();
+  const std::filesystem::path result_file = testoutputpath / "analysis.dat";
+  {
+    AnalysisOutput output(testoutputpath, "Analysis", out_par);
+    const double mass = Test::smashon_mass;
+    const double pt = 0.5;
+    const double energy = std::sqrt(mass * mass + pt * pt);
+    Particles particles;
+    particles.insert(Test::smashon(Test::Momentum(energy, pt, 0., 0.)));
+    particles.insert(Test::smashon(Test::Momentum(energy, 0., pt, 0.)));
+
+    // No interaction: both particles are spectators.
+    output.at_eventstart(particles, 0, info);
+    output.at_eventend(particles, 0, info);
+
+    // One initial particle was replaced by a new one.
+    output.at_eventstart(particles, 1, info);
+    particles.remove(particles.front());
+    particles.insert(Test::smashon(Test::Momentum(energy, pt, 0., 0.)));
+    output.at_eventend(particles, 1, info);
+
+    COMPARE(output.n_events(), 2u);
+    COMPARE(output.mean_participants(), 0.5);
+    const EventHistogram &dn_dy = output.rapidity_spectrum(0);
+    COMPARE(dn_dy.mean(0, 2), 0.);
+    COMPARE(dn_dy.mean(1, 2), 2.);
+    const EventHistogram &dn_dpt = output.pt_spectrum(0);
+    COMPARE(dn_dpt.mean(0, 2), 2.);
+    COMPARE(dn_dpt.mean(1, 2), 0.);
+  }
+  std::ifstream file(result_file);
+  const std::string content(std::istreambuf_iterator<char>(file), {});
+  VERIFY(content.find("# events 2\n") != std::string::npos);
+  VERIFY(content.find("# species 661\n") != std::string::npos);
+  // Two of the four particles move along x and two along y.
+  VERIFY(content.find("\n0 1 0.5 ") != std::string::npos);
+  VERIFY(std::filesystem::remove(result_file));
+}
+
+TEST_CATCH(no_species, std::invalid_argument) {
+  OutputParameters out_par = OutputParameters();
+  out_par.analysis_parameters.species.clear();
+  AnalysisOutput output(testoutputpath, "Analysis", out_par);
+}
+
+TEST(multi_tau_correlator) {
+  MultiTauCorrelator correlator(4, 3);
+  // Level 0 gives the lags 0-3, levels 1 and 2 the lags 4, 6 and 8, 12.
+  COMPARE(correlator.n_lags(), 8u);
+  COMPARE(correlator.lag(3), 3u);
+  COMPARE(correlator.lag(4), 4u);
+  COMPARE(correlator.lag(7), 12u);
+  const std::vector<double> series = {1., -2., 0.5, 3., -1., 2., 0., 1.5};
+  for (const double value : series) {
+    correlator.add(value);
+  }
+  // The short lags are the plain averages of the products.
+  for (std::size_t lag = 0; lag < 4; lag++) {
+    double sum = 0.;
+    for (std::size_t t = lag; t < series.size(); t++) {
+      sum += series[t] * series[t - lag];
+    }
+    FUZZY_COMPARE(correlator.correlation(lag), sum / (series.size() - lag));
+  }
+  // Lag 4 correlates the four pair averages 2 apart.
+  FUZZY_COMPARE(correlator.correlation(4), (-0.5 * 0.5 + 1.75 * 0.75) / 2.);
+  // Lag 12 needs a longer series.
+  COMPARE(correlator.correlation(7), 0.);
+
+  // Products are not formed across series.
+  MultiTauCorrelator constant(4, 3);
+  for (int series_number = 0; series_number < 3; series_number++) {
+    constant.start_series();
+    for (int t = 0; t < 20; t++) {
+      constant.add(series_number == 1 ? 2. : -2.);
+    }
+  }
+  for (std::size_t i = 0; i < constant.n_lags(); i++) {
+    COMPARE(constant.correlation(i), 4.);
+  }
+}
+
+TEST_CATCH(multi_tau_correlator_odd_points, std::invalid_argument) {
+  MultiTauCorrelator correlator(5, 2);
+}
+
+TEST(green_kubo_correlators) {
+  OutputParameters out_par = OutputParameters();
+  out_par.green_kubo_parameters.points_per_level = 4;
+  out_par.green_kubo_parameters.levels = 2;
+  const std::filesystem::path result_file = testoutputpath / "green_kubo.dat";
+  const double mass = Test::smashon_mass;
+  const double p = 0.5;
+  const double energy = std::sqrt(mass * mass + 2 * p * p);
+  {
+    GreenKuboOutput output(testoutputpath, "Green_Kubo", out_par);
+    std::vector<Particles> ensembles(2);
+    for (Particles &particles : ensembles) {
+      particles.insert(Test::smashon(Test::Momentum(energy, p, p, 0.)));
+    }
+    ensembles[1].insert(Test::smashon(Test::Momentum(energy, -p, p, 0.)));
+    const ExperimentParameters parameters = Test::default_parameters();
+    const DensityParameters dens_param(parameters);
+    output.at_eventstart(ensembles, 0);
+    std::unique_ptr<Clock> clock = std::make_unique<UniformClock>(0., 0.5, 5.);
+    for (int t = 0; t < 8; t++) {
+      output.at_intermediate_time(ensembles, clock, dens_param);
+      ++*clock;
+    }
+    COMPARE(output.interval(), 0.5);
+    // T^xy is p²/E in the first and 0 in the second ensemble.
+    const double txy = p * p / energy;
+    for (std::size_t i = 0; i < 6; i++) {
+      FUZZY_COMPARE(output.correlation(GreenKuboOutput::ShearXY, 1, i),
+                    0.5 * txy * txy);
+      COMPARE(output.correlation(GreenKuboOutput::ShearXZ, 2, i), 0.);
+      COMPARE(output.correlation(GreenKuboOutput::ChargeX, 3, i), 0.);
+    }
+  }
+  std::ifstream file(result_file);
+  const std::string content(std::istreambuf_iterator<char>(file), {});
+  VERIFY(content.find("# output interval 0.5 fm\n") != std::string::npos);
+  VERIFY(content.find("\n1.5 ") != std::string::npos);
+  VERIFY(std::filesystem::remove(result_file));
+}
@@ -0,0 +1,96 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/arrowexport.h"
+
+#include <cstring>
+
+#include "setup.h"
+#include "smash/particles.h"
+
+using namespace smash;
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+/**
+ * Check the exported columns against the particles, which are expected to be
+ * the smashons inserted in the tests below.
+ */
+static void check_export(const Particles &particles) {
+  ArrowArray array;
+  ArrowSchema schema;
+  export_particles_to_arrow(particles, &array, &schema);
+  COMPARE(std::strcmp(schema.format, "+s"), 0);
+  COMPARE(schema.n_children, 11);
+  COMPARE(array.n_children, 11);
+  COMPARE(array.length, static_cast<int64_t>(particles.size()));
+  COMPARE(array.null_count, 0);
+  const char *names[] = {"pdg", "t",  "x",  "y",  "z",    "E",
+                         "px",  "py", "pz", "id", "ncoll"};
+  for (int c = 0; c < 11; c++) {
+    COMPARE(std::strcmp(schema.children[c]->name, names[c]), 0);
+    COMPARE(array.children[c]->length, array.length);
+    COMPARE(array.children[c]->n_buffers, 2);
+    COMPARE(array.children[c]->buffers[0], nullptr);
+  }
+  COMPARE(std::strcmp(schema.children[0]->format, "i"), 0);
+  COMPARE(std::strcmp(schema.children[3]->format, "g"), 0);
+  const auto *pdg = static_cast<const int32_t *>(array.children[0]->buffers[1]);
+  const auto *x = static_cast<const double *>(array.children[2]->buffers[1]);
+  const auto *pz = static_cast<const double *>(array.children[8]->buffers[1]);
+  const auto *id = static_cast<const int32_t *>(array.children[9]->buffers[1]);
+  int i = 0;
+  for (const ParticleData &p : particles) {
+    COMPARE(pdg[i], 661);
+    COMPARE(x[i], p.position().x1());
+    COMPARE(pz[i], p.momentum().x3());
+    COMPARE(id[i], p.id());
+    i++;
+  }
+
+  // A column moved out of the array outlives the array.
+  ArrowArray moved = *array.children[2];
+  array.children[2]->release = nullptr;
+  array.release(&array);
+  VERIFY(array.release == nullptr);
+  if (particles.size() > 0) {
+    COMPARE(static_cast<const double *>(moved.buffers[1])[0],
+            particles.front().position().x1());
+  }
+  moved.release(&moved);
+  schema.release(&schema);
+  VERIFY(schema.release == nullptr);
+}
+
+TEST(export_particles) {
+  Particles particles;
+  check_export(particles);
+  for (int i = 0; i < 5; i++) {
+    particles.insert(Test::smashon(Test::Position{0., 1. * i, 0., 0.},
+                                   Test::Momentum{1., 0., 0., 0.1 * i}));
+  }
+  check_export(particles);
+  // with a hole in the storage
+  particles.remove(particles.front());
+  check_export(particles);
+}
+
+TEST(export_particles_from_arrays) {
+  Particles particles;
+  particles.enable_arrays();
+  for (int i = 0; i < 5; i++) {
+    particles.insert(Test::smashon(Test::Position{0., 1. * i, 0., 0.},
+                                   Test::Momentum{1., 0., 0., 0.1 * i}));
+  }
+  check_export(particles);
+  particles.remove(particles.front());
+  check_export(particles);
+}
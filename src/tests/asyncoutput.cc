@@ -0,0 +1,176 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/asyncoutput.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "setup.h"
+#include "smash/clock.h"
+#include "smash/wallcrossingaction.h"
+
+using namespace smash;
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+namespace {
+/// Output that records the calls it receives.
+class RecordingOutput : public OutputInterface {
+ public:
+  explicit RecordingOutput(const std::string &name) : OutputInterface(name) {}
+
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &) override {
+    record("start " + std::to_string(event_number), particles);
+  }
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &) override {
+    record("end " + std::to_string(event_number), particles);
+  }
+  void at_eventstart(const std::vector<Particles> &ensembles,
+                     int event_number) override {
+    calls.push_back("start ensembles " + std::to_string(event_number) + " " +
+                    std::to_string(ensembles.size()));
+    threads.push_back(std::this_thread::get_id());
+  }
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &,
+                            const EventInfo &) override {
+    record("intermediate " + std::to_string(clock->current_time()), particles);
+  }
+  void at_interaction(const Action &action, const double) override {
+    if (throw_at_interaction) {
+      throw std::runtime_error("writing failed");
+    }
+    std::string call = "interaction";
+    for (const ParticleData &p : action.incoming_particles()) {
+      call += " " + std::to_string(p.id());
+    }
+    for (const ParticleData &p : action.outgoing_particles()) {
+      call += " " + std::to_string(p.position().x1());
+    }
+    calls.push_back(call);
+    threads.push_back(std::this_thread::get_id());
+  }
+  bool uses_interactions() const override { return record_interactions; }
+
+  /// Calls in the order of their arrival
+  std::vector<std::string> calls;
+  /// Threads on which the calls were executed
+  std::vector<std::thread::id> threads;
+  /// Whether at_interaction() fails
+  bool throw_at_interaction = false;
+  /// Whether the output asks for the interactions
+  bool record_interactions = true;
+
+ private:
+  void record(std::string call, const Particles &particles) {
+    for (const ParticleData &p : particles) {
+      call += " " + std::to_string(p.id());
+    }
+    calls.push_back(call);
+    threads.push_back(std::this_thread::get_id());
+  }
+};
+}  // namespace
+
+TEST(keeps_kind_of_output) {
+  AsyncOutput dileptons(std::make_unique<RecordingOutput>("Dileptons"));
+  VERIFY(dileptons.is_dilepton_output());
+  VERIFY(!dileptons.is_photon_output());
+  AsyncOutput photons(std::make_unique<RecordingOutput>("Photons"));
+  VERIFY(photons.is_photon_output());
+  AsyncOutput ic(std::make_unique<RecordingOutput>("SMASH_IC"));
+  VERIFY(ic.is_IC_output());
+}
+
+TEST_CATCH(zero_capacity, std::invalid_argument) {
+  AsyncOutput output(std::make_unique<RecordingOutput>("Particles"), 0);
+}
+
+TEST(writes_snapshots_in_order_on_writer_thread) {
+  auto recording = std::make_unique<RecordingOutput>("Particles");
+  RecordingOutput *recorder = recording.get();
+  // A capacity of one forces the physics side to wait for the writer.
+  AsyncOutput output(std::move(recording), 1);
+
+  Particles particles;
+  particles.insert(Test::smashon_random());
+  const ParticleData removed = particles.insert(Test::smashon_random());
+  particles.insert(Test::smashon_random());
+  particles.remove(removed);
+  const EventInfo info = Test::default_event_info();
+  output.at_eventstart(particles, 3, info);
+
+  ParticleData moved = particles.front();
+  moved.set_4position({0., 2., 0., 0.});
+  // The action is destroyed before it is written.
+  output.at_interaction(WallcrossingAction(particles.front(), moved), 0.);
+
+  std::unique_ptr<Clock> clock = std::make_unique<UniformClock>(0., 0.5, 2.);
+  *clock += 3;
+  const ExperimentParameters parameters = Test::default_parameters();
+  output.at_intermediate_time(particles, clock, DensityParameters(parameters),
+                              info);
+  // Changes after the calls must not be seen by the writer.
+  particles.create(2, ParticleType::find(0x661).pdgcode());
+  output.at_eventend(particles, 3, info);
+
+  // At event end everything has been written.
+  const std::vector<std::string> expected = {
+      "start 3 0 2", "interaction 0 2.000000", "intermediate 1.500000 0 2",
+      "end 3 0 3 2 4"};
+  COMPARE(recorder->calls, expected);
+  for (const auto &thread : recorder->threads) {
+    VERIFY(thread != std::this_thread::get_id());
+  }
+}
+
+TEST_CATCH(rethrows_errors_of_writer, std::runtime_error) {
+  auto recording = std::make_unique<RecordingOutput>("Collisions");
+  recording->throw_at_interaction = true;
+  AsyncOutput output(std::move(recording));
+  Particles particles;
+  particles.insert(Test::smashon_random());
+  WallcrossingAction action(particles.front(), particles.front());
+  output.at_interaction(action, 0.);
+  output.flush();
+}
+
+TEST(forwards_only_particle_lists) {
+  auto recording = std::make_unique<RecordingOutput>("Rivet");
+  RecordingOutput *recorder = recording.get();
+  recorder->record_interactions = false;
+  AsyncOutput output(std::move(recording), AsyncOutput::default_capacity,
+                     AsyncOutput::Callbacks::ParticleLists);
+  VERIFY(!output.uses_interactions());
+
+  Particles particles;
+  particles.insert(Test::smashon_random());
+  const EventInfo info = Test::default_event_info();
+  const std::vector<Particles> ensembles(1);
+  output.at_eventstart(ensembles, 0);
+  output.at_eventstart(particles, 0, info);
+  output.at_interaction(
+      WallcrossingAction(particles.front(), particles.front()), 0.);
+  output.at_eventend(particles, 0, info);
+  output.at_eventstart(particles, 1, info);
+  output.flush();
+
+  // Neither the ensembles nor the unused interactions reach the output.
+  const std::vector<std::string> expected = {"start 0 0", "end 0 0",
+                                             "start 1 0"};
+  COMPARE(recorder->calls, expected);
+}
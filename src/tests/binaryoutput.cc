@@ -11,16 +11,20 @@
 
 #include "smash/binaryoutput.h"
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <vector>
 
 #include "setup.h"
+#include "smash/binaryreader.h"
 #include "smash/clock.h"
 #include "smash/config.h"
 #include "smash/file.h"
@@ -83,6 +87,8 @@ static bool compare_particle(const ParticleData &p, const FilePtr &file) {
          (mom == p.momentum() && charge == p.type().charge());
 }
 
+// The extended format needs the full particle history.
+#ifndef SMASH_COMPACT_PARTICLE_HISTORY
 /* Reads and compares particle in case of extended format */
 static void compare_particle_extended(const ParticleData &p,
                                       const FilePtr &file) {
@@ -112,6 +118,7 @@ static void compare_particle_extended(const ParticleData &p,
   COMPARE(baryon_number, p.type().baryon_number());
   COMPARE(strangeness, p.type().strangeness());
 }
+#endif
 
 /* function to read and compare particle block header */
 static bool compare_particles_block_header(const int &npart,
@@ -353,6 +360,7 @@ TEST(particles_format) {
   VERIFY(std::filesystem::remove(particleoutputpath));
 }
 
+#ifndef SMASH_COMPACT_PARTICLE_HISTORY
 TEST(extended) {
   /* create two smashon particles */
   Particles particles;
@@ -449,6 +457,7 @@ TEST(extended) {
 
   VERIFY(std::filesystem::remove(collisionsoutputfilepath));
 }
+#endif
 
 TEST(initial_conditions_format) {
   // Create 1 particle
@@ -520,3 +529,204 @@ TEST(initial_conditions_format) {
   }
   VERIFY(std::filesystem::remove(particleoutputpath));
 }
+
+TEST(buffer_size_does_not_change_content) {
+  auto particles =
+      Test::create_particles(2, [] { return Test::smashon_random(); });
+  const EventInfo event = Test::default_event_info(2.5, false);
+  ScatterActionPtr action = std::make_unique<ScatterAction>(
+      particles->front(), particles->back(), 0.);
+  action->add_all_scatterings(Test::default_finder_parameters());
+  action->generate_final_state();
+
+  const std::filesystem::path outputfilepath =
+      testoutputpath / "collisions_binary.bin";
+  std::filesystem::path outputfilepath_unfinished = outputfilepath;
+  outputfilepath_unfinished += ".unfinished";
+  auto read_file = [](const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+  };
+
+  std::vector<std::string> contents;
+  for (const std::size_t buffer_size :
+       {std::size_t{0}, std::size_t{1} << 20}) {
+    OutputParameters output_par = OutputParameters();
+    output_par.coll_printstartend = true;
+    output_par.binary_buffer_size = buffer_size;
+    {
+      BinaryOutputCollisions bin_output(testoutputpath, "Collisions",
+                                        output_par);
+      const auto header_size =
+          std::filesystem::file_size(outputfilepath_unfinished);
+      bin_output.at_eventstart(*particles, 0, event);
+      for (int i = 0; i < 3; i++) {
+        bin_output.at_interaction(*action, 0.1 * i);
+      }
+      // Without buffer every block is passed on to the file right away.
+      std::fflush(nullptr);
+      COMPARE(std::filesystem::file_size(outputfilepath_unfinished) ==
+                  header_size,
+              buffer_size > 0);
+      bin_output.at_eventend(*particles, 0, event);
+    }
+    contents.push_back(read_file(outputfilepath));
+    VERIFY(std::filesystem::remove(outputfilepath));
+  }
+  VERIFY(contents[0].size() > 0);
+  COMPARE(contents[0], contents[1]);
+}
+
+TEST(event_index) {
+  const EventInfo event = Test::default_event_info(2.5, false);
+  const std::filesystem::path outputfilepath =
+      testoutputpath / "collisions_binary.bin";
+  // The events are read in random order.
+  const std::array<std::size_t, 4> order = {2, 0, 3, 1};
+  ScatterActionPtr action;
+  std::vector<std::size_t> n_particles;
+  std::vector<std::vector<BinaryParticleLine>> events[2];
+  for (const bool event_index : {false, true}) {
+    {
+      OutputParameters output_par = OutputParameters();
+      output_par.coll_printstartend = true;
+      output_par.binary_event_index = event_index;
+      BinaryOutputCollisions bin_output(testoutputpath, "Collisions",
+                                        output_par);
+      for (int ev = 0; ev < 4; ev++) {
+        auto particles = Test::create_particles(
+            2 + ev, [] { return Test::smashon_random(); });
+        action = std::make_unique<ScatterAction>(particles->front(),
+                                                 particles->back(), 0.);
+        action->add_all_scatterings(Test::default_finder_parameters());
+        action->generate_final_state();
+        bin_output.at_eventstart(*particles, ev, event);
+        bin_output.at_interaction(*action, 0.1 * ev);
+        // The index gives the last particle block of an event.
+        particles->create(ev, Test::smashon().pdgcode());
+        bin_output.at_eventend(*particles, ev, event);
+        if (event_index) {
+          n_particles.push_back(particles->size());
+        }
+      }
+      // An unfinished event is not part of the index.
+      auto particles =
+          Test::create_particles(3, [] { return Test::smashon_random(); });
+      bin_output.at_eventstart(*particles, 4, event);
+    }
+    BinaryParticleListReader reader(outputfilepath);
+    COMPARE(reader.n_events(), 4u);
+    for (std::size_t i : order) {
+      COMPARE(reader.event_number(i), static_cast<std::int32_t>(i));
+      events[event_index].push_back(reader.read_event(i));
+    }
+    VERIFY(std::filesystem::remove(outputfilepath));
+  }
+  // The same particle blocks are found with and without index.
+  for (std::size_t i = 0; i < order.size(); i++) {
+    COMPARE(events[1][i].size(), n_particles[order[i]]);
+    COMPARE(events[0][i].size(), events[1][i].size());
+    for (std::size_t j = 0; j < events[0][i].size(); j++) {
+      COMPARE(events[0][i][j].id, events[1][i][j].id);
+    }
+  }
+}
+
+TEST(delta_blocks) {
+  const EventInfo event = Test::default_event_info();
+  const std::filesystem::path outputfilepath =
+      testoutputpath / "particles_binary.bin";
+  auto particles =
+      Test::create_particles(4, [] { return Test::smashon_random(); });
+  for (ParticleData &p : *particles) {
+    p.set_4position(FourVector(0., 0.1 * p.id(), -0.2, 0.3));
+  }
+  // Particle lists at the start, the two output times and the end
+  std::vector<ParticleList> expected;
+  std::array<std::size_t, 4> block_sizes;
+  {
+    OutputParameters output_par = OutputParameters();
+    output_par.part_only_final = OutputOnlyFinal::No;
+    output_par.part_delta_blocks = true;
+    // Every block is passed on to the file right away.
+    output_par.binary_buffer_size = 0;
+    BinaryOutputParticles bin_output(testoutputpath, "Particles", output_par);
+    const DensityParameters dens_par(Test::default_parameters());
+    std::unique_ptr<Clock> clock = std::make_unique<UniformClock>(0., 1., 10.);
+    std::size_t size = 0;
+    auto written = [&]() {
+      std::fflush(nullptr);
+      const std::size_t new_size =
+          std::filesystem::file_size(outputfilepath.string() + ".unfinished");
+      const std::size_t block_size = new_size - size;
+      size = new_size;
+      return block_size;
+    };
+    auto propagate = [&particles](double dt) {
+      for (ParticleData &p : *particles) {
+        p.set_4position(p.position() +
+                        FourVector(dt, p.velocity() * dt));
+      }
+    };
+    written();
+
+    bin_output.at_eventstart(*particles, 0, event);
+    expected.push_back(particles->copy_to_vector());
+    block_sizes[0] = written();
+
+    // One particle scatters, one is removed and one is created.
+    ++(*clock);
+    propagate(1.);
+    particles->front().set_4momentum(Test::smashon_mass, 0.1, 0.2, 0.3);
+    particles->remove(particles->back());
+    ParticleData created = Test::smashon_random();
+    created.set_4position(FourVector(1., 0.5, 0.5, 0.5));
+    particles->insert(created);
+    bin_output.at_intermediate_time(*particles, clock, dens_par, event);
+    expected.push_back(particles->copy_to_vector());
+    block_sizes[1] = written();
+
+    // All particles stay on their straight lines.
+    ++(*clock);
+    propagate(1.);
+    bin_output.at_intermediate_time(*particles, clock, dens_par, event);
+    expected.push_back(particles->copy_to_vector());
+    block_sizes[2] = written();
+
+    bin_output.at_eventend(*particles, 0, event);
+    expected.push_back(particles->copy_to_vector());
+  }
+  // 'd', time, numbers of removed ids and lines, then ids and lines
+  const std::size_t line_size = (block_sizes[0] - 5) / 4;
+  COMPARE(block_sizes[1], 17u + 4u + 2 * line_size);
+  COMPARE(block_sizes[2], 17u);
+
+  BinaryParticleListReader reader(outputfilepath);
+  COMPARE(reader.n_events(), 1u);
+  COMPARE(reader.read_event(0).size(), expected.back().size());
+  const auto lists = reader.read_particle_lists(0);
+  COMPARE(lists.size(), expected.size());
+  for (std::size_t i = 0; i < lists.size(); i++) {
+    ParticleList &particle_list = expected[i];
+    std::sort(particle_list.begin(), particle_list.end(),
+              [](const ParticleData &a, const ParticleData &b) {
+                return a.id() < b.id();
+              });
+    std::vector<BinaryParticleLine> lines = lists[i];
+    std::sort(lines.begin(), lines.end(),
+              [](const BinaryParticleLine &a, const BinaryParticleLine &b) {
+                return a.id < b.id;
+              });
+    COMPARE(lines.size(), particle_list.size()) << i;
+    for (std::size_t j = 0; j < lines.size(); j++) {
+      const ParticleData &p = particle_list[j];
+      COMPARE(lines[j].id, p.id());
+      COMPARE(lines[j].pdg, p.pdgcode().get_decimal());
+      COMPARE(lines[j].momentum, p.momentum());
+      VERIFY((lines[j].position - p.position()).abs3() < 1e-9)
+          << i << ' ' << lines[j].position << ' ' << p.position();
+    }
+  }
+  VERIFY(std::filesystem::remove(outputfilepath));
+}
+
@@ -0,0 +1,70 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/blockcache.h"
+
+#include <memory>
+#include <thread>
+
+using namespace smash;
+
+namespace {
+// Objects of two different sizes, allocated via the block cache
+struct Small : CacheAllocated {
+  virtual ~Small() = default;
+  double value = 1.;
+};
+struct Large : Small {
+  double values[20] = {};
+};
+}  // namespace
+
+TEST(freed_blocks_are_reused) {
+  const std::size_t cached = BlockCache::cached_blocks();
+  Small *small = new Small;
+  void *const address = small;
+  delete small;
+  COMPARE(BlockCache::cached_blocks(), cached + 1);
+  auto again = std::make_unique<Small>();
+  COMPARE(static_cast<void *>(again.get()), address);
+  COMPARE(BlockCache::cached_blocks(), cached);
+}
+
+TEST(size_of_dynamic_type) {
+  const std::size_t cached = BlockCache::cached_blocks();
+  std::unique_ptr<Small> large = std::make_unique<Large>();
+  void *const address = large.get();
+  large.reset();
+  COMPARE(BlockCache::cached_blocks(), cached + 1);
+  // a smaller object gets a different block
+  auto small = std::make_unique<Small>();
+  VERIFY(static_cast<void *>(small.get()) != address);
+  auto again = std::make_unique<Large>();
+  COMPARE(static_cast<void *>(again.get()), address);
+}
+
+TEST(large_blocks_are_not_cached) {
+  const std::size_t cached = BlockCache::cached_blocks();
+  void *p = BlockCache::allocate(BlockCache::max_size + 1);
+  BlockCache::deallocate(p, BlockCache::max_size + 1);
+  COMPARE(BlockCache::cached_blocks(), cached);
+}
+
+TEST(free_on_other_thread) {
+  Small *small = new Small;
+  std::size_t cached_by_other = 0;
+  std::thread other([&]() {
+    delete small;
+    cached_by_other = BlockCache::cached_blocks();
+  });
+  other.join();
+  COMPARE(cached_by_other, 1u);
+}
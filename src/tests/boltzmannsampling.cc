@@ -0,0 +1,110 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/boltzmannsampling.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "gsl/gsl_sf_bessel.h"
+
+#include "histogram.h"
+#include "setup.h"
+#include "smash/particles.h"
+#include "smash/random.h"
+
+using namespace smash;
+
+TEST(create_particles_table) {
+  Test::create_actual_particletypes();
+  Test::create_actual_decaymodes();
+}
+
+TEST(sample_momentum) {
+  const ParticleType &pip = ParticleType::find(0x211);
+  const double T = 0.15;
+  const BoltzmannSampling sampling({&pip}, T, false, 1);
+  Histogram1d hist(0.01);
+  hist.populate(100000, [&]() {
+    const auto [mass, momentum] = sampling.sample(pip);
+    COMPARE(mass, pip.mass());
+    return momentum;
+  });
+  hist.test([&](double p) {
+    return p * p * std::exp(-std::sqrt(p * p + pip.mass() * pip.mass()) / T);
+  });
+}
+
+TEST(sample_mass) {
+  const ParticleType &rhop = ParticleType::find(0x213);
+  const double T = 0.15;
+  const BoltzmannSampling sampling({&rhop}, T, true, 2);
+  Histogram1d hist(0.01);
+  hist.populate(100000, [&]() { return sampling.sample(rhop).first; });
+  hist.test([&](double m) {
+    return rhop.spectral_function(m) * m * m * gsl_sf_bessel_Kn(2, m / T);
+  });
+}
+
+TEST(sample_momentum_any_mass) {
+  const ThermalMomentumSampling &sampling = ThermalMomentumSampling::instance();
+  // Between the rows, on a row and beyond the tabulated m/T
+  for (const auto &[T, m] : {std::pair{0.15, 0.138}, std::pair{0.1, 0.938},
+                             std::pair{0.2, 1.25}, std::pair{0.01, 1.5}}) {
+    Histogram1d hist(0.1 * std::sqrt(T * (T + m)));
+    hist.populate(100000, [&]() { return sampling.sample(T, m); });
+    hist.test([&](double p) {
+      return p * p * std::exp(-(std::sqrt(p * p + m * m) - m) / T);
+    });
+  }
+}
+
+TEST_CATCH(sample_untabulated, std::out_of_range) {
+  const BoltzmannSampling sampling({&ParticleType::find(0x211)}, 0.15, false,
+                                   1);
+  sampling.sample(ParticleType::find(0x111));
+}
+
+TEST(parallel_sampling_is_reproducible) {
+  const ParticleType &pip = ParticleType::find(0x211);
+  const BoltzmannSampling sampling({&pip}, 0.15, false, 1);
+  auto sample_all = [&](int n_threads) {
+    random::set_seed(42);
+    Particles particles;
+    particles.create(5000, pip.pdgcode());
+    sample_particles_in_parallel(n_threads, particles, [&](ParticleData &data) {
+      data.set_4momentum(pip.mass(), 0., 0., sampling.sample(pip).second);
+    });
+    std::vector<double> momenta;
+    for (const ParticleData &data : particles) {
+      momenta.push_back(data.momentum().x3());
+    }
+    return momenta;
+  };
+  // The result does not depend on the number of threads.
+  const std::vector<double> first = sample_all(1);
+  const std::vector<double> second = sample_all(4);
+  COMPARE(first.size(), 5000u);
+  VERIFY(first == second);
+  // Different chunks draw from different streams.
+  VERIFY(first[0] != first[1024]);
+}
+
+TEST_CATCH(parallel_sampling_rethrows, std::runtime_error) {
+  Particles particles;
+  particles.create(3000, 0x211);
+  sample_particles_in_parallel(4, particles, [](ParticleData &data) {
+    if (data.id() == 2500) {
+      throw std::runtime_error("sampling failed");
+    }
+  });
+}
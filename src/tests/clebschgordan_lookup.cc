@@ -11,10 +11,12 @@
 
 #include "smash/clebschgordan_lookup.h"
 
+#include <iostream>
 #include <vector>
 
 #include "setup.h"
 #include "smash/clebschgordan.h"
+#include "smash/iomanipulators.h"
 
 using namespace smash;
 
@@ -96,6 +98,17 @@ TEST(coefficient) {
   }
 }
 
+TEST(outside_of_table) {
+  // the z components do not add up
+  COMPARE(ClebschGordan::coefficient(1, 1, 2, 1, 1, 0), 0.);
+  // spins that cannot couple
+  COMPARE(ClebschGordan::coefficient(1, 1, 6, 1, 1, 2), 0.);
+  // spins above the tabulated ones are calculated
+  FUZZY_COMPARE(ClebschGordan::coefficient(8, 0, 8, 2, 0, 2), 1.);
+  FUZZY_COMPARE(ClebschGordan::coefficient(0, 9, 9, 0, -3, -3), 1.);
+  FUZZY_COMPARE(ClebschGordan::coefficient(8, 2, 10, 8, 2, 10), 1.);
+}
+
 // This help function is used in the commented out part of the tabulate test
 [[maybe_unused]] static std::ostream &operator<<(
     std::ostream &out, const ClebschGordan::ThreeSpins &v) {
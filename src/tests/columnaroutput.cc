@@ -0,0 +1,124 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/columnaroutput.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "setup.h"
+#include "smash/clock.h"
+#include "smash/particles.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+static const std::filesystem::path outputfilepath =
+    testoutputpath / "particles_columnar.bin";
+
+/* Write two events with three particle lists each and return them. */
+static std::vector<ParticleList> write_events(
+    const OutputParameters &out_par) {
+  std::vector<ParticleList> written;
+  ColumnarOutput output(testoutputpath, "Particles", out_par);
+  const ExperimentParameters parameters = Test::default_parameters();
+  const DensityParameters dens_par(parameters);
+  std::unique_ptr<Clock> clock = std::make_unique<UniformClock>(0., 1., 5.);
+  for (int event = 0; event < 2; event++) {
+    auto particles = Test::create_particles(
+        3 + event, [] { return Test::smashon_random(); });
+    const EventInfo info = Test::default_event_info(1.5, false);
+    output.at_eventstart(*particles, event, info);
+    written.push_back(particles->copy_to_vector());
+    particles->insert(Test::smashon_random());
+    output.at_intermediate_time(*particles, clock, dens_par, info);
+    written.push_back(particles->copy_to_vector());
+    output.at_eventend(*particles, event, info);
+    written.push_back(particles->copy_to_vector());
+  }
+  return written;
+}
+
+TEST(read_selected_columns_of_an_event) {
+  OutputParameters out_par = OutputParameters();
+  out_par.part_only_final = OutputOnlyFinal::No;
+  const std::vector<ParticleList> written = write_events(out_par);
+
+  ColumnarReader reader(outputfilepath);
+  COMPARE(reader.size(), 6u);
+  COMPARE(reader.event_numbers(),
+          (std::vector<std::int32_t>{0, 0, 0, 1, 1, 1}));
+  VERIFY(!reader.single_precision());
+
+  const std::vector<ColumnarChunk> chunks = reader.read_event(
+      1, {ColumnarField::Pdg, ColumnarField::Pz, ColumnarField::T});
+  COMPARE(chunks.size(), 3u);
+  for (std::size_t i = 0; i < chunks.size(); i++) {
+    const ColumnarChunk &chunk = chunks[i];
+    const ParticleList &particles = written[3 + i];
+    COMPARE(chunk.event_number, 1);
+    COMPARE(chunk.n_particles, particles.size());
+    COMPARE(chunk.reals.size(), 2u);
+    COMPARE(chunk.integers.size(), 1u);
+    for (std::size_t j = 0; j < particles.size(); j++) {
+      COMPARE(chunk.integers.at(ColumnarField::Pdg)[j],
+              particles[j].pdgcode().get_decimal());
+      COMPARE(chunk.reals.at(ColumnarField::Pz)[j],
+              particles[j].momentum().x3());
+      COMPARE(chunk.reals.at(ColumnarField::T)[j],
+              particles[j].position().x0());
+    }
+  }
+  VERIFY(reader.read_event(7, {ColumnarField::Id}).empty());
+  VERIFY(std::filesystem::remove(outputfilepath));
+}
+
+TEST(single_precision_and_only_final) {
+  OutputParameters out_par = OutputParameters();
+  out_par.part_only_final = OutputOnlyFinal::Yes;
+  out_par.part_single_precision = true;
+  const std::vector<ParticleList> written = write_events(out_par);
+
+  ColumnarReader reader(outputfilepath);
+  COMPARE(reader.event_numbers(), (std::vector<std::int32_t>{0, 1}));
+  VERIFY(reader.single_precision());
+  const ColumnarChunk chunk = reader.read_chunk(1, {ColumnarField::Mass});
+  const ParticleList &particles = written[5];
+  COMPARE(chunk.n_particles, particles.size());
+  for (std::size_t j = 0; j < particles.size(); j++) {
+    COMPARE(chunk.reals.at(ColumnarField::Mass)[j],
+            static_cast<float>(particles[j].effective_mass()));
+  }
+  VERIFY(std::filesystem::remove(outputfilepath));
+}
+
+TEST(scan_file_without_index) {
+  OutputParameters out_par = OutputParameters();
+  write_events(out_par);
+  // Cut off the index, as if SMASH had not finished.
+  const auto size = std::filesystem::file_size(outputfilepath);
+  std::filesystem::resize_file(outputfilepath, size - 1);
+  ColumnarReader reader(outputfilepath);
+  COMPARE(reader.event_numbers(), (std::vector<std::int32_t>{0, 1}));
+  COMPARE(reader.read_event(1, {ColumnarField::Id}).size(), 1u);
+  VERIFY(std::filesystem::remove(outputfilepath));
+}
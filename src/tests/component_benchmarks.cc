@@ -0,0 +1,528 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+/*
+ * Times single components of the evolution with potentials in a box of
+ * nucleons, for a sweep of the numbers of test particles, of ensembles and of
+ * threads. Each component is repeated a few times and the mean run time with
+ * its standard error is reported.
+ *
+ * The results are printed as CSV, JSON or in the markdown format of the
+ * bm-results-SMASH-*.md files, such that they can be compared across commits
+ * with bin/benchmarks/compare_benchmarks.bash.
+ */
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "setup.h"
+#include "smash/boxmodus.h"
+#include "smash/configuration.h"
+#include "smash/density.h"
+#include "smash/grid.h"
+#include "smash/lattice.h"
+#include "smash/logging.h"
+#include "smash/parallel.h"
+#include "smash/potentials.h"
+#include "smash/propagation.h"
+#include "smash/random.h"
+#include "smash/scatteractionsfinder.h"
+
+using namespace smash;
+
+namespace {
+
+/// Time step of the evolution [fm]
+constexpr double time_step = 0.1;
+
+/// Parameters of the benchmarks, as given on the command line
+struct Options {
+  /// Numbers of test particles to sweep over
+  std::vector<int> n_test = {1, 10};
+  /// Numbers of ensembles to sweep over
+  std::vector<int> n_ensembles = {1, 4};
+  /// Numbers of threads to sweep over
+  std::vector<int> n_threads = {1, 2, 4};
+  /// Number of nucleons per ensemble and test particle
+  int nucleons = 200;
+  /// Edge length of the box [fm]
+  double length = 10.;
+  /// Number of timed repetitions of every component
+  int repetitions = 5;
+  /// Output format: csv, json or md
+  std::string format = "csv";
+  /// Output file, or empty for the standard output
+  std::string output;
+};
+
+/// Run time of one component for one setup
+struct Measurement {
+  /// Name of the component
+  std::string component;
+  /// Number of test particles
+  int n_test;
+  /// Number of ensembles
+  int n_ensembles;
+  /// Number of threads
+  int n_threads;
+  /// Mean run time [s]
+  double mean;
+  /// Standard error of the mean run time [s]
+  double error;
+};
+
+void usage(const std::string &progname, int rc) {
+  std::cout
+      << "\nUsage: " << progname << " [option]\n\n"
+      << "  -h, --help               usage information\n"
+      << "  -n, --testparticles <l>  comma-separated numbers of test particles"
+      << " (default: 1,10)\n"
+      << "  -e, --ensembles <l>      comma-separated numbers of ensembles"
+      << " (default: 1,4)\n"
+      << "  -t, --threads <l>        comma-separated numbers of threads"
+      << " (default: 1,2,4)\n"
+      << "  -N, --nucleons <n>       nucleons per ensemble and test particle"
+      << " (default: 200)\n"
+      << "  -L, --length <l>         edge length of the box in fm"
+      << " (default: 10)\n"
+      << "  -r, --repetitions <n>    timed repetitions per component"
+      << " (default: 5)\n"
+      << "  -f, --format <format>    csv, json or md (default: csv)\n"
+      << "  -o, --output <file>      output file"
+      << " (default: standard output)\n\n";
+  std::exit(rc);
+}
+
+/**
+ * \param[in] list Comma-separated list of positive integers
+ * \return the integers
+ * \throw std::invalid_argument if an entry is not a positive integer
+ */
+std::vector<int> parse_list(const std::string &list) {
+  std::vector<int> values;
+  std::stringstream stream(list);
+  std::string entry;
+  while (std::getline(stream, entry, ',')) {
+    const int value = std::stoi(entry);
+    if (value < 1) {
+      throw std::invalid_argument("Only positive numbers are allowed, got " +
+                                  entry + ".");
+    }
+    values.push_back(value);
+  }
+  return values;
+}
+
+/**
+ * \param[in] f Function to be timed
+ * \return wall-clock time taken by f [s]
+ */
+template <typename F>
+double time_of(F &&f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/**
+ * Run a component once to warm up and then for a number of repetitions.
+ *
+ * \param[in] repetitions Number of timed repetitions
+ * \param[in] run Function running the component once and returning the time
+ *            taken by the part to be measured [s]
+ * \return mean run time and its standard error [s]
+ */
+template <typename F>
+std::pair<double, double> measure(int repetitions, F &&run) {
+  run();
+  std::vector<double> times;
+  for (int i = 0; i < repetitions; i++) {
+    times.push_back(run());
+  }
+  double mean = 0., variance = 0.;
+  for (const double t : times) {
+    mean += t;
+  }
+  mean /= repetitions;
+  for (const double t : times) {
+    variance += (t - mean) * (t - mean);
+  }
+  const double error =
+      repetitions > 1
+          ? std::sqrt(variance / (repetitions - 1) / repetitions)
+          : 0.;
+  return {mean, error};
+}
+
+/**
+ * Call a function for all ensembles, which are distributed round-robin over
+ * the threads, as done by the Experiment.
+ *
+ * \param[in] n_threads Number of threads
+ * \param[in] n_ensembles Number of ensembles
+ * \param[in] f Function taking the index of an ensemble
+ */
+template <typename F>
+void for_each_ensemble(int n_threads, int n_ensembles, F &&f) {
+  parallel_for(n_threads, n_threads, 1, [&](int i_thread, std::size_t) {
+    for (int i_ens = i_thread; i_ens < n_ensembles; i_ens += n_threads) {
+      f(i_ens);
+    }
+  });
+}
+
+/**
+ * \param[in] ensembles Particles of all ensembles
+ * \return copies of the particles
+ */
+std::vector<Particles> copy_of(const std::vector<Particles> &ensembles) {
+  std::vector<Particles> copy(ensembles.size());
+  for (std::size_t i = 0; i < ensembles.size(); i++) {
+    for (const ParticleData &data : ensembles[i]) {
+      copy[i].insert(data);
+    }
+  }
+  return copy;
+}
+
+/**
+ * Time all components for one setup.
+ *
+ * \param[in] opt Options of the benchmarks
+ * \param[in] n_test Number of test particles
+ * \param[in] n_ensembles Number of ensembles
+ * \param[in,out] results Measurements, to which the new ones are appended
+ */
+void benchmark_setup(const Options &opt, int n_test, int n_ensembles,
+                     std::vector<Measurement> &results) {
+  ExperimentParameters par = Test::default_parameters(n_test, time_step);
+  par.n_ensembles = n_ensembles;
+  par.box_length = opt.length;
+
+  // thermal box of nucleons, the multiplicities are per test particle
+  Configuration box_conf{R"(
+    Box:
+      Initial_Condition: "thermal momenta"
+      Temperature: 0.1
+      Start_Time: 0.0
+  )"};
+  box_conf.set_value({"Box", "Init_Multiplicities", "2212"}, opt.nucleons / 2);
+  box_conf.set_value({"Box", "Init_Multiplicities", "2112"},
+                     opt.nucleons - opt.nucleons / 2);
+  box_conf.set_value({"Box", "Length"}, opt.length);
+  BoxModus box(std::move(box_conf), par);
+  std::vector<Particles> initial(n_ensembles);
+  for (Particles &particles : initial) {
+    box.initial_conditions(&particles, par);
+  }
+
+  Configuration pot_conf{R"(
+    Skyrme:
+      Skyrme_A: -209.2
+      Skyrme_B: 156.4
+      Skyrme_Tau: 1.35
+  )"};
+  const Potentials pot(std::move(pot_conf), par);
+  DensityParameters dens_par(par);
+
+  // lattices with 0.5 fm cells covering the periodic box
+  const int n_cells = std::max(2, static_cast<int>(2. * opt.length));
+  const std::array<double, 3> l = {opt.length, opt.length, opt.length};
+  const std::array<int, 3> n = {n_cells, n_cells, n_cells};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  DensityLattice jmu_B(l, n, origin, true, LatticeUpdate::EveryTimestep);
+  RectangularLattice<FourVector> jmu(l, n, origin, true,
+                                     LatticeUpdate::EveryTimestep);
+  RectangularLattice<FourVector> old_jmu(l, n, origin, true,
+                                         LatticeUpdate::EveryTimestep);
+  RectangularLattice<std::array<FourVector, 4>> four_gradient(
+      l, n, origin, true, LatticeUpdate::EveryTimestep);
+  RectangularLattice<std::pair<ThreeVector, ThreeVector>> FB(
+      l, n, origin, true, LatticeUpdate::EveryTimestep);
+
+  Configuration finder_conf{R"(
+    Collision_Term:
+      Strings: false
+  )"};
+  const ScatterActionsFinder finder(finder_conf, par);
+  const double min_cell_length = std::sqrt(4 * time_step * time_step +
+                                           200. / (M_PI * 10.));
+  const auto box_geometry = std::make_pair(origin, l);
+
+  /* actions of all ensembles, found in the grid cells of the ensemble, as in
+   * the Experiment or with translated copies of the search cells across the
+   * periodic boundaries */
+  auto find_actions = [&](const Particles &particles, bool copy_cells) {
+    ActionList actions;
+    const Grid<GridOptions::PeriodicBoundaries> grid(
+        box_geometry, particles, min_cell_length, time_step,
+        CellNumberLimitation::ParticleNumber);
+    auto in_cell = [&](const ParticleList &search) {
+      for (ActionPtr &action : finder.find_actions_in_cell(
+               search, time_step, grid.cell_volume(), {})) {
+        actions.push_back(std::move(action));
+      }
+    };
+    if (copy_cells) {
+      grid.iterate_cells(
+          in_cell,
+          [&](const ParticleList &search, const ParticleList &neighbors) {
+            for (ActionPtr &action : finder.find_actions_with_neighbors(
+                     search, neighbors, time_step, {})) {
+              actions.push_back(std::move(action));
+            }
+          });
+    } else {
+      grid.iterate_cells_with_shifts(
+          in_cell, [&](const ParticleList &search, const ThreeVector &shift,
+                       const ParticleList &neighbors) {
+            for (ActionPtr &action :
+                 finder.find_actions_with_shifted_neighbors(
+                     search, shift, neighbors, time_step, {})) {
+              actions.push_back(std::move(action));
+            }
+          });
+    }
+    return actions;
+  };
+
+  for (const int n_threads : opt.n_threads) {
+    const int ensemble_threads = std::min(n_threads, n_ensembles);
+    dens_par.set_threads(n_threads);
+    std::vector<Particles> ensembles = copy_of(initial);
+    auto add = [&](const std::string &component,
+                   std::pair<double, double> time) {
+      results.push_back(Measurement{component, n_test, n_ensembles,
+                                    n_threads, time.first, time.second});
+    };
+
+    add("Lattice update", measure(opt.repetitions, [&]() {
+          return time_of([&]() {
+            update_lattice(&jmu_B, LatticeUpdate::EveryTimestep,
+                           DensityType::Baryon, dens_par, ensembles, true);
+          });
+        }));
+
+    for (std::size_t i = 0; i < jmu.size(); i++) {
+      jmu[i] = jmu_B[i].jmu_net();
+    }
+    add("Four-gradient", measure(opt.repetitions, [&]() {
+          return time_of([&]() {
+            jmu.compute_four_gradient_lattice(old_jmu, time_step,
+                                              four_gradient);
+          });
+        }));
+
+    for (std::size_t i = 0; i < FB.size(); i++) {
+      DensityOnLattice node = jmu_B[i];
+      FB[i] = pot.skyrme_force(node.rho(), node.grad_j0(), node.dvecj_dt(),
+                               node.curl_vecj());
+    }
+    add("Momentum update", measure(opt.repetitions, [&]() {
+          return time_of([&]() {
+            update_momenta(ensembles, time_step, pot, &FB, nullptr, nullptr,
+                           &jmu_B, n_threads);
+          });
+        }));
+
+    add("Grid build", measure(opt.repetitions, [&]() {
+          return time_of([&]() {
+            for_each_ensemble(ensemble_threads, n_ensembles, [&](int i_ens) {
+              const Grid<GridOptions::PeriodicBoundaries> grid(
+                  box_geometry, ensembles[i_ens], min_cell_length, time_step,
+                  CellNumberLimitation::ParticleNumber);
+            });
+          });
+        }));
+
+    add("Action finding", measure(opt.repetitions, [&]() {
+          return time_of([&]() {
+            for_each_ensemble(ensemble_threads, n_ensembles, [&](int i_ens) {
+              find_actions(ensembles[i_ens], false);
+            });
+          });
+        }));
+
+    add("Action finding (copied cells)", measure(opt.repetitions, [&]() {
+          return time_of([&]() {
+            for_each_ensemble(ensemble_threads, n_ensembles, [&](int i_ens) {
+              find_actions(ensembles[i_ens], true);
+            });
+          });
+        }));
+
+    // the actions are performed on fresh copies of the initial particles
+    add("Action performing", measure(opt.repetitions, [&]() {
+          std::vector<Particles> fresh = copy_of(initial);
+          std::vector<ActionList> actions(n_ensembles);
+          for (int i_ens = 0; i_ens < n_ensembles; i_ens++) {
+            actions[i_ens] = find_actions(fresh[i_ens], false);
+            std::sort(actions[i_ens].begin(), actions[i_ens].end(),
+                      [](const ActionPtr &a, const ActionPtr &b) {
+                        return *a < *b;
+                      });
+          }
+          return time_of([&]() {
+            for_each_ensemble(ensemble_threads, n_ensembles, [&](int i_ens) {
+              uint32_t id_process = 1;
+              for (ActionPtr &action : actions[i_ens]) {
+                if (action->is_valid(fresh[i_ens])) {
+                  action->generate_final_state();
+                  action->perform(&fresh[i_ens], id_process++);
+                }
+              }
+            });
+          });
+        }));
+  }
+}
+
+/**
+ * Write the measurements.
+ *
+ * \param[in] results Measurements
+ * \param[in] format Output format: csv, json or md
+ * \param[out] out Stream to write to
+ */
+void write(const std::vector<Measurement> &results, const std::string &format,
+           std::ostream &out) {
+  out << std::setprecision(6);
+  if (format == "csv") {
+    out << "component,n_test,n_ensembles,n_threads,mean_s,error_s\n";
+    for (const Measurement &m : results) {
+      out << m.component << "," << m.n_test << "," << m.n_ensembles << ","
+          << m.n_threads << "," << m.mean << "," << m.error << "\n";
+    }
+  } else if (format == "json") {
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+      const Measurement &m = results[i];
+      out << "  {\"component\": \"" << m.component
+          << "\", \"n_test\": " << m.n_test
+          << ", \"n_ensembles\": " << m.n_ensembles
+          << ", \"n_threads\": " << m.n_threads << ", \"mean_s\": " << m.mean
+          << ", \"error_s\": " << m.error << "}"
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+  } else {
+    /* Every benchmark is a section, whose title starts with a capital letter,
+     * with a line in the format of perf stat, which is what
+     * compare_benchmarks.bash extracts. */
+    out << "# Component Benchmark Results\n\n## Results\n";
+    for (const Measurement &m : results) {
+      out << "\n### " << m.component << " (" << m.n_test << " TP, "
+          << m.n_ensembles << " ensembles, " << m.n_threads << " threads)\n"
+          << "```\n"
+          << "  " << m.mean << " +- " << m.error
+          << " seconds time elapsed\n"
+          << "```\n";
+    }
+  }
+}
+
+}  // unnamed namespace
+
+int main(int argc, char *argv[]) {
+  constexpr option longopts[] = {{"help", no_argument, 0, 'h'},
+                                 {"testparticles", required_argument, 0, 'n'},
+                                 {"ensembles", required_argument, 0, 'e'},
+                                 {"threads", required_argument, 0, 't'},
+                                 {"nucleons", required_argument, 0, 'N'},
+                                 {"length", required_argument, 0, 'L'},
+                                 {"repetitions", required_argument, 0, 'r'},
+                                 {"format", required_argument, 0, 'f'},
+                                 {"output", required_argument, 0, 'o'},
+                                 {nullptr, 0, 0, 0}};
+  const std::string progname = argv[0];
+  try {
+    Options opt;
+    int c;
+    while ((c = getopt_long(argc, argv, "hn:e:t:N:L:r:f:o:", longopts,
+                            nullptr)) != -1) {
+      switch (c) {
+        case 'h':
+          usage(progname, EXIT_SUCCESS);
+          break;
+        case 'n':
+          opt.n_test = parse_list(optarg);
+          break;
+        case 'e':
+          opt.n_ensembles = parse_list(optarg);
+          break;
+        case 't':
+          opt.n_threads = parse_list(optarg);
+          break;
+        case 'N':
+          opt.nucleons = std::stoi(optarg);
+          break;
+        case 'L':
+          opt.length = std::stod(optarg);
+          break;
+        case 'r':
+          opt.repetitions = std::stoi(optarg);
+          break;
+        case 'f':
+          opt.format = optarg;
+          break;
+        case 'o':
+          opt.output = optarg;
+          break;
+        default:
+          usage(progname, EXIT_FAILURE);
+      }
+    }
+    if (opt.format != "csv" && opt.format != "json" && opt.format != "md") {
+      throw std::invalid_argument("Unknown output format " + opt.format + ".");
+    }
+    if (opt.nucleons < 2 || opt.length <= 0. || opt.repetitions < 1) {
+      throw std::invalid_argument(
+          "The numbers of nucleons and repetitions as well as the length of "
+          "the box have to be positive.");
+    }
+
+    set_default_loglevel(einhard::WARN);
+    create_all_loggers(Configuration(""));
+    Test::create_actual_particletypes();
+    Test::create_actual_decaymodes();
+    random::set_seed(random::generate_63bit_seed());
+
+    std::vector<Measurement> results;
+    for (const int n_test : opt.n_test) {
+      for (const int n_ensembles : opt.n_ensembles) {
+        benchmark_setup(opt, n_test, n_ensembles, results);
+      }
+    }
+    if (opt.output.empty()) {
+      write(results, opt.format, std::cout);
+    } else {
+      std::ofstream file(opt.output);
+      write(results, opt.format, file);
+    }
+  } catch (std::exception &e) {
+    std::cerr << progname << ": " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -160,6 +160,23 @@ TEST(take_removes_empty_section_but_not_empty_lists) {
   conf.clear();
 }
 
+TEST(take_removes_empty_sections_after_modifications) {
+  Configuration conf{R"(
+    Section:
+      Sub-section:
+        Key: "Value"
+      Other_key: 1
+    Empty: {}
+  )"};
+  conf.take({"Section", "Other_key"});
+  VERIFY(!conf.has_value_including_empty({"Empty"}));
+  conf.merge_yaml("Merged: {}");
+  VERIFY(conf.has_value_including_empty({"Merged"}));
+  conf.take({"Section", "Sub-section", "Key"});
+  VERIFY(!conf.has_value_including_empty({"Merged"}));
+  VERIFY(conf.is_empty()) << "\n" << conf.to_string();
+}
+
 TEST_CATCH(read_failed_sequence_conversion,
            Configuration::IncorrectTypeInAssignment) {
   Configuration conf = make_test_configuration();
@@ -0,0 +1,85 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/coulombfieldsolver.h"
+
+#include "smash/potentials.h"
+
+using namespace smash;
+
+TEST(init_particle_types) {
+  ParticleType::create_type_list(
+      "# NAME MASS[GEV] WIDTH[GEV] PARITY PDG\n"
+      "N+ 0.938 0.0 + 2212\n");
+}
+
+/**
+ * Fill the charge density lattice with some protons and antiprotons, compute
+ * the fields with the solver and compare them to the direct sums.
+ */
+static void compare_to_direct_sum(const std::array<int, 3> &n,
+                                  const std::array<double, 3> &l,
+                                  bool periodic, double r_cut) {
+  const std::array<double, 3> origin = {-0.5 * l[0], -0.5 * l[1], -0.5 * l[2]};
+  RectangularLattice<DensityOnLattice> charge_density(
+      l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+  RectangularLattice<std::pair<ThreeVector, ThreeVector>> fields(
+      l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+  const ParticleType &proton = ParticleType::find(0x2212);
+  for (size_t i = 0; i < charge_density.size(); i += 3) {
+    ParticleData p{proton};
+    p.set_4momentum(proton.mass(), 0.1 * (i % 7), -0.2 * (i % 5),
+                    0.3 * (i % 4));
+    charge_density[i].add_particle(p, i % 2 == 0 ? 0.5 : -0.25);
+  }
+
+  const CoulombFieldSolver solver(n, charge_density.cell_sizes(), periodic,
+                                  r_cut, 2);
+  solver.compute_fields(charge_density, fields);
+
+  for (size_t i = 0; i < fields.size(); i++) {
+    const ThreeVector position = charge_density.cell_center(i);
+    ThreeVector electric_field = {0., 0., 0.};
+    charge_density.integrate_volume(
+        electric_field, Potentials::E_field_integrand, r_cut, position);
+    ThreeVector magnetic_field = {0., 0., 0.};
+    charge_density.integrate_volume(
+        magnetic_field, Potentials::B_field_integrand, r_cut, position);
+    for (int c = 0; c < 3; c++) {
+      COMPARE_ABSOLUTE_ERROR(fields[i].first[c], electric_field[c], 1.e-13)
+          << " at node " << i;
+      COMPARE_ABSOLUTE_ERROR(fields[i].second[c], magnetic_field[c], 1.e-13)
+          << " at node " << i;
+    }
+  }
+}
+
+TEST(non_periodic_lattice) {
+  compare_to_direct_sum({10, 12, 9}, {10., 12., 9.}, false, 3.);
+  compare_to_direct_sum({8, 8, 8}, {4., 4., 4.}, false, 5.);
+}
+
+TEST(periodic_lattice) {
+  // Powers of two and others, with and without several distances per node
+  compare_to_direct_sum({8, 8, 8}, {8., 8., 8.}, true, 2.5);
+  compare_to_direct_sum({7, 5, 6}, {7., 5., 6.}, true, 4.2);
+}
+
+TEST_CATCH(mismatching_lattice, std::invalid_argument) {
+  const CoulombFieldSolver solver({4, 4, 4}, {1., 1., 1.}, false, 2., 1);
+  RectangularLattice<DensityOnLattice> charge_density(
+      {5., 4., 4.}, {5, 4, 4}, {0., 0., 0.}, false,
+      LatticeUpdate::EveryTimestep);
+  RectangularLattice<std::pair<ThreeVector, ThreeVector>> fields(
+      {5., 4., 4.}, {5, 4, 4}, {0., 0., 0.}, false,
+      LatticeUpdate::EveryTimestep);
+  solver.compute_fields(charge_density, fields);
+}
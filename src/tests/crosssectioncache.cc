@@ -0,0 +1,89 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/crosssectioncache.h"
+
+#include "smash/particledata.h"
+
+using namespace smash;
+
+TEST(init_particle_types) {
+  ParticleType::create_type_list(
+      "# NAME MASS[GEV] WIDTH[GEV] PARITY PDG\n"
+      "σ    0.2 0.0 + 9876542\n"
+      "σino 0.5 0.0 + 1234568\n"
+      "ρino 1.1 0.1 + 1234578\n");
+}
+
+static ParticleList incoming(int pdg_a, int pdg_b) {
+  return {ParticleData{ParticleType::find(PdgCode(std::to_string(pdg_a)))},
+          ParticleData{ParticleType::find(PdgCode(std::to_string(pdg_b)))}};
+}
+
+TEST_CATCH(invalid_bin_width, std::invalid_argument) {
+  CrossSectionCache cache(0.);
+}
+
+TEST(applies_to) {
+  const CrossSectionCache cache(0.01);
+  VERIFY(cache.applies_to(incoming(9876542, 1234568), 1.));
+  VERIFY(cache.applies_to(incoming(1234568, 9876542), 0.711));
+  // the lower bin edge is below the threshold
+  VERIFY(!cache.applies_to(incoming(9876542, 1234568), 0.705));
+  // unstable particles have no fixed mass
+  VERIFY(!cache.applies_to(incoming(9876542, 1234578), 2.));
+}
+
+TEST(total_is_interpolated) {
+  CrossSectionCache cache(0.01);
+  int evaluations = 0;
+  auto linear = [&](double sqrt_s) {
+    evaluations++;
+    return 10. + 3. * sqrt_s;
+  };
+  FUZZY_COMPARE(cache.total(incoming(9876542, 1234568), 1.0042, linear),
+                10. + 3. * 1.0042);
+  COMPARE(evaluations, 2);
+  COMPARE(cache.misses(), 1u);
+  // same bin in opposite order
+  FUZZY_COMPARE(cache.total(incoming(1234568, 9876542), 1.0071, linear),
+                10. + 3. * 1.0071);
+  COMPARE(evaluations, 2);
+  COMPARE(cache.hits(), 1u);
+  // the next bin shares one edge
+  cache.total(incoming(9876542, 1234568), 1.0123, linear);
+  COMPARE(evaluations, 3);
+  COMPARE(cache.misses(), 2u);
+}
+
+TEST(branches_from_lower_edge) {
+  CrossSectionCache cache(0.01);
+  const ParticleList in = incoming(9876542, 1234568);
+  double evaluated_at = 0.;
+  auto elastic = [&](double sqrt_s) {
+    evaluated_at = sqrt_s;
+    CollisionBranchList list;
+    list.push_back(std::make_unique<CollisionBranch>(
+        in[0].type(), in[1].type(), sqrt_s, ProcessType::Elastic));
+    return list;
+  };
+  const CollisionBranchList first = cache.branches(in, 1.0042, elastic);
+  FUZZY_COMPARE(evaluated_at, 1.0);
+  evaluated_at = 0.;
+  const CollisionBranchList second = cache.branches(in, 1.0099, elastic);
+  COMPARE(evaluated_at, 0.);
+  COMPARE(second.size(), 1u);
+  COMPARE(second[0]->get_type(), ProcessType::Elastic);
+  FUZZY_COMPARE(second[0]->weight(), first[0]->weight());
+  VERIFY(second[0]->particle_types() == first[0]->particle_types());
+  COMPARE(cache.hits(), 1u);
+  COMPARE(cache.misses(), 1u);
+}
@@ -14,6 +14,7 @@
 #include "setup.h"
 #include "smash/isoparticletype.h"
 #include "smash/particletype.h"
+#include "smash/tabulationbundle.h"
 
 using namespace smash;
 
@@ -237,6 +238,67 @@ TEST(load_decaymodes_3body) {
   }
 }
 
+TEST(potential_scales) {
+  DecayModes::load_decaymodes(decays_input);
+  for (const ParticleType &type : ParticleType::list_all()) {
+    COMPARE(type.decay_modes().potential_scales().size(),
+            type.decay_modes().decay_mode_list().size());
+  }
+  // Δ⁺ → N π: the baryon scales cancel, the isospin projections do not
+  const auto &delta_plus = ParticleType::find(0x2214).decay_modes();
+  const auto &modelist = delta_plus.decay_mode_list();
+  COMPARE(modelist.size(), 2u);
+  for (std::size_t i = 0; i < modelist.size(); i++) {
+    const auto &scale = delta_plus.potential_scales()[i];
+    const auto &products = modelist[i]->particle_types();
+    const ParticleTypePtr nucleon =
+        products[0]->is_nucleon() ? products[0] : products[1];
+    VERIFY(nucleon->is_nucleon());
+    COMPARE(scale.first, 0.);
+    COMPARE(scale.second, 1. / 3. - nucleon->isospin3_rel());
+  }
+  // Λ(1520) → Λ π π: all scales cancel
+  for (const auto &scale :
+       ParticleType::find(0x3124).decay_modes().potential_scales()) {
+    COMPARE(scale.first, 0.);
+    COMPARE(scale.second, 0.);
+  }
+}
+
+TEST(formation_candidates) {
+  DecayModes::load_decaymodes(decays_input);
+  const ParticleTypePtr pi_plus = &ParticleType::find(0x211);
+  const ParticleTypePtr pi_minus = &ParticleType::find(-0x211);
+  const ParticleTypePtr pi_zero = &ParticleType::find(0x111);
+  // π⁺ π⁻ → ρ⁰, σ, for either order of the pions
+  const auto &candidates =
+      DecayModes::formation_candidates(pi_plus, pi_minus);
+  COMPARE(&candidates, &DecayModes::formation_candidates(pi_minus, pi_plus));
+  COMPARE(candidates.size(), 2u);
+  VERIFY(candidates[0].resonance < candidates[1].resonance);
+  VERIFY(candidates[0].resonance->pdgcode() == 0x113 ||
+         candidates[1].resonance->pdgcode() == 0x113);
+  VERIFY(candidates[0].resonance->pdgcode() == 0x9000221 ||
+         candidates[1].resonance->pdgcode() == 0x9000221);
+  for (const auto &candidate : candidates) {
+    const auto &modelist = candidate.resonance->decay_modes().decay_mode_list();
+    COMPARE(candidate.in_modes.size(), 1u);
+    VERIFY(modelist[candidate.in_modes[0]]->type().has_particles(
+        {pi_plus, pi_minus}));
+  }
+  // The decay of ρ⁰ into two π⁰ is forbidden by isospin
+  const auto &neutral = DecayModes::formation_candidates(pi_zero, pi_zero);
+  COMPARE(neutral.size(), 1u);
+  COMPARE(neutral[0].resonance->pdgcode(), 0x9000221);
+  // Three-body decays do not contribute
+  VERIFY(DecayModes::formation_candidates(&ParticleType::find(0x3122), pi_plus)
+             .empty());
+  const ParticleTypePtrList resonances = list_possible_resonances(
+      &ParticleType::find(0x2212), pi_plus);
+  COMPARE(resonances.size(), 1u);
+  COMPARE(resonances[0]->pdgcode(), 0x2224);
+}
+
 TEST_CATCH(add_no_particles, DecayModes::InvalidDecay) {
   DecayModes m;
   m.add_mode(&ParticleType::find(0x113), 1., 0, {});
@@ -254,3 +316,74 @@ TEST(add_two_particles) {
              {&ParticleType::find(0x211), &ParticleType::find(-0x211)});
   VERIFY(!m.is_empty());
 }
+
+TEST(get_decay_type_ignores_order) {
+  ParticleTypePtr rho = &ParticleType::find(0x113);
+  ParticleTypePtr pi_plus = &ParticleType::find(0x211);
+  ParticleTypePtr pi_minus = &ParticleType::find(-0x211);
+  DecayType *type = DecayModes::get_decay_type(rho, {pi_plus, pi_minus}, 1);
+  COMPARE(DecayModes::get_decay_type(rho, {pi_minus, pi_plus}, 1), type);
+  VERIFY(DecayModes::get_decay_type(rho, {pi_plus, pi_minus}, 0) != type);
+  VERIFY(type->has_particles({pi_minus, pi_plus}));
+  COMPARE(type->angular_momentum(), 1);
+}
+
+TEST(tabulated_widths) {
+  DecayModes::load_decaymodes(decays_input);
+  const ParticleType &rho = ParticleType::find(0x113);
+  const std::vector<double> masses = {0.2, 0.35, 0.5, 0.776, 1.2, 2.5, 4.};
+  std::vector<double> exact_total, exact_hadronic;
+  for (double m : masses) {
+    exact_total.push_back(rho.total_width(m));
+    exact_hadronic.push_back(rho.hadronic_width(m));
+  }
+  // only the hadronic decay into π π contributes at the pole
+  COMPARE_RELATIVE_ERROR(rho.hadronic_width(rho.mass()),
+                         0.99 * rho.width_at_pole(), 1e-6);
+
+  std::size_t n_unstable = 0;
+  for (const ParticleType &type : ParticleType::list_all()) {
+    n_unstable += !type.is_stable();
+  }
+  TabulationBundle bundle(sha256::Hash{});
+  COMPARE(DecayModes::tabulate_widths(bundle), 2u * n_unstable);
+  COMPARE(bundle.size(), 2u * n_unstable);
+  const auto compare_width = [](double tabulated, double exact, double m) {
+    if (exact == 0.) {
+      COMPARE(tabulated, 0.) << m;
+    } else {
+      COMPARE_RELATIVE_ERROR(tabulated, exact, 1e-3) << m;
+    }
+  };
+  for (std::size_t i = 0; i < masses.size(); i++) {
+    compare_width(rho.total_width(masses[i]), exact_total[i], masses[i]);
+    compare_width(rho.hadronic_width(masses[i]), exact_hadronic[i], masses[i]);
+  }
+
+  // The tabulations in the bundle are reused, and dropped with the modes.
+  COMPARE(DecayModes::tabulate_widths(bundle), 0u);
+  COMPARE(rho.total_width(0.5),
+          rho.decay_modes().total_width_tabulation().get_value_linear(0.5));
+  DecayModes::load_decaymodes(decays_input);
+  VERIFY(rho.decay_modes().total_width_tabulation().is_empty());
+  COMPARE(rho.total_width(masses[2]), exact_total[2]);
+}
+
+TEST(tabulate_decay_types) {
+  DecayModes::load_decaymodes(decays_input);
+  const ParticleType &omega = ParticleType::find(0x223);
+  // ω → π ρ is tabulated on first use
+  const double lazy_width = omega.total_width(1.0);
+
+  DecayModes::load_decaymodes(decays_input);
+  TabulationBundle bundle(sha256::Hash{});
+  const std::size_t n_tabulated = DecayModes::tabulate_decay_types(bundle);
+  VERIFY(n_tabulated > 0u);
+  COMPARE(bundle.size(), n_tabulated);
+  COMPARE(omega.total_width(1.0), lazy_width);
+
+  // The tabulations in the bundle are reused.
+  DecayModes::load_decaymodes(decays_input);
+  COMPARE(DecayModes::tabulate_decay_types(bundle), 0u);
+  COMPARE(omega.total_width(1.0), lazy_width);
+}
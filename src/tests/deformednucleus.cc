@@ -224,3 +224,55 @@ TEST(nucleon_density_norm) {
                            allowed_errors[index]);
   }
 }
+
+TEST(tabulated_sampling) {
+  const std::map<PdgCode, int> uranium = {{pdg::p, 92}, {pdg::n, 238 - 92}};
+  DeformedNucleus tabulated(uranium, 1), rejected(uranium, 1);
+  for (DeformedNucleus *nucleus : {&tabulated, &rejected}) {
+    nucleus->set_beta_2(0.28);
+    nucleus->set_beta_4(0.093);
+  }
+  rejected.set_tabulated_sampling(false);
+
+  constexpr int N_SAMPLES = 1000000;
+  std::vector<double> tabulated_moments(2, 0.), rejected_moments(2, 0.);
+  for (int i = 0; i < N_SAMPLES; i++) {
+    const ThreeVector a = tabulated.distribute_nucleon();
+    tabulated_moments[0] += square(a.x1()) / N_SAMPLES;
+    tabulated_moments[1] += square(a.x3()) / N_SAMPLES;
+    const ThreeVector b = rejected.distribute_nucleon();
+    rejected_moments[0] += square(b.x1()) / N_SAMPLES;
+    rejected_moments[1] += square(b.x3()) / N_SAMPLES;
+  }
+  // The prolate deformation stretches the nucleus along z.
+  VERIFY(tabulated_moments[1] > 1.1 * tabulated_moments[0]);
+  COMPARE_RELATIVE_ERROR(tabulated_moments[0], rejected_moments[0], 0.01);
+  COMPARE_RELATIVE_ERROR(tabulated_moments[1], rejected_moments[1], 0.01);
+}
+
+TEST(tabulated_triaxial_sampling) {
+  const std::map<PdgCode, int> uranium = {{pdg::p, 92}, {pdg::n, 238 - 92}};
+  DeformedNucleus tabulated(uranium, 1), rejected(uranium, 1);
+  for (DeformedNucleus *nucleus : {&tabulated, &rejected}) {
+    nucleus->set_beta_2(0.28);
+    nucleus->set_gamma(0.5);
+    nucleus->set_beta_3(0.05);
+  }
+  rejected.set_tabulated_sampling(false);
+
+  constexpr int N_SAMPLES = 1000000;
+  std::vector<double> tabulated_moments(3, 0.), rejected_moments(3, 0.);
+  for (int i = 0; i < N_SAMPLES; i++) {
+    const ThreeVector a = tabulated.distribute_nucleon();
+    const ThreeVector b = rejected.distribute_nucleon();
+    for (int k = 0; k < 3; k++) {
+      tabulated_moments[k] += square(a[k]) / N_SAMPLES;
+      rejected_moments[k] += square(b[k]) / N_SAMPLES;
+    }
+  }
+  // The triaxial deformation stretches the nucleus more along x than y.
+  VERIFY(tabulated_moments[0] > 1.1 * tabulated_moments[1]);
+  for (int k = 0; k < 3; k++) {
+    COMPARE_RELATIVE_ERROR(tabulated_moments[k], rejected_moments[k], 0.01);
+  }
+}
@@ -12,6 +12,7 @@
 #include "smash/density.h"
 
 #include <filesystem>
+#include <limits>
 #include <map>
 
 #include "setup.h"
@@ -141,6 +142,100 @@ TEST(density_eckart_special_cases) {
   COMPARE_RELATIVE_ERROR(rho, -0.0003763388107782538 * f, 1.e-5) << rho;
 }
 
+TEST(current_eckart_from_cells) {
+  const ExperimentParameters exp_par = smash::Test::default_parameters();
+  const DensityParameters par(exp_par);
+  ParticleList P;
+  for (int i = 0; i < 40; i++) {
+    ParticleData part = (i % 4 == 0) ? create_antiproton(i) : create_proton(i);
+    part.set_4position(
+        FourVector(0.0, 0.7 * i - 14.0, std::sin(i) * 3.0, -0.3 * i));
+    part.set_4momentum(0.938, 0.1 * std::cos(i), 0.2, -0.05 * i);
+    P.push_back(part);
+  }
+  const ParticleCells cells(P, par.r_cut());
+  COMPARE(cells.particles().size(), P.size());
+  // far away from all particles
+  VERIFY(cells.within_reach(ThreeVector(100., 0., 0.)).empty());
+  for (const ThreeVector r :
+       {ThreeVector(0., 0., 0.), ThreeVector(-5., 1., -2.),
+        ThreeVector(8., -3., -9.5)}) {
+    VERIFY(cells.within_reach(r).size() < P.size());
+    const auto expected =
+        current_eckart(r, P, par, DensityType::Baryon, true, true);
+    const auto from_cells =
+        current_eckart(r, cells, par, DensityType::Baryon, true, true);
+    COMPARE(std::get<0>(from_cells), std::get<0>(expected));
+    COMPARE(std::get<1>(from_cells), std::get<1>(expected));
+    COMPARE(std::get<2>(from_cells), std::get<2>(expected));
+    COMPARE(std::get<3>(from_cells), std::get<3>(expected));
+    COMPARE(std::get<4>(from_cells), std::get<4>(expected));
+    // without smearing, all particles contribute
+    COMPARE(std::get<1>(current_eckart(r, cells, par, DensityType::Baryon,
+                                       false, false)),
+            std::get<1>(
+                current_eckart(r, P, par, DensityType::Baryon, false, false)));
+  }
+}
+
+TEST(smear_at_points) {
+  const ExperimentParameters exp_par = smash::Test::default_parameters();
+  DensityParameters par(exp_par);
+  ParticleList P;
+  for (int i = 0; i < 40; i++) {
+    ParticleData part = (i % 4 == 0) ? create_antiproton(i) : create_proton(i);
+    part.set_4position(
+        FourVector(0.0, 0.7 * i - 14.0, std::sin(i) * 3.0, -0.3 * i));
+    part.set_4momentum(0.938, 0.1 * std::cos(i), 0.2, -0.05 * i);
+    P.push_back(part);
+  }
+  const ParticleCells cells(P, par.r_cut());
+  std::vector<ThreeVector> points;
+  for (int i = 0; i < 300; i++) {
+    points.emplace_back(0.1 * i - 15.0, std::cos(i), -0.04 * i);
+  }
+  auto currents = smear_at_points<DensityOnLattice>(points, cells, par,
+                                                    DensityType::Baryon);
+  const auto tmn = smear_at_points<EnergyMomentumTensor>(points, cells, par,
+                                                         DensityType::Hadron);
+  COMPARE(currents.size(), points.size());
+  COMPARE(tmn.size(), points.size());
+  for (std::size_t i = 0; i < points.size(); i++) {
+    const auto expected =
+        current_eckart(points[i], P, par, DensityType::Baryon, false, true);
+    COMPARE_ABSOLUTE_ERROR(currents[i].rho(), std::get<0>(expected), 1.e-15);
+    for (int mu = 0; mu < 4; mu++) {
+      COMPARE_ABSOLUTE_ERROR(currents[i].jmu_net()[mu],
+                             std::get<1>(expected)[mu], 1.e-15);
+    }
+    EnergyMomentumTensor expected_tmn;
+    for (const ParticleData &part : P) {
+      const FourVector p = part.momentum();
+      const double sf =
+          unnormalized_smearing_factor(part.position().threevec() - points[i],
+                                       p, 1.0 / p.abs(), par)
+              .first;
+      expected_tmn.add_particle(part, sf * par.norm_factor_sf());
+    }
+    for (int k = 0; k < 10; k++) {
+      COMPARE_ABSOLUTE_ERROR(tmn[i][k], expected_tmn[k], 1.e-15);
+    }
+  }
+  // The result does not depend on the number of threads.
+  par.set_threads(4);
+  const auto parallel_tmn = smear_at_points<EnergyMomentumTensor>(
+      points, cells, par, DensityType::Hadron);
+  for (std::size_t i = 0; i < points.size(); i++) {
+    for (int k = 0; k < 10; k++) {
+      COMPARE(parallel_tmn[i][k], tmn[i][k]);
+    }
+  }
+}
+
+TEST_CATCH(particle_cells_need_positive_cutoff, std::invalid_argument) {
+  ParticleCells cells(ParticleList{}, 0.);
+}
+
 TEST(smearing_factor_normalization) {
   // Create density lattice with small lattice spacing
   const std::array<double, 3> l = {10., 10., 10.};
@@ -179,6 +274,304 @@ TEST(smearing_factor_normalization) {
   COMPARE_RELATIVE_ERROR(int_rho_r_d3r, 1.0, 3.e-6);
 }
 
+TEST(threaded_smearing_matches_serial) {
+  const double L = 10.;
+  Configuration conf{R"(
+    Box:
+      Initial_Condition: "thermal momenta"
+      Temperature: 0.2
+      Start_Time: 0.0
+  )"};
+  conf.set_value({"Box", "Init_Multiplicities", "2212"}, 300);
+  conf.set_value({"Box", "Length"}, L);
+  ExperimentParameters par = smash::Test::default_parameters();
+  par.box_length = L;
+  std::unique_ptr<BoxModus> b =
+      std::make_unique<BoxModus>(std::move(conf), par);
+  std::vector<Particles> ensembles(1);
+  b->initial_conditions(&ensembles[0], par);
+
+  const DensityParameters serial_par = DensityParameters(par);
+  DensityParameters threaded_par = DensityParameters(par);
+  threaded_par.set_threads(3);
+  COMPARE(threaded_par.threads(), 3);
+  for (const bool periodicity : {true, false}) {
+    const std::array<double, 3> l = {L, L, L};
+    const std::array<int, 3> n = {20, 20, 20};
+    const std::array<double, 3> origin = {0., 0., 0.};
+    auto serial = std::make_unique<DensityLattice>(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    auto threaded = std::make_unique<DensityLattice>(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    update_lattice(serial.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::Baryon, serial_par, ensembles, true);
+    update_lattice(threaded.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::Baryon, threaded_par, ensembles, true);
+    for (std::size_t i = 0; i < serial->size(); i++) {
+      COMPARE((*threaded)[i].jmu_net(), (*serial)[i].jmu_net()) << i;
+      COMPARE((*threaded)[i].djmu_dxnu()[3], (*serial)[i].djmu_dxnu()[3]) << i;
+    }
+  }
+}
+
+TEST(gathered_currents_match_smearing) {
+  const double L = 10.;
+  Configuration conf{R"(
+    Box:
+      Initial_Condition: "thermal momenta"
+      Temperature: 0.2
+      Start_Time: 0.0
+  )"};
+  conf.set_value({"Box", "Init_Multiplicities", "2212"}, 200);
+  conf.set_value({"Box", "Init_Multiplicities", "-2212"}, 50);
+  conf.set_value({"Box", "Length"}, L);
+  ExperimentParameters par = smash::Test::default_parameters();
+  par.box_length = L;
+  par.derivatives_mode = DerivativesMode::CovariantGaussian;
+  std::unique_ptr<BoxModus> b =
+      std::make_unique<BoxModus>(std::move(conf), par);
+  std::vector<Particles> ensembles(1);
+  b->initial_conditions(&ensembles[0], par);
+  const DensityParameters dens_par(par);
+
+  // the lattice covers only part of the box without periodicity
+  for (const bool periodicity : {true, false}) {
+    const std::array<double, 3> l = {L, 0.6 * L, L};
+    const std::array<int, 3> n = {10, 9, 13};
+    const std::array<double, 3> origin = {0., 0.2 * L, 0.};
+    DensityLattice smeared(l, n, origin, periodicity,
+                           LatticeUpdate::EveryTimestep);
+    DensityLattice gathered(l, n, origin, periodicity,
+                            LatticeUpdate::EveryTimestep);
+    update_lattice(&smeared, LatticeUpdate::EveryTimestep, DensityType::Baryon,
+                   dens_par, ensembles, true);
+    gather_gaussian_currents(&gathered, DensityType::Baryon, dens_par,
+                             ensembles, true);
+    for (std::size_t i = 0; i < smeared.size(); i++) {
+      for (int mu = 0; mu < 4; mu++) {
+        COMPARE_ABSOLUTE_ERROR(gathered[i].jmu_net()[mu],
+                               smeared[i].jmu_net()[mu], 1e-12)
+            << i;
+        for (int nu = 0; nu < 4; nu++) {
+          COMPARE_ABSOLUTE_ERROR(gathered[i].djmu_dxnu()[nu][mu],
+                                 smeared[i].djmu_dxnu()[nu][mu], 1e-12)
+              << i;
+        }
+      }
+      COMPARE_ABSOLUTE_ERROR(gathered[i].rho(), smeared[i].rho(), 1e-12) << i;
+    }
+  }
+}
+
+TEST(single_precision_nodes_match_double) {
+  const double L = 10.;
+  Configuration conf{R"(
+    Box:
+      Initial_Condition: "thermal momenta"
+      Temperature: 0.2
+      Start_Time: 0.0
+  )"};
+  conf.set_value({"Box", "Init_Multiplicities", "2212"}, 200);
+  conf.set_value({"Box", "Init_Multiplicities", "-2212"}, 50);
+  conf.set_value({"Box", "Length"}, L);
+  ExperimentParameters par = smash::Test::default_parameters();
+  par.box_length = L;
+  par.derivatives_mode = DerivativesMode::CovariantGaussian;
+  std::unique_ptr<BoxModus> b =
+      std::make_unique<BoxModus>(std::move(conf), par);
+  std::vector<Particles> ensembles(1);
+  b->initial_conditions(&ensembles[0], par);
+  const DensityParameters dens_par(par);
+
+  COMPARE(2 * sizeof(BasicDensityOnLattice<float>),
+          sizeof(BasicDensityOnLattice<double>));
+  const std::array<double, 3> l = {L, L, L};
+  const std::array<int, 3> n = {10, 9, 13};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  RectangularLattice<BasicDensityOnLattice<double>> reference(
+      l, n, origin, true, LatticeUpdate::EveryTimestep);
+  RectangularLattice<BasicDensityOnLattice<float>> compact(
+      l, n, origin, true, LatticeUpdate::EveryTimestep);
+  update_lattice(&reference, LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, ensembles, true);
+  update_lattice(&compact, LatticeUpdate::EveryTimestep, DensityType::Baryon,
+                 dens_par, ensembles, true);
+  // every stored value is rounded once from the sum in double precision
+  const double precision = 2 * std::numeric_limits<float>::epsilon();
+  double max_j0 = 0.;
+  for (std::size_t i = 0; i < reference.size(); i++) {
+    max_j0 = std::max(max_j0, std::abs(reference[i].jmu_net().x0()));
+  }
+  VERIFY(max_j0 > 0.);
+  for (std::size_t i = 0; i < reference.size(); i++) {
+    const FourVector jmu = reference[i].jmu_net();
+    const std::array<FourVector, 4> djmu_dxnu = reference[i].djmu_dxnu();
+    for (int mu = 0; mu < 4; mu++) {
+      COMPARE_ABSOLUTE_ERROR(compact[i].jmu_net()[mu], jmu[mu],
+                             precision * max_j0)
+          << i;
+      for (int nu = 0; nu < 4; nu++) {
+        COMPARE_ABSOLUTE_ERROR(compact[i].djmu_dxnu()[nu][mu],
+                               djmu_dxnu[nu][mu],
+                               precision * std::abs(djmu_dxnu[nu][mu]) + 1e-12)
+            << i;
+      }
+    }
+  }
+}
+
+TEST(finite_difference_derivatives_in_one_sweep) {
+  const double L = 10.;
+  Configuration conf{R"(
+    Box:
+      Initial_Condition: "thermal momenta"
+      Temperature: 0.2
+      Start_Time: 0.0
+  )"};
+  conf.set_value({"Box", "Init_Multiplicities", "2212"}, 100);
+  conf.set_value({"Box", "Length"}, L);
+  ExperimentParameters par = smash::Test::default_parameters();
+  par.box_length = L;
+  par.derivatives_mode = DerivativesMode::FiniteDifference;
+  par.rho_derivatives_mode = RestFrameDensityDerivativesMode::On;
+  std::unique_ptr<BoxModus> b =
+      std::make_unique<BoxModus>(std::move(conf), par);
+  std::vector<Particles> ensembles(1);
+  b->initial_conditions(&ensembles[0], par);
+  const DensityParameters dens_par(par);
+  const double dt = 0.1;
+
+  for (const bool periodicity : {true, false}) {
+    const std::array<double, 3> l = {L, L, L};
+    const std::array<int, 3> n = {10, 12, 14};
+    const std::array<double, 3> origin = {0., 0., 0.};
+    DensityLattice lat(l, n, origin, periodicity,
+                       LatticeUpdate::EveryTimestep);
+    RectangularLattice<FourVector> old_jmu(l, n, origin, periodicity,
+                                           LatticeUpdate::EveryTimestep);
+    // the currents at t0, before the particles moved
+    update_lattice(&lat, LatticeUpdate::EveryTimestep, DensityType::Baryon,
+                   dens_par, ensembles, false);
+    RectangularLattice<FourVector> expected_old(l, n, origin, periodicity,
+                                                LatticeUpdate::EveryTimestep);
+    for (std::size_t i = 0; i < lat.size(); i++) {
+      expected_old[i] = lat[i].jmu_net();
+    }
+    for (ParticleData &data : ensembles[0]) {
+      data.set_4position(data.position() +
+                         FourVector(dt, data.momentum().velocity() * dt));
+    }
+    update_lattice(&lat, &old_jmu, LatticeUpdate::EveryTimestep,
+                   DensityType::Baryon, dens_par, ensembles, dt, true);
+
+    // the same in separate passes over auxiliary lattices
+    RectangularLattice<FourVector> expected_new(l, n, origin, periodicity,
+                                                LatticeUpdate::EveryTimestep);
+    for (std::size_t i = 0; i < lat.size(); i++) {
+      expected_new[i] = lat[i].jmu_net();
+    }
+    RectangularLattice<std::array<FourVector, 4>> expected_grad(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    expected_new.compute_four_gradient_lattice(expected_old, dt,
+                                               expected_grad);
+    for (std::size_t i = 0; i < lat.size(); i++) {
+      const std::array<FourVector, 4> djmu_dxnu = lat[i].djmu_dxnu();
+      for (int k = 0; k < 4; k++) {
+        COMPARE(djmu_dxnu[k], expected_grad[i][k]) << i;
+      }
+      // rest frame derivatives from the substituted current derivatives
+      DensityOnLattice node = lat[i];
+      double rho = node.rho();
+      if (std::abs(rho) < very_small_double) {
+        rho = (rho > 0 ? 1 : -1) * very_small_double;
+      }
+      const FourVector jmu = node.jmu_net();
+      const double drho_dx = jmu.Dot(expected_grad[i][1]) / rho;
+      COMPARE_RELATIVE_ERROR(node.drho_dxnu().x1(), drho_dx, 1.e-12) << i;
+    }
+  }
+}
+
+TEST(occupation_tracking_keeps_densities) {
+  Configuration conf{R"(
+    Box:
+      Initial_Condition: "thermal momenta"
+      Temperature: 0.2
+      Start_Time: 0.0
+  )"};
+  conf.set_value({"Box", "Init_Multiplicities", "2212"}, 50);
+  conf.set_value({"Box", "Length"}, 5.);
+  ExperimentParameters par = smash::Test::default_parameters();
+  par.derivatives_mode = DerivativesMode::CovariantGaussian;
+  par.rho_derivatives_mode = RestFrameDensityDerivativesMode::On;
+  std::unique_ptr<BoxModus> b =
+      std::make_unique<BoxModus>(std::move(conf), par);
+  std::vector<Particles> ensembles(1);
+  b->initial_conditions(&ensembles[0], par);
+  const DensityParameters dens_par(par);
+
+  // the particles fill only a corner of the lattice
+  for (const bool periodicity : {true, false}) {
+    const std::array<double, 3> l = {30., 30., 30.};
+    const std::array<int, 3> n = {30, 30, 30};
+    const std::array<double, 3> origin = {-2., -2., -2.};
+    DensityLattice lat(l, n, origin, periodicity,
+                       LatticeUpdate::EveryTimestep);
+    DensityLattice tracked(l, n, origin, periodicity,
+                           LatticeUpdate::EveryTimestep);
+    tracked.track_occupation();
+    // the second update has to clear what the first one left behind
+    for (const double shift : {0., 4.}) {
+      for (ParticleData &data : ensembles[0]) {
+        data.set_4position(data.position() + FourVector(0., shift, 0., 0.));
+      }
+      update_lattice(&lat, LatticeUpdate::EveryTimestep, DensityType::Baryon,
+                     dens_par, ensembles, true);
+      update_lattice(&tracked, LatticeUpdate::EveryTimestep,
+                     DensityType::Baryon, dens_par, ensembles, true);
+      for (std::size_t i = 0; i < lat.size(); i++) {
+        COMPARE(tracked[i].jmu_net(), lat[i].jmu_net()) << i;
+        COMPARE(tracked[i].drho_dxnu(), lat[i].drho_dxnu()) << i;
+      }
+    }
+  }
+}
+
+TEST(smearing_kernel_matches_smearing_factor) {
+  const ExperimentParameters exp_par = smash::Test::default_parameters();
+  const DensityParameters par(exp_par);
+  const std::array<double, 3> l = {10., 10., 10.};
+  const std::array<int, 3> n = {50, 50, 50};
+  const std::array<double, 3> origin = {-5., -5., -5.};
+  DensityLattice lat(l, n, origin, true, LatticeUpdate::EveryTimestep);
+  const ThreeVector pos(0.13, -0.27, 4.91);
+  // at rest and strongly boosted in a direction with a component along x
+  for (const FourVector &p : {FourVector(0.938, 0., 0., 0.),
+                              FourVector(5.0, 2.1, -1.3, 4.0)}) {
+    const double m_inv = 1.0 / p.abs();
+    GaussianSmearingKernel kernel(p, m_inv, par, lat.cell_sizes()[0]);
+    int n_inside = 0;
+    auto check_node = [&](DensityOnLattice &, int ix, int iy, int iz) {
+      const ThreeVector r = pos - lat.cell_center(ix, iy, iz);
+      const auto expected =
+          unnormalized_smearing_factor(r, p, m_inv, par, true);
+      const auto sf = kernel(r, ix, iy, iz, true);
+      if (expected.first == 0.) {
+        COMPARE(sf.first, 0.);
+        return;
+      }
+      n_inside++;
+      COMPARE_RELATIVE_ERROR(sf.first, expected.first, 1.e-12);
+      for (int i = 0; i < 3; i++) {
+        COMPARE_ABSOLUTE_ERROR(sf.second[i], expected.second[i],
+                               1.e-12 * expected.second.abs());
+      }
+    };
+    lat.iterate_in_cube(pos, par.r_cut(), check_node);
+    VERIFY(n_inside > 100);
+  }
+}
+
 TEST(smearing_factor_rcut_correction) {
   FUZZY_COMPARE(smearing_factor_rcut_correction(3.0), 0.97070911346511177);
   FUZZY_COMPARE(smearing_factor_rcut_correction(4.0), 0.99886601571021467);
@@ -0,0 +1,101 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/digestoutput.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "setup.h"
+#include "smash/decayaction.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+/**
+ * Run an event with two ensembles through a digest output in \p directory,
+ * with a different final momentum in the second ensemble if \p modify is
+ * set.
+ */
+static std::optional<int> run_event(const std::filesystem::path &directory,
+                                    const std::string &reference,
+                                    bool modify) {
+  std::filesystem::create_directories(directory);
+  OutputParameters out_par = OutputParameters();
+  out_par.digest_parameters.reference = reference;
+  DigestOutput output(directory, "Digest", out_par);
+  std::vector<Particles> ensembles(2);
+  for (Particles &particles : ensembles) {
+    particles.insert(Test::smashon(Test::Momentum(0.5, 0.1, 0.2, 0.3),
+                                   Test::Position(0., 1., 2., 3.)));
+    particles.insert(Test::smashon(Test::Momentum(0.6, -0.1, 0.2, 0.),
+                                   Test::Position(0., -1., 0., 1.)));
+  }
+  output.at_eventstart(ensembles, 0);
+  for (int i_ens = 0; i_ens < 2; i_ens++) {
+    const DecayAction action(ensembles[i_ens].front(), 0.5);
+    output.at_ensemble_interaction(action, 0., i_ens);
+  }
+  if (modify) {
+    ParticleData &particle = ensembles[1].front();
+    particle.set_4momentum(Test::smashon_mass, 0.1, 0.2, 0.30000001);
+  }
+  EventInfo info = Test::default_event_info();
+  info.n_ensembles = 2;
+  for (int i_ens = 0; i_ens < 2; i_ens++) {
+    output.at_eventend(ensembles[i_ens], i_ens, info);
+  }
+  return output.first_divergence();
+}
+
+TEST(compare_with_reference) {
+  const std::filesystem::path reference_dir = testoutputpath / "reference";
+  const std::filesystem::path reference_file = reference_dir / "digest.dat";
+  VERIFY(!run_event(reference_dir, "", false));
+  {
+    std::ifstream file(reference_file);
+    const std::string content(std::istreambuf_iterator<char>(file), {});
+    // The ensembles are identical, and so are their digests.
+    const std::size_t first = content.find("\n0 2 1 ");
+    const std::size_t second = content.find("\n1 2 1 ");
+    VERIFY(first != std::string::npos);
+    VERIFY(second != std::string::npos);
+    COMPARE(content.substr(first + 7, 129), content.substr(second + 7, 129));
+  }
+  const std::filesystem::path compared_dir = testoutputpath / "compared";
+  VERIFY(!run_event(compared_dir, reference_file.string(), false));
+  const std::optional<int> divergence =
+      run_event(compared_dir, reference_file.string(), true);
+  VERIFY(divergence.has_value());
+  COMPARE(*divergence, 1);
+  std::filesystem::remove_all(reference_dir);
+  std::filesystem::remove_all(compared_dir);
+}
+
+TEST_CATCH(missing_reference, std::runtime_error) {
+  OutputParameters out_par = OutputParameters();
+  out_par.digest_parameters.reference =
+      (testoutputpath / "no_digest.dat").string();
+  DigestOutput output(testoutputpath, "Digest", out_par);
+}
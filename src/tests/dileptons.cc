@@ -7,7 +7,10 @@
 
 #include "vir/test.h"  // This include has to be first
 
+#include <filesystem>
+
 #include "setup.h"
+#include "smash/analysisoutput.h"
 #include "smash/decayactiondilepton.h"
 
 using namespace smash;
@@ -108,3 +111,48 @@ TEST(eta_decay) {
   // (to an accuracy of five percent)
   COMPARE_RELATIVE_ERROR(weight_sum / N_samples, 0.0069, 0.05);
 }
+
+TEST(dalitz_decay_histograms) {
+  const std::filesystem::path testoutputpath =
+      std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+  std::filesystem::create_directories(testoutputpath);
+  const ParticleType &type_piz = ParticleType::find(0x111);
+  ParticleData piz{type_piz};
+  piz.set_4momentum(type_piz.mass(), ThreeVector(0., 0., 0.));
+  DecayBranchList dil_modes = type_piz.get_partial_widths(
+      piz.momentum(), piz.position().threevec(), WhichDecaymodes::Dileptons);
+  const double piz_width =
+      total_weight<DecayBranch>(type_piz.get_partial_widths(
+          piz.momentum(), piz.position().threevec(), WhichDecaymodes::All));
+  const auto act = std::make_unique<DecayActionDilepton>(
+      piz, 0., dil_modes[0]->weight() / piz_width);
+  act->add_decay(std::move(dil_modes[0]));
+
+  OutputParameters out_par = OutputParameters();
+  // All dileptons of a π⁰ fall into these bins.
+  out_par.dil_histograms.mass_bins = {0., 0.14, 14.};
+  const std::vector<Particles> ensembles(2);
+  constexpr int n_events = 10;
+  double weight_sum = 0.;
+  {
+    EmissionHistogramOutput output(testoutputpath, "Dileptons", out_par);
+    for (int event = 0; event < n_events; event++) {
+      for (int i = 0; i < 100; i++) {
+        act->generate_final_state();
+        weight_sum += act->get_total_weight();
+        output.at_interaction(*act, 0.);
+      }
+      output.at_eventend(ensembles, event);
+    }
+    COMPARE(output.n_events(), 2u * n_events);
+    COMPARE(output.channels().size(), 1u);
+    COMPARE(output.channels().begin()->first, type_piz.name());
+    const EventHistogram &mass = output.total().mass;
+    double histogrammed = 0.;
+    for (std::size_t i = 0; i < mass.n_bins(); i++) {
+      histogrammed += n_events * mass.mean(i, n_events);
+    }
+    COMPARE_RELATIVE_ERROR(histogrammed, weight_sum, 1e-12);
+  }
+  VERIFY(std::filesystem::remove(testoutputpath / "Dileptons_histograms.dat"));
+}
@@ -171,3 +171,34 @@ TEST(Landau_frame_values) {
   FUZZY_COMPARE(TL[8], 10.787129594442447275);
   FUZZY_COMPARE(TL[9], 39.94209073898776673);
 }
+
+TEST(Landau_frame_boosted_particles) {
+  /* Strongly boosted particles converge slowly in the iteration, and the
+     normalization of the nearly light-like eigenvector loses precision. */
+  const double m = 0.138;
+  const ThreeVector p(0.3, -0.2, 40.0);
+  const FourVector p1(std::sqrt(m * m + p.sqr()), p);
+  EnergyMomentumTensor T1;
+  T1.add_particle(p1);
+  const FourVector u1 = T1.landau_frame_4velocity();
+  COMPARE_RELATIVE_ERROR(u1[0], p1[0] / m, 1.e-6);
+  for (size_t i = 1; i < 4; i++) {
+    COMPARE_RELATIVE_ERROR(u1[i], -p1[i] / m, 1.e-6);
+  }
+
+  EnergyMomentumTensor T2;
+  T2.add_particle(FourVector(std::sqrt(m * m + 25.0), 0.0, 0.0, 5.0));
+  T2.add_particle(FourVector(std::sqrt(m * m + 24.0), 0.0, 1.0, 4.8));
+  EnergyMomentumTensor T2L = T2.boosted(T2.landau_frame_4velocity());
+  for (size_t i = 1; i < 4; i++) {
+    COMPARE_ABSOLUTE_ERROR(T2L[i], 0.0, 1.e-12) << T2L[i];
+  }
+}
+
+TEST(Landau_frame_massless_particle) {
+  // The Landau frame is not defined, the rest frame is returned.
+  EnergyMomentumTensor T;
+  T.add_particle(FourVector(1.0, 0.0, 0.6, 0.8));
+  const FourVector u = T.landau_frame_4velocity();
+  COMPARE(u, FourVector(1.0, 0.0, 0.0, 0.0));
+}
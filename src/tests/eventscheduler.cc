@@ -0,0 +1,89 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/eventscheduler.h"
+
+#include <thread>
+#include <vector>
+
+using namespace smash;
+
+TEST(fixed_number) {
+  LocalEventScheduler scheduler;
+  scheduler.start({EventCounting::FixedNumber, 3, 0, 0});
+  // Limits given by later experiments are ignored
+  scheduler.start({EventCounting::FixedNumber, 10, 0, 0});
+  COMPARE(scheduler.next_event(0), 0);
+  COMPARE(scheduler.next_event(0), 1);
+  COMPARE(scheduler.next_event(4), 2);
+  COMPARE(scheduler.next_event(0), -1);
+  COMPARE(scheduler.next_event(0), -1);
+}
+
+TEST(minimum_nonempty_ensembles) {
+  LocalEventScheduler scheduler;
+  scheduler.start({EventCounting::MinimumNonEmpty, 0, 5, 100});
+  COMPARE(scheduler.next_event(0), 0);
+  COMPARE(scheduler.next_event(0), 1);
+  // Counted over all events, no matter which experiment simulated them
+  COMPARE(scheduler.next_event(3), 2);
+  COMPARE(scheduler.next_event(1), 3);
+  COMPARE(scheduler.next_event(1), -1);
+}
+
+TEST(maximum_events) {
+  LocalEventScheduler scheduler;
+  scheduler.start({EventCounting::MinimumNonEmpty, 0, 5, 2});
+  COMPARE(scheduler.next_event(0), 0);
+  COMPARE(scheduler.next_event(0), 1);
+  COMPARE(scheduler.next_event(0), -1);
+  COMPARE(scheduler.next_event(0), -1);
+}
+
+TEST(single_event) {
+  SingleEventScheduler scheduler(83512);
+  scheduler.start({EventCounting::FixedNumber, 10, 0, 0});
+  COMPARE(scheduler.next_event(0), 83512);
+  COMPARE(scheduler.next_event(1), -1);
+  COMPARE(scheduler.next_event(0), -1);
+}
+
+TEST(concurrent_experiments) {
+  const int n_events = 1000;
+  LocalEventScheduler scheduler;
+  std::vector<std::vector<int>> events(4);
+  std::vector<std::thread> threads;
+  for (std::vector<int> &list : events) {
+    threads.emplace_back([&scheduler, &list]() {
+      scheduler.start({EventCounting::FixedNumber, n_events, 0, 0});
+      for (int event = scheduler.next_event(0); event >= 0;
+           event = scheduler.next_event(0)) {
+        list.push_back(event);
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  // Every event is handed out exactly once and in increasing order
+  std::vector<int> handed_out(n_events, 0);
+  for (const std::vector<int> &list : events) {
+    for (std::size_t i = 0; i < list.size(); i++) {
+      handed_out[list[i]]++;
+      if (i > 0) {
+        VERIFY(list[i] > list[i - 1]);
+      }
+    }
+  }
+  for (int count : handed_out) {
+    COMPARE(count, 1);
+  }
+}
@@ -10,9 +10,14 @@
 #include "vir/test.h"  // This include has to be first
 
 #include <filesystem>
+#include <map>
+#include <set>
+#include <string>
 
 #include "setup.h"
+#include "smash/boxmodus.h"
 #include "smash/collidermodus.h"
+#include "smash/library.h"
 
 using namespace smash;
 
@@ -127,6 +132,197 @@ TEST_CATCH(run_experiment_beyond_end_time, std::logic_error) {
   exp->run_time_evolution(1000);
 }
 
+static std::vector<ParticleList> evolve_box_with_ensemble_threads(
+    int threads) {
+  auto config = get_common_configuration();
+  config.set_value({"General", "Modus"}, "Box");
+  config.merge_yaml(R"(
+    Modi:
+      Box:
+        Initial_Condition: "thermal momenta"
+        Length: 5.0
+        Temperature: 0.2
+        Start_Time: 0.0
+        Init_Multiplicities:
+          2212: 50
+          2112: 50
+  )");
+  config.set_value({"General", "Ensembles"}, 4);
+  config.set_value({"General", "Ensemble_Threads"}, threads);
+  auto exp = std::make_unique<Experiment<BoxModus>>(config, ".");
+  exp->initialize_new_event();
+  exp->run_time_evolution(2.0);
+  std::vector<ParticleList> ensembles;
+  for (const Particles &particles : *exp->all_ensembles()) {
+    ensembles.push_back(particles.copy_to_vector());
+  }
+  return ensembles;
+}
+
+TEST(ensemble_threads_are_reproducible) {
+  const auto first = evolve_box_with_ensemble_threads(2);
+  const auto second = evolve_box_with_ensemble_threads(3);
+  COMPARE(first.size(), 4u);
+  COMPARE(second.size(), 4u);
+  for (std::size_t i_ens = 0; i_ens < first.size(); i_ens++) {
+    const ParticleList &particles_1 = first[i_ens];
+    const ParticleList &particles_2 = second[i_ens];
+    COMPARE(particles_1.size(), particles_2.size());
+    for (std::size_t i = 0; i < particles_1.size(); i++) {
+      COMPARE(particles_1[i].pdgcode(), particles_2[i].pdgcode());
+      COMPARE(particles_1[i].momentum(), particles_2[i].momentum());
+      COMPARE(particles_1[i].position(), particles_2[i].position());
+    }
+  }
+}
+
+TEST(box_without_wall_crossing_actions) {
+  auto config = get_common_configuration();
+  config.set_value({"General", "Modus"}, "Box");
+  config.merge_yaml(R"(
+    Modi:
+      Box:
+        Initial_Condition: "thermal momenta"
+        Length: 5.0
+        Temperature: 0.2
+        Start_Time: 0.0
+        Wall_Crossing_Actions: false
+        Init_Multiplicities:
+          2212: 50
+          2112: 50
+  )");
+  auto exp = std::make_unique<Experiment<BoxModus>>(config, ".");
+  exp->initialize_new_event();
+  exp->run_time_evolution(5.0);
+  const Particles &particles = *exp->first_ensemble();
+  VERIFY(particles.size() > 0u);
+  for (const ParticleData &p : particles) {
+    for (int i = 1; i < 4; i++) {
+      VERIFY(p.position()[i] >= 0.0) << p;
+      VERIFY(p.position()[i] < 5.0) << p;
+    }
+  }
+}
+
+TEST(collider_with_adaptive_time_step) {
+  auto config = get_collider_configuration();
+  config.merge_yaml(R"(
+    General:
+      Time_Step_Mode: Adaptive
+      Delta_Time: 0.1
+      Adaptive_Time_Step:
+        Minimum_Delta_Time: 0.05
+        Maximum_Delta_Time: 2.0
+  )");
+  auto exp = std::make_unique<Experiment<ColliderModus>>(config, ".");
+  exp->initialize_new_event();
+  exp->run_time_evolution(20.1);
+  VERIFY(exp->first_ensemble()->size() > 0u);
+}
+
+TEST_CATCH(adaptive_time_step_outside_of_bounds, std::invalid_argument) {
+  auto config = get_collider_configuration();
+  config.merge_yaml(R"(
+    General:
+      Time_Step_Mode: Adaptive
+      Delta_Time: 1.0
+      Adaptive_Time_Step:
+        Maximum_Delta_Time: 0.5
+  )");
+  Test::experiment(std::move(config));
+}
+
+TEST(collider_with_freeze_out_detection) {
+  auto config = get_collider_configuration();
+  config.set_value({"Modi", "Collider", "Freeze_Out_Rate"}, 0.01);
+  auto exp = std::make_unique<Experiment<ColliderModus>>(config, ".");
+  exp->initialize_new_event();
+  exp->run_time_evolution(20.1);
+  exp->do_final_decays();
+  const Particles &particles = *exp->first_ensemble();
+  VERIFY(particles.size() > 0u);
+  for (const ParticleData &p : particles) {
+    VERIFY(p.type().is_stable()) << p;
+  }
+}
+
+TEST_CATCH(freeze_out_detection_without_final_decays, std::invalid_argument) {
+  auto config = get_collider_configuration();
+  config.set_value({"Modi", "Collider", "Freeze_Out_Rate"}, 0.01);
+  config.set_value({"Collision_Term", "Force_Decays_At_End"}, false);
+  Test::experiment(std::move(config));
+}
+
+TEST(ensemble_threads_with_strings) {
+  auto config = get_collider_configuration();
+  config.set_value({"General", "Ensembles"}, 2);
+  config.set_value({"General", "Ensemble_Threads"}, 2);
+  VERIFY(!!Test::experiment(std::move(config)));
+}
+
+TEST_CATCH(ensemble_threads_with_pauli_blocking, std::invalid_argument) {
+  auto config = get_collider_configuration();
+  config.set_value({"General", "Ensembles"}, 2);
+  config.set_value({"General", "Ensemble_Threads"}, 2);
+  config.merge_yaml(R"(
+    Collision_Term:
+      Pauli_Blocking:
+        Spatial_Averaging_Radius: 1.86
+  )");
+  Test::experiment(std::move(config));
+}
+
+TEST_CATCH(share_events_without_fixed_number, std::invalid_argument) {
+  auto config = get_collider_configuration();
+  config.take({"General", "Nevents"});
+  config.merge_yaml(R"(
+    General:
+      Minimum_Nonempty_Ensembles:
+        Number: 2
+        Maximum_Ensembles_Run: 4
+  )");
+  auto exp = std::make_unique<Experiment<ColliderModus>>(config, ".");
+  exp->run(0, 2);
+}
+
+TEST(event_stream_yields_events) {
+  auto config = get_common_configuration();
+  config.set_value({"General", "Modus"}, "Box");
+  config.set_value({"General", "End_Time"}, 1.0);
+  config.set_value({"General", "Nevents"}, 3);
+  config.merge_yaml(R"(
+    Modi:
+      Box:
+        Initial_Condition: "thermal momenta"
+        Length: 5.0
+        Temperature: 0.2
+        Start_Time: 0.0
+        Init_Multiplicities:
+          2212: 50
+          2112: 50
+    Output:
+      Collisions:
+        Format: ["Oscar2013"]
+  )");
+  EventStream stream(config, true, 1, 2);
+  std::vector<int> numbers;
+  for (const StreamedEvent &event : stream) {
+    numbers.push_back(event.number);
+    VERIFY(event.ensembles != nullptr);
+    COMPARE(event.ensembles->size(), 1u);
+    VERIFY((*event.ensembles)[0].size() > 0);
+    COMPARE(event.info.size(), 1u);
+    FUZZY_COMPARE(event.info[0].current_time, 1.0);
+    VERIFY(!event.history.empty());
+    for (const StreamedInteraction &interaction : event.history) {
+      COMPARE(interaction.ensemble, 0);
+      VERIFY(interaction.time <= 1.0);
+    }
+  }
+  COMPARE(numbers, std::vector<int>{1});
+  VERIFY(!stream.next());
+}
+
 TEST(access_particles) {
   auto config = get_collider_configuration();
   auto exp = std::make_unique<Experiment<ColliderModus>>(config, ".");
@@ -207,3 +403,31 @@ TEST_CATCH(remove_particle_twice, std::logic_error) {
   // Try to remove the eta twice
   exp->run_time_evolution(1., ParticleList{}, ParticleList{eta, eta});
 }
+
+TEST(action_cost_report) {
+  std::map<ProcessType, ActionCost> costs;
+  costs[ProcessType::Elastic] += ActionCost{1000, 10, 1e-5};
+  costs[ProcessType::StringSoftNonDiffractive] += ActionCost{10, 1, 1e-3};
+  costs[ProcessType::Decay] += ActionCost{5, 0, 0.};
+  const std::string report = action_cost_report(costs);
+  // The strings took 1e-2 s in total, the elastic collisions 1e-3 s
+  VERIFY(report.find("Soft String Excitation (45)") <
+         report.find("Elastic (1)"))
+      << report;
+  VERIFY(report.find("Decay (5)") != std::string::npos) << report;
+}
+
+TEST(seed_of_event) {
+  // The first event uses the seed of the run
+  COMPARE(seed_of_event(42, 0), 42);
+  std::set<int64_t> seeds;
+  for (int event = 0; event < 1000; event++) {
+    const int64_t seed = seed_of_event(42, event);
+    VERIFY(seed >= 0);
+    seeds.insert(seed);
+  }
+  COMPARE(seeds.size(), 1000u);
+  // Only the run seed and the event number matter
+  COMPARE(seed_of_event(42, 83512), seed_of_event(42, 83512));
+  VERIFY(seed_of_event(42, 83512) != seed_of_event(43, 83512));
+}
@@ -0,0 +1,122 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/filteredoutput.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "setup.h"
+#include "smash/clock.h"
+
+using namespace smash;
+
+TEST(init_particletypes) { Test::create_actual_particletypes(); }
+
+namespace {
+/// Output that records the particle lists it receives.
+class RecordingOutput : public OutputInterface {
+ public:
+  RecordingOutput() : OutputInterface("Particles") {}
+
+  void at_eventstart(const Particles &particles, const int,
+                     const EventInfo &) override {
+    record("start", particles);
+  }
+  void at_eventend(const Particles &particles, const int,
+                   const EventInfo &) override {
+    record("end", particles);
+  }
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &,
+                            const DensityParameters &,
+                            const EventInfo &) override {
+    record("intermediate", particles);
+  }
+
+  /// Calls with the number and ids of the particles
+  std::vector<std::string> calls;
+
+ private:
+  void record(std::string call, const Particles &particles) {
+    call += " " + std::to_string(particles.size()) + ":";
+    for (const ParticleData &p : particles) {
+      call += " " + std::to_string(p.id());
+    }
+    calls.push_back(call);
+  }
+};
+
+/**
+ * Particle with the given PDG code, transverse momentum along x and
+ * longitudinal momentum.
+ */
+ParticleData particle(PdgCode pdg, double pt, double pz) {
+  ParticleData p{ParticleType::find(pdg)};
+  p.set_4momentum(p.pole_mass(), pt, 0., pz);
+  return p;
+}
+}  // namespace
+
+TEST(filter_selects_particles) {
+  Particles particles;
+  particles.insert(particle(0x211, 0.3, 0.));    // id 0
+  particles.insert(particle(0x111, 0.3, 0.));    // id 1
+  particles.insert(particle(0x2212, 0.5, 20.));  // id 2, forward
+  particles.insert(particle(-0x211, 2.0, 0.1));  // id 3, hard
+  particles.insert(particle(0x2212, 0.2, 0.));   // id 4
+
+  ParticleOutputFilter filter;
+  VERIFY(!filter.is_active());
+  for (const ParticleData &p : particles) {
+    VERIFY(filter.accepts(p));
+  }
+
+  filter.charge = ParticleOutputFilter::Charge::Charged;
+  VERIFY(filter.is_active());
+  filter.rapidity_window = {-1., 1.};
+  filter.pt_window = {0., 1.};
+  auto recording = std::make_unique<RecordingOutput>();
+  RecordingOutput *recorder = recording.get();
+  FilteredOutput output(std::move(recording), filter);
+  const EventInfo info = Test::default_event_info();
+  output.at_eventstart(particles, 0, info);
+
+  // the selected particles keep their ids, also once the list changed
+  particles.remove(particles.front());
+  output.at_eventend(particles, 0, info);
+  COMPARE(recorder->calls.size(), 2u);
+  COMPARE(recorder->calls[0], "start 2: 0 4");
+  COMPARE(recorder->calls[1], "end 1: 4");
+
+  // the species are sorted when they are read from the configuration
+  filter = ParticleOutputFilter();
+  filter.species = {-211, 111};
+  recording = std::make_unique<RecordingOutput>();
+  recorder = recording.get();
+  FilteredOutput species(std::move(recording), filter);
+  const std::unique_ptr<Clock> clock =
+      std::make_unique<UniformClock>(0., 1., 10.);
+  const DensityParameters dens_par(Test::default_parameters());
+  species.at_intermediate_time(particles, clock, dens_par, info);
+  COMPARE(recorder->calls.size(), 1u);
+  COMPARE(recorder->calls[0], "intermediate 2: 1 3");
+}
+
+TEST(only_participants) {
+  ParticleOutputFilter filter;
+  filter.only_participants = true;
+  ParticleData p = particle(0x211, 0.3, 0.);
+  VERIFY(!filter.accepts(p));
+  p.set_history(1, 1, ProcessType::Elastic, 0., {});
+  VERIFY(filter.accepts(p));
+}
@@ -11,6 +11,8 @@
 
 #include "smash/grid.h"
 
+#include <algorithm>
+#include <iterator>
 #include <set>
 #include <unordered_set>
 
@@ -144,9 +146,10 @@ TEST(grid_construction) {
                {19, 23}, {20, 22}, {20, 23}, {21, 22}, {21, 24}, {21, 25},
                {22, 23}, {22, 24}, {22, 25}, {22, 26}, {23, 25}, {23, 26},
                {24, 25}, {25, 26}},
-              {{0}, {9},  {18}, {3}, {12}, {21}, {6}, {15}, {24},
-               {1}, {10}, {19}, {4}, {13}, {22}, {7}, {16}, {25},
-               {2}, {11}, {20}, {5}, {14}, {23}, {8}, {17}, {26}}},
+              // cells are visited in Morton (Z-curve) order
+              {{0},  {9},  {3},  {12}, {1},  {10}, {4},  {13}, {18},
+               {21}, {19}, {22}, {6},  {15}, {7},  {16}, {24}, {25},
+               {2},  {11}, {5},  {14}, {20}, {23}, {8},  {17}, {26}}},
          }) {
       Particles list;
       for (auto p : param.particles) {
@@ -469,3 +472,551 @@ TEST(max_positions_normal_grid) {
   Grid<GridOptions::Normal> grid2(list, testparticles, 1.0,
                                   CellNumberLimitation::None);
 }
+
+// Collects the ids and x positions of the particles in each searched cell
+template <GridOptions O>
+static std::vector<std::set<std::pair<int, double>>> cell_contents(
+    const Grid<O> &grid) {
+  std::vector<std::set<std::pair<int, double>>> contents;
+  grid.iterate_cells(
+      [&](const ParticleList &search) {
+        contents.emplace_back();
+        for (const ParticleData &p : search) {
+          contents.back().emplace(p.id(), p.position().x1());
+        }
+      },
+      [](const ParticleList &, const ParticleList &) {});
+  return contents;
+}
+
+TEST(update_periodic_grid) {
+  using Test::Momentum;
+  using Test::Position;
+  const double min_cell_length = minimal_cell_length(1);
+  constexpr double length = 10;
+  const auto min_and_length =
+      make_pair(std::array<double, 3>{0, 0, 0},
+                std::array<double, 3>{length, length, length});
+  Particles list;
+  for (int n = 0; n < 40; ++n) {
+    const double x = 0.24 * n;
+    list.insert(Test::smashon(Position{0., x, 9.9 - x, 0.5 * x},
+                              Momentum{Test::smashon_mass, {0., 0., 0.}}, n));
+  }
+  Grid<GridOptions::PeriodicBoundaries> grid(min_and_length, list,
+                                             min_cell_length, timestep,
+                                             CellNumberLimitation::None);
+
+  // move some particles into other cells, remove and add some
+  for (auto &p : list) {
+    if (p.id() % 3 == 0) {
+      p.set_4position(Position{0., 9.9 - p.position().x1(),
+                               p.position().x2(), p.position().x3()});
+    }
+  }
+  list.remove(list.front());
+  list.insert(Test::smashon(Position{0., 5., 5., 5.},
+                            Momentum{Test::smashon_mass, {0., 0., 0.}}, 100));
+
+  grid.update(min_and_length, list, min_cell_length, timestep,
+              CellNumberLimitation::None);
+  const Grid<GridOptions::PeriodicBoundaries> fresh(
+      min_and_length, list, min_cell_length, timestep,
+      CellNumberLimitation::None);
+  COMPARE(cell_contents(grid), cell_contents(fresh));
+}
+
+TEST(place_and_search_surroundings) {
+  using Test::Position;
+  constexpr double spacing = 1.25;
+  Particles list;
+  for (int n = 0; n < 1000; ++n) {
+    list.insert(Test::smashon(Position{0., spacing * (n % 10),
+                                       spacing * (n / 10 % 10),
+                                       spacing * (n / 100)}));
+  }
+  Grid<GridOptions::Normal> grid(list, minimal_cell_length(1), timestep,
+                                 CellNumberLimitation::None);
+  VERIFY(grid.binned());
+
+  auto surroundings = [&](const ThreeVector &position, double radius) {
+    std::multiset<int> ids;
+    grid.iterate_surroundings(position, radius, [&](const ParticleData &p) {
+      ids.insert(p.id());
+    });
+    return ids;
+  };
+
+  // all particles within the cube are found, each once
+  const ThreeVector center(4., 5., 6.);
+  constexpr double radius = 2.;
+  const std::multiset<int> found = surroundings(center, radius);
+  for (const ParticleData &p : list) {
+    const ThreeVector r = p.position().threevec() - center;
+    if (std::abs(r.x1()) <= radius && std::abs(r.x2()) <= radius &&
+        std::abs(r.x3()) <= radius) {
+      COMPARE(found.count(p.id()), 1u) << p;
+    }
+  }
+  VERIFY(found.size() < list.size());
+
+  // a moved particle is only found at its new position
+  ParticleData &moved = *list.begin();
+  moved.set_4position(Position{0., 9 * spacing, 9 * spacing, 9 * spacing});
+  grid.place(moved);
+  COMPARE(surroundings(ThreeVector(0., 0., 0.), 0.1).count(moved.id()), 0u);
+  COMPARE(surroundings(moved.position().threevec(), 0.1).count(moved.id()),
+          1u);
+
+  // a new particle outside of the grid is placed into the closest cell
+  const ParticleData &outside =
+      list.insert(Test::smashon(Position{0., -100., 5., 5.}));
+  grid.place(outside);
+  COMPARE(surroundings(ThreeVector(-100., 5., 5.), 1.).count(outside.id()),
+          1u);
+  COMPARE(surroundings(ThreeVector(0., 5., 5.), 0.1).count(outside.id()), 1u);
+}
+
+TEST(excluded_particles) {
+  using Test::Position;
+  constexpr double spacing = 1.25;
+  Particles list;
+  for (int n = 0; n < 1000; ++n) {
+    list.insert(Test::smashon(Position{0., spacing * (n % 10),
+                                       spacing * (n / 10 % 10),
+                                       spacing * (n / 100)}));
+  }
+  auto placed_ids = [](const Grid<GridOptions::Normal> &grid) {
+    std::set<int> ids;
+    grid.iterate_cells(
+        [&](const ParticleList &search) {
+          for (const ParticleData &p : search) {
+            ids.insert(p.id());
+          }
+        },
+        [](const ParticleList &, const ParticleList &) {});
+    return ids;
+  };
+  for (CellSizeStrategy strategy :
+       {CellSizeStrategy::Optimal, CellSizeStrategy::Largest}) {
+    Grid<GridOptions::Normal> grid(list, minimal_cell_length(1), timestep,
+                                   CellNumberLimitation::None, false, strategy);
+    COMPARE(placed_ids(grid).size(), list.size());
+    int excluded_below = 500;
+    grid.set_exclusion(
+        [&](const ParticleData &p) { return p.id() < excluded_below; });
+    grid.update(list, minimal_cell_length(1), timestep,
+                CellNumberLimitation::None, false, strategy);
+    std::set<int> ids = placed_ids(grid);
+    COMPARE(ids.size(), 500u);
+    COMPARE(*ids.begin(), 500);
+    // particles rejoin once they are not excluded anymore
+    excluded_below = 250;
+    grid.update(list, minimal_cell_length(1), timestep,
+                CellNumberLimitation::None, false, strategy);
+    ids = placed_ids(grid);
+    COMPARE(ids.size(), 750u);
+    COMPARE(*ids.begin(), 250);
+  }
+}
+
+/**
+ * All pairs of particle ids that the grid passes together to the callbacks
+ * of iterate_cells, the smaller id first.
+ */
+template <GridOptions O>
+static std::set<std::pair<int, int>> candidate_pairs(const Grid<O> &grid) {
+  std::set<std::pair<int, int>> pairs;
+  auto add = [&](const ParticleData &a, const ParticleData &b) {
+    pairs.emplace(std::min(a.id(), b.id()), std::max(a.id(), b.id()));
+  };
+  grid.iterate_cells(
+      [&](const ParticleList &search) {
+        for (std::size_t i = 0; i < search.size(); i++) {
+          for (std::size_t j = i + 1; j < search.size(); j++) {
+            add(search[i], search[j]);
+          }
+        }
+      },
+      [&](const ParticleList &search, const ParticleList &neighbors) {
+        for (const ParticleData &a : search) {
+          for (const ParticleData &b : neighbors) {
+            add(a, b);
+          }
+        }
+      });
+  return pairs;
+}
+
+TEST(layers) {
+  using Test::Position;
+  constexpr double spacing = 1.25;
+  constexpr int n_layers = 3;
+  Particles list;
+  for (int n = 0; n < 1000; ++n) {
+    list.insert(Test::smashon(Position{0., spacing * (n % 10),
+                                       spacing * (n / 10 % 10),
+                                       spacing * (n / 100)},
+                              n));
+  }
+  for (ParticleData &p : list) {
+    p.set_subensemble(p.id() % n_layers);
+  }
+  // The pairs of one layer are those of a grid without layers.
+  auto expected_pairs = [&](const std::set<std::pair<int, int>> &all) {
+    std::set<std::pair<int, int>> pairs;
+    std::copy_if(all.begin(), all.end(), std::inserter(pairs, pairs.end()),
+                 [&](const std::pair<int, int> &ids) {
+                   return ids.first % n_layers == ids.second % n_layers;
+                 });
+    return pairs;
+  };
+  for (CellSizeStrategy strategy :
+       {CellSizeStrategy::Optimal, CellSizeStrategy::Largest}) {
+    Grid<GridOptions::Normal> grid(list, minimal_cell_length(1), timestep,
+                                   CellNumberLimitation::None, false, strategy);
+    const auto all = candidate_pairs(grid);
+    grid.set_layers(n_layers);
+    grid.update(list, minimal_cell_length(1), timestep,
+                CellNumberLimitation::None, false, strategy);
+    const auto layered = candidate_pairs(grid);
+    VERIFY(!layered.empty());
+    COMPARE(layered, expected_pairs(all));
+  }
+
+  constexpr double length = 10 * spacing;
+  const auto min_and_length =
+      make_pair(std::array<double, 3>{0, 0, 0},
+                std::array<double, 3>{length, length, length});
+  Grid<GridOptions::PeriodicBoundaries> periodic(
+      min_and_length, list, minimal_cell_length(1), timestep,
+      CellNumberLimitation::None);
+  const auto all = candidate_pairs(periodic);
+  periodic.set_layers(n_layers);
+  periodic.update(min_and_length, list, minimal_cell_length(1), timestep,
+                  CellNumberLimitation::None);
+  COMPARE(candidate_pairs(periodic), expected_pairs(all));
+}
+
+TEST_CATCH(no_layers, std::invalid_argument) {
+  Particles list;
+  list.insert(Test::smashon());
+  Grid<GridOptions::Normal> grid(list, minimal_cell_length(1), timestep,
+                                 CellNumberLimitation::None);
+  grid.set_layers(0);
+}
+
+TEST(statistics) {
+  using Test::Position;
+  Particles list;
+  for (int n = 0; n < 1000; ++n) {
+    list.insert(Test::smashon(
+        Position{0., 1.25 * (n % 10), 1.25 * (n / 10 % 10), 1.25 * (n / 100)},
+        n));
+  }
+  Grid<GridOptions::Normal> grid(list, minimal_cell_length(1), timestep,
+                                 CellNumberLimitation::None);
+  GridStatistics stats = grid.statistics();
+  COMPARE(stats.cells, 64);
+  COMPARE(stats.layers, 1);
+  COMPARE(stats.particles, 1000);
+  COMPARE(stats.single_cell_pairs, 1000 * 999 / 2);
+  VERIFY(stats.binned);
+  COMPARE(stats.pair_candidates,
+          static_cast<std::int64_t>(candidate_pairs(grid).size()));
+  VERIFY(std::isinf(stats.max_cell_length));
+
+  grid.update(list, minimal_cell_length(1), timestep,
+              CellNumberLimitation::None, false, CellSizeStrategy::Largest);
+  stats = grid.statistics();
+  COMPARE(stats.cells, 1);
+  VERIFY(!stats.binned);
+  COMPARE(stats.pair_candidates, stats.single_cell_pairs);
+}
+
+TEST(beam_axis_slabs) {
+  using Test::Position;
+  // two thin nuclei far apart along the beam axis
+  Particles list;
+  for (int n = 0; n < 200; ++n) {
+    list.insert(Test::smashon(Position{0., 1.25 * (n % 10),
+                                       1.25 * (n / 10 % 10),
+                                       20. * (n / 100) + 0.01 * (n % 7)},
+                              n));
+  }
+  const double min_cell_length = minimal_cell_length(1);
+  Grid<GridOptions::Normal> grid(list, min_cell_length, timestep,
+                                 CellNumberLimitation::ParticleNumber);
+  GridStatistics stats = grid.statistics();
+  VERIFY(stats.binned);
+  // one slab per nucleus and one for the gap
+  COMPARE(stats.cells, 4 * 4 * 3);
+
+  // all pairs within one cell length are candidates, none across the gap
+  const auto pairs = candidate_pairs(grid);
+  for (const ParticleData &a : list) {
+    for (const ParticleData &b : list) {
+      const ThreeVector r = a.position().threevec() - b.position().threevec();
+      if (a.id() < b.id() && std::abs(r.x1()) < min_cell_length &&
+          std::abs(r.x2()) < min_cell_length &&
+          std::abs(r.x3()) < min_cell_length) {
+        COMPARE(pairs.count({a.id(), b.id()}), 1u) << a << b;
+      }
+    }
+  }
+  for (const auto &pair : pairs) {
+    COMPARE(pair.first / 100, pair.second / 100) << pair;
+  }
+
+  // a new particle between the nuclei is found where it is
+  const ParticleData &between =
+      list.insert(Test::smashon(Position{0., 5., 5., 10.}));
+  grid.place(between);
+  std::set<int> found;
+  grid.iterate_surroundings(ThreeVector(5., 5., 10.), 0.1,
+                            [&](const ParticleData &p) { found.insert(p.id()); });
+  COMPARE(found.count(between.id()), 1u);
+}
+
+/// Place the particles onto a grid as chosen by \p sizer and measure it.
+static void record_grid(AdaptiveCellSizer &sizer, const Particles &list) {
+  const double min_cell_length = minimal_cell_length(1);
+  Grid<GridOptions::Normal> grid(
+      list, sizer.cell_length(min_cell_length), timestep,
+      CellNumberLimitation::None, false, sizer.strategy());
+  sizer.record(grid.statistics(), min_cell_length);
+}
+
+TEST(adaptive_cell_sizer) {
+  using Test::Position;
+  // dense: the minimal cell length stays
+  Particles dense;
+  for (int n = 0; n < 1000; ++n) {
+    dense.insert(Test::smashon(
+        Position{0., 1.25 * (n % 10), 1.25 * (n / 10 % 10), 1.25 * (n / 100)},
+        n));
+  }
+  AdaptiveCellSizer dense_sizer;
+  record_grid(dense_sizer, dense);
+  COMPARE(dense_sizer.cell_length(1.), 1.);
+  COMPARE(dense_sizer.strategy(), CellSizeStrategy::Optimal);
+
+  // dilute: the largest cells without neighboring particles
+  Particles dilute;
+  for (int n = 0; n < 27; ++n) {
+    dilute.insert(Test::smashon(
+        Position{0., 20. * (n % 3), 20. * (n / 3 % 3), 20. * (n / 9)}, n));
+  }
+  AdaptiveCellSizer dilute_sizer;
+  record_grid(dilute_sizer, dilute);
+  COMPARE_RELATIVE_ERROR(dilute_sizer.cell_length(1.),
+                         AdaptiveCellSizer::max_scale, 1e-12);
+  COMPARE(dilute_sizer.strategy(), CellSizeStrategy::Optimal);
+  // the choice is kept
+  record_grid(dilute_sizer, dilute);
+  COMPARE_RELATIVE_ERROR(dilute_sizer.cell_length(1.),
+                         AdaptiveCellSizer::max_scale, 1e-12);
+
+  // a cluster in a large volume: a single cell
+  Particles cluster;
+  for (int n = 0; n < 8; ++n) {
+    cluster.insert(Test::smashon(
+        Position{0., 0.5 * (n % 2), 0.5 * (n / 2 % 2), 0.5 * (n / 4)}, n));
+  }
+  cluster.insert(Test::smashon(Position{0., 100., 100., 100.}, 8));
+  AdaptiveCellSizer cluster_sizer;
+  record_grid(cluster_sizer, cluster);
+  COMPARE(cluster_sizer.strategy(), CellSizeStrategy::Largest);
+  record_grid(cluster_sizer, cluster);
+  COMPARE(cluster_sizer.strategy(), CellSizeStrategy::Largest);
+}
+
+TEST(parallel_cell_iteration) {
+  using Test::Position;
+  constexpr int n_threads = 4;
+  Particles list;
+  for (int n = 0; n < 2000; ++n) {
+    // a deterministic but irregular distribution over roughly 8^3 cells
+    list.insert(Test::smashon(Position{0., 0.37 * (n * 37 % 97),
+                                       0.41 * (n * 53 % 89),
+                                       0.43 * (n * 71 % 83)},
+                              n));
+  }
+  for (ParticleData &p : list) {
+    p.set_subensemble(p.id() % 2);
+  }
+  Grid<GridOptions::Normal> grid(list, minimal_cell_length(1), timestep,
+                                 CellNumberLimitation::None);
+  grid.set_layers(2);
+  grid.update(list, minimal_cell_length(1), timestep,
+              CellNumberLimitation::None);
+  const auto expected = candidate_pairs(grid);
+
+  // Every pair has to be passed exactly once, to any of the threads.
+  std::vector<std::multiset<std::pair<int, int>>> found(n_threads);
+  // The neighbors of a search cell follow it on the same thread.
+  std::vector<const ParticleList *> last_search(n_threads, nullptr);
+  auto add = [&](int i_thread, const ParticleData &a, const ParticleData &b) {
+    found[i_thread].emplace(std::min(a.id(), b.id()),
+                            std::max(a.id(), b.id()));
+  };
+  grid.iterate_cells_in_parallel(
+      n_threads,
+      [&](int i_thread, const ParticleList &search) {
+        last_search[i_thread] = &search;
+        for (std::size_t i = 0; i < search.size(); i++) {
+          for (std::size_t j = i + 1; j < search.size(); j++) {
+            add(i_thread, search[i], search[j]);
+          }
+        }
+      },
+      [&](int i_thread, const ParticleList &search,
+          const ParticleList &neighbors) {
+        COMPARE(&search, last_search[i_thread]);
+        for (const ParticleData &a : search) {
+          for (const ParticleData &b : neighbors) {
+            add(i_thread, a, b);
+          }
+        }
+      });
+  std::multiset<std::pair<int, int>> all;
+  for (const auto &pairs : found) {
+    all.insert(pairs.begin(), pairs.end());
+  }
+  COMPARE(all.size(), expected.size());
+  const std::set<std::pair<int, int>> unique(all.begin(), all.end());
+  COMPARE(unique, expected);
+}
+
+TEST(parallel_cell_iteration_periodic) {
+  using Test::Position;
+  constexpr int n_threads = 4;
+  const double cell_length = 1.05 * minimal_cell_length(1);
+  // Numbers of cells with all remainders modulo 3, and the minimal 2 cells
+  for (const std::array<int, 3> &cells :
+       {std::array<int, 3>{2, 6, 7}, std::array<int, 3>{5, 3, 4}}) {
+    std::array<double, 3> length;
+    for (int i = 0; i < 3; i++) {
+      length[i] = cells[i] * cell_length;
+    }
+    Particles list;
+    for (int n = 0; n < 2000; ++n) {
+      list.insert(Test::smashon(Position{0., length[0] * (n * 37 % 97) / 97,
+                                         length[1] * (n * 53 % 89) / 89,
+                                         length[2] * (n * 71 % 83) / 83},
+                                n));
+    }
+    Grid<GridOptions::PeriodicBoundaries> grid(
+        make_pair(std::array<double, 3>{0, 0, 0}, length), list,
+        minimal_cell_length(1), timestep, CellNumberLimitation::None);
+
+    // The same pairs as on one thread, as often as on one thread
+    std::multiset<std::pair<int, int>> expected;
+    std::vector<std::multiset<std::pair<int, int>>> found(n_threads);
+    auto add = [](std::multiset<std::pair<int, int>> &pairs,
+                  const ParticleData &a, const ParticleData &b) {
+      pairs.emplace(std::min(a.id(), b.id()), std::max(a.id(), b.id()));
+    };
+    grid.iterate_cells(
+        [&](const ParticleList &search) {
+          for (std::size_t i = 0; i < search.size(); i++) {
+            for (std::size_t j = i + 1; j < search.size(); j++) {
+              add(expected, search[i], search[j]);
+            }
+          }
+        },
+        [&](const ParticleList &search, const ParticleList &neighbors) {
+          for (const ParticleData &a : search) {
+            for (const ParticleData &b : neighbors) {
+              add(expected, a, b);
+            }
+          }
+        });
+    grid.iterate_cells_in_parallel(
+        n_threads,
+        [&](int i_thread, const ParticleList &search) {
+          for (std::size_t i = 0; i < search.size(); i++) {
+            for (std::size_t j = i + 1; j < search.size(); j++) {
+              add(found[i_thread], search[i], search[j]);
+            }
+          }
+        },
+        [&](int i_thread, const ParticleList &search,
+            const ParticleList &neighbors) {
+          for (const ParticleData &a : search) {
+            for (const ParticleData &b : neighbors) {
+              // the search cell is translated next to the neighbor cell
+              VERIFY((a.position() - b.position()).threevec().abs() <
+                     2 * std::sqrt(3.) * cell_length);
+              add(found[i_thread], a, b);
+            }
+          }
+        });
+    std::multiset<std::pair<int, int>> all;
+    for (const auto &pairs : found) {
+      all.insert(pairs.begin(), pairs.end());
+    }
+    COMPARE(all, expected);
+  }
+}
+
+TEST_CATCH(parallel_cell_iteration_rethrows, std::runtime_error) {
+  Particles list;
+  for (int n = 0; n < 1000; ++n) {
+    list.insert(Test::smashon(
+        Test::Position{0., 1.25 * (n % 10), 1.25 * (n / 10 % 10),
+                       1.25 * (n / 100)},
+        n));
+  }
+  Grid<GridOptions::Normal> grid(list, minimal_cell_length(1), timestep,
+                                 CellNumberLimitation::None);
+  grid.iterate_cells_in_parallel(
+      4,
+      [](int, const ParticleList &search) {
+        for (const ParticleData &p : search) {
+          if (p.id() == 500) {
+            throw std::runtime_error("search cell callback failed");
+          }
+        }
+      },
+      [](int, const ParticleList &, const ParticleList &) {});
+}
+
+TEST(member_selection) {
+  using Test::Position;
+  Particles list;
+  for (int n = 0; n < 1000; ++n) {
+    list.insert(Test::smashon(
+        Position{0., 1.25 * (n % 10), 1.25 * (n / 10 % 10), 1.25 * (n / 100)},
+        n));
+  }
+  auto is_member = [](const ParticleData &p) { return p.id() % 7 == 0; };
+  Grid<GridOptions::Normal> grid(list, minimal_cell_length(1), timestep,
+                                 CellNumberLimitation::None);
+  VERIFY(!grid.selects_members());
+  grid.set_member_selection(is_member);
+  VERIFY(grid.selects_members());
+  // The members are listed right away and again after moving particles.
+  for (int update = 0; update < 2; update++) {
+    std::size_t n_members = 0;
+    grid.iterate_cells(
+        [&](const ParticleList &search) {
+          ParticleList expected;
+          std::copy_if(search.begin(), search.end(),
+                       std::back_inserter(expected), is_member);
+          const ParticleList &members = grid.members_of(search);
+          COMPARE(members.size(), expected.size());
+          for (std::size_t i = 0; i < members.size(); i++) {
+            COMPARE(members[i].id(), expected[i].id());
+          }
+          n_members += members.size();
+        },
+        [](const ParticleList &, const ParticleList &) {});
+    COMPARE(n_members, 143u);
+    for (ParticleData &p : list) {
+      p.set_4position(p.position() + FourVector(0., 0., 0., 1.3));
+    }
+    grid.update(list, minimal_cell_length(1), timestep,
+                CellNumberLimitation::None);
+  }
+}
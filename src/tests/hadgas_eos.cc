@@ -11,6 +11,11 @@
 
 #include "smash/hadgas_eos.h"
 
+#include <thread>
+#include <vector>
+
+#include "gsl/gsl_sf_bessel.h"
+
 #include "setup.h"
 #include "smash/constants.h"
 
@@ -21,6 +26,16 @@ TEST(create_particles_table) {
   Test::create_actual_decaymodes();
 }
 
+TEST(scaled_bessel_table) {
+  const ScaledBesselTable &table = ScaledBesselTable::get();
+  for (const double z : {0.0, 1.e-3, 0.138, 1.0, 3.7, 12.5, 63.99, 64.0, 80.}) {
+    const double k2 = (z == 0.0) ? 2.0 : z * z * gsl_sf_bessel_Kn_scaled(2, z);
+    const double k1 = (z == 0.0) ? 0.0 : z * z * z * gsl_sf_bessel_K1_scaled(z);
+    COMPARE_RELATIVE_ERROR(table.density_factor(z), k2, 1.e-9) << z;
+    COMPARE_RELATIVE_ERROR(table.energy_factor(z), 3.0 * k2 + k1, 1.e-9) << z;
+  }
+}
+
 TEST(td_simple_gas) {
   const double T = 0.1;
   const double mub = 0.8;
@@ -66,6 +81,32 @@ TEST(solve_EoS_substitute) {
   COMPARE_ABSOLUTE_ERROR(sol[3], muq, 1.e-4);
 }
 
+TEST(solve_EoS_concurrently) {
+  const HadronGasEos eos = HadronGasEos(false, false);
+  const std::array<double, 4> T = {0.12, 0.15, 0.2, 0.25};
+  std::array<std::array<double, 4>, 4> solutions;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < T.size(); i++) {
+    threads.emplace_back([&, i]() {
+      const double mub = 0.3, mus = 0.05, muq = -0.02;
+      solutions[i] = eos.solve_eos(
+          HadronGasEos::energy_density(T[i], mub, mus, muq),
+          HadronGasEos::net_baryon_density(T[i], mub, mus, muq),
+          HadronGasEos::net_strange_density(T[i], mub, mus, muq),
+          HadronGasEos::net_charge_density(T[i], mub, mus, muq));
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < T.size(); i++) {
+    COMPARE_ABSOLUTE_ERROR(solutions[i][0], T[i], 1.e-4);
+    COMPARE_ABSOLUTE_ERROR(solutions[i][1], 0.3, 1.e-4);
+    COMPARE_ABSOLUTE_ERROR(solutions[i][2], 0.05, 1.e-4);
+    COMPARE_ABSOLUTE_ERROR(solutions[i][3], -0.02, 1.e-4);
+  }
+}
+
 TEST(EoS_table) {
   // make a small table of EoS
   HadronGasEos eos = HadronGasEos(false, false);
@@ -84,6 +125,33 @@ TEST(EoS_table) {
   remove("small_test_table_eos.dat");
 }
 
+TEST(EoS_table_is_saved) {
+  HadronGasEos eos = HadronGasEos(false, false);
+  EosTable table = EosTable(0.1, 0.05, 0.05, 5, 5, 5);
+  table.compile_table(eos, "small_test_table_eos.bin");
+  EosTable::table_element x;
+  table.get(x, 0.39, 0.09, 0.06);
+
+  // The same table is read from the file.
+  EosTable read_table = EosTable(0.1, 0.05, 0.05, 5, 5, 5);
+  read_table.compile_table(eos, "small_test_table_eos.bin");
+  EosTable::table_element y;
+  read_table.get(y, 0.39, 0.09, 0.06);
+  COMPARE(y.p, x.p);
+  COMPARE(y.T, x.T);
+  COMPARE(y.mub, x.mub);
+  COMPARE(y.mus, x.mus);
+  COMPARE(y.muq, x.muq);
+
+  // A table on another grid is compiled again.
+  EosTable other_table = EosTable(0.1, 0.04, 0.05, 5, 5, 5);
+  other_table.compile_table(eos, "small_test_table_eos.bin");
+  other_table.get(y, 0.39, 0.09, 0.06);
+  COMPARE_ABSOLUTE_ERROR(
+      HadronGasEos::net_baryon_density(y.T, y.mub, y.mus, y.muq), 0.09, 1.e-2);
+  remove("small_test_table_eos.bin");
+}
+
 /*
 TEST(make_test_table) {
   // To switch on these tests, comment out the previous ones.
@@ -0,0 +1,85 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/iccallbackoutput.h"
+
+#include <vector>
+
+#include "setup.h"
+#include "smash/hypersurfacecrossingaction.h"
+#include "smash/scatteraction.h"
+
+using namespace smash;
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+TEST(crossings_are_passed_per_ensemble) {
+  constexpr int n_ensembles = 2;
+  auto particles =
+      Test::create_particles(3, [] { return Test::smashon_random(); });
+  const EventInfo info = Test::default_event_info(2.5, false);
+
+  std::vector<int> event_numbers;
+  std::vector<ParticleList> received;
+  ICCallbackOutput output([&](const ParticleList &crossed, int event_number,
+                              const EventInfo &) {
+    event_numbers.push_back(event_number);
+    received.push_back(crossed);
+  });
+
+  const ParticleList plist = particles->copy_to_vector();
+  for (int event = 0; event < 2; event++) {
+    for (int i = 0; i < n_ensembles; i++) {
+      output.at_eventstart(*particles, event * n_ensembles + i, info);
+    }
+    for (std::size_t k = 0; k < plist.size(); k++) {
+      HypersurfacecrossingAction action(plist[k], plist[k], 0.);
+      action.generate_final_state();
+      output.at_ensemble_interaction(action, 0., k % n_ensembles);
+    }
+    for (int i = 0; i < n_ensembles; i++) {
+      output.at_eventend(*particles, event * n_ensembles + i, info);
+    }
+  }
+
+  COMPARE(event_numbers, (std::vector<int>{0, 1, 2, 3}));
+  COMPARE(received.size(), 4u);
+  for (int event = 0; event < 2; event++) {
+    const ParticleList &first = received[event * n_ensembles];
+    const ParticleList &second = received[event * n_ensembles + 1];
+    COMPARE(first.size(), 2u);
+    COMPARE(second.size(), 1u);
+    COMPARE(first[0].id(), plist[0].id());
+    COMPARE(first[1].id(), plist[2].id());
+    COMPARE(second[0].id(), plist[1].id());
+    COMPARE(second[0].position(), plist[1].position());
+  }
+}
+
+TEST(other_actions_are_ignored) {
+  auto particles =
+      Test::create_particles(2, [] { return Test::smashon_random(); });
+  const EventInfo info = Test::default_event_info(2.5, false);
+  std::size_t n_received = 0;
+  ICCallbackOutput output(
+      [&](const ParticleList &crossed, int, const EventInfo &) {
+        n_received = crossed.size();
+      });
+  output.at_eventstart(*particles, 0, info);
+  const ScatterAction action(particles->front(), particles->back(), 0.);
+  output.at_interaction(action, 0.);
+  output.at_eventend(*particles, 0, info);
+  COMPARE(n_received, 0u);
+}
+
+TEST_CATCH(no_callback, std::invalid_argument) {
+  ICCallbackOutput output(nullptr);
+}
@@ -15,6 +15,10 @@
 #include "smash/modusdefault.h"
 #include "smash/spheremodus.h"
 
+#include <array>
+#include <string>
+#include <vector>
+
 using namespace smash;
 
 TEST(init_particle_types) {
@@ -126,6 +130,87 @@ TEST_CATCH(initialize_nucleus_empty_target, ColliderModus::ColliderEmpty) {
   n.initial_conditions(&P, Test::default_parameters());
 }
 
+TEST(prefetched_initial_states) {
+  const std::string config =
+      "Collider:\n"
+      "  Sqrtsnn: 1.6\n"
+      "  Projectile:\n"
+      "    Particles: {661: 4}\n"
+      "  Target:\n"
+      "    Particles: {661: 4}\n"
+      "  Impact:\n"
+      "    Max: 5\n"
+      "  Prefetch_Initial_States: ";
+  auto seed_of_event = [](int event) { return int64_t{10} * event; };
+  // Impact parameter and position of the first nucleon of both ensembles
+  std::vector<std::array<double, 3>> reference;
+  for (const int depth : {1, 3}) {
+    ColliderModus n(Configuration((config + std::to_string(depth)).c_str()),
+                    Test::default_parameters());
+    COMPARE(n.prefetch_depth(), depth);
+    for (int event = 1; event <= 4; event++) {
+      std::vector<Particles> ensembles(2);
+      VERIFY(n.take_prefetched_initial_state(event, 1, seed_of_event,
+                                             &ensembles) < 0.);
+      COMPARE(ensembles[0].size(), 8u);
+      COMPARE(ensembles[1].size(), 8u);
+      const std::array<double, 3> state = {
+          n.impact_parameter(), ensembles[0].front().position().x1(),
+          ensembles[1].front().position().x1()};
+      if (depth == 1) {
+        reference.push_back(state);
+      } else {
+        // The initial states do not depend on the number of prefetched ones.
+        COMPARE(state, reference[event - 1]);
+      }
+    }
+    // Taking an unexpected event restarts the generation from that event.
+    std::vector<Particles> ensembles(2);
+    n.take_prefetched_initial_state(2, 1, seed_of_event, &ensembles);
+    COMPARE(n.impact_parameter(), reference[1][0]);
+    COMPARE(ensembles[0].front().position().x1(), reference[1][1]);
+  }
+}
+
+TEST(reconfigure_collider) {
+  ColliderModus n(Configuration("Collider:\n"
+                                "  Sqrtsnn: 1.6\n"
+                                "  Projectile:\n"
+                                "    Particles: {661: 1}\n"
+                                "  Target:\n"
+                                "    Particles: {661: 1}\n"
+                                "  Impact:\n"
+                                "    Value: 3\n"
+                                "  Prefetch_Initial_States: 2\n"),
+                  Test::default_parameters());
+  auto seed_of_event = [](int event) { return int64_t{event}; };
+  std::vector<Particles> ensembles(1);
+  n.take_prefetched_initial_state(1, 1, seed_of_event, &ensembles);
+  COMPARE(n.impact_parameter(), 3.);
+
+  Configuration changes("Collider:\n"
+                        "  Sqrtsnn: 2.4\n"
+                        "  Impact:\n"
+                        "    Range: [1, 1]\n"
+                        "Box:\n"
+                        "  Length: 1\n");
+  n.reconfigure(changes);
+  COMPARE(n.sqrt_s_NN(), 2.4);
+  // Other keys are left for the caller.
+  VERIFY(!changes.has_value({"Collider"}));
+  VERIFY(changes.has_value({"Box", "Length"}));
+  changes.clear();
+
+  // The initial state prefetched with the previous settings is dropped.
+  ensembles = std::vector<Particles>(1);
+  n.take_prefetched_initial_state(2, 1, seed_of_event, &ensembles);
+  COMPARE(n.impact_parameter(), 1.);
+  for (const ParticleData &p : ensembles[0]) {
+    // velocity should be sqrt(1 - (0.4 / 1.2)^2)
+    COMPARE_RELATIVE_ERROR(p.velocity().sqr(), 8. / 9., 1e-6);
+  }
+}
+
 TEST(initialize_sphere) {
   SphereModus s(Configuration("Sphere:\n"
                               "  Radius: 10\n"
@@ -11,6 +11,8 @@
 
 #include "smash/lattice.h"
 
+#include <sstream>
+
 #include "smash/fourvector.h"
 
 using namespace smash;
@@ -999,6 +1001,32 @@ TEST(iterate_nearest_neighbors) {
       });
 }
 
+TEST(iterate_in_parallel) {
+  const std::array<double, 3> l = {10., 10., 10.};
+  const std::array<int, 3> n = {20, 17, 9};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  RectangularLattice<int> lattice(l, n, origin, false,
+                                  LatticeUpdate::EveryTimestep);
+  for (int n_threads : {1, 4}) {
+    // Every node is visited exactly once.
+    lattice.iterate_in_parallel(n_threads,
+                                [&](std::size_t i) { lattice[i] += 1; });
+    for (std::size_t i = 0; i < lattice.size(); i++) {
+      COMPARE(lattice[i], n_threads == 1 ? 1 : 2) << " at node " << i;
+    }
+  }
+}
+
+TEST_CATCH(iterate_in_parallel_rethrows, std::runtime_error) {
+  RectangularLattice<int> lattice({10., 10., 10.}, {20, 20, 20}, {0., 0., 0.},
+                                  false, LatticeUpdate::EveryTimestep);
+  lattice.iterate_in_parallel(3, [](std::size_t i) {
+    if (i == 5000) {
+      throw std::runtime_error("node failed");
+    }
+  });
+}
+
 TEST(copy_constructor) {
   const std::array<double, 3> l = {10., 6., 2.};
   const std::array<int, 3> n = {4, 8, 3};
@@ -1050,3 +1078,121 @@ TEST(integrate_volume) {
   lattice.integrate_volume(integral, integrand, radius, r0);
   COMPARE_RELATIVE_ERROR(integral, 2 * M_PI * std::pow(radius, 4), 0.03);
 }
+
+TEST(track_occupation) {
+  const std::array<double, 3> l = {20., 20., 20.};
+  const std::array<int, 3> n = {20, 20, 20};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  for (const bool periodicity : {false, true}) {
+    RectangularLattice<double> lattice(l, n, origin, periodicity,
+                                       LatticeUpdate::EveryTimestep);
+    VERIFY(!lattice.tracks_occupation());
+    lattice.track_occupation();
+    VERIFY(lattice.tracks_occupation());
+    // all bricks are occupied initially and empty after a reset
+    int visited = 0;
+    lattice.iterate_occupied([&](double &) { visited++; });
+    COMPARE(visited, 20 * 20 * 20);
+    lattice.reset();
+    visited = 0;
+    lattice.iterate_occupied([&](double &) { visited++; });
+    COMPARE(visited, 0);
+
+    // a point in the corner only reaches the first brick, unless the lattice
+    // is periodic, where the reach wraps around to the last brick of 4 nodes
+    lattice.mark_occupied(ThreeVector(0.2, 10., 10.), {1., 1., 1.});
+    visited = 0;
+    lattice.iterate_occupied([&](double &node) {
+      node = 1.;
+      visited++;
+    });
+    COMPARE(visited, periodicity ? (8 + 4) * 8 * 8 : 8 * 8 * 8);
+    VERIFY(lattice.node(0, 10, 10) == 1.);
+    VERIFY(lattice.node(19, 10, 10) == (periodicity ? 1. : 0.));
+    VERIFY(lattice.node(10, 10, 10) == 0.);
+
+    // points far off the lattice are harmless
+    lattice.mark_occupied(ThreeVector(1.e12, -1.e12, 10.), {1., 1., 1.});
+
+    // the reset clears the occupied bricks
+    lattice.reset();
+    for (const double &node : lattice) {
+      COMPARE(node, 0.);
+    }
+  }
+}
+
+TEST(shift_and_resize) {
+  const std::array<double, 3> l = {4., 6., 2.};
+  const std::array<int, 3> n = {4, 3, 2};
+  const std::array<double, 3> origin = {0., -3., 1.};
+  RectangularLattice<double> lattice(l, n, origin, false,
+                                     LatticeUpdate::EveryTimestep);
+  lattice.iterate_sublattice({0, 0, 0}, n,
+                             [&](double &node, int ix, int iy, int iz) {
+                               node = ix + 10 * iy + 100 * iz;
+                             });
+  lattice.shift_and_resize({-1, 1, 0}, {6, 2, 3});
+  COMPARE(lattice.n_cells(), (std::array<int, 3>{6, 2, 3}));
+  COMPARE(lattice.cell_sizes(), (std::array<double, 3>{1., 2., 1.}));
+  COMPARE(lattice.lattice_sizes(), (std::array<double, 3>{6., 4., 3.}));
+  COMPARE(lattice.origin(), (std::array<double, 3>{-1., -1., 1.}));
+  COMPARE(lattice.size(), 36u);
+  lattice.iterate_sublattice(
+      {0, 0, 0}, lattice.n_cells(), [&](double &node, int ix, int iy, int iz) {
+        const int old_x = ix - 1, old_y = iy + 1;
+        if (old_x < 0 || old_x > 3 || iz > 1) {
+          COMPARE(node, 0.) << ix << " " << iy << " " << iz;
+        } else {
+          COMPARE(node, old_x + 10 * old_y + 100 * iz)
+              << ix << " " << iy << " " << iz;
+        }
+      });
+}
+
+TEST(follow) {
+  const std::array<double, 3> l = {10., 10., 10.};
+  const std::array<int, 3> n = {10, 10, 10};
+  const std::array<double, 3> origin = {-5., -5., -5.};
+  RectangularLattice<double> lattice(l, n, origin, false,
+                                     LatticeUpdate::EveryTimestep);
+  // a box fitting into the lattice does not change it
+  VERIFY(!lattice.follow(ThreeVector(-4., -3., -2.), ThreeVector(4., 3., 2.),
+                         n));
+  // the lattice is moved by whole cells and grows along z
+  VERIFY(lattice.follow(ThreeVector(0., -5., -10.), ThreeVector(4., 5., 10.),
+                        n));
+  COMPARE(lattice.n_cells(), (std::array<int, 3>{10, 10, 20}));
+  COMPARE(lattice.origin(), (std::array<double, 3>{-3., -5., -10.}));
+  COMPARE(lattice.cell_sizes(), (std::array<double, 3>{1., 1., 1.}));
+}
+
+TEST_CATCH(periodic_lattice_cannot_move, std::invalid_argument) {
+  auto lattice = create_lattice(true);
+  lattice->shift_and_resize({1, 0, 0}, lattice->n_cells());
+}
+
+TEST(checkpoint_round_trip) {
+  const std::array<double, 3> l = {10., 10., 10.};
+  const std::array<int, 3> n = {10, 10, 10};
+  const std::array<double, 3> origin = {-5., -5., -5.};
+  RectangularLattice<double> lattice(l, n, origin, false,
+                                     LatticeUpdate::EveryTimestep);
+  lattice.follow(ThreeVector(0., -5., -10.), ThreeVector(4., 5., 10.), n);
+  lattice.iterate_sublattice({0, 0, 0}, lattice.n_cells(),
+                             [](double &node, int ix, int iy, int iz) {
+                               node = ix + 10 * iy + 100 * iz;
+                             });
+  std::stringstream checkpoint;
+  lattice.write_checkpoint(checkpoint);
+
+  RectangularLattice<double> restored(l, n, origin, false,
+                                      LatticeUpdate::EveryTimestep);
+  restored.read_checkpoint(checkpoint);
+  COMPARE(restored.n_cells(), lattice.n_cells());
+  COMPARE(restored.origin(), lattice.origin());
+  COMPARE(restored.lattice_sizes(), lattice.lattice_sizes());
+  for (std::size_t i = 0; i < lattice.size(); i++) {
+    COMPARE(restored[i], lattice[i]);
+  }
+}
@@ -11,10 +11,13 @@
 
 #include "smash/listmodus.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
 #include <string>
 
 #include "setup.h"
+#include "smash/binaryoutput.h"
 #include "smash/oscaroutput.h"
 #include "smash/particles.h"
 
@@ -459,6 +462,46 @@ TEST(multiple_events_in_file) {
   }
 }
 
+TEST(prefetched_events_in_file) {
+  OutputParameters out_par = OutputParameters();
+  out_par.part_only_final = OutputOnlyFinal::Yes;
+  out_par.part_extended = false;
+  constexpr int max_events = 3;
+  std::vector<ParticleList> init_particles;
+  create_particlefile(out_par, 0, init_particles, 10, max_events);
+  ListModus list_modus = create_list_modus_with_single_file_for_test();
+  Configuration config{R"(
+    List:
+      File_Directory: ToBeSet
+      Filename: event0
+      Prefetch_Initial_States: 2
+    )"};
+  config.set_value({"List", "File_Directory"}, testoutputpath.string());
+  ListModus prefetching_modus(std::move(config), parameters);
+  COMPARE(prefetching_modus.prefetch_depth(), 2);
+
+  // The events read ahead of time are the ones read when they start.
+  for (int event = 0; event < max_events; event++) {
+    Particles particles_read;
+    const double start_time =
+        list_modus.initial_conditions(&particles_read, parameters);
+    std::vector<Particles> ensembles(1);
+    COMPARE(prefetching_modus.take_prefetched_initial_state(event, 1, {},
+                                                            &ensembles),
+            start_time);
+    const ParticleList expected = particles_read.copy_to_vector();
+    const ParticleList prefetched = ensembles[0].copy_to_vector();
+    COMPARE(prefetched.size(), expected.size());
+    for (std::size_t i = 0; i < prefetched.size(); i++) {
+      COMPARE(prefetched[i].id(), expected[i].id());
+      COMPARE(prefetched[i].pdgcode(), expected[i].pdgcode());
+      COMPARE(prefetched[i].position(), expected[i].position());
+      COMPARE(prefetched[i].momentum(), expected[i].momentum());
+      COMPARE(prefetched[i].formation_time(), expected[i].formation_time());
+    }
+  }
+}
+
 TEST(try_create_particle_func) {
   ListModus list_modus = create_list_modus_for_test();
   Particles particles;
@@ -532,3 +575,74 @@ TEST_CATCH(create_particle_with_nan, std::invalid_argument) {
   list_modus.try_create_particle(particles, pdg, NAN, r.x1(), r.x2(), r.x3(),
                                  m0, p.x0(), p.x1(), p.x2(), p.x3());
 }
+
+TEST(list_from_binary_output) {
+  OutputParameters out_par = OutputParameters();
+  out_par.part_only_final = OutputOnlyFinal::No;
+  out_par.part_extended = true;
+  constexpr int n_events = 3;
+  std::vector<ParticleList> final_particles;
+  {
+    BinaryOutputParticles bin_output(testoutputpath, "Particles", out_par);
+    const EventInfo info = Test::default_event_info(2.34, false);
+    for (int event = 0; event < n_events; event++) {
+      Particles particles;
+      for (int i = 0; i < 4 + event; i++) {
+        particles.insert(Test::smashon_random());
+      }
+      // Only the last particle block of an event is read.
+      bin_output.at_eventstart(particles, event, info);
+      particles.insert(Test::smashon_random());
+      bin_output.at_eventend(particles, event, info);
+      final_particles.push_back(particles.copy_to_vector());
+    }
+    // Blocks of an unfinished event are ignored.
+    Particles particles;
+    particles.insert(Test::smashon_random());
+    bin_output.at_eventstart(particles, n_events, info);
+  }
+  const std::filesystem::path inputfilepath = testoutputpath / "event0";
+  std::filesystem::rename(testoutputpath / "particles_binary.bin",
+                          inputfilepath);
+  VERIFY(BinaryParticleListReader::is_binary_file(inputfilepath));
+  COMPARE(BinaryParticleListReader(inputfilepath).n_events(),
+          std::size_t{n_events});
+
+  ListModus list_modus = create_list_modus_with_single_file_for_test();
+  for (int event = 0; event < n_events; event++) {
+    Particles particles_read;
+    list_modus.initial_conditions(&particles_read, parameters);
+    ParticleList &p_init = final_particles[event];
+    COMPARE(particles_read.size(), p_init.size());
+    double earliest_t = 1.e8;
+    for (const auto &particle : p_init) {
+      earliest_t = std::min(earliest_t, particle.position().x0());
+    }
+    ParticleList p_fin = particles_read.copy_to_vector();
+    for (std::size_t i = 0; i < p_fin.size(); i++) {
+      const ParticleData &a = p_init[i];
+      const ParticleData &b = p_fin[i];
+      const double t = a.position().x0();
+      const FourVector u(1.0, a.velocity());
+      compare_fourvector(a.momentum(), b.momentum());
+      compare_fourvector(a.position() + u * (earliest_t - t), b.position());
+      COMPARE_ABSOLUTE_ERROR(b.formation_time(), t, accuracy);
+      COMPARE(a.pdgcode(), b.pdgcode());
+    }
+  }
+  VERIFY(std::filesystem::remove(inputfilepath));
+}
+
+TEST_CATCH(list_with_incomplete_line, ListModus::LoadFailure) {
+  const std::filesystem::path inputfilepath = testoutputpath / "event0";
+  {
+    std::ofstream file(inputfilepath);
+    // The charge of the particle is missing.
+    file << "# event 0 out 1\n"
+         << "0.1 0.2 0.3 0.4 0.138 0.5 0.1 0.2 0.3 661 0\n"
+         << "# event 0 end 0\n";
+  }
+  ListModus list_modus = create_list_modus_with_single_file_for_test();
+  Particles particles;
+  list_modus.initial_conditions(&particles, parameters);
+}
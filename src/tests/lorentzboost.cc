@@ -7,6 +7,9 @@
 
 #include "vir/test.h"  // This include has to be first
 
+#include <array>
+#include <vector>
+
 #include "smash/angles.h"
 #include "smash/fourvector.h"
 
@@ -89,3 +92,36 @@ TEST(back_and_forth) {
     }
   }
 }
+
+// Boosting many vectors at once should agree with boosting them one by one:
+TEST(boost_arrays) {
+  constexpr double my_accuracy = 1e-14;
+  constexpr std::size_t n = 37;
+  for (int i = 0; i < 1000; i++) {
+    ThreeVector velocity = random_velocity();
+    const LorentzBoost boost(velocity);
+    std::vector<FourVector> vectors(n);
+    std::array<std::vector<double>, 4> components;
+    for (auto &x : components) {
+      x.resize(n);
+    }
+    for (std::size_t j = 0; j < n; j++) {
+      vectors[j] = FourVector(cos_like(), cos_like(), cos_like(), cos_like());
+      for (int mu = 0; mu < 4; mu++) {
+        components[mu][j] = vectors[j][mu];
+      }
+    }
+    std::vector<FourVector> boosted = vectors;
+    boost.apply(boosted.data(), n);
+    boost.apply(components[0].data(), components[1].data(),
+                components[2].data(), components[3].data(), n);
+    for (std::size_t j = 0; j < n; j++) {
+      const FourVector expected = vectors[j].lorentz_boost(velocity);
+      COMPARE(boosted[j], expected) << " at loop " << i << "*" << j;
+      for (int mu = 0; mu < 4; mu++) {
+        COMPARE_ABSOLUTE_ERROR(components[mu][j], expected[mu], my_accuracy)
+            << " at loop " << i << "*" << j;
+      }
+    }
+  }
+}
@@ -0,0 +1,121 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/memorytracker.h"
+
+#include <memory>
+
+#include "setup.h"
+#include "smash/lattice.h"
+#include "smash/particles.h"
+
+using namespace smash;
+
+static const MemorySubsystem subsystem = MemorySubsystem::Particles;
+
+TEST(disabled_accounts_are_not_counted) {
+  MemoryTracker::set_enabled(false);
+  const int64_t before = MemoryTracker::current_bytes(subsystem);
+  MemoryAccount account(subsystem);
+  account.set(1000);
+  COMPARE(MemoryTracker::current_bytes(subsystem), before);
+}
+
+TEST(current_and_peak) {
+  MemoryTracker::set_enabled(true);
+  const int64_t before = MemoryTracker::current_bytes(subsystem);
+  {
+    MemoryAccount account(subsystem);
+    account.set(1000);
+    COMPARE(MemoryTracker::current_bytes(subsystem), before + 1000);
+    const MemoryAccount copy = account;
+    COMPARE(MemoryTracker::current_bytes(subsystem), before + 2000);
+    account.set(500);
+    COMPARE(MemoryTracker::current_bytes(subsystem), before + 1500);
+    VERIFY(MemoryTracker::peak_bytes(subsystem) >= before + 2000);
+  }
+  COMPARE(MemoryTracker::current_bytes(subsystem), before);
+  MemoryTracker::set_enabled(false);
+}
+
+TEST(enabling_counts_later_updates) {
+  MemoryTracker::set_enabled(false);
+  const int64_t before = MemoryTracker::current_bytes(subsystem);
+  {
+    MemoryAccount account(subsystem);
+    account.set(1000);
+    MemoryTracker::set_enabled(true);
+    account.set(2000);
+    COMPARE(MemoryTracker::current_bytes(subsystem), before + 2000);
+    // Disabling the tracking releases the account at its next update.
+    MemoryTracker::set_enabled(false);
+    account.set(3000);
+    COMPARE(MemoryTracker::current_bytes(subsystem), before);
+  }
+  COMPARE(MemoryTracker::current_bytes(subsystem), before);
+}
+
+TEST(move_to_other_subsystem) {
+  MemoryTracker::set_enabled(true);
+  const int64_t before_particles = MemoryTracker::current_bytes(subsystem);
+  const int64_t before_outputs =
+      MemoryTracker::current_bytes(MemorySubsystem::Outputs);
+  MemoryAccount account(subsystem);
+  account.set(1000);
+  account.set_subsystem(MemorySubsystem::Outputs);
+  COMPARE(MemoryTracker::current_bytes(subsystem), before_particles);
+  COMPARE(MemoryTracker::current_bytes(MemorySubsystem::Outputs),
+          before_outputs + 1000);
+  MemoryTracker::set_enabled(false);
+}
+
+TEST(containers) {
+  Test::create_smashon_particletypes();
+  MemoryTracker::set_enabled(true);
+  const int64_t before = MemoryTracker::current_bytes(subsystem);
+  {
+    Particles particles;
+    const int64_t initial = MemoryTracker::current_bytes(subsystem) - before;
+    VERIFY(initial > 0);
+    for (int i = 0; i < 1000; i++) {
+      particles.insert(Test::smashon_random());
+    }
+    VERIFY(MemoryTracker::current_bytes(subsystem) - before >
+           static_cast<int64_t>(1000 * sizeof(ParticleData)));
+
+    const int64_t outputs_before =
+        MemoryTracker::current_bytes(MemorySubsystem::Outputs);
+    const std::unique_ptr<Particles> snapshot =
+        particles.clone(MemorySubsystem::Outputs);
+    VERIFY(MemoryTracker::current_bytes(MemorySubsystem::Outputs) >
+           outputs_before);
+  }
+  COMPARE(MemoryTracker::current_bytes(subsystem), before);
+
+  const int64_t lattices_before =
+      MemoryTracker::current_bytes(MemorySubsystem::Lattices);
+  {
+    RectangularLattice<double> lattice({10., 10., 10.}, {10, 10, 10},
+                                       {0., 0., 0.}, false,
+                                       LatticeUpdate::EveryTimestep);
+    VERIFY(MemoryTracker::current_bytes(MemorySubsystem::Lattices) >=
+           lattices_before + static_cast<int64_t>(1000 * sizeof(double)));
+  }
+  COMPARE(MemoryTracker::current_bytes(MemorySubsystem::Lattices),
+          lattices_before);
+  MemoryTracker::set_enabled(false);
+}
+
+TEST(report) {
+  const std::string report = MemoryTracker::report();
+  VERIFY(report.find("Particles") != std::string::npos);
+  VERIFY(report.find("Resident (process)") != std::string::npos);
+}
@@ -0,0 +1,504 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+/*
+ * Times the kernels that dominate the run time of SMASH in isolation: the
+ * cross-section evaluation of representative pairs, the collision time of a
+ * pair, the grid construction, the smearing onto the density lattice, the
+ * interpolation of tabulations, the string fragmentation, the replacement of
+ * particles and the particle outputs. All inputs are generated with a fixed
+ * seed, such that every run times the same work. Each kernel is called a fixed
+ * number of times per repetition and the mean run time of a repetition with
+ * its standard error is reported.
+ *
+ * The results are printed as CSV, JSON or in the markdown format of the
+ * bm-results-SMASH-*.md files, such that they can be compared across commits
+ * with bin/benchmarks/compare_benchmarks.bash.
+ */
+
+#include <getopt.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "setup.h"
+#include "smash/binaryoutput.h"
+#include "smash/configuration.h"
+#include "smash/crosssections.h"
+#include "smash/density.h"
+#include "smash/grid.h"
+#include "smash/kinematics.h"
+#include "smash/lattice.h"
+#include "smash/logging.h"
+#include "smash/oscaroutput.h"
+#include "smash/random.h"
+#include "smash/scatteractionsfinder.h"
+#include "smash/stringprocess.h"
+#include "smash/tabulation.h"
+
+using namespace smash;
+
+namespace {
+
+/// Seed of the random numbers generating the inputs
+constexpr int64_t seed = 20240101;
+
+/// Time step of the evolution [fm]
+constexpr double time_step = 0.1;
+
+/// Nuclear saturation density [fm^-3]
+constexpr double saturation_density = 0.16;
+
+/// Receives results of the kernels, such that their calls are not optimized out
+volatile double sink = 0.;
+
+/// Parameters of the benchmarks, as given on the command line
+struct Options {
+  /// Only benchmarks whose names contain this are run
+  std::string filter;
+  /// Number of timed repetitions of every benchmark
+  int repetitions = 10;
+  /// Output format: csv, json or md
+  std::string format = "csv";
+  /// Output file, or empty for the standard output
+  std::string output;
+};
+
+/// Run time of one benchmark
+struct Measurement {
+  /// Name of the benchmark
+  std::string name;
+  /// Number of calls of the kernel per repetition
+  int calls;
+  /// Mean run time of a repetition [s]
+  double mean;
+  /// Standard error of the mean run time [s]
+  double error;
+};
+
+void usage(const std::string &progname, int rc) {
+  std::cout
+      << "\nUsage: " << progname << " [option]\n\n"
+      << "  -h, --help               usage information\n"
+      << "  -b, --benchmarks <s>     only run the benchmarks whose names"
+      << " contain s\n"
+      << "  -r, --repetitions <n>    timed repetitions per benchmark"
+      << " (default: 10)\n"
+      << "  -f, --format <format>    csv, json or md (default: csv)\n"
+      << "  -o, --output <file>      output file"
+      << " (default: standard output)\n\n";
+  std::exit(rc);
+}
+
+/**
+ * \param[in] f Function to be timed
+ * \return wall-clock time taken by f [s]
+ */
+template <typename F>
+double time_of(F &&f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/**
+ * Run a benchmark once to warm up and then for a number of repetitions.
+ *
+ * \param[in] repetitions Number of timed repetitions
+ * \param[in] run Function running the benchmark once and returning the time
+ *            taken by the part to be measured [s]
+ * \return mean run time and its standard error [s]
+ */
+template <typename F>
+std::pair<double, double> measure(int repetitions, F &&run) {
+  run();
+  std::vector<double> times;
+  for (int i = 0; i < repetitions; i++) {
+    times.push_back(run());
+  }
+  double mean = 0., variance = 0.;
+  for (const double t : times) {
+    mean += t;
+  }
+  mean /= repetitions;
+  for (const double t : times) {
+    variance += (t - mean) * (t - mean);
+  }
+  const double error =
+      repetitions > 1
+          ? std::sqrt(variance / (repetitions - 1) / repetitions)
+          : 0.;
+  return {mean, error};
+}
+
+/**
+ * \param[in] n Number of particles
+ * \param[in] length Edge length of the box the particles are placed in [fm]
+ * \return nucleons and pions with uniformly distributed positions in the box
+ *         and momentum components up to 0.5 GeV.
+ */
+ParticleList random_particles(int n, double length) {
+  const std::array<PdgCode, 3> species = {pdg::p, pdg::n, pdg::pi_p};
+  ParticleList particles;
+  for (int i = 0; i < n; i++) {
+    ParticleData data{ParticleType::find(species[i % species.size()])};
+    data.set_4position(FourVector(0., random::uniform(0., length),
+                                  random::uniform(0., length),
+                                  random::uniform(0., length)));
+    data.set_4momentum(data.pole_mass(), random::uniform(-0.5, 0.5),
+                       random::uniform(-0.5, 0.5), random::uniform(-0.5, 0.5));
+    particles.push_back(data);
+  }
+  return particles;
+}
+
+/**
+ * Insert particles, such that they get valid ids.
+ *
+ * \param[in] list Particles to be inserted
+ * \param[out] particles Particles to insert into
+ */
+void insert(const ParticleList &list, Particles &particles) {
+  for (const ParticleData &data : list) {
+    particles.insert(data);
+  }
+}
+
+/**
+ * \param[in] pdg_a PDG code of the first particle
+ * \param[in] pdg_b PDG code of the second particle
+ * \param[in] sqrts Center-of-mass energy of the pair [GeV]
+ * \return the pair at their pole masses in their center-of-mass frame
+ */
+ParticleList pair_at(PdgCode pdg_a, PdgCode pdg_b, double sqrts) {
+  ParticleData a{ParticleType::find(pdg_a)}, b{ParticleType::find(pdg_b)};
+  const double p = pCM(sqrts, a.pole_mass(), b.pole_mass());
+  a.set_4momentum(a.pole_mass(), 0., 0., p);
+  b.set_4momentum(b.pole_mass(), 0., 0., -p);
+  a.set_id(0);
+  b.set_id(1);
+  return {a, b};
+}
+
+/**
+ * Time all selected benchmarks.
+ *
+ * \param[in] opt Options of the benchmarks
+ * \param[out] results Measurements, to which the new ones are appended
+ */
+void run_benchmarks(const Options &opt, std::vector<Measurement> &results) {
+  /* Whether a benchmark is selected, in which case the random numbers for its
+   * inputs are seeded anew. */
+  auto selected = [&](const std::string &name) {
+    if (name.find(opt.filter) == std::string::npos) {
+      return false;
+    }
+    random::set_seed(seed);
+    return true;
+  };
+  // time a function calling a kernel and returning the measured time
+  auto add = [&](const std::string &name, int calls, auto &&run) {
+    const std::pair<double, double> time = measure(opt.repetitions, run);
+    results.push_back(Measurement{name, calls, time.first, time.second});
+  };
+
+  const ScatterActionsFinderParameters finder_par =
+      Test::default_finder_parameters();
+  const std::unique_ptr<StringProcess> string_process =
+      Test::default_string_process_interface();
+  const std::array<std::pair<std::string, ParticleList>, 4> pairs = {
+      std::make_pair("pi+ p at 1.23 GeV", pair_at(pdg::pi_p, pdg::p, 1.23)),
+      std::make_pair("p p at 3 GeV", pair_at(pdg::p, pdg::p, 3.)),
+      std::make_pair("K- p at 2 GeV", pair_at(pdg::K_m, pdg::p, 2.)),
+      std::make_pair("pi- p at 10 GeV", pair_at(pdg::pi_m, pdg::p, 10.))};
+  for (const auto &[description, incoming] : pairs) {
+    const std::string name = "Cross sections " + description;
+    if (selected(name)) {
+      constexpr int calls = 100;
+      const double sqrts =
+          (incoming[0].momentum() + incoming[1].momentum()).abs();
+      add(name, calls, [&]() {
+        return time_of([&]() {
+          for (int i = 0; i < calls; i++) {
+            const CrossSections xs(incoming, sqrts, {});
+            sink += xs.generate_collision_list(finder_par,
+                                               string_process.get())
+                        .size();
+          }
+        });
+      });
+    }
+  }
+
+  if (selected("Collision time")) {
+    constexpr int n = 300;
+    const ExperimentParameters par = Test::default_parameters();
+    Configuration finder_conf{R"(
+      Collision_Term:
+        Strings: false
+    )"};
+    const ScatterActionsFinder finder(finder_conf, par);
+    Particles inserted;
+    insert(random_particles(n, 10.), inserted);
+    const ParticleList particles = inserted.copy_to_vector();
+    add("Collision time", n * (n - 1) / 2, [&]() {
+      return time_of([&]() {
+        for (std::size_t i = 0; i < particles.size(); i++) {
+          for (std::size_t j = i + 1; j < particles.size(); j++) {
+            sink += finder.collision_time(particles[i], particles[j],
+                                          time_step, {});
+          }
+        }
+      });
+    });
+  }
+
+  for (const int n : {1000, 10000, 100000}) {
+    const std::string name =
+        "Grid construction (" + std::to_string(n) + " particles)";
+    if (selected(name)) {
+      // particles at saturation density
+      const double length = std::cbrt(n / saturation_density);
+      Particles particles;
+      insert(random_particles(n, length), particles);
+      add(name, 1, [&]() {
+        return time_of([&]() {
+          const Grid<GridOptions::Normal> grid(
+              particles, 2.5, time_step, CellNumberLimitation::ParticleNumber);
+        });
+      });
+    }
+  }
+
+  const std::array<std::pair<std::string, SmearingMode>, 3> smearing_modes = {
+      std::make_pair("covariant Gaussian", SmearingMode::CovariantGaussian),
+      std::make_pair("triangular", SmearingMode::Triangular),
+      std::make_pair("discrete", SmearingMode::Discrete)};
+  for (const auto &[description, mode] : smearing_modes) {
+    const std::string name = "Lattice update (" + description + " smearing)";
+    if (selected(name)) {
+      // 2000 particles in a box of 20 fm with lattice cells of 1 fm
+      constexpr double length = 20.;
+      constexpr int n_cells = 20;
+      std::vector<Particles> ensembles(1);
+      insert(random_particles(2000, length), ensembles[0]);
+      const DensityParameters dens_par(Test::default_parameters(
+          1, time_step, CollisionCriterion::Geometric, mode));
+      DensityLattice jmu_B({length, length, length},
+                           {n_cells, n_cells, n_cells}, {0., 0., 0.}, false,
+                           LatticeUpdate::EveryTimestep);
+      add(name, 1, [&]() {
+        return time_of([&]() {
+          update_lattice(&jmu_B, LatticeUpdate::EveryTimestep,
+                         DensityType::Baryon, dens_par, ensembles, true);
+        });
+      });
+    }
+  }
+
+  if (selected("Tabulation linear interpolation")) {
+    constexpr int calls = 1000000;
+    const Tabulation tabulation(0., 10., 1000,
+                                [](double x) { return std::sin(x); });
+    // including arguments outside of the tabulated range
+    std::vector<double> x;
+    for (int i = 0; i < calls; i++) {
+      x.push_back(random::uniform(-1., 11.));
+    }
+    add("Tabulation linear interpolation", calls, [&]() {
+      return time_of([&]() {
+        for (const double xi : x) {
+          sink += tabulation.get_value_linear(xi);
+        }
+      });
+    });
+  }
+
+  if (selected("String fragmentation (u-ud at 10 GeV)")) {
+    constexpr int calls = 100;
+    string_process->init_pythia_hadron_rndm();
+    add("String fragmentation (u-ud at 10 GeV)", calls, [&]() {
+      return time_of([&]() {
+        for (int i = 0; i < calls; i++) {
+          ThreeVector evec(0., 0., 1.);
+          ParticleList fragments;
+          sink += string_process->fragment_string(2, 2101, 10., evec, false,
+                                                  false, fragments);
+        }
+      });
+    });
+  }
+
+  if (selected("Particles replace (2 -> 2)")) {
+    constexpr int n = 10000;
+    const ParticleList initial = random_particles(n, 20.);
+    add("Particles replace (2 -> 2)", n / 2, [&]() {
+      // every pair of particles is replaced once, by swapping them
+      Particles particles;
+      insert(initial, particles);
+      const ParticleList old = particles.copy_to_vector();
+      std::vector<ParticleList> to_remove, to_add;
+      for (std::size_t i = 0; i + 1 < old.size(); i += 2) {
+        to_remove.push_back({old[i], old[i + 1]});
+        to_add.push_back({old[i + 1], old[i]});
+      }
+      return time_of([&]() {
+        for (std::size_t i = 0; i < to_remove.size(); i++) {
+          particles.replace(to_remove[i], to_add[i]);
+        }
+      });
+    });
+  }
+
+  const std::filesystem::path output_path =
+      std::filesystem::temp_directory_path() / "smash_microbenchmarks";
+  for (const std::string format : {"Binary", "Oscar2013"}) {
+    constexpr int n = 10000;
+    const std::string name =
+        format + " particle output (" + std::to_string(n) + " particles)";
+    if (selected(name)) {
+      std::filesystem::create_directories(output_path);
+      OutputParameters out_par;
+      out_par.part_only_final = OutputOnlyFinal::No;
+      std::unique_ptr<OutputInterface> output =
+          format == "Binary"
+              ? std::make_unique<BinaryOutputParticles>(output_path,
+                                                        "Particles", out_par)
+              : create_oscar_output(format, "Particles", output_path,
+                                    out_par);
+      Particles particles;
+      insert(random_particles(n, 20.), particles);
+      const DensityParameters dens_par(Test::default_parameters());
+      const EventInfo event = Test::default_event_info();
+      output->at_eventstart(particles, 0, event);
+      add(name, 1, [&]() {
+        return time_of([&]() {
+          output->at_intermediate_time(particles, nullptr, dens_par, event);
+        });
+      });
+    }
+  }
+  std::filesystem::remove_all(output_path);
+}
+
+/**
+ * Write the measurements.
+ *
+ * \param[in] results Measurements
+ * \param[in] format Output format: csv, json or md
+ * \param[out] out Stream to write to
+ */
+void write(const std::vector<Measurement> &results, const std::string &format,
+           std::ostream &out) {
+  out << std::setprecision(6);
+  if (format == "csv") {
+    out << "benchmark,calls,mean_s,error_s,mean_per_call_ns\n";
+    for (const Measurement &m : results) {
+      out << m.name << "," << m.calls << "," << m.mean << "," << m.error << ","
+          << 1e9 * m.mean / m.calls << "\n";
+    }
+  } else if (format == "json") {
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+      const Measurement &m = results[i];
+      out << "  {\"benchmark\": \"" << m.name << "\", \"calls\": " << m.calls
+          << ", \"mean_s\": " << m.mean << ", \"error_s\": " << m.error
+          << ", \"mean_per_call_ns\": " << 1e9 * m.mean / m.calls << "}"
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+  } else {
+    // see component_benchmarks.cc for the format
+    out << "# Microbenchmark Results\n\n## Results\n";
+    for (const Measurement &m : results) {
+      out << "\n### " << m.name << " (" << m.calls << " calls)\n"
+          << "```\n"
+          << "  " << m.mean << " +- " << m.error
+          << " seconds time elapsed\n"
+          << "```\n";
+    }
+  }
+}
+
+}  // unnamed namespace
+
+int main(int argc, char *argv[]) {
+  constexpr option longopts[] = {{"help", no_argument, 0, 'h'},
+                                 {"benchmarks", required_argument, 0, 'b'},
+                                 {"repetitions", required_argument, 0, 'r'},
+                                 {"format", required_argument, 0, 'f'},
+                                 {"output", required_argument, 0, 'o'},
+                                 {nullptr, 0, 0, 0}};
+  const std::string progname = argv[0];
+  try {
+    Options opt;
+    int c;
+    while ((c = getopt_long(argc, argv, "hb:r:f:o:", longopts, nullptr)) !=
+           -1) {
+      switch (c) {
+        case 'h':
+          usage(progname, EXIT_SUCCESS);
+          break;
+        case 'b':
+          opt.filter = optarg;
+          break;
+        case 'r':
+          opt.repetitions = std::stoi(optarg);
+          break;
+        case 'f':
+          opt.format = optarg;
+          break;
+        case 'o':
+          opt.output = optarg;
+          break;
+        default:
+          usage(progname, EXIT_FAILURE);
+      }
+    }
+    if (opt.format != "csv" && opt.format != "json" && opt.format != "md") {
+      throw std::invalid_argument("Unknown output format " + opt.format + ".");
+    }
+    if (opt.repetitions < 1) {
+      throw std::invalid_argument(
+          "The number of repetitions has to be positive.");
+    }
+
+    set_default_loglevel(einhard::WARN);
+    create_all_loggers(Configuration(""));
+    Test::create_actual_particletypes();
+    Test::create_actual_decaymodes();
+
+    std::vector<Measurement> results;
+    run_benchmarks(opt, results);
+    if (opt.output.empty()) {
+      write(results, opt.format, std::cout);
+    } else {
+      std::ofstream file(opt.output);
+      write(results, opt.format, file);
+    }
+  } catch (std::exception &e) {
+    std::cerr << progname << ": " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
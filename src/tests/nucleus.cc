@@ -11,8 +11,14 @@
 
 #include "smash/nucleus.h"
 
+#include <filesystem>
+#include <fstream>
 #include <map>
+#include <set>
+#include <string>
 
+#include "smash/configuration.h"
+#include "smash/customnucleus.h"
 #include "smash/particles.h"
 #include "smash/pdgcode.h"
 #include "smash/pow.h"
@@ -259,6 +265,82 @@ TEST(Fermi_motion) {
   COMPARE_ABSOLUTE_ERROR(ptot.x3(), 0.0, 1.0e-15) << ptot.x3();
 }
 
+TEST(configuration_library) {
+  const std::filesystem::path testoutputpath =
+      std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+  std::filesystem::create_directories(testoutputpath);
+  const std::string file = (testoutputpath / "lead_library.dat").string();
+  std::filesystem::remove(file);
+
+  /* The Fermi momenta are taken from the library as they are, so the first
+   * nucleon has one of two momenta. */
+  Nucleus sampled(list, 1);
+  sampled.use_configuration_library(2, file);
+  std::set<double> momenta;
+  for (int i = 0; i < 20; i++) {
+    sampled.arrange_nucleons();
+    sampled.generate_fermi_momenta();
+    momenta.insert(sampled.cbegin()->momentum().x1());
+    // The drawn configurations are rotated around the center.
+    COMPARE_ABSOLUTE_ERROR(sampled.center().threevec().abs(), 0., 1e-12);
+  }
+  COMPARE(momenta.size(), 2u);
+  VERIFY(std::filesystem::exists(file));
+
+  // The saved library gives the same configurations.
+  Nucleus loaded(list, 1);
+  loaded.use_configuration_library(0, file);
+  for (int i = 0; i < 20; i++) {
+    loaded.arrange_nucleons();
+    loaded.generate_fermi_momenta();
+    VERIFY(momenta.count(loaded.cbegin()->momentum().x1()) == 1);
+  }
+  VERIFY(std::filesystem::remove(file));
+}
+
+TEST(custom_nucleus_configurations) {
+  const std::filesystem::path testoutputpath =
+      std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+  std::filesystem::create_directories(testoutputpath);
+  const std::string file = (testoutputpath / "deuteron_custom.dat").string();
+  {
+    std::ofstream out(file);
+    out << "1 0 0 0 1\n-1 0 0 0 0\n\n0 2 0 0 0\n0 -2 0 0 1\n";
+  }
+  const std::string yaml =
+      "Particles: {2212: 1, 2112: 1}\n"
+      "Custom:\n"
+      "  File_Directory: " +
+      testoutputpath.string() + "\n  File_Name: deuteron_custom.dat\n";
+  Configuration projectile_config{yaml.c_str()};
+  Configuration target_config{yaml.c_str()};
+  CustomNucleus projectile(projectile_config, 1);
+  CustomNucleus target(target_config, 1);
+  // The file is parsed once for both nuclei.
+  COMPARE(CustomNucleus::read_configurations(file)->size(), 4u);
+  VERIFY(CustomNucleus::read_configurations(file) ==
+         CustomNucleus::read_configurations(file));
+
+  /* Both configurations are drawn, with the distance of the nucleons and the
+   * order of protons and neutrons of the configuration. */
+  projectile.set_label(BelongsTo::Projectile);
+  std::set<bool> proton_first;
+  for (int i = 0; i < 40; i++) {
+    projectile.arrange_nucleons();
+    const ParticleData &first = *projectile.cbegin();
+    const ParticleData &second = *(projectile.cbegin() + 1);
+    const bool is_proton_first = first.pdgcode() == pdg::p;
+    proton_first.insert(is_proton_first);
+    COMPARE(second.pdgcode() == pdg::p, !is_proton_first);
+    FUZZY_COMPARE(
+        (first.position().threevec() - second.position().threevec()).abs(),
+        is_proton_first ? 2. : 4.);
+    VERIFY(first.belongs_to() == BelongsTo::Projectile);
+  }
+  COMPARE(proton_first.size(), 2u);
+  VERIFY(std::filesystem::remove(file));
+}
+
 TEST(nucleon_density_norm) {
   const std::map<PdgCode, int> deuteron = {{0x2212, 1}, {0x2112, 1}};
   const std::map<PdgCode, int> carbon = {{0x2212, 6}, {0x2112, 6}};
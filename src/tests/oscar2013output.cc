@@ -74,6 +74,8 @@ static void compare_particledata(
   COMPARE(std::atoi(datastring.at(11).c_str()), particle.type().charge());
 }
 
+// The extended format needs the full particle history.
+#ifndef SMASH_COMPACT_PARTICLE_HISTORY
 static void compare_extended_particledata(
     const std::array<std::string, data_elements_extended> &datastring,
     const ParticleData &particle, const int id) {
@@ -97,6 +99,7 @@ static void compare_extended_particledata(
           particle.type().baryon_number());
   COMPARE(std::atoi(datastring.at(21).c_str()), particle.type().strangeness());
 }
+#endif
 
 TEST(full2013_format) {
   /* Create elastic interaction (smashon + smashon). */
@@ -126,6 +129,9 @@ TEST(full2013_format) {
         create_oscar_output("Oscar2013", "Collisions", testoutputpath, out_par);
     VERIFY(bool(osc2013full));
     VERIFY(std::filesystem::exists(outputfilepath_unfinished));
+    VERIFY(osc2013full->uses_interactions());
+    VERIFY(osc2013full->uses_interaction_density());
+    VERIFY(!osc2013full->uses_intermediate_times());
 
     osc2013full->at_eventstart(particles, event_id, event);
     osc2013full->at_interaction(*action, 0.);
@@ -246,6 +252,9 @@ TEST(final2013_format) {
         create_oscar_output("Oscar2013", "Particles", testoutputpath, out_par);
     VERIFY(bool(osc2013final));
     VERIFY(std::filesystem::exists(outputfilepath_unfinished));
+    // Only the final particles are written.
+    VERIFY(!osc2013final->uses_interactions());
+    VERIFY(!osc2013final->uses_intermediate_times());
     /* Initial state output (note that this should not do anything!) */
     osc2013final->at_eventstart(particles, event_id, event);
     /* As with initial state output, this should not do anything */
@@ -298,6 +307,7 @@ TEST(final2013_format) {
   VERIFY(std::filesystem::remove(outputfilepath));
 }
 
+#ifndef SMASH_COMPACT_PARTICLE_HISTORY
 TEST(full_extended_oscar) {
   const std::filesystem::path outputfilename = "full_event_history.oscar";
   const std::filesystem::path outputfilepath = testoutputpath / outputfilename;
@@ -416,6 +426,7 @@ TEST(full_extended_oscar) {
   }
   VERIFY(std::filesystem::remove(outputfilepath));
 }
+#endif
 
 TEST(initial_conditions_2013_format) {
   // Create 1 particle
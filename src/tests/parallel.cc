@@ -0,0 +1,49 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/parallel.h"
+
+#include <stdexcept>
+
+using namespace smash;
+
+TEST(every_index_once) {
+  std::vector<int> calls(1001, 0);
+  parallel_for(4, calls.size(), 16, [&](std::size_t i) { calls[i]++; });
+  for (int n : calls) {
+    COMPARE(n, 1);
+  }
+  parallel_for(0, 0, 16, [](std::size_t) { FAIL() << "no index"; });
+}
+
+TEST(one_chunk_per_worker) {
+  std::vector<int> workers(3, -1);
+  parallel_for(8, workers.size(), 1,
+               [&](int i_thread, std::size_t i) { workers[i] = i_thread; });
+  for (std::size_t i = 0; i < workers.size(); i++) {
+    COMPARE(workers[i], static_cast<int>(i));
+  }
+}
+
+TEST_CATCH(rethrow, std::runtime_error) {
+  parallel_for(4, 100, 1, [](std::size_t i) {
+    if (i == 42) {
+      throw std::runtime_error("index 42");
+    }
+  });
+}
+
+TEST(default_thread_count) {
+  VERIFY(default_thread_count() >= 1);
+  set_concurrent_events(1 << 20);
+  COMPARE(default_thread_count(), 1);
+  set_concurrent_events(1);
+}
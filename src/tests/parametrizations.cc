@@ -18,6 +18,19 @@ using namespace smash;
 
 TEST(init_particle_types) { Test::create_actual_particletypes(); }
 
+TEST(smoothed_data_is_cached) {
+  // This has to run before any parametrization builds the interpolations.
+  TabulationBundle bundle(sha256::Hash{});
+  const std::size_t n_added =
+      initialize_parametrization_interpolations(&bundle);
+  VERIFY(n_added > 0);
+  COMPARE(bundle.size(), n_added);
+  VERIFY(bundle.find("lowess_piplusp_total") != nullptr);
+  // Only the first call builds the interpolations.
+  COMPARE(initialize_parametrization_interpolations(&bundle), 0u);
+  VERIFY(piplusp_total(1.5) > 0.);
+}
+
 constexpr double tolerance = 1.0e-7;
 TEST(clebsch_kaon_charge_exchange) {
   const auto& proton = ParticleType::find(0x2212);
@@ -30,3 +43,40 @@ TEST(clebsch_kaon_charge_exchange) {
   // We assume they are same in crosssections.cc.
   COMPARE_ABSOLUTE_ERROR(cg1, cg2, tolerance);
 }
+
+TEST(tabulated_parametrizations) {
+  const std::vector<double (*)(double)> parametrizations = {
+      pp_elastic,
+      np_elastic,
+      ppbar_elastic,
+      ppbar_total,
+      piplusp_elastic,
+      piminusp_elastic,
+      kplusp_elastic_background,
+      kminusp_elastic_background,
+      pp_high_energy,
+      ppbar_high_energy,
+      np_high_energy,
+      npbar_high_energy,
+      piplusp_high_energy,
+      piminusp_high_energy};
+  // Energies between the tabulated points and away from discontinuities
+  const std::vector<double> tabulated_sqrts = {1.9505, 2.5005, 3.1005, 4.7005,
+                                               8.8005, 17.3005, 27.0005};
+  for (const auto parametrization : parametrizations) {
+    for (const double sqrts : tabulated_sqrts) {
+      const double s = sqrts * sqrts;
+      use_tabulated_parametrizations(false);
+      const double exact = parametrization(s);
+      use_tabulated_parametrizations(true);
+      COMPARE_RELATIVE_ERROR(parametrization(s), exact, 1e-3)
+          << "sqrt(s) = " << sqrts;
+    }
+    // Beyond the tabulated range the exact parametrization is used.
+    use_tabulated_parametrizations(false);
+    const double exact = parametrization(40. * 40.);
+    use_tabulated_parametrizations(true);
+    COMPARE(parametrization(40. * 40.), exact);
+  }
+  use_tabulated_parametrizations(false);
+}
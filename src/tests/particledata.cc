@@ -94,11 +94,13 @@ TEST(set_get) {
   p.set_history(3, 5, ProcessType::None, 1.2, ParticleList{});
   COMPARE(p.id_process(), 5u);
   COMPARE(p.get_history().collisions_per_particle, 3);
-  COMPARE(p.get_history().time_last_collision, 1.2);
+  // only stored in builds with the full history
+  const double time_factor = ParticleData::has_full_history ? 1. : 0.;
+  COMPARE(p.get_history().time_last_collision, time_factor * 1.2);
   p.set_history(4, 6, ProcessType::None, 2.5, ParticleList{});
   COMPARE(p.id_process(), 6u);
   COMPARE(p.get_history().collisions_per_particle, 4);
-  COMPARE(p.get_history().time_last_collision, 2.5);
+  COMPARE(p.get_history().time_last_collision, time_factor * 2.5);
   FourVector m(1.0, 1.2, 1.4, 1.6);
   p.set_4momentum(m);
   COMPARE(p.momentum(), FourVector(1.0, 1.2, 1.4, 1.6));
@@ -153,6 +155,46 @@ TEST(translation) {
   COMPARE(p.translated({1, 2, 3}).position(), FourVector(0, 1, 2, 3));
 }
 
+TEST(scheduled_decay) {
+  ParticleData p = Test::smashon(Test::Position{1., 0., 0., 0.});
+  VERIFY(!p.has_scheduled_decay());
+  p.schedule_decay(3.5);
+  VERIFY(p.has_scheduled_decay());
+  COMPARE(p.scheduled_decay_time(), 3.5);
+  // wall crossings do not change the decay time
+  p.set_history(0, 1, ProcessType::Wall, 2., ParticleList{p});
+  COMPARE(p.scheduled_decay_time(), 3.5);
+  // any interaction does
+  p.set_history(1, 2, ProcessType::Elastic, 2., ParticleList{p});
+  VERIFY(!p.has_scheduled_decay());
+}
+
+TEST(history_of_decay) {
+  ParticleData parent = Test::smashon();
+  ParticleData p = Test::smashon();
+  const HistoryData initial = p.get_history();
+  COMPARE(initial.process_type, ProcessType::None);
+  COMPARE(initial.p1, PdgCode(0x0));
+  p.set_history(2, 7, ProcessType::Decay, 1.5, ParticleList{parent});
+  const HistoryData history = p.get_history();
+  COMPARE(history.collisions_per_particle, 2);
+  COMPARE(history.id_process, 7);
+  COMPARE(history.process_type, ProcessType::Decay);
+  COMPARE(history.p2, PdgCode(0x0));
+  // ids and flags take 16 bytes, the other members are not padded
+  VERIFY(sizeof(ParticleData) <=
+         16 + 2 * sizeof(FourVector) + 7 * sizeof(double));
+  if (ParticleData::has_full_history) {
+    COMPARE(history.time_last_collision, 1.5);
+    COMPARE(history.p1, parent.pdgcode());
+  } else {
+    // the compact history fits into two cache lines
+    COMPARE(history.time_last_collision, 0.);
+    COMPARE(history.p1, PdgCode(0x0));
+    VERIFY(sizeof(ParticleData) <= 128);
+  }
+}
+
 TEST(parity) {
   const auto p = Parity::Pos;
   const auto n = Parity::Neg;
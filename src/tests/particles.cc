@@ -11,6 +11,8 @@
 
 #include "smash/particles.h"
 
+#include <sstream>
+
 #include "setup.h"
 #include "smash/particledata.h"
 #include "smash/pdgcode.h"
@@ -298,6 +300,30 @@ TEST(copy_to_vector) {
   }
 }
 
+TEST(remove_trailing_holes) {
+  Particles p;
+  p.create(5, 0x661);
+  const auto copy = p.copy_to_vector();
+  p.remove(copy[2]);
+  p.remove(copy[3]);
+  // removing the last particle also drops the holes before it
+  p.remove(copy[4]);
+  COMPARE(p.size(), 2u);
+  COMPARE(std::distance(p.begin(), p.end()), 2);
+  VERIFY(p.is_valid(copy[0]));
+  VERIFY(p.is_valid(copy[1]));
+  // the storage is reused from the end again
+  const ParticleData &inserted = p.insert(copy[2]);
+  COMPARE(p.size(), 3u);
+  VERIFY(p.is_valid(inserted));
+  COMPARE(std::distance(p.begin(), p.end()), 3);
+
+  ParticleList appended = {copy[0]};
+  p.append_to(appended);
+  COMPARE(appended.size(), 4u);
+  COMPARE(appended[3].id(), inserted.id());
+}
+
 TEST(exceed_capacity) {
   Particles p;
   p.create(50, 0x661);
@@ -340,3 +366,210 @@ TEST(update) {
   COMPARE(p.front().position(), FourVector(3, 3, 3, 3));
   COMPARE(p.front().id_process(), 2u);
 }
+
+TEST(arrays_follow_modifications) {
+  Particles p;
+  auto pd =
+      Test::smashon(Test::Momentum{1, 0, 0, 0}, Test::Position{0, 1, 2, 3});
+  p.insert(pd);
+  p.insert(pd);
+  p.enable_arrays();
+  VERIFY(p.arrays_enabled());
+  COMPARE(p.arrays().size(), 2u);
+  COMPARE(p.arrays().position[3][1], 3.);
+  VERIFY(p.arrays().type[0] == &pd.type());
+
+  // elastic update of the first particle
+  pd.set_4position({4, 5, 6, 7});
+  p.update_particle(p.front(), pd);
+  COMPARE(p.arrays().position[1][0], 5.);
+
+  // replace the first particle by two new ones
+  auto copy = p.copy_to_vector();
+  ParticleList to_add = {pd, pd};
+  to_add[1].set_4momentum({2, 1, 0, 0});
+  p.replace({copy[0]}, to_add);
+  COMPARE(p.arrays().size(), 3u);
+  COMPARE(p.arrays().momentum[1][2], 1.);
+
+  // removing leaves a hole
+  p.remove(p.lookup(to_add[0]));
+  COMPARE(p.arrays().size(), 3u);
+  COMPARE(p.arrays().valid[0], 0);
+  COMPARE(p.arrays().valid[1], 1);
+
+  // changes through references need an explicit sync
+  p.back().set_4position({8, 8, 8, 8});
+  COMPARE(p.arrays().position[0][2], 4.);
+  p.sync_arrays();
+  COMPARE(p.arrays().position[0][2], 8.);
+
+  p.reset();
+  COMPARE(p.arrays().size(), 0u);
+}
+
+TEST(checkpoint_round_trip) {
+  Particles p;
+  for (int i = 0; i < 5; i++) {
+    p.insert(Test::smashon(Test::Momentum{1, 0, 0, 0.1 * i},
+                           Test::Position{0, 1, 2, 1. * i}));
+  }
+  p.remove(p.copy_to_vector()[1]);
+  std::stringstream checkpoint;
+  p.write_checkpoint(checkpoint);
+
+  Particles restored;
+  restored.insert(Test::smashon_random());
+  restored.enable_arrays();
+  restored.read_checkpoint(checkpoint);
+  COMPARE(restored.size(), 4u);
+  const ParticleList original = p.copy_to_vector();
+  const ParticleList copy = restored.copy_to_vector();
+  for (std::size_t i = 0; i < original.size(); i++) {
+    COMPARE(copy[i].id(), original[i].id());
+    COMPARE(copy[i].momentum(), original[i].momentum());
+    COMPARE(copy[i].position(), original[i].position());
+    COMPARE(copy[i].type(), original[i].type());
+  }
+  COMPARE(restored.arrays().valid[1], 0);
+  // The hole is reused and the ids continue as in the original
+  COMPARE(restored.insert(Test::smashon_random()).id(),
+          p.insert(Test::smashon_random()).id());
+  COMPARE(restored.size(), 5u);
+}
+
+TEST(sort_spatially) {
+  Particles p;
+  for (int i = 0; i < 6; i++) {
+    p.insert(Test::smashon(Test::Position{0, 5. - i, 0, 0}));
+  }
+  const ParticleList copy = p.copy_to_vector();
+  p.remove(copy[1]);
+  // a hole and all particles added since the start
+  FUZZY_COMPARE(p.disorder(), 7. / 6.);
+  p.enable_arrays();
+
+  p.sort_spatially(1.);
+  COMPARE(p.size(), 5u);
+  COMPARE(p.disorder(), 0.);
+  VERIFY(!p.is_valid(copy[0]));
+  // along one axis, the Morton order is the order of the positions
+  const ParticleList sorted = p.copy_to_vector();
+  const std::vector<int> expected_ids = {5, 4, 3, 2, 0};
+  for (std::size_t i = 0; i < sorted.size(); i++) {
+    COMPARE(sorted[i].id(), expected_ids[i]);
+    VERIFY(p.is_valid(sorted[i]));
+  }
+  COMPARE(p.arrays().size(), 5u);
+  COMPARE(p.arrays().position[1][0], 0.);
+  COMPARE(p.arrays().position[1][4], 5.);
+
+  // new particles are appended
+  const ParticleData &inserted = p.insert(copy[1]);
+  COMPARE(inserted.id(), 6);
+  FUZZY_COMPARE(p.disorder(), 1. / 6.);
+}
+
+TEST_CATCH(sort_spatially_without_cells, std::invalid_argument) {
+  Particles p;
+  p.sort_spatially(0.);
+}
+
+TEST(relocate) {
+  Particles p;
+  for (int i = 0; i < 4; i++) {
+    p.insert(Test::smashon(Test::Position{0, 1. * i, 0, 0}));
+  }
+  const ParticleList copy = p.copy_to_vector();
+  p.remove(copy[2]);
+  p.enable_arrays();
+
+  p.relocate();
+  COMPARE(p.size(), 3u);
+  VERIFY(p.is_valid(copy[0]));
+  VERIFY(!p.is_valid(copy[2]));
+  COMPARE(p.arrays().size(), 3u);
+  COMPARE(p.arrays().position[1][2], 3.);
+  // the hole is still reused
+  p.insert(copy[2]);
+  const std::vector<int> expected_ids = {0, 1, 4, 3};
+  const ParticleList relocated = p.copy_to_vector();
+  for (std::size_t i = 0; i < relocated.size(); i++) {
+    COMPARE(relocated[i].id(), expected_ids[i]);
+  }
+}
+
+TEST(copy_from) {
+  Particles initial;
+  for (int i = 0; i < 4; i++) {
+    initial.insert(Test::smashon(Test::Position{0, 1. * i, 0, 0}));
+  }
+  const ParticleList copy = initial.copy_to_vector();
+  initial.remove(copy[1]);
+
+  Particles p;
+  p.enable_arrays();
+  for (int i = 0; i < 7; i++) {
+    p.insert(Test::smashon(Test::Position{0, -1. * i, 0, 0}));
+  }
+  p.copy_from(initial);
+  COMPARE(p.size(), 3u);
+  VERIFY(p.is_valid(copy[0]));
+  VERIFY(!p.is_valid(copy[1]));
+  COMPARE(p.arrays().size(), 4u);
+  COMPARE(p.arrays().position[1][3], 3.);
+  // the hole and the ids continue as in the original
+  const ParticleData &inserted = p.insert(copy[1]);
+  COMPARE(inserted.id(), 4);
+  COMPARE(p.size(), 4u);
+  COMPARE(p.arrays().size(), 4u);
+  VERIFY(p.arrays().valid[1]);
+}
+
+TEST(partition) {
+  Particles p;
+  for (int i = 0; i < 10; i++) {
+    p.insert(Test::smashon(Test::Position{0, 1. * i, 0, 0}));
+  }
+  const ParticleList copy = p.copy_to_vector();
+  // holes at the beginning and at a boundary of the ranges
+  p.remove(copy[0]);
+  p.remove(copy[3]);
+  for (const int n : {1, 3, 4, 20}) {
+    const std::vector<Particles::iterator> bounds = p.partition(n);
+    COMPARE(bounds.size(), n + 1u);
+    VERIFY(bounds.front() == p.begin());
+    VERIFY(bounds.back() == p.end());
+    std::vector<int> ids;
+    for (int i = 0; i < n; i++) {
+      VERIFY(bounds[i] <= bounds[i + 1]);
+      for (auto it = bounds[i]; it != bounds[i + 1]; ++it) {
+        ids.push_back(it->id());
+      }
+    }
+    COMPARE(ids, (std::vector<int>{1, 2, 4, 5, 6, 7, 8, 9}));
+  }
+}
+
+TEST(boost_momenta) {
+  Particles p;
+  p.enable_arrays();
+  for (int i = 0; i < 5; i++) {
+    p.insert(Test::smashon(Test::Momentum{1., 0.1 * i, -0.2, 0.3}));
+  }
+  p.remove(p.front());
+  const ParticleList before = p.copy_to_vector();
+  const ThreeVector beta(0.1, -0.4, 0.5);
+  p.boost_momenta(beta);
+  const ParticleArrays &arrays = p.arrays();
+  std::size_t i = 1;  // the first entry is a hole
+  for (const ParticleData &original : before) {
+    const FourVector expected = original.momentum().lorentz_boost(beta);
+    COMPARE(p.lookup(original).momentum(), expected);
+    VERIFY(arrays.valid[i]);
+    for (int mu = 0; mu < 4; mu++) {
+      FUZZY_COMPARE(arrays.momentum[mu][i], expected[mu]);
+    }
+    i++;
+  }
+}
@@ -0,0 +1,65 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/particlesnapshot.h"
+
+#include <cstdint>
+#include <filesystem>
+
+#include "setup.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+static sha256::Hash make_hash(std::uint8_t first_byte) {
+  sha256::Hash hash{};
+  hash[0] = first_byte;
+  return hash;
+}
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(init_particle_types) {
+  Test::create_actual_particletypes();
+  Test::create_actual_decaymodes();
+}
+
+TEST(missing_snapshot_is_not_read) {
+  VERIFY(!ParticleSnapshot::read(testoutputpath, make_hash(1)));
+}
+
+TEST(write_snapshot) {
+  const sha256::Hash hash = make_hash(2);
+  ParticleSnapshot::write(testoutputpath, hash);
+  const std::filesystem::path path =
+      ParticleSnapshot::path(testoutputpath, hash);
+  VERIFY(std::filesystem::exists(path));
+  // Every type needs at least its name length, mass, width, parity and code.
+  VERIFY(std::filesystem::file_size(path) >
+         ParticleType::list_all().size() * 25);
+
+  // A snapshot of other input files is not read.
+  std::filesystem::copy_file(
+      path, ParticleSnapshot::path(testoutputpath, make_hash(3)));
+  VERIFY(!ParticleSnapshot::read(testoutputpath, make_hash(3)));
+  VERIFY(std::filesystem::remove(
+      ParticleSnapshot::path(testoutputpath, make_hash(3))));
+
+  // A damaged snapshot is not read.
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+  VERIFY(!ParticleSnapshot::read(testoutputpath, hash));
+  VERIFY(std::filesystem::remove(path));
+}
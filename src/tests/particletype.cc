@@ -272,3 +272,16 @@ TEST(exists) {
 
   VERIFY(!ParticleType::exists(0x667));  // ttbar
 }
+
+TEST(try_find_index) {
+  const auto &types = ParticleType::list_all();
+  for (std::size_t i = 0; i < types.size(); i++) {
+    const ParticleTypePtr found = ParticleType::try_find(types[i].pdgcode());
+    VERIFY(found);
+    COMPARE(found.index(), i);
+    COMPARE(found, &types[i]);
+  }
+  VERIFY(!ParticleType::try_find(0x667));
+  VERIFY(!ParticleType::try_find(PdgCode::invalid()));
+  COMPARE(ParticleTypePtr().index(), 0xffff);
+}
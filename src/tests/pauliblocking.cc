@@ -113,3 +113,54 @@ TEST(phase_space_density_nucleus) {
     std::cout << 0.5 / 100 * i << "  " << f << std::endl;
   }
 }
+
+TEST(phase_space_density_with_index) {
+  std::map<PdgCode, int> list = {{0x2212, 79}, {0x2112, 118}};
+  const int Ntest = 20;
+  Nucleus Au(list, Ntest);
+  Au.set_parameters_automatic();
+  Au.arrange_nucleons();
+  Au.generate_fermi_momenta();
+  std::vector<Particles> part_Au(1);
+  Au.copy_particles(&part_Au[0]);
+
+  ExperimentParameters param = smash::Test::default_parameters(Ntest);
+  PauliBlocker loop(get_pauli_blocking_conf(), param);
+  PauliBlocker indexed(get_pauli_blocking_conf(), param);
+  indexed.build_index(part_Au, 0.);
+  Configuration cells_conf = get_pauli_blocking_conf();
+  cells_conf.set_value({"Momentum_Cells"}, true);
+  PauliBlocker cells(std::move(cells_conf), param);
+  cells.build_index(part_Au, 0.);
+
+  const PdgCode pdg = 0x2212;
+  auto compare_densities = [&](const ParticleList &disregard) {
+    for (int i = 0; i < 20; i++) {
+      const ThreeVector r(0.4 * i - 4., 0.1 * i, -0.2 * i);
+      const ThreeVector p(0.0, 0.0, 0.01 * i);
+      const double f = loop.phasespace_dens(r, p, part_Au, pdg, disregard);
+      COMPARE(indexed.phasespace_dens(r, p, part_Au, pdg, disregard), f);
+      COMPARE(cells.phasespace_dens(r, p, part_Au, pdg, disregard), f);
+    }
+  };
+  compare_densities({});
+  compare_densities({part_Au[0].front()});
+
+  // replace a proton by a neutron at another place
+  ParticleList removed{part_Au[0].front()};
+  ParticleList added{ParticleData{ParticleType::find(0x2112)}};
+  added[0].set_4position(FourVector(0., 1., 1., 1.));
+  part_Au[0].replace(removed, added);
+  indexed.update_index(0, removed, added);
+  cells.update_index(0, removed, added);
+  compare_densities({});
+
+  // give a nucleon another momentum
+  removed = {part_Au[0].back()};
+  added = {removed[0]};
+  added[0].set_4momentum(0.938, 0., 0., 0.05);
+  part_Au[0].replace(removed, added);
+  indexed.update_index(0, removed, added);
+  cells.update_index(0, removed, added);
+  compare_densities({});
+}
@@ -270,6 +270,113 @@ TEST(propagation_in_test_potential) {
       << P2[0].front().momentum().velocity().x3();
 }
 
+TEST(update_momenta_sees_particles_before_the_update) {
+  /* The force of this potential is proportional to the total momentum of all
+   * particles, such that it changes as soon as one momentum is updated. */
+  class Total_Momentum_Pot : public Potentials {
+   public:
+    explicit Total_Momentum_Pot(const ExperimentParameters& param)
+        : Potentials(Configuration{""}, param) {}
+
+    std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector> all_forces(
+        const ThreeVector&, const ParticleList& plist) const override {
+      ThreeVector total;
+      for (const ParticleData& data : plist) {
+        total += data.momentum().threevec();
+      }
+      return std::make_tuple(total, ThreeVector(), ThreeVector(),
+                             ThreeVector());
+    }
+
+    bool use_skyrme() const override { return true; }
+  };
+
+  ExperimentParameters param = smash::Test::default_parameters();
+  const Total_Momentum_Pot pot(param);
+  const double dt = 0.1;
+  for (const int n_threads : {1, 3}) {
+    std::vector<Particles> ensembles(3);
+    for (int i = 0; i < 6; i++) {
+      ParticleData part = create_proton();
+      part.set_4momentum(0.938, 0.1 * i, -0.2, 0.05 * i);
+      // all particles are within the smearing range of each other
+      part.set_4position(FourVector(0.0, 0.5 * i, 0.0, 0.0));
+      ensembles[i % 3].insert(part);
+    }
+    // sum of the momenta of all six protons
+    const ThreeVector expected_force(1.5, -1.2, 0.75);
+    update_momenta(ensembles, dt, pot, nullptr, nullptr, nullptr, nullptr,
+                   n_threads);
+    for (int i_ens = 0; i_ens < 3; i_ens++) {
+      int i = i_ens;
+      for (const ParticleData& part : ensembles[i_ens]) {
+        const ThreeVector expected =
+            ThreeVector(0.1 * i, -0.2, 0.05 * i) + expected_force * dt;
+        COMPARE_ABSOLUTE_ERROR(part.momentum().x1(), expected.x1(), 1.e-12)
+            << n_threads;
+        COMPARE_ABSOLUTE_ERROR(part.momentum().x2(), expected.x2(), 1.e-12)
+            << n_threads;
+        COMPARE_ABSOLUTE_ERROR(part.momentum().x3(), expected.x3(), 1.e-12)
+            << n_threads;
+        i += 3;
+      }
+    }
+  }
+}
+
+TEST(two_half_kicks_make_one_update_of_the_momenta) {
+  class Constant_Pot : public Potentials {
+   public:
+    explicit Constant_Pot(const ExperimentParameters& param)
+        : Potentials(Configuration{""}, param) {}
+
+    std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector> all_forces(
+        const ThreeVector&, const ParticleList&) const override {
+      return std::make_tuple(ThreeVector(0.3, -0.1, 0.2), ThreeVector(),
+                             ThreeVector(), ThreeVector());
+    }
+
+    bool use_skyrme() const override { return true; }
+  };
+
+  ExperimentParameters param = smash::Test::default_parameters();
+  const Constant_Pot pot(param);
+  const double dt = 0.1;
+  auto create_ensembles = []() {
+    std::vector<Particles> ensembles(2);
+    for (int i = 0; i < 4; i++) {
+      ParticleData part = i == 3 ? ParticleData{ParticleType::find(0x211)}
+                                 : create_proton();
+      part.set_4momentum(part.pole_mass(), 0.1 * i, -0.2, 0.05 * i);
+      part.set_4position(FourVector(0.0, 0.5 * i, 0.0, 0.0));
+      ensembles[i % 2].insert(part);
+    }
+    return ensembles;
+  };
+  std::vector<Particles> kicked = create_ensembles();
+  std::vector<Particles> updated = create_ensembles();
+
+  const ParticleForces forces =
+      compute_forces(kicked, pot, nullptr, nullptr, nullptr, nullptr);
+  // computing the forces leaves the momenta alone
+  COMPARE(kicked[1].back().momentum().x1(), 0.3);
+  // the pion is not affected by the potentials
+  VERIFY(!forces[1].back());
+  kick_momenta(kicked, forces, 0.5 * dt);
+  kick_momenta(kicked, forces, 0.5 * dt);
+  update_momenta(updated, dt, pot, nullptr, nullptr, nullptr, nullptr);
+  for (int i_ens = 0; i_ens < 2; i_ens++) {
+    auto part = kicked[i_ens].cbegin();
+    for (const ParticleData& expected : updated[i_ens]) {
+      for (int mu = 0; mu < 4; mu++) {
+        COMPARE_ABSOLUTE_ERROR(part->momentum()[mu], expected.momentum()[mu],
+                               1.e-12);
+      }
+      ++part;
+    }
+  }
+}
+
 /*
  * The idea is to compute potentials from the same set of particles,
  * but in one case they are testparticles in one ensemble, while in the
@@ -421,6 +528,46 @@ TEST(energy_gradient_vs_pot_gradient) {
   COMPARE_RELATIVE_ERROR(-energy_grad[2], force_chain_rule[2], 0.001);
 };
 
+/*
+ * The single-particle energy in the calculation frame is the energy component
+ * of the effective four-momentum, which is the boost of the effective
+ * four-momentum in the local rest frame.
+ */
+TEST(calculation_frame_energy_is_covariant) {
+  const char* conf_pot{R"(
+    Skyrme:
+        Skyrme_A: -209.2
+        Skyrme_B: 156.4
+        Skyrme_Tau: 1.35
+    Momentum_Dependence:
+        C: -63.5
+        Lambda: 2.13
+  )"};
+  Configuration conf{conf_pot};
+  ExperimentParameters exp_par = Test::default_parameters();
+  DensityParameters denspar(exp_par);
+  Potentials pot(std::move(conf), denspar);
+
+  const double mass = 0.938;
+  const FourVector jmu_rest(0.2, 0., 0., 0.);
+  for (const ThreeVector& beta :
+       {ThreeVector(0., 0., 0.5), ThreeVector(0.3, -0.4, 0.2)}) {
+    for (const ThreeVector& p_rest :
+         {ThreeVector(0., 0., 0.), ThreeVector(0.1, 0.2, -0.3),
+          ThreeVector(1.5, 0., 0.4)}) {
+      const double energy_rest =
+          pot.calculation_frame_energy(p_rest, jmu_rest, mass);
+      const FourVector p_calc =
+          FourVector(energy_rest, p_rest).lorentz_boost(-beta);
+      const FourVector jmu_calc = jmu_rest.lorentz_boost(-beta);
+      COMPARE_RELATIVE_ERROR(
+          pot.calculation_frame_energy(p_calc.threevec(), jmu_calc, mass),
+          p_calc.x0(), 1e-10)
+          << " for p_rest = " << p_rest << ", beta = " << beta;
+    }
+  }
+}
+
 // create experiment parameters for tests with VDF
 static ExperimentParameters default_parameters_vdf(
     int testparticles = 1, double dt = 0.1,
@@ -563,13 +710,6 @@ TEST(vdf_chain_rule_derivatives_vs_vdf_direct_derivatives) {
   std::unique_ptr<RectangularLattice<FourVector>> old_jmu_aux =
       std::make_unique<RectangularLattice<FourVector>>(
           l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-  std::unique_ptr<RectangularLattice<FourVector>> new_jmu_aux =
-      std::make_unique<RectangularLattice<FourVector>>(
-          l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-  std::unique_ptr<RectangularLattice<std::array<FourVector, 4>>>
-      four_gradient_aux =
-          std::make_unique<RectangularLattice<std::array<FourVector, 4>>>(
-              l, n, origin, periodic, LatticeUpdate::EveryTimestep);
 
   std::unique_ptr<DensityLattice> jmu_B_lattice =
       std::make_unique<DensityLattice>(l, n, origin, periodic,
@@ -607,9 +747,8 @@ TEST(vdf_chain_rule_derivatives_vs_vdf_direct_derivatives) {
           RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
           l, n, origin, periodic, LatticeUpdate::EveryTimestep);
 
-  update_lattice(jmu_B_lattice.get(), old_jmu_aux.get(), new_jmu_aux.get(),
-                 four_gradient_aux.get(), LatticeUpdate::EveryTimestep,
-                 DensityType::Baryon, par, P,
+  update_lattice(jmu_B_lattice.get(), old_jmu_aux.get(),
+                 LatticeUpdate::EveryTimestep, DensityType::Baryon, par, P,
                  param.labclock->timestep_duration(), true);
 
   update_fields_lattice(fields_lattice.get(), old_fields_aux.get(),
@@ -968,13 +1107,6 @@ TEST(spinodal_dilute) {
   std::unique_ptr<RectangularLattice<FourVector>> old_jmu_auxiliary_df =
       std::make_unique<RectangularLattice<FourVector>>(
           l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-  std::unique_ptr<RectangularLattice<FourVector>> new_jmu_auxiliary_df =
-      std::make_unique<RectangularLattice<FourVector>>(
-          l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-  std::unique_ptr<RectangularLattice<std::array<FourVector, 4>>>
-      four_gradient_auxiliary_df =
-          std::make_unique<RectangularLattice<std::array<FourVector, 4>>>(
-              l, n, origin, periodic, LatticeUpdate::EveryTimestep);
 
   std::unique_ptr<DensityLattice> jmu_B_lat_df =
       std::make_unique<DensityLattice>(l, n, origin, periodic,
@@ -1004,7 +1136,6 @@ TEST(spinodal_dilute) {
     }
 
     update_lattice(jmu_B_lat_df.get(), old_jmu_auxiliary_df.get(),
-                   new_jmu_auxiliary_df.get(), four_gradient_auxiliary_df.get(),
                    LatticeUpdate::EveryTimestep, DensityType::Baryon, par, P,
                    dt, true);
     if (i == 0) {
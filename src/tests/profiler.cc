@@ -0,0 +1,141 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/profiler.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace smash;
+using namespace std::chrono_literals;
+
+static const std::size_t grid_update =
+    static_cast<std::size_t>(ProfiledPhase::GridUpdate);
+static const std::size_t action_finding =
+    static_cast<std::size_t>(ProfiledPhase::ActionFinding);
+
+TEST(disabled) {
+  Profiler profiler;
+  VERIFY(!profiler.enabled());
+  { ScopedTimer timer(profiler, ProfiledPhase::GridUpdate); }
+  profiler.end_event();
+  COMPARE(profiler.run_calls(grid_update), 0u);
+}
+
+TEST(nested_timers_are_exclusive) {
+  Profiler profiler;
+  profiler.set_enabled(true);
+  {
+    ScopedTimer outer(profiler, ProfiledPhase::GridUpdate);
+    for (int i = 0; i < 2; i++) {
+      ScopedTimer inner(profiler, ProfiledPhase::ActionFinding);
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+  const std::string event = profiler.end_event();
+  COMPARE(profiler.run_calls(grid_update), 1u);
+  COMPARE(profiler.run_calls(action_finding), 2u);
+  VERIFY(profiler.run_time(action_finding) >= 20ms);
+  VERIFY(profiler.run_time(grid_update) < profiler.run_time(action_finding));
+  // The slowest phase comes first, phases that were not entered are left out.
+  VERIFY(event.find("Action finding") < event.find("Grid update")) << event;
+  COMPARE(event.find("Lattice update"), std::string::npos) << event;
+}
+
+TEST(events_add_up) {
+  Profiler profiler;
+  profiler.set_enabled(true);
+  const std::size_t output = profiler.add_phase("Output Particles Oscar2013");
+  for (int event = 0; event < 3; event++) {
+    ScopedTimer timer(profiler, output);
+    std::this_thread::sleep_for(1ms);
+  }
+  profiler.end_event();
+  { ScopedTimer timer(profiler, output); }
+  profiler.end_event();
+  COMPARE(profiler.run_calls(output), 4u);
+  VERIFY(profiler.run_report().find("Output Particles Oscar2013") !=
+         std::string::npos);
+
+  std::ostringstream json;
+  profiler.write_json(json);
+  const std::string s = json.str();
+  VERIFY(s.find("\"run\": {\n    \"Output Particles Oscar2013\": "
+                "{\"seconds\": ") != std::string::npos)
+      << s;
+  VERIFY(s.find("\"calls\": 4}") != std::string::npos) << s;
+  VERIFY(s.find("\"calls\": 3}") != std::string::npos) << s;
+  VERIFY(s.find("\"calls\": 1}") != std::string::npos) << s;
+}
+
+TEST(startup_stages) {
+  Profiler &profiler = startup_profiler();
+  VERIFY(profiler.enabled());
+  {
+    ScopedTimer outer(profiler, StartupStage::Experiment);
+    ScopedTimer inner(profiler, StartupStage::Outputs);
+    std::this_thread::sleep_for(2ms);
+  }
+  const std::string report = profiler.end_event();
+  COMPARE(profiler.run_calls(static_cast<std::size_t>(StartupStage::Outputs)),
+          1u);
+  VERIFY(report.find("Outputs") < report.find("Experiment setup")) << report;
+  COMPARE(report.find("Grid update"), std::string::npos) << report;
+  VERIFY(profiler.elapsed() >= 2ms);
+}
+
+TEST(concurrent_timers) {
+  Profiler profiler;
+  profiler.set_enabled(true);
+  auto work = [&]() {
+    for (int i = 0; i < 1000; i++) {
+      ScopedTimer timer(profiler, ProfiledPhase::MomentumUpdate);
+    }
+  };
+  std::thread other(work);
+  work();
+  other.join();
+  profiler.end_event();
+  COMPARE(profiler.run_calls(
+              static_cast<std::size_t>(ProfiledPhase::MomentumUpdate)),
+          2000u);
+}
+
+TEST(trace) {
+  Profiler profiler;
+  profiler.set_enabled(true);
+  profiler.set_tracing(true);
+  auto work = [&]() {
+    ScopedTimer outer(profiler, ProfiledPhase::TimeStep);
+    ScopedTimer inner(profiler, ProfiledPhase::ActionExecution);
+  };
+  std::thread other(work);
+  other.join();
+  profiler.end_event();
+  work();
+
+  std::ostringstream trace;
+  profiler.write_trace(trace);
+  const std::string s = trace.str();
+  VERIFY(s.find("\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+                "\"tid\": 1") != std::string::npos)
+      << s;
+  VERIFY(s.find("\"name\": \"Time step\", \"ph\": \"X\", \"pid\": 1, "
+                "\"tid\": 0") != std::string::npos)
+      << s;
+  VERIFY(s.find("\"name\": \"Action execution\", \"ph\": \"X\", \"pid\": 1, "
+                "\"tid\": 1") != std::string::npos)
+      << s;
+  VERIFY(s.find("\"args\": {\"event\": 0}") != std::string::npos) << s;
+  VERIFY(s.find("\"args\": {\"event\": 1}") != std::string::npos) << s;
+}
@@ -76,6 +76,51 @@ TEST(propagate_default_no_potentials) {
           FourVector(1.0, 0.2 - 0.3 / 0.51, 0.0, 4.8 + 0.4 / 0.51));
 }
 
+TEST(propagate_on_threads) {
+  // enough particles for several threads, with holes in the storage
+  Particles serial, threaded;
+  for (int i = 0; i < 20000; i++) {
+    const ParticleData p =
+        Test::smashon(Position{0.5, 0.001 * i, 0.0, -0.002 * i},
+                      Momentum{1.0, 0.1 * (i % 7), 0.2, -0.3});
+    serial.insert(p);
+    threaded.insert(p);
+  }
+  for (const ParticleData &p : serial.copy_to_vector()) {
+    if (p.id() % 5 == 0) {
+      serial.remove(p);
+      threaded.remove(p);
+    }
+  }
+  const double dt = propagate_straight_line(&serial, 2.0, {});
+  COMPARE(propagate_straight_line(&threaded, 2.0, {}, 4), dt);
+  COMPARE(dt, 1.5);
+  COMPARE(threaded.size(), serial.size());
+  auto it = threaded.begin();
+  for (const ParticleData &p : serial) {
+    COMPARE(it->id(), p.id());
+    COMPARE(it->position(), p.position());
+    ++it;
+  }
+}
+
+TEST(propagate_single_particle) {
+  auto particles = create_box_particles();
+  // the particles are propagated in two steps, the copies at once
+  const ParticleList copies = particles->copy_to_vector();
+  propagate_straight_line(particles.get(), 0.4, {});
+  propagate_straight_line(particles.get(), 1.0, {});
+  auto it = particles->begin();
+  for (ParticleData copy : copies) {
+    COMPARE(propagate_straight_line(&copy, 1.0, {}), 1.0);
+    COMPARE(copy.position().x0(), 1.0);
+    COMPARE_ABSOLUTE_ERROR(copy.position().x1(), it->position().x1(), 1e-12);
+    COMPARE_ABSOLUTE_ERROR(copy.position().x2(), it->position().x2(), 1e-12);
+    COMPARE_ABSOLUTE_ERROR(copy.position().x3(), it->position().x3(), 1e-12);
+    ++it;
+  }
+}
+
 TEST(hubble) {
   // setting up some exeplary metrics with simple b_ for
   // easy analytic values. All ExpansionModes are tested.
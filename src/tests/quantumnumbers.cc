@@ -182,3 +182,22 @@ TEST(count_from_particles) {
           "Deviation in Baryon Number:\n"
           " 1 vs. 0\n");
 }
+
+TEST(track_changes) {
+  // The changes by replacing particles add up to the recounted values.
+  ParticleData particleP(ParticleType::find(PdgCode("123")));
+  particleP.set_4momentum(FourVector(1, 2, 3, 4));
+  ParticleData particleR(ParticleType::find(PdgCode("2346")));
+  particleR.set_4momentum(FourVector(3, 4, 5, 6));
+  ParticleData particleS(ParticleType::find(PdgCode("-1234568")));
+  particleS.set_4momentum(FourVector(-6, -9, -12, -15));
+
+  QuantumNumbers current(ParticleList{particleP, particleR});
+  QuantumNumbers change;
+  change.add_values(particleS);
+  change.subtract_values(particleP);
+  current += change;
+  COMPARE(current, QuantumNumbers(ParticleList{particleR, particleS}));
+  COMPARE(change, QuantumNumbers(FourVector(-7, -11, -15, -19), -2, -2, 0, -1,
+                                 1, -1));
+}
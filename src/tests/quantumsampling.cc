@@ -185,3 +185,31 @@ TEST(sample_fermi_distribution) {
       },
       "quantum_sampling.dat");
 }
+
+TEST(sample_bose_distribution) {
+  PdgCode pi_plus(0x211);
+  const int number_of_pions = 35;
+  std::map<PdgCode, int> init_mult = {{pi_plus, number_of_pions}};
+  const double V = 1000.0,  // fm^3
+      T = 0.15;             // GeV
+  ChemicalPotentialSolver mu_solver;
+  const QuantumSampling sampler(init_mult, V, T);
+
+  const double dmomentum = 0.01;  // GeV
+  Histogram1d hist(dmomentum);
+  constexpr int N_TEST = 1E6;  // number of samples
+  hist.populate(N_TEST, [&]() { return sampler.sample(pi_plus); });
+  const double g = pi_plus.spin_degeneracy(),
+               m = ParticleType::find(pi_plus).mass(),
+               n = number_of_pions / V * hbarc * hbarc * hbarc, stat = -1.0,
+               mu = mu_solver.effective_chemical_potential(g, m, n, T, stat,
+                                                           1.e-6);
+  hist.test([&](double p) {
+    return p * p / (std::exp((std::sqrt(p * p + m * m) - mu) / T) - 1.0);
+  });
+}
+
+TEST_CATCH(sample_unknown_species, std::out_of_range) {
+  const QuantumSampling sampler({{PdgCode(0x2212), 10}}, 50.0, 0.1);
+  sampler.sample(PdgCode(0x211));
+}
@@ -12,6 +12,7 @@
 #include "smash/random.h"
 
 #include <cinttypes>
+#include <sstream>
 
 #include "histogram.h"
 
@@ -125,3 +126,98 @@ TEST(beta_a0) {
       N_TEST, 0.001, [&]() { return random::beta_a0(xmin, b); },
       [&](double x) { return std::pow(1.0 - x, b) / x; });
 }
+
+TEST(streams_are_reproducible_and_distinct) {
+  random::Engine stream_a = random::make_stream(42, 0);
+  random::Engine stream_b = random::make_stream(42, 0);
+  random::Engine stream_c = random::make_stream(42, 1);
+  random::Engine stream_d = random::make_stream(43, 0);
+  for (int i = 0; i < 1000; i++) {
+    const auto a = stream_a();
+    COMPARE(a, stream_b());
+    VERIFY(a != stream_c());
+    VERIFY(a != stream_d());
+  }
+}
+
+TEST(scoped_engine_restores_thread_engine) {
+  random::set_seed(12345);
+  random::Engine reference(12345);
+  random::Engine stream = random::make_stream(12345, 7);
+  random::Engine stream_copy = stream;
+  {
+    random::ScopedEngine use_stream(stream);
+    COMPARE(random::advance(), stream_copy());
+    COMPARE(random::advance(), stream_copy());
+  }
+  // the thread engine continues unaltered and the stream kept its state
+  COMPARE(random::advance(), reference());
+  COMPARE(stream(), stream_copy());
+}
+
+TEST(explicit_stream_distributions) {
+  random::Engine stream_1 = random::make_stream(2024, 3);
+  random::Engine stream_2 = stream_1;
+  random::set_seed(1);
+  auto uniform_1 = random::make_uniform_distribution(0., 3.);
+  auto uniform_2 = random::make_uniform_distribution(0., 3.);
+  random::discrete_dist<double> discrete_1({0.2, 0.3, 0.5});
+  random::discrete_dist<double> discrete_2({0.2, 0.3, 0.5});
+  random::BesselSampler bessel_1(1.5, 2.5, 1), bessel_2(1.5, 2.5, 1);
+  for (int i = 0; i < 1000; i++) {
+    COMPARE(uniform_1(stream_1), uniform_2(stream_2));
+    COMPARE(discrete_1(stream_1), discrete_2(stream_2));
+    COMPARE(bessel_1.sample(stream_1), bessel_2.sample(stream_2));
+  }
+  // drawing from explicit streams leaves the thread engine untouched
+  random::Engine reference(1);
+  COMPARE(random::advance(), reference());
+}
+
+TEST(buffered_engine_streams) {
+  random::BufferedEngine a(42), b(42), c(43);
+  // beyond the first refill of the buffer
+  for (std::size_t i = 0; i < 3 * random::BufferedEngine::buffer_size; i++) {
+    const auto x = a();
+    COMPARE(x, b());
+    VERIFY(x != c());
+  }
+  VERIFY(a == b);
+  VERIFY(a != c);
+  b.seed(42);
+  VERIFY(a != b);
+}
+
+TEST(buffered_engine_state_io) {
+  random::BufferedEngine engine(2024);
+  for (int i = 0; i < 100; i++) {
+    engine();
+  }
+  std::stringstream state;
+  state << engine;
+  random::BufferedEngine restored;
+  state >> restored;
+  VERIFY(!state.fail());
+  VERIFY(restored == engine);
+  for (std::size_t i = 0; i < 2 * random::BufferedEngine::buffer_size; i++) {
+    COMPARE(restored(), engine());
+  }
+
+  // an invalid state leaves the engine unchanged
+  std::stringstream invalid("1 2 3");
+  invalid >> restored;
+  VERIFY(invalid.fail());
+  VERIFY(restored == engine);
+}
+
+TEST(canonical_from_bits) {
+  random::BufferedEngine engine(7);
+  test_distribution(
+      N_TEST, 0.0001,
+      [&]() { return random::canonical_from_bits<double>(engine); },
+      [](double) { return 1.0; });
+  for (int i = 0; i < 1000; i++) {
+    const double x = random::canonical_from_bits<double>(engine);
+    VERIFY(x >= 0. && x < 1.);
+  }
+}
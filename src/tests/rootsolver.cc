@@ -18,3 +18,20 @@ TEST(root_of_cosine) {
   VERIFY(hopefully_pi_half.has_value());
   COMPARE_ABSOLUTE_ERROR(*hopefully_pi_half, M_PI / 2.0, 1e-7);
 }
+
+TEST(root_without_sign_change) {
+  RootSolver1D rootsolver([](double x) { return x * x + 1.; });
+  VERIFY(!rootsolver.try_find_root(-1., 1., 10000).has_value());
+}
+
+TEST(root_of_lambda_with_reused_solver) {
+  const double exponent = 3.;
+  const auto equation = [exponent](double x) {
+    return std::pow(x, exponent) - 2.;
+  };
+  for (double high : {2., 10., 100.}) {
+    const auto root = RootSolver1D::find_root(equation, 0.5, high, 10000);
+    VERIFY(root.has_value());
+    COMPARE_RELATIVE_ERROR(*root, std::cbrt(2.), 1e-7);
+  }
+}
@@ -502,6 +502,42 @@ TEST_CATCH(add_branches_only_once, std::logic_error) {
   act_bottomup->add_all_scatterings(finder_parameters_bottomup);
 }
 
+TEST_CATCH(lazy_branches_bottomup, std::logic_error) {
+  ParticleData particle{ParticleType::find(0x111)};  // pi0
+  ScatterActionPtr act_bottomup = std::make_unique<ScatterAction>(
+      particle, particle, 0.1, false, 1.0, -1.0, false);
+  const auto finder_parameters_bottomup = Test::default_finder_parameters();
+  act_bottomup->add_all_scatterings_lazily(finder_parameters_bottomup);
+}
+
+TEST(lazy_branches_added_for_final_state) {
+  ParticleData p1{ParticleType::find(0x211)};   // pi+
+  ParticleData p2{ParticleType::find(0x2212)};  // p
+  p1.set_4position(pos_a);
+  p2.set_4position(pos_b);
+  p1.set_4momentum(p1.pole_mass(), 0.3, 0., 0.);
+  p2.set_4momentum(p2.pole_mass(), -0.3, 0., 0.);
+  ScatterActionPtr act =
+      std::make_unique<ScatterAction>(p1, p2, 0.1, false, 1.0, -1.0, true);
+  auto string_process_interface = Test::default_string_process_interface();
+  act->set_string_interface(string_process_interface.get());
+  const auto finder_parameters_topdown = Test::default_finder_parameters(
+      0, NNbarTreatment::Strings, Test::all_reactions_included(), true, true,
+      true, TotalCrossSectionStrategy::TopDown);
+  act->set_parametrized_total_cross_section(finder_parameters_topdown);
+  act->add_all_scatterings_lazily(finder_parameters_topdown);
+  VERIFY(act->collision_channels().empty());
+
+  act->generate_final_state();
+  VERIFY(!act->collision_channels().empty());
+  double sum_partials = 0;
+  for (const auto& proc : act->collision_channels()) {
+    sum_partials += proc->weight();
+  }
+  vir::test::setFuzzyness<double>(5);
+  FUZZY_COMPARE(sum_partials, act->cross_section());
+}
+
 TEST(top_down_sum_matches_parametrization) {
   const auto& all_types = ParticleType::list_all();
   int ntypes = all_types.size();
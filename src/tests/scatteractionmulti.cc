@@ -141,6 +141,55 @@ TEST(deuteron_three_to_two) {
          ProcessType::MultiParticleThreeToTwo);
 }
 
+TEST(reaction_masks) {
+  const MultiParticleReactionsBitSet incl_all_multi_set =
+      MultiParticleReactionsBitSet().set();
+  auto mask = [&](PdgCode pdg) {
+    return ScatterActionMulti::reaction_mask(ParticleType::find(pdg),
+                                             incl_all_multi_set);
+  };
+  const std::uint8_t three = ScatterActionMulti::reaction_families(3);
+  // η and nucleons have no 3-body reaction in common
+  COMPARE(mask(0x221) & mask(0x2212) & three, 0);
+  // Λ and Λ̅ do not form the same nucleus
+  COMPARE(mask(0x3122) & mask(-0x3122), 0);
+  // The mesons are no part of disabled reactions
+  MultiParticleReactionsBitSet deuteron_only;
+  deuteron_only.set(IncludedMultiParticleReactions::Deuteron_3to2);
+  COMPARE(ScatterActionMulti::reaction_mask(ParticleType::find(0x221),
+                                            deuteron_only),
+          0);
+
+  /* Every combination of three particles, which has a reaction, shares a bit
+   * of the masks. */
+  Momentum some_momentum{1.1, 1.0, 0., 0.};
+  ParticleList particles;
+  for (PdgCode pdg : {0x211, -0x211, 0x111, 0x221, 0x2212, 0x2112, -0x2212,
+                      -0x2112}) {
+    particles.emplace_back(ParticleType::find(pdg));
+    particles.back().set_4momentum(some_momentum);
+  }
+  int n_reacting = 0;
+  for (std::size_t i = 0; i < particles.size(); i++) {
+    for (std::size_t j = i; j < particles.size(); j++) {
+      for (std::size_t k = j; k < particles.size(); k++) {
+        const ParticleList incoming = {particles[i], particles[j],
+                                       particles[k]};
+        ScatterActionMulti act(incoming, 0.05);
+        act.add_possible_reactions(0.1, 8.0, incl_all_multi_set);
+        const std::uint8_t common = three & mask(particles[i].pdgcode()) &
+                                    mask(particles[j].pdgcode()) &
+                                    mask(particles[k].pdgcode());
+        if (!act.reaction_channels().empty()) {
+          n_reacting++;
+          VERIFY(common != 0);
+        }
+      }
+    }
+  }
+  VERIFY(n_reacting > 0);
+}
+
 TEST(threebody_integral_I3) {
   // Make sure incoming particles got their masses set
   // calculate_I3 uses effective mass , not type mass
@@ -165,6 +214,48 @@ TEST(threebody_integral_I3) {
   }
 }
 
+TEST(tabulated_integral_I3) {
+  ParticleData p{ParticleType::find(0x2212)};    // p
+  ParticleData n{ParticleType::find(0x2112)};    // n
+  ParticleData pip{ParticleType::find(0x211)};   // pi+
+  ParticleData pim{ParticleType::find(-0x211)};  // pi-
+  ParticleData piz{ParticleType::find(0x111)};   // pi0
+  const ScatterActionMulti act_piNN({pip, p, n}, 0.0);
+  const ScatterActionMulti act_NpiN({p, pip, n}, 0.0);
+  const ScatterActionMulti act_3pi({pip, pim, piz}, 0.0);
+
+  // Close to the threshold, within and beyond the tabulations
+  const double m_piNN = pip.type().mass() + p.type().mass() + n.type().mass();
+  const double m_3pi = 3 * pip.type().mass();
+  std::vector<double> srts_piNN{m_piNN + 0.0005, m_piNN + 0.0123, 2.5, 3.0,
+                                6.0};
+  std::vector<double> srts_3pi{m_3pi + 0.0031, 0.6, 1.234, 2.0};
+  std::vector<double> exact_piNN, exact_3pi;
+  for (double srts : srts_piNN) {
+    exact_piNN.push_back(act_piNN.calculate_I3(srts));
+  }
+  for (double srts : srts_3pi) {
+    exact_3pi.push_back(act_3pi.calculate_I3(srts));
+  }
+
+  sha256::Hash hash;
+  hash.fill(0);
+  TabulationBundle bundle(hash);
+  VERIFY(ScatterActionMulti::tabulate_phase_space_integrals(bundle) > 0);
+  COMPARE(ScatterActionMulti::tabulate_phase_space_integrals(bundle), 0u);
+  for (size_t i = 0; i < srts_piNN.size(); i++) {
+    COMPARE_RELATIVE_ERROR(act_piNN.calculate_I3(srts_piNN[i]), exact_piNN[i],
+                           1e-5);
+    // The order of the incoming particles does not matter
+    COMPARE_RELATIVE_ERROR(act_NpiN.calculate_I3(srts_piNN[i]), exact_piNN[i],
+                           1e-5);
+  }
+  for (size_t i = 0; i < srts_3pi.size(); i++) {
+    COMPARE_RELATIVE_ERROR(act_3pi.calculate_I3(srts_3pi[i]), exact_3pi[i],
+                           1e-5);
+  }
+}
+
 TEST(phi4_parametrization) {
   ParticleData N{ParticleType::find(0x2212)};   // p
   ParticleData pi{ParticleType::find(0x211)};   // pi+
@@ -18,6 +18,7 @@
 #include "smash/constants.h"
 #include "smash/particledata.h"
 #include "smash/pdgcode.h"
+#include "smash/random.h"
 
 using namespace smash;
 
@@ -333,3 +334,287 @@ TEST(check_stochastic_collision) {
   // compare probability to the probability of finding an action
   COMPARE_RELATIVE_ERROR(ratio_found, prob, 0.05);
 }
+
+TEST(sampled_stochastic_pairs) {
+  random::set_seed(7);
+  ParticleList search_list;
+  for (int i = 0; i < 8; i++) {
+    const double px = 0.02 * (i + 1) * (i % 2 == 0 ? 1. : -1.);
+    ParticleData p = Test::smashon(
+        Test::Momentum{std::sqrt(Test::smashon_mass * Test::smashon_mass +
+                                 px * px),
+                       px, 0., 0.},
+        Test::Position{0., 0.1 * i, 1., 1.}, i);
+    search_list.push_back(p);
+  }
+  const double grid_cell_vol = 8.0;
+  const double dt = 0.1;
+  const double elastic_parameter = 10.0;  // in mb
+  ExperimentParameters exp_par =
+      Test::default_parameters(1, dt, CollisionCriterion::Stochastic);
+  Configuration config = create_configuration_for_tests(elastic_parameter);
+  config.set_value({"Collision_Term", "Stochastic_Pair_Sampling"}, true);
+  ScatterActionsFinder finder(config, exp_par);
+
+  // expected number of collisions from the probabilities of all pairs
+  double expected = 0.;
+  for (size_t i = 0; i < search_list.size(); i++) {
+    for (size_t j = i + 1; j < search_list.size(); j++) {
+      const FourVector &p1 = search_list[i].momentum();
+      const FourVector &p2 = search_list[j].momentum();
+      const double m = Test::smashon_mass;
+      const double v_rel =
+          std::sqrt(Action::lambda_tilde((p1 + p2).sqr(), m * m, m * m)) /
+          (2. * p1.x0() * p2.x0());
+      expected += elastic_parameter * fm2_mb * v_rel * dt / grid_cell_vol;
+    }
+  }
+
+  const int N_samples = 200000;
+  int found_actions = 0;
+  for (int i = 0; i < N_samples; i++) {
+    found_actions +=
+        finder.find_actions_in_cell(search_list, dt, grid_cell_vol, {}).size();
+  }
+  const CollisionSearchCounters counters = finder.take_search_counters();
+  // Only a fraction of the 28 pairs of a cell is checked.
+  VERIFY(counters.checked_pairs < counters.candidate_pairs / 2)
+      << counters.checked_pairs << " of " << counters.candidate_pairs;
+  COMPARE_RELATIVE_ERROR(static_cast<double>(found_actions) / N_samples,
+                         expected, 0.03);
+}
+
+TEST(preselection_keeps_all_collisions) {
+  random::set_seed(42);
+  ParticleList particles;
+  for (int i = 0; i < 100; i++) {
+    const double px = random::uniform(-1., 1.);
+    const double py = random::uniform(-1., 1.);
+    const double pz = random::uniform(-1., 1.);
+    ParticleData p = create_smashon_particle(i);
+    p.set_4position(FourVector(0., random::uniform(-2., 2.),
+                               random::uniform(-2., 2.),
+                               random::uniform(-2., 2.)));
+    p.set_4momentum(p.pole_mass(), px, py, pz);
+    particles.push_back(p);
+  }
+  const double dt = 1.0;
+  const double elastic_parameter = 40.0;  // in mb
+  for (const CollisionCriterion criterion :
+       {CollisionCriterion::Geometric, CollisionCriterion::Covariant}) {
+    ExperimentParameters exp_par =
+        Test::default_parameters(1, dt, criterion);
+    Configuration config = create_configuration_for_tests(elastic_parameter);
+    ScatterActionsFinder finder(config, exp_par);
+    CollisionPartnerArrays partners;
+    partners.fill(particles, {});
+    std::vector<char> candidates;
+    size_t n_rejected = 0, n_collisions = 0;
+    for (const ParticleData& p1 : particles) {
+      finder.preselect_collision_partners(p1, ThreeVector(), partners, dt, {},
+                                         candidates);
+      COMPARE(candidates.size(), particles.size());
+      for (size_t i = 0; i < particles.size(); i++) {
+        const ParticleData& p2 = particles[i];
+        if (p1.id() == p2.id()) {
+          continue;
+        }
+        /* The search with the surrounding particles does not use the
+         * preselection. Ids are irrelevant here but have to differ. */
+        Particles surrounding;
+        surrounding.insert(p2);
+        ParticleData p1_copy = p1;
+        p1_copy.set_id(particles.size());
+        const bool collides = !finder
+                                   .find_actions_with_surrounding_particles(
+                                       {p1_copy}, surrounding, dt, {})
+                                   .empty();
+        n_collisions += collides;
+        n_rejected += !candidates[i];
+        if (collides) {
+          VERIFY(candidates[i]) << p1 << p2;
+        }
+      }
+    }
+    // Make sure the test is not trivial
+    VERIFY(n_collisions > 0);
+    VERIFY(n_rejected > 0);
+  }
+}
+
+TEST(shifted_neighbors_match_translated_neighbors) {
+  random::set_seed(7);
+  const ThreeVector shift(-10., 0., 10.);
+  ParticleList search, translated, neighbors;
+  for (int i = 0; i < 40; i++) {
+    ParticleData p = create_smashon_particle(i);
+    p.set_4position(FourVector(0., random::uniform(-1., 1.),
+                               random::uniform(-1., 1.),
+                               random::uniform(-1., 1.)));
+    p.set_4momentum(p.pole_mass(), random::uniform(-1., 1.),
+                    random::uniform(-1., 1.), random::uniform(-1., 1.));
+    if (i % 2 == 0) {
+      // Stored on the other side of the box
+      p.set_4position(p.position() - FourVector(0., shift));
+      search.push_back(p);
+      translated.push_back(p.translated(shift));
+    } else {
+      neighbors.push_back(p);
+    }
+  }
+  const double dt = 1.0;
+  ExperimentParameters exp_par =
+      Test::default_parameters(1, dt, CollisionCriterion::Geometric);
+  Configuration config = create_configuration_for_tests(40.0);
+  ScatterActionsFinder finder(config, exp_par);
+  const ActionList expected =
+      finder.find_actions_with_neighbors(translated, neighbors, dt, {});
+  const ActionList actions = finder.find_actions_with_shifted_neighbors(
+      search, shift, neighbors, dt, {});
+  VERIFY(!expected.empty());
+  COMPARE(actions.size(), expected.size());
+  for (size_t i = 0; i < actions.size(); i++) {
+    COMPARE(actions[i]->incoming_particles(),
+            expected[i]->incoming_particles());
+    COMPARE(actions[i]->get_interaction_point(),
+            expected[i]->get_interaction_point());
+  }
+}
+
+TEST(search_counters) {
+  // two particles colliding head-on and one far away
+  Particles p;
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., .1, 0.},
+                         Test::Position{0., 1., .9, 1.}));
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., -.1, 0.},
+                         Test::Position{0., 1., 1.1, 1.}));
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., .1, 0.},
+                         Test::Position{0., 1., 20., 1.}));
+  const double radius = 0.11;                                        // in fm
+  const double elastic_parameter = radius * radius * M_PI / fm2_mb;  // in mb
+  ExperimentParameters exp_par = Test::default_parameters();
+  Configuration config = create_configuration_for_tests(elastic_parameter);
+  ScatterActionsFinder finder(config, exp_par);
+  const ParticleList all = p.copy_to_vector();
+  const double dt = 0.9;
+
+  COMPARE(finder.find_actions_in_cell(all, dt, 0.0, {}).size(), 1u);
+  CollisionSearchCounters counters = finder.take_search_counters();
+  COMPARE(counters.cells, 1u);
+  COMPARE(counters.max_particles_in_cell, 3u);
+  COMPARE(counters.candidate_pairs, 3u);
+  VERIFY(counters.checked_pairs >= 1u && counters.checked_pairs <= 3u);
+  COMPARE(counters.found_actions, 1u);
+  COMPARE(counters.found_multi_particle_actions, 0u);
+
+  // the counters start from zero again
+  COMPARE(finder.take_search_counters().candidate_pairs, 0u);
+
+  const ParticleList search = {all[0]};
+  const ParticleList neighbors = {all[1], all[2]};
+  COMPARE(finder.find_actions_with_neighbors(search, neighbors, dt, {}).size(),
+          1u);
+  counters = finder.take_search_counters();
+  COMPARE(counters.cells, 0u);
+  COMPARE(counters.candidate_pairs, 2u);
+  COMPARE(counters.found_actions, 1u);
+}
+
+TEST(unformed_particles_skip_search) {
+  // two particles colliding head-on, the second one forms after the search
+  Particles p;
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., .1, 0.},
+                         Test::Position{0., 1., .9, 1.}));
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., -.1, 0.},
+                         Test::Position{0., 1., 1.1, 1.}));
+  const double radius = 0.11;                                        // in fm
+  const double elastic_parameter = radius * radius * M_PI / fm2_mb;  // in mb
+  ExperimentParameters exp_par = Test::default_parameters();
+  Configuration config = create_configuration_for_tests(elastic_parameter);
+  ScatterActionsFinder finder(config, exp_par);
+  ParticleList all = p.copy_to_vector();
+  const double dt = 0.9;
+  all[1].set_formation_time(dt + 1.);
+  all[1].set_cross_section_scaling_factor(0.);
+
+  COMPARE(finder.find_actions_in_cell(all, dt, 0.0, {}).size(), 0u);
+  CollisionSearchCounters counters = finder.take_search_counters();
+  COMPARE(counters.max_particles_in_cell, 1u);
+  COMPARE(counters.candidate_pairs, 0u);
+  COMPARE(finder.find_actions_with_neighbors({all[0]}, {all[1]}, dt, {}).size(),
+          0u);
+  COMPARE(finder.take_search_counters().candidate_pairs, 0u);
+  COMPARE(finder.find_actions_with_surrounding_particles({all[1]}, p, dt, {})
+              .size(),
+          0u);
+  COMPARE(finder.take_search_counters().candidate_pairs, 0u);
+
+  // once it forms before the collision, the collision is found again
+  all[1].set_formation_time(0.05);
+  COMPARE(finder.find_actions_in_cell(all, dt, 0.0, {}).size(), 1u);
+  COMPARE(finder.take_search_counters().candidate_pairs, 1u);
+}
+
+TEST(only_constant_elastic_collisions) {
+  Particles particles;
+  particles.insert(Test::smashon(Test::Momentum{1., 0.5, 0., 0.},
+                                 Test::Position{0., 0., 1., 1.}));
+  particles.insert(Test::smashon(Test::Momentum{1., -0.5, 0., 0.},
+                                 Test::Position{0., 0.2, 1., 1.}));
+
+  // only elastic collisions with a scaled constant cross section
+  ReactionsBitSet only_elastic;
+  only_elastic.set(IncludedReactions::Elastic);
+  const ExperimentParameters exp_par{
+      std::make_unique<UniformClock>(0., 0.1, 300.0),  // labclock
+      std::make_unique<UniformClock>(0., 1., 300.0),   // outputclock
+      1,                                               // ensembles
+      1,                                               // testparticles
+      DerivativesMode::CovariantGaussian,              // derivatives mode
+      RestFrameDensityDerivativesMode::Off,  // rest frame derivatives mode
+      FieldDerivativesMode::ChainRule,       // field derivatives mode
+      SmearingMode::CovariantGaussian,       // smearing mode
+      1.0,                                   // Gaussian smearing width
+      4.0,                                   // Gaussian smearing cut-off
+      0.333333,                              // discrete smearing weight
+      2.0,                                   // triangular smearing range
+      CollisionCriterion::Geometric,
+      false,  // two_to_one
+      only_elastic,
+      Test::no_multiparticle_reactions(),
+      false,  // strings switch
+      1.0,
+      NNbarTreatment::NoAnnihilation,
+      0.,           // low energy sigma_NN cut-off
+      false,        // potential_affect_threshold
+      -1.0,         // box_length
+      200.0,        // max. cross section
+      2.5,          // fixed min. cell length
+      2.0,          // cross section scaling
+      false,        // in thermodynamics outputs spectators are included
+      false,        // do weak decays
+      true,         // decay initial particles
+      std::nullopt  // use monash tune, not known
+  };
+  Configuration config{R"(
+    Collision_Term:
+      Elastic_Cross_Section: 10.0
+      Additional_Elastic_Cross_Section: 5.0
+      Isotropic: true
+  )"};
+  ScatterActionsFinder finder(config, exp_par);
+  const double xs = (10.0 + 5.0) * 2.0;
+  VERIFY(finder.is_constant_elastic_isotropic());
+  FUZZY_COMPARE(finder.max_transverse_distance_sqr(1), xs * fm2_mb * M_1_PI);
+
+  ParticleList particle_list = particles.copy_to_vector();
+  particle_list.pop_back();
+  ActionList actions = finder.find_actions_with_surrounding_particles(
+      particle_list, particles, 10000., {});
+  COMPARE(actions.size(), 1u);
+  auto *action = dynamic_cast<ScatterAction *>(actions[0].get());
+  VERIFY(action != nullptr);
+  FUZZY_COMPARE(action->cross_section(), xs);
+  action->generate_final_state();
+  COMPARE(action->get_type(), ProcessType::Elastic);
+}
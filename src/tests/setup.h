@@ -220,11 +220,12 @@ inline MultiParticleReactionsBitSet no_multiparticle_reactions() {
  * testing purposes.
  *
  * If needed you can set the testparticles parameter to a different value than
- * 1.
+ * 1, as well as the time step, collision criterion and smearing mode.
  */
 inline ExperimentParameters default_parameters(
     int testparticles = 1, double dt = 0.1,
-    CollisionCriterion crit = CollisionCriterion::Geometric) {
+    CollisionCriterion crit = CollisionCriterion::Geometric,
+    SmearingMode smearing = SmearingMode::CovariantGaussian) {
   return ExperimentParameters{
       std::make_unique<UniformClock>(0., dt, 300.0),  // labclock
       std::make_unique<UniformClock>(0., 1., 300.0),  // outputclock
@@ -233,7 +234,7 @@ inline ExperimentParameters default_parameters(
       DerivativesMode::CovariantGaussian,             // derivatives mode
       RestFrameDensityDerivativesMode::Off,  // rest frame derivatives mode
       FieldDerivativesMode::ChainRule,       // field derivatives mode
-      SmearingMode::CovariantGaussian,       // smearing mode
+      smearing,                              // smearing mode
       1.0,                                   // Gaussian smearing width
       4.0,                                   // Gaussian smearing cut-off
       0.333333,                              // discrete smearing weight
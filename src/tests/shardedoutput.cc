@@ -0,0 +1,119 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/shardedoutput.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "setup.h"
+#include "smash/binaryoutput.h"
+#include "smash/binaryreader.h"
+#include "smash/processbranch.h"
+#include "smash/scatteraction.h"
+#include "smash/scatteractionsfinderparameters.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+static std::string read_file(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+TEST(merged_shards_equal_sequential_output) {
+  constexpr int n_ensembles = 2;
+  auto particles =
+      Test::create_particles(2, [] { return Test::smashon_random(); });
+  const EventInfo info = Test::default_event_info(2.5, false);
+  ScatterActionPtr action = std::make_unique<ScatterAction>(
+      particles->front(), particles->back(), 0.);
+  action->add_all_scatterings(Test::default_finder_parameters());
+  action->generate_final_state();
+  OutputParameters out_par = OutputParameters();
+  out_par.coll_printstartend = true;
+
+  // Calls in the order of the experiment, with the ensembles interleaved
+  std::vector<std::filesystem::path> shard_files;
+  {
+    std::vector<std::unique_ptr<OutputInterface>> shards;
+    for (int i = 0; i < n_ensembles; i++) {
+      const std::filesystem::path dir =
+          testoutputpath / ("ensemble_" + std::to_string(i));
+      std::filesystem::create_directories(dir);
+      shards.push_back(
+          std::make_unique<BinaryOutputCollisions>(dir, "Collisions", out_par));
+      shard_files.push_back(dir / "collisions_binary.bin");
+    }
+    ShardedOutput output(std::move(shards));
+    COMPARE(output.size(), 2u);
+    for (int event = 0; event < 2; event++) {
+      for (int i = 0; i < n_ensembles; i++) {
+        output.at_eventstart(*particles, event * n_ensembles + i, info);
+      }
+      for (int k = 0; k < 3; k++) {
+        output.at_ensemble_interaction(*action, 0.1 * k, k % n_ensembles);
+      }
+      for (int i = 0; i < n_ensembles; i++) {
+        output.at_eventend(*particles, event * n_ensembles + i, info);
+      }
+    }
+  }
+
+  // The same events written one after another into a single output
+  const std::filesystem::path single_file =
+      testoutputpath / "collisions_binary.bin";
+  {
+    BinaryOutputCollisions output(testoutputpath, "Collisions", out_par);
+    for (int event = 0; event < 2 * n_ensembles; event++) {
+      output.at_eventstart(*particles, event, info);
+      for (int k = event % n_ensembles; k < 3; k += n_ensembles) {
+        output.at_interaction(*action, 0.1 * k);
+      }
+      output.at_eventend(*particles, event, info);
+    }
+  }
+
+  const std::filesystem::path merged_file = testoutputpath / "merged.bin";
+  merge_binary_shards(shard_files, merged_file);
+  const std::string merged = read_file(merged_file);
+  VERIFY(merged.size() > 0);
+  COMPARE(merged, read_file(single_file));
+
+  BinaryParticleListReader reader(merged_file);
+  COMPARE(reader.n_events(), 4u);
+  for (std::size_t i = 0; i < reader.n_events(); i++) {
+    COMPARE(reader.event_number(i), static_cast<std::int32_t>(i));
+  }
+
+  VERIFY(std::filesystem::remove(merged_file));
+  VERIFY(std::filesystem::remove(single_file));
+  for (const std::filesystem::path &file : shard_files) {
+    VERIFY(std::filesystem::remove_all(file.parent_path()) > 0);
+  }
+}
+
+TEST_CATCH(merge_without_shards, std::invalid_argument) {
+  merge_binary_shards({}, testoutputpath / "merged.bin");
+}
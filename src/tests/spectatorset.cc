@@ -0,0 +1,97 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/spectatorset.h"
+
+#include "setup.h"
+#include "smash/particles.h"
+
+using namespace smash;
+using Test::Position;
+
+// Interaction length and time step, such that particles further apart than
+// 2.3 fm cannot interact
+static constexpr double interaction_length = 1.;
+static constexpr double dt = 0.1;
+
+static const ParticleData &insert(Particles &particles, double x,
+                                  BelongsTo label) {
+  ParticleData data = Test::smashon(Position{0., x, 0., 0.});
+  data.set_belongs_to(label);
+  return particles.insert(data);
+}
+
+TEST(create_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(reset_tracks_nucleons) {
+  Particles particles;
+  const ParticleData projectile =
+      insert(particles, -10., BelongsTo::Projectile);
+  const ParticleData target = insert(particles, 10., BelongsTo::Target);
+  const ParticleData produced = insert(particles, 0., BelongsTo::Nothing);
+  SpectatorSet spectators;
+  COMPARE(spectators.size(), 0u);
+  spectators.reset(particles);
+  COMPARE(spectators.size(), 2u);
+  VERIFY(spectators.contains(projectile));
+  VERIFY(spectators.contains(target));
+  VERIFY(!spectators.contains(produced));
+}
+
+TEST(separated_nuclei_stay_spectators) {
+  Particles particles;
+  insert(particles, -10., BelongsTo::Projectile);
+  insert(particles, -9., BelongsTo::Projectile);
+  insert(particles, 10., BelongsTo::Target);
+  insert(particles, 9., BelongsTo::Target);
+  SpectatorSet spectators;
+  spectators.reset(particles);
+  COMPARE(spectators.update(particles, interaction_length, dt), 4u);
+}
+
+TEST(approaching_nuclei_rejoin) {
+  Particles particles;
+  const ParticleData far = insert(particles, -10., BelongsTo::Projectile);
+  const ParticleData close = insert(particles, -1., BelongsTo::Projectile);
+  const ParticleData target = insert(particles, 1., BelongsTo::Target);
+  SpectatorSet spectators;
+  spectators.reset(particles);
+  COMPARE(spectators.update(particles, interaction_length, dt), 1u);
+  VERIFY(spectators.contains(far));
+  VERIFY(!spectators.contains(close));
+  VERIFY(!spectators.contains(target));
+}
+
+TEST(rejoining_spectators_let_their_neighbors_rejoin) {
+  Particles particles;
+  // Inserted from far to close, such that rejoining takes several passes
+  const ParticleData far = insert(particles, -20., BelongsTo::Projectile);
+  const ParticleData beyond = insert(particles, -7., BelongsTo::Projectile);
+  const ParticleData second = insert(particles, -4.5, BelongsTo::Projectile);
+  const ParticleData first = insert(particles, -2., BelongsTo::Projectile);
+  insert(particles, 0., BelongsTo::Nothing);
+  SpectatorSet spectators;
+  spectators.reset(particles);
+  COMPARE(spectators.update(particles, interaction_length, dt), 2u);
+  VERIFY(!spectators.contains(first));
+  VERIFY(!spectators.contains(second));
+  VERIFY(spectators.contains(beyond));
+  VERIFY(spectators.contains(far));
+
+  // Rejoined particles are not tracked anymore, also when they move away.
+  for (ParticleData &data : particles) {
+    if (data.id() == first.id()) {
+      data.set_4position(Position{0., -50., 0., 0.});
+    }
+  }
+  COMPARE(spectators.update(particles, interaction_length, dt), 2u);
+  VERIFY(!spectators.contains(first));
+}
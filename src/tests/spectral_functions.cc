@@ -89,3 +89,21 @@ TEST(mass_sampling) {
     return res.spectral_function(m) * pcm * bw;
   });
 }
+
+TEST(tabulated_mass_sampling) {
+  ParticleType::tabulate_spectral_functions();
+  // Δ near threshold with N π → Δ π, where the rejection used to be slow
+  const ParticleType &delta = ParticleType::find(0x2214);
+  const double sqrts = 1.6;
+  const double mass_stable = 0.138;
+  const int L = 1;
+  Histogram1d hist(0.005);
+  hist.populate(1000000, [&]() {
+    return delta.sample_resonance_mass(mass_stable, sqrts, L);
+  });
+  hist.test([&](double m) {
+    const double pcm = pCM(sqrts, mass_stable, m);
+    const double bw = blatt_weisskopf_sqr(pcm, L);
+    return delta.spectral_function(m) * pcm * bw;
+  });
+}
@@ -703,6 +703,26 @@ TEST(pdg_map_for_pythia) {
   VERIFY(pdgid_mapped == -2112);
 }
 
+TEST(string_hadrons_from_quarks) {
+  std::unique_ptr<StringProcess> sp = std::make_unique<StringProcess>(
+      1., 1., .0, .001, .0, .0, 1., 1., .0, .0, .5, .0, .0, .0, .0, true,
+      1. / 3., true, 0., false);
+
+  // u and dbar turn into a positive meson
+  const int meson = sp->get_hadrontype_from_quark(2, -1);
+  COMPARE(PdgCode::from_decimal(meson).charge(), 1);
+  COMPARE(PdgCode::from_decimal(meson).baryon_number(), 0);
+
+  // resonances with the pole mass closest to the string mass
+  COMPARE(sp->get_resonance_from_quark(2, -1, 0.776), 213);
+  COMPARE(sp->get_resonance_from_quark(2, 2101, 1.232), 2214);
+  COMPARE(sp->get_resonance_from_quark(-2101, -2, 1.232), -2214);
+  // below the pion mass and for invalid string ends, there is no resonance
+  COMPARE(sp->get_resonance_from_quark(2, -1, 0.1), 0);
+  COMPARE(sp->get_resonance_from_quark(2, 2, 1.), 0);
+  COMPARE(sp->get_resonance_from_quark(2, 2101, 0.2), 0);
+}
+
 TEST(string_scaling_factors) {
   ParticleData a{ParticleType::find(0x2212)};
   ParticleData b{ParticleType::find(0x2212)};
@@ -11,6 +11,8 @@
 
 #include "smash/tabulation.h"
 
+#include <vector>
+
 using namespace smash;
 
 TEST(empty) {
@@ -89,3 +91,31 @@ TEST(quadratic) {
   // check extrapolated values
   COMPARE_ABSOLUTE_ERROR(tab.get_value_linear(3.), 7.8, error);
 }
+
+TEST(values_linear) {
+  const Tabulation tab(1., 4., 8, [](double x) { return x * x; });
+  const std::vector<double> x = {0.,  0.999, 1.,  1.3, 2.5,
+                                 4.9, 5.,    5.2, 9.};
+  std::vector<double> values(x.size());
+  for (const Extrapolation extrapolation :
+       {Extrapolation::Zero, Extrapolation::Const, Extrapolation::Linear}) {
+    tab.get_values_linear(x.data(), values.data(), x.size(), extrapolation);
+    for (size_t i = 0; i < x.size(); i++) {
+      COMPARE(values[i], tab.get_value_linear(x[i], extrapolation)) << x[i];
+    }
+  }
+}
+
+TEST(cdf) {
+  // uniform density on [1, 3], whose distribution function is (x - 1) / 2
+  const Tabulation cdf =
+      Tabulation::cdf(1., 3., 100, [](double) { return 1.; });
+  COMPARE(cdf.get_value_linear(1.), 0.);
+  COMPARE_ABSOLUTE_ERROR(cdf.get_value_linear(2.), 0.5, 1e-12);
+  COMPARE(cdf.get_value_linear(3.), 1.);
+  COMPARE_ABSOLUTE_ERROR(cdf.get_inverse_linear(0.25), 1.5, 1e-12);
+  COMPARE_ABSOLUTE_ERROR(cdf.get_inverse_linear(0.5), 2., 1e-12);
+  // the arguments are clamped to the tabulated range
+  COMPARE(cdf.get_inverse_linear(-1.), 1.);
+  COMPARE(cdf.get_inverse_linear(2.), 3.);
+}
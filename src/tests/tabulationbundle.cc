@@ -0,0 +1,79 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/tabulationbundle.h"
+
+#include <cstdint>
+#include <filesystem>
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+static sha256::Hash make_hash(std::uint8_t first_byte) {
+  sha256::Hash hash{};
+  hash[0] = first_byte;
+  return hash;
+}
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(missing_bundle_is_empty) {
+  const TabulationBundle bundle =
+      TabulationBundle::read(testoutputpath, make_hash(1));
+  COMPARE(bundle.size(), 0u);
+  VERIFY(bundle.find("NΔ") == nullptr);
+}
+
+TEST(publish_and_read) {
+  const sha256::Hash hash = make_hash(2);
+  TabulationBundle bundle(hash);
+  bundle.insert("NΔ", Tabulation(1., 2., 4, [](double x) { return x * x; }));
+  bundle.insert("πN", Tabulation(0., 1., 2, [](double x) { return -x; }));
+  bundle.publish(testoutputpath);
+  const std::filesystem::path path = TabulationBundle::path(testoutputpath,
+                                                            hash);
+  VERIFY(std::filesystem::exists(path));
+
+  const TabulationBundle read = TabulationBundle::read(testoutputpath, hash);
+  COMPARE(read.size(), 2u);
+  const Tabulation *tab = read.find("NΔ");
+  VERIFY(tab != nullptr);
+  COMPARE(tab->get_value_step(1.5), 2.25);
+  COMPARE(tab->get_value_linear(3.), 9.);
+  COMPARE(read.find("πN")->get_value_step(1.), -1.);
+
+  // A bundle of other particle properties is not found.
+  COMPARE(TabulationBundle::read(testoutputpath, make_hash(3)).size(), 0u);
+
+  // Publishing again replaces the bundle.
+  TabulationBundle updated(hash);
+  updated.insert("ρρ", Tabulation(0., 1., 2, [](double) { return 1.; }));
+  updated.publish(testoutputpath);
+  COMPARE(TabulationBundle::read(testoutputpath, hash).size(), 1u);
+  VERIFY(std::filesystem::remove(path));
+}
+
+TEST(damaged_bundle_is_ignored) {
+  const sha256::Hash hash = make_hash(4);
+  TabulationBundle bundle(hash);
+  bundle.insert("NΔ", Tabulation(1., 2., 4, [](double x) { return x; }));
+  bundle.publish(testoutputpath);
+  const std::filesystem::path path = TabulationBundle::path(testoutputpath,
+                                                            hash);
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+  COMPARE(TabulationBundle::read(testoutputpath, hash).size(), 0u);
+  VERIFY(std::filesystem::remove(path));
+}
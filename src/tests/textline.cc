@@ -0,0 +1,76 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/textline.h"
+
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace smash;
+
+/// \return x printed with "%.<precision>g", where "%g" has precision 6.
+static std::string printf_result(double x, int precision) {
+  char buffer[64];
+  const int n = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, x);
+  return std::string(buffer, n);
+}
+
+static const std::vector<double> values = {
+    0.,
+    -0.,
+    1.,
+    -1.5,
+    0.1,
+    1e-4,
+    1e-5,
+    123456.,
+    1234567.,
+    999999.5,
+    0.000123456789,
+    3.14159265358979,
+    -2.718281828459045e-12,
+    6.02214076e23,
+    std::numeric_limits<double>::min(),
+    std::numeric_limits<double>::denorm_min(),
+    std::numeric_limits<double>::max(),
+    std::numeric_limits<double>::infinity(),
+    -std::numeric_limits<double>::infinity()};
+
+TEST(reals_match_printf) {
+  TextLine line;
+  for (double x : values) {
+    line.clear();
+    line << x;
+    COMPARE(line.str(), printf_result(x, 6)) << x;
+    line.clear();
+    line.append(x, 9);
+    COMPARE(line.str(), printf_result(x, 9)) << x;
+  }
+}
+
+TEST(integers_match_printf) {
+  TextLine line;
+  for (int x : {0, 1, -1, 211, -2212, 1000822080,
+                std::numeric_limits<int>::min()}) {
+    line.clear();
+    line << x;
+    COMPARE(line.str(), std::to_string(x));
+  }
+}
+
+TEST(whole_line) {
+  TextLine line;
+  line << 1.5 << ' ' << -211 << ' ' << std::string("abc") << '\n';
+  COMPARE(line.str(), "1.5 -211 abc\n");
+  COMPARE(line.size(), 13u);
+}
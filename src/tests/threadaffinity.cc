@@ -0,0 +1,40 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/threadaffinity.h"
+
+using namespace smash;
+
+static const NumaNodes two_nodes = {{0, 1, 2}, {4, 5}};
+
+TEST(no_binding) {
+  VERIFY(assign_numa_nodes(ThreadAffinity::None, two_nodes, 4).empty());
+  VERIFY(assign_numa_nodes(ThreadAffinity::Compact, {}, 4).empty());
+}
+
+TEST(compact) {
+  const std::vector<std::size_t> expected = {0, 0, 0, 1, 1, 0, 0};
+  COMPARE(assign_numa_nodes(ThreadAffinity::Compact, two_nodes, 7), expected);
+}
+
+TEST(scatter) {
+  const std::vector<std::size_t> expected = {0, 1, 0, 1, 0};
+  COMPARE(assign_numa_nodes(ThreadAffinity::Scatter, two_nodes, 5), expected);
+}
+
+TEST(bind_to_usable_cores) {
+  const NumaNodes nodes = usable_numa_nodes();
+  if (nodes.empty()) {
+    return;
+  }
+  ScopedThreadAffinity binding(nodes[0]);
+  VERIFY(binding.bound());
+}
@@ -0,0 +1,117 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This has to be the first include
+
+#include "smash/vtkxmloutput.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "setup.h"
+#include "smash/lattice.h"
+#include "smash/particles.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+static std::string read_file(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(particles) {
+  Test::create_smashon_particletypes();
+  Particles particles;
+  for (int i = 0; i < 5; i++) {
+    particles.insert(Test::smashon_random());
+  }
+  OutputParameters out_par = OutputParameters();
+  out_par.part_compression_level = 0;
+  const std::filesystem::path path =
+      testoutputpath / "pos_ev00000_tstep00000.vtu";
+  {
+    VtkXmlOutput output(testoutputpath, "Particles", out_par);
+    output.at_eventstart(particles, 0, Test::default_event_info());
+    output.flush();
+    VERIFY(std::filesystem::exists(path));
+  }
+  const std::string content = read_file(path);
+  VERIFY(content.find("<VTKFile type=\"UnstructuredGrid\"") == 22);
+  VERIFY(content.find("NumberOfPoints=\"5\" NumberOfCells=\"5\"") !=
+         std::string::npos);
+  VERIFY(content.find("Name=\"pdg_codes\"") != std::string::npos);
+  // The appended data starts with the byte count of the first array.
+  const std::size_t data = content.find("<AppendedData encoding=\"raw\">\n_");
+  VERIFY(data != std::string::npos);
+  std::uint64_t size;
+  std::memcpy(&size, content.data() + data + 31, sizeof(size));
+  COMPARE(size, 5 * sizeof(std::int32_t));
+  VERIFY(std::filesystem::remove(path));
+}
+
+TEST(cropped_and_downsampled_lattice) {
+  OutputParameters out_par = OutputParameters();
+  out_par.td_downsampling = 2;
+  out_par.td_region_min = {{-2., -2., -2.}};
+  out_par.td_region_max = {{2., 2., 2.}};
+  // Cell centers from -4.5 to 4.5 fm, those from -1.5 to 1.5 fm are in the
+  // region and every second of them is written.
+  RectangularLattice<DensityOnLattice> lattice(
+      {{10., 10., 10.}}, {{10, 10, 10}}, {{-5., -5., -5.}}, false,
+      LatticeUpdate::EveryTimestep);
+  const std::filesystem::path path =
+      testoutputpath / "net_baryon_rho_eckart_00000_tstep00000.vti";
+  {
+    VtkXmlOutput output(testoutputpath, "Thermodynamics", out_par);
+    output.at_eventstart(Particles(), 0, Test::default_event_info());
+    output.thermodynamics_output(ThermodynamicQuantity::EckartDensity,
+                                 DensityType::Baryon, lattice);
+  }
+  VERIFY(std::filesystem::exists(path));
+  const std::string content = read_file(path);
+  VERIFY(content.find("WholeExtent=\"0 1 0 1 0 1\"") != std::string::npos);
+  VERIFY(content.find("Origin=\"-1.500000 -1.500000 -1.500000\"") !=
+         std::string::npos);
+  VERIFY(content.find("Spacing=\"2.000000 2.000000 2.000000\"") !=
+         std::string::npos);
+  VERIFY(std::filesystem::remove(path));
+}
+
+TEST(empty_region_is_skipped) {
+  OutputParameters out_par = OutputParameters();
+  out_par.td_region_min = {{20., 20., 20.}};
+  RectangularLattice<DensityOnLattice> lattice(
+      {{10., 10., 10.}}, {{10, 10, 10}}, {{-5., -5., -5.}}, false,
+      LatticeUpdate::EveryTimestep);
+  VtkXmlOutput output(testoutputpath, "Thermodynamics", out_par);
+  output.at_eventstart(Particles(), 1, Test::default_event_info());
+  output.thermodynamics_output(ThermodynamicQuantity::EckartDensity,
+                               DensityType::Baryon, lattice);
+  output.flush();
+  VERIFY(!std::filesystem::exists(
+      testoutputpath / "net_baryon_rho_eckart_00001_tstep00000.vti"));
+}
+
+TEST_CATCH(invalid_downsampling, std::invalid_argument) {
+  OutputParameters out_par = OutputParameters();
+  out_par.td_downsampling = 0;
+  VtkXmlOutput output(testoutputpath, "Thermodynamics", out_par);
+}
@@ -0,0 +1,95 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/textreader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace smash {
+
+TextParticleListReader::TextParticleListReader(
+    const std::filesystem::path &path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open " + path.string() + ".");
+  }
+  struct stat file_status;
+  if (fstat(fd, &file_status) != 0) {
+    close(fd);
+    throw std::runtime_error("Cannot determine the size of " + path.string() +
+                             ".");
+  }
+  size_ = static_cast<std::size_t>(file_status.st_size);
+  if (size_ > 0) {
+    void *mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("Cannot map " + path.string() + ".");
+    }
+    // The file is read once from the beginning to the end.
+    madvise(mapping, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char *>(mapping);
+  }
+  // The mapping stays valid after closing the file descriptor.
+  close(fd);
+
+  std::size_t offset = 0;
+  while (has_event_at(offset)) {
+    EventEntry entry{offset, size_};
+    while (offset < size_) {
+      const void *newline = std::memchr(data_ + offset, '\n', size_ - offset);
+      const std::size_t line_end =
+          newline ? static_cast<const char *>(newline) - data_ : size_;
+      const std::string_view line(data_ + offset, line_end - offset);
+      const bool is_end = line.find("end") != std::string_view::npos;
+      if (is_end) {
+        entry.end = offset;
+      }
+      offset = newline ? line_end + 1 : size_;
+      if (is_end) {
+        break;
+      }
+    }
+    events_.push_back(entry);
+  }
+}
+
+TextParticleListReader::~TextParticleListReader() {
+  if (data_) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+}
+
+bool TextParticleListReader::has_event_at(std::size_t offset) const {
+  // At most four lines that are no comments precede an event.
+  for (int line = 0; line < 5; line++) {
+    if (offset >= size_) {
+      return false;
+    }
+    const void *newline = std::memchr(data_ + offset, '\n', size_ - offset);
+    // A last line without line break ends the file.
+    if (!newline) {
+      return false;
+    }
+    if (data_[offset] == '#') {
+      return true;
+    }
+    offset = static_cast<const char *>(newline) - data_ + 1;
+  }
+  return true;
+}
+
+}  // namespace smash
@@ -9,15 +9,18 @@
 
 #include "smash/thermodynamiclatticeoutput.h"
 
+#include <array>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <vector>
 
 #include "smash/clock.h"
 #include "smash/config.h"
 #include "smash/density.h"
 #include "smash/energymomentumtensor.h"
 #include "smash/experimentparameters.h"
+#include "smash/parallel.h"
 #include "smash/thermodynamicoutput.h"
 #include "smash/vtkoutput.h"
 
@@ -178,6 +181,26 @@ namespace smash {
  * information about the computation of the various Thermodynamics quantities.
  */
 
+namespace {
+/**
+ * Evaluate a quantity at all nodes of a lattice in parallel. The nodes are
+ * handed out to the threads in chunks.
+ *
+ * \param[in] n_threads Maximal number of threads
+ * \param[in] n_nodes Number of nodes
+ * \param[in] compute Function giving the quantity at the node of an index
+ * \return The quantity at all nodes, in the order of the lattice.
+ */
+template <typename T, typename F>
+std::vector<T> compute_at_nodes(int n_threads, std::size_t n_nodes,
+                                const F &compute) {
+  std::vector<T> values(n_nodes);
+  parallel_for(n_threads, n_nodes, 64,
+               [&](std::size_t k) { values[k] = compute(k); });
+  return values;
+}
+}  // unnamed namespace
+
 /* initialization of the static member version */
 const double_t ThermodynamicLatticeOutput::version = 1.0;
 
@@ -545,9 +568,7 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
     return;
   }
   double result;
-  const auto dim = lattice.n_cells();
   std::shared_ptr<std::ofstream> fp(nullptr);
-  FourVector jQ = FourVector(), jB = FourVector(), jS = FourVector();
   constexpr bool compute_gradient = false;
   if (enable_ascii_) {
     fp = output_ascii_files_[ThermodynamicQuantity::j_QBS];
@@ -560,51 +581,48 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
     assert(sizeof(ctime) == sizeof(double));
     fp->write(reinterpret_cast<char *>(&ctime), sizeof(ctime));
   }
-  lattice.iterate_sublattice(
-      {0, 0, 0}, dim, [&](DensityOnLattice &, int ix, int iy, int iz) {
-        const ThreeVector position = lattice.cell_center(ix, iy, iz);
-        jQ.reset();
-        jB.reset();
-        jS.reset();
+  // The currents are evaluated in parallel and written in lattice order.
+  using Currents = std::array<FourVector, 3>;
+  const std::vector<Currents> currents = compute_at_nodes<Currents>(
+      out_par_.td_threads, lattice.size(), [&](std::size_t k) {
+        const ThreeVector position = lattice.cell_center(k);
+        Currents j_QBS;
         for (const Particles &particles : ensembles) {
-          jQ += std::get<1>(current_eckart(
+          j_QBS[0] += std::get<1>(current_eckart(
               position, particles, dens_param, DensityType::Charge,
               compute_gradient, out_par_.td_smearing));
-          jB += std::get<1>(current_eckart(
+          j_QBS[1] += std::get<1>(current_eckart(
               position, particles, dens_param, DensityType::Baryon,
               compute_gradient, out_par_.td_smearing));
-          jS += std::get<1>(current_eckart(
+          j_QBS[2] += std::get<1>(current_eckart(
               position, particles, dens_param, DensityType::Strangeness,
               compute_gradient, out_par_.td_smearing));
         }
-        if (enable_ascii_) {
-          *fp << jQ[0];
-          for (int l = 1; l < 4; l++) {
-            *fp << " " << jQ[l];
-          }
-          for (int l = 0; l < 4; l++) {
-            *fp << " " << jB[l];
-          }
-          for (int l = 0; l < 4; l++) {
-            *fp << " " << jS[l];
-          }
-          *fp << "\n";
-        }
-        if (enable_binary_) {
-          for (int l = 0; l < 4; l++) {
-            result = jQ[l];
-            fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-          }
-          for (int l = 0; l < 4; l++) {
-            result = jB[l];
-            fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-          }
-          for (int l = 0; l < 4; l++) {
-            result = jS[l];
-            fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-          }
-        }
+        return j_QBS;
       });
+  for (const Currents &j_QBS : currents) {
+    if (enable_ascii_) {
+      *fp << j_QBS[0][0];
+      for (int l = 1; l < 4; l++) {
+        *fp << " " << j_QBS[0][l];
+      }
+      for (int l = 0; l < 4; l++) {
+        *fp << " " << j_QBS[1][l];
+      }
+      for (int l = 0; l < 4; l++) {
+        *fp << " " << j_QBS[2][l];
+      }
+      *fp << "\n";
+    }
+    if (enable_binary_) {
+      for (const FourVector &j : j_QBS) {
+        for (int l = 0; l < 4; l++) {
+          result = j[l];
+          fp->write(reinterpret_cast<char *>(&result), sizeof(double));
+        }
+      }
+    }
+  }
 }
 
 void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
@@ -672,45 +690,47 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
         }
       }
       break;
-    case ThermodynamicQuantity::TmnLandau:
+    case ThermodynamicQuantity::TmnLandau: {
+      // The Landau frame is found once per node, in parallel.
+      const std::vector<EnergyMomentumTensor> Tmn_L =
+          compute_at_nodes<EnergyMomentumTensor>(
+              out_par_.td_threads, lattice.size(), [&](std::size_t k) {
+                const EnergyMomentumTensor &node = lattice[k];
+                return node.boosted(node.landau_frame_4velocity());
+              });
       for (int i = 0; i < 4; i++) {
         for (int j = i; j < 4; j++) {
-          lattice.iterate_sublattice(
-              {0, 0, 0}, dim,
-              [&](EnergyMomentumTensor &node, int ix, int, int) {
-                if (enable_ascii_) {
-                  const FourVector u = node.landau_frame_4velocity();
-                  const EnergyMomentumTensor Tmn_L = node.boosted(u);
-                  *fp << Tmn_L[EnergyMomentumTensor::tmn_index(i, j)] << " ";
-                  if (ix == dim[0] - 1) {
-                    *fp << "\n";
-                  }
-                }
-                if (enable_binary_) {
-                  const FourVector u = node.landau_frame_4velocity();
-                  const EnergyMomentumTensor Tmn_L = node.boosted(u);
-                  result = Tmn_L[EnergyMomentumTensor::tmn_index(i, j)];
-                  fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-                }
-              });
-        }
-      }
-      break;
-    case ThermodynamicQuantity::LandauVelocity:
-      lattice.iterate_sublattice(
-          {0, 0, 0}, dim, [&](EnergyMomentumTensor &node, int, int, int) {
+          for (std::size_t k = 0; k < Tmn_L.size(); k++) {
+            result = Tmn_L[k][EnergyMomentumTensor::tmn_index(i, j)];
             if (enable_ascii_) {
-              const FourVector u = node.landau_frame_4velocity();
-              const ThreeVector v = -u.velocity();
-              *fp << v.x1() << " " << v.x2() << " " << v.x3() << "\n";
+              *fp << result << " ";
+              if (static_cast<int>(k % dim[0]) == dim[0] - 1) {
+                *fp << "\n";
+              }
             }
             if (enable_binary_) {
-              const FourVector u = node.landau_frame_4velocity();
-              ThreeVector v = -u.velocity();
-              fp->write(reinterpret_cast<char *>(&v), 3 * sizeof(double));
+              fp->write(reinterpret_cast<char *>(&result), sizeof(double));
             }
+          }
+        }
+      }
+      break;
+    }
+    case ThermodynamicQuantity::LandauVelocity: {
+      std::vector<ThreeVector> velocities = compute_at_nodes<ThreeVector>(
+          out_par_.td_threads, lattice.size(), [&](std::size_t k) {
+            return -lattice[k].landau_frame_4velocity().velocity();
           });
+      for (ThreeVector &v : velocities) {
+        if (enable_ascii_) {
+          *fp << v.x1() << " " << v.x2() << " " << v.x3() << "\n";
+        }
+        if (enable_binary_) {
+          fp->write(reinterpret_cast<char *>(&v), 3 * sizeof(double));
+        }
+      }
       break;
+    }
     default:
       return;
   }
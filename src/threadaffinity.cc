@@ -0,0 +1,198 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/threadaffinity.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace smash {
+
+#ifdef __linux__
+/**
+ * Read a list of cores in the format of sysfs, like "0-3,8,10-11".
+ *
+ * \param[in] path File containing the list.
+ * \return The cores, empty if the file cannot be read.
+ */
+static std::vector<int> read_core_list(const std::filesystem::path &path) {
+  std::vector<int> cores;
+  std::ifstream file(path);
+  std::string range;
+  while (std::getline(file, range, ',')) {
+    std::istringstream numbers(range);
+    int first = 0, last = 0;
+    char dash = 0;
+    if (!(numbers >> first)) {
+      continue;
+    }
+    last = (numbers >> dash >> last && dash == '-') ? last : first;
+    for (int core = first; core <= last; core++) {
+      cores.push_back(core);
+    }
+  }
+  return cores;
+}
+
+NumaNodes usable_numa_nodes() {
+  cpu_set_t usable;
+  CPU_ZERO(&usable);
+  if (sched_getaffinity(0, sizeof(usable), &usable) != 0) {
+    return {};
+  }
+  auto is_usable = [&usable](int core) {
+    return core >= 0 && core < CPU_SETSIZE && CPU_ISSET(core, &usable);
+  };
+
+  // The nodes are ordered by their number, not by the order in the directory.
+  std::vector<std::pair<int, std::vector<int>>> numbered_nodes;
+  const std::filesystem::path node_dir = "/sys/devices/system/node";
+  std::error_code error;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(node_dir, error)) {
+    const std::string name = entry.path().filename().string();
+    if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+        !std::all_of(name.begin() + 4, name.end(),
+                     [](unsigned char c) { return std::isdigit(c); })) {
+      continue;
+    }
+    std::vector<int> cores = read_core_list(entry.path() / "cpulist");
+    cores.erase(std::remove_if(cores.begin(), cores.end(),
+                               [&](int core) { return !is_usable(core); }),
+                cores.end());
+    if (!cores.empty()) {
+      numbered_nodes.emplace_back(std::stoi(name.substr(4)), std::move(cores));
+    }
+  }
+  std::sort(numbered_nodes.begin(), numbered_nodes.end());
+  NumaNodes nodes;
+  for (auto &numbered_node : numbered_nodes) {
+    nodes.push_back(std::move(numbered_node.second));
+  }
+
+  if (nodes.empty()) {
+    // No information about the nodes, all cores are treated as one node
+    std::vector<int> cores;
+    for (int core = 0; core < CPU_SETSIZE; core++) {
+      if (is_usable(core)) {
+        cores.push_back(core);
+      }
+    }
+    if (!cores.empty()) {
+      nodes.push_back(std::move(cores));
+    }
+  }
+  return nodes;
+}
+
+/// Binding of a thread before it was bound by ScopedThreadAffinity
+struct ScopedThreadAffinity::PreviousCores {
+  /// Cores on which the thread could run
+  cpu_set_t cores;
+};
+
+ScopedThreadAffinity::ScopedThreadAffinity(const std::vector<int> &cores) {
+  auto previous = std::make_unique<PreviousCores>();
+  const pthread_t self = pthread_self();
+  if (pthread_getaffinity_np(self, sizeof(cpu_set_t), &previous->cores) !=
+      0) {
+    return;
+  }
+  cpu_set_t bound_cores;
+  CPU_ZERO(&bound_cores);
+  for (int core : cores) {
+    if (core >= 0 && core < CPU_SETSIZE) {
+      CPU_SET(core, &bound_cores);
+    }
+  }
+  if (CPU_COUNT(&bound_cores) == 0 ||
+      pthread_setaffinity_np(self, sizeof(cpu_set_t), &bound_cores) != 0) {
+    return;
+  }
+  previous_ = std::move(previous);
+}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() {
+  if (previous_) {
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                           &previous_->cores);
+  }
+}
+
+bool advise_huge_pages(void *memory, std::size_t bytes) {
+#ifdef MADV_HUGEPAGE
+  // Size of the huge pages on x86-64, the advice is ignored for other sizes
+  constexpr std::uintptr_t huge_page = 2u << 20;
+  const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(memory);
+  const std::uintptr_t aligned_begin =
+      (begin + huge_page - 1) / huge_page * huge_page;
+  const std::uintptr_t aligned_end = (begin + bytes) / huge_page * huge_page;
+  if (aligned_end <= aligned_begin) {
+    return false;
+  }
+  return madvise(reinterpret_cast<void *>(aligned_begin),
+                 aligned_end - aligned_begin, MADV_HUGEPAGE) == 0;
+#else
+  return false;
+#endif
+}
+#else
+NumaNodes usable_numa_nodes() { return {}; }
+
+/// Placeholder, binding threads is not supported
+struct ScopedThreadAffinity::PreviousCores {};
+
+ScopedThreadAffinity::ScopedThreadAffinity(const std::vector<int> &) {}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() = default;
+
+bool advise_huge_pages(void *, std::size_t) { return false; }
+#endif
+
+std::vector<std::size_t> assign_numa_nodes(ThreadAffinity policy,
+                                           const NumaNodes &nodes,
+                                           int n_threads) {
+  std::vector<std::size_t> assignment;
+  if (policy == ThreadAffinity::None || nodes.empty() || n_threads <= 0) {
+    return assignment;
+  }
+  assignment.reserve(n_threads);
+  if (policy == ThreadAffinity::Scatter) {
+    for (int i = 0; i < n_threads; i++) {
+      assignment.push_back(i % nodes.size());
+    }
+    return assignment;
+  }
+  // Compact: the node of every core, in the order of the nodes
+  std::vector<std::size_t> node_of_core;
+  for (std::size_t node = 0; node < nodes.size(); node++) {
+    node_of_core.insert(node_of_core.end(), nodes[node].size(), node);
+  }
+  if (node_of_core.empty()) {
+    return {};
+  }
+  for (int i = 0; i < n_threads; i++) {
+    assignment.push_back(node_of_core[i % node_of_core.size()]);
+  }
+  return assignment;
+}
+
+}  // namespace smash
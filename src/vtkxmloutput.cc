@@ -0,0 +1,562 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/vtkxmloutput.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+#ifdef SMASH_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "smash/config.h"
+#include "smash/energymomentumtensor.h"
+#include "smash/file.h"
+#include "smash/grandcan_thermalizer.h"
+#include "smash/lattice.h"
+#include "smash/logging.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+/*!\Userguide
+ * \page doxypage_output_vtk_xml
+ * The `VTK_XML` format writes the same particle lists and thermodynamic
+ * lattices as the \ref doxypage_output_vtk "VTK" format, but in the binary XML
+ * formats of VTK, which can be opened with ParaView (http://paraview.org) as
+ * well. The values are stored with full precision in the appended data section
+ * of the files and compressed with zlib, unless `Compression_Level` is set to
+ * 0 or SMASH is built without zlib. The files are written by a thread of the
+ * output while the simulation continues.
+ *
+ * **Particles** are written into unstructured grids of vertices, one file per
+ * output time named pos_ev<event>_tstep<output_number>.vtu, with the point
+ * data pdg_codes, is_formed, cross_section_scaling_factor, mass, N_coll,
+ * particle_ID, baryon_number, strangeness and momentum.
+ *
+ * **Thermodynamic lattices** are written into image data with the points at
+ * the centers of the lattice cells, one file per quantity and output time
+ * named \<quantity\>_\<event_number\>_tstep\<number_of_output_moment\>.vti.
+ * To reduce the size of large lattices, only the cells with centers inside
+ * the region given by `Region_Min` and `Region_Max` are written, and only
+ * every `Downsampling`-th of them in each direction, see
+ * \ref input_output_thermodynamics_.
+ */
+
+namespace {
+/// Size of the blocks compressed separately, as in VTK
+constexpr std::size_t block_size = 1 << 15;
+
+/**
+ * Convert numbers to a space-separated list of XML attribute values.
+ * \param[in] values Numbers to convert.
+ * \return The converted numbers.
+ */
+template <typename T>
+std::string join(const std::array<T, 3> &values) {
+  return std::to_string(values[0]) + " " + std::to_string(values[1]) + " " +
+         std::to_string(values[2]);
+}
+
+/**
+ * Data of an array as stored in the appended data section.
+ * \param[in] data Raw values.
+ * \param[in] compression_level zlib compression level, 0 for none.
+ * \return Header followed by the possibly compressed values.
+ * \throw std::runtime_error if the compression fails.
+ */
+std::vector<char> encode(const std::vector<char> &data,
+                         int compression_level) {
+  std::vector<char> encoded;
+  if (compression_level == 0) {
+    const std::uint64_t size = data.size();
+    encoded.resize(sizeof(size) + data.size());
+    std::memcpy(encoded.data(), &size, sizeof(size));
+    if (!data.empty()) {
+      std::memcpy(encoded.data() + sizeof(size), data.data(), data.size());
+    }
+    return encoded;
+  }
+#ifdef SMASH_USE_ZLIB
+  /* The header holds the number of blocks, the size of the blocks, the size
+   * of the last partial block (0 if there is none) and the compressed size of
+   * every block. */
+  const std::size_t n_blocks = (data.size() + block_size - 1) / block_size;
+  std::vector<std::uint64_t> header(3 + n_blocks);
+  header[0] = n_blocks;
+  header[1] = block_size;
+  header[2] = data.size() % block_size;
+  std::vector<char> blocks;
+  std::vector<char> compressed(compressBound(block_size));
+  for (std::size_t i = 0; i < n_blocks; i++) {
+    const std::size_t begin = i * block_size;
+    const std::size_t size = std::min(block_size, data.size() - begin);
+    uLongf compressed_size = compressed.size();
+    if (compress2(reinterpret_cast<Bytef *>(compressed.data()),
+                  &compressed_size,
+                  reinterpret_cast<const Bytef *>(data.data() + begin), size,
+                  compression_level) != Z_OK) {
+      throw std::runtime_error("Compression of a VTK data array failed.");
+    }
+    header[3 + i] = compressed_size;
+    blocks.insert(blocks.end(), compressed.begin(),
+                  compressed.begin() + compressed_size);
+  }
+  encoded.resize(header.size() * sizeof(std::uint64_t));
+  std::memcpy(encoded.data(), header.data(), encoded.size());
+  encoded.insert(encoded.end(), blocks.begin(), blocks.end());
+#endif
+  return encoded;
+}
+
+/**
+ * Append a number or the components of a vector to a list of values.
+ * \param[in] values List to append to.
+ * \param[in] x Value to append.
+ */
+void append(std::vector<double> &values, double x) { values.push_back(x); }
+
+/// \copydoc append(std::vector<double> &, double)
+void append(std::vector<double> &values, const ThreeVector &x) {
+  values.push_back(x.x1());
+  values.push_back(x.x2());
+  values.push_back(x.x3());
+}
+}  // namespace
+
+void VtkXmlFile::write(int compression_level) const {
+  std::vector<std::vector<char>> encoded;
+  encoded.reserve(arrays.size());
+  for (const Array &array : arrays) {
+    encoded.push_back(encode(array.data, compression_level));
+  }
+
+  std::string xml = "<?xml version=\"1.0\"?>\n<VTKFile type=\"" + dataset +
+                    "\" version=\"1.0\" byte_order=\"";
+#ifdef LITTLE_ENDIAN_ARCHITECTURE
+  xml += "LittleEndian";
+#else
+  xml += "BigEndian";
+#endif
+  xml += "\" header_type=\"UInt64\"";
+  if (compression_level > 0) {
+    xml += " compressor=\"vtkZLibDataCompressor\"";
+  }
+  xml += ">\n<!-- SMASH " SMASH_VERSION " -->\n";
+  xml += "<" + dataset + " " + dataset_attributes + ">\n";
+  xml += "<Piece " + piece_attributes + ">\n";
+  std::uint64_t offset = 0;
+  std::string section;
+  for (std::size_t i = 0; i < arrays.size(); i++) {
+    if (arrays[i].section != section) {
+      if (!section.empty()) {
+        xml += "</" + section + ">\n";
+      }
+      section = arrays[i].section;
+      xml += "<" + section + ">\n";
+    }
+    xml += "<DataArray type=\"" + arrays[i].type + "\" Name=\"" +
+           arrays[i].name + "\" NumberOfComponents=\"" +
+           std::to_string(arrays[i].n_components) +
+           "\" format=\"appended\" offset=\"" + std::to_string(offset) +
+           "\"/>\n";
+    offset += encoded[i].size();
+  }
+  if (!section.empty()) {
+    xml += "</" + section + ">\n";
+  }
+  xml += "</Piece>\n</" + dataset + ">\n<AppendedData encoding=\"raw\">\n_";
+
+  FilePtr file{std::fopen(path.native().c_str(), "wb")};
+  if (!file) {
+    throw std::runtime_error("Cannot open " + path.string() + " for writing.");
+  }
+  std::fwrite(xml.data(), 1, xml.size(), file.get());
+  for (const std::vector<char> &data : encoded) {
+    std::fwrite(data.data(), 1, data.size(), file.get());
+  }
+  const std::string end = "\n</AppendedData>\n</VTKFile>\n";
+  std::fwrite(end.data(), 1, end.size(), file.get());
+  if (std::ferror(file.get())) {
+    throw std::runtime_error("Writing " + path.string() + " failed.");
+  }
+}
+
+namespace {
+/**
+ * Compression level that can be used with this build of SMASH.
+ * \param[in] requested Compression level from the configuration.
+ * \return The compression level, 0 if zlib is not available.
+ * \throw std::invalid_argument if the level is not between 0 and 9.
+ */
+int usable_compression_level(int requested) {
+  if (requested < 0 || requested > 9) {
+    throw std::invalid_argument(
+        "Compression_Level of the VTK_XML output must be between 0 and 9.");
+  }
+#ifndef SMASH_USE_ZLIB
+  if (requested > 0) {
+    logg[LOutput].warn(
+        "Compression of the VTK_XML output requested, but zlib support not "
+        "compiled in. The files are stored uncompressed.");
+  }
+  return 0;
+#else
+  return requested;
+#endif
+}
+}  // namespace
+
+VtkXmlOutput::VtkXmlOutput(const std::filesystem::path &path,
+                           const std::string &name,
+                           const OutputParameters &out_par)
+    : OutputInterface(name),
+      base_path_(path),
+      is_thermodynamics_output_(name == "Thermodynamics"),
+      compression_level_(usable_compression_level(
+          is_thermodynamics_output_ ? out_par.td_compression_level
+                                    : out_par.part_compression_level)),
+      downsampling_(out_par.td_downsampling),
+      region_min_(out_par.td_region_min),
+      region_max_(out_par.td_region_max) {
+  if (downsampling_ < 1) {
+    throw std::invalid_argument(
+        "Downsampling of the VTK_XML output must be at least 1.");
+  }
+  writer_ = std::thread(&VtkXmlOutput::write_loop, this);
+}
+
+VtkXmlOutput::~VtkXmlOutput() {
+  {
+    std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  file_submitted_.notify_one();
+  writer_.join();
+  if (error_) {
+    logg[LOutput].error("Writing a VTK_XML file failed at shutdown.");
+  }
+}
+
+void VtkXmlOutput::write_loop() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    file_submitted_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      return;
+    }
+    std::unique_ptr<VtkXmlFile> file = std::move(pending_.front());
+    pending_.pop_front();
+    writing_ = true;
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      file->write(compression_level_);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    // The values are released before waking up the physics loop.
+    file.reset();
+    lock.lock();
+    writing_ = false;
+    if (error && !error_) {
+      error_ = error;
+    }
+    file_written_.notify_all();
+  }
+}
+
+void VtkXmlOutput::submit(std::unique_ptr<VtkXmlFile> file) {
+  std::unique_lock lock(mutex_);
+  file_written_.wait(lock, [this] {
+    return pending_.size() < max_pending_files || error_;
+  });
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  pending_.push_back(std::move(file));
+  lock.unlock();
+  file_submitted_.notify_one();
+}
+
+void VtkXmlOutput::flush() {
+  std::unique_lock lock(mutex_);
+  file_written_.wait(lock, [this] { return pending_.empty() && !writing_; });
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void VtkXmlOutput::at_eventstart(const Particles &particles,
+                                 const int event_number, const EventInfo &) {
+  current_event_ = event_number;
+  particles_counter_ = 0;
+  lattice_counters_.fill(0);
+  if (!is_thermodynamics_output_) {
+    write_particles(particles);
+  }
+}
+
+void VtkXmlOutput::at_intermediate_time(const Particles &particles,
+                                        const std::unique_ptr<Clock> &,
+                                        const DensityParameters &,
+                                        const EventInfo &) {
+  if (!is_thermodynamics_output_) {
+    write_particles(particles);
+  }
+}
+
+void VtkXmlOutput::write_particles(const Particles &particles) {
+  char filename[32];
+  std::snprintf(filename, sizeof(filename), "pos_ev%05i_tstep%05i.vtu",
+                current_event_, particles_counter_++);
+  auto file = std::make_unique<VtkXmlFile>();
+  file->path = base_path_ / filename;
+  file->dataset = "UnstructuredGrid";
+  const std::size_t n = particles.size();
+  file->piece_attributes = "NumberOfPoints=\"" + std::to_string(n) +
+                           "\" NumberOfCells=\"" + std::to_string(n) + "\"";
+
+  std::vector<std::int32_t> pdg, is_formed, n_coll, id, baryon, strangeness;
+  std::vector<double> scaling, mass, position, momentum;
+  for (std::vector<std::int32_t> *v :
+       {&pdg, &is_formed, &n_coll, &id, &baryon, &strangeness}) {
+    v->reserve(n);
+  }
+  scaling.reserve(n);
+  mass.reserve(n);
+  position.reserve(3 * n);
+  momentum.reserve(3 * n);
+  const double current_time = particles.time();
+  for (const ParticleData &p : particles) {
+    pdg.push_back(p.pdgcode().get_decimal());
+    is_formed.push_back(p.formation_time() > current_time ? 0 : 1);
+    scaling.push_back(p.xsec_scaling_factor());
+    mass.push_back(p.effective_mass());
+    n_coll.push_back(p.get_history().collisions_per_particle);
+    id.push_back(p.id());
+    baryon.push_back(p.pdgcode().baryon_number());
+    strangeness.push_back(p.pdgcode().strangeness());
+    append(position, p.position().threevec());
+    append(momentum, p.momentum().threevec());
+  }
+  file->add_array("PointData", "pdg_codes", "Int32", 1, pdg);
+  file->add_array("PointData", "is_formed", "Int32", 1, is_formed);
+  file->add_array("PointData", "cross_section_scaling_factor", "Float64", 1,
+                  scaling);
+  file->add_array("PointData", "mass", "Float64", 1, mass);
+  file->add_array("PointData", "N_coll", "Int32", 1, n_coll);
+  file->add_array("PointData", "particle_ID", "Int32", 1, id);
+  file->add_array("PointData", "baryon_number", "Int32", 1, baryon);
+  file->add_array("PointData", "strangeness", "Int32", 1, strangeness);
+  file->add_array("PointData", "momentum", "Float64", 3, momentum);
+  file->add_array("Points", "position", "Float64", 3, position);
+
+  // Every particle is a cell of the type VTK_VERTEX.
+  std::vector<std::int64_t> connectivity(n);
+  std::vector<std::int64_t> offsets(n);
+  for (std::size_t i = 0; i < n; i++) {
+    connectivity[i] = i;
+    offsets[i] = i + 1;
+  }
+  file->add_array("Cells", "connectivity", "Int64", 1, connectivity);
+  file->add_array("Cells", "offsets", "Int64", 1, offsets);
+  file->add_array("Cells", "types", "UInt8", 1, std::vector<std::uint8_t>(n, 1));
+  submit(std::move(file));
+}
+
+template <typename T>
+VtkXmlOutput::Selection VtkXmlOutput::select(
+    const RectangularLattice<T> &lattice) const {
+  Selection selection;
+  selection.stride = downsampling_;
+  const std::array<int, 3> &n = lattice.n_cells();
+  for (int d = 0; d < 3; d++) {
+    int first = n[d];
+    int last = -1;
+    for (int i = 0; i < n[d]; i++) {
+      std::array<int, 3> index{0, 0, 0};
+      index[d] = i;
+      const double x = lattice.cell_center(index[0], index[1], index[2])[d + 1];
+      if (x >= region_min_[d] && x <= region_max_[d]) {
+        first = std::min(first, i);
+        last = i;
+      }
+    }
+    selection.first[d] = first;
+    selection.count[d] = last < first ? 0 : (last - first) / downsampling_ + 1;
+  }
+  return selection;
+}
+
+template <typename T>
+std::unique_ptr<VtkXmlFile> VtkXmlOutput::lattice_file(
+    const RectangularLattice<T> &lattice, const Selection &selection,
+    const std::string &description, int counter) const {
+  char suffix[22];
+  std::snprintf(suffix, sizeof(suffix), "_%05i_tstep%05i.vti", current_event_,
+                counter);
+  auto file = std::make_unique<VtkXmlFile>();
+  file->path = base_path_ / (description + suffix);
+  file->dataset = "ImageData";
+  const ThreeVector origin = lattice.cell_center(
+      selection.first[0], selection.first[1], selection.first[2]);
+  std::array<double, 3> spacing;
+  for (int d = 0; d < 3; d++) {
+    spacing[d] = lattice.cell_sizes()[d] * selection.stride;
+  }
+  const std::string extent =
+      "0 " + std::to_string(selection.count[0] - 1) + " 0 " +
+      std::to_string(selection.count[1] - 1) + " 0 " +
+      std::to_string(selection.count[2] - 1);
+  file->dataset_attributes =
+      "WholeExtent=\"" + extent + "\" Origin=\"" +
+      join(std::array<double, 3>{origin.x1(), origin.x2(), origin.x3()}) +
+      "\" Spacing=\"" + join(spacing) + "\"";
+  file->piece_attributes = "Extent=\"" + extent + "\"";
+  return file;
+}
+
+template <typename T, typename F>
+std::vector<double> VtkXmlOutput::evaluate(RectangularLattice<T> &lattice,
+                                           const Selection &selection,
+                                           F &&get_quantity) {
+  std::vector<double> values;
+  const int stride = selection.stride;
+  for (int iz = 0; iz < selection.count[2]; iz++) {
+    for (int iy = 0; iy < selection.count[1]; iy++) {
+      for (int ix = 0; ix < selection.count[0]; ix++) {
+        append(values, get_quantity(lattice.node(
+                           selection.first[0] + ix * stride,
+                           selection.first[1] + iy * stride,
+                           selection.first[2] + iz * stride)));
+      }
+    }
+  }
+  return values;
+}
+
+namespace {
+/**
+ * Check whether any node of a lattice is selected and warn if not.
+ * \param[in] count Number of selected nodes in each direction.
+ * \return Whether a file has to be written.
+ */
+bool any_selected(const std::array<int, 3> &count) {
+  if (count[0] > 0 && count[1] > 0 && count[2] > 0) {
+    return true;
+  }
+  logg[LOutput].warn(
+      "No lattice node lies in the region of the VTK_XML output, the lattice "
+      "is not written.");
+  return false;
+}
+
+}  // namespace
+
+void VtkXmlOutput::thermodynamics_output(
+    const ThermodynamicQuantity tq, const DensityType dens_type,
+    RectangularLattice<DensityOnLattice> &lattice) {
+  if (!is_thermodynamics_output_) {
+    return;
+  }
+  const Selection selection = select(lattice);
+  const int counter = lattice_counters_[0]++;
+  if (!any_selected(selection.count)) {
+    return;
+  }
+  const std::string varname =
+      std::string(to_string(dens_type)) + "_" + to_string(tq);
+  auto file = lattice_file(lattice, selection, varname, counter);
+  file->add_array(
+      "PointData", varname, "Float64", 1,
+      evaluate(lattice, selection,
+               [](DensityOnLattice &node) { return node.rho(); }));
+  submit(std::move(file));
+}
+
+void VtkXmlOutput::thermodynamics_output(
+    const ThermodynamicQuantity tq, const DensityType dens_type,
+    RectangularLattice<EnergyMomentumTensor> &lattice) {
+  if (!is_thermodynamics_output_) {
+    return;
+  }
+  const Selection selection = select(lattice);
+  const std::size_t quantity = tq == ThermodynamicQuantity::Tmn         ? 1
+                               : tq == ThermodynamicQuantity::TmnLandau ? 2
+                                                                        : 3;
+  const int counter = lattice_counters_[quantity]++;
+  if (!any_selected(selection.count)) {
+    return;
+  }
+  const std::string varname =
+      std::string(to_string(dens_type)) + "_" + to_string(tq);
+  auto file = lattice_file(lattice, selection, varname, counter);
+  if (tq == ThermodynamicQuantity::Tmn ||
+      tq == ThermodynamicQuantity::TmnLandau) {
+    const bool landau = tq == ThermodynamicQuantity::TmnLandau;
+    for (int i = 0; i < 4; i++) {
+      for (int j = i; j < 4; j++) {
+        file->add_array(
+            "PointData", varname + std::to_string(i) + std::to_string(j),
+            "Float64", 1,
+            evaluate(lattice, selection, [&](EnergyMomentumTensor &node) {
+              const EnergyMomentumTensor Tmn =
+                  landau ? node.boosted(node.landau_frame_4velocity()) : node;
+              return Tmn[EnergyMomentumTensor::tmn_index(i, j)];
+            }));
+      }
+    }
+  } else {
+    file->add_array(
+        "PointData", varname, "Float64", 3,
+        evaluate(lattice, selection, [](EnergyMomentumTensor &node) {
+          return -node.landau_frame_4velocity().velocity();
+        }));
+  }
+  submit(std::move(file));
+}
+
+void VtkXmlOutput::thermodynamics_output(const GrandCanThermalizer &gct) {
+  if (!is_thermodynamics_output_) {
+    return;
+  }
+  RectangularLattice<ThermLatticeNode> &lattice = gct.lattice();
+  const Selection selection = select(lattice);
+  const int counter = lattice_counters_[4]++;
+  if (!any_selected(selection.count)) {
+    return;
+  }
+  auto file = lattice_file(lattice, selection, "fluidization_td", counter);
+  file->add_array(
+      "PointData", "e", "Float64", 1,
+      evaluate(lattice, selection, [](ThermLatticeNode &n) { return n.e(); }));
+  file->add_array(
+      "PointData", "p", "Float64", 1,
+      evaluate(lattice, selection, [](ThermLatticeNode &n) { return n.p(); }));
+  file->add_array(
+      "PointData", "v", "Float64", 3,
+      evaluate(lattice, selection, [](ThermLatticeNode &n) { return n.v(); }));
+  file->add_array(
+      "PointData", "T", "Float64", 1,
+      evaluate(lattice, selection, [](ThermLatticeNode &n) { return n.T(); }));
+  file->add_array("PointData", "mub", "Float64", 1,
+                  evaluate(lattice, selection,
+                           [](ThermLatticeNode &n) { return n.mub(); }));
+  file->add_array("PointData", "mus", "Float64", 1,
+                  evaluate(lattice, selection,
+                           [](ThermLatticeNode &n) { return n.mus(); }));
+  submit(std::move(file));
+}
+
+}  // namespace smash